@@ -328,6 +328,15 @@ struct xcptcontext
   uint32_t *kstkptr;  /* Saved kernel stack pointer */
 #endif
 #endif
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* With lazy FPU switching the floating point registers are not part of
+   * the exception frame.  They stay in the FPU until another thread uses
+   * it and are saved here in the layout of the REG_Sx/REG_FPSCR indices.
+   */
+
+  uint32_t fpuregs[FPU_CONTEXT_REGS];
+#endif
 };
 
 /****************************************************************************
@@ -102,6 +102,7 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
       nxsched_suspend_scheduler(g_running_tasks[this_cpu()]);
       nxsched_resume_scheduler(tcb);
+      arm_lazyfpu_switch(g_running_tasks[this_cpu()], tcb);
 
       /* Record the new "running" task when context switch occurred.
        * g_running_tasks[] is only used by assertion logic for reporting
@@ -99,6 +99,10 @@ void up_initial_state(struct tcb_s *tcb)
 
   memset(xcp->regs, 0, XCPTCONTEXT_SIZE);
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  memset(xcp->fpuregs, 0, sizeof(xcp->fpuregs));
+#endif
+
   /* Save the initial stack pointer */
 
   xcp->regs[REG_SP] = (uint32_t)tcb->stack_base_ptr +
@@ -0,0 +1,277 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_lazyfpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <sched/sched.h>
+
+#include "arm.h"
+#include "arm_internal.h"
+
+#ifdef CONFIG_ARCH_LAZYFPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FPEXC_EN            (1 << 30) /* Bit 30: FPU enable */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The thread whose floating point registers are loaded in the FPU of a
+ * CPU.  The PID is kept with the TCB pointer because the owner may exit
+ * while its registers are still loaded.
+ */
+
+struct fpu_owner_s
+{
+  struct tcb_s *tcb;
+  pid_t pid;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fpu_owner_s g_fpu_owner[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t arm_fpexc_get(void)
+{
+  uint32_t fpexc;
+
+  __asm__ __volatile__("vmrs %0, fpexc" : "=r"(fpexc));
+  return fpexc;
+}
+
+static inline void arm_fpexc_set(uint32_t fpexc)
+{
+  __asm__ __volatile__("vmsr fpexc, %0" : : "r"(fpexc));
+}
+
+/****************************************************************************
+ * Name: arm_fpu_store / arm_fpu_load
+ *
+ * Description:
+ *   Move the floating point registers between the FPU and a TCB.  The FPU
+ *   must be enabled.
+ *
+ ****************************************************************************/
+
+static void arm_fpu_store(struct tcb_s *tcb)
+{
+  uint32_t *fpuregs = tcb->xcp.fpuregs;
+
+  __asm__ __volatile__
+    (
+#ifdef CONFIG_ARM_DPFPU32
+      "vstmia.64 %0!, {d0-d15}\n"
+      "vstmia.64 %0!, {d16-d31}\n"
+#else
+      "vstmia %0!, {s0-s31}\n"
+#endif
+      : "+r"(fpuregs)
+      :
+      : "memory"
+    );
+
+  __asm__ __volatile__("vmrs %0, fpscr"
+                       : "=r"(tcb->xcp.fpuregs[REG_FPSCR]));
+}
+
+static void arm_fpu_load(struct tcb_s *tcb)
+{
+  const uint32_t *fpuregs = tcb->xcp.fpuregs;
+
+  __asm__ __volatile__
+    (
+#ifdef CONFIG_ARM_DPFPU32
+      "vldmia.64 %0!, {d0-d15}\n"
+      "vldmia.64 %0!, {d16-d31}\n"
+#else
+      "vldmia %0!, {s0-s31}\n"
+#endif
+      : "+r"(fpuregs)
+      :
+      : "memory"
+    );
+
+  __asm__ __volatile__("vmsr fpscr, %0"
+                       : : "r"(tcb->xcp.fpuregs[REG_FPSCR]));
+}
+
+/****************************************************************************
+ * Name: arm_fpu_owner
+ *
+ * Description:
+ *   Return the thread whose registers are loaded in the FPU of this CPU,
+ *   or NULL if there is none or it has exited.
+ *
+ ****************************************************************************/
+
+static struct tcb_s *arm_fpu_owner(int cpu)
+{
+  struct fpu_owner_s *owner = &g_fpu_owner[cpu];
+
+  if (owner->tcb != NULL && nxsched_get_tcb(owner->pid) != owner->tcb)
+    {
+      owner->tcb = NULL;
+    }
+
+  return owner->tcb;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_lazyfpu_trap
+ *
+ * Description:
+ *   Called on an undefined instruction exception.  If the FPU is disabled,
+ *   the exception was caused by the first floating point instruction since
+ *   the running thread was switched in:  Save the registers of the
+ *   previous owner, load those of the running thread, enable the FPU and
+ *   restart the instruction.
+ *
+ * Input Parameters:
+ *   regs - The exception frame of the undefined instruction
+ *
+ * Returned Value:
+ *   True if the exception was handled, false if it is a real undefined
+ *   instruction.
+ *
+ ****************************************************************************/
+
+bool arm_lazyfpu_trap(uint32_t *regs)
+{
+  struct tcb_s *rtcb = this_task();
+  struct tcb_s *otcb;
+  int cpu = this_cpu();
+
+  if ((arm_fpexc_get() & FPEXC_EN) != 0)
+    {
+      return false;
+    }
+
+  arm_fpexc_set(FPEXC_EN);
+
+  otcb = arm_fpu_owner(cpu);
+  if (otcb != rtcb)
+    {
+      if (otcb != NULL)
+        {
+          arm_fpu_store(otcb);
+        }
+
+      arm_fpu_load(rtcb);
+
+      g_fpu_owner[cpu].tcb = rtcb;
+      g_fpu_owner[cpu].pid = rtcb->pid;
+    }
+
+  /* The return address was taken past the faulting instruction */
+
+  regs[REG_PC] -= (regs[REG_CPSR] & PSR_T_BIT) != 0 ? 2 : 4;
+  return true;
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_switch
+ *
+ * Description:
+ *   Called on a context switch.  The FPU is left enabled only if it still
+ *   holds the registers of the incoming thread.  In SMP the registers of
+ *   the outgoing thread are saved because it may resume on another CPU.
+ *
+ * Input Parameters:
+ *   from - The thread being switched out
+ *   to   - The thread being switched in
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_switch(struct tcb_s *from, struct tcb_s *to)
+{
+  int cpu = this_cpu();
+
+#ifdef CONFIG_SMP
+  if (from != to && arm_fpu_owner(cpu) == from)
+    {
+      arm_fpu_store(from);
+      g_fpu_owner[cpu].tcb = NULL;
+    }
+#else
+  UNUSED(from);
+#endif
+
+  arm_fpexc_set(arm_fpu_owner(cpu) == to ? FPEXC_EN : 0);
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_save
+ *
+ * Description:
+ *   Make sure that the floating point registers of a thread are in its TCB
+ *   and no longer loaded in the FPU.  The next floating point instruction
+ *   of the thread will load them again.
+ *
+ * Input Parameters:
+ *   tcb - The running thread
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_save(struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  if (arm_fpu_owner(cpu) == tcb)
+    {
+      arm_fpexc_set(FPEXC_EN);
+      arm_fpu_store(tcb);
+      g_fpu_owner[cpu].tcb = NULL;
+    }
+
+  arm_fpexc_set(0);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_ARCH_LAZYFPU */
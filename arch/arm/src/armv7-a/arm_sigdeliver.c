@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <sched.h>
 #include <assert.h>
 #include <debug.h>
@@ -67,12 +68,25 @@ void arm_sigdeliver(void)
   int16_t saved_irqcount;
 #endif
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* The floating point registers are not part of the saved context with
+   * lazy FPU switching, so keep a copy while the signal handlers run.
+   */
+
+  uint32_t fpuregs[FPU_CONTEXT_REGS];
+#endif
+
   board_autoled_on(LED_SIGNAL);
 
   sinfo("rtcb=%p sigdeliver=%p sigpendactionq.head=%p\n",
         rtcb, rtcb->sigdeliver, rtcb->sigpendactionq.head);
   DEBUGASSERT(rtcb->sigdeliver != NULL);
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  arm_lazyfpu_save(rtcb);
+  memcpy(fpuregs, rtcb->xcp.fpuregs, sizeof(fpuregs));
+#endif
+
 retry:
 #ifdef CONFIG_SMP
   /* In the SMP case, up_schedule_sigaction(0) will have incremented
@@ -163,6 +177,13 @@ retry:
   rtcb->irqcount--;
 #endif
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* Discard the floating point registers of the signal handlers */
+
+  arm_lazyfpu_save(rtcb);
+  memcpy(rtcb->xcp.fpuregs, fpuregs, sizeof(fpuregs));
+#endif
+
   rtcb->xcp.regs = rtcb->xcp.saved_regs;
   arm_fullcontextrestore();
   UNUSED(regs);
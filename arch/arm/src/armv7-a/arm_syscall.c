@@ -274,6 +274,7 @@ uint32_t *arm_syscall(uint32_t *regs)
 
       case SYS_restore_context:
         nxsched_suspend_scheduler(*running_task);
+        arm_lazyfpu_switch(*running_task, tcb);
         *running_task = tcb;
 
         /* Restore the cpu lock */
@@ -47,6 +47,17 @@ uint32_t *arm_undefinedinsn(uint32_t *regs)
 {
   struct tcb_s *tcb = this_task();
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* The first floating point instruction of a thread traps here.  This is
+   * not supported in interrupt handlers.
+   */
+
+  if (!up_interrupt_context() && arm_lazyfpu_trap(regs))
+    {
+      return regs;
+    }
+#endif
+
   tcb->xcp.regs = regs;
   up_set_interrupt_context(true);
 
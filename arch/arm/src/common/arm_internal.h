@@ -450,6 +450,15 @@ void arm_fpuconfig(void);
 #  define arm_fpuconfig()
 #endif
 
+#ifdef CONFIG_ARCH_LAZYFPU
+bool arm_lazyfpu_trap(uint32_t *regs);
+void arm_lazyfpu_switch(struct tcb_s *from, struct tcb_s *to);
+void arm_lazyfpu_save(struct tcb_s *tcb);
+#else
+#  define arm_lazyfpu_switch(from, to)
+#  define arm_lazyfpu_save(tcb)
+#endif
+
 /* Low level serial output **************************************************/
 
 void arm_lowputc(char ch);
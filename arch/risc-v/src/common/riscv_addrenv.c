@@ -88,6 +88,10 @@
 
 #define ENTRIES_PER_PGT     (RV_MMU_PAGE_ENTRIES)
 
+/* The size of the memory mapped by one final level page table */
+
+#define SECTION_SIZE        (ENTRIES_PER_PGT * MM_PGSIZE)
+
 /* Make sure the address environment virtual address boundary is valid */
 
 static_assert((ARCH_ADDRENV_VBASE & RV_MMU_SECTION_ALIGN) == 0,
@@ -219,7 +223,9 @@ static int copy_kernel_mappings(arch_addrenv_t *addrenv)
  * Description:
  *   Map a single region of memory to MMU. Assumes that the static page
  *   tables exist. Allocates the final level page tables and commits the
- *   region memory to physical memory.
+ *   region memory to physical memory.  With CONFIG_ARCH_ADDRENV_SECTIONS,
+ *   the aligned sections of the region are committed to contiguous memory
+ *   and mapped by one entry each if such memory is available.
  *
  * Input Parameters:
  *   addrenv - Describes the address environment
@@ -261,6 +267,27 @@ static int create_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
 
       paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
 
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+      if (!paddr && (vaddr & (SECTION_SIZE - 1)) == 0 &&
+          size - nmapped >= SECTION_SIZE)
+        {
+          /* Try to commit the whole section to one block of memory that
+           * is mapped by the prior level.  Fall back to pages if there is
+           * no such block left.
+           */
+
+          paddr = mm_pgalloc_align(ENTRIES_PER_PGT, ENTRIES_PER_PGT);
+          if (paddr)
+            {
+              memset((void *)riscv_pgvaddr(paddr), 0, SECTION_SIZE);
+              mmu_ln_setentry(ptlevel, ptprev, paddr, vaddr, mmuflags);
+              nmapped += SECTION_SIZE;
+              vaddr   += SECTION_SIZE;
+              continue;
+            }
+        }
+#endif
+
       if (!paddr)
         {
           /* Nothing yet, allocate one page for final level page table */
@@ -546,6 +573,18 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
       i = (ARCH_SPGTS < 2) ? vaddr / pgsize : 0;
       for (; i < ENTRIES_PER_PGT; i++, vaddr += pgsize)
         {
+          if (mmu_pte_is_leaf(ptprev[i]))
+            {
+              /* A section, there is no final level page table */
+
+              if (!vaddr_is_shm(vaddr))
+                {
+                  mm_pgfree(mmu_pte_to_paddr(ptprev[i]), ENTRIES_PER_PGT);
+                }
+
+              continue;
+            }
+
           ptlast = (uintptr_t *)riscv_pgvaddr(mmu_pte_to_paddr(ptprev[i]));
           if (ptlast)
             {
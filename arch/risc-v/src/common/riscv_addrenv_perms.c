@@ -76,7 +76,17 @@ static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
            ptlevel < RV_MMU_PT_LEVELS;
            ptlevel++)
         {
-          paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, lnvaddr, vaddr));
+          entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+          if (mmu_pte_is_leaf(entry))
+            {
+              /* A section is always part of one region, it is modified
+               * as a whole.
+               */
+
+              break;
+            }
+
+          paddr = mmu_pte_to_paddr(entry);
           lnvaddr = riscv_pgvaddr(paddr);
           if (!lnvaddr)
             {
@@ -93,6 +103,14 @@ static int modify_region(uintptr_t vstart, uintptr_t vend, uintptr_t setmask)
       /* Restore the entry */
 
       mmu_ln_restore(ptlevel, lnvaddr, vaddr, entry);
+
+      /* Skip the rest of a section */
+
+      if (ptlevel < RV_MMU_PT_LEVELS)
+        {
+          vaddr |= mmu_get_region_size(ptlevel) - 1;
+          vaddr  = MM_PGALIGNDOWN(vaddr);
+        }
     }
 
   /* When all is set and done, flush the data caches */
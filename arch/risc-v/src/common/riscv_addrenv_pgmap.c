@@ -74,6 +74,7 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
   uintptr_t pgdir;
   uintptr_t lnvaddr;
   uintptr_t paddr;
+  uintptr_t entry;
   uint32_t  ptlevel;
 
   /* If vaddr is not user space, get out */
@@ -95,7 +96,16 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
 
   for (ptlevel = 1, lnvaddr = pgdir; ptlevel < RV_MMU_PT_LEVELS; ptlevel++)
     {
-      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, lnvaddr, vaddr));
+      entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      paddr = mmu_pte_to_paddr(entry);
+      if (mmu_pte_is_leaf(entry))
+        {
+          /* Mapped by a section, add the offset of the page in it */
+
+          return paddr + (MM_PGALIGNDOWN(vaddr) &
+                          (mmu_get_region_size(ptlevel) - 1));
+        }
+
       lnvaddr = riscv_pgvaddr(paddr);
       if (!lnvaddr)
         {
@@ -39,6 +39,56 @@
 
 #ifdef CONFIG_BUILD_KERNEL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of pages of a section, i.e. mapped by one last level table */
+
+#define SECTION_NPAGES (RV_MMU_SECTION_ALIGN >> MM_PGSHIFT)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+
+/****************************************************************************
+ * Name: riscv_section_fits
+ *
+ * Description:
+ *   Check whether the next pages to map can be mapped with one section
+ *   entry:  The virtual address and the first page must be aligned to a
+ *   section, the pages must be physically contiguous and nothing may be
+ *   mapped there yet.
+ *
+ ****************************************************************************/
+
+static bool riscv_section_fits(uintptr_t ptprev, uintptr_t *pages,
+                               unsigned int npages, uintptr_t vaddr)
+{
+  unsigned int i;
+
+  if (npages < SECTION_NPAGES ||
+      (vaddr & RV_MMU_SECTION_ALIGN_MASK) != 0 ||
+      (pages[0] & RV_MMU_SECTION_ALIGN_MASK) != 0 ||
+      mmu_ln_getentry(ARCH_SPGTS, ptprev, vaddr) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < SECTION_NPAGES; i++)
+    {
+      if (pages[i] != pages[0] + (i << MM_PGSHIFT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,11 +107,13 @@
  * Returned Value:
  *   The physical address of the corresponding final level page table, or
  *   NULL if one does not exist, and there is no free memory to allocate one
+ *   or 'vaddr' is mapped by a section
  *
  ****************************************************************************/
 
 uintptr_t riscv_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
 {
+  uintptr_t entry;
   uintptr_t paddr;
   uintptr_t ptprev;
   uint32_t  ptlevel;
@@ -80,7 +132,15 @@ uintptr_t riscv_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
 
   /* Find the physical address of the final level page table */
 
-  paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
+  entry = mmu_ln_getentry(ptlevel, ptprev, vaddr);
+  if (mmu_pte_is_leaf(entry))
+    {
+      /* The address is mapped by a section, there is no page table */
+
+      return 0;
+    }
+
+  paddr = mmu_pte_to_paddr(entry);
   if (!paddr)
     {
       /* No page table has been allocated... allocate one now */
@@ -117,7 +177,9 @@ uintptr_t riscv_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
  * Name: riscv_map_pages
  *
  * Description:
- *   Map physical pages into a continuous virtual memory block.
+ *   Map physical pages into a continuous virtual memory block.  With
+ *   CONFIG_ARCH_ADDRENV_SECTIONS, each run of physically contiguous pages
+ *   that covers a whole, unmapped section is mapped by one section entry.
  *
  * Input Parameters:
  *   addrenv - Pointer to a structure describing the address environment.
@@ -140,6 +202,15 @@ int riscv_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
   uintptr_t ptlast;
   uintptr_t ptlevel;
   uintptr_t paddr;
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+  uintptr_t ptprev;
+
+  ptprev  = riscv_pgvaddr(addrenv->spgtables[ARCH_SPGTS - 1]);
+  if (!ptprev)
+    {
+      return -EFAULT;
+    }
+#endif
 
   ptlevel =  RV_MMU_PT_LEVELS;
 
@@ -147,6 +218,19 @@ int riscv_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
 
   for (; npages > 0; npages--)
     {
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+      if (riscv_section_fits(ptprev, pages, npages, vaddr))
+        {
+          /* Map the whole section at once */
+
+          mmu_ln_setentry(ARCH_SPGTS, ptprev, *pages, vaddr, prot);
+          pages  += SECTION_NPAGES;
+          npages -= SECTION_NPAGES - 1;
+          vaddr  += RV_MMU_SECTION_ALIGN;
+          continue;
+        }
+#endif
+
       /* Get the address of the last level page table */
 
       ptlast = riscv_pgvaddr(riscv_get_pgtable(addrenv, vaddr));
@@ -193,6 +277,7 @@ int riscv_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
   uintptr_t ptlast;
   uintptr_t ptprev;
   uintptr_t ptlevel;
+  uintptr_t entry;
   uintptr_t paddr;
 
   ptlevel =  ARCH_SPGTS;
@@ -210,7 +295,24 @@ int riscv_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
     {
       /* Get the current final level entry corresponding to this vaddr */
 
-      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
+      entry = mmu_ln_getentry(ptlevel, ptprev, vaddr);
+      if (mmu_pte_is_leaf(entry))
+        {
+          /* A section can only be unmapped as a whole */
+
+          if ((vaddr & RV_MMU_SECTION_ALIGN_MASK) != 0 ||
+              npages < SECTION_NPAGES)
+            {
+              return -EINVAL;
+            }
+
+          mmu_ln_clear(ptlevel, ptprev, vaddr);
+          npages -= SECTION_NPAGES - 1;
+          vaddr  += RV_MMU_SECTION_ALIGN;
+          continue;
+        }
+
+      paddr = mmu_pte_to_paddr(entry);
       ptlast = riscv_pgvaddr(paddr);
       if (!ptlast)
         {
@@ -351,6 +351,26 @@ static inline uintptr_t mmu_pte_to_paddr(uintptr_t pte)
   return paddr;
 }
 
+/****************************************************************************
+ * Name: mmu_pte_is_leaf
+ *
+ * Description:
+ *   Check whether a PTE maps memory rather than the next level table.  A
+ *   leaf above the last level maps a whole section (a mega or giga page).
+ *
+ * Input Parameters:
+ *   pte - Page table entry
+ *
+ * Returned Value:
+ *   true if the PTE is a leaf entry
+ *
+ ****************************************************************************/
+
+static inline bool mmu_pte_is_leaf(uintptr_t pte)
+{
+  return (pte & PTE_LEAF_MASK) != 0;
+}
+
 /****************************************************************************
  * Name: mmu_satp_to_paddr
  *
@@ -418,6 +418,21 @@ void *mm_realloc(struct mm_heap_s *heap, void *oldmem,
   return mem;
 }
 
+/****************************************************************************
+ * Name: mm_realloc_inplace
+ *
+ * Description:
+ *   Resize an allocation only if that can be done without moving it.  The
+ *   host allocator has no such interface, so only a size that fits the
+ *   current block is accepted.
+ *
+ ****************************************************************************/
+
+void *mm_realloc_inplace(struct mm_heap_s *heap, void *mem, size_t size)
+{
+  return size <= host_mallocsize(mem) ? mem : NULL;
+}
+
 /****************************************************************************
  * Name: mm_calloc
  *
@@ -33,6 +33,7 @@
 #include <nuttx/pci/pci.h>
 
 #include "x86_64_internal.h"
+#include "intel64_cpu.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -83,6 +84,10 @@ static void x86_64_pci_release_irq(struct pci_bus_s *bus,
 static int x86_64_pci_connect_irq(struct pci_bus_s *bus,
                                   int *irq, int num,
                                   uintptr_t *mar, uint32_t *mdr);
+#ifdef CONFIG_SMP
+static int x86_64_pci_affinity_irq(struct pci_bus_s *bus, int irq, int cpu,
+                                   uintptr_t *mar, uint32_t *mdr);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -99,6 +104,9 @@ static const struct pci_ops_s g_x86_64_pci_ops =
   .alloc_irq   = x86_64_pci_alloc_irq,
   .release_irq = x86_64_pci_release_irq,
   .connect_irq = x86_64_pci_connect_irq,
+#ifdef CONFIG_SMP
+  .affinity_irq = x86_64_pci_affinity_irq,
+#endif
 };
 
 static struct pci_controller_s g_x86_64_pci =
@@ -407,6 +415,45 @@ static int x86_64_pci_connect_irq(struct pci_bus_s *bus, int *irq, int num,
   return up_connect_irq(irq, num, mar, mdr);
 }
 
+#ifdef CONFIG_SMP
+/****************************************************************************
+ * Name: x86_64_pci_affinity_irq
+ *
+ * Description:
+ *  Route an MSI/MSI-X interrupt to a CPU.  The destination Local APIC is
+ *  part of the message address, so return a new message.
+ *
+ * Input Parameters:
+ *   bus - Bus that PCI device resides
+ *   irq - vector to route
+ *   cpu - destination CPU
+ *   mar - returned value for Message Address Register
+ *   mdr - returned value for Message Data Register
+ *
+ * Returned Value:
+ *   1: the message must be rewritten, <0: A negative errno
+ *
+ ****************************************************************************/
+
+static int x86_64_pci_affinity_irq(struct pci_bus_s *bus, int irq, int cpu,
+                                   uintptr_t *mar, uint32_t *mdr)
+{
+  int ret;
+
+  UNUSED(bus);
+
+  ret = up_connect_irq(&irq, 1, mar, mdr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *mar &= ~((uintptr_t)0xff << PCI_MSI_DATA_CPUID_SHIFT);
+  *mar |= (uintptr_t)x86_64_cpu_to_loapic(cpu) << PCI_MSI_DATA_CPUID_SHIFT;
+  return 1;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,1265 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Q15 gain of a stream at full volume */
+
+#define AUDIO_MIXER_UNITY   32767
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes one playback stream of the mixer */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct audio_mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;  /* The mixer this stream belongs to */
+  struct dq_queue_s pending;        /* Enqueued buffers not consumed yet */
+  int16_t gain;                     /* Q15 gain of the stream */
+  bool reserved;                    /* The stream has been reserved */
+  bool running;                     /* The stream has been started */
+  bool paused;                      /* The stream has been paused */
+};
+
+/* This structure describes the internal state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The device streams are mixed to */
+  mutex_t lock;                        /* Protects the mixer and streams */
+  struct work_s work;                  /* Mixes from thread context */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                   /* The session on the lower half */
+#endif
+
+  /* The output buffers are allocated once from the lower half, so they
+   * are whatever memory it can stream from, and circulate between the
+   * free list and the lower half afterwards.  The free list is filled
+   * from the lower half callback, so it is protected by a critical
+   * section rather than by the lock.
+   */
+
+  FAR struct ap_buffer_s *outbuf[CONFIG_AUDIO_MIXER_NBUFFERS];
+  struct dq_queue_s outfree;
+
+  uint16_t samprate;                   /* The configured sample rate */
+  uint8_t channels;                    /* The configured channel count */
+  uint8_t nreserved;                   /* Number of reserved streams */
+  uint8_t nrunning;                    /* Number of running streams */
+  bool started;                        /* The lower half is streaming */
+  bool paused;                         /* The lower half is paused */
+
+  int nstreams;
+  struct audio_mixer_stream_s streams[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_notify
+ *
+ * Description:
+ *   Report an event of a stream to its upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_notify(FAR struct audio_mixer_stream_s *stream,
+                               uint16_t reason, FAR struct ap_buffer_s *apb,
+                               uint16_t status)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->export.upper(stream->export.priv, reason, apb, status, stream);
+#else
+  stream->export.upper(stream->export.priv, reason, apb, status);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_accumulate
+ *
+ * Description:
+ *   Add nsamples 16-bit samples scaled by a Q15 gain to the output with
+ *   saturation.  This is the inner loop of the mixer, written so that the
+ *   compiler can vectorize it on targets with saturating SIMD.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_accumulate(FAR int16_t *out, FAR const int16_t *in,
+                                   size_t nsamples, int16_t gain)
+{
+  size_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      int32_t sample = out[i] + (((int32_t)in[i] * gain) >> 15);
+
+      if (sample > INT16_MAX)
+        {
+          sample = INT16_MAX;
+        }
+      else if (sample < INT16_MIN)
+        {
+          sample = INT16_MIN;
+        }
+
+      out[i] = (int16_t)sample;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_available
+ *
+ * Description:
+ *   Return the number of samples queued on a stream and whether the
+ *   stream ends after them.
+ *
+ ****************************************************************************/
+
+static size_t audio_mixer_available(FAR struct audio_mixer_stream_s *stream,
+                                    FAR bool *final)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR dq_entry_t *entry;
+  size_t nsamples = 0;
+
+  *final = false;
+  for (entry = dq_peek(&stream->pending); entry != NULL;
+       entry = dq_next(entry))
+    {
+      apb = (FAR struct ap_buffer_s *)entry;
+      nsamples += (apb->nbytes - apb->curbyte) / sizeof(int16_t);
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          *final = true;
+          break;
+        }
+    }
+
+  return nsamples;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_consume
+ *
+ * Description:
+ *   Mix up to nsamples samples of a stream into the output and return the
+ *   buffers that have been used up to its upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_consume(FAR struct audio_mixer_s *mixer,
+                                FAR struct audio_mixer_stream_s *stream,
+                                FAR int16_t *out, size_t nsamples)
+{
+  FAR struct ap_buffer_s *apb;
+  size_t count;
+  bool final;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pending)) != NULL)
+    {
+      count = (apb->nbytes - apb->curbyte) / sizeof(int16_t);
+      if (count > nsamples)
+        {
+          count = nsamples;
+        }
+
+      audio_mixer_accumulate(out,
+                             (FAR const int16_t *)(apb->samp + apb->curbyte),
+                             count, stream->gain);
+
+      out          += count;
+      nsamples     -= count;
+      apb->curbyte += count * sizeof(int16_t);
+
+      if (apb->nbytes - apb->curbyte >= sizeof(int16_t))
+        {
+          break;
+        }
+
+      /* The buffer is used up, hand it back */
+
+      final = (apb->flags & AUDIO_APB_FINAL) != 0;
+      dq_remfirst(&stream->pending);
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+
+      if (final)
+        {
+          stream->running = false;
+          mixer->nrunning--;
+          audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix the running streams into one output buffer.  A buffer is only
+ *   produced once every running stream that is not about to end has
+ *   samples queued, and it is as long as the shortest of them, so that a
+ *   stream that is late is not padded with silence.
+ *
+ * Returned Value:
+ *   True if the buffer has been filled and should be sent to the lower
+ *   half.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_fill(FAR struct audio_mixer_s *mixer,
+                             FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  size_t frame = mixer->channels > 0 ? mixer->channels : 1;
+  size_t nsamples;
+  size_t longest = 0;
+  size_t avail;
+  bool limited = false;
+  bool active = false;
+  bool final;
+  int i;
+
+  nsamples = apb->nmaxbytes / sizeof(int16_t) / frame * frame;
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->streams[i];
+      if (!stream->running || stream->paused)
+        {
+          continue;
+        }
+
+      avail = audio_mixer_available(stream, &final);
+      if (!final)
+        {
+          if (avail == 0)
+            {
+              return false;
+            }
+
+          if (avail < nsamples)
+            {
+              nsamples = avail;
+            }
+
+          limited = true;
+        }
+      else if (avail > longest)
+        {
+          longest = avail;
+        }
+
+      active = true;
+    }
+
+  if (!active)
+    {
+      return false;
+    }
+
+  /* Only ending streams are left, drain the longest of them */
+
+  if (!limited && longest < nsamples)
+    {
+      nsamples = longest;
+    }
+
+  memset(apb->samp, 0, nsamples * sizeof(int16_t));
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->streams[i];
+      if (stream->running && !stream->paused)
+        {
+          audio_mixer_consume(mixer, stream, (FAR int16_t *)apb->samp,
+                              nsamples);
+        }
+    }
+
+  apb->nbytes  = nsamples * sizeof(int16_t);
+  apb->curbyte = 0;
+  apb->flags   = mixer->nrunning == 0 ? AUDIO_APB_FINAL : 0;
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_process
+ *
+ * Description:
+ *   Fill every free output buffer that can be filled, send them to the
+ *   lower half and start it if needed.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_process(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  bool queued = false;
+  int ret;
+
+  while (mixer->nrunning > 0)
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->outfree);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (!audio_mixer_fill(mixer, apb))
+        {
+          flags = enter_critical_section();
+          dq_addfirst(&apb->dq_entry, &mixer->outfree);
+          leave_critical_section(flags);
+          break;
+        }
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to enqueue a mixed buffer: %d\n", ret);
+          flags = enter_critical_section();
+          dq_addlast(&apb->dq_entry, &mixer->outfree);
+          leave_critical_section(flags);
+          break;
+        }
+
+      queued = true;
+    }
+
+  if (queued && !mixer->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->start(lower, mixer->session);
+#else
+      ret = lower->ops->start(lower);
+#endif
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to start the lower half: %d\n", ret);
+        }
+      else
+        {
+          mixer->started = true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Mix buffers after the lower half returned one.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_process(mixer);
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback of the mixed device.  It may run in
+ *   interrupt context, so the output buffer is only put back on the free
+ *   list here and the mixing is deferred to the work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+  int i;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, &mixer->outfree);
+        leave_critical_section(flags);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+        mixer->started = false;
+        mixer->paused  = false;
+        break;
+
+      default:
+
+        /* Errors and underruns concern every stream being played */
+
+        for (i = 0; i < mixer->nstreams; i++)
+          {
+            if (mixer->streams[i].running)
+              {
+                audio_mixer_notify(&mixer->streams[i], reason, apb, status);
+              }
+          }
+
+        return;
+    }
+
+  work_queue(LPWORK, &mixer->work, audio_mixer_worker, mixer, 0);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_freepool
+ *
+ * Description:
+ *   Free the output buffers.  Called with the lower half stopped.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_freepool(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s bufdesc;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      if (mixer->outbuf[i] == NULL)
+        {
+          continue;
+        }
+
+      if (lower->ops->freebuffer != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session  = mixer->session;
+#endif
+          bufdesc.u.buffer = mixer->outbuf[i];
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(mixer->outbuf[i]);
+        }
+
+      mixer->outbuf[i] = NULL;
+    }
+
+  dq_init(&mixer->outfree);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_allocpool
+ *
+ * Description:
+ *   Allocate the output buffers from the lower half, or from the heap if
+ *   it has no buffer requirements of its own.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_allocpool(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s bufdesc;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session   = mixer->session;
+#endif
+      bufdesc.numbytes  = CONFIG_AUDIO_MIXER_BUFSIZE;
+      bufdesc.u.pbuffer = &mixer->outbuf[i];
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0 || mixer->outbuf[i] == NULL)
+        {
+          mixer->outbuf[i] = NULL;
+          audio_mixer_freepool(mixer);
+          return ret < 0 ? ret : -ENOMEM;
+        }
+
+      dq_addlast(&mixer->outbuf[i]->dq_entry, &mixer->outfree);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stoplower
+ *
+ * Description:
+ *   Stop the lower half once no stream is running any more.  Called with
+ *   the lock held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stoplower(FAR struct audio_mixer_s *mixer)
+{
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  if (mixer->nrunning == 0 && mixer->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->stop(lower, mixer->session);
+#else
+      lower->ops->stop(lower);
+#endif
+      mixer->started = false;
+      mixer->paused  = false;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_halt
+ *
+ * Description:
+ *   Stop a stream and hand its queued buffers back.  Called with the lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_halt(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct ap_buffer_s *apb;
+  bool running = stream->running;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pending))
+         != NULL)
+    {
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+    }
+
+  stream->paused = false;
+  if (running)
+    {
+      stream->running = false;
+      mixer->nrunning--;
+      audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+      audio_mixer_stoplower(mixer);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stream->mixer->lower;
+
+  return lower->ops->getcaps(lower, type, caps);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Configure a stream.  The volume is applied by the mixer.  The output
+ *   format is passed to the lower half while no stream is running and must
+ *   match the current one otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            if (volume > 1000)
+              {
+                ret = -EDOM;
+                break;
+              }
+
+            stream->gain = (int16_t)((int32_t)volume *
+                                     AUDIO_MIXER_UNITY / 1000);
+            break;
+          }
+
+        goto forward;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        if (caps->ac_controls.b[2] != 16)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        if (caps->ac_channels == mixer->channels &&
+            caps->ac_controls.hw[0] == mixer->samprate)
+          {
+            break;
+          }
+
+        /* Another stream is playing in a different format */
+
+        if (mixer->nrunning > 0)
+          {
+            ret = -EBUSY;
+            break;
+          }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+        ret = lower->ops->configure(lower, mixer->session, caps);
+#else
+        ret = lower->ops->configure(lower, caps);
+#endif
+        if (ret >= 0)
+          {
+            mixer->channels = caps->ac_channels;
+            mixer->samprate = caps->ac_controls.hw[0];
+          }
+
+        break;
+
+      default:
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      forward:
+#endif
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+        ret = lower->ops->configure(lower, mixer->session, caps);
+#else
+        ret = lower->ops->configure(lower, caps);
+#endif
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ *
+ * Description:
+ *   Shutdown a stream.  The lower half is shut down with the last stream
+ *   that has been released.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_halt(stream);
+  if (mixer->nreserved == 0)
+    {
+      ret = mixer->lower->ops->shutdown(mixer->lower);
+      mixer->channels = 0;
+      mixer->samprate = 0;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream.  The lower half is started once the first
+ *   mixed buffer has been queued to it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!stream->running)
+    {
+      stream->running = true;
+      mixer->nrunning++;
+    }
+
+  audio_mixer_process(mixer);
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ *
+ * Description: Stop a stream.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_halt(stream);
+
+  /* The other streams may have been waiting for this one */
+
+  audio_mixer_process(mixer);
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause
+ *
+ * Description:
+ *   Pause a stream.  The lower half is paused when every running stream
+ *   is.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!stream->running)
+    {
+      goto out;
+    }
+
+  stream->paused = true;
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      if (mixer->streams[i].running && !mixer->streams[i].paused)
+        {
+          audio_mixer_process(mixer);
+          goto out;
+        }
+    }
+
+  if (mixer->started && !mixer->paused)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->pause(lower, mixer->session);
+#else
+      ret = lower->ops->pause(lower);
+#endif
+      mixer->paused = ret >= 0;
+    }
+
+out:
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resume
+ *
+ * Description: Resume a paused stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  stream->paused = false;
+  if (mixer->paused)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->resume(lower, mixer->session);
+#else
+      ret = lower->ops->resume(lower);
+#endif
+      mixer->paused = ret < 0;
+    }
+
+  audio_mixer_process(mixer);
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue a buffer on a stream.  Its samples are mixed straight from it
+ *   into the output buffers.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+
+  apb->curbyte = 0;
+  dq_addlast(&apb->dq_entry, &stream->pending);
+
+  if (stream->running)
+    {
+      audio_mixer_process(mixer);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ *
+ * Description:
+ *   Perform a device ioctl.  The streams buffer independently of the
+ *   lower half, anything else is passed to it.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stream->mixer->lower;
+
+  if (cmd == AUDIOIOC_GETBUFFERINFO || lower->ops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return lower->ops->ioctl(lower, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ *
+ * Description:
+ *   Reserve a stream.  The lower half is reserved and the output buffers
+ *   are allocated with the first stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  if (mixer->nreserved == 0)
+    {
+      if (lower->ops->reserve != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          ret = lower->ops->reserve(lower, &mixer->session);
+#else
+          ret = lower->ops->reserve(lower);
+#endif
+          if (ret < 0)
+            {
+              goto out;
+            }
+        }
+
+      ret = audio_mixer_allocpool(mixer);
+      if (ret < 0)
+        {
+          if (lower->ops->release != NULL)
+            {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+              lower->ops->release(lower, mixer->session);
+#else
+              lower->ops->release(lower);
+#endif
+            }
+
+          goto out;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  *session = stream;
+#endif
+  stream->reserved = true;
+  stream->gain     = AUDIO_MIXER_UNITY;
+  mixer->nreserved++;
+
+out:
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ *
+ * Description:
+ *   Release a stream.  The output buffers are freed and the lower half is
+ *   released with the last stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!stream->reserved)
+    {
+      goto out;
+    }
+
+  audio_mixer_halt(stream);
+  stream->reserved = false;
+
+  if (--mixer->nreserved == 0)
+    {
+      work_cancel_sync(LPWORK, &mixer->work);
+      audio_mixer_freepool(mixer);
+
+      if (lower->ops->release != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          ret = lower->ops->release(lower, mixer->session);
+#else
+          ret = lower->ops->release(lower);
+#endif
+        }
+    }
+
+out:
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Register nstreams playback devices named "<name>0", "<name>1", ...
+ *   whose 16-bit PCM streams are mixed into the lower half audio device.
+ *
+ * Input Parameters:
+ *   name     - The base name of the stream devices.
+ *   nstreams - The number of streams.
+ *   lower    - The lower half audio driver the streams are mixed into.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name, int nstreams,
+                           FAR struct audio_lowerhalf_s *lower)
+{
+  FAR struct audio_mixer_s *mixer;
+  char devname[32];
+  int ret;
+  int i;
+
+  if (name == NULL || lower == NULL || nstreams <= 0)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     sizeof(struct audio_mixer_stream_s) * (nstreams - 1));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mixer->lock);
+  dq_init(&mixer->outfree);
+  mixer->lower    = lower;
+  mixer->nstreams = nstreams;
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  for (i = 0; i < nstreams; i++)
+    {
+      FAR struct audio_mixer_stream_s *stream = &mixer->streams[i];
+
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->gain       = AUDIO_MIXER_UNITY;
+      dq_init(&stream->pending);
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+
+          /* The streams registered so far keep a reference to the mixer */
+
+          if (i == 0)
+            {
+              nxmutex_destroy(&mixer->lock);
+              kmm_free(mixer);
+            }
+
+          return ret;
+        }
+    }
+
+  return OK;
+}
@@ -179,7 +179,8 @@ int exec_module(FAR struct binary_s *binp,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+        nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (!tcb)
     {
       return -ENOMEM;
@@ -382,7 +383,7 @@ errout_with_envp:
 errout_with_args:
   binfmt_freeargv(argv);
 errout_with_tcb:
-  kmm_free(tcb);
+  nxsched_free_tcb((FAR struct tcb_s *)tcb);
   return ret;
 }
 
@@ -110,6 +110,17 @@ static int elf_loadbinary(FAR struct binary_s *binp,
       return ret;
     }
 
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+  /* Reuse the text of the instances already running from that file */
+
+  ret = libelf_textcache_attach(&loadinfo, filename, &binp->mod.textcache);
+  if (ret != 0)
+    {
+      berr("Failed to share ELF program text: %d\n", ret);
+      goto errout_with_init;
+    }
+
+#endif
   /* Load the program binary */
 
   ret = libelf_load_with_addrenv(&loadinfo);
@@ -185,6 +196,7 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 
   binp->mod.textalloc = (FAR void *)loadinfo.textalloc;
   binp->mod.dataalloc = (FAR void *)loadinfo.datastart;
+  binp->mod.xipbase   = loadinfo.xipbase;
 #  ifdef CONFIG_BINFMT_CONSTRUCTORS
   binp->mod.initarr = loadinfo.initarr;
   binp->mod.finiarr = loadinfo.finiarr;
@@ -233,6 +245,10 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 errout_with_load:
   libelf_unload(&loadinfo);
 errout_with_init:
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+  libelf_textcache_detach(binp->mod.textcache);
+  binp->mod.textcache = NULL;
+#endif
   libelf_uninitialize(&loadinfo);
   return ret;
 }
@@ -106,6 +106,12 @@ const struct userspace_s userspace locate_data(".userspace") =
 #ifdef CONFIG_LIBC_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* User-space copy of the system clock */
+
+#ifdef CONFIG_CLOCK_VDSO
+  .us_vdso          = &g_clock_vdso,
+#endif
 };
 
 /****************************************************************************
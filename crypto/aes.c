@@ -32,6 +32,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <string.h>
 #include <sys/types.h>
 #include <crypto/aes.h>
@@ -845,6 +847,26 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_AES_ARCH
+  uint32_t skey[60];
+  unsigned u;
+
+  /* The instructions take the plain round keys, as bytes in sk_exp */
+
+  ctx->num_rounds = aes_keysched_base(skey, key, len);
+  if (ctx->num_rounds == 0)
+    {
+      return -1;
+    }
+
+  for (u = 0; u < ((ctx->num_rounds + 1) << 2); u++)
+    {
+      enc32le((FAR uint8_t *)ctx->sk_exp + (u << 2), skey[u]);
+    }
+
+  explicit_bzero(skey, sizeof(skey));
+  aes_arch_setkey(ctx);
+#else
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -852,12 +874,17 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
     }
 
   aes_ct_skey_expand(ctx->sk_exp, ctx->num_rounds, ctx->sk);
+#endif
+
   return 0;
 }
 
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_AES_ARCH
+  aes_arch_encrypt_ecb(ctx, src, dst, num_blocks);
+#else
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -903,11 +930,15 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
           break;
         }
     }
+#endif
 }
 
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_AES_ARCH
+  aes_arch_decrypt_ecb(ctx, src, dst, num_blocks);
+#else
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -953,6 +984,7 @@ void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
           break;
         }
     }
+#endif
 }
 
 void aes_encrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
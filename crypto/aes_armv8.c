@@ -0,0 +1,227 @@
+/****************************************************************************
+ * crypto/aes_armv8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <arm_neon.h>
+#include <sys/types.h>
+
+#include <crypto/aes.h>
+#include <crypto/gmac.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The Crypto Extension is optional in ARMv8-A, so the toolchain may not
+ * have it enabled; CRYPTO_ARM64_CE says the core has it.
+ */
+
+#define ARM64_CE(insn, d, n) \
+  __asm__ (".arch_extension crypto\n" insn : "+w" (d) : "w" (n))
+
+#define ARM64_CE1(insn, d) \
+  __asm__ (".arch_extension crypto\n" insn : "+w" (d))
+
+/* The decryption round keys follow the encryption ones in sk_exp */
+
+#define AES_ARMV8_DKEY      240
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint8x16_t aes_armv8_aese(uint8x16_t s, uint8x16_t k)
+{
+  ARM64_CE("aese %0.16b, %1.16b", s, k);
+  return s;
+}
+
+static inline uint8x16_t aes_armv8_aesmc(uint8x16_t s)
+{
+  ARM64_CE1("aesmc %0.16b, %0.16b", s);
+  return s;
+}
+
+static inline uint8x16_t aes_armv8_aesd(uint8x16_t s, uint8x16_t k)
+{
+  ARM64_CE("aesd %0.16b, %1.16b", s, k);
+  return s;
+}
+
+static inline uint8x16_t aes_armv8_aesimc(uint8x16_t s)
+{
+  ARM64_CE1("aesimc %0.16b, %0.16b", s);
+  return s;
+}
+
+/* Carry-less product of the low (pmull) or high (pmull2) 64-bit lanes */
+
+static inline uint8x16_t aes_armv8_pmull(uint8x16_t a, uint8x16_t b)
+{
+  ARM64_CE("pmull %0.1q, %0.1d, %1.1d", a, b);
+  return a;
+}
+
+static inline uint8x16_t aes_armv8_pmull2(uint8x16_t a, uint8x16_t b)
+{
+  ARM64_CE("pmull2 %0.1q, %0.2d, %1.2d", a, b);
+  return a;
+}
+
+static inline void aes_armv8_loadkeys(FAR uint8x16_t *rk,
+                                      FAR const uint8_t *sk,
+                                      unsigned num_rounds)
+{
+  unsigned i;
+
+  for (i = 0; i <= num_rounds; i++)
+    {
+      rk[i] = vld1q_u8(sk + 16 * i);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void aes_arch_setkey(FAR AES_CTX *ctx)
+{
+  FAR uint8_t *sk = (FAR uint8_t *)ctx->sk_exp;
+  FAR uint8_t *dk = sk + AES_ARMV8_DKEY;
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  /* Equivalent inverse cipher: the keys in reverse order, with
+   * InvMixColumns applied to all but the first and the last.
+   */
+
+  vst1q_u8(dk, vld1q_u8(sk + 16 * nr));
+  for (i = 1; i < nr; i++)
+    {
+      vst1q_u8(dk + 16 * i,
+               aes_armv8_aesimc(vld1q_u8(sk + 16 * (nr - i))));
+    }
+
+  vst1q_u8(dk + 16 * nr, vld1q_u8(sk));
+}
+
+void aes_arch_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                          FAR uint8_t *dst, size_t num_blocks)
+{
+  uint8x16_t rk[AES_MAXROUNDS + 1];
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  aes_armv8_loadkeys(rk, (FAR const uint8_t *)ctx->sk_exp, nr);
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      uint8x16_t s = vld1q_u8(src);
+
+      for (i = 0; i < nr - 1; i++)
+        {
+          s = aes_armv8_aesmc(aes_armv8_aese(s, rk[i]));
+        }
+
+      s = veorq_u8(aes_armv8_aese(s, rk[nr - 1]), rk[nr]);
+      vst1q_u8(dst, s);
+    }
+}
+
+void aes_arch_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                          FAR uint8_t *dst, size_t num_blocks)
+{
+  uint8x16_t dk[AES_MAXROUNDS + 1];
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  aes_armv8_loadkeys(dk, (FAR const uint8_t *)ctx->sk_exp + AES_ARMV8_DKEY,
+                     nr);
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      uint8x16_t s = vld1q_u8(src);
+
+      for (i = 0; i < nr - 1; i++)
+        {
+          s = aes_armv8_aesimc(aes_armv8_aesd(s, dk[i]));
+        }
+
+      s = veorq_u8(aes_armv8_aesd(s, dk[nr - 1]), dk[nr]);
+      vst1q_u8(dst, s);
+    }
+}
+
+/****************************************************************************
+ * Name: ghash_arch_update
+ *
+ * Description:
+ *   GHASH with PMULL.  Reversing the bits of every byte turns the GCM bit
+ *   order into the natural one, with the coefficient of x^i in bit i of
+ *   the little-endian 128-bit value, so that a carry-less product needs
+ *   no shifting.  The product is done with three multiplications
+ *   (Karatsuba) and reduced in two folds by x^128 = x^7 + x^2 + x + 1.
+ *
+ ****************************************************************************/
+
+void ghash_arch_update(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint8x16_t zero = vdupq_n_u8(0);
+  uint8x16_t k = vreinterpretq_u8_u64(vdupq_n_u64(0x87));
+  uint8x16_t h = vrbitq_u8(vld1q_u8(ctx->H));
+  uint8x16_t hk = veorq_u8(h, vextq_u8(h, h, 8));
+  uint8x16_t y = vrbitq_u8(vld1q_u8(ctx->Z));
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, X += GMAC_BLOCK_LEN)
+    {
+      uint8x16_t lo;
+      uint8x16_t hi;
+      uint8x16_t mid;
+      uint8x16_t t;
+
+      y   = veorq_u8(y, vrbitq_u8(vld1q_u8(X)));
+      lo  = aes_armv8_pmull(y, h);
+      hi  = aes_armv8_pmull2(y, h);
+      mid = aes_armv8_pmull(veorq_u8(y, vextq_u8(y, y, 8)), hk);
+      mid = veorq_u8(mid, veorq_u8(lo, hi));
+      lo  = veorq_u8(lo, vextq_u8(zero, mid, 8));
+      hi  = veorq_u8(hi, vextq_u8(mid, zero, 8));
+
+      /* Fold the top 64 bits into the middle ones, then those into the
+       * bottom 128 bits.
+       */
+
+      t   = aes_armv8_pmull2(hi, k);
+      lo  = veorq_u8(lo, vextq_u8(zero, t, 8));
+      hi  = veorq_u8(hi, vextq_u8(t, zero, 8));
+      t   = aes_armv8_pmull(hi, k);
+      y   = veorq_u8(lo, t);
+    }
+
+  vst1q_u8(ctx->S, vrbitq_u8(y));
+  vst1q_u8(ctx->Z, vrbitq_u8(y));
+}
@@ -0,0 +1,302 @@
+/****************************************************************************
+ * crypto/aes_rv64zkn.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <crypto/aes.h>
+#include <crypto/gmac.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The scalar cryptography instructions (Zkne, Zknd, Zbkb and Zbkc) are
+ * emitted with .insn, so that the toolchain does not need to know them;
+ * CRYPTO_RISCV_ZKN says the core has them.
+ */
+
+#define RV_INSN_R(f3, f7, rd, rs1, rs2) \
+  __asm__ (".insn r 0x33, " #f3 ", " #f7 ", %0, %1, %2" \
+           : "=r" (rd) : "r" (rs1), "r" (rs2))
+
+#define RV_INSN_I(f3, imm, rd, rs1) \
+  __asm__ (".insn i 0x13, " #f3 ", %0, %1, " #imm \
+           : "=r" (rd) : "r" (rs1))
+
+/* The decryption round keys follow the encryption ones in sk_exp, whose
+ * alignment is only that of uint32_t; the rounds work on a copy.
+ */
+
+#define AES_RV64_DKEY       240
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* aes64es/aes64esm: ShiftRows and SubBytes (and MixColumns) of the
+ * 128-bit state {rs2, rs1}, giving its low 64 bits.
+ */
+
+static inline uint64_t aes_rv64_es(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(0, 0x19, rd, rs1, rs2);
+  return rd;
+}
+
+static inline uint64_t aes_rv64_esm(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(0, 0x1b, rd, rs1, rs2);
+  return rd;
+}
+
+static inline uint64_t aes_rv64_ds(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(0, 0x1d, rd, rs1, rs2);
+  return rd;
+}
+
+static inline uint64_t aes_rv64_dsm(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(0, 0x1f, rd, rs1, rs2);
+  return rd;
+}
+
+/* aes64im: InvMixColumns of two columns */
+
+static inline uint64_t aes_rv64_im(uint64_t rs1)
+{
+  uint64_t rd;
+
+  RV_INSN_I(1, 0x300, rd, rs1);
+  return rd;
+}
+
+/* clmul/clmulh: low and high 64 bits of the carry-less product */
+
+static inline uint64_t aes_rv64_clmul(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(1, 5, rd, rs1, rs2);
+  return rd;
+}
+
+static inline uint64_t aes_rv64_clmulh(uint64_t rs1, uint64_t rs2)
+{
+  uint64_t rd;
+
+  RV_INSN_R(3, 5, rd, rs1, rs2);
+  return rd;
+}
+
+/* brev8: reverse the bits of every byte */
+
+static inline uint64_t aes_rv64_brev8(uint64_t rs1)
+{
+  uint64_t rd;
+
+  RV_INSN_I(5, 0x687, rd, rs1);
+  return rd;
+}
+
+static inline uint64_t aes_rv64_load(FAR const uint8_t *p)
+{
+  uint64_t x;
+
+  memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+static inline void aes_rv64_store(FAR uint8_t *p, uint64_t x)
+{
+  memcpy(p, &x, sizeof(x));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void aes_arch_setkey(FAR AES_CTX *ctx)
+{
+  uint64_t sk[2 * (AES_MAXROUNDS + 1)];
+  uint64_t dk[2 * (AES_MAXROUNDS + 1)];
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  memcpy(sk, ctx->sk_exp, 16 * (nr + 1));
+
+  /* Equivalent inverse cipher: the keys in reverse order, with
+   * InvMixColumns applied to all but the first and the last.
+   */
+
+  dk[0] = sk[2 * nr];
+  dk[1] = sk[2 * nr + 1];
+  for (i = 1; i < nr; i++)
+    {
+      dk[2 * i]     = aes_rv64_im(sk[2 * (nr - i)]);
+      dk[2 * i + 1] = aes_rv64_im(sk[2 * (nr - i) + 1]);
+    }
+
+  dk[2 * nr]     = sk[0];
+  dk[2 * nr + 1] = sk[1];
+
+  memcpy((FAR uint8_t *)ctx->sk_exp + AES_RV64_DKEY, dk, 16 * (nr + 1));
+  explicit_bzero(sk, sizeof(sk));
+  explicit_bzero(dk, sizeof(dk));
+}
+
+void aes_arch_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                          FAR uint8_t *dst, size_t num_blocks)
+{
+  uint64_t rk[2 * (AES_MAXROUNDS + 1)];
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  memcpy(rk, ctx->sk_exp, 16 * (nr + 1));
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      uint64_t s0 = aes_rv64_load(src) ^ rk[0];
+      uint64_t s1 = aes_rv64_load(src + 8) ^ rk[1];
+      uint64_t t0;
+      uint64_t t1;
+
+      for (i = 1; i < nr; i++)
+        {
+          t0 = aes_rv64_esm(s0, s1);
+          t1 = aes_rv64_esm(s1, s0);
+          s0 = t0 ^ rk[2 * i];
+          s1 = t1 ^ rk[2 * i + 1];
+        }
+
+      t0 = aes_rv64_es(s0, s1);
+      t1 = aes_rv64_es(s1, s0);
+      aes_rv64_store(dst, t0 ^ rk[2 * nr]);
+      aes_rv64_store(dst + 8, t1 ^ rk[2 * nr + 1]);
+    }
+}
+
+void aes_arch_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                          FAR uint8_t *dst, size_t num_blocks)
+{
+  uint64_t dk[2 * (AES_MAXROUNDS + 1)];
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  memcpy(dk, (FAR uint8_t *)ctx->sk_exp + AES_RV64_DKEY, 16 * (nr + 1));
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      uint64_t s0 = aes_rv64_load(src) ^ dk[0];
+      uint64_t s1 = aes_rv64_load(src + 8) ^ dk[1];
+      uint64_t t0;
+      uint64_t t1;
+
+      for (i = 1; i < nr; i++)
+        {
+          t0 = aes_rv64_dsm(s0, s1);
+          t1 = aes_rv64_dsm(s1, s0);
+          s0 = t0 ^ dk[2 * i];
+          s1 = t1 ^ dk[2 * i + 1];
+        }
+
+      t0 = aes_rv64_ds(s0, s1);
+      t1 = aes_rv64_ds(s1, s0);
+      aes_rv64_store(dst, t0 ^ dk[2 * nr]);
+      aes_rv64_store(dst + 8, t1 ^ dk[2 * nr + 1]);
+    }
+}
+
+/****************************************************************************
+ * Name: ghash_arch_update
+ *
+ * Description:
+ *   GHASH with clmul/clmulh.  Reversing the bits of every byte turns the
+ *   GCM bit order into the natural one, with the coefficient of x^i in bit
+ *   i of the little-endian 128-bit value, so that a carry-less product
+ *   needs no shifting.  The product is done with three multiplications
+ *   (Karatsuba) and reduced in two folds by x^128 = x^7 + x^2 + x + 1.
+ *
+ ****************************************************************************/
+
+void ghash_arch_update(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint64_t h0 = aes_rv64_brev8(aes_rv64_load(ctx->H));
+  uint64_t h1 = aes_rv64_brev8(aes_rv64_load(ctx->H + 8));
+  uint64_t h2 = h0 ^ h1;
+  uint64_t y0 = aes_rv64_brev8(aes_rv64_load(ctx->Z));
+  uint64_t y1 = aes_rv64_brev8(aes_rv64_load(ctx->Z + 8));
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, X += GMAC_BLOCK_LEN)
+    {
+      uint64_t p0;
+      uint64_t p1;
+      uint64_t p2;
+      uint64_t p3;
+      uint64_t m0;
+      uint64_t m1;
+
+      y0 ^= aes_rv64_brev8(aes_rv64_load(X));
+      y1 ^= aes_rv64_brev8(aes_rv64_load(X + 8));
+
+      p0  = aes_rv64_clmul(y0, h0);
+      p1  = aes_rv64_clmulh(y0, h0);
+      p2  = aes_rv64_clmul(y1, h1);
+      p3  = aes_rv64_clmulh(y1, h1);
+      m0  = aes_rv64_clmul(y0 ^ y1, h2) ^ p0 ^ p2;
+      m1  = aes_rv64_clmulh(y0 ^ y1, h2) ^ p1 ^ p3;
+      p1 ^= m0;
+      p2 ^= m1;
+
+      /* Fold the top 64 bits into the middle ones, then those into the
+       * bottom 128 bits.
+       */
+
+      p1 ^= aes_rv64_clmul(p3, 0x87);
+      p2 ^= aes_rv64_clmulh(p3, 0x87);
+      y0  = p0 ^ aes_rv64_clmul(p2, 0x87);
+      y1  = p1 ^ aes_rv64_clmulh(p2, 0x87);
+    }
+
+  y0 = aes_rv64_brev8(y0);
+  y1 = aes_rv64_brev8(y1);
+  aes_rv64_store(ctx->S, y0);
+  aes_rv64_store(ctx->S + 8, y1);
+  aes_rv64_store(ctx->Z, y0);
+  aes_rv64_store(ctx->Z + 8, y1);
+}
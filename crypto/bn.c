@@ -53,7 +53,10 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
 #include <crypto/bn.h>
+#include <nuttx/kmalloc.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -63,6 +66,25 @@
 
 #define require(p, msg) ASSERT(p && msg)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Montgomery context: the limbs of the modulus, R^2 mod n, the product
+ * scratch and the caller's limbs share one allocation.
+ */
+
+struct bn_mont_s
+{
+  FAR uint32_t *n;
+  FAR uint32_t *rr;
+  FAR uint32_t *t;
+  FAR uint32_t *extra;
+  uint32_t n0;                  /* -n^-1 mod 2^32 */
+  int nl;                       /* Limbs of n */
+  size_t size;
+};
+
 /****************************************************************************
  * Private Functions Prototype
  ****************************************************************************/
@@ -162,6 +184,224 @@ static void rshift_one_bit(FAR struct bn *a)
   a->array[BN_ARRAY_SIZE - 1] >>= 1;
 }
 
+/* Number of significant words of a */
+
+static int bn_words(FAR const struct bn *a)
+{
+  int i;
+
+  for (i = BN_ARRAY_SIZE; i > 0 && a->array[i - 1] == 0; i--);
+
+  return i;
+}
+
+/* Montgomery arithmetic for bignum_mod_exp().  The numbers are converted
+ * to 32-bit limbs, least significant first, and only the nl limbs of the
+ * modulus are processed; x is kept as x * R mod n, R = 2^(32 * nl).
+ */
+
+static inline int bn_bit(FAR const struct bn *a, int i)
+{
+  return (a->array[i / (8 * WORD_SIZE)] >> (i % (8 * WORD_SIZE))) & 1;
+}
+
+static void bn_to_limbs(FAR uint32_t *l, FAR const struct bn *a, int nl)
+{
+  int i;
+
+  for (i = 0; i < nl; i++)
+    {
+      l[i] = (uint32_t)a->array[4 * i] |
+             ((uint32_t)a->array[4 * i + 1] << 8) |
+             ((uint32_t)a->array[4 * i + 2] << 16) |
+             ((uint32_t)a->array[4 * i + 3] << 24);
+    }
+}
+
+static void bn_from_limbs(FAR struct bn *a, FAR const uint32_t *l, int nl)
+{
+  int i;
+
+  bignum_init(a);
+  for (i = 0; i < nl; i++)
+    {
+      a->array[4 * i]     = (DTYPE)l[i];
+      a->array[4 * i + 1] = (DTYPE)(l[i] >> 8);
+      a->array[4 * i + 2] = (DTYPE)(l[i] >> 16);
+      a->array[4 * i + 3] = (DTYPE)(l[i] >> 24);
+    }
+}
+
+/* r -= n if hi is set or r >= n, without a data dependent branch */
+
+static void bn_mont_csub(FAR uint32_t *r, FAR const uint32_t *n, int nl,
+                         uint32_t hi)
+{
+  uint64_t d;
+  uint32_t borrow = 0;
+  uint32_t mask;
+  int i;
+
+  for (i = 0; i < nl; i++)
+    {
+      d = (uint64_t)r[i] - n[i] - borrow;
+      borrow = (uint32_t)(d >> 63);
+    }
+
+  mask = -(uint32_t)((hi != 0) | (borrow == 0));
+  borrow = 0;
+  for (i = 0; i < nl; i++)
+    {
+      d = (uint64_t)r[i] - (n[i] & mask) - borrow;
+      r[i] = (uint32_t)d;
+      borrow = (uint32_t)(d >> 63);
+    }
+}
+
+/* r = a * b / R mod n (CIOS), for a, b < n.  t holds nl + 2 limbs and r
+ * may be a or b.
+ */
+
+static void bn_mont_mul(FAR struct bn_mont_s *m, FAR uint32_t *r,
+                        FAR const uint32_t *a, FAR const uint32_t *b)
+{
+  FAR const uint32_t *n = m->n;
+  FAR uint32_t *t = m->t;
+  int nl = m->nl;
+  uint64_t c;
+  uint32_t q;
+  int i;
+  int j;
+
+  memset(t, 0, (nl + 2) * sizeof(uint32_t));
+
+  for (i = 0; i < nl; i++)
+    {
+      c = 0;
+      for (j = 0; j < nl; j++)
+        {
+          c += (uint64_t)a[j] * b[i] + t[j];
+          t[j] = (uint32_t)c;
+          c >>= 32;
+        }
+
+      c += t[nl];
+      t[nl] = (uint32_t)c;
+      t[nl + 1] = (uint32_t)(c >> 32);
+
+      q = t[0] * m->n0;
+      c = ((uint64_t)q * n[0] + t[0]) >> 32;
+      for (j = 1; j < nl; j++)
+        {
+          c += (uint64_t)q * n[j] + t[j];
+          t[j - 1] = (uint32_t)c;
+          c >>= 32;
+        }
+
+      c += t[nl];
+      t[nl - 1] = (uint32_t)c;
+      t[nl] = t[nl + 1] + (uint32_t)(c >> 32);
+    }
+
+  bn_mont_csub(t, n, nl, t[nl]);
+  memcpy(r, t, nl * sizeof(uint32_t));
+}
+
+/* Set up the modulus, -n^-1 mod 2^32 and R^2 mod n, with extra limbs
+ * after those for the caller.
+ */
+
+static int bn_mont_init(FAR struct bn_mont_s *m, FAR struct bn *n,
+                        int extra)
+{
+  uint32_t inv;
+  uint32_t hi;
+  int nl;
+  int i;
+  int j;
+
+  nl = (bn_words(n) + 3) / 4;
+  if (nl == 0 || (n->array[0] & 1) == 0)
+    {
+      return -EINVAL;
+    }
+
+  m->size = (3 * nl + 2 + extra * nl) * sizeof(uint32_t);
+  m->n = kmm_malloc(m->size);
+  if (m->n == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  m->nl = nl;
+  m->rr = m->n + nl;
+  m->t = m->rr + nl;
+  m->extra = m->t + nl + 2;
+  bn_to_limbs(m->n, n, nl);
+
+  /* Newton's iteration doubles the correct low bits, from the 3 of n */
+
+  inv = m->n[0];
+  for (i = 0; i < 4; i++)
+    {
+      inv *= 2 - m->n[0] * inv;
+    }
+
+  m->n0 = -inv;
+
+  /* R^2 mod n by doubling 1 modulo n, 2 * 32 * nl times */
+
+  memset(m->rr, 0, nl * sizeof(uint32_t));
+  m->rr[0] = 1;
+  for (i = 0; i < 64 * nl; i++)
+    {
+      hi = m->rr[nl - 1] >> 31;
+      for (j = nl - 1; j > 0; j--)
+        {
+          m->rr[j] = (m->rr[j] << 1) | (m->rr[j - 1] >> 31);
+        }
+
+      m->rr[0] <<= 1;
+      bn_mont_csub(m->rr, m->n, nl, hi);
+    }
+
+  return 0;
+}
+
+static void bn_mont_free(FAR struct bn_mont_s *m)
+{
+  explicit_bzero(m->n, m->size);
+  kmm_free(m->n);
+}
+
+/* r = a * R mod n */
+
+static void bn_mont_load(FAR struct bn_mont_s *m, FAR uint32_t *r,
+                         FAR struct bn *a, FAR struct bn *n)
+{
+  struct bn ta;
+
+  if (bignum_cmp_abs(a, n) != SMALLER)
+    {
+      bignum_mod(a, n, &ta);
+      a = &ta;
+    }
+
+  bn_to_limbs(r, a, m->nl);
+  bn_mont_mul(m, r, r, m->rr);
+}
+
+/* res = x / R mod n */
+
+static void bn_mont_store(FAR struct bn_mont_s *m, FAR struct bn *res,
+                          FAR uint32_t *x)
+{
+  memset(m->rr, 0, m->nl * sizeof(uint32_t));
+  m->rr[0] = 1;
+  bn_mont_mul(m, x, x, m->rr);
+  bn_from_limbs(res, x, m->nl);
+}
+
 static
 void bignum_add_sub(struct bn *a, struct bn *b, struct bn *c, int flip)
 {
@@ -438,8 +678,10 @@ void bignum_sub_abs(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
 
 void bignum_mul(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
 {
-  struct bn row;
   struct bn tmp;
+  DTYPE_TMP carry;
+  int na;
+  int nb;
   int i;
   int j;
 
@@ -447,36 +689,47 @@ void bignum_mul(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
   require(b, "b is null");
   require(c, "c is null");
 
-  bignum_init(c);
+  /* Schoolbook product over the significant words only, truncated to
+   * BN_ARRAY_SIZE words; c may be a or b.
+   */
 
-  for (i = 0; i < BN_ARRAY_SIZE; ++i)
+  na = bn_words(a);
+  nb = bn_words(b);
+  bignum_init(&tmp);
+
+  for (i = 0; i < na; ++i)
     {
-      bignum_init(&row);
+      if (a->array[i] == 0)
+        {
+          continue;
+        }
 
-      for (j = 0; j < BN_ARRAY_SIZE; ++j)
+      carry = 0;
+      for (j = 0; j < nb && i + j < BN_ARRAY_SIZE; ++j)
         {
-          if (i + j < BN_ARRAY_SIZE)
-            {
-              bignum_init(&tmp);
-              DTYPE_TMP intermediate =
-                ((DTYPE_TMP)a->array[i] * (DTYPE_TMP)b->array[j]);
-              bignum_from_int(&tmp, intermediate);
-              lshift_word(&tmp, i + j);
-              bignum_add_abs(&tmp, &row, &row);
-            }
+          carry += (DTYPE_TMP)a->array[i] * b->array[j] + tmp.array[i + j];
+          tmp.array[i + j] = (DTYPE)(carry & MAX_VAL);
+          carry >>= 8 * WORD_SIZE;
         }
 
-      bignum_add_abs(c, &row, c);
+      for (j = i + nb; carry != 0 && j < BN_ARRAY_SIZE; ++j)
+        {
+          carry += tmp.array[j];
+          tmp.array[j] = (DTYPE)(carry & MAX_VAL);
+          carry >>= 8 * WORD_SIZE;
+        }
     }
 
-  if (bignum_is_zero(c) != 0)
+  if (bignum_is_zero(&tmp) != 0)
     {
-      c->s = 1;
+      tmp.s = 1;
     }
   else
     {
-      c->s = a->s * b->s;
+      tmp.s = a->s * b->s;
     }
+
+  bignum_assign(c, &tmp);
 }
 
 void bignum_div(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
@@ -864,12 +1117,204 @@ void bignum_assign(FAR struct bn *dst, FAR struct bn *src)
   dst->s = src->s;
 }
 
+int bignum_mod_exp(FAR struct bn *a, FAR struct bn *b,
+                   FAR struct bn *n, FAR struct bn *res)
+{
+  struct bn_mont_s m;
+  FAR uint32_t *x;
+  FAR uint32_t *g;
+  unsigned val;
+  bool first = true;
+  int nbits;
+  int tsize;
+  int ret;
+  int w;
+  int i;
+  int j;
+  int k;
+
+  require(a, "a is null");
+  require(b, "b is null");
+  require(n, "n is null");
+  require(res, "res is null");
+
+  /* Sliding window of w bits: a table of the odd powers a^1 ... a^(2^w - 1)
+   * saves all but one multiplication per window.  The windows follow the
+   * exponent bits, so the time is not independent of b.
+   */
+
+  nbits = bn_words(b) * 8 * WORD_SIZE;
+  while (nbits > 0 && bn_bit(b, nbits - 1) == 0)
+    {
+      nbits--;
+    }
+
+  w = nbits > 256 ? 5 : nbits > 32 ? 4 : 1;
+  tsize = 1 << (w - 1);
+
+  ret = bn_mont_init(&m, n, 1 + tsize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  x = m.extra;
+  g = x + m.nl;
+
+  bn_mont_load(&m, g, a, n);
+  if (tsize > 1)
+    {
+      bn_mont_mul(&m, x, g, g);
+      for (k = 1; k < tsize; k++)
+        {
+          bn_mont_mul(&m, g + k * m.nl, g + (k - 1) * m.nl, x);
+        }
+    }
+
+  /* x = 1 * R, for a zero exponent */
+
+  memset(x, 0, m.nl * sizeof(uint32_t));
+  x[0] = 1;
+  bn_mont_mul(&m, x, x, m.rr);
+
+  for (i = nbits - 1; i >= 0; )
+    {
+      if (bn_bit(b, i) == 0)
+        {
+          bn_mont_mul(&m, x, x, x);
+          i--;
+          continue;
+        }
+
+      /* The longest window of at most w bits that ends with a one */
+
+      j = i - w + 1 > 0 ? i - w + 1 : 0;
+      while (bn_bit(b, j) == 0)
+        {
+          j++;
+        }
+
+      for (val = 0, k = i; k >= j; k--)
+        {
+          val = (val << 1) | bn_bit(b, k);
+          if (!first)
+            {
+              bn_mont_mul(&m, x, x, x);
+            }
+        }
+
+      if (first)
+        {
+          memcpy(x, g + (val >> 1) * m.nl, m.nl * sizeof(uint32_t));
+          first = false;
+        }
+      else
+        {
+          bn_mont_mul(&m, x, x, g + (val >> 1) * m.nl);
+        }
+
+      i = j - 1;
+    }
+
+  bn_mont_store(&m, res, x);
+  bn_mont_free(&m);
+  return 0;
+}
+
+int bignum_mod_exp_crt(FAR struct bn *x, FAR struct bn *p,
+                       FAR struct bn *q, FAR struct bn *dp,
+                       FAR struct bn *dq, FAR struct bn *qinv,
+                       FAR struct bn *res)
+{
+  struct bn_mont_s m;
+  struct bn m1;
+  struct bn m2;
+  struct bn h;
+  FAR uint32_t *u;
+  FAR uint32_t *v;
+  int ret;
+
+  require(x, "x is null");
+  require(p, "p is null");
+  require(q, "q is null");
+  require(dp, "dp is null");
+  require(dq, "dq is null");
+  require(qinv, "qinv is null");
+  require(res, "res is null");
+
+  /* Garner: m1 = x^dp mod p, m2 = x^dq mod q,
+   * res = m2 + q * (qinv * (m1 - m2) mod p).  The two half size
+   * exponentiations cost about a quarter of the one with d mod pq.
+   */
+
+  ret = bignum_mod_exp(x, dp, p, &m1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = bignum_mod_exp(x, dq, q, &m2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (bignum_cmp_abs(&m2, p) != SMALLER)
+    {
+      bignum_mod(&m2, p, &h);
+    }
+  else
+    {
+      bignum_assign(&h, &m2);
+    }
+
+  if (bignum_cmp_abs(&m1, &h) == SMALLER)
+    {
+      bignum_add_abs(&m1, p, &m1);
+    }
+
+  bignum_sub_abs(&m1, &h, &h);
+
+  /* h = qinv * h mod p: (qinv * R) * (h * R) / R / R */
+
+  ret = bn_mont_init(&m, p, 2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  u = m.extra;
+  v = u + m.nl;
+  bn_mont_load(&m, u, qinv, p);
+  bn_mont_load(&m, v, &h, p);
+  bn_mont_mul(&m, u, u, v);
+  bn_mont_store(&m, &h, u);
+  bn_mont_free(&m);
+
+  bignum_mul(&h, q, &h);
+  bignum_add_abs(&h, &m2, res);
+  res->s = 1;
+
+  explicit_bzero(&m1, sizeof(m1));
+  explicit_bzero(&m2, sizeof(m2));
+  explicit_bzero(&h, sizeof(h));
+  return 0;
+}
+
 void pow_mod_faster(FAR struct bn *a, FAR struct bn *b,
                     FAR struct bn *n, FAR struct bn *res)
 {
   struct bn tmpa;
   struct bn tmpb;
   struct bn tmp;
+
+  /* Odd moduli, which is all of RSA and DH, take the Montgomery path */
+
+  if ((n->array[0] & 1) != 0 && bignum_mod_exp(a, b, n, res) == 0)
+    {
+      return;
+    }
+
   bignum_assign(&tmpa, a);
   bignum_assign(&tmpb, b);
 
@@ -58,6 +58,33 @@ chacha_ctx;
     }                                            \
   while (0)
 
+/* Four blocks at a time where the core has 128-bit SIMD: lane i of each
+ * vector holds a word of block i, so the rounds are the scalar ones done
+ * on whole vectors and the compiler emits NEON, SSE2 or fixed-length RVV
+ * instructions for them.
+ */
+
+#if defined(__GNUC__) && (defined(__ARM_NEON) || defined(__SSE2__) || \
+    defined(__riscv_v_fixed_vlen))
+#  define CHACHA_X4
+#endif
+
+#ifdef CHACHA_X4
+typedef uint32_t chacha_v4 __attribute__((vector_size(16)));
+
+#define ROTATE4(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define QUARTERROUND4(a, b, c, d)                 \
+  do                                              \
+    {                                             \
+      a += b; d = ROTATE4(d ^ a, 16);             \
+      c += d; b = ROTATE4(b ^ c, 12);             \
+      a += b; d = ROTATE4(d ^ a, 8);              \
+      c += d; b = ROTATE4(b ^ c, 7);              \
+    }                                             \
+  while (0)
+#endif
+
 static const char sigma[16] = "expand 32-byte k";
 static const char tau[16] = "expand 16-byte k";
 
@@ -146,6 +173,79 @@ static void chacha_ivsetup(FAR chacha_ctx *x,
   x->input[15] = U8TO32_LITTLE(iv + 4);
 }
 
+#ifdef CHACHA_X4
+static void chacha_encrypt_x4(FAR chacha_ctx *x,
+                              FAR const uint8_t *m,
+                              FAR uint8_t *c)
+{
+  chacha_v4 j[16];
+  chacha_v4 v[16];
+  uint32_t w;
+  int b;
+  int n;
+
+  for (n = 0; n < 16; n++)
+    {
+      for (b = 0; b < 4; b++)
+        {
+          j[n][b] = x->input[n];
+        }
+    }
+
+  /* Consecutive block counters, carrying into the high word */
+
+  for (b = 0; b < 4; b++)
+    {
+      j[12][b] = PLUS(x->input[12], b);
+      j[13][b] = PLUS(x->input[13], j[12][b] < x->input[12]);
+    }
+
+  for (n = 0; n < 16; n++)
+    {
+      v[n] = j[n];
+    }
+
+  for (n = 20; n > 0; n -= 2)
+    {
+      QUARTERROUND4(v[0], v[4], v[8], v[12]);
+      QUARTERROUND4(v[1], v[5], v[9], v[13]);
+      QUARTERROUND4(v[2], v[6], v[10], v[14]);
+      QUARTERROUND4(v[3], v[7], v[11], v[15]);
+      QUARTERROUND4(v[0], v[5], v[10], v[15]);
+      QUARTERROUND4(v[1], v[6], v[11], v[12]);
+      QUARTERROUND4(v[2], v[7], v[8], v[13]);
+      QUARTERROUND4(v[3], v[4], v[9], v[14]);
+    }
+
+  for (n = 0; n < 16; n++)
+    {
+      v[n] += j[n];
+    }
+
+  for (b = 0; b < 4; b++, c += 64)
+    {
+      for (n = 0; n < 16; n++)
+        {
+          w = v[n][b];
+#ifndef KEYSTREAM_ONLY
+          w = XOR(w, U8TO32_LITTLE(m + 4 * n));
+#endif
+          U32TO8_LITTLE(c + 4 * n, w);
+        }
+
+#ifndef KEYSTREAM_ONLY
+      m += 64;
+#endif
+    }
+
+  x->input[12] = PLUS(x->input[12], 4);
+  if (x->input[12] < 4)
+    {
+      x->input[13] = PLUSONE(x->input[13]);
+    }
+}
+#endif
+
 static void chacha_encrypt_bytes(FAR chacha_ctx *x,
                                  FAR const uint8_t *m,
                                  FAR uint8_t *c,
@@ -192,6 +292,21 @@ static void chacha_encrypt_bytes(FAR chacha_ctx *x,
       return;
     }
 
+#ifdef CHACHA_X4
+  for (; bytes >= 256; bytes -= 256, c += 256)
+    {
+      chacha_encrypt_x4(x, m, c);
+#ifndef KEYSTREAM_ONLY
+      m += 256;
+#endif
+    }
+
+  if (!bytes)
+    {
+      return;
+    }
+#endif
+
   j0 = x->input[0];
   j1 = x->input[1];
   j2 = x->input[2];
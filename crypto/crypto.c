@@ -36,7 +36,7 @@
 #include <errno.h>
 #include <crypto/cryptodev.h>
 #include <nuttx/fs/fs.h>
-#include <nuttx/mutex.h>
+#include <nuttx/rwsem.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
@@ -51,7 +51,11 @@ int crypto_drivers_num = 0;
  * Private Data
  ****************************************************************************/
 
-static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
+/* Writers change the driver table and the sessions, readers run requests
+ * so that requests of different sessions may run in parallel.
+ */
+
+static rw_semaphore_t g_crypto_lock = RWSEM_INITIALIZER;
 
 /****************************************************************************
  * Public Functions
@@ -76,7 +80,7 @@ int crypto_newsession(FAR uint64_t *sid,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* The algorithm we use here is pretty stupid; just use the
    * first driver that supports all the algorithms we need. Do
@@ -200,7 +204,7 @@ int crypto_newsession(FAR uint64_t *sid,
 
   if (hid == -1)
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -216,7 +220,7 @@ int crypto_newsession(FAR uint64_t *sid,
       crypto_drivers[hid].cc_sessions++;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -243,7 +247,7 @@ int crypto_freesession(uint64_t sid)
       return -ENOENT;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers[hid].cc_sessions)
     {
@@ -267,7 +271,7 @@ int crypto_freesession(uint64_t sid)
       explicit_bzero(&crypto_drivers[hid], sizeof(struct cryptocap));
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -278,7 +282,7 @@ int crypto_get_driverid(uint8_t flags)
   FAR struct cryptocap *newdrv;
   int i;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers_num == 0)
     {
@@ -288,7 +292,7 @@ int crypto_get_driverid(uint8_t flags)
       if (crypto_drivers == NULL)
         {
           crypto_drivers_num = 0;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -304,7 +308,7 @@ int crypto_get_driverid(uint8_t flags)
         {
           crypto_drivers[i].cc_sessions = 1; /* Mark */
           crypto_drivers[i].cc_flags = flags;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return i;
         }
     }
@@ -315,7 +319,7 @@ int crypto_get_driverid(uint8_t flags)
     {
       if (crypto_drivers_num >= CRYPTO_DRIVERS_MAX)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -323,7 +327,7 @@ int crypto_get_driverid(uint8_t flags)
                           sizeof(struct cryptocap));
       if (newdrv == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -338,13 +342,13 @@ int crypto_get_driverid(uint8_t flags)
 
       kmm_free(crypto_drivers);
       crypto_drivers = newdrv;
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return i;
     }
 
   /* Shouldn't really get here... */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return -1;
 }
 
@@ -363,7 +367,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRK_ALGORITHM_MAX; i++)
     {
@@ -377,7 +381,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
 
   crypto_drivers[driverid].cc_kprocess = kprocess;
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -397,7 +401,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRYPTO_ALGORITHM_MAX; i++)
     {
@@ -414,7 +418,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
   crypto_drivers[driverid].cc_freesession = freeses;
   crypto_drivers[driverid].cc_sessions = 0; /* Unmark */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
 
   return 0;
 }
@@ -430,14 +434,14 @@ int crypto_unregister(uint32_t driverid, int alg)
   int i = CRYPTO_ALGORITHM_MAX + 1;
   uint32_t ses;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* Sanity checks. */
 
   if (driverid >= crypto_drivers_num || crypto_drivers == NULL ||
       alg <= 0 || alg > (CRYPTO_ALGORITHM_MAX + 1))
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -445,7 +449,7 @@ int crypto_unregister(uint32_t driverid, int alg)
     {
       if (crypto_drivers[driverid].cc_alg[alg] == 0)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -EINVAL;
         }
 
@@ -479,7 +483,7 @@ int crypto_unregister(uint32_t driverid, int alg)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -498,7 +502,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_read(&g_crypto_lock);
   for (hid = 0; hid < crypto_drivers_num; hid++)
     {
       if ((crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE) &&
@@ -524,7 +528,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
   if (hid == crypto_drivers_num)
     {
       krp->krp_status = -ENODEV;
-      nxmutex_unlock(&g_crypto_lock);
+      up_read(&g_crypto_lock);
       return 0;
     }
 
@@ -538,7 +542,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       krp->krp_status = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_read(&g_crypto_lock);
   return 0;
 }
 
@@ -549,6 +553,7 @@ int crypto_invoke(FAR struct cryptop *crp)
   FAR struct cryptodesc *crd;
   uint64_t nid;
   uint32_t hid;
+  bool cleanup;
   int error;
 
   /* Sanity checks. */
@@ -558,55 +563,58 @@ int crypto_invoke(FAR struct cryptop *crp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_read(&g_crypto_lock);
   if (crp->crp_desc == NULL || crypto_drivers == NULL)
     {
       crp->crp_etype = -EINVAL;
-      nxmutex_unlock(&g_crypto_lock);
+      up_read(&g_crypto_lock);
       return 0;
     }
 
   hid = (crp->crp_sid >> 32) & 0xffffffff;
-  if (hid >= crypto_drivers_num)
+  if (hid >= crypto_drivers_num ||
+      (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP) ||
+      crypto_drivers[hid].cc_process == NULL)
     {
       goto migrate;
     }
 
-  if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP)
-    {
-      crypto_freesession(crp->crp_sid);
-      goto migrate;
-    }
-
-  if (crypto_drivers[hid].cc_process == NULL)
-    {
-      goto migrate;
-    }
+  /* The statistics are not exact when requests run in parallel */
 
   crypto_drivers[hid].cc_operations++;
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
 
   error = crypto_drivers[hid].cc_process(crp);
-  if (error)
+  if (error == -ERESTART)
     {
-      if (error == -ERESTART)
-        {
-          /* Unregister driver and migrate session. */
+      /* Unregister driver and migrate session. */
 
-          crypto_unregister(hid, CRYPTO_ALGORITHM_MAX + 1);
-          goto migrate;
-        }
-      else
-        {
-          crp->crp_etype = error;
-        }
+      up_read(&g_crypto_lock);
+      crypto_unregister(hid, CRYPTO_ALGORITHM_MAX + 1);
+      goto migrated;
+    }
+  else if (error)
+    {
+      crp->crp_etype = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_read(&g_crypto_lock);
   return 0;
 
 migrate:
 
+  /* The session functions take the lock for writing */
+
+  cleanup = hid < crypto_drivers_num &&
+            (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP) != 0;
+  up_read(&g_crypto_lock);
+  if (cleanup)
+    {
+      crypto_freesession(crp->crp_sid);
+    }
+
+migrated:
+
   /* Migrate session. */
 
   for (crd = crp->crp_desc; crd->crd_next; crd = crd->crd_next)
@@ -620,7 +628,6 @@ migrate:
     }
 
   crp->crp_etype = -EAGAIN;
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -635,8 +642,6 @@ void crypto_freereq(FAR struct cryptop *crp)
       return;
     }
 
-  nxmutex_lock(&g_crypto_lock);
-
   while ((crd = crp->crp_desc) != NULL)
     {
       crp->crp_desc = crd->crd_next;
@@ -644,7 +649,6 @@ void crypto_freereq(FAR struct cryptop *crp)
     }
 
   kmm_free(crp);
-  nxmutex_unlock(&g_crypto_lock);
 }
 
 /* Acquire a set of crypto descriptors. */
@@ -654,12 +658,9 @@ FAR struct cryptop *crypto_getreq(int num)
   FAR struct cryptodesc *crd;
   FAR struct cryptop *crp;
 
-  nxmutex_lock(&g_crypto_lock);
-
   crp = kmm_malloc(sizeof(struct cryptop));
   if (crp == NULL)
     {
-      nxmutex_unlock(&g_crypto_lock);
       return NULL;
     }
 
@@ -670,7 +671,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crd = kmm_calloc(1, sizeof(struct cryptodesc));
       if (crd == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
           crypto_freereq(crp);
           return NULL;
         }
@@ -679,7 +679,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crp->crp_desc = crd;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
   return crp;
 }
 
@@ -42,8 +42,12 @@
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
+#include <fcntl.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -72,6 +76,18 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+struct cryptodev_job
+{
+  TAILQ_ENTRY(cryptodev_job) next; /* In the session queue, then done */
+  struct crypt_op cop;
+  uint32_t reqid;
+  int status;
+};
+
+TAILQ_HEAD(cryptodev_joblist, cryptodev_job);
+#endif
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
@@ -90,6 +106,14 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+
+  mutex_t lock;                    /* Serializes the operations */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr;
+  struct cryptodev_joblist jobs;   /* Queued, not started */
+  struct work_s work;
+  bool busy;                       /* The worker is queued or running */
+#endif
 };
 
 struct fcrypt
@@ -98,6 +122,13 @@ struct fcrypt
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
   int sesn;
   FAR struct pollfd *fds;
+  mutex_t lock;                    /* Protects fds and the job queues */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  struct cryptodev_joblist done;   /* Completed, not read yet */
+  sem_t waitsem;                   /* Wakes up read() and close() */
+  unsigned pending;                /* Queued or running jobs */
+  unsigned waiters;                /* Threads waiting on waitsem */
+#endif
 };
 
 /****************************************************************************
@@ -139,6 +170,11 @@ static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
+static void cryptodev_worker(FAR void *);
+#endif
+static void cryptodev_initfcr(FAR struct fcrypt *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
                                   FAR struct crypt_kop *);
 
@@ -179,6 +215,11 @@ static struct inode g_cryptoinode =
   .u.i_ops = &g_cryptofops
 };
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static mutex_t g_cryptodev_wqlock = NXMUTEX_INITIALIZER;
+static FAR struct kwork_wqueue_s *g_cryptodev_wq;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -188,7 +229,64 @@ static struct inode g_cryptoinode =
 static ssize_t cryptof_read(FAR struct file *filep,
                             FAR char *buffer, size_t len)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = filep->f_priv;
+  FAR struct crypt_result *res = (FAR struct crypt_result *)buffer;
+  FAR struct cryptodev_job *job;
+  ssize_t nread = 0;
+  int ret;
+
+  /* Return the results of the completed asynchronous operations */
+
+  if (len < sizeof(struct crypt_result))
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&fcr->lock);
+  while (TAILQ_EMPTY(&fcr->done))
+    {
+      if (fcr->pending == 0)
+        {
+          nxmutex_unlock(&fcr->lock);
+          return 0;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxmutex_unlock(&fcr->lock);
+          return -EAGAIN;
+        }
+
+      fcr->waiters++;
+      nxmutex_unlock(&fcr->lock);
+      ret = nxsem_wait(&fcr->waitsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxmutex_lock(&fcr->lock);
+    }
+
+  while (len >= sizeof(struct crypt_result) &&
+         (job = TAILQ_FIRST(&fcr->done)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->done, job, next);
+      res->reqid = job->reqid;
+      res->status = job->status;
+      kmm_free(job);
+
+      res++;
+      len -= sizeof(struct crypt_result);
+      nread += sizeof(struct crypt_result);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  return nread;
+#else
   return -EIO;
+#endif
 }
 
 /* ARGSUSED */
@@ -355,6 +453,13 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        if (cse->busy)
+          {
+            return -EBUSY;
+          }
+#endif
+
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -366,8 +471,15 @@ bail:
             return -EINVAL;
           }
 
+        nxmutex_lock(&cse->lock);
         error = cryptodev_op(cse, cop);
+        nxmutex_unlock(&cse->lock);
         break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCNCRYPTM:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -556,6 +668,144 @@ bail:
   return error;
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+
+/* Queue a batch of operations on the sessions' workers */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_job *job;
+  FAR struct crypt_n_op *req;
+  FAR struct csession *cse;
+  unsigned i;
+
+  if (mop->count == 0 || mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&g_cryptodev_wqlock);
+  if (g_cryptodev_wq == NULL)
+    {
+      g_cryptodev_wq =
+        work_queue_create("cryptodev",
+                          CONFIG_CRYPTO_CRYPTODEV_ASYNC_PRIORITY, NULL,
+                          CONFIG_CRYPTO_CRYPTODEV_ASYNC_STACKSIZE,
+                          CONFIG_CRYPTO_CRYPTODEV_ASYNC_NTHREADS);
+    }
+
+  nxmutex_unlock(&g_cryptodev_wqlock);
+  if (g_cryptodev_wq == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      req = &mop->reqs[i];
+      cse = csefind(fcr, req->cop.ses);
+      if (cse == NULL)
+        {
+          req->status = -EINVAL;
+          continue;
+        }
+
+      job = kmm_malloc(sizeof(struct cryptodev_job));
+      if (job == NULL)
+        {
+          req->status = -ENOMEM;
+          continue;
+        }
+
+      job->cop = req->cop;
+      job->reqid = req->reqid;
+      job->status = 0;
+
+      nxmutex_lock(&fcr->lock);
+      if (fcr->pending >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_MAXJOBS)
+        {
+          nxmutex_unlock(&fcr->lock);
+          kmm_free(job);
+          req->status = -EAGAIN;
+          continue;
+        }
+
+      /* One worker per session runs its jobs in order */
+
+      TAILQ_INSERT_TAIL(&cse->jobs, job, next);
+      fcr->pending++;
+      if (!cse->busy)
+        {
+          cse->busy = true;
+          work_queue_wq(g_cryptodev_wq, &cse->work, cryptodev_worker,
+                        cse, 0);
+        }
+
+      nxmutex_unlock(&fcr->lock);
+      req->status = 0;
+    }
+
+  return OK;
+}
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct csession *cse = arg;
+  FAR struct fcrypt *fcr = cse->fcr;
+  FAR struct cryptodev_job *job;
+
+  nxmutex_lock(&fcr->lock);
+  job = TAILQ_FIRST(&cse->jobs);
+  while (job != NULL)
+    {
+      TAILQ_REMOVE(&cse->jobs, job, next);
+      nxmutex_unlock(&fcr->lock);
+
+      nxmutex_lock(&cse->lock);
+      job->status = cryptodev_op(cse, &job->cop);
+      nxmutex_unlock(&cse->lock);
+
+      nxmutex_lock(&fcr->lock);
+      TAILQ_INSERT_TAIL(&fcr->done, job, next);
+
+      /* The session is not touched once it is idle: it may be freed as
+       * soon as the lock is released.
+       */
+
+      job = TAILQ_FIRST(&cse->jobs);
+      if (job == NULL)
+        {
+          cse->busy = false;
+        }
+
+      fcr->pending--;
+      while (fcr->waiters > 0)
+        {
+          fcr->waiters--;
+          nxsem_post(&fcr->waitsem);
+        }
+
+      if (fcr->fds != NULL)
+        {
+          poll_notify(&fcr->fds, 1, POLLIN);
+        }
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+#endif
+
+static void cryptodev_initfcr(FAR struct fcrypt *fcr)
+{
+  TAILQ_INIT(&fcr->csessions);
+  TAILQ_INIT(&fcr->crpk_ret);
+  nxmutex_init(&fcr->lock);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_INIT(&fcr->done);
+  nxsem_init(&fcr->waitsem, 0, 0);
+#endif
+}
+
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp = NULL;
@@ -802,33 +1052,42 @@ static int cryptof_poll(FAR struct file *filep,
                         FAR struct pollfd *fds, bool setup)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
+  bool ready;
+  int ret = OK;
 
   if (fcr == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
+  nxmutex_lock(&fcr->lock);
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      ready = !TAILQ_EMPTY(&fcr->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      ready |= !TAILQ_EMPTY(&fcr->done);
+#endif
+
+      if (ready)
         {
           poll_notify(&fds, 1, POLLIN);
-          return OK;
         }
-
-      if (fcr->fds)
+      else if (fcr->fds)
         {
-          return -EBUSY;
+          ret = -EBUSY;
+        }
+      else
+        {
+          fcr->fds = fds;
         }
-
-      fcr->fds = fds;
     }
   else
     {
       fcr->fds = NULL;
     }
 
-  return OK;
+  nxmutex_unlock(&fcr->lock);
+  return ret;
 }
 
 /* ARGSUSED */
@@ -838,8 +1097,35 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_job *job;
+#endif
   int i;
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* The workers use the sessions and the caller's buffers: wait for the
+   * queued jobs, then drop the results nobody read.
+   */
+
+  nxmutex_lock(&fcr->lock);
+  while (fcr->pending > 0)
+    {
+      fcr->waiters++;
+      nxmutex_unlock(&fcr->lock);
+      nxsem_wait_uninterruptible(&fcr->waitsem);
+      nxmutex_lock(&fcr->lock);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  while ((job = TAILQ_FIRST(&fcr->done)))
+    {
+      TAILQ_REMOVE(&fcr->done, job, next);
+      kmm_free(job);
+    }
+
+  nxsem_destroy(&fcr->waitsem);
+#endif
+
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
@@ -862,6 +1148,7 @@ static int cryptof_close(FAR struct file *filep)
       kmm_free(krp);
     }
 
+  nxmutex_destroy(&fcr->lock);
   kmm_free(fcr);
   filep->f_priv = NULL;
   return 0;
@@ -900,7 +1187,7 @@ static int cryptof_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  TAILQ_INIT(&fcrd->csessions);
+  cryptodev_initfcr(fcrd);
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1025,13 +1312,15 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
             return -ENOMEM;
           }
 
-        TAILQ_INIT(&fcr->csessions);
-        TAILQ_INIT(&fcr->crpk_ret);
-
+        cryptodev_initfcr(fcr);
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
         if (fd < 0)
           {
+            nxmutex_destroy(&fcr->lock);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+            nxsem_destroy(&fcr->waitsem);
+#endif
             kmm_free(fcr);
             return fd;
           }
@@ -1105,6 +1394,13 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+      nxmutex_init(&cse->lock);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      cse->fcr = fcr;
+      TAILQ_INIT(&cse->jobs);
+      memset(&cse->work, 0, sizeof(cse->work));
+      cse->busy = false;
+#endif
       cseadd(fcr, cse);
     }
 
@@ -1126,6 +1422,7 @@ static int csefree(FAR struct csession *cse)
       kmm_free(cse->mackey);
     }
 
+  nxmutex_destroy(&cse->lock);
   kmm_free(cse);
   return error;
 }
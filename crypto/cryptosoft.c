@@ -1184,6 +1184,41 @@ int swcr_mod_exp(struct cryptkop *krp)
   return 0;
 }
 
+static int swcr_mod_exp_crt(FAR struct cryptkop *krp)
+{
+  struct bn v[6];
+  struct bn r;
+  int len;
+  int ret;
+  int i;
+
+  /* x, p, q, dp, dq, qinv in, x^d mod pq out */
+
+  for (i = 0; i < 6; i++)
+    {
+      len = krp->krp_param[i].crp_nbits / 8;
+      if (len > sizeof(v[i].array))
+        {
+          return -EINVAL;
+        }
+
+      bignum_init(&v[i]);
+      memcpy(v[i].array, krp->krp_param[i].crp_p, len);
+    }
+
+  len = krp->krp_param[6].crp_nbits / 8;
+  ret = bignum_mod_exp_crt(&v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &r);
+  if (ret == 0)
+    {
+      memcpy(krp->krp_param[6].crp_p, r.array,
+             MIN(len, sizeof(r.array)));
+    }
+
+  explicit_bzero(v, sizeof(v));
+  explicit_bzero(&r, sizeof(r));
+  return ret;
+}
+
 static int swcr_dh_make_public(FAR struct cryptkop *krp)
 {
   /* Curve25519 is used for testing. In fact,
@@ -1264,6 +1299,13 @@ int swcr_kprocess(struct cryptkop *krp)
             goto done;
           }
 
+        break;
+      case CRK_MOD_EXP_CRT:
+        if ((krp->krp_status = swcr_mod_exp_crt(krp)) != 0)
+          {
+            goto done;
+          }
+
         break;
       case CRK_DH_MAKE_PUBLIC:
         if ((krp->krp_status = swcr_dh_make_public(krp) != 0))
@@ -1355,6 +1397,7 @@ void swcr_init(void)
                   swcr_freesession, swcr_process);
 
   kalgs[CRK_MOD_EXP] = CRYPTO_ALG_FLAG_SUPPORTED;
+  kalgs[CRK_MOD_EXP_CRT] = CRYPTO_ALG_FLAG_SUPPORTED;
   kalgs[CRK_DH_MAKE_PUBLIC] = CRYPTO_ALG_FLAG_SUPPORTED;
   kalgs[CRK_DH_COMPUTE_KEY] = CRYPTO_ALG_FLAG_SUPPORTED;
   kalgs[CRK_RSA_PKCS15_VERIFY] = CRYPTO_ALG_FLAG_SUPPORTED;
@@ -39,6 +39,37 @@
  * Private Types
  ****************************************************************************/
 
+/* Where the compiler has a 64 x 64 = 128 bit multiplication, field
+ * elements are kept in five 51-bit limbs rather than ten 25.5-bit ones.
+ */
+
+#ifdef __SIZEOF_INT128__
+#  define CURVE25519_64BIT
+#endif
+
+#ifdef CURVE25519_64BIT
+
+/* fe means field element. Here the field is \Z/(2^255-19). An element t,
+ * entries t[0]...t[4], represents the integer t[0]+2^51 t[1]+2^102 t[2]+
+ * 2^153 t[3]+2^204 t[4].
+ * fe limbs are bounded by 2^51 plus a small carry, fe_loose limbs by
+ * 2^54.  Multiplication and carrying produce fe from fe_loose.
+ */
+
+typedef struct fe
+{
+  uint64_t v[5];
+} fe;
+
+typedef struct fe_loose
+{
+  uint64_t v[5];
+} fe_loose;
+
+typedef unsigned __int128 fe_u128;
+
+#else
+
 /* fe means field element. Here the field is \Z/(2^255-19). An element t,
  * entries t[0]...t[9], represents the integer t[0]+2^26 t[1]+2^51 t[2]+2^77
  * t[3]+2^102 t[4]+...+2^230 t[9].
@@ -61,6 +92,8 @@ typedef struct fe_loose
   uint32_t v[10];
 } fe_loose;
 
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -75,6 +108,269 @@ static const uint8_t g_base_point[CURVE25519_KEY_SIZE] =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CURVE25519_64BIT
+
+#define FE_MASK51 (((uint64_t)1 << 51) - 1)
+
+static uint64_t get_unaligned_le64(FAR const uint8_t *a)
+{
+  uint64_t l;
+
+  memcpy(&l, a, sizeof(l));
+  return letoh64(l);
+}
+
+static void put_unaligned_le64(FAR uint8_t *a, uint64_t l)
+{
+  l = htole64(l);
+  memcpy(a, &l, sizeof(l));
+}
+
+static void fe_frombytes(FAR fe *h, FAR const uint8_t *s)
+{
+  /* Ignores top bit of s. */
+
+  uint64_t a0 = get_unaligned_le64(s);
+  uint64_t a1 = get_unaligned_le64(s + 8);
+  uint64_t a2 = get_unaligned_le64(s + 16);
+  uint64_t a3 = get_unaligned_le64(s + 24);
+
+  h->v[0] = a0 & FE_MASK51;
+  h->v[1] = ((a0 >> 51) | (a1 << 13)) & FE_MASK51;
+  h->v[2] = ((a1 >> 38) | (a2 << 26)) & FE_MASK51;
+  h->v[3] = ((a2 >> 25) | (a3 << 39)) & FE_MASK51;
+  h->v[4] = (a3 >> 12) & FE_MASK51;
+}
+
+/* Carry the limbs of r into h, folding the top carry back by 19 */
+
+static void fe_carry(FAR uint64_t h[5], FAR fe_u128 r[5])
+{
+  uint64_t c;
+
+  c = (uint64_t)(r[0] >> 51);
+  h[0] = (uint64_t)r[0] & FE_MASK51;
+  r[1] += c;
+  c = (uint64_t)(r[1] >> 51);
+  h[1] = (uint64_t)r[1] & FE_MASK51;
+  r[2] += c;
+  c = (uint64_t)(r[2] >> 51);
+  h[2] = (uint64_t)r[2] & FE_MASK51;
+  r[3] += c;
+  c = (uint64_t)(r[3] >> 51);
+  h[3] = (uint64_t)r[3] & FE_MASK51;
+  r[4] += c;
+  c = (uint64_t)(r[4] >> 51);
+  h[4] = (uint64_t)r[4] & FE_MASK51;
+  h[0] += c * 19;
+  h[1] += h[0] >> 51;
+  h[0] &= FE_MASK51;
+}
+
+static void fe_tobytes(uint8_t s[32], FAR const fe *f)
+{
+  uint64_t t[5];
+  int i;
+
+  memcpy(t, f->v, sizeof(t));
+
+  /* Carry twice, so that t is below 2^255 */
+
+  for (i = 0; i < 2; i++)
+    {
+      t[1] += t[0] >> 51;
+      t[0] &= FE_MASK51;
+      t[2] += t[1] >> 51;
+      t[1] &= FE_MASK51;
+      t[3] += t[2] >> 51;
+      t[2] &= FE_MASK51;
+      t[4] += t[3] >> 51;
+      t[3] &= FE_MASK51;
+      t[0] += (t[4] >> 51) * 19;
+      t[4] &= FE_MASK51;
+    }
+
+  /* Add 19 and carry: t >= p now shows as a carry out of bit 255, which
+   * is folded back by 19 again.  Adding 2^255 - 19 then and dropping
+   * bit 255 leaves t mod p.
+   */
+
+  t[0] += 19;
+  t[1] += t[0] >> 51;
+  t[0] &= FE_MASK51;
+  t[2] += t[1] >> 51;
+  t[1] &= FE_MASK51;
+  t[3] += t[2] >> 51;
+  t[2] &= FE_MASK51;
+  t[4] += t[3] >> 51;
+  t[3] &= FE_MASK51;
+  t[0] += (t[4] >> 51) * 19;
+  t[4] &= FE_MASK51;
+
+  t[0] += ((uint64_t)1 << 51) - 19;
+  t[1] += ((uint64_t)1 << 51) - 1;
+  t[2] += ((uint64_t)1 << 51) - 1;
+  t[3] += ((uint64_t)1 << 51) - 1;
+  t[4] += ((uint64_t)1 << 51) - 1;
+
+  t[1] += t[0] >> 51;
+  t[0] &= FE_MASK51;
+  t[2] += t[1] >> 51;
+  t[1] &= FE_MASK51;
+  t[3] += t[2] >> 51;
+  t[2] &= FE_MASK51;
+  t[4] += t[3] >> 51;
+  t[3] &= FE_MASK51;
+  t[4] &= FE_MASK51;
+
+  put_unaligned_le64(s, t[0] | (t[1] << 51));
+  put_unaligned_le64(s + 8, (t[1] >> 13) | (t[2] << 38));
+  put_unaligned_le64(s + 16, (t[2] >> 26) | (t[3] << 25));
+  put_unaligned_le64(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+/* h = f + g
+ * Can overlap h with f or g.
+ */
+
+static void fe_add(FAR fe_loose *h, FAR const fe *f, FAR const fe *g)
+{
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      h->v[i] = f->v[i] + g->v[i];
+    }
+}
+
+/* h = f - g, as f + 2p - g
+ * Can overlap h with f or g.
+ */
+
+static void fe_sub(FAR fe_loose *h, FAR const fe *f, FAR const fe *g)
+{
+  h->v[0] = f->v[0] + 0xfffffffffffda - g->v[0];
+  h->v[1] = f->v[1] + 0xffffffffffffe - g->v[1];
+  h->v[2] = f->v[2] + 0xffffffffffffe - g->v[2];
+  h->v[3] = f->v[3] + 0xffffffffffffe - g->v[3];
+  h->v[4] = f->v[4] + 0xffffffffffffe - g->v[4];
+}
+
+static void fe_mul_impl(uint64_t out[5], const uint64_t f[5],
+                        const uint64_t g[5])
+{
+  uint64_t g1_19 = g[1] * 19;
+  uint64_t g2_19 = g[2] * 19;
+  uint64_t g3_19 = g[3] * 19;
+  uint64_t g4_19 = g[4] * 19;
+  fe_u128 r[5];
+
+  r[0] = (fe_u128)f[0] * g[0] + (fe_u128)f[1] * g4_19 +
+         (fe_u128)f[2] * g3_19 + (fe_u128)f[3] * g2_19 +
+         (fe_u128)f[4] * g1_19;
+  r[1] = (fe_u128)f[0] * g[1] + (fe_u128)f[1] * g[0] +
+         (fe_u128)f[2] * g4_19 + (fe_u128)f[3] * g3_19 +
+         (fe_u128)f[4] * g2_19;
+  r[2] = (fe_u128)f[0] * g[2] + (fe_u128)f[1] * g[1] +
+         (fe_u128)f[2] * g[0] + (fe_u128)f[3] * g4_19 +
+         (fe_u128)f[4] * g3_19;
+  r[3] = (fe_u128)f[0] * g[3] + (fe_u128)f[1] * g[2] +
+         (fe_u128)f[2] * g[1] + (fe_u128)f[3] * g[0] +
+         (fe_u128)f[4] * g4_19;
+  r[4] = (fe_u128)f[0] * g[4] + (fe_u128)f[1] * g[3] +
+         (fe_u128)f[2] * g[2] + (fe_u128)f[3] * g[1] +
+         (fe_u128)f[4] * g[0];
+
+  fe_carry(out, r);
+}
+
+static void fe_mul_ttt(FAR fe *h, FAR const fe *f, FAR const fe *g)
+{
+  fe_mul_impl(h->v, f->v, g->v);
+}
+
+static void fe_mul_tlt(FAR fe *h, FAR const fe_loose *f,
+                       FAR const fe *g)
+{
+  fe_mul_impl(h->v, f->v, g->v);
+}
+
+static void fe_mul_tll(FAR fe *h, FAR const fe_loose *f,
+                       FAR const fe_loose *g)
+{
+  fe_mul_impl(h->v, f->v, g->v);
+}
+
+static void fe_sqr_impl(uint64_t out[5], const uint64_t f[5])
+{
+  uint64_t f0_2 = f[0] * 2;
+  uint64_t f1_2 = f[1] * 2;
+  uint64_t f1_38 = f[1] * 38;
+  uint64_t f2_38 = f[2] * 38;
+  uint64_t f3_38 = f[3] * 38;
+  uint64_t f3_19 = f[3] * 19;
+  uint64_t f4_19 = f[4] * 19;
+  fe_u128 r[5];
+
+  r[0] = (fe_u128)f[0] * f[0] + (fe_u128)f1_38 * f[4] +
+         (fe_u128)f2_38 * f[3];
+  r[1] = (fe_u128)f0_2 * f[1] + (fe_u128)f2_38 * f[4] +
+         (fe_u128)f3_19 * f[3];
+  r[2] = (fe_u128)f0_2 * f[2] + (fe_u128)f[1] * f[1] +
+         (fe_u128)f3_38 * f[4];
+  r[3] = (fe_u128)f0_2 * f[3] + (fe_u128)f1_2 * f[2] +
+         (fe_u128)f4_19 * f[4];
+  r[4] = (fe_u128)f0_2 * f[4] + (fe_u128)f1_2 * f[3] +
+         (fe_u128)f[2] * f[2];
+
+  fe_carry(out, r);
+}
+
+static void fe_sq_tl(FAR fe *h, FAR const fe_loose *f)
+{
+  fe_sqr_impl(h->v, f->v);
+}
+
+static void fe_sq_tt(FAR fe *h, FAR const fe *f)
+{
+  fe_sqr_impl(h->v, f->v);
+}
+
+/* Replace (f,g) with (g,f) if b == 1;
+ * replace (f,g) with (f,g) if b == 0.
+ *
+ * Preconditions: b in {0,1}
+ */
+
+static void fe_cswap(FAR fe *f, FAR fe *g, unsigned int b)
+{
+  uint64_t mask = 0 - (uint64_t)b;
+  unsigned i;
+
+  for (i = 0; i < 5; i++)
+    {
+      uint64_t x = f->v[i] ^ g->v[i];
+      x         &= mask;
+      f->v[i]   ^= x;
+      g->v[i]   ^= x;
+    }
+}
+
+static void fe_mul121666(FAR fe *h, FAR const fe_loose *f)
+{
+  fe_u128 r[5];
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      r[i] = (fe_u128)f->v[i] * 121666;
+    }
+
+  fe_carry(h->v, r);
+}
+
+#else /* CURVE25519_64BIT */
+
 static uint32_t get_unaligned_le32(FAR const uint8_t *a)
 {
   uint32_t l;
@@ -382,33 +678,36 @@ static void fe_tobytes(uint8_t s[32], FAR const fe *f)
   s[31] = h[9] >> 18;
 }
 
+#endif /* CURVE25519_64BIT */
+
 /* h = f */
 
 static void fe_copy(FAR fe *h, FAR const fe *f)
 {
-  memmove(h, f, sizeof(uint32_t) * 10);
+  memmove(h, f, sizeof(h->v));
 }
 
 static void fe_copy_lt(FAR fe_loose *h, FAR const fe *f)
 {
-  memmove(h, f, sizeof(uint32_t) * 10);
+  memmove(h, f, sizeof(h->v));
 }
 
 /* h = 0 */
 
 static void fe_0(FAR fe *h)
 {
-  memset(h, 0, sizeof(uint32_t) * 10);
+  memset(h, 0, sizeof(h->v));
 }
 
 /* h = 1 */
 
 static void fe_1(FAR fe *h)
 {
-  memset(h, 0, sizeof(uint32_t) * 10);
+  memset(h, 0, sizeof(h->v));
   h->v[0] = 1;
 }
 
+#ifndef CURVE25519_64BIT
 static void fe_add_impl(uint32_t out[10], const uint32_t in1[10],
                         const uint32_t in2[10])
 {
@@ -798,6 +1097,7 @@ static void fe_sq_tt(FAR fe *h, FAR const fe *f)
 {
   fe_sqr_impl(h->v, f->v);
 }
+#endif /* !CURVE25519_64BIT */
 
 static void fe_loose_invert(FAR fe *out, FAR const fe_loose *z)
 {
@@ -884,6 +1184,7 @@ static void fe_invert(FAR fe *out, FAR const fe *z)
   fe_loose_invert(out, &l);
 }
 
+#ifndef CURVE25519_64BIT
 /* Replace (f,g) with (g,f) if b == 1;
  * replace (f,g) with (f,g) if b == 0.
  *
@@ -1062,6 +1363,7 @@ static void fe_mul121666(FAR fe *h, FAR const fe_loose *f)
 {
   fe_mul_121666_impl(h->v, f->v);
 }
+#endif /* !CURVE25519_64BIT */
 
 /****************************************************************************
  * Public Functions
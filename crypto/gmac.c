@@ -30,6 +30,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
 #include <strings.h>
 #include <sys/param.h>
@@ -45,9 +47,15 @@ void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
 
 /* Allow overriding with optimized MD function */
 
+#ifdef CONFIG_CRYPTO_AES_ARCH
+CODE void (*ghash_update)(FAR GHASH_CTX *,
+                          FAR uint8_t *,
+                          size_t) = ghash_arch_update;
+#else
 CODE void (*ghash_update)(FAR GHASH_CTX *,
                           FAR uint8_t *,
                           size_t) = ghash_update_mi;
+#endif
 
 /* Computes a block multiplication in the GF(2^128) */
 
@@ -94,27 +102,154 @@ void ghash_gfmul(FAR uint32_t *X, FAR uint32_t *Y, FAR uint32_t *product)
   product[3] = htobe32(z[3]);
 }
 
-void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+/* Constant-time carry-less multiplication (after BearSSL's ghash_ctmul64):
+ * integer multiplications of the operands with holes every four bits, so
+ * that the carries never reach a bit that is kept.  Only the low 64 bits
+ * of the 128-bit product are exact; the high ones come from the product
+ * of the bit-reversed operands.
+ */
+
+static inline uint64_t ghash_bmul64(uint64_t x, uint64_t y)
+{
+  uint64_t x0 = x & 0x1111111111111111ull;
+  uint64_t x1 = x & 0x2222222222222222ull;
+  uint64_t x2 = x & 0x4444444444444444ull;
+  uint64_t x3 = x & 0x8888888888888888ull;
+  uint64_t y0 = y & 0x1111111111111111ull;
+  uint64_t y1 = y & 0x2222222222222222ull;
+  uint64_t y2 = y & 0x4444444444444444ull;
+  uint64_t y3 = y & 0x8888888888888888ull;
+  uint64_t z0;
+  uint64_t z1;
+  uint64_t z2;
+  uint64_t z3;
+
+  z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+  z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+  z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+  z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+  return (z0 & 0x1111111111111111ull) | (z1 & 0x2222222222222222ull) |
+         (z2 & 0x4444444444444444ull) | (z3 & 0x8888888888888888ull);
+}
+
+static inline uint64_t ghash_swap(uint64_t x, uint64_t mask, int shift)
+{
+  return ((x & mask) << shift) | ((x >> shift) & mask);
+}
+
+static inline uint64_t ghash_rev64(uint64_t x)
+{
+  x = ghash_swap(x, 0x5555555555555555ull, 1);
+  x = ghash_swap(x, 0x3333333333333333ull, 2);
+  x = ghash_swap(x, 0x0f0f0f0f0f0f0f0full, 4);
+  x = ghash_swap(x, 0x00ff00ff00ff00ffull, 8);
+  x = ghash_swap(x, 0x0000ffff0000ffffull, 16);
+  return (x << 32) | (x >> 32);
+}
+
+static inline uint64_t ghash_dec64be(FAR const uint8_t *p)
+{
+  return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+         ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+         ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+         ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+static inline void ghash_enc64be(FAR uint8_t *p, uint64_t x)
 {
-  FAR uint32_t *x = (FAR uint32_t *)X;
-  FAR uint32_t *s = (FAR uint32_t *)ctx->S;
-  FAR uint32_t *y = (FAR uint32_t *)ctx->Z;
   int i;
 
-  for (i = 0; i < len / GMAC_BLOCK_LEN; i++)
+  for (i = 7; i >= 0; i--)
     {
-      s[0] = y[0] ^ x[0];
-      s[1] = y[1] ^ x[1];
-      s[2] = y[2] ^ x[2];
-      s[3] = y[3] ^ x[3];
-
-      ghash_gfmul((FAR uint32_t *)ctx->S, (FAR uint32_t *)ctx->H,
-          (FAR uint32_t *)ctx->S);
+      p[i] = (uint8_t)x;
+      x >>= 8;
+    }
+}
 
-      y = s;
-      x += 4;
+void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint64_t h0;
+  uint64_t h1;
+  uint64_t h2;
+  uint64_t h0r;
+  uint64_t h1r;
+  uint64_t h2r;
+  uint64_t y0;
+  uint64_t y1;
+
+  h1  = ghash_dec64be(ctx->H);
+  h0  = ghash_dec64be(ctx->H + 8);
+  h0r = ghash_rev64(h0);
+  h1r = ghash_rev64(h1);
+  h2  = h0 ^ h1;
+  h2r = h0r ^ h1r;
+  y1  = ghash_dec64be(ctx->Z);
+  y0  = ghash_dec64be(ctx->Z + 8);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, X += GMAC_BLOCK_LEN)
+    {
+      uint64_t y0r;
+      uint64_t y1r;
+      uint64_t y2;
+      uint64_t y2r;
+      uint64_t z0;
+      uint64_t z1;
+      uint64_t z2;
+      uint64_t z0h;
+      uint64_t z1h;
+      uint64_t z2h;
+      uint64_t v0;
+      uint64_t v1;
+      uint64_t v2;
+      uint64_t v3;
+
+      y1 ^= ghash_dec64be(X);
+      y0 ^= ghash_dec64be(X + 8);
+      y0r = ghash_rev64(y0);
+      y1r = ghash_rev64(y1);
+      y2  = y0 ^ y1;
+      y2r = y0r ^ y1r;
+
+      /* Karatsuba: three 64x64 products, each as a low and a high half */
+
+      z0  = ghash_bmul64(y0, h0);
+      z1  = ghash_bmul64(y1, h1);
+      z2  = ghash_bmul64(y2, h2);
+      z0h = ghash_bmul64(y0r, h0r);
+      z1h = ghash_bmul64(y1r, h1r);
+      z2h = ghash_bmul64(y2r, h2r);
+      z2  ^= z0 ^ z1;
+      z2h ^= z0h ^ z1h;
+      z0h = ghash_rev64(z0h) >> 1;
+      z1h = ghash_rev64(z1h) >> 1;
+      z2h = ghash_rev64(z2h) >> 1;
+
+      v0 = z0;
+      v1 = z0h ^ z2;
+      v2 = z1 ^ z2h;
+      v3 = z1h;
+
+      /* The operands are bit-reversed, so the product is one bit off */
+
+      v3 = (v3 << 1) | (v2 >> 63);
+      v2 = (v2 << 1) | (v1 >> 63);
+      v1 = (v1 << 1) | (v0 >> 63);
+      v0 = (v0 << 1);
+
+      /* Reduce modulo x^128 + x^7 + x^2 + x + 1 */
+
+      v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+      v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+      v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+      v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+      y0 = v2;
+      y1 = v3;
     }
 
+  ghash_enc64be(ctx->S, y1);
+  ghash_enc64be(ctx->S + 8, y0);
   bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
 }
 
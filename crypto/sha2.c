@@ -35,6 +35,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
 #include <string.h>
 #include <sys/time.h>
@@ -59,6 +61,18 @@
 #  endif
 #endif
 
+/* sha256multi() hashes four messages at a time where the core has 128-bit
+ * SIMD, lane i of each vector holding a word of message i, unless the
+ * SHA-256 instructions of the CPU do the transform anyway.
+ */
+
+#if defined(__GNUC__) && !defined(CONFIG_CRYPTO_SHA256_ARCH) && \
+    (defined(__ARM_NEON) || defined(__SSE2__) || \
+     defined(__riscv_v_fixed_vlen))
+#  define SHA256_X4
+typedef uint32_t sha256_v4 __attribute__((vector_size(16)));
+#endif
+
 /* SHA-256/384/512 Machine Architecture Definitions */
 
 /* BYTE_ORDER NOTE:
@@ -101,6 +115,10 @@
 #define SHA384_SHORT_BLOCK_LENGTH (SHA384_BLOCK_LENGTH - 16)
 #define SHA512_SHORT_BLOCK_LENGTH (SHA512_BLOCK_LENGTH - 16)
 
+/* Blocks in a message of n bytes once padded */
+
+#define SHA256_NBLOCKS(n) (((n) + 8) / SHA256_BLOCK_LENGTH + 1)
+
 /* Macro for incrementally adding the unsigned 64-bit integer n to the
  * unsigned 128-bit integer (represented using a two-element array of
  * 64-bit words):
@@ -152,6 +170,33 @@
 #define sigma0_256(x) (S32(7, (x)) ^ S32(18, (x)) ^ R(3, (x)))
 #define sigma1_256(x) (S32(17, (x)) ^ S32(19, (x)) ^ R(10, (x)))
 
+/* Zknh has an instruction for each of the four, emitted with .insn so
+ * that the toolchain does not need to know them.
+ */
+
+#ifdef CONFIG_CRYPTO_RISCV_ZKN
+#  define RV_SHA256(imm, x) \
+  __asm__ (".insn i 0x13, 1, %0, %1, " #imm : "=r" (x) : "r" (x))
+
+#  undef SIGMA0_256
+#  undef SIGMA1_256
+#  undef sigma0_256
+#  undef sigma1_256
+#  define SIGMA0_256(x) sha256_rv_sum0(x)
+#  define SIGMA1_256(x) sha256_rv_sum1(x)
+#  define sigma0_256(x) sha256_rv_sig0(x)
+#  define sigma1_256(x) sha256_rv_sig1(x)
+#endif
+
+/* The portable four on vectors of four words, for sha256multi() */
+
+#ifdef SHA256_X4
+#  define SIGMA0_X4(x) (S32(2, (x)) ^ S32(13, (x)) ^ S32(22, (x)))
+#  define SIGMA1_X4(x) (S32(6, (x)) ^ S32(11, (x)) ^ S32(25, (x)))
+#  define sigma0_x4(x) (S32(7, (x)) ^ S32(18, (x)) ^ R(3, (x)))
+#  define sigma1_x4(x) (S32(17, (x)) ^ S32(19, (x)) ^ R(10, (x)))
+#endif
+
 /* Four of six logical functions used in SHA-384 and SHA-512: */
 
 #define SIGMA0_512(x) (S64(28, (x)) ^ S64(34, (x)) ^ S64(39, (x)))
@@ -170,6 +215,32 @@ void sha512last(FAR SHA2_CTX *);
 void sha256transform(FAR uint32_t *, FAR const uint8_t *);
 void sha512transform(FAR uint64_t *, FAR const uint8_t *);
 
+#ifdef CONFIG_CRYPTO_RISCV_ZKN
+static inline uint32_t sha256_rv_sum0(unsigned long x)
+{
+  RV_SHA256(0x100, x);
+  return x;
+}
+
+static inline uint32_t sha256_rv_sum1(unsigned long x)
+{
+  RV_SHA256(0x101, x);
+  return x;
+}
+
+static inline uint32_t sha256_rv_sig0(unsigned long x)
+{
+  RV_SHA256(0x102, x);
+  return x;
+}
+
+static inline uint32_t sha256_rv_sig1(unsigned long x)
+{
+  RV_SHA256(0x103, x);
+  return x;
+}
+#endif
+
 /* SHA-XYZ INITIAL HASH VALUES AND CONSTANTS */
 
 /* Hash constant words K for SHA-256: */
@@ -312,7 +383,14 @@ void sha256init(FAR SHA2_CTX *context)
   context->bitcount[0] = 0;
 }
 
-#ifdef SHA2_UNROLL_TRANSFORM
+#if defined(CONFIG_CRYPTO_SHA256_ARCH)
+
+void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  sha256_arch_transform(state, data);
+}
+
+#elif defined(SHA2_UNROLL_TRANSFORM)
 
 /* Unrolled SHA-256 round macros: */
 
@@ -675,6 +753,211 @@ void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
   explicit_bzero(context, sizeof(*context));
 }
 
+#ifdef SHA256_X4
+/* Block n of the padded message of len bytes at data, made up in buf if
+ * it is not a whole block of the message.
+ */
+
+static FAR const uint8_t *sha256block(FAR const uint8_t *data, size_t len,
+                                      size_t n, FAR uint8_t *buf)
+{
+  size_t off = n * SHA256_BLOCK_LENGTH;
+  uint64_t bits;
+  int j;
+
+  if (off + SHA256_BLOCK_LENGTH <= len)
+    {
+      return data + off;
+    }
+
+  memset(buf, 0, SHA256_BLOCK_LENGTH);
+  if (off <= len)
+    {
+      memcpy(buf, data + off, len - off);
+      buf[len - off] = 0x80;
+    }
+
+  if (n == SHA256_NBLOCKS(len) - 1)
+    {
+      bits = (uint64_t)len << 3;
+      for (j = 0; j < 8; j++)
+        {
+          buf[SHA256_BLOCK_LENGTH - 1 - j] = (uint8_t)(bits >> (8 * j));
+        }
+    }
+
+  return buf;
+}
+
+static void sha256transform_x4(FAR sha256_v4 *state,
+                               FAR const uint8_t * const *data)
+{
+  sha256_v4 a;
+  sha256_v4 b;
+  sha256_v4 c;
+  sha256_v4 d;
+  sha256_v4 e;
+  sha256_v4 f;
+  sha256_v4 g;
+  sha256_v4 h;
+  sha256_v4 s0;
+  sha256_v4 s1;
+  sha256_v4 T1;
+  sha256_v4 T2;
+  sha256_v4 W256[16];
+  FAR const uint8_t *p;
+  int j;
+  int l;
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+
+  for (j = 0; j < 64; j++)
+    {
+      if (j < 16)
+        {
+          for (l = 0; l < 4; l++)
+            {
+              p = data[l] + 4 * j;
+              W256[j][l] = (uint32_t)p[3] | ((uint32_t)p[2] << 8) |
+                  ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 24);
+            }
+        }
+      else
+        {
+          s0 = sigma0_x4(W256[(j + 1) & 0x0f]);
+          s1 = sigma1_x4(W256[(j + 14) & 0x0f]);
+          W256[j & 0x0f] += s1 + W256[(j + 9) & 0x0f] + s0;
+        }
+
+      T1 = h + SIGMA1_X4(e) + CH(e, f, g) + K256[j] + W256[j & 0x0f];
+      T2 = SIGMA0_X4(a) + MAJ(a, b, c);
+      h = g;
+      g = f;
+      f = e;
+      e = d + T1;
+      d = c;
+      c = b;
+      b = a;
+      a = T1 + T2;
+    }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/* Hash n messages, 2 <= n <= 4, in the lanes of the vectors: the missing
+ * lanes repeat the last message.  The messages are done together for as
+ * many blocks as the shortest has and then each on its own.
+ */
+
+static void sha256multi_x4(FAR const uint8_t * const *data,
+                           FAR const size_t *len,
+                           FAR uint8_t (*digest)[SHA256_DIGEST_LENGTH],
+                           int n)
+{
+  uint8_t buf[4][SHA256_BLOCK_LENGTH];
+  FAR const uint8_t *blocks[4];
+  size_t nblocks[4];
+  sha256_v4 state[8];
+  uint32_t st[8];
+  size_t common;
+  size_t i;
+  int j;
+  int l;
+  int m;
+
+  common = SIZE_MAX;
+  for (l = 0; l < 4; l++)
+    {
+      m = l < n ? l : n - 1;
+      nblocks[l] = SHA256_NBLOCKS(len[m]);
+      if (nblocks[l] < common)
+        {
+          common = nblocks[l];
+        }
+
+      for (j = 0; j < 8; j++)
+        {
+          state[j][l] = sha256_initial_hash_value[j];
+        }
+    }
+
+  for (i = 0; i < common; i++)
+    {
+      for (l = 0; l < 4; l++)
+        {
+          m = l < n ? l : n - 1;
+          blocks[l] = sha256block(data[m], len[m], i, buf[l]);
+        }
+
+      sha256transform_x4(state, blocks);
+    }
+
+  for (l = 0; l < n; l++)
+    {
+      for (j = 0; j < 8; j++)
+        {
+          st[j] = state[j][l];
+        }
+
+      for (i = common; i < nblocks[l]; i++)
+        {
+          sha256transform(st, sha256block(data[l], len[l], i, buf[0]));
+        }
+
+      for (j = 0; j < 8; j++)
+        {
+          digest[l][4 * j]     = (uint8_t)(st[j] >> 24);
+          digest[l][4 * j + 1] = (uint8_t)(st[j] >> 16);
+          digest[l][4 * j + 2] = (uint8_t)(st[j] >> 8);
+          digest[l][4 * j + 3] = (uint8_t)st[j];
+        }
+    }
+
+  explicit_bzero(buf, sizeof(buf));
+  explicit_bzero(state, sizeof(state));
+  explicit_bzero(st, sizeof(st));
+}
+#endif
+
+void sha256multi(FAR const uint8_t * const *data, FAR const size_t *len,
+                 FAR uint8_t (*digest)[SHA256_DIGEST_LENGTH], size_t count)
+{
+  SHA2_CTX context;
+  size_t i = 0;
+
+#ifdef SHA256_X4
+  int n;
+
+  while (count - i >= 2)
+    {
+      n = count - i < 4 ? count - i : 4;
+      sha256multi_x4(data + i, len + i, digest + i, n);
+      i += n;
+    }
+#endif
+
+  for (; i < count; i++)
+    {
+      sha256init(&context);
+      sha256update(&context, data[i], len[i]);
+      sha256final(digest[i], &context);
+    }
+}
+
 /* SHA-224: */
 
 void sha224init(FAR SHA2_CTX *context)
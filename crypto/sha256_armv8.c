@@ -0,0 +1,157 @@
+/****************************************************************************
+ * crypto/sha256_armv8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <arm_neon.h>
+#include <sys/types.h>
+
+#include <crypto/aes.h>
+#include <crypto/gmac.h>
+
+#include <nuttx/config.h>
+
+#include <arm_neon.h>
+#include <sys/types.h>
+
+#include <crypto/sha2.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The SHA-256 instructions are part of the optional Crypto Extension, so
+ * the toolchain may not have them enabled; CRYPTO_ARM64_CE says the core
+ * has them.
+ */
+
+#define ARM64_CE(insn, d, n) \
+  __asm__ (".arch_extension crypto\n" insn : "+w" (d) : "w" (n))
+
+#define ARM64_CE2(insn, d, n, m) \
+  __asm__ (".arch_extension crypto\n" insn : "+w" (d) : "w" (n), "w" (m))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* sha256h/sha256h2: four rounds, giving the new {a, b, c, d} and
+ * {e, f, g, h} from the old ones and W + K.
+ */
+
+static inline uint32x4_t sha256_armv8_h(uint32x4_t abcd, uint32x4_t efgh,
+                                        uint32x4_t wk)
+{
+  ARM64_CE2("sha256h %q0, %q1, %2.4s", abcd, efgh, wk);
+  return abcd;
+}
+
+static inline uint32x4_t sha256_armv8_h2(uint32x4_t efgh, uint32x4_t abcd,
+                                         uint32x4_t wk)
+{
+  ARM64_CE2("sha256h2 %q0, %q1, %2.4s", efgh, abcd, wk);
+  return efgh;
+}
+
+/* sha256su0/sha256su1: the next four words of the message schedule from
+ * the previous sixteen.
+ */
+
+static inline uint32x4_t sha256_armv8_su0(uint32x4_t w0, uint32x4_t w4)
+{
+  ARM64_CE("sha256su0 %0.4s, %1.4s", w0, w4);
+  return w0;
+}
+
+static inline uint32x4_t sha256_armv8_su1(uint32x4_t w0, uint32x4_t w8,
+                                          uint32x4_t w12)
+{
+  ARM64_CE2("sha256su1 %0.4s, %1.4s, %2.4s", w0, w8, w12);
+  return w0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void sha256_arch_transform(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  uint32x4_t abcd = vld1q_u32(state);
+  uint32x4_t efgh = vld1q_u32(state + 4);
+  uint32x4_t abcd0 = abcd;
+  uint32x4_t efgh0 = efgh;
+  uint32x4_t w[4];
+  uint32x4_t wk;
+  uint32x4_t t;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      wk = vaddq_u32(w[i & 3], vld1q_u32(g_sha256_k + 4 * i));
+      if (i < 12)
+        {
+          w[i & 3] = sha256_armv8_su1(sha256_armv8_su0(w[i & 3],
+                                                       w[(i + 1) & 3]),
+                                      w[(i + 2) & 3], w[(i + 3) & 3]);
+        }
+
+      t    = abcd;
+      abcd = sha256_armv8_h(abcd, efgh, wk);
+      efgh = sha256_armv8_h2(efgh, t, wk);
+    }
+
+  vst1q_u32(state, vaddq_u32(abcd, abcd0));
+  vst1q_u32(state + 4, vaddq_u32(efgh, efgh0));
+}
@@ -39,13 +39,23 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 
 #include <nuttx/irq.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Fills the ring up to its end when the next block does not fit there */
+
+#define ADC_BLOCK_PAD  (1 << 7)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -67,6 +77,15 @@ static int     adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
 static int     adc_reset_fifo(FAR struct adc_dev_s *dev);
 static int     adc_samples_on_read(FAR struct adc_dev_s *dev);
+#ifdef CONFIG_ADC_BLOCK
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+                                 FAR const uint8_t *channel,
+                                 FAR const uint32_t *data,
+                                 size_t count,
+                                 FAR const struct timespec *ts);
+static int     adc_mmap(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,7 +99,11 @@ static const struct file_operations g_adc_fops =
   NULL,         /* write */
   NULL,         /* seek */
   adc_ioctl,    /* ioctl */
+#ifdef CONFIG_ADC_BLOCK
+  adc_mmap,     /* mmap */
+#else
   NULL,         /* mmap */
+#endif
   NULL,         /* truncate */
   adc_poll      /* poll */
 };
@@ -89,7 +112,10 @@ static const struct adc_callback_s g_adc_callback =
 {
   adc_receive,       /* au_receive */
   adc_receive_batch, /* au_receive_batch */
-  adc_reset          /* au_reset */
+  adc_reset,         /* au_reset */
+#ifdef CONFIG_ADC_BLOCK
+  adc_receive_block  /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -149,6 +175,11 @@ static int adc_open(FAR struct file *filep)
                   dev->ad_recv.af_head = 0;
                   dev->ad_recv.af_tail = 0;
 
+#ifdef CONFIG_ADC_BLOCK
+                  circbuf_reset(&dev->ad_blocks);
+                  dev->ad_blockmode = false;
+#endif
+
                   /* Clear overrun indicator */
 
                   dev->ad_isovr = false;
@@ -219,6 +250,148 @@ static int adc_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_block_peek
+ *
+ * Description:
+ *   Return the oldest block of the ring, or NULL if it is empty.  The
+ *   padding at the end of the ring is skipped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static FAR struct adc_block_s *adc_block_peek(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_block_s *block;
+  size_t contig;
+
+  for (; ; )
+    {
+      block = circbuf_get_readptr(&dev->ad_blocks, &contig);
+      if (contig == 0)
+        {
+          return NULL;
+        }
+
+      /* The padding is too short for a header, or is marked as such */
+
+      if (contig >= sizeof(struct adc_block_s) &&
+          (block->ab_flags & ADC_BLOCK_PAD) == 0)
+        {
+          return block;
+        }
+
+      circbuf_readcommit(&dev->ad_blocks, contig);
+    }
+}
+
+/****************************************************************************
+ * Name: adc_block_wait
+ *
+ * Description:
+ *   Wait for a block.  The caller holds ad_blocklock.
+ *
+ ****************************************************************************/
+
+static int adc_block_wait(FAR struct file *filep, FAR struct adc_dev_s *dev,
+                          FAR struct adc_block_s **block)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  while ((*block = adc_block_peek(dev)) == NULL)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_block_read
+ *
+ * Description:
+ *   Copy as many whole blocks as fit in the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_block_read(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev,
+                              FAR char *buffer, size_t buflen)
+{
+  FAR struct adc_block_s *block;
+  size_t nread = 0;
+  int ret;
+
+  ret = nxmutex_lock(&dev->ad_blocklock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = adc_block_wait(filep, dev, &block);
+  while (ret >= 0 && block != NULL && nread + block->ab_size <= buflen)
+    {
+      memcpy(&buffer[nread], block, block->ab_size);
+      nread += block->ab_size;
+      circbuf_readcommit(&dev->ad_blocks, block->ab_size);
+      block = adc_block_peek(dev);
+    }
+
+  nxmutex_unlock(&dev->ad_blocklock);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The oldest block does not fit in the user buffer */
+
+  return nread > 0 ? nread : -EMSGSIZE;
+}
+
+/****************************************************************************
+ * Name: adc_block_mode
+ ****************************************************************************/
+
+static int adc_block_mode(FAR struct adc_dev_s *dev, bool enable)
+{
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmutex_lock(&dev->ad_blocklock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  circbuf_reset(&dev->ad_blocks);
+  dev->ad_recv.af_head = dev->ad_recv.af_tail;
+  dev->ad_blockseq     = 0;
+  dev->ad_blockmode    = enable;
+
+  leave_critical_section(flags);
+  nxmutex_unlock(&dev->ad_blocklock);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_read
  ****************************************************************************/
@@ -236,6 +409,13 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCK
+  if (dev->ad_blockmode)
+    {
+      return adc_block_read(filep, dev, buffer, buflen);
+    }
+#endif
+
   /* Determine the size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -443,6 +623,64 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_ADC_BLOCK
+      case ANIOC_BLOCK_MODE:
+        {
+          ret = adc_block_mode(dev, arg != 0);
+        }
+        break;
+
+      /* Zero-copy access for a single reader that mmap()ed the ring */
+
+      case ANIOC_BLOCK_ACQUIRE:
+        {
+          FAR off_t *offset = (FAR off_t *)((uintptr_t)arg);
+          FAR struct adc_block_s *block;
+
+          if (offset == NULL || !dev->ad_blockmode)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&dev->ad_blocklock);
+          if (ret >= 0)
+            {
+              ret = adc_block_wait(filep, dev, &block);
+              if (ret >= 0)
+                {
+                  *offset = (FAR uint8_t *)block -
+                            (FAR uint8_t *)dev->ad_blocks.base;
+                }
+
+              nxmutex_unlock(&dev->ad_blocklock);
+            }
+        }
+        break;
+
+      case ANIOC_BLOCK_RELEASE:
+        {
+          FAR struct adc_block_s *block;
+
+          ret = nxmutex_lock(&dev->ad_blocklock);
+          if (ret >= 0)
+            {
+              block = adc_block_peek(dev);
+              if (block != NULL)
+                {
+                  circbuf_readcommit(&dev->ad_blocks, block->ab_size);
+                }
+              else
+                {
+                  ret = -ENOENT;
+                }
+
+              nxmutex_unlock(&dev->ad_blocklock);
+            }
+        }
+        break;
+#endif
+
       default:
         {
           /* Those IOCTLs might be used in arch specific section */
@@ -527,6 +765,15 @@ static int adc_receive_batch(FAR struct adc_dev_s *dev,
   size_t                 first;
   size_t                 second;
 
+#ifdef CONFIG_ADC_BLOCK
+  /* Timestamp the batch on its arrival if block mode is selected */
+
+  if (dev->ad_blockmode)
+    {
+      return adc_receive_block(dev, channel, data, count, NULL);
+    }
+#endif
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
@@ -570,6 +817,96 @@ static int adc_receive_batch(FAR struct adc_dev_s *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: adc_receive_block
+ *
+ * Description:
+ *   Queue the samples of a DMA half or full transfer as one block.  The
+ *   blocks are contiguous in the ring, so that they can be read in place:
+ *   a block that does not fit before the end of the ring starts over at
+ *   its beginning, and the end is padded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+                             FAR const uint8_t *channel,
+                             FAR const uint32_t *data,
+                             size_t count,
+                             FAR const struct timespec *ts)
+{
+  FAR struct circbuf_s *ring = &dev->ad_blocks;
+  FAR struct adc_block_s *block;
+  size_t contig;
+  size_t size;
+  uint32_t seq;
+
+  if (!dev->ad_blockmode)
+    {
+      return adc_receive_batch(dev, channel, data, count);
+    }
+
+  if (count == 0 || count > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* The sequence counts the dropped blocks too */
+
+  seq  = dev->ad_blockseq++;
+  size = ADC_BLOCK_SIZE(count, channel != NULL);
+
+  block = circbuf_get_writeptr(ring, &contig);
+  if (contig < size)
+    {
+      /* Pad up to the end of the ring, if the block fits after that */
+
+      if ((FAR uint8_t *)block + contig !=
+          (FAR uint8_t *)ring->base + ring->size ||
+          circbuf_space(ring) < contig + size)
+        {
+          return -ENOMEM;
+        }
+
+      if (contig >= sizeof(struct adc_block_s))
+        {
+          block->ab_size  = contig;
+          block->ab_count = 0;
+          block->ab_flags = ADC_BLOCK_PAD;
+        }
+
+      circbuf_writecommit(ring, contig);
+      block = circbuf_get_writeptr(ring, &contig);
+    }
+
+  if (ts != NULL)
+    {
+      block->ab_time = *ts;
+    }
+  else
+    {
+      clock_systime_timespec(&block->ab_time);
+    }
+
+  block->ab_seq      = seq;
+  block->ab_size     = size;
+  block->ab_count    = count;
+  block->ab_flags    = channel != NULL ? ADC_BLOCK_CHANNELS : 0;
+  block->ab_reserved = 0;
+
+  memcpy(block + 1, data, count * sizeof(uint32_t));
+  if (channel != NULL)
+    {
+      memcpy((FAR uint8_t *)(block + 1) + count * sizeof(uint32_t),
+             channel, count);
+    }
+
+  circbuf_writecommit(ring, size);
+  adc_notify(dev);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_notify
  ****************************************************************************/
@@ -650,7 +987,11 @@ static int adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (dev->ad_recv.af_head != dev->ad_recv.af_tail
+#ifdef CONFIG_ADC_BLOCK
+          || (dev->ad_blockmode && !circbuf_is_empty(&dev->ad_blocks))
+#endif
+         )
         {
           poll_notify(&fds, 1, POLLIN);
         }
@@ -720,6 +1061,32 @@ static int adc_samples_on_read(FAR struct adc_dev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_mmap
+ *
+ * Description:
+ *   Map the ring of blocks, for ANIOC_BLOCK_ACQUIRE and ANIOC_BLOCK_RELEASE.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+  size_t                size  = circbuf_size(&dev->ad_blocks);
+
+  if (map->offset >= 0 && map->offset < size &&
+      map->length && map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR uint8_t *)dev->ad_blocks.base + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -796,29 +1163,55 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
       alloc_data = true;
     }
 
-  /* Register the ADC character driver */
+#ifdef CONFIG_ADC_BLOCK
+  /* Allocate the ring of blocks, a multiple of the block alignment */
 
-  ret = register_driver(path, &g_adc_fops, 0444, dev);
+  if (dev->ad_blocksize == 0)
+    {
+      dev->ad_blocksize = CONFIG_ADC_BLOCK_BUFSIZE;
+    }
+
+  ret = circbuf_init(&dev->ad_blocks, NULL,
+                     ALIGN_UP(dev->ad_blocksize, ADC_BLOCK_ALIGN));
   if (ret < 0)
     {
-      if (alloc_channel)
-        {
-           kmm_free(fifo->af_channel);
-        }
+      goto errout_with_fifo;
+    }
 
-      if (alloc_data)
-        {
-           kmm_free(fifo->af_data);
-        }
+  nxmutex_init(&dev->ad_blocklock);
+#endif
 
-      nxsem_destroy(&dev->ad_recv.af_sem);
-      nxmutex_destroy(&dev->ad_closelock);
-      return ret;
+  /* Register the ADC character driver */
+
+  ret = register_driver(path, &g_adc_fops, 0444, dev);
+  if (ret < 0)
+    {
+      goto errout_with_blocks;
     }
 
   /* Initialize the af_channale */
 
   memset(&fifo->af_channel[0], 0, fifo->af_fifosize);
+  return ret;
+
+errout_with_blocks:
+#ifdef CONFIG_ADC_BLOCK
+  circbuf_uninit(&dev->ad_blocks);
+  nxmutex_destroy(&dev->ad_blocklock);
+
+errout_with_fifo:
+#endif
+  if (alloc_channel)
+    {
+      kmm_free(fifo->af_channel);
+    }
+
+  if (alloc_data)
+    {
+      kmm_free(fifo->af_data);
+    }
 
+  nxsem_destroy(&dev->ad_recv.af_sem);
+  nxmutex_destroy(&dev->ad_closelock);
   return ret;
 }
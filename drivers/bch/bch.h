@@ -36,12 +36,25 @@
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 
+#ifdef CONFIG_BCH_WRITEBACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Writes of at least this many bytes bypass the sector buffer */
+
+#ifdef CONFIG_BCH_WRITEBACK
+#  define BCH_WB_NSECTORS   CONFIG_BCH_WRITEBACK_NSECTORS
+#  define BCH_DIRECT_MIN(b) ((b)->sectsize * BCH_WB_NSECTORS)
+#else
+#  define BCH_DIRECT_MIN(b) ((b)->sectsize)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -59,6 +72,14 @@ struct bchlib_s
   bool unlinked;           /* true: The driver has been unlinked */
   FAR uint8_t *buffer;     /* One sector buffer */
 
+#ifdef CONFIG_BCH_WRITEBACK
+  FAR uint8_t *wbbuffer;   /* BCH_WB_NSECTORS sectors, buffer points in it */
+  size_t wbbase;           /* First sector held in wbbuffer */
+  uint32_t wbvalid;        /* Sectors of wbbuffer holding data */
+  uint32_t wbdirty;        /* Sectors of wbbuffer not yet written back */
+  struct work_s wbwork;    /* Delayed write back of the dirty sectors */
+#endif
+
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
 #endif
@@ -85,6 +106,12 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_markdirty(FAR struct bchlib_s *bch);
+EXTERN bool bchlib_cached(FAR struct bchlib_s *bch, size_t sector,
+                          size_t nsectors);
+#ifdef CONFIG_BCH_WRITEBACK
+EXTERN int  bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
 #include <unistd.h>
 #include <string.h>
@@ -41,7 +42,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/uio.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/psi.h>
 
 #include "bch.h"
 
@@ -60,6 +63,8 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
+static ssize_t bch_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t bch_writev(FAR struct file *filep, FAR struct uio *uio);
 static int     bch_ioctl(FAR struct file *filep, int cmd,
                          unsigned long arg);
 static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
@@ -83,8 +88,8 @@ const struct file_operations g_bch_fops =
   NULL,        /* mmap */
   NULL,        /* truncate */
   bch_poll,    /* poll */
-  NULL,        /* readv */
-  NULL         /* writev */
+  bch_readv,   /* readv */
+  bch_writev   /* writev */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , bch_unlink /* unlink */
 #endif
@@ -307,7 +312,9 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
+  psi_stall_enter(PSI_IO);
   ret = bchlib_read(bch, buffer, filep->f_pos, len);
+  psi_stall_leave(PSI_IO);
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -339,7 +346,9 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
           return ret;
         }
 
+      psi_stall_enter(PSI_IO);
       ret = bchlib_write(bch, buffer, filep->f_pos, len);
+      psi_stall_leave(PSI_IO);
       if (ret > 0)
         {
           filep->f_pos += ret;
@@ -351,6 +360,208 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_vsectors
+ *
+ * Description:
+ *   Return the number of sectors that the vectored transfer at pos can
+ *   hand to the block driver as one request, or zero if the transfer must
+ *   go through the sector buffer.
+ *
+ ****************************************************************************/
+
+static size_t bch_vsectors(FAR struct bchlib_s *bch, FAR struct uio *uio,
+                           off_t pos, bool write)
+{
+  FAR const struct block_operations *bops = bch->inode->u.i_bops;
+  size_t sector = pos / bch->sectsize;
+
+#ifdef CONFIG_BCH_FORCE_INDIRECT
+  if (write)
+    {
+      return 0;
+    }
+#endif
+
+  if ((write ? bops->writev == NULL : bops->readv == NULL) ||
+      pos % bch->sectsize != 0 || sector >= bch->nsectors ||
+      uio->uio_resid < bch->sectsize || !uio_aligned(uio, bch->sectsize))
+    {
+      return 0;
+    }
+
+  return MIN(uio->uio_resid / bch->sectsize, bch->nsectors - sector);
+}
+
+/****************************************************************************
+ * Name: bch_transferv
+ *
+ * Description:
+ *   Transfer the segments one at a time through the sector buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_transferv(FAR struct bchlib_s *bch, FAR struct uio *uio,
+                             FAR off_t *pos, bool write)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  size_t offset = uio->uio_offset_in_iov;
+  ssize_t ntotal = 0;
+  ssize_t ret = 0;
+  size_t len;
+  int i;
+
+  for (i = 0; i < uio->uio_iovcnt; i++, offset = 0)
+    {
+      len = iov[i].iov_len - offset;
+      if (len == 0)
+        {
+          continue;
+        }
+
+      if (write)
+        {
+          ret = bchlib_write(bch, (FAR const char *)iov[i].iov_base + offset,
+                             *pos, len);
+        }
+      else
+        {
+          ret = bchlib_read(bch, (FAR char *)iov[i].iov_base + offset,
+                            *pos, len);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      *pos   += ret;
+      ntotal += ret;
+
+      if ((size_t)ret < len)
+        {
+          break;
+        }
+    }
+
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: bch_readv
+ *
+ * Description:
+ *   A sector aligned read whose segments are whole sectors is passed to the
+ *   block driver as one vectored request.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  size_t nsectors;
+  size_t sector;
+  ssize_t ret;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  psi_stall_enter(PSI_IO);
+  nsectors = bch_vsectors(bch, uio, filep->f_pos, false);
+  if (nsectors == 0)
+    {
+      ret = bch_transferv(bch, uio, &filep->f_pos, false);
+      goto out;
+    }
+
+  /* Write back the buffered sector so that the driver has the latest
+   * copy.
+   */
+
+  sector = filep->f_pos / bch->sectsize;
+  ret = bchlib_flushsector(bch, false);
+  if (ret >= 0)
+    {
+      ret = bch->inode->u.i_bops->readv(bch->inode, uio, sector, nsectors);
+    }
+
+  if (ret > 0)
+    {
+      ret *= bch->sectsize;
+      filep->f_pos += ret;
+    }
+
+out:
+  psi_stall_leave(PSI_IO);
+  nxmutex_unlock(&bch->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bch_writev
+ ****************************************************************************/
+
+static ssize_t bch_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  size_t nsectors;
+  size_t sector;
+  ssize_t ret;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  if (bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  psi_stall_enter(PSI_IO);
+  nsectors = bch_vsectors(bch, uio, filep->f_pos, true);
+  if (nsectors == 0)
+    {
+      ret = bch_transferv(bch, uio, &filep->f_pos, true);
+      goto out;
+    }
+
+  /* Flush the dirty sector to keep the sector sequence, and drop it if it
+   * is about to be overwritten.
+   */
+
+  sector = filep->f_pos / bch->sectsize;
+  ret = bchlib_flushsector(bch, bchlib_cached(bch, sector, nsectors));
+  if (ret >= 0)
+    {
+      ret = bch->inode->u.i_bops->writev(bch->inode, uio, sector,
+                                         nsectors);
+    }
+
+  if (ret > 0)
+    {
+      ret *= bch->sectsize;
+      filep->f_pos += ret;
+    }
+
+out:
+  psi_stall_leave(PSI_IO);
+  nxmutex_unlock(&bch->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: bch_ioctl
  *
@@ -435,11 +646,33 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* The readahead hint is in file offsets, which the block driver
+       * cannot interpret.
+       */
+
+      case FIOC_READAHEAD:
+        break;
+
       case BIOC_DISCARD:
         {
           /* Invalidate the sector so next read is from the device- */
 
+#ifdef CONFIG_BCH_WRITEBACK
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ret = bchlib_flushsector(bch, true);
+          nxmutex_unlock(&bch->lock);
+          if (ret < 0)
+            {
+              break;
+            }
+#else
           bch->sector = (size_t)-1;
+#endif
           goto ioctl_default;
         }
 
@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -62,10 +63,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *sectbuf,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)sectbuf;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +75,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -91,6 +93,142 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+#ifdef CONFIG_BCH_WRITEBACK
+/****************************************************************************
+ * Name: bchlib_wbworker
+ *
+ * Description:
+ *   Write back the dirty sectors some time after they were first written,
+ *   so that the data reaches the media even if no one flushes it.
+ *
+ ****************************************************************************/
+
+static void bchlib_wbworker(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = arg;
+
+  if (nxmutex_lock(&bch->lock) >= 0)
+    {
+      bchlib_flushsector(bch, false);
+      nxmutex_unlock(&bch->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_wbwrite
+ *
+ * Description:
+ *   Write count sectors of the write-back buffer, starting at index, to
+ *   the media with a single block driver write.
+ *
+ ****************************************************************************/
+
+static int bchlib_wbwrite(FAR struct bchlib_s *bch, size_t index,
+                          size_t count)
+{
+  FAR struct inode *inode = bch->inode;
+  FAR uint8_t *buffer = bch->wbbuffer + index * bch->sectsize;
+  ssize_t ret;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      bch_cypher(bch, buffer + i * bch->sectsize, bch->wbbase + index + i,
+                 CYPHER_ENCRYPT);
+    }
+#endif
+
+  ret = inode->u.i_bops->write(inode, buffer, bch->wbbase + index, count);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (i = 0; i < count; i++)
+    {
+      bch_cypher(bch, buffer + i * bch->sectsize, bch->wbbase + index + i,
+                 CYPHER_DECRYPT);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_wbmap
+ *
+ * Description:
+ *   Make a sector the current sector, moving the write-back buffer to the
+ *   BCH_WB_NSECTORS aligned sectors around it (and writing back the dirty
+ *   sectors of its previous position) if needed.  The sector is read from
+ *   the media if fill is set and the buffer does not hold it yet.
+ *
+ ****************************************************************************/
+
+static int bchlib_wbmap(FAR struct bchlib_s *bch, size_t sector, bool fill)
+{
+  FAR struct inode *inode;
+  size_t index;
+  ssize_t ret;
+
+  if (bch->wbbuffer == NULL)
+    {
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+      bch->wbbuffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                   bch->sectsize * BCH_WB_NSECTORS);
+#else
+      bch->wbbuffer = kmm_malloc(bch->sectsize * BCH_WB_NSECTORS);
+#endif
+      if (bch->wbbuffer == NULL)
+        {
+          ferr("Failed to allocate sector buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  if (bch->wbvalid == 0 || sector < bch->wbbase ||
+      sector >= bch->wbbase + BCH_WB_NSECTORS)
+    {
+      ret = bchlib_flushsector(bch, true);
+      if (ret < 0)
+        {
+          ferr("Flush failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      bch->wbbase = sector - sector % BCH_WB_NSECTORS;
+    }
+
+  index = sector - bch->wbbase;
+  bch->buffer = bch->wbbuffer + index * bch->sectsize;
+
+  if (fill && (bch->wbvalid & (1u << index)) == 0)
+    {
+      inode = bch->inode;
+
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      if (ret < 0)
+        {
+          ferr("Read failed: %zd\n", ret);
+          bch->sector = (size_t)-1;
+          return (int)ret;
+        }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, bch->buffer, sector, CYPHER_DECRYPT);
+#endif
+    }
+
+  bch->wbvalid |= 1u << index;
+  bch->sector   = sector;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -108,6 +246,47 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
+#ifdef CONFIG_BCH_WRITEBACK
+  size_t first;
+  size_t end;
+  int ret;
+
+  /* Write the dirty sectors back in as few writes as possible: a run
+   * extends over the clean sectors between two dirty ones as long as the
+   * buffer holds them.
+   */
+
+  while (bch->wbdirty != 0)
+    {
+      first = ffs(bch->wbdirty) - 1;
+      end   = first + 1;
+
+      while (end < BCH_WB_NSECTORS && (bch->wbvalid & (1u << end)) != 0 &&
+             (bch->wbdirty >> end) != 0)
+        {
+          end++;
+        }
+
+      ret = bchlib_wbwrite(bch, first, end - first);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      while (first < end)
+        {
+          bch->wbdirty &= ~(1u << first++);
+        }
+    }
+
+  if (discard)
+    {
+      bch->wbvalid = 0;
+      bch->sector  = (size_t)-1;
+    }
+
+  return OK;
+#else
   FAR struct inode *inode;
   ssize_t ret = OK;
 
@@ -122,7 +301,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
@@ -139,7 +318,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -153,6 +332,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
     }
 
   return (int)ret;
+#endif
 }
 
 /****************************************************************************
@@ -168,6 +348,9 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
+#ifdef CONFIG_BCH_WRITEBACK
+  return bchlib_wbmap(bch, sector, true);
+#else
   FAR struct inode *inode;
   ssize_t ret = OK;
 
@@ -205,9 +388,81 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_allocsector
+ *
+ * Description:
+ *   Make a sector the current sector without reading it from the media,
+ *   for a caller that overwrites all of it.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_WRITEBACK
+int bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  return bchlib_wbmap(bch, sector, false);
+}
+#endif
+
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Record that the current sector was modified.  With the write-back
+ *   cache the sector is written back when the cache moves to other
+ *   sectors, on a flush, or CONFIG_BCH_WRITEBACK_DELAY milliseconds after
+ *   the first modification, whichever comes first.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_markdirty(FAR struct bchlib_s *bch)
+{
+#ifdef CONFIG_BCH_WRITEBACK
+  bch->wbdirty |= 1u << (bch->sector - bch->wbbase);
+
+  if (work_available(&bch->wbwork))
+    {
+      work_queue(LPWORK, &bch->wbwork, bchlib_wbworker, bch,
+                 MSEC2TICK(CONFIG_BCH_WRITEBACK_DELAY));
+    }
+#else
+  bch->dirty = true;
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_cached
+ *
+ * Description:
+ *   Return true if the sector buffer holds any of the nsectors sectors
+ *   starting at sector, i.e. if a transfer that bypasses the buffer must
+ *   flush it first.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+bool bchlib_cached(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+#ifdef CONFIG_BCH_WRITEBACK
+  return bch->wbvalid != 0 && sector < bch->wbbase + BCH_WB_NSECTORS &&
+         bch->wbbase < sector + nsectors;
+#else
+  return sector <= bch->sector && bch->sector < sector + nsectors;
+#endif
 }
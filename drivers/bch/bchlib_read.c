@@ -148,6 +148,20 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Write back the buffered sectors so that the driver has the
+       * latest copy.
+       */
+
+      if (bchlib_cached(bch, sector, nsectors))
+        {
+          ret = bchlib_flushsector(bch, false);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
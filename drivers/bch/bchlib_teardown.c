@@ -64,6 +64,9 @@ int bchlib_teardown(FAR void *handle)
 
   /* Flush any pending data to the block driver */
 
+#ifdef CONFIG_BCH_WRITEBACK
+  work_cancel_sync(LPWORK, &bch->wbwork);
+#endif
   bchlib_flushsector(bch, false);
 
   /* Close the block driver */
@@ -72,10 +75,17 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
+#ifdef CONFIG_BCH_WRITEBACK
+  if (bch->wbbuffer)
+    {
+      kmm_free(bch->wbbuffer);
+    }
+#else
   if (bch->buffer)
     {
       kmm_free(bch->buffer);
     }
+#endif
 
   nxmutex_destroy(&bch->lock);
   kmm_free(bch);
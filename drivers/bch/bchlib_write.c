@@ -107,7 +107,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
       /* Adjust pointers and counts */
 
@@ -123,51 +123,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       len          -= nbytes;
     }
 
-  /* Then write all of the full sectors following the partial sector.. */
-
-#ifdef CONFIG_BCH_FORCE_INDIRECT
-
-  /* indirectly by using sector buffer.
-   */
-
-  while (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the data from the user buffer to the sector buffer */
-
-      nbytes = len > bch->sectsize ? bch->sectsize : len;
-      memcpy(bch->buffer, buffer, nbytes);
-      bch->dirty = true;
-
-      /* Write the sector back to the block device */
-
-      ret = bchlib_flushsector(bch, false);
-      if (ret < 0)
-        {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
-        }
-
-      /* Adjust pointers and counts */
-
-      buffer       += nbytes;
-      len          -= nbytes;
-      byteswritten += nbytes;
-      sector++;
-    }
-#else
-
-  /* directly from the user buffer.
+#ifndef CONFIG_BCH_FORCE_INDIRECT
+  /* Then write all of the full sectors following the partial sector
+   * directly from the user buffer.  With the write-back cache, writes
+   * shorter than the cache are gathered in it instead.
    */
 
-  if (len >= bch->sectsize)
+  if (len >= BCH_DIRECT_MIN(bch))
     {
       nsectors = len / bch->sectsize;
       if (sector + nsectors > bch->nsectors)
@@ -177,8 +139,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Flush the dirty sector to keep the sector sequence */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      ret = bchlib_flushsector(bch, bchlib_cached(bch, sector, nsectors));
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -209,29 +170,57 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       buffer    += nbytes;
       len       -= nbytes;
     }
+#endif /* CONFIG_BCH_FORCE_INDIRECT */
 
-  /* Then write any partial final sector */
+  /* Then write the remaining sectors indirectly by using sector buffer */
 
-  if (len > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the sector into the sector buffer */
+      nbytes = len > bch->sectsize ? bch->sectsize : len;
+
+      /* Read the sector into the sector buffer, unless it is overwritten
+       * whole.
+       */
+
+#ifdef CONFIG_BCH_WRITEBACK
+      if (nbytes == bch->sectsize)
+        {
+          ret = bchlib_allocsector(bch, sector);
+        }
+      else
+#endif
+        {
+          ret = bchlib_readsector(bch, sector);
+        }
 
-      ret = bchlib_readsector(bch, sector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Copy the head end of the sector from the user buffer */
+      /* Copy the data from the user buffer to the sector buffer */
+
+      memcpy(bch->buffer, buffer, nbytes);
+      bchlib_markdirty(bch);
+
+#if defined(CONFIG_BCH_FORCE_INDIRECT) && !defined(CONFIG_BCH_WRITEBACK)
+      /* Write the sector back to the block device */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      ret = bchlib_flushsector(bch, false);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+#endif
 
-      /* Adjust counts */
+      /* Adjust pointers and counts */
 
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
+      byteswritten += nbytes;
+      sector++;
     }
-#endif /* CONFIG_BCH_FORCE_INDIRECT */
 
   return byteswritten;
 }
@@ -187,6 +187,57 @@ static void can_txready_work(FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_rdfilter_match
+ *
+ * Description:
+ *   Return true if a received message should be queued for this reader,
+ *   i.e. the reader has no acceptance filters or one of them matches.
+ *   Error reports are never filtered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CAN_RDFILTER
+static bool can_rdfilter_match(FAR struct can_reader_s *reader,
+                               FAR const struct can_hdr_s *hdr)
+{
+  FAR const struct canioc_rdfilter_s *filter;
+  int i;
+
+  if (reader->nfilters == 0)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_CAN_ERRORS
+  if (hdr->ch_error)
+    {
+      return true;
+    }
+#endif
+
+  for (i = 0; i < reader->nfilters; i++)
+    {
+      filter = &reader->filters[i];
+
+#ifdef CONFIG_CAN_EXTID
+      if (filter->rf_extid != hdr->ch_extid)
+        {
+          continue;
+        }
+#endif
+
+      if ((hdr->ch_id & filter->rf_mask) ==
+          (filter->rf_id & filter->rf_mask))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
@@ -686,11 +737,13 @@ static ssize_t can_write(FAR struct file *filep, FAR const char *buffer,
       nsent += msglen;
     }
 
-  /* We get here after all messages have been added to the sender.  Check if
-   * we need to kick off the XMIT sequence.
+  /* We get here after all messages have been added to the sender.  Kick
+   * off the XMIT sequence if the hardware was idle, and otherwise top up
+   * any TX mailboxes that are free so that they do not sit empty until
+   * the next TX done interrupt.
    */
 
-  if (inactive)
+  if (inactive || dev_txready(dev))
     {
       can_xmit(dev);
     }
@@ -899,6 +952,42 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_CAN_RDFILTER
+      /* CANIOC_ADD_RDFILTER: Add an acceptance filter to this reader.
+       * Argument is a reference to struct canioc_rdfilter_s.
+       */
+
+      case CANIOC_ADD_RDFILTER:
+        {
+          FAR const struct canioc_rdfilter_s *filter =
+            (FAR const struct canioc_rdfilter_s *)((uintptr_t)arg);
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else if (reader->nfilters >= CONFIG_CAN_NRDFILTERS)
+            {
+              ret = -ENOSPC;
+            }
+          else
+            {
+              reader->filters[reader->nfilters++] = *filter;
+            }
+        }
+        break;
+
+      /* CANIOC_CLR_RDFILTERS: Remove all acceptance filters of this
+       * reader.  No argument.
+       */
+
+      case CANIOC_CLR_RDFILTERS:
+        {
+          reader->nfilters = 0;
+        }
+        break;
+#endif
+
       /* Set specific can transceiver state */
 
       case CANIOC_SET_TRANSVSTATE:
@@ -1158,6 +1247,21 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   caninfo("ID: %" PRId32 " DLC: %d\n", (uint32_t)hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Stamp the message on arrival if the lower half does not provide a
+   * hardware timestamp.
+   */
+
+  if (hdr->ch_ts.tv_sec == 0 && hdr->ch_ts.tv_usec == 0)
+    {
+      struct timespec ts;
+
+      clock_systime_timespec(&ts);
+      hdr->ch_ts.tv_sec  = ts.tv_sec;
+      hdr->ch_ts.tv_usec = ts.tv_nsec / NSEC_PER_USEC;
+    }
+#endif
+
   flags = enter_critical_section();
 
   /* Check if adding this new message would over-run the drivers ability to
@@ -1220,6 +1324,18 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
       FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
       fifo = &reader->fifo;
 
+#ifdef CONFIG_CAN_RDFILTER
+      /* Skip readers that are not interested in this message.  Dropping
+       * it on purpose is not an overrun.
+       */
+
+      if (!can_rdfilter_match(reader, hdr))
+        {
+          ret = OK;
+          continue;
+        }
+#endif
+
       nexttail = fifo->rx_tail + 1;
       if (nexttail >= CONFIG_CAN_RXFIFOSIZE)
         {
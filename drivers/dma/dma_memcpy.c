@@ -0,0 +1,215 @@
+/****************************************************************************
+ * drivers/dma/dma_memcpy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/dma/dma_memcpy.h>
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one copy, waited for on the caller's stack */
+
+struct dma_memcpy_s
+{
+  sem_t   done;     /* Posted by the completion callback */
+  ssize_t result;   /* Length transferred or negated errno */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct dma_dev_s *g_dma_memcpy_dev;
+static unsigned int g_dma_memcpy_ident;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_callback
+ ****************************************************************************/
+
+static void dma_memcpy_callback(FAR struct dma_chan_s *chan,
+                                FAR void *arg, ssize_t len)
+{
+  FAR struct dma_memcpy_s *copy = arg;
+
+  copy->result = len;
+  nxsem_post(&copy->done);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_transfer
+ *
+ * Description:
+ *   Copy with the DMA channel.  The destination is cache line aligned.
+ *
+ ****************************************************************************/
+
+static int dma_memcpy_transfer(FAR void *dst, FAR const void *src,
+                               size_t len)
+{
+  FAR struct dma_dev_s *dev = g_dma_memcpy_dev;
+  FAR struct dma_chan_s *chan;
+  struct dma_memcpy_s copy;
+  struct dma_config_s cfg;
+  unsigned int width;
+  int ret;
+
+  /* Use word transfers when everything is word aligned */
+
+  width = (((uintptr_t)dst | (uintptr_t)src | len) & 3) == 0 ? 4 : 1;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.direction = DMA_MEM_TO_MEM;
+  cfg.dst_width = width;
+  cfg.src_width = width;
+  cfg.dst_step  = width;
+  cfg.src_step  = width;
+
+  /* Write the source back to memory and drop the destination lines, so
+   * that no dirty line is evicted over the data written by the DMA.
+   */
+
+  up_clean_dcache((uintptr_t)src, (uintptr_t)src + len);
+  up_invalidate_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+
+  nxsem_init(&copy.done, 0, 0);
+  copy.result = -EIO;
+
+  chan = DMA_GET_CHAN(dev, g_dma_memcpy_ident);
+  ret  = DMA_CONFIG(chan, &cfg);
+  if (ret >= 0)
+    {
+      ret = DMA_START(chan, dma_memcpy_callback, &copy,
+                      (uintptr_t)dst, (uintptr_t)src, len);
+    }
+
+  if (ret >= 0)
+    {
+      ret = nxsem_wait_uninterruptible(&copy.done);
+      if (ret >= 0 && copy.result != (ssize_t)len)
+        {
+          ret = copy.result < 0 ? copy.result : -EIO;
+        }
+    }
+
+  DMA_PUT_CHAN(dev, chan);
+  nxsem_destroy(&copy.done);
+
+  /* Drop anything speculatively loaded while the DMA was running */
+
+  up_invalidate_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ *
+ * Description:
+ *   Select the DMA channel used by dma_memcpy().
+ *
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_dev_s *dev, unsigned int ident)
+{
+  if (dev == NULL || dev->get_chan == NULL || dev->put_chan == NULL)
+    {
+      return -EINVAL;
+    }
+
+  g_dma_memcpy_ident = ident;
+  g_dma_memcpy_dev   = dev;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Copy len bytes from src to dst, with the DMA channel for large copies.
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len)
+{
+  FAR uint8_t *dptr = dst;
+  FAR const uint8_t *sptr = src;
+  size_t linesize;
+  size_t head;
+  size_t body;
+
+  if (len < CONFIG_DMA_MEMCPY_THRESHOLD || g_dma_memcpy_dev == NULL ||
+      up_interrupt_context())
+    {
+      return memcpy(dst, src, len);
+    }
+
+  /* Copy the partial cache lines at both ends of the destination with the
+   * CPU, invalidating them could lose neighbouring data.
+   */
+
+  linesize = up_get_dcache_linesize();
+  head     = 0;
+  body     = len;
+
+  if (linesize > 1)
+    {
+      head = -(uintptr_t)dptr & (linesize - 1);
+      if (head > len)
+        {
+          head = len;
+        }
+
+      body = (len - head) & ~(linesize - 1);
+    }
+
+  if (body < CONFIG_DMA_MEMCPY_THRESHOLD ||
+      dma_memcpy_transfer(dptr + head, sptr + head, body) < 0)
+    {
+      return memcpy(dst, src, len);
+    }
+
+  memcpy(dptr, sptr, head);
+  memcpy(dptr + head + body, sptr + head + body, len - head - body);
+  return dst;
+}
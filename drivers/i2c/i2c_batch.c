@@ -0,0 +1,284 @@
+/****************************************************************************
+ * drivers/i2c/i2c_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_batch_reserve
+ *
+ * Description:
+ *   Make room for nmsgs more messages, flushing the queued ones if the
+ *   batch is full or if they are clocked at a different frequency (the
+ *   lower halves apply one frequency per transfer).
+ *
+ ****************************************************************************/
+
+static int i2c_batch_reserve(FAR struct i2c_batch_s *batch,
+                             FAR const struct i2c_config_s *config,
+                             size_t nmsgs)
+{
+  DEBUGASSERT(batch != NULL && config != NULL);
+  DEBUGASSERT(config->addrlen == 10 || config->addrlen == 7);
+  DEBUGASSERT(nmsgs <= batch->maxmsgs);
+
+  if (batch->msgc + nmsgs > batch->maxmsgs ||
+      (batch->msgc > 0 && batch->msgv[0].frequency != config->frequency))
+    {
+      return i2c_batch_flush(batch);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_batch_add
+ ****************************************************************************/
+
+static void i2c_batch_add(FAR struct i2c_batch_s *batch,
+                          FAR const struct i2c_config_s *config,
+                          unsigned int flags, FAR uint8_t *buffer,
+                          ssize_t buflen)
+{
+  FAR struct i2c_msg_s *msg = &batch->msgv[batch->msgc++];
+
+  if (config->addrlen == 10)
+    {
+      flags |= I2C_M_TEN;
+    }
+
+  msg->frequency = config->frequency;
+  msg->addr      = config->address;
+  msg->flags     = flags;
+  msg->buffer    = buffer;
+  msg->length    = buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_batch_init
+ *
+ * Description:
+ *   Prepare a batch of I2C operations.  Operations queued on the batch are
+ *   only described, not performed, until i2c_batch_flush() runs all of
+ *   them as a single transfer: one START, a repeated START between the
+ *   operations, even if they address different devices, and one STOP at
+ *   the end.  This saves the bus turnaround and the wakeup of the caller
+ *   between operations, and lets the lower half chain the operations.
+ *
+ * Input Parameters:
+ *   batch   - The batch to initialize
+ *   dev     - Device-specific state data
+ *   msgv    - Storage for the queued messages
+ *   maxmsgs - The number of messages in msgv (at least 2)
+ *
+ ****************************************************************************/
+
+void i2c_batch_init(FAR struct i2c_batch_s *batch,
+                    FAR struct i2c_master_s *dev,
+                    FAR struct i2c_msg_s *msgv, size_t maxmsgs)
+{
+  DEBUGASSERT(batch != NULL && dev != NULL && msgv != NULL);
+  DEBUGASSERT(maxmsgs >= 2);
+
+  batch->dev     = dev;
+  batch->msgv    = msgv;
+  batch->maxmsgs = maxmsgs;
+  batch->msgc    = 0;
+}
+
+/****************************************************************************
+ * Name: i2c_batch_write
+ *
+ * Description:
+ *   Queue a write of a block of data.  The buffer must stay valid until
+ *   the batch is flushed.
+ *
+ * Input Parameters:
+ *   batch  - The batch to queue on
+ *   config - Described the I2C configuration
+ *   buffer - A pointer to the read-only buffer of data to be written to
+ *            device
+ *   buflen - The number of bytes to send from the buffer
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno from flushing a full batch
+ *
+ ****************************************************************************/
+
+int i2c_batch_write(FAR struct i2c_batch_s *batch,
+                    FAR const struct i2c_config_s *config,
+                    FAR const uint8_t *buffer, int buflen)
+{
+  int ret;
+
+  ret = i2c_batch_reserve(batch, config, 1);
+  if (ret >= 0)
+    {
+      i2c_batch_add(batch, config, 0,
+                    (FAR uint8_t *)buffer, buflen);  /* Override const */
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: i2c_batch_read
+ *
+ * Description:
+ *   Queue a read of a block of data.  The buffer is only filled in when
+ *   the batch is flushed.
+ *
+ * Input Parameters:
+ *   batch  - The batch to queue on
+ *   config - Described the I2C configuration
+ *   buffer - A pointer to a buffer of data to receive the data from the
+ *            device
+ *   buflen - The requested number of bytes to be read
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno from flushing a full batch
+ *
+ ****************************************************************************/
+
+int i2c_batch_read(FAR struct i2c_batch_s *batch,
+                   FAR const struct i2c_config_s *config,
+                   FAR uint8_t *buffer, int buflen)
+{
+  int ret;
+
+  ret = i2c_batch_reserve(batch, config, 1);
+  if (ret >= 0)
+    {
+      i2c_batch_add(batch, config, I2C_M_READ, buffer, buflen);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: i2c_batch_writeread
+ *
+ * Description:
+ *   Queue the batched equivalent of i2c_writeread(): a write (typically a
+ *   register address) followed by a restarted read, or by a continued
+ *   write if rbuflen is negative.
+ *
+ * Input Parameters:
+ *   batch   - The batch to queue on
+ *   config  - Described the I2C configuration
+ *   wbuffer - A pointer to the read-only buffer of data to be written to
+ *             device
+ *   wbuflen - The number of bytes to send from the buffer
+ *   rbuffer - A pointer to a buffer of data to receive the data from the
+ *             device
+ *   rbuflen - The requested number of bytes to be read
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno from flushing a full batch
+ *
+ ****************************************************************************/
+
+int i2c_batch_writeread(FAR struct i2c_batch_s *batch,
+                        FAR const struct i2c_config_s *config,
+                        FAR const uint8_t *wbuffer, int wbuflen,
+                        FAR uint8_t *rbuffer, int rbuflen)
+{
+  int ret;
+
+  ret = i2c_batch_reserve(batch, config, 2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  i2c_batch_add(batch, config, I2C_M_NOSTOP,
+                (FAR uint8_t *)wbuffer, wbuflen);  /* Override const */
+
+  if (rbuflen > 0)
+    {
+      i2c_batch_add(batch, config, I2C_M_READ, rbuffer, rbuflen);
+    }
+  else
+    {
+      i2c_batch_add(batch, config, I2C_M_NOSTART, rbuffer, -rbuflen);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_batch_flush
+ *
+ * Description:
+ *   Perform all the queued operations as one transfer and empty the batch.
+ *   Every message but the last is sent without a STOP, so the operations
+ *   are separated by repeated STARTs and the bus is held for the whole
+ *   batch.
+ *
+ * Input Parameters:
+ *   batch - The batch to flush
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_batch_flush(FAR struct i2c_batch_s *batch)
+{
+  size_t i;
+  int ret;
+
+  DEBUGASSERT(batch != NULL);
+
+  if (batch->msgc == 0)
+    {
+      return OK;
+    }
+
+  for (i = 0; i < batch->msgc - 1; i++)
+    {
+      batch->msgv[i].flags |= I2C_M_NOSTOP;
+    }
+
+  batch->msgv[i].flags &= ~I2C_M_NOSTOP;
+
+  ret = I2C_TRANSFER(batch->dev, batch->msgv, batch->msgc);
+  batch->msgc = 0;
+
+  return (ret >= 0) ? OK : ret;
+}
@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -35,7 +37,9 @@
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/lcd/lcd.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_LCD_FRAMEBUFFER
 
@@ -65,6 +69,15 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  /* Areas changed since the last write to the LCD */
+
+  spinlock_t lock;                  /* Protects the damage list */
+  struct work_s work;               /* Writes the damage to the LCD */
+  int ndamage;                      /* Number of damage rectangles */
+  struct fb_area_s damage[CONFIG_LCD_FRAMEBUFFER_NDAMAGE];
+#endif
 };
 
 /****************************************************************************
@@ -154,17 +167,16 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_putarea
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Write an area of the framebuffer to the LCD.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
   FAR uint8_t *run = priv->fbmem;
   fb_coord_t row;
@@ -257,12 +269,193 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
         }
     }
 
-  if (pinfo->redraw != NULL)
+  return OK;
+}
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+/****************************************************************************
+ * Name: lcdfb_touches
+ *
+ * Description:
+ *   Return true if two areas overlap or share an edge.
+ *
+ ****************************************************************************/
+
+static bool lcdfb_touches(FAR const struct fb_area_s *a,
+                          FAR const struct fb_area_s *b)
+{
+  return a->x <= b->x + b->w && b->x <= a->x + a->w &&
+         a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_union
+ *
+ * Description:
+ *   Grow an area to the bounding box of itself and another one.
+ *
+ ****************************************************************************/
+
+static void lcdfb_union(FAR struct fb_area_s *dst,
+                        FAR const struct fb_area_s *src)
+{
+  fb_coord_t endx = MAX(dst->x + dst->w, src->x + src->w);
+  fb_coord_t endy = MAX(dst->y + dst->h, src->y + src->h);
+
+  dst->x = MIN(dst->x, src->x);
+  dst->y = MIN(dst->y, src->y);
+  dst->w = endx - dst->x;
+  dst->h = endy - dst->y;
+}
+
+/****************************************************************************
+ * Name: lcdfb_adddamage
+ *
+ * Description:
+ *   Add an area to the damage list, merging it with the areas it touches.
+ *   If the list is full, the area is merged with the rectangle that grows
+ *   the least.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void lcdfb_adddamage(FAR struct lcdfb_dev_s *priv,
+                            FAR const struct fb_area_s *area)
+{
+  struct fb_area_s merged = *area;
+  uint32_t growth;
+  uint32_t best = UINT32_MAX;
+  int target = 0;
+  int i;
+
+  /* Absorb every rectangle the new one touches.  The merged rectangle may
+   * touch rectangles it did not touch before, so start over each time.
+   */
+
+  for (i = 0; i < priv->ndamage; )
+    {
+      if (lcdfb_touches(&priv->damage[i], &merged))
+        {
+          lcdfb_union(&merged, &priv->damage[i]);
+          priv->damage[i] = priv->damage[--priv->ndamage];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (priv->ndamage < CONFIG_LCD_FRAMEBUFFER_NDAMAGE)
+    {
+      priv->damage[priv->ndamage++] = merged;
+      return;
+    }
+
+  for (i = 0; i < priv->ndamage; i++)
+    {
+      struct fb_area_s tmp = priv->damage[i];
+
+      lcdfb_union(&tmp, &merged);
+      growth = (uint32_t)tmp.w * tmp.h -
+               (uint32_t)priv->damage[i].w * priv->damage[i].h;
+      if (growth < best)
+        {
+          best   = growth;
+          target = i;
+        }
+    }
+
+  lcdfb_union(&priv->damage[target], &merged);
+}
+
+/****************************************************************************
+ * Name: lcdfb_worker
+ *
+ * Description:
+ *   Write the recorded damage to the LCD.  Areas recorded while this runs
+ *   are written by the next run.
+ *
+ ****************************************************************************/
+
+static void lcdfb_worker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  struct fb_area_s damage[CONFIG_LCD_FRAMEBUFFER_NDAMAGE];
+  irqstate_t flags;
+  int ndamage;
+  int i;
+
+  flags = spin_lock_irqsave(&priv->lock);
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct fb_area_s));
+  priv->ndamage = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      lcdfb_putarea(priv, &damage[i]);
+    }
+
+  if (ndamage > 0 && pinfo->redraw != NULL)
     {
       pinfo->redraw(pinfo->dev);
     }
+}
+#endif
+
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ * Update the LCD when there is a change to the framebuffer.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  struct fb_area_s full;
+  irqstate_t flags;
+
+  if (area == NULL)
+    {
+      full.x = 0;
+      full.y = 0;
+      full.w = priv->xres;
+      full.h = priv->yres;
+      area   = &full;
+    }
+
+  if (area->w == 0 || area->h == 0)
+    {
+      return OK;
+    }
+
+  flags = spin_lock_irqsave(&priv->lock);
+  lcdfb_adddamage(priv, area);
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, lcdfb_worker, priv, 0);
+    }
 
   return OK;
+#else
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  int ret;
+
+  ret = lcdfb_putarea(priv, area);
+  if (ret >= 0 && pinfo->redraw != NULL)
+    {
+      pinfo->redraw(pinfo->dev);
+    }
+
+  return ret;
+#endif
 }
 
 /****************************************************************************
@@ -623,6 +816,9 @@ int up_fbinitialize(int display)
   /* Initialize the LCD-independent fields of the state structure */
 
   priv->display             = display;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  spin_lock_init(&priv->lock);
+#endif
 
   priv->vtable.getvideoinfo = lcdfb_getvideoinfo,
   priv->vtable.getplaneinfo = lcdfb_getplaneinfo,
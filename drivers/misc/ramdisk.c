@@ -40,6 +40,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/uio.h>
 #include <nuttx/drivers/ramdisk.h>
 
 /****************************************************************************
@@ -91,6 +92,10 @@ static ssize_t rd_read(FAR struct inode *inode, FAR unsigned char *buffer,
 static ssize_t rd_write(FAR struct inode *inode,
                         FAR const unsigned char *buffer,
                         blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t rd_readv(FAR struct inode *inode, FAR struct uio *uio,
+                        blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t rd_writev(FAR struct inode *inode, FAR struct uio *uio,
+                         blkcnt_t start_sector, unsigned int nsectors);
 static int     rd_geometry(FAR struct inode *inode,
                            FAR struct geometry *geometry);
 static int     rd_ioctl(FAR struct inode *inode, int cmd,
@@ -116,10 +121,12 @@ static const struct block_operations g_bops =
   rd_read,     /* read     */
   rd_write,    /* write    */
   rd_geometry, /* geometry */
-  rd_ioctl     /* ioctl    */
+  rd_ioctl,    /* ioctl    */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , rd_unlink  /* unlink   */
+  rd_unlink,   /* unlink   */
 #endif
+  rd_readv,    /* readv    */
+  rd_writev    /* writev   */
 };
 
 /****************************************************************************
@@ -296,6 +303,62 @@ static ssize_t rd_write(FAR struct inode *inode,
   return -EFBIG;
 }
 
+/****************************************************************************
+ * Name: rd_readv
+ *
+ * Description: Read the specified number of sectors into the segments
+ *
+ ****************************************************************************/
+
+static ssize_t rd_readv(FAR struct inode *inode, FAR struct uio *uio,
+                        blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct rd_struct_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  if (start_sector < dev->rd_nsectors &&
+      start_sector + nsectors <= dev->rd_nsectors)
+    {
+      uio_copyfrom(uio, 0, &dev->rd_buffer[start_sector * dev->rd_sectsize],
+                   nsectors * dev->rd_sectsize);
+      return nsectors;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: rd_writev
+ *
+ * Description: Write the specified number of sectors from the segments
+ *
+ ****************************************************************************/
+
+static ssize_t rd_writev(FAR struct inode *inode, FAR struct uio *uio,
+                         blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct rd_struct_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  if (!RDFLAG_IS_WRENABLED(dev->rd_flags))
+    {
+      return -EACCES;
+    }
+  else if (start_sector < dev->rd_nsectors &&
+           start_sector + nsectors <= dev->rd_nsectors)
+    {
+      uio_copyto(uio, 0, &dev->rd_buffer[start_sector * dev->rd_sectsize],
+                 nsectors * dev->rd_sectsize);
+      return nsectors;
+    }
+
+  return -EFBIG;
+}
+
 /****************************************************************************
  * Name: rd_geometry
  *
@@ -71,6 +71,10 @@ struct rpmsgblk_cookie_s
   sem_t     sem;     /* Semaphore used for rpmsg */
   int       result;  /* The return value of the remote call */
   FAR void *data;    /* The return data buffer of the remote call */
+
+  /* Read data handed over to the caller */
+
+  struct rpmsg_rxslot_s slot;
 };
 
 /****************************************************************************
@@ -870,7 +874,12 @@ static int rpmsgblk_send_recv(FAR struct rpmsgblk_s *priv,
       goto fail;
     }
 
-  ret = rpmsg_wait(&priv->ept, &cookie.sem);
+  do
+    {
+      ret = rpmsg_wait(&priv->ept, &cookie.sem);
+    }
+  while (ret >= 0 && rpmsg_rxslot_get(&priv->ept, &cookie.slot));
+
   if (ret >= 0)
     {
       ret = cookie.result;
@@ -946,18 +955,25 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
       (FAR struct rpmsgblk_cookie_s *)(uintptr_t)header->cookie;
   FAR struct rpmsgblk_read_s *rsp = data;
   FAR struct iovec *iov = cookie->data;
+  bool handed = false;
   size_t read;
+  bool last;
 
   cookie->result = header->result;
+  last = cookie->result <= 0 ||
+         iov->iov_len + cookie->result >= rsp->nsectors;
   if (cookie->result > 0)
     {
+      /* Let the reader copy the data, the rx thread goes on receiving */
+
       read = cookie->result * rsp->sectorsize;
-      memcpy(iov->iov_base, rsp->buf, read);
+      handed = rpmsg_rxslot_put(ept, &cookie->slot, data, iov->iov_base,
+                                rsp->buf, read, last);
       iov->iov_base += read;
       iov->iov_len  += cookie->result;
     }
 
-  if (cookie->result <= 0 || iov->iov_len >= rsp->nsectors)
+  if (handed || last)
     {
       return rpmsg_post(ept, &cookie->sem);
     }
@@ -86,6 +86,10 @@ struct rpmsgdev_cookie_s
   sem_t     sem;     /* Semaphore used for rpmsg */
   int       result;  /* The return value of the remote call */
   FAR void *data;    /* The return data buffer of the remote call */
+
+  /* Read data handed over to the caller */
+
+  struct rpmsg_rxslot_s slot;
 };
 
 /****************************************************************************
@@ -840,7 +844,12 @@ static int rpmsgdev_send_recv(FAR struct rpmsgdev_s *priv,
       goto fail;
     }
 
-  ret = rpmsg_wait(&priv->ept, &cookie.sem);
+  do
+    {
+      ret = rpmsg_wait(&priv->ept, &cookie.sem);
+    }
+  while (ret >= 0 && rpmsg_rxslot_get(&priv->ept, &cookie.slot));
+
   if (ret >= 0)
     {
       ret = cookie.result;
@@ -917,16 +926,23 @@ static int rpmsgdev_read_handler(FAR struct rpmsg_endpoint *ept,
       (FAR struct rpmsgdev_cookie_s *)(uintptr_t)header->cookie;
   FAR struct rpmsgdev_read_s *rsp = data;
   FAR struct iovec *read = cookie->data;
+  bool handed = false;
+  bool last;
 
   cookie->result = header->result;
+  last = header->command == RPMSGDEV_READ_NOFRAG || cookie->result <= 0 ||
+         read->iov_len + cookie->result >= rsp->count;
   if (cookie->result > 0)
     {
-      memcpy(read->iov_base + read->iov_len, rsp->buf, cookie->result);
+      /* Let the reader copy the data, the rx thread goes on receiving */
+
+      handed = rpmsg_rxslot_put(ept, &cookie->slot, data,
+                                read->iov_base + read->iov_len, rsp->buf,
+                                cookie->result, last);
       read->iov_len += cookie->result;
     }
 
-  if (header->command == RPMSGDEV_READ_NOFRAG ||
-      cookie->result <= 0 || read->iov_len >= rsp->count)
+  if (handed || last)
     {
       rpmsg_post(ept, &cookie->sem);
     }
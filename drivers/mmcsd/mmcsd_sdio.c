@@ -104,6 +104,14 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+#ifdef CONFIG_SDIO_DMA_SG
+#  if (CONFIG_SDIO_DMA_SG_ALIGN & (CONFIG_SDIO_DMA_SG_ALIGN - 1)) != 0
+#    error CONFIG_SDIO_DMA_SG_ALIGN must be a power of two
+#  endif
+#  define MMCSD_SG_ALIGN        CONFIG_SDIO_DMA_SG_ALIGN
+#  define MMCSD_SG_MAXSEGS      3 /* Head bounce, in place body, tail bounce */
+#endif
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 #ifdef CONFIG_BOARD_COREDUMP_BLKDEV
@@ -177,6 +185,14 @@ static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
                                    uint32_t nblocks);
 #endif
+#if MMCSD_MULTIBLOCK_LIMIT != 1 && defined(CONFIG_SDIO_DMA_SG)
+static int     mmcsd_sgsetup(FAR uint8_t *buffer, size_t nbytes,
+                             FAR uint8_t *bounce,
+                             FAR struct sdio_dmaseg_s *segs, bool write);
+static void    mmcsd_sgfinish(FAR uint8_t *buffer,
+                              FAR const struct sdio_dmaseg_s *segs,
+                              int nsegs);
+#endif
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_part_s *part,
                                 FAR uint8_t *buffer, off_t startblock);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
@@ -1470,6 +1486,82 @@ static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
 }
 #endif
 
+#if MMCSD_MULTIBLOCK_LIMIT != 1 && defined(CONFIG_SDIO_DMA_SG)
+/****************************************************************************
+ * Name: mmcsd_sgsetup
+ *
+ * Description:
+ *   Describe an unaligned buffer as a scatter-gather list: the partial
+ *   lines at its start and end go through the two lines of the bounce
+ *   buffer, everything in between is transferred in place.  For a write,
+ *   the partial lines are copied into the bounce buffer here.
+ *
+ * Returned Value:
+ *   The number of segments, or zero if the buffer is aligned and can be
+ *   transferred with a plain DMA.
+ *
+ ****************************************************************************/
+
+static int mmcsd_sgsetup(FAR uint8_t *buffer, size_t nbytes,
+                         FAR uint8_t *bounce,
+                         FAR struct sdio_dmaseg_s *segs, bool write)
+{
+  size_t head;
+  size_t body;
+  size_t tail;
+  int nsegs = 0;
+
+  head = -(uintptr_t)buffer & (MMCSD_SG_ALIGN - 1);
+  if (head == 0 || nbytes <= 2 * MMCSD_SG_ALIGN)
+    {
+      return 0;
+    }
+
+  body = (nbytes - head) & ~(MMCSD_SG_ALIGN - 1);
+  tail = nbytes - head - body;
+
+  segs[nsegs].buffer   = bounce;
+  segs[nsegs++].buflen = head;
+  segs[nsegs].buffer   = buffer + head;
+  segs[nsegs++].buflen = body;
+
+  if (tail > 0)
+    {
+      segs[nsegs].buffer   = bounce + MMCSD_SG_ALIGN;
+      segs[nsegs++].buflen = tail;
+    }
+
+  if (write)
+    {
+      memcpy(bounce, buffer, head);
+      memcpy(bounce + MMCSD_SG_ALIGN, buffer + head + body, tail);
+    }
+
+  return nsegs;
+}
+
+/****************************************************************************
+ * Name: mmcsd_sgfinish
+ *
+ * Description:
+ *   Copy the partial lines of a read from the bounce buffer back to the
+ *   caller's buffer.
+ *
+ ****************************************************************************/
+
+static void mmcsd_sgfinish(FAR uint8_t *buffer,
+                           FAR const struct sdio_dmaseg_s *segs, int nsegs)
+{
+  size_t body = segs[0].buflen + segs[1].buflen;
+
+  memcpy(buffer, segs[0].buffer, segs[0].buflen);
+  if (nsegs > 2)
+    {
+      memcpy(buffer + body, segs[2].buffer, segs[2].buflen);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_readsingle
  *
@@ -1678,6 +1770,11 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
   memset(&dma_align_manager,0,sizeof(dma_align_manager));
   uint8_t *aligned_buffer=(uint8_t *)buffer;
   struct dma_align_allocator_s *dma_align_allocator=SDIO_DMA_ALLOCATOR(priv->dev);
+  int nsegs = 0;
+#endif
+#ifdef CONFIG_SDIO_DMA_SG
+  uint8_t sgbounce[2 * MMCSD_SG_ALIGN] aligned_data(MMCSD_SG_ALIGN);
+  struct sdio_dmaseg_s segs[MMCSD_SG_MAXSEGS];
 #endif
   finfo("startblock=%jd nblocks=%zu\n", (intmax_t)startblock, nblocks);
   DEBUGASSERT(priv != NULL && buffer != NULL);
@@ -1704,11 +1801,23 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
       priv->partnum = partnum;
     }
 
+#ifdef CONFIG_SDIO_DMA_SG
+  /* A scatter-gather capable controller reads an unaligned buffer in
+   * place, only its partial first and last lines are bounced.
+   */
+
+  if ((priv->caps & (SDIO_CAPS_DMASUPPORTED | SDIO_CAPS_DMA_SG)) ==
+      (SDIO_CAPS_DMASUPPORTED | SDIO_CAPS_DMA_SG))
+    {
+      nsegs = mmcsd_sgsetup(buffer, nbytes, sgbounce, segs, false);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
    */
- if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
+ if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0 && nsegs == 0)
   {
     #ifdef CONFIG_ARCH_HAVE_SDIO_PREFLIGHT
     ret = SDIO_DMAPREFLIGHT(priv->dev, buffer, nbytes);
@@ -1782,7 +1891,17 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
 #ifdef CONFIG_SDIO_DMA
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMARECVSETUP(priv->dev, aligned_buffer, nbytes);
+#ifdef CONFIG_SDIO_DMA_SG
+      if (nsegs > 0)
+        {
+          ret = SDIO_DMARECVSETUP_SG(priv->dev, segs, nsegs);
+        }
+      else
+#endif
+        {
+          ret = SDIO_DMARECVSETUP(priv->dev, aligned_buffer, nbytes);
+        }
+
       if (ret != OK)
         {
           finfo("SDIO_DMARECVSETUP: error %d\n", ret);
@@ -1849,6 +1968,12 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
       {
         memcpy(buffer,aligned_buffer,nbytes);
       }
+#ifdef CONFIG_SDIO_DMA_SG
+      else if (nsegs > 0)
+        {
+          mmcsd_sgfinish(buffer, segs, nsegs);
+        }
+#endif
     } 
 #endif
 
@@ -2107,6 +2232,11 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
   memset(&dma_align_manager,0,sizeof(dma_align_manager));
   uint8_t *aligned_buffer=(uint8_t *)buffer;
   struct dma_align_allocator_s *dma_align_allocator=SDIO_DMA_ALLOCATOR(priv->dev);
+  int nsegs = 0;
+#endif
+#ifdef CONFIG_SDIO_DMA_SG
+  uint8_t sgbounce[2 * MMCSD_SG_ALIGN] aligned_data(MMCSD_SG_ALIGN);
+  struct sdio_dmaseg_s segs[MMCSD_SG_MAXSEGS];
 #endif
 
   finfo("startblock=%jd nblocks=%zu\n", (intmax_t)startblock, nblocks);
@@ -2136,9 +2266,22 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
       priv->partnum = partnum;
     }
 
+#ifdef CONFIG_SDIO_DMA_SG
+  /* A scatter-gather capable controller writes an unaligned buffer in
+   * place, only its partial first and last lines are bounced.
+   */
+
+  if ((priv->caps & (SDIO_CAPS_DMASUPPORTED | SDIO_CAPS_DMA_SG)) ==
+      (SDIO_CAPS_DMASUPPORTED | SDIO_CAPS_DMA_SG))
+    {
+      nsegs = mmcsd_sgsetup((FAR uint8_t *)buffer, nbytes, sgbounce, segs,
+                            true);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) 
 
-     if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
+     if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0 && nsegs == 0)
     {
       #ifdef CONFIG_ARCH_HAVE_SDIO_PREFLIGHT
       ret = SDIO_DMAPREFLIGHT(priv->dev, buffer, nbytes);
@@ -2293,7 +2436,17 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 #ifdef CONFIG_SDIO_DMA
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMASENDSETUP(priv->dev, aligned_buffer, nbytes);
+#ifdef CONFIG_SDIO_DMA_SG
+      if (nsegs > 0)
+        {
+          ret = SDIO_DMASENDSETUP_SG(priv->dev, segs, nsegs);
+        }
+      else
+#endif
+        {
+          ret = SDIO_DMASENDSETUP(priv->dev, aligned_buffer, nbytes);
+        }
+
       if (ret != OK)
         {
           ferr("SDIO_DMASENDSETUP: error %d\n", ret);
@@ -34,6 +34,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <dhara/map.h>
 #include <dhara/nand.h>
@@ -63,6 +64,9 @@ struct dhara_dev_s
 
   FAR struct mtd_dev_s *mtd;      /* Contained MTD interface */
   struct mtd_geometry_s geo;      /* Device geometry */
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  struct rwbuffer_s     rwb;      /* Write buffer support */
+#endif
   uint16_t              blkper;   /* R/W blocks per erase block */
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
@@ -87,10 +91,14 @@ typedef struct dhara_dev_s dhara_dev_t;
 
 static int     dhara_open(FAR struct inode *inode);
 static int     dhara_close(FAR struct inode *inode);
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks);
 static ssize_t dhara_read(FAR struct inode *inode,
                           FAR unsigned char *buffer,
                           blkcnt_t start_sector,
                           unsigned int nsectors);
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t startblock, size_t nblocks);
 static ssize_t dhara_write(FAR struct inode *inode,
                            FAR const unsigned char *buffer,
                            blkcnt_t start_sector,
@@ -321,12 +329,20 @@ static int dhara_close(FAR struct inode *inode)
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  rwb_flush(&dev->rwb);
+#endif
+
   nxmutex_lock(&dev->lock);
   dev->refs--;
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
       kmm_free(dev->pagebuf);
@@ -337,86 +353,185 @@ static int dhara_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: dhara_read
+ * Name: dhara_readrun
  *
- * Description:  Read the specified number of sectors
+ * Description:
+ *   Read npages consecutive pages.  A single page goes through the page
+ *   cache, longer runs are read with one MTD transfer.
  *
  ****************************************************************************/
 
-static ssize_t dhara_read(FAR struct inode *inode,
-                          FAR unsigned char *buffer,
-                          blkcnt_t start_sector,
-                          unsigned int nsectors)
+static int dhara_readrun(FAR dhara_dev_t *dev, dhara_page_t page,
+                         size_t npages, FAR uint8_t *buffer)
 {
-  FAR dhara_dev_t *dev;
+  dhara_error_t err;
+  ssize_t ret;
+
+  if (npages == 1)
+    {
+      ret = dhara_nand_read(&dev->nand, page, 0, dev->geo.blocksize,
+                            buffer, &err);
+      return ret < 0 ? dhara_convert_result(err) : 0;
+    }
+
+  ret = MTD_BREAD(dev->mtd, page, npages, buffer);
+  if (ret == -EUCLEAN)
+    {
+      ret = npages; /* Ignore the correctable ECC error */
+    }
+
+  return ret == npages ? 0 : ret < 0 ? (int)ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: dhara_reload
+ *
+ * Description:
+ *   Read the specified number of sectors.  The map is looked up for each
+ *   sector, but sectors that the journal stored in consecutive pages are
+ *   read together.
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks)
+{
+  FAR dhara_dev_t *dev = priv;
+  FAR uint8_t *runbuf = buffer;
+  dhara_page_t runpage = 0;
+  size_t runlen = 0;
   size_t nread = 0;
   int ret = 0;
 
-  DEBUGASSERT(inode->i_private);
-  dev = inode->i_private;
-
   nxmutex_lock(&dev->lock);
-  while (nsectors-- > 0)
+  while (nread < nblocks)
     {
       dhara_error_t err;
-      ret = dhara_map_read(&dev->map,
-                           start_sector,
-                           buffer,
-                           &err);
-      if (ret < 0)
+      dhara_page_t page;
+      bool found;
+
+      found = dhara_map_find(&dev->map, startblock + nread, &page,
+                             &err) >= 0;
+      if (found && runlen > 0 && page == runpage + runlen)
+        {
+          runlen++;
+          nread++;
+          continue;
+        }
+
+      /* The sector does not extend the current run, read the run */
+
+      if (runlen > 0)
+        {
+          ret = dhara_readrun(dev, runpage, runlen, runbuf);
+          if (ret < 0)
+            {
+              nread -= runlen;
+              runlen = 0;
+              break;
+            }
+
+          runlen = 0;
+        }
+
+      if (found)
+        {
+          runbuf  = buffer + nread * dev->geo.blocksize;
+          runpage = page;
+          runlen  = 1;
+        }
+      else if (err == DHARA_E_NOT_FOUND)
+        {
+          /* Never written, read as erased */
+
+          memset(buffer + nread * dev->geo.blocksize, 0xff,
+                 dev->geo.blocksize);
+        }
+      else
         {
           ret = dhara_convert_result(err);
-          ferr("Read startblock %lld failed nread %zd err: %s\n",
-               (long long)start_sector, nread, dhara_strerror(err));
           break;
         }
 
       nread++;
-      start_sector++;
-      buffer += dev->geo.blocksize;
+    }
+
+  if (runlen > 0)
+    {
+      ret = dhara_readrun(dev, runpage, runlen, runbuf);
+      if (ret < 0)
+        {
+          nread -= runlen;
+        }
     }
 
   nxmutex_unlock(&dev->lock);
+
+  if (ret < 0)
+    {
+      ferr("Read startblock %lld failed nread %zu err: %d\n",
+           (long long)startblock, nread, ret);
+    }
+
   return nread ? nread : ret;
 }
 
 /****************************************************************************
- * Name: dhara_write
+ * Name: dhara_read
  *
- * Description: Write (or buffer) the specified number of sectors
+ * Description:  Read the specified number of sectors
  *
  ****************************************************************************/
 
-static ssize_t dhara_write(FAR struct inode *inode,
-                           FAR const unsigned char *buffer,
-                           blkcnt_t start_sector,
-                           unsigned int nsectors)
+static ssize_t dhara_read(FAR struct inode *inode,
+                          FAR unsigned char *buffer,
+                          blkcnt_t start_sector,
+                          unsigned int nsectors)
 {
   FAR dhara_dev_t *dev;
-  size_t nwrite = 0;
-  int ret = 0;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_reload(dev, buffer, start_sector, nsectors);
+#endif
+}
+
+/****************************************************************************
+ * Name: dhara_flush
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t startblock, size_t nblocks)
+{
+  FAR dhara_dev_t *dev = priv;
+  size_t nwrite = 0;
+  int ret = 0;
+
   nxmutex_lock(&dev->lock);
-  while (nsectors-- > 0)
+  while (nblocks-- > 0)
     {
       dhara_error_t err;
       ret = dhara_map_write(&dev->map,
-                            start_sector,
+                            startblock,
                             buffer,
                             &err);
       if (ret < 0)
         {
           ret = dhara_convert_result(err);
           ferr("Write starting at block %lld failed nwrite %zu err %s\n",
-               (long long)start_sector, nwrite, dhara_strerror(err));
+               (long long)startblock, nwrite, dhara_strerror(err));
           break;
         }
 
       nwrite++;
-      start_sector++;
+      startblock++;
       buffer += dev->geo.blocksize;
     }
 
@@ -424,6 +539,30 @@ static ssize_t dhara_write(FAR struct inode *inode,
   return nwrite ? nwrite : ret;
 }
 
+/****************************************************************************
+ * Name: dhara_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_write(FAR struct inode *inode,
+                           FAR const unsigned char *buffer,
+                           blkcnt_t start_sector,
+                           unsigned int nsectors)
+{
+  FAR dhara_dev_t *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_flush(dev, buffer, start_sector, nsectors);
+#endif
+}
+
 /****************************************************************************
  * Name: dhara_geometry
  *
@@ -472,6 +611,13 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  if (cmd == BIOC_FLUSH)
+    {
+      rwb_flush(&dev->rwb);
+    }
+#endif
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -506,6 +652,9 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
       kmm_free(dev->pagebuf);
@@ -750,6 +899,27 @@ int dhara_initialize_by_path(FAR const char *path,
 
   dhara_map_resume(&dev->map, NULL);
 
+  /* Configure write buffering, the buffer gathers up to one erase block of
+   * adjacent sectors before they are written to the journal.
+   */
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  dev->rwb.blocksize     = dev->geo.blocksize;
+  dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+  dev->rwb.dev           = (FAR void *)dev;
+  dev->rwb.wrflush       = dhara_flush;
+  dev->rwb.rhreload      = dhara_reload;
+  dev->rwb.wrmaxblocks   = dev->blkper;
+  dev->rwb.wralignblocks = dev->blkper;
+
+  ret = rwb_initialize(&dev->rwb);
+  if (ret < 0)
+    {
+      ferr("rwb_initialize failed: %d\n", ret);
+      goto err;
+    }
+#endif
+
   /* Inode private data is a reference to the
    * DHARA_MTDBLOCK device structure
    */
@@ -758,6 +928,9 @@ int dhara_initialize_by_path(FAR const char *path,
   if (ret < 0)
     {
       ferr("register_blockdriver failed: %d\n", ret);
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       goto err;
     }
 
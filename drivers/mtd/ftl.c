@@ -430,6 +430,75 @@ static ssize_t ftl_mtd_erase(FAR struct ftl_struct_s *dev, off_t startblock)
     }
 }
 
+/****************************************************************************
+ * Name: ftl_mtd_rmw
+ *
+ * Description:
+ *   Replace count blocks at offset (in blocks) of the erase block starting
+ *   at rwblock: read the blocks of the erase block that are kept, erase it
+ *   and write it back with the new data.  The blocks that are replaced are
+ *   not read.
+ *
+ ****************************************************************************/
+
+static int ftl_mtd_rmw(FAR struct ftl_struct_s *dev, off_t rwblock,
+                       off_t offset, size_t count,
+                       FAR const uint8_t *buffer)
+{
+  size_t tail = dev->blkper - offset - count;
+  ssize_t nxfrd;
+  int ret;
+
+  /* Read the blocks before and after the new data into the buffer */
+
+  if (offset > 0)
+    {
+      nxfrd = ftl_mtd_bread(dev, rwblock, offset, dev->eblock);
+      if (nxfrd != offset)
+        {
+          return -EIO;
+        }
+    }
+
+  if (tail > 0)
+    {
+      nxfrd = ftl_mtd_bread(dev, rwblock + offset + count, tail,
+                            dev->eblock +
+                            (offset + count) * dev->geo.blocksize);
+      if (nxfrd != tail)
+        {
+          return -EIO;
+        }
+    }
+
+  /* Then erase the erase block */
+
+  ret = ftl_mtd_erase(dev, rwblock / dev->blkper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Copy the user data into the buffered erase block */
+
+  finfo("Copy %zu blocks into erase block=%" PRIdOFF
+        " at block offset=%" PRIdOFF "\n",
+        count, rwblock / dev->blkper, offset);
+
+  memcpy(dev->eblock + offset * dev->geo.blocksize, buffer,
+         count * dev->geo.blocksize);
+
+  /* And write the erase block back to flash */
+
+  nxfrd = ftl_mtd_bwrite(dev, rwblock, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -484,12 +553,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   off_t  alignedblock;
   off_t  mask;
-  off_t  rwblock;
   off_t  eraseblock;
   off_t  offset;
   size_t remaining;
   size_t nxfrd;
-  int    nbytes;
   int    ret;
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
@@ -505,66 +572,21 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   remaining = nblocks;
   if (alignedblock > startblock)
     {
-      /* Check if the write is shorter than to the end of the erase block */
-
-      bool short_write = (remaining < (alignedblock - startblock));
+      /* The write may end before the end of the erase block */
 
-      /* Read the full erase block into the buffer */
-
-      rwblock = startblock & ~mask;
-      nxfrd   = ftl_mtd_bread(dev, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          return -EIO;
-        }
-
-      /* Then erase the erase block */
+      offset = startblock & mask;
+      nxfrd  = MIN(remaining, (size_t)(dev->blkper - offset));
 
-      eraseblock = rwblock / dev->blkper;
-      ret        = ftl_mtd_erase(dev, eraseblock);
+      ret = ftl_mtd_rmw(dev, startblock & ~mask, offset, nxfrd, buffer);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Copy the user data at the end of the buffered erase block */
-
-      offset = (startblock & mask) * dev->geo.blocksize;
-
-      if (short_write)
-        {
-          nbytes = remaining * dev->geo.blocksize;
-        }
-      else
-        {
-          nbytes = dev->geo.erasesize - offset;
-        }
-
-      finfo("Copy %d bytes into erase block=%" PRIdOFF
-            " at offset=%" PRIdOFF "\n", nbytes, eraseblock, offset);
-
-      memcpy(dev->eblock + offset, buffer, nbytes);
-
-      /* And write the erase block back to flash */
-
-      nxfrd = ftl_mtd_bwrite(dev, rwblock, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          return -EIO;
-        }
-
       /* Then update for amount written */
 
-      if (short_write)
-        {
-          remaining = 0;
-        }
-      else
-        {
-          remaining -= dev->blkper - (startblock & mask);
-        }
-
-      buffer += nbytes;
+      remaining -= nxfrd;
+      buffer    += nxfrd * dev->geo.blocksize;
     }
 
   /* How handle full erase pages in the middle */
@@ -602,37 +624,11 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
   if (remaining > 0)
     {
-      /* Read the full erase block into the buffer */
-
-      nxfrd = ftl_mtd_bread(dev, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          return -EIO;
-        }
-
-      /* Then erase the erase block */
-
-      eraseblock = alignedblock / dev->blkper;
-      ret        = ftl_mtd_erase(dev, eraseblock);
+      ret = ftl_mtd_rmw(dev, alignedblock, 0, remaining, buffer);
       if (ret < 0)
         {
           return ret;
         }
-
-      /* Copy the user data at the beginning the buffered erase block */
-
-      nbytes = remaining * dev->geo.blocksize;
-      finfo("Copy %d bytes into erase block=%" PRIdOFF " at offset=0\n",
-             nbytes, alignedblock);
-      memcpy(dev->eblock, buffer, nbytes);
-
-      /* And write the erase back to flash */
-
-      nxfrd = ftl_mtd_bwrite(dev, alignedblock, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          return -EIO;
-        }
     }
 
   return nblocks;
@@ -0,0 +1,565 @@
+/****************************************************************************
+ * drivers/mtd/mtd_rcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* MTD driver that contains another MTD driver and keeps the most recently
+ * read lines of it in RAM, so that small random reads (file system
+ * metadata, directory walks) are not each turned into a full command
+ * sequence on the bus.  Writes and erases go straight to the contained
+ * driver and invalidate the lines they touch.  If the contained driver
+ * reports a memory mapped window through BIOC_XIPBASE, reads are served
+ * from that window instead.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+#ifdef CONFIG_MTD_RCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached line of the contained device */
+
+struct mtd_rcache_line_s
+{
+  struct list_node      node;   /* LRU list, most recently used first */
+  off_t                 offset; /* Device offset of the line, -1 if empty */
+  FAR uint8_t          *data;   /* Line data */
+};
+
+/* This type represents the state of the MTD device.
+ * The struct mtd_dev_s must appear at the beginning of the definition so
+ * that you can freely cast between pointers to struct mtd_dev_s and struct
+ * mtd_rcache_s.
+ */
+
+struct mtd_rcache_s
+{
+  struct mtd_dev_s      mtd;       /* Our exported MTD interface */
+  FAR struct mtd_dev_s *dev;       /* Saved lower level MTD interface */
+  mutex_t               lock;      /* Serialize cache and device access */
+  FAR uint8_t          *xipbase;   /* Memory mapped window or NULL */
+  uint32_t              blocksize; /* Size of one read/write block */
+  uint32_t              erasesize; /* Size of one erase block */
+  uint32_t              linesize;  /* Size of one line, blocksize multiple */
+  off_t                 size;      /* Device size in bytes */
+  struct list_node      lru;       /* LRU list of the lines */
+  struct mtd_rcache_line_s lines[CONFIG_MTD_RCACHE_NLINES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* MTD driver methods */
+
+static int mtd_rcache_erase(FAR struct mtd_dev_s *dev, off_t block,
+                            size_t nblocks);
+static ssize_t mtd_rcache_bread(FAR struct mtd_dev_s *dev, off_t block,
+                                size_t nblocks, FAR uint8_t *buffer);
+static ssize_t mtd_rcache_bwrite(FAR struct mtd_dev_s *dev, off_t block,
+                                 size_t nblocks,
+                                 FAR const uint8_t *buffer);
+static ssize_t mtd_rcache_read(FAR struct mtd_dev_s *dev, off_t offset,
+                               size_t nbytes, FAR uint8_t *buffer);
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_rcache_write(FAR struct mtd_dev_s *dev, off_t offset,
+                                size_t nbytes, FAR const uint8_t *buffer);
+#endif
+static int mtd_rcache_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                            unsigned long arg);
+static int mtd_rcache_isbad(FAR struct mtd_dev_s *dev, off_t block);
+static int mtd_rcache_markbad(FAR struct mtd_dev_s *dev, off_t block);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_rcache_invalidate
+ *
+ * Description:
+ *   Drop the lines overlapping a range of the device which has just been
+ *   written or erased.
+ *
+ ****************************************************************************/
+
+static void mtd_rcache_invalidate(FAR struct mtd_rcache_s *priv,
+                                  off_t offset, off_t nbytes)
+{
+  int i;
+
+  if (priv->xipbase != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)priv->xipbase + offset,
+                           (uintptr_t)priv->xipbase + offset + nbytes);
+      return;
+    }
+
+  for (i = 0; i < CONFIG_MTD_RCACHE_NLINES; i++)
+    {
+      FAR struct mtd_rcache_line_s *line = &priv->lines[i];
+
+      if (line->offset >= 0 && line->offset < offset + nbytes &&
+          line->offset + priv->linesize > offset)
+        {
+          line->offset = -1;
+          list_delete(&line->node);
+          list_add_tail(&priv->lru, &line->node);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_readdev
+ *
+ * Description:
+ *   Read from the contained device, byte oriented if it supports it.  The
+ *   range must be block aligned otherwise.
+ *
+ ****************************************************************************/
+
+static ssize_t mtd_rcache_readdev(FAR struct mtd_rcache_s *priv,
+                                  off_t offset, size_t nbytes,
+                                  FAR uint8_t *buffer)
+{
+  FAR struct mtd_dev_s *dev = priv->dev;
+  ssize_t ret;
+
+  if (dev->read != NULL)
+    {
+      ret = dev->read(dev, offset, nbytes, buffer);
+      if (ret >= 0 && (size_t)ret != nbytes)
+        {
+          ret = -EIO;
+        }
+    }
+  else
+    {
+      ret = dev->bread(dev, offset / priv->blocksize,
+                       nbytes / priv->blocksize, buffer);
+      if (ret >= 0)
+        {
+          ret = (size_t)ret * priv->blocksize == nbytes ? nbytes : -EIO;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_getline
+ *
+ * Description:
+ *   Return the line starting at offset, loading the least recently used
+ *   line with it on a miss.
+ *
+ ****************************************************************************/
+
+static int mtd_rcache_getline(FAR struct mtd_rcache_s *priv, off_t offset,
+                              FAR struct mtd_rcache_line_s **result)
+{
+  FAR struct mtd_rcache_line_s *line;
+  ssize_t ret;
+
+  list_for_every_entry(&priv->lru, line, struct mtd_rcache_line_s, node)
+    {
+      if (line->offset == offset)
+        {
+          goto out;
+        }
+    }
+
+  line = list_last_entry(&priv->lru, struct mtd_rcache_line_s, node);
+  line->offset = -1;
+
+  ret = mtd_rcache_readdev(priv, offset,
+                           MIN(priv->linesize, priv->size - offset),
+                           line->data);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to load line %jd: %zd\n", (intmax_t)offset, ret);
+      return ret;
+    }
+
+  line->offset = offset;
+
+out:
+  list_delete(&line->node);
+  list_add_head(&priv->lru, &line->node);
+  *result = line;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_readbytes
+ ****************************************************************************/
+
+static ssize_t mtd_rcache_readbytes(FAR struct mtd_rcache_s *priv,
+                                    off_t offset, size_t nbytes,
+                                    FAR uint8_t *buffer)
+{
+  FAR struct mtd_rcache_line_s *line;
+  size_t remaining;
+  off_t lineoff;
+  size_t len;
+  int ret;
+
+  if (offset < 0 || offset >= priv->size)
+    {
+      return offset < 0 ? -EINVAL : 0;
+    }
+
+  nbytes = MIN(nbytes, priv->size - offset);
+  if (priv->xipbase != NULL)
+    {
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      return nbytes;
+    }
+
+  /* Large reads gain nothing from the cache, since it always matches the
+   * device they go directly to the device without evicting the lines.
+   */
+
+  if (nbytes > priv->linesize &&
+      (priv->dev->read != NULL || (offset % priv->blocksize == 0 &&
+                                   nbytes % priv->blocksize == 0)))
+    {
+      return mtd_rcache_readdev(priv, offset, nbytes, buffer);
+    }
+
+  for (remaining = nbytes; remaining > 0; remaining -= len)
+    {
+      lineoff = offset - offset % priv->linesize;
+      ret = mtd_rcache_getline(priv, lineoff, &line);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      len = MIN(remaining, priv->linesize - (offset - lineoff));
+      memcpy(buffer, line->data + (offset - lineoff), len);
+      buffer += len;
+      offset += len;
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_erase
+ ****************************************************************************/
+
+static int mtd_rcache_erase(FAR struct mtd_dev_s *dev, off_t block,
+                            size_t nblocks)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = priv->dev->erase(priv->dev, block, nblocks);
+  mtd_rcache_invalidate(priv, (off_t)block * priv->erasesize,
+                        (off_t)nblocks * priv->erasesize);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_bread
+ ****************************************************************************/
+
+static ssize_t mtd_rcache_bread(FAR struct mtd_dev_s *dev, off_t block,
+                                size_t nblocks, FAR uint8_t *buffer)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = mtd_rcache_readbytes(priv, (off_t)block * priv->blocksize,
+                             nblocks * priv->blocksize, buffer);
+  nxmutex_unlock(&priv->lock);
+  return ret < 0 ? ret : ret / priv->blocksize;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_bwrite
+ ****************************************************************************/
+
+static ssize_t mtd_rcache_bwrite(FAR struct mtd_dev_s *dev, off_t block,
+                                 size_t nblocks,
+                                 FAR const uint8_t *buffer)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = priv->dev->bwrite(priv->dev, block, nblocks, buffer);
+  mtd_rcache_invalidate(priv, (off_t)block * priv->blocksize,
+                        (off_t)nblocks * priv->blocksize);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_read
+ ****************************************************************************/
+
+static ssize_t mtd_rcache_read(FAR struct mtd_dev_s *dev, off_t offset,
+                               size_t nbytes, FAR uint8_t *buffer)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = mtd_rcache_readbytes(priv, offset, nbytes, buffer);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_write
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_rcache_write(FAR struct mtd_dev_s *dev, off_t offset,
+                                size_t nbytes, FAR const uint8_t *buffer)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = priv->dev->write(priv->dev, offset, nbytes, buffer);
+  mtd_rcache_invalidate(priv, offset, nbytes);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mtd_rcache_ioctl
+ ****************************************************************************/
+
+static int mtd_rcache_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                            unsigned long arg)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+  int ret;
+
+  finfo("cmd: %d\n", cmd);
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = priv->dev->ioctl(priv->dev, cmd, arg);
+
+  /* Anything but a query may have changed the contents of the device
+   * (MTDIOC_BULKERASE, MTDIOC_ERASESECTORS, ...).
+   */
+
+  switch (cmd)
+    {
+      case MTDIOC_GEOMETRY:
+      case BIOC_PARTINFO:
+      case BIOC_XIPBASE:
+        break;
+
+      default:
+        mtd_rcache_invalidate(priv, 0, priv->size);
+        break;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_isbad
+ ****************************************************************************/
+
+static int mtd_rcache_isbad(FAR struct mtd_dev_s *dev, off_t block)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+
+  return MTD_ISBAD(priv->dev, block);
+}
+
+/****************************************************************************
+ * Name: mtd_rcache_markbad
+ ****************************************************************************/
+
+static int mtd_rcache_markbad(FAR struct mtd_dev_s *dev, off_t block)
+{
+  FAR struct mtd_rcache_s *priv = (FAR struct mtd_rcache_s *)dev;
+
+  return MTD_MARKBAD(priv->dev, block);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_rcache_initialize
+ *
+ * Description:
+ *   Create an MTD device instance caching the reads of another MTD device.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_dev_s *mtd_rcache_initialize(FAR struct mtd_dev_s *mtd)
+{
+  FAR struct mtd_rcache_s *priv;
+  struct mtd_geometry_s geo;
+  FAR uint8_t *data;
+  FAR void *xipbase = NULL;
+  uint32_t linesize;
+  int ret;
+  int i;
+
+  finfo("mtd: %p\n", mtd);
+  DEBUGASSERT(mtd && mtd->ioctl);
+
+  /* Get the device geometry */
+
+  ret = mtd->ioctl(mtd, MTDIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTDIOC_GEOMETRY ioctl failed: %d\n", ret);
+      return NULL;
+    }
+
+  /* Use the memory mapped window of the device if there is one, the lines
+   * are not needed then.
+   */
+
+  ret = mtd->ioctl(mtd, BIOC_XIPBASE, (unsigned long)((uintptr_t)&xipbase));
+  if (ret < 0)
+    {
+      xipbase = NULL;
+    }
+
+  linesize = xipbase != NULL ? 0 :
+             ALIGN_UP(CONFIG_MTD_RCACHE_LINESIZE, geo.blocksize);
+
+  priv = kmm_zalloc(sizeof(struct mtd_rcache_s) +
+                    linesize * CONFIG_MTD_RCACHE_NLINES);
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate mtd_rcache\n");
+      return NULL;
+    }
+
+  /* Initialize the allocated structure. (unsupported methods/fields
+   * were already nullified by kmm_zalloc).
+   */
+
+  priv->mtd.erase    = mtd_rcache_erase;
+  priv->mtd.bread    = mtd_rcache_bread;
+  priv->mtd.bwrite   = mtd_rcache_bwrite;
+  priv->mtd.read     = mtd_rcache_read;
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (mtd->write != NULL)
+    {
+      priv->mtd.write = mtd_rcache_write;
+    }
+#endif
+
+  priv->mtd.ioctl    = mtd_rcache_ioctl;
+  priv->mtd.isbad    = mtd_rcache_isbad;
+  priv->mtd.markbad  = mtd_rcache_markbad;
+  priv->mtd.name     = "rcache";
+
+  priv->dev          = mtd;
+  priv->xipbase      = xipbase;
+  priv->blocksize    = geo.blocksize;
+  priv->erasesize    = geo.erasesize;
+  priv->linesize     = linesize;
+  priv->size         = (off_t)geo.erasesize * geo.neraseblocks;
+
+  nxmutex_init(&priv->lock);
+
+  /* All lines start empty at the cold end of the LRU list */
+
+  list_initialize(&priv->lru);
+  data = (FAR uint8_t *)(priv + 1);
+  for (i = 0; i < CONFIG_MTD_RCACHE_NLINES; i++)
+    {
+      priv->lines[i].offset = -1;
+      priv->lines[i].data   = data + i * linesize;
+      list_add_tail(&priv->lru, &priv->lines[i].node);
+    }
+
+  return &priv->mtd;
+}
+
+#endif /* CONFIG_MTD_RCACHE */
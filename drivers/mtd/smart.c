@@ -41,10 +41,13 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/crc8.h>
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -144,6 +147,15 @@
 #define SMART_WEARFLAGS_FORCE_REORG         0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED        0x02
 
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define SMART_BGGC_DELAY      MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY)
+#  define smart_lock(d)         nxmutex_lock(&(d)->lock)
+#  define smart_unlock(d)       nxmutex_unlock(&(d)->lock)
+#else
+#  define smart_lock(d)         OK
+#  define smart_unlock(d)
+#endif
+
 #define SET_BITMAP(m, n) do { (m)[(n) / 8] |= 1 << ((n) % 8); } while (0)
 #define CLR_BITMAP(m, n) do { (m)[(n) / 8] &= ~(1 << ((n) % 8)); } while (0)
 #define ISSET_BITMAP(m, n) ((m)[(n) / 8] & (1 << ((n) % 8)))
@@ -299,6 +311,10 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  mutex_t               lock;             /* Serializes the device accesses */
+  struct work_s         gcwork;           /* Background collection work */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -448,6 +464,10 @@ static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
 static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
                                      uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+static void    smart_bggc_worker(FAR void *arg);
+#endif
+
 #ifdef CONFIG_MTD_SMART_FSCK
 static int     smart_fsck(FAR struct smart_struct_s *dev);
 #endif
@@ -902,6 +922,7 @@ static ssize_t smart_read(FAR struct inode *inode, FAR unsigned char *buffer,
                           blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %" PRIuOFF " nsectors: %u\n",
         start_sector, nsectors);
@@ -912,7 +933,16 @@ static ssize_t smart_read(FAR struct inode *inode, FAR unsigned char *buffer,
 #else
   dev = inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -949,7 +979,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -991,8 +1025,7 @@ static ssize_t smart_write(FAR struct inode *inode,
               ferr("ERROR: Erase block=%" PRIdOFF " failed: %d\n",
                    eraseblock, ret);
 
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -1022,8 +1055,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           ferr("ERROR: Write block %" PRIdOFF " failed: %zd.\n",
                nextblock, nxfrd);
 
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -1035,6 +1067,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdblkspererase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 
@@ -4014,6 +4047,67 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_findcollectblock
+ *
+ * Description:  Find the erase block with the most released sectors, at
+ *               least minrelease.  Blocks worn completely are skipped and
+ *               of equally dirty blocks the least worn one is chosen.
+ *
+ * Returned Value:  The block number or 0xffff if no block qualifies.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_findcollectblock(FAR struct smart_struct_s *dev,
+                                       uint8_t minrelease)
+{
+  uint16_t collectblock = 0xffff;
+  uint8_t releasemax = minrelease - 1;
+  uint8_t count;
+  int x;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  uint8_t collectlevel = 0;
+  uint8_t level;
+#endif
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      level = smart_get_wear_level(dev, x);
+      if (level >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+#else
+      count = dev->releasecount[x];
+#endif
+      if (count > releasemax)
+        {
+          releasemax   = count;
+          collectblock = x;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          collectlevel = level;
+#endif
+        }
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      else if (count == releasemax && collectblock != 0xffff &&
+               level < collectlevel)
+        {
+          collectblock = x;
+          collectlevel = level;
+        }
+#endif
+    }
+
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -4026,13 +4120,8 @@ retry:
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
   uint16_t collectblock;
-  uint16_t releasemax;
   bool collect = true;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
@@ -4061,39 +4150,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-#endif
-
+          collectblock = smart_findcollectblock(dev, 1);
           if (collectblock == 0xffff)
             {
               /* Need to collect, but no sectors with released blocks! */
@@ -4267,6 +4324,110 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Test if the free sectors are below the background
+ *               collection watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  return dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+         dev->releasesectors > 0 &&
+         (uint32_t)dev->freesectors * 100 <
+         (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_BGGC_WATERMARK;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  (Re)start the idle timer of the background collection if
+ *               the free sectors are below the watermark.  Every call
+ *               pushes the collection back so that it runs when the device
+ *               has been idle for CONFIG_MTD_SMART_BGGC_DELAY.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (smart_bggc_needed(dev))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_DELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Compact up to CONFIG_MTD_SMART_BGGC_NBLOCKS of the
+ *               dirtiest erase blocks.  Only blocks with at least a quarter
+ *               of their sectors released are worth the erase here, the
+ *               rest is left to the foreground collection.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = arg;
+  uint16_t collectblock;
+  uint8_t minrelease;
+  int nblocks;
+
+  if (smart_lock(dev) < 0)
+    {
+      return;
+    }
+
+  minrelease = dev->availsectperblk >> 2;
+  if (minrelease == 0)
+    {
+      minrelease = 1;
+    }
+
+  for (nblocks = 0; nblocks < CONFIG_MTD_SMART_BGGC_NBLOCKS &&
+                    smart_bggc_needed(dev); nblocks++)
+    {
+      collectblock = smart_findcollectblock(dev, minrelease);
+      if (collectblock == 0xffff)
+        {
+          break;
+        }
+
+      finfo("Background collecting block %d, free=%d released=%d\n",
+            collectblock, dev->freesectors, dev->releasesectors);
+
+      if (smart_relocate_block(dev, collectblock) != OK)
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  /* The run was cut short by the erase budget, continue after another
+   * idle period.
+   */
+
+  if (nblocks == CONFIG_MTD_SMART_BGGC_NBLOCKS)
+    {
+      smart_bggc_schedule(dev);
+    }
+
+  smart_unlock(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_read_wearstatus
  *
@@ -5502,6 +5663,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = inode->i_private;
 #endif
 
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5641,6 +5808,15 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGGC
+  if (cmd == BIOC_ALLOCSECT || cmd == BIOC_FREESECT ||
+      cmd == BIOC_WRITESECT)
+    {
+      smart_bggc_schedule(dev);
+    }
+#endif
+
+  smart_unlock(dev);
   return ret;
 }
 
@@ -6183,6 +6359,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6332,6 +6511,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -6461,11 +6643,18 @@ static int smart_loteardown(FAR const char *devname)
 
   close_blockdriver(inode);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  work_cancel_sync(LPWORK, &dev->gcwork);
+#endif
+
   /* Now teardown the filemtd */
 
   filemtd_teardown(dev->mtd);
   unregister_blockdriver(devname);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
   kmm_free(dev);
 
   return OK;
@@ -66,6 +66,18 @@
 #define IGC_TX_DESC            CONFIG_NET_IGC_TXDESC
 #define IGC_RX_DESC            CONFIG_NET_IGC_RXDESC
 
+/* RX/TX queue pairs, each with the number of descriptors above */
+
+#ifdef CONFIG_NET_IGC_NQUEUES
+#  define IGC_NQUEUES          CONFIG_NET_IGC_NQUEUES
+#else
+#  define IGC_NQUEUES          1
+#endif
+
+#if IGC_NQUEUES > 1 && IGC_NQUEUES > CONFIG_NETDEV_MAX_QUEUES
+#  error CONFIG_NET_IGC_NQUEUES must be <= CONFIG_NETDEV_MAX_QUEUES
+#endif
+
 /* After RX packet is done, we provide free netpkt to the RX descriptor ring.
  * The upper-half network logic is responsible for freeing the RX packets
  * so we need some additional spare netpkt buffers to assure that it's
@@ -73,8 +85,9 @@
  * It's hard to tell how many spare buffers is needed, for now it's set to 8.
  */
 
-#define IGC_TX_QUOTA           IGC_TX_DESC
-#define IGC_RX_QUOTA           (IGC_RX_DESC + CONFIG_NET_IGC_RXSPARE)
+#define IGC_TX_QUOTA           (IGC_TX_DESC * IGC_NQUEUES)
+#define IGC_RX_QUOTA           (IGC_RX_DESC * IGC_NQUEUES + \
+                                CONFIG_NET_IGC_RXSPARE)
 
 /* NOTE: CONFIG_IOB_ALIGNMENT must match system D-CACHE line size */
 
@@ -104,6 +117,34 @@
 #define IGC_MSIX_IVAR0         (IGC_IVAR0_RXQ0_VAL | IGC_IVAR0_TXQ0_VAL)
 #define IGC_MSIX_IVARMSC       (IGC_IVARMSC_OTHER_VAL)
 
+/* With more than one queue, MSI-X vector n serves RX/TX queue pair n and
+ * the vector behind the queues the other causes.
+ */
+
+#if IGC_NQUEUES > 1
+#  define IGC_NVECTORS         (IGC_NQUEUES + 1)
+#  define IGC_OTHER_VECTOR     IGC_NQUEUES
+#  define IGC_GPIE_MSIX_MULTI  (IGC_GPIE_NSICR | IGC_GPIE_MSIX | \
+                                IGC_GPIE_PBASUPPORT)
+#  define IGC_MSIX_MULTI_IMS   (IGC_IC_LSC | IGC_IC_RXMISS)
+#  define IGC_MSIX_MULTI_QUEUE ((1 << IGC_NQUEUES) - 1)
+#  define IGC_MSIX_MULTI_EIMS  (IGC_MSIX_MULTI_QUEUE | \
+                                (1 << IGC_OTHER_VECTOR))
+#  define IGC_MRQC_VAL         (IGC_MRQC_RSS | IGC_MRQC_RSS_IPV4 | \
+                                IGC_MRQC_RSS_IPV4_TCP | \
+                                IGC_MRQC_RSS_IPV4_UDP | \
+                                IGC_MRQC_RSS_IPV6 | \
+                                IGC_MRQC_RSS_IPV6_TCP | \
+                                IGC_MRQC_RSS_IPV6_UDP)
+#  define IGC_INT_IMS          IGC_MSIX_MULTI_IMS
+#  define IGC_INT_EIMS         IGC_MSIX_MULTI_EIMS
+#else
+#  define IGC_NVECTORS         1
+#  define IGC_OTHER_VECTOR     0
+#  define IGC_INT_IMS          IGC_MSIX_IMS
+#  define IGC_INT_EIMS         IGC_MSIX_EIMS
+#endif
+
 /*****************************************************************************
  * Private Types
  *****************************************************************************/
@@ -116,18 +157,13 @@ struct igc_type_s
   uint32_t mta_regs;            /* MTA registers */
 };
 
-/* IGC private data */
+/* IGC RX/TX queue pair */
 
-struct igc_driver_s
+struct igc_driver_s;
+struct igc_queue_s
 {
-  /* This holds the information visible to the NuttX network */
-
-  struct netdev_lowerhalf_s dev;
-  struct work_s work;
-
-  /* Driver state */
-
-  bool bifup;
+  FAR struct igc_driver_s *priv;
+  int                      qid;
 
   /* Packets list */
 
@@ -142,12 +178,30 @@ struct igc_driver_s
   size_t tx_now;
   size_t tx_done;
   size_t rx_now;
+};
+
+/* IGC private data */
+
+struct igc_driver_s
+{
+  /* This holds the information visible to the NuttX network */
+
+  struct netdev_lowerhalf_s dev;
+  struct work_s work;
+
+  /* Driver state */
+
+  bool bifup;
+
+  /* RX/TX queues */
+
+  struct igc_queue_s queue[IGC_NQUEUES];
 
   /* PCI data */
 
   FAR struct pci_device_s     *pcidev;
   FAR const struct igc_type_s *type;
-  int                          irq;
+  int                          irq[IGC_NVECTORS];
   uint64_t                     base;
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -181,16 +235,25 @@ static void igc_rxclean(FAR struct igc_driver_s *priv);
 
 /* Common TX logic */
 
+static int igc_transmitq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                         FAR netpkt_t *pkt);
 static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
                         FAR netpkt_t *pkt);
 
 /* Interrupt handling */
 
+static FAR netpkt_t *igc_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid);
 static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev);
+static void igc_txqdone(FAR struct igc_queue_s *q);
 static void igc_txdone(FAR struct netdev_lowerhalf_s *dev);
+static void igc_rxready(FAR struct igc_driver_s *priv);
 
 static void igc_msix_interrupt(FAR struct igc_driver_s *priv);
 static int igc_interrupt(int irq, FAR void *context, FAR void *arg);
+#if IGC_NQUEUES > 1
+static int igc_queue_interrupt(int irq, FAR void *context, FAR void *arg);
+#endif
 
 /* NuttX callback functions */
 
@@ -252,15 +315,29 @@ static struct pci_driver_s g_pci_igc_drv =
 
 static const struct netdev_ops_s g_igc_ops =
 {
-  .ifup     = igc_ifup,
-  .ifdown   = igc_ifdown,
-  .transmit = igc_transmit,
-  .receive  = igc_receive,
+  .ifup      = igc_ifup,
+  .ifdown    = igc_ifdown,
+  .transmit  = igc_transmit,
+  .receive   = igc_receive,
 #ifdef CONFIG_NET_MCASTGROUP
-  .addmac   = igc_addmac,
-  .rmmac    = igc_rmmac,
+  .addmac    = igc_addmac,
+  .rmmac     = igc_rmmac,
 #endif
+#if IGC_NQUEUES > 1
+  .transmitq = igc_transmitq,
+  .receiveq  = igc_receiveq,
+#endif
+};
+
+/* The RSS key, the one of the Microsoft RSS verification suite */
+
+#if IGC_NQUEUES > 1
+static const uint32_t g_igc_rsskey[IGC_RSSRK_REGS] =
+{
+  0xda565a6d, 0xc20e5b25, 0x3d256741, 0xb08fa343, 0xcb2bcad0,
+  0xb4307bae, 0xa32dcb77, 0x0cf23080, 0x3bb7426a, 0xfa01acbe
 };
+#endif
 
 /*****************************************************************************
  * Private Functions
@@ -447,27 +524,34 @@ static void igc_dump_mem(FAR struct igc_driver_s *priv, FAR const char *msg)
 static void igc_txclean(FAR struct igc_driver_s *priv)
 {
   FAR struct netdev_lowerhalf_s *netdev = &priv->dev;
+  FAR struct igc_queue_s        *q;
+  int                            i;
 
-  /* Reset ring */
+  for (i = 0; i < IGC_NQUEUES; i++)
+    {
+      q = &priv->queue[i];
 
-  igc_putreg_mem(priv, IGC_TDH0, 0);
-  igc_putreg_mem(priv, IGC_TDT0, 0);
+      /* Reset ring */
 
-  /* Free any pending TX */
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TDH0, i), 0);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TDT0, i), 0);
 
-  while (priv->tx_now != priv->tx_done)
-    {
-      /* Free net packet */
+      /* Free any pending TX */
 
-      netpkt_free(netdev, priv->tx_pkt[priv->tx_done], NETPKT_TX);
+      while (q->tx_now != q->tx_done)
+        {
+          /* Free net packet */
 
-      /* Next descriptor */
+          netpkt_free(netdev, q->tx_pkt[q->tx_done], NETPKT_TX);
 
-      priv->tx_done = (priv->tx_done + 1) % IGC_TX_DESC;
-    }
+          /* Next descriptor */
+
+          q->tx_done = (q->tx_done + 1) % IGC_TX_DESC;
+        }
 
-  priv->tx_now  = 0;
-  priv->tx_done = 0;
+      q->tx_now  = 0;
+      q->tx_done = 0;
+    }
 }
 
 /*****************************************************************************
@@ -486,36 +570,44 @@ static void igc_txclean(FAR struct igc_driver_s *priv)
 
 static void igc_rxclean(FAR struct igc_driver_s *priv)
 {
-  priv->rx_now = 0;
+  int i;
+
+  for (i = 0; i < IGC_NQUEUES; i++)
+    {
+      priv->queue[i].rx_now = 0;
 
-  igc_putreg_mem(priv, IGC_RDH0, 0);
-  igc_putreg_mem(priv, IGC_RDT0, 0);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDH0, i), 0);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDT0, i), 0);
+    }
 }
 
 /*****************************************************************************
- * Name: igc_transmit
+ * Name: igc_transmitq
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
+ *   Start hardware transmission on a TX queue.  Called either from the
+ *   txdone interrupt handling or from watchdog based polling.
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   dev - Reference to the lower half driver structure
+ *   qid - The index of the TX queue
+ *   pkt - The packet to send
  *
  * Returned Value:
- *   None
+ *   OK on success; a negated errno value on failure.
  *
  * Assumptions:
  *   The network is locked.
  *
  *****************************************************************************/
 
-static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
-                          FAR netpkt_t *pkt)
+static int igc_transmitq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                         FAR netpkt_t *pkt)
 {
   FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+  FAR struct igc_queue_s  *q    = &priv->queue[qid];
   uint64_t                 pa   = 0;
-  int                      desc = priv->tx_now;
+  int                      desc = q->tx_now;
   size_t                   len  = netpkt_getdatalen(dev, pkt);
 
   ninfo("transmit\n");
@@ -535,28 +627,28 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
 
   /* Store TX packet reference */
 
-  priv->tx_pkt[priv->tx_now] = pkt;
+  q->tx_pkt[q->tx_now] = pkt;
 
   /* Prepare next TX descriptor */
 
-  priv->tx_now = (priv->tx_now + 1) % IGC_TX_DESC;
+  q->tx_now = (q->tx_now + 1) % IGC_TX_DESC;
 
   /* Setup TX descriptor */
 
   pa = up_addrenv_va_to_pa(netpkt_getdata(dev, pkt));
 
-  priv->tx[desc].addr   = pa;
-  priv->tx[desc].len    = len;
-  priv->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
-                           IGC_TDESC_CMD_RS);
-  priv->tx[desc].cso    = 0;
-  priv->tx[desc].status = 0;
+  q->tx[desc].addr   = pa;
+  q->tx[desc].len    = len;
+  q->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
+                        IGC_TDESC_CMD_RS);
+  q->tx[desc].cso    = 0;
+  q->tx[desc].status = 0;
 
   UP_DSB();
 
   /* Update TX tail */
 
-  igc_putreg_mem(priv, IGC_TDT0, priv->tx_now);
+  igc_putreg_mem(priv, IGC_QUEUE(IGC_TDT0, qid), q->tx_now);
 
   ninfodumpbuffer("Transmitted:", netpkt_getdata(dev, pkt), len);
 
@@ -564,35 +656,50 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
 }
 
 /*****************************************************************************
- * Name: igc_receive
+ * Name: igc_transmit
+ *
+ * Description:
+ *   Start hardware transmission on the first TX queue.
+ *
+ *****************************************************************************/
+
+static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt)
+{
+  return igc_transmitq(dev, 0, pkt);
+}
+
+/*****************************************************************************
+ * Name: igc_receiveq
  *
  * Description:
  *   An interrupt was received indicating the availability of a new RX packet
+ *   on an RX queue
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   dev - Reference to the lower half driver structure
+ *   qid - The index of the RX queue
  *
  * Returned Value:
- *   None
- *
- * Assumptions:
- *   The network is locked.
+ *   The received packet, or NULL if there is none.
  *
  *****************************************************************************/
 
-static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
+static FAR netpkt_t *igc_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid)
 {
   FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+  FAR struct igc_queue_s  *q    = &priv->queue[qid];
   FAR netpkt_t            *pkt  = NULL;
   FAR struct igc_rx_leg_s *rx   = NULL;
   int                      desc = 0;
 
-  desc = priv->rx_now;
+  desc = q->rx_now;
 
   /* Get RX descriptor and RX packet */
 
-  rx = &priv->rx[desc];
-  pkt = priv->rx_pkt[desc];
+  rx = &q->rx[desc];
+  pkt = q->rx_pkt[desc];
 
   /* Check if descriptor done */
 
@@ -603,12 +710,12 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
 
   /* Next descriptor */
 
-  priv->rx_now = (priv->rx_now + 1) % IGC_RX_DESC;
+  q->rx_now = (q->rx_now + 1) % IGC_RX_DESC;
 
   /* Allocate new rx packet */
 
-  priv->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
-  if (priv->rx_pkt[desc] == NULL)
+  q->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
+  if (q->rx_pkt[desc] == NULL)
     {
       nerr("alloc pkt_new failed\n");
       PANIC();
@@ -621,13 +728,13 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
-               netpkt_getdata(dev, priv->rx_pkt[desc]));
+               netpkt_getdata(dev, q->rx_pkt[desc]));
   rx->len    = 0;
   rx->status = 0;
 
   /* Update RX tail */
 
-  igc_putreg_mem(priv, IGC_RDT0, desc);
+  igc_putreg_mem(priv, IGC_QUEUE(IGC_RDT0, qid), desc);
 
   /* Handle errors */
 
@@ -643,51 +750,114 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /*****************************************************************************
- * Name: igc_txdone
+ * Name: igc_receive
  *
  * Description:
- *   An interrupt was received indicating that the last TX packet(s) is done
+ *   Receive a packet from the first RX queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ *****************************************************************************/
+
+static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  return igc_receiveq(dev, 0);
+}
+
+/*****************************************************************************
+ * Name: igc_txqdone
+ *
+ * Description:
+ *   Free the packets of a TX queue that are sent
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   q - Reference to the TX queue
  *
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   The network is locked.
- *
  *****************************************************************************/
 
-static void igc_txdone(FAR struct netdev_lowerhalf_s *dev)
+static void igc_txqdone(FAR struct igc_queue_s *q)
 {
-  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+  FAR struct netdev_lowerhalf_s *dev = &q->priv->dev;
 
-  while (priv->tx_now != priv->tx_done)
+  while (q->tx_now != q->tx_done)
     {
-      if (priv->tx[priv->tx_done].status == 0)
+      if (q->tx[q->tx_done].status == 0)
         {
           break;
         }
 
-      if (!(priv->tx[priv->tx_done].status & IGC_TDESC_STATUS_DD))
+      if (!(q->tx[q->tx_done].status & IGC_TDESC_STATUS_DD))
         {
-          nerr("tx failed: 0x%" PRIx32 "\n", priv->tx[priv->tx_done].status);
-          NETDEV_TXERRORS(priv->dev);
+          nerr("tx failed: 0x%" PRIx32 "\n", q->tx[q->tx_done].status);
+          NETDEV_TXERRORS(&dev->netdev);
         }
 
       /* Free net packet */
 
-      netpkt_free(dev, priv->tx_pkt[priv->tx_done], NETPKT_TX);
+      netpkt_free(dev, q->tx_pkt[q->tx_done], NETPKT_TX);
 
       /* Next descriptor */
 
-      priv->tx_done = (priv->tx_done + 1) % IGC_TX_DESC;
+      q->tx_done = (q->tx_done + 1) % IGC_TX_DESC;
+    }
+}
+
+/*****************************************************************************
+ * Name: igc_txdone
+ *
+ * Description:
+ *   An interrupt was received indicating that the last TX packet(s) is done
+ *
+ * Input Parameters:
+ *   dev - Reference to the lower half driver structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ *****************************************************************************/
+
+static void igc_txdone(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+  int                      i;
+
+  for (i = 0; i < IGC_NQUEUES; i++)
+    {
+      igc_txqdone(&priv->queue[i]);
     }
 
   netdev_lower_txdone(dev);
 }
 
+/*****************************************************************************
+ * Name: igc_rxready
+ *
+ * Description:
+ *   Notify the network of received packets on any RX queue
+ *
+ *****************************************************************************/
+
+static void igc_rxready(FAR struct igc_driver_s *priv)
+{
+#if IGC_NQUEUES > 1
+  int i;
+
+  for (i = 0; i < IGC_NQUEUES; i++)
+    {
+      netdev_lower_queue_rxready(&priv->dev, i);
+    }
+#else
+  netdev_lower_rxready(&priv->dev);
+#endif
+}
+
 /*****************************************************************************
  * Name: igc_link_work
  *
@@ -754,6 +924,9 @@ static void igc_msix_interrupt(FAR struct igc_driver_s *priv)
 
   ninfo("eicr = 0x%" PRIx32 " icr = 0x%" PRIx32 "\n", eicr, icr);
 
+  /* The queues have their own vectors if there are several of them */
+
+  icr &= IGC_INT_IMS;
   if (icr == 0)
     {
       /* Ignore spurious interrupts */
@@ -765,7 +938,7 @@ static void igc_msix_interrupt(FAR struct igc_driver_s *priv)
 
   if (icr & IGC_IC_RXDW)
     {
-      netdev_lower_rxready(&priv->dev);
+      igc_rxready(priv);
     }
 
   /* Link Status Change */
@@ -787,7 +960,7 @@ static void igc_msix_interrupt(FAR struct igc_driver_s *priv)
   if (icr & IGC_IC_RXMISS)
     {
       nerr("Receiver Miss\n");
-      netdev_lower_rxready(&priv->dev);
+      igc_rxready(priv);
     }
 
   /* Transmit Descriptor Written Back */
@@ -832,6 +1005,41 @@ static int igc_interrupt(int irq, FAR void *context, FAR void *arg)
   return OK;
 }
 
+#if IGC_NQUEUES > 1
+/*****************************************************************************
+ * Name: igc_queue_interrupt
+ *
+ * Description:
+ *   Hardware interrupt handler of the MSI-X vector of a RX/TX queue pair
+ *
+ * Input Parameters:
+ *   irq     - Number of the IRQ that generated the interrupt
+ *   context - Interrupt register state save info (architecture-specific)
+ *   arg     - Reference to the queue pair
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ *****************************************************************************/
+
+static int igc_queue_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct igc_queue_s *q = arg;
+
+  DEBUGASSERT(q != NULL);
+
+  /* The vector is cleared automatically (EIAC), the RX queue is drained
+   * by the work of the queue.
+   */
+
+  netdev_lower_queue_rxready(&q->priv->dev, q->qid);
+  igc_txqdone(q);
+  netdev_lower_txdone(&q->priv->dev);
+
+  return OK;
+}
+#endif
+
 /*****************************************************************************
  * Name: igc_ifup
  *
@@ -1047,6 +1255,7 @@ static int igc_rmmac(FAR struct netdev_lowerhalf_s *dev,
 static void igc_disable(FAR struct igc_driver_s *priv)
 {
   int i = 0;
+  int q = 0;
 
   /* Reset Tx tail */
 
@@ -1058,9 +1267,12 @@ static void igc_disable(FAR struct igc_driver_s *priv)
 
   /* Disable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMC, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMC, IGC_MSIX_IMS);
-  up_disable_irq(priv->irq);
+  igc_putreg_mem(priv, IGC_EIMC, IGC_INT_EIMS);
+  igc_putreg_mem(priv, IGC_IMC, IGC_INT_IMS);
+  for (i = 0; i < IGC_NVECTORS; i++)
+    {
+      up_disable_irq(priv->irq[i]);
+    }
 
   /* Disable Transmitter */
 
@@ -1072,9 +1284,12 @@ static void igc_disable(FAR struct igc_driver_s *priv)
 
   /* Free RX packets */
 
-  for (i = 0; i < IGC_RX_DESC; i += 1)
+  for (q = 0; q < IGC_NQUEUES; q++)
     {
-      netpkt_free(&priv->dev, priv->rx_pkt[i], NETPKT_RX);
+      for (i = 0; i < IGC_RX_DESC; i += 1)
+        {
+          netpkt_free(&priv->dev, priv->queue[q].rx_pkt[i], NETPKT_RX);
+        }
     }
 }
 
@@ -1111,6 +1326,7 @@ static void igc_enable(FAR struct igc_driver_s *priv)
   uint64_t pa     = 0;
   uint32_t regval = 0;
   int      i      = 0;
+  int      q      = 0;
 
   /* Reset PHY */
 
@@ -1123,62 +1339,92 @@ static void igc_enable(FAR struct igc_driver_s *priv)
       igc_putreg_mem(priv, IGC_MTA + (i << 2), 0);
     }
 
-  /* Allocate RX packets */
-
-  for (i = 0; i < IGC_RX_DESC; i += 1)
+  for (q = 0; q < IGC_NQUEUES; q++)
     {
-      priv->rx_pkt[i] = netpkt_alloc(dev, NETPKT_RX);
-      if (priv->rx_pkt[i] == NULL)
+      FAR struct igc_queue_s *queue = &priv->queue[q];
+
+      /* Allocate RX packets */
+
+      for (i = 0; i < IGC_RX_DESC; i += 1)
         {
-          nerr("alloc rx_pkt failed\n");
-          PANIC();
+          queue->rx_pkt[i] = netpkt_alloc(dev, NETPKT_RX);
+          if (queue->rx_pkt[i] == NULL)
+            {
+              nerr("alloc rx_pkt failed\n");
+              PANIC();
+            }
+
+          /* Configure RX descriptor */
+
+          queue->rx[i].addr   = up_addrenv_va_to_pa(
+                                netpkt_getdata(dev, queue->rx_pkt[i]));
+          queue->rx[i].len    = 0;
+          queue->rx[i].status = 0;
         }
 
-      /* Configure RX descriptor */
+      /* Setup TX descriptor */
 
-      priv->rx[i].addr   = up_addrenv_va_to_pa(
-                           netpkt_getdata(dev, priv->rx_pkt[i]));
-      priv->rx[i].len    = 0;
-      priv->rx[i].status = 0;
-    }
+      /* The address passed to the NIC must be physical */
 
-  /* Setup TX descriptor */
+      pa = up_addrenv_va_to_pa(queue->tx);
+
+      regval = (uint32_t)pa;
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TDBAL0, q), regval);
+      regval = (uint32_t)(pa >> 32);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TDBAH0, q), regval);
+
+      regval = IGC_TX_DESC * sizeof(struct igc_tx_leg_s);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TDLEN0, q), regval);
 
-  /* The address passed to the NIC must be physical */
+      /* Setup RX descriptor */
 
-  pa = up_addrenv_va_to_pa(priv->tx);
+      /* The address passed to the NIC must be physical */
 
-  regval = (uint32_t)pa;
-  igc_putreg_mem(priv, IGC_TDBAL0, regval);
-  regval = (uint32_t)(pa >> 32);
-  igc_putreg_mem(priv, IGC_TDBAH0, regval);
+      pa = up_addrenv_va_to_pa(queue->rx);
 
-  regval = IGC_TX_DESC * sizeof(struct igc_tx_leg_s);
-  igc_putreg_mem(priv, IGC_TDLEN0, regval);
+      regval = (uint32_t)pa;
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDBAL0, q), regval);
+      regval = (uint32_t)(pa >> 32);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDBAH0, q), regval);
+
+      regval = IGC_RX_DESC * sizeof(struct igc_rx_leg_s);
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDLEN0, q), regval);
+    }
 
   /* Reset TX tail */
 
   igc_txclean(priv);
 
-  /* Setup RX descriptor */
+#if IGC_NQUEUES > 1
+  /* Spread the flows over the RX queues with RSS */
 
-  /* The address passed to the NIC must be physical */
+  for (i = 0; i < IGC_RSSRK_REGS; i++)
+    {
+      igc_putreg_mem(priv, IGC_RSSRK + (i << 2), g_igc_rsskey[i]);
+    }
 
-  pa = up_addrenv_va_to_pa(priv->rx);
+  for (i = 0; i < IGC_RETA_ENTRIES / 4; i++)
+    {
+      regval = 0;
+      for (q = 0; q < 4; q++)
+        {
+          regval |= ((i * 4 + q) % IGC_NQUEUES) << (q << 3);
+        }
 
-  regval = (uint32_t)pa;
-  igc_putreg_mem(priv, IGC_RDBAL0, regval);
-  regval = (uint32_t)(pa >> 32);
-  igc_putreg_mem(priv, IGC_RDBAH0, regval);
+      igc_putreg_mem(priv, IGC_RETA + (i << 2), regval);
+    }
 
-  regval = IGC_RX_DESC * sizeof(struct igc_rx_leg_s);
-  igc_putreg_mem(priv, IGC_RDLEN0, regval);
+  igc_putreg_mem(priv, IGC_MRQC, IGC_MRQC_VAL);
+#endif
 
   /* Enable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
-  up_enable_irq(priv->irq);
+  igc_putreg_mem(priv, IGC_EIMS, IGC_INT_EIMS);
+  igc_putreg_mem(priv, IGC_IMS, IGC_INT_IMS);
+  for (i = 0; i < IGC_NVECTORS; i++)
+    {
+      up_enable_irq(priv->irq[i]);
+    }
 
   /* Set link up */
 
@@ -1199,17 +1445,20 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 #endif
   igc_putreg_mem(priv, IGC_RCTL, regval);
 
-  /* Enable TX queeu */
+  for (q = 0; q < IGC_NQUEUES; q++)
+    {
+      /* Enable TX queeu */
 
-  regval = igc_getreg_mem(priv, IGC_TXDCTL0);
-  regval |= IGC_TXDCTL_ENABLE;
-  igc_putreg_mem(priv, IGC_TXDCTL0, regval);
+      regval = igc_getreg_mem(priv, IGC_QUEUE(IGC_TXDCTL0, q));
+      regval |= IGC_TXDCTL_ENABLE;
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_TXDCTL0, q), regval);
 
-  /* Enable RX queue */
+      /* Enable RX queue */
 
-  regval = igc_getreg_mem(priv, IGC_RXDCTL0);
-  regval |= IGC_RXDCTL_ENABLE;
-  igc_putreg_mem(priv, IGC_RXDCTL0, regval);
+      regval = igc_getreg_mem(priv, IGC_QUEUE(IGC_RXDCTL0, q));
+      regval |= IGC_RXDCTL_ENABLE;
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RXDCTL0, q), regval);
+    }
 
   /* Reset RX tail - after queue is enabled */
 
@@ -1217,7 +1466,10 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 
   /* All RX descriptors available */
 
-  igc_putreg_mem(priv, IGC_RDT0, IGC_RX_DESC);
+  for (q = 0; q < IGC_NQUEUES; q++)
+    {
+      igc_putreg_mem(priv, IGC_QUEUE(IGC_RDT0, q), IGC_RX_DESC);
+    }
 
 #ifdef CONFIG_DEBUG_NET_INFO
   /* Dump memory */
@@ -1239,27 +1491,37 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   uint32_t regval = 0;
   uint64_t mac    = 0;
   int      ret    = OK;
+#if IGC_NQUEUES > 1
+  int      q      = 0;
+#endif
 
   /* Allocate MSI */
 
-  ret = pci_alloc_irq(priv->pcidev, &priv->irq, 1);
-  if (ret != 1)
+  ret = pci_alloc_irq(priv->pcidev, priv->irq, IGC_NVECTORS);
+  if (ret != IGC_NVECTORS)
     {
       nerr("Failed to allocate MSI %d\n", ret);
-      return ret;
+      return ret < 0 ? ret : -ENOTSUP;
     }
 
   /* Attach IRQ */
 
-  irq_attach(priv->irq, igc_interrupt, priv);
+#if IGC_NQUEUES > 1
+  for (q = 0; q < IGC_NQUEUES; q++)
+    {
+      irq_attach(priv->irq[q], igc_queue_interrupt, &priv->queue[q]);
+    }
+#endif
+
+  irq_attach(priv->irq[IGC_OTHER_VECTOR], igc_interrupt, priv);
 
   /* Connect MSI */
 
-  ret = pci_connect_irq(priv->pcidev, &priv->irq, 1);
+  ret = pci_connect_irq(priv->pcidev, priv->irq, IGC_NVECTORS);
   if (ret != OK)
     {
       nerr("Failed to connect MSI %d\n", ret);
-      pci_release_irq(priv->pcidev, &priv->irq, 1);
+      pci_release_irq(priv->pcidev, priv->irq, IGC_NVECTORS);
 
       return -ENOTSUP;
     }
@@ -1269,6 +1531,64 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   igc_putreg_mem(priv, IGC_EIMC, 0xffffffff);
   igc_putreg_mem(priv, IGC_IMC, 0xffffffff);
 
+#if IGC_NQUEUES > 1
+  /* Configure MSI-X: vector n for RX/TX queue n, the last one for the
+   * other causes.
+   */
+
+  for (q = 0; q < IGC_NQUEUES; q += 2)
+    {
+      regval = ((q | IGC_IVAR_VALID) << IGC_IVAR_RXQ_SHIFT(q)) |
+               ((q | IGC_IVAR_VALID) << IGC_IVAR_TXQ_SHIFT(q));
+      if (q + 1 < IGC_NQUEUES)
+        {
+          regval |= (((q + 1) | IGC_IVAR_VALID) <<
+                     IGC_IVAR_RXQ_SHIFT(q + 1)) |
+                    (((q + 1) | IGC_IVAR_VALID) <<
+                     IGC_IVAR_TXQ_SHIFT(q + 1));
+        }
+
+      igc_putreg_mem(priv, IGC_IVAR0 + ((q >> 1) << 2), regval);
+    }
+
+  igc_putreg_mem(priv, IGC_IVARMSC,
+                 (IGC_OTHER_VECTOR | IGC_IVAR_VALID) <<
+                 IGC_IVARMSC_OTHER_SHIFT);
+
+#  ifdef CONFIG_SMP
+  /* Take the interrupt of each queue on the CPU its RX work runs on */
+
+  for (q = 0; q < IGC_NQUEUES; q++)
+    {
+      ret = pci_set_irq_affinity(priv->pcidev, priv->irq, q,
+                                 netdev_lower_queue_cpu(&priv->dev, q));
+      if (ret < 0)
+        {
+          nwarn("Failed to route queue %d vector %d\n", q, ret);
+        }
+    }
+#  endif
+
+  /* Enable MSI-X Multiple Vectors, the queue vectors are cleared
+   * automatically.
+   */
+
+  igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_MULTI);
+  igc_putreg_mem(priv, IGC_EIAC, IGC_MSIX_MULTI_QUEUE);
+  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_MULTI_EIMS);
+
+  /* Configure Other causes */
+
+  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_MULTI_IMS);
+
+  /* Configure Interrupt Throttle */
+
+  for (q = 0; q < IGC_NVECTORS; q++)
+    {
+      igc_putreg_mem(priv, IGC_EITR0 + (q << 2),
+                     (CONFIG_NET_IGC_INT_INTERVAL << 2));
+    }
+#else
   /* Configure MSI-X */
 
   igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_IVAR0);
@@ -1286,6 +1606,7 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   /* Configure Interrupt Throttle */
 
   igc_putreg_mem(priv, IGC_EITR0, (CONFIG_NET_IGC_INT_INTERVAL << 2));
+#endif
 
   /* Get MAC if valid */
 
@@ -1318,6 +1639,7 @@ static int igc_probe(FAR struct pci_device_s *dev)
   FAR struct igc_driver_s       *priv   = NULL;
   FAR struct netdev_lowerhalf_s *netdev = NULL;
   int                            ret    = -ENOMEM;
+  int                            q      = 0;
 
   /* Get type data associated with this PCI device card */
 
@@ -1340,42 +1662,50 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   priv->pcidev = dev;
 
-  /* Allocate TX descriptors */
-
-  priv->tx = kmm_memalign(type->desc_align,
-                          IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
-  if (priv->tx == NULL)
+  for (q = 0; q < IGC_NQUEUES; q++)
     {
-      nerr("alloc tx failed %d\n", errno);
-      goto errout;
-    }
+      FAR struct igc_queue_s *queue = &priv->queue[q];
 
-  /* Allocate RX descriptors */
+      queue->priv = priv;
+      queue->qid  = q;
 
-  priv->rx = kmm_memalign(type->desc_align,
-                          IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
-  if (priv->rx == NULL)
-    {
-      nerr("alloc rx failed %d\n", errno);
-      goto errout;
-    }
+      /* Allocate TX descriptors */
 
-  /* Allocate TX packet pointer array */
+      queue->tx = kmm_memalign(type->desc_align,
+                               IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
+      if (queue->tx == NULL)
+        {
+          nerr("alloc tx failed %d\n", errno);
+          goto errout;
+        }
 
-  priv->tx_pkt = kmm_zalloc(IGC_TX_DESC * sizeof(netpkt_t *));
-  if (priv->tx_pkt == NULL)
-    {
-      nerr("alloc tx_pkt failed\n");
-      goto errout;
-    }
+      /* Allocate RX descriptors */
+
+      queue->rx = kmm_memalign(type->desc_align,
+                               IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
+      if (queue->rx == NULL)
+        {
+          nerr("alloc rx failed %d\n", errno);
+          goto errout;
+        }
 
-  /* Allocate RX packet pointer array */
+      /* Allocate TX packet pointer array */
 
-  priv->rx_pkt = kmm_zalloc(IGC_RX_DESC * sizeof(netpkt_t *));
-  if (priv->rx_pkt == NULL)
-    {
-      nerr("alloc rx_pkt failed\n");
-      goto errout;
+      queue->tx_pkt = kmm_zalloc(IGC_TX_DESC * sizeof(netpkt_t *));
+      if (queue->tx_pkt == NULL)
+        {
+          nerr("alloc tx_pkt failed\n");
+          goto errout;
+        }
+
+      /* Allocate RX packet pointer array */
+
+      queue->rx_pkt = kmm_zalloc(IGC_RX_DESC * sizeof(netpkt_t *));
+      if (queue->rx_pkt == NULL)
+        {
+          nerr("alloc rx_pkt failed\n");
+          goto errout;
+        }
     }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -1422,12 +1752,21 @@ static int igc_probe(FAR struct pci_device_s *dev)
   netdev->quota[NETPKT_TX] = IGC_TX_QUOTA;
   netdev->quota[NETPKT_RX] = IGC_RX_QUOTA;
   netdev->ops = &g_igc_ops;
+#if IGC_NQUEUES > 1
+  netdev->nqueues = IGC_NQUEUES;
+#endif
 
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
-  kmm_free(priv->tx);
-  kmm_free(priv->rx);
+  for (q = 0; q < IGC_NQUEUES; q++)
+    {
+      kmm_free(priv->queue[q].tx);
+      kmm_free(priv->queue[q].rx);
+      kmm_free(priv->queue[q].tx_pkt);
+      kmm_free(priv->queue[q].rx_pkt);
+    }
+
 #ifdef CONFIG_NET_MCASTGROUP
   kmm_free(priv->mta);
 #endif
@@ -139,6 +139,10 @@
 #define IGC_TDWBAL0               (0xe038)   /* Transmit Descriptor WB Address Low Queue */
 #define IGC_TDWBAH0               (0xe03c)   /* Transmit Descriptor WB Address High Queue */
 
+/* The registers of RX/TX queue n follow those of queue 0 by 0x40 each */
+
+#define IGC_QUEUE(reg, n)         ((reg) + ((n) << 6))
+
 /* Transmit Scheduling Registers */
 
 #define IGC_TQAVHC                (0x300c)   /* Transmit Qav High Credits */
@@ -371,6 +375,21 @@
 #define IGC_RXDCTL_SWFLUSH        (1 << 26) /* Bit 26: Receive Software Flush */
                                             /* Bits 27-31: Reserved */
 
+/* Multiple Receive Queues Command */
+
+#define IGC_MRQC_RSS              (2 << 0)   /* Bits 0-2: RSS multiple receive queues */
+#define IGC_MRQC_RSS_IPV4_TCP     (1 << 16)  /* Bit 16: Hash TCP over IPv4 */
+#define IGC_MRQC_RSS_IPV4         (1 << 17)  /* Bit 17: Hash IPv4 */
+#define IGC_MRQC_RSS_IPV6         (1 << 20)  /* Bit 20: Hash IPv6 */
+#define IGC_MRQC_RSS_IPV6_TCP     (1 << 21)  /* Bit 21: Hash TCP over IPv6 */
+#define IGC_MRQC_RSS_IPV4_UDP     (1 << 22)  /* Bit 22: Hash UDP over IPv4 */
+#define IGC_MRQC_RSS_IPV6_UDP     (1 << 23)  /* Bit 23: Hash UDP over IPv6 */
+
+/* The redirection table has 128 one byte entries, the RSS key 10 words */
+
+#define IGC_RETA_ENTRIES          (128)
+#define IGC_RSSRK_REGS            (10)
+
 /* Interrupt Cause */
 
 #define IGC_IC_TXDW               (1 << 0)   /* Bit 0: Transmit Descriptor Written Back */
@@ -425,6 +444,12 @@
 #define IGC_IVAR0_TXQ0_SHIFT      (8)        /* Bits 8-12: MSI-X vector assigned to TxQ0 */
 #define IGC_IVAR0_TXQ0_VAL        (1 << 7)   /* Bit 7: Valid bit for TxQ0 */
 
+/* IVAR register n holds the vectors of RxQ/TxQ 2n and 2n + 1 */
+
+#define IGC_IVAR_VALID            (1 << 7)   /* Valid bit of an entry */
+#define IGC_IVAR_RXQ_SHIFT(q)     (((q) & 1) << 4)
+#define IGC_IVAR_TXQ_SHIFT(q)     ((((q) & 1) << 4) + 8)
+
 /* Interrupt Vector Allocation Registers - Misc */
 
 #define IGC_IVARMSC_TCPTIM        (0)        /* Bits 0-5: MSI-X vectorassigned to TCP timer interrupt */
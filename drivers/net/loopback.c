@@ -337,6 +337,17 @@ int localhost_initialize(void)
 #endif
   priv->lo_dev.d_private = priv;         /* Used to recover private state from dev */
 
+  /* Nothing leaves memory, so the checksums are left partial and the TCP
+   * super-segments are delivered whole instead of being cut to the MTU.
+   */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  priv->lo_dev.d_csumcaps = NETDEV_CSUM_PARTIAL | NETDEV_CSUM_VALID;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  priv->lo_dev.d_gsomax   = CONFIG_NETDEV_GSO_MAX_SIZE;
+#endif
+
   /* Register the loopabck device with the OS so that socket IOCTLs can b
    * performed.
    */
@@ -39,6 +39,8 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -56,16 +58,70 @@
 #  define NETDEV_WORK LPWORK
 #endif
 
+/* With the per-device locks, the frames are taken from the lower half into
+ * a queue without the network lock.
+ */
+
+#if defined(CONFIG_NET_FINE_LOCK) && CONFIG_IOB_NCHAINS > 0
+#  define NETDEV_RXQ
+#endif
+
 #ifdef CONFIG_NETDEV_RSS
 #  define NETDEV_THREAD_COUNT CONFIG_SMP_NCPUS
 #else
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+/* The offload features that segment all the TCP super-segments */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NETDEV_F_TSO (NETDEV_F_TSO4 | NETDEV_F_TSO6)
+#elif defined(CONFIG_NET_IPv6)
+#  define NETDEV_F_TSO NETDEV_F_TSO6
+#else
+#  define NETDEV_F_TSO NETDEV_F_TSO4
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The TCP segment that the receive offload coalesces the following
+ * segments of its flow into during an RX poll.
+ */
+
+#ifdef CONFIG_NETDEV_GRO
+struct netdev_gro_s
+{
+  FAR netpkt_t *pkt;           /* The coalesced segment, NULL if none */
+  uint32_t      seqno;         /* The sequence number that follows it */
+  uint16_t      iphdrlen;      /* The size of its IP header */
+  uint16_t      hdrlen;        /* The size of its IP and TCP headers */
+  uint16_t      segsize;       /* The size of its first segment */
+  bool          more;          /* The last segment was full and not PSH */
+};
+#endif
+
+struct netdev_upper_queue_s;
+
+/* An RX queue of a multi-queue device, or one of the per-CPU queues that
+ * the frames of a device with one queue are steered to.  The frames wait in
+ * rxq until the work of the queue passes them to the network on the CPU of
+ * the queue.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+struct netdev_upper_queue_s
+{
+  FAR struct netdev_upperhalf_s *upper;
+  struct work_s                  work; /* The work on the CPU of the queue */
+  struct iob_queue_s             rxq;  /* The frames of the queue */
+  spinlock_t                     lock; /* Protects rxq */
+  uint8_t                        qid;  /* The index of the queue */
+  int                            cpu;  /* The CPU of the queue */
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -87,6 +143,19 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* RX queue of the frames taken from the lower half */
+
+#ifdef NETDEV_RXQ
+  struct iob_queue_s rxq;
+#endif
+
+  /* The RX queues, those of the lower half or the per-CPU queues of RPS */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  uint8_t nqueues;
+  struct netdev_upper_queue_s queue[CONFIG_NETDEV_MAX_QUEUES];
+#endif
 };
 
 /****************************************************************************
@@ -127,6 +196,40 @@ static bool quota_is_valid(FAR struct netdev_lowerhalf_s *lower)
   return true;
 }
 
+/****************************************************************************
+ * Name: ops_is_valid
+ *
+ * Description:
+ *   Check if the lower half provides the operations for its queues.
+ *
+ ****************************************************************************/
+
+static bool ops_is_valid(FAR struct netdev_lowerhalf_s *lower)
+{
+  FAR const struct netdev_ops_s *ops = lower->ops;
+
+  if (ops == NULL)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      if (lower->nqueues > CONFIG_NETDEV_MAX_QUEUES)
+        {
+          nerr("ERROR: Too many queues when registering device: %d\n",
+               lower->nqueues);
+          return false;
+        }
+
+      return ops->transmitq != NULL && ops->receiveq != NULL;
+    }
+#endif
+
+  return ops->transmit != NULL && ops->receive != NULL;
+}
+
 /****************************************************************************
  * Name: netpkt_get
  *
@@ -241,424 +344,1433 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 
   if (quota <= 0 && lower->ops->reclaim)
     {
+      netdev_lock(&lower->netdev);
       lower->ops->reclaim(lower);
+      netdev_unlock(&lower->netdev);
       quota = netdev_lower_quota_load(lower, NETPKT_TX);
     }
 
   return quota > 0;
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+
 /****************************************************************************
- * Name: netdev_upper_txpoll
+ * Name: netdev_upper_flowhash
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete
- *   2. When the preceding TX packet send times out and the interface is
- *      reset
- *   3. During normal TX polling
+ *   Hash the IP addresses and the TCP or UDP ports of a frame.  Both
+ *   directions of a flow get the same hash, the fragments of an IP packet
+ *   and the frames of other protocols are hashed by what they have of it.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   pkt - The frame, with the IP header in its first buffer
  *
  * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
- *
- * Assumptions:
- *   Called with the network locked.
+ *   The hash of the flow.
  *
  ****************************************************************************/
 
-static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+static uint32_t netdev_upper_flowhash(FAR netpkt_t *pkt)
 {
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR netpkt_t                  *pkt;
-  int                            ret;
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  unsigned int hdrlen = 0;
+  uint32_t hash = 0;
+  uint8_t proto = 0;
 
-  DEBUGASSERT(dev->d_len > 0);
+  if (pkt->io_len == 0)
+    {
+      return 0;
+    }
 
-  NETDEV_TXPACKETS(dev);
+  switch (l3[0] >> 4)
+    {
+#ifdef CONFIG_NET_IPv4
+      case 4:
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
 
-#ifdef CONFIG_NET_PKT
-  /* When packet sockets are enabled, feed the tx frame into it */
+          if (pkt->io_len < IPv4_HDRLEN)
+            {
+              return 0;
+            }
 
-  pkt_input(dev);
+          hash   = net_ip4addr_conv32(ipv4->srcipaddr) ^
+                   net_ip4addr_conv32(ipv4->destipaddr);
+          hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+          if ((ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0)
+            {
+              proto = ipv4->proto;
+            }
+        }
+        break;
 #endif
 
-  pkt = netpkt_get(dev, NETPKT_TX);
+#ifdef CONFIG_NET_IPv6
+      case 6:
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+          int i;
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
-    {
-      nerr("ERROR: Packet too long to send!\n");
-      ret = -EMSGSIZE;
-    }
-  else
-    {
-      ret = lower->ops->transmit(lower, pkt);
+          if (pkt->io_len < IPv6_HDRLEN)
+            {
+              return 0;
+            }
+
+          for (i = 0; i < 8; i++)
+            {
+              hash ^= (uint32_t)(ipv6->srcipaddr[i] ^ ipv6->destipaddr[i]) <<
+                      ((i & 1) << 4);
+            }
+
+          hdrlen = IPv6_HDRLEN;
+          proto  = ipv6->proto;
+        }
+        break;
+#endif
+
+      default:
+        return 0;
     }
 
-  if (ret != OK)
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      pkt->io_len >= hdrlen + 4)
     {
-      /* Stop polling on any error
-       * REVISIT: maybe store the pkt in upper half and retry later?
-       */
+      FAR uint8_t *ports = l3 + hdrlen;
 
-      NETDEV_TXERRORS(dev);
-      netpkt_put(dev, pkt, NETPKT_TX);
-      return ret;
+      hash ^= (uint32_t)((ports[0] ^ ports[2]) << 8 | (ports[1] ^ ports[3]))
+              << 16;
     }
 
-  return NETDEV_TX_CONTINUE;
+  /* Mix the bits, the low bits pick the queue */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash;
 }
 
 /****************************************************************************
- * Name: netdev_upper_tx
+ * Name: netdev_upper_queue_add
  *
  * Description:
- *   Do the actual transmission of packets, including pre-queued packets and
- *   packets from the network stack.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Add a received frame to an RX queue, it is dropped if the queue has no
+ *   room.
  *
  ****************************************************************************/
 
-static int netdev_upper_tx(FAR struct net_driver_s *dev)
+static void netdev_upper_queue_add(FAR struct netdev_upper_queue_s *queue,
+                                   FAR netpkt_t *pkt)
 {
-#if CONFIG_IOB_NCHAINS > 0
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  irqstate_t flags;
+  int ret;
 
-  if (!IOB_QEMPTY(&upper->txq))
-    {
-      /* Put the packet back to the device */
+  flags = spin_lock_irqsave(&queue->lock);
+  ret = iob_tryadd_queue(pkt, &queue->rxq);
+  spin_unlock_irqrestore(&queue->lock, flags);
 
-      netdev_iob_replace(dev, iob_remove_queue(&upper->txq));
-      return netdev_upper_txpoll(dev);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Failed to queue RX packet, dropping\n");
+      netpkt_free(queue->upper->lower, pkt, NETPKT_RX);
     }
-#endif
+}
 
-  /* No more TX packets in queue, poll the net stack to get more packets */
+/****************************************************************************
+ * Name: netdev_upper_queue_remove
+ *
+ * Description:
+ *   Take the oldest frame from an RX queue, or NULL if it is empty.
+ *
+ ****************************************************************************/
 
-  return devif_poll(dev, netdev_upper_txpoll);
+static FAR netpkt_t *
+netdev_upper_queue_remove(FAR struct netdev_upper_queue_s *queue)
+{
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  pkt = iob_remove_queue(&queue->rxq);
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  return pkt;
 }
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
 
 /****************************************************************************
- * Name: netdev_upper_txavail_work
+ * Name: netdev_upper_transmit
  *
  * Description:
- *   Perform an out-of-cycle tx poll on the worker thread.
+ *   Hand a packet to the lower half, to the TX queue of its flow if the
+ *   device has more than one.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
+ *   lower - The lower half device driver structure
+ *   pkt   - The packet to send
+ *
+ * Returned Value:
+ *   The result of the transmit operation of the lower half.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+static int netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower,
+                                 FAR netpkt_t *pkt)
 {
-  FAR struct net_driver_s *dev = &upper->lower->netdev;
-
-  /* Ignore the notification if the interface is not yet up */
+  int ret;
 
-  if (IFF_IS_UP(dev->d_flags))
+  netdev_lock(&lower->netdev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
     {
-      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
-      while (netdev_upper_can_tx(upper) &&
-             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+      ret = lower->ops->transmitq(lower, netdev_upper_flowhash(pkt) %
+                                         lower->nqueues, pkt);
+    }
+  else
+#endif
+    {
+      ret = lower->ops->transmit(lower, pkt);
     }
+
+  netdev_unlock(&lower->netdev);
+  return ret;
 }
 
+#ifdef CONFIG_NETDEV_GSO
+
 /****************************************************************************
- * Name: netdev_upper_queue_tx
+ * Name: netdev_upper_gsomax
  *
  * Description:
- *   Queue a TX packet to the upper half for sending later.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Get the largest super-segment that the device takes.  The hardware
+ *   takes what the lower half announces, the software segmentation needs a
+ *   TX buffer for every segment and is limited by the quota.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
-static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+static uint16_t netdev_upper_gsomax(FAR struct netdev_lowerhalf_s *lower)
 {
-#if CONFIG_IOB_NCHAINS > 0
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int ret;
+  FAR struct net_driver_s *dev = &lower->netdev;
+  unsigned int mtu = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev);
+  unsigned int maxsize = CONFIG_NETDEV_GSO_MAX_SIZE;
 
-  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+  if ((lower->features & NETDEV_F_TSO) != 0 && lower->gso_maxsize > 0)
     {
-      netdev_iob_clear(dev);
+      maxsize = MIN(maxsize, lower->gso_maxsize);
     }
-  else
+
+  if ((lower->features & NETDEV_F_TSO) != NETDEV_F_TSO)
     {
-      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+      maxsize = MIN(maxsize,
+                    netdev_lower_quota_load(lower, NETPKT_TX) * mtu);
     }
-#else
-  /* Fall back to send the packet directly if we don't have IOB queue. */
 
-  netdev_upper_txpoll(dev);
-#endif
+  return maxsize > mtu ? maxsize : 0;
 }
-#endif
 
 /****************************************************************************
- * Name: eth_input
+ * Name: netdev_upper_gso
  *
  * Description:
- *   Handle L2 packet input.
+ *   Cut a TCP super-segment into segments of d_gsosize bytes in software
+ *   and transmit them.  The segments get copies of the headers of the
+ *   super-segment with the lengths, sequence numbers, IPv4 IDs, flags and
+ *   checksums adjusted.  The segments that are left when the TX quota runs
+ *   out are dropped and recovered by TCP.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   dev - Reference to the NuttX driver state structure
+ *   pkt - The super-segment, owned by this function
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-static void eth_input(FAR struct net_driver_s *dev)
+static int netdev_upper_gso(FAR struct net_driver_s *dev, FAR netpkt_t *pkt)
 {
-  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
-
-  /* Check if this is an 802.1Q VLAN tagged packet */
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+  FAR netpkt_t *seg;
+  uint16_t gsosize = dev->d_gsosize;
+  bool ipv6 = (l3[0] >> 4) == 6;
+  unsigned int iphdrlen = 0;
+  unsigned int hdrlen;
+  unsigned int offset;
+  unsigned int seglen;
+  unsigned int total;
+  unsigned int len;
+  uint32_t seqno;
+  uint32_t tmp;
+  uint16_t ipid = 0;
+  uint8_t proto = 0;
+  uint8_t flags;
+  int ret = OK;
+
+  /* The segments are ordinary packets for the lower half */
+
+  dev->d_gsosize = 0;
+
+  /* Find the TCP header, it is in the first buffer with the IP header */
 
-  if (eth_hdr->type == HTONS(TPID_8021QVLAN))
+#ifdef CONFIG_NET_IPv6
+  if (ipv6)
     {
-      /* Need to remove the 4 octet VLAN Tag, by moving src and dest
-       * addresses 4 octets to the right, and then read the actual
-       * ethertype. The VLAN ID and priority fields are currently
-       * ignored.
-       */
-
-      memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
-              offsetof(struct eth_hdr_s, type));
-      dev->d_iob  = iob_trimhead(dev->d_iob, 4);
-      dev->d_len -= 4;
-
-      eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ((FAR struct ipv6_hdr_s *)l3)->proto;
     }
-
-  /* We only accept IP packets of the configured type and ARP packets */
+#endif
 
 #ifdef CONFIG_NET_IPv4
-  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+  if (!ipv6)
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
-
-      /* Receive an IPv4 packet from the network device */
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
 
-      ipv4_input(dev);
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
+      ipid     = ((uint16_t)ipv4->ipid[0] << 8) | ipv4->ipid[1];
     }
-  else
 #endif
-#ifdef CONFIG_NET_IPv6
-  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
-    {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
 
-      /* Give the IPv6 packet to the network layer */
+  tcp    = (FAR struct tcp_hdr_s *)(l3 + iphdrlen);
+  hdrlen = iphdrlen + TCP_HDRLEN;
+  if (proto == IP_PROTO_TCP && pkt->io_len >= hdrlen)
+    {
+      hdrlen = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+    }
 
-      ipv6_input(dev);
+  if (proto != IP_PROTO_TCP || gsosize == 0 || pkt->io_len < hdrlen)
+    {
+      nerr("ERROR: Not a TCP super-segment\n");
+      NETDEV_TXERRORS(dev);
+      netpkt_free(lower, pkt, NETPKT_TX);
+      return -EINVAL;
     }
-  else
-#endif
-#ifdef CONFIG_NET_ARP
-  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
+
+  memcpy(&seqno, tcp->seqno, sizeof(seqno));
+  seqno = NTOHL(seqno);
+  flags = tcp->flags;
+  total = pkt->io_pktlen - hdrlen;
+
+  for (offset = 0; offset < total; offset += seglen)
+    {
+      seglen = MIN(gsosize, total - offset);
+
+      seg = netdev_upper_can_tx(upper) ?
+            netpkt_alloc(lower, NETPKT_TX) : NULL;
+      if (seg == NULL)
+        {
+          ret = -ENOBUFS;
+          break;
+        }
+
+      /* Copy the headers and the data of the segment, the link layer
+       * header goes to the space reserved in front of them.
+       */
+
+      if (iob_clone_partial(pkt, hdrlen, 0, seg, 0, false, false) < 0 ||
+          iob_clone_partial(pkt, seglen, hdrlen + offset, seg, hdrlen,
+                            false, false) < 0 ||
+          seg->io_len < hdrlen)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          ret = -ENOMEM;
+          break;
+        }
+
+      memcpy(IOB_DATA(seg) - NET_LL_HDRLEN(dev), l3 - NET_LL_HDRLEN(dev),
+             NET_LL_HDRLEN(dev));
+
+      /* Only the last segment keeps the FIN and the PSH flags */
+
+      tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(seg) + iphdrlen);
+      tmp = HTONL(seqno + offset);
+      memcpy(tcp->seqno, &tmp, sizeof(tmp));
+      if (offset + seglen < total)
+        {
+          tcp->flags = flags & ~(TCP_FIN | TCP_PSH);
+        }
+
+      tcp->tcpchksum = 0;
+      dev->d_iob     = seg;
+
+#ifdef CONFIG_NET_IPv6
+      if (ipv6)
+        {
+          FAR struct ipv6_hdr_s *ipv6hdr = IPv6BUF;
+
+          len             = hdrlen - IPv6_HDRLEN + seglen;
+          ipv6hdr->len[0] = len >> 8;
+          ipv6hdr->len[1] = len & 0xff;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+          tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                    IPv6_HDRLEN);
+#endif
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+      if (!ipv6)
+        {
+          FAR struct ipv4_hdr_s *ipv4hdr = IPv4BUF;
+
+          len               = hdrlen + seglen;
+          ipv4hdr->len[0]   = len >> 8;
+          ipv4hdr->len[1]   = len & 0xff;
+          ipv4hdr->ipid[0]  = ipid >> 8;
+          ipv4hdr->ipid[1]  = ipid & 0xff;
+          ipv4hdr->ipchksum = 0;
+          ipv4hdr->ipchksum = ~ipv4_chksum(ipv4hdr);
+          ipid++;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+          tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
+#endif
+        }
+#endif
+
+      dev->d_iob = NULL;
+
+      ret = netdev_upper_transmit(lower, seg);
+
+      if (ret != OK)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          break;
+        }
+    }
+
+  netpkt_free(lower, pkt, NETPKT_TX);
+
+  if (ret != OK)
+    {
+      nwarn("WARNING: Dropped the rest of a super-segment: %d\n", ret);
+      NETDEV_TXERRORS(dev);
+      return ret;
+    }
+
+  return NETDEV_TX_CONTINUE;
+}
+#endif /* CONFIG_NETDEV_GSO */
+
+/****************************************************************************
+ * Name: netdev_upper_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
+  bool                           gso = false;
+  int                            ret;
+
+  DEBUGASSERT(dev->d_len > 0);
+
+  NETDEV_TXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the tx frame into it */
+
+  pkt_input(dev);
+#endif
+
+  pkt = netpkt_get(dev, NETPKT_TX);
+
+#ifdef CONFIG_NETDEV_GSO
+  /* A super-segment goes to the hardware as it is if it segments TCP over
+   * the IP version of the packet, it is segmented here otherwise.
+   */
+
+  if (dev->d_gsosize > 0 &&
+      netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+    {
+      if ((lower->features & ((IOB_DATA(pkt)[0] >> 4) == 6 ?
+                              NETDEV_F_TSO6 : NETDEV_F_TSO4)) == 0)
+        {
+          return netdev_upper_gso(dev, pkt);
+        }
+
+      gso = true;
+    }
+#endif
+
+  if (!gso && netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+    {
+      nerr("ERROR: Packet too long to send!\n");
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      ret = netdev_upper_transmit(lower, pkt);
+    }
+
+  if (ret != OK)
+    {
+      /* Stop polling on any error
+       * REVISIT: maybe store the pkt in upper half and retry later?
+       */
+
+      NETDEV_TXERRORS(dev);
+      netpkt_put(dev, pkt, NETPKT_TX);
+      return ret;
+    }
+
+  return NETDEV_TX_CONTINUE;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_tx
+ *
+ * Description:
+ *   Do the actual transmission of packets, including pre-queued packets and
+ *   packets from the network stack.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  if (!IOB_QEMPTY(&upper->txq))
+    {
+      /* Put the packet back to the device */
+
+      netdev_iob_replace(dev, iob_remove_queue(&upper->txq));
+      return netdev_upper_txpoll(dev);
+    }
+#endif
+
+  /* No more TX packets in queue, poll the net stack to get more packets */
+
+  return devif_poll(dev, netdev_upper_txpoll);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle tx poll on the worker thread.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  /* Ignore the notification if the interface is not yet up */
+
+  if (IFF_IS_UP(dev->d_flags))
+    {
+      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
+      while (netdev_upper_can_tx(upper) &&
+             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_tx
+ *
+ * Description:
+ *   Queue a TX packet to the upper half for sending later.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
+static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+
+#ifdef CONFIG_NETDEV_GSO
+  /* The segment size does not go with a queued packet, send a TCP
+   * super-segment produced by the input right away.
+   */
+
+  if (dev->d_gsosize > 0)
+    {
+      netdev_upper_txpoll(dev);
+      dev->d_gsosize = 0;
+      return;
+    }
+#endif
+
+  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+    {
+      netdev_iob_clear(dev);
+    }
+  else
+    {
+      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+    }
+#else
+  /* Fall back to send the packet directly if we don't have IOB queue. */
+
+  netdev_upper_txpoll(dev);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: eth_input
+ *
+ * Description:
+ *   Handle L2 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+static void eth_input(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+
+  /* Check if this is an 802.1Q VLAN tagged packet */
+
+  if (eth_hdr->type == HTONS(TPID_8021QVLAN))
+    {
+      /* Need to remove the 4 octet VLAN Tag, by moving src and dest
+       * addresses 4 octets to the right, and then read the actual
+       * ethertype. The VLAN ID and priority fields are currently
+       * ignored.
+       */
+
+      memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
+              offsetof(struct eth_hdr_s, type));
+      dev->d_iob  = iob_trimhead(dev->d_iob, 4);
+      dev->d_len -= 4;
+
+      eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+    }
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
     {
       ninfo("ARP frame\n");
       NETDEV_RXARP(dev);
 
-      /* Handle ARP packet */
+      /* Handle ARP packet */
+
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ip_input
+ *
+ * Description:
+ *   Handle L3 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MBIM
+static void ip_input(FAR struct net_driver_s *dev)
+{
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_receive
+ *
+ * Description:
+ *   Get the next received frame, from the RX queue if the frames are
+ *   queued, or else from the lower half.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The multi-queue RX queue to take the frame from, or NULL
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_upperhalf_s *upper,
+                     FAR struct netdev_upper_queue_s *queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (queue != NULL)
+    {
+      return netdev_upper_queue_remove(queue);
+    }
+#endif
+
+  netdev_lock(&lower->netdev);
+#ifdef NETDEV_RXQ
+  pkt = iob_remove_queue(&upper->rxq);
+#else
+  pkt = lower->ops->receive(lower);
+#endif
+  netdev_unlock(&lower->netdev);
+
+  return pkt;
+}
 
-      arp_input(dev);
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass a received frame into the network stack.
+ *
+ * Input Parameters:
+ *   upper   - Reference to the upper half driver structure
+ *   pkt     - The received frame
+ *   gsosize - The size of the first of the TCP segments coalesced into the
+ *             frame by the receive offload, 0 for an ordinary frame
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt, uint16_t gsosize)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NETDEV_GRO
+  dev->d_gsosize = gsosize;
+#endif
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+      case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+      case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+      case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+        eth_input(dev);
+        break;
+#endif
+#ifdef CONFIG_NET_MBIM
+      case NET_LL_MBIM:
+        ip_input(dev);
+        break;
+#endif
+#ifdef CONFIG_NET_CAN
+      case NET_LL_CAN:
+        ninfo("CAN frame");
+        can_input(dev);
+        break;
+#endif
+      default:
+        nerr("Unknown link type %d\n", dev->d_lltype);
+        break;
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  dev->d_gsosize = 0;
+#endif
+}
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Name: netdev_upper_gro_tcp
+ *
+ * Description:
+ *   Check if a received frame is a TCP segment that can be coalesced:  A
+ *   correct in-order data segment with only the ACK and PSH flags, for an
+ *   address of the device, with the IP and TCP headers in its first
+ *   buffer.
+ *
+ * Input Parameters:
+ *   dev      - Reference to the NuttX driver state structure
+ *   pkt      - The received frame
+ *   iphdrlen - The location to return the size of the IP header
+ *   hdrlen   - The location to return the size of the IP and TCP headers
+ *
+ * Returned Value:
+ *   The TCP header of the segment, NULL if it cannot be coalesced.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_hdr_s *
+netdev_upper_gro_tcp(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
+                     FAR uint16_t *iphdrlen, FAR uint16_t *hdrlen)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)
+                              (IOB_DATA(pkt) - NET_LL_HDRLEN(dev));
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  FAR struct iob_s *iob;
+#endif
+  unsigned int iplen = 0;
+  uint16_t sum = 0xffff;
+
+  if (dev->d_lltype != NET_LL_ETHERNET)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP) && pkt->io_len >= IPv4TCP_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      if (ipv4->vhl != 0x45 || ipv4->proto != IP_PROTO_TCP ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+          !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                            dev->d_ipaddr)
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+          || ipv4_chksum(ipv4) != 0xffff
+#endif
+         )
+        {
+          return NULL;
+        }
+
+      *iphdrlen = IPv4_HDRLEN;
+      iplen     = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
     }
   else
 #endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6) && pkt->io_len >= IPv6TCP_HDRLEN)
     {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      if (ipv6->proto != IP_PROTO_TCP ||
+          !NETDEV_IS_MY_V6ADDR(dev, ipv6->destipaddr))
+        {
+          return NULL;
+        }
+
+      *iphdrlen = IPv6_HDRLEN;
+      iplen     = IPv6_HDRLEN + ((uint16_t)ipv6->len[0] << 8) +
+                  ipv6->len[1];
+    }
+  else
+#endif
+    {
+      return NULL;
     }
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
+  /* The frames padded to the minimum Ethernet size carry no data */
+
+  tcp     = (FAR struct tcp_hdr_s *)(l3 + *iphdrlen);
+  *hdrlen = *iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  if ((tcp->flags & ~TCP_PSH) != TCP_ACK || *hdrlen > pkt->io_len ||
+      *hdrlen < *iphdrlen + TCP_HDRLEN || iplen != pkt->io_pktlen ||
+      iplen <= *hdrlen)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  /* Check the segment unless the device did, tcp_input() will not */
+
+  iob        = dev->d_iob;
+  dev->d_iob = pkt;
+#  ifdef CONFIG_NET_IPv6
+  if (*iphdrlen == IPv6_HDRLEN && !netdev_csum_valid(dev))
+    {
+      sum = ipv6_upperlayer_chksum(dev, IP_PROTO_TCP, IPv6_HDRLEN);
+    }
+
+#  endif
+#  ifdef CONFIG_NET_IPv4
+  if (*iphdrlen == IPv4_HDRLEN && !netdev_csum_valid(dev))
+    {
+      sum = ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+    }
+#  endif
+
+  dev->d_iob = iob;
+#endif
+
+  return sum == 0xffff ? tcp : NULL;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append a TCP segment to the coalesced segment if it is the next one of
+ *   the same flow, with the same headers but the window and the PSH flag.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   gro    - The coalesced segment
+ *   pkt    - The received segment
+ *   tcp    - The TCP header of the received segment
+ *   hdrlen - The size of the IP and TCP headers of the received segment
+ *
+ * Returned Value:
+ *   True if the segment was appended and belongs to the coalesced segment
+ *   now; false if it was left alone.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_merge(FAR struct netdev_upperhalf_s *upper,
+                                   FAR struct netdev_gro_s *gro,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   uint16_t hdrlen)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR uint8_t *l3 = IOB_DATA(gro->pkt);
+  FAR struct tcp_hdr_s *head;
+  uint16_t datalen = pkt->io_pktlen - hdrlen;
+  uint32_t seqno;
+  unsigned int len;
+
+  head = (FAR struct tcp_hdr_s *)(l3 + gro->iphdrlen);
+  memcpy(&seqno, tcp->seqno, sizeof(seqno));
+
+  if (!gro->more || hdrlen != gro->hdrlen || datalen > gro->segsize ||
+      NTOHL(seqno) != gro->seqno ||
+      gro->pkt->io_pktlen + datalen > UINT16_MAX - NET_LL_HDRLEN(dev))
+    {
+      return false;
+    }
+
+  /* The addresses and the TOS/TTL or traffic class/hop limit, the ports,
+   * the ACK number and the options have to match.
    */
 
-  if (dev->d_len > 0)
+#ifdef CONFIG_NET_IPv6
+  if (gro->iphdrlen == IPv6_HDRLEN)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
 
-      netdev_upper_queue_tx(dev);
+      if (memcmp(ipv6, IOB_DATA(pkt), offsetof(struct ipv6_hdr_s, len)) ||
+          memcmp(&ipv6->proto, &((FAR struct ipv6_hdr_s *)
+                                 IOB_DATA(pkt))->proto,
+                 IPv6_HDRLEN - offsetof(struct ipv6_hdr_s, proto)))
+        {
+          return false;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (gro->iphdrlen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+      FAR struct ipv4_hdr_s *next = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+
+      if (ipv4->tos != next->tos || ipv4->ttl != next->ttl ||
+          ipv4->proto != next->proto ||
+          memcmp(ipv4->srcipaddr, next->srcipaddr, 2 * sizeof(in_addr_t)))
+        {
+          return false;
+        }
+    }
+#endif
+
+  if (memcmp(head, tcp, offsetof(struct tcp_hdr_s, seqno)) ||
+      memcmp(head->ackno, tcp->ackno, sizeof(tcp->ackno)) ||
+      memcmp(head->optdata, tcp->optdata, hdrlen - gro->iphdrlen -
+                                          TCP_HDRLEN))
+    {
+      return false;
+    }
+
+  /* Take the latest window and PSH, then only the data of the frame */
+
+  memcpy(head->wnd, tcp->wnd, sizeof(tcp->wnd));
+  head->flags |= tcp->flags & TCP_PSH;
+  gro->more    = (tcp->flags & TCP_PSH) == 0 && datalen == gro->segsize;
+  gro->seqno  += datalen;
+
+  iob_concat(gro->pkt, iob_trimhead(pkt, hdrlen));
+  len = gro->pkt->io_pktlen;
+
+  /* The frame is freed with the coalesced segment */
+
+  atomic_fetch_add(&upper->lower->quota[NETPKT_RX], 1);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_IPv6
+  if (gro->iphdrlen == IPv6_HDRLEN)
+    {
+      len  -= IPv6_HDRLEN;
+      l3[4] = len >> 8;
+      l3[5] = len & 0xff;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (gro->iphdrlen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      ipv4->len[0]   = len >> 8;
+      ipv4->len[1]   = len & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+    }
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the coalesced segment into the network stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper,
+                                   FAR struct netdev_gro_s *gro)
+{
+  if (gro->pkt != NULL)
+    {
+      netdev_upper_input(upper, gro->pkt, gro->segsize);
+      gro->pkt = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro
+ *
+ * Description:
+ *   Coalesce a received frame into the coalesced segment or pass it into
+ *   the network stack, in the order of reception.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   gro   - The coalesced segment
+ *   pkt   - The received frame
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro(FAR struct netdev_upperhalf_s *upper,
+                             FAR struct netdev_gro_s *gro,
+                             FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint32_t seqno;
+
+  tcp = netdev_upper_gro_tcp(dev, pkt, &iphdrlen, &hdrlen);
+  if (tcp != NULL && gro->pkt != NULL &&
+      netdev_upper_gro_merge(upper, gro, pkt, tcp, hdrlen))
+    {
+      if (!gro->more)
+        {
+          netdev_upper_gro_flush(upper, gro);
+        }
+
+      return;
+    }
+
+  netdev_upper_gro_flush(upper, gro);
+
+  if (tcp == NULL)
+    {
+      netdev_upper_input(upper, pkt, 0);
+      return;
+    }
+
+  /* Start a new coalesced segment with this one */
+
+  memcpy(&seqno, tcp->seqno, sizeof(seqno));
+
+  gro->pkt      = pkt;
+  gro->iphdrlen = iphdrlen;
+  gro->hdrlen   = hdrlen;
+  gro->segsize  = pkt->io_pktlen - hdrlen;
+  gro->seqno    = NTOHL(seqno) + gro->segsize;
+  gro->more     = (tcp->flags & TCP_PSH) == 0;
+
+  if (!gro->more)
+    {
+      netdev_upper_gro_flush(upper, gro);
+    }
+}
+#endif /* CONFIG_NETDEV_GRO */
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The multi-queue RX queue to poll, or NULL for the device
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     FAR struct netdev_upper_queue_s *queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *pkt;
+#ifdef CONFIG_NETDEV_GRO
+  struct netdev_gro_s            gro;
+
+  gro.pkt = NULL;
+#endif
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  while ((pkt = netdev_upper_receive(upper, queue)) != NULL)
+    {
+      if (!IFF_IS_UP(dev->d_flags))
+        {
+          /* Interface down, drop frame */
+
+          NETDEV_RXDROPPED(dev);
+          netpkt_free(lower, pkt, NETPKT_RX);
+          continue;
+        }
+
+#ifdef CONFIG_NETDEV_GRO
+      netdev_upper_gro(upper, &gro, pkt);
+#else
+      netdev_upper_input(upper, pkt, 0);
+#endif
     }
-}
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The segments of one RX poll are coalesced at most */
+
+  netdev_upper_gro_flush(upper, &gro);
 #endif
+}
 
 /****************************************************************************
- * Name: ip_input
+ * Name: netdev_upper_rxqueue
  *
  * Description:
- *   Handle L3 packet input.
+ *   Take the received frames from the lower half into the RX queue.  The
+ *   frames are bounded by the RX quota of the lower half.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   upper - Reference to the upper half driver structure
  *
  * Assumptions:
- *   Called with the network locked.
+ *   Called without the network locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_MBIM
-static void ip_input(FAR struct net_driver_s *dev)
+#ifdef NETDEV_RXQ
+static void netdev_upper_rxqueue(FAR struct netdev_upperhalf_s *upper)
 {
-  /* We only accept IP packets of the configured type */
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
 
-#ifdef CONFIG_NET_IPv4
-  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+  netdev_lock(&lower->netdev);
+  while ((pkt = lower->ops->receive(lower)) != NULL)
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
-
-      /* Receive an IPv4 packet from the network device */
-
-      ipv4_input(dev);
+      if (iob_tryadd_queue(pkt, &upper->rxq) < 0)
+        {
+          nwarn("WARNING: Failed to queue RX packet, dropping\n");
+          netpkt_free(lower, pkt, NETPKT_RX);
+        }
     }
-  else
+
+  netdev_unlock(&lower->netdev);
+}
 #endif
-#ifdef CONFIG_NET_IPv6
-  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
-    {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
 
-      /* Give the IPv6 packet to the network layer */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
 
-      ipv6_input(dev);
-    }
-  else
-#endif
-    {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-    }
+/****************************************************************************
+ * Name: netdev_upper_queue_rxwork
+ *
+ * Description:
+ *   The work of an RX queue on the CPU of the queue:  Take the frames of
+ *   the RX queue of a multi-queue device from the lower half, then pass
+ *   the frames of the queue to the network.
+ *
+ * Input Parameters:
+ *   arg - Reference to the RX queue (cast to void *)
+ *
+ ****************************************************************************/
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+static void netdev_upper_queue_rxwork(FAR void *arg)
+{
+  FAR struct netdev_upper_queue_s *queue = arg;
+  FAR struct netdev_upperhalf_s   *upper = queue->upper;
+  FAR struct netdev_lowerhalf_s   *lower = upper->lower;
+  FAR netpkt_t                    *pkt;
 
-  if (dev->d_len > 0)
+  if (lower->nqueues > 1)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
+      /* Only this work takes from the queue, the device is not locked and
+       * the works of the other queues drain them meanwhile.
        */
 
-      netdev_upper_queue_tx(dev);
+      while ((pkt = lower->ops->receiveq(lower, queue->qid)) != NULL)
+        {
+          netdev_upper_queue_add(queue, pkt);
+        }
+    }
+
+  net_lock();
+  netdev_upper_rxpoll_work(upper, queue);
+  netdev_upper_txavail_work(upper);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_schedule
+ *
+ * Description:
+ *   Schedule the work of an RX queue on the CPU of the queue.
+ *
+ ****************************************************************************/
+
+static void
+netdev_upper_queue_schedule(FAR struct netdev_upper_queue_s *queue)
+{
+  if (work_available(&queue->work))
+    {
+      work_queue_cpu(NETDEV_WORK, queue->cpu, &queue->work,
+                     netdev_upper_queue_rxwork, queue, 0);
     }
 }
-#endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Name: netdev_upper_rps
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Take the received frames of a device with one RX queue and steer them
+ *   to the per-CPU queues by the hash of their flow.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
  *
  * Assumptions:
- *   Called with the network locked.
+ *   Called without the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+#ifdef CONFIG_NETDEV_RPS
+static void netdev_upper_rps(FAR struct netdev_upperhalf_s *upper)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR struct netdev_lowerhalf_s *lower   = upper->lower;
   FAR netpkt_t                  *pkt;
+  uint32_t                       pending = 0;
+  int                            qid;
 
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
-
+  netdev_lock(&lower->netdev);
   while ((pkt = lower->ops->receive(lower)) != NULL)
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
-
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
-        }
-
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+      qid = netdev_upper_flowhash(pkt) % upper->nqueues;
+      netdev_upper_queue_add(&upper->queue[qid], pkt);
+      pending |= 1u << qid;
+    }
 
-      pkt_input(dev);
-#endif
+  netdev_unlock(&lower->netdev);
 
-      switch (dev->d_lltype)
+  for (qid = 0; pending != 0; qid++, pending >>= 1)
+    {
+      if ((pending & 1) != 0)
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          netdev_upper_queue_schedule(&upper->queue[qid]);
         }
     }
 }
+#endif
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
 
 /****************************************************************************
  * Name: netdev_upper_work
@@ -675,10 +1787,51 @@ static void netdev_upper_work(FAR void *arg)
 {
   FAR struct netdev_upperhalf_s *upper = arg;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The RX queues of a multi-queue device are served by their own works,
+   * and the frames of a device with one queue are steered to the queues by
+   * RPS.  Only the TX is left to do here then.
+   */
+
+  if (upper->nqueues > 0)
+    {
+#  if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
+      int qid;
+
+      /* There are no RX interrupts to schedule the works of the queues */
+
+      for (qid = 0; qid < upper->lower->nqueues; qid++)
+        {
+          netdev_upper_queue_schedule(&upper->queue[qid]);
+        }
+
+#  endif
+#  ifdef CONFIG_NETDEV_RPS
+      if (upper->lower->nqueues <= 1)
+        {
+          netdev_upper_rps(upper);
+        }
+#  endif
+
+      net_lock();
+      netdev_upper_txavail_work(upper);
+      net_unlock();
+      return;
+    }
+#endif
+
+#ifdef NETDEV_RXQ
+  /* Drain the device before taking the network lock, the other devices
+   * can be served meanwhile.
+   */
+
+  netdev_upper_rxqueue(upper);
+#endif
+
   /* RX may release quota and driver buffer, so do RX first. */
 
   net_lock();
-  netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxpoll_work(upper, NULL);
   netdev_upper_txavail_work(upper);
   net_unlock();
 }
@@ -769,9 +1922,12 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 #else
   if (work_available(&upper->work))
     {
-      /* Schedule to serialize the poll on the worker thread. */
+      /* Schedule to serialize the poll on the worker thread.  Keep it on
+       * this CPU, which has just touched the device and its buffers.
+       */
 
-      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
+      work_queue_cpu(NETDEV_WORK, this_cpu(), &upper->work,
+                     netdev_upper_work, upper, 0);
     }
 #endif
 }
@@ -1047,6 +2203,7 @@ int netdev_upper_wireless_ioctl(FAR struct netdev_lowerhalf_s *lower,
 static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
   int i;
@@ -1086,7 +2243,10 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      netdev_lock(dev);
+      ret = upper->lower->ops->ifup(upper->lower);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1095,14 +2255,27 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int i;
+#endif
 
 #ifndef CONFIG_NETDEV_WORK_THREAD
   work_cancel(NETDEV_WORK, &upper->work);
 #endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      work_cancel(NETDEV_WORK, &upper->queue[i].work);
+    }
+#endif
 
   if (upper->lower->ops->ifdown)
     {
-      return upper->lower->ops->ifdown(upper->lower);
+      netdev_lock(dev);
+      ret = upper->lower->ops->ifdown(upper->lower);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1113,10 +2286,14 @@ static int netdev_upper_addmac(FAR struct net_driver_s *dev,
                                FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->addmac)
     {
-      return upper->lower->ops->addmac(upper->lower, mac);
+      netdev_lock(dev);
+      ret = upper->lower->ops->addmac(upper->lower, mac);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1128,10 +2305,14 @@ static int netdev_upper_rmmac(FAR struct net_driver_s *dev,
                               FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->rmmac)
     {
-      return upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_lock(dev);
+      ret = upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1144,24 +2325,24 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int ret = -ENOTTY;
+
+  netdev_lock(dev);
 
 #ifdef CONFIG_NETDEV_WIRELESS_HANDLER
   if (lower->iw_ops)
     {
-      int ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
-      if (ret != -ENOTTY)
-        {
-          return ret;
-        }
+      ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
     }
 #endif
 
-  if (lower->ops->ioctl)
+  if (ret == -ENOTTY && lower->ops->ioctl)
     {
-      return lower->ops->ioctl(lower, cmd, arg);
+      ret = lower->ops->ioctl(lower, cmd, arg);
     }
 
-  return -ENOTTY;
+  netdev_unlock(dev);
+  return ret;
 }
 #endif
 
@@ -1191,12 +2372,12 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) || defined(CONFIG_NETDEV_MULTIQUEUE)
   int i;
 #endif
 
-  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || quota_is_valid(dev) == false ||
+      ops_is_valid(dev) == false)
     {
       return -EINVAL;
     }
@@ -1206,6 +2387,29 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The frames of a device with one queue go to a queue per CPU for RPS */
+
+  if (dev->nqueues > 1)
+    {
+      upper->nqueues = dev->nqueues;
+    }
+#  ifdef CONFIG_NETDEV_RPS
+  else
+    {
+      upper->nqueues = MIN(CONFIG_SMP_NCPUS, CONFIG_NETDEV_MAX_QUEUES);
+    }
+#  endif
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      upper->queue[i].upper = upper;
+      upper->queue[i].qid   = i;
+      upper->queue[i].cpu   = netdev_lower_queue_cpu(dev, i);
+      spin_lock_init(&upper->queue[i].lock);
+    }
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1225,6 +2429,26 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       dev->netdev.d_private = NULL;
     }
 
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_CSUM_OFFLOAD)
+  else
+    {
+#  ifdef CONFIG_NETDEV_GSO
+      dev->netdev.d_gsomax = netdev_upper_gsomax(dev);
+#  endif
+#  ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      if ((dev->features & NETDEV_F_TXCSUM) != 0)
+        {
+          dev->netdev.d_csumcaps |= NETDEV_CSUM_PARTIAL;
+        }
+
+      if ((dev->features & NETDEV_F_RXCSUM) != 0)
+        {
+          dev->netdev.d_csumcaps |= NETDEV_CSUM_VALID;
+        }
+#  endif
+    }
+#endif
+
 #ifdef CONFIG_NETDEV_WORK_THREAD
   for (i = 0; i < NETDEV_THREAD_COUNT; i++)
     {
@@ -1255,7 +2479,7 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) || defined(CONFIG_NETDEV_MULTIQUEUE)
   int i;
 #endif
 
@@ -1291,6 +2515,16 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
 #if CONFIG_IOB_NCHAINS > 0
   iob_free_queue(&upper->txq);
 #endif
+#ifdef NETDEV_RXQ
+  iob_free_queue(&upper->rxq);
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      work_cancel_sync(NETDEV_WORK, &upper->queue[i].work);
+      iob_free_queue(&upper->queue[i].rxq);
+    }
+#endif
 
   kmm_free(upper);
   dev->netdev.d_private = NULL;
@@ -1369,6 +2603,52 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_queue_rxready
+ *
+ * Description:
+ *   Notifies the networking layer that RX queue qid of a multi-queue device
+ *   has packets ready to read.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The index of the RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_queue_rxready(FAR struct netdev_lowerhalf_s *dev,
+                                int qid)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(qid >= 0 && qid < upper->nqueues);
+  netdev_upper_queue_schedule(&upper->queue[qid]);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_queue_cpu
+ *
+ * Description:
+ *   Get the CPU that RX queue qid of a multi-queue device is bound to.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The index of the RX queue
+ *
+ * Returned Value:
+ *   The index of the CPU.
+ *
+ ****************************************************************************/
+
+int netdev_lower_queue_cpu(FAR struct netdev_lowerhalf_s *dev, int qid)
+{
+  return qid % CONFIG_SMP_NCPUS;
+}
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
+
 /****************************************************************************
  * Name: netpkt_alloc
  *
@@ -1395,7 +2675,8 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
       return NULL;
     }
 
-  pkt = iob_tryalloc(false);
+  pkt = iob_tryalloc_size(false, NETDEV_PKTSIZE(&dev->netdev) +
+                               CONFIG_NET_LL_GUARDSIZE);
   if (pkt == NULL)
     {
       atomic_fetch_add(&dev->quota[type], 1);
@@ -1625,3 +2906,79 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_getcsum
+ *
+ * Description:
+ *   Check if the hardware has to complete the TCP or UDP checksum of a
+ *   packet passed to transmit().
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - The location to return the offset of the TCP or UDP header
+ *            from netpkt_getdata()
+ *   offset - The location to return the offset of the checksum field in
+ *            the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the hardware has to complete the checksum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool netpkt_getcsum(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                    FAR uint16_t *start, FAR uint16_t *offset)
+{
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  uint16_t iphdrlen = 0;
+  uint8_t proto = 0;
+
+  if ((pkt->io_flags & NETDEV_CSUM_PARTIAL) == 0)
+    {
+      return false;
+    }
+
+  /* Only a TCP or UDP packet has a partial checksum, the flag stays with
+   * the buffer if the network reuses it for another packet, like the ARP
+   * request for the destination of the packet.
+   */
+
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] >> 4) == 6)
+    {
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ((FAR struct ipv6_hdr_s *)l3)->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] >> 4) == 4)
+    {
+      iphdrlen = (l3[0] & IPv4_HLMASK) << 2;
+      proto    = ((FAR struct ipv4_hdr_s *)l3)->proto;
+    }
+#endif
+
+  *start = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+
+  switch (proto)
+    {
+#ifdef CONFIG_NET_TCP
+      case IP_PROTO_TCP:
+        *offset = offsetof(struct tcp_hdr_s, tcpchksum);
+        return true;
+#endif
+
+#ifdef CONFIG_NET_UDP
+      case IP_PROTO_UDP:
+        *offset = offsetof(struct udp_hdr_s, udpchksum);
+        return true;
+#endif
+
+      default:
+        return false;
+    }
+}
+#endif
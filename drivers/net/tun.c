@@ -52,8 +52,6 @@
 
 #include <arpa/inet.h>
 
-#include <net/if.h>
-
 #ifdef CONFIG_NET_PKT
 #  include <nuttx/net/pkt.h>
 #endif
@@ -62,11 +60,14 @@
 #include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/uio.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/net/tun.h>
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TUN)
@@ -102,6 +103,19 @@
 #  define CONFIG_TUN_NINTERFACES 1
 #endif
 
+/* CONFIG_NET_TUN_NQUEUES is the number of file descriptors that can be
+ * attached to one interface, CONFIG_NET_TUN_QUEUE_DEPTH the number of
+ * packets that wait to be read on each of them.
+ */
+
+#ifndef CONFIG_NET_TUN_NQUEUES
+#  define CONFIG_NET_TUN_NQUEUES 1
+#endif
+
+#ifndef CONFIG_NET_TUN_QUEUE_DEPTH
+#  define CONFIG_NET_TUN_QUEUE_DEPTH 1
+#endif
+
 /* This is a helper pointer for accessing the contents of the Ethernet
  * header.
  */
@@ -114,29 +128,46 @@
  * Private Types
  ****************************************************************************/
 
-/* The tun_device_s encapsulates all state information for a single hardware
+/* A packet waiting to be read */
+
+struct tun_pkt_s
+{
+  FAR struct iob_s *iob;       /* The packet, link layer header included */
+  size_t            len;       /* The length of the packet */
+};
+
+/* The tun_queue_s holds the state of one file descriptor attached to an
  * interface
  */
 
-struct tun_device_s
+struct tun_queue_s
 {
-  bool              bifup;     /* true:ifup false:ifdown */
+  FAR struct tun_device_s *priv;  /* The interface of the queue */
+  bool              attached;     /* The queue belongs to an open file */
   bool              read_wait;
   bool              write_wait;
-  struct work_s     work;      /* For deferring poll work to the work queue */
+  uint8_t           head;         /* Index of the oldest packet in pkts */
+  uint8_t           count;        /* Number of packets in pkts */
   FAR struct pollfd *poll_fds;
-  mutex_t           lock;
   sem_t             read_wait_sem;
   sem_t             write_wait_sem;
-  size_t            read_d_len;
-  size_t            write_d_len;
+  struct tun_pkt_s  pkts[CONFIG_NET_TUN_QUEUE_DEPTH];
+};
 
-  /* These packet buffer arrays required 16-bit alignment.  That alignment
-   * is assured only by the preceding wide data types.
-   */
+/* The tun_device_s encapsulates all state information for a single hardware
+ * interface
+ */
+
+struct tun_device_s
+{
+  bool              bifup;     /* true:ifup false:ifdown */
+  bool              multiq;    /* Created with IFF_MULTI_QUEUE */
+  bool              vnet_hdr;  /* Packets carry a struct tun_vnet_hdr_s */
+  uint8_t           nqueues;   /* Number of attached queues */
+  struct work_s     work;      /* For deferring poll work to the work queue */
+  mutex_t           lock;
 
-  FAR struct iob_s *read_buf;
-  FAR struct iob_s *write_buf;
+  struct tun_queue_s queue[CONFIG_NET_TUN_NQUEUES];
 
   /* This holds the information visible to the NuttX network */
 
@@ -155,20 +186,16 @@ struct tun_driver_s
 
 /* Common TX logic */
 
-static void tun_fd_transmit(FAR struct tun_device_s *priv);
+static void tun_fd_transmit(FAR struct tun_queue_s *queue);
 static int  tun_txpoll(FAR struct net_driver_s *dev);
-#ifdef CONFIG_NET_ETHERNET
-static int  tun_txpoll_tap(FAR struct net_driver_s *dev);
-#endif
-static int  tun_txpoll_tun(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
-static void tun_net_receive(FAR struct tun_device_s *priv);
+static void tun_net_receive(FAR struct tun_queue_s *queue);
 #ifdef CONFIG_NET_ETHERNET
-static void tun_net_receive_tap(FAR struct tun_device_s *priv);
+static void tun_net_receive_tap(FAR struct tun_queue_s *queue);
 #endif
-static void tun_net_receive_tun(FAR struct tun_device_s *priv);
+static void tun_net_receive_tun(FAR struct tun_queue_s *queue);
 
 static void tun_txdone(FAR struct tun_device_s *priv);
 
@@ -182,9 +209,12 @@ static int tun_addmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 #endif
 
+static int tun_queue_attach(FAR struct tun_device_s *priv,
+                            FAR struct file *filep);
+static bool tun_queue_detach(FAR struct tun_queue_s *queue);
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep,
-                        FAR const char *devfmt, bool tun);
+                        FAR const char *devfmt, int flags);
 static void tun_dev_uninit(FAR struct tun_device_s *priv);
 
 /* File interface */
@@ -197,6 +227,8 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int tun_poll(FAR struct file *filep, FAR struct pollfd *fds,
                     bool setup);
+static ssize_t tun_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t tun_writev(FAR struct file *filep, FAR struct uio *uio);
 
 /****************************************************************************
  * Private Data
@@ -219,7 +251,9 @@ static const struct file_operations g_tun_file_ops =
   tun_ioctl,    /* ioctl */
   NULL,         /* mmap */
   NULL,         /* truncate */
-  tun_poll      /* poll */
+  tun_poll,     /* poll */
+  tun_readv,    /* readv */
+  tun_writev    /* writev */
 };
 
 /****************************************************************************
@@ -230,148 +264,206 @@ static const struct file_operations g_tun_file_ops =
  * Name: tun_pollnotify
  ****************************************************************************/
 
-static void tun_pollnotify(FAR struct tun_device_s *priv,
+static void tun_pollnotify(FAR struct tun_queue_s *queue,
                            pollevent_t eventset)
 {
-  FAR struct pollfd *fds = priv->poll_fds;
+  FAR struct pollfd *fds = queue->poll_fds;
 
-  if (priv->read_wait && (eventset & POLLIN))
+  if (queue->read_wait && (eventset & POLLIN))
     {
-      priv->read_wait = false;
-      nxsem_post(&priv->read_wait_sem);
+      queue->read_wait = false;
+      nxsem_post(&queue->read_wait_sem);
     }
 
-  if (priv->write_wait && (eventset & POLLOUT))
+  if (queue->write_wait && (eventset & POLLOUT))
     {
-      priv->write_wait = false;
-      nxsem_post(&priv->write_wait_sem);
+      queue->write_wait = false;
+      nxsem_post(&queue->write_wait_sem);
     }
 
   poll_notify(&fds, 1, eventset);
 }
 
 /****************************************************************************
- * Name: tun_fd_transmit
+ * Name: tun_txroom
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
- *
- * Input Parameters:
- *   priv - Reference to the driver state structure
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Check that every queue of the interface can take another packet, the
+ *   next packet of the network may be steered to any of them.
  *
  ****************************************************************************/
 
-static void tun_fd_transmit(FAR struct tun_device_s *priv)
+static bool tun_txroom(FAR struct tun_device_s *priv)
 {
-  tun_pollnotify(priv, POLLIN);
+  int i;
+
+  if (priv->nqueues == 0)
+    {
+      return false;
+    }
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached &&
+          priv->queue[i].count >= CONFIG_NET_TUN_QUEUE_DEPTH)
+        {
+          return false;
+        }
+    }
+
+  return true;
 }
 
 /****************************************************************************
- * Name: tun_txpoll
+ * Name: tun_flowhash
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   OK on success; a negated errno on failure
- *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Hash the IP addresses and the TCP or UDP ports of the packet in d_iob,
+ *   so that all the packets of a flow are read from the same queue.
  *
  ****************************************************************************/
 
-static int tun_txpoll(FAR struct net_driver_s *dev)
+static uint32_t tun_flowhash(FAR struct net_driver_s *dev)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
-  int ret;
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR uint8_t *l3 = IOB_DATA(iob);
+  unsigned int hdrlen = 0;
+  uint32_t hash = 0;
+  uint8_t proto = 0;
 
-  DEBUGASSERT(priv->read_buf == NULL);
+  switch (iob->io_len > 0 ? l3[0] >> 4 : 0)
+    {
+#ifdef CONFIG_NET_IPv4
+      case 4:
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
 
-  NETDEV_TXPACKETS(dev);
-#ifdef CONFIG_NET_PKT
-  /* When packet sockets are enabled, feed the frame into the tap */
+          if (iob->io_len < IPv4_HDRLEN)
+            {
+              return 0;
+            }
 
-  pkt_input(dev);
+          hash   = net_ip4addr_conv32(ipv4->srcipaddr) ^
+                   net_ip4addr_conv32(ipv4->destipaddr);
+          hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+          if ((ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0)
+            {
+              proto = ipv4->proto;
+            }
+        }
+        break;
 #endif
 
-  priv->read_d_len = dev->d_len;
-  priv->read_buf   = dev->d_iob;
-  netdev_iob_clear(dev);
+#ifdef CONFIG_NET_IPv6
+      case 6:
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+          int i;
 
-#ifdef CONFIG_NET_ETHERNET
-  if (dev->d_lltype == NET_LL_ETHERNET)
-    {
-      ret = tun_txpoll_tap(dev);
-    }
-  else
+          if (iob->io_len < IPv6_HDRLEN)
+            {
+              return 0;
+            }
+
+          for (i = 0; i < 8; i++)
+            {
+              hash ^= (uint32_t)(ipv6->srcipaddr[i] ^ ipv6->destipaddr[i]) <<
+                      ((i & 1) << 4);
+            }
+
+          hdrlen = IPv6_HDRLEN;
+          proto  = ipv6->proto;
+        }
+        break;
 #endif
+
+      default:
+        return 0;
+    }
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      iob->io_len >= hdrlen + 4)
     {
-      ret = tun_txpoll_tun(dev);
+      FAR uint8_t *ports = l3 + hdrlen;
+
+      hash ^= (uint32_t)((ports[0] ^ ports[2]) << 8 | (ports[1] ^ ports[3]))
+              << 16;
     }
 
-  return ret;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash;
 }
 
 /****************************************************************************
- * Name: tun_txpoll_tap : for tap (ethernet bridge) mode
+ * Name: tun_select_queue
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
+ *   Select the queue that the outgoing packet in d_iob is read from.
  *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
+ ****************************************************************************/
+
+static FAR struct tun_queue_s *
+tun_select_queue(FAR struct tun_device_s *priv)
+{
+  unsigned int n = 0;
+  int i;
+
+  if (priv->nqueues > 1)
+    {
+      n = tun_flowhash(&priv->dev) % priv->nqueues;
+    }
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached && n-- == 0)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(i < CONFIG_NET_TUN_NQUEUES);
+  return &priv->queue[i];
+}
+
+/****************************************************************************
+ * Name: tun_fd_transmit
+ *
+ * Description:
+ *   Move the packet in d_iob to a queue and wake up its reader.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   queue - The queue the packet is read from
  *
  * Returned Value:
- *   OK on success; a negated errno on failure
+ *   None
  *
  * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   The device is locked and the queue has room for the packet.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_ETHERNET
-static int tun_txpoll_tap(FAR struct net_driver_s *dev)
+static void tun_fd_transmit(FAR struct tun_queue_s *queue)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+  FAR struct net_driver_s *dev = &queue->priv->dev;
+  FAR struct tun_pkt_s *pkt;
 
-  /* Send the packet */
+  DEBUGASSERT(queue->count < CONFIG_NET_TUN_QUEUE_DEPTH);
 
-  tun_fd_transmit(priv);
+  pkt = &queue->pkts[(queue->head + queue->count) %
+                     CONFIG_NET_TUN_QUEUE_DEPTH];
+  pkt->len = dev->d_len;
+  pkt->iob = dev->d_iob;
+  queue->count++;
+  netdev_iob_clear(dev);
 
-  return 1;
+  tun_pollnotify(queue, POLLIN);
 }
-#endif
 
 /****************************************************************************
- * Name: tun_txpoll_tun : for tun (IP tunneling) mode
+ * Name: tun_txpoll
  *
  * Description:
  *   The transmitter is available, check if the network has any outgoing
@@ -386,7 +478,7 @@ static int tun_txpoll_tap(FAR struct net_driver_s *dev)
  *   dev - Reference to the NuttX driver state structure
  *
  * Returned Value:
- *   OK on success; a negated errno on failure
+ *   Zero to continue polling while all the queues have room, 1 to stop
  *
  * Assumptions:
  *   May or may not be called from an interrupt handler.  In either case,
@@ -395,13 +487,22 @@ static int tun_txpoll_tap(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-static int tun_txpoll_tun(FAR struct net_driver_s *dev)
+static int tun_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
 
-  tun_fd_transmit(priv);
+  NETDEV_TXPACKETS(dev);
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  /* Send the packet on the queue of its flow */
+
+  tun_fd_transmit(tun_select_queue(priv));
 
-  return 1;
+  return tun_txroom(priv) ? 0 : 1;
 }
 
 /****************************************************************************
@@ -412,7 +513,7 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
  *   packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - The queue the packet was written to
  *
  * Returned Value:
  *   None
@@ -422,17 +523,17 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-static void tun_net_receive(FAR struct tun_device_s *priv)
+static void tun_net_receive(FAR struct tun_queue_s *queue)
 {
 #ifdef CONFIG_NET_ETHERNET
-  if (priv->dev.d_lltype == NET_LL_ETHERNET)
+  if (queue->priv->dev.d_lltype == NET_LL_ETHERNET)
     {
-      tun_net_receive_tap(priv);
+      tun_net_receive_tap(queue);
     }
   else
 #endif
     {
-      tun_net_receive_tun(priv);
+      tun_net_receive_tun(queue);
     }
 }
 
@@ -443,7 +544,7 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
  *   An interrupt was received indicating the availability of a new RX packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - The queue the packet was written to
  *
  * Returned Value:
  *   None
@@ -454,8 +555,9 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
  ****************************************************************************/
 
 #ifdef CONFIG_NET_ETHERNET
-static void tun_net_receive_tap(FAR struct tun_device_s *priv)
+static void tun_net_receive_tap(FAR struct tun_queue_s *queue)
 {
+  FAR struct tun_device_s *priv = queue->priv;
   FAR struct net_driver_s *dev = &priv->dev;
 
   /* Copy the data data from the hardware to priv->dev.d_buf.  Set amount of
@@ -515,13 +617,9 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
 
   if (priv->dev.d_len > 0)
     {
-      /* And send the packet */
+      /* And send the packet back on the queue it came from */
 
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = priv->dev.d_len;
-      priv->write_buf   = priv->dev.d_iob;
-      netdev_iob_clear(&priv->dev);
-      tun_fd_transmit(priv);
+      tun_fd_transmit(queue);
     }
 }
 #endif
@@ -534,7 +632,7 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
  *   packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - The queue the packet was written to
  *
  * Returned Value:
  *   None
@@ -544,9 +642,9 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
  *
  ****************************************************************************/
 
-static void tun_net_receive_tun(FAR struct tun_device_s *priv)
+static void tun_net_receive_tun(FAR struct tun_queue_s *queue)
 {
-  FAR struct net_driver_s *dev = &priv->dev;
+  FAR struct net_driver_s *dev = &queue->priv->dev;
 
   /* Copy the data data from the hardware to dev->d_buf.  Set amount of
    * data in dev->d_len
@@ -597,11 +695,7 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
 
   if (dev->d_len > 0)
     {
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = dev->d_len;
-      priv->write_buf   = dev->d_iob;
-      netdev_iob_clear(dev);
-      tun_fd_transmit(priv);
+      tun_fd_transmit(queue);
     }
 }
 
@@ -630,7 +724,10 @@ static void tun_txdone(FAR struct tun_device_s *priv)
 
   /* Then poll the network for new XMIT data */
 
-  devif_poll(&priv->dev, tun_txpoll);
+  if (priv->bifup && tun_txroom(priv))
+    {
+      devif_poll(&priv->dev, tun_txpoll);
+    }
 }
 
 /****************************************************************************
@@ -736,9 +833,9 @@ static void tun_txavail_work(FAR void *arg)
       return;
     }
 
-  /* Check if there is room to hold another network packet. */
+  /* Check if every queue has room to hold another network packet. */
 
-  if (priv->read_d_len != 0)
+  if (!tun_txroom(priv))
     {
       nxmutex_unlock(&priv->lock);
       return;
@@ -851,189 +948,294 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 #endif
 
 /****************************************************************************
- * Name: tun_dev_init
+ * Name: tun_copyin
  *
  * Description:
- *   Initialize the TUN device
- *
- * Input Parameters:
- *
- * Returned Value:
- *   OK on success; Negated errno on failure.
- *
- * Assumptions:
+ *   Gather len bytes of the user I/O vector, starting offset bytes into it,
+ *   into an IOB chain at iobofs.
  *
  ****************************************************************************/
 
-static int tun_dev_init(FAR struct tun_device_s *priv,
-                        FAR struct file *filep,
-                        FAR const char *devfmt, bool tun)
+static int tun_copyin(FAR struct iob_s *iob, FAR struct uio *uio,
+                      size_t offset, size_t len, int iobofs)
 {
+  FAR const struct iovec *iov = uio->uio_iov;
   int ret;
 
-  /* Initialize the driver structure */
-
-  memset(priv, 0, sizeof(struct tun_device_s));
-  priv->dev.d_ifup    = tun_ifup;     /* I/F up (new IP address) callback */
-  priv->dev.d_ifdown  = tun_ifdown;   /* I/F down callback */
-  priv->dev.d_txavail = tun_txavail;  /* New TX data callback */
-#ifdef CONFIG_NET_MCASTGROUP
-  priv->dev.d_addmac  = tun_addmac;   /* Add multicast MAC address */
-  priv->dev.d_rmmac   = tun_rmmac;    /* Remove multicast MAC address */
-#endif
-  priv->dev.d_private = priv;         /* Used to recover private state from dev */
-
-  /* Initialize the mutual exclusion and wait semaphore */
-
-  nxmutex_init(&priv->lock);
-  nxsem_init(&priv->read_wait_sem, 0, 0);
-  nxsem_init(&priv->write_wait_sem, 0, 0);
-
-  /* Assign d_ifname if specified. */
-
-  if (devfmt)
+  offset += uio->uio_offset_in_iov;
+  while (offset > iov->iov_len)
     {
-      strlcpy(priv->dev.d_ifname, devfmt, IFNAMSIZ);
+      offset -= iov->iov_len;
+      iov++;
     }
 
-  /* Register the device with the OS so that socket IOCTLs can be performed */
-
-  ret = netdev_register(&priv->dev, tun ? NET_LL_TUN : NET_LL_ETHERNET);
-  if (ret != OK)
+  while (len > 0)
     {
-      nxmutex_destroy(&priv->lock);
-      nxsem_destroy(&priv->read_wait_sem);
-      nxsem_destroy(&priv->write_wait_sem);
-      return ret;
+      size_t blen = MIN(len, iov->iov_len - offset);
+
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)iov->iov_base + offset,
+                          blen, iobofs, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      iobofs += blen;
+      len    -= blen;
+      iov++;
+      offset  = 0;
     }
 
-  filep->f_priv = priv; /* Set link to TUN device */
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
- * Name: tun_dev_uninit
+ * Name: tun_copyout
+ *
+ * Description:
+ *   Scatter len bytes of an IOB chain, from iobofs, into the user I/O
+ *   vector, starting offset bytes into it.
+ *
  ****************************************************************************/
 
-static void tun_dev_uninit(FAR struct tun_device_s *priv)
+static void tun_copyout(FAR struct uio *uio, size_t offset,
+                        FAR struct iob_s *iob, size_t len, int iobofs)
 {
-  /* Put the interface in the down state */
+  FAR const struct iovec *iov = uio->uio_iov;
 
-  tun_ifdown(&priv->dev);
-
-  work_cancel_sync(TUNWORK, &priv->work);
+  offset += uio->uio_offset_in_iov;
+  while (offset > iov->iov_len)
+    {
+      offset -= iov->iov_len;
+      iov++;
+    }
 
-  /* Remove the device from the OS */
+  while (len > 0)
+    {
+      size_t blen = MIN(len, iov->iov_len - offset);
 
-  netdev_unregister(&priv->dev);
+      iob_copyout((FAR uint8_t *)iov->iov_base + offset, iob, blen, iobofs);
 
-  nxmutex_destroy(&priv->lock);
-  nxsem_destroy(&priv->read_wait_sem);
-  nxsem_destroy(&priv->write_wait_sem);
+      iobofs += blen;
+      len    -= blen;
+      iov++;
+      offset  = 0;
+    }
 }
 
 /****************************************************************************
- * Name: tun_close
+ * Name: tun_vnet_get
+ *
+ * Description:
+ *   Describe the checksum of an outgoing packet that the network left for
+ *   the device to complete in the virtio-net header read in front of it.
+ *
  ****************************************************************************/
 
-static int tun_close(FAR struct file *filep)
+static void tun_vnet_get(FAR struct tun_device_s *priv,
+                         FAR struct iob_s *iob,
+                         FAR struct tun_vnet_hdr_s *hdr)
 {
-  FAR struct inode *inode       = filep->f_inode;
-  FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
-  int intf;
-  int ret;
+  memset(hdr, 0, sizeof(*hdr));
 
-  if (priv == NULL)
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if ((iob->io_flags & NETDEV_CSUM_PARTIAL) != 0)
     {
-      return OK;
-    }
+      FAR uint8_t *l3 = IOB_DATA(iob);
+      uint16_t iphdrlen = 0;
+      uint8_t proto = 0;
 
-  intf = priv - g_tun_devices;
-  ret  = nxmutex_lock(&tun->lock);
-  if (ret >= 0)
-    {
-      tun->free_tuns |= (1 << intf);
-      tun_dev_uninit(priv);
+#  ifdef CONFIG_NET_IPv6
+      if ((l3[0] >> 4) == 6)
+        {
+          iphdrlen = IPv6_HDRLEN;
+          proto    = ((FAR struct ipv6_hdr_s *)l3)->proto;
+        }
+#  endif
 
-      nxmutex_unlock(&tun->lock);
-    }
+#  ifdef CONFIG_NET_IPv4
+      if ((l3[0] >> 4) == 4)
+        {
+          iphdrlen = (l3[0] & IPv4_HLMASK) << 2;
+          proto    = ((FAR struct ipv4_hdr_s *)l3)->proto;
+        }
+#  endif
 
-  return ret;
+      /* Only a TCP or UDP packet has a partial checksum, the flag stays
+       * with a buffer that the network reused for another packet.
+       */
+
+      hdr->csum_start = NET_LL_HDRLEN(&priv->dev) + iphdrlen;
+      switch (proto)
+        {
+#  ifdef CONFIG_NET_TCP
+          case IP_PROTO_TCP:
+            hdr->flags       = TUN_VNET_HDR_F_NEEDS_CSUM;
+            hdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+            break;
+#  endif
+
+#  ifdef CONFIG_NET_UDP
+          case IP_PROTO_UDP:
+            hdr->flags       = TUN_VNET_HDR_F_NEEDS_CSUM;
+            hdr->csum_offset = offsetof(struct udp_hdr_s, udpchksum);
+            break;
+#  endif
+
+          default:
+            hdr->csum_start = 0;
+            break;
+        }
+    }
+#endif
 }
 
 /****************************************************************************
- * Name: tun_write
+ * Name: tun_vnet_set
+ *
+ * Description:
+ *   Apply the virtio-net header written in front of an incoming packet.
+ *   A partial checksum is completed here, the packet may be forwarded to a
+ *   device that does not do it.
+ *
  ****************************************************************************/
 
-static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static int tun_vnet_set(FAR struct tun_device_s *priv, FAR struct iob_s *iob,
+                        FAR const struct tun_vnet_hdr_s *hdr, size_t len)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
-  uint8_t llhdrlen;
-  ssize_t ret;
+  uint8_t llhdrlen = NET_LL_HDRLEN(&priv->dev);
+  uint16_t sum;
+  int ret;
 
-  if (priv == NULL || buflen > CONFIG_NET_TUN_PKTSIZE)
+  if (hdr->gso_type != TUN_VNET_HDR_GSO_NONE)
     {
       return -EINVAL;
     }
 
-  llhdrlen = NET_LL_HDRLEN(&priv->dev);
-
-  for (; ; )
+  if ((hdr->flags & TUN_VNET_HDR_F_NEEDS_CSUM) != 0)
     {
-      /* Write must return immediately if interrupted by a signal (or if the
-       * thread is canceled) and no data has yet been written.
-       */
-
-      ret = nxmutex_lock(&priv->lock);
-      if (ret < 0)
+      if (hdr->csum_start < llhdrlen ||
+          hdr->csum_start + hdr->csum_offset + 2 > len)
         {
-          return ret;
+          return -EINVAL;
         }
 
-      /* Check if there are free space to write */
+      /* The field holds the sum of the pseudo header already */
 
-      if (priv->write_d_len == 0)
+      sum = ~chksum_iob(0, iob, hdr->csum_start - llhdrlen);
+      if (sum == 0)
         {
-          net_lock();
-          netdev_iob_release(&priv->dev);
-          ret = netdev_iob_prepare(&priv->dev, false, 0);
-          priv->dev.d_buf = NULL;
-          if (ret < 0)
-            {
-              net_unlock();
-              break;
-            }
+          sum = 0xffff;
+        }
+
+      sum = HTONS(sum);
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)&sum, sizeof(sum),
+                          hdr->csum_start + hdr->csum_offset - llhdrlen,
+                          false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
 
-          ret = iob_trycopyin(priv->dev.d_iob, (FAR const uint8_t *)buffer,
-                              buflen, -llhdrlen, false);
-          if (ret < 0)
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if ((hdr->flags & (TUN_VNET_HDR_F_NEEDS_CSUM |
+                     TUN_VNET_HDR_F_DATA_VALID)) != 0)
+    {
+      iob->io_flags |= NETDEV_CSUM_VALID;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tun_queue_read
+ *
+ * Description:
+ *   Read the oldest packet of a queue into a user I/O vector.
+ *
+ ****************************************************************************/
+
+static ssize_t tun_queue_read(FAR struct tun_queue_s *queue,
+                              FAR struct uio *uio, bool nonblock)
+{
+  FAR struct tun_device_s *priv = queue->priv;
+  FAR struct tun_pkt_s *pkt;
+  FAR struct iob_s *iob;
+  size_t hdrlen;
+  uint8_t llhdrlen;
+  size_t len;
+  ssize_t ret;
+
+  hdrlen   = priv->vnet_hdr ? sizeof(struct tun_vnet_hdr_s) : 0;
+  llhdrlen = NET_LL_HDRLEN(&priv->dev);
+
+  for (; ; )
+    {
+      /* Read must return immediately if interrupted by a signal (or if the
+       * thread is canceled) and no data has yet been read.
+       */
+
+      ret = nxmutex_lock(&priv->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Check if there are data to read */
+
+      if (queue->count > 0)
+        {
+          pkt = &queue->pkts[queue->head];
+          if (uio->uio_resid < hdrlen + pkt->len)
             {
-              net_unlock();
+              ret = -EINVAL;
               break;
             }
 
-          priv->dev.d_len = buflen;
+          iob = pkt->iob;
+          len = pkt->len;
+
+          pkt->iob     = NULL;
+          queue->head  = (queue->head + 1) % CONFIG_NET_TUN_QUEUE_DEPTH;
+          queue->count--;
 
-          tun_net_receive(priv);
+          /* The room may let the network send more, copy the packet out
+           * without holding the device then.
+           */
+
+          tun_pollnotify(queue, POLLOUT);
+
+          net_lock();
+          tun_txdone(priv);
           net_unlock();
+          nxmutex_unlock(&priv->lock);
 
-          ret = buflen;
-          break;
+          if (hdrlen > 0)
+            {
+              struct tun_vnet_hdr_s hdr;
+
+              tun_vnet_get(priv, iob, &hdr);
+              uio_copyfrom(uio, 0, &hdr, hdrlen);
+            }
+
+          tun_copyout(uio, hdrlen, iob, len, -llhdrlen);
+          iob_free_chain(iob);
+          return hdrlen + len;
         }
 
-      /* Wait if there are no free space to write */
+      /* Wait if there are no data to read */
 
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+      if (nonblock)
         {
           ret = -EAGAIN;
           break;
         }
 
-      priv->write_wait = true;
+      queue->read_wait = true;
       nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->write_wait_sem);
+      nxsem_wait(&queue->read_wait_sem);
     }
 
   nxmutex_unlock(&priv->lock);
@@ -1041,97 +1243,473 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 }
 
 /****************************************************************************
- * Name: tun_read
+ * Name: tun_queue_write
+ *
+ * Description:
+ *   Write one packet from a user I/O vector to the network.
+ *
  ****************************************************************************/
 
-static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static ssize_t tun_queue_write(FAR struct tun_queue_s *queue,
+                               FAR struct uio *uio, bool nonblock)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_device_s *priv = queue->priv;
+  FAR struct iob_s *iob;
+  size_t hdrlen;
   uint8_t llhdrlen;
+  size_t len;
   ssize_t ret;
 
-  if (priv == NULL)
+  hdrlen   = priv->vnet_hdr ? sizeof(struct tun_vnet_hdr_s) : 0;
+  llhdrlen = NET_LL_HDRLEN(&priv->dev);
+  len      = uio->uio_resid;
+
+  if (len < hdrlen + llhdrlen || len - hdrlen > CONFIG_NET_TUN_PKTSIZE)
     {
       return -EINVAL;
     }
 
-  llhdrlen = NET_LL_HDRLEN(&priv->dev);
+  len -= hdrlen;
+
+  /* Copy the packet in before taking the device, the queues of an
+   * interface can do that in parallel.
+   */
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE);
+
+  ret = tun_copyin(iob, uio, hdrlen, len, -llhdrlen);
+  if (ret >= 0 && hdrlen > 0)
+    {
+      struct tun_vnet_hdr_s hdr;
+
+      uio_copyto(uio, 0, &hdr, hdrlen);
+      ret = tun_vnet_set(priv, iob, &hdr, len);
+    }
+
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
 
   for (; ; )
     {
-      /* Read must return immediately if interrupted by a signal (or if the
-       * thread is canceled) and no data has yet been read.
+      /* Write must return immediately if interrupted by a signal (or if the
+       * thread is canceled) and no data has yet been written.
        */
 
       ret = nxmutex_lock(&priv->lock);
       if (ret < 0)
         {
+          iob_free_chain(iob);
           return ret;
         }
 
-      /* Check if there are data to read in write buffer */
+      /* Check if there is room for the reply to the packet */
 
-      if (priv->write_d_len > 0)
+      if (queue->count < CONFIG_NET_TUN_QUEUE_DEPTH)
         {
-          if (buflen < priv->write_d_len)
-            {
-              ret = -EINVAL;
-              break;
-            }
+          net_lock();
+          netdev_iob_replace(&priv->dev, iob);
+          priv->dev.d_buf = NULL;
+          priv->dev.d_len = len;
+
+          tun_net_receive(queue);
+          net_unlock();
 
-          iob_copyout((FAR uint8_t *)buffer, priv->write_buf,
-                      priv->write_d_len, -llhdrlen);
-          ret = priv->write_d_len;
+          ret = hdrlen + len;
+          break;
+        }
 
-          iob_free_chain(priv->write_buf);
-          priv->write_buf   = NULL;
-          priv->write_d_len = 0;
+      /* Wait if there are no free space to write */
 
-          NETDEV_TXDONE(&priv->dev);
-          tun_pollnotify(priv, POLLOUT);
+      if (nonblock)
+        {
+          iob_free_chain(iob);
+          ret = -EAGAIN;
           break;
         }
 
-      /* Check if there are data to read in read buffer */
+      queue->write_wait = true;
+      nxmutex_unlock(&priv->lock);
+      nxsem_wait(&queue->write_wait_sem);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tun_queue_attach
+ *
+ * Description:
+ *   Attach an open file to a free queue of the interface.
+ *
+ ****************************************************************************/
+
+static int tun_queue_attach(FAR struct tun_device_s *priv,
+                            FAR struct file *filep)
+{
+  FAR struct tun_queue_s *queue;
+  int ret;
+  int i;
 
-      if (priv->read_d_len > 0)
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      queue = &priv->queue[i];
+      if (!queue->attached)
         {
-          if (buflen < priv->read_d_len)
-            {
-              ret = -EINVAL;
-              break;
-            }
+          memset(queue, 0, sizeof(*queue));
+          queue->priv     = priv;
+          queue->attached = true;
+          nxsem_init(&queue->read_wait_sem, 0, 0);
+          nxsem_init(&queue->write_wait_sem, 0, 0);
+
+          priv->nqueues++;
+          filep->f_priv = queue;
+          break;
+        }
+    }
 
-          iob_copyout((FAR uint8_t *)buffer, priv->read_buf,
-                      priv->read_d_len, -llhdrlen);
-          ret = priv->read_d_len;
+  nxmutex_unlock(&priv->lock);
+  return i < CONFIG_NET_TUN_NQUEUES ? OK : -EBUSY;
+}
 
-          iob_free_chain(priv->read_buf);
-          priv->read_buf   = NULL;
-          priv->read_d_len = 0;
+/****************************************************************************
+ * Name: tun_queue_detach
+ *
+ * Description:
+ *   Detach a queue from its interface and drop the packets on it.
+ *
+ * Returned Value:
+ *   true if it was the last queue of the interface.
+ *
+ ****************************************************************************/
 
-          net_lock();
-          tun_txdone(priv);
-          net_unlock();
+static bool tun_queue_detach(FAR struct tun_queue_s *queue)
+{
+  FAR struct tun_device_s *priv = queue->priv;
+  bool last;
+
+  nxmutex_lock(&priv->lock);
+
+  while (queue->count > 0)
+    {
+      iob_free_chain(queue->pkts[queue->head].iob);
+      queue->head = (queue->head + 1) % CONFIG_NET_TUN_QUEUE_DEPTH;
+      queue->count--;
+    }
+
+  nxsem_destroy(&queue->read_wait_sem);
+  nxsem_destroy(&queue->write_wait_sem);
+  queue->attached = false;
+  last = --priv->nqueues == 0;
+
+  /* The other queues may take the packets that waited for this one */
+
+  if (!last)
+    {
+      tun_txavail(&priv->dev);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return last;
+}
+
+/****************************************************************************
+ * Name: tun_dev_init
+ *
+ * Description:
+ *   Initialize the TUN device
+ *
+ * Input Parameters:
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static int tun_dev_init(FAR struct tun_device_s *priv,
+                        FAR struct file *filep,
+                        FAR const char *devfmt, int flags)
+{
+  bool tun = (flags & IFF_MASK) == IFF_TUN;
+  int ret;
+
+  /* Initialize the driver structure */
+
+  memset(priv, 0, sizeof(struct tun_device_s));
+  priv->dev.d_ifup    = tun_ifup;     /* I/F up (new IP address) callback */
+  priv->dev.d_ifdown  = tun_ifdown;   /* I/F down callback */
+  priv->dev.d_txavail = tun_txavail;  /* New TX data callback */
+#ifdef CONFIG_NET_MCASTGROUP
+  priv->dev.d_addmac  = tun_addmac;   /* Add multicast MAC address */
+  priv->dev.d_rmmac   = tun_rmmac;    /* Remove multicast MAC address */
+#endif
+  priv->dev.d_private = priv;         /* Used to recover private state from dev */
+
+  priv->multiq = (flags & IFF_MULTI_QUEUE) != 0;
+  priv->vnet_hdr    = (flags & IFF_VNET_HDR) != 0;
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* The reader of the virtio-net header completes and verifies checksums */
+
+  if (priv->vnet_hdr)
+    {
+      priv->dev.d_csumcaps = NETDEV_CSUM_PARTIAL | NETDEV_CSUM_VALID;
+    }
+#endif
+
+  /* Initialize the mutual exclusion and the first queue */
+
+  nxmutex_init(&priv->lock);
+  tun_queue_attach(priv, filep);
+
+  /* Assign d_ifname if specified. */
+
+  if (devfmt)
+    {
+      strlcpy(priv->dev.d_ifname, devfmt, IFNAMSIZ);
+    }
+
+  /* Register the device with the OS so that socket IOCTLs can be performed */
+
+  ret = netdev_register(&priv->dev, tun ? NET_LL_TUN : NET_LL_ETHERNET);
+  if (ret != OK)
+    {
+      tun_queue_detach(filep->f_priv);
+      filep->f_priv = NULL;
+      nxmutex_destroy(&priv->lock);
+      return ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tun_dev_uninit
+ ****************************************************************************/
+
+static void tun_dev_uninit(FAR struct tun_device_s *priv)
+{
+  /* Put the interface in the down state */
+
+  tun_ifdown(&priv->dev);
+
+  work_cancel_sync(TUNWORK, &priv->work);
+
+  /* Remove the device from the OS */
+
+  netdev_unregister(&priv->dev);
+
+  nxmutex_destroy(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: tun_find
+ *
+ * Description:
+ *   Find the interface with IFF_MULTI_QUEUE that a TUNSETIFF names.
+ *
+ ****************************************************************************/
+
+static FAR struct tun_device_s *tun_find(FAR struct tun_driver_s *tun,
+                                         FAR const char *name)
+{
+  int intf;
+
+  for (intf = 0; intf < CONFIG_TUN_NINTERFACES; intf++)
+    {
+      FAR struct tun_device_s *priv = &g_tun_devices[intf];
+
+      if ((tun->free_tuns & (1 << intf)) == 0 && priv->multiq &&
+          strncmp(priv->dev.d_ifname, name, IFNAMSIZ) == 0)
+        {
+          return priv;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tun_close
+ ****************************************************************************/
+
+static int tun_close(FAR struct file *filep)
+{
+  FAR struct inode *inode        = filep->f_inode;
+  FAR struct tun_driver_s *tun   = inode->i_private;
+  FAR struct tun_queue_s *queue  = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  int intf;
+  int ret;
+
+  if (queue == NULL)
+    {
+      return OK;
+    }
+
+  priv = queue->priv;
+  intf = priv - g_tun_devices;
+  ret  = nxmutex_lock(&tun->lock);
+  if (ret >= 0)
+    {
+      if (tun_queue_detach(queue))
+        {
+          tun->free_tuns |= (1 << intf);
+          tun_dev_uninit(priv);
+        }
+
+      nxmutex_unlock(&tun->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tun_write
+ ****************************************************************************/
+
+static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = buflen;
+  uio_init(&uio, &iov, 1);
+
+  return tun_writev(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: tun_writev
+ *
+ * Description:
+ *   Write one packet, gathered from the I/O vector.
+ *
+ ****************************************************************************/
+
+static ssize_t tun_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR struct tun_queue_s *queue = filep->f_priv;
+
+  if (queue == NULL)
+    {
+      return -EINVAL;
+    }
+
+  return tun_queue_write(queue, uio, (filep->f_oflags & O_NONBLOCK) != 0);
+}
+
+/****************************************************************************
+ * Name: tun_read
+ ****************************************************************************/
+
+static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = buflen;
+  uio_init(&uio, &iov, 1);
+
+  return tun_readv(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: tun_readv
+ *
+ * Description:
+ *   Read one packet, scattered over the I/O vector.
+ *
+ ****************************************************************************/
+
+static ssize_t tun_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR struct tun_queue_s *queue = filep->f_priv;
+
+  if (queue == NULL)
+    {
+      return -EINVAL;
+    }
+
+  return tun_queue_read(queue, uio, (filep->f_oflags & O_NONBLOCK) != 0);
+}
+
+/****************************************************************************
+ * Name: tun_batch
+ *
+ * Description:
+ *   Read or write up to batch->npkts packets, one per buffer.  Only the
+ *   first packet waits, the batch ends when the queue would block.
+ *
+ ****************************************************************************/
+
+static int tun_batch(FAR struct file *filep, FAR struct tun_batch_s *batch,
+                     bool write)
+{
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  bool nonblock = (filep->f_oflags & O_NONBLOCK) != 0;
+  struct uio uio;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  if (queue == NULL || batch == NULL || batch->pkts == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < batch->npkts; i++)
+    {
+      ret = uio_init(&uio, &batch->pkts[i], 1);
+      if (ret < 0)
+        {
           break;
         }
 
-      /* Wait if there are no data to read */
+      if (write)
+        {
+          ret = tun_queue_write(queue, &uio, nonblock || i > 0);
+        }
+      else
+        {
+          ret = tun_queue_read(queue, &uio, nonblock || i > 0);
+        }
 
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+      if (ret < 0)
         {
-          ret = -EAGAIN;
           break;
         }
 
-      priv->read_wait = true;
-      nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->read_wait_sem);
+      batch->pkts[i].iov_len = ret;
     }
 
-  nxmutex_unlock(&priv->lock);
-  return ret;
+  if (i == 0 && batch->npkts > 0)
+    {
+      return ret;
+    }
+
+  batch->npkts = i;
+  return OK;
 }
 
 /****************************************************************************
@@ -1141,17 +1719,19 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 static int tun_poll(FAR struct file *filep,
                     FAR struct pollfd *fds, bool setup)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   pollevent_t eventset;
   int ret;
 
   /* Some sanity checking */
 
-  if (priv == NULL || fds == NULL)
+  if (queue == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
+  priv = queue->priv;
   ret = nxmutex_lock(&priv->lock);
   if (ret < 0)
     {
@@ -1160,28 +1740,24 @@ static int tun_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (priv->poll_fds)
+      if (queue->poll_fds)
         {
           ret = -EBUSY;
           goto errout;
         }
 
-      priv->poll_fds = fds;
+      queue->poll_fds = fds;
 
       eventset = 0;
 
-      /* If write buffer is empty notify App.  */
+      /* If there is room for a packet and its reply, notify App. */
 
-      if (priv->write_d_len == 0)
+      if (queue->count < CONFIG_NET_TUN_QUEUE_DEPTH)
         {
           eventset |= POLLOUT;
         }
 
-      /* The write buffer sometimes could be used for TX.
-       * So check it too.
-       */
-
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (queue->count > 0)
         {
           eventset |= POLLIN;
         }
@@ -1190,7 +1766,7 @@ static int tun_poll(FAR struct file *filep,
     }
   else
     {
-      priv->poll_fds = NULL;
+      queue->poll_fds = NULL;
     }
 
 errout:
@@ -1204,18 +1780,19 @@ errout:
 
 static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
-  FAR struct inode *inode       = filep->f_inode;
-  FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct inode *inode        = filep->f_inode;
+  FAR struct tun_driver_s *tun   = inode->i_private;
+  FAR struct tun_queue_s *queue  = filep->f_priv;
   int ret = OK;
 
   if (cmd == TUNSETIFF)
     {
+      FAR struct tun_device_s *priv;
       uint8_t free_tuns;
       int intf;
       FAR struct ifreq *ifr = (FAR struct ifreq *)arg;
 
-      if (priv != NULL || ifr == NULL ||
+      if (queue != NULL || ifr == NULL ||
          ((ifr->ifr_flags & IFF_MASK) != IFF_TUN &&
           (ifr->ifr_flags & IFF_MASK) != IFF_TAP))
         {
@@ -1228,6 +1805,31 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           return ret;
         }
 
+      /* Attach another queue to a multi-queue interface of that name */
+
+      priv = NULL;
+      if ((ifr->ifr_flags & IFF_MULTI_QUEUE) != 0 && *ifr->ifr_name)
+        {
+          priv = tun_find(tun, ifr->ifr_name);
+        }
+
+      if (priv != NULL)
+        {
+          if (priv->vnet_hdr != ((ifr->ifr_flags & IFF_VNET_HDR) != 0) ||
+              (priv->dev.d_lltype == NET_LL_TUN) !=
+              ((ifr->ifr_flags & IFF_MASK) == IFF_TUN))
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = tun_queue_attach(priv, filep);
+            }
+
+          nxmutex_unlock(&tun->lock);
+          return ret;
+        }
+
       free_tuns = tun->free_tuns;
 
       if (free_tuns == 0)
@@ -1242,7 +1844,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = tun_dev_init(&g_tun_devices[intf], filep,
                          *ifr->ifr_name ? ifr->ifr_name : NULL,
-                         (ifr->ifr_flags & IFF_MASK) == IFF_TUN);
+                         ifr->ifr_flags);
       if (ret != OK)
         {
           nxmutex_unlock(&tun->lock);
@@ -1251,8 +1853,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tun->free_tuns &= ~(1 << intf);
 
-      priv = filep->f_priv;
-      strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
+      strlcpy(ifr->ifr_name, g_tun_devices[intf].dev.d_ifname, IFNAMSIZ);
       nxmutex_unlock(&tun->lock);
 
       return OK;
@@ -1260,33 +1861,38 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   else if (cmd == TUNGETIFF)
     {
       FAR struct ifreq *ifr = (FAR struct ifreq *)arg;
-      if (priv == NULL || ifr == NULL)
+      if (queue == NULL || ifr == NULL)
         {
           return -EINVAL;
         }
 
-      strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
+      strlcpy(ifr->ifr_name, queue->priv->dev.d_ifname, IFNAMSIZ);
 
       return OK;
     }
   else if (cmd == TUNSETCARRIER)
     {
-      if (priv == NULL || arg == 0)
+      if (queue == NULL || arg == 0)
         {
           return -EINVAL;
         }
 
       if (*(FAR int *)((uintptr_t)arg))
         {
-          netdev_carrier_on(&priv->dev);
+          netdev_carrier_on(&queue->priv->dev);
         }
       else
         {
-          netdev_carrier_off(&priv->dev);
+          netdev_carrier_off(&queue->priv->dev);
         }
 
       return OK;
     }
+  else if (cmd == TUNREADBATCH || cmd == TUNWRITEBATCH)
+    {
+      return tun_batch(filep, (FAR struct tun_batch_s *)((uintptr_t)arg),
+                       cmd == TUNWRITEBATCH);
+    }
 
   return -ENOTTY;
 }
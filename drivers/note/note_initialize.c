@@ -28,8 +28,10 @@
 
 #include <nuttx/instrument.h>
 #include <nuttx/note/note_driver.h>
+#include <nuttx/note/notectf_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
+#include <nuttx/note/noteheap_driver.h>
 #include <nuttx/note/notesnap_driver.h>
 #include <nuttx/note/notestream_driver.h>
 #include <nuttx/segger/note_rtt.h>
@@ -123,6 +125,15 @@ int note_early_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTEHEAP
+  ret = noteheap_register();
+  if (ret < 0)
+    {
+      serr("noteheap_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
   return ret;
 }
 
@@ -158,6 +169,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTECTF
+  ret = notectf_register();
+  if (ret < 0)
+    {
+      serr("notectf_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_NOTEFILE
   ret = notefile_register(CONFIG_DRIVERS_NOTEFILE_PATH);
   if (ret < 0)
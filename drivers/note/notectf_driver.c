@@ -0,0 +1,499 @@
+/****************************************************************************
+ * drivers/note/notectf_driver.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/note/notectf_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NOTECTF_UNSIGNED  0
+#define NOTECTF_SIGNED    1
+#define NOTECTF_CLOCK     2
+
+#define NOTECTF_FIELD(t, m, name, kind) \
+  { name, offsetof(struct t, m), sizeof(((FAR struct t *)0)->m), kind }
+
+#define NOTECTF_END(t, m) \
+  (offsetof(struct t, m) + sizeof(((FAR struct t *)0)->m))
+
+#define NOTECTF_EVENT(name, fields, end) \
+  { name, fields, nitems(fields), end }
+
+#define NOTECTF_EVENT0(name) \
+  { name, NULL, 0, sizeof(struct note_common_s) }
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notectf_field_s
+{
+  FAR const char *name;
+  uint8_t offset;
+  uint8_t size;
+  uint8_t kind;
+};
+
+struct notectf_event_s
+{
+  FAR const char *name;
+  FAR const struct notectf_field_s *fields;
+  uint8_t nfields;
+  uint8_t end;                  /* End of the named fields in the note */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int notectf_open(FAR struct file *filep);
+static int notectf_close(FAR struct file *filep);
+static ssize_t notectf_read(FAR struct file *filep,
+                            FAR char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_notectf_fops =
+{
+  notectf_open,  /* open */
+  notectf_close, /* close */
+  notectf_read,  /* read */
+};
+
+/* The common note header is the CTF event header, nc_type is the event
+ * id and nc_systime the timestamp.
+ */
+
+static const struct notectf_field_s g_notectf_header[] =
+{
+  NOTECTF_FIELD(note_common_s, nc_length, "length", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_common_s, nc_type, "id", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_common_s, nc_priority, "priority", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_common_s, nc_cpu, "cpu", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_common_s, nc_pid, "pid", NOTECTF_SIGNED),
+  NOTECTF_FIELD(note_common_s, nc_systime, "timestamp", NOTECTF_CLOCK),
+};
+
+static const struct notectf_field_s g_notectf_suspend[] =
+{
+  NOTECTF_FIELD(note_suspend_s, nsu_state, "state", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_cpu_start[] =
+{
+  NOTECTF_FIELD(note_cpu_start_s, ncs_target, "target", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_cpu_pause[] =
+{
+  NOTECTF_FIELD(note_cpu_pause_s, ncp_target, "target", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_cpu_resume[] =
+{
+  NOTECTF_FIELD(note_cpu_resume_s, ncr_target, "target", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_preempt[] =
+{
+  NOTECTF_FIELD(note_preempt_s, npr_count, "count", NOTECTF_UNSIGNED),
+};
+
+#ifdef CONFIG_SMP
+static const struct notectf_field_s g_notectf_csection[] =
+{
+  NOTECTF_FIELD(note_csection_s, ncs_count, "count", NOTECTF_UNSIGNED),
+};
+#endif
+
+static const struct notectf_field_s g_notectf_spinlock[] =
+{
+  NOTECTF_FIELD(note_spinlock_s, nsp_spinlock, "lock", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_spinlock_s, nsp_value, "value", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_syscall_enter[] =
+{
+  NOTECTF_FIELD(note_syscall_enter_s, nsc_nr, "nr", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_syscall_enter_s, nsc_argc, "argc", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_syscall_leave[] =
+{
+  NOTECTF_FIELD(note_syscall_leave_s, nsc_nr, "nr", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_syscall_leave_s, nsc_result, "result",
+                NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_irqhandler[] =
+{
+  NOTECTF_FIELD(note_irqhandler_s, nih_handler, "handler",
+                NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_irqhandler_s, nih_irq, "irq", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_wdog[] =
+{
+  NOTECTF_FIELD(note_wdog_s, handler, "handler", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_wdog_s, arg, "arg", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_heap[] =
+{
+  NOTECTF_FIELD(note_heap_s, heap, "heap", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_heap_s, mem, "mem", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_heap_s, size, "size", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_heap_s, used, "used", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_printf[] =
+{
+  NOTECTF_FIELD(note_printf_s, npt_ip, "ip", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_printf_s, npt_fmt, "fmt", NOTECTF_UNSIGNED),
+  NOTECTF_FIELD(note_printf_s, npt_type, "type", NOTECTF_UNSIGNED),
+};
+
+static const struct notectf_field_s g_notectf_event[] =
+{
+  NOTECTF_FIELD(note_event_s, nev_ip, "ip", NOTECTF_UNSIGNED),
+};
+
+/* Indexed by enum note_type_e */
+
+static const struct notectf_event_s g_notectf_events[NOTE_TYPE_LAST] =
+{
+  NOTECTF_EVENT0("task_start"),
+  NOTECTF_EVENT0("task_stop"),
+  NOTECTF_EVENT("task_suspend", g_notectf_suspend,
+                NOTECTF_END(note_suspend_s, nsu_state)),
+  NOTECTF_EVENT0("task_resume"),
+  NOTECTF_EVENT("cpu_start", g_notectf_cpu_start,
+                NOTECTF_END(note_cpu_start_s, ncs_target)),
+  NOTECTF_EVENT0("cpu_started"),
+  NOTECTF_EVENT("cpu_pause", g_notectf_cpu_pause,
+                NOTECTF_END(note_cpu_pause_s, ncp_target)),
+  NOTECTF_EVENT0("cpu_paused"),
+  NOTECTF_EVENT("cpu_resume", g_notectf_cpu_resume,
+                NOTECTF_END(note_cpu_resume_s, ncr_target)),
+  NOTECTF_EVENT0("cpu_resumed"),
+  NOTECTF_EVENT("preempt_lock", g_notectf_preempt,
+                NOTECTF_END(note_preempt_s, npr_count)),
+  NOTECTF_EVENT("preempt_unlock", g_notectf_preempt,
+                NOTECTF_END(note_preempt_s, npr_count)),
+#ifdef CONFIG_SMP
+  NOTECTF_EVENT("csection_enter", g_notectf_csection,
+                NOTECTF_END(note_csection_s, ncs_count)),
+  NOTECTF_EVENT("csection_leave", g_notectf_csection,
+                NOTECTF_END(note_csection_s, ncs_count)),
+#else
+  NOTECTF_EVENT0("csection_enter"),
+  NOTECTF_EVENT0("csection_leave"),
+#endif
+  NOTECTF_EVENT("spinlock_lock", g_notectf_spinlock,
+                NOTECTF_END(note_spinlock_s, nsp_value)),
+  NOTECTF_EVENT("spinlock_locked", g_notectf_spinlock,
+                NOTECTF_END(note_spinlock_s, nsp_value)),
+  NOTECTF_EVENT("spinlock_unlock", g_notectf_spinlock,
+                NOTECTF_END(note_spinlock_s, nsp_value)),
+  NOTECTF_EVENT("spinlock_abort", g_notectf_spinlock,
+                NOTECTF_END(note_spinlock_s, nsp_value)),
+  NOTECTF_EVENT("syscall_enter", g_notectf_syscall_enter,
+                NOTECTF_END(note_syscall_enter_s, nsc_argc)),
+  NOTECTF_EVENT("syscall_leave", g_notectf_syscall_leave,
+                NOTECTF_END(note_syscall_leave_s, nsc_result)),
+  NOTECTF_EVENT("irq_enter", g_notectf_irqhandler,
+                NOTECTF_END(note_irqhandler_s, nih_irq)),
+  NOTECTF_EVENT("irq_leave", g_notectf_irqhandler,
+                NOTECTF_END(note_irqhandler_s, nih_irq)),
+  NOTECTF_EVENT("wdog_start", g_notectf_wdog,
+                NOTECTF_END(note_wdog_s, arg)),
+  NOTECTF_EVENT("wdog_cancel", g_notectf_wdog,
+                NOTECTF_END(note_wdog_s, arg)),
+  NOTECTF_EVENT("wdog_enter", g_notectf_wdog,
+                NOTECTF_END(note_wdog_s, arg)),
+  NOTECTF_EVENT("wdog_leave", g_notectf_wdog,
+                NOTECTF_END(note_wdog_s, arg)),
+  NOTECTF_EVENT("heap_add", g_notectf_heap,
+                NOTECTF_END(note_heap_s, used)),
+  NOTECTF_EVENT("heap_remove", g_notectf_heap,
+                NOTECTF_END(note_heap_s, used)),
+  NOTECTF_EVENT("heap_alloc", g_notectf_heap,
+                NOTECTF_END(note_heap_s, used)),
+  NOTECTF_EVENT("heap_free", g_notectf_heap,
+                NOTECTF_END(note_heap_s, used)),
+  NOTECTF_EVENT("printf", g_notectf_printf,
+                NOTECTF_END(note_printf_s, npt_type)),
+  NOTECTF_EVENT("begin", g_notectf_event,
+                NOTECTF_END(note_event_s, nev_ip)),
+  NOTECTF_EVENT("end", g_notectf_event,
+                NOTECTF_END(note_event_s, nev_ip)),
+  NOTECTF_EVENT("mark", g_notectf_event,
+                NOTECTF_END(note_event_s, nev_ip)),
+  NOTECTF_EVENT("counter", g_notectf_event,
+                NOTECTF_END(note_event_s, nev_ip)),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_fields
+ *
+ * Description:
+ *   Describe the bytes [start, end) of a note, padding the gaps left by
+ *   the C layout with byte arrays.
+ *
+ ****************************************************************************/
+
+static int notectf_fields(FAR struct lib_outstream_s *stream,
+                          FAR const struct notectf_field_s *fields,
+                          int nfields, size_t start, size_t end)
+{
+  int ret = 0;
+  int i;
+
+  for (i = 0; i < nfields; i++)
+    {
+      FAR const struct notectf_field_s *field = &fields[i];
+
+      if (field->offset > start)
+        {
+          ret += lib_sprintf(stream, "\t\tuint8_t _pad%d[%zu];\n",
+                             i, field->offset - start);
+        }
+
+      if (field->kind == NOTECTF_CLOCK)
+        {
+          ret += lib_sprintf(stream, "\t\tperf_clock_t %s;\n",
+                             field->name);
+        }
+      else
+        {
+          ret += lib_sprintf(stream, "\t\t%sint%d_t %s;\n",
+                             field->kind == NOTECTF_SIGNED ? "" : "u",
+                             field->size * 8, field->name);
+        }
+
+      start = field->offset + field->size;
+    }
+
+  if (end > start)
+    {
+      ret += lib_sprintf(stream, "\t\tuint8_t _pad%d[%zu];\n",
+                         i, end - start);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: notectf_open
+ ****************************************************************************/
+
+static int notectf_open(FAR struct file *filep)
+{
+  struct lib_outstream_s nullstream;
+  struct lib_memoutstream_s memstream;
+  FAR char *text;
+  ssize_t len;
+
+  /* Size the metadata first, then render it once for this open file */
+
+  lib_nulloutstream(&nullstream);
+  len = notectf_metadata(&nullstream);
+
+  text = kmm_malloc(len + 1);
+  if (text == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  lib_memoutstream(&memstream, text, len + 1);
+  notectf_metadata(&memstream.common);
+
+  filep->f_priv = text;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: notectf_close
+ ****************************************************************************/
+
+static int notectf_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: notectf_read
+ ****************************************************************************/
+
+static ssize_t notectf_read(FAR struct file *filep,
+                            FAR char *buffer, size_t buflen)
+{
+  FAR const char *text = filep->f_priv;
+  size_t len = strlen(text);
+
+  if (filep->f_pos >= len)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, len - filep->f_pos);
+  memcpy(buffer, text + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_datalen
+ ****************************************************************************/
+
+uint8_t notectf_datalen(FAR const struct note_common_s *note)
+{
+  if (note->nc_type >= NOTE_TYPE_LAST ||
+      note->nc_length < g_notectf_events[note->nc_type].end)
+    {
+      return 0;
+    }
+
+  return note->nc_length - g_notectf_events[note->nc_type].end;
+}
+
+/****************************************************************************
+ * Name: notectf_put
+ ****************************************************************************/
+
+void notectf_put(FAR struct lib_outstream_s *stream,
+                 FAR const void *note, size_t notelen)
+{
+  lib_stream_putc(stream, notectf_datalen(note));
+  lib_stream_puts(stream, note, notelen);
+}
+
+/****************************************************************************
+ * Name: notectf_metadata
+ ****************************************************************************/
+
+ssize_t notectf_metadata(FAR struct lib_outstream_s *stream)
+{
+  ssize_t ret;
+  int i;
+
+  ret = lib_sprintf(stream,
+                    "/* CTF 1.8 */\n\n"
+                    "typealias integer { size = 8; align = 8; "
+                    "signed = false; } := uint8_t;\n"
+                    "typealias integer { size = 16; align = 8; "
+                    "signed = false; } := uint16_t;\n"
+                    "typealias integer { size = 32; align = 8; "
+                    "signed = false; } := uint32_t;\n"
+                    "typealias integer { size = 64; align = 8; "
+                    "signed = false; } := uint64_t;\n"
+                    "typealias integer { size = 16; align = 8; "
+                    "signed = true; } := int16_t;\n"
+                    "typealias integer { size = 32; align = 8; "
+                    "signed = true; } := int32_t;\n"
+                    "typealias integer { size = 64; align = 8; "
+                    "signed = true; } := int64_t;\n\n"
+                    "trace {\n"
+                    "\tmajor = 1;\n"
+                    "\tminor = 8;\n"
+                    "\tbyte_order = %s;\n"
+                    "};\n\n"
+                    "env {\n"
+                    "\tsysname = \"NuttX\";\n"
+                    "};\n\n"
+                    "clock {\n"
+                    "\tname = perf;\n"
+                    "\tfreq = %lu;\n"
+                    "};\n\n"
+                    "typealias integer { size = %zu; align = 8; "
+                    "signed = false; map = clock.perf.value; } "
+                    ":= perf_clock_t;\n\n"
+                    "stream {\n"
+                    "\tevent.header := struct {\n"
+                    "\t\tuint8_t datalen;\n",
+#ifdef CONFIG_ENDIAN_BIG
+                    "be",
+#else
+                    "le",
+#endif
+                    perf_getfreq(), sizeof(clock_t) * 8);
+
+  ret += notectf_fields(stream, g_notectf_header,
+                        nitems(g_notectf_header), 0,
+                        sizeof(struct note_common_s));
+  ret += lib_sprintf(stream, "\t};\n};\n");
+
+  for (i = 0; i < NOTE_TYPE_LAST; i++)
+    {
+      FAR const struct notectf_event_s *event = &g_notectf_events[i];
+
+      ret += lib_sprintf(stream,
+                         "\nevent {\n"
+                         "\tname = \"%s\";\n"
+                         "\tid = %d;\n"
+                         "\tfields := struct {\n",
+                         event->name, i);
+      ret += notectf_fields(stream, event->fields, event->nfields,
+                            sizeof(struct note_common_s), event->end);
+      ret += lib_sprintf(stream,
+                         "\t\tuint8_t data[stream.event.header.datalen];\n"
+                         "\t};\n"
+                         "};\n");
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: notectf_register
+ ****************************************************************************/
+
+int notectf_register(void)
+{
+  return register_driver("/dev/note/metadata", &g_notectf_fops, 0444, NULL);
+}
@@ -0,0 +1,808 @@
+/****************************************************************************
+ * drivers/note/noteheap_driver.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mutex.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/noteheap_driver.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NOTEHEAP_NRECORDS CONFIG_DRIVERS_NOTEHEAP_NRECORDS
+#define NOTEHEAP_NSAMPLES CONFIG_DRIVERS_NOTEHEAP_SAMPLES
+#define NOTEHEAP_NTHREADS CONFIG_DRIVERS_NOTEHEAP_THREADS
+
+/* The name of the heap manager of this build */
+
+#if defined(CONFIG_MM_TLSF_MANAGER)
+#  define NOTEHEAP_MANAGER "tlsf"
+#elif defined(CONFIG_MM_CUSTOMIZE_MANAGER)
+#  define NOTEHEAP_MANAGER "custom"
+#else
+#  define NOTEHEAP_MANAGER "mm_heap"
+#endif
+
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
+#  define NOTEHEAP_NALLOCATORS 2
+#else
+#  define NOTEHEAP_NALLOCATORS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One of the threads of a replay */
+
+struct noteheap_thread_s
+{
+  FAR void **mem;                /* The block of each allocation record     */
+  FAR clock_t *alloctime;        /* The latencies of the allocations        */
+  FAR clock_t *freetime;         /* The latencies of the frees              */
+  uint32_t nallocs;
+  uint32_t nfrees;
+  uint32_t nfails;
+};
+
+/* A replay of the trace against one heap */
+
+struct noteheap_replay_s
+{
+  FAR struct mm_heap_s *heap;    /* The private heap replayed against       */
+  FAR int32_t *link;             /* For a free, the allocation record       */
+  FAR struct noteheap_result_s *result;
+  sem_t start;                   /* Released once all threads are ready     */
+  sem_t done;                    /* Posted by each thread once finished     */
+  struct noteheap_thread_s thread[NOTEHEAP_NTHREADS];
+};
+
+struct noteheap_s
+{
+  struct note_driver_s driver;
+  atomic_t recording;
+  atomic_t index;
+  atomic_t dropped;
+  mutex_t lock;
+  struct noteheap_replay_s replay;
+  int nresults;
+  struct noteheap_result_s result[2 * NOTEHEAP_NALLOCATORS];
+  struct noteheap_record_s record[NOTEHEAP_NRECORDS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void noteheap_heap(FAR struct note_driver_s *drv, uint8_t event,
+                          FAR void *heap, FAR void *mem, size_t size,
+                          size_t curused);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_noteheap_ops =
+{
+  .heap = noteheap_heap,
+};
+
+static struct noteheap_s g_noteheap =
+{
+  {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+    "heap",
+    {
+      {
+        CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE,
+#  ifdef CONFIG_SMP
+        CONFIG_SCHED_INSTRUMENTATION_CPUSET
+#  endif
+      },
+    },
+#endif
+    &g_noteheap_ops,
+  },
+  .lock = NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: noteheap_heap
+ *
+ * Description:
+ *   Record an allocation or a free.  This runs inside the allocator, maybe
+ *   from an interrupt handler, so it only reserves a record and fills it.
+ *
+ ****************************************************************************/
+
+static void noteheap_heap(FAR struct note_driver_s *drv, uint8_t event,
+                          FAR void *heap, FAR void *mem, size_t size,
+                          size_t curused)
+{
+  FAR struct noteheap_s *trace = (FAR struct noteheap_s *)drv;
+  FAR struct noteheap_record_s *record;
+  int index;
+
+  if ((event != NOTE_HEAP_ALLOC && event != NOTE_HEAP_FREE) ||
+      !atomic_read(&trace->recording))
+    {
+      return;
+    }
+
+  /* Check before reserving, so that the index stays bounded once full */
+
+  if (atomic_read(&trace->index) >= NOTEHEAP_NRECORDS ||
+      (index = atomic_fetch_add(&trace->index, 1)) >= NOTEHEAP_NRECORDS)
+    {
+      atomic_fetch_add(&trace->dropped, 1);
+      return;
+    }
+
+  record        = &trace->record[index];
+  record->time  = perf_gettime();
+  record->mem   = mem;
+  record->size  = size;
+  record->pid   = this_task()->pid;
+  record->alloc = event == NOTE_HEAP_ALLOC;
+}
+
+/****************************************************************************
+ * Name: noteheap_nrecords
+ ****************************************************************************/
+
+static uint32_t noteheap_nrecords(void)
+{
+  int index = atomic_read(&g_noteheap.index);
+
+  return index < NOTEHEAP_NRECORDS ? index : NOTEHEAP_NRECORDS;
+}
+
+/****************************************************************************
+ * Name: noteheap_compare / noteheap_ns
+ ****************************************************************************/
+
+static int noteheap_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+static uint64_t noteheap_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: noteheap_link
+ *
+ * Description:
+ *   Find the allocation record each free releases, through a hash table of
+ *   the addresses still allocated.  The frees of blocks allocated before
+ *   the trace started link to nothing and are not replayed.
+ *
+ ****************************************************************************/
+
+static int noteheap_link(FAR int32_t *link, uint32_t nrecords)
+{
+  FAR struct noteheap_record_s *record = g_noteheap.record;
+  FAR uintptr_t *keys;
+  FAR int32_t *values;
+  uint32_t mask;
+  uint32_t slot;
+  uint32_t i;
+
+  for (mask = 1; mask < 2 * nrecords; mask <<= 1);
+  keys = kmm_zalloc(mask * (sizeof(uintptr_t) + sizeof(int32_t)));
+  if (keys == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  values = (FAR int32_t *)(keys + mask);
+  mask--;
+
+  for (i = 0; i < nrecords; i++)
+    {
+      uintptr_t key = (uintptr_t)record[i].mem;
+
+      slot = (uint32_t)(key >> 3) * 2654435761u & mask;
+      while (keys[slot] != 0 && keys[slot] != key)
+        {
+          slot = (slot + 1) & mask;
+        }
+
+      /* A free leaves its key in the table, so that the probe sequences of
+       * the other keys stay unbroken.
+       */
+
+      if (record[i].alloc)
+        {
+          values[slot] = i;
+          link[i]      = -1;
+        }
+      else
+        {
+          link[i]      = keys[slot] == key ? values[slot] : -1;
+          values[slot] = -1;
+        }
+
+      keys[slot] = key;
+    }
+
+  kmm_free(keys);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: noteheap_fragmentation
+ *
+ * Description:
+ *   The percent of the free memory of a heap outside its largest free
+ *   block.
+ *
+ ****************************************************************************/
+
+static uint8_t noteheap_fragmentation(FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info = mm_mallinfo(heap);
+
+  if (info.fordblks <= 0)
+    {
+      return 0;
+    }
+
+  return 100 - (uint8_t)((uint64_t)info.mxordblk * 100 / info.fordblks);
+}
+
+/****************************************************************************
+ * Name: noteheap_thread
+ *
+ * Description:
+ *   Replay the whole trace once, as one of the threads of a replay.  The
+ *   first thread samples the fragmentation of the heap as it goes.
+ *
+ ****************************************************************************/
+
+static int noteheap_thread(int argc, FAR char *argv[])
+{
+  FAR struct noteheap_replay_s *replay = &g_noteheap.replay;
+  FAR struct noteheap_record_s *record = g_noteheap.record;
+  FAR struct noteheap_thread_s *thread;
+  uint32_t nrecords = noteheap_nrecords();
+  uint32_t sample = 0;
+  clock_t start;
+  FAR void *mem;
+  int index;
+  uint32_t i;
+
+  DEBUGASSERT(argc == 2);
+  index  = atoi(argv[1]);
+  thread = &replay->thread[index];
+
+  nxsem_wait_uninterruptible(&replay->start);
+
+  for (i = 0; i < nrecords; i++)
+    {
+      if (record[i].alloc)
+        {
+          start = perf_gettime();
+          mem   = mm_malloc(replay->heap, record[i].size);
+          thread->alloctime[thread->nallocs++] = perf_gettime() - start;
+
+          thread->mem[i] = mem;
+          if (mem == NULL)
+            {
+              thread->nfails++;
+            }
+        }
+      else if (replay->link[i] >= 0 && thread->mem[replay->link[i]])
+        {
+          mem   = thread->mem[replay->link[i]];
+          start = perf_gettime();
+          mm_free(replay->heap, mem);
+          thread->freetime[thread->nfrees++] = perf_gettime() - start;
+
+          thread->mem[replay->link[i]] = NULL;
+        }
+
+      while (index == 0 && sample < NOTEHEAP_NSAMPLES &&
+             (uint64_t)(i + 1) * NOTEHEAP_NSAMPLES >=
+             (uint64_t)(sample + 1) * nrecords)
+        {
+          replay->result->frag[sample++] =
+            noteheap_fragmentation(replay->heap);
+        }
+    }
+
+  nxsem_post(&replay->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: noteheap_percentiles
+ *
+ * Description:
+ *   Gather the latencies of one kind of operation of all the threads into
+ *   scratch and return their percentiles.
+ *
+ ****************************************************************************/
+
+static void noteheap_percentiles(FAR clock_t *scratch, int nthreads,
+                                 bool alloc, FAR uint64_t *p50,
+                                 FAR uint64_t *p90, FAR uint64_t *p99,
+                                 FAR uint64_t *max)
+{
+  FAR struct noteheap_replay_s *replay = &g_noteheap.replay;
+  uint32_t n = 0;
+  int i;
+
+  for (i = 0; i < nthreads; i++)
+    {
+      FAR struct noteheap_thread_s *thread = &replay->thread[i];
+      uint32_t count = alloc ? thread->nallocs : thread->nfrees;
+
+      memcpy(scratch + n, alloc ? thread->alloctime : thread->freetime,
+             count * sizeof(clock_t));
+      n += count;
+    }
+
+  if (n == 0)
+    {
+      return;
+    }
+
+  qsort(scratch, n, sizeof(clock_t), noteheap_compare);
+
+  *p50 = noteheap_ns(scratch[(n - 1) * 50 / 100]);
+  *p90 = noteheap_ns(scratch[(n - 1) * 90 / 100]);
+  *p99 = noteheap_ns(scratch[(n - 1) * 99 / 100]);
+  *max = noteheap_ns(scratch[n - 1]);
+}
+
+/****************************************************************************
+ * Name: noteheap_run
+ *
+ * Description:
+ *   Replay the trace from nthreads threads at once against a new private
+ *   heap, with or without the multiple mempool in front of it.
+ *
+ ****************************************************************************/
+
+static int noteheap_run(FAR const char *name, bool pool, int nthreads,
+                        FAR void *buffer, FAR clock_t *scratch,
+                        FAR struct noteheap_result_s *result)
+{
+  FAR struct noteheap_replay_s *replay = &g_noteheap.replay;
+  uint32_t nrecords = noteheap_nrecords();
+  FAR char *argv[2];
+  char arg[8];
+  clock_t start;
+  uint32_t j;
+  int ret = OK;
+  int i;
+
+  memset(result, 0, sizeof(*result));
+  result->name     = name;
+  result->nthreads = nthreads;
+  result->arena    = CONFIG_DRIVERS_NOTEHEAP_HEAPSIZE;
+
+  if (pool)
+    {
+      replay->heap = mm_initialize_pool("noteheap", buffer,
+                                        CONFIG_DRIVERS_NOTEHEAP_HEAPSIZE,
+                                        NULL);
+    }
+  else
+    {
+      replay->heap = mm_initialize("noteheap", buffer,
+                                   CONFIG_DRIVERS_NOTEHEAP_HEAPSIZE);
+    }
+
+  if (replay->heap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  replay->result = result;
+  nxsem_init(&replay->start, 0, 0);
+  nxsem_init(&replay->done, 0, 0);
+
+  for (i = 0; i < nthreads; i++)
+    {
+      FAR struct noteheap_thread_s *thread = &replay->thread[i];
+
+      memset(thread->mem, 0, nrecords * sizeof(FAR void *));
+      thread->nallocs = 0;
+      thread->nfrees  = 0;
+      thread->nfails  = 0;
+    }
+
+  /* Start the threads at the priority of the caller and release them all
+   * at once.
+   */
+
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  for (i = 0; i < nthreads; i++)
+    {
+      snprintf(arg, sizeof(arg), "%d", i);
+      ret = kthread_create("noteheap", this_task()->sched_priority,
+                           CONFIG_DRIVERS_NOTEHEAP_STACKSIZE,
+                           noteheap_thread, argv);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (i > 0)
+    {
+      int started = i;
+
+      start = perf_gettime();
+      for (i = 0; i < started; i++)
+        {
+          nxsem_post(&replay->start);
+        }
+
+      for (i = 0; i < started; i++)
+        {
+          nxsem_wait_uninterruptible(&replay->done);
+        }
+
+      result->elapsed = noteheap_ns(perf_gettime() - start);
+      result->peak    = mm_mallinfo(replay->heap).usmblks;
+    }
+
+  /* Release what the trace left allocated, then the heap */
+
+  for (i = 0; i < nthreads; i++)
+    {
+      FAR struct noteheap_thread_s *thread = &replay->thread[i];
+
+      for (j = 0; j < nrecords; j++)
+        {
+          if (thread->mem[j] != NULL)
+            {
+              mm_free(replay->heap, thread->mem[j]);
+            }
+        }
+
+      result->nallocs += thread->nallocs;
+      result->nfrees  += thread->nfrees;
+      result->nfails  += thread->nfails;
+    }
+
+  mm_uninitialize(replay->heap);
+  replay->heap = NULL;
+
+  nxsem_destroy(&replay->start);
+  nxsem_destroy(&replay->done);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  noteheap_percentiles(scratch, nthreads, true, &result->alloc_p50,
+                       &result->alloc_p90, &result->alloc_p99,
+                       &result->alloc_max);
+  noteheap_percentiles(scratch, nthreads, false, &result->free_p50,
+                       &result->free_p90, &result->free_p99,
+                       &result->free_max);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: noteheap_register
+ ****************************************************************************/
+
+int noteheap_register(void)
+{
+  return note_driver_register(&g_noteheap.driver);
+}
+
+/****************************************************************************
+ * Name: noteheap_clear
+ ****************************************************************************/
+
+void noteheap_clear(void)
+{
+  nxmutex_lock(&g_noteheap.lock);
+
+  atomic_set(&g_noteheap.recording, false);
+  atomic_set(&g_noteheap.index, 0);
+  atomic_set(&g_noteheap.dropped, 0);
+
+  nxmutex_unlock(&g_noteheap.lock);
+}
+
+/****************************************************************************
+ * Name: noteheap_start
+ ****************************************************************************/
+
+void noteheap_start(void)
+{
+  nxmutex_lock(&g_noteheap.lock);
+
+  atomic_set(&g_noteheap.recording, false);
+  atomic_set(&g_noteheap.index, 0);
+  atomic_set(&g_noteheap.dropped, 0);
+  atomic_set(&g_noteheap.recording, true);
+
+  nxmutex_unlock(&g_noteheap.lock);
+}
+
+/****************************************************************************
+ * Name: noteheap_stop
+ ****************************************************************************/
+
+void noteheap_stop(void)
+{
+  atomic_set(&g_noteheap.recording, false);
+}
+
+/****************************************************************************
+ * Name: noteheap_load
+ ****************************************************************************/
+
+int noteheap_load(FAR const struct noteheap_record_s *record)
+{
+  int index;
+  int ret;
+
+  ret = nxmutex_lock(&g_noteheap.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  index = atomic_read(&g_noteheap.index);
+  if (atomic_read(&g_noteheap.recording))
+    {
+      ret = -EBUSY;
+    }
+  else if (index >= NOTEHEAP_NRECORDS)
+    {
+      ret = -ENOSPC;
+    }
+  else
+    {
+      g_noteheap.record[index] = *record;
+      atomic_set(&g_noteheap.index, index + 1);
+    }
+
+  nxmutex_unlock(&g_noteheap.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: noteheap_status
+ ****************************************************************************/
+
+void noteheap_status(FAR struct noteheap_status_s *status)
+{
+  uint32_t nrecords = noteheap_nrecords();
+
+  memset(status, 0, sizeof(*status));
+  status->recording = atomic_read(&g_noteheap.recording);
+  status->nrecords  = nrecords;
+  status->dropped   = atomic_read(&g_noteheap.dropped);
+
+  if (nrecords > 1 && g_noteheap.record[0].time != 0)
+    {
+      status->elapsed = noteheap_ns(g_noteheap.record[nrecords - 1].time -
+                                    g_noteheap.record[0].time);
+    }
+}
+
+/****************************************************************************
+ * Name: noteheap_record
+ ****************************************************************************/
+
+int noteheap_record(uint32_t index, FAR struct noteheap_record_s *record)
+{
+  if (index >= noteheap_nrecords())
+    {
+      return -ENOENT;
+    }
+
+  *record = g_noteheap.record[index];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: noteheap_replay
+ ****************************************************************************/
+
+int noteheap_replay(int nthreads)
+{
+  static FAR const char * const names[] =
+  {
+    NOTEHEAP_MANAGER,
+#if NOTEHEAP_NALLOCATORS > 1
+    NOTEHEAP_MANAGER "+mempool",
+#endif
+  };
+
+  FAR struct noteheap_replay_s *replay = &g_noteheap.replay;
+  uint32_t nrecords;
+  FAR clock_t *scratch = NULL;
+  FAR void *buffer = NULL;
+  int nresults = 0;
+  int ret;
+  int i;
+
+  if (nthreads < 1 || nthreads > NOTEHEAP_NTHREADS)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&g_noteheap.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nrecords = noteheap_nrecords();
+  if (atomic_read(&g_noteheap.recording))
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+  else if (nrecords == 0)
+    {
+      ret = -ENODATA;
+      goto out;
+    }
+
+  /* The heap, the links, and the blocks and latencies of each thread */
+
+  buffer  = kmm_malloc(CONFIG_DRIVERS_NOTEHEAP_HEAPSIZE);
+  scratch = kmm_malloc(nthreads * nrecords * sizeof(clock_t));
+  replay->link = kmm_malloc(nrecords * sizeof(int32_t));
+  if (buffer == NULL || scratch == NULL || replay->link == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      FAR struct noteheap_thread_s *thread = &replay->thread[i];
+
+      thread->mem   = kmm_malloc(nrecords * sizeof(FAR void *));
+      thread->alloctime = kmm_malloc(nrecords * sizeof(clock_t));
+      thread->freetime  = kmm_malloc(nrecords * sizeof(clock_t));
+      if (thread->mem == NULL || thread->alloctime == NULL ||
+          thread->freetime == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+    }
+
+  ret = noteheap_link(replay->link, nrecords);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  /* One thread alone first, then all of them contending for the heap */
+
+  for (i = 0; i < NOTEHEAP_NALLOCATORS; i++)
+    {
+      ret = noteheap_run(names[i], i > 0, 1, buffer, scratch,
+                         &g_noteheap.result[nresults]);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      nresults++;
+      if (nthreads > 1)
+        {
+          ret = noteheap_run(names[i], i > 0, nthreads, buffer, scratch,
+                             &g_noteheap.result[nresults]);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          nresults++;
+        }
+    }
+
+  ret = nresults;
+
+out:
+  g_noteheap.nresults = nresults;
+
+  for (i = 0; i < nthreads; i++)
+    {
+      FAR struct noteheap_thread_s *thread = &replay->thread[i];
+
+      kmm_free(thread->mem);
+      kmm_free(thread->alloctime);
+      kmm_free(thread->freetime);
+      memset(thread, 0, sizeof(*thread));
+    }
+
+  kmm_free(replay->link);
+  replay->link = NULL;
+  kmm_free(scratch);
+  kmm_free(buffer);
+
+  nxmutex_unlock(&g_noteheap.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: noteheap_result
+ ****************************************************************************/
+
+int noteheap_result(int index, FAR struct noteheap_result_s *result)
+{
+  if (index < 0 || index >= g_noteheap.nresults)
+    {
+      return -ENOENT;
+    }
+
+  *result = g_noteheap.result[index];
+  return OK;
+}
@@ -41,6 +41,7 @@
 #include <nuttx/sched_note.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/note/note_driver.h>
+#include <nuttx/note/notectf_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/panic_notifier.h>
 #include <nuttx/fs/fs.h>
@@ -72,20 +73,58 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* The buffer is split into one ring per CPU whose size is the largest
+ * power of two that fits, so that free running positions can be masked
+ * into ring offsets.
+ */
+
+#define NOTERAM_SMEAR1(n)  ((n) | ((n) >> 1))
+#define NOTERAM_SMEAR2(n)  (NOTERAM_SMEAR1(n) | (NOTERAM_SMEAR1(n) >> 2))
+#define NOTERAM_SMEAR4(n)  (NOTERAM_SMEAR2(n) | (NOTERAM_SMEAR2(n) >> 4))
+#define NOTERAM_SMEAR8(n)  (NOTERAM_SMEAR4(n) | (NOTERAM_SMEAR4(n) >> 8))
+#define NOTERAM_SMEAR16(n) (NOTERAM_SMEAR8(n) | (NOTERAM_SMEAR8(n) >> 16))
+#define NOTERAM_RINGSIZE(n) \
+  (NOTERAM_SMEAR16(n) - (NOTERAM_SMEAR16(n) >> 1))
+
+/* Orders the ring data against the head/tail positions.  The compiler
+ * barrier also covers the UP case, where the reader may be interrupted
+ * by the producer.
+ */
+
+#define noteram_barrier() \
+  do \
+    { \
+      UP_DMB(); \
+      __asm__ __volatile__("" ::: "memory"); \
+    } \
+  while (0)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* Single producer ring of one CPU.  Positions are free running byte
+ * counts: only the owning CPU (with local interrupts disabled) moves
+ * nr_head and nr_tail, only readers move nr_read and nr_start.
+ */
+
+struct noteram_ring_s
+{
+  volatile unsigned int nr_head;  /* End of the last committed note */
+  volatile unsigned int nr_tail;  /* Start of the oldest valid note */
+  volatile unsigned int nr_read;  /* Next note returned to the reader */
+  unsigned int nr_start;          /* Read position after NOTERAM_CLEAR */
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
   size_t ni_bufsize;
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
-  spinlock_t lock;
+  unsigned int ni_ringsize;       /* Size of each per-CPU ring */
+  struct noteram_ring_s ni_ring[NCPUS];
+  spinlock_t lock;                /* Serializes the readers only */
   FAR struct pollfd *pfd;
 };
 
@@ -177,10 +216,11 @@ struct noteram_driver_s g_noteram_driver =
   g_ramnote_buffer,
   CONFIG_DRIVERS_NOTERAM_BUFSIZE,
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
-  NOTERAM_MODE_OVERWRITE_DISABLE
+  NOTERAM_MODE_OVERWRITE_DISABLE,
 #else
-  NOTERAM_MODE_OVERWRITE_ENABLE
+  NOTERAM_MODE_OVERWRITE_ENABLE,
 #endif
+  NOTERAM_RINGSIZE(CONFIG_DRIVERS_NOTERAM_BUFSIZE / NCPUS)
 };
 
 /****************************************************************************
@@ -203,8 +243,19 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  int cpu;
+
+  /* The producers own the tail, so only move the reader side past the
+   * notes recorded so far.
+   */
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct noteram_ring_s *ring = &drv->ni_ring[cpu];
+
+      ring->nr_start = ring->nr_head;
+      ring->nr_read  = ring->nr_start;
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -213,138 +264,123 @@ static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 }
 
 /****************************************************************************
- * Name: noteram_next
+ * Name: noteram_ring_pos
  *
  * Description:
- *   Return the circular buffer index at offset from the specified index
- *   value, handling wraparound
- *
- * Input Parameters:
- *   ndx - Old circular buffer index
- *
- * Returned Value:
- *   New circular buffer index
+ *   Return the position of the next unread note of a ring.  A read
+ *   position the producer has already overwritten (or a stale one) is
+ *   replaced by the oldest valid note.
  *
  ****************************************************************************/
 
-static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
-                                        unsigned int ndx,
-                                        unsigned int offset)
+static inline unsigned int noteram_ring_pos(FAR struct noteram_ring_s *ring,
+                                            unsigned int head)
 {
-  ndx += offset;
-  if (ndx >= drv->ni_bufsize)
-    {
-      ndx -= drv->ni_bufsize;
-    }
+  unsigned int tail = ring->nr_tail;
+  unsigned int read = ring->nr_read;
 
-  return ndx;
+  return read - tail > head - tail ? tail : read;
 }
 
 /****************************************************************************
- * Name: noteram_length
+ * Name: noteram_ring_copy
  *
  * Description:
- *   Length of data currently in circular buffer.
- *
- * Input Parameters:
- *   None
+ *   Copy len bytes at position pos out of a ring.
  *
  * Returned Value:
- *   Length of data currently in circular buffer.
+ *   false if the producer overwrote the bytes while they were copied.
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static bool noteram_ring_copy(FAR struct noteram_driver_s *drv,
+                              FAR struct noteram_ring_s *ring,
+                              unsigned int pos, FAR uint8_t *buffer,
+                              size_t len)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  FAR uint8_t *base = drv->ni_buffer +
+                      (ring - drv->ni_ring) * drv->ni_ringsize;
+  unsigned int offset = pos & (drv->ni_ringsize - 1);
+  unsigned int space = drv->ni_ringsize - offset;
 
-  if (tail > head)
-    {
-      head += drv->ni_bufsize;
-    }
+  space = space < len ? space : len;
+  memcpy(buffer, base + offset, space);
+  memcpy(buffer + space, base, len - space);
+  noteram_barrier();
 
-  return head - tail;
+  return pos - ring->nr_tail < drv->ni_ringsize;
 }
 
 /****************************************************************************
- * Name: noteram_unread_length
+ * Name: noteram_ring_peek
  *
  * Description:
- *   Length of unread data currently in circular buffer.
- *
- * Input Parameters:
- *   None
+ *   Get the common header of the next unread note of a ring.
  *
  * Returned Value:
- *   Length of unread data currently in circular buffer.
+ *   true and the note position in pos if the ring has an unread note.
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+static bool noteram_ring_peek(FAR struct noteram_driver_s *drv,
+                              FAR struct noteram_ring_s *ring,
+                              FAR unsigned int *pos,
+                              FAR struct note_common_s *note)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  unsigned int head;
 
-  if (read > head)
+  do
     {
-      head += drv->ni_bufsize;
+      head = ring->nr_head;
+      noteram_barrier();
+
+      *pos = noteram_ring_pos(ring, head);
+      if (*pos == head)
+        {
+          return false;
+        }
     }
+  while (!noteram_ring_copy(drv, ring, *pos, (FAR uint8_t *)note,
+                            sizeof(*note)));
 
-  return head - read;
+  return true;
 }
 
 /****************************************************************************
- * Name: noteram_remove
+ * Name: noteram_unread_length
  *
  * Description:
- *   Remove the variable length note from the tail of the circular buffer
+ *   Check whether any ring has unread notes.
  *
  * Input Parameters:
  *   None
  *
  * Returned Value:
- *   None
- *
- * Assumptions:
- *   We are within a critical section.
+ *   Non-zero if there are unread notes.
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
 {
-  unsigned int tail;
-  unsigned int length;
-
-  /* Get the tail index of the circular buffer */
-
-  tail = drv->ni_tail;
-  DEBUGASSERT(tail < drv->ni_bufsize);
-
-  /* Get the length of the note at the tail index */
-
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
-
-  /* Increment the tail index to remove the entire note from the circular
-   * buffer.
-   */
+  unsigned int length = 0;
+  int cpu;
 
-  if (drv->ni_read == drv->ni_tail)
+  for (cpu = 0; cpu < NCPUS; cpu++)
     {
-      /* The read index also needs increment. */
+      FAR struct noteram_ring_s *ring = &drv->ni_ring[cpu];
+      unsigned int head = ring->nr_head;
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      length += head - noteram_ring_pos(ring, head);
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  return length;
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the next note, in timestamp order across the per-CPU rings.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -360,63 +396,54 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
-  unsigned int remaining;
-  unsigned int read;
-  ssize_t notelen;
-  size_t circlen;
+  FAR struct noteram_ring_s *ring;
+  struct note_common_s note;
+  unsigned int notepos = 0;
+  unsigned int pos;
+  clock_t systime = 0;
+  ssize_t notelen = 0;
+  int cpu;
 
   DEBUGASSERT(buffer != NULL);
 
-  /* Verify that the circular buffer is not empty */
-
-  circlen = noteram_unread_length(drv);
-  if (circlen <= 0)
-    {
-      return 0;
-    }
-
-  /* Get the read index of the circular buffer */
-
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
-
-  /* Get the length of the note at the read index */
-
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
-
-  /* Is the user buffer large enough to hold the note? */
-
-  if (buflen < notelen)
+  do
     {
-      /* Skip the large note so that we do not get constipated. */
+      /* Pick the oldest unread note among the rings */
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
-
-      /* and return an error */
+      ring = NULL;
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          if (noteram_ring_peek(drv, &drv->ni_ring[cpu], &pos, &note) &&
+              (ring == NULL || (sclock_t)(note.nc_systime - systime) < 0))
+            {
+              ring    = &drv->ni_ring[cpu];
+              notepos = pos;
+              notelen = note.nc_length;
+              systime = note.nc_systime;
+            }
+        }
 
-      return -EFBIG;
-    }
+      if (ring == NULL)
+        {
+          return 0;
+        }
 
-  /* Loop until the note has been transferred to the user buffer */
+      /* Is the user buffer large enough to hold the note? */
 
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the read index */
+      if (buflen < notelen)
+        {
+          /* Skip the large note so that we do not get constipated. */
 
-      *buffer++ = drv->ni_buffer[read];
+          ring->nr_read = notepos + NOTE_ALIGN(notelen);
 
-      /* Adjust indices and counts */
+          /* and return an error */
 
-      read = noteram_next(drv, read, 1);
-      remaining--;
+          return -EFBIG;
+        }
     }
+  while (!noteram_ring_copy(drv, ring, notepos, buffer, notelen));
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
-
+  ring->nr_read = notepos + NOTE_ALIGN(notelen);
   return notelen;
 }
 
@@ -429,10 +456,21 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  irqstate_t flags;
+  int cpu;
 
-  /* Reset the read index of the circular buffer */
+  /* Reset the read index of the circular buffers, a position older than
+   * the tail falls back to the oldest note.
+   */
+
+  flags = spin_lock_irqsave_notrace(&drv->lock);
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_ring[cpu].nr_read = drv->ni_ring[cpu].nr_start;
+    }
+
+  spin_unlock_irqrestore_notrace(&drv->lock, flags);
 
-  drv->ni_read = drv->ni_tail;
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -467,10 +505,55 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
   if (ctx->mode == NOTERAM_MODE_READ_BINARY)
     {
+      /* Return as many whole notes as fit, a note is at most UINT8_MAX
+       * bytes.
+       */
+
       flags = spin_lock_irqsave_notrace(&drv->lock);
       ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
+      while (ret > 0 && buflen - ret >= UINT8_MAX)
+        {
+          ssize_t len = noteram_get(drv, (FAR uint8_t *)buffer + ret,
+                                    buflen - ret);
+          if (len <= 0)
+            {
+              break;
+            }
+
+          ret += len;
+        }
+
       spin_unlock_irqrestore_notrace(&drv->lock, flags);
     }
+#ifdef CONFIG_DRIVERS_NOTECTF
+  else if (ctx->mode == NOTERAM_MODE_READ_CTF)
+    {
+      /* Return as many whole CTF records as fit */
+
+      ret = 0;
+      flags = spin_lock_irqsave_notrace(&drv->lock);
+      while (buflen - ret >= NOTECTF_RECORD_MAX)
+        {
+          FAR uint8_t *record = (FAR uint8_t *)buffer + ret;
+          ssize_t len = noteram_get(drv, record + 1, UINT8_MAX);
+
+          if (len <= 0)
+            {
+              break;
+            }
+
+          record[0] = notectf_datalen((FAR struct note_common_s *)
+                                      (record + 1));
+          ret += len + 1;
+        }
+
+      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+      if (ret == 0 && buflen < NOTECTF_RECORD_MAX)
+        {
+          ret = -EINVAL;
+        }
+    }
+#endif
   else
     {
       lib_memoutstream(&stream, buffer, buflen);
@@ -684,7 +767,9 @@ errout:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The note is added to the ring of the calling CPU.  Only local
+ *   interrupts are disabled, no lock shared with other CPUs or with the
+ *   readers is taken.
  *
  ****************************************************************************/
 
@@ -693,51 +778,68 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *base;
+  unsigned int alignlen = NOTE_ALIGN(notelen);
+  unsigned int offset;
   unsigned int head;
-  unsigned int remain;
+  unsigned int tail;
   unsigned int space;
   irqstate_t flags;
-
-  flags = spin_lock_irqsave_notrace(&drv->lock);
+  int cpu;
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
       return;
     }
 
-  DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  DEBUGASSERT(note != NULL && notelen < drv->ni_ringsize);
 
-  if (remain <= NOTE_ALIGN(notelen))
+  flags = up_irq_save();
+  cpu   = this_cpu();
+  ring  = &drv->ni_ring[cpu];
+  base  = drv->ni_buffer + cpu * drv->ni_ringsize;
+  head  = ring->nr_head;
+  tail  = ring->nr_tail;
+
+  /* Reserve the space, dropping the oldest notes if needed */
+
+  if (head + alignlen - tail > drv->ni_ringsize)
     {
       if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
         {
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
+          up_irq_restore(flags);
           return;
         }
 
-      /* Remove the note at the tail index , make sure there is enough space
-       */
-
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          tail += NOTE_ALIGN(base[tail & (drv->ni_ringsize - 1)]);
         }
-      while (remain <= NOTE_ALIGN(notelen));
+      while (head + alignlen - tail > drv->ni_ringsize);
+
+      /* Publish the new tail before the old notes are overwritten, so a
+       * concurrent reader notices that its copy is stale.
+       */
+
+      ring->nr_tail = tail;
+      noteram_barrier();
     }
 
-  head = drv->ni_head;
-  space = drv->ni_bufsize - head;
+  /* Copy the note and commit it by moving the head */
+
+  offset = head & (drv->ni_ringsize - 1);
+  space = drv->ni_ringsize - offset;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  memcpy(base + offset, note, space);
+  memcpy(base, buf + space, notelen - space);
+  noteram_barrier();
+  ring->nr_head = head + alignlen;
+  up_irq_restore(flags);
+
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
@@ -1370,9 +1472,9 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   drv->ni_bufsize = bufsize;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  drv->ni_ringsize = NOTERAM_RINGSIZE(bufsize / NCPUS);
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
+  spin_lock_init(&drv->lock);
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
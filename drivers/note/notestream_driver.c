@@ -28,6 +28,7 @@
 #include <fcntl.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/note/notectf_driver.h>
 #include <nuttx/note/notestream_driver.h>
 
 /****************************************************************************
@@ -93,7 +94,11 @@ static void notestream_add(FAR struct note_driver_s *drv,
 {
   FAR struct notestream_driver_s *drivers =
       (FAR struct notestream_driver_s *)drv;
+#ifdef CONFIG_DRIVERS_NOTECTF
+  notectf_put(drivers->stream, note, len);
+#else
   lib_stream_puts(drivers->stream, note, len);
+#endif
 }
 
 /****************************************************************************
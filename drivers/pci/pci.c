@@ -2034,6 +2034,114 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+#ifdef CONFIG_SMP
+/****************************************************************************
+ * Name: pci_set_irq_affinity
+ *
+ * Description:
+ *   Route one MSI or MSI-X vector of a device to a CPU.  When the route is
+ *   carried in the message itself, the MSI-X table entry of the vector is
+ *   rewritten.  With plain MSI all the vectors share one message, so only
+ *   index 0 can be routed and it moves all of them.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   irq   - vectors passed to pci_connect_irq()
+ *   index - index of the vector in irq
+ *   cpu   - the CPU that should take the interrupt
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_set_irq_affinity(FAR struct pci_device_s *dev, FAR const int *irq,
+                         int index, int cpu)
+{
+  FAR const struct pci_ops_s *ops = dev->bus->ctrl->ops;
+  uintptr_t mar = 0;
+  uint32_t  mdr = 0;
+  uint16_t  flags = 0;
+  uint8_t   msi = 0;
+  uint8_t   msix = 0;
+  int       ret;
+
+  if (index < 0 || cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  if (ops->affinity_irq == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  ret = ops->affinity_irq(dev->bus, irq[index], cpu, &mar, &mdr);
+  if (ret <= 0)
+    {
+      /* Routed by the interrupt controller, or failed */
+
+      return ret;
+    }
+
+  pci_get_msi_base(dev, &msi, &msix);
+
+#ifdef CONFIG_PCI_MSIX
+  if (msix != 0)
+    {
+      uintptr_t tbladdr;
+      uint32_t  tbl = 0;
+
+      pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+      if (index > (flags & PCI_MSIX_FLAGS_QSIZE))
+        {
+          return -EINVAL;
+        }
+
+      pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
+      tbladdr = pci_resource_start(dev, tbl & PCI_MSIX_TABLE_BIR) +
+                (tbl & PCI_MSIX_TABLE_OFFSET);
+      if (ops->map)
+        {
+          tbladdr = ops->map(dev->bus, tbladdr, tbladdr +
+                             ((flags & PCI_MSIX_FLAGS_QSIZE) + 1) *
+                             PCI_MSIX_ENTRY_SIZE);
+        }
+
+      tbladdr += index * PCI_MSIX_ENTRY_SIZE;
+
+      /* Mask the vector while its message is inconsistent */
+
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL,
+                           PCI_MSIX_ENTRY_CTRL_MASKBIT);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_LOWER_ADDR, mar);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_UPPER_ADDR,
+                           ((uint64_t)mar >> 32));
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_DATA, mdr);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL, 0);
+      return OK;
+    }
+#endif
+
+  if (msi == 0 || index != 0)
+    {
+      return -ENOTSUP;
+    }
+
+  /* The data of vector 0 is the base of all the vectors, keep it */
+
+  pci_read_config_word(dev, msi + PCI_MSI_FLAGS, &flags);
+  pci_write_config_dword(dev, msi + PCI_MSI_ADDRESS_LO, mar);
+  if ((flags & PCI_MSI_FLAGS_64BIT) != 0)
+    {
+      pci_write_config_dword(dev, msi + PCI_MSI_ADDRESS_HI,
+                             ((uint64_t)mar >> 32));
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -77,6 +77,11 @@ static void pci_ecam_release_irq(FAR struct pci_bus_s *bus, FAR int *irq,
 static int pci_ecam_connect_irq(FAR struct pci_bus_s *bus, FAR int *irq,
                                 int num, FAR uintptr_t *mar,
                                 FAR uint32_t *mdr);
+#  ifdef CONFIG_SMP
+static int pci_ecam_affinity_irq(FAR struct pci_bus_s *bus, int irq,
+                                 int cpu, FAR uintptr_t *mar,
+                                 FAR uint32_t *mdr);
+#  endif
 #endif
 
 /****************************************************************************
@@ -105,6 +110,9 @@ static const struct pci_ops_s g_pci_ecam_ops =
   .alloc_irq   = pci_ecam_alloc_irq,
   .release_irq = pci_ecam_release_irq,
   .connect_irq = pci_ecam_connect_irq,
+#  ifdef CONFIG_SMP
+  .affinity_irq = pci_ecam_affinity_irq,
+#  endif
 #endif
 };
 
@@ -412,6 +420,22 @@ static int pci_ecam_connect_irq(FAR struct pci_bus_s *bus, FAR int *irq,
 {
   return up_connect_irq(irq, num, mar, mdr);
 }
+
+#  ifdef CONFIG_SMP
+static int pci_ecam_affinity_irq(FAR struct pci_bus_s *bus, int irq,
+                                 int cpu, FAR uintptr_t *mar,
+                                 FAR uint32_t *mdr)
+{
+  cpu_set_t cpuset;
+
+  /* The MSI frame turns the message into an SPI, route that */
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  up_affinity_irq(irq, cpuset);
+  return 0;
+}
+#  endif
 #endif
 
 /****************************************************************************
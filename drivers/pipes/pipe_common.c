@@ -85,6 +85,225 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_splice_out
+ *
+ * Description:
+ *   Write the pipe data to another file straight from the circular buffer,
+ *   without copying it to an intermediate buffer first.  Only the bytes
+ *   accepted by the file are removed from the pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_out(FAR struct file *filep,
+                                     FAR struct pipe_splice_s *sp)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                nmoved = 0;
+  FAR void              *buf;
+  size_t                 size;
+  ssize_t                ret;
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (sp->flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Hand over the contiguous runs of the buffer (at most two) */
+
+  while ((size_t)nmoved < sp->len)
+    {
+      buf  = circbuf_get_readptr(&dev->d_buffer, &size);
+      size = MIN(size, sp->len - nmoved);
+      if (size == 0)
+        {
+          break;
+        }
+
+      if (sp->offset != NULL)
+        {
+          ret = file_pwrite(sp->file, buf, size, *sp->offset);
+        }
+      else
+        {
+          ret = file_write(sp->file, buf, size);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      circbuf_readcommit(&dev->d_buffer, ret);
+      nmoved += ret;
+      if (sp->offset != NULL)
+        {
+          *sp->offset += ret;
+        }
+
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (nmoved > 0)
+    {
+      if (circbuf_used(&dev->d_buffer) <=
+          (dev->d_bufsize - dev->d_polloutthrd))
+        {
+          poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+        }
+
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return nmoved > 0 ? nmoved : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_in
+ *
+ * Description:
+ *   Read from another file straight into the free space of the circular
+ *   buffer.  Waits only while the pipe is full and nothing has been moved.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_in(FAR struct file *filep,
+                                    FAR struct pipe_splice_s *sp)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                nmoved = 0;
+  FAR void              *buf;
+  size_t                 size;
+  ssize_t                ret;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (sp->flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Fill the contiguous runs of free space (at most two) */
+
+  while ((size_t)nmoved < sp->len)
+    {
+      buf  = circbuf_get_writeptr(&dev->d_buffer, &size);
+      size = MIN(size, sp->len - nmoved);
+      if (size == 0)
+        {
+          break;
+        }
+
+      if (sp->offset != NULL)
+        {
+          ret = file_pread(sp->file, buf, size, *sp->offset);
+        }
+      else
+        {
+          ret = file_read(sp->file, buf, size);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      circbuf_writecommit(&dev->d_buffer, ret);
+      nmoved += ret;
+      if (sp->offset != NULL)
+        {
+          *sp->offset += ret;
+        }
+
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (nmoved > 0)
+    {
+      if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+        {
+          poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+        }
+
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return nmoved > 0 ? nmoved : ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -903,6 +1122,27 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = -EINVAL;
         break;
 
+      /* The transfer may block on the pipe, the helpers take the lock
+       * themselves like read and write do.
+       */
+
+      case PIPEIOC_SPLICE:
+        {
+          FAR struct pipe_splice_s *sp =
+            (FAR struct pipe_splice_s *)((uintptr_t)arg);
+
+          nxrmutex_unlock(&dev->d_bflock);
+
+          DEBUGASSERT(sp != NULL && sp->file != NULL);
+          if (sp->file->f_inode == inode)
+            {
+              return -EINVAL;
+            }
+
+          return sp->topipe ? pipecommon_splice_in(filep, sp) :
+                              pipecommon_splice_out(filep, sp);
+        }
+
       default:
         ret = -ENOTTY;
         break;
@@ -41,6 +41,43 @@
 typedef CODE void (*regmap_lock_t)(FAR void *);
 typedef CODE void (*regmap_unlock_t)(FAR void *);
 
+struct regmap_s;
+
+/* A run of consecutive register indexes (address / stride) held by a
+ * cache, with the bitmaps of the ones holding a value and of the ones not
+ * yet written to the device.
+ */
+
+struct regcache_block_s
+{
+  unsigned int          base;   /* Index of the first register */
+  unsigned int          count;  /* Number of registers */
+  FAR uint32_t         *valid;  /* Registers with a cached value */
+  FAR uint32_t         *dirty;  /* Registers to be written by the sync */
+  FAR unsigned int     *values; /* Register values */
+};
+
+/* Register cache implementation */
+
+struct regcache_ops_s
+{
+  CODE int (*init)(FAR struct regmap_s *map);
+  CODE void (*exit)(FAR struct regmap_s *map);
+
+  /* Return the block holding index, allocating it if create is set */
+
+  CODE FAR struct regcache_block_s *(*lookup)(FAR struct regmap_s *map,
+                                              unsigned int index,
+                                              bool create);
+
+  /* Return the block after block in index order, the first one if block
+   * is NULL.
+   */
+
+  CODE FAR struct regcache_block_s *(*next)(FAR struct regmap_s *map,
+                                   FAR struct regcache_block_s *block);
+};
+
 /* Configuration for the register map of a device.
  * This structure is only used inside regmap.
  */
@@ -81,9 +118,84 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Register cache, see regmap_config_s */
+
+  FAR const struct regcache_ops_s *cache_ops;
+  FAR void *cache;
+  unsigned int max_register;
+  regmap_volatile_t volatile_reg;
+  bool use_single_write;
+  bool cache_only;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Create the register cache selected by the configuration, if any.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_read
+ *
+ * Description:
+ *   Return the cached value of a register, -ENOENT if it is not cached.
+ *
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val);
+
+/****************************************************************************
+ * Name: regcache_write
+ *
+ * Description:
+ *   Store the value of a register in the cache, marked dirty if it has not
+ *   been written to the device.  Uncacheable registers are ignored.
+ *
+ ****************************************************************************/
+
+void regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                    unsigned int val, bool dirty);
+
+/****************************************************************************
+ * Name: regcache_drop
+ *
+ * Description:
+ *   Forget the cached values of nregs registers starting at reg.
+ *
+ ****************************************************************************/
+
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int nregs);
+
+/****************************************************************************
+ * Name: regcache_cacheable
+ ****************************************************************************/
+
+bool regcache_cacheable(FAR struct regmap_s *map, unsigned int reg);
+
+#endif /* CONFIG_REGMAP_CACHE */
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
@@ -0,0 +1,590 @@
+/****************************************************************************
+ * drivers/regmap/regcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/tree.h>
+
+#include <errno.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/regmap/regmap.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_BITMAP_WORDS(n)   (((n) + 31) / 32)
+#define REGCACHE_TEST(bm, i)       (((bm)[(i) / 32] >> ((i) % 32)) & 1)
+#define REGCACHE_SET(bm, i)        ((bm)[(i) / 32] |= 1u << ((i) % 32))
+#define REGCACHE_CLEAR(bm, i)      ((bm)[(i) / 32] &= ~(1u << ((i) % 32)))
+
+/* Number of registers of an rbtree node, nodes start at a multiple of it */
+
+#define REGCACHE_RBTREE_NREGS      32
+
+/* Largest run of registers written by one regcache_sync() bus transfer */
+
+#define REGCACHE_SYNC_NREGS        32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Flat cache: one block covering register 0 to max_register */
+
+struct regcache_flat_s
+{
+  struct regcache_block_s block;
+};
+
+/* Rbtree cache: one node per REGCACHE_RBTREE_NREGS aligned registers
+ * which have been accessed.
+ */
+
+struct regcache_rbnode_s
+{
+  RB_ENTRY(regcache_rbnode_s) link;
+  struct regcache_block_s     block;
+  uint32_t                    valid;
+  uint32_t                    dirty;
+  unsigned int                values[REGCACHE_RBTREE_NREGS];
+};
+
+RB_HEAD(regcache_rbtree_s, regcache_rbnode_s);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map);
+static void regcache_flat_exit(FAR struct regmap_s *map);
+static FAR struct regcache_block_s *
+regcache_flat_lookup(FAR struct regmap_s *map, unsigned int index,
+                     bool create);
+static FAR struct regcache_block_s *
+regcache_flat_next(FAR struct regmap_s *map,
+                   FAR struct regcache_block_s *block);
+
+static int regcache_rbtree_init(FAR struct regmap_s *map);
+static void regcache_rbtree_exit(FAR struct regmap_s *map);
+static FAR struct regcache_block_s *
+regcache_rbtree_lookup(FAR struct regmap_s *map, unsigned int index,
+                       bool create);
+static FAR struct regcache_block_s *
+regcache_rbtree_next(FAR struct regmap_s *map,
+                     FAR struct regcache_block_s *block);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct regcache_ops_s g_regcache_flat_ops =
+{
+  regcache_flat_init,
+  regcache_flat_exit,
+  regcache_flat_lookup,
+  regcache_flat_next,
+};
+
+static const struct regcache_ops_s g_regcache_rbtree_ops =
+{
+  regcache_rbtree_init,
+  regcache_rbtree_exit,
+  regcache_rbtree_lookup,
+  regcache_rbtree_next,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_flat_init
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map)
+{
+  unsigned int count = map->max_register / map->reg_stride + 1;
+  unsigned int words = REGCACHE_BITMAP_WORDS(count);
+  FAR struct regcache_flat_s *flat;
+
+  flat = kmm_zalloc(sizeof(*flat) + 2 * words * sizeof(uint32_t) +
+                    count * sizeof(unsigned int));
+  if (flat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flat->block.count  = count;
+  flat->block.valid  = (FAR uint32_t *)(flat + 1);
+  flat->block.dirty  = flat->block.valid + words;
+  flat->block.values = (FAR unsigned int *)(flat->block.dirty + words);
+
+  map->cache = flat;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_flat_exit
+ ****************************************************************************/
+
+static void regcache_flat_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+}
+
+/****************************************************************************
+ * Name: regcache_flat_lookup
+ ****************************************************************************/
+
+static FAR struct regcache_block_s *
+regcache_flat_lookup(FAR struct regmap_s *map, unsigned int index,
+                     bool create)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+
+  return &flat->block;
+}
+
+/****************************************************************************
+ * Name: regcache_flat_next
+ ****************************************************************************/
+
+static FAR struct regcache_block_s *
+regcache_flat_next(FAR struct regmap_s *map,
+                   FAR struct regcache_block_s *block)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+
+  return block == NULL ? &flat->block : NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_rbtree_compare
+ ****************************************************************************/
+
+static int regcache_rbtree_compare(FAR struct regcache_rbnode_s *a,
+                                   FAR struct regcache_rbnode_s *b)
+{
+  return a->block.base < b->block.base ? -1 :
+         a->block.base > b->block.base;
+}
+
+RB_GENERATE_STATIC(regcache_rbtree_s, regcache_rbnode_s, link,
+                   regcache_rbtree_compare);
+
+/****************************************************************************
+ * Name: regcache_rbtree_init
+ ****************************************************************************/
+
+static int regcache_rbtree_init(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbtree_s *tree;
+
+  tree = kmm_malloc(sizeof(*tree));
+  if (tree == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  RB_INIT(tree);
+  map->cache = tree;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_rbtree_exit
+ ****************************************************************************/
+
+static void regcache_rbtree_exit(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbtree_s *tree = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  FAR struct regcache_rbnode_s *temp;
+
+  RB_FOREACH_SAFE(node, regcache_rbtree_s, tree, temp)
+    {
+      RB_REMOVE(regcache_rbtree_s, tree, node);
+      kmm_free(node);
+    }
+
+  kmm_free(tree);
+}
+
+/****************************************************************************
+ * Name: regcache_rbtree_lookup
+ ****************************************************************************/
+
+static FAR struct regcache_block_s *
+regcache_rbtree_lookup(FAR struct regmap_s *map, unsigned int index,
+                       bool create)
+{
+  FAR struct regcache_rbtree_s *tree = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  struct regcache_rbnode_s search;
+
+  search.block.base = index - index % REGCACHE_RBTREE_NREGS;
+  node = RB_FIND(regcache_rbtree_s, tree, &search);
+  if (node != NULL || !create)
+    {
+      return node != NULL ? &node->block : NULL;
+    }
+
+  node = kmm_zalloc(sizeof(*node));
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  node->block.base   = search.block.base;
+  node->block.count  = REGCACHE_RBTREE_NREGS;
+  node->block.valid  = &node->valid;
+  node->block.dirty  = &node->dirty;
+  node->block.values = node->values;
+
+  RB_INSERT(regcache_rbtree_s, tree, node);
+  return &node->block;
+}
+
+/****************************************************************************
+ * Name: regcache_rbtree_next
+ ****************************************************************************/
+
+static FAR struct regcache_block_s *
+regcache_rbtree_next(FAR struct regmap_s *map,
+                     FAR struct regcache_block_s *block)
+{
+  FAR struct regcache_rbtree_s *tree = map->cache;
+  FAR struct regcache_rbnode_s *node;
+
+  if (block == NULL)
+    {
+      node = RB_MIN(regcache_rbtree_s, tree);
+    }
+  else
+    {
+      node = container_of(block, struct regcache_rbnode_s, block);
+      node = RB_NEXT(regcache_rbtree_s, tree, node);
+    }
+
+  return node != NULL ? &node->block : NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_sync_run
+ *
+ * Description:
+ *   Write count consecutive dirty registers starting at index of block
+ *   with one bus transfer: the register address followed by the values,
+ *   most significant byte first.
+ *
+ ****************************************************************************/
+
+static int regcache_sync_run(FAR struct regmap_s *map,
+                             FAR struct regcache_block_s *block,
+                             unsigned int index, unsigned int count)
+{
+  uint8_t buf[sizeof(uint32_t) * (REGCACHE_SYNC_NREGS + 1)];
+  unsigned int reg = (block->base + index) * map->reg_stride;
+  unsigned int len = 0;
+  unsigned int i;
+  int ret;
+  int j;
+
+  if (count == 1 || map->write == NULL || map->use_single_write)
+    {
+      for (i = 0; i < count; i++)
+        {
+          ret = map->reg_write(map->bus, reg + i * map->reg_stride,
+                               block->values[index + i]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      return 0;
+    }
+
+  for (j = map->reg_bytes - 1; j >= 0; j--)
+    {
+      buf[len++] = reg >> (8 * j);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      for (j = map->val_bytes - 1; j >= 0; j--)
+        {
+          buf[len++] = block->values[index + i] >> (8 * j);
+        }
+    }
+
+  ret = map->write(map->bus, buf, len);
+  return ret < 0 ? ret : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  switch (config->cache_type)
+    {
+      case REGCACHE_NONE:
+        return 0;
+
+      case REGCACHE_FLAT:
+        map->cache_ops = &g_regcache_flat_ops;
+        break;
+
+      case REGCACHE_RBTREE:
+        map->cache_ops = &g_regcache_rbtree_ops;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  map->max_register     = config->max_register;
+  map->volatile_reg     = config->volatile_reg;
+  map->use_single_write = config->use_single_write;
+
+  return map->cache_ops->init(map);
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  if (map->cache_ops != NULL)
+    {
+      map->cache_ops->exit(map);
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_cacheable
+ ****************************************************************************/
+
+bool regcache_cacheable(FAR struct regmap_s *map, unsigned int reg)
+{
+  return map->cache_ops != NULL && reg <= map->max_register &&
+         (map->volatile_reg == NULL || !map->volatile_reg(reg));
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val)
+{
+  FAR struct regcache_block_s *block;
+  unsigned int index = reg / map->reg_stride;
+
+  if (!regcache_cacheable(map, reg))
+    {
+      return -ENOENT;
+    }
+
+  block = map->cache_ops->lookup(map, index, false);
+  if (block == NULL || !REGCACHE_TEST(block->valid, index - block->base))
+    {
+      return -ENOENT;
+    }
+
+  *val = block->values[index - block->base];
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ ****************************************************************************/
+
+void regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                    unsigned int val, bool dirty)
+{
+  FAR struct regcache_block_s *block;
+  unsigned int index = reg / map->reg_stride;
+
+  if (!regcache_cacheable(map, reg))
+    {
+      return;
+    }
+
+  block = map->cache_ops->lookup(map, index, true);
+  if (block == NULL)
+    {
+      return;
+    }
+
+  index -= block->base;
+  block->values[index] = val;
+  REGCACHE_SET(block->valid, index);
+  if (dirty)
+    {
+      REGCACHE_SET(block->dirty, index);
+    }
+  else
+    {
+      REGCACHE_CLEAR(block->dirty, index);
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_drop
+ ****************************************************************************/
+
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int nregs)
+{
+  FAR struct regcache_block_s *block;
+  unsigned int index = reg / map->reg_stride;
+
+  if (map->cache_ops == NULL)
+    {
+      return;
+    }
+
+  while (nregs-- > 0)
+    {
+      block = map->cache_ops->lookup(map, index, false);
+      if (block != NULL && index - block->base < block->count)
+        {
+          REGCACHE_CLEAR(block->valid, index - block->base);
+          REGCACHE_CLEAR(block->dirty, index - block->base);
+        }
+
+      index++;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map)
+{
+  FAR struct regcache_block_s *block = NULL;
+  unsigned int i;
+
+  if (map->cache_ops == NULL)
+    {
+      return;
+    }
+
+  map->lock(map);
+  while ((block = map->cache_ops->next(map, block)) != NULL)
+    {
+      for (i = 0; i < REGCACHE_BITMAP_WORDS(block->count); i++)
+        {
+          block->dirty[i] = block->valid[i];
+        }
+    }
+
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_sync
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map)
+{
+  FAR struct regcache_block_s *block = NULL;
+  unsigned int start;
+  unsigned int end;
+  int ret = 0;
+
+  if (map->cache_ops == NULL)
+    {
+      return 0;
+    }
+
+  map->lock(map);
+  while (ret >= 0 && (block = map->cache_ops->next(map, block)) != NULL)
+    {
+      for (start = 0; start < block->count; start = end)
+        {
+          if (!REGCACHE_TEST(block->dirty, start))
+            {
+              end = start + 1;
+              continue;
+            }
+
+          /* Extend the run over the following dirty registers */
+
+          end = start + 1;
+          while (end < block->count && end - start < REGCACHE_SYNC_NREGS &&
+                 REGCACHE_TEST(block->dirty, end))
+            {
+              end++;
+            }
+
+          ret = regcache_sync_run(map, block, start, end - start);
+          if (ret < 0)
+            {
+              regmaperr("ERROR: Failed to sync register %u: %d\n",
+                     (block->base + start) * map->reg_stride, ret);
+              break;
+            }
+
+          while (start < end)
+            {
+              REGCACHE_CLEAR(block->dirty, start);
+              start++;
+            }
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
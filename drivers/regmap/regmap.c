@@ -61,6 +61,108 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+/****************************************************************************
+ * Name: regmap_read_unlocked
+ *
+ * Description:
+ *   Read a register from the cache, or from the bus and cache it.
+ *
+ ****************************************************************************/
+
+static int regmap_read_unlocked(FAR struct regmap_s *map, unsigned int reg,
+                                FAR unsigned int *val)
+{
+  union
+  {
+    uint8_t  u8;
+    uint16_t u16;
+    uint32_t u32;
+  } buf;
+
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_read(map, reg, val) >= 0)
+    {
+      return 0;
+    }
+
+  if (map->cache_only)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  buf.u32 = 0;
+  ret = map->reg_read(map->bus, reg, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (map->val_bytes)
+    {
+      case 1:
+        *val = buf.u8;
+        break;
+      case 2:
+        *val = buf.u16;
+        break;
+      default:
+        *val = buf.u32;
+        break;
+    }
+
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_write(map, reg, *val, false);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: regmap_write_unlocked
+ *
+ * Description:
+ *   Write a register to the bus and the cache, or only to the cache in
+ *   cache only mode.
+ *
+ ****************************************************************************/
+
+static int regmap_write_unlocked(FAR struct regmap_s *map, unsigned int reg,
+                                 unsigned int val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      if (!regcache_cacheable(map, reg))
+        {
+          return -EBUSY;
+        }
+
+      regcache_write(map, reg, val, true);
+      return 0;
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, val, false);
+    }
+  else
+    {
+      regcache_drop(map, reg, 1);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,6 +242,19 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -173,7 +288,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_unlocked(map, reg, val);
 
   map->unlock(map);
 
@@ -214,6 +329,17 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  regcache_drop(map, reg, val_count);
+#endif
+
   if (map->write != NULL)
     {
       ret = map->write(map->bus, val, val_bytes * val_count);
@@ -274,13 +400,29 @@ out:
 
 int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 {
+  unsigned int ival;
   int ret;
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  ret = regmap_read_unlocked(map, reg, &ival);
+  if (ret >= 0)
+    {
+      switch (map->val_bytes)
+        {
+          case 1:
+            *(FAR uint8_t *)val = ival;
+            break;
+          case 2:
+            *(FAR uint16_t *)val = ival;
+            break;
+          default:
+            *(FAR uint32_t *)val = ival;
+            break;
+        }
+    }
 
   map->unlock(map);
   return ret;
@@ -322,6 +464,14 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      map->unlock(map);
+      return -EBUSY;
+    }
+#endif
+
   if (map->read != NULL)
     {
       ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
@@ -359,6 +509,50 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits of mask in a register.  The register is
+ *   only written if its value changes, and is read from the cache if it
+ *   is cached.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits in mask.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_read_unlocked(map, reg, &orig);
+  if (ret >= 0)
+    {
+      tmp = (orig & ~mask) | (val & mask);
+      if (tmp != orig)
+        {
+          ret = regmap_write_unlocked(map, reg, tmp);
+        }
+    }
+
+  map->unlock(map);
+  return ret < 0 ? ret : 0;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -374,6 +568,10 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
 void regmap_exit(FAR struct regmap_s *map)
 {
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_exit(map);
+#endif
+
   if (!map->disable_locking)
     {
       nxmutex_destroy(&map->mutex[0]);
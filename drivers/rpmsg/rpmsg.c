@@ -26,10 +26,13 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+
 #include <metal/sys.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/rpmsg/rpmsg.h>
 
 #include "rpmsg_ping.h"
@@ -185,6 +188,47 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem)
   return rpmsg->ops->post(rpmsg, sem);
 }
 
+bool rpmsg_rxslot_put(FAR struct rpmsg_endpoint *ept,
+                      FAR struct rpmsg_rxslot_s *slot, FAR void *rxbuf,
+                      FAR void *dest, FAR const void *src, size_t len,
+                      bool last)
+{
+  if (slot->rxbuf != NULL)
+    {
+      memcpy(dest, src, len);
+      return false;
+    }
+
+  rpmsg_hold_rx_buffer(ept, rxbuf);
+  slot->dest = dest;
+  slot->src  = src;
+  slot->len  = len;
+  slot->last = last;
+  UP_DMB();
+  slot->rxbuf = rxbuf;
+  return true;
+}
+
+bool rpmsg_rxslot_get(FAR struct rpmsg_endpoint *ept,
+                      FAR struct rpmsg_rxslot_s *slot)
+{
+  FAR void *rxbuf = slot->rxbuf;
+  bool last;
+
+  if (rxbuf == NULL)
+    {
+      return false;
+    }
+
+  UP_DMB();
+  memcpy(slot->dest, slot->src, slot->len);
+  last = slot->last;
+  rpmsg_release_rx_buffer(ept, rxbuf);
+  UP_DMB();
+  slot->rxbuf = NULL;
+  return !last;
+}
+
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev)
 {
   FAR struct rpmsg_s *rpmsg = rpmsg_get_by_rdev(rdev);
@@ -24,10 +24,15 @@
  * Included Files
  ****************************************************************************/
 
+#include <debug.h>
+#include <inttypes.h>
 #include <stdio.h>
 
+#include <sys/param.h>
+
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 
 #include <metal/mutex.h>
 #include <metal/sys.h>
@@ -122,6 +127,48 @@ rpmsg_port_remove_node(FAR struct rpmsg_port_list_s *list)
   return node;
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_merge_buffer
+ *
+ * Description:
+ *   Append the records of hdr to the last frame of the ready list if they
+ *   fit, the caller returns hdr to the free list on success. The transport
+ *   removes a frame from the ready list before sending it, so the frame
+ *   found here is not in flight.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_BATCH
+static bool
+rpmsg_port_queue_merge_buffer(FAR struct rpmsg_port_queue_s *queue,
+                              FAR struct rpmsg_port_header_s *hdr)
+{
+  uint16_t len = hdr->len - sizeof(*hdr);
+  FAR struct rpmsg_port_header_s *tail;
+  FAR struct list_node *node;
+  bool merged = false;
+  irqstate_t flags;
+  uint16_t offset;
+
+  flags = spin_lock_irqsave(&queue->ready.lock);
+  node = list_peek_tail(&queue->ready.head);
+  if (node != NULL)
+    {
+      tail = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      offset = ALIGN_UP(tail->len, RPMSG_PORT_RECORD_ALIGN);
+      if (offset + len <= queue->len)
+        {
+          memcpy((FAR uint8_t *)tail + offset, hdr->buf, len);
+          tail->len = offset + len;
+          merged = true;
+        }
+    }
+
+  spin_unlock_irqrestore(&queue->ready.lock, flags);
+  return merged;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_destroy_queue
  *
@@ -260,15 +307,14 @@ rpmsg_port_get_tx_payload_buffer(FAR struct rpmsg_device *rdev,
 }
 
 /****************************************************************************
- * Name: rpmsg_port_send_offchannel_nocopy
+ * Name: rpmsg_port_send_buffer
  ****************************************************************************/
 
-static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
-                                             uint32_t src, uint32_t dst,
-                                             FAR const void *data, int len)
+static void rpmsg_port_send_buffer(FAR struct rpmsg_port_s *port,
+                                   uint32_t src, uint32_t dst,
+                                   FAR const void *data, int len,
+                                   uint16_t flags)
 {
-  FAR struct rpmsg_port_s *port =
-    metal_container_of(rdev, struct rpmsg_port_s, rdev);
   FAR struct rpmsg_port_header_s *hdr;
   FAR struct rpmsg_hdr *rphdr;
 
@@ -277,18 +323,90 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   rphdr->src = src;
   rphdr->len = len;
   rphdr->reserved = 0;
-  rphdr->flags = 0;
+  rphdr->flags = flags;
 
   hdr = metal_container_of(rphdr, struct rpmsg_port_header_s, buf);
   hdr->len = sizeof(struct rpmsg_port_header_s) +
              sizeof(struct rpmsg_hdr) + len;
 
-  rpmsg_port_queue_add_buffer(&port->txq, hdr);
+#ifdef CONFIG_RPMSG_PORT_BATCH
+  if (len <= CONFIG_RPMSG_PORT_BATCH_MAXLEN &&
+      rpmsg_port_queue_merge_buffer(&port->txq, hdr))
+    {
+      rpmsg_port_queue_return_buffer(&port->txq, hdr);
+    }
+  else
+#endif
+    {
+      rpmsg_port_queue_add_buffer(&port->txq, hdr);
+    }
+
   if (port->ops->notify_tx_ready)
     {
       port->ops->notify_tx_ready(port);
     }
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_send_offchannel_nocopy
+ ****************************************************************************/
+
+static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
+                                             uint32_t src, uint32_t dst,
+                                             FAR const void *data, int len)
+{
+  FAR struct rpmsg_port_s *port =
+    metal_container_of(rdev, struct rpmsg_port_s, rdev);
+
+  rpmsg_port_send_buffer(port, src, dst, data, len, 0);
+  return len;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_send_fragments
+ *
+ * Description:
+ *   Send a message larger than one frame as a sequence of fragments which
+ *   the peer reassembles before calling the endpoint. Fragmented messages
+ *   are serialized against each other, other messages may be interleaved.
+ *
+ ****************************************************************************/
+
+static int rpmsg_port_send_fragments(FAR struct rpmsg_device *rdev,
+                                     uint32_t src, uint32_t dst,
+                                     FAR const void *data,
+                                     int len, int wait)
+{
+  FAR struct rpmsg_port_s *port =
+    metal_container_of(rdev, struct rpmsg_port_s, rdev);
+  uint16_t flags = RPMSG_PORT_FLAG_FRAG;
+  uint32_t buflen;
+  FAR void *buf;
+  int offset;
+
+  buflen = port->txq.len - sizeof(struct rpmsg_port_header_s) -
+           sizeof(struct rpmsg_hdr);
+  if (!wait &&
+      rpmsg_port_queue_navail(&port->txq) < (len + buflen - 1) / buflen)
+    {
+      return RPMSG_ERR_NO_BUFF;
+    }
+
+  nxmutex_lock(&port->txfraglock);
+  for (offset = 0; offset < len; offset += buflen)
+    {
+      buf = rpmsg_port_get_tx_payload_buffer(rdev, &buflen, true);
+      if (len - offset <= buflen)
+        {
+          buflen = len - offset;
+          flags |= RPMSG_PORT_FLAG_FRAG_LAST;
+        }
+
+      memcpy(buf, (FAR const uint8_t *)data + offset, buflen);
+      rpmsg_port_send_buffer(port, src, dst, buf, buflen, flags);
+    }
 
+  nxmutex_unlock(&port->txfraglock);
   return len;
 }
 
@@ -301,21 +419,54 @@ static int rpmsg_port_send_offchannel_raw(FAR struct rpmsg_device *rdev,
                                           FAR const void *data,
                                           int len, int wait)
 {
+  FAR struct rpmsg_port_s *port =
+    metal_container_of(rdev, struct rpmsg_port_s, rdev);
   uint32_t buflen;
   FAR void *buf;
 
+  if (len > port->txq.len - sizeof(struct rpmsg_port_header_s) -
+            sizeof(struct rpmsg_hdr))
+    {
+      return rpmsg_port_send_fragments(rdev, src, dst, data, len, wait);
+    }
+
   buf = rpmsg_port_get_tx_payload_buffer(rdev, &buflen, wait);
   if (buf == NULL)
     {
       return RPMSG_ERR_NO_BUFF;
     }
 
-  RPMSG_ASSERT(len <= buflen, "Send size larger than buffer size\n");
   memcpy(buf, data, len);
 
   return rpmsg_port_send_offchannel_nocopy(rdev, src, dst, buf, len);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_rx_owner
+ *
+ * Description:
+ *   Return the record holding the hold count of an rx buffer: all records
+ *   of a frame share the count of the first one, a reassembled message
+ *   has its own.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsg_hdr *
+rpmsg_port_rx_owner(FAR struct rpmsg_port_s *port, FAR void *rxbuf)
+{
+  FAR struct rpmsg_hdr *rphdr = RPMSG_LOCATE_HDR(rxbuf);
+  FAR struct rpmsg_port_header_s *hdr;
+
+  if (rphdr->flags & RPMSG_PORT_FLAG_ALLOC)
+    {
+      return rphdr;
+    }
+
+  hdr = RPMSG_PORT_NODE_TO_BUF(&port->rxq,
+                               RPMSG_PORT_BUF_TO_NODE(&port->rxq, rphdr));
+  return (FAR struct rpmsg_hdr *)hdr->buf;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_hold_rx_buffer
  ****************************************************************************/
@@ -323,7 +474,9 @@ static int rpmsg_port_send_offchannel_raw(FAR struct rpmsg_device *rdev,
 static void rpmsg_port_hold_rx_buffer(FAR struct rpmsg_device *rdev,
                                       FAR void *rxbuf)
 {
-  FAR struct rpmsg_hdr *rphdr = RPMSG_LOCATE_HDR(rxbuf);
+  FAR struct rpmsg_port_s *port =
+    metal_container_of(rdev, struct rpmsg_port_s, rdev);
+  FAR struct rpmsg_hdr *rphdr = rpmsg_port_rx_owner(port, rxbuf);
 
   atomic_fetch_add(&rphdr->reserved, 1 << RPMSG_BUF_HELD_SHIFT);
 }
@@ -337,13 +490,22 @@ static void rpmsg_port_release_rx_buffer(FAR struct rpmsg_device *rdev,
 {
   FAR struct rpmsg_port_s *port =
     metal_container_of(rdev, struct rpmsg_port_s, rdev);
-  FAR struct rpmsg_hdr *rphdr = RPMSG_LOCATE_HDR(rxbuf);
+  FAR struct rpmsg_hdr *rphdr = rpmsg_port_rx_owner(port, rxbuf);
   FAR struct rpmsg_port_header_s *hdr =
     metal_container_of(rphdr, struct rpmsg_port_header_s, buf);
   uint32_t reserved =
     atomic_fetch_sub(&rphdr->reserved, 1 << RPMSG_BUF_HELD_SHIFT);
 
-  if ((reserved & RPMSG_BUF_HELD_MASK) == (1 << RPMSG_BUF_HELD_SHIFT))
+  if ((reserved & RPMSG_BUF_HELD_MASK) != (1 << RPMSG_BUF_HELD_SHIFT))
+    {
+      return;
+    }
+
+  if (rphdr->flags & RPMSG_PORT_FLAG_ALLOC)
+    {
+      kmm_free(rphdr);
+    }
+  else
     {
       rpmsg_port_queue_return_buffer(&port->rxq, hdr);
       if (port->ops->notify_rx_free)
@@ -397,14 +559,13 @@ static int rpmsg_port_get_rx_buffer_size(FAR struct rpmsg_device *rdev)
 }
 
 /****************************************************************************
- * Name: rpmsg_port_rx_callback
+ * Name: rpmsg_port_rx_deliver
  ****************************************************************************/
 
-static void rpmsg_port_rx_callback(FAR struct rpmsg_port_s *port,
-                                   FAR struct rpmsg_port_header_s *hdr)
+static void rpmsg_port_rx_deliver(FAR struct rpmsg_port_s *port,
+                                  FAR struct rpmsg_hdr *rphdr, size_t len)
 {
   FAR struct rpmsg_device *rdev = &port->rdev;
-  FAR struct rpmsg_hdr *rphdr = (FAR struct rpmsg_hdr *)hdr->buf;
   FAR void *data = RPMSG_LOCATE_DATA(rphdr);
   FAR struct rpmsg_endpoint *ept;
   int status;
@@ -422,7 +583,7 @@ static void rpmsg_port_rx_callback(FAR struct rpmsg_port_s *port,
           ept->dest_addr = rphdr->src;
         }
 
-      status = ept->cb(ept, data, rphdr->len, rphdr->src, ept->priv);
+      status = ept->cb(ept, data, len, rphdr->src, ept->priv);
       if (status < 0)
         {
           RPMSG_ASSERT(0, "unexpected callback status\n");
@@ -435,6 +596,117 @@ static void rpmsg_port_rx_callback(FAR struct rpmsg_port_s *port,
   metal_mutex_release(&rdev->lock);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_rx_reset
+ ****************************************************************************/
+
+static void rpmsg_port_rx_reset(FAR struct rpmsg_port_s *port)
+{
+  port->rxfrag = NULL;
+  port->rxfraglen = 0;
+  port->rxfragsize = 0;
+  port->rxfragdrop = false;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_rx_reassemble
+ *
+ * Description:
+ *   Append a fragment to the message being reassembled and deliver it with
+ *   the last fragment. A message which cannot be allocated is dropped.
+ *
+ ****************************************************************************/
+
+static void rpmsg_port_rx_reassemble(FAR struct rpmsg_port_s *port,
+                                     FAR struct rpmsg_hdr *rphdr)
+{
+  FAR struct rpmsg_hdr *frag = port->rxfrag;
+  size_t len;
+
+  if (!port->rxfragdrop &&
+      port->rxfraglen + rphdr->len > port->rxfragsize)
+    {
+      len = MAX(port->rxfragsize * 2, port->rxfraglen + rphdr->len);
+      frag = kmm_realloc(port->rxfrag, sizeof(struct rpmsg_hdr) + len);
+      if (frag == NULL)
+        {
+          rpmsgerr("drop fragmented message from %" PRIu32 "\n",
+                   rphdr->src);
+          kmm_free(port->rxfrag);
+          rpmsg_port_rx_reset(port);
+          port->rxfragdrop = true;
+        }
+      else
+        {
+          port->rxfrag = frag;
+          port->rxfragsize = len;
+        }
+    }
+
+  if (!port->rxfragdrop)
+    {
+      memcpy((FAR uint8_t *)RPMSG_LOCATE_DATA(frag) + port->rxfraglen,
+             RPMSG_LOCATE_DATA(rphdr), rphdr->len);
+      port->rxfraglen += rphdr->len;
+    }
+
+  if (rphdr->flags & RPMSG_PORT_FLAG_FRAG_LAST)
+    {
+      len = port->rxfraglen;
+      rpmsg_port_rx_reset(port);
+      if (frag != NULL)
+        {
+          frag->src = rphdr->src;
+          frag->dst = rphdr->dst;
+          frag->reserved = 0;
+          frag->len = 0;
+          frag->flags = RPMSG_PORT_FLAG_ALLOC;
+          rpmsg_port_rx_deliver(port, frag, len);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_rx_callback
+ ****************************************************************************/
+
+static void rpmsg_port_rx_callback(FAR struct rpmsg_port_s *port,
+                                   FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct rpmsg_hdr *first = (FAR struct rpmsg_hdr *)hdr->buf;
+  FAR struct rpmsg_hdr *rphdr;
+  uint32_t offset = sizeof(*hdr);
+
+  /* Hold the frame while its records are delivered, the last release
+   * returns it to the rx queue.
+   */
+
+  first->reserved = 1 << RPMSG_BUF_HELD_SHIFT;
+  while (offset + sizeof(struct rpmsg_hdr) <= hdr->len)
+    {
+      rphdr = (FAR struct rpmsg_hdr *)((FAR uint8_t *)hdr + offset);
+      offset += sizeof(struct rpmsg_hdr) + rphdr->len;
+      if (offset > hdr->len)
+        {
+          rpmsgerr("truncated record in frame, dropped\n");
+          break;
+        }
+
+      if (rphdr->flags & RPMSG_PORT_FLAG_FRAG)
+        {
+          rpmsg_port_rx_reassemble(port, rphdr);
+        }
+      else
+        {
+          rpmsg_port_rx_deliver(port, rphdr, rphdr->len);
+        }
+
+      offset = ALIGN_UP(offset, RPMSG_PORT_RECORD_ALIGN);
+    }
+
+  rpmsg_port_release_rx_buffer(&port->rdev, RPMSG_LOCATE_DATA(first));
+}
+
 /****************************************************************************
  * Name: rpmsg_port_ns_callback
  ****************************************************************************/
@@ -592,6 +864,8 @@ int rpmsg_port_initialize(FAR struct rpmsg_port_s *port,
 
   port->ops = ops;
   strlcpy(port->cpuname, cfg->remotecpu, RPMSG_NAME_SIZE);
+  nxmutex_init(&port->txfraglock);
+  rpmsg_port_rx_reset(port);
 
   rdev = &port->rdev;
   memset(rdev, 0, sizeof(*rdev));
@@ -642,6 +916,8 @@ void rpmsg_port_uninitialize(FAR struct rpmsg_port_s *port)
     }
 
   metal_mutex_deinit(&rdev->lock);
+  nxmutex_destroy(&port->txfraglock);
+  kmm_free(port->rxfrag);
   rpmsg_port_destroy_queues(port);
 }
 
@@ -763,6 +1039,11 @@ void rpmsg_port_unregister(FAR struct rpmsg_port_s *port)
   rpmsg_unregister(name, &port->rpmsg);
 
   rpmsg_device_destory(&port->rpmsg);
+
+  /* Drop a message the peer did not finish sending */
+
+  kmm_free(port->rxfrag);
+  rpmsg_port_rx_reset(port);
 }
 
 /****************************************************************************
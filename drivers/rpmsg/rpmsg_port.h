@@ -32,16 +32,38 @@
 #include <nuttx/atomic.h>
 
 #include <nuttx/list.h>
+#include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/rpmsg/rpmsg_port.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RPMSG_PORT_RECORD_ALIGN   8
+
+/* struct rpmsg_hdr flags: the record is a piece of a message larger than
+ * one frame, and the last piece of it.
+ */
+
+#define RPMSG_PORT_FLAG_FRAG      0x0001
+#define RPMSG_PORT_FLAG_FRAG_LAST 0x0002
+
+/* Local only: the record heads a reassembled message on the heap */
+
+#define RPMSG_PORT_FLAG_ALLOC     0x8000
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
-/* This header is for physical layer's use */
+/* This header is for physical layer's use. A frame carries one or more
+ * struct rpmsg_hdr records, each starting RPMSG_PORT_RECORD_ALIGN aligned
+ * from the frame start; len covers the frame up to the end of the last
+ * record.
+ */
 
 begin_packed_struct struct rpmsg_port_header_s
 {
@@ -126,6 +148,17 @@ struct rpmsg_port_s
   /* Ops need implemented by drivers under port layer */
 
   const FAR struct rpmsg_port_ops_s *ops;
+
+  /* Serialize the fragments of messages larger than one frame */
+
+  mutex_t                           txfraglock;
+
+  /* Message being reassembled from the fragments sent by the peer */
+
+  FAR struct rpmsg_hdr              *rxfrag;
+  size_t                            rxfraglen;
+  size_t                            rxfragsize;
+  bool                              rxfragdrop;
 };
 
 #ifndef __ASSEMBLY__
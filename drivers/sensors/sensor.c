@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -36,10 +37,12 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
 
@@ -53,6 +56,16 @@
 #define DEVNAME_FMT         "/dev/uorb/sensor_%s%d"
 #define TIMING_BUF_ESIZE    (sizeof(uint32_t))
 
+/* The shared sample ring must be readable by user space */
+
+#ifdef CONFIG_BUILD_KERNEL
+#  define sensor_zalloc(s)  kmm_zalloc(s)
+#  define sensor_free(p)    kmm_free(p)
+#else
+#  define sensor_zalloc(s)  kumm_zalloc(s)
+#  define sensor_free(p)    kumm_free(p)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,6 +115,10 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+  bool             mapped;     /* The user follows the ring through mmap */
+  uint32_t         mapseq;     /* The samples published at the last poll */
+  uint64_t         notified;   /* The time of the last data wakeup, in us */
+  uint32_t         npending;   /* The samples pushed since that wakeup */
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -119,6 +136,7 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+  FAR struct sensor_mmap_s *shm;         /* Shared header, data follow */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
 };
@@ -137,6 +155,8 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -228,7 +248,7 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
-  NULL,           /* mmap */
+  sensor_mmap,    /* mmap */
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -390,6 +410,59 @@ update:
   return ret;
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size = lower->nbuffer * upper->state.esize;
+  int ret;
+
+  /* The data live right behind the header shared with mmap() users */
+
+  upper->shm = sensor_zalloc(sizeof(struct sensor_mmap_s) + size);
+  if (upper->shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->shm->esize   = upper->state.esize;
+  upper->shm->nbuffer = lower->nbuffer;
+
+  ret = circbuf_init(&upper->buffer, upper->shm + 1, size);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  sensor_free(upper->shm);
+  upper->shm = NULL;
+  return ret;
+}
+
+static bool sensor_wakeup_due(FAR struct sensor_upperhalf_s *upper,
+                              FAR struct sensor_user_s *user,
+                              uint64_t now)
+{
+  /* Coalesce the wakeups to the batch latency the user asked for, but
+   * never let the pending samples fill more than half of the buffer.
+   */
+
+  return user->state.latency == 0 ||
+         user->state.latency == UINT32_MAX ||
+         now - user->notified >= user->state.latency ||
+         user->npending >= MAX(upper->lower->nbuffer / 2, 1);
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -408,7 +481,11 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
 {
   long delta = (long long)upper->state.generation - user->state.generation;
 
-  if (delta <= 0)
+  if (user->mapped)
+    {
+      return user->mapseq != upper->shm->written;
+    }
+  else if (delta <= 0)
     {
       return false;
     }
@@ -1065,6 +1142,13 @@ static int sensor_poll(FAR struct file *filep,
         }
       else if (sensor_is_updated(upper, user))
         {
+          /* A mmap() user consumes everything published so far */
+
+          if (user->mapped)
+            {
+              user->mapseq = upper->shm->written;
+            }
+
           eventset |= POLLIN;
         }
 
@@ -1086,13 +1170,65 @@ errout:
   return ret;
 }
 
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  size_t size;
+  int ret = OK;
+
+  if ((filep->f_oflags & O_RDOK) == 0 || (map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+#ifdef CONFIG_BUILD_KERNEL
+  /* The ring is kernel heap, there is no user mapping of it */
+
+  UNUSED(upper);
+  UNUSED(user);
+  UNUSED(size);
+  UNUSED(ret);
+  return -ENOTSUP;
+#else
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_init_buffer(upper);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  size = sizeof(struct sensor_mmap_s) + circbuf_size(&upper->buffer);
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > size)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  map->vaddr   = (FAR char *)upper->shm + map->offset;
+  user->mapseq = upper->shm->written;
+  user->mapped = true;
+
+errout:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+#endif
+}
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
+  uint64_t now;
   int semcount;
   int ret;
 
@@ -1125,30 +1261,35 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
+      ret = sensor_init_buffer(upper);
       if (ret < 0)
         {
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
     }
 
+  /* Announce the slots about to be overwritten to mmap() readers */
+
+  upper->shm->writing += envcount;
+  UP_DMB();
   circbuf_overwrite(&upper->buffer, data, bytes);
+  UP_DMB();
+  upper->shm->written += envcount;
   sensor_generate_timing(upper, envcount);
+  now = sensor_get_timestamp();
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
         {
+          user->npending += envcount;
+          if (!sensor_wakeup_due(upper, user, now))
+            {
+              continue;
+            }
+
+          user->notified = now;
+          user->npending = 0;
           nxsem_get_value(&user->buffersem, &semcount);
           if (semcount < 1)
             {
@@ -1218,6 +1359,54 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
   memcpy(out, tmp, sizeof(tmp));
 }
 
+/****************************************************************************
+ * Name: sensor_push_batch
+ *
+ * Description:
+ *   Push the samples drained from a hardware FIFO in one call, with the
+ *   timestamps interpolated backwards from the time of the last sample.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_batch(FAR struct sensor_lowerhalf_s *lower,
+                          FAR void *data, size_t bytes, size_t esize,
+                          uint64_t timestamp, uint32_t period)
+{
+  FAR uint8_t *sample = data;
+  uint64_t measured;
+  size_t nsamples;
+  size_t i;
+
+  if (esize < sizeof(uint64_t) || bytes == 0 || bytes % esize != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Trust the measured period only while it is close to the nominal one,
+   * the FIFO was restarted or overflowed otherwise.
+   */
+
+  nsamples = bytes / esize;
+  if (lower->batch_timestamp != 0 && timestamp > lower->batch_timestamp)
+    {
+      measured = (timestamp - lower->batch_timestamp) / nsamples;
+      if (period == 0 || (measured > period / 2 && measured < period * 2))
+        {
+          period = measured;
+        }
+    }
+
+  lower->batch_timestamp = timestamp;
+  for (i = 0; i < nsamples; i++, sample += esize)
+    {
+      uint64_t ts = timestamp - (uint64_t)period * (nsamples - 1 - i);
+
+      memcpy(sample, &ts, sizeof(ts));
+    }
+
+  return lower->push_event(lower->priv, data, bytes);
+}
+
 /****************************************************************************
  * Name: sensor_register
  *
@@ -1447,6 +1636,7 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
     {
       circbuf_uninit(&upper->buffer);
       circbuf_uninit(&upper->timing);
+      sensor_free(upper->shm);
     }
 
   kmm_free(upper);
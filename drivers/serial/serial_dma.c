@@ -27,8 +27,10 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
 #include <nuttx/signal.h>
 
@@ -360,4 +362,150 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_dmaring
+ *
+ * Description:
+ *   Move the bytes a continuous circular DMA wrote up to position pos to
+ *   the RX circular buffer, in at most a few contiguous copies, and inform
+ *   the waiters once for the whole batch.  Bytes that do not fit the RX
+ *   buffer stay in the DMA ring, the lower half reports pos again from its
+ *   dmarxfree() method.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_dmaring(FAR uart_dev_t *dev, size_t pos)
+{
+  FAR struct uart_dmaring_s *ring = &dev->dmaring;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  unsigned int watermark;
+#endif
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo = 0;
+#endif
+#if defined(CONFIG_SERIAL_TERMIOS) || \
+    defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
+  size_t nbuffered;
+#endif
+  size_t ncopied = 0;
+  size_t nbytes;
+  size_t space;
+  int head = rxbuf->head;
+  int tail;
+
+  pos %= ring->size;
+
+  while (ring->tail != pos)
+    {
+      /* Contiguous new bytes in the DMA ring */
+
+      nbytes = pos > ring->tail ? pos - ring->tail :
+                                  ring->size - ring->tail;
+
+      /* Contiguous free space in the RX buffer, keeping one slot empty */
+
+      tail = rxbuf->tail;
+      if (tail > head)
+        {
+          space = tail - head - 1;
+        }
+      else
+        {
+          space = rxbuf->size - head - (tail == 0);
+        }
+
+      if (space == 0)
+        {
+          break;
+        }
+
+      nbytes = MIN(nbytes, space);
+      memcpy(&rxbuf->buffer[head], &ring->buffer[ring->tail], nbytes);
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+      if (signo == 0)
+        {
+          signo = uart_check_special(dev, &rxbuf->buffer[head], nbytes);
+        }
+#endif
+
+      head += nbytes;
+      if (head >= rxbuf->size)
+        {
+          head = 0;
+        }
+
+      ring->tail += nbytes;
+      if (ring->tail >= ring->size)
+        {
+          ring->tail = 0;
+        }
+
+      ncopied += nbytes;
+    }
+
+  rxbuf->head = head;
+
+#if defined(CONFIG_SERIAL_TERMIOS) || \
+    defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
+  tail = rxbuf->tail;
+  if (head >= tail)
+    {
+      nbuffered = head - tail;
+    }
+  else
+    {
+      nbuffered = rxbuf->size - tail + head;
+    }
+#endif
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  /* Let the lower half know that the watermark level has been crossed.
+   * The DMA keeps running, but the sender should pause.
+   */
+
+  watermark = (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * rxbuf->size) /
+              100;
+  if (nbuffered >= watermark)
+    {
+      uart_rxflowcontrol(dev, nbuffered, true);
+    }
+#else
+  /* Bytes are left in the DMA ring because the RX buffer is full */
+
+  if (ring->tail != pos)
+    {
+      uart_rxflowcontrol(dev, rxbuf->size, true);
+    }
+#endif
+#endif
+
+  /* One wakeup for the whole batch */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if (ncopied > 0 && nbuffered >= dev->minrecv)
+#else
+  if (ncopied > 0)
+#endif
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_tgkill(-1, dev->pid, signo);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
@@ -270,9 +270,11 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
   FAR union bt_hdr_u *hdr;
   enum bt_buf_type_e type;
   size_t reserved;
-  uint8_t *data;
+  FAR uint8_t *data;
+  FAR uint8_t *pkt;
   size_t pktlen;
   size_t hdrlen;
+  size_t off;
   int ret;
 
   ret = nxmutex_lock(&dev->sendlock);
@@ -302,25 +304,33 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
          buffer, buflen);
   dev->sendlen += buflen;
 
-  hdr = (FAR union bt_hdr_u *)data;
+  /* Send every complete packet where it lies and move only the incomplete
+   * tail, if any, once at the end.  A driver that needs more headroom than
+   * the H4 byte writes it over the packet before, which is already sent.
+   */
 
-  for (; ; )
+  for (off = 0; ; off += pktlen)
     {
-      switch (*(data - H4_HEADER_SIZE))
+      pkt = data - H4_HEADER_SIZE + off;
+      hdr = (FAR union bt_hdr_u *)(pkt + H4_HEADER_SIZE);
+
+      if (dev->sendlen - off < H4_HEADER_SIZE)
+        {
+          break;
+        }
+
+      switch (*pkt)
         {
           case H4_CMD:
             hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
-            pktlen = hdr->cmd.param_len;
             type = BT_CMD;
             break;
           case H4_ACL:
             hdrlen = sizeof(struct bt_hci_acl_hdr_s);
-            pktlen = hdr->acl.len;
             type = BT_ACL_OUT;
             break;
           case H4_ISO:
             hdrlen = sizeof(struct bt_hci_iso_hdr_s);
-            pktlen = hdr->iso.len;
             type = BT_ISO_OUT;
             break;
           default:
@@ -332,36 +342,49 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
 
       hdrlen += H4_HEADER_SIZE;
 
-      if (dev->sendlen < hdrlen)
+      if (dev->sendlen - off < hdrlen)
+        {
+          break;
+        }
+
+      if (type == BT_CMD)
+        {
+          pktlen = hdr->cmd.param_len;
+        }
+      else if (type == BT_ACL_OUT)
+        {
+          pktlen = hdr->acl.len;
+        }
+      else
         {
-          goto out;
+          pktlen = hdr->iso.len;
         }
 
       pktlen += hdrlen;
-      if (dev->sendlen < pktlen)
+      if (dev->sendlen - off < pktlen)
         {
-          goto out;
+          break;
         }
 
       /* Got the full packet, send out */
 
       ret = dev->drv->send(dev->drv, type,
-                           data, pktlen - H4_HEADER_SIZE);
+                           pkt + H4_HEADER_SIZE, pktlen - H4_HEADER_SIZE);
       if (ret < 0)
         {
           goto err;
         }
+    }
 
-      dev->sendlen -= pktlen;
-      if (dev->sendlen == 0)
-        {
-          goto out;
-        }
-
-      memmove(data - H4_HEADER_SIZE,
-              dev->sendbuf + pktlen, dev->sendlen);
+  dev->sendlen -= off;
+  if (off > 0 && dev->sendlen > 0)
+    {
+      memmove(data - H4_HEADER_SIZE, data - H4_HEADER_SIZE + off,
+              dev->sendlen);
     }
 
+  goto out;
+
 err:
   dev->sendlen = 0;
 out:
@@ -468,8 +491,9 @@ int uart_bth4_register(FAR const char *path, FAR struct bt_driver_s *drv)
     }
 
   dev->drv     = drv;
-  drv->receive = uart_bth4_receive;
-  drv->priv    = dev;
+  drv->receive     = uart_bth4_receive;
+  drv->receive_iob = NULL;
+  drv->priv        = dev;
 
   nxmutex_init(&dev->sendlock);
   nxmutex_init(&dev->openlock);
@@ -0,0 +1,195 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/list.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The transfer queue of one SPI bus */
+
+struct spi_async_s
+{
+  FAR struct spi_dev_s *spi;     /* The SPI bus the messages are run on */
+  spinlock_t            lock;    /* Protects pending */
+  sem_t                 sem;     /* Counts the pending messages */
+  struct list_node      pending; /* Messages waiting to be run */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_thread
+ *
+ * Description:
+ *   Run the queued messages back to back.  The semaphore counts the
+ *   messages, so a message queued while another one is on the bus is
+ *   started as soon as that one completes, without the submitter being
+ *   scheduled in between.
+ *
+ ****************************************************************************/
+
+static int spi_async_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_async_s *async =
+    (FAR struct spi_async_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&async->sem);
+
+      flags = spin_lock_irqsave(&async->lock);
+      msg = list_remove_head_type(&async->pending,
+                                  struct spi_message_s, node);
+      spin_unlock_irqrestore(&async->lock, flags);
+
+      if (msg == NULL)
+        {
+          continue;
+        }
+
+      ret = spi_transfer(async->spi, msg->seq);
+      if (msg->complete != NULL)
+        {
+          msg->complete(msg, ret);
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the transfer queue of an SPI bus.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device the queued messages are run on
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_async_s *async;
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(spi != NULL);
+
+  async = kmm_zalloc(sizeof(struct spi_async_s));
+  if (async == NULL)
+    {
+      spierr("ERROR: Failed to allocate the SPI queue\n");
+      return NULL;
+    }
+
+  async->spi = spi;
+  spin_lock_init(&async->lock);
+  nxsem_init(&async->sem, 0, 0);
+  list_initialize(&async->pending);
+
+  snprintf(arg1, sizeof(arg1), "%p", async);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("spi_async", CONFIG_SPI_ASYNC_PRIORITY,
+                       CONFIG_SPI_ASYNC_STACKSIZE, spi_async_thread, argv);
+  if (ret < 0)
+    {
+      spierr("ERROR: Failed to create the SPI queue thread: %d\n", ret);
+      nxsem_destroy(&async->sem);
+      kmm_free(async);
+      return NULL;
+    }
+
+  return async;
+}
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a message and return immediately.  The message is run with
+ *   spi_transfer() after the messages queued before it, then its complete
+ *   callback is called from the queue thread with the result.  The message
+ *   and the sequence it refers to must stay valid until then.  May be
+ *   called from interrupt context.
+ *
+ * Input Parameters:
+ *   async - The transfer queue of the SPI bus
+ *   msg   - The message to queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_async_s *async,
+                       FAR struct spi_message_s *msg)
+{
+  irqstate_t flags;
+
+  if (async == NULL || msg == NULL || msg->seq == NULL ||
+      msg->seq->trans == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&async->lock);
+  list_add_tail(&async->pending, &msg->node);
+  spin_unlock_irqrestore(&async->lock, flags);
+
+  return nxsem_post(&async->sem);
+}
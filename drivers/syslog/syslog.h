@@ -30,6 +30,29 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A message queued by the deferred logging: the arguments follow packed
+ * in the layout lib_bsprintf() expects.
+ */
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+struct syslog_deferred_s
+{
+  FAR const IPTR char *fmt;        /* Format string, resolved when drained */
+  struct timespec ts;              /* Time stamp of the message */
+  pid_t pid;                       /* Thread that logged the message */
+  uint8_t priority;                /* Message priority */
+  uint8_t cpu;                     /* CPU that logged the message */
+  bool hasts;                      /* ts is valid */
+};
+#endif
 
 /****************************************************************************
  * Public Data
@@ -229,6 +252,97 @@ void syslog_add_intbuffer(FAR const char *buffer, size_t buflen);
 void syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_add_async
+ *
+ * Description:
+ *   Queue a message on the per-CPU ring of the calling CPU for the drain
+ *   thread.  Never blocks.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   true if the message was queued (or dropped by the ring policy), false
+ *   if the caller must write it synchronously.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+bool syslog_add_async(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_flush_async
+ *
+ * Description:
+ *   Write out all queued messages from the calling context.
+ *
+ * Input Parameters:
+ *   force   - Use the force() method of the channel vs. the putc() method.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+void syslog_flush_async(bool force);
+#endif
+
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Queue a deferred record on the per-CPU ring of the calling CPU, the
+ *   drain thread formats it with syslog_format_deferred().
+ *
+ * Input Parameters:
+ *   rec - The record followed by its packed arguments
+ *   len - The total number of bytes of the record
+ *
+ * Returned Value:
+ *   true if the record was queued (or dropped by the ring policy), false
+ *   if the caller must format the message itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+bool syslog_add_deferred(FAR const struct syslog_deferred_s *rec,
+                         size_t len);
+#endif
+
+/****************************************************************************
+ * Name: syslog_format_deferred
+ *
+ * Description:
+ *   Format a deferred record exactly as nx_vsyslog() would have formatted
+ *   the message.
+ *
+ * Returned Value:
+ *   The number of bytes written to the stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_format_deferred(FAR struct lib_outstream_s *stream,
+                           FAR const struct syslog_deferred_s *rec);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_initialize
+ *
+ * Description:
+ *   Start the drain thread of the asynchronous SYSLOG rings.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+int syslog_async_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_write_foreach
  *
@@ -0,0 +1,609 @@
+/****************************************************************************
+ * drivers/syslog/syslog_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NCPUS                CONFIG_SMP_NCPUS
+#define SYSLOG_ASYNC_SIZE    CONFIG_SYSLOG_ASYNC_BUFSIZE
+#define SYSLOG_ASYNC_MASK    (SYSLOG_ASYNC_SIZE - 1)
+#define SYSLOG_ASYNC_HDRSIZE sizeof(struct syslog_async_hdr_s)
+#define SYSLOG_ASYNC_RECLEN(len) \
+  ALIGN_UP(SYSLOG_ASYNC_HDRSIZE + (len), sizeof(uint32_t))
+
+/* Record types */
+
+#define SYSLOG_ASYNC_TEXT     0    /* Formatted message */
+#define SYSLOG_ASYNC_DEFERRED 1    /* struct syslog_deferred_s */
+
+#if (SYSLOG_ASYNC_SIZE & SYSLOG_ASYNC_MASK) != 0
+#  error "CONFIG_SYSLOG_ASYNC_BUFSIZE must be a power of two"
+#endif
+
+/* Orders the ring data against the head/tail positions, the compiler
+ * barrier also covers the UP case where the drain thread is interrupted
+ * by a producer.
+ */
+
+#define syslog_async_barrier() \
+  do \
+    { \
+      UP_DMB(); \
+      __asm__ __volatile__("" ::: "memory"); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every message is stored as a header followed by its bytes, padded to a
+ * word boundary.  The global sequence number lets the drain thread put
+ * the messages of all CPUs back in emission order.
+ */
+
+struct syslog_async_hdr_s
+{
+  uint32_t seq;
+  uint16_t len;
+  uint8_t type;                    /* SYSLOG_ASYNC_TEXT/DEFERRED */
+};
+
+/* Single producer ring of one CPU.  Positions are free running byte
+ * counts: only the owning CPU (with local interrupts disabled) moves
+ * head, tail and dropped, only the drain side moves read and reported.
+ */
+
+struct syslog_async_ring_s
+{
+  volatile unsigned int head;      /* End of the last committed message */
+  volatile unsigned int tail;      /* Start of the oldest valid message */
+  volatile unsigned int read;      /* Next message to drain */
+  volatile unsigned int dropped;   /* Messages lost on this CPU */
+  unsigned int reported;           /* Lost messages already reported */
+  uint8_t buffer[SYSLOG_ASYNC_SIZE];
+};
+
+struct syslog_async_s
+{
+  sem_t sem;                       /* Wakes up the drain thread */
+  atomic_t seq;                    /* Next message sequence number */
+  volatile bool waiting;           /* The drain thread is about to sleep */
+  volatile bool running;           /* The drain thread was started */
+  struct syslog_async_ring_s ring[NCPUS];
+  char batch[SYSLOG_ASYNC_SIZE];   /* Output batch of the drain side */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_async_s g_syslog_async =
+{
+  SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_copyin/copyout
+ *
+ * Description:
+ *   Copy bytes into/out of a ring at a free running position.
+ *
+ ****************************************************************************/
+
+static void syslog_async_copyin(FAR struct syslog_async_ring_s *ring,
+                                unsigned int pos, FAR const void *src,
+                                size_t len)
+{
+  unsigned int offset = pos & SYSLOG_ASYNC_MASK;
+  size_t space = MIN(SYSLOG_ASYNC_SIZE - offset, len);
+
+  memcpy(ring->buffer + offset, src, space);
+  memcpy(ring->buffer, (FAR const uint8_t *)src + space, len - space);
+}
+
+static void syslog_async_copyout(FAR struct syslog_async_ring_s *ring,
+                                 unsigned int pos, FAR void *dest,
+                                 size_t len)
+{
+  unsigned int offset = pos & SYSLOG_ASYNC_MASK;
+  size_t space = MIN(SYSLOG_ASYNC_SIZE - offset, len);
+
+  memcpy(dest, ring->buffer + offset, space);
+  memcpy((FAR uint8_t *)dest + space, ring->buffer, len - space);
+}
+
+/****************************************************************************
+ * Name: syslog_async_valid
+ *
+ * Description:
+ *   Check, after copying data out, that the producer did not overwrite
+ *   the message at pos meanwhile.
+ *
+ ****************************************************************************/
+
+static inline bool syslog_async_valid(FAR struct syslog_async_ring_s *ring,
+                                      unsigned int pos)
+{
+  syslog_async_barrier();
+  return pos - ring->tail < SYSLOG_ASYNC_SIZE;
+}
+
+/****************************************************************************
+ * Name: syslog_async_peek
+ *
+ * Description:
+ *   Get the header of the next undrained message of a ring.
+ *
+ * Returned Value:
+ *   true and the message position in pos if the ring has a message.
+ *
+ ****************************************************************************/
+
+static bool syslog_async_peek(FAR struct syslog_async_ring_s *ring,
+                              FAR unsigned int *pos,
+                              FAR struct syslog_async_hdr_s *hdr)
+{
+  unsigned int head;
+  unsigned int tail;
+
+  do
+    {
+      head = ring->head;
+      syslog_async_barrier();
+
+      /* A read position already overwritten falls back to the oldest
+       * message.
+       */
+
+      tail = ring->tail;
+      *pos = ring->read;
+      if (*pos - tail > head - tail)
+        {
+          *pos = tail;
+        }
+
+      if (*pos == head)
+        {
+          return false;
+        }
+
+      syslog_async_copyout(ring, *pos, hdr, sizeof(*hdr));
+    }
+  while (!syslog_async_valid(ring, *pos));
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_async_format
+ *
+ * Description:
+ *   Format the deferred record at pos into the batch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+static size_t syslog_async_format(FAR struct syslog_async_ring_s *ring,
+                                  unsigned int pos,
+                                  FAR const struct syslog_async_hdr_s *hdr,
+                                  FAR char *batch, size_t size)
+{
+  uintptr_t record[CONFIG_SYSLOG_DEFERRED_RECSIZE / sizeof(uintptr_t)];
+  struct lib_memoutstream_s stream;
+
+  /* A record is only usable if it was not overwritten while copied */
+
+  if (hdr->len < sizeof(struct syslog_deferred_s) ||
+      hdr->len > sizeof(record))
+    {
+      return 0;
+    }
+
+  syslog_async_copyout(ring, pos + SYSLOG_ASYNC_HDRSIZE, record, hdr->len);
+  if (!syslog_async_valid(ring, pos))
+    {
+      return 0;
+    }
+
+  lib_memoutstream(&stream, batch, size);
+  syslog_format_deferred(&stream.common,
+                         (FAR const struct syslog_deferred_s *)record);
+  return stream.common.nput;
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_gather
+ *
+ * Description:
+ *   Move the pending messages of all CPUs, in sequence order, into the
+ *   batch buffer.  A message larger than an empty batch is truncated.
+ *
+ * Returned Value:
+ *   The number of bytes in the batch.
+ *
+ ****************************************************************************/
+
+static size_t syslog_async_gather(FAR char *batch, size_t size)
+{
+  FAR struct syslog_async_ring_s *ring;
+  struct syslog_async_hdr_s hdr;
+  struct syslog_async_hdr_s best;
+  unsigned int bestpos = 0;
+  unsigned int pos;
+  size_t nbytes = 0;
+  size_t len;
+  int cpu;
+
+  memset(&best, 0, sizeof(best));
+  for (; ; )
+    {
+      ring = NULL;
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          if (syslog_async_peek(&g_syslog_async.ring[cpu], &pos, &hdr) &&
+              (ring == NULL || (int32_t)(hdr.seq - best.seq) < 0))
+            {
+              ring    = &g_syslog_async.ring[cpu];
+              bestpos = pos;
+              best    = hdr;
+            }
+        }
+
+      if (ring == NULL || (nbytes > 0 && nbytes + best.len > size))
+        {
+          break;
+        }
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+      if (best.type == SYSLOG_ASYNC_DEFERRED)
+        {
+          /* Format into an empty batch only, the output size is unknown */
+
+          if (nbytes > 0)
+            {
+              break;
+            }
+
+          nbytes = syslog_async_format(ring, bestpos, &best, batch, size);
+          ring->read = bestpos + SYSLOG_ASYNC_RECLEN(best.len);
+          continue;
+        }
+#endif
+
+      len = MIN(best.len, size - nbytes);
+      syslog_async_copyout(ring, bestpos + SYSLOG_ASYNC_HDRSIZE,
+                           batch + nbytes, len);
+      if (syslog_async_valid(ring, bestpos))
+        {
+          nbytes += len;
+        }
+
+      ring->read = bestpos + SYSLOG_ASYNC_RECLEN(best.len);
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: syslog_async_report
+ *
+ * Description:
+ *   Report the messages dropped since the last report.
+ *
+ ****************************************************************************/
+
+static void syslog_async_report(bool force)
+{
+  char msg[64];
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct syslog_async_ring_s *ring = &g_syslog_async.ring[cpu];
+      unsigned int dropped = ring->dropped;
+
+      if (dropped != ring->reported)
+        {
+          int len = snprintf(msg, sizeof(msg),
+                             "[syslog: %u messages dropped on CPU%d]\n",
+                             dropped - ring->reported, cpu);
+
+          ring->reported = dropped;
+          syslog_write_foreach(msg, len, force);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_async_pending
+ ****************************************************************************/
+
+static bool syslog_async_pending(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct syslog_async_ring_s *ring = &g_syslog_async.ring[cpu];
+      unsigned int head = ring->head;
+      unsigned int tail = ring->tail;
+      unsigned int read = ring->read;
+
+      if (read - tail > head - tail ? tail != head : read != head)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: syslog_async_thread
+ *
+ * Description:
+ *   Drain the per-CPU rings to the SYSLOG channels in batches.
+ *
+ ****************************************************************************/
+
+static int syslog_async_thread(int argc, FAR char *argv[])
+{
+  size_t nbytes;
+
+  for (; ; )
+    {
+      nbytes = syslog_async_gather(g_syslog_async.batch,
+                                   sizeof(g_syslog_async.batch));
+      if (nbytes > 0)
+        {
+          syslog_write_foreach(g_syslog_async.batch, nbytes, false);
+          continue;
+        }
+
+      syslog_async_report(false);
+
+      /* Announce the sleep before the final check, a producer commits its
+       * message before it looks at the flag.
+       */
+
+      g_syslog_async.waiting = true;
+      syslog_async_barrier();
+      if (syslog_async_pending())
+        {
+          g_syslog_async.waiting = false;
+          continue;
+        }
+
+      nxsem_wait_uninterruptible(&g_syslog_async.sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_async_add
+ *
+ * Description:
+ *   Queue a record on the ring of the calling CPU for the drain thread.
+ *   Never blocks: when the ring is full the oldest records are evicted
+ *   (or, with CONFIG_SYSLOG_ASYNC_DROP_NEWEST, the new record is
+ *   discarded) and the loss is counted.
+ *
+ * Returned Value:
+ *   true if the record was taken over, false if it must be written
+ *   synchronously (the drain thread does not run yet or the system
+ *   panicked).
+ *
+ ****************************************************************************/
+
+static bool syslog_async_add(uint8_t type, FAR const void *buffer,
+                             size_t buflen)
+{
+  FAR struct syslog_async_ring_s *ring;
+  struct syslog_async_hdr_s hdr;
+  unsigned int reclen;
+  unsigned int head;
+  unsigned int tail;
+  irqstate_t flags;
+
+  if (!g_syslog_async.running)
+    {
+      return false;
+    }
+
+  if (g_nx_initstate >= OSINIT_PANIC)
+    {
+      /* Keep the order: queued messages go out before the crash report */
+
+      syslog_flush_async(true);
+      return false;
+    }
+
+  buflen = MIN(buflen, SYSLOG_ASYNC_SIZE - SYSLOG_ASYNC_HDRSIZE);
+  reclen = SYSLOG_ASYNC_RECLEN(buflen);
+
+  flags = up_irq_save();
+  ring  = &g_syslog_async.ring[this_cpu()];
+  head  = ring->head;
+  tail  = ring->tail;
+
+  if (head + reclen - tail > SYSLOG_ASYNC_SIZE)
+    {
+#ifdef CONFIG_SYSLOG_ASYNC_DROP_NEWEST
+      ring->dropped++;
+      up_irq_restore(flags);
+      return true;
+#else
+      do
+        {
+          syslog_async_copyout(ring, tail, &hdr, sizeof(hdr));
+          if ((int)(tail - ring->read) >= 0)
+            {
+              ring->dropped++;
+            }
+
+          tail += SYSLOG_ASYNC_RECLEN(hdr.len);
+        }
+      while (head + reclen - tail > SYSLOG_ASYNC_SIZE);
+
+      /* Publish the new tail before the old messages are overwritten */
+
+      ring->tail = tail;
+      syslog_async_barrier();
+#endif
+    }
+
+  hdr.seq = atomic_fetch_add(&g_syslog_async.seq, 1);
+  hdr.len = buflen;
+  hdr.type = type;
+  syslog_async_copyin(ring, head, &hdr, sizeof(hdr));
+  syslog_async_copyin(ring, head + SYSLOG_ASYNC_HDRSIZE, buffer, buflen);
+  syslog_async_barrier();
+  ring->head = head + reclen;
+  up_irq_restore(flags);
+
+  syslog_async_barrier();
+  if (g_syslog_async.waiting)
+    {
+      g_syslog_async.waiting = false;
+      nxsem_post(&g_syslog_async.sem);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_add_async
+ *
+ * Description:
+ *   Queue a formatted message for the drain thread.
+ *
+ ****************************************************************************/
+
+bool syslog_add_async(FAR const char *buffer, size_t buflen)
+{
+  return syslog_async_add(SYSLOG_ASYNC_TEXT, buffer, buflen);
+}
+
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Queue a deferred record for the drain thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+bool syslog_add_deferred(FAR const struct syslog_deferred_s *rec,
+                         size_t len)
+{
+  return syslog_async_add(SYSLOG_ASYNC_DEFERRED, rec, len);
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_flush_async
+ *
+ * Description:
+ *   Write out everything still queued from the calling context.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channel vs. the putc() method.
+ *
+ ****************************************************************************/
+
+void syslog_flush_async(bool force)
+{
+  char batch[128];
+  size_t nbytes;
+
+  while ((nbytes = syslog_async_gather(batch, sizeof(batch))) > 0)
+    {
+      syslog_write_foreach(batch, nbytes, force);
+    }
+
+  syslog_async_report(force);
+}
+
+/****************************************************************************
+ * Name: syslog_async_initialize
+ *
+ * Description:
+ *   Start the drain thread, from then on syslog_write() only queues.
+ *
+ ****************************************************************************/
+
+int syslog_async_initialize(void)
+{
+  int pid;
+
+  pid = kthread_create("syslogd", CONFIG_SYSLOG_ASYNC_PRIORITY,
+                       CONFIG_SYSLOG_ASYNC_STACKSIZE,
+                       syslog_async_thread, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  g_syslog_async.running = true;
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_ASYNC */
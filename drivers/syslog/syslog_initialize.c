@@ -97,6 +97,12 @@ int syslog_initialize(void)
   syslog_rpmsg_server_init();
 #endif
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Start draining only once the channels are registered */
+
+  ret = syslog_async_initialize();
+#endif
+
   return ret;
 }
 
@@ -65,86 +65,98 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_gettime
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Get the time stamp of a message.  Since debug output may be generated
+ *   very early in the start-up sequence, hardware timer support may not
+ *   yet be available: false is returned then.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static bool syslog_gettime(FAR struct timespec *ts)
 {
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_self();
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
 
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
-
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
-   */
-
   if (OSINIT_HW_READY())
     {
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, ts);
 #  endif
 
-      /* Prepend the message with the current time, if available */
+      return true;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: syslog_prefix
+ *
+ * Description:
+ *   Output the configured message prefix (time stamp, CPU, thread, ...)
+ *   of a message logged at time ts (NULL if unknown) by thread pid.
+ *
+ ****************************************************************************/
+
+static int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                         FAR const struct timespec *ts, int cpu, pid_t pid,
+                         FAR const char *name)
+{
+  int ret = 0;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec zero =
+    {
+      0
+    };
 
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+#  endif
+#endif
+
+  UNUSED(priority);
+  UNUSED(cpu);
+  UNUSED(pid);
+  UNUSED(name);
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  memset(&tm, 0, sizeof(tm));
+  if (ts != NULL)
+    {
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
+      localtime_r(&ts->tv_sec, &tm);
 #    else
-      gmtime_r(&ts.tv_sec, &tm);
+      gmtime_r(&ts->tv_sec, &tm);
 #    endif
-#  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
 #  endif
+
+  if (ts == NULL)
+    {
+      ts = &zero;
+    }
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -152,7 +164,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -206,24 +218,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -247,12 +259,96 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , name
 #endif
                     );
 
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Queue the format string and the raw arguments of a message for the
+ *   SYSLOG drain thread instead of formatting it in the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+static bool syslog_defer(int priority, FAR const struct timespec *ts,
+                         bool hasts, FAR const IPTR char *fmt,
+                         FAR va_list *ap)
+{
+  uintptr_t record[CONFIG_SYSLOG_DEFERRED_RECSIZE / sizeof(uintptr_t)];
+  FAR struct syslog_deferred_s *rec = (FAR struct syslog_deferred_s *)record;
+  va_list copy;
+  size_t len;
+
+  rec->fmt      = fmt;
+  rec->ts       = *ts;
+  rec->pid      = nxsched_gettid();
+  rec->priority = priority;
+  rec->cpu      = this_cpu();
+  rec->hasts    = hasts;
+
+  va_copy(copy, *ap);
+  len = lib_vbpack(rec + 1, sizeof(record) - sizeof(*rec), fmt, copy);
+  va_end(copy);
+
+  return syslog_add_deferred(rec, sizeof(*rec) + len);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+  bool hasts;
+  int ret = 0;
+
+  hasts = syslog_gettime(&ts);
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Only store the format string and the arguments if the drain thread
+   * runs, the message is formatted there.
+   */
+
+  if (syslog_defer(priority, &ts, hasts, fmt, ap))
+    {
+      return 0;
+    }
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  ret = syslog_prefix(&stream.common, priority, hasts ? &ts : NULL,
+                      this_cpu(), nxsched_gettid(),
+                      get_task_name(nxsched_self()));
+
   /* Generate the output */
 
   ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
@@ -274,3 +370,49 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
   lib_syslograwstream_close(&stream);
   return ret;
 }
+
+/****************************************************************************
+ * Name: syslog_format_deferred
+ *
+ * Description:
+ *   Format a message queued by the deferred logging of nx_vsyslog().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_format_deferred(FAR struct lib_outstream_s *stream,
+                           FAR const struct syslog_deferred_s *rec)
+{
+  FAR const char *name = "";
+  size_t len;
+  int ret;
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  FAR struct tcb_s *tcb = nxsched_get_tcb(rec->pid);
+
+  if (tcb != NULL)
+    {
+      name = get_task_name(tcb);
+    }
+#endif
+
+  ret  = syslog_prefix(stream, rec->priority, rec->hasts ? &rec->ts : NULL,
+                       rec->cpu, rec->pid, name);
+  ret += lib_bsprintf(stream, rec->fmt, rec + 1);
+
+  len = strlen(rec->fmt);
+  if (len == 0 || rec->fmt[len - 1] != '\n')
+    {
+      lib_stream_putc(stream, '\n');
+      ret++;
+    }
+
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
+  /* Reset the terminal style back to normal. */
+
+  ret += lib_stream_puts(stream, "\e[0m", sizeof("\e[0m"));
+#endif
+
+  return ret;
+}
+#endif
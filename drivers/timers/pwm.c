@@ -37,6 +37,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -72,6 +73,16 @@ struct pwm_upperhalf_s
 #endif
   struct pwm_info_s info;           /* Pulsed output characteristics */
   FAR struct pwm_lowerhalf_s *dev;  /* lower-half state */
+#ifdef CONFIG_PWM_SEQUENCE
+  FAR struct pwm_step_s *steps;     /* The step buffers of the sequences */
+  struct pwm_sequence_s seq[CONFIG_PWM_SEQUENCE_NBUFFERS];
+  uint8_t           seqhead;        /* The oldest queued sequence */
+  uint8_t           seqcount;       /* The number of queued sequences */
+  uint8_t           seqsubmit;      /* Of those, the ones the lower half
+                                     * has accepted */
+  sem_t             seqsem;         /* Counts the free sequence buffers */
+  FAR struct pollfd *fds;           /* Waits for a free sequence buffer */
+#endif
 };
 
 /****************************************************************************
@@ -90,6 +101,14 @@ static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
 static int     pwm_start(FAR struct pwm_upperhalf_s *upper,
                          unsigned int oflags);
 static int     pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef CONFIG_PWM_SEQUENCE
+static int     pwm_sequence_submit(FAR struct pwm_upperhalf_s *upper);
+static void    pwm_sequence_reset(FAR struct pwm_upperhalf_s *upper);
+static int     pwm_sequence(FAR struct pwm_upperhalf_s *upper,
+                            FAR const struct pwm_sequence_s *seq);
+static int     pwm_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -103,6 +122,11 @@ static const struct file_operations g_pwmops =
   pwm_write, /* write */
   NULL,      /* seek */
   pwm_ioctl, /* ioctl */
+#ifdef CONFIG_PWM_SEQUENCE
+  NULL,      /* mmap */
+  NULL,      /* truncate */
+  pwm_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -254,6 +278,9 @@ static int pwm_close(FAR struct file *filep)
       pwminfo("calling shutdown\n");
 
       lower->ops->shutdown(lower);
+#ifdef CONFIG_PWM_SEQUENCE
+      pwm_sequence_reset(upper);
+#endif
     }
 
   ret = OK;
@@ -409,6 +436,160 @@ static int pwm_start(FAR struct pwm_upperhalf_s *upper, unsigned int oflags)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence_submit
+ *
+ * Description:
+ *   Offer the lower half the queued sequences it did not accept yet, in
+ *   order.  Called in a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+static int pwm_sequence_submit(FAR struct pwm_upperhalf_s *upper)
+{
+  FAR struct pwm_lowerhalf_s *lower = upper->dev;
+  int index;
+  int ret = OK;
+
+  while (upper->seqsubmit < upper->seqcount)
+    {
+      index = (upper->seqhead + upper->seqsubmit) %
+              CONFIG_PWM_SEQUENCE_NBUFFERS;
+
+      ret = lower->ops->sequence(lower, &upper->seq[index], upper);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      upper->seqsubmit++;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pwm_sequence_reset
+ *
+ * Description:
+ *   Drop the queued sequences, once the lower half has stopped.
+ *
+ ****************************************************************************/
+
+static void pwm_sequence_reset(FAR struct pwm_upperhalf_s *upper)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  upper->seqhead   = 0;
+  upper->seqcount  = 0;
+  upper->seqsubmit = 0;
+  nxsem_reset(&upper->seqsem, CONFIG_PWM_SEQUENCE_NBUFFERS);
+  poll_notify(&upper->fds, 1, POLLOUT);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pwm_sequence
+ *
+ * Description:
+ *   Handle the PWMIOC_SEQUENCE ioctl command, once a buffer is free
+ *
+ ****************************************************************************/
+
+static int pwm_sequence(FAR struct pwm_upperhalf_s *upper,
+                        FAR const struct pwm_sequence_s *seq)
+{
+  FAR struct pwm_sequence_s *slot;
+  FAR struct pwm_step_s *steps;
+  irqstate_t flags;
+  int index;
+  int ret;
+
+  /* The free buffer follows the queued ones.  pwm_sequence_done() moves
+   * the head and the count together, so it stays the same until queued.
+   */
+
+  flags = enter_critical_section();
+  index = (upper->seqhead + upper->seqcount) % CONFIG_PWM_SEQUENCE_NBUFFERS;
+  leave_critical_section(flags);
+
+  slot  = &upper->seq[index];
+  steps = &upper->steps[index * CONFIG_PWM_SEQUENCE_NSTEPS];
+
+  memcpy(steps, seq->steps, seq->nsteps * sizeof(struct pwm_step_s));
+  memcpy(slot, seq, sizeof(struct pwm_sequence_s));
+  slot->steps = steps;
+
+  flags = enter_critical_section();
+
+  upper->seqcount++;
+  ret = pwm_sequence_submit(upper);
+
+  /* A sequence the lower half cannot take yet waits its turn */
+
+  if (ret == -EBUSY && upper->seqsubmit > 0)
+    {
+      ret = OK;
+    }
+
+  if (ret < 0)
+    {
+      pwminfo("sequence failed: %d\n", ret);
+      upper->seqcount--;
+      nxsem_post(&upper->seqsem);
+    }
+  else
+    {
+      upper->started = true;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pwm_poll
+ ****************************************************************************/
+
+static int pwm_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct pwm_upperhalf_s *upper = inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      if (upper->fds != NULL)
+        {
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      upper->fds = fds;
+      if (upper->seqcount < CONFIG_PWM_SEQUENCE_NBUFFERS)
+        {
+          poll_notify(&upper->fds, 1, POLLOUT);
+        }
+    }
+  else
+    {
+      upper->fds = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
@@ -531,10 +712,71 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
                   upper->waiting = false;
                 }
 #endif
+
+#ifdef CONFIG_PWM_SEQUENCE
+              pwm_sequence_reset(upper);
+#endif
             }
         }
         break;
 
+#ifdef CONFIG_PWM_SEQUENCE
+      /* PWMIOC_SEQUENCE - Queue a waveform sequence and start the output.
+       *
+       *   ioctl argument:  A read-only reference to struct pwm_sequence_s.
+       */
+
+      case PWMIOC_SEQUENCE:
+        {
+          FAR const struct pwm_sequence_s *seq =
+            (FAR const struct pwm_sequence_s *)((uintptr_t)arg);
+          DEBUGASSERT(seq != NULL);
+
+          if (lower->ops->sequence == NULL)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          if (seq->steps == NULL || seq->nsteps == 0 ||
+              seq->nsteps > CONFIG_PWM_SEQUENCE_NSTEPS)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Wait for a free buffer without the lock, so that PWMIOC_STOP
+           * may drop the queue meanwhile.
+           */
+
+          nxmutex_unlock(&upper->lock);
+
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = nxsem_trywait(&upper->seqsem);
+            }
+          else
+            {
+              ret = nxsem_wait(&upper->seqsem);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = nxmutex_lock(&upper->lock);
+          if (ret < 0)
+            {
+              nxsem_post(&upper->seqsem);
+              return ret;
+            }
+
+          ret = pwm_sequence(upper, seq);
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl
        * commands.
        */
@@ -604,6 +846,24 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev)
   nxsem_init(&upper->waitsem, 0, 0);
 #endif
 
+#ifdef CONFIG_PWM_SEQUENCE
+  upper->steps = kmm_malloc(CONFIG_PWM_SEQUENCE_NBUFFERS *
+                            CONFIG_PWM_SEQUENCE_NSTEPS *
+                            sizeof(struct pwm_step_s));
+  if (upper->steps == NULL)
+    {
+      pwmerr("Allocation failed\n");
+      nxmutex_destroy(&upper->lock);
+#ifdef CONFIG_PWM_PULSECOUNT
+      nxsem_destroy(&upper->waitsem);
+#endif
+      kmm_free(upper);
+      return -ENOMEM;
+    }
+
+  nxsem_init(&upper->seqsem, 0, CONFIG_PWM_SEQUENCE_NBUFFERS);
+#endif
+
   upper->dev = dev;
 
   /* Register the PWM device */
@@ -677,4 +937,43 @@ void pwm_expired(FAR void *handle)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence_done
+ *
+ * Description:
+ *   Called by the lower half when it has played the oldest sequence that
+ *   it accepted.  See include/nuttx/timers/pwm.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+void pwm_sequence_done(FAR void *handle)
+{
+  FAR struct pwm_upperhalf_s *upper = (FAR struct pwm_upperhalf_s *)handle;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (upper->seqsubmit > 0)
+    {
+      upper->seqhead = (upper->seqhead + 1) % CONFIG_PWM_SEQUENCE_NBUFFERS;
+      upper->seqcount--;
+      upper->seqsubmit--;
+
+      /* Hand over what the lower half could not take before */
+
+      pwm_sequence_submit(upper);
+      if (upper->seqcount == 0)
+        {
+          upper->started = false;
+        }
+
+      nxsem_post(&upper->seqsem);
+      poll_notify(&upper->fds, 1, POLLOUT);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 #endif /* CONFIG_PWM */
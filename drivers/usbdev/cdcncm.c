@@ -307,11 +307,18 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  /* Read requests, and the completed ones waiting to be unpacked */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  FAR struct usbdev_req_s    *rdreq[CONFIG_CDCNCM_NRDREQS];
+  FAR struct usbdev_req_s    *rdready[CONFIG_CDCNCM_NRDREQS];
+  uint8_t                     rdhead;      /* Oldest entry in rdready */
+  uint8_t                     rdcount;     /* Number of entries in rdready */
+
+  /* Write requests, one NTB each */
+
+  FAR struct usbdev_req_s    *wrreq[CONFIG_CDCNCM_NWRREQS];
+  uint8_t                     wrhead;      /* Write request being filled */
+  sem_t                       wrreq_idle;  /* Counts idle write requests */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -371,7 +378,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -841,6 +849,7 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
                                    FAR netpkt_t *pkt)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *wrreq = self->wrreq[self->wrhead];
   unsigned int dglen = netpkt_getdatalen(&self->dev, pkt);
   const int div = g_ntbparameters.ndpindivisor;
   const int rem = g_ntbparameters.ndpinpayloadremainder;
@@ -855,31 +864,40 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 
   if (self->dgramcount == 0)
     {
+      /* Wait until the request for this NTB is no longer on the bus.
+       * Requests complete in the order they were submitted, so the next
+       * one to become idle is always the one at wrhead.
+       */
+
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
       /* Fill NCB */
 
-      tmp = self->wrreq->buf;
+      tmp = wrreq->buf;
       memset(tmp, 0, ncblen);
       cdcncm_put(&tmp, 4, opts->nthsign);
       cdcncm_put(&tmp, 2, opts->nthsize);
       tmp += 2;              /* Skip seq */
       tmp += opts->blocklen; /* Skip block len */
       cdcncm_put(&tmp, opts->ndpindex, ndpindex);
-      self->dgramaddr = self->wrreq->buf + ndpindex +
+      self->dgramaddr = wrreq->buf + ndpindex +
                         opts->ndpsize + (TX_MAX_NUM_DPE + 1) * dgramidxlen;
       self->dgramaddr = (FAR uint8_t *)NCM_ALIGN((uintptr_t)self->dgramaddr,
                                                  div) + rem;
 
       /* Fill NDP */
 
-      tmp = self->wrreq->buf + ndpindex;
+      tmp = wrreq->buf + ndpindex;
       cdcncm_put(&tmp, 4, self->ndpsign);
       tmp += 2 + opts->reserved1;
       cdcncm_put(&tmp, opts->nextndpindex, 0);
     }
 
-  tmp = self->wrreq->buf + ndpindex + opts->ndpsize +
+  tmp = wrreq->buf + ndpindex + opts->ndpsize +
         self->dgramcount * dgramidxlen;
-  cdcncm_put(&tmp, opts->dgramitemlen, self->dgramaddr - self->wrreq->buf);
+  cdcncm_put(&tmp, opts->dgramitemlen, self->dgramaddr - wrreq->buf);
   cdcncm_put(&tmp, opts->dgramitemlen, dglen);
 
   /* Fill IP packet */
@@ -897,7 +915,9 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
  * Name: cdcncm_transmit_work
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Send the NTB being filled to the host and move on to the next write
+ *   request, so that the following datagrams are aggregated while this
+ *   NTB is on the bus.
  *
  * Input Parameters:
  *   arg - Reference to the driver state structure
@@ -911,6 +931,7 @@ static void cdcncm_transmit_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = arg;
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *wrreq = self->wrreq[self->wrhead];
   FAR uint8_t *tmp;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
@@ -918,12 +939,9 @@ static void cdcncm_transmit_work(FAR void *arg)
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
-
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->dgramcount == 0)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
@@ -931,13 +949,13 @@ static void cdcncm_transmit_work(FAR void *arg)
 
   /* Fill NCB */
 
-  tmp      = self->wrreq->buf + 8; /* Offset to block length */
-  totallen = self->dgramaddr - self->wrreq->buf;
+  tmp      = wrreq->buf + 8; /* Offset to block length */
+  totallen = self->dgramaddr - wrreq->buf;
   cdcncm_put(&tmp, opts->blocklen, totallen);
 
   /* Fill NDP */
 
-  tmp = self->wrreq->buf + ndpindex + 4; /* Offset to ndp length */
+  tmp = wrreq->buf + ndpindex + 4; /* Offset to ndp length */
   cdcncm_put(&tmp, 2, opts->ndpsize + (self->dgramcount + 1) * dgramidxlen);
 
   tmp += opts->reserved1 + opts->nextndpindex + opts->reserved2 +
@@ -947,9 +965,14 @@ static void cdcncm_transmit_work(FAR void *arg)
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
 
-  self->wrreq->len = totallen;
+  wrreq->len = totallen;
+
+  if (++self->wrhead >= CONFIG_CDCNCM_NWRREQS)
+    {
+      self->wrhead = 0;
+    }
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+  EP_SUBMIT(self->epbulkin, wrreq);
 }
 
 /****************************************************************************
@@ -997,20 +1020,22 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  * Name: cdcncm_receive
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Unpack the datagrams of an NTB received from the host
  *
  * Input Parameters:
  *   self - Reference to the driver state structure
+ *   req  - The completed read request holding the NTB
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1021,7 +1046,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1061,7 +1086,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1105,7 +1130,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1155,21 +1180,35 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct usbdev_req_s *req;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Unpack the received NTBs in the order they arrived.  Each request is
+   * given back to the endpoint as soon as it is unpacked, while the host
+   * may already be filling the others.
+   */
 
-  if (self->rxpending)
+  flags = enter_critical_section();
+  while (self->rdcount > 0)
     {
-      cdcncm_receive(self);
+      req = self->rdready[self->rdhead];
+      leave_critical_section(flags);
+
+      cdcncm_receive(self, req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
-      leave_critical_section(flags);
+      if (++self->rdhead >= CONFIG_CDCNCM_NRDREQS)
+        {
+          self->rdhead = 0;
+        }
+
+      self->rdcount--;
+      EP_SUBMIT(self->epbulkout, req);
     }
 
+  leave_critical_section(flags);
+
   /* Check if a packet transmission just completed.  If so, call
    * cdcncm_txdone. This may disable further Tx interrupts if there
    * are no pending transmissions.
@@ -1294,8 +1333,9 @@ static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
   cdcncm_transmit_format(self, pkt);
   netpkt_free(dev, pkt, NETPKT_TX);
 
-  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
-       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
+  if ((self->wrreq[self->wrhead]->buf + NTB_OUT_SIZE - self->dgramaddr <
+       self->dev.netdev.d_pktsize) ||
+      self->dgramcount >= TX_MAX_NUM_DPE)
     {
       work_cancel(ETHWORK, &self->delaywork);
       cdcncm_transmit_work(self);
@@ -1482,8 +1522,16 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          int index = self->rdhead + self->rdcount;
+
+          if (index >= CONFIG_CDCNCM_NRDREQS)
+            {
+              index -= CONFIG_CDCNCM_NRDREQS;
+            }
+
+          DEBUGASSERT(self->rdcount < CONFIG_CDCNCM_NRDREQS);
+          self->rdready[index] = req;
+          self->rdcount++;
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1495,7 +1543,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1519,9 +1567,7 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
+  /* This write request is available for upcoming NTBs again */
 
   rc = nxsem_post(&self->wrreq_idle);
 
@@ -1585,6 +1631,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1637,14 +1684,16 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(self->rdcount == 0);
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreq[i]);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2480,6 +2529,7 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2537,31 +2587,42 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      self->rdreq[i] = usbdev_allocreq(self->epbulkout,
+                                       NTB_DEFAULT_IN_SIZE);
+      if (self->rdreq[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      self->rdreq[i]->callback = cdcncm_rdcomplete;
     }
 
-  self->rdreq->callback = cdcncm_rdcomplete;
+  self->rdhead  = 0;
+  self->rdcount = 0;
 
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  /* Pre-allocate write requests. Buffer size is NTB_OUT_SIZE */
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      self->wrreq[i] = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (self->wrreq[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
+      self->wrreq[i]->callback = cdcncm_wrcomplete;
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are all available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  self->wrhead = 0;
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCNCM_NWRREQS);
 
   if (ret != OK)
     {
@@ -2594,6 +2655,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2633,10 +2695,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreq[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreq[i]);
+          self->rdreq[i] = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -2651,10 +2716,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreq[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreq[i]);
+          self->wrreq[i] = NULL;
+        }
     }
 
   /* Free the bulk IN endpoint */
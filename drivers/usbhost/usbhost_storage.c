@@ -102,6 +102,17 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+/* One stage (CBW, data or CSW) of a queued Bulk-Only command */
+
+struct usbhost_state_s;
+struct usbhost_stage_s
+{
+  FAR struct usbhost_state_s *priv;     /* The class instance */
+  ssize_t                     result;   /* Bytes transferred or -errno */
+};
+#endif
+
 /* This structure contains the internal, private state of the USB host mass
  * storage class.
  */
@@ -126,6 +137,10 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  sem_t                   stagesem;     /* Posted as each stage completes */
+  struct usbhost_stage_s  stages[3];    /* CBW, data and CSW stages */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -212,6 +227,14 @@ static inline int usbhost_talloc(FAR struct usbhost_state_s *priv);
 static inline int usbhost_tfree(FAR struct usbhost_state_s *priv);
 static FAR struct usbmsc_cbw_s *
        usbhost_cbwalloc(FAR struct usbhost_state_s *priv);
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+static void usbhost_stagedone(FAR void *arg, ssize_t nbytes);
+static ssize_t usbhost_bulkcmd(FAR struct usbhost_state_s *priv,
+                               FAR struct usbhost_driver_s *drvr,
+                               FAR struct usbmsc_cbw_s *cbw,
+                               FAR uint8_t *buffer, size_t buflen,
+                               bool in);
+#endif
 
 /* struct usbhost_registry_s methods */
 
@@ -921,6 +944,9 @@ static void usbhost_destroy(FAR void *arg)
   /* Destroy the mutex */
 
   nxmutex_destroy(&priv->lock);
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  nxsem_destroy(&priv->stagesem);
+#endif
 
   /* Disconnect the USB host device */
 
@@ -1641,6 +1667,144 @@ static FAR struct usbmsc_cbw_s *
   return cbw;
 }
 
+/****************************************************************************
+ * Name: usbhost_stagedone
+ *
+ * Description:
+ *   Asynchronous completion of one stage of a queued command.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+static void usbhost_stagedone(FAR void *arg, ssize_t nbytes)
+{
+  FAR struct usbhost_stage_s *stage = (FAR struct usbhost_stage_s *)arg;
+
+  stage->result = nbytes;
+  nxsem_post(&stage->priv->stagesem);
+}
+
+/****************************************************************************
+ * Name: usbhost_bulkcmd
+ *
+ * Description:
+ *   Perform one Bulk-Only command with a data stage.  The CBW, the data
+ *   and the CSW transfers are all queued on the host controller at once,
+ *   so it runs the three stages back to back instead of waiting for this
+ *   thread between them.  The CSW is received into the transfer buffer
+ *   that holds the CBW: the device only sends it after the CBW is gone.
+ *
+ * Input Parameters:
+ *   priv   - A reference to the class instance.
+ *   drvr   - The host controller driver.
+ *   cbw    - The CBW to send, in the transfer buffer.
+ *   buffer - The data to send or receive.
+ *   buflen - The length of the data.
+ *   in     - True if the data stage is IN.
+ *
+ * Returned Value:
+ *   The number of data bytes transferred on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_bulkcmd(FAR struct usbhost_state_s *priv,
+                               FAR struct usbhost_driver_s *drvr,
+                               FAR struct usbmsc_cbw_s *cbw,
+                               FAR uint8_t *buffer, size_t buflen,
+                               bool in)
+{
+  FAR struct usbmsc_csw_s *csw;
+  bool cancelled = false;
+  ssize_t ret;
+  int nstages = 0;
+  int i;
+
+  for (i = 0; i < 3; i++)
+    {
+      priv->stages[i].priv   = priv;
+      priv->stages[i].result = -EBUSY;
+    }
+
+  ret = DRVR_ASYNCH(drvr, priv->bulkout, (FAR uint8_t *)cbw,
+                    USBMSC_CBW_SIZEOF, usbhost_stagedone, &priv->stages[0]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nstages++;
+  ret = DRVR_ASYNCH(drvr, in ? priv->bulkin : priv->bulkout, buffer,
+                    buflen, usbhost_stagedone, &priv->stages[1]);
+  if (ret >= 0)
+    {
+      nstages++;
+      ret = DRVR_ASYNCH(drvr, priv->bulkin, priv->tbuffer,
+                        USBMSC_CSW_SIZEOF, usbhost_stagedone,
+                        &priv->stages[2]);
+      if (ret >= 0)
+        {
+          nstages++;
+        }
+    }
+
+  /* If a stage could not be queued, cancel the ones that were */
+
+  if (ret < 0)
+    {
+      DRVR_CANCEL(drvr, priv->bulkout);
+      DRVR_CANCEL(drvr, priv->bulkin);
+      cancelled = true;
+    }
+
+  for (i = 0; i < nstages; i++)
+    {
+      int j;
+
+      nxsem_wait_uninterruptible(&priv->stagesem);
+
+      /* Once a stage fails, the stages behind it will never run.  Cancel
+       * them; they then complete with -ESHUTDOWN.
+       */
+
+      for (j = 0; !cancelled && j < nstages; j++)
+        {
+          if (priv->stages[j].result < 0 &&
+              priv->stages[j].result != -EBUSY)
+            {
+              DRVR_CANCEL(drvr, priv->bulkout);
+              DRVR_CANCEL(drvr, priv->bulkin);
+              cancelled = true;
+            }
+        }
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nstages; i++)
+    {
+      if (priv->stages[i].result < 0)
+        {
+          return priv->stages[i].result;
+        }
+    }
+
+  /* Check the CSW status */
+
+  csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+  if (csw->status != 0)
+    {
+      uerr("ERROR: CSW status error: %d\n", csw->status);
+      return -ENODEV;
+    }
+
+  return priv->stages[1].result;
+}
+#endif
+
 /****************************************************************************
  * Name: usbhost_create
  *
@@ -1703,6 +1867,9 @@ static FAR struct usbhost_class_s *
            */
 
           nxmutex_init(&priv->lock);
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+          nxsem_init(&priv->stagesem, 0, 0);
+#endif
 
           /* NOTE: We do not yet know the geometry of the USB mass storage
            * device.
@@ -2041,6 +2208,10 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
               /* Construct and send the CBW */
 
               usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+              nbytes = usbhost_bulkcmd(priv, hport->drvr, cbw, buffer,
+                                       priv->blocksize * nsectors, true);
+#else
               nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
                                      (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
               if (nbytes >= 0)
@@ -2072,6 +2243,7 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                         }
                     }
                 }
+#endif
             }
           while (nbytes == -EAGAIN);
         }
@@ -2147,6 +2319,11 @@ static ssize_t usbhost_write(FAR struct inode *inode,
           /* Construct and send the CBW */
 
           usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+          nbytes = usbhost_bulkcmd(priv, hport->drvr, cbw,
+                                   (FAR uint8_t *)buffer,
+                                   priv->blocksize * nsectors, false);
+#else
           nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
                                  (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
           if (nbytes >= 0)
@@ -2177,6 +2354,7 @@ static ssize_t usbhost_write(FAR struct inode *inode,
                     }
                 }
             }
+#endif
         }
 
       nxmutex_unlock(&priv->lock);
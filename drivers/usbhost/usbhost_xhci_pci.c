@@ -70,6 +70,15 @@
 #define XHCI_TD_MAX              (8)
 #define XHCI_BUFSIZE             (512)
 
+/* The TD ring must hold the transfer in progress plus the queued ones,
+ * and keeps one entry for the link TRB.
+ */
+
+#if defined(CONFIG_USBHOST_ASYNCH_QUEUE) && \
+    CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH > XHCI_TD_MAX - 2
+#  error CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH too large for XHCI_TD_MAX
+#endif
+
 /* Port numbers macros */
 
 #define HPNDX(hp)                ((hp)->port)
@@ -114,6 +123,17 @@ struct xhci_ring_s
   bool                   ccs;   /* Consumer Cycle State */
 };
 
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+/* An asynchronous transfer queued behind the one in progress */
+
+struct xhci_asynch_s
+{
+  usbhost_asynch_t   callback;     /* Transfer complete callback */
+  FAR void          *arg;          /* Argument that accompanies the callback */
+  size_t             buflen;       /* Buffer length used for transfer */
+};
+#endif
+
 /* EP info */
 
 struct xhci_epinfo_s
@@ -135,6 +155,14 @@ struct xhci_epinfo_s
 #ifdef CONFIG_USBHOST_ASYNCH
   usbhost_asynch_t   callback;     /* Transfer complete callback */
   FAR void          *arg;          /* Argument that accompanies the callback */
+#endif
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  uint8_t            qhead;        /* Oldest entry in queue[] */
+  uint8_t            qcount;       /* Number of entries in queue[] */
+
+  /* Transfers queued behind the one in progress, in ring order */
+
+  struct xhci_asynch_s queue[CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH];
 #endif
   struct xhci_ring_s td;           /* TD ring for this endpoint */
   uint8_t            slot;         /* Slot where this EP resides */
@@ -381,6 +409,7 @@ static int xhci_ioc_wait(FAR struct xhci_epinfo_s *epinfo);
 #ifdef CONFIG_USBHOST_ASYNCH
 static inline int xhci_ioc_async_setup(FAR struct xhci_rhport_s *rhport,
                                        FAR struct xhci_epinfo_s *epinfo,
+                                       size_t buflen,
                                        usbhost_asynch_t callback,
                                        FAR void *arg);
 static void xhci_asynch_completion(FAR struct xhci_epinfo_s *epinfo);
@@ -2414,6 +2443,7 @@ static ssize_t xhci_transfer_wait(FAR struct usbhost_xhci_s *priv,
  * Input Parameters:
  *   epinfo - The IN or OUT endpoint descriptor for the device endpoint on
  *      which the transfer will be performed.
+ *   buflen - The length of the transfer
  *   callback - The function to be called when the transfer completes
  *   arg - An arbitrary argument that will be provided with the callback.
  *
@@ -2427,20 +2457,60 @@ static ssize_t xhci_transfer_wait(FAR struct usbhost_xhci_s *priv,
 
 static inline int xhci_ioc_async_setup(FAR struct xhci_rhport_s *rhport,
                                        FAR struct xhci_epinfo_s *epinfo,
+                                       size_t buflen,
                                        usbhost_asynch_t callback,
                                        FAR void *arg)
 {
   FAR struct usbhost_xhci_s *priv = XHCI_PRIV_FROM_RHPORT(rhport);
   irqstate_t                 flags;
-  int                        ret  = -ENODEV;
+  int                        ret;
 
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  DEBUGASSERT(rhport && epinfo && !epinfo->iocwait);
+#else
   DEBUGASSERT(rhport && epinfo && !epinfo->iocwait &&
               epinfo->callback == NULL);
+#endif
 
   /* Is the device still connected? */
 
   flags = spin_lock_irqsave(&priv->spinlock);
-  if (rhport->connected)
+  if (!rhport->connected)
+    {
+      ret = -ENODEV;
+    }
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  else if (epinfo->callback != NULL)
+    {
+      /* A transfer is already in progress.  Queue this one behind it; its
+       * TD is added to the ring right after, so the controller moves on
+       * to it without waiting for the callback.
+       */
+
+      if (epinfo->qcount < CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH)
+        {
+          FAR struct xhci_asynch_s *entry;
+          int index = epinfo->qhead + epinfo->qcount;
+
+          if (index >= CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH)
+            {
+              index -= CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH;
+            }
+
+          entry           = &epinfo->queue[index];
+          entry->callback = callback;
+          entry->arg      = arg;
+          entry->buflen   = buflen;
+          epinfo->qcount++;
+          ret             = OK;
+        }
+      else
+        {
+          ret = -EBUSY;
+        }
+    }
+#endif
+  else
     {
       /* Then save callback information to be used when either (1) the
        * device is disconnected, or (2) the transfer completes.
@@ -2449,6 +2519,7 @@ static inline int xhci_ioc_async_setup(FAR struct xhci_rhport_s *rhport,
       epinfo->iocwait  = false;    /* No synchronous wakeup */
       epinfo->status   = 0;        /* No status yet */
       epinfo->xfrd     = 0;        /* Nothing transferred yet */
+      epinfo->buflen   = buflen;   /* Buffer length */
       epinfo->result   = -EBUSY;   /* Transfer in progress */
       epinfo->callback = callback; /* Asynchronous callback */
       epinfo->arg      = arg;      /* Argument that accompanies the callback */
@@ -2500,6 +2571,28 @@ static void xhci_asynch_completion(FAR struct xhci_epinfo_s *epinfo)
   epinfo->result   = OK;
   epinfo->iocwait  = false;
 
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  /* The next queued transfer, if any, is the one now in progress */
+
+  if (epinfo->qcount > 0)
+    {
+      FAR struct xhci_asynch_s *entry = &epinfo->queue[epinfo->qhead];
+
+      epinfo->callback = entry->callback;
+      epinfo->arg      = entry->arg;
+      epinfo->buflen   = entry->buflen;
+      epinfo->xfrd     = 0;
+      epinfo->result   = -EBUSY;
+
+      if (++epinfo->qhead >= CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH)
+        {
+          epinfo->qhead = 0;
+        }
+
+      epinfo->qcount--;
+    }
+#endif
+
   /* Then perform the callback.  Provide the number of bytes successfully
    * transferred or the negated errno value in the event of a failure.
    */
@@ -3943,6 +4036,9 @@ errout_with_lock:
  *
  *   Only one transfer may be queued; Neither this method nor the ctrlin or
  *   ctrlout methods can be called again until the transfer completes.
+ *   With CONFIG_USBHOST_ASYNCH_QUEUE, up to
+ *   CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH further transfers may be queued on
+ *   the same endpoint; their callbacks are made in submission order.
  *
  * Input Parameters:
  *   drvr     - The USB host driver instance obtained as a parameter from
@@ -3975,6 +4071,9 @@ static int xhci_asynch(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep,
   FAR struct usbhost_xhci_s *priv   = XHCI_PRIV_FROM_DRVR(drvr);
   FAR struct xhci_rhport_s  *rhport = (FAR struct xhci_rhport_s *)drvr;
   FAR struct xhci_epinfo_s  *epinfo = (FAR struct xhci_epinfo_s *)ep;
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  irqstate_t                 flags;
+#endif
   int                        ret;
 
   DEBUGASSERT(priv && rhport && epinfo && buffer && buflen > 0);
@@ -3991,7 +4090,7 @@ static int xhci_asynch(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep,
 
   /* Set the request for the callback well BEFORE initiating the transfer. */
 
-  ret = xhci_ioc_async_setup(rhport, epinfo, callback, arg);
+  ret = xhci_ioc_async_setup(rhport, epinfo, buflen, callback, arg);
   if (ret != OK)
     {
       goto errout_with_lock;
@@ -4040,8 +4139,27 @@ static int xhci_asynch(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep,
   return OK;
 
 errout_with_callback:
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  /* This transfer is the newest one, so it is either the last queued
+   * entry or, if nothing is queued, the one marked as in progress.
+   */
+
+  flags = spin_lock_irqsave(&priv->spinlock);
+  if (epinfo->qcount > 0)
+    {
+      epinfo->qcount--;
+    }
+  else
+    {
+      epinfo->callback = NULL;
+      epinfo->arg      = NULL;
+    }
+
+  spin_unlock_irqrestore(&priv->spinlock, flags);
+#else
   epinfo->callback = NULL;
   epinfo->arg      = NULL;
+#endif
 errout_with_lock:
   nxmutex_unlock(&priv->lock);
   return ret;
@@ -4074,6 +4192,11 @@ static int xhci_cancel(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep)
 #ifdef CONFIG_USBHOST_ASYNCH
   usbhost_asynch_t           callback;
   FAR void                  *arg;
+#endif
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  struct xhci_asynch_s       queue[CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH];
+  uint8_t                    qcount;
+  int                        i;
 #endif
   irqstate_t                 flags;
   bool                       iocwait;
@@ -4096,6 +4219,17 @@ static int xhci_cancel(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep)
 #ifdef CONFIG_USBHOST_ASYNCH
   epinfo->callback = NULL;
   epinfo->arg      = NULL;
+#endif
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  qcount           = epinfo->qcount;
+  for (i = 0; i < qcount; i++)
+    {
+      queue[i] = epinfo->queue[(epinfo->qhead + i) %
+                               CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH];
+    }
+
+  epinfo->qhead    = 0;
+  epinfo->qcount   = 0;
 #endif
   epinfo->iocwait  = false;
   spin_unlock_irqrestore(&priv->spinlock, flags);
@@ -4138,6 +4272,15 @@ static int xhci_cancel(FAR struct usbhost_driver_s *drvr, usbhost_ep_t ep)
     }
 #endif
 
+#ifdef CONFIG_USBHOST_ASYNCH_QUEUE
+  /* The transfers queued behind it are cancelled too */
+
+  for (i = 0; i < qcount; i++)
+    {
+      queue[i].callback(queue[i].arg, -ESHUTDOWN);
+    }
+#endif
+
   return OK;
 }
 
@@ -49,6 +49,8 @@
 #  include <nuttx/signal.h>
 #endif
 
+#include "video_dmabuf.h"
+
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
@@ -99,6 +101,9 @@ struct fb_paninfo_s
   FAR struct circbuf_s     buf;        /* Pan buffer queued list             */
   struct wdog_s            wdog;       /* VSync offset timer                 */
   FAR struct fb_chardev_s *dev;
+  uint32_t                 yres;       /* Rows of one buffer                 */
+  uint32_t                 front;      /* Buffer shown while queue is empty  */
+  uint32_t                 acquired;   /* Buffers handed out for rendering   */
 };
 
 /* This structure defines one framebuffer device.  Note that which is
@@ -123,6 +128,7 @@ struct fb_panelinfo_s
   size_t fblen;                        /* Size of the framebuffer            */
   uint8_t fbcount;                     /* Count of frame buffer              */
   uint8_t bpp;                         /* Bits per pixel                     */
+  uint32_t yres;                       /* Rows of one frame buffer           */
 };
 
 /****************************************************************************
@@ -134,8 +140,17 @@ static FAR struct circbuf_s *fb_get_panbuf(FAR struct fb_chardev_s *fb,
 static int     fb_add_paninfo(FAR struct fb_chardev_s *fb,
                               FAR const union fb_paninfo_u *info,
                               int overlay);
+static void    fb_submit_buffer(FAR struct fb_chardev_s *fb,
+                                FAR const union fb_paninfo_u *info,
+                                int overlay);
+static int     fb_acquire_buffer(FAR struct fb_chardev_s *fb,
+                                 FAR struct fb_bufferinfo_s *binfo);
 static int     fb_clear_paninfo(FAR struct fb_chardev_s *fb,
                                 int overlay);
+#ifdef CONFIG_VIDEO_DMABUF
+static int     fb_export_buffer(FAR struct fb_chardev_s *fb,
+                                FAR struct fb_exportbuffer_s *einfo);
+#endif
 static int     fb_open(FAR struct file *filep);
 static int     fb_close(FAR struct file *filep);
 static ssize_t fb_read(FAR struct file *filep, FAR char *buffer,
@@ -379,6 +394,194 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
   return ret <= 0 ? -ENOSPC : OK;
 }
 
+/****************************************************************************
+ * Name: fb_bufferindex
+ *
+ * Description:
+ *   Set the bit of the buffer a pan info refers to in a buffer mask.
+ *
+ ****************************************************************************/
+
+static void fb_bufferindex(FAR struct fb_chardev_s *fb,
+                           FAR const union fb_paninfo_u *info,
+                           int overlay, FAR uint32_t *mask)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[overlay + 1];
+  uint32_t yoffset = info->planeinfo.yoffset;
+  uint32_t index;
+
+#ifdef CONFIG_FB_OVERLAY
+  if (overlay != FB_NO_OVERLAY)
+    {
+      yoffset = info->overlayinfo.yoffset;
+    }
+#endif
+
+  if (paninfo->yres > 0)
+    {
+      index = yoffset / paninfo->yres;
+      if (index < 32)
+        {
+          *mask |= 1u << index;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fb_submit_buffer
+ *
+ * Description:
+ *   Hand an acquired buffer back once it has been queued for pan.
+ *
+ ****************************************************************************/
+
+static void fb_submit_buffer(FAR struct fb_chardev_s *fb,
+                             FAR const union fb_paninfo_u *info,
+                             int overlay)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[overlay + 1];
+  irqstate_t flags;
+  uint32_t mask = 0;
+
+  fb_bufferindex(fb, info, overlay, &mask);
+
+  flags = enter_critical_section();
+  paninfo->acquired &= ~mask;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: fb_acquire_buffer
+ *
+ * Description:
+ *   Find a buffer of a plane or overlay that is neither shown, queued for
+ *   pan nor already handed out, so that the next frame can be rendered in
+ *   it while the display scans out the current one.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if every buffer is busy, in which case
+ *   POLLOUT is raised when the display releases one.
+ *
+ ****************************************************************************/
+
+static int fb_acquire_buffer(FAR struct fb_chardev_s *fb,
+                             FAR struct fb_bufferinfo_s *binfo)
+{
+  struct fb_panelinfo_s panelinfo;
+  FAR struct fb_paninfo_s *paninfo;
+  union fb_paninfo_u info;
+  irqstate_t flags;
+  uint32_t busy;
+  size_t used;
+  size_t off;
+  int index;
+  int ret;
+
+  if (binfo->overlay + 1 < 0 || binfo->overlay + 1 >= fb->paninfo_count)
+    {
+      return -EINVAL;
+    }
+
+  ret = fb_get_panelinfo(fb, &panelinfo, binfo->overlay);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (panelinfo.fbcount < 2 || panelinfo.fbcount > 32)
+    {
+      return -ENOTTY;
+    }
+
+  paninfo = &fb->paninfo[binfo->overlay + 1];
+
+  flags = enter_critical_section();
+
+  paninfo->yres = panelinfo.yres;
+  busy = paninfo->acquired;
+
+  /* The head of the queue is on screen and the rest is waiting for pan.
+   * With nothing queued, the buffer panned last is still on screen.
+   */
+
+  used = circbuf_used(&paninfo->buf);
+  if (used == 0)
+    {
+      busy |= paninfo->front;
+    }
+
+  for (off = 0; off < used; off += sizeof(info))
+    {
+      circbuf_peekat(&paninfo->buf, paninfo->buf.tail + off, &info,
+                     sizeof(info));
+      fb_bufferindex(fb, &info, binfo->overlay, &busy);
+    }
+
+  for (index = 0; index < panelinfo.fbcount; index++)
+    {
+      if ((busy & (1u << index)) == 0)
+        {
+          break;
+        }
+    }
+
+  if (index < panelinfo.fbcount)
+    {
+      paninfo->acquired |= 1u << index;
+      binfo->index        = index;
+      binfo->yoffset      = index * panelinfo.yres;
+    }
+  else
+    {
+      ret = -EAGAIN;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fb_export_buffer
+ *
+ * Description:
+ *   Return a buffer of a plane or overlay as a DMABUF file descriptor.
+ *   The framebuffer memory lives as long as the driver, so the descriptor
+ *   may outlive the open file it came from.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VIDEO_DMABUF
+static int fb_export_buffer(FAR struct fb_chardev_s *fb,
+                            FAR struct fb_exportbuffer_s *einfo)
+{
+  struct fb_panelinfo_s panelinfo;
+  size_t len;
+  int ret;
+
+  ret = fb_get_panelinfo(fb, &panelinfo, einfo->overlay);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (einfo->index >= panelinfo.fbcount)
+    {
+      return -EINVAL;
+    }
+
+  len = panelinfo.fblen / panelinfo.fbcount;
+  ret = video_dmabuf_export((FAR uint8_t *)panelinfo.fbmem +
+                            len * einfo->index, len, einfo->flags, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  einfo->fd = ret;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fb_clear_paninfo
  ****************************************************************************/
@@ -386,7 +589,9 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
 static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
                             int overlay)
 {
+  FAR struct fb_paninfo_s *paninfo;
   FAR struct circbuf_s *panbuf;
+  union fb_paninfo_u info;
   irqstate_t flags;
 
   DEBUGASSERT(fb != NULL);
@@ -397,6 +602,8 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
       return -EINVAL;
     }
 
+  paninfo = &fb->paninfo[overlay + 1];
+
   /* Disable the interrupt when writing to the queue to
    * prevent it from being modified by the interrupted
    * thread during the writing process.
@@ -404,6 +611,14 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
 
   flags = enter_critical_section();
 
+  /* The head of the queue stays on screen until something else is panned */
+
+  if (circbuf_peek(panbuf, &info, sizeof(info)) == sizeof(info))
+    {
+      fb_bufferindex(fb, &info, overlay, &paninfo->front);
+    }
+
+  paninfo->acquired = 0;
   circbuf_reset(panbuf);
 
   /* Re-enable interrupts */
@@ -1076,6 +1291,10 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
 
           ret = fb_add_paninfo(fb, &paninfo, oinfo->overlay);
+          if (ret >= 0)
+            {
+              fb_submit_buffer(fb, &paninfo, oinfo->overlay);
+            }
         }
         break;
 
@@ -1152,9 +1371,35 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
 
           ret = fb_add_paninfo(fb, &paninfo, FB_NO_OVERLAY);
+          if (ret >= 0)
+            {
+              fb_submit_buffer(fb, &paninfo, FB_NO_OVERLAY);
+            }
         }
         break;
 
+      case FBIO_ACQUIREBUFFER:
+        {
+          FAR struct fb_bufferinfo_s *binfo =
+            (FAR struct fb_bufferinfo_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(binfo != NULL && fb->vtable != NULL);
+          ret = fb_acquire_buffer(fb, binfo);
+        }
+        break;
+
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIO_EXPORTBUFFER:
+        {
+          FAR struct fb_exportbuffer_s *einfo =
+            (FAR struct fb_exportbuffer_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(einfo != NULL && fb->vtable != NULL);
+          ret = fb_export_buffer(fb, einfo);
+        }
+        break;
+#endif
+
       case FBIOPAN_CLEAR:
         {
           ret = fb_clear_paninfo(fb, (int)arg);
@@ -1483,6 +1728,7 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
       panelinfo->fbcount = oinfo.yres_virtual == 0 ?
                            1 : (oinfo.yres_virtual / oinfo.yres);
       panelinfo->bpp     = oinfo.bpp;
+      panelinfo->yres    = oinfo.yres;
       return OK;
     }
 #endif
@@ -1505,6 +1751,7 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
   panelinfo->fbcount = pinfo.yres_virtual == 0 ?
                        1 : (pinfo.yres_virtual / vinfo.yres);
   panelinfo->bpp     = pinfo.bpp;
+  panelinfo->yres    = vinfo.yres;
 
   return OK;
 }
@@ -1948,7 +2195,9 @@ int fb_register_device(int display, int plane,
 
       DEBUGASSERT(ret == 0);
 
-      fb->paninfo[i].dev = fb;
+      fb->paninfo[i].dev   = fb;
+      fb->paninfo[i].yres  = panelinfo.yres;
+      fb->paninfo[i].front = 1;
 
       /* Clear the framebuffer memory */
 
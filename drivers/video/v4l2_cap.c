@@ -30,11 +30,14 @@
 #include <assert.h>
 #include <errno.h>
 #include <poll.h>
+#include <time.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/video/v4l2_cap.h>
 #include <nuttx/video/video.h>
 
+#include "video_dmabuf.h"
 #include "video_framebuff.h"
 
 /****************************************************************************
@@ -111,6 +114,9 @@ struct capture_type_inf_s
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
+#ifdef CONFIG_VIDEO_DMABUF
+  atomic_t               exported;  /* DMABUF descriptors open on bufheap */
+#endif
 };
 
 typedef struct capture_type_inf_s capture_type_inf_t;
@@ -231,6 +237,10 @@ static int capture_querybuf(FAR struct file *filep,
                             FAR struct v4l2_buffer *buf);
 static int capture_qbuf(FAR struct file *filep,
                         FAR struct v4l2_buffer *buf);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp);
+#endif
 static int capture_dqbuf(FAR struct file *filep,
                          FAR struct v4l2_buffer *buf);
 static int capture_cancel_dqbuf(FAR struct file *filep,
@@ -312,6 +322,11 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_reqbufs,                    /* reqbufs */
   capture_querybuf,                   /* querybuf */
   capture_qbuf,                       /* qbuf */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf,                     /* expbuf */
+#else
+  NULL,                               /* expbuf */
+#endif
   capture_dqbuf,                      /* dqbuf */
   capture_cancel_dqbuf,               /* cancel_dqbuf */
   capture_g_fmt,                      /* g_fmt */
@@ -1185,6 +1200,18 @@ static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
   nxmutex_destroy(&type_inf->lock_state);
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The buffers stay while other devices use them; the next REQBUFS that
+   * finds them unused frees them.
+   */
+
+  if (atomic_read(&type_inf->exported) > 0)
+    {
+      return;
+    }
+#endif
+
   if (type_inf->bufheap != NULL)
     {
       if (cmng->imgdata->ops->free)
@@ -1982,6 +2009,19 @@ static int complete_capture(uint8_t err_code,
     {
       type_inf->bufinf.vbuf_next->buf.timestamp = *ts;
     }
+  else
+    {
+      struct timespec now;
+
+      /* The driver has no timestamp of its own, take it on completion */
+
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      type_inf->bufinf.vbuf_next->buf.timestamp.tv_sec  = now.tv_sec;
+      type_inf->bufinf.vbuf_next->buf.timestamp.tv_usec =
+        now.tv_nsec / NSEC_PER_USEC;
+      type_inf->bufinf.vbuf_next->buf.flags |=
+        V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+    }
 
   video_framebuff_capture_done(&type_inf->bufinf);
 
@@ -2169,6 +2209,16 @@ static int capture_reqbufs(FAR struct file *filep,
           reqbufs->count = V4L2_REQBUFS_COUNT_MAX;
         }
 
+#ifdef CONFIG_VIDEO_DMABUF
+      /* Exported buffers are not freed under the other devices */
+
+      if (atomic_read(&type_inf->exported) > 0)
+        {
+          leave_critical_section(flags);
+          return -EBUSY;
+        }
+#endif
+
       video_framebuff_change_mode(&type_inf->bufinf, reqbufs->mode);
       ret = video_framebuff_realloc_container(&type_inf->bufinf,
                                               reqbufs->count);
@@ -2279,6 +2329,28 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      FAR void *addr;
+      size_t len;
+      int ret;
+
+      /* Capture right into the buffer of the other device */
+
+      ret = video_dmabuf_import(buf->m.fd, &addr, &len);
+      if (ret < 0 ||
+          len < get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]))
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret < 0 ? ret : -EINVAL;
+        }
+
+      container->fd            = buf->m.fd;
+      container->buf.length    = len;
+      container->buf.m.userptr = (unsigned long)addr;
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2394,11 +2466,66 @@ static int capture_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = container->fd;
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  irqstate_t flags;
+  size_t bufsize;
+  int ret;
+
+  if (cmng == NULL || exp == NULL || exp->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, exp->type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  /* Only the buffers of V4L2_MEMORY_MMAP belong to the driver */
+
+  if (type_inf->bufheap == NULL ||
+      exp->index >= type_inf->bufinf.container_size)
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  bufsize = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+  ret = video_dmabuf_export(type_inf->bufheap + bufsize * exp->index,
+                            bufsize, exp->flags, &type_inf->exported);
+  leave_critical_section(flags);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  exp->fd = ret;
+  return OK;
+}
+#endif
+
 static int capture_cancel_dqbuf(FAR struct file *filep,
                                 enum v4l2_buf_type type)
 {
@@ -193,6 +193,15 @@ static int v4l2_ioctl(FAR struct file *filep,
         return v4l2->vops->qbuf(filep,
                              (FAR struct v4l2_buffer *)arg);
 
+      case VIDIOC_EXPBUF:
+        if (v4l2->vops->expbuf == NULL)
+          {
+            break;
+          }
+
+        return v4l2->vops->expbuf(filep,
+                             (FAR struct v4l2_exportbuffer *)arg);
+
       case VIDIOC_DQBUF:
         if (v4l2->vops->dqbuf == NULL)
           {
@@ -33,6 +33,7 @@
 #include <nuttx/video/v4l2_m2m.h>
 #include <nuttx/video/video.h>
 
+#include "video_dmabuf.h"
 #include "video_framebuff.h"
 
 /****************************************************************************
@@ -166,6 +167,7 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_reqbufs,         /* reqbufs */
   codec_querybuf,        /* querybuf */
   codec_qbuf,            /* qbuf */
+  NULL,                  /* expbuf */
   codec_dqbuf,           /* dqbuf */
   NULL,                  /* cancel_dqbuf */
   codec_g_fmt,           /* g_fmt */
@@ -413,6 +415,29 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      FAR void *addr;
+      size_t len;
+      int ret;
+
+      /* Code from or into the buffer of the other device, as the frame
+       * a camera captured.
+       */
+
+      ret = video_dmabuf_import(buf->m.fd, &addr, &len);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+
+      container->fd            = buf->m.fd;
+      container->buf.length    = len;
+      container->buf.m.userptr = (unsigned long)addr;
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -461,6 +486,13 @@ static int codec_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = container->fd;
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   vinfo("%s dequeue done\n", V4L2_TYPE_IS_OUTPUT(buf->type) ?
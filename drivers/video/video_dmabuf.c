@@ -0,0 +1,198 @@
+/****************************************************************************
+ * drivers/video/video_dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+
+#include "video_dmabuf.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct video_dmabuf_s
+{
+  FAR uint8_t  *addr;            /* Start of the buffer                     */
+  size_t        len;             /* Length of the buffer in bytes           */
+  FAR atomic_t *users;           /* Descriptors open on the exporter        */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int video_dmabuf_close(FAR struct file *filep);
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_video_dmabuf_fops =
+{
+  NULL,                /* open */
+  video_dmabuf_close,  /* close */
+  NULL,                /* read */
+  NULL,                /* write */
+  NULL,                /* seek */
+  NULL,                /* ioctl */
+  video_dmabuf_mmap,   /* mmap */
+};
+
+static struct inode g_video_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_video_dmabuf_fops  /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int video_dmabuf_close(FAR struct file *filep)
+{
+  FAR struct video_dmabuf_s *dmabuf = filep->f_priv;
+
+  if (dmabuf->users != NULL)
+    {
+      atomic_fetch_sub(dmabuf->users, 1);
+    }
+
+  kmm_free(dmabuf);
+  return OK;
+}
+
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map)
+{
+  FAR struct video_dmabuf_s *dmabuf = filep->f_priv;
+
+  if (map->offset < 0 || map->offset >= dmabuf->len ||
+      map->length == 0 || map->offset + map->length > dmabuf->len)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = dmabuf->addr + map->offset;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: video_dmabuf_export
+ ****************************************************************************/
+
+int video_dmabuf_export(FAR void *addr, size_t len, int oflags,
+                        FAR atomic_t *users)
+{
+  FAR struct video_dmabuf_s *dmabuf;
+  int fd;
+
+  if (addr == NULL || len == 0 ||
+      (oflags & ~(O_ACCMODE | O_CLOEXEC)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf = kmm_malloc(sizeof(struct video_dmabuf_s));
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dmabuf->addr  = addr;
+  dmabuf->len   = len;
+  dmabuf->users = users;
+
+  /* Count the user first: the exporter must not free the buffer from the
+   * moment the descriptor exists.
+   */
+
+  if (users != NULL)
+    {
+      atomic_fetch_add(users, 1);
+    }
+
+  fd = file_allocate(&g_video_dmabuf_inode, oflags, 0, dmabuf, 0, true);
+  if (fd < 0)
+    {
+      if (users != NULL)
+        {
+          atomic_fetch_sub(users, 1);
+        }
+
+      kmm_free(dmabuf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: video_dmabuf_import
+ ****************************************************************************/
+
+int video_dmabuf_import(int fd, FAR void **addr, FAR size_t *len)
+{
+  FAR struct video_dmabuf_s *dmabuf;
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode != &g_video_dmabuf_inode)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      dmabuf = filep->f_priv;
+      *addr  = dmabuf->addr;
+      *len   = dmabuf->len;
+    }
+
+  fs_putfilep(filep);
+  return ret;
+}
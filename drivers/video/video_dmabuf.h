@@ -0,0 +1,83 @@
+/****************************************************************************
+ * drivers/video/video_dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_VIDEO_VIDEO_DMABUF_H
+#define __DRIVERS_VIDEO_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/atomic.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: video_dmabuf_export
+ *
+ * Description:
+ *   Return a new file descriptor that stands for a buffer of a video
+ *   device, to be mmap'ed or queued to another device with
+ *   V4L2_MEMORY_DMABUF, so that the devices share the buffer instead of
+ *   copying the frames.
+ *
+ * Input Parameters:
+ *   addr   - The start of the buffer.
+ *   len    - Its length in bytes.
+ *   oflags - O_CLOEXEC, O_RDONLY, O_WRONLY or O_RDWR.
+ *   users  - Counts the descriptors open on the buffers of the exporter,
+ *            which must not free them until it drops to zero.  NULL if the
+ *            buffer is never freed.
+ *
+ * Returned Value:
+ *   The file descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int video_dmabuf_export(FAR void *addr, size_t len, int oflags,
+                        FAR atomic_t *users);
+
+/****************************************************************************
+ * Name: video_dmabuf_import
+ *
+ * Description:
+ *   Return the buffer a file descriptor returned by video_dmabuf_export()
+ *   stands for.  The descriptor must stay open while the buffer is in use.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBADF if fd is not open, -EINVAL if it is not
+ *   a video buffer.
+ *
+ ****************************************************************************/
+
+int video_dmabuf_import(int fd, FAR void **addr, FAR size_t *len);
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __DRIVERS_VIDEO_VIDEO_DMABUF_H */
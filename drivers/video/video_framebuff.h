@@ -40,6 +40,9 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  int                      fd;    /* Descriptor of a DMABUF buffer */
+#endif
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
@@ -0,0 +1,499 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_hextile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEXTILE_SIZE 16
+
+/* The most bytes that one tile can take: a Raw tile.  The RRE-like forms
+ * fall back to Raw as soon as they grow bigger.
+ */
+
+#define HEXTILE_TILEMAX(bpp) (1 + HEXTILE_SIZE * HEXTILE_SIZE * (bpp))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of the encoding of one rectangle */
+
+struct vnc_hextile_s
+{
+  uint8_t colorfmt;              /* Remote color format */
+  uint8_t bytesperpixel;         /* Remote bytes per pixel */
+  bool bigendian;                /* Remote byte order */
+  bool bgvalid;                  /* The previous tile set a background */
+  bool fgvalid;                  /* The previous tile set a foreground */
+  lfb_color_t bg;                /* That background, in the local format */
+  lfb_color_t fg;                /* That foreground, in the local format */
+  FAR uint8_t *dest;             /* Where the next byte goes in outbuf */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_pixel
+ *
+ * Description:
+ *   Convert a local pixel to the remote color format and append it.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_pixel(FAR struct vnc_hextile_s *hex,
+                              lfb_color_t rgb)
+{
+  uint32_t pixel;
+
+  switch (hex->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        *hex->dest++ = vnc_convert_rgb8_222(rgb);
+        return;
+
+      case FB_FMT_RGB8_332:
+        *hex->dest++ = vnc_convert_rgb8_332(rgb);
+        return;
+
+      case FB_FMT_RGB16_555:
+        pixel = vnc_convert_rgb16_555(rgb);
+        break;
+
+      case FB_FMT_RGB16_565:
+        pixel = vnc_convert_rgb16_565(rgb);
+        break;
+
+      default:
+        pixel = vnc_convert_rgb32_888(rgb);
+        if (hex->bigendian)
+          {
+            rfb_putbe32(hex->dest, pixel);
+          }
+        else
+          {
+            rfb_putle32(hex->dest, pixel);
+          }
+
+        hex->dest += sizeof(uint32_t);
+        return;
+    }
+
+  if (hex->bigendian)
+    {
+      rfb_putbe16(hex->dest, pixel);
+    }
+  else
+    {
+      rfb_putle16(hex->dest, pixel);
+    }
+
+  hex->dest += sizeof(uint16_t);
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile of at most 16x16 pixels, choosing the smallest form:
+ *   a solid tile is its background alone; a tile of two colors is the
+ *   subrectangles of its foreground; other tiles are the subrectangles of
+ *   each color, or the raw pixels if those would not be smaller.  The
+ *   subrectangles are grown greedily, right then down.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_tile(FAR struct vnc_session_s *session,
+                             FAR struct vnc_hextile_s *hex,
+                             fb_coord_t x, fb_coord_t y,
+                             fb_coord_t w, fb_coord_t h)
+{
+  FAR const lfb_color_t *tile;
+  FAR uint8_t *start = hex->dest;
+  FAR uint8_t *nsubrects;
+  uint16_t covered[HEXTILE_SIZE];
+  size_t rawsize;
+  size_t rectsize;
+  lfb_color_t pixel;
+  lfb_color_t bg;
+  lfb_color_t fg = 0;
+  uint32_t bits;
+  uint8_t mask;
+  bool solid = true;
+  bool mono = true;
+  int nrects = 0;
+  int tx;
+  int ty;
+  int rw;
+  int rh;
+  int i;
+
+#define HEXTILE_PIXEL(col, row) \
+  tile[(row) * CONFIG_VNCSERVER_SCREENWIDTH + (col)]
+
+  tile    = (FAR const lfb_color_t *)
+            (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+  rawsize = 1 + w * h * hex->bytesperpixel;
+
+  /* The first pixel is the background; find at most one other color */
+
+  bg = HEXTILE_PIXEL(0, 0);
+  for (ty = 0; ty < h && mono; ty++)
+    {
+      for (tx = 0; tx < w; tx++)
+        {
+          pixel = HEXTILE_PIXEL(tx, ty);
+          if (pixel == bg)
+            {
+              continue;
+            }
+
+          if (solid)
+            {
+              fg    = pixel;
+              solid = false;
+            }
+          else if (pixel != fg)
+            {
+              mono = false;
+              break;
+            }
+        }
+    }
+
+  mask = solid ? 0 : RFB_HEXTILE_ANY;
+  hex->dest++;
+
+  if (!hex->bgvalid || hex->bg != bg)
+    {
+      mask |= RFB_HEXTILE_BACK;
+      vnc_hextile_pixel(hex, bg);
+    }
+
+  if (solid)
+    {
+      *start       = mask;
+      hex->bg      = bg;
+      hex->bgvalid = true;
+      return;
+    }
+
+  if (!mono)
+    {
+      mask    |= RFB_HEXTILE_COLORED;
+      rectsize = hex->bytesperpixel + 2;
+    }
+  else
+    {
+      if (!hex->fgvalid || hex->fg != fg)
+        {
+          mask |= RFB_HEXTILE_FORE;
+          vnc_hextile_pixel(hex, fg);
+        }
+
+      rectsize = 2;
+    }
+
+  nsubrects = hex->dest++;
+  memset(covered, 0, sizeof(covered));
+
+  for (ty = 0; ty < h; ty++)
+    {
+      for (tx = 0; tx < w; tx++)
+        {
+          pixel = HEXTILE_PIXEL(tx, ty);
+          if (pixel == bg || (covered[ty] & (1 << tx)) != 0)
+            {
+              continue;
+            }
+
+          /* Grow right over the uncovered pixels of the same color */
+
+          for (rw = 1; tx + rw < w; rw++)
+            {
+              if (HEXTILE_PIXEL(tx + rw, ty) != pixel ||
+                  (covered[ty] & (1 << (tx + rw))) != 0)
+                {
+                  break;
+                }
+            }
+
+          /* Then down while the whole run matches */
+
+          for (rh = 1; ty + rh < h; rh++)
+            {
+              for (i = 0; i < rw; i++)
+                {
+                  if (HEXTILE_PIXEL(tx + i, ty + rh) != pixel ||
+                      (covered[ty + rh] & (1 << (tx + i))) != 0)
+                    {
+                      break;
+                    }
+                }
+
+              if (i < rw)
+                {
+                  break;
+                }
+            }
+
+          if ((size_t)(hex->dest - start) + rectsize > rawsize)
+            {
+              goto raw;
+            }
+
+          bits = ((1u << rw) - 1) << tx;
+          for (i = 0; i < rh; i++)
+            {
+              covered[ty + i] |= bits;
+            }
+
+          if (!mono)
+            {
+              vnc_hextile_pixel(hex, pixel);
+            }
+
+          *hex->dest++ = (tx << 4) | ty;
+          *hex->dest++ = ((rw - 1) << 4) | (rh - 1);
+          nrects++;
+        }
+    }
+
+  *start       = mask;
+  *nsubrects   = nrects;
+  hex->bg      = bg;
+  hex->bgvalid = true;
+  hex->fg      = fg;
+  hex->fgvalid = mono;
+  return;
+
+raw:
+
+  /* Raw pixels, after which neither color carries over */
+
+  hex->dest    = start;
+  *hex->dest++ = RFB_HEXTILE_RAW;
+
+  for (ty = 0; ty < h; ty++)
+    {
+      for (tx = 0; tx < w; tx++)
+        {
+          vnc_hextile_pixel(hex, HEXTILE_PIXEL(tx, ty));
+        }
+    }
+
+  hex->bgvalid = false;
+  hex->fgvalid = false;
+#undef HEXTILE_PIXEL
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_send
+ *
+ * Description:
+ *   Send the encoded part of the update.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_send(FAR struct vnc_session_s *session,
+                            FAR const uint8_t *src, size_t size)
+{
+  ssize_t nsent;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle with the Hextile encoding, if the client
+ *  supports it.  The tiles are encoded into the output buffer, which is
+ *  sent whenever it may not hold the next tile, so that a rectangle of any
+ *  size is sent as a single rectangle of one FramebufferUpdate.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR uint8_t *outend = session->outbuf + sizeof(session->outbuf);
+  struct vnc_hextile_s hex;
+  size_t tilemax;
+  size_t nbytes = 0;
+  fb_coord_t x;
+  fb_coord_t y;
+  int ret;
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  memset(&hex, 0, sizeof(hex));
+  hex.colorfmt      = session->colorfmt;
+  hex.bytesperpixel = (session->bpp + 7) >> 3;
+  hex.bigendian     = session->bigendian;
+
+  switch (hex.colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+      case FB_FMT_RGB8_332:
+      case FB_FMT_RGB16_555:
+      case FB_FMT_RGB16_565:
+      case FB_FMT_RGB32:
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", hex.colorfmt);
+        return -EINVAL;
+    }
+
+  /* Leave it to the Raw encoding if a tile might not fit */
+
+  tilemax = HEXTILE_TILEMAX(hex.bytesperpixel);
+  if (tilemax > sizeof(session->outbuf))
+    {
+      return 0;
+    }
+
+  /* Format the FrameBuffer Update with a single Hextile rectangle */
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->x);
+  rfb_putbe16(update->rect[0].ypos, rect->y);
+  rfb_putbe16(update->rect[0].width, rect->w);
+  rfb_putbe16(update->rect[0].height, rect->h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  hex.dest = session->outbuf +
+             SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+
+  for (y = 0; y < rect->h; y += HEXTILE_SIZE)
+    {
+      for (x = 0; x < rect->w; x += HEXTILE_SIZE)
+        {
+          if ((size_t)(outend - hex.dest) < tilemax)
+            {
+              ret = vnc_hextile_send(session, session->outbuf,
+                                     hex.dest - session->outbuf);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              nbytes  += hex.dest - session->outbuf;
+              hex.dest = session->outbuf;
+            }
+
+          vnc_hextile_tile(session, &hex, rect->x + x, rect->y + y,
+                           MIN(HEXTILE_SIZE, rect->w - x),
+                           MIN(HEXTILE_SIZE, rect->h - y));
+        }
+    }
+
+  ret = vnc_hextile_send(session, session->outbuf,
+                         hex.dest - session->outbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nbytes += hex.dest - session->outbuf;
+  updinfo("Sent {(%d, %d),(%d, %d)} in %zu bytes\n",
+          rect->x, rect->y, rect->w, rect->h, nbytes);
+  return nbytes;
+}
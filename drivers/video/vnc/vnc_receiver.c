@@ -298,6 +298,10 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                     {
                       gerr("ERROR: Failed to queue update: %d\n", ret);
                     }
+
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+                  vnc_update_demand(session);
+#endif
                 }
             }
             break;
@@ -471,6 +475,7 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+  session->hextile = false;
 
   /* Loop for each client supported encoding */
 
@@ -487,6 +492,13 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
     }
 
   session->change = true;
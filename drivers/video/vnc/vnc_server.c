@@ -120,6 +120,9 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
 
   nxsem_reset(&session->freesem, CONFIG_VNCSERVER_NUPDATES);
   nxsem_reset(&session->queuesem, 0);
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+  nxsem_reset(&session->reqsem, 0);
+#endif
 
   session->fb      = fb;
   session->display = display;
@@ -127,6 +130,12 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->nwhupd  = 0;
   session->change  = true;
 
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  /* Nothing is known of what the next client shows */
+
+  session->shadowed = false;
+#endif
+
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
 #endif
@@ -284,6 +293,22 @@ int vnc_server(int argc, FAR char *argv[])
   g_vnc_sessions[display] = session;
   nxsem_init(&session->freesem, 0, CONFIG_VNCSERVER_NUPDATES);
   nxsem_init(&session->queuesem, 0, 0);
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+  nxsem_init(&session->reqsem, 0, 0);
+#endif
+
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  /* The copy of the framebuffer as sent, to send only what changed.  Do
+   * without it if there is no memory for it.
+   */
+
+  session->shadow = kmm_zalloc(RFB_SIZE);
+  if (session->shadow == NULL)
+    {
+      gwarn("WARNING: No shadow framebuffer: %lu KB\n",
+            (unsigned long)(RFB_SIZE / 1024));
+    }
+#endif
 
 #ifdef CONFIG_FB_SYNC
   nxsem_init(&session->vsyncsem, 0, 0);
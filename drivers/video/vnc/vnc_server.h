@@ -189,6 +189,7 @@ struct vnc_fbupdate_s
 {
   FAR struct vnc_fbupdate_s *flink;
   bool whupd;                  /* True: whole screen update */
+  bool change;                 /* True: queued for a framebuffer change only */
   struct fb_area_s rect;       /* The enqueued update rectangle */
 };
 
@@ -209,7 +210,12 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
   FAR uint8_t *fb;             /* Allocated local frame buffer */
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  FAR uint8_t *shadow;         /* The frame buffer as last sent, or NULL */
+  bool shadowed;               /* True: shadow matches the client */
+#endif
 
   /* VNC client input support */
 
@@ -236,6 +242,9 @@ struct vnc_session_s
   sq_queue_t updqueue;
   sem_t freesem;
   sem_t queuesem;
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+  sem_t reqsem;                /* Posted when the client asks for updates */
+#endif
 #ifdef CONFIG_FB_SYNC
   sem_t vsyncsem;
 #endif
@@ -427,6 +436,22 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct fb_area_s *rect,
                          bool change);
 
+/****************************************************************************
+ * Name: vnc_update_demand
+ *
+ * Description:
+ *  Let the updater send what is queued, in response to a
+ *  FramebufferUpdateRequest from the client.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+void vnc_update_demand(FAR struct vnc_session_s *session);
+#endif
+
 /****************************************************************************
  * Name: vnc_receiver
  *
@@ -466,6 +491,30 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle with the Hextile encoding, if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
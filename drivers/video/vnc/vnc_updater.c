@@ -351,6 +351,136 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
               sval <= CONFIG_VNCSERVER_NUPDATES);
 }
 
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Merge a rectangle into a queued one if their bounding box is no larger
+ *   than the two together, as when one holds the other, they overlap much
+ *   or they share a whole side.  The caller is in a critical section.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be merged.
+ *   change  - True: Frame buffer data has changed
+ *
+ * Returned Value:
+ *   True if the rectangle was merged; false if it is to be queued.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *rect, bool change)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  fb_coord_t x1;
+  fb_coord_t y1;
+  fb_coord_t x2;
+  fb_coord_t y2;
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL; curr = curr->flink)
+    {
+      x1 = MIN(curr->rect.x, rect->x);
+      y1 = MIN(curr->rect.y, rect->y);
+      x2 = MAX(curr->rect.x + curr->rect.w, rect->x + rect->w);
+      y2 = MAX(curr->rect.y + curr->rect.h, rect->y + rect->h);
+
+      if ((uint32_t)(x2 - x1) * (y2 - y1) <=
+          (uint32_t)curr->rect.w * curr->rect.h +
+          (uint32_t)rect->w * rect->h)
+        {
+          curr->rect.x  = x1;
+          curr->rect.y  = y1;
+          curr->rect.w  = x2 - x1;
+          curr->rect.h  = y2 - y1;
+          curr->change &= change;
+
+          updinfo("Merged into {(%d, %d),(%d, %d)}\n",
+                  x1, y1, curr->rect.w, curr->rect.h);
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: vnc_shadow_trim
+ *
+ * Description:
+ *   Copy the rectangle of the framebuffer into the shadow framebuffer,
+ *   first shrinking it to the pixels that differ from the shadow.  The
+ *   copy is made before the rectangle is sent, so that a change made
+ *   while it is being sent is seen by the next update.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle, trimmed on return.
+ *   trim    - False: copy only, the client wants the whole rectangle
+ *
+ * Returned Value:
+ *   False if nothing changed in the rectangle, so nothing is to be sent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+static bool vnc_shadow_trim(FAR struct vnc_session_s *session,
+                            FAR struct fb_area_s *rect, bool trim)
+{
+  FAR const lfb_color_t *src;
+  FAR lfb_color_t *dest;
+  size_t offset;
+  fb_coord_t left = rect->w;
+  fb_coord_t right = 0;
+  fb_coord_t top = rect->h;
+  fb_coord_t bottom = 0;
+  fb_coord_t x;
+  fb_coord_t y;
+
+  if (trim)
+    {
+      for (y = 0; y < rect->h; y++)
+        {
+          offset = RFB_STRIDE * (rect->y + y) + RFB_BYTESPERPIXEL * rect->x;
+          src    = (FAR const lfb_color_t *)(session->fb + offset);
+          dest   = (FAR lfb_color_t *)(session->shadow + offset);
+
+          for (x = 0; x < rect->w && src[x] == dest[x]; x++);
+          if (x == rect->w)
+            {
+              continue;
+            }
+
+          left = MIN(left, x);
+          for (x = rect->w; src[x - 1] == dest[x - 1]; x--);
+          right  = MAX(right, x);
+          top    = MIN(top, y);
+          bottom = y + 1;
+        }
+
+      if (top >= bottom)
+        {
+          return false;
+        }
+
+      rect->x += left;
+      rect->y += top;
+      rect->w  = right - left;
+      rect->h  = bottom - top;
+    }
+
+  for (y = 0; y < rect->h; y++)
+    {
+      offset = RFB_STRIDE * (rect->y + y) + RFB_BYTESPERPIXEL * rect->x;
+      memcpy(session->shadow + offset, session->fb + offset,
+             RFB_BYTESPERPIXEL * rect->w);
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -374,6 +504,9 @@ static FAR void *vnc_updater(FAR void *arg)
 #ifdef CONFIG_FB_SYNC
   int val;
 #endif
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+  bool more = false;
+#endif
 
   DEBUGASSERT(session != NULL);
   ginfo("Updater running for Display %d\n", session->display);
@@ -386,6 +519,23 @@ static FAR void *vnc_updater(FAR void *arg)
 
   while (session->state == VNCSERVER_RUNNING)
     {
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+      /* Send nothing until the client asks for an update, then all that is
+       * queued.  Meanwhile the framebuffer changes are merged into the
+       * queued rectangles, so that a client on a slow link gets fewer and
+       * larger updates rather than falling behind.
+       */
+
+      if (!more)
+        {
+          nxsem_wait_uninterruptible(&session->reqsem);
+          if (session->state != VNCSERVER_RUNNING)
+            {
+              break;
+            }
+        }
+#endif
+
       /* Get the next queued rectangle update.  This call will block until an
        * update is available for the case where the update queue is empty.
        */
@@ -408,20 +558,53 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+      /* Send only the part that differs from what the client has.  What it
+       * asked for itself is sent whole.
+       */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+      if (session->shadow != NULL &&
+          !vnc_shadow_trim(session, &srcrect->rect,
+                           srcrect->change && session->shadowed))
+        {
+          ret = OK;
+        }
+      else
+#endif
         {
-          /* Perform the framebuffer update using the default RAW encoding */
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+          session->shadowed |= srcrect->whupd;
+#endif
 
-          ret = vnc_raw(session, &srcrect->rect);
+          /* Attempt to use RRE encoding for a single color */
+
+          ret = vnc_rre(session, &srcrect->rect);
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+          if (ret == 0)
+            {
+              ret = vnc_hextile(session, &srcrect->rect);
+            }
+#endif
+
+          if (ret == 0)
+            {
+              /* Perform the framebuffer update using the default RAW
+               * encoding
+               */
+
+              ret = vnc_raw(session, &srcrect->rect);
+            }
         }
 
       /* Release the update structure */
 
       vnc_free_update(session, srcrect);
 
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+      more = !sq_empty(&session->updqueue);
+#endif
+
 #ifdef CONFIG_FB_SYNC
       ret = nxsem_get_value(&session->vsyncsem, &val);
 
@@ -529,6 +712,9 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
       /* Notify updater thread we stopped */
 
       nxsem_post(&session->queuesem);
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+      nxsem_post(&session->reqsem);
+#endif
 
       /* Wait for the thread to comply with our request */
 
@@ -548,6 +734,35 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
   return OK;
 }
 
+/****************************************************************************
+ * Name: vnc_update_demand
+ *
+ * Description:
+ *  Let the updater send what is queued, in response to a
+ *  FramebufferUpdateRequest from the client.  The requests do not add up:
+ *  one lets the updater send all that is queued at the time.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_UPDATE_PACING
+void vnc_update_demand(FAR struct vnc_session_s *session)
+{
+  irqstate_t flags;
+  int sval;
+
+  flags = enter_critical_section();
+  if (nxsem_get_value(&session->reqsem, &sval) == 0 && sval <= 0)
+    {
+      nxsem_post(&session->reqsem);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_update_rectangle
  *
@@ -661,6 +876,14 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Grow a queued update rather than queue another */
+
+              if (vnc_merge_queue(session, &intersection, change))
+                {
+                  leave_critical_section(flags);
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
@@ -670,7 +893,8 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
           /* Copy the clipped rectangle into the update structure */
 
-          update->whupd = whupd;
+          update->whupd  = whupd;
+          update->change = change;
           memcpy(&update->rect, &intersection, sizeof(intersection));
 
           /* Add the update to the end of the update queue. */
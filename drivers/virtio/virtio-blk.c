@@ -24,12 +24,15 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/uio.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
@@ -45,9 +48,11 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SEG_MAX        2  /* Maximum segments per request */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
 
 /* Block request type */
 
@@ -66,6 +71,11 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* Request queues, one per CPU when the device offers enough of them */
+
+#define VIRTIO_BLK_NQUEUES \
+  MIN(CONFIG_DRIVERS_VIRTIO_BLK_NQUEUES, CONFIG_SMP_NCPUS)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -114,12 +124,35 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* One request in flight, lives on the stack of the submitting thread */
+
+struct virtio_blk_cmd_s
+{
+  struct virtio_blk_req_s       req;            /* Out header */
+  struct virtio_blk_resp_s      resp;           /* In header */
+  sem_t                         done;           /* Posted on completion */
+};
+
+/* One request queue.  Any number of requests may be outstanding, the
+ * submitters wait on 'space' while the ring has too few free descriptors.
+ */
+
+struct virtio_blk_queue_s
+{
+  FAR struct virtqueue         *vq;             /* The virtqueue */
+  spinlock_t                    lock;           /* Protects vq and nwait */
+  sem_t                         space;          /* Descriptors were freed */
+  int                           nwait;          /* Waiters on space */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      seg_max;        /* Data segments per request */
+  int                           nqueues;        /* Number of request queues */
+  struct virtio_blk_queue_s     queues[VIRTIO_BLK_NQUEUES];
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -129,9 +162,15 @@ struct virtio_blk_priv_s
 
 /* BLK block_operations functions and they helper function */
 
+static int     virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                                 uint32_t type, blkcnt_t startsector,
+                                 FAR struct virtqueue_buf *vb, int nsegs);
 static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write);
+static ssize_t virtio_blk_rdwrv(FAR struct virtio_blk_priv_s *priv,
+                                FAR struct uio *uio, blkcnt_t startsector,
+                                unsigned int nsectors, bool write);
 static int     virtio_blk_open(FAR struct inode *inode);
 static int     virtio_blk_close(FAR struct inode *inode);
 static ssize_t virtio_blk_read(FAR struct inode *inode,
@@ -140,6 +179,12 @@ static ssize_t virtio_blk_read(FAR struct inode *inode,
 static ssize_t virtio_blk_write(FAR struct inode *inode,
                                 FAR const unsigned char *buffer,
                                 blkcnt_t startsector, unsigned int nsectors);
+static ssize_t virtio_blk_readv(FAR struct inode *inode,
+                                FAR struct uio *uio, blkcnt_t startsector,
+                                unsigned int nsectors);
+static ssize_t virtio_blk_writev(FAR struct inode *inode,
+                                 FAR struct uio *uio, blkcnt_t startsector,
+                                 unsigned int nsectors);
 static int     virtio_blk_geometry(FAR struct inode *inode,
                                    FAR struct geometry *geometry);
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
@@ -174,7 +219,12 @@ static const struct block_operations g_virtio_blk_bops =
   virtio_blk_read,     /* read     */
   virtio_blk_write,    /* write    */
   virtio_blk_geometry, /* geometry */
-  virtio_blk_ioctl     /* ioctl    */
+  virtio_blk_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,                /* unlink   */
+#endif
+  virtio_blk_readv,    /* readv    */
+  virtio_blk_writev    /* writev   */
 };
 
 static int g_virtio_blk_idx = 0;
@@ -183,6 +233,20 @@ static int g_virtio_blk_idx = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_queue
+ *
+ * Description:
+ *   Return the request queue of the calling CPU.
+ *
+ ****************************************************************************/
+
+static FAR struct virtio_blk_queue_s *
+virtio_blk_queue(FAR struct virtio_blk_priv_s *priv)
+{
+  return &priv->queues[this_cpu() % priv->nqueues];
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -191,112 +255,229 @@ static int g_virtio_blk_idx = 0;
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+static void virtio_blk_wait_complete(FAR struct virtio_blk_queue_s *q,
+                                     FAR struct virtio_blk_cmd_s *cmd)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  FAR struct virtio_blk_cmd_s *done;
 
   if (up_interrupt_context())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
+          done = virtqueue_get_buffer_lock(q->vq, NULL, NULL, &q->lock);
+          if (done == cmd)
             {
               break;
             }
-          else if (sem != NULL)
+          else if (done != NULL)
             {
-              nxsem_post(sem);
+              nxsem_post(&done->done);
             }
         }
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      nxsem_wait_uninterruptible(&cmd->done);
     }
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_submit
  *
  * Description:
- *   Common function for read and write
+ *   Queue one request on the queue of the calling CPU and wait for its
+ *   completion.  vb[0] and vb[nsegs + 1] are reserved for the headers, the
+ *   data segments are vb[1..nsegs].  Requests from other CPUs go to other
+ *   queues and requests from the same CPU stay outstanding together, the
+ *   only wait is for the completion or for free descriptors.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             uint32_t type, blkcnt_t startsector,
+                             FAR struct virtqueue_buf *vb, int nsegs)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR struct virtio_blk_queue_s *q = virtio_blk_queue(priv);
+  struct virtio_blk_cmd_s cmd;
   irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
   int readnum;
+  int ret;
 
-  nxsem_init(&respsem, 0, 0);
+  if (nsegs + 2 > q->vq->vq_nentries)
+    {
+      return -E2BIG;
+    }
+
+  nxsem_init(&cmd.done, 0, 0);
 
   /* Build the block request */
 
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cmd.req.type     = type;
+  cmd.req.reserved = 0;
+  cmd.req.sector   = startsector * priv->block_size >>
+                     VIRTIO_BLK_SECTOR_BITS;
+  cmd.resp.status  = VIRTIO_BLK_S_IOERR;
 
   /* Fill the virtqueue buffer:
    * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
+   * Buffer 1..nsegs: the read/write buffers;
+   * Buffer nsegs + 1: the block in header, return the status.
    */
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
+  vb[0].buf         = &cmd.req;
+  vb[0].len         = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[nsegs + 1].buf = &cmd.resp;
+  vb[nsegs + 1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+  readnum = type == VIRTIO_BLK_T_IN ? 1 : nsegs + 1;
 
   if (up_interrupt_context())
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      virtqueue_disable_cb_lock(q->vq, &q->lock);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  flags = spin_lock_irqsave(&q->lock);
+  while (q->vq->vq_free_cnt < nsegs + 2 && !up_interrupt_context())
+    {
+      q->nwait++;
+      spin_unlock_irqrestore(&q->lock, flags);
+      nxsem_wait_uninterruptible(&q->space);
+      flags = spin_lock_irqsave(&q->lock);
+    }
+
+  ret = virtqueue_add_buffer(q->vq, vb, readnum, nsegs + 2 - readnum, &cmd);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
+      spin_unlock_irqrestore(&q->lock, flags);
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
       goto err;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  virtqueue_kick(q->vq);
+  spin_unlock_irqrestore(&q->lock, flags);
 
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(q, &cmd);
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (cmd.resp.status != VIRTIO_BLK_S_OK)
     {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      ret = cmd.resp.status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
     }
 
 err:
   if (up_interrupt_context())
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      virtqueue_enable_cb_lock(q->vq, &q->lock);
+    }
+
+  nxsem_destroy(&cmd.done);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  struct virtqueue_buf vb[3];
+  int ret;
+
+  vb[1].buf = buffer;
+  vb[1].len = nsectors * priv->block_size;
+
+  ret = virtio_blk_submit(priv, write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN,
+                          startsector, vb, 1);
+  if (ret < 0)
+    {
+      vrterr("%s Error\n", write ? "Write" : "Read");
+      return ret;
+    }
+
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwrv
+ *
+ * Description:
+ *   Transfer the uio segments with one request.  The segments beyond the
+ *   device limit (seg_max) are transferred one by one.
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwrv(FAR struct virtio_blk_priv_s *priv,
+                                FAR struct uio *uio, blkcnt_t startsector,
+                                unsigned int nsectors, bool write)
+{
+  struct virtqueue_buf vb[CONFIG_DRIVERS_VIRTIO_BLK_MAXSEGS + 2];
+  FAR const struct iovec *iov = uio->uio_iov;
+  size_t offset = uio->uio_offset_in_iov;
+  size_t remain = (size_t)nsectors * priv->block_size;
+  unsigned int maxsegs;
+  unsigned int nsegs = 0;
+  ssize_t ret;
+  size_t len;
+  int i;
+
+  maxsegs = MIN(priv->seg_max, CONFIG_DRIVERS_VIRTIO_BLK_MAXSEGS);
+  for (i = 0; i < uio->uio_iovcnt && remain > 0; i++, offset = 0)
+    {
+      len = MIN(iov[i].iov_len - offset, remain);
+      if (len == 0)
+        {
+          continue;
+        }
+
+      if (nsegs == maxsegs)
+        {
+          break;
+        }
+
+      nsegs++;
+      vb[nsegs].buf = (FAR uint8_t *)iov[i].iov_base + offset;
+      vb[nsegs].len = len;
+      remain -= len;
+    }
+
+  if (remain == 0)
+    {
+      ret = virtio_blk_submit(priv, write ? VIRTIO_BLK_T_OUT :
+                              VIRTIO_BLK_T_IN, startsector, vb, nsegs);
+      return ret < 0 ? ret : nsectors;
     }
 
-  return ret >= 0 ? nsectors : ret;
+  /* Too many segments, one request per segment */
+
+  iov    = uio->uio_iov;
+  offset = uio->uio_offset_in_iov;
+  remain = nsectors;
+  for (i = 0; i < uio->uio_iovcnt && remain > 0; i++, offset = 0)
+    {
+      len = MIN((iov[i].iov_len - offset) / priv->block_size, remain);
+      if (len == 0)
+        {
+          continue;
+        }
+
+      ret = virtio_blk_rdwr(priv, (FAR uint8_t *)iov[i].iov_base + offset,
+                            startsector, len, write);
+      if (ret < 0)
+        {
+          return remain < nsectors ? nsectors - remain : ret;
+        }
+
+      startsector += len;
+      remain      -= len;
+    }
+
+  return nsectors - remain;
 }
 
 /****************************************************************************
@@ -371,6 +552,49 @@ static ssize_t virtio_blk_write(FAR struct inode *inode,
                          true);
 }
 
+/****************************************************************************
+ * Name: virtio_blk_readv
+ *
+ * Description:
+ *   Read the sectors into the uio segments with one device request.
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_readv(FAR struct inode *inode,
+                                FAR struct uio *uio, blkcnt_t startsector,
+                                unsigned int nsectors)
+{
+  FAR struct virtio_blk_priv_s *priv;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+  return virtio_blk_rdwrv(priv, uio, startsector, nsectors, false);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_writev
+ *
+ * Description:
+ *   Write the sectors from the uio segments with one device request.
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_writev(FAR struct inode *inode,
+                                 FAR struct uio *uio, blkcnt_t startsector,
+                                 unsigned int nsectors)
+{
+  FAR struct virtio_blk_priv_s *priv;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+  if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+    {
+      return -EPERM;
+    }
+
+  return virtio_blk_rdwrv(priv, uio, startsector, nsectors, true);
+}
+
 /****************************************************************************
  * Name: virtio_blk_geometry
  *
@@ -406,47 +630,13 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
+  struct virtqueue_buf vb[2];
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
-
-  /* Build the block request */
-
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
-
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  ret = virtio_blk_submit(priv, VIRTIO_BLK_T_FLUSH, 0, vb, 0);
   if (ret < 0)
-    {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
-    }
-
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
-
-  /* Wait for the request completion */
-
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
     {
       vrterr("Flush Error\n");
-      ret = -EIO;
     }
 
   return ret;
@@ -485,18 +675,45 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
+  FAR struct virtio_blk_queue_s *q = NULL;
+  FAR struct virtio_blk_cmd_s *cmd;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      if (priv->queues[i].vq == vq)
+        {
+          q = &priv->queues[i];
+          break;
+        }
+    }
+
+  DEBUGASSERT(q != NULL);
+
+  /* Wake every completed request, not only the oldest one */
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
+      cmd = virtqueue_get_buffer_lock(vq, NULL, NULL, &q->lock);
+      if (cmd == NULL)
         {
           break;
         }
 
-      nxsem_post(respsem);
+      nxsem_post(&cmd->done);
     }
+
+  /* The freed descriptors may let the waiting submitters in */
+
+  flags = spin_lock_irqsave(&q->lock);
+  while (q->nwait > 0)
+    {
+      q->nwait--;
+      nxsem_post(&q->space);
+    }
+
+  spin_unlock_irqrestore(&q->lock, flags);
 }
 
 /****************************************************************************
@@ -506,33 +723,75 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_NQUEUES];
+  vq_callback callback[VIRTIO_BLK_NQUEUES];
+  uint16_t num_queues;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SEG_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+                                  VIRTIO_PACKED_FEATURES, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  /* Without SEG_MAX the device accepts any number of segments that fit
+   * in the ring.
+   */
+
+  priv->seg_max = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s, seg_max,
+                                &priv->seg_max);
+      priv->seg_max = MAX(priv->seg_max, 1);
+    }
+
+  priv->nqueues = 1;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &num_queues);
+      priv->nqueues = MAX(MIN(num_queues, VIRTIO_BLK_NQUEUES), 1);
+    }
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+      spin_lock_init(&priv->queues[i].lock);
+      nxsem_init(&priv->queues[i].space, 0, 0);
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nqueues, vqname, callback,
+                                 NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
       return ret;
     }
 
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      priv->queues[i].vq = vdev->vrings_info[i].vq;
+    }
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb(priv->queues[i].vq);
+    }
+
+  vrtinfo("Virtio blk queues=%d seg_max=%" PRIu32 "\n",
+          priv->nqueues, priv->seg_max);
   return ret;
 }
 
@@ -418,6 +418,13 @@ virtio_mmio_create_virtqueue(FAR struct virtio_mmio_device_s *vmdev,
 
   virtqueue_set_shmem_io(vq, &vmdev->shm_io);
 
+#ifdef CONFIG_DRIVERS_VIRTIO_RING_PACKED
+  if (virtio_has_feature(vdev, VIRTIO_F_RING_PACKED))
+    {
+      virtio_packed_init(vq);
+    }
+#endif
+
   /* Set the mmio virtqueue register */
 
   ret = virtio_mmio_config_virtqueue(&vmdev->cfg_io, vq);
@@ -708,6 +715,14 @@ static uint64_t virtio_mmio_negotiate_features(struct virtio_device *vdev,
                                                uint64_t features)
 {
   features = features & virtio_mmio_get_features(vdev);
+
+  /* The legacy interface only has the page of a split ring */
+
+  if (vdev->id.version == VIRTIO_MMIO_VERSION_1)
+    {
+      features &= ~(1ULL << VIRTIO_F_RING_PACKED);
+    }
+
   virtio_mmio_set_features(vdev, features);
   return features;
 }
@@ -29,10 +29,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -44,31 +46,89 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM  1
+#define VIRTIO_NET_HDR_F_DATA_VALID  2
+#define VIRTIO_NET_HDR_GSO_TCPV4     1
+#define VIRTIO_NET_HDR_GSO_TCPV6     4
+
+/* Virtio net control commands and their result */
+
+#define VIRTIO_NET_OK                    0
+#define VIRTIO_NET_CTRL_MQ               4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET  0
+
+/* Virtio net header size and packet buffer size, the num_buffers field of
+ * the header is only there with VIRTIO_NET_F_MRG_RXBUF.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
+#define VIRTIO_NET_HDRSIZE_NOMRG \
+    (offsetof(struct virtio_net_hdr_s, num_buffers))
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
+#define VIRTIO_NET_PKTPTRSIZE (offsetof(struct virtio_net_llhdr_s, vhdr))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* The RX buffers are one IOB each with VIRTIO_NET_F_MRG_RXBUF, the device
+ * spreads a larger frame over several of them.  It needs room for the
+ * bigger header in the guard of the IOBs.
+ */
+
+#define VIRTIO_NET_MRG_RXBUF \
+    (CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN)
+#define VIRTIO_NET_MRG_BUFSIZE \
+    MIN(VIRTIO_NET_BUFSIZE, \
+        CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN)
+
+/* Virtio net virtqueue index and number, the RX and TX virtqueues of the
+ * queue pair q are 2q and 2q + 1.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
-#define VIRTIO_NET_NUM        2
+#define VIRTIO_NET_RXQ(q)     (2 * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (2 * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_ISTX(id)   ((id) % 2 == VIRTIO_NET_TX)
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_NQUEUES
+#  define VIRTIO_NET_MAXPAIRS CONFIG_DRIVERS_VIRTIO_NET_NQUEUES
+#else
+#  define VIRTIO_NET_MAXPAIRS 1
+#endif
+
+#define VIRTIO_NET_NUM        (2 * VIRTIO_NET_MAXPAIRS)
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+#  define VIRTIO_NET_TSO_NIOB \
+    ((CONFIG_NET_LL_GUARDSIZE + CONFIG_DRIVERS_VIRTIO_NET_TSO_SIZE + \
+      CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#endif
+
+/* Wait for the answer to a control command, in units of 10us */
+
+#define VIRTIO_NET_CTRL_TIMEOUT 100000
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, only used for the checksum and segmentation offload
+ * and the merged RX buffers, zero for all other packets.
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -79,6 +139,7 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;                      /* VIRTIO_NET_F_MRG_RXBUF */
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -99,6 +160,16 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* A command of the control virtqueue, the device writes ack */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;                            /* VIRTIO_NET_CTRL_MQ */
+  uint8_t  ack;
+} end_packed_struct;
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -113,11 +184,23 @@ struct virtio_net_priv_s
 #endif
 
   spinlock_t                lock[VIRTIO_NET_NUM];
+  uint16_t                  rxnum[VIRTIO_NET_MAXPAIRS]; /* RX buffers */
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX buffer number of a queue */
+  int                       rxbufnum;  /* RX buffer number of a queue */
+  uint16_t                  rxbufsize; /* Length of an RX buffer */
+  uint8_t                   hdrsize;   /* Size of the virtio net header */
+  uint8_t                   nqueues;   /* Number of RX/TX queue pairs */
+
+  /* The buffers of a TX super-segment, too many for the stack */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+  struct virtqueue_buf      txvb[VIRTIO_NET_TSO_NIOB + 1];
+  struct iovec              txiov[VIRTIO_NET_TSO_NIOB];
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -129,7 +212,10 @@ struct virtio_net_priv_s
  * |               |<--------- datalen -------->|
  * ^base           ^data
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
+ * The virtio header ends where the ETH header starts, it is hdrsize bytes
+ * long, two more with VIRTIO_NET_F_MRG_RXBUF.
+ *
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_PKTPTRSIZE + hdrsize + ETH_HDR_SIZE
  *                          = sizeof(uintptr) + 10 + 14
  *                          = 32 (64-Bit)
  *                          = 28 (32-Bit)
@@ -141,7 +227,8 @@ begin_packed_struct struct virtio_net_llhdr_s
   struct virtio_net_hdr_s vhdr;        /* Virtio net header */
 } end_packed_struct;
 
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_PKTPTRSIZE +
+              VIRTIO_NET_HDRSIZE_NOMRG + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
               " + VIRTIO_NET_LLHDRSIZE");
 
@@ -154,6 +241,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                            FAR netpkt_t *pkt);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid);
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -194,7 +285,11 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_sendq,
+  virtio_net_recvq,
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -205,6 +300,198 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+
+/****************************************************************************
+ * Name: virtio_net_tsohdr
+ *
+ * Description:
+ *   Fill the virtio net header of a TCP super-segment.  The device cuts it
+ *   into segments of gso_size and completes the TCP checksum of each of
+ *   them, starting from the pseudo header checksum in the TCP header.
+ *
+ ****************************************************************************/
+
+static void virtio_net_tsohdr(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR uint8_t *l3 = netpkt_getdata(dev, pkt) + NET_LL_HDRLEN(&dev->netdev);
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t iphdrlen = 0;
+  uint16_t sum = 0;
+
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] >> 4) == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      iphdrlen       = IPv6_HDRLEN;
+      sum            = ((uint16_t)ipv6->len[0] << 8) + ipv6->len[1];
+      sum            = chksum(sum + IP_PROTO_TCP,
+                              (FAR uint8_t *)ipv6->srcipaddr,
+                              2 * sizeof(net_ipv6addr_t));
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] >> 4) == 4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      iphdrlen       = (ipv4->vhl & IPv4_HLMASK) << 2;
+      sum            = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+      sum            = chksum(sum - iphdrlen + IP_PROTO_TCP,
+                              (FAR uint8_t *)ipv4->srcipaddr,
+                              2 * sizeof(in_addr_t));
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+    }
+#endif
+
+  tcp            = (FAR struct tcp_hdr_s *)(l3 + iphdrlen);
+  tcp->tcpchksum = HTONS(sum);
+
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->gso_size    = netpkt_getgsosize(dev, pkt);
+  vhdr->csum_start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+  vhdr->hdr_len     = vhdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+}
+
+/****************************************************************************
+ * Name: virtio_net_tsoinit
+ *
+ * Description:
+ *   Announce the TCP segmentation offload of the device to the upper half.
+ *   A super-segment takes up to VIRTIO_NET_TSO_NIOB + 1 descriptors, the
+ *   TX quota shrinks to what the TX virtqueue holds of them.
+ *
+ ****************************************************************************/
+
+static void virtio_net_tsoinit(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct netdev_lowerhalf_s *netdev =
+                                  (FAR struct netdev_lowerhalf_s *)priv;
+  FAR struct virtio_device *vdev = priv->vdev;
+  int txnum = vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+              (VIRTIO_NET_TSO_NIOB + 1);
+
+  /* Keep at least two super-segments in flight */
+
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_CSUM) || txnum < 2)
+    {
+      return;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+    {
+      netdev->features |= NETDEV_F_TSO4;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+    {
+      netdev->features |= NETDEV_F_TSO6;
+    }
+
+  if ((netdev->features & (NETDEV_F_TSO4 | NETDEV_F_TSO6)) != 0)
+    {
+      netdev->gso_maxsize      = CONFIG_DRIVERS_VIRTIO_NET_TSO_SIZE;
+      netdev->quota[NETPKT_TX] = MIN(priv->bufnum, txnum) * priv->nqueues;
+    }
+}
+#endif /* CONFIG_DRIVERS_VIRTIO_NET_TSO */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+
+/****************************************************************************
+ * Name: virtio_net_csumhdr
+ *
+ * Description:
+ *   Fill the virtio net header of a packet whose TCP or UDP checksum only
+ *   holds the sum of the pseudo header, the device completes it.
+ *
+ ****************************************************************************/
+
+static void virtio_net_csumhdr(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt,
+                               FAR struct virtio_net_hdr_s *vhdr)
+{
+  uint16_t start;
+  uint16_t offset;
+
+  if (netpkt_getcsum(dev, pkt, &start, &offset))
+    {
+      vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+      vhdr->csum_start  = start;
+      vhdr->csum_offset = offset;
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_rxcsum
+ *
+ * Description:
+ *   Mark a received packet whose checksum the device verified.  A packet
+ *   from another guest of the host may come with the sum of the pseudo
+ *   header in the checksum field instead, it is completed here.
+ *
+ ****************************************************************************/
+
+static void virtio_net_rxcsum(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtio_net_hdr_s *vhdr)
+{
+  unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+  uint16_t sum;
+
+  if ((vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) != 0)
+    {
+      if (vhdr->csum_start < llhdrlen ||
+          vhdr->csum_start + vhdr->csum_offset + sizeof(sum) >
+          netpkt_getdatalen(dev, pkt))
+        {
+          return;
+        }
+
+      sum = chksum_iob(0, pkt, vhdr->csum_start - llhdrlen);
+      sum = ~HTONS(sum);
+      if (sum == 0)
+        {
+          sum = 0xffff;
+        }
+
+      if (netpkt_copyin(dev, pkt, (FAR const uint8_t *)&sum, sizeof(sum),
+                        vhdr->csum_start + vhdr->csum_offset) < 0)
+        {
+          return;
+        }
+    }
+  else if ((vhdr->flags & VIRTIO_NET_HDR_F_DATA_VALID) == 0)
+    {
+      return;
+    }
+
+  netpkt_setcsumvalid(dev, pkt);
+}
+#endif /* CONFIG_NETDEV_CSUM_OFFLOAD */
+
+/****************************************************************************
+ * Name: virtio_net_llhdr
+ *
+ * Description:
+ *   Get the link layer header in front of the data of a buffer, the
+ *   virtio net header ends right where the data starts.
+ *
+ ****************************************************************************/
+
+static inline FAR struct virtio_net_llhdr_s *
+virtio_net_llhdr(FAR struct virtio_net_priv_s *priv, FAR void *data)
+{
+  return (FAR struct virtio_net_llhdr_s *)
+         ((FAR uint8_t *)data - priv->hdrsize - VIRTIO_NET_PKTPTRSIZE);
+}
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -215,23 +502,50 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  struct virtqueue_buf rxvb[VIRTIO_NET_MAX_NIOB + 1];
+  struct iovec rxiov[VIRTIO_NET_MAX_NIOB];
+  FAR struct virtqueue_buf *vb = rxvb;
+  FAR struct iovec *iov = rxiov;
+  int niov = VIRTIO_NET_MAX_NIOB;
   int iov_cnt;
   int i;
 
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+  /* The TX packets are sent one at a time, under the lock of the device */
+
+  if (VIRTIO_NET_ISTX(vq_id))
+    {
+      vb   = priv->txvb;
+      iov  = priv->txiov;
+      niov = VIRTIO_NET_TSO_NIOB;
+    }
+#endif
+
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, niov);
 
   /* Alloc cookie and net header from transport layer */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+  hdr = virtio_net_llhdr(priv, iov[0].iov_base);
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  memset(&hdr->vhdr, 0, priv->hdrsize);
   hdr->pkt = pkt;
 
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+  if (VIRTIO_NET_ISTX(vq_id) && netpkt_getgsosize(dev, pkt) > 0)
+    {
+      virtio_net_tsohdr(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (VIRTIO_NET_ISTX(vq_id) && hdr->vhdr.flags == 0)
+    {
+      virtio_net_csumhdr(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -239,9 +553,9 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Append the virtio net header to the first buffer */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_MAX_NIOB > 1 || defined(CONFIG_DRIVERS_VIRTIO_NET_TSO)
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -254,7 +568,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Buffer 0 is only for virtio net header */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -266,7 +580,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (!VIRTIO_NET_ISTX(vq_id))
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,16 +594,21 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 
 /****************************************************************************
  * Name: virtio_net_rxfill
+ *
+ * Description:
+ *   Top up the RX virtqueue of queue pair qid to rxbufnum buffers.
+ *
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int vq_id = VIRTIO_NET_RXQ(qid);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxnum[qid] < priv->rxbufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -300,10 +619,9 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
           break;
         }
 
-      /* Preserve data length */
+      /* Preserve data length, it drops the IOBs beyond an RX buffer */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, priv->rxbufsize) < priv->rxbufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
@@ -312,31 +630,86 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, vq_id) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxnum[qid]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_rxmerge
+ *
+ * Description:
+ *   Append the following RX buffers of a frame that the device spread over
+ *   nbufs more buffers (VIRTIO_NET_F_MRG_RXBUF).  Only the first buffer
+ *   has the virtio net header, the data of the others starts where their
+ *   header would be.
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value if the device did not return all
+ *   the buffers of the frame.
+ *
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_rxmerge(FAR struct netdev_lowerhalf_s *dev, int qid,
+                              FAR netpkt_t *pkt, uint16_t nbufs)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int vq_id = VIRTIO_NET_RXQ(qid);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  unsigned int offset = NET_LL_HDRLEN(&dev->netdev) + priv->hdrsize;
+  FAR struct virtio_net_llhdr_s *hdr;
+  FAR netpkt_t *next;
+  uint32_t len;
+
+  while (nbufs-- > 0)
+    {
+      hdr = virtqueue_get_buffer_lock(vq, &len, NULL, &priv->lock[vq_id]);
+      if (hdr == NULL)
+        {
+          vrterr("Missing RX buffers of a merged frame: %u\n", nbufs + 1);
+          return -EIO;
+        }
+
+      priv->rxnum[qid]--;
+      next = hdr->pkt;
+      next->io_offset -= offset;
+      iob_update_pktlen(next, len, false);
+      iob_concat(pkt, next);
+
+      /* The frame counts as one RX buffer in the quota from now on */
+
+      atomic_fetch_add(&dev->quota[NETPKT_RX], 1);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_net_txfreeq
+ ****************************************************************************/
+
+static void virtio_net_txfreeq(FAR struct netdev_lowerhalf_s *dev, int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_TXQ(qid);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[vq_id]);
       if (hdr == NULL)
         {
           break;
@@ -347,6 +720,21 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int qid;
+
+  for (qid = 0; qid < priv->nqueues; qid++)
+    {
+      virtio_net_txfreeq(dev, qid);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -354,6 +742,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int qid;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -370,9 +759,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (qid = 0; qid < priv->nqueues; qid++)
+    {
+      virtqueue_enable_cb_lock(
+        priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq,
+        &priv->lock[VIRTIO_NET_RXQ(qid)]);
+      virtio_net_rxfill(dev, qid);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -395,7 +788,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < 2 * priv->nqueues; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -415,18 +808,27 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_sendq
+ *
+ * Description:
+ *   Send a packet on the TX virtqueue of queue pair qid.  The device is
+ *   only notified when it asked for it with VIRTIO_F_EVENT_IDX, while it
+ *   still works on the queue the kicks are skipped.
+ *
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int qid,
+                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_TXQ(qid);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  int ret;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE &&
+      netpkt_getgsosize(dev, pkt) == 0)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -434,65 +836,117 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  ret = virtio_net_addbuffer(dev, vq, pkt, vq_id);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick_lock(vq, &priv->lock[vq_id]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfreeq(dev, qid);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_sendq(dev, 0, pkt);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ *
+ * Description:
+ *   Take a received frame from the RX virtqueue of queue pair qid.
+ *
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int vq_id = VIRTIO_NET_RXQ(qid);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, qid);
 
-  /* Get received buffer form RX virtqueue */
-
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  while (1)
     {
-      /* If we have no buffer left, enable RX callback. */
+      /* Get received buffer form RX virtqueue */
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      flags = spin_lock_irqsave(&priv->lock[vq_id]);
+      hdr = virtqueue_get_buffer(vq, &len, NULL);
+      if (hdr == NULL)
+        {
+          /* If we have no buffer left, enable RX callback. */
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
-    }
-  else
-    {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
-    }
+          virtqueue_enable_cb(vq);
+          spin_unlock_irqrestore(&priv->lock[vq_id], flags);
+
+          vrtinfo("get NULL buffer\n");
+          return NULL;
+        }
+      else
+        {
+          spin_unlock_irqrestore(&priv->lock[vq_id], flags);
+        }
+
+      priv->rxnum[qid]--;
+
+      /* Set the received pkt length */
+
+      netpkt_setdatalen(dev, hdr->pkt, len - priv->hdrsize);
 
-  /* Set the received pkt length */
+      /* Gather the rest of a frame larger than an RX buffer */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+      if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_MRG_RXBUF) &&
+          hdr->vhdr.num_buffers > 1 &&
+          virtio_net_rxmerge(dev, qid, hdr->pkt,
+                             hdr->vhdr.num_buffers - 1) < 0)
+        {
+          netpkt_free(dev, hdr->pkt, NETPKT_RX);
+          continue;
+        }
+
+      break;
+    }
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  virtio_net_rxcsum(dev, hdr->pkt, &hdr->vhdr);
+#endif
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recvq(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -535,7 +989,19 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The work of the RX queue drains it on the CPU of the queue */
+
+  if (priv->nqueues > 1)
+    {
+      netdev_lower_queue_rxready((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / 2);
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -547,10 +1013,74 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_setpairs
+ *
+ * Description:
+ *   Tell the device through the control virtqueue how many queue pairs are
+ *   used, it only uses the first one until then.  Called once from the
+ *   initialization, the answer is polled.
+ *
+ ****************************************************************************/
+
+#if VIRTIO_NET_MAXPAIRS > 1
+static int virtio_net_setpairs(FAR struct virtio_net_priv_s *priv,
+                               FAR struct virtqueue *vq)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  FAR struct virtio_net_ctrl_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int timeout = VIRTIO_NET_CTRL_TIMEOUT;
+  int ret;
+
+  ctrl = virtio_zalloc_buf(vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->nqueues;
+  ctrl->ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = sizeof(ctrl->class) + sizeof(ctrl->cmd);
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      virtio_free_buf(vdev, ctrl);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  while (virtqueue_get_buffer(vq, NULL, NULL) == NULL)
+    {
+      /* The device may still write the command later, keep it */
+
+      if (--timeout <= 0)
+        {
+          return -ETIMEDOUT;
+        }
+
+      up_udelay(10);
+    }
+
+  ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+  virtio_free_buf(vdev, ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,12 +1088,18 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  int nvqs = VIRTIO_NET_NUM;
+  uint16_t maxpairs = 1;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_NUM; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
@@ -571,15 +1107,89 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#if defined(CONFIG_DRIVERS_VIRTIO_NET_TSO) || \
+    defined(CONFIG_NETDEV_CSUM_OFFLOAD)
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#endif
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+                                  (1UL << VIRTIO_NET_F_HOST_TSO4) |
+                                  (1UL << VIRTIO_NET_F_HOST_TSO6) |
+#endif
+#if VIRTIO_NET_MAXPAIRS > 1
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
+                                  (VIRTIO_NET_MRG_RXBUF ?
+                                   (1UL << VIRTIO_NET_F_MRG_RXBUF) |
+                                   VIRTIO_PACKED_FEATURES : 0) |
+                                  (1UL << VIRTIO_F_EVENT_IDX) |
                                   (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  /* The header has num_buffers with VIRTIO_F_VERSION_1 too, which the
+   * packed virtqueues need and are only asked for with room for it.
+   */
+
+  priv->hdrsize = virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF) ||
+                  virtio_has_feature(vdev, VIRTIO_F_VERSION_1) ?
+                  VIRTIO_NET_HDRSIZE : VIRTIO_NET_HDRSIZE_NOMRG;
+
+  /* The control virtqueue follows the queue pairs of the device, all of
+   * them are created but only the first nqueues are used.
+   */
+
+#if VIRTIO_NET_MAXPAIRS > 1
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs     = 2 * maxpairs + 1;
+    }
+#endif
+
+  priv->nqueues = MIN(maxpairs, VIRTIO_NET_MAXPAIRS);
+#if VIRTIO_NET_MAXPAIRS > 1
+  priv->nqueues = MIN(priv->nqueues, CONFIG_SMP_NCPUS);
+#endif
+
+  vqnames = kmm_zalloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)(vqnames + nvqs);
+  for (i = 0; i < nvqs; i++)
+    {
+      if (i == 2 * maxpairs)
+        {
+          vqnames[i] = "virtio_net_ctrl";
+        }
+      else if (VIRTIO_NET_ISTX(i))
+        {
+          vqnames[i] = "virtio_net_tx";
+          if (i < 2 * priv->nqueues)
+            {
+              callbacks[i] = virtio_net_txdone;
+            }
+        }
+      else
+        {
+          vqnames[i] = "virtio_net_rx";
+          if (i < 2 * priv->nqueues)
+            {
+              callbacks[i] = virtio_net_rxready;
+            }
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -588,19 +1198,50 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#if VIRTIO_NET_MAXPAIRS > 1
+  if (priv->nqueues > 1)
+    {
+      ret = virtio_net_setpairs(priv, vdev->vrings_info[2 * maxpairs].vq);
+      if (ret < 0)
+        {
+          vrtwarn("Failed to use %u queue pairs, ret=%d\n",
+                  priv->nqueues, ret);
+          priv->nqueues = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the queues.
    */
 
   priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = MAX(priv->bufnum / priv->nqueues, 1);
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* The merged RX buffers are one IOB each, as many as the IOBs of the
+   * full sized ones, up to two descriptors each.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->rxbufsize = VIRTIO_NET_MRG_BUFSIZE;
+      priv->rxbufnum  = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs
+                            / 2, priv->bufnum * VIRTIO_NET_MAX_NIOB);
+    }
+  else
+    {
+      priv->rxbufsize = VIRTIO_NET_BUFSIZE;
+      priv->rxbufnum  = priv->bufnum;
+    }
+
   return OK;
 }
 
@@ -668,9 +1309,28 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxbufnum * priv->nqueues;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->nqueues;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = priv->nqueues;
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->features |= NETDEV_F_TXCSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->features |= NETDEV_F_RXCSUM;
+    }
+#endif
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_TSO
+  virtio_net_tsoinit(priv);
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -0,0 +1,470 @@
+/****************************************************************************
+ * drivers/virtio/virtio-packed.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <metal/atomic.h>
+#include <nuttx/virtio/virtio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Descriptor flags, the driver flips AVAIL and USED of a descriptor to
+ * make it available, the device sets them equal once it is used.  Both
+ * mean the opposite after each wrap of the ring.
+ */
+
+#define VIRTQ_DESC_F_NEXT       (1 << 0)
+#define VIRTQ_DESC_F_WRITE      (1 << 1)
+#define VIRTQ_DESC_F_AVAIL      (1 << 7)
+#define VIRTQ_DESC_F_USED       (1 << 15)
+
+/* Event suppression flags */
+
+#define VIRTQ_EVENT_F_ENABLE    0
+#define VIRTQ_EVENT_F_DISABLE   1
+#define VIRTQ_EVENT_F_DESC      2
+
+/* The position in the ring and the wrap counter in one index, the queue
+ * size is at most 32768.
+ */
+
+#define VIRTQ_WRAP              0x8000
+#define VIRTQ_POS(idx)          ((idx) & (VIRTQ_WRAP - 1))
+
+/* The end of the list of the free buffer ids */
+
+#define VIRTQ_ID_END            0xffff
+
+/* The driver event area is vq_ring.avail, the device one vq_ring.used */
+
+#define virtq_desc(vq)          ((FAR struct virtq_packed_desc_s *) \
+                                 (vq)->vq_ring.desc)
+#define virtq_driver_event(vq)  ((FAR struct virtq_event_s *) \
+                                 (vq)->vq_ring.avail)
+#define virtq_device_event(vq)  ((FAR struct virtq_event_s *) \
+                                 (vq)->vq_ring.used)
+
+#define virtq_mb()              atomic_thread_fence(memory_order_seq_cst)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A packed descriptor, the same size as a split one */
+
+begin_packed_struct struct virtq_packed_desc_s
+{
+  uint64_t addr;
+  uint32_t len;
+  uint16_t id;
+  uint16_t flags;
+} end_packed_struct;
+
+/* The driver and the device event suppression areas */
+
+begin_packed_struct struct virtq_event_s
+{
+  uint16_t off_wrap;                  /* Position and wrap counter */
+  uint16_t flags;                     /* VIRTQ_EVENT_F_* */
+} end_packed_struct;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: virtq_packed_advance
+ *
+ * Description:
+ *   Move an index with its wrap counter n descriptors ahead.
+ *
+ ****************************************************************************/
+
+static inline uint16_t virtq_packed_advance(FAR struct virtqueue *vq,
+                                            uint16_t idx, uint16_t n)
+{
+  uint16_t pos = VIRTQ_POS(idx) + n;
+
+  if (pos >= vq->vq_nentries)
+    {
+      pos -= vq->vq_nentries;
+      idx ^= VIRTQ_WRAP;
+    }
+
+  return (idx & VIRTQ_WRAP) | pos;
+}
+
+/****************************************************************************
+ * Name: virtq_packed_avail
+ *
+ * Description:
+ *   The AVAIL and USED flags of a descriptor made available at idx.
+ *
+ ****************************************************************************/
+
+static inline uint16_t virtq_packed_avail(uint16_t idx)
+{
+  return (idx & VIRTQ_WRAP) != 0 ? VIRTQ_DESC_F_AVAIL : VIRTQ_DESC_F_USED;
+}
+
+/****************************************************************************
+ * Name: virtq_packed_more_used
+ *
+ * Description:
+ *   Check if the device returned the buffer at the used index.
+ *
+ ****************************************************************************/
+
+static bool virtq_packed_more_used(FAR struct virtqueue *vq)
+{
+  uint16_t idx = vq->vq_used_cons_idx;
+  uint16_t flags = virtq_desc(vq)[VIRTQ_POS(idx)].flags;
+  bool avail = (flags & VIRTQ_DESC_F_AVAIL) != 0;
+  bool used = (flags & VIRTQ_DESC_F_USED) != 0;
+
+  return avail == used && used == ((idx & VIRTQ_WRAP) != 0);
+}
+
+/****************************************************************************
+ * Name: virtq_packed_add_buffer
+ ****************************************************************************/
+
+static int virtq_packed_add_buffer(FAR struct virtqueue *vq,
+                                   FAR struct virtqueue_buf *buf_list,
+                                   int readable, int writable,
+                                   FAR void *cookie)
+{
+  FAR struct virtq_packed_desc_s *desc = virtq_desc(vq);
+  uint16_t idx = vq->vq_available_idx;
+  uint16_t nbufs = readable + writable;
+  uint16_t head = VIRTQ_POS(idx);
+  uint16_t headflags = 0;
+  uint16_t flags;
+  uint16_t id;
+  int i;
+
+  if (nbufs == 0 || cookie == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (vq->vq_free_cnt < nbufs || vq->vq_desc_head_idx == VIRTQ_ID_END)
+    {
+      return -ENOSPC;
+    }
+
+  /* The buffer id, the free ids are chained through ndescs */
+
+  id = vq->vq_desc_head_idx;
+  vq->vq_desc_head_idx = vq->vq_descx[id].ndescs;
+  vq->vq_descx[id].cookie = cookie;
+  vq->vq_descx[id].ndescs = nbufs;
+
+  /* Fill the descriptors, the flags of the first one are written last so
+   * that the device sees the whole chain at once.
+   */
+
+  for (i = 0; i < nbufs; i++)
+    {
+      FAR struct virtq_packed_desc_s *d = &desc[VIRTQ_POS(idx)];
+
+      flags = virtq_packed_avail(idx);
+      if (i < nbufs - 1)
+        {
+          flags |= VIRTQ_DESC_F_NEXT;
+        }
+
+      if (i >= readable)
+        {
+          flags |= VIRTQ_DESC_F_WRITE;
+        }
+
+      d->addr = metal_io_virt_to_phys(vq->shm_io, buf_list[i].buf);
+      d->len  = buf_list[i].len;
+      d->id   = id;
+
+      if (i == 0)
+        {
+          headflags = flags;
+        }
+      else
+        {
+          d->flags = flags;
+        }
+
+      idx = virtq_packed_advance(vq, idx, 1);
+    }
+
+  virtq_mb();
+  desc[head].flags = headflags;
+
+  vq->vq_available_idx = idx;
+  vq->vq_free_cnt     -= nbufs;
+  vq->vq_queued_cnt   += nbufs;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtq_packed_get_buffer
+ ****************************************************************************/
+
+static FAR void *virtq_packed_get_buffer(FAR struct virtqueue *vq,
+                                         FAR uint32_t *len,
+                                         FAR uint16_t *idx)
+{
+  FAR struct virtq_packed_desc_s *d;
+  FAR void *cookie;
+  uint16_t ndescs;
+  uint16_t id;
+
+  if (!virtq_packed_more_used(vq))
+    {
+      return NULL;
+    }
+
+  /* Read the id and the length after the flags */
+
+  virtq_mb();
+  d  = &virtq_desc(vq)[VIRTQ_POS(vq->vq_used_cons_idx)];
+  id = d->id;
+  if (id >= vq->vq_nentries || vq->vq_descx[id].cookie == NULL)
+    {
+      vrterr("Bad used id %u of vq %u\n", id, vq->vq_queue_index);
+      return NULL;
+    }
+
+  if (len != NULL)
+    {
+      *len = d->len;
+    }
+
+  if (idx != NULL)
+    {
+      *idx = id;
+    }
+
+  /* The device skips the rest of the chain of the buffer */
+
+  cookie = vq->vq_descx[id].cookie;
+  ndescs = vq->vq_descx[id].ndescs;
+  vq->vq_descx[id].cookie = NULL;
+  vq->vq_descx[id].ndescs = vq->vq_desc_head_idx;
+  vq->vq_desc_head_idx    = id;
+
+  vq->vq_used_cons_idx = virtq_packed_advance(vq, vq->vq_used_cons_idx,
+                                              ndescs);
+  vq->vq_free_cnt     += ndescs;
+  return cookie;
+}
+
+/****************************************************************************
+ * Name: virtq_packed_enable_cb
+ ****************************************************************************/
+
+static int virtq_packed_enable_cb(FAR struct virtqueue *vq)
+{
+  FAR struct virtq_event_s *event = virtq_driver_event(vq);
+
+  /* With VIRTIO_F_EVENT_IDX only the next used buffer interrupts */
+
+  if (virtio_has_feature(vq->vq_dev, VIRTIO_F_EVENT_IDX))
+    {
+      event->off_wrap = vq->vq_used_cons_idx;
+      virtq_mb();
+      event->flags    = VIRTQ_EVENT_F_DESC;
+    }
+  else
+    {
+      event->flags    = VIRTQ_EVENT_F_ENABLE;
+    }
+
+  /* Tell the caller about the buffers returned meanwhile */
+
+  virtq_mb();
+  return virtq_packed_more_used(vq);
+}
+
+/****************************************************************************
+ * Name: virtq_packed_need_kick
+ ****************************************************************************/
+
+static bool virtq_packed_need_kick(FAR struct virtqueue *vq)
+{
+  FAR struct virtq_event_s *event = virtq_device_event(vq);
+  uint16_t new = VIRTQ_POS(vq->vq_available_idx);
+  uint16_t old = new - vq->vq_queued_cnt;
+  uint16_t off_wrap;
+  uint16_t event_idx;
+
+  virtq_mb();
+  switch (event->flags)
+    {
+      case VIRTQ_EVENT_F_DISABLE:
+        return false;
+
+      case VIRTQ_EVENT_F_DESC:
+        off_wrap  = event->off_wrap;
+        event_idx = VIRTQ_POS(off_wrap);
+        if ((off_wrap & VIRTQ_WRAP) != (vq->vq_available_idx & VIRTQ_WRAP))
+          {
+            event_idx -= vq->vq_nentries;
+          }
+
+        return (uint16_t)(new - event_idx - 1) < (uint16_t)(new - old);
+
+      default:
+        return true;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: virtio_packed_init
+ *
+ * Description:
+ *   Lay out a packed ring in the memory of the split ring the transport
+ *   allocated for the virtqueue, vring_size() is larger.  The descriptors
+ *   are followed by the driver and the device event suppression areas,
+ *   which take the place of the available and the used rings.
+ *
+ ****************************************************************************/
+
+void virtio_packed_init(FAR struct virtqueue *vq)
+{
+  uint16_t num = vq->vq_nentries;
+  FAR uint8_t *ring = (FAR uint8_t *)vq->vq_ring.desc;
+  uint16_t i;
+
+  DEBUGASSERT(num > 0 && num <= VIRTQ_WRAP);
+
+  memset(ring, 0, num * sizeof(struct virtq_packed_desc_s) +
+                  2 * sizeof(struct virtq_event_s));
+
+  ring += num * sizeof(struct virtq_packed_desc_s);
+  vq->vq_ring.avail = (FAR struct vring_avail *)ring;
+  ring += sizeof(struct virtq_event_s);
+  vq->vq_ring.used  = (FAR struct vring_used *)ring;
+
+  for (i = 0; i < num; i++)
+    {
+      vq->vq_descx[i].cookie = NULL;
+      vq->vq_descx[i].ndescs = i + 1 < num ? i + 1 : VIRTQ_ID_END;
+    }
+
+  vq->vq_desc_head_idx = 0;
+  vq->vq_free_cnt      = num;
+  vq->vq_queued_cnt    = 0;
+  vq->vq_available_idx = VIRTQ_WRAP;
+  vq->vq_used_cons_idx = VIRTQ_WRAP;
+}
+
+/****************************************************************************
+ * Name: virtio_vq_add_buffer
+ ****************************************************************************/
+
+int virtio_vq_add_buffer(FAR struct virtqueue *vq,
+                         FAR struct virtqueue_buf *buf_list,
+                         int readable, int writable, FAR void *cookie)
+{
+  if (virtqueue_is_packed(vq))
+    {
+      return virtq_packed_add_buffer(vq, buf_list, readable, writable,
+                                     cookie);
+    }
+
+  return (virtqueue_add_buffer)(vq, buf_list, readable, writable, cookie);
+}
+
+/****************************************************************************
+ * Name: virtio_vq_get_buffer
+ ****************************************************************************/
+
+FAR void *virtio_vq_get_buffer(FAR struct virtqueue *vq, FAR uint32_t *len,
+                               FAR uint16_t *idx)
+{
+  if (virtqueue_is_packed(vq))
+    {
+      return virtq_packed_get_buffer(vq, len, idx);
+    }
+
+  return (virtqueue_get_buffer)(vq, len, idx);
+}
+
+/****************************************************************************
+ * Name: virtio_vq_disable_cb
+ ****************************************************************************/
+
+void virtio_vq_disable_cb(FAR struct virtqueue *vq)
+{
+  if (virtqueue_is_packed(vq))
+    {
+      virtq_driver_event(vq)->flags = VIRTQ_EVENT_F_DISABLE;
+      return;
+    }
+
+  (virtqueue_disable_cb)(vq);
+}
+
+/****************************************************************************
+ * Name: virtio_vq_enable_cb
+ ****************************************************************************/
+
+int virtio_vq_enable_cb(FAR struct virtqueue *vq)
+{
+  if (virtqueue_is_packed(vq))
+    {
+      return virtq_packed_enable_cb(vq);
+    }
+
+  return (virtqueue_enable_cb)(vq);
+}
+
+/****************************************************************************
+ * Name: virtio_vq_kick
+ ****************************************************************************/
+
+void virtio_vq_kick(FAR struct virtqueue *vq)
+{
+  if (virtqueue_is_packed(vq))
+    {
+      if (virtq_packed_need_kick(vq) && vq->notify != NULL)
+        {
+          vq->notify(vq);
+        }
+
+      vq->vq_queued_cnt = 0;
+      return;
+    }
+
+  (virtqueue_kick)(vq);
+}
@@ -353,6 +353,13 @@ virtio_pci_create_virtqueue(FAR struct virtio_pci_device_s *vpdev,
 
   virtqueue_set_shmem_io(vq, &vpdev->shm_io);
 
+#ifdef CONFIG_DRIVERS_VIRTIO_RING_PACKED
+  if (virtio_has_feature(vdev, VIRTIO_F_RING_PACKED))
+    {
+      virtio_packed_init(vq);
+    }
+#endif
+
   /* Set the pci virtqueue register, active vq, enable vq */
 
   ret = vpdev->ops->create_virtqueue(vpdev, vq);
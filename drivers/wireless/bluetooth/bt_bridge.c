@@ -668,6 +668,7 @@ int bt_bridge_register(FAR struct bt_driver_s *hcidrv,
   bridge->driver = hcidrv;
 
   hcidrv->receive = bt_bridge_receive;
+  hcidrv->receive_iob = NULL;
   hcidrv->priv = bridge;
 
   bt_device_init(bridge, btdrv, BT_FILTER_TYPE_BT);
@@ -526,8 +526,9 @@ int rpmshci_server_init(FAR const char *name, FAR struct bt_driver_s *btdev)
 
   /* Connect BT receive callback and RPMSG as priv */
 
-  btdev->receive = rpmsghci_bt_receive;
-  btdev->priv    = priv;
+  btdev->receive     = rpmsghci_bt_receive;
+  btdev->receive_iob = NULL;
+  btdev->priv        = priv;
 
   /* Initialize RPMSG-HCI server data */
 
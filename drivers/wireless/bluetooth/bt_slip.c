@@ -1037,6 +1037,7 @@ FAR struct bt_driver_s *bt_slip_register(FAR struct bt_driver_s *drv)
   priv->drv = drv;
   drv->priv = priv;
   drv->receive = bt_slip_receive;
+  drv->receive_iob = NULL;
 
   nxmutex_init(&priv->sliplock);
   nxmutex_init(&priv->unacklock);
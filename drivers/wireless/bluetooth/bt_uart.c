@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/bluetooth.h>
 
 #include <nuttx/wireless/bluetooth/bt_core.h>
@@ -99,6 +100,59 @@ static ssize_t btuart_read(FAR struct btuart_upperhalf_s *upper,
   return ntotal;
 }
 
+/* Read the payload of a packet straight into an IOB and hand that to the
+ * stack, if it takes IOBs and one is free.  Returns one if the packet was
+ * read, zero if it must go the copying way or a negated errno.
+ */
+
+static int btuart_rxiob(FAR struct btuart_upperhalf_s *upper,
+                            enum bt_buf_type_e type,
+                            FAR const uint8_t *hdr, unsigned int hdrlen,
+                            unsigned int pktlen)
+{
+  FAR struct iob_s *iob;
+  ssize_t nread;
+  int ret;
+
+  if (upper->dev.receive_iob == NULL ||
+      BLUETOOTH_H4_HDRLEN + hdrlen + pktlen > CONFIG_IOB_BUFSIZE)
+    {
+      return 0;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return 0;
+    }
+
+  /* The stack's headroom first, as in bt_receive() */
+
+  iob->io_offset = BLUETOOTH_H4_HDRLEN;
+  memcpy(&iob->io_data[iob->io_offset], hdr, hdrlen);
+
+  nread = btuart_read(upper, &iob->io_data[iob->io_offset + hdrlen],
+                      pktlen, pktlen);
+  if (nread != pktlen)
+    {
+      iob_free(iob);
+      return nread < 0 ? (int)nread : -EIO;
+    }
+
+  iob->io_len    = iob->io_offset + hdrlen + pktlen;
+  iob->io_pktlen = iob->io_len;
+
+  BT_DUMP("Received", &iob->io_data[iob->io_offset], hdrlen + pktlen);
+  ret = upper->dev.receive_iob(&upper->dev, type, iob);
+  if (ret < 0)
+    {
+      wlwarn("WARNING: Packet dropped: %d\n", ret);
+      iob_free(iob);
+    }
+
+  return 1;
+}
+
 static void btuart_rxwork(FAR void *arg)
 {
   FAR struct btuart_upperhalf_s *upper;
@@ -107,6 +161,7 @@ static void btuart_rxwork(FAR void *arg)
   unsigned int hdrlen;
   unsigned int pktlen;
   ssize_t nread;
+  int ret;
   union
     {
       struct bt_hci_evt_hdr_s evt;
@@ -178,6 +233,18 @@ static void btuart_rxwork(FAR void *arg)
           break;
         }
 
+      ret = btuart_rxiob(upper, type, data + H4_HEADER_SIZE, hdrlen,
+                         pktlen);
+      if (ret < 0)
+        {
+          wlwarn("WARNING: Unable to read H4 packet: %d\n", ret);
+          break;
+        }
+      else if (ret > 0)
+        {
+          continue;
+        }
+
       nread = btuart_read(upper, data + H4_HEADER_SIZE + hdrlen,
                           pktlen, pktlen);
       if (nread != pktlen)
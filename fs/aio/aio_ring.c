@@ -0,0 +1,832 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/aioring.h>
+#include <sys/socket.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct aioring_ctx_s;
+
+/* One in-flight operation.  Operations on files that can report readiness
+ * through poll() wait on the driver without holding a worker thread, the
+ * worker only runs the operation once the driver reports the event.
+ */
+
+struct aioring_op_s
+{
+  sq_entry_t                 link;     /* Link in the free or done list */
+  struct aioring_sqe_s       sqe;      /* Copy of the submission entry */
+  struct work_s              work;     /* Runs the operation on the pool */
+  struct pollfd              pfd;      /* Readiness notification */
+  FAR struct aioring_ctx_s  *ctx;
+  FAR struct file           *filep;
+#ifdef CONFIG_NET
+  FAR struct socket         *newsock;  /* Accepted socket to install */
+#endif
+  bool                       armed;    /* The poll callback may queue work */
+  bool                       polled;   /* pfd is setup in the driver */
+};
+
+struct aioring_ctx_s
+{
+  FAR struct aioring_s      *ring;     /* The ring in application memory */
+  uint32_t                   sqmask;
+  uint32_t                   cqmask;
+  int                        crefs;
+  bool                       closing;
+  mutex_t                    lock;     /* Serialize the submitters */
+  mutex_t                    cqlock;   /* Protect the CQ and the lists */
+  spinlock_t                 slock;    /* Protect armed of the ops */
+  sem_t                      cqsem;    /* Wake up the completion waiters */
+  sq_queue_t                 freelist; /* Free operations */
+  sq_queue_t                 donelist; /* Accepts waiting for a fd */
+  FAR struct aioring_op_s   *ops;      /* cq_entries operations */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void aioring_worker(FAR void *arg);
+static int aioring_open(FAR struct file *filep);
+static int aioring_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_aioring_ops =
+{
+  aioring_open,     /* open */
+  aioring_close,    /* close */
+};
+
+static struct inode g_aioring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_aioring_ops        /* u */
+  }
+};
+
+/* The worker pool shared by all the rings, created on first use */
+
+static mutex_t g_aioring_lock = NXMUTEX_INITIALIZER;
+static FAR struct kwork_wqueue_s *g_aioring_wq;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioring_post
+ *
+ * Description:
+ *   Post the completion entry of the operation and release the operation.
+ *   There is always room in the CQ because the number of in-flight
+ *   operations is limited to the CQ size.
+ *
+ ****************************************************************************/
+
+static void aioring_post(FAR struct aioring_ctx_s *ctx,
+                         FAR struct aioring_op_s *op, ssize_t res)
+{
+  FAR struct aioring_s *ring = ctx->ring;
+  FAR struct aioring_cqe_s *cqe;
+  int semcount = 0;
+
+  if (op->filep != NULL)
+    {
+      fs_putfilep(op->filep);
+      op->filep = NULL;
+    }
+
+  nxmutex_lock(&ctx->cqlock);
+
+  cqe            = &ring->cqes[ring->cq_tail & ctx->cqmask];
+  cqe->user_data = op->sqe.user_data;
+  cqe->res       = res;
+  UP_DMB();
+  ring->cq_tail++;
+
+  sq_addlast(&op->link, &ctx->freelist);
+  nxmutex_unlock(&ctx->cqlock);
+
+  nxsem_get_value(&ctx->cqsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&ctx->cqsem);
+    }
+}
+
+/****************************************************************************
+ * Name: aioring_poll_cb
+ *
+ * Description:
+ *   The driver reports the readiness, queue the operation to the worker
+ *   pool.  This may run in the interrupt context.
+ *
+ ****************************************************************************/
+
+static void aioring_poll_cb(FAR struct pollfd *fds)
+{
+  FAR struct aioring_op_s *op = fds->arg;
+  FAR struct aioring_ctx_s *ctx = op->ctx;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&ctx->slock);
+  if (op->armed && fds->revents != 0)
+    {
+      op->armed = false;
+      work_queue_wq(g_aioring_wq, &op->work, aioring_worker, op, 0);
+    }
+
+  spin_unlock_irqrestore(&ctx->slock, flags);
+}
+
+/****************************************************************************
+ * Name: aioring_arm
+ *
+ * Description:
+ *   Wait for the poll events of the operation in the driver.  The callback
+ *   may run before this function returns if the file is ready already.
+ *
+ ****************************************************************************/
+
+static int aioring_arm(FAR struct aioring_op_s *op, pollevent_t events)
+{
+  irqstate_t flags;
+  int ret;
+
+  op->pfd.events  = events;
+  op->pfd.revents = 0;
+
+  /* Mark it polled first, the worker queued by the callback may run
+   * before file_poll() returns and should teardown this setup.
+   */
+
+  op->polled = true;
+  flags = spin_lock_irqsave(&op->ctx->slock);
+  op->armed = true;
+  spin_unlock_irqrestore(&op->ctx->slock, flags);
+
+  ret = file_poll(op->filep, &op->pfd, true);
+  if (ret < 0)
+    {
+      flags = spin_lock_irqsave(&op->ctx->slock);
+      op->armed = false;
+      spin_unlock_irqrestore(&op->ctx->slock, flags);
+      op->polled = false;
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aioring_disarm
+ ****************************************************************************/
+
+static void aioring_disarm(FAR struct aioring_op_s *op)
+{
+  if (op->polled)
+    {
+      file_poll(op->filep, &op->pfd, false);
+      op->polled = false;
+    }
+}
+
+/****************************************************************************
+ * Name: aioring_events
+ *
+ * Description:
+ *   Return the poll events the operation waits for.
+ *
+ ****************************************************************************/
+
+static pollevent_t aioring_events(FAR struct aioring_op_s *op)
+{
+  switch (op->sqe.opcode)
+    {
+      case AIORING_OP_READ:
+      case AIORING_OP_RECV:
+      case AIORING_OP_ACCEPT:
+        return POLLIN;
+
+      case AIORING_OP_WRITE:
+      case AIORING_OP_SEND:
+        return POLLOUT;
+
+      case AIORING_OP_POLL:
+        return op->sqe.opflags;
+
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: aioring_perform
+ *
+ * Description:
+ *   Run the operation on a worker thread.  Socket operations never block,
+ *   -EAGAIN makes the caller wait for the readiness again.
+ *
+ ****************************************************************************/
+
+static ssize_t aioring_perform(FAR struct aioring_op_s *op)
+{
+  FAR struct aioring_sqe_s *sqe = &op->sqe;
+#ifdef CONFIG_NET
+  FAR struct socket *psock = file_socket(op->filep);
+  int ret;
+#endif
+
+  switch (sqe->opcode)
+    {
+      case AIORING_OP_READ:
+#ifdef CONFIG_NET
+        if (psock != NULL)
+          {
+            return psock_recvfrom(psock, sqe->addr, sqe->len,
+                                  MSG_DONTWAIT, NULL, NULL);
+          }
+#endif
+
+        if (sqe->off == AIORING_OFF_CURRENT)
+          {
+            return file_read(op->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pread(op->filep, sqe->addr, sqe->len, sqe->off);
+
+      case AIORING_OP_WRITE:
+#ifdef CONFIG_NET
+        if (psock != NULL)
+          {
+            return psock_send(psock, sqe->addr, sqe->len, MSG_DONTWAIT);
+          }
+#endif
+
+        if (sqe->off == AIORING_OFF_CURRENT)
+          {
+            return file_write(op->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pwrite(op->filep, sqe->addr, sqe->len, sqe->off);
+
+#ifdef CONFIG_NET
+      case AIORING_OP_SEND:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        return psock_send(psock, sqe->addr, sqe->len,
+                          sqe->opflags | MSG_DONTWAIT);
+
+      case AIORING_OP_RECV:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        return psock_recvfrom(psock, sqe->addr, sqe->len,
+                              sqe->opflags | MSG_DONTWAIT, NULL, NULL);
+
+      case AIORING_OP_ACCEPT:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        op->newsock = fs_heap_zalloc(sizeof(*op->newsock));
+        if (op->newsock == NULL)
+          {
+            return -ENOMEM;
+          }
+
+        ret = psock_accept(psock, NULL, NULL, op->newsock, sqe->opflags);
+        if (ret < 0)
+          {
+            fs_heap_free(op->newsock);
+            op->newsock = NULL;
+          }
+
+        return ret;
+#endif
+
+      case AIORING_OP_FSYNC:
+        return file_fsync(op->filep);
+
+      case AIORING_OP_POLL:
+        return op->pfd.revents;
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: aioring_worker
+ ****************************************************************************/
+
+static void aioring_worker(FAR void *arg)
+{
+  FAR struct aioring_op_s *op = arg;
+  FAR struct aioring_ctx_s *ctx = op->ctx;
+  ssize_t res;
+
+  aioring_disarm(op);
+
+  res = aioring_perform(op);
+  if (res == -EAGAIN && !ctx->closing)
+    {
+      res = aioring_arm(op, aioring_events(op));
+      if (res >= 0)
+        {
+          return;
+        }
+    }
+
+#ifdef CONFIG_NET
+  if (op->newsock != NULL)
+    {
+      /* The descriptor must be allocated in the task group of the ring,
+       * leave it to the next aioring_enter().
+       */
+
+      nxmutex_lock(&ctx->cqlock);
+      sq_addlast(&op->link, &ctx->donelist);
+      nxmutex_unlock(&ctx->cqlock);
+      nxsem_post(&ctx->cqsem);
+      return;
+    }
+#endif
+
+  aioring_post(ctx, op, res);
+}
+
+/****************************************************************************
+ * Name: aioring_install
+ *
+ * Description:
+ *   Allocate the descriptors of the accepted sockets in the calling task
+ *   group and post their completions.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+static void aioring_install(FAR struct aioring_ctx_s *ctx)
+{
+  FAR struct aioring_op_s *op;
+  int oflags;
+  int fd;
+
+  for (; ; )
+    {
+      nxmutex_lock(&ctx->cqlock);
+      op = (FAR struct aioring_op_s *)sq_remfirst(&ctx->donelist);
+      nxmutex_unlock(&ctx->cqlock);
+      if (op == NULL)
+        {
+          break;
+        }
+
+      oflags = O_RDWR;
+      if ((op->sqe.opflags & SOCK_CLOEXEC) != 0)
+        {
+          oflags |= O_CLOEXEC;
+        }
+
+      if ((op->sqe.opflags & SOCK_NONBLOCK) != 0)
+        {
+          oflags |= O_NONBLOCK;
+        }
+
+      fd = sockfd_allocate(op->newsock, oflags);
+      if (fd < 0)
+        {
+          psock_close(op->newsock);
+          fs_heap_free(op->newsock);
+          fd = -ENFILE;
+        }
+
+      op->newsock = NULL;
+      aioring_post(ctx, op, fd);
+    }
+}
+#else
+#  define aioring_install(ctx)
+#endif
+
+/****************************************************************************
+ * Name: aioring_submit
+ *
+ * Description:
+ *   Start one submission entry.  Returns a negated errno value if the
+ *   operation could not be started, the caller posts the completion.
+ *
+ ****************************************************************************/
+
+static int aioring_submit(FAR struct aioring_ctx_s *ctx,
+                          FAR struct aioring_op_s *op)
+{
+  pollevent_t events;
+  int ret;
+
+  if (op->sqe.opcode == AIORING_OP_NOP)
+    {
+      aioring_post(ctx, op, 0);
+      return OK;
+    }
+
+  ret = fs_getfilep(op->sqe.fd, &op->filep);
+  if (ret < 0)
+    {
+      op->filep = NULL;
+      return ret;
+    }
+
+  /* Wait for the readiness in the driver when the operation has a poll
+   * event, regular files report ready at once.  The rest and the drivers
+   * without poll support go to the worker pool directly.
+   */
+
+  events = aioring_events(op);
+  if (events != 0)
+    {
+      ret = aioring_arm(op, events);
+      if (ret != -ENOSYS || op->sqe.opcode == AIORING_OP_POLL)
+        {
+          return ret;
+        }
+    }
+
+  return work_queue_wq(g_aioring_wq, &op->work, aioring_worker, op, 0);
+}
+
+/****************************************************************************
+ * Name: aioring_open
+ ****************************************************************************/
+
+static int aioring_open(FAR struct file *filep)
+{
+  FAR struct aioring_ctx_s *ctx = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret >= 0)
+    {
+      ctx->crefs++;
+      nxmutex_unlock(&ctx->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aioring_close
+ *
+ * Description:
+ *   Cancel the in-flight operations and free the ring context.
+ *
+ ****************************************************************************/
+
+static int aioring_close(FAR struct file *filep)
+{
+  FAR struct aioring_ctx_s *ctx = filep->f_priv;
+  FAR struct aioring_op_s *op;
+  irqstate_t flags;
+  uint32_t i;
+  int ret;
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--ctx->crefs > 0)
+    {
+      nxmutex_unlock(&ctx->lock);
+      return OK;
+    }
+
+  ctx->closing = true;
+  for (i = 0; i <= ctx->cqmask; i++)
+    {
+      op = &ctx->ops[i];
+
+      /* Stop the poll callback and wait for the running worker, the worker
+       * doesn't arm again once closing is set.
+       */
+
+      flags = spin_lock_irqsave(&ctx->slock);
+      op->armed = false;
+      spin_unlock_irqrestore(&ctx->slock, flags);
+
+      work_cancel_sync_wq(g_aioring_wq, &op->work);
+      aioring_disarm(op);
+
+#ifdef CONFIG_NET
+      if (op->newsock != NULL)
+        {
+          psock_close(op->newsock);
+          fs_heap_free(op->newsock);
+          op->newsock = NULL;
+        }
+#endif
+
+      if (op->filep != NULL)
+        {
+          fs_putfilep(op->filep);
+          op->filep = NULL;
+        }
+    }
+
+  nxmutex_unlock(&ctx->lock);
+  nxmutex_destroy(&ctx->lock);
+  nxmutex_destroy(&ctx->cqlock);
+  nxsem_destroy(&ctx->cqsem);
+  fs_heap_free(ctx);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioring_setup
+ *
+ * Description:
+ *   Register the ring with the kernel and return a file descriptor for it.
+ *
+ * Input Parameters:
+ *   ring - The ring in the application memory, sq_entries and cq_entries
+ *          must be powers of two.
+ *
+ * Returned Value:
+ *   The file descriptor on success.  Otherwise, -1 is returned and the
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int aioring_setup(FAR struct aioring_s *ring)
+{
+  FAR struct aioring_ctx_s *ctx;
+  uint32_t i;
+  int ret;
+
+  if (ring == NULL || ring->sqes == NULL || ring->cqes == NULL ||
+      ring->sq_entries == 0 || ring->cq_entries == 0 ||
+      (ring->sq_entries & (ring->sq_entries - 1)) != 0 ||
+      (ring->cq_entries & (ring->cq_entries - 1)) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  nxmutex_lock(&g_aioring_lock);
+  if (g_aioring_wq == NULL)
+    {
+      g_aioring_wq = work_queue_create("aioring",
+                                       CONFIG_FS_AIO_RING_PRIORITY, NULL,
+                                       CONFIG_FS_AIO_RING_STACKSIZE,
+                                       CONFIG_FS_AIO_RING_NTHREADS);
+    }
+
+  nxmutex_unlock(&g_aioring_lock);
+  if (g_aioring_wq == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ctx = fs_heap_zalloc(sizeof(*ctx) +
+                       sizeof(struct aioring_op_s) * ring->cq_entries);
+  if (ctx == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ctx->ring   = ring;
+  ctx->sqmask = ring->sq_entries - 1;
+  ctx->cqmask = ring->cq_entries - 1;
+  ctx->crefs  = 1;
+  ctx->ops    = (FAR struct aioring_op_s *)(ctx + 1);
+  nxmutex_init(&ctx->lock);
+  nxmutex_init(&ctx->cqlock);
+  nxsem_init(&ctx->cqsem, 0, 0);
+  spin_lock_init(&ctx->slock);
+  sq_init(&ctx->freelist);
+  sq_init(&ctx->donelist);
+
+  for (i = 0; i < ring->cq_entries; i++)
+    {
+      ctx->ops[i].ctx     = ctx;
+      ctx->ops[i].pfd.arg = &ctx->ops[i];
+      ctx->ops[i].pfd.cb  = aioring_poll_cb;
+      sq_addlast(&ctx->ops[i].link, &ctx->freelist);
+    }
+
+  ring->sq_head = ring->sq_tail = 0;
+  ring->cq_head = ring->cq_tail = 0;
+
+  ret = file_allocate(&g_aioring_inode, O_RDWR, 0, ctx, 0, true);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&ctx->lock);
+      nxmutex_destroy(&ctx->cqlock);
+      nxsem_destroy(&ctx->cqsem);
+      fs_heap_free(ctx);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: aioring_enter
+ *
+ * Description:
+ *   Submit the queued entries in one call and optionally wait for the
+ *   completions.
+ *
+ * Input Parameters:
+ *   fd           - The ring file descriptor
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - The number of completions to wait for
+ *   flags        - AIORING_ENTER_* flags
+ *
+ * Returned Value:
+ *   The number of submitted entries on success.  Otherwise, -1 is returned
+ *   and the errno is set appropriately.  The submission stops early with
+ *   fewer entries when all the operations are in flight (the CQ size).
+ *
+ ****************************************************************************/
+
+int aioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                  unsigned int flags)
+{
+  FAR struct aioring_ctx_s *ctx;
+  FAR struct aioring_op_s *op;
+  FAR struct aioring_s *ring;
+  FAR struct file *filep;
+  unsigned int submitted = 0;
+  uint32_t head;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_aioring_inode)
+    {
+      ret = -EBADF;
+      goto errout_with_filep;
+    }
+
+  ctx  = filep->f_priv;
+  ring = ctx->ring;
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  aioring_install(ctx);
+
+  /* Consume the submission queue, each entry is copied so that the slot
+   * can be reused by the application as soon as sq_head moves.
+   */
+
+  head = ring->sq_head;
+  UP_DMB();
+  while (submitted < to_submit && head != ring->sq_tail)
+    {
+      nxmutex_lock(&ctx->cqlock);
+      op = (FAR struct aioring_op_s *)sq_remfirst(&ctx->freelist);
+      nxmutex_unlock(&ctx->cqlock);
+      if (op == NULL)
+        {
+          break;
+        }
+
+      op->sqe = ring->sqes[head & ctx->sqmask];
+      ring->sq_head = ++head;
+      submitted++;
+
+      ret = aioring_submit(ctx, op);
+      if (ret < 0)
+        {
+          aioring_post(ctx, op, ret);
+        }
+    }
+
+  nxmutex_unlock(&ctx->lock);
+
+  if (submitted == 0 && to_submit > 0 && head != ring->sq_tail)
+    {
+      ret = -EBUSY;
+      goto errout_with_filep;
+    }
+
+  /* Wait for the completions */
+
+  ret = OK;
+  if ((flags & AIORING_ENTER_GETEVENTS) != 0)
+    {
+      while (ring->cq_tail - ring->cq_head < min_complete)
+        {
+          ret = nxsem_wait(&ctx->cqsem);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (nxmutex_lock(&ctx->lock) >= 0)
+            {
+              aioring_install(ctx);
+              nxmutex_unlock(&ctx->lock);
+            }
+        }
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0 && submitted == 0)
+    {
+      goto errout;
+    }
+
+  return submitted;
+
+errout_with_filep:
+  fs_putfilep(filep);
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_AIO_RING */
@@ -145,8 +145,13 @@ static int      cromfs_open(FAR struct file *filep, FAR const char *relpath,
 static int      cromfs_close(FAR struct file *filep);
 static ssize_t  cromfs_read(FAR struct file *filep,
                             FAR char *buffer, size_t buflen);
+static int      cromfs_xipbase(FAR const struct cromfs_volume_s *fs,
+                               FAR const struct cromfs_node_s *node,
+                               FAR uintptr_t *xipbase);
 static int      cromfs_ioctl(FAR struct file *filep,
                              int cmd, unsigned long arg);
+static int      cromfs_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
 
 static int      cromfs_dup(FAR const struct file *oldp,
                            FAR struct file *newp);
@@ -191,7 +196,7 @@ const struct mountpt_operations g_cromfs_operations =
   NULL,              /* write */
   NULL,              /* seek */
   cromfs_ioctl,      /* ioctl */
-  NULL,              /* mmap */
+  cromfs_mmap,       /* mmap */
   NULL,              /* truncate */
   NULL,              /* poll */
   NULL,              /* readv */
@@ -1078,15 +1083,88 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   return buflen;
 }
 
+/****************************************************************************
+ * Name: cromfs_xipbase
+ *
+ * Description:
+ *   Return the address of the file data in the image if it can be accessed
+ *   in place.  The data is broken up by the LZF block headers, so that is
+ *   only possible if the whole file is held by one uncompressed block.
+ *
+ ****************************************************************************/
+
+static int cromfs_xipbase(FAR const struct cromfs_volume_s *fs,
+                          FAR const struct cromfs_node_s *node,
+                          FAR uintptr_t *xipbase)
+{
+  FAR struct lzf_type0_header_s *hdr0;
+  uint16_t ulen;
+
+  hdr0 = (FAR struct lzf_type0_header_s *)
+         cromfs_offset2addr(fs, node->u.cn_blocks);
+  if (hdr0->lzf_type != LZF_TYPE0_HDR)
+    {
+      return -ENXIO;
+    }
+
+  ulen = (uint16_t)hdr0->lzf_len[0] << 8 | (uint16_t)hdr0->lzf_len[1];
+  if (ulen != node->cn_size)
+    {
+      return -ENXIO;
+    }
+
+  *xipbase = (uintptr_t)hdr0 + LZF_TYPE0_HDR_SIZE;
+  return OK;
+}
+
 /****************************************************************************
  * Name: cromfs_ioctl
  ****************************************************************************/
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct cromfs_file_s *ff;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands yet supported */
+  ff = filep->f_priv;
+  DEBUGASSERT(ff != NULL && ff->ff_node != NULL);
+
+  if (cmd == FIOC_XIPBASE)
+    {
+      return cromfs_xipbase(filep->f_inode->i_private, ff->ff_node,
+                            (FAR uintptr_t *)arg);
+    }
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: cromfs_mmap
+ ****************************************************************************/
+
+static int cromfs_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct cromfs_file_s *ff;
+  uintptr_t xipbase;
+
+  ff = filep->f_priv;
+  DEBUGASSERT(ff != NULL && ff->ff_node != NULL);
+
+  /* Return the address of the data in the image if it is uncompressed,
+   * otherwise let rammap() decompress the file.
+   */
+
+  if (map->offset >= 0 && map->offset < ff->ff_node->cn_size &&
+      map->length != 0 &&
+      map->offset + map->length <= ff->ff_node->cn_size &&
+      cromfs_xipbase(filep->f_inode->i_private, ff->ff_node,
+                     &xipbase) >= 0)
+    {
+      map->vaddr = (FAR void *)(xipbase + map->offset);
+      return OK;
+    }
 
   return -ENOTTY;
 }
@@ -0,0 +1,876 @@
+/****************************************************************************
+ * fs/driver/fs_blkcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <inttypes.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkcache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_FS_BLKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLKCACHE_HASH_MASK (CONFIG_FS_BLKCACHE_HASHSIZE - 1)
+
+#if (CONFIG_FS_BLKCACHE_HASHSIZE & BLKCACHE_HASH_MASK) != 0
+#  error CONFIG_FS_BLKCACHE_HASHSIZE must be a power of two
+#endif
+
+#ifndef CONFIG_SCHED_LPWORK
+#  error CONFIG_FS_BLKCACHE requires CONFIG_SCHED_LPWORK
+#endif
+
+#define BLKCACHE_HASH(s)   ((uint32_t)(s) & BLKCACHE_HASH_MASK)
+#define BLKCACHE_PAGESIZE(bc) \
+  (sizeof(struct blkcache_page_s) + (bc)->sectorsize)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct blkcache_page_s
+{
+  struct list_node               lru;    /* g_blkcache_lru, MRU first */
+  FAR struct blkcache_page_s    *hnext;  /* Hash bucket chain */
+  FAR struct blkcache_s         *bc;     /* Owner cache */
+  blkcnt_t                       sector; /* Sector number */
+  bool                           dirty;  /* Not yet written back */
+  aligned_data(sizeof(uintptr_t)) uint8_t data[1];
+};
+
+/* The cache of one block driver */
+
+struct blkcache_s
+{
+  struct list_node               node;   /* g_blkcache_list */
+  FAR struct inode              *inode;  /* The block driver */
+  int                            crefs;  /* Number of users */
+  uint16_t                       sectorsize;
+  blkcnt_t                       nsectors;
+  blkcnt_t                       ranext; /* Next sector if sequential */
+  unsigned int                   rawin;  /* Readahead window in sectors */
+  unsigned int                   ndirty; /* Number of dirty pages */
+  FAR uint8_t                   *bounce; /* MAXIO sectors transfer buffer */
+  struct work_s                  work;   /* Delayed writeback */
+  struct work_s                  rawork; /* Asynchronous readahead */
+  blkcnt_t                       rapos;  /* Next sector to prefetch */
+  unsigned int                   racnt;  /* Sectors left to prefetch */
+  FAR struct blkcache_page_s    *hash[CONFIG_FS_BLKCACHE_HASHSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All the caches share one lock, one LRU list and one memory budget */
+
+static mutex_t g_blkcache_lock = NXMUTEX_INITIALIZER;
+static struct list_node g_blkcache_lru = LIST_INITIAL_VALUE(g_blkcache_lru);
+static struct list_node g_blkcache_list =
+  LIST_INITIAL_VALUE(g_blkcache_list);
+static size_t g_blkcache_used;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_find
+ ****************************************************************************/
+
+static FAR struct blkcache_page_s *blkcache_find(FAR struct blkcache_s *bc,
+                                                 blkcnt_t sector)
+{
+  FAR struct blkcache_page_s *page;
+
+  for (page = bc->hash[BLKCACHE_HASH(sector)]; page; page = page->hnext)
+    {
+      if (page->sector == sector)
+        {
+          break;
+        }
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: blkcache_insert
+ *
+ * Description:
+ *   Make a detached page visible in the hash and the LRU list.
+ *
+ ****************************************************************************/
+
+static void blkcache_insert(FAR struct blkcache_page_s *page,
+                            blkcnt_t sector)
+{
+  FAR struct blkcache_page_s **bucket;
+
+  bucket       = &page->bc->hash[BLKCACHE_HASH(sector)];
+  page->sector = sector;
+  page->hnext  = *bucket;
+  *bucket      = page;
+  list_add_head(&g_blkcache_lru, &page->lru);
+}
+
+/****************************************************************************
+ * Name: blkcache_free
+ ****************************************************************************/
+
+static void blkcache_free(FAR struct blkcache_page_s *page)
+{
+  FAR struct blkcache_s *bc = page->bc;
+  FAR struct blkcache_page_s **pp;
+
+  for (pp = &bc->hash[BLKCACHE_HASH(page->sector)]; *pp != page;
+       pp = &(*pp)->hnext);
+
+  *pp = page->hnext;
+  list_delete(&page->lru);
+
+  if (page->dirty)
+    {
+      bc->ndirty--;
+    }
+
+  g_blkcache_used -= BLKCACHE_PAGESIZE(bc);
+  kmm_free(page);
+}
+
+/****************************************************************************
+ * Name: blkcache_writeback
+ *
+ * Description:
+ *   Write back the run of adjacent dirty sectors around page with one
+ *   driver request of up to CONFIG_FS_BLKCACHE_MAXIO sectors.
+ *
+ ****************************************************************************/
+
+static int blkcache_writeback(FAR struct blkcache_page_s *page)
+{
+  FAR struct blkcache_s *bc = page->bc;
+  FAR struct inode *inode = bc->inode;
+  FAR struct blkcache_page_s *p;
+  blkcnt_t start = page->sector;
+  unsigned int count;
+  unsigned int i;
+  ssize_t ret;
+
+  /* Find the start of the run */
+
+  for (count = 1; count < CONFIG_FS_BLKCACHE_MAXIO && start > 0;
+       count++, start--)
+    {
+      p = blkcache_find(bc, start - 1);
+      if (p == NULL || !p->dirty)
+        {
+          break;
+        }
+    }
+
+  /* Gather the run in the bounce buffer */
+
+  for (count = 0; count < CONFIG_FS_BLKCACHE_MAXIO; count++)
+    {
+      p = blkcache_find(bc, start + count);
+      if (p == NULL || !p->dirty)
+        {
+          break;
+        }
+
+      memcpy(bc->bounce + count * bc->sectorsize, p->data, bc->sectorsize);
+    }
+
+  ret = inode->u.i_bops->write(inode, bc->bounce, start, count);
+  if (ret < 0)
+    {
+      ferr("ERROR: write %" PRIuOFF " failed: %zd\n", start, ret);
+      return ret;
+    }
+
+  /* A short write leaves the rest of the run dirty */
+
+  for (i = 0; i < ret; i++)
+    {
+      p = blkcache_find(bc, start + i);
+      p->dirty = false;
+    }
+
+  bc->ndirty -= ret;
+  return ret > 0 ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: blkcache_writeback_all
+ ****************************************************************************/
+
+static int blkcache_writeback_all(FAR struct blkcache_s *bc)
+{
+  FAR struct blkcache_page_s *page;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLKCACHE_HASHSIZE && bc->ndirty > 0; i++)
+    {
+      for (page = bc->hash[i]; page; page = page->hnext)
+        {
+          if (page->dirty)
+            {
+              ret = blkcache_writeback(page);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_alloc
+ *
+ * Description:
+ *   Allocate a detached page, evicting the least recently used pages of
+ *   any cache to stay in the memory budget.  The page is not reachable by
+ *   the eviction until blkcache_insert() is called.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_page_s *
+blkcache_alloc(FAR struct blkcache_s *bc)
+{
+  FAR struct blkcache_page_s *page;
+  size_t size = BLKCACHE_PAGESIZE(bc);
+
+  while (g_blkcache_used + size > CONFIG_FS_BLKCACHE_SIZE)
+    {
+      if (list_is_empty(&g_blkcache_lru))
+        {
+          return NULL;
+        }
+
+      page = list_last_entry(&g_blkcache_lru, struct blkcache_page_s, lru);
+      if (page->dirty && blkcache_writeback(page) < 0)
+        {
+          return NULL;
+        }
+
+      blkcache_free(page);
+    }
+
+  page = kmm_malloc(size);
+  if (page != NULL)
+    {
+      page->bc    = bc;
+      page->dirty = false;
+      g_blkcache_used += size;
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: blkcache_discard
+ *
+ * Description:
+ *   Write back or drop the cached sectors that a direct transfer overlaps.
+ *
+ ****************************************************************************/
+
+static int blkcache_discard(FAR struct blkcache_s *bc, blkcnt_t sector,
+                            unsigned int nsectors, bool drop)
+{
+  FAR struct blkcache_page_s *page;
+  unsigned int i;
+  int ret;
+
+  for (i = 0; i < nsectors; i++)
+    {
+      page = blkcache_find(bc, sector + i);
+      if (page == NULL)
+        {
+          continue;
+        }
+
+      if (drop)
+        {
+          blkcache_free(page);
+        }
+      else if (page->dirty)
+        {
+          ret = blkcache_writeback(page);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_fill
+ *
+ * Description:
+ *   Read the missing sector and up to limit - 1 following missing sectors
+ *   into the cache with one driver request.
+ *
+ * Returned Value:
+ *   The number of sectors read or a negated errno value.  Zero means that
+ *   no page could be allocated.
+ *
+ ****************************************************************************/
+
+static ssize_t blkcache_fill(FAR struct blkcache_s *bc, blkcnt_t sector,
+                             unsigned int limit)
+{
+  FAR struct blkcache_page_s *pages[CONFIG_FS_BLKCACHE_MAXIO];
+  FAR struct inode *inode = bc->inode;
+  unsigned int count;
+  unsigned int i;
+  ssize_t ret;
+
+  limit = MIN(limit, CONFIG_FS_BLKCACHE_MAXIO);
+  limit = MIN(limit, bc->nsectors - sector);
+
+  /* Stop at the first sector that is already cached */
+
+  for (count = 0; count < limit; count++)
+    {
+      if (count > 0 && blkcache_find(bc, sector + count) != NULL)
+        {
+          break;
+        }
+
+      pages[count] = blkcache_alloc(bc);
+      if (pages[count] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  ret = inode->u.i_bops->read(inode, bc->bounce, sector, count);
+  if (ret > 0)
+    {
+      for (i = 0; i < ret; i++)
+        {
+          memcpy(pages[i]->data, bc->bounce + i * bc->sectorsize,
+                 bc->sectorsize);
+          blkcache_insert(pages[i], sector + i);
+        }
+    }
+
+  /* Release the pages that were not filled */
+
+  for (i = ret > 0 ? ret : 0; i < count; i++)
+    {
+      g_blkcache_used -= BLKCACHE_PAGESIZE(bc);
+      kmm_free(pages[i]);
+    }
+
+  return ret != 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: blkcache_worker
+ ****************************************************************************/
+
+static void blkcache_worker(FAR void *arg)
+{
+  FAR struct blkcache_s *bc = arg;
+
+  nxmutex_lock(&g_blkcache_lock);
+  blkcache_writeback_all(bc);
+  nxmutex_unlock(&g_blkcache_lock);
+}
+
+/****************************************************************************
+ * Name: blkcache_raworker
+ ****************************************************************************/
+
+static void blkcache_raworker(FAR void *arg)
+{
+  FAR struct blkcache_s *bc = arg;
+  ssize_t ret;
+
+  nxmutex_lock(&g_blkcache_lock);
+  while (bc->racnt > 0)
+    {
+      if (blkcache_find(bc, bc->rapos) != NULL)
+        {
+          ret = 1;
+        }
+      else
+        {
+          ret = blkcache_fill(bc, bc->rapos, bc->racnt);
+          if (ret <= 0)
+            {
+              break;
+            }
+        }
+
+      bc->rapos += ret;
+      bc->racnt -= MIN((size_t)ret, bc->racnt);
+    }
+
+  bc->racnt = 0;
+  nxmutex_unlock(&g_blkcache_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_open
+ ****************************************************************************/
+
+int blkcache_open(FAR struct inode *inode, FAR struct blkcache_s **bc)
+{
+  FAR struct blkcache_s *cache;
+  struct geometry geo;
+  int ret;
+
+  DEBUGASSERT(inode != NULL && bc != NULL);
+
+  if (inode->u.i_bops == NULL || inode->u.i_bops->read == NULL ||
+      inode->u.i_bops->geometry == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  list_for_every_entry(&g_blkcache_list, cache, struct blkcache_s, node)
+    {
+      if (cache->inode == inode)
+        {
+          cache->crefs++;
+          goto out;
+        }
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  cache = kmm_zalloc(sizeof(*cache));
+  if (cache == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  cache->bounce = kmm_malloc(CONFIG_FS_BLKCACHE_MAXIO * geo.geo_sectorsize);
+  if (cache->bounce == NULL)
+    {
+      kmm_free(cache);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  cache->inode      = inode;
+  cache->crefs      = 1;
+  cache->sectorsize = geo.geo_sectorsize;
+  cache->nsectors   = geo.geo_nsectors;
+  list_add_tail(&g_blkcache_list, &cache->node);
+
+out:
+  *bc = cache;
+  ret = OK;
+
+errout:
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_close
+ ****************************************************************************/
+
+int blkcache_close(FAR struct blkcache_s *bc)
+{
+  FAR struct blkcache_page_s *page;
+  int ret;
+  int i;
+
+  nxmutex_lock(&g_blkcache_lock);
+  ret = blkcache_writeback_all(bc);
+  if (--bc->crefs > 0)
+    {
+      nxmutex_unlock(&g_blkcache_lock);
+      return ret;
+    }
+
+  list_delete(&bc->node);
+  bc->racnt = 0;
+  for (i = 0; i < CONFIG_FS_BLKCACHE_HASHSIZE; i++)
+    {
+      while ((page = bc->hash[i]) != NULL)
+        {
+          blkcache_free(page);
+        }
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+
+  /* The worker may still hold a reference to the cache */
+
+  work_cancel_sync(LPWORK, &bc->work);
+  work_cancel_sync(LPWORK, &bc->rawork);
+  kmm_free(bc->bounce);
+  kmm_free(bc);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_read
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct blkcache_s *bc, FAR void *buffer,
+                      blkcnt_t sector, unsigned int nsectors)
+{
+  FAR struct inode *inode = bc->inode;
+  FAR struct blkcache_page_s *page;
+  FAR uint8_t *dest = buffer;
+  unsigned int done;
+  ssize_t ret;
+
+  if (sector >= bc->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nsectors = MIN(nsectors, bc->nsectors - sector);
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Grow the readahead window while the reads are sequential */
+
+  if (sector == bc->ranext)
+    {
+      bc->rawin = MIN(MAX(bc->rawin * 2, nsectors),
+                      CONFIG_FS_BLKCACHE_READAHEAD);
+    }
+  else
+    {
+      bc->rawin = 0;
+    }
+
+  bc->ranext = sector + nsectors;
+
+  /* Large transfers bypass the cache, the cached data is written back
+   * first so that the driver has the latest copy.
+   */
+
+  if (nsectors >= CONFIG_FS_BLKCACHE_MAXIO)
+    {
+      ret = blkcache_discard(bc, sector, nsectors, false);
+      if (ret >= 0)
+        {
+          ret = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+        }
+
+      goto out;
+    }
+
+  for (done = 0; done < nsectors; done++)
+    {
+      page = blkcache_find(bc, sector + done);
+      if (page == NULL)
+        {
+          ret = blkcache_fill(bc, sector + done,
+                              nsectors - done + bc->rawin);
+          if (ret == 0)
+            {
+              /* Out of cache memory, read directly */
+
+              ret = inode->u.i_bops->read(inode, dest, sector + done, 1);
+              if (ret != 1)
+                {
+                  break;
+                }
+
+              dest += bc->sectorsize;
+              continue;
+            }
+          else if (ret < 0)
+            {
+              break;
+            }
+
+          page = blkcache_find(bc, sector + done);
+        }
+
+      memcpy(dest, page->data, bc->sectorsize);
+      list_delete(&page->lru);
+      list_add_head(&g_blkcache_lru, &page->lru);
+      dest += bc->sectorsize;
+    }
+
+  ret = done > 0 ? done : ret;
+
+out:
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_readahead
+ ****************************************************************************/
+
+int blkcache_readahead(FAR struct blkcache_s *bc, blkcnt_t sector,
+                       unsigned int nsectors)
+{
+  int ret;
+
+  if (sector >= bc->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* A newer hint replaces the pending one */
+
+  bc->rapos = sector;
+  bc->racnt = MIN(nsectors, bc->nsectors - sector);
+  if (bc->racnt > 0 && work_available(&bc->rawork))
+    {
+      work_queue(LPWORK, &bc->rawork, blkcache_raworker, bc, 0);
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_write
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct blkcache_s *bc, FAR const void *buffer,
+                       blkcnt_t sector, unsigned int nsectors)
+{
+  FAR struct inode *inode = bc->inode;
+  FAR struct blkcache_page_s *page;
+  FAR const uint8_t *src = buffer;
+  unsigned int done;
+  ssize_t ret;
+
+  if (inode->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  if (sector >= bc->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nsectors = MIN(nsectors, bc->nsectors - sector);
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Large transfers bypass the cache, the overwritten pages are dropped */
+
+  if (nsectors >= CONFIG_FS_BLKCACHE_MAXIO)
+    {
+      blkcache_discard(bc, sector, nsectors, true);
+      ret = inode->u.i_bops->write(inode, buffer, sector, nsectors);
+      goto out;
+    }
+
+  for (done = 0; done < nsectors; done++, src += bc->sectorsize)
+    {
+      page = blkcache_find(bc, sector + done);
+      if (page == NULL)
+        {
+          page = blkcache_alloc(bc);
+          if (page == NULL)
+            {
+              /* Out of cache memory, write through */
+
+              ret = inode->u.i_bops->write(inode, src, sector + done, 1);
+              if (ret != 1)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          blkcache_insert(page, sector + done);
+        }
+      else
+        {
+          list_delete(&page->lru);
+          list_add_head(&g_blkcache_lru, &page->lru);
+        }
+
+      memcpy(page->data, src, bc->sectorsize);
+      if (!page->dirty)
+        {
+          page->dirty = true;
+          bc->ndirty++;
+        }
+    }
+
+  if (bc->ndirty > 0 && work_available(&bc->work))
+    {
+      work_queue(LPWORK, &bc->work, blkcache_worker, bc,
+                 MSEC2TICK(CONFIG_FS_BLKCACHE_FLUSH_DELAY));
+    }
+
+  ret = done > 0 ? done : ret;
+
+out:
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_readdirect
+ ****************************************************************************/
+
+ssize_t blkcache_readdirect(FAR struct blkcache_s *bc, FAR void *buffer,
+                            blkcnt_t sector, unsigned int nsectors)
+{
+  FAR struct inode *inode = bc->inode;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = blkcache_discard(bc, sector, nsectors, false);
+  if (ret >= 0)
+    {
+      ret = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_writedirect
+ ****************************************************************************/
+
+ssize_t blkcache_writedirect(FAR struct blkcache_s *bc,
+                             FAR const void *buffer, blkcnt_t sector,
+                             unsigned int nsectors)
+{
+  FAR struct inode *inode = bc->inode;
+  ssize_t ret;
+
+  if (inode->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  blkcache_discard(bc, sector, nsectors, true);
+  ret = inode->u.i_bops->write(inode, buffer, sector, nsectors);
+
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_flush
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct blkcache_s *bc)
+{
+  int ret;
+
+  ret = nxmutex_lock(&g_blkcache_lock);
+  if (ret >= 0)
+    {
+      ret = blkcache_writeback_all(bc);
+      nxmutex_unlock(&g_blkcache_lock);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLKCACHE */
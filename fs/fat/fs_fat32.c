@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -42,6 +43,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -620,10 +622,32 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  /* Jump as close as possible to the target cluster with the cached runs
+   * of the chain.
+   */
+
+  if (ff->ff_startcluster != 0 && num_clu > 0 && new_num_clu > 0)
+    {
+      uint32_t excluster;
+      uint32_t exindex;
+
+      exindex = fat_extentlookup(ff, MIN(num_clu, new_num_clu) - 1,
+                                 &excluster) + 1;
+      if (excluster != 0 && (int)exindex > num_traversed)
+        {
+          cluster       = excluster;
+          num_traversed = exindex;
+        }
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
     {
+      int prevcluster = cluster;
+
       cluster = fat_getcluster(fs, cluster);
 
       /* The chain is broken */
@@ -632,6 +656,12 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      fat_extentadd(ff, i, cluster, prevcluster);
+#else
+      UNUSED(prevcluster);
+#endif
     }
 
   if (read)
@@ -677,6 +707,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
   for (; i < new_num_clu - 1; i++)
     {
+      int prevcluster = cluster;
+
       cluster = fat_extendchain(fs, cluster);
 
       if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
@@ -684,6 +716,12 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+      fat_extentadd(ff, i, cluster, prevcluster);
+#else
+      UNUSED(prevcluster);
+#endif
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -700,6 +738,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
   if (i == new_num_clu - 1)
     {
+      int prevcluster = cluster;
+
       cluster = fat_extendchain(fs, cluster);
 
       if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
@@ -707,6 +747,12 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+      fat_extentadd(ff, i, cluster, prevcluster);
+#else
+      UNUSED(prevcluster);
+#endif
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -744,6 +790,80 @@ out:
   return 0;
 }
 
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Find how many sectors, up to nsectors, can be transferred with one
+ *   request from ->ff_currentsector: the rest of the current cluster and
+ *   the following clusters of the chain while they are contiguous on the
+ *   volume.  If alloc is true, the missing clusters are appended to the
+ *   chain.  ->ff_currentcluster and ->ff_pos are moved to the last
+ *   cluster of the run.
+ *
+ * Returned Value:
+ *   The number of sectors from ->ff_currentsector to the end of the last
+ *   cluster of the run, or a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff,
+                          unsigned int nsectors, bool alloc)
+{
+  unsigned int avail = ff->ff_sectorsincluster;
+  int32_t next;
+
+  nsectors = MIN(nsectors, MAX(avail, CONFIG_FAT_MAXIO_SECTORS));
+  while (avail < nsectors)
+    {
+      next = fat_getcluster(fs, ff->ff_currentcluster);
+      if (next < 0)
+        {
+          return next;
+        }
+
+      if (next < 2 || next >= fs->fs_nclusters + 2)
+        {
+          /* End of the chain */
+
+          if (!alloc)
+            {
+              break;
+            }
+
+          next = fat_extendchain(fs, ff->ff_currentcluster);
+          if (next < 0)
+            {
+              return next;
+            }
+          else if (next == 0)
+            {
+              break;
+            }
+        }
+
+      if (next != ff->ff_currentcluster + 1)
+        {
+          break;
+        }
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      fat_extentadd(ff, ff->ff_pos / (fs->fs_fatsecperclus *
+                                      fs->fs_hwsectorsize) + 1,
+                    next, ff->ff_currentcluster);
+#endif
+
+      ff->ff_currentcluster = next;
+      ff->ff_pos           += fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+      avail                += fs->fs_fatsecperclus;
+    }
+
+  return avail;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -764,6 +884,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
   bool force_indirect = false;
+  bool direct = (filep->f_oflags & O_DIRECT) != 0;
+  int avail;
 #endif
 
   /* Sanity checks */
@@ -808,6 +930,17 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
       goto errout_with_lock;
     }
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+  /* O_DIRECT transfers must be sector aligned */
+
+  if (direct && ((filep->f_pos & SEC_NDXMASK(fs)) != 0 ||
+                 (buflen & SEC_NDXMASK(fs)) != 0))
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+#endif
+
   /* Check that the file position is not past the end of the file */
 
   if (filep->f_pos > ff->ff_size)
@@ -868,13 +1001,21 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the remaining sectors in this cluster
+           * and in the following clusters that are contiguous on the
+           * volume.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          avail = fat_contiguous(fs, ff, nsectors, false);
+          if (avail < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ret = avail;
+              goto errout_with_lock;
+            }
+
+          if (nsectors > (unsigned int)avail)
+            {
+              nsectors = avail;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -885,7 +1026,17 @@ fat_read_restart:
 
           /* Read all of the sectors directly into user memory */
 
-          ret = fat_hwread(fs, userbuffer, ff->ff_currentsector, nsectors);
+          if (direct)
+            {
+              ret = fat_hwreaddirect(fs, userbuffer, ff->ff_currentsector,
+                                     nsectors);
+            }
+          else
+            {
+              ret = fat_hwread(fs, userbuffer, ff->ff_currentsector,
+                               nsectors);
+            }
+
           if (ret < 0)
             {
 #ifdef CONFIG_FAT_DIRECT_RETRY
@@ -909,7 +1060,7 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_sectorsincluster  = avail - nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -984,6 +1135,8 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
   bool force_indirect = false;
+  bool direct = (filep->f_oflags & O_DIRECT) != 0;
+  int avail;
 #endif
 
   DEBUGASSERT(filep->f_priv != NULL);
@@ -1026,6 +1179,17 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+  /* O_DIRECT transfers must be sector aligned */
+
+  if (direct && ((filep->f_pos & SEC_NDXMASK(fs)) != 0 ||
+                 (buflen & SEC_NDXMASK(fs)) != 0))
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+#endif
+
   /* Check if the file size would exceed the range of off_t */
 
   if (buflen > OFF_MAX || ff->ff_size > OFF_MAX - (off_t)buflen)
@@ -1066,13 +1230,21 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the remaining sectors in this cluster
+           * and in the following clusters that are contiguous on the
+           * volume, appending clusters to the chain as needed.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          avail = fat_contiguous(fs, ff, nsectors, true);
+          if (avail < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ret = avail;
+              goto errout_with_lock;
+            }
+
+          if (nsectors > (unsigned int)avail)
+            {
+              nsectors = avail;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -1084,7 +1256,17 @@ fat_write_restart:
 
           /* Write all of the sectors directly from user memory */
 
-          ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector, nsectors);
+          if (direct)
+            {
+              ret = fat_hwwritedirect(fs, userbuffer, ff->ff_currentsector,
+                                      nsectors);
+            }
+          else
+            {
+              ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector,
+                                nsectors);
+            }
+
           if (ret < 0)
             {
 #ifdef CONFIG_FAT_DIRECT_RETRY
@@ -1108,7 +1290,7 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_sectorsincluster  = avail - nsectors;
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -1368,6 +1550,34 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#ifdef CONFIG_FAT_BLKCACHE
+  /* Prefetch the rest of the current cluster, up to the hinted size and
+   * the end of the file, into the sector cache.  Following the chain into
+   * the next cluster would need FAT reads, which is what the readahead is
+   * trying to take out of the read path.
+   */
+
+  if (cmd == FIOC_READAHEAD && fs->fs_blkcache != NULL)
+    {
+      unsigned int nsectors = ff->ff_sectorsincluster;
+
+      ret = OK;
+      if (nsectors > 0 && filep->f_pos < ff->ff_size)
+        {
+          nsectors = MIN(nsectors, SEC_NSECTORS(fs, (size_t)arg +
+                                                fs->fs_hwsectorsize - 1));
+          nsectors = MIN(nsectors, SEC_NSECTORS(fs, ff->ff_size -
+                                                filep->f_pos +
+                                                fs->fs_hwsectorsize - 1));
+          ret = blkcache_readahead(fs->fs_blkcache, ff->ff_currentsector,
+                                   nsectors);
+        }
+
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+#endif
+
   /* ioctl calls are just passed through to the contained block driver */
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1492,6 +1702,15 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+#ifdef CONFIG_FAT_BLKCACHE
+  /* Write back the sectors held dirty in the block cache */
+
+  if (ret >= 0 && fs->fs_blkcache != NULL)
+    {
+      ret = blkcache_flush(fs->fs_blkcache);
+    }
+
+#endif
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1599,6 +1818,9 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1931,6 +2153,10 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+      /* The cached runs may refer to released clusters */
+
+      fat_extentinvalidate(ff);
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2326,6 +2552,15 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_BLKCACHE
+  /* Write back and release the block cache before the driver is closed */
+
+  if (fs->fs_blkcache != NULL)
+    {
+      blkcache_close(fs->fs_blkcache);
+    }
+
+#endif
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2358,6 +2593,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemaprelease(fs);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -36,6 +36,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/fs/blkcache.h>
 
 #include "fs_heap.h"
 
@@ -891,8 +892,29 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_BLKCACHE
+  FAR struct blkcache_s *fs_blkcache; /* Shared sector cache, may be NULL */
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* Bitmap of the allocated clusters, may
+                                    * be NULL */
+#endif
 };
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+/* A run of contiguous clusters of a file: file clusters fe_index to
+ * fe_index + fe_count - 1 are held by the volume clusters fe_cluster to
+ * fe_cluster + fe_count - 1.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* First file cluster index (0-based) */
+  uint32_t fe_cluster;             /* First volume cluster */
+  uint32_t fe_count;               /* Number of clusters, 0: unused */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -913,6 +935,9 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTCACHE_SIZE];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1040,6 +1065,20 @@ EXTERN int    fat_hwread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
 EXTERN int    fat_hwwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
 
+#ifdef CONFIG_FAT_BLKCACHE
+EXTERN int    fat_hwreaddirect(FAR struct fat_mountpt_s *fs,
+                               FAR uint8_t *buffer, off_t sector,
+                               unsigned int nsectors);
+EXTERN int    fat_hwwritedirect(FAR struct fat_mountpt_s *fs,
+                                FAR uint8_t *buffer, off_t sector,
+                                unsigned int nsectors);
+#else
+#  define fat_hwreaddirect(fs, buffer, sector, nsectors) \
+     fat_hwread(fs, buffer, sector, nsectors)
+#  define fat_hwwritedirect(fs, buffer, sector, nsectors) \
+     fat_hwwrite(fs, buffer, sector, nsectors)
+#endif
+
 /* Cluster / cluster chain access helpers */
 
 EXTERN off_t  fat_cluster2sector(FAR struct fat_mountpt_s *fs,
@@ -1055,6 +1094,24 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Free cluster bitmap and file cluster extent cache */
+
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN int    fat_freemapbuild(FAR struct fat_mountpt_s *fs);
+EXTERN void   fat_freemaprelease(FAR struct fat_mountpt_s *fs);
+#endif
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+EXTERN uint32_t fat_extentlookup(FAR struct fat_file_s *ff, uint32_t index,
+                                 FAR uint32_t *cluster);
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster, uint32_t prevcluster);
+#  define fat_extentinvalidate(ff) \
+     memset((ff)->ff_extents, 0, sizeof((ff)->ff_extents))
+#else
+#  define fat_extentinvalidate(ff)
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -40,6 +40,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/psi.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -270,6 +271,207 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemapset
+ *
+ * Description:
+ *   Track an allocation or release of a cluster in the free bitmap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_freemapset(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                           bool used)
+{
+  uint32_t ndx = cluster - 2;
+
+  if (fs->fs_freemap != NULL && cluster >= 2)
+    {
+      if (used)
+        {
+          fs->fs_freemap[ndx >> 5] |= (uint32_t)1 << (ndx & 31);
+        }
+      else
+        {
+          fs->fs_freemap[ndx >> 5] &= ~((uint32_t)1 << (ndx & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemaptest
+ ****************************************************************************/
+
+static bool fat_freemaptest(FAR struct fat_mountpt_s *fs, uint32_t cluster)
+{
+  uint32_t ndx = cluster - 2;
+
+  return (fs->fs_freemap[ndx >> 5] & ((uint32_t)1 << (ndx & 31))) == 0;
+}
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Search the bitmap for a free cluster after start, wrapping around the
+ *   end of the volume.  The start of the first run of at least
+ *   CONFIG_FAT_FREEMAP_MINRUN free clusters is preferred so that the files
+ *   stay contiguous, otherwise the first free cluster is returned.
+ *
+ * Returned Value:
+ *   The free cluster number or 0 if the volume is full.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                  uint32_t start)
+{
+  uint32_t end = fs->fs_nclusters + 2;
+  uint32_t first = 0;
+  uint32_t runstart = 0;
+  uint32_t run = 0;
+  uint32_t cluster;
+  uint32_t n;
+
+  cluster = start + 1;
+  for (n = 0; n < fs->fs_nclusters; n++, cluster++)
+    {
+      if (cluster >= end)
+        {
+          /* A run does not continue across the end of the volume */
+
+          cluster = 2;
+          run     = 0;
+        }
+
+      /* Skip the fully allocated bitmap words at once */
+
+      if (((cluster - 2) & 31) == 0 && cluster + 32 <= end &&
+          fs->fs_freemap[(cluster - 2) >> 5] == UINT32_MAX &&
+          n + 32 <= fs->fs_nclusters)
+        {
+          run      = 0;
+          cluster += 31;
+          n       += 31;
+          continue;
+        }
+
+      if (!fat_freemaptest(fs, cluster))
+        {
+          run = 0;
+          continue;
+        }
+
+      if (run++ == 0)
+        {
+          runstart = cluster;
+          if (first == 0)
+            {
+              first = cluster;
+            }
+        }
+
+      if (run >= CONFIG_FAT_FREEMAP_MINRUN)
+        {
+          return runstart;
+        }
+    }
+
+  return first;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfreecluster
+ *
+ * Description:
+ *   Find a free cluster after startcluster.  When extending the chain
+ *   ending at cluster (non-zero), the cluster following it is tried first.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(FAR struct fat_mountpt_s *fs,
+                                   uint32_t cluster, uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap != NULL)
+    {
+      newcluster = cluster + 1;
+      if (cluster != 0 && newcluster < fs->fs_nclusters + 2 &&
+          fat_freemaptest(fs, newcluster))
+        {
+          return newcluster;
+        }
+
+      return fat_freemapsearch(fs, startcluster);
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster break out */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -520,6 +722,17 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#ifdef CONFIG_FAT_BLKCACHE
+  /* Route the sector accesses through the shared block cache.  The volume
+   * still works without it.
+   */
+
+  if (blkcache_open(inode, &fs->fs_blkcache) < 0)
+    {
+      fs->fs_blkcache = NULL;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -636,6 +849,16 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
     }
 #endif
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Build the free cluster bitmap.  The volume still works without it. */
+
+  ret = fat_freemapbuild(fs);
+  if (ret < 0)
+    {
+      fwarn("WARNING: No free cluster bitmap: %d\n", ret);
+    }
+#endif
+
   /* We did it! */
 
   finfo("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -658,6 +881,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_BLKCACHE
+  if (fs->fs_blkcache != NULL)
+    {
+      blkcache_close(fs->fs_blkcache);
+      fs->fs_blkcache = NULL;
+    }
+
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -728,8 +959,24 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread;
+
+          psi_stall_enter(PSI_IO);
+#ifdef CONFIG_FAT_BLKCACHE
+          if (fs->fs_blkcache != NULL)
+            {
+              nsectorsread = blkcache_read(fs->fs_blkcache, buffer,
+                                           sector, nsectors);
+            }
+          else
+#endif
+            {
+              nsectorsread = inode->u.i_bops->read(inode, buffer,
+                                                   sector, nsectors);
+            }
+
+          psi_stall_leave(PSI_IO);
+
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -761,8 +1008,23 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
-          ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+          ssize_t nsectorswritten;
+
+          psi_stall_enter(PSI_IO);
+#ifdef CONFIG_FAT_BLKCACHE
+          if (fs->fs_blkcache != NULL)
+            {
+              nsectorswritten = blkcache_write(fs->fs_blkcache, buffer,
+                                               sector, nsectors);
+            }
+          else
+#endif
+            {
+              nsectorswritten =
+                inode->u.i_bops->write(inode, buffer, sector, nsectors);
+            }
+
+          psi_stall_leave(PSI_IO);
 
           if (nsectorswritten == nsectors)
             {
@@ -778,6 +1040,55 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwreaddirect/fat_hwwritedirect
+ *
+ * Description:
+ *   Transfer the sectors without keeping them in the block cache, used for
+ *   the O_DIRECT accesses.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_BLKCACHE
+int fat_hwreaddirect(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                     off_t sector, unsigned int nsectors)
+{
+  ssize_t ret;
+
+  if (fs->fs_blkcache == NULL)
+    {
+      return fat_hwread(fs, buffer, sector, nsectors);
+    }
+
+  ret = blkcache_readdirect(fs->fs_blkcache, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ret == nsectors ? OK : -ENODEV;
+}
+
+int fat_hwwritedirect(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                      off_t sector, unsigned int nsectors)
+{
+  ssize_t ret;
+
+  if (fs->fs_blkcache == NULL)
+    {
+      return fat_hwwrite(fs, buffer, sector, nsectors);
+    }
+
+  ret = blkcache_writedirect(fs->fs_blkcache, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ret == nsectors ? OK : -ENODEV;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -1102,6 +1413,9 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
       /* Mark the modified sector as "dirty" and return success */
 
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemapset(fs, clusterno, nextcluster != 0);
+#endif
       fs->fs_dirty = true;
       return OK;
     }
@@ -1226,66 +1540,18 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
-
-  newcluster = startcluster;
-  for (; ; )
+  ret = fat_findfreecluster(fs, cluster, startcluster);
+  if (ret <= 0)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
+      /* An error occurred or there is no free cluster */
 
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = ret;
+
+  /* We have an available cluster number in 'newcluster'.  Now mark that
+   * cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -2206,3 +2472,186 @@ int fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff,
 
   return -ENOSPC;
 }
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Scan the FAT once and build the bitmap of the allocated clusters.  The
+ *   free cluster count is updated on the way.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  fat_freemaprelease(fs);
+
+  fs->fs_freemap = fs_heap_zalloc(((fs->fs_nclusters + 31) >> 5) *
+                                  sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fat_freemaprelease(fs);
+          return next;
+        }
+      else if (next != 0)
+        {
+          fat_freemapset(fs, cluster, true);
+        }
+      else
+        {
+          nfreeclusters++;
+        }
+    }
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemaprelease
+ ****************************************************************************/
+
+void fat_freemaprelease(FAR struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      fs_heap_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extentlookup
+ *
+ * Description:
+ *   Find the cached cluster of the file closest to, but not after, the
+ *   file cluster index.
+ *
+ * Returned Value:
+ *   The file cluster index of the cluster returned in *cluster.  Zero with
+ *   *cluster == 0 if nothing is cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+uint32_t fat_extentlookup(FAR struct fat_file_s *ff, uint32_t index,
+                          FAR uint32_t *cluster)
+{
+  FAR struct fat_extent_s *fe;
+  uint32_t best = 0;
+  int i;
+
+  *cluster = 0;
+  for (i = 0; i < CONFIG_FAT_EXTENTCACHE_SIZE; i++)
+    {
+      fe = &ff->ff_extents[i];
+      if (fe->fe_count == 0 || fe->fe_index > index)
+        {
+          continue;
+        }
+
+      if (index < fe->fe_index + fe->fe_count)
+        {
+          *cluster = fe->fe_cluster + (index - fe->fe_index);
+          return index;
+        }
+
+      if (*cluster == 0 || fe->fe_index + fe->fe_count - 1 > best)
+        {
+          best     = fe->fe_index + fe->fe_count - 1;
+          *cluster = fe->fe_cluster + fe->fe_count - 1;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Remember that the file cluster index is held by cluster.  prevcluster
+ *   holds the file cluster index - 1 (ignored for index 0), it is used to
+ *   start a new run.  When the cache is full the shortest run is replaced.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                   uint32_t cluster, uint32_t prevcluster)
+{
+  FAR struct fat_extent_s *victim = NULL;
+  FAR struct fat_extent_s *fe;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_EXTENTCACHE_SIZE; i++)
+    {
+      fe = &ff->ff_extents[i];
+      if (fe->fe_count == 0)
+        {
+          if (victim == NULL || victim->fe_count != 0)
+            {
+              victim = fe;
+            }
+
+          continue;
+        }
+
+      if (index >= fe->fe_index && index < fe->fe_index + fe->fe_count)
+        {
+          /* Already cached */
+
+          return;
+        }
+
+      if (fe->fe_index + fe->fe_count == index &&
+          fe->fe_cluster + fe->fe_count == cluster)
+        {
+          /* Grow the run */
+
+          fe->fe_count++;
+          return;
+        }
+
+      if (victim == NULL ||
+          (victim->fe_count != 0 && fe->fe_count < victim->fe_count))
+        {
+          victim = fe;
+        }
+    }
+
+  if (index > 0 && prevcluster + 1 == cluster)
+    {
+      victim->fe_index   = index - 1;
+      victim->fe_cluster = prevcluster;
+      victim->fe_count   = 2;
+    }
+  else
+    {
+      victim->fe_index   = index;
+      victim->fe_cluster = cluster;
+      victim->fe_count   = 1;
+    }
+}
+#endif
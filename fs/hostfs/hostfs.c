@@ -62,7 +62,14 @@
 struct hostfs_dir_s
 {
   struct fs_dirent_s base;
-  FAR void *dir;
+  FAR void *dir;             /* Host directory, NULL if served from cache */
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  FAR char *relpath;         /* Key of the listing in the directory cache */
+  FAR char *list;            /* Listing being served or being collected */
+  size_t listlen;
+  size_t listpos;
+  bool building;             /* Collecting the listing for the cache */
+#endif
 };
 
 /****************************************************************************
@@ -240,6 +247,63 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+/****************************************************************************
+ * Name: hostfs_dir_append
+ *
+ * Description:
+ *   Append an entry read from the host to the listing being collected for
+ *   the directory cache.  The listing is abandoned if memory runs out.
+ *
+ ****************************************************************************/
+
+static void hostfs_dir_append(FAR struct hostfs_dir_s *hdir,
+                              FAR const struct dirent *entry)
+{
+  size_t namelen = strlen(entry->d_name) + 1;
+  FAR char *list;
+
+  list = fs_heap_realloc(hdir->list, hdir->listlen + 1 + namelen);
+  if (list == NULL)
+    {
+      fs_heap_free(hdir->list);
+      hdir->list     = NULL;
+      hdir->building = false;
+      return;
+    }
+
+  list[hdir->listlen] = entry->d_type;
+  memcpy(&list[hdir->listlen + 1], entry->d_name, namelen);
+  hdir->list     = list;
+  hdir->listlen += 1 + namelen;
+}
+
+/****************************************************************************
+ * Name: hostfs_dir_next
+ *
+ * Description:
+ *   Return the next entry of a listing served from the directory cache.
+ *
+ ****************************************************************************/
+
+static int hostfs_dir_next(FAR struct hostfs_dir_s *hdir,
+                           FAR struct dirent *entry)
+{
+  FAR const char *name;
+
+  if (hdir->listpos >= hdir->listlen)
+    {
+      return -ENOENT;
+    }
+
+  entry->d_type = hdir->list[hdir->listpos];
+  name = &hdir->list[hdir->listpos + 1];
+  strlcpy(entry->d_name, name, sizeof(entry->d_name));
+  hdir->listpos += 1 + strlen(name) + 1;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -333,6 +397,17 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   memcpy(hf->relpath, relpath, len + 1);
   fs->fs_head = hf;
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  /* Creating or truncating a file changes what the caches have seen */
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_cache_invalidate(fs);
+    }
+
+  hostfs_cache_open(fs, hf);
+#endif
+
   ret = OK;
   goto errout_with_lock;
 
@@ -472,7 +547,17 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = host_read(hf->fd, buffer, buflen);
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  if (hf->cached)
+    {
+      ret = hostfs_cache_read(fs, hf, buffer, filep->f_pos, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_read(hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -524,6 +609,10 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_changed(fs, hf);
+#endif
+
   ret = host_write(hf->fd, buffer, buflen);
   if (ret > 0)
     {
@@ -568,6 +657,15 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  ret = hostfs_cache_sync(hf, filep->f_pos);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
   if (ret >= 0)
     {
@@ -611,6 +709,15 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  ret = hostfs_cache_sync(hf, filep->f_pos);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   ret = host_ioctl(hf->fd, cmd, arg);
   if (ret < 0)
     {
@@ -673,6 +780,12 @@ static int hostfs_sync(FAR struct file *filep)
 
   host_sync(hf->fd);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  /* Drop all caches of the mount to pick up changes of the host */
+
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return OK;
 }
@@ -795,6 +908,10 @@ static int hostfs_fchstat(FAR const struct file *filep,
 
   ret = host_fchstat(hf->fd, buf, flags);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_changed(fs, hf);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -836,6 +953,10 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   ret = host_ftruncate(hf->fd, length);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_changed(fs, hf);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -876,6 +997,24 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_hdir;
     }
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  /* Serve the listing from the directory cache if it is still valid */
+
+  ret = hostfs_cache_getdir(fs, relpath, &hdir->list, &hdir->listlen);
+  if (ret >= 0)
+    {
+      *dir = (FAR struct fs_dirent_s *)hdir;
+      nxmutex_unlock(&g_lock);
+      return OK;
+    }
+
+  if (fs->fs_cache != NULL)
+    {
+      hdir->relpath  = fs_heap_strdup(relpath);
+      hdir->building = hdir->relpath != NULL;
+    }
+#endif
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -897,6 +1036,9 @@ errout_with_lock:
   nxmutex_unlock(&g_lock);
 
 errout_with_hdir:
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  fs_heap_free(hdir->relpath);
+#endif
   fs_heap_free(hdir);
   return ret;
 }
@@ -932,9 +1074,16 @@ static int hostfs_closedir(FAR struct inode *mountpt,
 
   /* Call the host's closedir function */
 
-  host_closedir(hdir->dir);
+  if (hdir->dir != NULL)
+    {
+      host_closedir(hdir->dir);
+    }
 
   nxmutex_unlock(&g_lock);
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  fs_heap_free(hdir->relpath);
+  fs_heap_free(hdir->list);
+#endif
   fs_heap_free(hdir);
   return OK;
 }
@@ -969,10 +1118,38 @@ static int hostfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  if (hdir->dir == NULL)
+    {
+      ret = hostfs_dir_next(hdir, entry);
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host OS's readdir function */
 
   ret = host_readdir(hdir->dir, entry);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  /* Collect the listing, and hand it to the cache once it is complete */
+
+  if (hdir->building)
+    {
+      if (ret >= 0)
+        {
+          hostfs_dir_append(hdir, entry);
+        }
+      else if (ret == -ENOENT)
+        {
+          hostfs_cache_setdir(mountpt->i_private, hdir->relpath,
+                              hdir->list, hdir->listlen);
+          hdir->list     = NULL;
+          hdir->building = false;
+        }
+    }
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1006,6 +1183,22 @@ static int hostfs_rewinddir(FAR struct inode *mountpt,
       return ret;
     }
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  if (hdir->dir == NULL)
+    {
+      hdir->listpos = 0;
+      nxmutex_unlock(&g_lock);
+      return OK;
+    }
+
+  /* Start collecting the listing again */
+
+  fs_heap_free(hdir->list);
+  hdir->list     = NULL;
+  hdir->listlen  = 0;
+  hdir->building = hdir->relpath != NULL;
+#endif
+
   /* Call the host and let it do all the work */
 
   host_rewinddir(hdir->dir);
@@ -1032,6 +1225,7 @@ static int hostfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   FAR char *options;
   FAR char *saveptr;
   FAR char *ptr;
+  bool nocache = false;
   int len;
   int ret;
 
@@ -1054,6 +1248,7 @@ static int hostfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   /* The options we support are:
    *  "fs=whatever", remote dir
+   *  "nocache", bypass the attribute, directory and block caches
    */
 
   options = fs_heap_strdup(data);
@@ -1070,17 +1265,38 @@ static int hostfs_bind(FAR struct inode *blkdriver, FAR const void *data,
         {
           strlcpy(fs->fs_root, &ptr[3], sizeof(fs->fs_root));
         }
+      else if (strcmp(ptr, "nocache") == 0)
+        {
+          nocache = true;
+        }
 
       ptr = strtok_r(NULL, ",", &saveptr);
     }
 
   fs_heap_free(options);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  if (!nocache)
+    {
+      ret = hostfs_cache_init(fs);
+      if (ret < 0)
+        {
+          fs_heap_free(fs);
+          return ret;
+        }
+    }
+#else
+  UNUSED(nocache);
+#endif
+
   /* Take the lock for the mount */
 
   ret = nxmutex_lock(&g_lock);
   if (ret < 0)
     {
+#ifdef CONFIG_FS_HOSTFS_CACHE
+      hostfs_cache_uninit(fs);
+#endif
       fs_heap_free(fs);
       return ret;
     }
@@ -1155,6 +1371,9 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
     }
 
   nxmutex_unlock(&g_lock);
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_uninit(fs);
+#endif
   fs_heap_free(fs);
   return ret;
 }
@@ -1229,6 +1448,10 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   ret = host_unlink(path);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1269,6 +1492,10 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_mkdir(path, mode);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1310,6 +1537,10 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   ret = host_rmdir(path);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1354,6 +1585,10 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   ret = host_rename(oldpath, newpath);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1386,6 +1621,15 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  ret = hostfs_cache_getattr(fs, relpath, buf);
+  if (ret != -EAGAIN)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -1394,6 +1638,10 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_stat(path, buf);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_setattr(fs, relpath, buf, ret);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1434,6 +1682,10 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_chstat(path, buf, flags);
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  hostfs_cache_invalidate(fs);
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
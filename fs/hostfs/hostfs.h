@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -53,6 +54,13 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  dev_t                     dev;     /* Host identity of the file, valid */
+  ino_t                     ino;     /* if ino is not zero */
+  struct timespec           mtime;   /* Host modification time at open */
+  bool                      cached;  /* Reads go through the block cache */
+  bool                      seek;    /* Host position lags behind f_pos */
+#endif
   char                      relpath[1];
 };
 
@@ -65,6 +73,9 @@ struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
   char                       fs_root[HOSTFS_MAX_PATH];
+#ifdef CONFIG_FS_HOSTFS_CACHE
+  FAR struct hostfs_cache_s *fs_cache;     /* NULL if mounted with nocache */
+#endif
 };
 
 /****************************************************************************
@@ -81,4 +92,33 @@ struct fs_dirent_s;
 struct statfs;
 struct stat;
 
+#ifdef CONFIG_FS_HOSTFS_CACHE
+/* The caches of one mount, see hostfs_cache.c.  All the functions below
+ * are called with the hostfs lock held.
+ */
+
+int     hostfs_cache_init(FAR struct hostfs_mountpt_s *fs);
+void    hostfs_cache_uninit(FAR struct hostfs_mountpt_s *fs);
+void    hostfs_cache_invalidate(FAR struct hostfs_mountpt_s *fs);
+void    hostfs_cache_changed(FAR struct hostfs_mountpt_s *fs,
+                             FAR struct hostfs_ofile_s *hf);
+int     hostfs_cache_getattr(FAR struct hostfs_mountpt_s *fs,
+                             FAR const char *relpath, FAR struct stat *buf);
+void    hostfs_cache_setattr(FAR struct hostfs_mountpt_s *fs,
+                             FAR const char *relpath,
+                             FAR const struct stat *buf, int result);
+int     hostfs_cache_getdir(FAR struct hostfs_mountpt_s *fs,
+                            FAR const char *relpath, FAR char **list,
+                            FAR size_t *len);
+void    hostfs_cache_setdir(FAR struct hostfs_mountpt_s *fs,
+                            FAR const char *relpath, FAR char *list,
+                            size_t len);
+void    hostfs_cache_open(FAR struct hostfs_mountpt_s *fs,
+                          FAR struct hostfs_ofile_s *hf);
+ssize_t hostfs_cache_read(FAR struct hostfs_mountpt_s *fs,
+                          FAR struct hostfs_ofile_s *hf, FAR char *buffer,
+                          off_t pos, size_t buflen);
+int     hostfs_cache_sync(FAR struct hostfs_ofile_s *hf, off_t pos);
+#endif
+
 #endif /* __FS_HOSTFS_HOSTFS_H */
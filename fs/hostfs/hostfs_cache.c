@@ -0,0 +1,625 @@
+/****************************************************************************
+ * fs/hostfs/hostfs_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/hostfs.h>
+
+#include "hostfs.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HOSTFS_CACHE_TICKS   MSEC2TICK(CONFIG_FS_HOSTFS_CACHE_TIMEOUT)
+#define HOSTFS_BLOCK_SIZE    CONFIG_FS_HOSTFS_BLOCK_SIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One stat() result, negative results are kept as well */
+
+struct hostfs_attr_s
+{
+  FAR char       *path;    /* Relative path, NULL if the slot is free */
+  clock_t         time;    /* When the entry was filled */
+  int             result;  /* OK or the negated errno of the host */
+  struct stat     buf;
+};
+
+/* One complete directory listing, packed as d_type[1] d_name[] '\0' */
+
+struct hostfs_dirlist_s
+{
+  FAR char       *path;    /* Relative path, NULL if the slot is free */
+  clock_t         time;    /* When the listing was completed */
+  FAR char       *list;
+  size_t          len;
+};
+
+/* One data block of a host file */
+
+struct hostfs_block_s
+{
+  dev_t           dev;     /* Host identity of the file */
+  ino_t           ino;     /* Zero if the slot is free */
+  struct timespec mtime;   /* Host modification time of the data */
+  off_t           blkno;
+  size_t          len;     /* Number of valid bytes */
+  uint32_t        lru;     /* Last use stamp */
+  FAR char       *data;
+};
+
+struct hostfs_cache_s
+{
+  struct hostfs_attr_s    attr[CONFIG_FS_HOSTFS_ATTR_CACHE];
+  struct hostfs_dirlist_s dirs[CONFIG_FS_HOSTFS_DIR_CACHE];
+  struct hostfs_block_s   blocks[CONFIG_FS_HOSTFS_BLOCK_CACHE];
+  uint32_t                stamp;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hostfs_cache_expired
+ ****************************************************************************/
+
+static bool hostfs_cache_expired(clock_t time)
+{
+  return clock_systime_ticks() - time >= HOSTFS_CACHE_TICKS;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_dropattr
+ ****************************************************************************/
+
+static void hostfs_cache_dropattr(FAR struct hostfs_cache_s *cache)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTR_CACHE; i++)
+    {
+      fs_heap_free(cache->attr[i].path);
+      cache->attr[i].path = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_dropdirs
+ ****************************************************************************/
+
+static void hostfs_cache_dropdirs(FAR struct hostfs_cache_s *cache)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_DIR_CACHE; i++)
+    {
+      fs_heap_free(cache->dirs[i].path);
+      fs_heap_free(cache->dirs[i].list);
+      cache->dirs[i].path = NULL;
+      cache->dirs[i].list = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_dropblocks
+ *
+ * Description:
+ *   Drop the blocks of one host file, or of all files if hf is NULL.
+ *
+ ****************************************************************************/
+
+static void hostfs_cache_dropblocks(FAR struct hostfs_cache_s *cache,
+                                    FAR struct hostfs_ofile_s *hf)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_BLOCK_CACHE; i++)
+    {
+      FAR struct hostfs_block_s *blk = &cache->blocks[i];
+
+      if (hf == NULL || (blk->ino == hf->ino && blk->dev == hf->dev))
+        {
+          blk->ino = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_getblock
+ *
+ * Description:
+ *   Find a data block of the file, reading it from the host on a miss.
+ *
+ ****************************************************************************/
+
+static int hostfs_cache_getblock(FAR struct hostfs_cache_s *cache,
+                                 FAR struct hostfs_ofile_s *hf,
+                                 off_t blkno,
+                                 FAR struct hostfs_block_s **blkp)
+{
+  FAR struct hostfs_block_s *victim = NULL;
+  FAR struct hostfs_block_s *blk;
+  ssize_t ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_BLOCK_CACHE; i++)
+    {
+      blk = &cache->blocks[i];
+      if (blk->ino == hf->ino && blk->dev == hf->dev &&
+          blk->blkno == blkno &&
+          blk->mtime.tv_sec == hf->mtime.tv_sec &&
+          blk->mtime.tv_nsec == hf->mtime.tv_nsec)
+        {
+          blk->lru = ++cache->stamp;
+          *blkp = blk;
+          return OK;
+        }
+
+      if (victim == NULL || blk->ino == 0 ||
+          (victim->ino != 0 && blk->lru < victim->lru))
+        {
+          victim = blk;
+        }
+    }
+
+  /* Miss, replace the least recently used block */
+
+  victim->ino = 0;
+  hf->seek    = true;
+
+  ret = host_lseek(hf->fd, 0, blkno * HOSTFS_BLOCK_SIZE, SEEK_SET);
+  if (ret >= 0)
+    {
+      ret = host_read(hf->fd, victim->data, HOSTFS_BLOCK_SIZE);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  victim->dev   = hf->dev;
+  victim->ino   = hf->ino;
+  victim->mtime = hf->mtime;
+  victim->blkno = blkno;
+  victim->len   = ret;
+  victim->lru   = ++cache->stamp;
+  *blkp = victim;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hostfs_cache_init
+ ****************************************************************************/
+
+int hostfs_cache_init(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_cache_s *cache;
+  FAR char *data;
+  int i;
+
+  cache = fs_heap_zalloc(sizeof(*cache));
+  if (cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  data = fs_heap_malloc(CONFIG_FS_HOSTFS_BLOCK_CACHE * HOSTFS_BLOCK_SIZE);
+  if (data == NULL)
+    {
+      fs_heap_free(cache);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_BLOCK_CACHE; i++)
+    {
+      cache->blocks[i].data = data + i * HOSTFS_BLOCK_SIZE;
+    }
+
+  fs->fs_cache = cache;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_uninit
+ ****************************************************************************/
+
+void hostfs_cache_uninit(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+
+  if (cache != NULL)
+    {
+      hostfs_cache_dropattr(cache);
+      hostfs_cache_dropdirs(cache);
+      fs_heap_free(cache->blocks[0].data);
+      fs_heap_free(cache);
+      fs->fs_cache = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_invalidate
+ *
+ * Description:
+ *   Drop everything, called after a change of the name space and by
+ *   fsync() to pick up changes made on the host side.
+ *
+ ****************************************************************************/
+
+void hostfs_cache_invalidate(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+
+  if (cache != NULL)
+    {
+      hostfs_cache_dropattr(cache);
+      hostfs_cache_dropdirs(cache);
+      hostfs_cache_dropblocks(cache, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_changed
+ *
+ * Description:
+ *   The data or the attributes of an open file were changed: drop the
+ *   cached attributes and the blocks of the file.
+ *
+ ****************************************************************************/
+
+void hostfs_cache_changed(FAR struct hostfs_mountpt_s *fs,
+                          FAR struct hostfs_ofile_s *hf)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+
+  if (cache != NULL)
+    {
+      hostfs_cache_dropattr(cache);
+      hostfs_cache_dropblocks(cache, hf->ino != 0 ? hf : NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_getattr
+ *
+ * Returned Value:
+ *   The cached result of stat() for relpath, or -EAGAIN on a miss.
+ *
+ ****************************************************************************/
+
+int hostfs_cache_getattr(FAR struct hostfs_mountpt_s *fs,
+                         FAR const char *relpath, FAR struct stat *buf)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+  int i;
+
+  if (cache == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTR_CACHE; i++)
+    {
+      FAR struct hostfs_attr_s *attr = &cache->attr[i];
+
+      if (attr->path != NULL && strcmp(attr->path, relpath) == 0)
+        {
+          if (hostfs_cache_expired(attr->time))
+            {
+              break;
+            }
+
+          if (attr->result >= 0)
+            {
+              memcpy(buf, &attr->buf, sizeof(*buf));
+            }
+
+          return attr->result;
+        }
+    }
+
+  return -EAGAIN;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_setattr
+ ****************************************************************************/
+
+void hostfs_cache_setattr(FAR struct hostfs_mountpt_s *fs,
+                          FAR const char *relpath,
+                          FAR const struct stat *buf, int result)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+  FAR struct hostfs_attr_s *victim = NULL;
+  int i;
+
+  if (cache == NULL || (result < 0 && result != -ENOENT))
+    {
+      return;
+    }
+
+  /* Reuse the entry of the same path, a free one or the oldest one */
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTR_CACHE; i++)
+    {
+      FAR struct hostfs_attr_s *attr = &cache->attr[i];
+
+      if (attr->path != NULL && strcmp(attr->path, relpath) == 0)
+        {
+          victim = attr;
+          break;
+        }
+
+      if (victim == NULL || attr->path == NULL ||
+          (victim->path != NULL && attr->time < victim->time))
+        {
+          victim = attr;
+        }
+    }
+
+  if (victim->path == NULL || strcmp(victim->path, relpath) != 0)
+    {
+      fs_heap_free(victim->path);
+      victim->path = fs_heap_strdup(relpath);
+      if (victim->path == NULL)
+        {
+          return;
+        }
+    }
+
+  victim->time   = clock_systime_ticks();
+  victim->result = result;
+  if (result >= 0)
+    {
+      memcpy(&victim->buf, buf, sizeof(*buf));
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_getdir
+ *
+ * Description:
+ *   Return a private copy of the cached listing of relpath.
+ *
+ ****************************************************************************/
+
+int hostfs_cache_getdir(FAR struct hostfs_mountpt_s *fs,
+                        FAR const char *relpath, FAR char **list,
+                        FAR size_t *len)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+  int i;
+
+  if (cache == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_DIR_CACHE; i++)
+    {
+      FAR struct hostfs_dirlist_s *dir = &cache->dirs[i];
+
+      if (dir->path != NULL && strcmp(dir->path, relpath) == 0)
+        {
+          if (hostfs_cache_expired(dir->time))
+            {
+              break;
+            }
+
+          *list = fs_heap_malloc(dir->len + 1);
+          if (*list == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          memcpy(*list, dir->list, dir->len);
+          *len = dir->len;
+          return OK;
+        }
+    }
+
+  return -EAGAIN;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_setdir
+ *
+ * Description:
+ *   Keep a complete listing of relpath, the cache takes over the list.
+ *
+ ****************************************************************************/
+
+void hostfs_cache_setdir(FAR struct hostfs_mountpt_s *fs,
+                         FAR const char *relpath, FAR char *list,
+                         size_t len)
+{
+  FAR struct hostfs_cache_s *cache = fs->fs_cache;
+  FAR struct hostfs_dirlist_s *victim = NULL;
+  int i;
+
+  if (cache == NULL)
+    {
+      fs_heap_free(list);
+      return;
+    }
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_DIR_CACHE; i++)
+    {
+      FAR struct hostfs_dirlist_s *dir = &cache->dirs[i];
+
+      if (dir->path != NULL && strcmp(dir->path, relpath) == 0)
+        {
+          victim = dir;
+          break;
+        }
+
+      if (victim == NULL || dir->path == NULL ||
+          (victim->path != NULL && dir->time < victim->time))
+        {
+          victim = dir;
+        }
+    }
+
+  fs_heap_free(victim->path);
+  fs_heap_free(victim->list);
+  victim->list = NULL;
+  victim->path = fs_heap_strdup(relpath);
+  if (victim->path == NULL)
+    {
+      fs_heap_free(list);
+      return;
+    }
+
+  victim->list = list;
+  victim->len  = len;
+  victim->time = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_open
+ *
+ * Description:
+ *   Record the host identity of a newly opened regular file.  Read-only
+ *   files are then read through the block cache.
+ *
+ ****************************************************************************/
+
+void hostfs_cache_open(FAR struct hostfs_mountpt_s *fs,
+                       FAR struct hostfs_ofile_s *hf)
+{
+  struct stat buf;
+
+  hf->ino    = 0;
+  hf->cached = false;
+  hf->seek   = false;
+
+  if (fs->fs_cache == NULL || host_fstat(hf->fd, &buf) < 0 ||
+      !S_ISREG(buf.st_mode) || buf.st_ino == 0)
+    {
+      return;
+    }
+
+  hf->dev    = buf.st_dev;
+  hf->ino    = buf.st_ino;
+  hf->mtime  = buf.st_mtim;
+  hf->cached = (hf->oflags & O_ACCMODE) == O_RDONLY;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_read
+ *
+ * Description:
+ *   Read from pos through the block cache.  The host file position is
+ *   left behind, hostfs_cache_sync() fixes it before it is needed.
+ *
+ ****************************************************************************/
+
+ssize_t hostfs_cache_read(FAR struct hostfs_mountpt_s *fs,
+                          FAR struct hostfs_ofile_s *hf, FAR char *buffer,
+                          off_t pos, size_t buflen)
+{
+  FAR struct hostfs_block_s *blk;
+  ssize_t nread = 0;
+  size_t offset;
+  size_t n;
+  int ret = OK;
+
+  while (buflen > 0)
+    {
+      ret = hostfs_cache_getblock(fs->fs_cache, hf,
+                                  pos / HOSTFS_BLOCK_SIZE, &blk);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      offset = pos % HOSTFS_BLOCK_SIZE;
+      if (offset >= blk->len)
+        {
+          break;
+        }
+
+      n = MIN(buflen, blk->len - offset);
+      memcpy(buffer, blk->data + offset, n);
+      nread  += n;
+      pos    += n;
+      buffer += n;
+      buflen -= n;
+
+      if (blk->len < HOSTFS_BLOCK_SIZE)
+        {
+          break;
+        }
+    }
+
+  hf->seek = true;
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_cache_sync
+ *
+ * Description:
+ *   Move the host file position to pos if cached reads left it behind.
+ *
+ ****************************************************************************/
+
+int hostfs_cache_sync(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (!hf->seek)
+    {
+      return OK;
+    }
+
+  ret = host_lseek(hf->fd, pos, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hf->seek = false;
+  return OK;
+}
@@ -41,6 +41,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/rcu.h>
 #include <nuttx/sched.h>
 #include <nuttx/spawn.h>
 #include <nuttx/spinlock.h>
@@ -70,11 +71,27 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
                                             int l1, int l2, FAR bool *new)
 {
   FAR struct file *filep;
+#ifdef CONFIG_RCU
+  FAR struct file **files;
+
+  /* The rows never move, only the array of the row pointers is replaced
+   * by files_extend().  Order the load of fl_rows done by the caller to
+   * check the descriptor before the load of fl_files, files_extend()
+   * publishes them in the opposite order.
+   */
+
+  rcu_read_lock();
+  UP_DMB();
+  files = rcu_dereference(list->fl_files);
+  filep = &files[l1][l2];
+  rcu_read_unlock();
+#else
   irqstate_t flags;
 
   flags = spin_lock_irqsave_notrace(&list->fl_lock);
   filep = &list->fl_files[l1][l2];
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
+#endif
 
 #ifdef CONFIG_FS_REFCOUNT
   if (filep->f_inode != NULL)
@@ -192,13 +209,27 @@ static int files_extend(FAR struct filelist *list, size_t row)
     }
 
   tmp = list->fl_files;
+#ifdef CONFIG_RCU
+  /* Lockless readers check the descriptor against fl_rows and then load
+   * fl_files, publish the larger array first.
+   */
+
+  rcu_assign_pointer(list->fl_files, files);
+  UP_DMB();
+#else
   list->fl_files = files;
+#endif
   list->fl_rows = row;
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
 
   if (tmp != NULL && tmp != &list->fl_prefile)
     {
+#ifdef CONFIG_RCU
+      /* Wait for the readers that may still use the old array */
+
+      synchronize_rcu();
+#endif
       fs_heap_free(tmp);
     }
 
@@ -600,6 +631,10 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
 #ifdef CONFIG_FDCHECK
               filep->f_tag_fdcheck = 0;
 #endif
+#ifdef CONFIG_FS_READAHEAD
+              filep->f_ranext      = pos;
+              filep->f_rawin       = 0;
+#endif
 
               goto found;
             }
@@ -0,0 +1,215 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_MASK (CONFIG_FS_INODE_CACHE_ENTRIES - 1)
+
+#if (CONFIG_FS_INODE_CACHE_ENTRIES & INODE_CACHE_MASK) != 0
+#  error CONFIG_FS_INODE_CACHE_ENTRIES must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached _inode_search() result.  The path and relpath of the result
+ * are kept as offsets into the searched path.
+ */
+
+struct inode_cache_s
+{
+  uint32_t          gen;     /* Tree generation, 0: unused entry */
+  uint32_t          hash;    /* Hash of the path */
+  FAR struct inode *node;    /* The search result */
+  FAR struct inode *peer;
+  FAR struct inode *parent;
+  int16_t           ret;     /* OK or -ENOENT (negative entry) */
+  int16_t           pathoff; /* Offset of the remaining path */
+  int16_t           reloff;  /* Offset of relpath, -1: NULL */
+  uint16_t          len;     /* Length of the path */
+  char              path[CONFIG_FS_INODE_CACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_ENTRIES];
+static spinlock_t g_inode_cache_lock = SP_UNLOCKED;
+
+/* Bumped whenever the inode tree changes, the entries of an older
+ * generation are stale.
+ */
+
+static uint32_t g_inode_cache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*path++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the first len bytes of path in the cache and fill the search
+ *   result on a hit.
+ *
+ * Returned Value:
+ *   true on hit, the search return value is returned in ret.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc,
+                        FAR const char *path, size_t len, FAR int *ret)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  bool hit = false;
+
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  hash  = inode_cache_hash(path, len);
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  if (entry->gen == g_inode_cache_gen && entry->hash == hash &&
+      entry->len == len && memcmp(entry->path, path, len) == 0)
+    {
+      desc->path    = path + entry->pathoff;
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->relpath = entry->reloff < 0 ? NULL : path + entry->reloff;
+      *ret          = entry->ret;
+      hit           = true;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the search result of the first len bytes of path, the path
+ *   and relpath of the result must point into path.
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const struct inode_search_s *desc,
+                        FAR const char *path, size_t len, int ret)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN || (ret != OK && ret != -ENOENT))
+    {
+      return;
+    }
+
+  hash  = inode_cache_hash(path, len);
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  entry->gen     = g_inode_cache_gen;
+  entry->hash    = hash;
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->ret     = ret;
+  entry->pathoff = desc->path - path;
+  entry->reloff  = desc->relpath == NULL ? -1 : desc->relpath - path;
+  entry->len     = len;
+  memcpy(entry->path, path, len);
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all the cached entries.  Called with the inode tree write locked
+ *   after any change of the tree.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  if (++g_inode_cache_gen == 0)
+    {
+      g_inode_cache_gen = 1;
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -49,6 +49,9 @@ static int _inode_linktarget(FAR struct inode *inode,
 #endif
 static int _inode_search(FAR struct inode_search_s *desc);
 static FAR const char *_inode_getcwd(void);
+#ifdef CONFIG_FS_INODE_CACHE
+static FAR const char *_inode_lastname(FAR const char *path, size_t len);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -193,6 +196,36 @@ static int _inode_linktarget(FAR struct inode *inode,
 }
 #endif
 
+/****************************************************************************
+ * Name: _inode_lastname
+ *
+ * Description:
+ *   Return the last path segment of 'path' if the path up to that segment
+ *   names its parent directory in the cache, i.e. the segment follows a
+ *   single '/' and the segment before it is not '.'.  Otherwise NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+static FAR const char *_inode_lastname(FAR const char *path, size_t len)
+{
+  FAR const char *last = path + len;
+
+  while (last > path && *(last - 1) != '/')
+    {
+      last--;
+    }
+
+  if (last == path + len || last - path < 2 || *(last - 2) == '/' ||
+      (*(last - 2) == '.' && (last - path < 3 || *(last - 3) == '/')))
+    {
+      return NULL;
+    }
+
+  return last;
+}
+#endif
+
 /****************************************************************************
  * Name: _inode_search
  *
@@ -221,6 +254,15 @@ static int _inode_search(FAR struct inode_search_s *desc)
   FAR struct inode *left    = NULL;
   FAR struct inode *above   = NULL;
   FAR const char   *relpath = NULL;
+#ifdef CONFIG_FS_INODE_CACHE
+  struct inode_search_s dir;
+  FAR const char   *start   = desc->path;
+  FAR const char   *dirname = NULL;
+  FAR const char   *last;
+  bool              cacheable = true;
+  size_t            len;
+  int               dirret;
+#endif
   int ret = -ENOENT;
 
   /* Get the search path, skipping over the leading '/'.  The leading '/' is
@@ -235,6 +277,44 @@ static int _inode_search(FAR struct inode_search_s *desc)
       return -EINVAL;
     }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Try the whole path first, then start below the cached parent
+   * directory of the last segment.
+   */
+
+  len = strlen(start);
+  if (inode_cache_lookup(desc, start, len, &ret))
+    {
+      return ret;
+    }
+
+  last = _inode_lastname(start, len);
+  if (last != NULL &&
+      inode_cache_lookup(&dir, start, last - start - 1, &dirret) &&
+      dirret == OK && dir.path == last - 1)
+    {
+      if (INODE_IS_MOUNTPT(dir.node))
+        {
+          /* The mountpoint absorbs the last segment */
+
+          inode   = dir.node;
+          left    = dir.peer;
+          above   = dir.parent;
+          name    = last;
+          relpath = last;
+          ret     = OK;
+          goto found;
+        }
+      else if (!INODE_IS_SOFTLINK(dir.node))
+        {
+          above   = dir.node;
+          inode   = dir.node->i_child;
+          name    = last;
+          dirname = last;
+        }
+    }
+#endif
+
   /* Traverse the pseudo file system node tree until either (1) all nodes
    * have been examined without finding the matching node, or (2) the
    * matching node is found.
@@ -306,6 +386,12 @@ static int _inode_search(FAR struct inode_search_s *desc)
                 {
                   int status;
 
+#ifdef CONFIG_FS_INODE_CACHE
+                  /* The result depends on the link target */
+
+                  cacheable = false;
+#endif
+
                   /* If this intermediate inode in the is a soft link, then
                    * (1) recursively look-up the inode referenced by the
                    * soft link, and (2) continue searching with that inode
@@ -384,6 +470,12 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
               /* Keep looking at the next level "down" */
 
+#ifdef CONFIG_FS_INODE_CACHE
+              dir.node   = inode;
+              dir.peer   = left;
+              dir.parent = above;
+              dirname    = name;
+#endif
               above = inode;
               left  = NULL;
               inode = inode->i_child;
@@ -407,11 +499,33 @@ static int _inode_search(FAR struct inode_search_s *desc)
    *   (4) When the node matching the full path is found
    */
 
+#ifdef CONFIG_FS_INODE_CACHE
+found:
+#endif
   desc->path    = name;
   desc->node    = inode;
   desc->peer    = left;
   desc->parent  = above;
   desc->relpath = relpath;
+
+#ifdef CONFIG_FS_INODE_CACHE
+  if (cacheable)
+    {
+      inode_cache_insert(desc, start, len, ret);
+
+      /* Also remember the parent directory of the last segment, the
+       * siblings of this path are found from there.
+       */
+
+      if (dirname != NULL && dirname == last)
+        {
+          dir.path    = last - 1;
+          dir.relpath = last - 1;
+          inode_cache_insert(&dir, start, last - start - 1, OK);
+        }
+    }
+#endif
+
   return ret;
 }
 
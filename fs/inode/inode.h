@@ -237,6 +237,26 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup/inode_cache_insert/inode_cache_invalidate
+ *
+ * Description:
+ *   The path lookup cache of inode_search().  inode_cache_invalidate()
+ *   must be called with the inode tree write locked after every change of
+ *   the tree: inode insertion or removal and mountpoint changes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc,
+                        FAR const char *path, size_t len, FAR int *ret);
+void inode_cache_insert(FAR const struct inode_search_s *desc,
+                        FAR const char *path, size_t len, int ret);
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
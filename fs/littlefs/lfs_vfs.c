@@ -28,13 +28,16 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/psi.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -52,6 +55,8 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+#define LITTLEFS_CBLOCK_NONE ((lfs_block_t)-1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,6 +73,20 @@ struct littlefs_file_s
   int                   refs;
 };
 
+/* One cache_size chunk of a block kept by the block cache.  littlefs only
+ * keeps a single read cache, so every lookup walks the metadata pairs on
+ * the device again, the block cache keeps the recently read chunks for all
+ * the open files and directories of the mountpoint.
+ */
+
+struct littlefs_cblock_s
+{
+  struct list_node      node;     /* LRU list, most recent first */
+  lfs_block_t           block;    /* LITTLEFS_CBLOCK_NONE: unused */
+  lfs_off_t             off;      /* Offset of the chunk in the block */
+  FAR uint8_t          *data;     /* cache_size bytes */
+};
+
 /* This structure represents the overall mountpoint state. An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a littlefs filesystem.
@@ -81,6 +100,9 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+  struct list_node      cblocks;  /* LRU list of the cached chunks */
+  FAR struct littlefs_cblock_s *cblock;
+  size_t                ncblocks;
 };
 
 /* NuttX specific file attributes.
@@ -1154,12 +1176,12 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: littlefs_read_block
+ * Name: littlefs_read_device
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_read_device(FAR const struct lfs_config *c,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1169,6 +1191,7 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  psi_stall_enter(PSI_IO);
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
@@ -1178,9 +1201,138 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
       ret = drv->u.i_bops->read(drv, buffer, block, size);
     }
 
+  psi_stall_leave(PSI_IO);
+
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_read_block
+ *
+ * Description: Read through the block cache.  The reads inside one
+ *  cache_size chunk are served from the cache, the chunk is loaded on a
+ *  miss replacing the least recently used one.  Larger reads go to the
+ *  device directly.
+ *
+ ****************************************************************************/
+
+static int littlefs_read_block(FAR const struct lfs_config *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  FAR struct littlefs_cblock_s *cb;
+  lfs_off_t coff;
+  int ret;
+
+  coff = off - off % c->cache_size;
+  if (fs->ncblocks == 0 || off + size > coff + c->cache_size)
+    {
+      return littlefs_read_device(c, block, off, buffer, size);
+    }
+
+  list_for_every_entry(&fs->cblocks, cb, struct littlefs_cblock_s, node)
+    {
+      if (cb->block == block && cb->off == coff)
+        {
+          goto hit;
+        }
+    }
+
+  cb = list_last_entry(&fs->cblocks, struct littlefs_cblock_s, node);
+  cb->block = LITTLEFS_CBLOCK_NONE;
+
+  ret = littlefs_read_device(c, block, coff, cb->data, c->cache_size);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  cb->block = block;
+  cb->off   = coff;
+
+hit:
+  list_delete(&cb->node);
+  list_add_head(&fs->cblocks, &cb->node);
+  memcpy(buffer, cb->data + off - coff, size);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_update
+ *
+ * Description: Keep the cached chunks in step with a program of the
+ *  device, or drop the chunks of an erased block (data == NULL).
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_update(FAR struct littlefs_mountpt_s *fs,
+                                  lfs_block_t block, lfs_off_t off,
+                                  FAR const uint8_t *data, lfs_size_t size)
+{
+  FAR struct littlefs_cblock_s *cb;
+  lfs_off_t start;
+  lfs_off_t end;
+
+  list_for_every_entry(&fs->cblocks, cb, struct littlefs_cblock_s, node)
+    {
+      if (cb->block != block)
+        {
+          continue;
+        }
+
+      if (data == NULL)
+        {
+          cb->block = LITTLEFS_CBLOCK_NONE;
+          continue;
+        }
+
+      start = lfs_max(off, cb->off);
+      end   = lfs_min(off + size, cb->off + fs->cfg.cache_size);
+      if (start < end)
+        {
+          memcpy(cb->data + start - cb->off, data + start - off,
+                 end - start);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_init
+ *
+ * Description: Allocate the block cache of the mountpoint.
+ *
+ ****************************************************************************/
+
+static int littlefs_cache_init(FAR struct littlefs_mountpt_s *fs)
+{
+  FAR uint8_t *data;
+  size_t i;
+
+  list_initialize(&fs->cblocks);
+  if (fs->ncblocks == 0)
+    {
+      return OK;
+    }
+
+  fs->cblock = fs_heap_malloc(fs->ncblocks *
+                              (sizeof(*fs->cblock) + fs->cfg.cache_size));
+  if (fs->cblock == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  data = (FAR uint8_t *)&fs->cblock[fs->ncblocks];
+  for (i = 0; i < fs->ncblocks; i++)
+    {
+      fs->cblock[i].block = LITTLEFS_CBLOCK_NONE;
+      fs->cblock[i].data  = data + i * fs->cfg.cache_size;
+      list_add_tail(&fs->cblocks, &fs->cblock[i].node);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_write_block
  ****************************************************************************/
@@ -1192,6 +1344,7 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
   FAR struct inode *drv = fs->drv;
+  off_t sector;
   int ret;
 
   if (fs->readonly)
@@ -1199,18 +1352,25 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
-  block = (block * c->block_size + off) / geo->blocksize;
-  size  = size / geo->blocksize;
+  sector = (block * c->block_size + off) / geo->blocksize;
 
+  psi_stall_enter(PSI_IO);
   if (INODE_IS_MTD(drv))
     {
-      ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
+      ret = MTD_BWRITE(drv->u.i_mtd, sector, size / geo->blocksize,
+                       buffer);
     }
   else
     {
-      ret = drv->u.i_bops->write(drv, buffer, block, size);
+      ret = drv->u.i_bops->write(drv, buffer, sector,
+                                 size / geo->blocksize);
     }
 
+  psi_stall_leave(PSI_IO);
+
+  /* A failed program leaves the chunks of the block unknown */
+
+  littlefs_cache_update(fs, block, off, ret >= 0 ? buffer : NULL, size);
   return ret >= 0 ? OK : ret;
 }
 
@@ -1230,6 +1390,8 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
+  littlefs_cache_update(fs, block, 0, NULL, 0);
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1276,6 +1438,118 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description: Parse the comma separated mount options.  Besides
+ *  forceformat, autoformat and ro the geometry of the mountpoint can be
+ *  tuned with read_size=, prog_size=, cache_size= and lookahead_size= (in
+ *  bytes) and block_cache= (number of cache_size chunks in the block
+ *  cache).  Unknown options are ignored.
+ *
+ ****************************************************************************/
+
+static int littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const char *data,
+                                  FAR bool *forceformat,
+                                  FAR bool *autoformat)
+{
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *value;
+  FAR char *ptr;
+  bool tuned = false;
+  lfs_size_t num;
+
+  *forceformat = false;
+  *autoformat  = false;
+  fs->ncblocks = CONFIG_FS_LITTLEFS_BLOCK_CACHE;
+
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = fs_heap_strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL)
+    {
+      value = strchr(ptr, '=');
+      if (value != NULL)
+        {
+          *value++ = '\0';
+          num = strtoul(value, NULL, 0);
+        }
+      else
+        {
+          num = 0;
+        }
+
+      if (strcmp(ptr, "forceformat") == 0)
+        {
+          *forceformat = true;
+        }
+      else if (strcmp(ptr, "autoformat") == 0)
+        {
+          *autoformat = true;
+        }
+      else if (strcmp(ptr, "ro") == 0)
+        {
+          fs->readonly = true;
+        }
+      else if (strcmp(ptr, "block_cache") == 0)
+        {
+          fs->ncblocks = num;
+        }
+      else if (strcmp(ptr, "read_size") == 0)
+        {
+          fs->cfg.read_size = num;
+          tuned = true;
+        }
+      else if (strcmp(ptr, "prog_size") == 0)
+        {
+          fs->cfg.prog_size = num;
+          tuned = true;
+        }
+      else if (strcmp(ptr, "cache_size") == 0)
+        {
+          fs->cfg.cache_size = num;
+          tuned = true;
+        }
+      else if (strcmp(ptr, "lookahead_size") == 0)
+        {
+          fs->cfg.lookahead_size = num;
+          tuned = true;
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  fs_heap_free(options);
+
+  /* littlefs only asserts on these, reject them here */
+
+  if (tuned &&
+      (fs->cfg.read_size == 0 || fs->cfg.prog_size == 0 ||
+       fs->cfg.cache_size == 0 || fs->cfg.lookahead_size == 0 ||
+       fs->cfg.read_size % fs->geo.blocksize != 0 ||
+       fs->cfg.prog_size % fs->geo.blocksize != 0 ||
+       fs->cfg.cache_size % fs->cfg.read_size != 0 ||
+       fs->cfg.cache_size % fs->cfg.prog_size != 0 ||
+       fs->cfg.block_size % fs->cfg.cache_size != 0 ||
+       fs->cfg.lookahead_size % 8 != 0))
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  *
@@ -1291,6 +1565,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  bool forceformat;
+  bool autoformat;
   int ret;
 
   /* Open the block driver */
@@ -1395,13 +1671,27 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.disk_version   = CONFIG_FS_LITTLEFS_DISK_VERSION;
 #endif
 
+  /* The mount options may override the sizes above */
+
+  ret = littlefs_parse_options(fs, data, &forceformat, &autoformat);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
+  ret = littlefs_cache_init(fs);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (forceformat)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1410,17 +1700,12 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
         }
     }
 
-  if (data && !strcmp(data, "ro"))
-    {
-      fs->readonly = true;
-    }
-
   ret = littlefs_convert_result(lfs_mount(&fs->lfs, &fs->cfg));
   if (ret < 0)
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || !autoformat)
         {
           goto errout_with_fs;
         }
@@ -1444,6 +1729,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+  fs_heap_free(fs->cblock);
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1503,6 +1789,7 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+      fs_heap_free(fs->cblock);
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
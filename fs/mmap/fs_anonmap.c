@@ -29,11 +29,26 @@
 #include <nuttx/sched.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
+#include <sys/mman.h>
 
 #include "fs_anonmap.h"
 #include "sched/sched.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of a huge page, i.e. of the memory that the architecture maps
+ * with one section entry instead of a final level page table.
+ */
+
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+#  define ANONMAP_HUGE_SIZE (CONFIG_MM_PGSIZE * \
+                             (CONFIG_MM_PGSIZE / sizeof(uintptr_t)))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -129,8 +144,34 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel)
    * you had logic in place to assign a virtual address to the mapping.
    */
 
-  entry->vaddr = kernel ?
-    fs_heap_zalloc(entry->length) : kumm_zalloc(entry->length);
+  entry->vaddr = NULL;
+
+#ifdef ANONMAP_HUGE_SIZE
+  /* MAP_HUGETLB asks for memory in as few TLB entries as possible.  Large
+   * mappings are aligned to a section then:  The heaps of the address
+   * environments are mapped by sections where possible.  It is only a
+   * hint, unaligned memory is used if there is no aligned block left.
+   */
+
+  if ((entry->flags & MAP_HUGETLB) != 0 &&
+      entry->length >= ANONMAP_HUGE_SIZE)
+    {
+      entry->vaddr = kernel ?
+        fs_heap_memalign(ANONMAP_HUGE_SIZE, entry->length) :
+        kumm_memalign(ANONMAP_HUGE_SIZE, entry->length);
+      if (entry->vaddr != NULL)
+        {
+          memset(entry->vaddr, 0, entry->length);
+        }
+    }
+#endif
+
+  if (entry->vaddr == NULL)
+    {
+      entry->vaddr = kernel ?
+        fs_heap_zalloc(entry->length) : kumm_zalloc(entry->length);
+    }
+
   if (entry->vaddr == NULL)
     {
       ferr("ERROR: kumm_alloc() failed, enable DEBUG_MM for info!\n");
@@ -37,6 +37,7 @@
 #include <nuttx/kmalloc.h>
 
 #include "inode/inode.h"
+#include "fs_pagemap.h"
 #include "fs_rammap.h"
 #include "fs_anonmap.h"
 
@@ -159,11 +160,15 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
        * probably because the underlying media doesn't support random access.
        */
 
-      /* Allocate memory and copy the file into memory.  We would, of course,
-       * do much better in the KERNEL build using the MMU.
+      /* Page the user mappings in on demand where the MMU allows it,
+       * otherwise allocate memory and copy the file into memory.
        */
 
-      ret = rammap(filep, &entry, type);
+      ret = type == MAP_USER ? pagemap(filep, &entry) : -ENOSYS;
+      if (ret == -ENOSYS)
+        {
+          ret = rammap(filep, &entry, type);
+        }
     }
 
   /* Return */
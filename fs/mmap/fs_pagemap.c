@@ -0,0 +1,610 @@
+/****************************************************************************
+ * fs/mmap/fs_pagemap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/sched.h>
+
+#include "fs_pagemap.h"
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of clean pages dropped at once when the page allocator runs
+ * out of memory.
+ */
+
+#define PAGEMAP_RECLAIM 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One page of the mapping, pp_paddr is 0 until the first access */
+
+struct pagemap_page_s
+{
+  uintptr_t pp_paddr;         /* Physical page */
+  uint32_t  pp_hash;          /* Hash of the contents as read/written back */
+  bool      pp_dirty;         /* Populated by a write access */
+};
+
+struct pagemap_s
+{
+  FAR struct file *pm_filep;  /* The backing file */
+  mutex_t          pm_lock;   /* Serializes the faults of the threads */
+  size_t           pm_npages; /* The number of pages of the mapping */
+  size_t           pm_hand;   /* Where the next reclaim starts */
+  struct pagemap_page_s pm_pages[];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int pagemap_fault(FAR struct mm_map_entry_s *entry, FAR void *vaddr,
+                         bool write);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagemap_kaddr
+ *
+ * Description:
+ *   Return the kernel address of a physical page, the pages are filled and
+ *   written back through it so that it does not matter which address
+ *   environment is active.
+ *
+ ****************************************************************************/
+
+static inline FAR uint8_t *pagemap_kaddr(uintptr_t paddr)
+{
+  return (FAR uint8_t *)up_addrenv_page_vaddr(paddr);
+}
+
+/****************************************************************************
+ * Name: pagemap_hash
+ ****************************************************************************/
+
+static uint32_t pagemap_hash(FAR const uint8_t *kaddr)
+{
+  FAR const uint32_t *word = (FAR const uint32_t *)kaddr;
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < MM_PGSIZE / sizeof(uint32_t); i++)
+    {
+      hash = (hash ^ word[i]) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: pagemap_modified
+ *
+ * Description:
+ *   A populated page is modified if it was populated by a write or its
+ *   contents changed since it was read or last written back.  Hardware
+ *   dirty bits are not available through the up_shmat() interface.
+ *
+ ****************************************************************************/
+
+static bool pagemap_modified(FAR struct pagemap_page_s *page)
+{
+  return page->pp_dirty ||
+         page->pp_hash != pagemap_hash(pagemap_kaddr(page->pp_paddr));
+}
+
+/****************************************************************************
+ * Name: pagemap_length
+ *
+ * Description:
+ *   Return the number of bytes of the file behind the page index.
+ *
+ ****************************************************************************/
+
+static inline size_t pagemap_length(FAR struct mm_map_entry_s *entry,
+                                    size_t index)
+{
+  return MIN(MM_PGSIZE, entry->length - (index << MM_PGSHIFT));
+}
+
+/****************************************************************************
+ * Name: pagemap_writeback
+ *
+ * Description:
+ *   Write the modified pages in [first, last) back to the file.  The
+ *   private mappings are never written back.
+ *
+ ****************************************************************************/
+
+static int pagemap_writeback(FAR struct mm_map_entry_s *entry,
+                             FAR struct pagemap_s *pm,
+                             size_t first, size_t last)
+{
+  FAR struct pagemap_page_s *page;
+  FAR uint8_t *kaddr;
+  ssize_t nwrite;
+  size_t length;
+  off_t offset;
+  int ret = OK;
+
+  if ((entry->flags & MAP_SHARED) == 0)
+    {
+      return OK;
+    }
+
+  for (; first < last; first++)
+    {
+      page = &pm->pm_pages[first];
+      if (page->pp_paddr == 0 || !pagemap_modified(page))
+        {
+          continue;
+        }
+
+      kaddr  = pagemap_kaddr(page->pp_paddr);
+      offset = entry->offset + (first << MM_PGSHIFT);
+      length = pagemap_length(entry, first);
+
+      while (length > 0)
+        {
+          nwrite = file_pwrite(pm->pm_filep, kaddr, length, offset);
+          if (nwrite < 0)
+            {
+              if (nwrite == -EINTR)
+                {
+                  continue;
+                }
+
+              ferr("ERROR: Write failed: offset=%" PRIdOFF " nwrite=%zd\n",
+                   offset, nwrite);
+              ret = nwrite;
+              break;
+            }
+
+          kaddr  += nwrite;
+          offset += nwrite;
+          length -= nwrite;
+        }
+
+      if (length == 0)
+        {
+          page->pp_dirty = false;
+          page->pp_hash  = pagemap_hash(pagemap_kaddr(page->pp_paddr));
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagemap_release
+ *
+ * Description:
+ *   Unmap and free the populated pages in [first, last).  The MMU mappings
+ *   are left alone when group is NULL, the address environment is being
+ *   destroyed.
+ *
+ ****************************************************************************/
+
+static void pagemap_release(FAR struct task_group_s *group,
+                            FAR struct mm_map_entry_s *entry,
+                            FAR struct pagemap_s *pm,
+                            size_t first, size_t last)
+{
+  FAR struct pagemap_page_s *page;
+
+  for (; first < last; first++)
+    {
+      page = &pm->pm_pages[first];
+      if (page->pp_paddr != 0)
+        {
+          if (group != NULL)
+            {
+              up_shmdt((uintptr_t)entry->vaddr + (first << MM_PGSHIFT), 1);
+            }
+
+          mm_pgfree(page->pp_paddr, 1);
+          page->pp_paddr = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pagemap_evict
+ *
+ * Description:
+ *   Drop up to nfree clean pages of one mapping, they are read again from
+ *   the file on the next access.  Called with pm_lock held.
+ *
+ ****************************************************************************/
+
+static size_t pagemap_evict(FAR struct mm_map_entry_s *entry,
+                            FAR struct pagemap_s *pm, size_t nfree)
+{
+  FAR struct pagemap_page_s *page;
+  size_t nevict = 0;
+  size_t i;
+
+  for (i = 0; i < pm->pm_npages && nevict < nfree; i++)
+    {
+      if (++pm->pm_hand >= pm->pm_npages)
+        {
+          pm->pm_hand = 0;
+        }
+
+      page = &pm->pm_pages[pm->pm_hand];
+      if (page->pp_paddr != 0 && !pagemap_modified(page))
+        {
+          up_shmdt((uintptr_t)entry->vaddr + (pm->pm_hand << MM_PGSHIFT), 1);
+          mm_pgfree(page->pp_paddr, 1);
+          page->pp_paddr = 0;
+          nevict++;
+        }
+    }
+
+  return nevict;
+}
+
+/****************************************************************************
+ * Name: pagemap_reclaim
+ *
+ * Description:
+ *   Free some clean pages of the demand paged mappings of the current
+ *   address space.  The faulting mapping (whose lock is held) goes last.
+ *
+ ****************************************************************************/
+
+static size_t pagemap_reclaim(FAR struct mm_map_entry_s *self)
+{
+  FAR struct mm_map_s *mm = get_current_mm();
+  FAR struct mm_map_entry_s *entry = NULL;
+  FAR struct pagemap_s *pm;
+  size_t nevict = 0;
+
+  while (nevict < PAGEMAP_RECLAIM &&
+         (entry = mm_map_next(mm, entry)) != NULL)
+    {
+      if (entry == self || entry->fault != pagemap_fault)
+        {
+          continue;
+        }
+
+      pm = entry->priv.p;
+      if (nxmutex_trylock(&pm->pm_lock) == OK)
+        {
+          nevict += pagemap_evict(entry, pm, PAGEMAP_RECLAIM - nevict);
+          nxmutex_unlock(&pm->pm_lock);
+        }
+    }
+
+  if (nevict < PAGEMAP_RECLAIM)
+    {
+      nevict += pagemap_evict(self, self->priv.p, PAGEMAP_RECLAIM - nevict);
+    }
+
+  return nevict;
+}
+
+/****************************************************************************
+ * Name: pagemap_fill
+ *
+ * Description:
+ *   Read one page from the file and map it at its place in the mapping.
+ *   The part past the end of the file reads as zeros.
+ *
+ ****************************************************************************/
+
+static int pagemap_fill(FAR struct mm_map_entry_s *entry,
+                        FAR struct pagemap_s *pm, size_t index)
+{
+  FAR struct pagemap_page_s *page = &pm->pm_pages[index];
+  FAR uint8_t *kaddr;
+  uintptr_t paddr;
+  ssize_t nread;
+  size_t length;
+  size_t pos = 0;
+  off_t offset;
+  int ret;
+
+  paddr = mm_pgalloc(1);
+  if (paddr == 0 && pagemap_reclaim(entry) > 0)
+    {
+      paddr = mm_pgalloc(1);
+    }
+
+  if (paddr == 0)
+    {
+      ferr("ERROR: Out of pages\n");
+      return -ENOMEM;
+    }
+
+  kaddr  = pagemap_kaddr(paddr);
+  offset = entry->offset + (index << MM_PGSHIFT);
+  length = pagemap_length(entry, index);
+
+  while (pos < length)
+    {
+      nread = file_pread(pm->pm_filep, kaddr + pos, length - pos,
+                         offset + pos);
+      if (nread < 0)
+        {
+          if (nread == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Read failed: offset=%" PRIdOFF " ret=%zd\n",
+               offset, nread);
+          ret = nread;
+          goto errout_with_page;
+        }
+      else if (nread == 0)
+        {
+          break;
+        }
+
+      pos += nread;
+    }
+
+  memset(kaddr + pos, 0, MM_PGSIZE - pos);
+
+  ret = up_shmat(&paddr, 1, (uintptr_t)entry->vaddr + (index << MM_PGSHIFT));
+  if (ret < 0)
+    {
+      goto errout_with_page;
+    }
+
+  page->pp_paddr = paddr;
+  page->pp_hash  = pagemap_hash(kaddr);
+  page->pp_dirty = false;
+  return OK;
+
+errout_with_page:
+  mm_pgfree(paddr, 1);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagemap_fault
+ ****************************************************************************/
+
+static int pagemap_fault(FAR struct mm_map_entry_s *entry, FAR void *vaddr,
+                         bool write)
+{
+  FAR struct pagemap_s *pm = entry->priv.p;
+  size_t index;
+  int ret;
+
+  index = ((uintptr_t)vaddr - (uintptr_t)entry->vaddr) >> MM_PGSHIFT;
+  if (index >= pm->pm_npages)
+    {
+      return -EFAULT;
+    }
+
+  ret = nxmutex_lock(&pm->pm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Another thread may have filled the page while we waited */
+
+  if (pm->pm_pages[index].pp_paddr == 0)
+    {
+      ret = pagemap_fill(entry, pm, index);
+    }
+
+  if (ret >= 0 && write)
+    {
+      pm->pm_pages[index].pp_dirty = true;
+    }
+
+  nxmutex_unlock(&pm->pm_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msync_pagemap
+ ****************************************************************************/
+
+static int msync_pagemap(FAR struct mm_map_entry_s *entry, FAR void *start,
+                         size_t length, int flags)
+{
+  FAR struct pagemap_s *pm = entry->priv.p;
+  size_t offset;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  ret = nxmutex_lock(&pm->pm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pagemap_writeback(entry, pm, offset >> MM_PGSHIFT,
+                          MM_NPAGES(offset + length));
+  nxmutex_unlock(&pm->pm_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: unmap_pagemap
+ ****************************************************************************/
+
+static int unmap_pagemap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start,
+                         size_t length)
+{
+  FAR struct pagemap_s *pm = entry->priv.p;
+  size_t offset;
+  size_t first;
+  int ret;
+
+  /* As with rammap, the mappings can only be unmapped to the end */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  /* The page holding the new end stays mapped */
+
+  first = MM_NPAGES(offset);
+
+  ret = nxmutex_lock(&pm->pm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pagemap_writeback(entry, pm, first, pm->pm_npages);
+  pagemap_release(group, entry, pm, first, pm->pm_npages);
+
+  if (offset > 0)
+    {
+      entry->length = offset;
+      pm->pm_npages = first;
+      nxmutex_unlock(&pm->pm_lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&pm->pm_lock);
+
+  if (group != NULL)
+    {
+      vm_release_region(get_group_mm(group), entry->vaddr,
+                        MM_PGALIGNUP(entry->length));
+    }
+
+  fs_putfilep(pm->pm_filep);
+  nxmutex_destroy(&pm->pm_lock);
+  fs_heap_free(pm);
+
+  /* Then remove the mapping from the list */
+
+  return mm_map_remove(get_group_mm(group), entry);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagemap
+ *
+ * Description:
+ *   Map a regular file into the user address space on demand.
+ *
+ ****************************************************************************/
+
+int pagemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry)
+{
+  FAR struct mm_map_s *mm = get_current_mm();
+  FAR struct pagemap_s *pm;
+  size_t npages;
+  int ret;
+
+  /* Only the files of the mounted file systems can be read at random
+   * offsets, and the page offsets must be page aligned.
+   */
+
+  if (!INODE_IS_MOUNTPT(filep->f_inode) ||
+      (entry->offset & MM_PGMASK) != 0)
+    {
+      return -ENOSYS;
+    }
+
+  npages = MM_NPAGES(entry->length);
+  pm = fs_heap_zalloc(sizeof(struct pagemap_s) +
+                      npages * sizeof(struct pagemap_page_s));
+  if (pm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  entry->vaddr = vm_alloc_region(mm, NULL, npages << MM_PGSHIFT);
+  if (entry->vaddr == NULL)
+    {
+      ferr("ERROR: No address space for %zu pages\n", npages);
+      ret = -ENOMEM;
+      goto errout_with_pm;
+    }
+
+  nxmutex_init(&pm->pm_lock);
+  pm->pm_filep  = filep;
+  pm->pm_npages = npages;
+
+  fs_reffilep(filep);
+  entry->priv.p = pm;
+  entry->munmap = unmap_pagemap;
+  entry->msync  = msync_pagemap;
+  entry->fault  = pagemap_fault;
+
+  ret = mm_map_add(mm, entry);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+  return OK;
+
+errout_with_region:
+  fs_putfilep(filep);
+  nxmutex_destroy(&pm->pm_lock);
+  vm_release_region(mm, entry->vaddr, npages << MM_PGSHIFT);
+
+errout_with_pm:
+  fs_heap_free(pm);
+  return ret;
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ * fs/mmap/fs_pagemap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_PAGEMAP_H
+#define __FS_MMAP_FS_PAGEMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <nuttx/mm/map.h>
+
+#ifdef CONFIG_FS_PAGEMAP
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagemap
+ *
+ * Description:
+ *   Map a regular file into the user address space on demand.  Only the
+ *   virtual range is reserved here, the pages are read from the file by the
+ *   page faults of the first accesses.
+ *
+ * Input Parameters:
+ *   filep   file descriptor of the backing file -- required.
+ *   entry   mmap entry information.
+ *           field offset and length must be initialized correctly.
+ *
+ * Returned Value:
+ *   On success pagemap returns 0 and entry->vaddr points to the mapping.
+ *   -ENOSYS if the file cannot be paged on demand and must be copied by
+ *   rammap() instead.  Otherwise a negated errno value:
+ *
+ *     ENOMEM
+ *       Insufficient memory or address space to map the file.
+ *
+ ****************************************************************************/
+
+int pagemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry);
+#else
+#  define pagemap(file, entry) (-ENOSYS)
+#endif /* CONFIG_FS_PAGEMAP */
+
+#endif /* __FS_MMAP_FS_PAGEMAP_H */
@@ -90,8 +90,10 @@
 
 #include <fcntl.h>
 #include <math.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <stdio.h>
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -162,6 +164,10 @@ static int     mnemofs_rename(FAR struct inode *mountpt,
 static int     mnemofs_stat(FAR struct inode *mountpt,
                             FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef CONFIG_MNEMOFS_GROUP_COMMIT
+static void    mnemofs_commit_worker(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -503,8 +509,10 @@ errout:
  *   representation in the file pointer's private field. mnemofs also syncs
  *   up the on-flash data after closing of a file (unlike a typical fs as
  *   mentioned in `man`). This is to be prepared for random power loss at all
- *   possible times. See `close(2)` for details on the work and parameters
- *   of this function.
+ *   possible times. With CONFIG_MNEMOFS_GROUP_COMMIT the sync is deferred
+ *   by CONFIG_MNEMOFS_COMMIT_DELAY, so that the files closed in the
+ *   meantime are committed together. See `close(2)` for details on the work
+ *   and parameters of this function.
  *
  * Input Parameters:
  *   filep   - File pointer.
@@ -557,7 +565,15 @@ static int mnemofs_close(FAR struct file *filep)
     {
       MFS_EXTRA_LOG("CLOSE", "Reference Counter is 0.");
 
+#ifdef CONFIG_MNEMOFS_GROUP_COMMIT
+      if (work_available(&sb->commit_work))
+        {
+          ret = work_queue(LPWORK, &sb->commit_work, mnemofs_commit_worker,
+                           sb, MSEC2TICK(CONFIG_MNEMOFS_COMMIT_DELAY));
+        }
+#else
       ret = mnemofs_flush(sb);
+#endif
       if (predict_false(ret < 0))
         {
           MFS_LOG("CLOSE", "Could not flush file system.");
@@ -1992,6 +2008,13 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+#ifdef CONFIG_MNEMOFS_GROUP_COMMIT
+  /* Commit what the closed files left in the LRU. */
+
+  work_cancel_sync(LPWORK, &sb->commit_work);
+  mnemofs_flush(sb);
+#endif
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
@@ -2620,6 +2643,40 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: mnemofs_commit_worker
+ *
+ * Description:
+ *   Commits the changes of the files closed since the last commit as one
+ *   flush of the LRU and the journal.
+ *
+ * Input Parameters:
+ *   arg - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_GROUP_COMMIT
+static void mnemofs_commit_worker(FAR void *arg)
+{
+  int                  ret;
+  FAR struct mfs_sb_s *sb = arg;
+
+  ret = nxmutex_lock(&MFS_LOCK(sb));
+  if (predict_false(ret < 0))
+    {
+      return;
+    }
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      MFS_LOG("COMMIT", "Could not flush file system: %d.", ret);
+    }
+
+  nxmutex_unlock(&MFS_LOCK(sb));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -61,6 +61,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -185,6 +186,8 @@ struct mfs_jrnl_state_s
   mfs_t    jrnlarr_pg;
   mfs_t    jrnlarr_pgoff;
   uint16_t n_blks;        /* TODO: Does not include the master node. */
+  FAR char *cbuf;         /* Logs not yet committed to log_cpg. */
+  mfs_t    cbuf_len;      /* Bytes used in cbuf. */
 };
 
 struct mfs_sb_s
@@ -207,6 +210,9 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#ifdef CONFIG_MNEMOFS_GROUP_COMMIT
+  struct work_s           commit_work;   /* Deferred group commit. */
+#endif
 };
 
 /* This is for *dir VFS methods. */
@@ -675,6 +681,25 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
 
 int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb);
 
+/****************************************************************************
+ * Name: mfs_jrnl_commit
+ *
+ * Description:
+ *   Write the logs gathered by mfs_jrnl_wrlog to the journal. The logs of
+ *   one flush are packed together, so a batch of small updates costs one
+ *   page program instead of one per log.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ ****************************************************************************/
+
+int mfs_jrnl_commit(FAR struct mfs_sb_s * const sb);
+
 /****************************************************************************
  * Name: mfs_jrnl_isempty
  *
@@ -708,7 +733,7 @@ struct mfs_jrnl_log_s
 
 int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
                       FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
-                      FAR struct mfs_jrnl_log_s *log);
+                      FAR mfs_t *pgoff, FAR struct mfs_jrnl_log_s *log);
 
 void mfs_jrnl_log_free(FAR const struct mfs_jrnl_log_s * const log);
 
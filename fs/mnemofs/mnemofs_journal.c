@@ -67,8 +67,9 @@
  * with an array containing the block numbers of all blocks in the journal
  * including the first block. Then the logs start.
  *
- * The logs take up size in multiples of pages. There might be unitilzed
- * space at the end of a log.
+ * Each log is preceded by its size. The logs written by one flush are
+ * packed into pages by mfs_jrnl_commit, a log never crosses a page and a
+ * zero size marks the unused rest of a page.
  *
  * All logs are followed by a byte-long hash of the log.
  ****************************************************************************/
@@ -112,6 +113,9 @@ FAR static const char *deser_log(FAR const char * const in,
                                  FAR struct mfs_jrnl_log_s * const x);
 FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
                                FAR char * const out);
+static void            jrnl_nextpg(FAR const struct mfs_sb_s * const sb,
+                                   FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
+                                   FAR mfs_t *pgoff);
 
 /****************************************************************************
  * Private Data
@@ -136,6 +140,7 @@ FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
  *   sb        - Superblock instance of the device.
  *   blkidx    - Journal Block Index of the current block.
  *   pg_in_blk - Page offset in the block.
+ *   pgoff     - Byte offset in the page.
  *   log       - To populate with the log.
  *
  * Returned Value:
@@ -149,8 +154,8 @@ FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
  *   hence the first time blkidx and pg_in_blk are initialized, they should
  *   be derived from the values in MFS_JRNL(sb) respectively.
  *
- *   This updates the blkidx and pg_in_blk to point to the next log, and
- *   returns an -ENOSPC when end of journal is reached in traversal.
+ *   This updates the blkidx, pg_in_blk and pgoff to point to the next log,
+ *   and returns an -ENOSPC when end of journal is reached in traversal.
  *
  *   Free the log after use.
  *
@@ -158,7 +163,7 @@ FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
 
 int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
                       FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
-                      FAR struct mfs_jrnl_log_s *log)
+                      FAR mfs_t *pgoff, FAR struct mfs_jrnl_log_s *log)
 {
   int       ret       = OK;
   char      tmp[4];
@@ -167,24 +172,36 @@ int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
   mfs_t     jrnl_blk;
   FAR char *buf       = NULL;
 
-  DEBUGASSERT(*pg_in_blk % MFS_PGSZ(sb) == 0);
+  DEBUGASSERT(*pgoff < MFS_PGSZ(sb));
 
-  jrnl_blk = mfs_jrnl_blkidx2blk(sb, *blkidx);
-  jrnl_pg  = MFS_BLK2PG(sb, jrnl_blk) + *pg_in_blk;
+  for (; ; )
+    {
+      jrnl_blk = mfs_jrnl_blkidx2blk(sb, *blkidx);
+      jrnl_pg  = MFS_BLK2PG(sb, jrnl_blk) + *pg_in_blk;
 
-  /* First 4 bytes contain the size of the entire log. */
+      /* First 4 bytes contain the size of the entire log. */
 
-  ret = mfs_read_page(sb, tmp, 4, jrnl_pg, 0);
-  if (predict_false(ret < 0))
-    {
-      goto errout;
-    }
+      ret = mfs_read_page(sb, tmp, 4, jrnl_pg, *pgoff);
+      if (predict_false(ret < 0))
+        {
+          goto errout;
+        }
 
-  mfs_deser_mfs(tmp, &log_sz);
-  if (log_sz == 0)
-    {
-      ret = -ENOSPC;
-      goto errout;
+      mfs_deser_mfs(tmp, &log_sz);
+      if (log_sz != 0)
+        {
+          break;
+        }
+
+      if (*pgoff == 0)
+        {
+          ret = -ENOSPC;
+          goto errout;
+        }
+
+      /* Unused rest of a packed page, the next log is on the next page. */
+
+      jrnl_nextpg(sb, blkidx, pg_in_blk, pgoff);
     }
 
   buf = fs_heap_zalloc(log_sz);
@@ -194,7 +211,7 @@ int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
       goto errout;
     }
 
-  ret = mfs_read_page(sb, buf, log_sz, jrnl_pg, 4);
+  ret = mfs_read_page(sb, buf, log_sz, jrnl_pg, *pgoff + 4);
   if (predict_false(ret < 0))
     {
       goto errout_with_buf;
@@ -208,12 +225,10 @@ int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
       goto errout_with_buf;
     }
 
-  (*pg_in_blk)++;
-
-  if (*pg_in_blk >= MFS_PGINBLK(sb))
+  *pgoff += 4 + log_sz;
+  if (*pgoff + 4 > MFS_PGSZ(sb))
     {
-      *pg_in_blk = 0;
-      (*blkidx)++;
+      jrnl_nextpg(sb, blkidx, pg_in_blk, pgoff);
     }
 
 errout_with_buf:
@@ -333,6 +348,34 @@ void mfs_jrnl_log_free(FAR const struct mfs_jrnl_log_s * const log)
   fs_heap_free(log->path);
 }
 
+/****************************************************************************
+ * Name: jrnl_nextpg
+ *
+ * Description:
+ *   Advance a journal location to the start of the next page.
+ *
+ * Input Parameters:
+ *   sb        - Superblock instance of the device.
+ *   blkidx    - Journal Block Index of the current block.
+ *   pg_in_blk - Page offset in the block.
+ *   pgoff     - Byte offset in the page.
+ *
+ ****************************************************************************/
+
+static void jrnl_nextpg(FAR const struct mfs_sb_s * const sb,
+                        FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
+                        FAR mfs_t *pgoff)
+{
+  *pgoff = 0;
+  (*pg_in_blk)++;
+
+  if (*pg_in_blk >= MFS_PGINBLK(sb))
+    {
+      *pg_in_blk = 0;
+      (*blkidx)++;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -344,6 +387,7 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
   mfs_t             sz;
   mfs_t             blkidx;
   mfs_t             pg_in_blk;
+  mfs_t             pgoff;
   struct mfs_jrnl_log_s log;
 
   /* Magic sequence is already used to find the block, so not required. */
@@ -372,10 +416,11 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
   MFS_JRNL(sb).n_logs = 0;
   blkidx              = MFS_JRNL(sb).log_sblkidx;
   pg_in_blk           = MFS_JRNL(sb).log_spg % MFS_PGINBLK(sb);
+  pgoff               = 0;
 
   while (true)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &log);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &pgoff, &log);
       if (predict_false(ret < 0 && ret != -ENOSPC))
         {
           goto errout;
@@ -518,6 +563,8 @@ errout:
 
 void mfs_jrnl_free(FAR struct mfs_sb_s * const sb)
 {
+  mfs_jrnl_commit(sb);
+
   if (!mfs_jrnl_isempty(sb) &&
       MFS_JRNL(sb).log_cblkidx >= MFS_JRNL_LIM(sb))
     {
@@ -575,6 +622,7 @@ int mfs_jrnl_updatedinfo(FAR const struct mfs_sb_s * const sb,
   mfs_t             blkidx;
   mfs_t             counter     = 0;
   mfs_t             pg_in_block;
+  mfs_t             pgoff       = 0;
   struct mfs_jrnl_log_s tmplog;
 
   /* TODO: Allow optional filling of updated timestamps, etc. */
@@ -586,7 +634,7 @@ int mfs_jrnl_updatedinfo(FAR const struct mfs_sb_s * const sb,
 
   while (blkidx < MFS_JRNL(sb).n_blks && counter < MFS_JRNL(sb).n_logs)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_block, &tmplog);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_block, &pgoff, &tmplog);
       if (predict_false(ret < 0 && ret != -ENOSPC))
         {
           goto errout;
@@ -627,7 +675,6 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
                    const struct mfs_ctz_s loc_new, const mfs_t sz_new)
 {
   int                    ret      = OK;
-  mfs_t                  jrnl_pg;
   FAR char              *buf      = NULL;
   FAR char              *tmp      = NULL;
   const mfs_t            log_sz   = sizeof(mfs_t) + MFS_LOGSZ(node->depth);
@@ -654,16 +701,62 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
   tmp = mfs_ser_mfs(log_sz - sizeof(mfs_t), tmp); /* First 4 bytes have sz */
   tmp = ser_log(&log, tmp);
 
-  /* Store */
+  /* Store. The log is packed after the ones not yet committed, the page
+   * is written once the next log does not fit anymore, or on commit.
+   *
+   * TODO: It assumes it takes only one page per log.
+   */
+
+  if (MFS_JRNL(sb).cbuf != NULL &&
+      MFS_JRNL(sb).cbuf_len + log_sz > MFS_PGSZ(sb))
+    {
+      ret = mfs_jrnl_commit(sb);
+      if (predict_false(ret < 0))
+        {
+          goto errout_with_buf;
+        }
+    }
+
+  if (MFS_JRNL(sb).cbuf == NULL)
+    {
+      MFS_JRNL(sb).cbuf = fs_heap_zalloc(MFS_PGSZ(sb));
+      if (predict_false(MFS_JRNL(sb).cbuf == NULL))
+        {
+          ret = -ENOMEM;
+          goto errout_with_buf;
+        }
+
+      MFS_JRNL(sb).cbuf_len = 0;
+    }
+
+  memcpy(MFS_JRNL(sb).cbuf + MFS_JRNL(sb).cbuf_len, buf, log_sz);
+  MFS_JRNL(sb).cbuf_len += log_sz;
+  MFS_JRNL(sb).n_logs++;
+
+errout_with_buf:
+  fs_heap_free(buf);
+
+errout:
+  return ret;
+}
 
-  jrnl_pg  = MFS_JRNL(sb).log_cpg;
+int mfs_jrnl_commit(FAR struct mfs_sb_s * const sb)
+{
+  int   ret     = OK;
+  mfs_t jrnl_pg;
+
+  if (MFS_JRNL(sb).cbuf == NULL)
+    {
+      goto errout;
+    }
 
-  /* TODO: It assumes it takes only one page per log. */
+  jrnl_pg = MFS_JRNL(sb).log_cpg;
 
-  ret = mfs_write_page(sb, buf, log_sz, jrnl_pg, 0);
+  ret = mfs_write_page(sb, MFS_JRNL(sb).cbuf, MFS_JRNL(sb).cbuf_len,
+                       jrnl_pg, 0);
   if (predict_false(ret < 0))
     {
-      goto errout_with_buf;
+      goto errout;
     }
 
   ret = OK;
@@ -676,10 +769,10 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
     }
 
   MFS_JRNL(sb).log_cpg = jrnl_pg;
-  MFS_JRNL(sb).n_logs++;
 
-errout_with_buf:
-  fs_heap_free(buf);
+  fs_heap_free(MFS_JRNL(sb).cbuf);
+  MFS_JRNL(sb).cbuf     = NULL;
+  MFS_JRNL(sb).cbuf_len = 0;
 
 errout:
   return ret;
@@ -723,8 +816,10 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
   mfs_t                    log_itr       = 0;
   mfs_t                    pg_in_blk     = MFS_JRNL(sb).log_spg \
                                            % MFS_PGINBLK(sb);
+  mfs_t                    pgoff         = 0;
   mfs_t                    tmp_blkidx;
   mfs_t                    tmp_pg_in_blk;
+  mfs_t                    tmp_pgoff;
   mfs_t                    mn_blk1;
   mfs_t                    mn_blk2;
   mfs_t                    i;
@@ -736,9 +831,17 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
   struct mfs_jrnl_state_s  j_state;
   struct mfs_mn_s          mn_state;
 
+  /* The logs still in the commit buffer have to be on the flash first. */
+
+  ret = mfs_jrnl_commit(sb);
+  if (predict_false(ret < 0))
+    {
+      goto errout;
+    }
+
   while (log_itr < MFS_JRNL(sb).n_logs)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &log);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &pgoff, &log);
       if (predict_false(ret < 0))
         {
           DEBUGASSERT(ret != -ENOSPC); /* While condition is sufficient. */
@@ -754,6 +857,7 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
 
       tmp_blkidx    = blkidx;
       tmp_pg_in_blk = pg_in_blk;
+      tmp_pgoff     = pgoff;
 
       path = fs_heap_zalloc(log.depth * sizeof(struct mfs_path_s));
       if (predict_false(path == NULL))
@@ -766,7 +870,8 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
 
       for (; ; )
         {
-          ret = mfs_jrnl_rdlog(sb, &tmp_blkidx, &tmp_pg_in_blk, &tmp_log);
+          ret = mfs_jrnl_rdlog(sb, &tmp_blkidx, &tmp_pg_in_blk, &tmp_pgoff,
+                               &tmp_log);
           if (ret == -ENOSPC)
             {
               break;
@@ -827,12 +827,16 @@ int mfs_lru_flush(FAR struct mfs_sb_s * const sb)
         }
     }
 
+  /* All the logs of this flush go to the journal as one commit. */
+
+  ret = mfs_jrnl_commit(sb);
   return ret;
 
 errout_with_tmp:
   lru_node_free(node);
 
 errout:
+  mfs_jrnl_commit(sb); /* Keep the logs of the nodes already flushed. */
   MFS_FLUSH(sb) = false;
   return ret;
 }
@@ -197,6 +197,7 @@ int mfs_mn_init(FAR struct mfs_sb_s * const sb, const mfs_t jrnl_blk)
   mfs_t           mblk1;
   mfs_t           blkidx;
   mfs_t           pg_in_blk;
+  mfs_t           pgoff;
   mfs_t           jrnl_blk_tmp;
   uint16_t        hash;
   struct mfs_mn_s mn;
@@ -252,10 +253,11 @@ int mfs_mn_init(FAR struct mfs_sb_s * const sb, const mfs_t jrnl_blk)
 
   blkidx              = MFS_JRNL(sb).log_sblkidx;
   pg_in_blk           = MFS_JRNL(sb).log_spg % MFS_PGINBLK(sb);
+  pgoff               = 0;
 
   while (true)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &log);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &pgoff, &log);
       if (predict_false(ret < 0 && ret != -ENOSPC))
         {
           goto errout;
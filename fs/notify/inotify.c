@@ -51,6 +51,14 @@
 
  #define ROUND_UP(x, y) (((x) + (y) - 1) / (y) * (y))
 
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+#  define INOTIFY_POOL_NAMELEN \
+     ROUND_UP(CONFIG_FS_NOTIFY_EVENT_POOL_NAMELEN, sizeof(struct inotify_event))
+#  define INOTIFY_POOL_SLOTSIZE \
+     ROUND_UP(sizeof(struct inotify_event_s) + INOTIFY_POOL_NAMELEN, \
+              sizeof(uintptr_t))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,12 +73,17 @@ struct inotify_device_s
   uint32_t           event_size;  /* Size of the queue (bytes) */
   uint32_t           event_count; /* Number of pending events */
   FAR struct pollfd *fds[CONFIG_FS_NOTIFY_FD_POLLWAITERS];
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  struct list_node   pool;        /* List of free preallocated events */
+#endif
 };
 
 struct inotify_event_s
 {
-  struct list_node     node;     /* Entry in inotify_device's list */
-  struct inotify_event event;    /* The user-space event */
+  struct list_node             node;   /* Entry in inotify_device's list */
+  FAR struct inotify_event_s **owner;  /* Watch's last event slot or NULL */
+  bool                         pooled; /* Taken from the device's pool */
+  struct inotify_event         event;  /* The user-space event */
 };
 
 struct inotify_watch_list_s
@@ -87,6 +100,7 @@ struct inotify_watch_s
   uint32_t                         mask;    /* Event mask for this watch */
   FAR struct inotify_device_s     *dev;     /* Associated device */
   FAR struct inotify_watch_list_s *list;    /* Associated watch list */
+  FAR struct inotify_event_s      *last;    /* Last queued event, if pending */
 };
 
 struct inotify_global_s
@@ -197,15 +211,15 @@ static int notify_check_mask(uint32_t mask)
  * Name: inotify_alloc_event
  *
  * Description:
- *   Initialize a kernel event.
+ *   Initialize a kernel event, from the device's pool if possible.
  *   Size of name is rounded up to sizeof(struct inotify_event).
  ****************************************************************************/
 
 static FAR struct inotify_event_s *
-inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
-                    FAR const char *name)
+inotify_alloc_event(FAR struct inotify_device_s *dev, int wd, uint32_t mask,
+                    uint32_t cookie, FAR const char *name)
 {
-  FAR struct inotify_event_s *event;
+  FAR struct inotify_event_s *event = NULL;
   size_t len = 0;
 
   if (name != NULL)
@@ -213,12 +227,27 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
       len = ROUND_UP(strlen(name) + 1, sizeof(struct inotify_event));
     }
 
-  event = fs_heap_malloc(sizeof(struct inotify_event_s) + len);
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  if (len <= INOTIFY_POOL_NAMELEN && !list_is_empty(&dev->pool))
+    {
+      event = list_remove_head_type(&dev->pool, struct inotify_event_s,
+                                    node);
+      event->pooled = true;
+    }
+#endif
+
   if (event == NULL)
     {
-      return NULL;
+      event = fs_heap_malloc(sizeof(struct inotify_event_s) + len);
+      if (event == NULL)
+        {
+          return NULL;
+        }
+
+      event->pooled = false;
     }
 
+  event->owner        = NULL;
   event->event.wd     = wd;
   event->event.mask   = mask;
   event->event.cookie = cookie;
@@ -232,32 +261,57 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
   return event;
 }
 
+/****************************************************************************
+ * Name: inotify_same_event
+ *
+ * Description:
+ *   Check if a queued event carries the same information as a new one.
+ *
+ ****************************************************************************/
+
+static bool inotify_same_event(FAR struct inotify_event_s *event, int wd,
+                               uint32_t mask, uint32_t cookie,
+                               FAR const char *name)
+{
+  return event->event.mask == mask && event->event.wd == wd &&
+         event->event.cookie == cookie &&
+         ((name == NULL && event->event.len == 0) ||
+          (name && event->event.len && !strcmp(name, event->event.name)));
+}
+
 /****************************************************************************
  * Name: inotify_queue_event
  *
  * Description:
- *   Queue an event to the inotify device.
+ *   Queue an event to the inotify device.  If last is not NULL, it holds
+ *   the still pending event queued last for the same watch.  An identical
+ *   event is coalesced into it, otherwise the new event is recorded there.
  *
  ****************************************************************************/
 
 static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
                                 uint32_t mask, uint32_t cookie,
-                                FAR const char *name)
+                                FAR const char *name,
+                                FAR struct inotify_event_s **last)
 {
   FAR struct inotify_event_s *event;
-  FAR struct inotify_event_s *last;
   int semcnt;
 
+  if (last != NULL && *last != NULL &&
+      inotify_same_event(*last, wd, mask, cookie, name))
+    {
+      /* The watch has not seen anything else since, nothing new to say */
+
+      return;
+    }
+
   if (!list_is_empty(&dev->events))
     {
       /* Drop this event if it is a dupe of the previous */
 
-      last = list_last_entry(&dev->events,
-                             struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
-          ((name == NULL && last->event.len == 0) ||
-           (name && last->event.len && !strcmp(name, last->event.name))))
+      event = list_last_entry(&dev->events,
+                              struct inotify_event_s, node);
+      if (inotify_same_event(event, wd, mask, cookie, name))
         {
           return;
         }
@@ -271,11 +325,21 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
   if (dev->event_count == CONFIG_FS_NOTIFY_MAX_EVENTS)
     {
-      event = inotify_alloc_event(-1, IN_Q_OVERFLOW, cookie, NULL);
+      event = inotify_alloc_event(dev, -1, IN_Q_OVERFLOW, cookie, NULL);
     }
   else
     {
-      event = inotify_alloc_event(wd, mask, cookie, name);
+      event = inotify_alloc_event(dev, wd, mask, cookie, name);
+      if (event != NULL && last != NULL)
+        {
+          if (*last != NULL)
+            {
+              (*last)->owner = NULL;
+            }
+
+          event->owner = last;
+          *last = event;
+        }
     }
 
   if (event == NULL)
@@ -287,14 +351,20 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
   dev->event_size += sizeof(struct inotify_event) + event->event.len;
   list_add_tail(&dev->events, &event->node);
 
+  /* Readers and pollers only wait for an empty queue to fill up, wake
+   * them once per batch rather than once per event.
+   */
+
+  if (dev->event_count > 1)
+    {
+      return;
+    }
+
   poll_notify(dev->fds, CONFIG_FS_NOTIFY_FD_POLLWAITERS, POLLIN);
 
-  if (nxsem_get_value(&dev->sem, &semcnt) >= 0)
+  if (nxsem_get_value(&dev->sem, &semcnt) >= 0 && semcnt <= 0)
     {
-      while (semcnt++ <= 1)
-        {
-          nxsem_post(&dev->sem);
-        }
+      nxsem_post(&dev->sem);
     }
 }
 
@@ -311,6 +381,11 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
 {
   FAR struct inotify_watch_list_s *list = watch->list;
 
+  if (watch->last != NULL)
+    {
+      watch->last->owner = NULL;
+    }
+
   list_delete(&watch->d_node);
   list_delete(&watch->l_node);
   inotify_sub_count(watch->mask);
@@ -335,7 +410,7 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
 static void inotify_remove_watch(FAR struct inotify_device_s *dev,
                                  FAR struct inotify_watch_s *watch)
 {
-  inotify_queue_event(dev, watch->wd, IN_IGNORED, 0, NULL);
+  inotify_queue_event(dev, watch->wd, IN_IGNORED, 0, NULL, NULL);
   inotify_remove_watch_no_event(watch);
 }
 
@@ -353,6 +428,20 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
   list_delete(&event->node);
   dev->event_size -= sizeof(struct inotify_event) + event->event.len;
   dev->event_count--;
+
+  if (event->owner != NULL)
+    {
+      *event->owner = NULL;
+    }
+
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  if (event->pooled)
+    {
+      list_add_tail(&dev->pool, &event->node);
+      return;
+    }
+#endif
+
   fs_heap_free(event);
 }
 
@@ -367,8 +456,17 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
 static FAR struct inotify_device_s *inotify_alloc_device(void)
 {
   FAR struct inotify_device_s *dev;
+  size_t size = sizeof(struct inotify_device_s);
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  FAR char *slot;
+  int i;
 
-  dev = fs_heap_zalloc(sizeof(struct inotify_device_s));
+  /* The event pool follows the device structure */
+
+  size += CONFIG_FS_NOTIFY_EVENT_POOL * INOTIFY_POOL_SLOTSIZE;
+#endif
+
+  dev = fs_heap_zalloc(size);
   if (dev == NULL)
     {
       return dev;
@@ -379,6 +477,17 @@ static FAR struct inotify_device_s *inotify_alloc_device(void)
   nxsem_init(&dev->sem, 0, 0);
   list_initialize(&dev->events);
   list_initialize(&dev->watches);
+
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  list_initialize(&dev->pool);
+  slot = (FAR char *)(dev + 1);
+  for (i = 0; i < CONFIG_FS_NOTIFY_EVENT_POOL; i++)
+    {
+      list_add_tail(&dev->pool, (FAR struct list_node *)slot);
+      slot += INOTIFY_POOL_SLOTSIZE;
+    }
+#endif
+
   return dev;
 }
 
@@ -494,6 +603,7 @@ static ssize_t inotify_read(FAR struct file *filp, FAR char *buffer,
 {
   FAR struct inotify_device_s *dev = filp->f_priv;
   FAR char *start = buffer;
+  int semcnt;
   int ret = 0;
 
   if (len < sizeof(struct inotify_event) || buffer == NULL)
@@ -537,6 +647,14 @@ static ssize_t inotify_read(FAR struct file *filp, FAR char *buffer,
         }
     }
 
+  /* Pass the wakeup on if another reader waits for what is left */
+
+  if (!list_is_empty(&dev->events) &&
+      nxsem_get_value(&dev->sem, &semcnt) >= 0 && semcnt < 0)
+    {
+      nxsem_post(&dev->sem);
+    }
+
   nxmutex_unlock(&dev->lock);
   if (start != buffer)
     {
@@ -820,7 +938,8 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
           bool last_iteration = list_is_singular(&list->watches);
 
           nxmutex_lock(&dev->lock);
-          inotify_queue_event(dev, watch->wd, mask, cookie, name);
+          inotify_queue_event(dev, watch->wd, mask, cookie, name,
+                              &watch->last);
           if (watch_mask & IN_ONESHOT)
             {
               inotify_remove_watch(dev, watch);
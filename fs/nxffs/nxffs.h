@@ -174,6 +174,15 @@
 
 #define NXFFS_NERASED             128
 
+/* The number of hash buckets of the in-RAM inode index */
+
+#ifdef CONFIG_NXFFS_INDEX
+#  define NXFFS_INDEX_MASK        (CONFIG_NXFFS_INDEX_NBUCKETS - 1)
+#  if (CONFIG_NXFFS_INDEX_NBUCKETS & NXFFS_INDEX_MASK) != 0
+#    error CONFIG_NXFFS_INDEX_NBUCKETS must be a power of two
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -263,6 +272,19 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+/* One entry of the in-RAM inode index.  Only the hash of the name is kept,
+ * the inode header at hoffset is read to confirm a match.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  FAR struct nxffs_index_s *flink;     /* Next entry in the hash bucket */
+  uint32_t                  hash;      /* Hash of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -281,6 +303,10 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  bool                      idxvalid;  /* The inode index is complete */
+  FAR struct nxffs_index_s *index[CONFIG_NXFFS_INDEX_NBUCKETS];
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -619,6 +645,28 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
 int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
                     FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_rdinode
+ *
+ * Description:
+ *   Read and verify the inode header at a known FLASH offset.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   offset - The FLASH offset of the inode header
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no valid
+ *   inode at the offset.
+ *
+ * Defined in nxffs_inode.c
+ *
+ ****************************************************************************/
+
+int nxffs_rdinode(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry);
+
 /****************************************************************************
  * Name: nxffs_inodeend
  *
@@ -646,6 +694,88 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 off_t nxffs_inodeend(FAR struct nxffs_volume_s *volume,
                      FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_idxbuild, nxffs_idxinvalidate
+ *
+ * Description:
+ *   Build the in-RAM inode index by scanning all of the inode headers, or
+ *   discard it.  The index is discarded when the inodes move (packing,
+ *   reformatting) and rebuilt on the next lookup.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   nxffs_idxbuild returns zero on success; a negated errno value if the
+ *   index could not be built, lookups then scan the FLASH.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_idxbuild(FAR struct nxffs_volume_s *volume);
+void nxffs_idxinvalidate(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_idxbuild(v)
+#  define nxffs_idxinvalidate(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxadd, nxffs_idxremove
+ *
+ * Description:
+ *   Keep the inode index in sync when an inode header is written or an
+ *   inode is marked deleted.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   name    - The name of the new inode
+ *   hoffset - The FLASH offset of the inode header
+ *
+ * Returned Value:
+ *   None.  The index is discarded if it cannot be updated.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset);
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+#else
+#  define nxffs_idxadd(v,n,o)
+#  define nxffs_idxremove(v,o)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Find an inode through the inode index, only the inode headers with a
+ *   matching name hash are read from FLASH.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success, -ENOENT if there is no such inode and
+ *   -ENOSYS if no index is available and the FLASH must be scanned.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry);
+#else
+#  define nxffs_idxfind(v,n,e)   (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Name: nxffs_verifyblock
  *
@@ -0,0 +1,261 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "nxffs.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxhash
+ ****************************************************************************/
+
+static uint32_t nxffs_idxhash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxinsert
+ ****************************************************************************/
+
+static int nxffs_idxinsert(FAR struct nxffs_volume_s *volume,
+                           FAR const char *name, off_t hoffset)
+{
+  FAR struct nxffs_index_s *idx;
+  FAR struct nxffs_index_s **head;
+
+  idx = fs_heap_malloc(sizeof(struct nxffs_index_s));
+  if (idx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  idx->hash    = nxffs_idxhash(name);
+  idx->hoffset = hoffset;
+
+  head         = &volume->index[idx->hash & NXFFS_INDEX_MASK];
+  idx->flink   = *head;
+  *head        = idx;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxinvalidate
+ *
+ * Description:
+ *   Discard the inode index, it is rebuilt on the next lookup.
+ *
+ ****************************************************************************/
+
+void nxffs_idxinvalidate(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_index_s *idx;
+  int i;
+
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      while ((idx = volume->index[i]) != NULL)
+        {
+          volume->index[i] = idx->flink;
+          fs_heap_free(idx);
+        }
+    }
+
+  volume->idxvalid = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxbuild
+ *
+ * Description:
+ *   Scan all of the valid inode headers once and index them by name.
+ *
+ ****************************************************************************/
+
+int nxffs_idxbuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_idxinvalidate(volume);
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) != -ENOENT)
+    {
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      ret    = nxffs_idxinsert(volume, entry.name, entry.hoffset);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  volume->idxvalid = true;
+  return OK;
+
+errout:
+  ferr("ERROR: Failed to build the inode index: %d\n", -ret);
+  nxffs_idxinvalidate(volume);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxadd
+ *
+ * Description:
+ *   Index a new inode header.  Any older inode with the same name has
+ *   already been removed.
+ *
+ ****************************************************************************/
+
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset)
+{
+  if (volume->idxvalid && nxffs_idxinsert(volume, name, hoffset) < 0)
+    {
+      nxffs_idxinvalidate(volume);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxremove
+ *
+ * Description:
+ *   Remove the inode header at hoffset from the index.
+ *
+ ****************************************************************************/
+
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  FAR struct nxffs_index_s **prev;
+  FAR struct nxffs_index_s *idx;
+  int i;
+
+  if (!volume->idxvalid)
+    {
+      return;
+    }
+
+  /* The name is not at hand, removals are rare enough to visit all of the
+   * buckets.
+   */
+
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      for (prev = &volume->index[i]; (idx = *prev) != NULL;
+           prev = &idx->flink)
+        {
+          if (idx->hoffset == hoffset)
+            {
+              *prev = idx->flink;
+              fs_heap_free(idx);
+              return;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Find an inode through the inode index.
+ *
+ ****************************************************************************/
+
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *idx;
+  uint32_t hash;
+  int ret;
+
+  if (!volume->idxvalid && nxffs_idxbuild(volume) < 0)
+    {
+      return -ENOSYS;
+    }
+
+  hash = nxffs_idxhash(name);
+  for (idx = volume->index[hash & NXFFS_INDEX_MASK]; idx != NULL;
+       idx = idx->flink)
+    {
+      if (idx->hash != hash)
+        {
+          continue;
+        }
+
+      ret = nxffs_rdinode(volume, idx->hoffset, entry);
+      if (ret < 0)
+        {
+          /* The index does not match the FLASH, scan it instead */
+
+          ferr("ERROR: Stale inode index at %jd: %d\n",
+               (intmax_t)idx->hoffset, -ret);
+          nxffs_idxinvalidate(volume);
+          return -ENOSYS;
+        }
+
+      if (strcmp(name, entry->name) == 0)
+        {
+          return OK;
+        }
+
+      nxffs_freeentry(entry);
+    }
+
+  return -ENOENT;
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -270,6 +270,7 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+      nxffs_idxbuild(volume);
       return OK;
     }
 
@@ -299,6 +300,7 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+      nxffs_idxbuild(volume);
       return OK;
     }
 
@@ -372,6 +372,14 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+  /* Try the in-RAM index first, it is authoritative if present */
+
+  ret = nxffs_idxfind(volume, name, entry);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -421,6 +429,50 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: nxffs_rdinode
+ *
+ * Description:
+ *   Read and verify the inode header at a known FLASH offset.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   offset - The FLASH offset of the inode header
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no valid
+ *   inode at the offset.
+ *
+ ****************************************************************************/
+
+int nxffs_rdinode(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry)
+{
+  int ret;
+
+  /* Make sure that the block with the inode header is in the cache */
+
+  nxffs_ioseek(volume, offset);
+  ret = nxffs_rdcache(volume, volume->ioblock);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to read block %jd: %d\n",
+           (intmax_t)volume->ioblock, -ret);
+      return ret;
+    }
+
+  /* The magic is not checked by nxffs_rdentry() */
+
+  if (memcmp(&volume->cache[volume->iooffset], g_inodemagic,
+             NXFFS_MAGICSIZE) != 0)
+    {
+      return -ENOENT;
+    }
+
+  return nxffs_rdentry(volume, offset, entry);
+}
+
 /****************************************************************************
  * Name: nxffs_inodeend
  *
@@ -1259,6 +1259,10 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %jd: %d\n",
            (intmax_t)volume->ioblock, -ret);
     }
+  else
+    {
+      nxffs_idxadd(volume, entry->name, entry->hoffset);
+    }
 
   /* The volume is now available for other writers */
 
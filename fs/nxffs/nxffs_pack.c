@@ -1277,6 +1277,12 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   int i;
   int ret = OK;
 
+  /* The inodes are about to move, the index is rebuilt on the next
+   * lookup.
+   */
+
+  nxffs_idxinvalidate(volume);
+
   /* Get the offset to the first valid inode entry */
 
   wrfile = NULL;
@@ -274,6 +274,7 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 
   /* Erase and reformat the entire volume */
 
+  nxffs_idxinvalidate(volume);
   ret = nxffs_format(volume);
   if (ret < 0)
     {
@@ -56,12 +56,18 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_benchmark_operations;
 extern const struct procfs_operations g_clk_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
+extern const struct procfs_operations g_csection_operations;
 extern const struct procfs_operations g_fdt_operations;
+extern const struct procfs_operations g_fgraph_operations;
+extern const struct procfs_operations g_heaptrace_operations;
 extern const struct procfs_operations g_iobinfo_operations;
+extern const struct procfs_operations g_latency_operations;
+extern const struct procfs_operations g_lockstat_operations;
 extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
@@ -69,10 +75,13 @@ extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_profile_operations;
+extern const struct procfs_operations g_smpcall_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -104,6 +113,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#ifdef CONFIG_SCHED_BENCHMARK
+  { "benchmark",    &g_benchmark_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_CLK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CLK)
   { "clk",          &g_clk_operations,      PROCFS_FILE_TYPE   },
 #endif
@@ -121,10 +134,18 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "critmon",      &g_critmon_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+  { "csection",     &g_csection_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_DEVICE_TREE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FDT)
   { "fdt",          &g_fdt_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_FGRAPH
+  { "fgraph",       &g_fgraph_operations,   PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -141,6 +162,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTEHEAP
+  { "heaptrace",    &g_heaptrace_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",      &g_iobinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -149,6 +174,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "irqs",         &g_irq_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  { "latency",      &g_latency_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#if CONFIG_SCHED_LOCKSTAT > 0
+  { "lockstat",     &g_lockstat_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
@@ -187,11 +220,19 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_PROFILER
+  { "profile",      &g_profile_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_SMP) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMPCALL)
+  { "smpcall",      &g_smpcall_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -208,6 +249,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
@@ -0,0 +1,480 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsbenchmark.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/benchmark.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BENCHMARK_LINELEN 256
+
+/* The longest command: "run " and the name of a benchmark */
+
+#define BENCHMARK_CMDLEN  32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct benchmark_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[BENCHMARK_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     benchmark_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     benchmark_close(FAR struct file *filep);
+static ssize_t benchmark_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t benchmark_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     benchmark_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     benchmark_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The output format selected by the last "csv" or "json" command */
+
+static bool g_benchmark_json;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_benchmark_operations =
+{
+  benchmark_open,     /* open */
+  benchmark_close,    /* close */
+  benchmark_read,     /* read */
+  benchmark_write,    /* write */
+  NULL,               /* poll */
+
+  benchmark_dup,      /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  benchmark_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: benchmark_open
+ ****************************************************************************/
+
+static int benchmark_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct benchmark_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct benchmark_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchmark_close
+ ****************************************************************************/
+
+static int benchmark_close(FAR struct file *filep)
+{
+  FAR struct benchmark_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct benchmark_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchmark_format
+ *
+ * Description:
+ *   Format one result as a CSV line or a JSON object.  The change of the
+ *   median against the baseline is in percent, and the throughput of the
+ *   benchmarks that move data in MB/s, from the mean time.
+ *
+ ****************************************************************************/
+
+static size_t benchmark_format(FAR struct benchmark_file_s *attr,
+                               FAR const struct bench_result_s *result,
+                               bool first)
+{
+  uint64_t mbyte_s = 0;
+  int64_t delta = 0;
+  size_t linesize;
+
+  if (result->base > 0)
+    {
+      delta = ((int64_t)result->p50 - (int64_t)result->base) * 100 /
+              (int64_t)result->base;
+    }
+
+  if (result->mean > 0)
+    {
+      mbyte_s = (uint64_t)result->bytes * 1000 / result->mean;
+    }
+
+  if (!g_benchmark_json)
+    {
+      linesize = procfs_snprintf(attr->line, BENCHMARK_LINELEN,
+                                 "%s,%" PRIu32 ",%" PRIu64 ",%" PRIu64
+                                 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                                 ",%" PRIu64,
+                                 result->name, result->iterations,
+                                 result->min, result->p50, result->p90,
+                                 result->p99, result->max, result->mean);
+      if (result->base > 0)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize,
+                                      ",%" PRIu64 ",%" PRId64,
+                                      result->base, delta);
+        }
+      else
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize, ",,");
+        }
+
+      if (result->bytes > 0)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize,
+                                      ",%" PRIu32 ",%" PRIu64 "\n",
+                                      result->bytes, mbyte_s);
+        }
+      else
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize, ",,\n");
+        }
+    }
+  else
+    {
+      linesize = procfs_snprintf(attr->line, BENCHMARK_LINELEN,
+                                 "%s  {\"name\": \"%s\", "
+                                 "\"iterations\": %" PRIu32 ", "
+                                 "\"min\": %" PRIu64 ", "
+                                 "\"p50\": %" PRIu64 ", "
+                                 "\"p90\": %" PRIu64 ", "
+                                 "\"p99\": %" PRIu64 ", "
+                                 "\"max\": %" PRIu64 ", "
+                                 "\"mean\": %" PRIu64,
+                                 first ? "" : ",\n", result->name,
+                                 result->iterations, result->min,
+                                 result->p50, result->p90, result->p99,
+                                 result->max, result->mean);
+      if (result->base > 0)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize,
+                                      ", \"base_p50\": %" PRIu64
+                                      ", \"delta_pct\": %" PRId64,
+                                      result->base, delta);
+        }
+
+      if (result->bytes > 0)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      BENCHMARK_LINELEN - linesize,
+                                      ", \"bytes\": %" PRIu32
+                                      ", \"mbyte_s\": %" PRIu64,
+                                      result->bytes, mbyte_s);
+        }
+
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  BENCHMARK_LINELEN - linesize, "}");
+    }
+
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: benchmark_read
+ *
+ * Description:
+ *   Report the last results, in nanoseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t benchmark_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct benchmark_file_s *attr;
+  struct bench_result_s result;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  bool first = true;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct benchmark_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  if (g_benchmark_json)
+    {
+      linesize = procfs_snprintf(attr->line, BENCHMARK_LINELEN, "[\n");
+    }
+  else
+    {
+      linesize = procfs_snprintf(attr->line, BENCHMARK_LINELEN,
+                                 "name,iterations,min_ns,p50_ns,p90_ns,"
+                                 "p99_ns,max_ns,mean_ns,base_p50_ns,"
+                                 "delta_pct,bytes,mbyte_s\n");
+    }
+
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  for (i = 0; buflen > 0 && bench_get(i, &result) == OK; i++)
+    {
+      if (result.iterations == 0)
+        {
+          continue;
+        }
+
+      linesize = benchmark_format(attr, &result, first);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+      first      = false;
+    }
+
+  if (g_benchmark_json && buflen > 0)
+    {
+      linesize = procfs_snprintf(attr->line, BENCHMARK_LINELEN, "\n]\n");
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: benchmark_write
+ *
+ * Description:
+ *   Accept the commands:
+ *
+ *   run [name]  Run all the benchmarks, or the named one
+ *   baseline    Keep the last results as the baseline
+ *   csv, json   Select the output format
+ *
+ ****************************************************************************/
+
+static ssize_t benchmark_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  char cmd[BENCHMARK_CMDLEN];
+  size_t len = buflen;
+  int ret = OK;
+
+  while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == ' '))
+    {
+      len--;
+    }
+
+  if (len >= sizeof(cmd))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strcmp(cmd, "run") == 0)
+    {
+      ret = bench_run(NULL);
+    }
+  else if (strncmp(cmd, "run ", 4) == 0)
+    {
+      ret = bench_run(cmd + 4);
+    }
+  else if (strcmp(cmd, "baseline") == 0)
+    {
+      bench_baseline();
+    }
+  else if (strcmp(cmd, "csv") == 0)
+    {
+      g_benchmark_json = false;
+    }
+  else if (strcmp(cmd, "json") == 0)
+    {
+      g_benchmark_json = true;
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: benchmark_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int benchmark_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct benchmark_file_s *oldattr;
+  FAR struct benchmark_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct benchmark_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct benchmark_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct benchmark_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchmark_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int benchmark_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "benchmark" is read for the results and written with commands */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_BENCHMARK */
@@ -60,7 +60,11 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CPULOAD_LINELEN 16
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+#  define CPULOAD_LINELEN 32
+#else
+#  define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -211,6 +215,9 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       clock_t active = 0;
       uint32_t intpart;
       uint32_t fracpart;
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+      int cpu;
+#endif
 
       /* Sample the counts for the IDLE thread.  clock_cpuload should only
        * fail if the PID is not valid.  This, however, should never happen
@@ -262,6 +269,38 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
                                  "%3" PRId32 ".%01" PRId32 "%%\n",
                                  intpart, fracpart);
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+      /* Then the part of the load spent in interrupt handlers */
+
+      active = 0;
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          struct cpuload_s irqload;
+
+          DEBUGVERIFY(clock_cpuload_irq(cpu, &irqload));
+          active += irqload.active;
+        }
+
+      if (total > 0 && active <= total)
+        {
+          uint32_t tmp;
+
+          tmp      = (1000 * active) / total;
+          intpart  = tmp / 10;
+          fracpart = tmp - 10 * intpart;
+        }
+      else
+        {
+          intpart  = 0;
+          fracpart = 0;
+        }
+
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  CPULOAD_LINELEN - linesize,
+                                  "%3" PRId32 ".%01" PRId32 "%% irq\n",
+                                  intpart, fracpart);
+#endif
+
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
       attr->linesize = linesize;
@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -59,7 +60,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#define CRITMON_LINELEN 96
 
 /****************************************************************************
  * Private Types
@@ -89,6 +90,11 @@ static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+static ssize_t csection_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -116,6 +122,26 @@ const struct procfs_operations g_critmon_operations =
   critmon_stat        /* stat */
 };
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+const struct procfs_operations g_csection_operations =
+{
+  critmon_open,       /* open */
+  critmon_close,      /* close */
+  csection_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  critmon_dup,        /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  critmon_stat        /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -331,6 +357,82 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: csection_read
+ *
+ * Description:
+ *   Report the code locations that took the global critical section:  The
+ *   caller address, the number of times, and the total and maximum time
+ *   the section was held.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+static ssize_t csection_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct critmon_caller_s *entry;
+  FAR struct critmon_file_s *attr;
+  struct timespec total;
+  struct timespec max;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "%-18s %10s %20s %20s\n",
+                             "CALLER", "COUNT", "TOTAL", "MAX");
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS && buflen > 0;
+       i++)
+    {
+      entry = &g_crit_callers[i];
+      if (entry->caller == NULL)
+        {
+          continue;
+        }
+
+      perf_convert(entry->total, &total);
+      perf_convert(entry->max, &max);
+
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 "%-18p %10" PRIu32 " %10lu.%09lu "
+                                 "%10lu.%09lu\n",
+                                 entry->caller, entry->count,
+                                 (unsigned long)total.tv_sec,
+                                 (unsigned long)total.tv_nsec,
+                                 (unsigned long)max.tv_sec,
+                                 (unsigned long)max.tv_nsec);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_dup
  *
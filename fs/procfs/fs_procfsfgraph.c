@@ -0,0 +1,540 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsfgraph.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/fgraph.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/sched.h>
+#include <nuttx/symtab.h>
+
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_FGRAPH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define FGRAPH_LINELEN 192
+
+/* The most indentation, two spaces per nested call */
+
+#define FGRAPH_INDENT  64
+
+/* The longest command: "filter" and a symbol name */
+
+#define FGRAPH_CMDLEN  80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct fgraph_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  int cpu;                      /* The CPU of the next record to format */
+  int index;                    /* The index of that record */
+  off_t pos;                    /* The file offset where it starts */
+  char line[FGRAPH_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     fgraph_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     fgraph_close(FAR struct file *filep);
+static ssize_t fgraph_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t fgraph_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     fgraph_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     fgraph_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_fgraph_indent[FGRAPH_INDENT + 1] =
+  "                                                                ";
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_fgraph_operations =
+{
+  fgraph_open,      /* open */
+  fgraph_close,     /* close */
+  fgraph_read,      /* read */
+  fgraph_write,     /* write */
+  NULL,             /* poll */
+
+  fgraph_dup,       /* dup */
+
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+
+  fgraph_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fgraph_open
+ ****************************************************************************/
+
+static int fgraph_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct fgraph_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct fgraph_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fgraph_close
+ ****************************************************************************/
+
+static int fgraph_close(FAR struct file *filep)
+{
+  FAR struct fgraph_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct fgraph_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fgraph_symbol
+ *
+ * Description:
+ *   Format the name of a function, from the kernel symbol table if there is
+ *   one; else its address, for the host to resolve.
+ *
+ ****************************************************************************/
+
+static size_t fgraph_symbol(FAR char *buffer, size_t buflen,
+                            FAR void *func)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+  size_t size;
+
+  symbol = allsyms_findbyvalue(func, &size);
+  if (symbol != NULL)
+    {
+      if (symbol->sym_value == func)
+        {
+          return procfs_snprintf(buffer, buflen, "%s", symbol->sym_name);
+        }
+
+      return procfs_snprintf(buffer, buflen, "%s+0x%" PRIxPTR,
+                             symbol->sym_name,
+                             (uintptr_t)func -
+                             (uintptr_t)symbol->sym_value);
+    }
+#endif
+
+  return procfs_snprintf(buffer, buflen, "0x%" PRIxPTR, (uintptr_t)func);
+}
+
+/****************************************************************************
+ * Name: fgraph_format
+ *
+ * Description:
+ *   Format one or two records the way the function_graph tracer of Linux
+ *   prints them: "func() {" at an entry and "}" at an exit, indented by
+ *   the nesting of the call, or "func();" for an entry immediately
+ *   followed by its own exit.  The duration of the call is on the line
+ *   that ends it.
+ *
+ * Returned Value:
+ *   The length of the line; *nrecords is set to the records it covers.
+ *
+ ****************************************************************************/
+
+static size_t fgraph_format(FAR struct fgraph_file_s *attr,
+                            FAR const struct fgraph_record_s *record,
+                            FAR const struct fgraph_record_s *next,
+                            FAR int *nrecords)
+{
+  struct timespec ts;
+  size_t linesize;
+  int indent;
+
+  *nrecords = 1;
+  if (next != NULL && !record->leave && next->leave &&
+      next->func == record->func && next->pid == record->pid &&
+      next->depth == record->depth)
+    {
+      *nrecords = 2;
+    }
+
+  perf_convert(record->time, &ts);
+  linesize = procfs_snprintf(attr->line, FGRAPH_LINELEN,
+                             "%3d) %5d %lu.%06lu | ",
+                             attr->cpu, (int)record->pid,
+                             (unsigned long)ts.tv_sec,
+                             (unsigned long)(ts.tv_nsec / 1000));
+
+  if (*nrecords == 2 || record->leave)
+    {
+      FAR const struct fgraph_record_s *last = *nrecords == 2 ?
+                                               next : record;
+
+      perf_convert(last->duration, &ts);
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  FGRAPH_LINELEN - linesize,
+                                  "%8" PRIu64 " ns | ",
+                                  (uint64_t)ts.tv_sec * NSEC_PER_SEC +
+                                  ts.tv_nsec);
+    }
+  else
+    {
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  FGRAPH_LINELEN - linesize,
+                                  "            | ");
+    }
+
+  indent = 2 * record->depth;
+  if (indent > FGRAPH_INDENT)
+    {
+      indent = FGRAPH_INDENT;
+    }
+
+  linesize += procfs_snprintf(attr->line + linesize,
+                              FGRAPH_LINELEN - linesize, "%s",
+                              &g_fgraph_indent[FGRAPH_INDENT - indent]);
+
+  if (record->leave)
+    {
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  FGRAPH_LINELEN - linesize, "} /* ");
+      linesize += fgraph_symbol(attr->line + linesize,
+                                FGRAPH_LINELEN - linesize, record->func);
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  FGRAPH_LINELEN - linesize, " */\n");
+    }
+  else
+    {
+      linesize += fgraph_symbol(attr->line + linesize,
+                                FGRAPH_LINELEN - linesize, record->func);
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  FGRAPH_LINELEN - linesize, "%s\n",
+                                  *nrecords == 2 ? "();" : "() {");
+    }
+
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: fgraph_read
+ *
+ * Description:
+ *   Report the records of all the CPUs, one CPU after the other.  A read
+ *   that continues where the previous one stopped resumes from the line it
+ *   stopped in, rather than formatting all the lines before it again.
+ *
+ ****************************************************************************/
+
+static ssize_t fgraph_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct fgraph_file_s *attr;
+  struct fgraph_record_s record;
+  struct fgraph_record_s next;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  off_t skip;
+  int nrecords;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct fgraph_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  totalsize = 0;
+
+  if (attr->pos == 0 || filep->f_pos < attr->pos)
+    {
+      offset   = filep->f_pos;
+      linesize = procfs_snprintf(attr->line, FGRAPH_LINELEN,
+                                 "# CPU   PID   TIME(s)       | "
+                                 "DURATION    | FUNCTION CALLS\n");
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      attr->cpu   = 0;
+      attr->index = 0;
+      attr->pos   = linesize;
+    }
+
+  offset = filep->f_pos + totalsize - attr->pos;
+
+  while (buflen > 0 && attr->cpu < CONFIG_SMP_NCPUS)
+    {
+      if (fgraph_get(attr->cpu, attr->index, &record) < 0)
+        {
+          attr->cpu++;
+          attr->index = 0;
+          continue;
+        }
+
+      skip     = offset;
+      linesize = fgraph_format(attr, &record,
+                               fgraph_get(attr->cpu, attr->index + 1,
+                                          &next) < 0 ? NULL : &next,
+                               &nrecords);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      /* Stay on this line if the buffer filled up inside it */
+
+      if (skip + copysize < linesize)
+        {
+          break;
+        }
+
+      attr->pos   += linesize;
+      attr->index += nrecords;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: fgraph_write
+ *
+ * Description:
+ *   Accept the commands:
+ *
+ *   start           Clear the records and trace the calls
+ *   stop            Stop tracing
+ *   filter <func>   Trace only the calls of func and the calls they make,
+ *                   func being a symbol name with CONFIG_ALLSYMS, else a
+ *                   hexadecimal address; more functions can be added
+ *   filter clear    Trace all the calls again
+ *
+ ****************************************************************************/
+
+static ssize_t fgraph_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  char cmd[FGRAPH_CMDLEN];
+  size_t len = buflen;
+  FAR void *func;
+  int ret;
+
+  while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == ' '))
+    {
+      len--;
+    }
+
+  if (len >= sizeof(cmd))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strcmp(cmd, "start") == 0)
+    {
+      fgraph_start();
+    }
+  else if (strcmp(cmd, "stop") == 0)
+    {
+      fgraph_stop();
+    }
+  else if (strcmp(cmd, "filter clear") == 0)
+    {
+      fgraph_filter(NULL);
+    }
+  else if (strncmp(cmd, "filter ", 7) == 0)
+    {
+#ifdef CONFIG_ALLSYMS
+      FAR const struct symtab_s *symbol;
+      size_t size;
+
+      symbol = allsyms_findbyname(cmd + 7, &size);
+      func   = symbol != NULL ? (FAR void *)symbol->sym_value :
+               (FAR void *)strtoul(cmd + 7, NULL, 16);
+#else
+      func   = (FAR void *)strtoul(cmd + 7, NULL, 16);
+#endif
+
+      if (func == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ret = fgraph_filter(func);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: fgraph_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int fgraph_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct fgraph_file_s *oldattr;
+  FAR struct fgraph_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct fgraph_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct fgraph_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct fgraph_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fgraph_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int fgraph_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fgraph" is read for the calls and written with commands */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_FGRAPH */
@@ -0,0 +1,508 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheaptrace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/note/noteheap_driver.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_DRIVERS_NOTEHEAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPTRACE_LINELEN (256 + 4 * CONFIG_DRIVERS_NOTEHEAP_SAMPLES)
+
+/* The longest command or record line written */
+
+#define HEAPTRACE_CMDLEN  64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heaptrace_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[HEAPTRACE_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heaptrace_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     heaptrace_close(FAR struct file *filep);
+static ssize_t heaptrace_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t heaptrace_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     heaptrace_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heaptrace_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The output selected by the last "results" or "trace" command */
+
+static bool g_heaptrace_trace;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_heaptrace_operations =
+{
+  heaptrace_open,     /* open */
+  heaptrace_close,    /* close */
+  heaptrace_read,     /* read */
+  heaptrace_write,    /* write */
+  NULL,               /* poll */
+
+  heaptrace_dup,      /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  heaptrace_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heaptrace_open
+ ****************************************************************************/
+
+static int heaptrace_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct heaptrace_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct heaptrace_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_close
+ ****************************************************************************/
+
+static int heaptrace_close(FAR struct file *filep)
+{
+  FAR struct heaptrace_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heaptrace_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_result
+ *
+ * Description:
+ *   Format the line of the results: the state of the trace, the CSV
+ *   header, then one line per replay.  The fragmentation samples are in
+ *   percent, separated by spaces.  Zero is returned past the last line.
+ *
+ ****************************************************************************/
+
+static size_t heaptrace_result(FAR struct heaptrace_file_s *attr, int line)
+{
+  struct noteheap_status_s status;
+  struct noteheap_result_s result;
+  size_t linesize;
+  int i;
+
+  if (line == 0)
+    {
+      noteheap_status(&status);
+      return procfs_snprintf(attr->line, HEAPTRACE_LINELEN,
+                             "# %s records=%" PRIu32 " dropped=%" PRIu32
+                             " elapsed_ns=%" PRIu64 "\n",
+                             status.recording ? "recording" : "stopped",
+                             status.nrecords, status.dropped,
+                             status.elapsed);
+    }
+  else if (line == 1)
+    {
+      return procfs_snprintf(attr->line, HEAPTRACE_LINELEN,
+                             "allocator,threads,allocs,frees,fails,"
+                             "alloc_p50_ns,alloc_p90_ns,alloc_p99_ns,"
+                             "alloc_max_ns,free_p50_ns,free_p90_ns,"
+                             "free_p99_ns,free_max_ns,elapsed_ns,arena,"
+                             "peak,frag_pct\n");
+    }
+  else if (noteheap_result(line - 2, &result) < 0)
+    {
+      return 0;
+    }
+
+  linesize = procfs_snprintf(attr->line, HEAPTRACE_LINELEN,
+                             "%s,%u,%" PRIu32 ",%" PRIu32 ",%" PRIu32
+                             ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                             ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                             ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                             ",%zu,%zu,",
+                             result.name, result.nthreads, result.nallocs,
+                             result.nfrees, result.nfails,
+                             result.alloc_p50, result.alloc_p90,
+                             result.alloc_p99, result.alloc_max,
+                             result.free_p50, result.free_p90,
+                             result.free_p99, result.free_max,
+                             result.elapsed, result.arena, result.peak);
+
+  for (i = 0; i < CONFIG_DRIVERS_NOTEHEAP_SAMPLES; i++)
+    {
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  HEAPTRACE_LINELEN - linesize,
+                                  i > 0 ? " %u" : "%u", result.frag[i]);
+    }
+
+  linesize += procfs_snprintf(attr->line + linesize,
+                              HEAPTRACE_LINELEN - linesize, "\n");
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: heaptrace_record
+ *
+ * Description:
+ *   Format one record of the trace, in the form heaptrace_write() loads:
+ *
+ *   a <address> <size> <pid>
+ *   f <address> <size> <pid>
+ *
+ *   Zero is returned past the last record.
+ *
+ ****************************************************************************/
+
+static size_t heaptrace_record(FAR struct heaptrace_file_s *attr, int line)
+{
+  struct noteheap_record_s record;
+
+  if (noteheap_record(line, &record) < 0)
+    {
+      return 0;
+    }
+
+  return procfs_snprintf(attr->line, HEAPTRACE_LINELEN,
+                         "%c %p %" PRIu32 " %d\n",
+                         record.alloc ? 'a' : 'f', record.mem,
+                         record.size, (int)record.pid);
+}
+
+/****************************************************************************
+ * Name: heaptrace_read
+ *
+ * Description:
+ *   Report the results of the last replay, or the trace itself.
+ *
+ ****************************************************************************/
+
+static ssize_t heaptrace_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct heaptrace_file_s *attr;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int line;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heaptrace_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  for (line = 0; buflen > 0; line++)
+    {
+      linesize = g_heaptrace_trace ? heaptrace_record(attr, line) :
+                                     heaptrace_result(attr, line);
+      if (linesize == 0)
+        {
+          break;
+        }
+
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heaptrace_command
+ *
+ * Description:
+ *   Run one command, or load one record of the form heaptrace_record()
+ *   formats.  The size and pid of a free are optional.
+ *
+ ****************************************************************************/
+
+static int heaptrace_command(FAR char *cmd)
+{
+  struct noteheap_record_s record;
+  FAR char *endptr;
+
+  if (strcmp(cmd, "start") == 0)
+    {
+      noteheap_start();
+    }
+  else if (strcmp(cmd, "stop") == 0)
+    {
+      noteheap_stop();
+    }
+  else if (strcmp(cmd, "clear") == 0)
+    {
+      noteheap_clear();
+    }
+  else if (strcmp(cmd, "replay") == 0)
+    {
+      return noteheap_replay(CONFIG_DRIVERS_NOTEHEAP_THREADS);
+    }
+  else if (strncmp(cmd, "replay ", 7) == 0)
+    {
+      return noteheap_replay(atoi(cmd + 7));
+    }
+  else if (strcmp(cmd, "results") == 0)
+    {
+      g_heaptrace_trace = false;
+    }
+  else if (strcmp(cmd, "trace") == 0)
+    {
+      g_heaptrace_trace = true;
+    }
+  else if ((cmd[0] == 'a' || cmd[0] == 'f') && cmd[1] == ' ')
+    {
+      memset(&record, 0, sizeof(record));
+      record.alloc = cmd[0] == 'a';
+      record.mem   = (FAR void *)(uintptr_t)strtoul(cmd + 2, &endptr, 16);
+      record.size  = strtoul(endptr, &endptr, 0);
+      record.pid   = strtol(endptr, &endptr, 0);
+
+      if (record.mem == NULL || (record.alloc && record.size == 0))
+        {
+          return -EINVAL;
+        }
+
+      return noteheap_load(&record);
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_write
+ *
+ * Description:
+ *   Accept one command or record per line:
+ *
+ *   start         Clear the trace and record the heaps
+ *   stop          Stop recording
+ *   clear         Clear the trace, to load one
+ *   replay [n]    Replay the trace from one, then n threads
+ *   results       Read the results of the last replay
+ *   trace         Read the trace
+ *   a|f ...       Load a record
+ *
+ ****************************************************************************/
+
+static ssize_t heaptrace_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  char cmd[HEAPTRACE_CMDLEN];
+  FAR const char *end = buffer + buflen;
+  FAR const char *eol;
+  size_t len;
+  int ret;
+
+  while (buffer < end)
+    {
+      eol = memchr(buffer, '\n', end - buffer);
+      len = (eol != NULL ? eol : end) - buffer;
+
+      while (len > 0 && (buffer[len - 1] == ' ' || buffer[len - 1] == '\r'))
+        {
+          len--;
+        }
+
+      if (len >= sizeof(cmd))
+        {
+          return -EINVAL;
+        }
+
+      if (len > 0)
+        {
+          memcpy(cmd, buffer, len);
+          cmd[len] = '\0';
+
+          ret = heaptrace_command(cmd);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      buffer = eol != NULL ? eol + 1 : end;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: heaptrace_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heaptrace_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heaptrace_file_s *oldattr;
+  FAR struct heaptrace_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heaptrace_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct heaptrace_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heaptrace_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heaptrace_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heaptrace" is read for the results or the trace, and written with
+   * commands and records
+   */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_DRIVERS_NOTEHEAP */
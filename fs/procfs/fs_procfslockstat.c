@@ -0,0 +1,353 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslockstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/lockstat.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     CONFIG_SCHED_LOCKSTAT > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[LOCKSTAT_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     lockstat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     lockstat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_lockstat_types[] =
+{
+  "mutex", "sem", "spin"
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_lockstat_operations =
+{
+  lockstat_open,      /* open */
+  lockstat_close,     /* close */
+  lockstat_read,      /* read */
+  lockstat_write,     /* write */
+  NULL,               /* poll */
+
+  lockstat_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  lockstat_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct lockstat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ *
+ * Description:
+ *   Report the contended locks:  The type, the number of contended
+ *   acquisitions, the total and maximum wait and hold times, followed by
+ *   the code locations that waited most often.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct lockstat_file_s *attr;
+  struct lockstat_s stat;
+  struct timespec wait;
+  struct timespec waitmax;
+  struct timespec hold;
+  struct timespec holdmax;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  linesize = procfs_snprintf(attr->line, LOCKSTAT_LINELEN,
+                             "%-18s %-5s %10s %20s %20s %20s %20s\n",
+                             "LOCK", "TYPE", "COUNT", "WAIT", "WAITMAX",
+                             "HOLD", "HOLDMAX");
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  for (i = 0; buflen > 0 && lockstat_get(i, &stat); i++)
+    {
+      if (stat.lock == NULL)
+        {
+          continue;
+        }
+
+      perf_convert(stat.wait, &wait);
+      perf_convert(stat.waitmax, &waitmax);
+      perf_convert(stat.hold, &hold);
+      perf_convert(stat.holdmax, &holdmax);
+
+      linesize = procfs_snprintf(attr->line, LOCKSTAT_LINELEN,
+                                 "%-18p %-5s %10" PRIu32 " %10lu.%09lu "
+                                 "%10lu.%09lu %10lu.%09lu %10lu.%09lu\n",
+                                 stat.lock, g_lockstat_types[stat.type],
+                                 stat.count,
+                                 (unsigned long)wait.tv_sec,
+                                 (unsigned long)wait.tv_nsec,
+                                 (unsigned long)waitmax.tv_sec,
+                                 (unsigned long)waitmax.tv_nsec,
+                                 (unsigned long)hold.tv_sec,
+                                 (unsigned long)hold.tv_nsec,
+                                 (unsigned long)holdmax.tv_sec,
+                                 (unsigned long)holdmax.tv_nsec);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      for (j = 0; j < CONFIG_SCHED_LOCKSTAT_CALLERS && buflen > 0; j++)
+        {
+          if (stat.callers[j].caller == NULL)
+            {
+              continue;
+            }
+
+          linesize = procfs_snprintf(attr->line, LOCKSTAT_LINELEN,
+                                     "  %-16p       %10" PRIu32 "\n",
+                                     stat.callers[j].caller,
+                                     stat.callers[j].count);
+          copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                   &offset);
+
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: lockstat_write
+ *
+ * Description:
+ *   Any write clears the statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  lockstat_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldattr;
+  FAR struct lockstat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct lockstat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct lockstat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct lockstat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "lockstat" is read to get the statistics and written to clear them */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_LOCKSTAT */
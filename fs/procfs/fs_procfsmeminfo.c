@@ -94,6 +94,10 @@ struct progmem_info_s
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 static void    meminfo_progmem(FAR struct progmem_info_s *progmem);
 #endif
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+static size_t  meminfo_histogram(FAR char *line, size_t linesize,
+                 FAR const size_t *count);
+#endif
 
 /* File system methods */
 
@@ -225,6 +229,37 @@ static void meminfo_progmem(FAR struct progmem_info_s *progmem)
 }
 #endif
 
+/****************************************************************************
+ * Name: meminfo_histogram
+ *
+ * Description:
+ *   Append the non-zero counts of a size class histogram to a line as
+ *   "class:count" pairs, class n being the sizes from 2^n to 2^(n+1) - 1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+static size_t meminfo_histogram(FAR char *line, size_t linesize,
+                                FAR const size_t *count)
+{
+  int i;
+
+  for (i = 0; i < MM_FRAG_NCLASSES; i++)
+    {
+      if (count[i] > 0)
+        {
+          linesize += procfs_snprintf(line + linesize,
+                                      MEMINFO_LINELEN - linesize,
+                                      " %d:%lu", i, (unsigned long)count[i]);
+        }
+    }
+
+  linesize += procfs_snprintf(line + linesize, MEMINFO_LINELEN - linesize,
+                              "\n");
+  return linesize;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_open
  ****************************************************************************/
@@ -345,6 +380,49 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* Followed by the fragmentation of the heaps:  The external
+   * fragmentation index with the free chunks of each size class, then the
+   * failed allocations of each size class.
+   */
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      struct mm_fraginfo_s frag;
+
+      if (buflen == 0 || mm_fraginfo(entry->heap, &frag) < 0)
+        {
+          continue;
+        }
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%s frag %d.%d%%, free",
+                                   entry->name, frag.fragindex / 10,
+                                   frag.fragindex % 10);
+      linesize   = meminfo_histogram(procfile->line, linesize, frag.nfree);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+
+      if (buflen > 0)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%s fail", entry->name);
+          linesize   = meminfo_histogram(procfile->line, linesize,
+                                         frag.nfail);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (buflen > 0)
     {
@@ -443,6 +521,9 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 #if CONFIG_MM_BACKTRACE > 0
                   "/on/off"
 #endif
+#ifdef CONFIG_MM_HEAP_PROFILE
+                 "/profile"
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
                  "/leak/pid> <seqmin> <seqmax"
 #endif
@@ -459,6 +540,9 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 #if CONFIG_MM_BACKTRACE > 0
                  "on/off: set backtrace enabled state\n"
 #endif
+#ifdef CONFIG_MM_HEAP_PROFILE
+                 "profile: dump sampled allocations in pprof format\n"
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
                  "leak: dump all leaked node\n"
                  "pid: dump pid allocated node\n"
@@ -604,6 +688,12 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
         break;
 #endif
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+      case 'p':
+        dump.pid = PID_MM_PROFILE;
+        break;
+#endif
+
       case 'o':
         dump.pid = PID_MM_ORPHAN;
 #  if CONFIG_MM_BACKTRACE >= 0
@@ -26,20 +26,39 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <poll.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
+#include <nuttx/psi.h>
 #include <nuttx/queue.h>
 #include <nuttx/spinlock.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PSI
+#  define PRESSURE_NFILES   PSI_NRES
+#else
+#  define PRESSURE_NFILES   1
+#endif
+
+/* Limits of a stall trigger window, as in Linux */
+
+#define PRESSURE_WINDOW_MIN (500 * USEC_PER_MSEC)
+#define PRESSURE_WINDOW_MAX (10 * USEC_PER_SEC)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -52,6 +71,18 @@ struct pressure_file_s
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
+#ifdef CONFIG_SCHED_PSI
+  int res;                          /* The resource of the file */
+  dq_entry_t psientry;              /* Link in the stall trigger list */
+  bool armed;                       /* A stall trigger is set */
+  bool fired;                       /* Fired in the current window */
+  bool pending;                     /* Fired while nobody was polling */
+  uint8_t kind;                     /* PSI_SOME or PSI_FULL */
+  uint64_t stall;                   /* Stall time (us) that fires ... */
+  clock_t window;                   /* ... within a window of this length */
+  clock_t winstart;                 /* Start of the current window */
+  uint64_t winbase;                 /* Stall total at the window start */
+#endif
 };
 
 /****************************************************************************
@@ -59,10 +90,24 @@ struct pressure_file_s
  ****************************************************************************/
 
 static dq_queue_t g_pressure_memory_queue;
+#ifdef CONFIG_SCHED_PSI
+static dq_queue_t g_pressure_psi_queue[PSI_NRES];
+#endif
 static spinlock_t g_pressure_lock;
 static size_t g_remaining;
 static size_t g_largest;
 
+/* The files, indexed by enum psi_res_e */
+
+static FAR const char * const g_pressure_names[PRESSURE_NFILES] =
+{
+#ifdef CONFIG_SCHED_PSI
+  "cpu", "memory", "io"
+#else
+  "memory"
+#endif
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -109,6 +154,179 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_find
+ *
+ * Description:
+ *   Return the index of the file named by relpath, or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int pressure_find(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "pressure/", 9) != 0)
+    {
+      return -ENOENT;
+    }
+
+  for (i = 0; i < PRESSURE_NFILES; i++)
+    {
+      if (strcmp(relpath + 9, g_pressure_names[i]) == 0)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: pressure_link
+ *
+ * Description:
+ *   Put an open file on the lists it belongs to.  Called with
+ *   g_pressure_lock held.
+ *
+ ****************************************************************************/
+
+static void pressure_link(FAR struct pressure_file_s *priv)
+{
+#ifdef CONFIG_SCHED_PSI
+  if (priv->armed)
+    {
+      dq_addfirst(&priv->psientry, &g_pressure_psi_queue[priv->res]);
+    }
+
+  if (priv->res != PSI_MEM)
+    {
+      return;
+    }
+#endif
+
+  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+}
+
+/****************************************************************************
+ * Name: pressure_unlink
+ ****************************************************************************/
+
+static void pressure_unlink(FAR struct pressure_file_s *priv)
+{
+#ifdef CONFIG_SCHED_PSI
+  if (priv->armed)
+    {
+      dq_rem(&priv->psientry, &g_pressure_psi_queue[priv->res]);
+    }
+
+  if (priv->res != PSI_MEM)
+    {
+      return;
+    }
+#endif
+
+  dq_rem(&priv->entry, &g_pressure_memory_queue);
+}
+
+#ifdef CONFIG_SCHED_PSI
+/****************************************************************************
+ * Name: pressure_psi_trigger
+ *
+ * Description:
+ *   Set a stall trigger written as in Linux, "some|full <stall> <window>"
+ *   with both times in us: POLLPRI is raised when the stall time within a
+ *   window reaches the given one, at most once per window.
+ *
+ ****************************************************************************/
+
+static int pressure_psi_trigger(FAR struct pressure_file_s *priv,
+                                FAR const char *buffer, size_t buflen)
+{
+  char buf[64];
+  FAR char *endptr;
+  unsigned long stall;
+  unsigned long window;
+  uint32_t flags;
+  uint8_t kind;
+
+  buflen = MIN(buflen, sizeof(buf) - 1);
+  memcpy(buf, buffer, buflen);
+  buf[buflen] = '\0';
+
+  if (strncmp(buf, "some ", 5) == 0)
+    {
+      kind = PSI_SOME;
+    }
+  else if (strncmp(buf, "full ", 5) == 0)
+    {
+      kind = PSI_FULL;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  stall  = strtoul(buf + 5, &endptr, 0);
+  window = strtoul(endptr, NULL, 0);
+  if (window < PRESSURE_WINDOW_MIN || window > PRESSURE_WINDOW_MAX ||
+      stall == 0 || stall > window)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  pressure_unlink(priv);
+
+  priv->armed    = true;
+  priv->fired    = false;
+  priv->pending  = false;
+  priv->kind     = kind;
+  priv->stall    = stall;
+  priv->window   = USEC2TICK(window);
+  priv->winstart = clock_systime_ticks() - priv->window;
+
+  pressure_link(priv);
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pressure_psi_format
+ ****************************************************************************/
+
+static size_t pressure_psi_format(FAR char *buf, size_t buflen, int res)
+{
+  static FAR const char * const kinds[PSI_NKINDS] =
+  {
+    "some", "full"
+  };
+
+  struct psi_stat_s stat;
+  size_t len = 0;
+  int kind;
+
+  psi_get(res, &stat);
+
+  for (kind = 0; kind < PSI_NKINDS; kind++)
+    {
+      len += procfs_snprintf(buf + len, buflen - len,
+                             "%s avg10=%u.%02u avg60=%u.%02u "
+                             "avg300=%u.%02u total=%" PRIu64 "\n",
+                             kinds[kind],
+                             stat.avg[kind][0] / 100,
+                             stat.avg[kind][0] % 100,
+                             stat.avg[kind][1] / 100,
+                             stat.avg[kind][1] % 100,
+                             stat.avg[kind][2] / 100,
+                             stat.avg[kind][2] % 100,
+                             stat.total[kind]);
+    }
+
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -118,11 +336,13 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int res;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  res = pressure_find(relpath);
+  if (res < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
-      return -ENOENT;
+      return res;
     }
 
   priv = fs_heap_zalloc(sizeof(struct pressure_file_s));
@@ -133,8 +353,11 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
+#ifdef CONFIG_SCHED_PSI
+  priv->res = res;
+#endif
   filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  pressure_link(priv);
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -149,7 +372,7 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  pressure_unlink(priv);
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   fs_heap_free(priv);
   return OK;
@@ -162,20 +385,30 @@ static int pressure_close(FAR struct file *filep)
 static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen)
 {
-  char buf[128];
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  char buf[256];
   uint32_t flags;
   size_t remain;
   size_t largest;
   off_t offset;
-  ssize_t ret;
-
-  flags   = spin_lock_irqsave(&g_pressure_lock);
-  remain  = g_remaining;
-  largest = g_largest;
-  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  ssize_t ret = 0;
+
+#ifdef CONFIG_SCHED_PSI
+  ret = pressure_psi_format(buf, sizeof(buf), priv->res);
+  if (priv->res == PSI_MEM)
+#else
+  UNUSED(priv);
+#endif
+    {
+      flags   = spin_lock_irqsave(&g_pressure_lock);
+      remain  = g_remaining;
+      largest = g_largest;
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
 
-  ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu, largest:%zu\n",
-                        remain, largest);
+      ret += procfs_snprintf(buf + ret, sizeof(buf) - ret,
+                             "remaining %zu, largest:%zu\n",
+                             remain, largest);
+    }
 
   if (ret > buflen)
     {
@@ -207,6 +440,18 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_PSI
+  /* A stall trigger, or for the memory file also the threshold of the
+   * largest free block below.
+   */
+
+  if (priv->res != PSI_MEM || buffer[0] == 's' || buffer[0] == 'f')
+    {
+      int ret = pressure_psi_trigger(priv, buffer, buflen);
+      return ret < 0 ? ret : buflen;
+    }
+#endif
+
   threshold = strtoul(buffer, &endptr, 0);
   if (threshold == 0)
     {
@@ -256,6 +501,18 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
           priv->fds = fds;
           fds->priv = &priv->fds;
 
+#ifdef CONFIG_SCHED_PSI
+          /* A stall trigger that fired while nobody was polling */
+
+          if (priv->pending)
+            {
+              priv->pending = false;
+              spin_unlock_irqrestore(&g_pressure_lock, flags);
+              poll_notify(&priv->fds, 1, POLLPRI);
+              return OK;
+            }
+#endif
+
           /* If the remaining memory is less than the threshold and
            * lasttick is CLOCK_MAX, it means the event is triggered for
            * the first time and we should always send a notification.
@@ -304,8 +561,11 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  pressure_link(newpriv);
   newpriv->fds = NULL;
+#ifdef CONFIG_SCHED_PSI
+  newpriv->pending = false;
+#endif
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
@@ -330,7 +590,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = PRESSURE_NFILES;
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -365,7 +625,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strlcpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -396,7 +657,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_find(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -471,3 +732,57 @@ void mm_notify_pressure(size_t remaining, size_t largest)
   spin_unlock_irqrestore(&g_pressure_lock, flags);
 }
 
+/****************************************************************************
+ * psi_notify_pressure
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PSI
+void psi_notify_pressure(enum psi_res_e res, FAR const uint64_t *total)
+{
+  clock_t current = clock_systime_ticks();
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+  uint32_t flags;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  dq_for_every_safe(&g_pressure_psi_queue[res], entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, psientry);
+
+      /* A window starts at the first stalled sample after the previous
+       * one has ended.
+       */
+
+      if (current - pressure->winstart >= pressure->window)
+        {
+          pressure->winstart = current;
+          pressure->winbase  = total[pressure->kind];
+          pressure->fired    = false;
+        }
+
+      if (pressure->fired ||
+          total[pressure->kind] - pressure->winbase < pressure->stall)
+        {
+          continue;
+        }
+
+      pressure->fired = true;
+
+      /* Keep the event for the next poll if nobody is polling now */
+
+      if (pressure->fds == NULL)
+        {
+          pressure->pending = true;
+          continue;
+        }
+
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
+      poll_notify(&pressure->fds, 1, POLLPRI);
+      flags = spin_lock_irqsave(&g_pressure_lock);
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+#endif
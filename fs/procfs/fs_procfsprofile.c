@@ -0,0 +1,458 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsprofile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/profiler.h>
+#include <nuttx/sched.h>
+#include <nuttx/symtab.h>
+
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_PROFILER)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest sample generated by this logic: its header line
+ * and one line per address.
+ */
+
+#define PROFILE_LINELEN (96 + 96 * CONFIG_SCHED_PROFILER_DEPTH)
+
+/* The longest command: "start" and a rate */
+
+#define PROFILE_CMDLEN  32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct profile_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  int cpu;                      /* The CPU of the next sample to format */
+  int index;                    /* The index of that sample */
+  off_t pos;                    /* The file offset where it starts */
+  char line[PROFILE_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     profile_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     profile_close(FAR struct file *filep);
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t profile_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     profile_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     profile_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The names of the events, as perf names them */
+
+static FAR const char * const g_profile_events[PROFILER_NEVENTS] =
+{
+  "cpu-clock",
+  "cycles",
+  "cache-misses",
+  "branch-misses",
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_profile_operations =
+{
+  profile_open,     /* open */
+  profile_close,    /* close */
+  profile_read,     /* read */
+  profile_write,    /* write */
+  NULL,             /* poll */
+
+  profile_dup,      /* dup */
+
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+
+  profile_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_open
+ ****************************************************************************/
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct profile_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct profile_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_close
+ ****************************************************************************/
+
+static int profile_close(FAR struct file *filep)
+{
+  FAR struct profile_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_format
+ *
+ * Description:
+ *   Format one sample the way "perf script" prints it: a header line, then
+ *   one line per address of the call stack, innermost first, then an
+ *   empty line.  The addresses are resolved with the kernel symbol table
+ *   if there is one; else the symbols are left for the host to resolve.
+ *
+ ****************************************************************************/
+
+static size_t profile_format(FAR struct profile_file_s *attr,
+                             FAR const struct profiler_sample_s *sample)
+{
+  FAR struct tcb_s *tcb;
+  FAR const char *name = "[exited]";
+  struct timespec ts;
+  size_t linesize;
+  int i;
+
+  tcb = nxsched_get_tcb(sample->pid);
+  if (tcb != NULL)
+    {
+      name = get_task_name(tcb);
+    }
+
+  perf_convert(sample->time, &ts);
+
+  linesize = procfs_snprintf(attr->line, PROFILE_LINELEN,
+                             "%s %d [%03u] %lu.%06lu: 1 %s:\n",
+                             name, (int)sample->pid, sample->cpu,
+                             (unsigned long)ts.tv_sec,
+                             (unsigned long)(ts.tv_nsec / 1000),
+                             sample->event < PROFILER_NEVENTS ?
+                             g_profile_events[sample->event] : "unknown");
+
+  for (i = 0; i < sample->depth; i++)
+    {
+#ifdef CONFIG_ALLSYMS
+      FAR const struct symtab_s *symbol;
+      size_t size;
+
+      symbol = allsyms_findbyvalue(sample->stack[i], &size);
+      if (symbol != NULL)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      PROFILE_LINELEN - linesize,
+                                      "\t%16" PRIxPTR " %s+0x%" PRIxPTR
+                                      " (nuttx)\n",
+                                      (uintptr_t)sample->stack[i],
+                                      symbol->sym_name,
+                                      (uintptr_t)sample->stack[i] -
+                                      (uintptr_t)symbol->sym_value);
+          continue;
+        }
+#endif
+
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  PROFILE_LINELEN - linesize,
+                                  "\t%16" PRIxPTR " [unknown] (nuttx)\n",
+                                  (uintptr_t)sample->stack[i]);
+    }
+
+  linesize += procfs_snprintf(attr->line + linesize,
+                              PROFILE_LINELEN - linesize, "\n");
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ *
+ * Description:
+ *   Report the samples of all the CPUs.  A read that continues where the
+ *   previous one stopped resumes from the sample it stopped in, rather
+ *   than formatting all the samples before it again.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct profile_file_s *attr;
+  struct profiler_sample_s sample;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  off_t skip;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  totalsize = 0;
+
+  if (attr->pos == 0 || filep->f_pos < attr->pos)
+    {
+      /* Start from the comment line, that perf tools skip */
+
+      offset   = filep->f_pos;
+      linesize = procfs_snprintf(attr->line, PROFILE_LINELEN,
+                                 "# dropped %" PRIu32 "\n",
+                                 profiler_dropped());
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      attr->cpu   = 0;
+      attr->index = 0;
+      attr->pos   = linesize;
+    }
+
+  offset = filep->f_pos + totalsize - attr->pos;
+
+  while (buflen > 0 && attr->cpu < CONFIG_SMP_NCPUS)
+    {
+      if (profiler_get(attr->cpu, attr->index, &sample) < 0)
+        {
+          attr->cpu++;
+          attr->index = 0;
+          continue;
+        }
+
+      skip     = offset;
+      linesize = profile_format(attr, &sample);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      /* Stay on this sample if the buffer filled up inside it */
+
+      if (skip + copysize < linesize)
+        {
+          break;
+        }
+
+      attr->pos += linesize;
+      attr->index++;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: profile_write
+ *
+ * Description:
+ *   Accept the commands:
+ *
+ *   start [rate]  Clear the samples and sample each CPU rate times per
+ *                 second, or CONFIG_SCHED_PROFILER_RATE times
+ *   stop          Stop sampling
+ *
+ ****************************************************************************/
+
+static ssize_t profile_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen)
+{
+  char cmd[PROFILE_CMDLEN];
+  size_t len = buflen;
+
+  while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == ' '))
+    {
+      len--;
+    }
+
+  if (len >= sizeof(cmd))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strcmp(cmd, "start") == 0)
+    {
+      profiler_start(CONFIG_SCHED_PROFILER_RATE);
+    }
+  else if (strncmp(cmd, "start ", 6) == 0)
+    {
+      profiler_start(strtoul(cmd + 6, NULL, 0));
+    }
+  else if (strcmp(cmd, "stop") == 0)
+    {
+      profiler_stop();
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: profile_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct profile_file_s *oldattr;
+  FAR struct profile_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct profile_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct profile_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct profile_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int profile_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "profile" is read for the samples and written with commands */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_PROFILER */
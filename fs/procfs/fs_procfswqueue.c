@@ -0,0 +1,394 @@
+/****************************************************************************
+ * fs/procfs/fs_procfswqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_WORKQUEUE_STATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WQUEUE_LINELEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[WQUEUE_LINELEN];    /* Pre-allocated buffer for formatted lines */
+  struct work_stats_s stats;    /* The queue being reported */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t wqueue_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     wqueue_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,        /* open */
+  wqueue_close,       /* close */
+  wqueue_read,        /* read */
+  wqueue_write,       /* write */
+  NULL,               /* poll */
+
+  wqueue_dup,         /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  wqueue_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct wqueue_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_emit
+ *
+ * Description:
+ *   Copy a formatted line to the user buffer, from the file offset.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_emit(FAR struct wqueue_file_s *attr,
+                          FAR char **buffer, FAR size_t *buflen,
+                          FAR off_t *offset, FAR const char *fmt, ...)
+{
+  size_t linesize;
+  size_t copysize;
+  va_list ap;
+
+  va_start(ap, fmt);
+  linesize = vsnprintf(attr->line, WQUEUE_LINELEN, fmt, ap);
+  va_end(ap);
+
+  if (linesize >= WQUEUE_LINELEN)
+    {
+      linesize = WQUEUE_LINELEN - 1;
+    }
+
+  copysize = procfs_memcpy(attr->line, linesize, *buffer, *buflen, offset);
+
+  *buffer += copysize;
+  *buflen -= copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ *
+ * Description:
+ *   Report each kernel work queue:  The works run, the total and maximum
+ *   latency and run time, the maximum backlog, the latency histogram and
+ *   the worker functions with the longest runs.
+ *
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct wqueue_file_s *attr;
+  FAR struct work_stats_s *stats;
+  FAR struct work_funcstat_s *func;
+  struct timespec latency;
+  struct timespec latencymax;
+  struct timespec run;
+  struct timespec runmax;
+  size_t totalsize;
+  off_t offset;
+  int qid;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  stats     = &attr->stats;
+  offset    = filep->f_pos;
+  totalsize = wqueue_emit(attr, &buffer, &buflen, &offset,
+                          "%-6s %3s %10s %20s %20s %20s %20s %8s\n",
+                          "QUEUE", "CPU", "COUNT", "LATENCY", "LATENCYMAX",
+                          "RUN", "RUNMAX", "BACKLOG");
+
+  for (qid = HPWORK; qid <= LPWORK && buflen > 0; qid++)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS && buflen > 0; cpu++)
+        {
+          if (work_stats_get(qid, cpu, stats) < 0)
+            {
+              continue;
+            }
+
+          perf_convert(stats->latency, &latency);
+          perf_convert(stats->latencymax, &latencymax);
+          perf_convert(stats->run, &run);
+          perf_convert(stats->runmax, &runmax);
+
+          totalsize += wqueue_emit(attr, &buffer, &buflen, &offset,
+                                   "%-6s %3d %10" PRIu32 " %10lu.%09lu "
+                                   "%10lu.%09lu %10lu.%09lu %10lu.%09lu "
+                                   "%8" PRIu32 "\n",
+                                   qid == HPWORK ? "hpwork" : "lpwork",
+                                   cpu, stats->count,
+                                   (unsigned long)latency.tv_sec,
+                                   (unsigned long)latency.tv_nsec,
+                                   (unsigned long)latencymax.tv_sec,
+                                   (unsigned long)latencymax.tv_nsec,
+                                   (unsigned long)run.tv_sec,
+                                   (unsigned long)run.tv_nsec,
+                                   (unsigned long)runmax.tv_sec,
+                                   (unsigned long)runmax.tv_nsec,
+                                   stats->backlogmax);
+
+          /* The latency histogram, the empty buckets left out */
+
+          for (i = 0; i < WORK_STATS_NBUCKETS && buflen > 0; i++)
+            {
+              if (stats->histogram[i] == 0)
+                {
+                  continue;
+                }
+
+              totalsize += wqueue_emit(attr, &buffer, &buflen, &offset,
+                                       "  %s%-7lu us %10" PRIu32 "\n",
+                                       i < WORK_STATS_NBUCKETS - 1 ?
+                                       "< " : ">=",
+                                       1ul << (i < WORK_STATS_NBUCKETS - 1 ?
+                                               i : i - 1),
+                                       stats->histogram[i]);
+            }
+
+          for (i = 0; i < CONFIG_SCHED_WORKQUEUE_STATS_NWORKERS &&
+                      buflen > 0; i++)
+            {
+              func = &stats->funcs[i];
+              if (func->worker == NULL)
+                {
+                  continue;
+                }
+
+              perf_convert(func->run, &run);
+              perf_convert(func->runmax, &runmax);
+
+              totalsize += wqueue_emit(attr, &buffer, &buflen, &offset,
+                                       "  %-16p %10" PRIu32 " %20s %20s "
+                                       "%10lu.%09lu %10lu.%09lu\n",
+                                       func->worker, func->count, "", "",
+                                       (unsigned long)run.tv_sec,
+                                       (unsigned long)run.tv_nsec,
+                                       (unsigned long)runmax.tv_sec,
+                                       (unsigned long)runmax.tv_nsec);
+            }
+        }
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: wqueue_write
+ *
+ * Description:
+ *   Any write clears the statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t wqueue_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  work_stats_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct wqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is read to get the statistics and written to clear them */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_WORKQUEUE_STATS */
@@ -891,15 +891,9 @@ int romfs_hwconfigure(FAR struct romfs_mountpt_s *rm)
   rm->rm_hwnsectors   = geo.geo_nsectors;
   rm->rm_cachesector  = (uint32_t)-1;
 
-  /* Allocate the device cache buffer for normal sector accesses */
-
-  rm->rm_devbuffer = fs_heap_malloc(rm->rm_hwsectorsize);
-  if (!rm->rm_devbuffer)
-    {
-      return -ENOMEM;
-    }
-
-  /* Determine if block driver supports the XIP mode of operation */
+  /* Determine if block driver supports the XIP mode of operation, e.g. a
+   * FTL over a NOR flash MTD driver that supports MTDIOC_XIPBASE.
+   */
 
   if (inode->u.i_bops->ioctl)
     {
@@ -908,16 +902,32 @@ int romfs_hwconfigure(FAR struct romfs_mountpt_s *rm)
       if (ret >= 0 && rm->rm_xipbase)
         {
           /* Yes.. Then we will directly access the media (vs.
-           * copying into an allocated sector buffer.
+           * copying into an allocated sector buffer.  The device buffer
+           * is then only needed to write the media.
            */
 
           rm->rm_buffer      = rm->rm_xipbase;
           rm->rm_cachesector = 0;
+#ifdef CONFIG_FS_ROMFS_WRITEABLE
+          rm->rm_devbuffer   = fs_heap_malloc(rm->rm_hwsectorsize);
+          if (!rm->rm_devbuffer)
+            {
+              return -ENOMEM;
+            }
+#endif
+
           return 0;
         }
     }
 
-  /* The device cache buffer for normal sector accesses */
+  /* Allocate the device cache buffer for normal sector accesses */
+
+  rm->rm_xipbase   = NULL;
+  rm->rm_devbuffer = fs_heap_malloc(rm->rm_hwsectorsize);
+  if (!rm->rm_devbuffer)
+    {
+      return -ENOMEM;
+    }
 
   rm->rm_buffer = rm->rm_devbuffer;
   return 0;
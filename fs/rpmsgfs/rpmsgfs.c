@@ -38,6 +38,7 @@
 #include <debug.h>
 #include <limits.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -61,6 +62,13 @@ struct rpmsgfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+  FAR char *buf;      /* Records of the last readdir batch */
+  size_t    bufsize;  /* Size of buf */
+  size_t    next;     /* Offset of the next record in buf */
+  int       count;    /* Number of records left in buf */
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  FAR char *path;     /* Host path of the directory */
+#endif
 };
 
 /* This structure describes the state of one open file.  This structure
@@ -73,6 +81,12 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  FAR char                   *buf;     /* Readahead or write-back data */
+  size_t                     buflen;   /* Number of valid bytes in buf */
+  size_t                     bufpos;   /* Bytes of buf already consumed */
+  bool                       dirty;    /* buf holds writes not yet sent */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -87,6 +101,12 @@ struct rpmsgfs_mountpt_s
   char                       fs_root[PATH_MAX];
   void                       *handle;
   int                        timeout;  /* Connect timeout */
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  FAR char                   *attr;    /* Copy of the last readdir batch */
+  size_t                     attrlen;  /* Number of valid bytes in attr */
+  clock_t                    attrtime; /* When the batch was fetched */
+  char                       attrdir[PATH_MAX];
+#endif
 };
 
 /****************************************************************************
@@ -272,6 +292,258 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: rpmsgfs_flushbuf
+ *
+ * Description:
+ *   Bring the host file position back in line with what the user has
+ *   seen: send the buffered writes, or step back over the readahead data
+ *   that was not consumed.  The buffer is empty afterwards.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_flushbuf(FAR struct rpmsgfs_mountpt_s *fs,
+                            FAR struct rpmsgfs_ofile_s *hf)
+{
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  ssize_t ret = OK;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, hf->buf, hf->buflen);
+    }
+  else if (hf->bufpos < hf->buflen)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd,
+                                 -(off_t)(hf->buflen - hf->bufpos),
+                                 SEEK_CUR);
+    }
+
+  hf->buflen = 0;
+  hf->bufpos = 0;
+  hf->dirty  = false;
+  return ret < 0 ? ret : OK;
+#else
+  return OK;
+#endif
+}
+
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+/****************************************************************************
+ * Name: rpmsgfs_bufread
+ *
+ * Description:
+ *   Read through the file buffer.  A read smaller than the buffer fetches
+ *   a whole buffer from the host in one streamed request.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_bufread(FAR struct rpmsgfs_mountpt_s *fs,
+                               FAR struct rpmsgfs_ofile_s *hf,
+                               FAR char *buffer, size_t buflen)
+{
+  ssize_t nread;
+  ssize_t ret;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_flushbuf(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  nread = MIN(buflen, hf->buflen - hf->bufpos);
+  memcpy(buffer, hf->buf + hf->bufpos, nread);
+  hf->bufpos += nread;
+  buffer     += nread;
+  buflen     -= nread;
+  if (buflen == 0)
+    {
+      return nread;
+    }
+
+  if (hf->buf == NULL)
+    {
+      hf->buf = fs_heap_malloc(CONFIG_FS_RPMSGFS_BUFFER_SIZE);
+    }
+
+  if (buflen >= CONFIG_FS_RPMSGFS_BUFFER_SIZE || hf->buf == NULL)
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+    }
+  else
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->buf,
+                                CONFIG_FS_RPMSGFS_BUFFER_SIZE);
+      hf->buflen = ret > 0 ? ret : 0;
+      hf->bufpos = MIN(buflen, hf->buflen);
+      memcpy(buffer, hf->buf, hf->bufpos);
+      if (ret > 0)
+        {
+          ret = hf->bufpos;
+        }
+    }
+
+  if (ret > 0)
+    {
+      nread += ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_bufwrite
+ *
+ * Description:
+ *   Collect small writes in the file buffer, they are sent when the buffer
+ *   fills up or by rpmsgfs_flushbuf().
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_bufwrite(FAR struct rpmsgfs_mountpt_s *fs,
+                                FAR struct rpmsgfs_ofile_s *hf,
+                                FAR const char *buffer, size_t buflen)
+{
+  int ret;
+
+  if (!hf->dirty || hf->buflen + buflen > CONFIG_FS_RPMSGFS_BUFFER_SIZE)
+    {
+      ret = rpmsgfs_flushbuf(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (hf->buf == NULL)
+    {
+      hf->buf = fs_heap_malloc(CONFIG_FS_RPMSGFS_BUFFER_SIZE);
+    }
+
+  if (buflen >= CONFIG_FS_RPMSGFS_BUFFER_SIZE || hf->buf == NULL)
+    {
+      return rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+    }
+
+  memcpy(hf->buf + hf->buflen, buffer, buflen);
+  hf->buflen += buflen;
+  hf->dirty   = true;
+  return buflen;
+}
+#endif
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_drop
+ *
+ * Description:
+ *   Forget the cached attributes, called by every change made through the
+ *   mount.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_drop(FAR struct rpmsgfs_mountpt_s *fs)
+{
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  fs->attrlen = 0;
+#endif
+}
+
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+/****************************************************************************
+ * Name: rpmsgfs_attr_fill
+ *
+ * Description:
+ *   Keep a copy of the readdir batch just fetched for rpmsgfs_stat().
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_fill(FAR struct rpmsgfs_mountpt_s *fs,
+                              FAR struct rpmsgfs_dir_s *rdir)
+{
+  FAR struct rpmsgfs_dirent_s *rec;
+  size_t len = 0;
+  int i;
+
+  for (i = 0; i < rdir->count; i++)
+    {
+      rec = (FAR struct rpmsgfs_dirent_s *)(rdir->buf + len);
+      if (rec->reclen < sizeof(*rec) || len + rec->reclen > rdir->bufsize)
+        {
+          return;
+        }
+
+      len += rec->reclen;
+    }
+
+  if (fs->attr == NULL)
+    {
+      fs->attr = fs_heap_malloc(rdir->bufsize);
+      if (fs->attr == NULL)
+        {
+          return;
+        }
+    }
+
+  memcpy(fs->attr, rdir->buf, len);
+  strlcpy(fs->attrdir, rdir->path, sizeof(fs->attrdir));
+  fs->attrlen  = len;
+  fs->attrtime = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_lookup
+ *
+ * Description:
+ *   Answer a stat() from the attributes of the last readdir batch.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_attr_lookup(FAR struct rpmsgfs_mountpt_s *fs,
+                               FAR const char *path, FAR struct stat *buf)
+{
+  FAR struct rpmsgfs_dirent_s *rec;
+  FAR const char *name;
+  size_t dirlen;
+  size_t off;
+
+  if (fs->attrlen == 0 || clock_systime_ticks() - fs->attrtime >
+      MSEC2TICK(CONFIG_FS_RPMSGFS_ATTR_TIMEOUT))
+    {
+      return -ENOENT;
+    }
+
+  dirlen = strlen(fs->attrdir);
+  if (strncmp(path, fs->attrdir, dirlen) != 0)
+    {
+      return -ENOENT;
+    }
+
+  name = path + dirlen;
+  if (dirlen > 0 && fs->attrdir[dirlen - 1] != '/')
+    {
+      if (*name++ != '/')
+        {
+          return -ENOENT;
+        }
+    }
+
+  for (off = 0; off < fs->attrlen; off += rec->reclen)
+    {
+      rec = (FAR struct rpmsgfs_dirent_s *)(fs->attr + off);
+      if (rec->valid && strcmp(rec->name, name) == 0)
+        {
+          rpmsgfs_client_convert_stat(&rec->buf, buf);
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -315,7 +587,7 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  hf = fs_heap_malloc(sizeof *hf);
+  hf = fs_heap_zalloc(sizeof *hf);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -328,6 +600,11 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Try to open the file in the host file system */
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_attr_drop(fs);
+    }
+
   hf->fd = rpmsgfs_client_open(fs->handle, path, oflags, mode);
   if (hf->fd < 0)
     {
@@ -461,18 +738,22 @@ static int rpmsgfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Send what is still buffered and close the host file */
 
+  ret = rpmsgfs_flushbuf(fs, hf);
   rpmsgfs_client_close(fs->handle, hf->fd);
 
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  fs_heap_free(hf->buf);
+#endif
   fs_heap_free(hf);
 
 okout:
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -509,7 +790,11 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  ret = rpmsgfs_bufread(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -561,7 +846,12 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+  rpmsgfs_attr_drop(fs);
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  ret = rpmsgfs_bufwrite(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -605,7 +895,12 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+  ret = rpmsgfs_flushbuf(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+    }
+
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -648,7 +943,12 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+  ret = rpmsgfs_flushbuf(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+    }
+
   if (ret == 0 && (cmd == FIONBIO || cmd == FIOCLEX || cmd == FIONCLEX))
     {
       ret = -ENOTTY;
@@ -693,10 +993,13 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  /* fsync() is the barrier for the buffered writes */
+
+  ret = rpmsgfs_flushbuf(fs, hf);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -769,7 +1072,11 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
-  ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+  ret = rpmsgfs_flushbuf(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -815,7 +1122,12 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
-  ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+  rpmsgfs_attr_drop(fs);
+  ret = rpmsgfs_flushbuf(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -856,7 +1168,12 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  rpmsgfs_attr_drop(fs);
+  ret = rpmsgfs_flushbuf(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -912,6 +1229,23 @@ static int rpmsgfs_opendir(FAR struct inode *mountpt,
 
   /* Call the host's opendir function */
 
+  rdir->bufsize = rpmsgfs_client_readdir_size(fs->handle);
+  rdir->buf = fs_heap_malloc(rdir->bufsize);
+  if (rdir->buf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  rdir->path = fs_heap_strdup(path);
+  if (rdir->path == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+#endif
+
   rdir->dir = rpmsgfs_client_opendir(fs->handle, path);
   if (rdir->dir == NULL)
     {
@@ -926,6 +1260,10 @@ static int rpmsgfs_opendir(FAR struct inode *mountpt,
 
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  fs_heap_free(rdir->path);
+#endif
+  fs_heap_free(rdir->buf);
 
 errout_with_rdir:
   lib_put_pathbuffer(path);
@@ -969,6 +1307,10 @@ static int rpmsgfs_closedir(FAR struct inode *mountpt,
   rpmsgfs_client_closedir(fs->handle, rdir->dir);
 
   nxmutex_unlock(&fs->fs_lock);
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  fs_heap_free(rdir->path);
+#endif
+  fs_heap_free(rdir->buf);
   fs_heap_free(rdir);
   return OK;
 }
@@ -985,6 +1327,7 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
                            FAR struct dirent *entry)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+  FAR struct rpmsgfs_dirent_s *rec;
   FAR struct rpmsgfs_dir_s *rdir;
   int ret;
 
@@ -1005,10 +1348,43 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
-  /* Call the host OS's readdir function */
+  /* Fetch the next batch of entries from the host when the last one is
+   * used up.
+   */
+
+  if (rdir->count == 0)
+    {
+      ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, rdir->buf,
+                                   rdir->bufsize);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      rdir->count = ret;
+      rdir->next  = 0;
+
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+      rpmsgfs_attr_fill(fs, rdir);
+#endif
+    }
+
+  rec = (FAR struct rpmsgfs_dirent_s *)(rdir->buf + rdir->next);
+  if (rec->reclen < sizeof(*rec) ||
+      rdir->next + rec->reclen > rdir->bufsize)
+    {
+      rdir->count = 0;
+      ret = -EIO;
+      goto out;
+    }
 
-  ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, entry);
+  strlcpy(entry->d_name, rec->name, sizeof(entry->d_name));
+  entry->d_type = rec->type;
+  rdir->next   += rec->reclen;
+  rdir->count--;
+  ret = OK;
 
+out:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -1047,6 +1423,7 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
   /* Call the host and let it do all the work */
 
   rpmsgfs_client_rewinddir(fs->handle, rdir->dir);
+  rdir->count = 0;
 
   nxmutex_unlock(&fs->fs_lock);
   return OK;
@@ -1214,6 +1591,9 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
     }
 
   nxmutex_destroy(&fs->fs_lock);
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  fs_heap_free(fs->attr);
+#endif
   fs_heap_free(fs);
   return 0;
 }
@@ -1291,6 +1671,7 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host fs to perform the unlink */
 
+  rpmsgfs_attr_drop(fs);
   ret = rpmsgfs_client_unlink(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1339,6 +1720,7 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_drop(fs);
   ret = rpmsgfs_client_mkdir(fs->handle, path, mode);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1388,6 +1770,7 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_drop(fs);
   ret = rpmsgfs_client_rmdir(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1448,6 +1831,7 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_drop(fs);
   ret = rpmsgfs_client_rename(fs->handle, oldpath, newpath);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1497,7 +1881,15 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  ret = rpmsgfs_attr_lookup(fs, path, buf);
+  if (ret < 0)
+    {
+      ret = rpmsgfs_client_stat(fs->handle, path, buf);
+    }
+#else
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
+#endif
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
@@ -1545,6 +1937,7 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the chstat operation */
 
+  rpmsgfs_attr_drop(fs);
   ret = rpmsgfs_client_chstat(fs->handle, path, buf, flags);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -61,6 +61,14 @@
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
 
+/* Set in rpmsgfs_readdir_s::type by a client that accepts several
+ * rpmsgfs_dirent_s records per reply, and echoed back by a server that
+ * sent them.  An older server overwrites the field with the d_type of a
+ * single entry, so both sides stay compatible.
+ */
+
+#define RPMSGFS_READDIR_BATCH   0x80000000
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -170,6 +178,17 @@ begin_packed_struct struct rpmsgfs_readdir_s
   char                    name[0];
 } end_packed_struct;
 
+/* One record of a batched readdir reply, result holds the record count */
+
+begin_packed_struct struct rpmsgfs_dirent_s
+{
+  struct rpmsgfs_stat_priv_s buf;    /* Attributes of the entry */
+  uint16_t                   reclen; /* Length of the whole record */
+  uint8_t                    type;   /* d_type of the entry */
+  uint8_t                    valid;  /* Non-zero if buf is filled */
+  char                       name[0];
+} end_packed_struct;
+
 #define rpmsgfs_rewinddir_s rpmsgfs_close_s
 #define rpmsgfs_closedir_s rpmsgfs_close_s
 
@@ -240,7 +259,11 @@ int       rpmsgfs_client_fchstat(FAR void *handle, int fd,
 int       rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length);
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name);
 int       rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                                 FAR struct dirent *entry);
+                                 FAR void *buf, size_t len);
+size_t    rpmsgfs_client_readdir_size(FAR void *handle);
+void      rpmsgfs_client_convert_stat(
+                             FAR const struct rpmsgfs_stat_priv_s *src,
+                             FAR struct stat *buf);
 void      rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp);
 int       rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname);
 int       rpmsgfs_client_unbind(FAR void *handle);
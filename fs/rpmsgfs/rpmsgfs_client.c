@@ -33,6 +33,7 @@
 #include <fcntl.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/semaphore.h>
@@ -56,6 +57,7 @@ struct rpmsgfs_cookie_s
   sem_t    sem;
   int      result;
   FAR void *data;
+  struct rpmsg_rxslot_s slot;
 };
 
 /****************************************************************************
@@ -154,15 +156,23 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
       (struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
   FAR struct rpmsgfs_read_s *rsp = data;
   FAR struct iovec *read = cookie->data;
+  bool handed = false;
+  bool last;
 
   cookie->result = header->result;
+  last = cookie->result <= 0 ||
+         read->iov_len + cookie->result >= rsp->count;
   if (cookie->result > 0)
     {
-      memcpy(read->iov_base + read->iov_len, rsp->buf, cookie->result);
+      /* Let the reader copy the data, the rx thread goes on receiving */
+
+      handed = rpmsg_rxslot_put(ept, &cookie->slot, data,
+                                read->iov_base + read->iov_len, rsp->buf,
+                                cookie->result, last);
       read->iov_len += cookie->result;
     }
 
-  if (cookie->result <= 0 || read->iov_len >= rsp->count)
+  if (handed || last)
     {
       rpmsg_post(ept, &cookie->sem);
     }
@@ -198,13 +208,27 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct rpmsgfs_cookie_s *cookie =
       (struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
   FAR struct rpmsgfs_readdir_s *rsp = data;
-  FAR struct dirent *entry = cookie->data;
+  FAR struct iovec *iov = cookie->data;
+  FAR struct rpmsgfs_dirent_s *rec = iov->iov_base;
 
   cookie->result = header->result;
   if (cookie->result >= 0)
     {
-      strlcpy(entry->d_name, rsp->name, sizeof(entry->d_name));
-      entry->d_type = rsp->type;
+      if ((rsp->type & RPMSGFS_READDIR_BATCH) != 0)
+        {
+          memcpy(iov->iov_base, rsp->name,
+                 MIN(len - sizeof(*rsp), iov->iov_len));
+        }
+      else
+        {
+          /* An older server returns one entry without attributes */
+
+          memset(rec, 0, sizeof(*rec));
+          rec->type = rsp->type;
+          strlcpy(rec->name, rsp->name, iov->iov_len - sizeof(*rec));
+          rec->reclen = ALIGN_UP(sizeof(*rec) + strlen(rec->name) + 1, 8);
+          cookie->result = 1;
+        }
     }
 
   rpmsg_post(ept, &cookie->sem);
@@ -253,22 +277,7 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
   cookie->result = header->result;
   if (cookie->result >= 0)
     {
-      buf->st_dev          = rsp->buf.dev;
-      buf->st_ino          = rsp->buf.ino;
-      buf->st_mode         = rsp->buf.mode;
-      buf->st_nlink        = rsp->buf.nlink;
-      buf->st_uid          = rsp->buf.uid;
-      buf->st_gid          = rsp->buf.gid;
-      buf->st_rdev         = rsp->buf.rdev;
-      buf->st_size         = rsp->buf.size;
-      buf->st_atim.tv_sec  = rsp->buf.atim_sec;
-      buf->st_atim.tv_nsec = rsp->buf.atim_nsec;
-      buf->st_mtim.tv_sec  = rsp->buf.mtim_sec;
-      buf->st_mtim.tv_nsec = rsp->buf.mtim_nsec;
-      buf->st_ctim.tv_sec  = rsp->buf.ctim_sec;
-      buf->st_ctim.tv_nsec = rsp->buf.ctim_nsec;
-      buf->st_blksize      = rsp->buf.blksize;
-      buf->st_blocks       = rsp->buf.blocks;
+      rpmsgfs_client_convert_stat(&rsp->buf, buf);
     }
 
   rpmsg_post(ept, &cookie->sem);
@@ -496,7 +505,12 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       goto out;
     }
 
-  ret = rpmsg_wait(&priv->ept, &cookie.sem);
+  do
+    {
+      ret = rpmsg_wait(&priv->ept, &cookie.sem);
+    }
+  while (ret >= 0 && rpmsg_rxslot_get(&priv->ept, &cookie.slot));
+
   if (ret < 0)
     {
       goto out;
@@ -714,15 +728,56 @@ FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
 }
 
 int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                           FAR struct dirent *entry)
+                           FAR void *buf, size_t len)
 {
+  struct iovec iov =
+  {
+    .iov_base = buf,
+    .iov_len  = len,
+  };
+
   struct rpmsgfs_readdir_s msg =
   {
-    .fd = (uintptr_t)dirp,
+    .fd   = (uintptr_t)dirp,
+    .type = RPMSGFS_READDIR_BATCH,
   };
 
   return rpmsgfs_send_recv(handle, RPMSGFS_READDIR, true,
-          (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), &iov);
+}
+
+size_t rpmsgfs_client_readdir_size(FAR void *handle)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+  int size;
+
+  /* A batch never exceeds one rx buffer, a single entry from an older
+   * server needs room for the longest name.
+   */
+
+  size = rpmsg_get_rx_buffer_size(&priv->ept);
+  return MAX(size, (int)(sizeof(struct rpmsgfs_dirent_s) + NAME_MAX + 1));
+}
+
+void rpmsgfs_client_convert_stat(FAR const struct rpmsgfs_stat_priv_s *src,
+                                 FAR struct stat *buf)
+{
+  buf->st_dev          = src->dev;
+  buf->st_ino          = src->ino;
+  buf->st_mode         = src->mode;
+  buf->st_nlink        = src->nlink;
+  buf->st_uid          = src->uid;
+  buf->st_gid          = src->gid;
+  buf->st_rdev         = src->rdev;
+  buf->st_size         = src->size;
+  buf->st_atim.tv_sec  = src->atim_sec;
+  buf->st_atim.tv_nsec = src->atim_nsec;
+  buf->st_mtim.tv_sec  = src->mtim_sec;
+  buf->st_mtim.tv_nsec = src->mtim_nsec;
+  buf->st_ctim.tv_sec  = src->ctim_sec;
+  buf->st_ctim.tv_nsec = src->ctim_nsec;
+  buf->st_blksize      = src->blksize;
+  buf->st_blocks       = src->blocks;
 }
 
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
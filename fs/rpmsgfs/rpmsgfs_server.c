@@ -36,6 +36,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rpmsg/rpmsg.h>
 
@@ -313,6 +314,85 @@ static FAR void *rpmsgfs_get_dir(
   return dir;
 }
 
+static void rpmsgfs_stat_copy(FAR struct rpmsgfs_stat_priv_s *dst,
+                              FAR const struct stat *src)
+{
+  dst->dev       = src->st_dev;
+  dst->ino       = src->st_ino;
+  dst->mode      = src->st_mode;
+  dst->nlink     = src->st_nlink;
+  dst->uid       = src->st_uid;
+  dst->gid       = src->st_gid;
+  dst->rdev      = src->st_rdev;
+  dst->size      = src->st_size;
+  dst->atim_sec  = src->st_atim.tv_sec;
+  dst->atim_nsec = src->st_atim.tv_nsec;
+  dst->mtim_sec  = src->st_mtim.tv_sec;
+  dst->mtim_nsec = src->st_mtim.tv_nsec;
+  dst->ctim_sec  = src->st_ctim.tv_sec;
+  dst->ctim_nsec = src->st_ctim.tv_nsec;
+  dst->blksize   = src->st_blksize;
+  dst->blocks    = src->st_blocks;
+}
+
+static int rpmsgfs_readdir_batch(FAR struct rpmsg_endpoint *ept,
+                                 FAR struct rpmsgfs_readdir_s *msg,
+                                 FAR DIR *dir)
+{
+  FAR struct rpmsgfs_readdir_s *rsp;
+  FAR struct rpmsgfs_dirent_s *rec;
+  FAR struct dirent *entry;
+  struct stat buf;
+  size_t len = sizeof(*rsp);
+  size_t namelen;
+  uint32_t space;
+  int count = 0;
+
+  /* Pack as many entries as surely fit, each with its attributes, so
+   * that the client can serve a whole "ls -l" from a few replies.
+   */
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp = *msg;
+
+  while (space >= len + sizeof(*rec) + NAME_MAX + 1)
+    {
+      entry = readdir(dir);
+      if (entry == NULL)
+        {
+          break;
+        }
+
+      rec = (FAR struct rpmsgfs_dirent_s *)((FAR char *)rsp + len);
+      namelen = strlen(entry->d_name) + 1;
+      rec->reclen = ALIGN_UP(sizeof(*rec) + namelen, 8);
+      rec->type = entry->d_type;
+      rec->valid = fstatat(dirfd(dir), entry->d_name, &buf, 0) >= 0;
+      if (rec->valid)
+        {
+          rpmsgfs_stat_copy(&rec->buf, &buf);
+        }
+
+      memcpy(rec->name, entry->d_name, namelen);
+      len += rec->reclen;
+      count++;
+    }
+
+  rsp->type = RPMSGFS_READDIR_BATCH;
+  rsp->header.result = count > 0 ? count : -ENOENT;
+  if (rpmsg_send_nocopy(ept, rsp, len) < 0)
+    {
+      rpmsg_release_tx_buffer(ept, rsp);
+    }
+
+  return 0;
+}
+
 static int rpmsgfs_open_handler(FAR struct rpmsg_endpoint *ept,
                                 FAR void *data, size_t len,
                                 uint32_t src, FAR void *priv)
@@ -538,22 +618,7 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_fstat(filep, &buf);
       if (ret >= 0)
         {
-          msg->buf.dev       = buf.st_dev;
-          msg->buf.ino       = buf.st_ino;
-          msg->buf.mode      = buf.st_mode;
-          msg->buf.nlink     = buf.st_nlink;
-          msg->buf.uid       = buf.st_uid;
-          msg->buf.gid       = buf.st_gid;
-          msg->buf.rdev      = buf.st_rdev;
-          msg->buf.size      = buf.st_size;
-          msg->buf.atim_sec  = buf.st_atim.tv_sec;
-          msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-          msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-          msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-          msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-          msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-          msg->buf.blksize   = buf.st_blksize;
-          msg->buf.blocks    = buf.st_blocks;
+          rpmsgfs_stat_copy(&msg->buf, &buf);
         }
     }
 
@@ -612,6 +677,11 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   size_t size;
 
   dir = rpmsgfs_get_dir(priv, msg->fd);
+  if (dir && (msg->type & RPMSGFS_READDIR_BATCH) != 0)
+    {
+      return rpmsgfs_readdir_batch(ept, msg, dir);
+    }
+
   if (dir)
     {
       entry = readdir(dir);
@@ -759,22 +829,7 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
   ret = nx_stat(msg->pathname, &buf, 1);
   if (ret >= 0)
     {
-      msg->buf.dev       = buf.st_dev;
-      msg->buf.ino       = buf.st_ino;
-      msg->buf.mode      = buf.st_mode;
-      msg->buf.nlink     = buf.st_nlink;
-      msg->buf.uid       = buf.st_uid;
-      msg->buf.gid       = buf.st_gid;
-      msg->buf.rdev      = buf.st_rdev;
-      msg->buf.size      = buf.st_size;
-      msg->buf.atim_sec  = buf.st_atim.tv_sec;
-      msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-      msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-      msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-      msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-      msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-      msg->buf.blksize   = buf.st_blksize;
-      msg->buf.blocks    = buf.st_blocks;
+      rpmsgfs_stat_copy(&msg->buf, &buf);
     }
 
   msg->header.result = ret;
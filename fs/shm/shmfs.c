@@ -29,8 +29,11 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/map.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/sched.h>
+#include <nuttx/shmring.h>
 
 #include "shm/shmfs.h"
 #include "inode/inode.h"
@@ -46,6 +49,9 @@ static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen);
 static int shmfs_truncate(FAR struct file *filep, off_t length);
+#ifdef CONFIG_FS_SHMFS_RING
+static int shmfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#endif
 
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int shmfs_unlink(FAR struct inode *inode);
@@ -69,7 +75,11 @@ const struct file_operations g_shmfs_operations =
   shmfs_read,       /* read */
   shmfs_write,      /* write */
   NULL,             /* seek */
+#ifdef CONFIG_FS_SHMFS_RING
+  shmfs_ioctl,      /* ioctl */
+#else
   NULL,             /* ioctl */
+#endif
   shmfs_mmap,       /* mmap */
   shmfs_truncate,   /* truncate */
   NULL,             /* poll */
@@ -249,6 +259,104 @@ static int shmfs_truncate(FAR struct file *filep, off_t length)
   return ret;
 }
 
+/****************************************************************************
+ * Name: shmfs_wait
+ *
+ * Description:
+ *   Sleep until shmfs_wake() if the word still holds the value.  The word
+ *   is in the caller's mapping of the object, and it is read with the
+ *   wake ups held off, so that a wake up after the caller changed the word
+ *   cannot be lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SHMFS_RING
+static int shmfs_wait(FAR struct shmfs_object_s *object,
+                      FAR struct shmring_wait_s *wait)
+{
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  if (atomic_read(wait->addr) != wait->val)
+    {
+      ret = -EAGAIN;
+    }
+  else if (wait->timeout < 0)
+    {
+      ret = nxsem_wait(&object->waitsem);
+    }
+  else
+    {
+      ret = nxsem_tickwait(&object->waitsem, MSEC2TICK(wait->timeout));
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmfs_wake
+ *
+ * Description:
+ *   Wake up to nwake waiters of the object and return how many were woken.
+ *
+ ****************************************************************************/
+
+static int shmfs_wake(FAR struct shmfs_object_s *object, int nwake)
+{
+  irqstate_t flags;
+  int woken = 0;
+  int sval;
+
+  flags = enter_critical_section();
+
+  nxsem_get_value(&object->waitsem, &sval);
+  while (sval < 0 && woken < nwake)
+    {
+      nxsem_post(&object->waitsem);
+      sval++;
+      woken++;
+    }
+
+  leave_critical_section(flags);
+  return woken;
+}
+
+/****************************************************************************
+ * Name: shmfs_ioctl
+ ****************************************************************************/
+
+static int shmfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+
+  switch (cmd)
+    {
+      case FIOC_SHMWAIT:
+        if (object == NULL)
+          {
+            return -EINVAL;
+          }
+
+        return shmfs_wait(object,
+                          (FAR struct shmring_wait_s *)(uintptr_t)arg);
+
+      case FIOC_SHMWAKE:
+        if (object == NULL)
+          {
+            return -EINVAL;
+          }
+
+        return shmfs_wake(object, (int)arg);
+
+      default:
+        return -ENOTTY;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: shmfs_unlink
  ****************************************************************************/
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
 
 /****************************************************************************
  * Public Data
@@ -45,6 +46,12 @@ struct shmfs_object_s
 
   size_t length;
 
+#ifdef CONFIG_FS_SHMFS_RING
+  /* The waiters of FIOC_SHMWAIT */
+
+  sem_t waitsem;
+#endif
+
   /* Vector of allocations from physical memory.
    *
    * - In flat and protected builds this is a pointer to the
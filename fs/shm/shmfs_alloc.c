@@ -142,6 +142,9 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
   if (allocated)
     {
       object->length = length;
+#ifdef CONFIG_FS_SHMFS_RING
+      nxsem_init(&object->waitsem, 0, 0);
+#endif
     }
   else
     {
@@ -158,6 +161,10 @@ void shmfs_free_object(FAR struct shmfs_object_s *object)
 {
   if (object)
     {
+#ifdef CONFIG_FS_SHMFS_RING
+      nxsem_destroy(&object->waitsem);
+#endif
+
 #if defined(CONFIG_BUILD_PROTECTED)
       kumm_free(object->paddr);
 #elif defined(CONFIG_BUILD_KERNEL)
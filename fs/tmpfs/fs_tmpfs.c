@@ -54,10 +54,6 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
-
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -94,8 +90,6 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
-              size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -268,84 +262,6 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
-/****************************************************************************
- * Name: tmpfs_realloc_file
- ****************************************************************************/
-
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
-                              size_t newsize)
-{
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
-
-  /* Are we growing or shrinking the object? */
-
-  if (newsize <= tfo->tfo_alloc)
-    {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
-
-      if (newsize == 0)
-        {
-          /* Free the file object */
-
-          fs_heap_free(tfo->tfo_data);
-          tfo->tfo_data = NULL;
-          tfo->tfo_alloc = 0;
-          tfo->tfo_size = 0;
-          return OK;
-        }
-      else if (newsize > 0)
-        {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
-
-          delta = tfo->tfo_alloc - newsize;
-
-          /* We should make sure the shrunked memory be zero */
-
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
-
-              tfo->tfo_size = newsize;
-              return OK;
-            }
-        }
-    }
-
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
-
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-  if (allocsize < newsize)
-    {
-      /* There must have been an integer overflow */
-
-      return -ENOMEM;
-    }
-
-  /* Realloc the file object */
-
-  newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
-    {
-      return -ENOMEM;
-    }
-
-  /* Return the new address of the reallocated file object */
-
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
-  return OK;
-}
-
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -383,7 +299,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_page_truncate(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -582,7 +498,6 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
-  tfo->tfo_data   = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1189,7 +1104,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1265,7 +1184,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_page_truncate(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1438,11 +1357,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(tfo, 0);
-              if (ret < 0)
-                {
-                  goto errout_with_filelock;
-                }
+              tmpfs_page_truncate(tfo, 0);
             }
         }
     }
@@ -1584,17 +1499,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  nread = tmpfs_page_read(tfo, buffer, startpos, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1642,29 +1550,21 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       startpos = filep->f_pos;
     }
 
-  nwritten = buflen;
-  endpos   = startpos + buflen;
+  /* Copy data from the user buffer to the file pages, a write past the
+   * end of the file leaves a hole.
+   */
 
-  if (endpos > tfo->tfo_size)
+  nwritten = tmpfs_page_write(tfo, buffer, startpos, buflen);
+  if (nwritten < 0)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
-
-      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
+      ret = nwritten;
+      goto errout_with_lock;
     }
 
-  /* Copy data from the memory object to the user buffer */
-
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
+  endpos = startpos + nwritten;
+  if (endpos > tfo->tfo_size)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      tfo->tfo_size = endpos;
     }
 
   filep->f_pos = endpos;
@@ -1753,20 +1653,23 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
       ret = mm_map_remove(get_group_mm(group), entry);
       if (ret >= 0)
         {
-          ret = tmpfs_release_file(tfo);
+          ret = tmpfs_lock_file(tfo);
+          if (ret >= 0)
+            {
+              tmpfs_page_unmap(tfo, entry->vaddr);
+              tmpfs_release_lockedfile(tfo);
+            }
         }
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  The file itself is not changed.
    */
 
   else
     {
       entry->length = offset;
-      tmpfs_lock_file(tfo);
-      ret = tmpfs_realloc_file(tfo, offset);
-      tmpfs_unlock_file(tfo);
+      ret = OK;
     }
 
   return ret;
@@ -1785,22 +1688,43 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Map the file pages directly.  The pages of the range are gathered in
+   * one run if needed, the run is shared by the mapping and the file.
+   */
+
+  ret = -EINVAL;
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      map->vaddr = tmpfs_page_map(tfo, map->offset, map->length, true);
+      if (map->vaddr == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
 
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
+        }
+      else
+        {
+          tmpfs_page_unmap(tfo, map->vaddr);
         }
     }
 
+errout_with_lock:
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1842,8 +1766,26 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
-      *ptr = (uintptr_t)tfo->tfo_data;
-      return OK;
+      /* Gather the whole file in one run of pages */
+
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      *ptr = 0;
+      if (tfo->tfo_size > 0)
+        {
+          *ptr = (uintptr_t)tmpfs_page_map(tfo, 0, tfo->tfo_size, false);
+          if (*ptr == 0)
+            {
+              ret = -ENOMEM;
+            }
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   return ret;
@@ -1968,29 +1910,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Shrinking releases the pages
+       * past the end, growing only leaves a hole.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      tmpfs_page_truncate(tfo, length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2426,7 +2354,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_page_truncate(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/fs/fs.h>
@@ -42,6 +43,15 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data pages and their radix index */
+
+#define TMPFS_PAGESIZE     CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_PAGEMASK     (TMPFS_PAGESIZE - 1)
+
+#define TMPFS_RADIX_SHIFT  4
+#define TMPFS_RADIX_FANOUT (1 << TMPFS_RADIX_SHIFT)
+#define TMPFS_RADIX_MASK   (TMPFS_RADIX_FANOUT - 1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -105,6 +115,20 @@ struct tmpfs_directory_s
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
 
+/* A run of contiguous pages allocated to give mmap() a linear view of a
+ * file range.  The pages of the run are referenced from the file page
+ * index like any other page.
+ */
+
+struct tmpfs_chunk_s
+{
+  FAR struct tmpfs_chunk_s *tc_next;
+  size_t        tc_npages; /* Pages still in the file page index */
+  size_t        tc_size;   /* Total number of pages */
+  unsigned int  tc_maps;   /* Number of mappings of the run */
+  FAR uint8_t  *tc_data;   /* First page of the run */
+};
+
 /* The form of a regular file memory object
  *
  * NOTE that in this very simplified implementation, there is no per-open
@@ -126,9 +150,14 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;  /* See TFO_FLAG_* definitions */
+  uint8_t       tfo_height; /* Height of the page index */
+  size_t        tfo_size;   /* Valid file size */
+  FAR void     *tfo_root;   /* Page index, the missing pages are holes */
+
+  /* Runs of contiguous pages shared with the mmap() mappings */
+
+  FAR struct tmpfs_chunk_s *tfo_chunks;
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -177,6 +206,18 @@ EXTERN const struct mountpt_operations g_tmpfs_operations;
  * Public Function Prototypes
  ****************************************************************************/
 
+/* File page management, the caller holds the file lock */
+
+ssize_t tmpfs_page_read(FAR struct tmpfs_file_s *tfo, FAR void *buffer,
+                        off_t offset, size_t buflen);
+ssize_t tmpfs_page_write(FAR struct tmpfs_file_s *tfo,
+                         FAR const void *buffer, off_t offset,
+                         size_t buflen);
+void tmpfs_page_truncate(FAR struct tmpfs_file_s *tfo, off_t length);
+FAR uint8_t *tmpfs_page_map(FAR struct tmpfs_file_s *tfo, off_t offset,
+                            size_t length, bool pin);
+void tmpfs_page_unmap(FAR struct tmpfs_file_s *tfo, FAR const void *vaddr);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,522 @@
+/****************************************************************************
+ * fs/tmpfs/fs_tmpfspage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "fs_tmpfs.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (TMPFS_PAGESIZE & TMPFS_PAGEMASK) != 0
+#  error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
+#endif
+
+#define TMPFS_NODESIZE (TMPFS_RADIX_FANOUT * sizeof(FAR void *))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tmpfs_page_capacity
+ *
+ * Description:
+ *   Return the number of pages covered by an index of the given height.
+ *   A zero height index is a single page.
+ *
+ ****************************************************************************/
+
+static size_t tmpfs_page_capacity(unsigned int height)
+{
+  if (height * TMPFS_RADIX_SHIFT >= sizeof(size_t) * 8)
+    {
+      return SIZE_MAX;
+    }
+
+  return (size_t)1 << (height * TMPFS_RADIX_SHIFT);
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_slot
+ *
+ * Description:
+ *   Return the index slot of the page, growing the index if alloc is true.
+ *   NULL is returned if the slot does not exist or cannot be allocated.
+ *
+ ****************************************************************************/
+
+static FAR void **tmpfs_page_slot(FAR struct tmpfs_file_s *tfo,
+                                  size_t index, bool alloc)
+{
+  FAR void **node;
+  FAR void **slot;
+  int level;
+
+  while (index >= tmpfs_page_capacity(tfo->tfo_height))
+    {
+      if (!alloc)
+        {
+          return NULL;
+        }
+
+      /* Add a level on top, the old root becomes its first child */
+
+      if (tfo->tfo_root != NULL)
+        {
+          node = fs_heap_zalloc(TMPFS_NODESIZE);
+          if (node == NULL)
+            {
+              return NULL;
+            }
+
+          node[0]       = tfo->tfo_root;
+          tfo->tfo_root = node;
+        }
+
+      tfo->tfo_height++;
+    }
+
+  slot = &tfo->tfo_root;
+  for (level = tfo->tfo_height - 1; level >= 0; level--)
+    {
+      if (*slot == NULL)
+        {
+          if (!alloc)
+            {
+              return NULL;
+            }
+
+          *slot = fs_heap_zalloc(TMPFS_NODESIZE);
+          if (*slot == NULL)
+            {
+              return NULL;
+            }
+        }
+
+      node = *slot;
+      slot = &node[(index >> (level * TMPFS_RADIX_SHIFT)) &
+                   TMPFS_RADIX_MASK];
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_lookup
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_page_lookup(FAR struct tmpfs_file_s *tfo,
+                                      size_t index)
+{
+  FAR void **slot = tmpfs_page_slot(tfo, index, false);
+
+  return slot != NULL ? *slot : NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_findchunk
+ ****************************************************************************/
+
+static FAR struct tmpfs_chunk_s **
+tmpfs_page_findchunk(FAR struct tmpfs_file_s *tfo, FAR const uint8_t *addr)
+{
+  FAR struct tmpfs_chunk_s **pp;
+
+  for (pp = &tfo->tfo_chunks; *pp != NULL; pp = &(*pp)->tc_next)
+    {
+      if (addr >= (*pp)->tc_data &&
+          addr < (*pp)->tc_data + (*pp)->tc_size * TMPFS_PAGESIZE)
+        {
+          return pp;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_release
+ *
+ * Description:
+ *   Release a page removed from the index.  A page of a run is freed with
+ *   the last page of the run that is neither indexed nor mapped.
+ *
+ ****************************************************************************/
+
+static void tmpfs_page_release(FAR struct tmpfs_file_s *tfo,
+                               FAR uint8_t *page)
+{
+  FAR struct tmpfs_chunk_s **pp;
+  FAR struct tmpfs_chunk_s *chunk;
+
+  tfo->tfo_alloc -= TMPFS_PAGESIZE;
+
+  pp = tmpfs_page_findchunk(tfo, page);
+  if (pp == NULL)
+    {
+      fs_heap_free(page);
+      return;
+    }
+
+  chunk = *pp;
+  if (--chunk->tc_npages == 0 && chunk->tc_maps == 0)
+    {
+      *pp = chunk->tc_next;
+      fs_heap_free(chunk);
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_trim
+ *
+ * Description:
+ *   Release the pages from index first in the subtree of the given height
+ *   at *slot that covers the pages from index base.  The emptied index
+ *   nodes are freed too.
+ *
+ ****************************************************************************/
+
+static void tmpfs_page_trim(FAR struct tmpfs_file_s *tfo, FAR void **slot,
+                            unsigned int height, size_t base, size_t first)
+{
+  FAR void **node;
+  size_t cap;
+  int i;
+
+  if (height == 0)
+    {
+      if (base >= first)
+        {
+          tmpfs_page_release(tfo, *slot);
+          *slot = NULL;
+        }
+
+      return;
+    }
+
+  node = *slot;
+  cap  = tmpfs_page_capacity(height - 1);
+
+  for (i = 0; i < TMPFS_RADIX_FANOUT; i++, base += cap)
+    {
+      if (node[i] != NULL && base + cap > first)
+        {
+          tmpfs_page_trim(tfo, &node[i], height - 1, base, first);
+        }
+    }
+
+  for (i = 0; i < TMPFS_RADIX_FANOUT && node[i] == NULL; i++);
+
+  if (i == TMPFS_RADIX_FANOUT)
+    {
+      fs_heap_free(node);
+      *slot = NULL;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tmpfs_page_read
+ *
+ * Description:
+ *   Copy the file data to the buffer, the holes read as zeros.
+ *
+ ****************************************************************************/
+
+ssize_t tmpfs_page_read(FAR struct tmpfs_file_s *tfo, FAR void *buffer,
+                        off_t offset, size_t buflen)
+{
+  FAR uint8_t *dest = buffer;
+  FAR uint8_t *page;
+  size_t pgoff;
+  size_t n;
+
+  while (buflen > 0)
+    {
+      pgoff = offset & TMPFS_PAGEMASK;
+      n     = MIN(buflen, TMPFS_PAGESIZE - pgoff);
+      page  = tmpfs_page_lookup(tfo, offset / TMPFS_PAGESIZE);
+
+      if (page != NULL)
+        {
+          memcpy(dest, page + pgoff, n);
+        }
+      else
+        {
+          memset(dest, 0, n);
+        }
+
+      dest   += n;
+      offset += n;
+      buflen -= n;
+    }
+
+  return dest - (FAR uint8_t *)buffer;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_write
+ *
+ * Description:
+ *   Copy the buffer to the file pages, allocating the missing ones.  The
+ *   file size is not changed.
+ *
+ * Returned Value:
+ *   The number of bytes written, -ENOMEM if no byte could be written.
+ *
+ ****************************************************************************/
+
+ssize_t tmpfs_page_write(FAR struct tmpfs_file_s *tfo,
+                         FAR const void *buffer, off_t offset,
+                         size_t buflen)
+{
+  FAR const uint8_t *src = buffer;
+  FAR void **slot;
+  size_t pgoff;
+  size_t n;
+
+  while (buflen > 0)
+    {
+      pgoff = offset & TMPFS_PAGEMASK;
+      n     = MIN(buflen, TMPFS_PAGESIZE - pgoff);
+      slot  = tmpfs_page_slot(tfo, offset / TMPFS_PAGESIZE, true);
+      if (slot == NULL)
+        {
+          break;
+        }
+
+      if (*slot == NULL)
+        {
+          /* A new page, the parts not written must read as zeros */
+
+          *slot = fs_heap_zalloc(TMPFS_PAGESIZE);
+          if (*slot == NULL)
+            {
+              break;
+            }
+
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+
+      memcpy((FAR uint8_t *)*slot + pgoff, src, n);
+
+      src    += n;
+      offset += n;
+      buflen -= n;
+    }
+
+  if (src == buffer && buflen > 0)
+    {
+      return -ENOMEM;
+    }
+
+  return src - (FAR const uint8_t *)buffer;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_truncate
+ *
+ * Description:
+ *   Set the file size.  The pages past the new end of file are released
+ *   and the rest of the last page is cleared so that a later extension
+ *   reads zeros.  Growing the file only creates a hole.
+ *
+ ****************************************************************************/
+
+void tmpfs_page_truncate(FAR struct tmpfs_file_s *tfo, off_t length)
+{
+  FAR uint8_t *page;
+  size_t pgoff;
+
+  if (tfo->tfo_root != NULL)
+    {
+      tmpfs_page_trim(tfo, &tfo->tfo_root, tfo->tfo_height, 0,
+                      (length + TMPFS_PAGEMASK) / TMPFS_PAGESIZE);
+      if (tfo->tfo_root == NULL)
+        {
+          tfo->tfo_height = 0;
+        }
+    }
+
+  pgoff = length & TMPFS_PAGEMASK;
+  if (pgoff != 0)
+    {
+      page = tmpfs_page_lookup(tfo, length / TMPFS_PAGESIZE);
+      if (page != NULL)
+        {
+          memset(page + pgoff, 0, TMPFS_PAGESIZE - pgoff);
+        }
+    }
+
+  tfo->tfo_size = length;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_map
+ *
+ * Description:
+ *   Return a linear view of the file range for mmap().  If the pages of
+ *   the range are not already contiguous, they are moved to a new run of
+ *   contiguous pages that replaces them in the index, so that the mapping
+ *   and the file share the same memory.  With pin, the run is kept until
+ *   tmpfs_page_unmap() even if the file is truncated.
+ *
+ * Returned Value:
+ *   The address of offset or NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *tmpfs_page_map(FAR struct tmpfs_file_s *tfo, off_t offset,
+                            size_t length, bool pin)
+{
+  FAR struct tmpfs_chunk_s **pp;
+  FAR struct tmpfs_chunk_s *chunk;
+  FAR uint8_t *page;
+  FAR uint8_t *old;
+  FAR void **slot;
+  size_t first;
+  size_t npages;
+  size_t i;
+
+  first  = offset / TMPFS_PAGESIZE;
+  npages = (offset + length + TMPFS_PAGEMASK) / TMPFS_PAGESIZE - first;
+
+  /* Check if the range is already in one run */
+
+  page = tmpfs_page_lookup(tfo, first);
+  pp   = page != NULL ? tmpfs_page_findchunk(tfo, page) : NULL;
+  if (pp != NULL &&
+      page + npages * TMPFS_PAGESIZE <=
+      (*pp)->tc_data + (*pp)->tc_size * TMPFS_PAGESIZE)
+    {
+      for (i = 1; i < npages; i++)
+        {
+          if (tmpfs_page_lookup(tfo, first + i) !=
+              page + i * TMPFS_PAGESIZE)
+            {
+              break;
+            }
+        }
+
+      if (i == npages)
+        {
+          chunk = *pp;
+          goto out;
+        }
+    }
+
+  /* Make sure that all the index slots exist before touching the pages */
+
+  for (i = 0; i < npages; i++)
+    {
+      if (tmpfs_page_slot(tfo, first + i, true) == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  chunk = fs_heap_malloc(sizeof(*chunk) + npages * TMPFS_PAGESIZE);
+  if (chunk == NULL)
+    {
+      return NULL;
+    }
+
+  chunk->tc_npages = npages;
+  chunk->tc_size   = npages;
+  chunk->tc_maps   = 0;
+  chunk->tc_data   = (FAR uint8_t *)(chunk + 1);
+  chunk->tc_next   = tfo->tfo_chunks;
+  tfo->tfo_chunks  = chunk;
+
+  /* Move the pages to the run, the holes are filled with zeros */
+
+  for (i = 0; i < npages; i++)
+    {
+      page = chunk->tc_data + i * TMPFS_PAGESIZE;
+      slot = tmpfs_page_slot(tfo, first + i, false);
+      old  = *slot;
+
+      if (old != NULL)
+        {
+          memcpy(page, old, TMPFS_PAGESIZE);
+          tmpfs_page_release(tfo, old);
+        }
+      else
+        {
+          memset(page, 0, TMPFS_PAGESIZE);
+        }
+
+      *slot = page;
+      tfo->tfo_alloc += TMPFS_PAGESIZE;
+    }
+
+out:
+  if (pin)
+    {
+      chunk->tc_maps++;
+    }
+
+  return tmpfs_page_lookup(tfo, first) + (offset & TMPFS_PAGEMASK);
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_unmap
+ *
+ * Description:
+ *   Drop the pin of tmpfs_page_map() on the run holding vaddr.
+ *
+ ****************************************************************************/
+
+void tmpfs_page_unmap(FAR struct tmpfs_file_s *tfo, FAR const void *vaddr)
+{
+  FAR struct tmpfs_chunk_s **pp;
+  FAR struct tmpfs_chunk_s *chunk;
+
+  pp = tmpfs_page_findchunk(tfo, vaddr);
+  if (pp == NULL)
+    {
+      return;
+    }
+
+  chunk = *pp;
+  if (--chunk->tc_maps == 0 && chunk->tc_npages == 0)
+    {
+      *pp = chunk->tc_next;
+      fs_heap_free(chunk);
+    }
+}
@@ -52,6 +52,14 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_UNIONFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0 || CONFIG_FS_UNIONFS_DIR_CACHE > 0
+#  define UNIONFS_HAVE_CACHE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -64,7 +72,39 @@ struct unionfs_dir_s
   bool fu_prefix[2];                   /* True: Fake directory in prefix */
   FAR char *fu_relpath;                /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2]; /* dirent struct used by contained file system */
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  FAR char *fu_list;                   /* Merged listing, served or being built */
+  size_t fu_listlen;                   /* Length of the merged listing */
+  size_t fu_listpos;                   /* Read position in a served listing */
+  uint32_t fu_gen;                     /* Name space generation at opendir */
+  bool fu_cached;                      /* True: Served from the directory cache */
+  bool fu_building;                    /* True: Collecting the merged listing */
+#endif
+};
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+/* Which of the two file systems hold a recently used path */
+
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path, NULL if unused */
+  uint32_t ul_stamp;                 /* Last use, for replacement */
+  uint8_t ul_known;                  /* Bit n: presence on fs n is known */
+  uint8_t ul_present;                /* Bit n: path exists on fs n */
 };
+#endif
+
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+/* The merged listing of a directory, packed as d_type[1] d_name[] '\0' */
+
+struct unionfs_dircache_s
+{
+  FAR char *ud_path;                 /* Relative path, NULL if unused */
+  uint32_t ud_stamp;                 /* Last use, for replacement */
+  FAR char *ud_list;
+  size_t ud_len;
+};
+#endif
 
 /* This structure describes one contained file system mountpoint */
 
@@ -82,6 +122,17 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#ifdef UNIONFS_HAVE_CACHE
+  mutex_t ui_cachelock;              /* Protects the caches below */
+  uint32_t ui_gen;                   /* Bumped on each name space change */
+  uint32_t ui_stamp;                 /* Use counter of the caches */
+#endif
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_LOOKUP_CACHE];
+#endif
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  struct unionfs_dircache_s ui_dirs[CONFIG_FS_UNIONFS_DIR_CACHE];
+#endif
 };
 
 /* This structure describes one opened file */
@@ -138,8 +189,28 @@ static int     unionfs_trystatdir(FAR struct inode *inode,
 static int     unionfs_trystatfile(FAR struct inode *inode,
                                    FAR const char *relpath,
                                    FAR const char *prefix);
+static bool    unionfs_cache_absent(FAR struct unionfs_inode_s *ui,
+                                    FAR const char *relpath, int ndx,
+                                    FAR uint32_t *gen);
+static void    unionfs_cache_record(FAR struct unionfs_inode_s *ui,
+                                    FAR const char *relpath, int ndx,
+                                    int result, uint32_t gen);
+static void    unionfs_cache_invalidate(FAR struct unionfs_inode_s *ui);
+static int     unionfs_lookup(FAR struct unionfs_inode_s *ui, int ndx,
+                              FAR const char *relpath,
+                              FAR struct stat *buf);
 static FAR char *unionfs_relpath(FAR const char *path,
                                  FAR const char *name);
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+static bool    unionfs_dircache_get(FAR struct unionfs_inode_s *ui,
+                                    FAR const char *relpath,
+                                    FAR struct unionfs_dir_s *udir);
+static void    unionfs_dircache_put(FAR struct unionfs_inode_s *ui,
+                                    FAR const char *relpath,
+                                    FAR struct unionfs_dir_s *udir);
+static void    unionfs_dircache_append(FAR struct unionfs_dir_s *udir,
+                                       FAR const struct dirent *entry);
+#endif
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -715,6 +786,335 @@ static int unionfs_tryunlink(FAR struct inode *inode,
   return ops->unlink(inode, trypath);
 }
 
+/****************************************************************************
+ * Name: unionfs_cache_absent
+ *
+ * Description:
+ *   Return true if relpath is known not to exist on file system ndx.  The
+ *   current name space generation is returned in gen, to be passed to
+ *   unionfs_cache_record() with the result of the lookup.
+ *
+ ****************************************************************************/
+
+static bool unionfs_cache_absent(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath, int ndx,
+                                 FAR uint32_t *gen)
+{
+  bool absent = false;
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  FAR struct unionfs_lookup_s *ul;
+  int i;
+
+  nxmutex_lock(&ui->ui_cachelock);
+  *gen = ui->ui_gen;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      ul = &ui->ui_lookup[i];
+      if (ul->ul_path != NULL && strcmp(ul->ul_path, relpath) == 0)
+        {
+          ul->ul_stamp = ++ui->ui_stamp;
+          absent = (ul->ul_known & ~ul->ul_present & (1 << ndx)) != 0;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ui->ui_cachelock);
+#else
+  *gen = 0;
+#endif
+
+  return absent;
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_record
+ *
+ * Description:
+ *   Record the outcome of a lookup of relpath on file system ndx.  Only
+ *   success and -ENOENT say anything about the presence of the path.  The
+ *   result is dropped if the name space changed since gen was taken.
+ *
+ ****************************************************************************/
+
+static void unionfs_cache_record(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath, int ndx,
+                                 int result, uint32_t gen)
+{
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  FAR struct unionfs_lookup_s *victim = NULL;
+  FAR struct unionfs_lookup_s *ul;
+  int i;
+
+  if (result < 0 && result != -ENOENT)
+    {
+      return;
+    }
+
+  nxmutex_lock(&ui->ui_cachelock);
+  if (gen != ui->ui_gen)
+    {
+      goto out;
+    }
+
+  /* Update the entry of this path, or replace a free or the least
+   * recently used one.
+   */
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      ul = &ui->ui_lookup[i];
+      if (ul->ul_path != NULL && strcmp(ul->ul_path, relpath) == 0)
+        {
+          victim = ul;
+          break;
+        }
+
+      if (victim == NULL || ul->ul_path == NULL ||
+          (victim->ul_path != NULL && ul->ul_stamp < victim->ul_stamp))
+        {
+          victim = ul;
+        }
+    }
+
+  if (victim->ul_path == NULL || strcmp(victim->ul_path, relpath) != 0)
+    {
+      if (victim->ul_path != NULL)
+        {
+          fs_heap_free(victim->ul_path);
+        }
+
+      victim->ul_known   = 0;
+      victim->ul_present = 0;
+      victim->ul_path    = fs_heap_strdup(relpath);
+      if (victim->ul_path == NULL)
+        {
+          goto out;
+        }
+    }
+
+  victim->ul_stamp  = ++ui->ui_stamp;
+  victim->ul_known |= 1 << ndx;
+  if (result >= 0)
+    {
+      victim->ul_present |= 1 << ndx;
+    }
+  else
+    {
+      victim->ul_present &= ~(1 << ndx);
+    }
+
+out:
+  nxmutex_unlock(&ui->ui_cachelock);
+#endif
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_invalidate
+ *
+ * Description:
+ *   Forget everything, called after any change of the name space.
+ *
+ ****************************************************************************/
+
+static void unionfs_cache_invalidate(FAR struct unionfs_inode_s *ui)
+{
+#ifdef UNIONFS_HAVE_CACHE
+  int i;
+
+  nxmutex_lock(&ui->ui_cachelock);
+  ui->ui_gen++;
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      if (ui->ui_lookup[i].ul_path != NULL)
+        {
+          fs_heap_free(ui->ui_lookup[i].ul_path);
+          ui->ui_lookup[i].ul_path = NULL;
+        }
+    }
+#endif
+
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  for (i = 0; i < CONFIG_FS_UNIONFS_DIR_CACHE; i++)
+    {
+      if (ui->ui_dirs[i].ud_path != NULL)
+        {
+          fs_heap_free(ui->ui_dirs[i].ud_path);
+          fs_heap_free(ui->ui_dirs[i].ud_list);
+          ui->ui_dirs[i].ud_path = NULL;
+          ui->ui_dirs[i].ud_list = NULL;
+        }
+    }
+#endif
+
+  nxmutex_unlock(&ui->ui_cachelock);
+#endif
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   stat() relpath on file system ndx, skipping the file system if the
+ *   path is already known not to be there.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup(FAR struct unionfs_inode_s *ui, int ndx,
+                          FAR const char *relpath, FAR struct stat *buf)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[ndx];
+  uint32_t gen;
+  int ret;
+
+  if (unionfs_cache_absent(ui, relpath, ndx, &gen))
+    {
+      return -ENOENT;
+    }
+
+  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  unionfs_cache_record(ui, relpath, ndx, ret, gen);
+  return ret;
+}
+
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+/****************************************************************************
+ * Name: unionfs_dircache_get
+ *
+ * Description:
+ *   Set up udir to serve a private copy of the cached merged listing of
+ *   relpath.
+ *
+ ****************************************************************************/
+
+static bool unionfs_dircache_get(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath,
+                                 FAR struct unionfs_dir_s *udir)
+{
+  FAR struct unionfs_dircache_s *ud;
+  bool found = false;
+  int i;
+
+  nxmutex_lock(&ui->ui_cachelock);
+  udir->fu_gen = ui->ui_gen;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_DIR_CACHE; i++)
+    {
+      ud = &ui->ui_dirs[i];
+      if (ud->ud_path != NULL && strcmp(ud->ud_path, relpath) == 0)
+        {
+          udir->fu_list = fs_heap_malloc(ud->ud_len + 1);
+          if (udir->fu_list != NULL)
+            {
+              memcpy(udir->fu_list, ud->ud_list, ud->ud_len);
+              udir->fu_listlen = ud->ud_len;
+              udir->fu_cached  = true;
+              ud->ud_stamp     = ++ui->ui_stamp;
+              found            = true;
+            }
+
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ui->ui_cachelock);
+  return found;
+}
+
+/****************************************************************************
+ * Name: unionfs_dircache_put
+ *
+ * Description:
+ *   Hand the completed merged listing collected by udir to the cache,
+ *   unless the name space changed while it was collected.
+ *
+ ****************************************************************************/
+
+static void unionfs_dircache_put(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath,
+                                 FAR struct unionfs_dir_s *udir)
+{
+  FAR struct unionfs_dircache_s *victim = NULL;
+  FAR struct unionfs_dircache_s *ud;
+  FAR char *path;
+  int i;
+
+  udir->fu_building = false;
+
+  path = fs_heap_strdup(relpath);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  nxmutex_lock(&ui->ui_cachelock);
+  if (udir->fu_gen != ui->ui_gen)
+    {
+      nxmutex_unlock(&ui->ui_cachelock);
+      fs_heap_free(path);
+      return;
+    }
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_DIR_CACHE; i++)
+    {
+      ud = &ui->ui_dirs[i];
+      if (victim == NULL || ud->ud_path == NULL ||
+          (victim->ud_path != NULL && ud->ud_stamp < victim->ud_stamp))
+        {
+          victim = ud;
+        }
+    }
+
+  if (victim->ud_path != NULL)
+    {
+      fs_heap_free(victim->ud_path);
+      fs_heap_free(victim->ud_list);
+    }
+
+  victim->ud_path  = path;
+  victim->ud_list  = udir->fu_list;
+  victim->ud_len   = udir->fu_listlen;
+  victim->ud_stamp = ++ui->ui_stamp;
+  nxmutex_unlock(&ui->ui_cachelock);
+
+  udir->fu_list    = NULL;
+  udir->fu_listlen = 0;
+}
+
+/****************************************************************************
+ * Name: unionfs_dircache_append
+ *
+ * Description:
+ *   Append an entry to the merged listing being collected.  The listing is
+ *   abandoned if memory runs out.
+ *
+ ****************************************************************************/
+
+static void unionfs_dircache_append(FAR struct unionfs_dir_s *udir,
+                                    FAR const struct dirent *entry)
+{
+  size_t namelen = strlen(entry->d_name) + 1;
+  FAR char *list;
+
+  list = fs_heap_realloc(udir->fu_list, udir->fu_listlen + 1 + namelen);
+  if (list == NULL)
+    {
+      fs_heap_free(udir->fu_list);
+      udir->fu_list     = NULL;
+      udir->fu_listlen  = 0;
+      udir->fu_building = false;
+      return;
+    }
+
+  list[udir->fu_listlen] = entry->d_type;
+  memcpy(&list[udir->fu_listlen + 1], entry->d_name, namelen);
+  udir->fu_list     = list;
+  udir->fu_listlen += 1 + namelen;
+}
+#endif
+
 /****************************************************************************
  * Name: unionfs_relpath
  ****************************************************************************/
@@ -852,6 +1252,13 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       fs_heap_free(ui->ui_fs[1].um_prefix);
     }
 
+  /* Drop the caches */
+
+  unionfs_cache_invalidate(ui);
+#ifdef UNIONFS_HAVE_CACHE
+  nxmutex_destroy(&ui->ui_cachelock);
+#endif
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxmutex_destroy(&ui->ui_lock);
@@ -868,6 +1275,8 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  bool create = (oflags & O_CREAT) != 0;
+  uint32_t gen;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -903,7 +1312,21 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_oflags = filep->f_oflags;
   uf->uf_file.f_inode  = um->um_node;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+  /* Skip a file system known not to hold the path, unless the file may be
+   * created there.
+   */
+
+  ret = -ENOENT;
+  if (create || !unionfs_cache_absent(ui, relpath, 0, &gen))
+    {
+      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                            mode);
+      if (!create)
+        {
+          unionfs_cache_record(ui, relpath, 0, ret, gen);
+        }
+    }
+
   if (ret >= 0)
     {
       /* Successfully opened on file system 1 */
@@ -919,10 +1342,20 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_file.f_oflags = filep->f_oflags;
       uf->uf_file.f_inode  = um->um_node;
 
-      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
-                            mode);
+      ret = -ENOENT;
+      if (create || !unionfs_cache_absent(ui, relpath, 1, &gen))
+        {
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          if (!create)
+            {
+              unionfs_cache_record(ui, relpath, 1, ret, gen);
+            }
+        }
+
       if (ret < 0)
         {
+          fs_heap_free(uf);
           goto errout_with_lock;
         }
 
@@ -931,6 +1364,13 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_ndx = 1;
     }
 
+  /* A file may have been created */
+
+  if (create)
+    {
+      unionfs_cache_invalidate(ui);
+    }
+
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -1434,6 +1874,15 @@ static int unionfs_opendir(FAR struct inode *mountpt,
 
   DEBUGASSERT(dir);
 
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  /* Serve the merged listing from the cache if we have it */
+
+  if (unionfs_dircache_get(ui, relpath, udir))
+    {
+      goto out;
+    }
+#endif
+
   /* Clone the path.  We will need this when we traverse file system 2 to
    * omit duplicates on file system 1.
    */
@@ -1514,6 +1963,14 @@ static int unionfs_opendir(FAR struct inode *mountpt,
         }
     }
 
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  /* Collect the merged listing while it is read */
+
+  udir->fu_building = true;
+
+out:
+#endif
+
   /* Increment the number of open references and return success */
 
   ui->ui_nopen++;
@@ -1599,6 +2056,13 @@ static int unionfs_closedir(FAR struct inode *mountpt,
       fs_heap_free(udir->fu_relpath);
     }
 
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  if (udir->fu_list != NULL)
+    {
+      fs_heap_free(udir->fu_list);
+    }
+#endif
+
   fs_heap_free(udir);
 
   /* Decrement the count of open reference.  If that count would go to zero
@@ -1619,16 +2083,20 @@ static int unionfs_closedir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: unionfs_readdir
+ * Name: unionfs_readdir_merge
+ *
+ * Description:
+ *   Read the next entry of the merged listing from the contained file
+ *   systems.
+ *
  ****************************************************************************/
 
-static int unionfs_readdir(FAR struct inode *mountpt,
-                           FAR struct fs_dirent_s *dir,
-                           FAR struct dirent *entry)
+static int unionfs_readdir_merge(FAR struct inode *mountpt,
+                                 FAR struct fs_dirent_s *dir,
+                                 FAR struct dirent *entry)
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
-  FAR struct unionfs_mountpt_s *um0;
   FAR const struct mountpt_operations *ops;
   FAR struct unionfs_dir_s *udir;
   FAR char *relpath;
@@ -1774,9 +2242,7 @@ static int unionfs_readdir(FAR struct inode *mountpt,
                        * system 1
                        */
 
-                      um0 = &ui->ui_fs[0];
-                      tmp = unionfs_trystat(um0->um_node, relpath,
-                                            um0->um_prefix, &buf);
+                      tmp = unionfs_lookup(ui, 0, relpath, &buf);
 
                       /* Free the allocated relpath */
 
@@ -1852,9 +2318,7 @@ static int unionfs_readdir(FAR struct inode *mountpt,
 
                   /* Check if anything exists at this path on file system 1 */
 
-                  um0 = &ui->ui_fs[0];
-                  tmp = unionfs_trystat(um0->um_node, relpath,
-                                        um0->um_prefix, &buf);
+                  tmp = unionfs_lookup(ui, 0, relpath, &buf);
                   if (tmp >= 0)
                     {
                       /* There is something there!
@@ -1877,6 +2341,65 @@ static int unionfs_readdir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: unionfs_readdir
+ ****************************************************************************/
+
+static int unionfs_readdir(FAR struct inode *mountpt,
+                           FAR struct fs_dirent_s *dir,
+                           FAR struct dirent *entry)
+{
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  FAR struct unionfs_dir_s *udir = (FAR struct unionfs_dir_s *)dir;
+  FAR const char *name;
+#endif
+  int ret;
+
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  /* Serve the listing from the directory cache */
+
+  if (udir->fu_cached)
+    {
+      if (udir->fu_listpos >= udir->fu_listlen)
+        {
+          return -ENOENT;
+        }
+
+      entry->d_type = udir->fu_list[udir->fu_listpos];
+      name = &udir->fu_list[udir->fu_listpos + 1];
+      strlcpy(entry->d_name, name, sizeof(entry->d_name));
+      udir->fu_listpos += 1 + strlen(name) + 1;
+      return OK;
+    }
+#endif
+
+  ret = unionfs_readdir_merge(mountpt, dir, entry);
+
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  /* Collect the merged listing, and cache it once it is complete */
+
+  if (udir->fu_building)
+    {
+      if (ret >= 0)
+        {
+          unionfs_dircache_append(udir, entry);
+        }
+      else if (ret == -ENOENT)
+        {
+          unionfs_dircache_put(mountpt->i_private,
+                               udir->fu_relpath ? udir->fu_relpath : "",
+                               udir);
+        }
+      else
+        {
+          udir->fu_building = false;
+        }
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: unionfs_rewindir
  ****************************************************************************/
@@ -1900,6 +2423,25 @@ static int unionfs_rewinddir(FAR struct inode *mountpt,
   DEBUGASSERT(dir);
   udir = (FAR struct unionfs_dir_s *)dir;
 
+#if CONFIG_FS_UNIONFS_DIR_CACHE > 0
+  if (udir->fu_cached)
+    {
+      udir->fu_listpos = 0;
+      return OK;
+    }
+
+  /* A partly read listing is no longer collected */
+
+  if (udir->fu_list != NULL)
+    {
+      fs_heap_free(udir->fu_list);
+      udir->fu_list = NULL;
+    }
+
+  udir->fu_listlen  = 0;
+  udir->fu_building = false;
+#endif
+
   /* Were we currently enumerating on file system 1?  If not, is an
    * enumeration possible on file system 1?
    */
@@ -2186,7 +2728,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
    */
 
   um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+  ret = unionfs_lookup(ui, 0, relpath, &buf);
   if (ret >= 0)
     {
       /* Yes.. Try to unlink the file on file system 1 (perhaps exposing
@@ -2208,7 +2750,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
        */
 
       um  = &ui->ui_fs[1];
-      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+      ret = unionfs_lookup(ui, 1, relpath, &buf);
       if (ret >= 0)
         {
           /* Yes.. Try to unlink the file on file system 1.  This would fail
@@ -2220,6 +2762,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_cache_invalidate(ui);
   return ret;
 }
 
@@ -2247,15 +2790,13 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Is there anything with this name on either file system? */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+  ret = unionfs_lookup(ui, 0, relpath, &buf);
   if (ret >= 0)
     {
       return -EEXIST;
     }
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+  ret = unionfs_lookup(ui, 1, relpath, &buf);
   if (ret >= 0)
     {
       return -EEXIST;
@@ -2269,6 +2810,8 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   um  = &ui->ui_fs[1];
   ret2 = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
 
+  unionfs_cache_invalidate(ui);
+
   /* We will say we were successful if we were able to create the
    * directory on either file system.  Perhaps one file system is
    * read-only and the other is write-able?
@@ -2311,6 +2854,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
+      unionfs_cache_invalidate(ui);
       if (ret < 0)
         {
           return ret;
@@ -2330,6 +2874,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
+      unionfs_cache_invalidate(ui);
 
       /* REVISIT:  Should we try to restore the directory on file system 1
        * if we failure to removed the directory on file system 2?
@@ -2373,6 +2918,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
+      unionfs_cache_invalidate(ui);
       if (ret >= 0)
         {
           /* Return immediately on success.  In the event that the file
@@ -2400,6 +2946,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
+      unionfs_cache_invalidate(ui);
     }
 
   return ret;
@@ -2413,7 +2960,6 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct unionfs_inode_s *ui;
-  FAR struct unionfs_mountpt_s *um;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2426,8 +2972,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* stat this path on file system 1 */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = unionfs_lookup(ui, 0, relpath, buf);
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
@@ -2439,8 +2984,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* stat failed on the file system 1.  Try again on file system 2. */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = unionfs_lookup(ui, 1, relpath, buf);
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
@@ -2608,6 +3152,9 @@ static int unionfs_dobind(FAR const char *fspath1, FAR const char *prefix1,
     }
 
   nxmutex_init(&ui->ui_lock);
+#ifdef UNIONFS_HAVE_CACHE
+  nxmutex_init(&ui->ui_cachelock);
+#endif
 
   /* Get the inodes associated with fspath1 and fspath2 */
 
@@ -2675,6 +3222,9 @@ errout_with_fs1:
   inode_release(ui->ui_fs[0].um_node);
 
 errout_with_uinode:
+#ifdef UNIONFS_HAVE_CACHE
+  nxmutex_destroy(&ui->ui_cachelock);
+#endif
   nxmutex_destroy(&ui->ui_lock);
   fs_heap_free(ui);
   return ret;
@@ -367,6 +367,15 @@ struct v9fs_map_s
   int conversion;
 };
 
+struct v9fs_client_io_s
+{
+  struct v9fs_write_s   request;
+  struct v9fs_rwrite_s  response;
+  struct iovec          wiov[2];
+  struct iovec          riov[2];
+  struct v9fs_payload_s payload;
+};
+
 struct v9fs_fid_s
 {
   uint32_t iounit;
@@ -537,6 +546,46 @@ static void v9fs_fid_destroy(FAR struct v9fs_client_s *client,
   fs_heap_free(fidp);
 }
 
+/****************************************************************************
+ * v9fs_client_rpc
+ ****************************************************************************/
+
+static int v9fs_client_submit(FAR struct v9fs_transport_s *transport,
+                              FAR struct v9fs_payload_s *payload,
+                              FAR struct iovec *wiov, size_t wcount,
+                              FAR struct iovec *riov, size_t rcount,
+                              uint16_t tag)
+{
+  int ret;
+
+  nxsem_init(&payload->resp, 0, 0);
+  payload->wiov = wiov;
+  payload->riov = riov;
+  payload->wcount = wcount;
+  payload->rcount = rcount;
+  payload->tag = tag;
+  payload->ret = -EIO;
+
+  ret = v9fs_transport_request(transport, payload);
+  if (ret < 0)
+    {
+      nxsem_destroy(&payload->resp);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_client_complete
+ ****************************************************************************/
+
+static int v9fs_client_complete(FAR struct v9fs_payload_s *payload)
+{
+  nxsem_wait_uninterruptible(&payload->resp);
+  nxsem_destroy(&payload->resp);
+  return payload->ret;
+}
+
 /****************************************************************************
  * v9fs_client_rpc
  ****************************************************************************/
@@ -549,25 +598,144 @@ static int v9fs_client_rpc(FAR struct v9fs_transport_s *transport,
   struct v9fs_payload_s payload;
   int ret;
 
-  nxsem_init(&payload.resp, 0, 0);
-  payload.wiov = wiov;
-  payload.riov = riov;
-  payload.wcount = wcount;
-  payload.rcount = rcount;
-  payload.tag = tag;
-  payload.ret = -EIO;
-
-  ret = v9fs_transport_request(transport, &payload);
+  ret = v9fs_client_submit(transport, &payload, wiov, wcount,
+                           riov, rcount, tag);
   if (ret < 0)
     {
-      nxsem_destroy(&payload.resp);
       return ret;
     }
 
-  nxsem_wait(&payload.resp);
-  nxsem_destroy(&payload.resp);
+  return v9fs_client_complete(&payload);
+}
+
+/****************************************************************************
+ * v9fs_client_transfer
+ *
+ * Description:
+ *   Move buflen bytes between the buffer and the file with Tread/Twrite
+ *   requests of at most iounit bytes.  Up to CONFIG_V9FS_QUEUE_DEPTH
+ *   requests are in flight at once, the replies are then collected in
+ *   order so that a short count still ends the transfer at the right
+ *   place.
+ *
+ ****************************************************************************/
+
+static ssize_t v9fs_client_transfer(FAR struct v9fs_client_s *client,
+                                    uint32_t fid, uint8_t type,
+                                    FAR uint8_t *buffer, off_t offset,
+                                    size_t buflen)
+{
+  struct v9fs_client_io_s io[CONFIG_V9FS_QUEUE_DEPTH];
+  FAR struct v9fs_fid_s *fidp;
+  bool done = false;
+  size_t ntotal = 0;
+  int ret = 0;
+  int n;
+  int i;
+
+  /* size[4] Tread tag[2] fid[4] offset[8] count[4]
+   * size[4] Rread tag[2] count[4] data[count]
+   *
+   * size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
+   * size[4] Rwrite tag[2] count[4]
+   */
+
+  fidp = idr_find(client->fids, fid);
+  if (fidp == NULL)
+    {
+      return -ENOENT;
+    }
+
+  while (buflen > 0 && !done)
+    {
+      /* Fill the queue */
+
+      for (n = 0; n < CONFIG_V9FS_QUEUE_DEPTH && buflen > 0; n++)
+        {
+          FAR struct v9fs_client_io_s *slot = &io[n];
+
+          slot->request.count = buflen > fidp->iounit ?
+                                fidp->iounit : buflen;
+          slot->request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                      V9FS_BIT64SZ + V9FS_BIT32SZ;
+          slot->request.header.type = type;
+          slot->request.header.tag = v9fs_get_tagid(client);
+          slot->request.fid = fid;
+          slot->request.offset = offset;
+
+          slot->wiov[0].iov_base = &slot->request;
+          slot->wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                  V9FS_BIT64SZ + V9FS_BIT32SZ;
+          slot->riov[0].iov_base = &slot->response;
+          slot->riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+
+          if (type == V9FS_TWRITE)
+            {
+              slot->request.header.size += slot->request.count;
+              slot->wiov[1].iov_base = buffer;
+              slot->wiov[1].iov_len = slot->request.count;
+              ret = v9fs_client_submit(client->transport, &slot->payload,
+                                       slot->wiov, 2, slot->riov, 1,
+                                       slot->request.header.tag);
+            }
+          else
+            {
+              slot->riov[1].iov_base = buffer;
+              slot->riov[1].iov_len = slot->request.count;
+              ret = v9fs_client_submit(client->transport, &slot->payload,
+                                       slot->wiov, 1, slot->riov, 2,
+                                       slot->request.header.tag);
+            }
+
+          if (ret < 0)
+            {
+              /* The transport is full, wait for what was already sent
+               * and try again.
+               */
+
+              break;
+            }
+
+          offset += slot->request.count;
+          buffer += slot->request.count;
+          buflen -= slot->request.count;
+        }
+
+      if (n == 0)
+        {
+          break;
+        }
+
+      /* Collect the replies in order, once a reply comes back short or
+       * failed the later ones are only drained.
+       */
+
+      ret = OK;
+      for (i = 0; i < n; i++)
+        {
+          int result = v9fs_client_complete(&io[i].payload);
 
-  return payload.ret;
+          if (done)
+            {
+              continue;
+            }
+
+          if (result < 0)
+            {
+              ret = result;
+              done = true;
+              continue;
+            }
+
+          ntotal += io[i].response.count;
+          if (io[i].response.count < io[i].request.count)
+            {
+              done = true;
+            }
+        }
+    }
+
+  return ntotal ? ntotal : ret;
 }
 
 /****************************************************************************
@@ -902,61 +1070,8 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
 ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
                          FAR void *buffer, off_t offset, size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_read_s request;
-  struct v9fs_rread_s response;
-  struct iovec wiov[1];
-  struct iovec riov[2];
-  size_t nread = 0;
-  int ret = 0;
-
-  /* size[4] Tread tag[2] fid[4] offset[8] count[4]
-   * size[4] Rread tag[2] count[4] data[count]
-   */
-
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ;
-      request.header.type = V9FS_TREAD;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-      riov[1].iov_base = (FAR void *)buffer;
-      riov[1].iov_len = request.count;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 2,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      if (response.count == 0)
-        {
-          break;
-        }
-
-      nread += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nread ? nread : ret;
+  return v9fs_client_transfer(client, fid, V9FS_TREAD, buffer,
+                              offset, buflen);
 }
 
 /****************************************************************************
@@ -1078,56 +1193,8 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
                           FAR const void *buffer, off_t offset,
                           size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_write_s request;
-  struct v9fs_rwrite_s response;
-  struct iovec wiov[2];
-  struct iovec riov[1];
-  size_t nwrite = 0;
-  int ret = 0;
-
-  /* size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
-   * size[4] Rwrite tag[2] count[4]
-   */
-
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ + request.count;
-      request.header.type = V9FS_TWRITE;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      wiov[1].iov_base = (FAR void *)buffer;
-      wiov[1].iov_len = request.count;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 2, riov, 1,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      nwrite += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nwrite ? nwrite : ret;
+  return v9fs_client_transfer(client, fid, V9FS_TWRITE,
+                              (FAR uint8_t *)buffer, offset, buflen);
 }
 
 /****************************************************************************
@@ -30,6 +30,7 @@
 #include <inttypes.h>
 #include <libgen.h>
 #include <string.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -47,6 +48,12 @@ struct v9fs_vfs_file_s
 {
   uint32_t fid;
   mutex_t  lock;
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+  FAR char *rabuf;    /* Readahead buffer, allocated on first use */
+  off_t     rapos;    /* File offset of the first byte in rabuf */
+  size_t    ralen;    /* Number of valid bytes in rabuf */
+  off_t     ranext;   /* Where the next sequential read starts */
+#endif
 };
 
 struct v9fs_vfs_dirent_s
@@ -263,10 +270,89 @@ static int v9fs_vfs_close(FAR struct file *filep)
 
   v9fs_fid_put(client, file->fid);
   nxmutex_destroy(&file->lock);
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+  if (file->rabuf != NULL)
+    {
+      fs_heap_free(file->rabuf);
+    }
+#endif
+
   fs_heap_free(file);
   return 0;
 }
 
+/****************************************************************************
+ * Name: v9fs_vfs_readahead
+ *
+ * Description:
+ *   Serve a read from the readahead buffer of the file.  A sequential read
+ *   smaller than the buffer refills it with one pipelined transfer, other
+ *   reads go straight to the server.
+ *
+ ****************************************************************************/
+
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+static ssize_t v9fs_vfs_readahead(FAR struct v9fs_client_s *client,
+                                  FAR struct v9fs_vfs_file_s *file,
+                                  FAR char *buffer, off_t pos,
+                                  size_t buflen)
+{
+  bool sequential = pos == file->ranext;
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  size_t n;
+
+  /* Copy what the buffer already holds */
+
+  if (pos >= file->rapos && pos < file->rapos + file->ralen)
+    {
+      n = MIN(buflen, file->rapos + file->ralen - pos);
+      memcpy(buffer, file->rabuf + (pos - file->rapos), n);
+      nread  += n;
+      pos    += n;
+      buffer += n;
+      buflen -= n;
+    }
+
+  if (buflen > 0)
+    {
+      if (sequential && buflen < CONFIG_V9FS_READAHEAD_SIZE &&
+          file->rabuf == NULL)
+        {
+          file->rabuf = fs_heap_malloc(CONFIG_V9FS_READAHEAD_SIZE);
+        }
+
+      if (sequential && buflen < CONFIG_V9FS_READAHEAD_SIZE &&
+          file->rabuf != NULL)
+        {
+          file->ralen = 0;
+          ret = v9fs_client_read(client, file->fid, file->rabuf, pos,
+                                 CONFIG_V9FS_READAHEAD_SIZE);
+          if (ret > 0)
+            {
+              file->rapos = pos;
+              file->ralen = ret;
+              ret = MIN(buflen, (size_t)ret);
+              memcpy(buffer, file->rabuf, ret);
+            }
+        }
+      else
+        {
+          ret = v9fs_client_read(client, file->fid, buffer, pos, buflen);
+        }
+
+      if (ret > 0)
+        {
+          nread += ret;
+          pos   += ret;
+        }
+    }
+
+  file->ranext = pos;
+  return nread ? nread : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: v9fs_vfs_read
  ****************************************************************************/
@@ -288,7 +374,11 @@ static ssize_t v9fs_vfs_read(FAR struct file *filep, FAR char *buffer,
   file = filep->f_priv;
 
   nxmutex_lock(&file->lock);
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+  ret = v9fs_vfs_readahead(client, file, buffer, filep->f_pos, buflen);
+#else
   ret = v9fs_client_read(client, file->fid, buffer, filep->f_pos, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -319,6 +409,10 @@ static ssize_t v9fs_vfs_write(FAR struct file *filep, FAR const char *buffer,
   file = filep->f_priv;
 
   nxmutex_lock(&file->lock);
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+  file->ralen = 0;
+#endif
+
   ret = v9fs_client_write(client, file->fid, buffer, filep->f_pos, buflen);
   if (ret > 0)
     {
@@ -500,6 +594,15 @@ static int v9fs_vfs_fchstat(FAR const struct file *filep,
   client = filep->f_inode->i_private;
   file = filep->f_priv;
 
+#if CONFIG_V9FS_READAHEAD_SIZE > 0
+  if ((flags & CH_STAT_SIZE) != 0)
+    {
+      nxmutex_lock(&file->lock);
+      file->ralen = 0;
+      nxmutex_unlock(&file->lock);
+    }
+#endif
+
   return v9fs_client_chstat(client, file->fid, buf, flags);
 }
 
@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -53,8 +54,10 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rnode;    /* Link in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     armed;    /* False after an EPOLLONESHOT event */
+  bool                     recheck;  /* Level triggered event reported */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -68,18 +71,26 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  spinlock_t            rlock;    /* Protect the ready list and the rnode,
+                                   * armed and pfd.revents of all the epoll
+                                   * nodes, these are also touched by the
+                                   * poll callback from the drivers.
+                                   */
+  struct list_node      ready;    /* The ready list, the poll callback
+                                   * queues the epoll node here when the
+                                   * driver reports an event, epoll_wait
+                                   * only walks this list.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      setup;    /* The setup list, store all the setuped
+                                   * and armed epoll node, the setup is kept
+                                   * until epoll_ctl(EPOLL_CTL_DEL/MOD) or
+                                   * close.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
                                    * EPOLLONESHOT events, these oneshot epoll
-                                   * nodes can be reset by epoll_ctl (move
+                                   * nodes are still setuped but disarmed
+                                   * and can be reset by epoll_ctl (move
                                    * from oneshot list to the setup list).
                                    */
   struct list_node      free;     /* The free list, store all the freed epoll
@@ -101,9 +112,10 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd);
+static void epoll_unready(FAR epoll_node_t *epn);
+static int epoll_harvest(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents);
 
 /****************************************************************************
  * Private Data
@@ -203,6 +215,12 @@ static int epoll_do_close(FAR struct file *filep)
           fs_putfilep(epn->filep);
         }
 
+      list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        {
+          file_poll(epn->filep, &epn->pfd, false);
+          fs_putfilep(epn->filep);
+        }
+
       list_for_every_entry_safe(&eph->extend, epn, tmp, epoll_node_t, node)
         {
           list_delete(&epn->node);
@@ -239,13 +257,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  list_initialize(&eph->ready);
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -271,61 +290,80 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_find
  *
  * Description:
- *   Setup all the fd.
+ *   Find the setuped epoll node of the fd.
  *
  * Input Parameters:
- *   eph       - The epoll head pointer
+ *   eph - The epoll head pointer
+ *   fd  - The file descriptor
  *
  * Returned Value:
- *   Positive on success, negative on fail
+ *   The epoll node pointer, NULL if not found
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
-  int ret;
 
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
+  list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
     {
-      return ret;
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
     }
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = file_poll(epn->filep, &epn->pfd, true);
-      if (ret < 0)
+      if (epn->pfd.fd == fd)
         {
-          ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
-               "ret=%d\n", epn->filep, epn->pfd.events, ret);
-          break;
+          return epn;
         }
+    }
 
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove the epoll node from the ready list and drop the pending events,
+ *   the caller should teardown the fd first to avoid the node queued again.
+ *
+ * Input Parameters:
+ *   epn - The epoll node pointer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&epn->eph->rlock);
+  if (list_in_list(&epn->rnode))
+    {
+      list_delete(&epn->rnode);
     }
 
-  nxmutex_unlock(&eph->lock);
-  return ret;
+  epn->pfd.revents = 0;
+  epn->recheck     = false;
+  spin_unlock_irqrestore(&epn->eph->rlock, flags);
 }
 
 /****************************************************************************
- * Name: epoll_teardown
+ * Name: epoll_harvest
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Collect the events of the epoll nodes in the ready list.  The fds stay
+ *   setuped between the waits, only the level triggered fds reported by the
+ *   previous wait are polled again to check whether they are still ready.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -334,52 +372,116 @@ static int epoll_setup(FAR epoll_head_t *eph)
  *
  * Returned Value:
  *   Return the number of fd that notified and the events is also user
- *   expected.
+ *   expected, negative on fail.
  *
  ****************************************************************************/
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+static int epoll_harvest(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents)
 {
-  FAR epoll_node_t *tepn;
+  FAR struct list_node *node;
   FAR epoll_node_t *epn;
+  struct list_node requeue;
+  pollevent_t revents;
+  irqstate_t flags;
+  int ret;
   int i = 0;
 
-  nxmutex_lock(&eph->lock);
-
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  ret = nxmutex_lock(&eph->lock);
+  if (ret < 0)
     {
-      /* Only check the notified fd */
+      return ret;
+    }
 
-      if (!epn->notified)
+  list_initialize(&requeue);
+  while (i < maxevents)
+    {
+      flags = spin_lock_irqsave(&eph->rlock);
+      node  = list_remove_head(&eph->ready);
+      if (node == NULL)
         {
-          continue;
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          break;
         }
 
-      /* Teradown all the notified fd */
-
-      file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+      epn              = container_of(node, epoll_node_t, rnode);
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+      spin_unlock_irqrestore(&eph->rlock, flags);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if (revents == 0 && epn->recheck)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+          /* No new event since the last wait reported this level
+           * triggered fd, setup again to check whether it is still ready.
+           */
+
+          file_poll(epn->filep, &epn->pfd, false);
+          ret = file_poll(epn->filep, &epn->pfd, true);
+          if (ret < 0)
             {
-              list_add_tail(&eph->oneshot, &epn->node);
+              ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
+                   "ret=%d\n", epn->filep, epn->pfd.events, ret);
             }
-          else
+
+          flags = spin_lock_irqsave(&eph->rlock);
+          if (list_in_list(&epn->rnode))
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              list_delete(&epn->rnode);
             }
+
+          revents          = epn->pfd.revents;
+          epn->pfd.revents = 0;
+          spin_unlock_irqrestore(&eph->rlock, flags);
         }
-      else
+
+      epn->recheck = false;
+      if (revents == 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          continue;
         }
+
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+
+      flags = spin_lock_irqsave(&eph->rlock);
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          /* Disarm the node until epoll_ctl(EPOLL_CTL_MOD) */
+
+          epn->armed = false;
+          if (list_in_list(&epn->rnode))
+            {
+              list_delete(&epn->rnode);
+            }
+
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
+          continue;
+        }
+      else if ((epn->pfd.events & EPOLLET) == 0 &&
+               !list_in_list(&epn->rnode))
+        {
+          /* Level triggered, report it again on the next wait if the fd
+           * is still ready.
+           */
+
+          epn->recheck = true;
+          list_add_tail(&requeue, &epn->rnode);
+        }
+
+      spin_unlock_irqrestore(&eph->rlock, flags);
     }
 
+  /* Move the level triggered nodes back to the ready list */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  while ((node = list_remove_head(&requeue)) != NULL)
+    {
+      list_add_tail(&eph->ready, node);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
   nxmutex_unlock(&eph->lock);
   return i;
 }
@@ -402,15 +504,30 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  bool queued = false;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  /* Queue the node to the ready list directly, epoll_wait() doesn't need
+   * to scan or setup the other fds.
+   */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (epn->armed && fds->revents != 0 && !list_in_list(&epn->rnode))
+    {
+      list_add_tail(&eph->ready, &epn->rnode);
+      queued = true;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (queued)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
+      nxsem_get_value(&eph->sem, &semcount);
       if (semcount < 1)
         {
-          nxsem_post(&epn->eph->sem);
+          nxsem_post(&eph->sem);
         }
     }
 }
@@ -507,31 +624,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        if (epoll_find(eph, fd) != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -559,10 +655,12 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           }
 
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
+        list_clear_node(&epn->rnode);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
-        epn->pfd.events  = ev->events | POLLALWAYS;
+        epn->armed       = true;
+        epn->recheck     = false;
+        epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
@@ -575,9 +673,14 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             goto err;
           }
 
+        /* The setup is persistent, the driver notifies this node until
+         * EPOLL_CTL_DEL or close.
+         */
+
         ret = file_poll(epn->filep, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(epn);
             fs_putfilep(epn->filep);
             list_add_tail(&eph->free, &epn->node);
             goto err;
@@ -588,122 +691,52 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                file_poll(epn->filep, &epn->pfd, false);
-                fs_putfilep(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                fs_putfilep(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                fs_putfilep(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            file_poll(epn->filep, &epn->pfd, false);
+            epoll_unready(epn);
+            fs_putfilep(epn->filep);
+            list_delete(&epn->node);
+            list_add_tail(&eph->free, &epn->node);
           }
 
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    file_poll(epn->filep, &epn->pfd, false);
-
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            break;
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
-          }
+        /* Setup again with the new events, this also rearms the
+         * EPOLLONESHOT node and reports the events already pending.
+         */
+
+        file_poll(epn->filep, &epn->pfd, false);
+        epoll_unready(epn);
+
+        epn->data        = ev->data;
+        epn->armed       = true;
+        epn->pfd.events  = ev->events;
+
+        list_delete(&epn->node);
+        list_add_tail(&eph->setup, &epn->node);
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        ret = file_poll(epn->filep, &epn->pfd, true);
+        if (ret < 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                epn->notified    = false;
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
-                epn->pfd.revents = 0;
-
-                ret = file_poll(epn->filep, &epn->pfd, true);
-                if (ret < 0)
-                  {
-                    goto err;
-                  }
-
-                list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
-                break;
-              }
+            goto err;
           }
 
         break;
-
       default:
         ret = -EINVAL;
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   fs_putfilep(filep);
   return OK;
@@ -734,21 +767,22 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
+  ret = epoll_harvest(eph, evs, maxevents);
   if (ret < 0)
     {
       goto err;
     }
+  else if (ret > 0 || timeout == 0)
+    {
+      fs_putfilep(filep);
+      return ret;
+    }
 
   /* Wait the poll ready */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
 
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
+  if (timeout > 0)
     {
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
     }
@@ -762,15 +796,15 @@ retry:
     {
       goto err;
     }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
+  else if (ret >= 0)
     {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
+      goto retry;
+    }
 
-      ret = num;
+  ret = epoll_harvest(eph, evs, maxevents);
+  if (ret < 0)
+    {
+      goto err;
     }
 
   fs_putfilep(filep);
@@ -809,19 +843,20 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
+  ret = epoll_harvest(eph, evs, maxevents);
   if (ret < 0)
     {
       goto err;
     }
+  else if (ret > 0 || timeout == 0)
+    {
+      fs_putfilep(filep);
+      return ret;
+    }
 
   /* Wait the poll ready */
 
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
+  if (timeout > 0)
     {
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
     }
@@ -834,15 +869,15 @@ retry:
     {
       goto err;
     }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
+  else if (ret >= 0)
     {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
+      goto retry;
+    }
 
-      ret = num;
+  ret = epoll_harvest(eph, evs, maxevents);
+  if (ret < 0)
+    {
+      goto err;
     }
 
   fs_putfilep(filep);
@@ -37,6 +37,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 #include <nuttx/tls.h>
 
 #include <arch/irq.h>
@@ -54,6 +55,27 @@ struct pollfd_s
   nfds_t nfds;
 };
 
+#ifdef CONFIG_FS_POLL_CACHE
+/* A registration of the poll cache.  The driver holds pfd, a copy of the
+ * caller's entry, from one poll() to the next.
+ */
+
+struct poll_entry_s
+{
+  struct pollfd pfd;
+  FAR struct file *filep;          /* Referenced while armed, else NULL */
+};
+
+/* The poll() registrations of a thread, see poll_cache() */
+
+struct poll_cache_s
+{
+  sem_t sem;                       /* Posted by the armed entries */
+  nfds_t nfds;
+  struct poll_entry_s entry[0];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -220,10 +242,267 @@ static void poll_cleanup(FAR void *arg)
   poll_teardown(fdsinfo->fds, fdsinfo->nfds, &count);
 }
 
+#ifdef CONFIG_FS_POLL_CACHE
+/****************************************************************************
+ * Name: poll_cache_disarm
+ *
+ * Description:
+ *   Teardown the poll of a registration and drop the file reference.
+ *
+ ****************************************************************************/
+
+static void poll_cache_disarm(FAR struct poll_entry_s *entry)
+{
+  if (entry->filep != NULL)
+    {
+      file_poll(entry->filep, &entry->pfd, false);
+      fs_putfilep(entry->filep);
+      entry->filep = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: poll_cache_arm
+ *
+ * Description:
+ *   Setup the poll of a registration.  The driver reports the events that
+ *   are already there, so this also gets the current state of the file.
+ *
+ ****************************************************************************/
+
+static void poll_cache_arm(FAR struct poll_cache_s *cache,
+                           FAR struct poll_entry_s *entry)
+{
+  FAR struct file *filep;
+  int ret;
+
+  entry->pfd.arg     = &cache->sem;
+  entry->pfd.cb      = poll_default_cb;
+  entry->pfd.revents = 0;
+  entry->pfd.priv    = NULL;
+
+  if (entry->pfd.fd < 0)
+    {
+      return;
+    }
+
+  ret = fs_getfilep(entry->pfd.fd, &filep);
+  if (ret >= 0)
+    {
+      ret = file_poll(filep, &entry->pfd, true);
+      if (ret >= 0)
+        {
+          entry->filep = filep;
+          return;
+        }
+
+      fs_putfilep(filep);
+    }
+
+  entry->pfd.revents |= POLLERR;
+}
+
+/****************************************************************************
+ * Name: poll_cache_update
+ *
+ * Description:
+ *   Bring the registrations up to date with the caller's entries and
+ *   return the count of entries with events.  The entries that changed,
+ *   whose file was closed, or that reported events are set up again; the
+ *   others stay armed as they are, their drivers notify any change.
+ *
+ ****************************************************************************/
+
+static int poll_cache_update(FAR struct poll_cache_s *cache,
+                             FAR struct pollfd *fds)
+{
+  FAR struct poll_entry_s *entry;
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      entry = &cache->entry[i];
+
+      /* The reference of the cache is the last one if the file was closed
+       * since the previous call.
+       */
+
+      if (entry->pfd.fd != fds[i].fd ||
+          entry->pfd.events != fds[i].events ||
+          entry->pfd.revents != 0 ||
+          (entry->filep != NULL && atomic_read(&entry->filep->f_refs) <= 1))
+        {
+          poll_cache_disarm(entry);
+
+          entry->pfd.fd     = fds[i].fd;
+          entry->pfd.events = fds[i].events;
+          poll_cache_arm(cache, entry);
+        }
+
+      if (entry->pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_count
+ ****************************************************************************/
+
+static int poll_cache_count(FAR struct poll_cache_s *cache)
+{
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      if (cache->entry[i].pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   poll() for the larger sets.  The registrations with the drivers are
+ *   kept after the call, in a cache of the calling thread that is keyed by
+ *   the contents of the caller's pollfd array.  An event loop that polls
+ *   the same set over and over only sets up again the entries that changed
+ *   or reported events, instead of all of them twice per call.
+ *
+ ****************************************************************************/
+
+static int poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  FAR struct tcb_s *rtcb = nxsched_self();
+  FAR struct poll_cache_s *cache = rtcb->pollcache;
+  clock_t deadline = 0;
+  int count;
+  int ret = OK;
+  nfds_t i;
+
+  if (cache != NULL && cache->nfds != nfds)
+    {
+      poll_cache_release(rtcb);
+      cache = NULL;
+    }
+
+  if (cache == NULL)
+    {
+      cache = fs_heap_zalloc(sizeof(struct poll_cache_s) +
+                             nfds * sizeof(struct poll_entry_s));
+      if (cache == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      nxsem_init(&cache->sem, 0, 0);
+      cache->nfds = nfds;
+      for (i = 0; i < nfds; i++)
+        {
+          cache->entry[i].pfd.fd = -1;
+        }
+
+      rtcb->pollcache = cache;
+    }
+
+  /* Forget the notifications that came after the previous call, the
+   * entries that got them are set up again.
+   */
+
+  nxsem_reset(&cache->sem, 0);
+
+  count = poll_cache_update(cache, fds);
+  if (count == 0 && timeout != 0)
+    {
+      if (timeout > 0)
+        {
+          deadline = clock_systime_ticks() + MSEC2TICK((clock_t)timeout);
+        }
+
+      /* The semaphore may have been posted for an event that an entry set
+       * up again no longer has, so wait until there is one.
+       */
+
+      do
+        {
+          if (timeout > 0)
+            {
+              clock_t now = clock_systime_ticks();
+
+              if (clock_compare(deadline, now))
+                {
+                  break;
+                }
+
+              ret = nxsem_tickwait(&cache->sem, deadline - now);
+            }
+          else
+            {
+              ret = nxsem_wait(&cache->sem);
+            }
+
+          if (ret < 0)
+            {
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = OK;
+                }
+
+              break;
+            }
+
+          count = poll_cache_count(cache);
+        }
+      while (count == 0);
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      fds[i].revents = cache->entry[i].pfd.revents;
+    }
+
+  return ret < 0 ? ret : count;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: poll_cache_release
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct poll_cache_s *cache = tcb->pollcache;
+  nfds_t i;
+
+  if (cache != NULL)
+    {
+      tcb->pollcache = NULL;
+      for (i = 0; i < cache->nfds; i++)
+        {
+          poll_cache_disarm(&cache->entry[i]);
+        }
+
+      nxsem_destroy(&cache->sem);
+      fs_heap_free(cache);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: poll_default_cb
  *
@@ -422,6 +701,9 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 {
   FAR struct pollfd *kfds;
+#ifdef CONFIG_BUILD_KERNEL
+  struct pollfd stackfds[CONFIG_FS_POLL_STACK_NFDS];
+#endif
   sem_t sem;
   int count = 0;
   int ret = OK;
@@ -432,16 +714,32 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  if (nfds >= CONFIG_FS_POLL_CACHE_NFDS)
+    {
+      ret = poll_cache(fds, nfds, timeout);
+      count = ret;
+      goto out_with_cancelpt;
+    }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
-  /* Allocate kernel memory for the fds */
+  /* Allocate kernel memory for the fds, unless they fit on the stack */
 
-  kfds = fs_heap_malloc(nfds * sizeof(struct pollfd));
-  if (!kfds)
+  if (nfds <= CONFIG_FS_POLL_STACK_NFDS)
     {
-      /* Out of memory */
+      kfds = stackfds;
+    }
+  else
+    {
+      kfds = fs_heap_malloc(nfds * sizeof(struct pollfd));
+      if (!kfds)
+        {
+          /* Out of memory */
 
-      ret = -ENOMEM;
-      goto out_with_cancelpt;
+          ret = -ENOMEM;
+          goto out_with_cancelpt;
+        }
     }
 
   /* Copy the user fds to neutral kernel memory */
@@ -542,11 +840,15 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   /* Free the temporary buffer */
 
-  fs_heap_free(kfds);
+  if (kfds != stackfds)
+    {
+      fs_heap_free(kfds);
+    }
+#endif
 
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FS_POLL_CACHE)
 out_with_cancelpt:
 #endif
-
   leave_cancellation_point();
 
   if (ret < 0)
@@ -26,7 +26,9 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sched.h>
@@ -34,6 +36,7 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "notify/notify.h"
 #include "inode/inode.h"
@@ -129,6 +132,52 @@ static ssize_t file_readv_compat(FAR struct file *filep,
   return ntotal;
 }
 
+/****************************************************************************
+ * Name: file_readahead
+ *
+ * Description:
+ *   Track the sequential reads of the file and pass the readahead window to
+ *   the driver or the file system.  Only the files whose position advanced
+ *   by the amount read are considered, which leaves out pipes, sockets and
+ *   other streams.  The files that do not understand FIOC_READAHEAD are
+ *   not asked again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_READAHEAD
+static void file_readahead(FAR struct file *filep, off_t pos, ssize_t nread)
+{
+  FAR struct inode *inode = filep->f_inode;
+  int ret;
+
+  if (filep->f_rawin == SIZE_MAX)
+    {
+      return;
+    }
+
+  if (pos == filep->f_ranext && filep->f_pos == pos + nread)
+    {
+      filep->f_rawin = MIN(MAX(filep->f_rawin * 2, (size_t)nread),
+                           CONFIG_FS_READAHEAD_MAX);
+    }
+  else
+    {
+      filep->f_rawin = 0;
+    }
+
+  filep->f_ranext = filep->f_pos;
+
+  if (filep->f_rawin > 0 && inode->u.i_ops->ioctl != NULL)
+    {
+      ret = inode->u.i_ops->ioctl(filep, FIOC_READAHEAD, filep->f_rawin);
+      if (ret == -ENOTTY)
+        {
+          filep->f_rawin = SIZE_MAX;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -160,6 +209,9 @@ ssize_t file_readv(FAR struct file *filep,
 {
   FAR struct inode *inode;
   ssize_t ret = -EBADF;
+#ifdef CONFIG_FS_READAHEAD
+  off_t pos = filep->f_pos;
+#endif
 
   DEBUGASSERT(filep);
   inode = filep->f_inode;
@@ -200,6 +252,13 @@ ssize_t file_readv(FAR struct file *filep,
 
   /* Return the number of bytes read (or possibly an error code) */
 
+#ifdef CONFIG_FS_READAHEAD
+  if (ret > 0)
+    {
+      file_readahead(filep, pos, ret);
+    }
+#endif
+
 #ifdef CONFIG_FS_NOTIFY
   if (ret > 0)
     {
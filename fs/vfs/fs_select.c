@@ -91,6 +91,7 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
+  struct pollfd stackset[CONFIG_FS_POLL_STACK_NFDS];
   struct pollfd *pollset = NULL;
   int fd;
   int npfds;
@@ -126,9 +127,16 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  /* Allocate the descriptor list for poll() */
+  /* Allocate the descriptor list for poll(), unless it fits on the
+   * stack.
+   */
 
-  if (npfds > 0)
+  if (npfds <= CONFIG_FS_POLL_STACK_NFDS)
+    {
+      memset(stackset, 0, sizeof(stackset));
+      pollset = stackset;
+    }
+  else
     {
       pollset = (FAR struct pollfd *)
         fs_heap_zalloc(npfds * sizeof(struct pollfd));
@@ -280,6 +288,10 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  fs_heap_free(pollset);
+  if (pollset != stackset)
+    {
+      fs_heap_free(pollset);
+    }
+
   return ret;
 }
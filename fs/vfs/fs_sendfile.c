@@ -233,6 +233,41 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
   return ntransferred;
 }
 
+/****************************************************************************
+ * Name: splicefile
+ *
+ * Description:
+ *   Move the data through the pipe buffer until count bytes are transferred
+ *   or the end of the input is reached, like copyfile() does.
+ *
+ ****************************************************************************/
+
+static ssize_t splicefile(FAR struct file *outfile, FAR struct file *infile,
+                          FAR off_t *offset, size_t count)
+{
+  size_t ntransferred = 0;
+  ssize_t ret;
+
+  if (offset != NULL && INODE_IS_PIPE(infile->f_inode))
+    {
+      return -ESPIPE;
+    }
+
+  while (ntransferred < count)
+    {
+      ret = file_splice(infile, offset, outfile, NULL,
+                        count - ntransferred, 0);
+      if (ret <= 0)
+        {
+          return ntransferred > 0 ? (ssize_t)ntransferred : ret;
+        }
+
+      ntransferred += ret;
+    }
+
+  return ntransferred;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -279,6 +314,15 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
+  /* A pipe on either side moves the data straight between its buffer and
+   * the other file.
+   */
+
+  if (INODE_IS_PIPE(infile->f_inode) || INODE_IS_PIPE(outfile->f_inode))
+    {
+      return splicefile(outfile, infile, offset, count);
+    }
+
   /* No... then this is probably a file-to-file transfer.  The generic
    * copyfile() can handle that case.
    */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  struct pipe_splice_s sp;
+  FAR struct file *pipe;
+  bool inpipe = INODE_IS_PIPE(infile->f_inode);
+  bool outpipe = INODE_IS_PIPE(outfile->f_inode);
+  int ret;
+
+  if ((inpipe && inoff != NULL) || (outpipe && outoff != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* The pipe moves the data between its buffer and the other file */
+
+  sp.len   = len;
+  sp.flags = flags;
+  if (inpipe)
+    {
+      pipe      = infile;
+      sp.file   = outfile;
+      sp.offset = outoff;
+      sp.topipe = false;
+    }
+  else if (outpipe)
+    {
+      pipe      = outfile;
+      sp.file   = infile;
+      sp.offset = inoff;
+      sp.topipe = true;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  ret = file_ioctl(pipe, PIPEIOC_SPLICE, (unsigned long)((uintptr_t)&sp));
+  return ret == -ENOTTY ? -EINVAL : ret;
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors, one of which must
+ *   refer to a pipe.  The data goes directly between the pipe buffer and
+ *   the other file, without a trip through a user buffer.
+ *
+ * Input Parameters:
+ *   fdin   - The descriptor to read from
+ *   offin  - Offset in fdin, NULL to use and update the file position.
+ *            Must be NULL if fdin is a pipe.
+ *   fdout  - The descriptor to write to
+ *   offout - Offset in fdout, NULL to use and update the file position.
+ *            Must be NULL if fdout is a pipe.
+ *   len    - The maximum number of bytes to move
+ *   flags  - SPLICE_F_NONBLOCK: do not block on the pipe.  The other
+ *            flags are accepted as hints.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at the end of the input.  On error,
+ *   -1 is returned and errno is set appropriately:
+ *
+ *   EINVAL - Neither descriptor refers to a pipe, or both refer to the
+ *            same pipe.
+ *   ESPIPE - An offset was given for a pipe.
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe is empty or full.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fdin, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fdout, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, offin, outfile, offout, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   vmsplice() moves data between user memory and a pipe: into the pipe if
+ *   fd was opened for writing, out of it otherwise.  The memory is always
+ *   copied, SPLICE_F_GIFT is accepted but there are no pages to hand over
+ *   in a flat address space.
+ *
+ * Input Parameters:
+ *   fd    - A descriptor that refers to a pipe
+ *   iov   - The user memory segments
+ *   nsegs - The number of segments
+ *   flags - SPLICE_F_* flags, only hints for now
+ *
+ * Returned Value:
+ *   The number of bytes moved.  On error, -1 is returned and errno is set
+ *   appropriately:
+ *
+ *   EBADF  - fd is not valid or does not refer to a pipe.
+ *   EINVAL - nsegs is out of range.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nsegs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  if (nsegs > IOV_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!INODE_IS_PIPE(filep->f_inode))
+    {
+      ret = -EBADF;
+    }
+  else if ((filep->f_oflags & O_WROK) != 0)
+    {
+      ret = file_writev(filep, iov, nsegs);
+    }
+  else
+    {
+      ret = file_readv(filep, iov, nsegs);
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
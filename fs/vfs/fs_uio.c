@@ -32,6 +32,7 @@
 #include <nuttx/fs/fs.h>
 
 #include <assert.h>
+#include <stdbool.h>
 #include <errno.h>
 
 /****************************************************************************
@@ -227,3 +228,31 @@ void uio_copyto(FAR struct uio *uio, size_t offset, FAR void *buf,
       offset = 0;
     }
 }
+
+/****************************************************************************
+ * Name: uio_aligned
+ *
+ * Description:
+ *   Return true if every remaining segment of uio is a whole multiple of
+ *   align bytes, so that it can be handed to a block driver as is.
+ *
+ ****************************************************************************/
+
+bool uio_aligned(FAR const struct uio *uio, size_t align)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  size_t offset = uio->uio_offset_in_iov;
+  int i;
+
+  DEBUGASSERT(align > 0);
+
+  for (i = 0; i < uio->uio_iovcnt; i++, offset = 0)
+    {
+      if ((iov[i].iov_len - offset) % align != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
@@ -27,7 +27,9 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -39,6 +41,16 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* How the data of an open entry is read */
+
+#define ZIPFS_MINIZIP     0  /* Through minizip, restarted on backward seek */
+#define ZIPFS_STORED      1  /* Straight from the archive */
+#define ZIPFS_DEFLATED    2  /* Inflated here, with checkpoints */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -51,16 +63,49 @@ struct zipfs_dir_s
   bool last;
 };
 
+/* One entry of the name index built at mount time, sorted by hash */
+
+struct zipfs_entry_s
+{
+  uint32_t hash;
+  uint32_t name;               /* Offset of the name in the name pool */
+  ZPOS64_T size;               /* Uncompressed size */
+  unz64_file_pos pos;          /* Position in the central directory */
+};
+
 struct zipfs_mountpt_s
 {
+  FAR struct zipfs_entry_s *index;
+  FAR char *names;
+  size_t nentries;
   char abspath[1];
 };
 
+/* The state of the inflate stream at some uncompressed offset */
+
+struct zipfs_ckpt_s
+{
+  off_t out;                   /* Uncompressed offset */
+  off_t in;                    /* Compressed bytes consumed */
+  z_stream strm;
+};
+
 struct zipfs_file_s
 {
-  unzFile uf;
+  unzFile uf;                  /* NULL unless method is ZIPFS_MINIZIP */
   mutex_t lock;
   FAR char *seekbuf;
+  int method;
+  struct file data;            /* The archive, for direct reads */
+  off_t datapos;               /* Offset of the entry data in the archive */
+  off_t csize;                 /* Compressed size */
+  off_t size;                  /* Uncompressed size */
+  off_t pos;                   /* Uncompressed offset of the stream */
+  off_t inpos;                 /* Compressed bytes read from the archive */
+  z_stream strm;
+  FAR Bytef *inbuf;
+  FAR struct zipfs_ckpt_s *ckpt;
+  int nckpt;
   char relpath[1];
 };
 
@@ -243,6 +288,404 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+static uint32_t zipfs_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+static int zipfs_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct zipfs_entry_s *ea = a;
+  FAR const struct zipfs_entry_s *eb = b;
+
+  return ea->hash < eb->hash ? -1 : ea->hash > eb->hash;
+}
+
+static FAR struct zipfs_entry_s *
+zipfs_lookup(FAR struct zipfs_mountpt_s *fs, FAR const char *relpath)
+{
+  uint32_t hash = zipfs_hash(relpath);
+  size_t low = 0;
+  size_t high = fs->nentries;
+
+  while (low < high)
+    {
+      size_t mid = (low + high) / 2;
+
+      if (fs->index[mid].hash < hash)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  for (; low < fs->nentries && fs->index[low].hash == hash; low++)
+    {
+      if (strcmp(fs->names + fs->index[low].name, relpath) == 0)
+        {
+          return &fs->index[low];
+        }
+    }
+
+  return NULL;
+}
+
+/* Build the hashed name index of the central directory, so a lookup no
+ * longer walks the whole directory through minizip.
+ */
+
+static int zipfs_build_index(FAR struct zipfs_mountpt_s *fs, unzFile uf)
+{
+  unz_global_info64 global;
+  unz_file_info64 file_info;
+  char name[PATH_MAX];
+  size_t namesize = 0;
+  size_t namelen = 0;
+  FAR char *names;
+  int ret;
+
+  ret = zipfs_convert_result(unzGetGlobalInfo64(uf, &global));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (global.number_entry == 0)
+    {
+      return OK;
+    }
+
+  fs->index = fs_heap_malloc(global.number_entry * sizeof(*fs->index));
+  if (fs->index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = zipfs_convert_result(unzGoToFirstFile(uf));
+  while (ret == OK && fs->nentries < global.number_entry)
+    {
+      FAR struct zipfs_entry_s *entry = &fs->index[fs->nentries];
+      size_t len;
+
+      ret = unzGetCurrentFileInfo64(uf, &file_info, name, sizeof(name),
+                                    NULL, 0, NULL, 0);
+      ret = zipfs_convert_result(ret);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = zipfs_convert_result(unzGetFilePos64(uf, &entry->pos));
+      if (ret < 0)
+        {
+          break;
+        }
+
+      len = strlen(name) + 1;
+      if (namelen + len > namesize)
+        {
+          namesize = MAX(2 * namesize, namelen + len + 256);
+          names = fs_heap_realloc(fs->names, namesize);
+          if (names == NULL)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+
+          fs->names = names;
+        }
+
+      memcpy(fs->names + namelen, name, len);
+      entry->hash = zipfs_hash(name);
+      entry->name = namelen;
+      entry->size = file_info.uncompressed_size;
+      namelen += len;
+      fs->nentries++;
+
+      ret = zipfs_convert_result(unzGoToNextFile(uf));
+    }
+
+  if (ret < 0 && ret != -ENOENT)
+    {
+      fs_heap_free(fs->index);
+      fs_heap_free(fs->names);
+      fs->index = NULL;
+      fs->names = NULL;
+      fs->nentries = 0;
+      return ret;
+    }
+
+  qsort(fs->index, fs->nentries, sizeof(*fs->index), zipfs_compare);
+  return OK;
+}
+
+static int zipfs_locate(FAR struct zipfs_mountpt_s *fs, unzFile uf,
+                        FAR const char *relpath)
+{
+  FAR struct zipfs_entry_s *entry;
+
+  entry = zipfs_lookup(fs, relpath);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  return zipfs_convert_result(unzGoToFilePos64(uf, &entry->pos));
+}
+
+/* Stored and deflated entries are read from the archive directly.  Find
+ * the entry data and set up the inflate stream for deflated entries.
+ */
+
+static int zipfs_direct_open(FAR struct zipfs_mountpt_s *fs,
+                             FAR struct zipfs_file_s *fp)
+{
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info, NULL, 0,
+                                NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fp->csize = file_info.compressed_size;
+  fp->size  = file_info.uncompressed_size;
+
+  /* Leave encrypted entries and other methods to minizip */
+
+  if ((file_info.flag & 1) != 0 ||
+      (file_info.compression_method != 0 &&
+       file_info.compression_method != Z_DEFLATED))
+    {
+      return OK;
+    }
+
+  fp->datapos = unzGetCurrentFileZStreamPos64(fp->uf);
+
+  if (file_info.compression_method == Z_DEFLATED)
+    {
+      fp->inbuf = fs_heap_malloc(CONFIG_ZIPFS_INFLATE_BUFSIZE);
+      if (fp->inbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(&fp->strm, 0, sizeof(fp->strm));
+      if (inflateInit2(&fp->strm, -MAX_WBITS) != Z_OK)
+        {
+          fs_heap_free(fp->inbuf);
+          fp->inbuf = NULL;
+          return -ENOMEM;
+        }
+    }
+
+  ret = file_open(&fp->data, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      if (fp->inbuf != NULL)
+        {
+          inflateEnd(&fp->strm);
+          fs_heap_free(fp->inbuf);
+          fp->inbuf = NULL;
+        }
+
+      return ret;
+    }
+
+  /* minizip is not needed any more, drop its inflate state and handle */
+
+  unzCloseCurrentFile(fp->uf);
+  unzClose(fp->uf);
+  fp->uf = NULL;
+  fp->method = fp->inbuf != NULL ? ZIPFS_DEFLATED : ZIPFS_STORED;
+  return OK;
+}
+
+static void zipfs_direct_close(FAR struct zipfs_file_s *fp)
+{
+  int i;
+
+  if (fp->method == ZIPFS_MINIZIP)
+    {
+      return;
+    }
+
+  if (fp->method == ZIPFS_DEFLATED)
+    {
+      for (i = 0; i < fp->nckpt; i++)
+        {
+          inflateEnd(&fp->ckpt[i].strm);
+        }
+
+      fs_heap_free(fp->ckpt);
+      inflateEnd(&fp->strm);
+      fs_heap_free(fp->inbuf);
+    }
+
+  file_close(&fp->data);
+}
+
+/* Save the stream state when it reaches the next checkpoint boundary */
+
+static void zipfs_checkpoint(FAR struct zipfs_file_s *fp)
+{
+#if CONFIG_ZIPFS_CHECKPOINT_INTERVAL > 0
+  FAR struct zipfs_ckpt_s *ckpt;
+
+  if (fp->pos == 0 || fp->pos % CONFIG_ZIPFS_CHECKPOINT_INTERVAL != 0 ||
+      fp->pos / CONFIG_ZIPFS_CHECKPOINT_INTERVAL != fp->nckpt + 1 ||
+      fp->nckpt >= CONFIG_ZIPFS_CHECKPOINT_MAX)
+    {
+      return;
+    }
+
+  if (fp->ckpt == NULL)
+    {
+      fp->ckpt = fs_heap_malloc(CONFIG_ZIPFS_CHECKPOINT_MAX *
+                                sizeof(*fp->ckpt));
+      if (fp->ckpt == NULL)
+        {
+          return;
+        }
+    }
+
+  ckpt = &fp->ckpt[fp->nckpt];
+  if (inflateCopy(&ckpt->strm, &fp->strm) == Z_OK)
+    {
+      ckpt->out = fp->pos;
+      ckpt->in  = fp->inpos - fp->strm.avail_in;
+      fp->nckpt++;
+    }
+#endif
+}
+
+static ssize_t zipfs_inflate(FAR struct zipfs_file_s *fp,
+                             FAR char *buffer, size_t buflen)
+{
+  size_t total = 0;
+
+  while (total < buflen && fp->pos < fp->size)
+    {
+      size_t n = buflen - total;
+      ssize_t nread;
+      int ret;
+
+#if CONFIG_ZIPFS_CHECKPOINT_INTERVAL > 0
+      /* Stop at the next checkpoint boundary to save the state there */
+
+      n = MIN(n, CONFIG_ZIPFS_CHECKPOINT_INTERVAL -
+                 fp->pos % CONFIG_ZIPFS_CHECKPOINT_INTERVAL);
+#endif
+
+      if (fp->strm.avail_in == 0 && fp->inpos < fp->csize)
+        {
+          nread = MIN(CONFIG_ZIPFS_INFLATE_BUFSIZE, fp->csize - fp->inpos);
+          nread = file_pread(&fp->data, fp->inbuf, nread,
+                             fp->datapos + fp->inpos);
+          if (nread <= 0)
+            {
+              return total > 0 ? total : nread < 0 ? nread : -EIO;
+            }
+
+          fp->inpos        += nread;
+          fp->strm.next_in  = fp->inbuf;
+          fp->strm.avail_in = nread;
+        }
+
+      fp->strm.next_out  = (FAR Bytef *)buffer + total;
+      fp->strm.avail_out = n;
+      ret = inflate(&fp->strm, Z_NO_FLUSH);
+      n -= fp->strm.avail_out;
+      total   += n;
+      fp->pos += n;
+
+      if (ret == Z_STREAM_END)
+        {
+          break;
+        }
+      else if (ret != Z_OK)
+        {
+          return total > 0 ? total : -EIO;
+        }
+
+      zipfs_checkpoint(fp);
+    }
+
+  return total;
+}
+
+/* Move the inflate stream to offset, starting from the nearest checkpoint
+ * before it if that is closer than the current position.
+ */
+
+static int zipfs_inflate_seek(FAR struct zipfs_file_s *fp, off_t offset)
+{
+  FAR struct zipfs_ckpt_s *best = NULL;
+  ssize_t ret;
+  int i;
+
+  for (i = 0; i < fp->nckpt && fp->ckpt[i].out <= offset; i++)
+    {
+      best = &fp->ckpt[i];
+    }
+
+  if (offset < fp->pos || (best != NULL && best->out > fp->pos))
+    {
+      if (best != NULL)
+        {
+          inflateEnd(&fp->strm);
+          if (inflateCopy(&fp->strm, &best->strm) != Z_OK)
+            {
+              memset(&fp->strm, 0, sizeof(fp->strm));
+              inflateInit2(&fp->strm, -MAX_WBITS);
+              best = NULL;
+            }
+        }
+      else
+        {
+          inflateReset(&fp->strm);
+        }
+
+      fp->strm.avail_in = 0;
+      fp->pos   = best != NULL ? best->out : 0;
+      fp->inpos = best != NULL ? best->in : 0;
+    }
+
+  if (fp->seekbuf == NULL && fp->pos < offset)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (fp->pos < offset)
+    {
+      ret = zipfs_inflate(fp, fp->seekbuf,
+                          MIN(offset - fp->pos, CONFIG_ZIPFS_SEEK_BUFSIZE));
+      if (ret <= 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -252,7 +695,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 
   DEBUGASSERT(fs != NULL);
 
-  fp = fs_heap_malloc(sizeof(*fp) + strlen(relpath));
+  fp = fs_heap_zalloc(sizeof(*fp) + strlen(relpath));
   if (fp == NULL)
     {
       return -ENOMEM;
@@ -271,7 +714,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_mutex;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(fp->uf, relpath, 0));
+  ret = zipfs_locate(fs, fp->uf, relpath);
   if (ret < 0)
     {
       goto err_with_zip;
@@ -283,9 +726,9 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+  ret = zipfs_direct_open(fs, fp);
   if (ret == OK)
     {
-      fp->seekbuf = NULL;
       strcpy(fp->relpath, relpath);
       filep->f_priv = fp;
     }
@@ -305,9 +748,14 @@ err_with_fp:
 static int zipfs_close(FAR struct file *filep)
 {
   FAR struct zipfs_file_s *fp = filep->f_priv;
-  int ret;
+  int ret = OK;
 
-  ret = zipfs_convert_result(unzClose(fp->uf));
+  if (fp->uf != NULL)
+    {
+      ret = zipfs_convert_result(unzClose(fp->uf));
+    }
+
+  zipfs_direct_close(fp);
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
   fs_heap_free(fp);
@@ -321,7 +769,26 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+  if (fp->method == ZIPFS_STORED)
+    {
+      ret = 0;
+      if (filep->f_pos < fp->size)
+        {
+          ret = file_pread(&fp->data, buffer,
+                           MIN(buflen, fp->size - filep->f_pos),
+                           fp->datapos + filep->f_pos);
+        }
+    }
+  else if (fp->method == ZIPFS_DEFLATED)
+    {
+      ret = zipfs_inflate(fp, buffer, buflen);
+    }
+  else
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer, buflen);
+      ret = zipfs_convert_result(ret);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -369,9 +836,7 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
-  unz_file_info64 file_info;
   off_t ret = 0;
 
   nxmutex_lock(&fp->lock);
@@ -383,41 +848,40 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         offset += filep->f_pos;
         break;
       case SEEK_END:
-        ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
-                                      NULL, 0, NULL, 0, NULL, 0);
-        ret = zipfs_convert_result(ret);
-        if (ret < 0)
-          {
-            goto err_with_lock;
-          }
-
-          offset += file_info.uncompressed_size;
+        offset += fp->size;
         break;
       default:
         ret = -EINVAL;
         goto err_with_lock;
     }
 
+  if (offset < 0)
+    {
+      ret = -EINVAL;
+      goto err_with_lock;
+    }
+
+  if (fp->method == ZIPFS_STORED)
+    {
+      filep->f_pos = offset;
+      goto err_with_lock;
+    }
+  else if (fp->method == ZIPFS_DEFLATED)
+    {
+      ret = zipfs_inflate_seek(fp, offset);
+      filep->f_pos = fp->pos;
+      goto err_with_lock;
+    }
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
     }
   else if (filep->f_pos > offset)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
+      /* Restart the entry, the archive stays open */
 
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
-        {
-          ret = -EINVAL;
-          goto err_with_lock;
-        }
-
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
+      ret = zipfs_convert_result(unzCloseCurrentFile(fp->uf));
       if (ret < 0)
         {
           goto err_with_lock;
@@ -456,31 +920,15 @@ static int zipfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   return zipfs_open(newp, fp->relpath, oldp->f_oflags, 0);
 }
 
-static int zipfs_stat_common(unzFile uf, FAR struct stat *buf)
-{
-  unz_file_info64 file_info;
-  int ret;
-
-  memset(buf, 0, sizeof(struct stat));
-
-  ret = unzGetCurrentFileInfo64(uf, &file_info, NULL, 0,
-                                NULL, 0, NULL, 0);
-  ret = zipfs_convert_result(ret);
-  if (ret >= 0)
-    {
-      buf->st_size = file_info.uncompressed_size;
-      buf->st_mode = S_IFREG | 0444;
-    }
-
-  return ret;
-}
-
 static int zipfs_fstat(FAR const struct file *filep,
                        FAR struct stat *buf)
 {
   FAR struct zipfs_file_s *fp = filep->f_priv;
 
-  return zipfs_stat_common(fp->uf, buf);
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_size = fp->size;
+  buf->st_mode = S_IFREG | 0444;
+  return OK;
 }
 
 static int zipfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
@@ -584,6 +1032,7 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 {
   FAR struct zipfs_mountpt_s *fs;
   unzFile uf;
+  int ret;
 
   if (data == NULL)
     {
@@ -603,7 +1052,14 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
       return -EINVAL;
     }
 
+  ret = zipfs_build_index(fs, uf);
   unzClose(uf);
+  if (ret < 0)
+    {
+      fs_heap_free(fs);
+      return ret;
+    }
+
   strcpy(fs->abspath, data);
   *handle = fs;
 
@@ -613,7 +1069,11 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
-  fs_heap_free(handle);
+  FAR struct zipfs_mountpt_s *fs = handle;
+
+  fs_heap_free(fs->index);
+  fs_heap_free(fs->names);
+  fs_heap_free(fs);
   return OK;
 }
 
@@ -628,8 +1088,7 @@ static int zipfs_stat(FAR struct inode *mountpt,
                       FAR const char *relpath, FAR struct stat *buf)
 {
   FAR struct zipfs_mountpt_s *fs;
-  unzFile uf;
-  int ret;
+  FAR struct zipfs_entry_s *entry;
 
   /* Sanity checks */
 
@@ -641,22 +1100,17 @@ static int zipfs_stat(FAR struct inode *mountpt,
       return OK;
     }
 
-  fs = mountpt->i_private;
-  uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-  if (uf == NULL)
-    {
-      return -EINVAL;
-    }
+  /* Answered from the index, without touching the archive */
 
-  ret = zipfs_convert_result(unzLocateFile(uf, relpath, 0));
-  if (ret < 0)
+  fs = mountpt->i_private;
+  entry = zipfs_lookup(fs, relpath);
+  if (entry == NULL)
     {
-      unzClose(uf);
-      return ret;
+      return -ENOENT;
     }
 
-  ret = zipfs_stat_common(uf, buf);
-
-  unzClose(uf);
-  return ret;
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_size = entry->size;
+  buf->st_mode = S_IFREG | 0444;
+  return OK;
 }
@@ -51,9 +51,25 @@ void nxbe_redrawbelow(FAR struct nxbe_state_s *be,
                       FAR const struct nxgl_rect_s *rect)
 {
   FAR struct nxbe_window_s *currwnd;
+  struct nxgl_rect_s region;
+
+  /* Only the part of the region on the display matters */
+
+  nxgl_rectintersect(&region, rect, &be->bkgd.bounds);
 
   for (currwnd = wnd; currwnd; currwnd = currwnd->below)
     {
-      nxbe_redraw(be, currwnd, rect);
+      nxbe_redraw(be, currwnd, &region);
+
+      /* Windows are opaque, so once a visible window covers the whole
+       * region, everything below it is fully occluded.
+       */
+
+      if (!NXBE_ISHIDDEN(currwnd) &&
+          nxgl_rectinside(&currwnd->bounds, &region.pt1) &&
+          nxgl_rectinside(&currwnd->bounds, &region.pt2))
+        {
+          break;
+        }
     }
 }
@@ -29,7 +29,9 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -106,53 +108,24 @@
 #  define NXGL_ALIGNDOWN(x)        ((x) & ~NXGL_PIXELMASK)
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
+/* Whole bytes are filled with memset() and copied with memmove(), which
+ * move a word or more at a time and tolerate the overlapping rows of
+ * nxgl_moverectangle.
+ */
+
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+   memset((dest), (value), NXGL_SCALEX(width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+   nxgl_memset24((FAR uint8_t *)(dest), (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -171,28 +144,21 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
-
-#  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+#else /* NXGLIB_BITSPERPIXEL == 8 || 16 || 32 */
+
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_MEMSET(dest,value,width) \
+     memset((dest), (value), (width))
+#  elif NXGLIB_BITSPERPIXEL == 16
+#    define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset16((FAR uint16_t *)(dest), (value), (width))
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset32((FAR uint32_t *)(dest), (value), (width))
+#  endif
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -211,6 +177,113 @@
 #define _NXGL_FUNCNAME(a,b) a ## b
 #define NXGL_FUNCNAME(a,b)  _NXGL_FUNCNAME(a,b)
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+/****************************************************************************
+ * Name: nxgl_memset16
+ *
+ * Description:
+ *   Fill a run of 16-bit pixels two at a time with aligned 32-bit stores.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_memset16(FAR uint16_t *dest, uint16_t value,
+                                 size_t npixels)
+{
+  FAR uint32_t *wptr;
+  uint32_t value32 = ((uint32_t)value << 16) | value;
+
+  if (npixels > 0 && ((uintptr_t)dest & 2) != 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  wptr = (FAR uint32_t *)dest;
+  for (; npixels >= 8; npixels -= 8, wptr += 4)
+    {
+      wptr[0] = value32;
+      wptr[1] = value32;
+      wptr[2] = value32;
+      wptr[3] = value32;
+    }
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wptr++ = value32;
+    }
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wptr = value;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 24
+/****************************************************************************
+ * Name: nxgl_memset24
+ *
+ * Description:
+ *   Fill a run of packed 24-bit pixels.  The first pixel is stored byte by
+ *   byte, then the filled part is doubled with memcpy() until the run is
+ *   complete, so most of the work is done by word-wide copies.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_memset24(FAR uint8_t *dest, uint32_t value,
+                                 size_t npixels)
+{
+  size_t total = npixels * 3;
+  size_t done = 3;
+
+  if (npixels == 0)
+    {
+      return;
+    }
+
+  dest[0] = value;
+  dest[1] = value >> 8;
+  dest[2] = value >> 16;
+
+  while (done < total)
+    {
+      size_t len = total - done < done ? total - done : done;
+
+      memcpy(dest + done, dest, len);
+      done += len;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 32
+/****************************************************************************
+ * Name: nxgl_memset32
+ *
+ * Description:
+ *   Fill a run of 32-bit pixels, four stores per iteration.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_memset32(FAR uint32_t *dest, uint32_t value,
+                                 size_t npixels)
+{
+  for (; npixels >= 4; npixels -= 4, dest += 4)
+    {
+      dest[0] = value;
+      dest[1] = value;
+      dest[2] = value;
+      dest[3] = value;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = value;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
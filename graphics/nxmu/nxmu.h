@@ -217,6 +217,19 @@ void nxmu_redrawreq(FAR struct nxbe_window_s *wnd,
 void nxmu_redraw(FAR struct nxbe_window_s *wnd,
                  FAR const struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: nxmu_redrawflush
+ *
+ * Description:
+ *   Send the redraw requests accumulated by nxmu_redrawreq(), one per
+ *   damaged window.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DEFERREDRAW
+void nxmu_redrawflush(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nxmu_mouseinit
  *
@@ -128,6 +128,22 @@ void nxmu_redrawreq(FAR struct nxbe_window_s *wnd,
 {
   struct nxclimsg_redraw_s outmsg;
 
+#ifdef CONFIG_NX_DEFERREDRAW
+  /* Only accumulate the damage, nxmu_redrawflush() sends the request */
+
+  if (NXBE_ISDAMAGED(wnd))
+    {
+      nxgl_rectunion(&wnd->damage, &wnd->damage, rect);
+    }
+  else
+    {
+      nxgl_rectcopy(&wnd->damage, rect);
+      NXBE_SETDAMAGED(wnd);
+    }
+
+  return;
+#endif
+
   /* Send the client redraw message */
 
   outmsg.msgid = NX_CLIMSG_REDRAW;
@@ -179,3 +195,46 @@ void nxmu_redraw(FAR struct nxbe_window_s *wnd,
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxmu_redrawflush
+ *
+ * Description:
+ *   Send the redraw requests accumulated by nxmu_redrawreq(), one per
+ *   damaged window.  The damage is clipped to the current window bounds
+ *   since the window may have been moved or resized in the meantime.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DEFERREDRAW
+void nxmu_redrawflush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_window_s *wnd;
+  struct nxclimsg_redraw_s outmsg;
+
+  for (wnd = be->topwnd; wnd != NULL; wnd = wnd->below)
+    {
+      if (!NXBE_ISDAMAGED(wnd))
+        {
+          continue;
+        }
+
+      NXBE_CLRDAMAGED(wnd);
+
+      nxgl_rectintersect(&wnd->damage, &wnd->damage, &wnd->bounds);
+      if (NXBE_ISHIDDEN(wnd) || nxgl_nullrect(&wnd->damage))
+        {
+          continue;
+        }
+
+      outmsg.msgid = NX_CLIMSG_REDRAW;
+      outmsg.wnd   = wnd;
+      outmsg.more  = false;
+      nxgl_rectoffset(&outmsg.rect, &wnd->damage,
+                      -wnd->bounds.pt1.x, -wnd->bounds.pt1.y);
+
+      nxmu_sendclientwindow(wnd, &outmsg,
+                            sizeof(struct nxclimsg_redraw_s));
+    }
+}
+#endif
@@ -272,6 +272,9 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_DEFERREDRAW
+  struct mq_attr         attr;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -297,6 +300,18 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
+#ifdef CONFIG_NX_DEFERREDRAW
+      /* Send the merged redraw requests once every queued message has been
+       * processed, so that a burst of operations causes one redraw per
+       * damaged window.
+       */
+
+      if (mq_getattr(nxmu.conn.crdmq, &attr) < 0 || attr.mq_curmsgs == 0)
+        {
+          nxmu_redrawflush(&nxmu.be);
+        }
+#endif
+
       /* Receive the next server message */
 
       nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
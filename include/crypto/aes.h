@@ -58,4 +58,17 @@ void aes_decrypt_ecb(FAR AES_CTX *, FAR const uint8_t *, FAR uint8_t *,
 int aes_keysetup_encrypt(FAR uint32_t *, FAR const uint8_t *, int);
 int aes_keysetup_decrypt(FAR uint32_t *, FAR const uint8_t *, int);
 
+#ifdef CONFIG_CRYPTO_AES_ARCH
+/* AES with the instructions of the CPU (aes_armv8.c, aes_rv64zkn.c).
+ * aes_setkey() leaves the round keys as bytes at the start of sk_exp and
+ * aes_arch_setkey() derives the decryption round keys at sk_exp + 60.
+ */
+
+void aes_arch_setkey(FAR AES_CTX *);
+void aes_arch_encrypt_ecb(FAR AES_CTX *, FAR const uint8_t *,
+                          FAR uint8_t *, size_t);
+void aes_arch_decrypt_ecb(FAR AES_CTX *, FAR const uint8_t *,
+                          FAR uint8_t *, size_t);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_AES_H */
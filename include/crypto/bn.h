@@ -227,6 +227,20 @@ void bignum_assign(FAR struct bn *dst, FAR struct bn *src);
 void pow_mod_faster(FAR struct bn *a, FAR struct bn *b,
                     FAR struct bn *n, FAR struct bn *res);
 
+/* res = a^b mod n for an odd n, by Montgomery multiplication with a
+ * sliding window; returns -EINVAL for an even n or -ENOMEM.
+ */
+
+int bignum_mod_exp(FAR struct bn *a, FAR struct bn *b,
+                   FAR struct bn *n, FAR struct bn *res);
+
+/* res = x^d mod pq from the CRT key (p, q, dp, dq, qinv) */
+
+int bignum_mod_exp_crt(FAR struct bn *x, FAR struct bn *p,
+                       FAR struct bn *q, FAR struct bn *dp,
+                       FAR struct bn *dq, FAR struct bn *qinv,
+                       FAR struct bn *res);
+
 /* Return the number of less significant zero-bits */
 
 int bignum_lsb(FAR struct bn *a);
@@ -371,6 +371,32 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* Asynchronous operations (CIOCNCRYPTM): the operations of a batch are
+ * queued and run on kernel worker threads, in order within a session and
+ * in parallel across sessions.  The buffers of an operation must stay
+ * valid until its result has been read back with read(), which returns
+ * an array of struct crypt_result and polls for POLLIN.
+ */
+
+struct crypt_n_op
+{
+  struct crypt_op cop;
+  uint32_t reqid;     /* returned in the result */
+  int status;         /* returns: 0 if queued, else a negated errno */
+};
+
+struct crypt_mop
+{
+  unsigned count;     /* number of operations */
+  FAR struct crypt_n_op *reqs;
+};
+
+struct crypt_result
+{
+  uint32_t reqid;
+  int status;         /* 0 or a negated errno */
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -392,6 +418,7 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCNCRYPTM             107
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
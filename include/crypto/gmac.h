@@ -48,6 +48,14 @@ AES_GMAC_CTX;
 
 extern void (*ghash_update)(FAR GHASH_CTX *, FAR uint8_t *, size_t);
 
+#ifdef CONFIG_CRYPTO_AES_ARCH
+/* GHASH with the carry-less multiply instructions (aes_armv8.c,
+ * aes_rv64zkn.c)
+ */
+
+void ghash_arch_update(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#endif
+
 void aes_gmac_init(FAR void *);
 void aes_gmac_setkey(FAR void *, FAR const uint8_t *, uint16_t);
 void aes_gmac_reinit(FAR void *, FAR const uint8_t *, uint16_t);
@@ -14,15 +14,30 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #define poly1305_block_size 16
 
+/* Where the compiler has a 64 x 64 = 128 bit multiplication, r and h are
+ * kept in three 44-bit limbs rather than five 26-bit ones.
+ */
+
+#ifdef __SIZEOF_INT128__
+#  define POLY1305_64BIT
+#endif
+
 typedef struct poly1305_state
 {
+#ifdef POLY1305_64BIT
+  uint64_t r[3];
+  uint64_t h[3];
+  uint64_t pad[2];
+#else
   unsigned long r[5];
   unsigned long h[5];
   unsigned long pad[4];
+#endif
   size_t leftover;
   unsigned char buffer[poly1305_block_size];
   unsigned char final;
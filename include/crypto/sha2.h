@@ -78,6 +78,13 @@ void sha256init(FAR SHA2_CTX *);
 void sha256update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha256final(FAR uint8_t *, FAR SHA2_CTX *);
 
+/* digest[i] = SHA-256(data[i], len[i]) for i < count, several messages
+ * at a time where the CPU has SIMD.
+ */
+
+void sha256multi(FAR const uint8_t * const *data, FAR const size_t *len,
+                 FAR uint8_t (*digest)[SHA256_DIGEST_LENGTH], size_t count);
+
 void sha384init(FAR SHA2_CTX *);
 void sha384update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha384final(FAR uint8_t *, FAR SHA2_CTX *);
@@ -86,4 +93,12 @@ void sha512init(FAR SHA2_CTX *);
 void sha512update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha512final(FAR uint8_t *, FAR SHA2_CTX *);
 
+#ifdef CONFIG_CRYPTO_SHA256_ARCH
+/* The SHA-256 transform with the instructions of the CPU
+ * (sha256_armv8.c).
+ */
+
+void sha256_arch_transform(FAR uint32_t *state, FAR const uint8_t *data);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_SHA2_H */
@@ -459,6 +459,69 @@ struct avg_filter_data_s
   float k;             /* k counter */
 };
 
+/* Batch versions of the frames and controllers above, one entry per motor
+ * axis in each array (structure-of-arrays layout), so that one call
+ * processes all axes and the compiler can vectorize across them.
+ */
+
+struct abc_batch_f32_s
+{
+  FAR float *a;                /* A components */
+  FAR float *b;                /* B components */
+  FAR float *c;                /* C components */
+};
+
+typedef struct abc_batch_f32_s abc_batch_f32_t;
+
+struct ab_batch_f32_s
+{
+  FAR float *a;                /* Alpha components */
+  FAR float *b;                /* Beta components */
+};
+
+typedef struct ab_batch_f32_s ab_batch_f32_t;
+
+struct dq_batch_f32_s
+{
+  FAR float *d;                /* Direct components */
+  FAR float *q;                /* Quadrature components */
+};
+
+typedef struct dq_batch_f32_s dq_batch_f32_t;
+
+struct phase_angle_batch_f32_s
+{
+  FAR float *sin;              /* Phase angle sines */
+  FAR float *cos;              /* Phase angle cosines */
+};
+
+typedef struct phase_angle_batch_f32_s phase_angle_batch_f32_t;
+
+struct svm3_batch_f32_s
+{
+  FAR uint8_t *sector;         /* Space vector sectors, may be NULL */
+  FAR float   *d_u;            /* Duty cycles for phase U */
+  FAR float   *d_v;            /* Duty cycles for phase V */
+  FAR float   *d_w;            /* Duty cycles for phase W */
+};
+
+/* PI controllers with output saturation and anti-windup decay always
+ * enabled (KC = 0 disables the latter).
+ */
+
+struct pi_batch_f32_s
+{
+  FAR float *KP;               /* Proportional coefficients */
+  FAR float *KI;               /* Integral coefficients */
+  FAR float *KC;               /* Integral anti-windup decay coefficients */
+  FAR float *min;              /* Lower output limits */
+  FAR float *max;              /* Upper output limits */
+  FAR float *part_i;           /* Integral parts */
+  FAR float *aw;               /* Integral anti-windup decay parts */
+};
+
+typedef struct pi_batch_f32_s pi_batch_f32_t;
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -619,6 +682,23 @@ void avg_filter_data_init(FAR struct avg_filter_data_s *data,
                           float prev_avg, float k);
 float avg_filter(FAR struct avg_filter_data_s *data, float x);
 
+/* Batch functions, n axes per call */
+
+void clarke_transform_batch(FAR abc_batch_f32_t *abc,
+                            FAR ab_batch_f32_t *ab, size_t n);
+void inv_clarke_transform_batch(FAR ab_batch_f32_t *ab,
+                                FAR abc_batch_f32_t *abc, size_t n);
+void park_transform_batch(FAR phase_angle_batch_f32_t *angle,
+                          FAR ab_batch_f32_t *ab,
+                          FAR dq_batch_f32_t *dq, size_t n);
+void inv_park_transform_batch(FAR phase_angle_batch_f32_t *angle,
+                              FAR dq_batch_f32_t *dq,
+                              FAR ab_batch_f32_t *ab, size_t n);
+void svm3_batch(FAR struct svm3_batch_f32_s *s, FAR ab_batch_f32_t *v_ab,
+                size_t n);
+void pi_controller_batch(FAR pi_batch_f32_t *pi, FAR const float *err,
+                         FAR float *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -441,6 +441,68 @@ struct pmsm_model_b16_s
   b16_t                         iq_int; /* Iq integral part */
 };
 
+/* Batch versions of the frames and controllers above, one entry per motor
+ * axis in each array (structure-of-arrays layout).
+ */
+
+struct abc_batch_b16_s
+{
+  FAR b16_t *a;                /* A components */
+  FAR b16_t *b;                /* B components */
+  FAR b16_t *c;                /* C components */
+};
+
+typedef struct abc_batch_b16_s abc_batch_b16_t;
+
+struct ab_batch_b16_s
+{
+  FAR b16_t *a;                /* Alpha components */
+  FAR b16_t *b;                /* Beta components */
+};
+
+typedef struct ab_batch_b16_s ab_batch_b16_t;
+
+struct dq_batch_b16_s
+{
+  FAR b16_t *d;                /* Direct components */
+  FAR b16_t *q;                /* Quadrature components */
+};
+
+typedef struct dq_batch_b16_s dq_batch_b16_t;
+
+struct phase_angle_batch_b16_s
+{
+  FAR b16_t *sin;              /* Phase angle sines */
+  FAR b16_t *cos;              /* Phase angle cosines */
+};
+
+typedef struct phase_angle_batch_b16_s phase_angle_batch_b16_t;
+
+struct svm3_batch_b16_s
+{
+  FAR uint8_t *sector;         /* Space vector sectors, may be NULL */
+  FAR b16_t   *d_u;            /* Duty cycles for phase U */
+  FAR b16_t   *d_v;            /* Duty cycles for phase V */
+  FAR b16_t   *d_w;            /* Duty cycles for phase W */
+};
+
+/* PI controllers with output saturation and anti-windup decay always
+ * enabled (KC = 0 disables the latter).
+ */
+
+struct pi_batch_b16_s
+{
+  FAR b16_t *KP;               /* Proportional coefficients */
+  FAR b16_t *KI;               /* Integral coefficients */
+  FAR b16_t *KC;               /* Integral anti-windup decay coefficients */
+  FAR b16_t *min;              /* Lower output limits */
+  FAR b16_t *max;              /* Upper output limits */
+  FAR b16_t *part_i;           /* Integral parts */
+  FAR b16_t *aw;               /* Integral anti-windup decay parts */
+};
+
+typedef struct pi_batch_b16_s pi_batch_b16_t;
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -600,6 +662,23 @@ int pmsm_model_elec_b16(FAR struct pmsm_model_b16_s *model,
                         FAR ab_frame_b16_t *vab);
 int pmsm_model_mech_b16(FAR struct pmsm_model_b16_s *model, b16_t load);
 
+/* Batch functions, n axes per call */
+
+void clarke_transform_batch_b16(FAR abc_batch_b16_t *abc,
+                                FAR ab_batch_b16_t *ab, size_t n);
+void inv_clarke_transform_batch_b16(FAR ab_batch_b16_t *ab,
+                                    FAR abc_batch_b16_t *abc, size_t n);
+void park_transform_batch_b16(FAR phase_angle_batch_b16_t *angle,
+                              FAR ab_batch_b16_t *ab,
+                              FAR dq_batch_b16_t *dq, size_t n);
+void inv_park_transform_batch_b16(FAR phase_angle_batch_b16_t *angle,
+                                  FAR dq_batch_b16_t *dq,
+                                  FAR ab_batch_b16_t *ab, size_t n);
+void svm3_batch_b16(FAR struct svm3_batch_b16_s *s,
+                    FAR ab_batch_b16_t *v_ab, size_t n);
+void pi_controller_batch_b16(FAR pi_batch_b16_t *pi, FAR const b16_t *err,
+                             FAR b16_t *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -161,6 +162,13 @@
 
 #define creat(path, mode) open(path, O_WRONLY|O_CREAT|O_TRUNC, mode)
 
+/* Flags for splice() and vmsplice() */
+
+#define SPLICE_F_MOVE       0x0001 /* Move pages instead of copying (hint) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data will follow (hint) */
+#define SPLICE_F_GIFT       0x0008 /* Pages are gifted to the pipe (hint) */
+
 #if defined(CONFIG_FS_LARGEFILE)
 #  define F_GETLK64         F_GETLK
 #  define F_SETLK64         F_SETLK
@@ -215,6 +223,11 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nsegs,
+                 unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -35,6 +35,7 @@
 
 /* Special PID to query the info about alloc, free and mempool */
 
+#define PID_MM_PROFILE ((pid_t)-7)
 #define PID_MM_ORPHAN  ((pid_t)-6)
 #define PID_MM_BIGGEST ((pid_t)-5)
 #define PID_MM_FREE    ((pid_t)-4)
@@ -102,6 +103,7 @@ extern "C"
 int mallopt(int param, int value);
 struct mallinfo mallinfo(void);
 size_t malloc_size(FAR void *ptr);
+FAR void *realloc_inplace(FAR void *ptr, size_t size);
 struct mallinfo_task mallinfo_task(FAR const struct malltask *task);
 
 #if defined(__cplusplus)
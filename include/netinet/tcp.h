@@ -58,4 +58,12 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* The congestion control algorithm.  Argument: its name, e.g. "cubic" */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 5)
+
+/* The maximum length of the name of a congestion control algorithm */
+
+#define TCP_CA_NAME_MAX 16
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -80,6 +80,15 @@
 #define NETLINK_CRYPTO                   21      /* Crypto layer */
 #define NETLINK_SMC                      22      /* SMC monitoring */
 
+/* Socket options of level SOL_NETLINK.  The value of the option is the
+ * number of the multicast group (RTNLGRP_*) to join or to leave.
+ */
+
+#define SOL_NETLINK                      270
+
+#define NETLINK_ADD_MEMBERSHIP           1
+#define NETLINK_DROP_MEMBERSHIP          2
+
 /* Definitions associated with struct sockaddr_nl ***************************/
 
 /* Flags values */
@@ -44,6 +44,35 @@
 #define PACKET_LOOPBACK   5
 #define PACKET_FASTROUTE  6
 
+/* Packet socket options (level SOL_PACKET) */
+
+#define PACKET_RX_RING    5   /* Arg: struct tpacket_req */
+#define PACKET_STATISTICS 6   /* Arg: struct tpacket_stats */
+#define PACKET_TX_RING    13  /* Arg: struct tpacket_req */
+
+/* tp_status of the frames of a receive ring */
+
+#define TP_STATUS_KERNEL        0         /* Owned by the kernel */
+#define TP_STATUS_USER          (1 << 0)  /* Holds a frame for the user */
+#define TP_STATUS_LOSING        (1 << 2)  /* Frames were dropped before */
+
+/* tp_status of the frames of a transmit ring */
+
+#define TP_STATUS_AVAILABLE     0         /* Free for the user */
+#define TP_STATUS_SEND_REQUEST  (1 << 0)  /* Holds a frame to send */
+#define TP_STATUS_SENDING       (1 << 1)  /* Being sent */
+#define TP_STATUS_WRONG_FORMAT  (1 << 2)  /* Could not be sent */
+
+/* The frame header is followed by a struct sockaddr_ll, the data of the
+ * frames of a transmit ring starts behind that.
+ */
+
+#define TPACKET_ALIGNMENT       16
+#define TPACKET_ALIGN(x) \
+  (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN \
+  (TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -59,4 +88,35 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* The layout of a ring set with PACKET_RX_RING and PACKET_TX_RING.  The
+ * receive ring is mapped at offset zero and the transmit ring follows it.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Size of a block of frames */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of a frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+/* The header at the start of each frame of a ring */
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;    /* TP_STATUS_* */
+  unsigned int   tp_len;       /* Length of the frame */
+  unsigned int   tp_snaplen;   /* Length of the part kept */
+  unsigned short tp_mac;       /* Offset of the frame in the slot */
+  unsigned short tp_net;       /* Offset of the network header */
+  unsigned int   tp_sec;       /* Time of reception */
+  unsigned int   tp_usec;
+};
+
+struct tpacket_stats
+{
+  unsigned int tp_packets;     /* Frames received */
+  unsigned int tp_drops;       /* Frames dropped for a full ring */
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -34,7 +34,9 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
+#include <nuttx/circbuf.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
@@ -61,6 +63,24 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#if defined(CONFIG_ADC_BLOCK) && !defined(CONFIG_ADC_BLOCK_BUFSIZE)
+#  define CONFIG_ADC_BLOCK_BUFSIZE 4096
+#endif
+
+/* Flags of struct adc_block_s */
+
+#define ADC_BLOCK_CHANNELS     (1 << 0) /* Channel numbers follow the samples */
+
+/* The bytes of a block of count samples, header included.  The blocks
+ * are aligned to 8 bytes in the ring and in the buffers of read().
+ */
+
+#define ADC_BLOCK_ALIGN        8
+#define ADC_BLOCK_SIZE(count, channels) \
+  (((sizeof(struct adc_block_s) + (count) * sizeof(uint32_t) + \
+     ((channels) ? (count) : 0)) + ADC_BLOCK_ALIGN - 1) & \
+   ~(ADC_BLOCK_ALIGN - 1))
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset(dev))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup(dev))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown(dev))
@@ -124,7 +144,53 @@ struct adc_callback_s
    */
 
   CODE int (*au_reset)(FAR struct adc_dev_s *dev);
+
+#ifdef CONFIG_ADC_BLOCK
+  /* This method is called from the lower half, platform-specific ADC logic
+   * on each half and full transfer interrupt of its DMA ring.  In block
+   * mode the samples are queued as one timestamped block, else they are
+   * passed to au_receive_batch.
+   *
+   * Input Parameters:
+   *   dev     - The ADC device structure that was previously registered by
+   *             adc_register()
+   *   channel - Pointer to the channel lists buffer, or NULL
+   *   data    - Pointer to the half of the DMA buffer that is complete.
+   *   count   - Number of data elements in the channel and data buffers.
+   *   ts      - The time of the last sample, CLOCK_MONOTONIC, or NULL
+   *             for the time of the call.
+   *
+   * Returned Value:
+   *   Zero on success; a negated errno value on failure.
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+                               FAR const uint8_t *channel,
+                               FAR const uint32_t *data,
+                               size_t count,
+                               FAR const struct timespec *ts);
+#endif
+};
+
+#ifdef CONFIG_ADC_BLOCK
+/* The header of a block of samples.  In block mode read() returns whole
+ * blocks, each one followed by its ab_count samples (uint32_t) then, with
+ * ADC_BLOCK_CHANNELS, their ab_count channel numbers (uint8_t), padded to
+ * ab_size bytes.
+ */
+
+struct adc_block_s
+{
+  struct timespec ab_time;               /* Time of the last sample */
+  uint32_t        ab_seq;                /* Counts the blocks; a gap means
+                                          * dropped blocks */
+  uint32_t        ab_size;               /* Bytes of the block, header
+                                          * included */
+  uint16_t        ab_count;              /* Number of samples */
+  uint8_t         ab_flags;              /* See ADC_BLOCK_* */
+  uint8_t         ab_reserved;
 };
+#endif
 
 /* This describes on ADC message */
 
@@ -224,6 +290,19 @@ struct adc_dev_s
    */
 
   FAR struct pollfd          *fds[CONFIG_ADC_NPOLLWAITERS];
+
+#ifdef CONFIG_ADC_BLOCK
+  /* The ring of blocks.  The lower half is the only producer; the readers
+   * are serialized by ad_blocklock.  ad_blocksize may be set by the lower
+   * half before adc_register(), like ad_recv.af_fifosize.
+   */
+
+  size_t                      ad_blocksize;  /* Bytes of the ring */
+  struct circbuf_s            ad_blocks;     /* Ring of adc_block_s */
+  mutex_t                     ad_blocklock;  /* Serializes the readers */
+  uint32_t                    ad_blockseq;   /* Sequence of the next block */
+  bool                        ad_blockmode;  /* read() returns blocks */
+#endif
 #endif /* CONFIG_ADC */
 };
 
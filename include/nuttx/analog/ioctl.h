@@ -65,9 +65,23 @@
                                                  * IN: None
                                                  * OUT: Number of samples
                                                  * waiting to be read */
+#define ANIOC_BLOCK_MODE        _ANIOC(0x0007)  /* Select block mode:
+                                                 * read() returns whole
+                                                 * struct adc_block_s
+                                                 * IN: 0 or 1
+                                                 * OUT: None */
+#define ANIOC_BLOCK_ACQUIRE     _ANIOC(0x0008)  /* Get the oldest block
+                                                 * in the mmap()ed ring
+                                                 * IN: Pointer to off_t
+                                                 * OUT: Offset of the
+                                                 * block in the ring */
+#define ANIOC_BLOCK_RELEASE     _ANIOC(0x0009)  /* Free the oldest block
+                                                 * of the ring
+                                                 * IN: None
+                                                 * OUT: None */
 
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          6               /* Number of common commands */
+#define AN_NCMDS          9               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half driver to the lower-half driver via the ioctl()
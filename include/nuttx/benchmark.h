@@ -0,0 +1,156 @@
+/****************************************************************************
+ * include/nuttx/benchmark.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BENCHMARK_H
+#define __INCLUDE_NUTTX_BENCHMARK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A benchmark: take n samples, in perf counts */
+
+typedef CODE int (*bench_run_t)(FAR clock_t *samples, int n);
+
+/* The result of one benchmark.  The times are in nanoseconds. */
+
+struct bench_result_s
+{
+  FAR const char *name;                  /* Name of the benchmark           */
+  uint32_t iterations;                   /* Samples taken, 0 if not run     */
+  uint32_t bytes;                        /* Bytes moved per sample, or 0    */
+  uint64_t min;                          /* Fastest sample                  */
+  uint64_t p50;                          /* Median                          */
+  uint64_t p90;                          /* 90th percentile                 */
+  uint64_t p99;                          /* 99th percentile                 */
+  uint64_t max;                          /* Slowest sample                  */
+  uint64_t mean;                         /* Average                         */
+  uint64_t base;                         /* Baseline median, 0 if none      */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Run the benchmarks from the calling task, which must be allowed to
+ *   block.  Helper threads are created at its priority and, with SMP,
+ *   everything runs on the current CPU.
+ *
+ * Input Parameters:
+ *   name - The benchmark to run, or NULL to run them all
+ *
+ * Returned Value:
+ *   The number of benchmarks run on success; a negated errno value on
+ *   failure.  -ENOENT is returned if no benchmark is named so.
+ *
+ ****************************************************************************/
+
+int bench_run(FAR const char *name);
+
+/****************************************************************************
+ * Name: bench_get
+ *
+ * Description:
+ *   Return the last result of a benchmark.
+ *
+ * Input Parameters:
+ *   index  - The index of the benchmark, from 0
+ *   result - The location to return the result
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if index is past the last benchmark.
+ *
+ ****************************************************************************/
+
+int bench_get(int index, FAR struct bench_result_s *result);
+
+/****************************************************************************
+ * Name: bench_baseline
+ *
+ * Description:
+ *   Keep the medians of the last results as the baseline of the next
+ *   ones.
+ *
+ ****************************************************************************/
+
+void bench_baseline(void);
+
+/****************************************************************************
+ * Name: net_bench_*
+ *
+ * Description:
+ *   The network benchmarks, between a client and a server thread over the
+ *   loopback device:
+ *
+ *   tcp_stream  - Sending CONFIG_NET_BENCHMARK_CHUNK bytes of a bulk
+ *                 transfer
+ *   tcp_rr      - A one byte request and response
+ *   tcp_connect - Connecting, and accepting the connection
+ *   net_lock    - The hold times of the network lock during a bulk
+ *                 transfer
+ *   udp         - Sending a CONFIG_NET_BENCHMARK_UDP_SIZE bytes datagram
+ *                 to the server
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCHMARK
+#  ifdef CONFIG_NET_TCP
+int net_bench_tcp_stream(FAR clock_t *samples, int n);
+int net_bench_tcp_rr(FAR clock_t *samples, int n);
+int net_bench_tcp_connect(FAR clock_t *samples, int n);
+int net_bench_netlock(FAR clock_t *samples, int n);
+#  endif
+#  ifdef CONFIG_NET_UDP
+int net_bench_udp(FAR clock_t *samples, int n);
+#  endif
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCHMARK */
+#endif /* __INCLUDE_NUTTX_BENCHMARK_H */
@@ -286,6 +286,25 @@
  *                   nature of the error.
  *   Dependencies:   None
  *
+ * CANIOC_ADD_RDFILTER
+ *   Description:    Add an acceptance filter to this open file.  Once a
+ *                   filter is installed, only received messages that match
+ *                   at least one of the filters of the file are queued in
+ *                   its receive FIFO.  Error reports are always queued.
+ *   Argument:       A reference to struct canioc_rdfilter_s
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.  ENOSPC means that all
+ *                   CONFIG_CAN_NRDFILTERS filters are in use.
+ *   Dependencies:   CONFIG_CAN_RDFILTER
+ *
+ * CANIOC_CLR_RDFILTERS
+ *   Description:    Remove all acceptance filters of this open file.  All
+ *                   received messages are queued again.
+ *   Argument:       None
+ *   Returned Value: Zero (OK) is returned on success.
+ *   Dependencies:   CONFIG_CAN_RDFILTER
+ *
  * CANIOC_SET_TRANSV_STATE
  *   Description:    Set specific can transceiver state
  *
@@ -326,9 +345,11 @@
 #define CANIOC_GET_STATE          _CANIOC(17)
 #define CANIOC_SET_TRANSVSTATE    _CANIOC(18)
 #define CANIOC_GET_TRANSVSTATE    _CANIOC(19)
+#define CANIOC_ADD_RDFILTER       _CANIOC(20)
+#define CANIOC_CLR_RDFILTERS      _CANIOC(21)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 19             /* 20 common commands   */
+#define CAN_NCMDS                 21             /* 21 common commands   */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the
@@ -799,11 +820,30 @@ struct can_ops_s
  * The common logic will initialize all semaphores.
  */
 
+#ifdef CONFIG_CAN_RDFILTER
+/* CANIOC_ADD_RDFILTER:
+ *
+ * A message matches when (ch_id & rf_mask) == (rf_id & rf_mask) and, if
+ * extended IDs are supported, ch_extid equals rf_extid.
+ */
+
+struct canioc_rdfilter_s
+{
+  uint32_t              rf_id;           /* ID to compare */
+  uint32_t              rf_mask;         /* ID bits that must match */
+  uint8_t               rf_extid;        /* 1=Match extended IDs only */
+};
+#endif
+
 struct can_reader_s
 {
   struct list_node     list;
   struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
   FAR struct pollfd   *cd_fds;
+#ifdef CONFIG_CAN_RDFILTER
+  uint8_t              nfilters;         /* Number of filters in use */
+  struct canioc_rdfilter_s filters[CONFIG_CAN_NRDFILTERS];
+#endif
 };
 
 struct can_transv_s
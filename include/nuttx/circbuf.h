@@ -26,8 +26,9 @@
 /* Note about locking: There is no locking required while only one reader
  * and one writer is using the circular buffer.
  * For multiple writer and one reader there is only a need to lock the
- * writer. And vice versa for only one writer and multiple reader there is
- * only a need to lock the reader.
+ * writer, or the writers use the circbuf_mp_xxx() functions which need no
+ * lock either. And vice versa for only one writer and multiple reader
+ * there is only a need to lock the reader.
  */
 
 /****************************************************************************
@@ -56,6 +57,8 @@ struct circbuf_s
   size_t    head;     /* The head of buffer space */
   size_t    tail;     /* The tail of buffer space */
   bool      external; /* The flag for external buffer */
+  size_t    reserve;  /* Space reserved by circbuf_mp_xxx() writers */
+  size_t    commit;   /* Space committed by circbuf_mp_xxx() writers */
 };
 
 /****************************************************************************
@@ -411,6 +414,63 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize);
 
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize);
 
+/****************************************************************************
+ * Name: circbuf_mp_reserve
+ *
+ * Description:
+ *   Reserve contiguous space for a writer that may run concurrently with
+ *   other circbuf_mp_xxx() writers and one reader, without locking.  Once
+ *   the data is written, circbuf_mp_commit() hands it to the reader.
+ *   Writers of a buffer must either all use the circbuf_mp_xxx() functions
+ *   or none of them.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   size  - The size wanted; returns the size reserved, which is smaller
+ *           if less space is free or the space wraps around.
+ *
+ * Returned Value:
+ *   The address of the reserved space; NULL if the buffer is full.
+ *
+ ****************************************************************************/
+
+FAR void *circbuf_mp_reserve(FAR struct circbuf_s *circ, FAR size_t *size);
+
+/****************************************************************************
+ * Name: circbuf_mp_commit
+ *
+ * Description:
+ *   Commit space reserved with circbuf_mp_reserve() after writing it.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - The size that was reserved.
+ *
+ ****************************************************************************/
+
+void circbuf_mp_commit(FAR struct circbuf_s *circ, size_t bytes);
+
+/****************************************************************************
+ * Name: circbuf_mp_write
+ *
+ * Description:
+ *   Write data to the circular buffer, all of it or nothing, from a writer
+ *   that may run concurrently with other circbuf_mp_xxx() writers and one
+ *   reader, without locking.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   src   - The data to be added.
+ *   bytes - Number of bytes to be added.
+ *
+ * Returned Value:
+ *   bytes if the data was written; zero if it does not fit.
+ *
+ ****************************************************************************/
+
+ssize_t circbuf_mp_write(FAR struct circbuf_s *circ,
+                         FAR const void *src, size_t bytes);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -312,6 +312,21 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The system clock as published to user space with CONFIG_CLOCK_VDSO.  The
+ * sequence number is odd while the kernel is updating the structure, so a
+ * reader must retry until it reads the same even number before and after
+ * copying the times.
+ */
+
+#ifdef CONFIG_CLOCK_VDSO
+struct clock_vdso_s
+{
+  volatile uint32_t seq;           /* Update sequence number */
+  struct timespec   monotonic;     /* CLOCK_MONOTONIC at the last tick */
+  struct timespec   realtime;      /* CLOCK_REALTIME at the last tick */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -762,6 +777,25 @@ int clock_systime_timespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuload_irq
+ *
+ * Description:
+ *   Return the load measurement data of the interrupt handlers of a CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU of interest
+ *   cpuload - The location to return the CPU load
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+int clock_cpuload_irq(int cpu, FAR struct cpuload_s *cpuload);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_oneshot_extclk
  *
@@ -847,6 +881,19 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp);
 
 void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp);
 
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   The clock_gettime() system call used by the user-space clock_gettime()
+ *   for the clocks that are not published in struct clock_vdso_s.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_VDSO
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * include/nuttx/dma/dma_memcpy.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DMA_DMA_MEMCPY_H
+#define __INCLUDE_NUTTX_DMA_DMA_MEMCPY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <sys/types.h>
+
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA_MEMCPY
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ *
+ * Description:
+ *   Select the DMA channel used by dma_memcpy().  The channel is taken
+ *   with DMA_GET_CHAN() for each copy, so it may be shared with other
+ *   clients.
+ *
+ * Input Parameters:
+ *   dev   - The DMA device
+ *   ident - The identifier of a channel able to do memory to memory
+ *           transfers
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_dev_s *dev, unsigned int ident);
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Copy len bytes from src to dst and wait for the copy to complete.
+ *   Copies of at least CONFIG_DMA_MEMCPY_THRESHOLD bytes are done by the
+ *   registered DMA channel, which also cleans and invalidates the data
+ *   cache as needed; shorter ones, copies from interrupt context and
+ *   copies without a registered channel use memcpy().  The buffers must
+ *   not overlap and must be DMA accessible kernel memory.
+ *
+ * Input Parameters:
+ *   dst - The destination buffer
+ *   src - The source buffer
+ *   len - The number of bytes to copy
+ *
+ * Returned Value:
+ *   dst
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len);
+
+#else
+#  define dma_memcpy(dst, src, len) memcpy(dst, src, len)
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_DMA_DMA_MEMCPY_H */
@@ -37,7 +37,7 @@
 
 /* Initializers */
 
-#define NXEVENT_INITIALIZER(e, v) {LIST_INITIAL_VALUE((e).list), (v)}
+#define NXEVENT_INITIALIZER(e, v) {LIST_INITIAL_VALUE((e).list), (v), 0}
 
 /* Event Wait Flags */
 
@@ -62,6 +62,7 @@ struct nxevent_s
 {
   struct list_node         list;    /* Waiting list of nxevent_wait_t */
   volatile nxevent_mask_t  events;  /* Pending Events */
+  nxevent_mask_t           expect;  /* Events expected by the waiters */
 };
 
 #ifdef CONFIG_FS_NAMED_EVENTS
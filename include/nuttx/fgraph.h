@@ -0,0 +1,115 @@
+/****************************************************************************
+ * include/nuttx/fgraph.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FGRAPH_H
+#define __INCLUDE_NUTTX_FGRAPH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_SCHED_FGRAPH
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The entry into, or the exit from, an instrumented function */
+
+struct fgraph_record_s
+{
+  clock_t   time;                        /* perf_gettime() of the event     */
+  clock_t   duration;                    /* Of the call at its exit, else 0 */
+  FAR void *func;                        /* The function                    */
+  pid_t     pid;                         /* The thread that called it       */
+  uint8_t   depth;                       /* Its nesting in the thread       */
+  bool      leave;                       /* An exit, else an entry          */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: fgraph_start / fgraph_stop
+ *
+ * Description:
+ *   Clear the rings and record the calls of the instrumented functions,
+ *   or stop recording.  Until the first start the tracer is not even
+ *   registered with the instrument framework; once stopped, its hooks
+ *   return after testing one flag.
+ *
+ ****************************************************************************/
+
+void fgraph_start(void);
+void fgraph_stop(void);
+
+/****************************************************************************
+ * Name: fgraph_filter
+ *
+ * Description:
+ *   Add a function to the filter set, or clear the set if func is NULL.
+ *   With an empty set all the calls are recorded; else only the calls of
+ *   the functions of the set, and all the calls they make in turn.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the set is full.
+ *
+ ****************************************************************************/
+
+int fgraph_filter(FAR void *func);
+
+/****************************************************************************
+ * Name: fgraph_get
+ *
+ * Description:
+ *   Copy a record of the ring of a CPU, from the oldest one that is still
+ *   there.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if index is past the last record.
+ *
+ ****************************************************************************/
+
+int fgraph_get(int cpu, int index, FAR struct fgraph_record_s *record);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_FGRAPH */
+#endif /* __INCLUDE_NUTTX_FGRAPH_H */
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * include/nuttx/fs/blkcache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKCACHE_H
+#define __INCLUDE_NUTTX_FS_BLKCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_FS_BLKCACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The shared sector cache of one block driver, opaque to the users */
+
+struct inode;
+struct blkcache_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blkcache_open
+ *
+ * Description:
+ *   Attach to the sector cache of a block driver, the cache is created on
+ *   first use and shared by all the users of the same driver.  All the
+ *   caches share the memory budget CONFIG_FS_BLKCACHE_SIZE and one LRU
+ *   list.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *   bc    - The location to return the cache handle
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkcache_open(FAR struct inode *inode, FAR struct blkcache_s **bc);
+
+/****************************************************************************
+ * Name: blkcache_close
+ *
+ * Description:
+ *   Write back the dirty sectors and detach from the cache.
+ *
+ ****************************************************************************/
+
+int blkcache_close(FAR struct blkcache_s *bc);
+
+/****************************************************************************
+ * Name: blkcache_read/blkcache_write
+ *
+ * Description:
+ *   Read or write sectors through the cache.  The reads grow an adaptive
+ *   readahead window while the accesses are sequential.  The writes are
+ *   kept dirty in the cache and written back later by the flusher, adjacent
+ *   sectors are merged into one multi-sector request.
+ *
+ * Returned Value:
+ *   The number of sectors transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct blkcache_s *bc, FAR void *buffer,
+                      blkcnt_t sector, unsigned int nsectors);
+ssize_t blkcache_write(FAR struct blkcache_s *bc, FAR const void *buffer,
+                       blkcnt_t sector, unsigned int nsectors);
+
+/****************************************************************************
+ * Name: blkcache_readahead
+ *
+ * Description:
+ *   Queue the sectors to be read into the cache in the background.  The
+ *   sectors already cached are skipped and a newer request replaces the
+ *   pending one.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkcache_readahead(FAR struct blkcache_s *bc, blkcnt_t sector,
+                       unsigned int nsectors);
+
+/****************************************************************************
+ * Name: blkcache_readdirect/blkcache_writedirect
+ *
+ * Description:
+ *   Transfer the sectors between the driver and the buffer without keeping
+ *   them in the cache (O_DIRECT).  The cached copies of the sectors are
+ *   written back before a direct read and dropped by a direct write.
+ *
+ * Returned Value:
+ *   The number of sectors transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_readdirect(FAR struct blkcache_s *bc, FAR void *buffer,
+                            blkcnt_t sector, unsigned int nsectors);
+ssize_t blkcache_writedirect(FAR struct blkcache_s *bc,
+                             FAR const void *buffer, blkcnt_t sector,
+                             unsigned int nsectors);
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write back all the dirty sectors of the cache now.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct blkcache_s *bc);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_BLKCACHE */
+#endif /* __INCLUDE_NUTTX_FS_BLKCACHE_H */
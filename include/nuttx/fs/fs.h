@@ -104,10 +104,11 @@
 
 /* Stream flags for the fs_flags field of in struct file_struct */
 
-#define __FS_FLAG_EOF   (1 << 0) /* EOF detected by a read operation */
-#define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
-#define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
-#define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_EOF    (1 << 0) /* EOF detected by a read operation */
+#define __FS_FLAG_ERROR  (1 << 1) /* Error detected by any operation */
+#define __FS_FLAG_LBF    (1 << 2) /* Line buffered */
+#define __FS_FLAG_UBF    (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_NOLOCK (1 << 4) /* Caller does the locking (__fsetlocking) */
 
 /* Inode i_flags values:
  *
@@ -275,6 +276,16 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored transfers.  Every remaining segment of the uio is a
+   * whole number of sectors, the driver moves all of them with a single
+   * device request and returns the number of sectors transferred.
+   */
+
+  CODE ssize_t (*readv)(FAR struct inode *inode, FAR struct uio *uio,
+                        blkcnt_t start_sector, unsigned int nsectors);
+  CODE ssize_t (*writev)(FAR struct inode *inode, FAR struct uio *uio,
+                         blkcnt_t start_sector, unsigned int nsectors);
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -481,6 +492,11 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              locked; /* Filelock state: false - unlocked, true - locked */
 #endif
+
+#ifdef CONFIG_FS_READAHEAD
+  off_t             f_ranext;   /* File position if the reads are sequential */
+  size_t            f_rawin;    /* Readahead window in bytes */
+#endif
 };
 
 /* This defines a two layer array of files indexed by the file descriptor.
@@ -1543,6 +1559,19 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1692,6 +1721,19 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Teardown the poll() registrations that a thread kept in its cache and
+ *   free the cache.  Called when the thread exits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_release(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
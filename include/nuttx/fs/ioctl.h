@@ -234,6 +234,17 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_READAHEAD      _FIOC(0x0016) /* IN:  size_t, number of bytes
+                                           *      expected to be read next
+                                           *      from the file position
+                                           * OUT: None
+                                           */
+#define FIOC_SHMWAIT        _FIOC(0x0017) /* IN:  Pointer to shmring_wait_s
+                                           * OUT: None
+                                           */
+#define FIOC_SHMWAKE        _FIOC(0x0018) /* IN:  int, waiters to wake
+                                           * OUT: None
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -512,6 +523,11 @@
                                                * IN: None
                                                * OUT: int */
 
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0007)  /* Move data between the pipe
+                                               * buffer and another file
+                                               * IN: pipe_splice_s
+                                               * OUT: Number of bytes */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -803,6 +819,16 @@ struct pipe_peek_s
   size_t size;
 };
 
+struct file;
+struct pipe_splice_s
+{
+  FAR struct file *file;    /* The other end of the transfer */
+  FAR off_t *offset;        /* Offset in file, NULL to use the file position */
+  size_t len;               /* Maximum number of bytes to move */
+  unsigned int flags;       /* SPLICE_F_* flags */
+  bool topipe;              /* true: file to pipe, false: pipe to file */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -26,6 +26,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Public Type Definitions
@@ -106,4 +107,15 @@ void uio_copyfrom(FAR struct uio *uio, size_t offset, FAR const void *buf,
 void uio_copyto(FAR struct uio *uio, size_t offset, FAR void *buf,
                 size_t len);
 
+/****************************************************************************
+ * Name: uio_aligned
+ *
+ * Description:
+ *   Return true if every remaining segment of uio is a whole multiple of
+ *   align bytes.
+ *
+ ****************************************************************************/
+
+bool uio_aligned(FAR const struct uio *uio, size_t align);
+
 #endif /* __INCLUDE_NUTTX_FS_UIO_H */
@@ -27,6 +27,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <nuttx/lib/math32.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
@@ -99,4 +103,264 @@
 typedef dq_queue_t hash_head_t;
 typedef dq_entry_t hash_node_t;
 
+/* Resizable hash table.
+ *
+ * Unlike DECLARE_HASHTABLE() the bucket array is allocated, doubled when
+ * the table holds more nodes than buckets and halved when it holds fewer
+ * than one per eight buckets, between (1 << minbits) and (1 << maxbits)
+ * buckets.  A resize does not move all the nodes at once: each later
+ * insertion moves two buckets of the old array, so an insertion never
+ * costs more than a few bucket moves.
+ *
+ * The caller hashes the key, with htable_hash32(), htable_hashmem() or any
+ * other 32-bit hash (e.g. SipHash from crypto/siphash.c for keys chosen
+ * by a remote peer), and the node keeps the hash so that the table can
+ * move it without knowing the key.  Lookups compare the stored hash before
+ * the caller compares the key.
+ *
+ * The table has no lock of its own: lookups may run in parallel, updates
+ * need the same lock as the lookups.  Removal never moves other nodes, so
+ * nodes may be removed while iterating over the table.
+ */
+
+typedef struct htable_node_s
+{
+  dq_entry_t entry;              /* Link in the bucket, must be first */
+  uint32_t   hash;               /* Hash of the key */
+} htable_node_t;
+
+struct htable_s
+{
+  FAR hash_head_t *buckets;      /* (1 << bits) buckets, NULL until used */
+  FAR hash_head_t *old;          /* Buckets being moved from, or NULL */
+  size_t           nelems;       /* Number of nodes in the table */
+  uint32_t         moved;        /* Buckets of old already moved */
+  uint8_t          bits;         /* log2 of the number of buckets */
+  uint8_t          oldbits;      /* log2 of the number of old buckets */
+  uint8_t          minbits;      /* Smallest size */
+  uint8_t          maxbits;      /* Largest size */
+};
+
+#define HTABLE_INITIALIZER(minbits, maxbits) \
+  { NULL, NULL, 0, 0, (minbits), 0, (minbits), (maxbits) }
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: htable_hash32
+ *
+ * Description:
+ *   Mix a 32-bit key (the finalizer of MurmurHash3), so that every key bit
+ *   affects every bucket index bit.
+ *
+ ****************************************************************************/
+
+static inline uint32_t htable_hash32(uint32_t key, uint32_t seed)
+{
+  key ^= seed;
+  key ^= key >> 16;
+  key *= 0x85ebca6b;
+  key ^= key >> 13;
+  key *= 0xc2b2ae35;
+  key ^= key >> 16;
+  return key;
+}
+
+/****************************************************************************
+ * Name: htable_bucket
+ *
+ * Description:
+ *   Return the bucket a node with this hash is in, or is to be inserted
+ *   into: in the old array while a resize has not moved its bucket yet.
+ *   NULL if nothing was ever inserted.
+ *
+ ****************************************************************************/
+
+static inline FAR hash_head_t *
+htable_bucket(FAR const struct htable_s *table, uint32_t hash)
+{
+  if (table->old != NULL)
+    {
+      uint32_t i = hash & ((UINT32_C(1) << table->oldbits) - 1);
+
+      if (i >= table->moved)
+        {
+          return &table->old[i];
+        }
+    }
+
+  if (table->buckets == NULL)
+    {
+      return NULL;
+    }
+
+  return &table->buckets[hash & ((UINT32_C(1) << table->bits) - 1)];
+}
+
+/****************************************************************************
+ * Name: htable_first, htable_next
+ *
+ * Description:
+ *   The first node with this hash, and the node with the same hash that
+ *   follows node.  NULL if there is none.
+ *
+ ****************************************************************************/
+
+static inline FAR htable_node_t *htable_next(FAR htable_node_t *node,
+                                             uint32_t hash)
+{
+  while (node != NULL && node->hash != hash)
+    {
+      node = (FAR htable_node_t *)node->entry.flink;
+    }
+
+  return node;
+}
+
+static inline FAR htable_node_t *
+htable_first(FAR const struct htable_s *table, uint32_t hash)
+{
+  FAR hash_head_t *bucket = htable_bucket(table, hash);
+
+  return bucket == NULL ? NULL :
+         htable_next((FAR htable_node_t *)bucket->head, hash);
+}
+
+/****************************************************************************
+ * Name: htable_nbuckets, htable_bucket_at
+ *
+ * Description:
+ *   For iterating over all the nodes: the buckets of both arrays while a
+ *   resize is in progress, those of the old array first.
+ *
+ ****************************************************************************/
+
+static inline uint32_t htable_nbuckets(FAR const struct htable_s *table)
+{
+  return (table->buckets != NULL ? UINT32_C(1) << table->bits : 0) +
+         (table->old != NULL ? UINT32_C(1) << table->oldbits : 0);
+}
+
+static inline FAR htable_node_t *
+htable_bucket_at(FAR const struct htable_s *table, uint32_t i)
+{
+  if (table->old != NULL)
+    {
+      if (i < (UINT32_C(1) << table->oldbits))
+        {
+          return (FAR htable_node_t *)table->old[i].head;
+        }
+
+      i -= UINT32_C(1) << table->oldbits;
+    }
+
+  return (FAR htable_node_t *)table->buckets[i].head;
+}
+
+/* Iterate over the nodes with the given hash */
+
+#define htable_for_every_possible(table, node, hash) \
+  for ((node) = htable_first(table, hash); (node) != NULL; \
+       (node) = htable_next((FAR htable_node_t *)(node)->entry.flink, hash))
+
+#define htable_for_every_possible_safe(table, node, tmp, hash) \
+  for ((node) = htable_first(table, hash); \
+       (node) != NULL && \
+       ((tmp) = htable_next((FAR htable_node_t *)(node)->entry.flink, \
+                            hash), true); \
+       (node) = (tmp))
+
+/* Iterate over all the nodes */
+
+#define htable_for_every(table, node, i) \
+  for ((i) = 0; (i) < htable_nbuckets(table); (i)++) \
+    for ((node) = htable_bucket_at(table, i); (node) != NULL; \
+         (node) = (FAR htable_node_t *)(node)->entry.flink)
+
+#define htable_for_every_safe(table, node, tmp, i) \
+  for ((i) = 0; (i) < htable_nbuckets(table); (i)++) \
+    for ((node) = htable_bucket_at(table, i); \
+         (node) != NULL && \
+         ((tmp) = (FAR htable_node_t *)(node)->entry.flink, true); \
+         (node) = (tmp))
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: htable_init
+ *
+ * Description:
+ *   Initialize an empty table of (1 << minbits) to (1 << maxbits) buckets.
+ *   Nothing is allocated before the first insertion.  Same as
+ *   HTABLE_INITIALIZER().
+ *
+ ****************************************************************************/
+
+void htable_init(FAR struct htable_s *table, unsigned int minbits,
+                 unsigned int maxbits);
+
+/****************************************************************************
+ * Name: htable_deinit
+ *
+ * Description:
+ *   Free the bucket arrays.  The nodes belong to the caller and are not
+ *   touched.
+ *
+ ****************************************************************************/
+
+void htable_deinit(FAR struct htable_s *table);
+
+/****************************************************************************
+ * Name: htable_insert
+ *
+ * Description:
+ *   Insert node with the given hash and move on any resize in progress.
+ *   Must not be called while iterating over the table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the first bucket array could not be
+ *   allocated.  Failing to grow later only makes the chains longer.
+ *
+ ****************************************************************************/
+
+int htable_insert(FAR struct htable_s *table, FAR htable_node_t *node,
+                  uint32_t hash);
+
+/****************************************************************************
+ * Name: htable_remove
+ *
+ * Description:
+ *   Remove node from the table.
+ *
+ ****************************************************************************/
+
+void htable_remove(FAR struct htable_s *table, FAR htable_node_t *node);
+
+/****************************************************************************
+ * Name: htable_hashmem
+ *
+ * Description:
+ *   Hash len octets at key (MurmurHash3, 32-bit).
+ *
+ ****************************************************************************/
+
+uint32_t htable_hashmem(FAR const void *key, size_t len, uint32_t seed);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_HASHTABLE_H */
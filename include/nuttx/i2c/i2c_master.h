@@ -270,6 +270,20 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_BATCH
+/* A batch of I2C operations queued with i2c_batch_*() and performed with a
+ * single transfer by i2c_batch_flush().
+ */
+
+struct i2c_batch_s
+{
+  FAR struct i2c_master_s *dev; /* The I2C bus the batch is performed on */
+  FAR struct i2c_msg_s *msgv;   /* Storage for the queued messages */
+  size_t maxmsgs;               /* Number of messages in msgv */
+  size_t msgc;                  /* Number of queued messages */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +397,40 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_BATCH
+/****************************************************************************
+ * Name: i2c_batch_init, i2c_batch_write, i2c_batch_read,
+ *       i2c_batch_writeread, i2c_batch_flush
+ *
+ * Description:
+ *   Queue several I2C operations, to one or more devices on the same bus,
+ *   and perform them back to back as one transfer separated by repeated
+ *   STARTs.  The queue functions take the same arguments as i2c_write(),
+ *   i2c_read() and i2c_writeread(); the buffers must stay valid until
+ *   i2c_batch_flush() returns.  A full batch, or an operation at another
+ *   frequency, flushes the operations queued so far.
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+void i2c_batch_init(FAR struct i2c_batch_s *batch,
+                    FAR struct i2c_master_s *dev,
+                    FAR struct i2c_msg_s *msgv, size_t maxmsgs);
+int i2c_batch_write(FAR struct i2c_batch_s *batch,
+                    FAR const struct i2c_config_s *config,
+                    FAR const uint8_t *buffer, int buflen);
+int i2c_batch_read(FAR struct i2c_batch_s *batch,
+                   FAR const struct i2c_config_s *config,
+                   FAR uint8_t *buffer, int buflen);
+int i2c_batch_writeread(FAR struct i2c_batch_s *batch,
+                        FAR const struct i2c_config_s *config,
+                        FAR const uint8_t *wbuffer, int wbuflen,
+                        FAR uint8_t *rbuffer, int rbuflen);
+int i2c_batch_flush(FAR struct i2c_batch_s *batch);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -75,6 +75,17 @@ enum nx_initstate_e
   OSINIT_PANIC     = 7   /* Fatal error happened. */
 };
 
+/* One entry of an initcall table run by nx_initcall().  Bit n of deps
+ * names entry n of the same table as a prerequisite.
+ */
+
+struct initcall_s
+{
+  FAR const char *name;        /* Name used in the boot profile and trace */
+  CODE int (*func)(void);      /* Returns zero or a negated errno value */
+  uint32_t deps;               /* Entries that must complete first */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -104,6 +115,28 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+/****************************************************************************
+ * Name: nx_initcall
+ *
+ * Description:
+ *   Run a table of initialization functions, starting each entry once the
+ *   entries it depends on have completed.  Independent entries run in
+ *   parallel on up to CONFIG_INITCALL_NTHREADS threads.  Must be called
+ *   from a thread that can wait, for example from board_late_initialize().
+ *
+ * Input Parameters:
+ *   calls  - The initcall table
+ *   ncalls - The number of entries, at most 32
+ *
+ * Returned Value:
+ *   Zero (OK) if every entry succeeded; otherwise the first negated errno
+ *   value returned by an entry, or -EDEADLK if the dependencies cannot be
+ *   met.
+ *
+ ****************************************************************************/
+
+int nx_initcall(FAR const struct initcall_s *calls, int ncalls);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
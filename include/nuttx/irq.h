@@ -223,6 +223,29 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
                       int priority, int stack_size);
 
+/****************************************************************************
+ * Name: irq_thread_inherit
+ *
+ * Description:
+ *   Raise the priority of the thread attached to IRQ number 'irq' with
+ *   irq_attach_thread() to at least 'priority' until the thread handler
+ *   has run.  This is called before a thread blocks waiting for the
+ *   device, so that the handler thread runs at the priority of its highest
+ *   priority waiter.
+ *
+ * Input Parameters:
+ *   irq      - Irq num
+ *   priority - The priority of the waiting thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+int irq_thread_inherit(int irq, int priority);
+#endif
+
 /****************************************************************************
  * Name: irq_attach_wqueue
  *
@@ -80,6 +80,7 @@ extern "C"
 #define kumm_malloc_size(p)      malloc_size(p)
 #define kumm_zalloc(s)           zalloc(s)
 #define kumm_realloc(p,s)        realloc(p,s)
+#define kumm_realloc_inplace(p,s) realloc_inplace(p,s)
 #define kumm_memalign(a,s)       memalign(a,s)
 #define kumm_free(p)             free(p)
 #define kumm_mallinfo()          mallinfo()
@@ -100,12 +101,25 @@ extern "C"
 #  define kmm_malloc_size(p)     malloc_size(p)
 #  define kmm_zalloc(s)          zalloc(s)
 #  define kmm_realloc(p,s)       realloc(p,s)
+#  define kmm_realloc_inplace(p,s) realloc_inplace(p,s)
 #  define kmm_memalign(a,s)      memalign(a,s)
 #  define kmm_free(p)            free(p)
 #  define kmm_mallinfo()         mallinfo()
 #  define kmm_heapmember(p)      umm_heapmember(p)
 #  define kmm_memdump(p)         umm_memdump(p)
 
+/* The placement hints need the heap itself, so they are only honored in
+ * the flat build.
+ */
+
+#  if defined(CONFIG_MM_REGION_ATTR) && defined(CONFIG_BUILD_FLAT)
+#    define kmm_malloc_attr(s,a) mm_malloc_attr(g_mmheap,s,a)
+#    define kmm_memalign_attr(l,s,a) mm_memalign_attr(g_mmheap,l,s,a)
+#  elif defined(CONFIG_MM_REGION_ATTR)
+#    define kmm_malloc_attr(s,a) malloc(s)
+#    define kmm_memalign_attr(l,s,a) memalign(l,s)
+#  endif
+
 #else
 /* Otherwise, the kernel-space allocators are declared in
  * include/nuttx/mm/mm.h and we can call them directly.
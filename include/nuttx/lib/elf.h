@@ -33,6 +33,7 @@
 #include <elf.h>
 
 #include <nuttx/addrenv.h>
+#include <nuttx/symtab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -169,6 +170,12 @@ struct module_s
   uint16_t nsect;                      /* Number of entries in sectalloc array */
 #endif
   int dynamic;                         /* Module is a dynamic shared object */
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+  FAR void *textcache;                 /* Shared text entry, if any */
+#endif
+#ifdef CONFIG_SYMTAB_HASHED
+  struct symtab_hash_s exphash;        /* Hash index of modinfo.exports */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   size_t textsize;                     /* Size of the kernel .text memory allocation */
   size_t datasize;                     /* Size of the kernel .bss/.data memory allocation */
@@ -213,6 +220,7 @@ struct mod_loadinfo_s
   size_t        textalign;   /* Necessary alignment of .text */
   size_t        dataalign;   /* Necessary alignment of .bss/.text */
   off_t         filelen;     /* Length of the entire module file */
+  time_t        filemtime;   /* Modification time of the module file */
   uid_t         fileuid;     /* Uid of the file system */
   gid_t         filegid;     /* Gid of the file system */
   int           filemode;    /* Mode of the file system */
@@ -361,6 +369,38 @@ int libelf_load_with_addrenv(FAR struct mod_loadinfo_s *loadinfo);
 #  define libelf_load_with_addrenv(l) libelf_load(l)
 #endif
 
+/****************************************************************************
+ * Name: libelf_textcache_attach
+ *
+ * Description:
+ *   Share the read-only part of a position independent ELF program between
+ *   all the instances loaded from the same, unchanged, file.  Must be
+ *   called between libelf_initialize() and libelf_load().
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  *handle is set to the cache entry to release with
+ *   libelf_textcache_detach(), or NULL if nothing is shared.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+int libelf_textcache_attach(FAR struct mod_loadinfo_s *loadinfo,
+                            FAR const char *filename,
+                            FAR void **handle);
+
+/****************************************************************************
+ * Name: libelf_textcache_detach
+ *
+ * Description:
+ *   Release one instance of a shared text.  The cached copy is freed with
+ *   its last instance.
+ *
+ ****************************************************************************/
+
+void libelf_textcache_detach(FAR void *handle);
+#endif
+
 /****************************************************************************
  * Name: libelf_bind
  *
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * include/nuttx/lockstat.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LOCKSTAT_H
+#define __INCLUDE_NUTTX_LOCKSTAT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(CONFIG_SCHED_LOCKSTAT) && CONFIG_SCHED_LOCKSTAT > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Types of the accounted locks */
+
+#define LOCKSTAT_MUTEX      0
+#define LOCKSTAT_SEM        1
+#define LOCKSTAT_SPIN       2
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A code location that waited for the lock */
+
+struct lockstat_caller_s
+{
+  FAR void *caller;                      /* Return address of the waiter    */
+  uint32_t  count;                       /* Number of waits                 */
+};
+
+/* The contention of one lock.  The times are in perf counts. */
+
+struct lockstat_s
+{
+  FAR void *lock;                        /* Address of the lock             */
+  uint8_t   type;                        /* See LOCKSTAT_* definitions      */
+  uint32_t  count;                       /* Contended acquisitions          */
+  clock_t   wait;                        /* Total wait time                 */
+  clock_t   waitmax;                     /* Maximum wait time               */
+  uint32_t  nhold;                       /* Measured holds                  */
+  clock_t   hold;                        /* Total hold time                 */
+  clock_t   holdmax;                     /* Maximum hold time               */
+  clock_t   acquired;                    /* Time of the last contended
+                                          * acquisition, 0 if released      */
+  struct lockstat_caller_s callers[CONFIG_SCHED_LOCKSTAT_CALLERS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lockstat_wait
+ *
+ * Description:
+ *   Account a contended acquisition of a lock, once the waiter got it.
+ *   If hold is true, the time of the acquisition is kept to measure the
+ *   hold time at the next lockstat_release(); the caller must be sure
+ *   that this release will be seen, or the time would be stale.
+ *
+ * Input Parameters:
+ *   lock   - The address of the lock
+ *   type   - LOCKSTAT_MUTEX, LOCKSTAT_SEM or LOCKSTAT_SPIN
+ *   caller - The code location that waited
+ *   start  - perf_gettime() when the wait started
+ *   hold   - Measure the hold time
+ *
+ ****************************************************************************/
+
+void lockstat_wait(FAR void *lock, uint8_t type, FAR void *caller,
+                   clock_t start, bool hold);
+
+/****************************************************************************
+ * Name: lockstat_release
+ *
+ * Description:
+ *   Account the hold time of a lock that was acquired after a wait.  Locks
+ *   that were not are left alone.
+ *
+ ****************************************************************************/
+
+void lockstat_release(FAR void *lock);
+
+/****************************************************************************
+ * Name: lockstat_get
+ *
+ * Description:
+ *   Copy an entry of the table.  Returns false if the index is past the
+ *   table; an unused entry has a NULL lock.
+ *
+ ****************************************************************************/
+
+bool lockstat_get(int index, FAR struct lockstat_s *stat);
+
+/****************************************************************************
+ * Name: lockstat_reset
+ *
+ * Description:
+ *   Forget all the locks.
+ *
+ ****************************************************************************/
+
+void lockstat_reset(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_LOCKSTAT > 0 */
+#endif /* __INCLUDE_NUTTX_LOCKSTAT_H */
@@ -0,0 +1,157 @@
+//***************************************************************************
+// include/nuttx/memory_resource.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_MEMORY_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+struct mempool_multiple_s;
+
+namespace nuttx::pmr
+{
+  //*************************************************************************
+  // arena_resource
+  //
+  // A monotonic resource: allocation bumps a pointer through the current
+  // chunk, deallocation does nothing and release() drops everything at
+  // once.  Unlike std::pmr::monotonic_buffer_resource, release() keeps the
+  // largest chunk for the next round, so an arena reused per request
+  // settles at one chunk and then neither allocates nor frees upstream:
+  // release() is O(1).  Not thread safe, like the standard one.
+  //*************************************************************************
+
+  class arena_resource : public std::pmr::memory_resource
+  {
+  public:
+    explicit arena_resource(std::size_t chunksize =
+                              CONFIG_LIBXX_PMR_ARENA_CHUNKSIZE,
+                            std::pmr::memory_resource *upstream =
+                              std::pmr::get_default_resource()) noexcept;
+
+    // Start with a caller supplied buffer, e.g. on the stack; chunks from
+    // upstream are only added once it is used up.
+
+    arena_resource(void *buffer, std::size_t size,
+                   std::pmr::memory_resource *upstream =
+                     std::pmr::get_default_resource()) noexcept;
+
+    arena_resource(const arena_resource &) = delete;
+    arena_resource &operator=(const arena_resource &) = delete;
+
+    ~arena_resource() override;
+
+    // Make all the memory available again.  Every chunk but the largest
+    // goes back upstream.
+
+    void release() noexcept;
+
+    // Return every chunk upstream.
+
+    void shrink() noexcept;
+
+    std::pmr::memory_resource *upstream_resource() const noexcept
+    {
+      return m_upstream;
+    }
+
+  protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+  private:
+    struct chunk_s
+    {
+      chunk_s    *next;               // Older chunk
+      std::size_t size;               // Size including this header
+    };
+
+    std::pmr::memory_resource *m_upstream;
+    chunk_s    *m_chunks;             // Chunks from upstream, newest first
+    char       *m_cur;                // Next free byte
+    char       *m_end;                // End of the current chunk or buffer
+    void       *m_buffer;             // Initial buffer, or NULL
+    std::size_t m_bufsize;            // Size of the initial buffer
+    std::size_t m_nextsize;           // Size of the next chunk
+  };
+
+  //*************************************************************************
+  // pool_resource
+  //
+  // Blocks up to the largest of the given sizes come from a private
+  // multiple mempool (mm/mempool), which takes only a per size spinlock
+  // and, with CONFIG_MM_HEAP_MEMPOOL_CACHE, a per CPU cache instead of
+  // the heap lock; the pools grow from the heap expandsize bytes at a time.
+  // Larger blocks, or all of them if the pool cannot be created, go to the
+  // upstream resource.  Thread safe.
+  //*************************************************************************
+
+  class pool_resource : public std::pmr::memory_resource
+  {
+  public:
+    pool_resource(const std::size_t *blocksizes, std::size_t npools,
+                  std::size_t expandsize = CONFIG_LIBXX_PMR_POOL_EXPANDSIZE,
+                  std::pmr::memory_resource *upstream =
+                    std::pmr::get_default_resource()) noexcept;
+
+    pool_resource(const pool_resource &) = delete;
+    pool_resource &operator=(const pool_resource &) = delete;
+
+    ~pool_resource() override;
+
+    std::pmr::memory_resource *upstream_resource() const noexcept
+    {
+      return m_upstream;
+    }
+
+  protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+  private:
+    std::pmr::memory_resource *m_upstream;
+    struct mempool_multiple_s *m_pool;
+    std::size_t m_maxsize;            // Largest block size of the pools
+  };
+}
+
+#endif // CONFIG_LIBXX_PMR
+#endif // __INCLUDE_NUTTX_MEMORY_RESOURCE_HXX
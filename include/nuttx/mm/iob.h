@@ -81,7 +81,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -103,8 +103,8 @@
 typedef CODE void (*iob_free_cb_t)(FAR void *data);
 
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
- * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
- * the head of the chain.
+ * buffers in a chain.  The io_pktlen and the io_flags are only valid for the
+ * I/O buffer at the head of the chain.
  */
 
 struct iob_s
@@ -124,6 +124,9 @@ struct iob_s
 #  ifdef CONFIG_IOB_ALLOC
   uint16_t io_bufsize;  /* Total length of the data buffer */
 #  endif
+#endif
+#ifdef CONFIG_IOB_FLAGS
+  uint8_t  io_flags;    /* Flags of the packet, defined by the user */
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
@@ -221,6 +224,33 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer for size bytes of data from the best
+ *   fitting size class without waiting:  A small buffer of
+ *   CONFIG_IOB_BUFSIZE, a large buffer of CONFIG_IOB_LARGE_BUFSIZE or a
+ *   jumbo buffer from the heap.  A small buffer is returned if there is no
+ *   buffer of that class, so the buffer may still have to be chained.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size);
+
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate up to count I/O buffers at once without waiting for
+ *   buffers to become free.  The buffers are returned as a chain of empty
+ *   buffers linked through io_flink, which may be shorter than requested,
+ *   or NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(unsigned int count, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -347,7 +377,8 @@ void iob_notifier_teardown(int key);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The buffers are returned to the free list in one
+ *   operation.
  *
  ****************************************************************************/
 
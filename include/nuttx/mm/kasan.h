@@ -46,6 +46,8 @@
 #  define kasan_stop()
 #  define kasan_debugpoint(t,a,s) 0
 #  define kasan_init_early()
+#  define kasan_check(addr, size, is_write)
+#  define kasan_region_enable(addr, enable) 0
 #else
 
 #  define kasan_init_early() kasan_stop()
@@ -201,6 +203,47 @@ void kasan_stop(void);
 
 int kasan_debugpoint(int type, FAR void *addr, size_t size);
 
+/****************************************************************************
+ * Name: kasan_check
+ *
+ * Description:
+ *   Check a whole range at once, e.g. before a bulk copy by code that is not
+ *   instrumented itself.  One call checks the shadow a word at a time
+ *   instead of once for every access.
+ *
+ * Input Parameters:
+ *   addr     - range start address
+ *   size     - range size
+ *   is_write - whether the range is written or only read
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void kasan_check(FAR const void *addr, size_t size, bool is_write);
+
+/****************************************************************************
+ * Name: kasan_region_enable
+ *
+ * Description:
+ *   Enable or disable the checks of the accesses to a region registered by
+ *   kasan_register(), e.g. to leave out a large buffer pool.  The shadow of
+ *   a disabled region is still kept up to date.  With
+ *   CONFIG_MM_KASAN_REGION_ALLOWLIST the regions start disabled and only
+ *   the ones that are enabled are checked.
+ *
+ * Input Parameters:
+ *   addr   - any address of the region
+ *   enable - whether to check the region
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if addr is not in a registered region.
+ *
+ ****************************************************************************/
+
+int kasan_region_enable(FAR const void *addr, bool enable);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * include/nuttx/mm/kmem_cache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+#define __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_MM_KMEM_CACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Constructor of the objects of a cache.  It is called once for every
+ * object when the cache grows, not on every allocation:  An object must be
+ * returned to the cache in its constructed state.
+ */
+
+typedef CODE void (*kmem_ctor_t)(FAR void *obj);
+
+struct kmem_cache_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of the same size.  The objects are kept in a
+ *   memory pool that grows from the kernel heap by
+ *   CONFIG_MM_KMEM_CACHE_BATCH objects at a time and is listed in
+ *   /proc/mempool under the name of the cache.
+ *
+ * Input Parameters:
+ *   name - The name of the cache
+ *   size - The size of the objects
+ *   ctor - The constructor of the objects, or NULL
+ *
+ * Returned Value:
+ *   The cache on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, kmem_ctor_t ctor);
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache.  All objects must have been freed.
+ *
+ * Input Parameters:
+ *   cache - The cache to destroy
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if some objects are still used.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate a constructed object from a cache.
+ *
+ * Input Parameters:
+ *   cache - The cache to allocate from
+ *
+ * Returned Value:
+ *   The object on success; NULL if the memory is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate a zeroed object from a cache that has no constructor.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object to the cache it was allocated from.
+ *
+ * Input Parameters:
+ *   cache - The cache of the object
+ *   obj   - The object to free
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_MM_KMEM_CACHE */
+#endif /* __INCLUDE_NUTTX_MM_KMEM_CACHE_H */
@@ -28,6 +28,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdbool.h>
+
 #include <nuttx/queue.h>
 #include <nuttx/mutex.h>
 #include <nuttx/mm/gran.h>
@@ -72,6 +75,13 @@ struct mm_map_entry_s
                 FAR struct mm_map_entry_s *entry,
                 FAR void *start,
                 size_t length);
+
+  /* Demand paged mappings populate the page containing vaddr on the first
+   * access, see mm_map_fault().
+   */
+
+  int (*fault)(FAR struct mm_map_entry_s *entry, FAR void *vaddr,
+               bool write);
 };
 
 /* memory mapping structure for the task group */
@@ -301,6 +311,27 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
                                        FAR const void *vaddr,
                                        size_t length);
 
+/****************************************************************************
+ * Name: mm_map_fault
+ *
+ * Description:
+ *   Resolve a translation fault at vaddr in the task group's address space
+ *   through the fault method of the mapping containing it.  Called by the
+ *   architecture page fault handler from a context that may block.
+ *
+ * Input Parameters:
+ *   mm    - A reference to the faulting task group's mm_map struct
+ *   vaddr - The faulting address
+ *   write - True if the access was a write
+ *
+ * Returned Value:
+ *   OK if the page is now mapped and the access can be restarted; a negated
+ *   errno value if the fault is a real access violation.
+ *
+ ****************************************************************************/
+
+int mm_map_fault(FAR struct mm_map_s *mm, FAR void *vaddr, bool write);
+
 /****************************************************************************
  * Name: mm_map_remove
  *
@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/list.h>
 #include <nuttx/queue.h>
 #include <nuttx/mm/mm.h>
@@ -107,7 +108,20 @@ struct mempool_s
   sq_queue_t queue;   /* The free block queue in normal mempool */
   sq_queue_t iqueue;  /* The free block queue in interrupt mempool */
   sq_queue_t equeue;  /* The expand block queue for normal mempool */
+  size_t     nblocks; /* The number of blocks in mempool */
+  size_t     hwater;  /* The most blocks that were used at once */
+  size_t     lwater;  /* The fewest blocks that were left free */
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  atomic64_t lfhead;  /* The tagged head of the lock-free queue */
+  atomic64_t lfihead; /* The tagged head of the lock-free iqueue */
+  atomic_t   nalloc;  /* The number of used block in mempool */
+
+  /* One free block cached by each CPU */
+
+  atomic_t   lfcache[CONFIG_SMP_NCPUS];
+#else
   size_t     nalloc;  /* The number of used block in mempool */
+#endif
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
@@ -137,6 +151,8 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+  unsigned long hwater;   /* This is the most blocks used at once */
+  unsigned long lwater;   /* This is the fewest free blocks left */
 };
 
 /****************************************************************************
@@ -203,6 +219,28 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool);
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk);
 
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Give the memory of an expansion of the pool back if none of its blocks
+ *   is used.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *   base - The address returned by the alloc function of the pool for the
+ *          expansion.
+ *
+ * Returned Value:
+ *   OK on success; A negated errno value on any failure:
+ *
+ *   EINVAL The memory is not an expansion of the pool.
+ *   EBUSY  Some blocks of the expansion are used.
+ *   ENOSYS The pool cannot shrink in the lock-free mode.
+ ****************************************************************************/
+
+int mempool_shrink(FAR struct mempool_s *pool, FAR void *base);
+
 /****************************************************************************
  * Name: mempool_info
  *
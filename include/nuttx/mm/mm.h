@@ -166,12 +166,39 @@
 #define MM_ALLOC_MAGIC   0xaa
 #define MM_FREE_MAGIC    0x55
 
+/* The attributes of a heap region, see mm_region_setattr().  They are
+ * also the placement hints of mm_malloc_attr(), where MM_REGION_CPULOCAL
+ * asks for a region that is local to the CPU that allocates and
+ * MM_REGION_STRICT fails the allocation instead of falling back to the
+ * other regions.
+ */
+
+#define MM_REGION_FAST       (1 << 0) /* Fast memory, e.g. SRAM or TCM */
+#define MM_REGION_DMA        (1 << 1) /* Reachable by DMA */
+#define MM_REGION_CACHEABLE  (1 << 2) /* Cached by the CPUs */
+#define MM_REGION_CPULOCAL   (1 << 3) /* Local to the CPU of MM_REGION_CPU */
+#define MM_REGION_ATTRMASK   0x00ffffff
+#define MM_REGION_CPU(cpu)   (MM_REGION_CPULOCAL | ((uint32_t)(cpu) << 24))
+#define MM_REGION_CPUOF(a)   (((a) >> 24) & 0x7f)
+#define MM_REGION_STRICT     (UINT32_C(1) << 31)
+
+/* The number of the power of two size classes of struct mm_fraginfo_s */
+
+#define MM_FRAG_NCLASSES 32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct mm_heap_s; /* Forward reference */
 
+/* The callback of mm_heapfree_foreach:  The part of a free chunk that
+ * holds no heap metadata.
+ */
+
+typedef CODE void (*mm_heapfree_handler_t)(FAR void *start, size_t size,
+                                           FAR void *arg);
+
 struct mempool_init_s
 {
   FAR const size_t *poolsize;
@@ -182,6 +209,34 @@ struct mempool_init_s
   size_t            dict_expendsize;
 };
 
+#ifdef CONFIG_MM_REGION_ATTR
+/* The usage of one region of a heap */
+
+struct mm_regioninfo_s
+{
+  FAR void *start;    /* The start of the region */
+  size_t    size;     /* The size of the region */
+  size_t    fordblks; /* Total size of the free chunks of the region */
+  uint32_t  attr;     /* The attributes of the region */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+/* The fragmentation of a heap.  The free chunks and the failed allocations
+ * are counted by the size class:  Class n holds the sizes from 2^n to
+ * 2^(n+1) - 1 bytes, the largest class of the heap all the bigger ones.
+ */
+
+struct mm_fraginfo_s
+{
+  size_t nfree[MM_FRAG_NCLASSES]; /* The free chunks of each class */
+  size_t nfail[MM_FRAG_NCLASSES]; /* The failed allocations of each class */
+  size_t fordblks;                /* Total size of the free chunks */
+  size_t mxordblk;                /* Size of the largest free chunk */
+  int    fragindex;               /* 1000 * (1 - mxordblk / fordblks) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -281,6 +336,10 @@ void kmm_addregion(FAR void *heapstart, size_t heapsize);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size) malloc_like1(2);
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_malloc_attr(FAR struct mm_heap_s *heap, size_t size,
+                         uint32_t attr) malloc_like1(2);
+#endif
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
@@ -288,6 +347,9 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_malloc(size_t size) malloc_like1(1);
+#  ifdef CONFIG_MM_REGION_ATTR
+FAR void *kmm_malloc_attr(size_t size, uint32_t attr) malloc_like1(1);
+#  endif
 #endif
 
 /* Functions contained in mm_malloc_size.c **********************************/
@@ -314,11 +376,14 @@ void kmm_free(FAR void *mem);
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                      size_t size) realloc_like(3);
+FAR void *mm_realloc_inplace(FAR struct mm_heap_s *heap, FAR void *mem,
+                             size_t size);
 
 /* Functions contained in kmm_realloc.c *************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize) realloc_like(2);
+FAR void *kmm_realloc_inplace(FAR void *mem, size_t newsize);
 #endif
 
 /* Functions contained in mm_calloc.c ***************************************/
@@ -352,11 +417,19 @@ void kmm_memdump(FAR const struct mm_memdump_s *dump);
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size) malloc_like1(3);
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_memalign_attr(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, uint32_t attr) malloc_like1(3);
+#endif
 
 /* Functions contained in kmm_memalign.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_memalign(size_t alignment, size_t size) malloc_like1(2);
+#  ifdef CONFIG_MM_REGION_ATTR
+FAR void *kmm_memalign_attr(size_t alignment, size_t size, uint32_t attr)
+  malloc_like1(2);
+#  endif
 #endif
 
 /* Functions contained in mm_heapmember.c ***********************************/
@@ -410,6 +483,22 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
+void mm_heapfree_foreach(FAR struct mm_heap_s *heap,
+                         mm_heapfree_handler_t handler, FAR void *arg);
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+int mm_fraginfo(FAR struct mm_heap_s *heap,
+                FAR struct mm_fraginfo_s *info);
+#endif
+
+/* Functions contained in mm_region.c ***************************************/
+
+#ifdef CONFIG_MM_REGION_ATTR
+int mm_region_setattr(FAR struct mm_heap_s *heap, int region,
+                      uint32_t attr);
+int mm_region_info(FAR struct mm_heap_s *heap, int region,
+                   FAR struct mm_regioninfo_s *info);
+#endif
 
 /* Functions contained in kmm_mallinfo.c ************************************/
 
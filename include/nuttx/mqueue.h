@@ -91,6 +91,12 @@
 #  define nxmq_pollnotify(msgq, eventset)
 #endif
 
+#ifdef CONFIG_MQ_ZEROCOPY
+#  define MQ_ISFULL(msgq)             list_is_empty(&(msgq)->msgpool)
+#else
+#  define MQ_ISFULL(msgq)             ((msgq)->nmsgs >= (msgq)->maxmsgs)
+#endif
+
 #  define MQ_WNELIST(cmn)             (&((cmn).waitfornotempty))
 #  define MQ_WNFLIST(cmn)             (&((cmn).waitfornotfull))
 
@@ -115,6 +121,9 @@ struct mqueue_inode_s
   struct mqueue_cmn_s cmn;    /* Common prologue */
   FAR struct inode *inode;    /* Containing inode */
   struct list_node msglist;   /* Prioritized message list */
+#ifdef CONFIG_MQ_ZEROCOPY
+  struct list_node msgpool;   /* Free messages owned by the queue */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
 #if CONFIG_MQ_MAXMSGSIZE < 256
@@ -793,6 +802,73 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Name: file_mq_reserve, file_mq_commit, nxmq_reserve and nxmq_commit
+ *
+ * Description:
+ *   Take a free message buffer from the pool of a message queue and queue
+ *   the message built in it, without copying.  A reserved buffer that is
+ *   not committed must be given back with file_mq_release().
+ *
+ *   These are internal OS interfaces.  They follow the NuttX internal error
+ *   return policy (see mq_timedsend() for the list of valid return values).
+ *
+ ****************************************************************************/
+
+int file_mq_reserve(FAR struct file *mq, FAR void **buf,
+                    FAR const struct timespec *abstime);
+int file_mq_commit(FAR struct file *mq, FAR void *buf, size_t msglen,
+                   unsigned int prio);
+int nxmq_reserve(mqd_t mqdes, FAR void **buf,
+                 FAR const struct timespec *abstime);
+int nxmq_commit(mqd_t mqdes, FAR void *buf, size_t msglen,
+                unsigned int prio);
+
+/****************************************************************************
+ * Name: file_mq_borrow, file_mq_release, nxmq_borrow and nxmq_release
+ *
+ * Description:
+ *   Remove a message from a message queue and return its buffer instead of
+ *   copying it, then give the buffer back to the pool of the queue.  All
+ *   buffers must be released before the message queue is closed.
+ *
+ *   These are internal OS interfaces.  They follow the NuttX internal error
+ *   return policy (see mq_timedreceive() for the list of valid return
+ *   values).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_borrow(FAR struct file *mq, FAR void **buf,
+                       FAR unsigned int *prio,
+                       FAR const struct timespec *abstime);
+int file_mq_release(FAR struct file *mq, FAR void *buf);
+ssize_t nxmq_borrow(mqd_t mqdes, FAR void **buf, FAR unsigned int *prio,
+                    FAR const struct timespec *abstime);
+int nxmq_release(mqd_t mqdes, FAR void *buf);
+
+#ifndef CONFIG_DISABLE_MQUEUE_SYSV
+
+/****************************************************************************
+ * Name: nxmsg_reserve, nxmsg_commit, nxmsg_borrow and nxmsg_release
+ *
+ * Description:
+ *   The same for System V message queues:  nxmsg_reserve()/nxmsg_commit()
+ *   replace msgsnd() and nxmsg_borrow()/nxmsg_release() replace msgrcv().
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int nxmsg_reserve(int msqid, FAR void **buf, int msgflg);
+int nxmsg_commit(int msqid, FAR void *buf, size_t msgsz, long mtype);
+ssize_t nxmsg_borrow(int msqid, FAR void **buf, FAR long *mtype,
+                     long msgtyp, int msgflg);
+int nxmsg_release(int msqid, FAR void *buf);
+
+#endif /* !CONFIG_DISABLE_MQUEUE_SYSV */
+#endif /* CONFIG_MQ_ZEROCOPY */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
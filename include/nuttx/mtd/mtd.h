@@ -289,6 +289,30 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 #endif
 
+/****************************************************************************
+ * Name: mtd_rcache_initialize
+ *
+ * Description:
+ *   Create an MTD device instance which contains another MTD driver and
+ *   caches its reads in CONFIG_MTD_RCACHE_NLINES lines of
+ *   CONFIG_MTD_RCACHE_LINESIZE bytes, replaced least recently used first.
+ *   Writes and erases go to the contained driver and invalidate the lines
+ *   they overlap.  If the contained driver supports BIOC_XIPBASE, reads
+ *   are copied from its memory mapped window instead.
+ *
+ * Input Parameters:
+ *   mtd - The MTD device to be cached
+ *
+ * Returned Value:
+ *   On success, the caching MTD device is returned.  A NULL value is
+ *   returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_RCACHE
+FAR struct mtd_dev_s *mtd_rcache_initialize(FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
  * Name: ftl_initialize_by_path
  *
@@ -32,10 +32,21 @@
 
 #include <nuttx/semaphore.h>
 
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+#  include <nuttx/atomic.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Spinning needs to look at the running TCBs, which only the kernel can */
+
+#if defined(CONFIG_LIBC_MUTEX_ADAPTIVE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define NXMUTEX_ADAPTIVE_SPIN 1
+#endif
+
 #define NXMUTEX_INITIALIZER                                             \
   {NXSEM_INITIALIZER(NXSEM_NO_MHOLDER, SEM_TYPE_MUTEX | SEM_PRIO_INHERIT)}
 
@@ -51,6 +62,10 @@ struct mutex_s
 #if CONFIG_LIBC_MUTEX_BACKTRACE > 0
   FAR void *backtrace[CONFIG_LIBC_MUTEX_BACKTRACE];
 #endif
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+  atomic_t spins;   /* Number of acquisitions that succeeded by spinning */
+  atomic_t blocks;  /* Number of waits that fell back to blocking */
+#endif
 };
 
 typedef struct mutex_s mutex_t;
@@ -96,6 +111,48 @@ void nxmutex_add_backtrace(FAR mutex_t *mutex);
 #  define nxmutex_add_backtrace(mutex)
 #endif
 
+/****************************************************************************
+ * Name: nxmutex_spin
+ *
+ * Description:
+ *   Try to take the mutex by busy-waiting for as long as its holder is
+ *   running on another CPU, up to CONFIG_LIBC_MUTEX_SPIN_COUNT polls.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   True if the mutex was acquired; false if the caller has to block.
+ *
+ ****************************************************************************/
+
+#ifdef NXMUTEX_ADAPTIVE_SPIN
+bool nxmutex_spin(FAR mutex_t *mutex);
+#else
+#  define nxmutex_spin(mutex) false
+#endif
+
+/****************************************************************************
+ * Name: nxmutex_get_stats
+ *
+ * Description:
+ *   This function returns the adaptive spinning counters of the mutex.
+ *
+ * Parameters:
+ *   mutex  - mutex descriptor.
+ *   spins  - Location to return the number of acquisitions that succeeded
+ *            while spinning.
+ *   blocks - Location to return the number of waits that had to block.
+ *
+ * Return Value:
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+void nxmutex_get_stats(FAR mutex_t *mutex, FAR uint32_t *spins,
+                       FAR uint32_t *blocks);
+#endif
+
 /****************************************************************************
  * Name: nxmutex_init
  *
@@ -503,9 +560,13 @@ static inline_function int nxmutex_destroy(FAR mutex_t *mutex)
 
 static inline_function int nxmutex_lock(FAR mutex_t *mutex)
 {
-  int ret;
+  int ret = OK;
+
+  if (!nxmutex_spin(mutex))
+    {
+      ret = nxsem_wait(&mutex->sem);
+    }
 
-  ret = nxsem_wait(&mutex->sem);
   if (ret >= 0)
     {
       nxmutex_add_backtrace(mutex);
@@ -878,6 +939,30 @@ static inline_function void nxrmutex_reset(FAR rmutex_t *rmutex)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxrmutex_get_stats
+ *
+ * Description:
+ *   This function returns the adaptive spinning counters of the recursive
+ *   mutex.
+ *
+ * Parameters:
+ *   rmutex - Recursive mutex descriptor.
+ *   spins  - Location to return the number of acquisitions that succeeded
+ *            while spinning.
+ *   blocks - Location to return the number of waits that had to block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+static inline_function void nxrmutex_get_stats(FAR rmutex_t *rmutex,
+                                               FAR uint32_t *spins,
+                                               FAR uint32_t *blocks)
+{
+  nxmutex_get_stats(&rmutex->mutex, spins, blocks);
+}
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
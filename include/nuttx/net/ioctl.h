@@ -110,6 +110,8 @@
 #define TUNSETIFF        _SIOC(0x0028)  /* Set TUN/TAP interface */
 #define TUNGETIFF        _SIOC(0x0035)  /* Get TUN/TAP interface */
 #define TUNSETCARRIER    _SIOC(0x0040)  /* Set TUN/TAP carrier state */
+#define TUNREADBATCH     _SIOC(0x0043)  /* Read several TUN/TAP packets */
+#define TUNWRITEBATCH    _SIOC(0x0044)  /* Write several TUN/TAP packets */
 
 /* Telnet driver ************************************************************/
 
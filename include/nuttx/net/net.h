@@ -51,6 +51,22 @@
 #define SOCKCAP_NONBLOCKING (1 << 0)  /* Bit 0: Socket supports non-blocking
                                        *        operation. */
 
+/* Per-connection locking.  The lock of a connection serializes the copies
+ * of the socket data between the user buffers and the connection buffers,
+ * which are done without the network lock.  The locks must be taken in
+ * the order conn_lock(), net_lock() and netdev_lock().
+ */
+
+#ifdef CONFIG_NET_FINE_LOCK
+#  define conn_lock_init(s)  nxrmutex_init(&(s)->s_lock)
+#  define conn_lock(s)       nxrmutex_lock(&(s)->s_lock)
+#  define conn_unlock(s)     nxrmutex_unlock(&(s)->s_lock)
+#else
+#  define conn_lock_init(s)
+#  define conn_lock(s)
+#  define conn_unlock(s)
+#endif
+
 /* Definitions of 8-bit socket flags */
 
 #define _SF_INITD           0x01  /* Bit 0: Socket structure is initialized */
@@ -137,10 +153,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;            /* Forward reference */
+struct stat;            /* Forward reference */
+struct socket;          /* Forward reference */
+struct pollfd;          /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +198,14 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -234,6 +259,10 @@ struct socket_conn_s
   uint8_t       s_ttl;       /* Default time-to-live */
 #endif
 
+#ifdef CONFIG_NET_FINE_LOCK
+  rmutex_t      s_lock;      /* Serializes the data copies of the socket */
+#endif
+
   /* Connection-specific content may follow */
 };
 
@@ -380,6 +409,21 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: net_lock_sample
+ *
+ * Description:
+ *   Record the hold times of the network lock, in perf counts, until n
+ *   of them are recorded.  A NULL samples stops the recording.
+ *   net_lock_nsamples() returns the number recorded so far.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCHMARK
+void net_lock_sample(FAR clock_t *samples, int n);
+int net_lock_nsamples(void);
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -928,6 +972,69 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent; the msg_len of each
+ *   of them is set to the number of characters sent.  If no message could
+ *   be sent, a negated errno value is returned (see comments with
+ *   sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  This is
+ *   an internal OS interface.  It is functionally equivalent to
+ *   recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of buffers
+ *   flags     Receive flags
+ *   timeout   The time after which no further message is waited for, or
+ *             NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len of
+ *   each of them is set to the number of characters received.  If no
+ *   message could be received, a negated errno value is returned (see
+ *   comments with recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1344,6 +1451,25 @@ int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
 int psock_dup2(FAR struct socket *psock1, FAR struct socket *psock2);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping to set up.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.  -ENODEV is returned if the socket cannot be mapped.
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_fstat
  *
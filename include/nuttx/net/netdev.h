@@ -79,6 +79,22 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Per-device locking.  The lock of a device serializes the calls into its
+ * driver, so that the frames can be taken from one device without the
+ * network lock while the network processes the frames of another.  It is
+ * taken after the network lock if both are held (see conn_lock()).
+ */
+
+#ifdef CONFIG_NET_FINE_LOCK
+#  define netdev_lock_init(d) nxrmutex_init(&(d)->d_lock)
+#  define netdev_lock(d)      nxrmutex_lock(&(d)->d_lock)
+#  define netdev_unlock(d)    nxrmutex_unlock(&(d)->d_lock)
+#else
+#  define netdev_lock_init(d)
+#  define netdev_lock(d)
+#  define netdev_unlock(d)
+#endif
+
 /* Determine the largest possible address */
 
 #if defined(CONFIG_WIRELESS_IEEE802154) && defined(CONFIG_WIRELESS_PKTRADIO)
@@ -203,6 +219,23 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+/* Checksum offload.  The flags of a packet, in the io_flags of its IOB
+ * chain, tell that the device completes the TCP or UDP checksum of an
+ * outgoing packet, which only holds the sum of the pseudo header then, or
+ * that the device verified the checksum of an incoming packet.  d_csumcaps
+ * holds the flags that a device handles.
+ */
+
+#define NETDEV_CSUM_PARTIAL (1 << 0) /* The device completes the checksum */
+#define NETDEV_CSUM_VALID   (1 << 1) /* The device verified the checksum */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netdev_csum_valid(dev) \
+     (((dev)->d_iob->io_flags & NETDEV_CSUM_VALID) != 0)
+#else
+#  define netdev_csum_valid(dev) false
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #  ifndef CONFIG_NETDEV_MAX_IPv6_ADDR
 #    define CONFIG_NETDEV_MAX_IPv6_ADDR 1
@@ -338,6 +371,12 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t d_gsomax;            /* Maximum super-segment size, 0: none */
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t d_csumcaps;           /* NETDEV_CSUM_* flags handled by device */
+#endif
 
   /* Link layer address */
 
@@ -418,6 +457,12 @@ struct net_driver_s
   FAR struct iob_queue_s d_fragout;
 #endif
 
+  /* Remember the fast path forwarded packets waiting to be sent */
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+  FAR struct iob_queue_s d_fwdout;
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
@@ -474,6 +519,17 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_GRO)
+  /* When d_iob holds a TCP super-segment of up to d_gsomax bytes,
+   * d_gsosize is non-zero and is the size of the segments that it has to
+   * be cut into.  On input it is non-zero for the TCP segments that the
+   * receive offload has checked and coalesced, the size of the first of
+   * them.
+   */
+
+  uint16_t d_gsosize;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -542,6 +598,12 @@ struct net_driver_s
                       unsigned long arg);
 #endif
 
+#ifdef CONFIG_NET_FINE_LOCK
+  /* Serializes the access to the driver, see netdev_lock() */
+
+  rmutex_t d_lock;
+#endif
+
   /* Drivers may attached device-specific, private information */
 
   FAR void *d_private;
@@ -947,6 +1009,34 @@ uint16_t ipv4_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto);
+
+/****************************************************************************
+ * Name: ipv4_upperlayer_txchksum
+ *
+ * Description:
+ *   Get the checksum field of an outgoing packet with a zero checksum
+ *   field:  The complement of the checksum over the IPv4 pseudo-header,
+ *   the protocol header and the payload, or only the sum of the
+ *   pseudo-header if the device completes the checksum.  The flags of the
+ *   packet tell the device which one it is.
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *
+ * Returned Value:
+ *   The value of the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+uint16_t ipv4_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto);
+#else
+#  define ipv4_upperlayer_txchksum(dev, proto) \
+     ((uint16_t)~ipv4_upperlayer_chksum(dev, proto))
+#endif
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
@@ -1019,6 +1109,33 @@ uint16_t ipv6_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 
 uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
                                 uint8_t proto, unsigned int iplen);
+
+/****************************************************************************
+ * Name: ipv6_upperlayer_txchksum
+ *
+ * Description:
+ *   The same as ipv4_upperlayer_txchksum() for IPv6.
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *   iplen - The size of the IPv6 header.  This may be larger than
+ *           IPv6_HDRLEN the IPv6 header if IPv6 extension headers are
+ *           present.
+ *
+ * Returned Value:
+ *   The value of the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+uint16_t ipv6_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto, unsigned int iplen);
+#else
+#  define ipv6_upperlayer_txchksum(dev, proto, iplen) \
+     ((uint16_t)~ipv6_upperlayer_chksum(dev, proto, iplen))
+#endif
 #endif /* CONFIG_NET_IPv6 */
 
 /****************************************************************************
@@ -72,6 +72,13 @@
 #define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
 #define NETPKT_BUFNUM   CONFIG_IOB_NBUFFERS
 
+/* Offload features of the lower half, see the features field below */
+
+#define NETDEV_F_TSO4   (1 << 0) /* Segments TCP over IPv4 in hardware */
+#define NETDEV_F_TSO6   (1 << 1) /* Segments TCP over IPv6 in hardware */
+#define NETDEV_F_TXCSUM (1 << 2) /* Completes TCP/UDP checksums on TX */
+#define NETDEV_F_RXCSUM (1 << 3) /* Verifies TCP/UDP checksums on RX */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -119,6 +126,26 @@ struct netdev_lowerhalf_s
 
   atomic_t quota[NETPKT_TYPENUM];
 
+  /* The NETDEV_F_* offload features and the largest super-segment that
+   * the hardware takes, 0 for CONFIG_NETDEV_GSO_MAX_SIZE.
+   */
+
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_CSUM_OFFLOAD)
+  uint32_t features;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t gso_maxsize;
+#endif
+
+  /* The number of RX/TX queue pairs of a multi-queue device, 0 or 1 for a
+   * device with one queue.  The queues of a device with more than one are
+   * served through transmitq and receiveq.
+   */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +199,21 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmitq - The same as transmit for TX queue qid of a device with
+   *             more than one queue, which needs no transmit then.  The
+   *             upper half picks the queue by the flow of the packet.
+   * receiveq  - The same as receive for RX queue qid.  It is only called by
+   *             the work of the queue and without the device locked, the
+   *             RX queues of a device are drained in parallel.
+   */
+
+  CODE int (*transmitq)(FAR struct netdev_lowerhalf_s *dev, int qid,
+                        FAR netpkt_t *pkt);
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int qid);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +350,45 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_queue_rxready
+ *
+ * Description:
+ *   Notifies the networking layer that RX queue qid of a multi-queue device
+ *   has packets ready to read.  The packets are read by the work of the
+ *   queue on the CPU that the queue is bound to.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The index of the RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_queue_rxready(FAR struct netdev_lowerhalf_s *dev,
+                                int qid);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_queue_cpu
+ *
+ * Description:
+ *   Get the CPU that RX queue qid of a multi-queue device is bound to.  The
+ *   driver should route the interrupt of the queue to it.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The index of the RX queue
+ *
+ * Returned Value:
+ *   The index of the CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_lower_queue_cpu(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -509,6 +590,78 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_getgsosize
+ *
+ * Description:
+ *   Get the segment size of a packet passed to transmit().  It is not zero
+ *   if the packet is a TCP super-segment that the hardware has to cut into
+ *   segments of that size, which only happens with NETDEV_F_TSO4/6 set in
+ *   the features.  Only valid during transmit().
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+#  define netpkt_getgsosize(dev, pkt) ((dev)->netdev.d_gsosize)
+#else
+#  define netpkt_getgsosize(dev, pkt) 0
+#endif
+
+/****************************************************************************
+ * Name: netpkt_getcsum
+ *
+ * Description:
+ *   Check if the hardware has to complete the TCP or UDP checksum of a
+ *   packet passed to transmit(), which only happens with NETDEV_F_TXCSUM
+ *   set in the features.  The checksum field holds the sum of the pseudo
+ *   header then.  The hardware sums up the packet data from start on and
+ *   stores the complement of the sum at start + offset.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - The location to return the offset of the TCP or UDP header
+ *            from netpkt_getdata()
+ *   offset - The location to return the offset of the checksum field in
+ *            the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the hardware has to complete the checksum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool netpkt_getcsum(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                    FAR uint16_t *start, FAR uint16_t *offset);
+#else
+#  define netpkt_getcsum(dev, pkt, start, offset) false
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setcsumvalid
+ *
+ * Description:
+ *   Mark a received packet as having a TCP or UDP checksum that the
+ *   hardware verified, the network stack does not check it again.  Only
+ *   for a lower half with NETDEV_F_RXCSUM set in the features.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netpkt_setcsumvalid(dev, pkt) \
+     ((pkt)->io_flags |= NETDEV_CSUM_VALID)
+#else
+#  define netpkt_setcsumvalid(dev, pkt)
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -43,8 +43,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 
 #include <nuttx/net/ip.h>
@@ -76,6 +78,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The statistics gathered on the current CPU.  Each CPU counts in its own
+ * copy so that the counters do not bounce between the caches, the copies
+ * are summed by net_stats_sum() when the statistics are read.
+ */
+
+#define NETSTATS (g_netstats[this_cpu()])
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -127,13 +136,28 @@ struct net_stats_s
  * Public Data
  ****************************************************************************/
 
-/* This is the structure in which the statistics are gathered. */
+/* These are the structures in which the statistics are gathered, one per
+ * CPU.
+ */
 
-extern struct net_stats_s g_netstats;
+extern struct net_stats_s g_netstats[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_stats_sum
+ *
+ * Description:
+ *   Sum the statistics gathered on all of the CPUs.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ ****************************************************************************/
+
+void net_stats_sum(FAR struct net_stats_s *stats);
+
 #endif /* CONFIG_NET_STATISTICS */
 #endif /* __INCLUDE_NUTTX_NET_NETSTATS_H */
@@ -72,11 +72,13 @@
 #define TCP_OPT_WS        3   /* Window size scaling factor */
 #define TCP_OPT_SACK_PERM 4   /* Selective-ACK Permitted option */
 #define TCP_OPT_SACK      5   /* Selective-ACK Block option */
+#define TCP_OPT_FASTOPEN  34  /* TCP Fast Open cookie option */
 
 #define TCP_OPT_NOOP_LEN       1   /* Length of TCP NOOP option. */
 #define TCP_OPT_MSS_LEN        4   /* Length of TCP MSS option. */
 #define TCP_OPT_WS_LEN         3   /* Length of TCP WS option. */
 #define TCP_OPT_SACK_PERM_LEN  2   /* Length of TCP SACK option. */
+#define TCP_OPT_FASTOPEN_LEN   10  /* Length of TCP Fast Open option. */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -44,6 +44,9 @@
 #include <nuttx/config.h>
 #include <nuttx/net/ioctl.h>
 
+#include <stdint.h>
+#include <sys/uio.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -54,13 +57,51 @@
 #define IFF_TAP          0x02
 #define IFF_MASK         0x7f
 #define IFF_NO_PI        0x80
+#define IFF_MULTI_QUEUE  0x0100  /* Attach another queue to the interface */
+#define IFF_VNET_HDR     0x4000  /* Packets carry a struct tun_vnet_hdr_s */
 
-#ifdef CONFIG_NET_TUN
+/* struct tun_vnet_hdr_s flags and gso_type */
+
+#define TUN_VNET_HDR_F_NEEDS_CSUM  0x01  /* Complete the TCP/UDP checksum */
+#define TUN_VNET_HDR_F_DATA_VALID  0x02  /* The checksum was verified */
+
+#define TUN_VNET_HDR_GSO_NONE      0x00
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* With IFF_VNET_HDR every packet read or written is preceded by this
+ * header, laid out like struct virtio_net_hdr.  A packet read with
+ * TUN_VNET_HDR_F_NEEDS_CSUM holds the sum of its pseudo header at
+ * csum_start + csum_offset, the reader completes the checksum from
+ * csum_start to the end of the packet.  Segmentation offload is not
+ * supported, gso_type must be TUN_VNET_HDR_GSO_NONE.
+ */
+
+struct tun_vnet_hdr_s
+{
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;
+  uint16_t gso_size;
+  uint16_t csum_start;
+  uint16_t csum_offset;
+};
+
+/* The argument of TUNREADBATCH and TUNWRITEBATCH: one buffer per packet.
+ * The call moves up to npkts packets, only the first one may block, and
+ * sets npkts to the number moved and the iov_len of each to its length.
+ */
+
+struct tun_batch_s
+{
+  FAR struct iovec *pkts;
+  unsigned int      npkts;
+};
+
+#ifdef CONFIG_NET_TUN
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,99 @@
+/****************************************************************************
+ * include/nuttx/note/notectf_driver.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A CTF event record is one byte holding the number of trailing bytes the
+ * metadata does not describe as named fields, followed by the unmodified
+ * note.  Records are at most NOTECTF_RECORD_MAX bytes.
+ */
+
+#define NOTECTF_RECORD_MAX (UINT8_MAX + 1)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTECTF
+
+/****************************************************************************
+ * Name: notectf_datalen
+ *
+ * Description:
+ *   Return the record prefix of a note: the length of its variable data
+ *   (task name, printf arguments, syscall arguments, ...) and trailing
+ *   padding.
+ *
+ ****************************************************************************/
+
+uint8_t notectf_datalen(FAR const struct note_common_s *note);
+
+/****************************************************************************
+ * Name: notectf_put
+ *
+ * Description:
+ *   Write one note as a CTF event record to the stream.
+ *
+ ****************************************************************************/
+
+void notectf_put(FAR struct lib_outstream_s *stream,
+                 FAR const void *note, size_t notelen);
+
+/****************************************************************************
+ * Name: notectf_metadata
+ *
+ * Description:
+ *   Write the CTF 1.8 TSDL metadata describing the records of this build
+ *   (byte order, note layout, perf counter frequency) to the stream.
+ *
+ * Returned Value:
+ *   The number of bytes written.
+ *
+ ****************************************************************************/
+
+ssize_t notectf_metadata(FAR struct lib_outstream_s *stream);
+
+/****************************************************************************
+ * Name: notectf_register
+ *
+ * Description:
+ *   Register /dev/note/metadata returning the CTF metadata.
+ *
+ ****************************************************************************/
+
+int notectf_register(void);
+
+#endif /* CONFIG_DRIVERS_NOTECTF */
+#endif /* __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H */
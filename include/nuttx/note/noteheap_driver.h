@@ -0,0 +1,192 @@
+/****************************************************************************
+ * include/nuttx/note/noteheap_driver.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTEHEAP_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTEHEAP_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_DRIVERS_NOTEHEAP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One allocation or free of the trace */
+
+struct noteheap_record_s
+{
+  clock_t time;                  /* perf_gettime() of the event, 0 if loaded */
+  FAR void *mem;                 /* The address allocated or freed          */
+  uint32_t size;                 /* The size of the block allocated         */
+  pid_t pid;                     /* The thread that made the call           */
+  bool alloc;                    /* An allocation, else a free              */
+};
+
+/* The state of the trace */
+
+struct noteheap_status_s
+{
+  bool recording;                /* Recording is started                    */
+  uint32_t nrecords;             /* Records in the trace                    */
+  uint32_t dropped;              /* Events lost with the trace full         */
+  uint64_t elapsed;              /* Time from the first to the last, in ns  */
+};
+
+/* The replay of the trace against one allocator.  The times are in
+ * nanoseconds and the sizes in bytes.
+ */
+
+struct noteheap_result_s
+{
+  FAR const char *name;          /* The allocator                           */
+  uint8_t nthreads;              /* Threads replaying the trace at once     */
+  uint32_t nallocs;              /* Allocations replayed                    */
+  uint32_t nfrees;               /* Frees replayed                          */
+  uint32_t nfails;               /* Allocations that failed                 */
+  uint64_t alloc_p50;            /* Allocation latency percentiles          */
+  uint64_t alloc_p90;
+  uint64_t alloc_p99;
+  uint64_t alloc_max;
+  uint64_t free_p50;             /* Free latency percentiles                */
+  uint64_t free_p90;
+  uint64_t free_p99;
+  uint64_t free_max;
+  uint64_t elapsed;              /* Wall time of the whole replay           */
+  size_t arena;                  /* The size of the replay heap             */
+  size_t peak;                   /* The most memory ever in use             */
+
+  /* The fragmentation at evenly spaced points of the replay, as the percent
+   * of the free memory that is not in the largest free block.
+   */
+
+  uint8_t frag[CONFIG_DRIVERS_NOTEHEAP_SAMPLES];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: noteheap_register
+ *
+ * Description:
+ *   Register the heap trace recorder as a note driver.  It does not record
+ *   until noteheap_start() is called.
+ *
+ ****************************************************************************/
+
+int noteheap_register(void);
+
+/****************************************************************************
+ * Name: noteheap_clear / noteheap_start / noteheap_stop
+ *
+ * Description:
+ *   Clear the trace, and record the allocations and frees of all the heaps
+ *   until it is full or noteheap_stop() is called.
+ *
+ ****************************************************************************/
+
+void noteheap_clear(void);
+void noteheap_start(void);
+void noteheap_stop(void);
+
+/****************************************************************************
+ * Name: noteheap_load
+ *
+ * Description:
+ *   Append a record to the trace, to replay a trace captured on another
+ *   target or configuration.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY while recording or -ENOSPC if the trace
+ *   is full.
+ *
+ ****************************************************************************/
+
+int noteheap_load(FAR const struct noteheap_record_s *record);
+
+/****************************************************************************
+ * Name: noteheap_status / noteheap_record
+ *
+ * Description:
+ *   Return the state of the trace, or one of its records.  noteheap_record
+ *   returns -ENOENT past the last record.
+ *
+ ****************************************************************************/
+
+void noteheap_status(FAR struct noteheap_status_s *status);
+int noteheap_record(uint32_t index, FAR struct noteheap_record_s *record);
+
+/****************************************************************************
+ * Name: noteheap_replay
+ *
+ * Description:
+ *   Replay the trace against each allocator this build provides: the heap
+ *   manager alone and, with CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0, behind
+ *   the multiple mempool.  Each runs on a private heap of
+ *   CONFIG_DRIVERS_NOTEHEAP_HEAPSIZE bytes, once from one thread and once
+ *   from nthreads threads at the same time, all sharing that heap.
+ *
+ * Input Parameters:
+ *   nthreads - The threads of the contended replay, 1 to skip it
+ *
+ * Returned Value:
+ *   The number of results on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int noteheap_replay(int nthreads);
+
+/****************************************************************************
+ * Name: noteheap_result
+ *
+ * Description:
+ *   Return a result of the last replay, -ENOENT past the last one.
+ *
+ ****************************************************************************/
+
+int noteheap_result(int index, FAR struct noteheap_result_s *result);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DRIVERS_NOTEHEAP */
+#endif /* __INCLUDE_NUTTX_NOTE_NOTEHEAP_DRIVER_H */
@@ -73,6 +73,7 @@
 
 #define NOTERAM_MODE_READ_ASCII             0
 #define NOTERAM_MODE_READ_BINARY            1
+#define NOTERAM_MODE_READ_CTF               2
 #endif
 
 /****************************************************************************
@@ -66,6 +66,7 @@
 #define NXBE_WINDOW_RAMBACKED (1 << 2) /* Bit 2: Window is backed by a framebuffer */
 #define NXBE_WINDOW_MODAL     (1 << 3) /* Bit 3: Window is in a focused, modal state */
 #define NXBE_WINDOW_HIDDEN    (1 << 4) /* Bit 4: Window is hidden */
+#define NXBE_WINDOW_DAMAGED   (1 << 5) /* Bit 5: A redraw request is pending */
 
 /* Valid user flags for different window types.  This is the subset of flags
  * that may be passed with nx_openwindow() or nxtk_openwindow.  Most of the
@@ -126,6 +127,13 @@
 #define NXBE_CLRHIDDEN(wnd) \
   do { (wnd)->flags &= ~NXBE_WINDOW_HIDDEN; } while (0)
 
+#define NXBE_ISDAMAGED(wnd) \
+  (((wnd)->flags & NXBE_WINDOW_DAMAGED) != 0)
+#define NXBE_SETDAMAGED(wnd) \
+  do { (wnd)->flags |= NXBE_WINDOW_DAMAGED; } while (0)
+#define NXBE_CLRDAMAGED(wnd) \
+  do { (wnd)->flags &= ~NXBE_WINDOW_DAMAGED; } while (0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -165,6 +173,14 @@ struct nxbe_window_s
 
   uint8_t flags;
 
+#ifdef CONFIG_NX_DEFERREDRAW
+  /* Bounding box of the area to be redrawn by the client, in absolute
+   * screen coordinates.  Valid while NXBE_WINDOW_DAMAGED is set.
+   */
+
+  struct nxgl_rect_s damage;
+#endif
+
 #ifdef CONFIG_NX_RAMBACKED
   /* Per-window framebuffer support */
 
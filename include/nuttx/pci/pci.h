@@ -344,6 +344,14 @@ struct pci_ops_s
 
   CODE int (*connect_irq)(FAR struct pci_bus_s *bus, FAR int *irq,
                           int num, FAR uintptr_t *mar, FAR uint32_t *mdr);
+
+  /* Route an MSI/MSI-X interrupt to a CPU.  Return 0 when the interrupt
+   * controller was reprogrammed, or 1 with the new message in mar/mdr when
+   * the destination is carried in the message.
+   */
+
+  CODE int (*affinity_irq)(FAR struct pci_bus_s *bus, int irq, int cpu,
+                           FAR uintptr_t *mar, FAR uint32_t *mdr);
 };
 
 /* Each pci channel is a top-level PCI bus seem by CPU.  A machine with
@@ -834,6 +842,29 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_set_irq_affinity
+ *
+ * Description:
+ *   Route one MSI or MSI-X vector of a device to a CPU, so that the
+ *   vectors of a multi-queue device can be spread over the CPUs.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   irq   - vectors passed to pci_connect_irq()
+ *   index - index of the vector in irq
+ *   cpu   - the CPU that should take the interrupt
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int pci_set_irq_affinity(FAR struct pci_device_s *dev, FAR const int *irq,
+                         int index, int cpu);
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -0,0 +1,147 @@
+/****************************************************************************
+ * include/nuttx/profiler.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PROFILER_H
+#define __INCLUDE_NUTTX_PROFILER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_SCHED_PROFILER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The events that trigger a sample.  The timer is built in; the others are
+ * for the counter overflow interrupts of a PMU, which the architecture
+ * programs and reports through profiler_sample().
+ */
+
+#define PROFILER_EVENT_TIMER         0
+#define PROFILER_EVENT_CYCLES        1
+#define PROFILER_EVENT_CACHE_MISSES  2
+#define PROFILER_EVENT_BRANCH_MISSES 3
+#define PROFILER_NEVENTS             4
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One sample: the interrupted thread and its call stack, innermost first */
+
+struct profiler_sample_s
+{
+  clock_t  time;                         /* perf_gettime() of the sample    */
+  pid_t    pid;                          /* The interrupted thread          */
+  uint8_t  cpu;                          /* The CPU that took the sample    */
+  uint8_t  event;                        /* See PROFILER_EVENT_*            */
+  uint8_t  depth;                        /* Valid entries of stack[]        */
+  FAR void *stack[CONFIG_SCHED_PROFILER_DEPTH];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: profiler_start
+ *
+ * Description:
+ *   Clear the samples and start sampling all the CPUs from a timer.
+ *
+ * Input Parameters:
+ *   rate - The samples per second of each CPU, 0 for no timer, so that
+ *          only the PMU interrupts sample.  The timer is limited to the
+ *          rate of the system tick.
+ *
+ ****************************************************************************/
+
+void profiler_start(unsigned int rate);
+
+/****************************************************************************
+ * Name: profiler_stop
+ ****************************************************************************/
+
+void profiler_stop(void);
+
+/****************************************************************************
+ * Name: profiler_sample
+ *
+ * Description:
+ *   Take a sample of the interrupted thread on this CPU.  This is called
+ *   from interrupt handlers only: the profiler timer, or the counter
+ *   overflow interrupt of a PMU.  The sample is dropped if the buffer of
+ *   this CPU is full or the profiler is stopped.
+ *
+ * Input Parameters:
+ *   event - The event that triggered the interrupt, PROFILER_EVENT_*
+ *
+ ****************************************************************************/
+
+void profiler_sample(uint8_t event);
+
+/****************************************************************************
+ * Name: profiler_get
+ *
+ * Description:
+ *   Copy a sample of a CPU.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if index is past the last sample of the
+ *   CPU.
+ *
+ ****************************************************************************/
+
+int profiler_get(int cpu, int index, FAR struct profiler_sample_s *sample);
+
+/****************************************************************************
+ * Name: profiler_dropped
+ *
+ * Description:
+ *   Return the samples dropped with the buffers full.
+ *
+ ****************************************************************************/
+
+uint32_t profiler_dropped(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_PROFILER */
+#endif /* __INCLUDE_NUTTX_PROFILER_H */
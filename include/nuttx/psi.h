@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/nuttx/psi.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PSI_H
+#define __INCLUDE_NUTTX_PSI_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Indexes of the two stall kinds */
+
+#define PSI_SOME            0  /* At least one task stalled */
+#define PSI_FULL            1  /* Tasks stalled and no CPU doing other work */
+#define PSI_NKINDS          2
+
+/* Indexes of the running averages: 10 s, 60 s and 300 s */
+
+#define PSI_NAVGS           3
+
+/* The averages are in hundredths of a percent */
+
+#define PSI_AVG_ONE         10000
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+enum psi_res_e
+{
+  PSI_CPU = 0,                 /* Ready tasks that are not running */
+  PSI_MEM,                     /* Tasks waiting for memory */
+  PSI_IO,                      /* Tasks blocked on I/O */
+  PSI_NRES
+};
+
+struct psi_stat_s
+{
+  uint64_t total[PSI_NKINDS];             /* Total stall time in us */
+  uint16_t avg[PSI_NKINDS][PSI_NAVGS];    /* Averages, see PSI_AVG_ONE */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SCHED_PSI
+
+/****************************************************************************
+ * Name: psi_stall_enter / psi_stall_leave
+ *
+ * Description:
+ *   Bracket a wait of the calling task for memory (PSI_MEM) or I/O
+ *   (PSI_IO).  The calls nest and may be used from any task context; the
+ *   CPU stall is accounted by the scheduler itself.
+ *
+ ****************************************************************************/
+
+void psi_stall_enter(enum psi_res_e res);
+void psi_stall_leave(enum psi_res_e res);
+
+/****************************************************************************
+ * Name: psi_get
+ *
+ * Description:
+ *   Return the stall totals and averages of a resource.
+ *
+ ****************************************************************************/
+
+void psi_get(enum psi_res_e res, FAR struct psi_stat_s *stat);
+
+#else
+#  define psi_stall_enter(res)
+#  define psi_stall_leave(res)
+#endif
+
+/****************************************************************************
+ * Name: psi_notify_pressure
+ *
+ * Description:
+ *   Called by the PSI sampler, from the watchdog, after a sample in which
+ *   the resource was stalled, with its new totals.  Checks the stall
+ *   triggers set through /proc/pressure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_PSI) && defined(CONFIG_FS_PROCFS_INCLUDE_PRESSURE)
+void psi_notify_pressure(enum psi_res_e res, FAR const uint64_t *total);
+#else
+#  define psi_notify_pressure(res, total)
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_PSI_H */
@@ -32,6 +32,10 @@
 #include <pthread.h>
 #include <sched.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -96,6 +100,19 @@
   }
 #endif
 
+/* The uncontended lock and unlock of a pthread mutex are done with an atomic
+ * compare-and-swap of the holder of the underlying semaphore in libc, so
+ * that no system call is needed for them.  This is possible only if the
+ * kernel does not have to track the mutexes held by each thread (i.e. for
+ * the non-robust mutex) and, like the semaphore fast path, only if the
+ * atomic operations do not rely on spinlocks.
+ */
+
+#if defined(CONFIG_PTHREAD_MUTEX_UNSAFE) && \
+    !defined(CONFIG_LIBC_ARCH_ATOMIC) && CONFIG_LIBC_MUTEX_BACKTRACE == 0
+#  define PTHREAD_MUTEX_FASTPATH 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -164,6 +181,134 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
 
 void nx_pthread_exit(FAR void *exit_value) noreturn_function;
 
+/****************************************************************************
+ * Name: pthread_mutex_timedlock_slow, pthread_mutex_trylock_slow and
+ *       pthread_mutex_unlock_slow
+ *
+ * Description:
+ *   The system calls behind pthread_mutex_timedlock(),
+ *   pthread_mutex_trylock() and pthread_mutex_unlock().  These are used
+ *   when the libc fast path cannot complete the operation.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_timedlock_slow(FAR pthread_mutex_t *mutex,
+                                 FAR const struct timespec *abs_timeout);
+int pthread_mutex_trylock_slow(FAR pthread_mutex_t *mutex);
+int pthread_mutex_unlock_slow(FAR pthread_mutex_t *mutex);
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef PTHREAD_MUTEX_FASTPATH
+
+/****************************************************************************
+ * Name: pthread_mutex_fastlock
+ *
+ * Description:
+ *   Try to take a free mutex without entering the kernel.  Priority
+ *   protected mutexes always take the slow path.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be locked.
+ *
+ * Returned Value:
+ *   true if the mutex was taken, false if the slow path has to be used.
+ *
+ ****************************************************************************/
+
+static inline_function bool
+pthread_mutex_fastlock(FAR pthread_mutex_t *mutex)
+{
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  FAR sem_t *sem = &mutex->mutex.mutex.sem;
+#else
+  FAR sem_t *sem = &mutex->mutex.sem;
+#endif
+  int32_t old = NXSEM_NO_MHOLDER;
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      return false;
+    }
+#endif
+
+  if (!atomic_try_cmpxchg_acquire(NXSEM_MHOLDER(sem), &old,
+                                  _SCHED_GETTID()))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->mutex.count = 1;
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastunlock
+ *
+ * Description:
+ *   Try to release a mutex held by the calling thread without entering the
+ *   kernel.  This fails if there are waiters to be woken up, if this is not
+ *   the outermost unlock of a recursive mutex or if the caller is not the
+ *   holder.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   true if the mutex was released, false if the slow path has to be used.
+ *
+ ****************************************************************************/
+
+static inline_function bool
+pthread_mutex_fastunlock(FAR pthread_mutex_t *mutex)
+{
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  FAR sem_t *sem = &mutex->mutex.mutex.sem;
+#else
+  FAR sem_t *sem = &mutex->mutex.sem;
+#endif
+  int32_t old = _SCHED_GETTID();
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  /* Only the holder may touch the recursion count */
+
+  if (atomic_read(NXSEM_MHOLDER(sem)) != old || mutex->mutex.count != 1)
+    {
+      return false;
+    }
+
+  mutex->mutex.count = 0;
+  if (!atomic_try_cmpxchg_release(NXSEM_MHOLDER(sem), &old,
+                                  NXSEM_NO_MHOLDER))
+    {
+      /* A waiter set the blocking bit in the meantime */
+
+      mutex->mutex.count = 1;
+      return false;
+    }
+
+  return true;
+#else
+  return atomic_try_cmpxchg_release(NXSEM_MHOLDER(sem), &old,
+                                    NXSEM_NO_MHOLDER);
+#endif
+}
+
+#endif /* PTHREAD_MUTEX_FASTPATH */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Publish a pointer to an RCU protected object.  The initialization of the
+ * object is ordered before the pointer becomes visible to readers.
+ */
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      UP_DMB(); \
+      (p) = (v); \
+    } \
+  while (0)
+
+/* Fetch a pointer to an RCU protected object inside a read-side critical
+ * section.  Readers rely on the address dependency for ordering.
+ */
+
+#define rcu_dereference(p) (p)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+struct rcu_head;
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head *head);
+
+/* This structure is embedded in an object whose reclamation is deferred
+ * with call_rcu().
+ */
+
+struct rcu_head
+{
+  FAR struct rcu_head *next;    /* Next pending callback */
+  rcu_callback_t       func;    /* Called after the grace period */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter an RCU read-side critical section.  Objects obtained with
+ *   rcu_dereference() stay valid until the matching rcu_read_unlock().
+ *   Read-side critical sections may nest and may be used from interrupt
+ *   handlers, but must not block.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void);
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave an RCU read-side critical section.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void);
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until all RCU read-side critical sections that were in progress
+ *   when this function was called have completed.  Objects unlinked before
+ *   the call may then be freed.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from task context, outside of any read-side critical section.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Invoke 'func' on the work queue once all read-side critical sections
+ *   in progress at the time of the call have completed.  Unlike
+ *   synchronize_rcu() this never blocks and may be called from an
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   head - The rcu_head embedded in the object to be reclaimed
+ *   func - The function that reclaims the object
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RCU */
+#endif /* __INCLUDE_NUTTX_RCU_H */
@@ -41,6 +41,21 @@
 
 struct regmap_bus_s;
 
+/* Register cache types */
+
+enum regcache_type_e
+{
+  REGCACHE_NONE = 0,   /* No cache, every access goes over the bus */
+  REGCACHE_FLAT,       /* Array covering register 0 to max_register */
+  REGCACHE_RBTREE,     /* Tree of register blocks, for sparse maps */
+};
+
+/* Return true if a register changes without being written (status,
+ * interrupt flags, FIFO data, ...).
+ */
+
+typedef CODE bool (*regmap_volatile_t)(unsigned int reg);
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -100,6 +115,29 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* Register cache type, REGCACHE_NONE if not cached.  Needs
+   * CONFIG_REGMAP_CACHE.
+   */
+
+  enum regcache_type_e cache_type;
+
+  /* Highest valid register address, mandatory with a cache.  Registers
+   * above it are never cached.
+   */
+
+  unsigned int max_register;
+
+  /* Optional: registers for which this returns true are never cached. */
+
+  regmap_volatile_t volatile_reg;
+
+  /* The device does not auto-increment the register address, so
+   * regcache_sync() must not coalesce consecutive dirty registers into one
+   * bus write.
+   */
+
+  bool use_single_write;
 };
 
 struct regmap_s;
@@ -312,6 +350,80 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits of mask in a register.  The register is
+ *   only written if its value changes, and is read from the cache if it
+ *   is cached.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits in mask.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   While enabled, e.g. when the device is suspended or powered off,
+ *   writes to cached registers only update the cache and mark them dirty,
+ *   and accesses to other registers fail with -EBUSY.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - Enable or disable cache only mode.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark every cached register dirty, because the device lost its state
+ *   (reset, power loss).  The next regcache_sync() writes them all back.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers back to the device, typically after resume.
+ *   Runs of consecutive dirty registers are written with one bus transfer
+ *   unless use_single_write is set.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
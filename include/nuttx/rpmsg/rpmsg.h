@@ -78,6 +78,22 @@ struct rpmsg_ops_s
   CODE FAR const char *(*get_cpuname)(FAR struct rpmsg_s *rpmsg);
 };
 
+/* Hands one received payload over from an endpoint callback to the thread
+ * waiting for it: the callback holds the receive buffer instead of copying
+ * the payload, the waiter copies it straight to its destination and
+ * releases the buffer.  The remote can keep sending meanwhile, a payload
+ * arriving while the slot is busy is copied in the callback.
+ */
+
+struct rpmsg_rxslot_s
+{
+  FAR void *volatile rxbuf;    /* Held receive buffer, NULL if free */
+  FAR void          *dest;     /* Where the payload goes */
+  FAR const void    *src;      /* The payload in rxbuf */
+  size_t             len;      /* The payload length */
+  bool               last;     /* No further payload follows */
+};
+
 CODE typedef void (*rpmsg_dev_cb_t)(FAR struct rpmsg_device *rdev,
                                     FAR void *priv);
 CODE typedef bool (*rpmsg_match_cb_t)(FAR struct rpmsg_device *rdev,
@@ -102,6 +118,13 @@ extern "C"
 int rpmsg_wait(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 
+bool rpmsg_rxslot_put(FAR struct rpmsg_endpoint *ept,
+                      FAR struct rpmsg_rxslot_s *slot, FAR void *rxbuf,
+                      FAR void *dest, FAR const void *src, size_t len,
+                      bool last);
+bool rpmsg_rxslot_get(FAR struct rpmsg_endpoint *ept,
+                      FAR struct rpmsg_rxslot_s *slot);
+
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev);
 FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev);
 
@@ -98,6 +98,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -343,6 +344,27 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure holds the parameters and the Constant Bandwidth Server
+ * state of a thread that uses the SCHED_DEADLINE scheduling policy.  The
+ * remaining budget is kept in the timeslice field of the TCB.
+ */
+
+struct deadline_s
+{
+  clock_t  runtime;                 /* Budget per period (ticks)            */
+  clock_t  deadline;                /* Relative deadline (ticks)            */
+  clock_t  period;                  /* Activation period (ticks)            */
+  clock_t  abstick;                 /* Current absolute deadline            */
+  uint32_t bandwidth;               /* Reserved runtime/period fraction     */
+  bool     blocked;                 /* Apply the CBS wakeup rule            */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -512,6 +534,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+#ifdef CONFIG_SIG_PENDING_POOL
+  sigset_t tg_sigpoolset;           /* Standard signals pending in tg_sigpool   */
+  FAR struct sigpendq *tg_sigpool;  /* Pending entries of standard signals      */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -615,18 +641,28 @@ struct tcb_s
   int16_t  lockcount;                    /* 0=preemptible (not-locked)      */
 #ifdef CONFIG_IRQCOUNT
   int16_t  irqcount;                     /* 0=Not in critical section       */
+#endif
+#ifdef CONFIG_RCU
+  int16_t  rcu_nesting;                  /* 0=Not in RCU read-side section  */
 #endif
   int16_t  errcode;                      /* Used to pass error information  */
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
   int32_t  timeslice;                    /* RR timeslice OR Sporadic budget */
                                          /* interval remaining              */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct deadline_s dl;                  /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_WDOG_SLACK
+  unsigned long timerslack;              /* Timer slack in nanoseconds      */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -669,6 +705,10 @@ struct tcb_s
   clock_t ticks;                         /* Number of ticks on this thread  */
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  clock_t run_rem;                       /* Run time not charged as ticks   */
+#endif
+
   /* Pre-emption monitor support ********************************************/
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
@@ -684,6 +724,10 @@ struct tcb_s
   void   *preemp_max_caller;             /* Caller of max preemption        */
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  clock_t ready_time;                    /* Time thread became ready-to-run */
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
   clock_t crit_start;                    /* Time critical section entered   */
   clock_t crit_max;                      /* Max time in critical section    */
@@ -717,6 +761,17 @@ struct tcb_s
   size_t level;
 #endif
 
+#ifdef CONFIG_SCHED_FGRAPH
+  clock_t fgraph_time[CONFIG_SCHED_FGRAPH_DEPTH];
+  uint16_t fgraph_depth;                 /* Nesting, fgraph_time[] entries  */
+  uint16_t fgraph_filter;                /* Depth + 1 of the filtered call  */
+  bool fgraph_busy;                      /* Inside the tracer               */
+#endif
+
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct poll_cache_s *pollcache;    /* Kept poll() registrations      */
+#endif
+
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   spinlock_t mutex_lock;
 #endif
@@ -802,6 +857,20 @@ begin_packed_struct struct tcbinfo_s
   end_packed_struct reg_off; /* Refer to https://sourceware.org/gdb/current/onlinedocs/gdb.html/Standard-Target-Features.html */
 } end_packed_struct;
 
+/* struct critmon_caller_s **************************************************/
+
+/* Usage of the global critical section by one calling code location */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+struct critmon_caller_s
+{
+  FAR void *caller;                      /* Caller of critical section      */
+  uint32_t  count;                       /* Number of times it was taken    */
+  clock_t   total;                       /* Total time held                 */
+  clock_t   max;                         /* Maximum time held               */
+};
+#endif
+
 /* This is the callback type used by nxsched_foreach() */
 
 typedef CODE void (*nxsched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
@@ -847,6 +916,13 @@ EXTERN clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* The code locations that take the global critical section */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+EXTERN struct critmon_caller_s
+g_crit_callers[CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -925,6 +1001,19 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid);
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+/****************************************************************************
+ * Name: nxsched_alloc_tcb and nxsched_free_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB of the given size, or free a TCB allocated by
+ *   nxsched_alloc_tcb().  TCBs are kept in an object cache if
+ *   CONFIG_MM_KMEM_CACHE is enabled.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size);
+void nxsched_free_tcb(FAR struct tcb_s *tcb);
+
 /* File system helpers ******************************************************/
 
 /* These functions all extract lists from the group structure associated with
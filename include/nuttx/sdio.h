@@ -482,6 +482,7 @@
 #define SDIO_CAPS_8BIT            0x10 /* Bit 4=1: Supports 8 bit operation */
 #define SDIO_CAPS_4BIT_ONLY       0x20 /* Bit 5=1: Supports 4-bit only operation */
 #define SDIO_CAPS_MMC_HS_MODE     0x40 /* Bit 6=1: Supports eMMC high speed mode */
+#define SDIO_CAPS_DMA_SG          0x80 /* Bit 7=1: Supports scatter-gather DMA */
 
 /****************************************************************************
  * Name: SDIO_STATUS
@@ -905,6 +906,38 @@
 #  define SDIO_DMASENDSETUP(dev,buffer,len) (-ENOSYS)
 #endif
 
+/****************************************************************************
+ * Name: SDIO_DMARECVSETUP_SG / SDIO_DMASENDSETUP_SG
+ *
+ * Description:
+ *   Like SDIO_DMARECVSETUP and SDIO_DMASENDSETUP, but the data is
+ *   scattered over several segments, which the driver chains in one
+ *   descriptor list (e.g. ADMA2) so that the card sees one transfer.  Only
+ *   the start address of each segment needs to be aligned to
+ *   CONFIG_SDIO_DMA_SG_ALIGN, and only the length of the last segment may
+ *   not be a multiple of it.  Only available if the driver reports
+ *   SDIO_CAPS_DMA_SG.
+ *
+ * Input Parameters:
+ *   dev   - An instance of the SDIO device interface
+ *   segs  - The memory segments to DMA to/from, in transfer order
+ *   nsegs - The number of segments
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_DMA_SG
+#  define SDIO_DMARECVSETUP_SG(dev,segs,nsegs) \
+    ((dev)->dmarecvsetup_sg(dev,segs,nsegs))
+#  define SDIO_DMASENDSETUP_SG(dev,segs,nsegs) \
+    ((dev)->dmasendsetup_sg(dev,segs,nsegs))
+#else
+#  define SDIO_DMARECVSETUP_SG(dev,segs,nsegs) (-ENOSYS)
+#  define SDIO_DMASENDSETUP_SG(dev,segs,nsegs) (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Name: SDIO_GOTEXTCSD
  *
@@ -951,6 +984,16 @@ typedef uint8_t sdio_eventset_t;
 
 typedef uint8_t sdio_capset_t;
 
+#ifdef CONFIG_SDIO_DMA_SG
+/* One segment of a scatter-gather DMA transfer */
+
+struct sdio_dmaseg_s
+{
+  FAR uint8_t *buffer;          /* Start of the segment */
+  size_t       buflen;          /* Length of the segment in bytes */
+};
+#endif
+
 /* Status set.  A uint8_t is big enough to hold a set of 8 status bits.
  * If more are needed, change this to a uint16_t.
  */
@@ -1046,6 +1089,14 @@ struct sdio_dev_s
                              size_t buflen);
   CODE int   (*dmasendsetup)(FAR struct sdio_dev_s *dev,
                              FAR const uint8_t *buffer, size_t buflen);
+#ifdef CONFIG_SDIO_DMA_SG
+  CODE int   (*dmarecvsetup_sg)(FAR struct sdio_dev_s *dev,
+                                FAR const struct sdio_dmaseg_s *segs,
+                                int nsegs);
+  CODE int   (*dmasendsetup_sg)(FAR struct sdio_dev_s *dev,
+                                FAR const struct sdio_dmaseg_s *segs,
+                                int nsegs);
+#endif
 #endif /* CONFIG_SDIO_DMA */
   CODE void  (*gotextcsd)(FAR struct sdio_dev_s *dev,
                           FAR const uint8_t *buffer);
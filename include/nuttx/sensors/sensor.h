@@ -599,6 +599,12 @@ struct sensor_lowerhalf_s
    */
 
   bool persist;
+
+  /* The timestamp of the last sample pushed by sensor_push_batch(), used
+   * to measure the sample period of the hardware FIFO.
+   */
+
+  uint64_t batch_timestamp;
 };
 
 /****************************************************************************
@@ -632,6 +638,34 @@ extern "C"
 void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
                                int place);
 
+/****************************************************************************
+ * Name: sensor_push_batch
+ *
+ * Description:
+ *   Push the samples drained from a hardware FIFO in one call.  Only the
+ *   time the last sample was taken is needed: the timestamps of all the
+ *   samples are interpolated from the period measured between successive
+ *   batches (or the nominal period on the first batch and after a gap)
+ *   and written into the leading timestamp field of each sample.
+ *
+ * Input Parameters:
+ *   lower     - The lower half driver pushing the samples.
+ *   data      - The samples, struct sensor_xxx each.
+ *   bytes     - The number of bytes of the samples.
+ *   esize     - The size of one sample.
+ *   timestamp - The time the last sample was taken, in us.
+ *   period    - The nominal sample period of the FIFO, in us.
+ *
+ * Returned Value:
+ *   The bytes of push is returned when success;
+ *   A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_batch(FAR struct sensor_lowerhalf_s *lower,
+                          FAR void *data, size_t bytes, size_t esize,
+                          uint64_t timestamp, uint32_t period);
+
 /****************************************************************************
  * "Upper Half" Sensor Driver Interfaces
  ****************************************************************************/
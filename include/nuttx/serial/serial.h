@@ -145,6 +145,22 @@ struct uart_dmaxfer_s
 };
 #endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
 
+/* Continuous circular RX DMA.  The lower half provides the buffer and
+ * keeps a DMA running into it, wrapping at the end; each half of the
+ * buffer is a ping-pong buffer whose completion the lower half reports,
+ * as well as idle line or receive timeout events, with
+ * uart_recvchars_dmaring().  It restarts the DMA with tail set to zero.
+ */
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+struct uart_dmaring_s
+{
+  FAR char        *buffer;  /* DMA ring buffer, provided by the lower half */
+  size_t           size;    /* Size of the DMA ring buffer */
+  size_t           tail;    /* Next byte not yet moved to the RX buffer */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture
  * specific logic.  All fields must be provided with non-NULL function
  * pointers by the caller of uart_register().
@@ -353,6 +369,9 @@ struct uart_dev_s
 #ifdef CONFIG_SERIAL_RXDMA
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
 #endif
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+  struct uart_dmaring_s dmaring;     /* Describes circular receive DMA */
+#endif
 
   /* Driver interface */
 
@@ -532,6 +551,22 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_dmaring
+ *
+ * Description:
+ *  Move the bytes received by a circular DMA up to the write position pos
+ *  to the RX circular buffer and wake up the readers once.  Called by the
+ *  lower half on half transfer, transfer complete and idle line events and
+ *  from its dmarxfree() method: bytes that do not fit the RX buffer stay in
+ *  the DMA ring until then.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_dmaring(FAR uart_dev_t *dev, size_t pos);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
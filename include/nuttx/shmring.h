@@ -0,0 +1,209 @@
+/****************************************************************************
+ * include/nuttx/shmring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SHMRING_H
+#define __INCLUDE_NUTTX_SHMRING_H
+
+/* A shared memory ring is a bounded queue of messages in a shared memory
+ * object, that the processes which map the object send to and receive from
+ * without a system call.  Any number of senders and receivers may use a
+ * ring at the same time: each slot has a sequence number that tells the
+ * senders and the receivers whose turn it is.  The system calls are only
+ * made to sleep and wake up, when a receiver finds the ring empty or a
+ * sender finds it full: the other side then wakes them up with the
+ * FIOC_SHMWAKE ioctl, a futex on the shared memory object.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/atomic.h>
+
+#ifdef CONFIG_FS_SHMFS_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMRING_MAGIC             0x53524e47
+
+/* The header keeps the indexes of the senders and of the receivers apart */
+
+#define SHMRING_ALIGN             64
+
+/* The bytes of a slot for messages up to msgsize bytes, and of a ring */
+
+#define SHMRING_SLOTSIZE(msgsize) (((msgsize) + 8 + 7) & ~7)
+#define SHMRING_SIZE(msgsize, nslots) \
+  (sizeof(struct shmring_hdr_s) + (nslots) * SHMRING_SLOTSIZE(msgsize))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The argument of FIOC_SHMWAIT: sleep until FIOC_SHMWAKE if the word at
+ * addr, in the shared memory object, still holds val.
+ */
+
+struct shmring_wait_s
+{
+  FAR atomic_t *addr;
+  int32_t val;
+  int timeout;                           /* In ms, negative for no timeout */
+};
+
+/* The start of the shared memory object, then the slots */
+
+struct shmring_hdr_s
+{
+  atomic_t magic;                        /* SHMRING_MAGIC once initialized  */
+  uint32_t msgsize;                      /* Largest message                 */
+  uint32_t nslots;                       /* A power of two                  */
+  uint32_t reserved;
+
+  atomic_t head aligned_data(SHMRING_ALIGN); /* Next slot to send          */
+  atomic_t tail aligned_data(SHMRING_ALIGN); /* Next slot to receive       */
+
+  /* The waiters on an empty and on a full ring, and the futex words that
+   * the wake ups change.
+   */
+
+  atomic_t datawaiters aligned_data(SHMRING_ALIGN);
+  atomic_t dataseq;
+  atomic_t spacewaiters;
+  atomic_t spaceseq;
+};
+
+struct shmring_slot_s
+{
+  atomic_t seq;                          /* Position + 1 once sent          */
+  uint32_t len;
+  uint8_t data[1];
+};
+
+/* A ring opened by a process */
+
+struct shmring_s
+{
+  FAR struct shmring_hdr_s *hdr;
+  FAR uint8_t *slots;
+  size_t size;                           /* Of the mapping                  */
+  uint32_t mask;                         /* nslots - 1                      */
+  uint32_t slotsize;
+  int fd;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_open
+ *
+ * Description:
+ *   Open and map a ring, a shared memory object of shm_open().  The
+ *   process that creates the ring opens it with O_CREAT | O_EXCL, so that
+ *   it alone sizes and initializes it; the others open it without O_CREAT
+ *   and get -EAGAIN until it is initialized.
+ *
+ * Input Parameters:
+ *   ring    - The ring to open
+ *   name    - The name of the shared memory object
+ *   oflags  - The flags of shm_open(), O_RDWR is implied
+ *   msgsize - The largest message, when the ring is created
+ *   nslots  - The messages of the ring, a power of two, when created
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int shmring_open(FAR struct shmring_s *ring, FAR const char *name,
+                 int oflags, uint32_t msgsize, uint32_t nslots);
+
+/****************************************************************************
+ * Name: shmring_close
+ *
+ * Description:
+ *   Unmap and close a ring.  shm_unlink() removes it.
+ *
+ ****************************************************************************/
+
+void shmring_close(FAR struct shmring_s *ring);
+
+/****************************************************************************
+ * Name: shmring_send
+ *
+ * Description:
+ *   Send a message, waiting up to timeout ms while the ring is full: 0 to
+ *   not wait, negative to wait for ever.
+ *
+ * Returned Value:
+ *   The bytes sent on success; -EMSGSIZE if len is over the message size
+ *   of the ring, -EAGAIN or -ETIMEDOUT if the ring stayed full, or another
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_send(FAR struct shmring_s *ring, FAR const void *buf,
+                     size_t len, int timeout);
+
+/****************************************************************************
+ * Name: shmring_recv
+ *
+ * Description:
+ *   Receive a message, waiting up to timeout ms while the ring is empty, as
+ *   shmring_send().
+ *
+ * Returned Value:
+ *   The bytes of the message on success; -EMSGSIZE, leaving the message in
+ *   the ring, if it is over len bytes; -EAGAIN or -ETIMEDOUT if the ring
+ *   stayed empty, or another negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_recv(FAR struct shmring_s *ring, FAR void *buf,
+                     size_t len, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_SHMFS_RING */
+#endif /* __INCLUDE_NUTTX_SHMRING_H */
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/list.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -114,6 +115,27 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+/* This describes a sequence queued with spi_transfer_async().  The
+ * transactions of the sequence are the segments of the message, their
+ * deselect flags give the chip select changes between them.
+ */
+
+struct spi_message_s;
+typedef CODE void (*spi_complete_t)(FAR struct spi_message_s *msg,
+                                    int result);
+
+struct spi_message_s
+{
+  struct list_node node;        /* Used internally by the queue */
+  FAR struct spi_sequence_s *seq;
+  spi_complete_t complete;      /* Called with the spi_transfer() result */
+  FAR void *arg;                /* Free for use by the submitter */
+};
+
+/* The transfer queue of one SPI bus, see spi_async_initialize() */
+
+struct spi_async_s;
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -137,6 +159,48 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the transfer queue of an SPI bus.  A thread of the queue runs
+ *   the queued messages back to back, so the drivers queueing them do not
+ *   block on each transfer and may overlap their work with the bus.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device the queued messages are run on
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a message and return immediately.  The message is run with
+ *   spi_transfer() after the messages queued before it, then its complete
+ *   callback is called from the queue thread with the result.  The message
+ *   and the sequence it refers to must stay valid until then.  May be
+ *   called from interrupt context.
+ *
+ * Input Parameters:
+ *   async - The transfer queue of the SPI bus
+ *   msg   - The message to queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_async_s *async,
+                       FAR struct spi_message_s *msg);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
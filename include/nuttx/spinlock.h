@@ -82,7 +82,8 @@ extern "C"
 #endif
 
 #if !defined(__SP_UNLOCK_FUNCTION) && (defined(CONFIG_TICKET_SPINLOCK) || \
-     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS))
+     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) || \
+     defined(CONFIG_SCHED_LOCKSTAT_SPINLOCK))
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
@@ -102,6 +103,14 @@ void sched_note_spinlock_unlock(FAR volatile spinlock_t *spinlock);
 #  define sched_note_spinlock_unlock(spinlock)
 #endif
 
+#ifdef CONFIG_SCHED_LOCKSTAT_SPINLOCK
+void lockstat_spin_lock(FAR volatile spinlock_t *lock);
+void lockstat_spin_unlock(FAR volatile spinlock_t *lock);
+#else
+#  define lockstat_spin_lock(lock) spin_lock_notrace(lock)
+#  define lockstat_spin_unlock(lock)
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
@@ -237,9 +246,9 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
 
   sched_note_spinlock_lock(lock);
 
-  /* Lock without trace note */
+  /* Lock without trace note, accounting the contention */
 
-  spin_lock_notrace(lock);
+  lockstat_spin_lock(lock);
 
   /* Notify that we have the spinlock */
 
@@ -395,6 +404,7 @@ static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
 {
   /* Unlock without trace note */
 
+  lockstat_spin_unlock(lock);
   spin_unlock_notrace(lock);
 
   /* Notify that we are unlocking the spinlock */
@@ -485,9 +495,10 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
 
   sched_note_spinlock_lock(lock);
 
-  /* Lock without trace note */
+  /* Lock without trace note, accounting the contention */
 
-  flags = spin_lock_irqsave_notrace(lock);
+  flags = up_irq_save();
+  lockstat_spin_lock(lock);
 
   /* Notify that we have the spinlock */
 
@@ -623,6 +634,7 @@ void spin_unlock_irqrestore(FAR volatile spinlock_t *lock, irqstate_t flags)
 {
   /* Unlock without trace note */
 
+  lockstat_spin_unlock(lock);
   spin_unlock_irqrestore_notrace(lock, flags);
 
   /* Notify that we are unlocking the spinlock */
@@ -288,6 +288,16 @@ struct lib_lzfoutstream_s
   char                        in[LZF_STREAM_BLOCKSIZE];
   char                        out[LZF_MAX_HDR_SIZE + LZF_STREAM_BLOCKSIZE];
 };
+
+struct lib_lzfinstream_s
+{
+  struct lib_instream_s       common;
+  FAR struct lib_instream_s  *backend;
+  size_t                      offset;  /* Next octet of out to return */
+  size_t                      length;  /* Octets decompressed into out */
+  char                        in[LZF_STREAM_BLOCKSIZE];
+  char                        out[LZF_STREAM_BLOCKSIZE];
+};
 #endif
 
 #ifndef CONFIG_DISABLE_MOUNTPOINT
@@ -606,6 +616,27 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
                       FAR struct lib_outstream_s *backend);
 #endif
 
+/****************************************************************************
+ * Name: lib_lzfinstream
+ *
+ * Description:
+ *  LZF decompressing pipeline stream, the reverse of lib_lzfoutstream()
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lzfinstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_LZF
+void lib_lzfinstream(FAR struct lib_lzfinstream_s *stream,
+                     FAR struct lib_instream_s *backend);
+#endif
+
 /****************************************************************************
  * Name: lib_blkoutstream_open
  *
@@ -738,6 +769,18 @@ int lib_sprintf(FAR struct lib_outstream_s *stream,
 int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
                  FAR const void *buf);
 
+/****************************************************************************
+ * Name: lib_vbpack
+ *
+ * Description:
+ *  Store the arguments of fmt in buf in the layout lib_bsprintf() expects,
+ *  so that the formatting can be done later.
+ *
+ ****************************************************************************/
+
+size_t lib_vbpack(FAR void *buf, size_t buflen, FAR const IPTR char *fmt,
+                  va_list ap);
+
 /****************************************************************************
  * Name: lib_sprintf_internal
  *
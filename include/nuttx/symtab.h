@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +59,25 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+/* struct symtab_hash_s is a GNU-hash style index over a symbol table that
+ * is built once with symtab_hash_initialize().  The table itself is not
+ * modified, so the index may be built over a const table in FLASH.  The
+ * symbols are grouped by bucket in order[]; chain[] holds the hash of each
+ * of them with bit 0 set on the last symbol of a bucket.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* Number of symbols in symtab */
+  uint32_t nbuckets;                 /* Number of hash buckets */
+  uint32_t nbloom;                   /* Number of bloom words (power of 2) */
+  FAR uintptr_t *bloom;              /* Bloom filter over all hashes */
+  FAR uint32_t *buckets;             /* First order[] index of each bucket */
+  FAR uint32_t *chain;               /* Hash values, bit 0 ends a bucket */
+  FAR uint32_t *order;               /* symtab index of each chain entry */
+};
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -121,6 +142,52 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash_initialize
+ *
+ * Description:
+ *   Build a hash index over a symbol table.  The symbol table must stay
+ *   valid and unchanged while the index is in use.  If the index cannot be
+ *   allocated, the structure is still usable and symtab_hash_findbyname()
+ *   falls back to symtab_findbyname().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hash_initialize(FAR struct symtab_hash_s *hash,
+                           FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hash_uninitialize
+ *
+ * Description:
+ *   Free the hash index built by symtab_hash_initialize().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hash_uninitialize(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_hash_findbyname
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hash_findbyname(FAR const struct symtab_hash_s *hash,
+                       FAR const char *name);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
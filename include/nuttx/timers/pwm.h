@@ -62,6 +62,10 @@
  * CONFIG_PWM_MULTICHAN - Enables support for multiple output channels per
  *   timer.  If selected, then CONFIG_PWM_NCHANNELS must be provided to
  *   indicated the maximum number of supported PWM output channels.
+ * CONFIG_PWM_SEQUENCE - Some hardware will support playing an array of
+ *   duty cycles and periods by DMA or a timer burst.  If selected, then
+ *   CONFIG_PWM_SEQUENCE_NBUFFERS and CONFIG_PWM_SEQUENCE_NSTEPS give the
+ *   number of sequences that may be queued and the size of each.
  * CONFIG_DEBUG_PWM_INFO - This will generate output that can be use to
  *   debug the PWM driver.
  */
@@ -119,6 +123,17 @@
  *  bitmask, therefore it ioctl is both input and output. Passing NULL
  *  clears all active faults and does not read them back. Passing a pointer
  *  to a bitmask full of zeros will read the current faults and clear none.
+ *
+ * PWMIOC_SEQUENCE - Queue a waveform sequence, and start the output if it
+ *  is stopped.  The steps are copied, so the array may be refilled as soon
+ *  as the call returns.  The sequence starts where the previous one ends.
+ *  If CONFIG_PWM_SEQUENCE_NBUFFERS sequences are queued already, then this
+ *  ioctl call will block until the oldest one has been played, or fail
+ *  with EAGAIN if the PWM driver was opened with O_NONBLOCK.  poll()
+ *  reports POLLOUT while a sequence can be queued.  PWMIOC_STOP drops all
+ *  the queued sequences.
+ *
+ *  ioctl argument:  A read-only reference to struct pwm_sequence_s.
  */
 
 #define PWMIOC_SETCHARACTERISTICS      _PWMIOC(1)
@@ -126,6 +141,7 @@
 #define PWMIOC_START                   _PWMIOC(3)
 #define PWMIOC_STOP                    _PWMIOC(4)
 #define PWMIOC_FAULTS_FETCH_AND_CLEAR  _PWMIOC(5)
+#define PWMIOC_SEQUENCE                _PWMIOC(6)
 
 /* PWM channel polarity *****************************************************/
 
@@ -208,6 +224,34 @@ struct pwm_info_s
                                  * lower half */
 };
 
+#ifdef CONFIG_PWM_SEQUENCE
+/* One step of a waveform sequence, that lasts one period */
+
+struct pwm_step_s
+{
+  uint32_t           period;    /* Length of the period in nanoseconds.
+                                 * 0 means the period of the frequency of
+                                 * struct pwm_info_s */
+  ub16_t             duty;      /* Duty of the period */
+};
+
+/* A waveform sequence, queued with PWMIOC_SEQUENCE */
+
+struct pwm_sequence_s
+{
+  /* The steps to play in order */
+
+  FAR const struct pwm_step_s *steps;
+  uint32_t           nsteps;    /* The number of steps.  Maximum:
+                                 * CONFIG_PWM_SEQUENCE_NSTEPS */
+  uint32_t           count;     /* The number of times to play the steps.
+                                 * 0 means to play them until stopped */
+#ifdef CONFIG_PWM_MULTICHAN
+  int8_t             channel;   /* The channel that plays the sequence */
+#endif
+};
+#endif
+
 /* This structure is a set a callback functions used to call from the upper-
  * half, generic PWM driver into lower-half, platform-specific logic that
  * supports the low-level timer outputs.
@@ -252,6 +296,20 @@ struct pwm_ops_s
 
   CODE int (*ioctl)(FAR struct pwm_lowerhalf_s *dev,
                     int cmd, unsigned long arg);
+
+#ifdef CONFIG_PWM_SEQUENCE
+  /* Play a waveform sequence by DMA or a timer burst, starting the output
+   * if it is stopped, else queue it to start where the sequence being
+   * played ends.  The steps stay valid until the lower half reports the
+   * sequence with pwm_sequence_done(handle).  Return -EBUSY if no more
+   * sequences can be queued; the upper half offers it again after the next
+   * pwm_sequence_done().  The stop method drops all the sequences.
+   */
+
+  CODE int (*sequence)(FAR struct pwm_lowerhalf_s *dev,
+                       FAR const struct pwm_sequence_s *seq,
+                       FAR void *handle);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -367,6 +425,32 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev);
 void pwm_expired(FAR void *handle);
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence_done
+ *
+ * Description:
+ *   Called by the lower half when it has played the oldest sequence that
+ *   it accepted, the given number of times.  The upper half then frees the
+ *   buffer of the sequence for refill, and offers the lower half the next
+ *   queued sequence, if it did not take it yet.  When no sequence is left,
+ *   the lower half stops the output.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     sequence() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+void pwm_sequence_done(FAR void *handle);
+#endif
+
 /****************************************************************************
  * Platform-Independent "Lower-Half" PWM Driver Interfaces
  ****************************************************************************/
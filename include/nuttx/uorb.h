@@ -1162,6 +1162,23 @@ struct sensor_gnss_geofence_param
   int32_t            transition;
 };
 
+/* This structure heads the read-only mapping of a sensor ring returned by
+ * mmap(), nbuffer samples of esize bytes follow.  Sample n is stored in
+ * slot n % nbuffer.  The upper half bumps writing before it overwrites
+ * slots and written once the samples are complete, so a reader accesses
+ * sample n in place if n < written and then keeps it only if it still
+ * holds writing - n <= nbuffer.  poll() reports POLLIN when written moved
+ * since the last poll() of the same file.
+ */
+
+struct sensor_mmap_s
+{
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of samples in the ring */
+  volatile uint32_t writing;   /* The number of samples being written */
+  volatile uint32_t written;   /* The number of samples published */
+};
+
 /* This structure describes the state for the sensor device */
 
 struct sensor_state_s
@@ -523,7 +523,10 @@
  * Description:
  *   Process a request to handle a transfer asynchronously.  This method
  *   will enqueue the transfer request and return immediately.  Only one
- *   transfer may be queued on a given endpoint/
+ *   transfer may be queued on a given endpoint/  With
+ *   CONFIG_USBHOST_ASYNCH_QUEUE, up to CONFIG_USBHOST_ASYNCH_QUEUE_DEPTH
+ *   more may be queued behind it; they are performed and their callbacks
+ *   invoked in submission order.
  *
  *   When the transfer completes, the callback will be invoked with the
  *   provided argument.
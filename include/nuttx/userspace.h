@@ -75,7 +75,8 @@
  * Public Type Definitions
  ****************************************************************************/
 
-struct mm_heap_s; /* Forward reference */
+struct mm_heap_s;    /* Forward reference */
+struct clock_vdso_s; /* Forward reference */
 
 /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s. An
@@ -114,6 +115,12 @@ struct userspace_s
 #ifdef CONFIG_LIBC_USRWORK
   CODE int (*work_usrstart)(void);
 #endif
+
+  /* User-space copy of the system clock */
+
+#ifdef CONFIG_CLOCK_VDSO
+  FAR struct clock_vdso_s *us_vdso;
+#endif
 };
 
 /****************************************************************************
@@ -128,6 +135,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* The user-space copy of the system clock, defined in libc */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+EXTERN struct clock_vdso_s g_clock_vdso;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -322,6 +322,18 @@
                                               /* Argument: writable struct
                                                *           fb_fix_screeninfo */
 
+/* Swap Chain ***************************************************************/
+
+#define FBIO_ACQUIREBUFFER    _FBIOC(0x001d)  /* Get a buffer that is neither
+                                               * shown nor queued for pan
+                                               * Argument: read/write struct
+                                               *           fb_bufferinfo_s* */
+
+#define FBIO_EXPORTBUFFER     _FBIOC(0x001e)  /* Export a buffer as a DMABUF
+                                               * file descriptor
+                                               * Argument: read/write struct
+                                               *           fb_exportbuffer_s* */
+
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
 #define FB_TYPE_INTERLEAVED_PLANES   2      /* Interleaved planes */
@@ -542,6 +554,33 @@ struct fb_planeinfo_s
   uint32_t   yoffset;      /* Offset from virtual to visible resolution */
 };
 
+/* This structure describes one buffer of a multi-buffered plane or
+ * overlay.  FBIO_ACQUIREBUFFER hands out a buffer that is neither shown
+ * nor queued.  It is submitted by passing its yoffset to FBIOPAN_DISPLAY
+ * or FBIOPAN_OVERLAY, and POLLOUT is raised when the display releases the
+ * buffer it showed before.
+ */
+
+struct fb_bufferinfo_s
+{
+  int        overlay;      /* Overlay number, or FB_NO_OVERLAY (input) */
+  uint8_t    index;        /* Index of the buffer (output) */
+  uint32_t   yoffset;      /* Offset of the buffer in rows (output) */
+};
+
+/* This structure describes a buffer to be exported with FBIO_EXPORTBUFFER,
+ * so that a video device, as a camera, draws into it with
+ * V4L2_MEMORY_DMABUF.
+ */
+
+struct fb_exportbuffer_s
+{
+  int        overlay;      /* Overlay number, or FB_NO_OVERLAY (input) */
+  uint8_t    index;        /* Index of the buffer (input) */
+  int        flags;        /* O_CLOEXEC and access mode (input) */
+  int        fd;           /* The file descriptor (output) */
+};
+
 /* This structure describes an area. */
 
 struct fb_area_s
@@ -81,6 +81,8 @@ struct v4l2_ops_s
                        FAR struct v4l2_buffer *buf);
   CODE int (*qbuf)(FAR struct file *filep,
                    FAR struct v4l2_buffer *buf);
+  CODE int (*expbuf)(FAR struct file *filep,
+                     FAR struct v4l2_exportbuffer *exp);
   CODE int (*dqbuf)(FAR struct file *filep,
                     FAR struct v4l2_buffer *buf);
   CODE int (*cancel_dqbuf)(FAR struct file *filep,
@@ -44,6 +44,20 @@
 /* Virtio common feature bits */
 
 #define VIRTIO_F_ANY_LAYOUT   27
+#define VIRTIO_F_EVENT_IDX    29  /* VIRTIO_RING_F_EVENT_IDX, see virtqueue */
+#define VIRTIO_F_VERSION_1    32
+#define VIRTIO_F_RING_PACKED  34
+
+/* The features a driver adds to use packed virtqueues if the device and
+ * the transport support them, packed virtqueues need VIRTIO_F_VERSION_1.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_RING_PACKED
+#  define VIRTIO_PACKED_FEATURES \
+      ((1ULL << VIRTIO_F_VERSION_1) | (1ULL << VIRTIO_F_RING_PACKED))
+#else
+#  define VIRTIO_PACKED_FEATURES 0
+#endif
 
 /* Virtio helper functions */
 
@@ -58,6 +72,26 @@
       virtio_write_config((vdev), offsetof(structname, member), \
                           (ptr), sizeof(*(ptr)));
 
+/* The virtqueues of a device with VIRTIO_F_RING_PACKED are packed ones,
+ * the driver side virtqueue operations pass them to virtio-packed.c and
+ * the split ones to OpenAMP.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_RING_PACKED
+#  define virtqueue_is_packed(vq) \
+      virtio_has_feature((vq)->vq_dev, VIRTIO_F_RING_PACKED)
+
+#  define virtqueue_add_buffer(vq, buf_list, readable, writable, cookie) \
+      virtio_vq_add_buffer(vq, buf_list, readable, writable, cookie)
+#  define virtqueue_get_buffer(vq, len, idx) \
+      virtio_vq_get_buffer(vq, len, idx)
+#  define virtqueue_disable_cb(vq) virtio_vq_disable_cb(vq)
+#  define virtqueue_enable_cb(vq)  virtio_vq_enable_cb(vq)
+#  define virtqueue_kick(vq)       virtio_vq_kick(vq)
+#else
+#  define virtqueue_is_packed(vq)  false
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -70,6 +104,23 @@ struct virtio_driver
   CODE void        (*remove)(FAR struct virtio_device *vdev);
 };
 
+/* Packed virtqueues, virtio_packed_init() lays out the ring of a virtqueue
+ * created by the transport, before the transport passes it to the device.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_RING_PACKED
+void virtio_packed_init(FAR struct virtqueue *vq);
+
+int virtio_vq_add_buffer(FAR struct virtqueue *vq,
+                         FAR struct virtqueue_buf *buf_list,
+                         int readable, int writable, FAR void *cookie);
+FAR void *virtio_vq_get_buffer(FAR struct virtqueue *vq, FAR uint32_t *len,
+                               FAR uint16_t *idx);
+void virtio_vq_disable_cb(FAR struct virtqueue *vq);
+int virtio_vq_enable_cb(FAR struct virtqueue *vq);
+void virtio_vq_kick(FAR struct virtqueue *vq);
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -97,6 +97,12 @@ struct wdog_s
   FAR void          *picbase;    /* PIC base address */
 #endif
   clock_t            expired;    /* Timer associated with the absolute time */
+#ifdef CONFIG_WDOG_SLACK
+  clock_t            slack;      /* Ticks by which expiration may be deferred */
+#endif
+#ifdef CONFIG_WDOG_PERCPU
+  uint8_t            cpu;        /* CPU whose list holds the active watchdog */
+#endif
 };
 
 struct wdog_period_s
@@ -196,6 +202,41 @@ int wd_start(FAR struct wdog_s *wdog, clock_t delay,
 int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
                      wdentry_t wdentry, wdparm_t arg);
 
+/****************************************************************************
+ * Name: wd_start_abstick_slack and wd_start_slack
+ *
+ * Description:
+ *   The same as wd_start_abstick() and wd_start(), but the watchdog may
+ *   expire up to 'slack' ticks late so that its expiration can be merged
+ *   with that of other watchdogs.  Without CONFIG_WDOG_SLACK the slack is
+ *   ignored.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absolute time in clock ticks (wd_start_abstick_slack)
+ *   delay    - Delay count in clock ticks (wd_start_slack)
+ *   slack    - Maximum deferral of the expiration in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_SLACK
+int wd_start_abstick_slack(FAR struct wdog_s *wdog, clock_t ticks,
+                           clock_t slack, wdentry_t wdentry, wdparm_t arg);
+int wd_start_slack(FAR struct wdog_s *wdog, clock_t delay, clock_t slack,
+                   wdentry_t wdentry, wdparm_t arg);
+#else
+#  define wd_start_abstick_slack(wdog, ticks, slack, wdentry, arg) \
+          wd_start_abstick(wdog, ticks, wdentry, arg)
+#  define wd_start_slack(wdog, delay, slack, wdentry, arg) \
+          wd_start(wdog, delay, wdentry, arg)
+#endif
+
 /****************************************************************************
  * Name: wd_start_abstime
  *
@@ -86,6 +86,16 @@ struct bt_driver_s
                       enum bt_buf_type_e type,
                       FAR void *data, size_t len);
 
+  /* Filled by register function, may be NULL: hand over a frame read into
+   * an IOB, at io_offset, instead of copying it.  The IOB belongs to the
+   * stack only on success.  Anything that replaces receive must set this
+   * too (or to NULL).
+   */
+
+  CODE int (*receive_iob)(FAR struct bt_driver_s *btdev,
+                          enum bt_buf_type_e type,
+                          FAR struct iob_s *iob);
+
   /* Lower-half logic may support platform-specific ioctl commands */
 
   CODE int (*ioctl)(FAR struct bt_driver_s *btdev, int cmd,
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/clock.h>
@@ -228,6 +229,26 @@
 
 #endif /* CONFIG_LIBC_USRWORK && !__KERNEL__ */
 
+/* Per-CPU kernel work queues are only visible to kernel code */
+
+#if defined(CONFIG_SCHED_WORKQUEUE_PERCPU) && \
+    (!defined(CONFIG_LIBC_USRWORK) || defined(__KERNEL__))
+#  define WORK_HAVE_PERCPU 1
+#endif
+
+/* CPU selection for work_queue_cpu():  WORK_CPU_ANY queues the work on the
+ * calling CPU and lets any idle worker of the same priority take it.
+ */
+
+#define WORK_CPU_ANY       (-1)
+
+/* Buckets of the latency histogram of struct work_stats_s:  bucket 0
+ * counts the latencies under 1 us, bucket n those under 2^n us, and the
+ * last one all the longer ones.
+ */
+
+#define WORK_STATS_NBUCKETS 16
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -254,8 +275,52 @@ struct work_s
   clock_t          period; /* Periodical delay ticks */
   worker_t         worker; /* Work callback */
   FAR void        *arg;    /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+
+  /* The per-CPU queue holding the work and whether it may move to the
+   * queue of another CPU.
+   */
+
+  FAR struct kwork_wqueue_s *wq;
+  bool             pinned;
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t          ready;  /* perf_gettime() when the work became due */
+#endif
+};
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+/* The run time of one worker function.  The times are in perf counts. */
+
+struct work_funcstat_s
+{
+  worker_t  worker;                      /* The worker function             */
+  uint32_t  count;                       /* Number of runs                  */
+  clock_t   run;                         /* Total run time                  */
+  clock_t   runmax;                      /* Maximum run time                */
 };
 
+/* The statistics of one kernel work queue.  The latency is the time from
+ * the work being due to a worker starting it; the backlog is the due work
+ * still waiting for a worker.  The times are in perf counts.
+ */
+
+struct work_stats_s
+{
+  uint32_t  count;                       /* Works run                       */
+  clock_t   latency;                     /* Total latency                   */
+  clock_t   latencymax;                  /* Maximum latency                 */
+  clock_t   run;                         /* Total run time                  */
+  clock_t   runmax;                      /* Maximum run time                */
+  uint32_t  backlogmax;                  /* Maximum backlog                 */
+  uint32_t  histogram[WORK_STATS_NBUCKETS];
+
+  /* The worker functions with the longest runs */
+
+  struct work_funcstat_s funcs[CONFIG_SCHED_WORKQUEUE_STATS_NWORKERS];
+};
+#endif
+
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
  */
@@ -410,6 +475,39 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to be performed on the worker of a specific CPU.  This is
+ *   the same as work_queue() except that the work is bound to the queue of
+ *   the selected CPU and will not be taken by the workers of other CPUs.
+ *   Without CONFIG_SCHED_WORKQUEUE_PERCPU the CPU is ignored.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU that should run the work, or WORK_CPU_ANY
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef WORK_HAVE_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+#else
+#  define work_queue_cpu(qid, cpu, work, worker, arg, delay) \
+     work_queue(qid, work, worker, arg, delay)
+#endif
+
 /****************************************************************************
  * Name: work_queue_period/work_queue_period_wq
  *
@@ -667,6 +765,38 @@ void work_notifier_signal(enum work_evtype_e evtype,
                            FAR void *qualifier);
 #endif
 
+/****************************************************************************
+ * Name: work_stats_get
+ *
+ * Description:
+ *   Copy the statistics of a kernel work queue.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID, HPWORK or LPWORK
+ *   cpu   - The CPU of the queue with per-CPU work queues, else 0
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_stats_get(int qid, int cpu, FAR struct work_stats_s *stats);
+#endif
+
+/****************************************************************************
+ * Name: work_stats_reset
+ *
+ * Description:
+ *   Clear the statistics of all the kernel work queues.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+void work_stats_reset(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -276,6 +276,49 @@ int nx_asprintf(FAR char **ptr, FAR const IPTR char *fmt, ...)
 int nx_vasprintf(FAR char **ptr, FAR const IPTR char *fmt, va_list ap)
     printf_like(2, 0);
 
+/* Inline fast paths of the single character functions without locking:
+ * a character comes straight out of, or goes straight into, the stream
+ * buffer while it has data or room, and only the other cases call the
+ * library.  Character output that ends a line of a line buffered stream
+ * always goes through fputc_unlocked() to flush.  A non-empty write buffer
+ * also shows that the stream is open for writing.
+ */
+
+#if defined(CONFIG_FILE_STREAM) && !defined(CONFIG_STDIO_DISABLE_BUFFERING)
+static inline int __getc_unlocked(FAR FILE *stream)
+{
+#if CONFIG_NUNGET_CHARS > 0
+  if (stream->fs_bufpos < stream->fs_bufread && stream->fs_nungotten == 0)
+#else
+  if (stream->fs_bufpos < stream->fs_bufread)
+#endif
+    {
+      return (unsigned char)*stream->fs_bufpos++;
+    }
+
+  return fgetc_unlocked(stream);
+}
+
+static inline int __putc_unlocked(int c, FAR FILE *stream)
+{
+  if (stream->fs_bufpos > stream->fs_bufstart &&
+      stream->fs_bufpos < stream->fs_bufend &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = (char)c;
+      return (unsigned char)c;
+    }
+
+  return fputc_unlocked(c, stream);
+}
+
+#define getc_unlocked(s)     __getc_unlocked(s)
+#define putc_unlocked(c, s)  __putc_unlocked(c, s)
+#define getchar_unlocked()   __getc_unlocked(stdin)
+#define putchar_unlocked(c)  __putc_unlocked(c, stdout)
+#endif
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(fgets) FAR char *fgets(FAR char *s, int n, FAR FILE *stream)
 {
@@ -0,0 +1,72 @@
+/****************************************************************************
+ * include/stdio_ext.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_STDIO_EXT_H
+#define __INCLUDE_STDIO_EXT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Types for __fsetlocking() */
+
+#define FSETLOCKING_QUERY    0 /* Only return the current type */
+#define FSETLOCKING_INTERNAL 1 /* The stdio functions lock the stream */
+#define FSETLOCKING_BYCALLER 2 /* The caller locks the stream, if at all */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Name: __fsetlocking
+ *
+ * Description:
+ *   Set the locking type of the stream, as in glibc.  With
+ *   FSETLOCKING_BYCALLER every stdio function on the stream behaves like
+ *   its _unlocked variant and flockfile() does nothing: for a stream only
+ *   ever used by one thread, which then saves a mutex lock and unlock per
+ *   call.
+ *
+ * Returned Value:
+ *   The previous type, FSETLOCKING_INTERNAL or FSETLOCKING_BYCALLER.
+ *
+ ****************************************************************************/
+
+int __fsetlocking(FAR FILE *stream, int type);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_STDIO_EXT_H */
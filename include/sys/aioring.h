@@ -0,0 +1,201 @@
+/****************************************************************************
+ * include/sys/aioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_AIORING_H
+#define __INCLUDE_SYS_AIORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry operations */
+
+#define AIORING_OP_NOP          0  /* Complete immediately with res 0 */
+#define AIORING_OP_READ         1  /* read()/pread() into addr/len at off */
+#define AIORING_OP_WRITE        2  /* write()/pwrite() from addr/len at off */
+#define AIORING_OP_SEND         3  /* send() addr/len with opflags */
+#define AIORING_OP_RECV         4  /* recv() into addr/len with opflags */
+#define AIORING_OP_ACCEPT       5  /* accept4() with opflags, res is new fd */
+#define AIORING_OP_FSYNC        6  /* fsync() */
+#define AIORING_OP_POLL         7  /* Wait for opflags poll events */
+
+/* aioring_enter() flags */
+
+#define AIORING_ENTER_GETEVENTS (1 << 0) /* Wait for min_complete CQEs */
+
+/* Use this offset for READ/WRITE to use and update the file position */
+
+#define AIORING_OFF_CURRENT     ((off_t)-1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Submission queue entry, filled by the application */
+
+struct aioring_sqe_s
+{
+  uint8_t   opcode;                 /* AIORING_OP_* */
+  uint8_t   reserved[3];
+  int       fd;                     /* Target file descriptor */
+  off_t     off;                    /* READ/WRITE file offset */
+  FAR void *addr;                   /* Data buffer */
+  size_t    len;                    /* Data buffer length */
+  uint32_t  opflags;                /* MSG_*, SOCK_* or poll events */
+  uintptr_t user_data;              /* Copied to the completion */
+};
+
+/* Completion queue entry, filled by the kernel */
+
+struct aioring_cqe_s
+{
+  uintptr_t user_data;              /* user_data of the submission */
+  ssize_t   res;                    /* Result or negated errno value */
+};
+
+/* The ring shared between the application and the kernel.  The memory is
+ * owned by the application and registered with aioring_setup().  The
+ * entries counts must be powers of two.  The application advances sq_tail
+ * and cq_head, the kernel advances sq_head and cq_tail; the indexes are
+ * free running and wrap through the masks.
+ */
+
+struct aioring_s
+{
+  volatile uint32_t         sq_head;
+  volatile uint32_t         sq_tail;
+  volatile uint32_t         cq_head;
+  volatile uint32_t         cq_tail;
+  uint32_t                  sq_entries;
+  uint32_t                  cq_entries;
+  FAR struct aioring_sqe_s *sqes;
+  FAR struct aioring_cqe_s *cqes;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Return the next free submission entry or NULL if the queue is full.  The
+ * entry is handed to the kernel by aioring_sq_advance().
+ */
+
+static inline_function FAR struct aioring_sqe_s *
+aioring_get_sqe(FAR struct aioring_s *ring)
+{
+  if (ring->sq_tail - ring->sq_head >= ring->sq_entries)
+    {
+      return NULL;
+    }
+
+  return &ring->sqes[ring->sq_tail & (ring->sq_entries - 1)];
+}
+
+static inline_function void aioring_sq_advance(FAR struct aioring_s *ring,
+                                               uint32_t count)
+{
+  __sync_synchronize();
+  ring->sq_tail += count;
+}
+
+/* Return the oldest completion entry or NULL if there is none, the entry
+ * is released by aioring_cq_advance().
+ */
+
+static inline_function FAR struct aioring_cqe_s *
+aioring_peek_cqe(FAR struct aioring_s *ring)
+{
+  if (ring->cq_head == ring->cq_tail)
+    {
+      return NULL;
+    }
+
+  __sync_synchronize();
+  return &ring->cqes[ring->cq_head & (ring->cq_entries - 1)];
+}
+
+static inline_function void aioring_cq_advance(FAR struct aioring_s *ring,
+                                               uint32_t count)
+{
+  ring->cq_head += count;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioring_setup
+ *
+ * Description:
+ *   Register the ring with the kernel and return a file descriptor for it.
+ *   Closing the descriptor cancels the in-flight operations.
+ *
+ ****************************************************************************/
+
+int aioring_setup(FAR struct aioring_s *ring);
+
+/****************************************************************************
+ * Name: aioring_enter
+ *
+ * Description:
+ *   Submit up to to_submit entries and, with AIORING_ENTER_GETEVENTS, wait
+ *   until at least min_complete completions are available.  Returns the
+ *   number of submitted entries.
+ *
+ ****************************************************************************/
+
+int aioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                  unsigned int flags);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_SYS_AIORING_H */
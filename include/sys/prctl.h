@@ -69,6 +69,17 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to arg2 (unsigned long)
+ *    nanoseconds.  POSIX timers created by the thread may expire that much
+ *    late so that their expirations can be merged.  Requires
+ *    CONFIG_WDOG_SLACK.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 50000);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the timer slack of the calling thread in nanoseconds.
  */
 
 #define PR_SET_NAME     1
@@ -79,6 +90,9 @@
 #define PR_SET_DUMPABLE 5
 #define PR_GET_DUMPABLE 6
 
+#define PR_SET_TIMERSLACK 29
+#define PR_GET_TIMERSLACK 30
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -136,10 +136,15 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* Block for the first message only.  */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
 
+/* Send without copying the data. */
+
+#define MSG_ZEROCOPY     0x4000000
+
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET       1 /* Only socket-level options supported */
@@ -220,6 +225,17 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to bind to the same port and
+                            * spread the incoming connections and datagrams
+                            * between them (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_PASSCRED     20 /* Receive the credentials of the peer in an
+                            * SCM_CREDENTIALS control message (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -227,6 +243,9 @@
 #define SO_SNDBUFFORCE  32
 #define SO_RCVBUFFORCE  33
 #define SO_RXQ_OVFL     40
+#define SO_ZEROCOPY     60 /* Enables MSG_ZEROCOPY sends (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value */
 
 /* Protocol-level socket operations. */
 
@@ -297,6 +316,17 @@
 #define SCM_SECURITY    0x03    /* rw: security label */
 #define SCM_TIMESTAMP   SO_TIMESTAMP
 
+/* Origins and codes of the error queue messages */
+
+#define SO_EE_ORIGIN_NONE          0
+#define SO_EE_ORIGIN_LOCAL         1
+#define SO_EE_ORIGIN_ICMP          2
+#define SO_EE_ORIGIN_ICMP6         3
+#define SO_EE_ORIGIN_TXSTATUS      4
+#define SO_EE_ORIGIN_ZEROCOPY      5
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1 /* The data was copied after all */
+
 /* Desired design of maximum size and alignment (see RFC2553) */
 
 #define SS_MAXSIZE   128               /* Implementation-defined maximum size. */
@@ -372,6 +402,12 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -386,6 +422,26 @@ struct ucred
   gid_t gid;
 };
 
+/* The message of the error queue, read with recvmsg(MSG_ERRQUEUE) as the
+ * data of an IP_RECVERR or IPV6_RECVERR control message.  The completion
+ * of MSG_ZEROCOPY sends is reported with the origin SO_EE_ORIGIN_ZEROCOPY
+ * and the range of the completed sends in ee_info to ee_data; the sends of
+ * a socket are counted from zero.
+ */
+
+struct sock_extended_err
+{
+  uint32_t ee_errno;            /* Error number */
+  uint8_t  ee_origin;           /* Where the error originated */
+  uint8_t  ee_type;             /* Type */
+  uint8_t  ee_code;             /* Code */
+  uint8_t  ee_pad;
+  uint32_t ee_info;             /* Additional information */
+  uint32_t ee_data;             /* Other data */
+};
+
+struct timespec;                /* Forward reference */
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -459,6 +515,11 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
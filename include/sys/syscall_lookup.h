@@ -168,7 +168,11 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
  */
 
 SYSCALL_LOOKUP(clock,                      0)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_VDSO
+  SYSCALL_LOOKUP(nx_clock_gettime,         2)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
@@ -209,6 +213,10 @@ SYSCALL_LOOKUP(pwrite,                     4)
   SYSCALL_LOOKUP(aio_write,                1)
   SYSCALL_LOOKUP(aio_fsync,                2)
   SYSCALL_LOOKUP(aio_cancel,               2)
+#ifdef CONFIG_FS_AIO_RING
+  SYSCALL_LOOKUP(aioring_setup,            1)
+  SYSCALL_LOOKUP(aioring_enter,            4)
+#endif
 #endif
   SYSCALL_LOOKUP(poll,                     3)
   SYSCALL_LOOKUP(select,                   5)
@@ -248,6 +256,8 @@ SYSCALL_LOOKUP(fstat,                      2)
 SYSCALL_LOOKUP(statfs,                     2)
 SYSCALL_LOOKUP(fstatfs,                    2)
 SYSCALL_LOOKUP(sendfile,                   4)
+SYSCALL_LOOKUP(splice,                     6)
+SYSCALL_LOOKUP(vmsplice,                   4)
 SYSCALL_LOOKUP(sync,                       0)
 SYSCALL_LOOKUP(fsync,                      1)
 SYSCALL_LOOKUP(chmod,                      2)
@@ -321,9 +331,9 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(pthread_join,             2)
   SYSCALL_LOOKUP(pthread_mutex_destroy,    1)
   SYSCALL_LOOKUP(pthread_mutex_init,       2)
-  SYSCALL_LOOKUP(pthread_mutex_timedlock,  2)
-  SYSCALL_LOOKUP(pthread_mutex_trylock,    1)
-  SYSCALL_LOOKUP(pthread_mutex_unlock,     1)
+  SYSCALL_LOOKUP(pthread_mutex_timedlock_slow, 2)
+  SYSCALL_LOOKUP(pthread_mutex_trylock_slow, 1)
+  SYSCALL_LOOKUP(pthread_mutex_unlock_slow, 1)
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   SYSCALL_LOOKUP(pthread_mutex_consistent, 1)
 #endif
@@ -376,9 +386,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -522,7 +522,9 @@ enum v4l2_buf_type
 
 #define V4L2_TYPE_IS_CAPTURE(type) (!V4L2_TYPE_IS_OUTPUT(type))
 
-/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR. */
+/* Memory I/O method.  V4L2_MEMORY_DMABUF needs CONFIG_VIDEO_DMABUF.
+ * V4L2_MEMORY_OVERLAY is not supported.
+ */
 
 enum v4l2_memory
 {
@@ -800,10 +802,30 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).  The buffer index of queue type is
+ * returned as a file descriptor, to be mmap'ed or queued to another device
+ * as m.fd with V4L2_MEMORY_DMABUF.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t             type;      /* enum #v4l2_buf_type */
+  uint32_t             index;     /* Buffer id */
+  uint32_t             plane;     /* Plane, 0 as planes are not supported */
+  uint32_t             flags;     /* O_CLOEXEC and access mode */
+  int32_t              fd;        /* Driver sets the file descriptor */
+  uint32_t             reserved[11];
+};
+
 /* Image is a keyframe (I-frame) */
 
 #define V4L2_BUF_FLAG_KEYFRAME                  0x00000008
 
+/* The timestamp is of CLOCK_MONOTONIC, taken at the end of the frame */
+
+#define V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC       0x00002000
+
 /* mem2mem encoder/decoder */
 
 #define V4L2_BUF_FLAG_LAST                      0x00100000
@@ -140,6 +140,47 @@ int libelf_insertsymtab(FAR struct module_s *modp,
                         FAR Elf_Shdr *shdr,
                         FAR Elf_Sym *sym);
 
+/****************************************************************************
+ * Name: libelf_modsymbol
+ *
+ * Description:
+ *   Find a symbol exported by a loaded module.
+ *
+ * Input Parameters:
+ *   modp - Module state information
+ *   name - Symbol name to find
+ *
+ * Returned Value:
+ *   A reference to the exported symbol; NULL if the module does not
+ *   export a symbol of that name.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *libelf_modsymbol(FAR struct module_s *modp,
+                                            FAR const char *name);
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol in the exported kernel symbol table.  With
+ *   CONFIG_SYMTAB_HASHED the hash index of the table is built on first use
+ *   and kept until a different table is searched.
+ *
+ * Input Parameters:
+ *   exports  - The table of exported symbols
+ *   name     - Symbol name to find
+ *   nexports - The number of symbols in the exports table
+ *
+ * Returned Value:
+ *   A reference to the exported symbol; NULL if it is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports);
+
 /****************************************************************************
  * Name: libelf_findglobal
  *
@@ -76,6 +76,7 @@ static inline int libelf_fileinfo(FAR struct mod_loadinfo_s *loadinfo)
   loadinfo->fileuid  = buf.st_uid;
   loadinfo->filegid  = buf.st_gid;
   loadinfo->filemode = buf.st_mode;
+  loadinfo->filemtime = buf.st_mtime;
   return OK;
 }
 
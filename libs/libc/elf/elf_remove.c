@@ -153,6 +153,11 @@ int libelf_uninit(FAR struct module_s *modp)
           lib_free((FAR void *)modp->textalloc);
         }
 
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+      libelf_textcache_detach(modp->textcache);
+      modp->textcache = NULL;
+#endif
+
       modp->textalloc = NULL;
       modp->dataalloc = NULL;
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
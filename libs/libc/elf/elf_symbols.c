@@ -203,9 +203,7 @@ static int libelf_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = libelf_modsymbol(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -408,7 +406,7 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
+            symbol = libelf_findexport(exports, exportinfo.name,
                                        nexports);
           }
 
@@ -544,6 +542,11 @@ int libelf_insertsymtab(FAR struct module_s *modp,
 
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
           symtab_sortbyname(symbol, symcount);
+#endif
+#ifdef CONFIG_SYMTAB_HASHED
+          /* Without the index, lookups fall back to a plain search */
+
+          symtab_hash_initialize(&modp->exphash, symbol, symcount);
 #endif
         }
       else
@@ -556,6 +559,40 @@ int libelf_insertsymtab(FAR struct module_s *modp,
   return ret;
 }
 
+/****************************************************************************
+ * Name: libelf_modsymbol
+ *
+ * Description:
+ *   Find a symbol exported by a loaded module, through the hash index of
+ *   its exports when it has one.
+ *
+ * Input Parameters:
+ *   modp - Module state information
+ *   name - Symbol name to find
+ *
+ * Returned Value:
+ *   A reference to the exported symbol; NULL if the module does not
+ *   export a symbol of that name.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *libelf_modsymbol(FAR struct module_s *modp,
+                                            FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASHED
+  /* The module initializer may have replaced the exports we indexed */
+
+  if (modp->exphash.symtab == modp->modinfo.exports &&
+      modp->exphash.nsyms == modp->modinfo.nexports)
+    {
+      return symtab_hash_findbyname(&modp->exphash, name);
+    }
+#endif
+
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
+}
+
 /****************************************************************************
  * Name: findep
  *
@@ -630,6 +667,10 @@ void libelf_freesymtab(FAR struct module_s *modp)
   FAR const struct symtab_s *symbol;
   int i;
 
+#ifdef CONFIG_SYMTAB_HASHED
+  symtab_hash_uninitialize(&modp->exphash);
+#endif
+
   if ((symbol = modp->modinfo.exports) != NULL)
     {
       for (i = 0; i < modp->modinfo.nexports; i++)
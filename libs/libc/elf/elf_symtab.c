@@ -31,6 +31,8 @@
 #include <nuttx/symtab.h>
 #include <nuttx/lib/elf.h>
 
+#include "elf/elf.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,6 +67,12 @@ extern int CONFIG_LIBC_ELF_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_libelf_symtab;
 static int g_libelf_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASHED
+/* Hash index of the last exported symbol table searched */
+
+static struct symtab_hash_s g_libelf_hash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -129,3 +137,44 @@ void libelf_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   g_libelf_nsymbols = nsymbols;
   libelf_registry_unlock();
 }
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol in the exported kernel symbol table.  With
+ *   CONFIG_SYMTAB_HASHED the hash index of the table is built on first use
+ *   and kept until a different table is searched.
+ *
+ * Input Parameters:
+ *   exports  - The table of exported symbols
+ *   name     - Symbol name to find
+ *   nexports - The number of symbols in the exports table
+ *
+ * Returned Value:
+ *   A reference to the exported symbol; NULL if it is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports)
+{
+#ifdef CONFIG_SYMTAB_HASHED
+  FAR const struct symtab_s *symbol;
+
+  libelf_registry_lock();
+  if (g_libelf_hash.symtab != exports || g_libelf_hash.nsyms != nexports)
+    {
+      symtab_hash_uninitialize(&g_libelf_hash);
+      symtab_hash_initialize(&g_libelf_hash, exports, nexports);
+    }
+
+  symbol = symtab_hash_findbyname(&g_libelf_hash, name);
+  libelf_registry_unlock();
+
+  return symbol;
+#else
+  return symtab_findbyname(exports, name, nexports);
+#endif
+}
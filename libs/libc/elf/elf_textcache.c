@@ -0,0 +1,348 @@
+/****************************************************************************
+ * libs/libc/elf/elf_textcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/lib/elf.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "libc.h"
+#include "elf/elf.h"
+
+#ifdef CONFIG_LIBC_ELF_SHARED_TEXT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_USE_TEXT_HEAP
+#  define textcache_memalign(a, s)  up_textheap_memalign(a, s)
+#  define textcache_free(p)         up_textheap_free(p)
+#  define textcache_data(p) \
+            (FAR uint8_t *)up_textheap_data_address((FAR void *)p)
+#else
+#  define textcache_memalign(a, s)  lib_memalign(a, s)
+#  define textcache_free(p)         lib_free(p)
+#  define textcache_data(p)         ((FAR uint8_t *)p)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached copy of the read-only part of an ELF file */
+
+struct libelf_text_s
+{
+  FAR struct libelf_text_s *flink; /* Supports a singly linked list */
+  FAR void *region;                /* Copy of the read-only file range */
+  off_t offset;                    /* File offset of region[0] */
+  size_t size;                     /* Size of region */
+  off_t filelen;                   /* Length of the cached file */
+  time_t filemtime;                /* Modification time of the file */
+  int crefs;                       /* Number of loaded instances */
+  char filename[1];                /* Path of the cached file */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of cached files, protected by the registry lock */
+
+static FAR struct libelf_text_s *g_libelf_text;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: libelf_textrange
+ *
+ * Description:
+ *   Find the file range holding all of the read-only sections, which is
+ *   what the loader executes in place once xipbase is set.  The text can
+ *   only be shared if it is position independent (there is a GOT) and no
+ *   relocation patches it, so that each instance only differs by its data.
+ *
+ * Returned Value:
+ *   0 (OK) if the text can be shared; -ENOSYS if it cannot.
+ *
+ ****************************************************************************/
+
+static int libelf_textrange(FAR struct mod_loadinfo_s *loadinfo,
+                            FAR off_t *start, FAR off_t *end,
+                            FAR size_t *align)
+{
+  FAR Elf_Shdr *shdr;
+  off_t lo = loadinfo->shdr[1].sh_offset;
+  off_t hi = lo;
+  int i;
+
+  *align = sizeof(uintptr_t);
+
+  if (loadinfo->ehdr.e_type == ET_DYN ||
+      libelf_findsection(loadinfo, ".got") < 0)
+    {
+      return -ENOSYS;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      shdr = &loadinfo->shdr[i];
+
+      /* Refuse text relocations: they would patch the shared copy */
+
+      if ((shdr->sh_type == SHT_REL || shdr->sh_type == SHT_RELA) &&
+          shdr->sh_info < loadinfo->ehdr.e_shnum &&
+          (loadinfo->shdr[shdr->sh_info].sh_flags &
+           (SHF_ALLOC | SHF_WRITE)) == SHF_ALLOC)
+        {
+          return -ENOSYS;
+        }
+
+      if ((shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+          shdr->sh_type == SHT_NOBITS || shdr->sh_size == 0)
+        {
+          continue;
+        }
+
+      lo = MIN(lo, (off_t)shdr->sh_offset);
+      hi = MAX(hi, (off_t)(shdr->sh_offset + shdr->sh_size));
+      if (*align < shdr->sh_addralign)
+        {
+          *align = shdr->sh_addralign;
+        }
+    }
+
+  if (hi <= lo || hi > loadinfo->filelen)
+    {
+      return -ENOSYS;
+    }
+
+  /* Keep the file offsets aligned like the sections they hold */
+
+  *start = lo & ~((off_t)*align - 1);
+  *end   = hi;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: libelf_textfill
+ *
+ * Description:
+ *   Create the cache entry of a file and read its read-only range.
+ *
+ ****************************************************************************/
+
+static FAR struct libelf_text_s *
+libelf_textfill(FAR struct mod_loadinfo_s *loadinfo,
+                FAR const char *filename)
+{
+  FAR struct libelf_text_s *text;
+  size_t align;
+  off_t start;
+  off_t end;
+  int ret;
+
+  if (libelf_textrange(loadinfo, &start, &end, &align) < 0)
+    {
+      return NULL;
+    }
+
+  text = lib_zalloc(sizeof(struct libelf_text_s) + strlen(filename));
+  if (text == NULL)
+    {
+      return NULL;
+    }
+
+  text->size   = end - start;
+  text->region = textcache_memalign(align, text->size);
+  if (text->region == NULL)
+    {
+      lib_free(text);
+      return NULL;
+    }
+
+  ret = libelf_read(loadinfo, textcache_data(text->region), text->size,
+                    start);
+  if (ret < 0)
+    {
+      berr("ERROR: Failed to read shared text: %d\n", ret);
+      textcache_free(text->region);
+      lib_free(text);
+      return NULL;
+    }
+
+  up_coherent_dcache((uintptr_t)text->region, text->size);
+
+  strcpy(text->filename, filename);
+  text->offset    = start;
+  text->filelen   = loadinfo->filelen;
+  text->filemtime = loadinfo->filemtime;
+  return text;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: libelf_textcache_attach
+ *
+ * Description:
+ *   Share the read-only part of a position independent ELF program between
+ *   all the instances loaded from the same, unchanged, file.  The first
+ *   instance reads that part into a cached copy; every instance then
+ *   executes it in place exactly as if the file system had provided it
+ *   through FIOC_XIPBASE, and only loads its own data and bss.
+ *
+ *   This must be called between libelf_initialize() and libelf_load().
+ *   Files that cannot share their text are loaded as before.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  *handle is set to the cache entry to release with
+ *   libelf_textcache_detach(), or NULL if nothing is shared.
+ *
+ ****************************************************************************/
+
+int libelf_textcache_attach(FAR struct mod_loadinfo_s *loadinfo,
+                            FAR const char *filename,
+                            FAR void **handle)
+{
+  FAR struct libelf_text_s *text;
+  uintptr_t xipbase;
+  int ret;
+
+  DEBUGASSERT(loadinfo != NULL && filename != NULL && handle != NULL);
+
+  *handle = NULL;
+
+  /* Nothing to share if the file system can already run it in place */
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE, (unsigned long)&xipbase) >= 0)
+    {
+      return OK;
+    }
+
+  libelf_registry_lock();
+  for (text = g_libelf_text; text != NULL; text = text->flink)
+    {
+      if (text->filelen == loadinfo->filelen &&
+          text->filemtime == loadinfo->filemtime &&
+          strcmp(text->filename, filename) == 0)
+        {
+          break;
+        }
+    }
+
+  if (text == NULL)
+    {
+      ret = libelf_loadhdrs(loadinfo);
+      if (ret >= 0)
+        {
+          text = libelf_textfill(loadinfo, filename);
+        }
+
+      /* libelf_load() reads the headers again */
+
+      libelf_freebuffers(loadinfo);
+      if (ret < 0)
+        {
+          libelf_registry_unlock();
+          return ret;
+        }
+
+      if (text == NULL)
+        {
+          libelf_registry_unlock();
+          return OK;
+        }
+
+      text->flink   = g_libelf_text;
+      g_libelf_text = text;
+    }
+
+  text->crefs++;
+  libelf_registry_unlock();
+
+  binfo("%s: shared text %p size %zu, %d instances\n",
+        filename, text->region, text->size, text->crefs);
+
+  loadinfo->xipbase = (uintptr_t)text->region - text->offset;
+  *handle = text;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: libelf_textcache_detach
+ *
+ * Description:
+ *   Release one instance of a shared text.  The cached copy is freed with
+ *   its last instance.
+ *
+ ****************************************************************************/
+
+void libelf_textcache_detach(FAR void *handle)
+{
+  FAR struct libelf_text_s *text = handle;
+  FAR struct libelf_text_s **link;
+
+  if (text == NULL)
+    {
+      return;
+    }
+
+  libelf_registry_lock();
+  DEBUGASSERT(text->crefs > 0);
+  if (--text->crefs == 0)
+    {
+      for (link = &g_libelf_text; *link != NULL; link = &(*link)->flink)
+        {
+          if (*link == text)
+            {
+              *link = text->flink;
+              break;
+            }
+        }
+
+      textcache_free(text->region);
+      lib_free(text);
+    }
+
+  libelf_registry_unlock();
+}
+
+#endif /* CONFIG_LIBC_ELF_SHARED_TEXT */
@@ -75,8 +75,12 @@
 #  define IDX(h)    ((h) & (HSIZE - 1))
 #endif
 
+/* MAX_OFF is set by the 13 offset bits of the format, not by the hash
+ * table size.
+ */
+
 #define MAX_LIT     (1 <<  5)
-#define MAX_OFF     (1 << HLOG)
+#define MAX_OFF     (1 << 13)
 #define MAX_REF     ((1 << 8) + (1 << 3))
 
 #if __GNUC__ >= 3
@@ -90,6 +94,91 @@
 #define expect_false(expr)   expect((expr) != 0, 0)
 #define expect_true(expr)    expect((expr) != 0, 1)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_match_len
+ *
+ * Description:
+ *   Return the length of the match between ref and ip, whose first three
+ *   octets are known to be equal, up to maxlen octets.  Compares a word
+ *   at a time and finds the first differing octet from the XOR of the
+ *   words.
+ *
+ ****************************************************************************/
+
+static unsigned int lzf_match_len(FAR const uint8_t *ref,
+                                  FAR const uint8_t *ip,
+                                  unsigned int maxlen)
+{
+  unsigned int len = 3;
+
+#if defined(__GNUC__) && !defined(CONFIG_LIBC_LZF_ALIGN)
+  while (len + sizeof(unsigned long) <= maxlen)
+    {
+      unsigned long a;
+      unsigned long b;
+
+      memcpy(&a, ref + len, sizeof(a));
+      memcpy(&b, ip + len, sizeof(b));
+      if (a != b)
+        {
+#  ifdef CONFIG_ENDIAN_BIG
+          return len + __builtin_clzl(a ^ b) / 8;
+#  else
+          return len + __builtin_ctzl(a ^ b) / 8;
+#  endif
+        }
+
+      len += sizeof(unsigned long);
+    }
+#endif
+
+  while (len < maxlen && ref[len] == ip[len])
+    {
+      len++;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: lzf_find
+ *
+ * Description:
+ *   Return the length of the match at ip against the earlier position ref
+ *   taken from the hash table, or 0 if there is none.  The offset of the
+ *   match is returned in off.
+ *
+ ****************************************************************************/
+
+static unsigned int lzf_find(FAR const uint8_t *in_data,
+                             FAR const uint8_t *in_end,
+                             FAR const uint8_t *ip,
+                             FAR const uint8_t *ref,
+                             FAR uintptr_t *off)
+{
+  unsigned int maxlen;
+
+  if (
+#if INIT_HTAB
+      ref >= ip || /* the next test also takes care of this, but faster */
+#endif
+      (*off = ip - ref - 1) >= MAX_OFF
+      || ref <= in_data
+      || ref[2] != ip[2]
+      || ref[1] != ip[1]
+      || ref[0] != ip[0])
+    {
+      return 0;
+    }
+
+  maxlen = in_end - ip - 2;
+  return lzf_match_len(ref, ip, maxlen > MAX_REF ? MAX_REF : maxlen);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,19 +227,12 @@ size_t lzf_compress(FAR const void *const in_data,
   ssize_t cs;
   ssize_t retlen;
 
-  /* off requires a type wide enough to hold a general pointer difference.
-   * ISO C doesn't have that (size_t might not be enough and ptrdiff_t only
-   * works for differences within a single object). We also assume that no
-   * no bit pattern traps. Since the only platform that is both non-POSIX
-   * and fails to support both assumptions is windows 64 bit, we make a
-   * special workaround for it.
+  /* off requires a type wide enough to hold a general pointer difference,
+   * as a stale hash table entry may point anywhere.
    */
 
-#ifdef CONFIG_HAVE_LONG_LONG
-  uint64_t off;  /* Workaround for missing POSIX compliance */
-#else
-  unsigned long off;
-#endif
+  uintptr_t off;
+  unsigned int len;
   unsigned int hval;
   int lit;
 
@@ -177,25 +259,53 @@ size_t lzf_compress(FAR const void *const in_data,
       ref    = *hslot + LZF_HSLOT_BIAS;
       *hslot = ip - LZF_HSLOT_BIAS;
 
-      if (1
-#if INIT_HTAB
-          && ref < ip /* the next test will actually take care of this, but this is faster */
-#endif
-          && (off = ip - ref - 1) < MAX_OFF
-          && ref > (uint8_t *)in_data
-          && ref[2] == ip[2]
-#ifdef CONFIG_LIBC_LZF_ALIGN
-          && ((ref[1] << 8) | ref[0]) == ((ip[1] << 8) | ip[0])
-#else
-          && *(FAR uint16_t *)ref == *(FAR uint16_t *)ip
-#endif
-        )
+      len = lzf_find(in_data, in_end, ip, ref, &off);
+      if (len != 0)
         {
           /* Match found at *ref++ */
 
-          unsigned int len = 2;
-          unsigned int maxlen = in_end - ip - len;
-          maxlen = maxlen > MAX_REF ? MAX_REF : maxlen;
+#ifdef CONFIG_LIBC_LZF_LAZY
+          /* Lazy matching: while the match at the next octet is longer,
+           * emit this octet as a literal and take that match instead.
+           */
+
+          while (len < MAX_REF && ip + 1 < in_end - 2)
+            {
+              unsigned int hnext = NEXT(hval, (ip + 1));
+              FAR const uint8_t *ref2;
+              uintptr_t off2;
+              unsigned int len2;
+
+              hslot = htab + IDX(hnext);
+              ref2  = *hslot + LZF_HSLOT_BIAS;
+              len2  = lzf_find(in_data, in_end, ip + 1, ref2, &off2);
+              if (len2 <= len)
+                {
+                  break;
+                }
+
+              if (expect_false(op >= out_end))
+                {
+                  cs = 0;
+                  goto genhdr;
+                }
+
+              lit++;
+              *op++ = *ip++;
+
+              if (expect_false(lit == MAX_LIT))
+                {
+                  op[(- lit) - 1] = lit - 1; /* Stop run */
+                  lit = 0;                   /* Start run */
+                  op++;
+                }
+
+              *hslot = ip - LZF_HSLOT_BIAS;
+              hval   = hnext;
+              len    = len2;
+              off    = off2;
+            }
+#endif
 
           /* First a faster conservative test */
 
@@ -213,116 +323,6 @@ size_t lzf_compress(FAR const void *const in_data,
           op[(- lit) - 1] = lit - 1; /* Stop run */
           op -= !lit;                /* Undo run if length is zero */
 
-          for (; ; )
-            {
-              if (expect_true(maxlen > 16))
-                {
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-
-                  len++;
-                  if (ref[len] != ip[len])
-                    {
-                      break;
-                    }
-                }
-
-              do
-                {
-                  len++;
-                }
-              while (len < maxlen && ref[len] == ip[len]);
-
-              break;
-            }
-
           len -= 2; /* len is now #octets - 1 */
           ip++;
 
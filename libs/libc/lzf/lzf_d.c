@@ -96,103 +96,23 @@ unsigned int lzf_decompress (FAR const void *const in_data,
 #ifdef lzf_movsb
           lzf_movsb(op, ip, ctrl);
 #else
-          switch (ctrl)
-            {
-              case 32:
-                *op++ = *ip++;
-
-              case 31:
-                *op++ = *ip++;
-
-              case 30:
-                *op++ = *ip++;
-
-              case 29:
-                *op++ = *ip++;
-
-              case 28:
-                *op++ = *ip++;
-
-              case 27:
-                *op++ = *ip++;
-
-              case 26:
-                *op++ = *ip++;
-
-              case 25:
-                *op++ = *ip++;
-
-              case 24:
-                *op++ = *ip++;
-
-              case 23:
-                *op++ = *ip++;
-
-              case 22:
-                *op++ = *ip++;
-
-              case 21:
-                *op++ = *ip++;
-
-              case 20:
-                *op++ = *ip++;
-
-              case 19:
-                *op++ = *ip++;
-
-              case 18:
-                *op++ = *ip++;
-
-              case 17:
-                *op++ = *ip++;
-
-              case 16:
-                *op++ = *ip++;
-
-              case 15:
-                *op++ = *ip++;
-
-              case 14:
-                *op++ = *ip++;
-
-              case 13:
-                *op++ = *ip++;
-
-              case 12:
-                *op++ = *ip++;
-
-              case 11:
-                *op++ = *ip++;
-
-              case 10:
-                *op++ = *ip++;
-
-              case 9:
-                *op++ = *ip++;
+          /* Runs are up to 32 octets: a word copy pays off from about
+           * eight on.
+           */
 
-              case 8:
-                *op++ = *ip++;
-
-              case 7:
-                *op++ = *ip++;
-
-              case 6:
-                *op++ = *ip++;
-
-              case 5:
-                *op++ = *ip++;
-
-              case 4:
-                *op++ = *ip++;
-
-              case 3:
-                *op++ = *ip++;
-
-              case 2:
-                *op++ = *ip++;
-
-              case 1:
-                *op++ = *ip++;
+          if (ctrl >= 8)
+            {
+              memcpy(op, ip, ctrl);
+              op += ctrl;
+              ip += ctrl;
+            }
+          else
+            {
+              do
+                {
+                  *op++ = *ip++;
+                }
+              while (--ctrl);
             }
 #endif
         }
@@ -249,18 +169,33 @@ unsigned int lzf_decompress (FAR const void *const in_data,
                   {
                     /* Disjunct areas */
 
-                    memcpy (op, ref, len);
+                    memcpy(op, ref, len);
+                    op += len;
+                  }
+                else if (op == ref + 1)
+                  {
+                    /* Run of one octet */
+
+                    memset(op, *ref, len);
                     op += len;
                   }
                 else
                   {
-                    /* Overlapping, use octet by octet copying */
+                    /* Overlapping: the octets between ref and op are
+                     * already there, so copy them as a block.  The block
+                     * doubles with each copy.
+                     */
 
                     do
                       {
-                        *op++ = *ref++;
+                        unsigned int n = op - ref;
+
+                        n = n < len ? n : len;
+                        memcpy(op, ref, n);
+                        op  += n;
+                        len -= n;
                       }
-                    while (--len);
+                    while (len > 0);
                   }
 
                 break;
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * libs/libc/machine/arm64/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC32 instructions are optional in ARMv8.0-A, so the toolchain may
+ * not have them enabled; ARCH_HAVE_CRC32 says the core has them.
+ */
+
+#define ARM64_CRC32(insn, crc, data) \
+  __asm__ (".arch_extension crc\n" insn : "+r" (crc) : "r" (data))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   crc32 polynomial 0x04C11DB7 (bitreflected 0xEDB88320)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t data;
+
+  for (; len >= 8; len -= 8, src += 8)
+    {
+      memcpy(&data, src, 8);
+      ARM64_CRC32("crc32x %w0, %w0, %x1", crc32val, data);
+    }
+
+  for (; len > 0; len--)
+    {
+      uint32_t byte = *src++;
+      ARM64_CRC32("crc32b %w0, %w0, %w1", crc32val, byte);
+    }
+
+  return crc32val;
+}
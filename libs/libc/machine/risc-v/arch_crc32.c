@@ -0,0 +1,130 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reflected CRC of an XLEN-bit word s, as the polynomial s(x) * x^32
+ * mod P(x), by Barrett reduction:
+ *
+ *   q   = s ^ (clmul(s, CRC32_ZBC_MU) << 1)
+ *   crc = clmulr(q, CRC32_ZBC_POLY)
+ *
+ * CRC32_ZBC_MU is floor(x^(XLEN + 32) / P(x)) without its top term and
+ * CRC32_ZBC_POLY is P(x) without its top term, both bit-reflected to
+ * XLEN bits.  A part word is reduced from the top bits of s.
+ */
+
+#if __riscv_xlen == 64
+#  define CRC32_ZBC_MU      UINT64_C(0x5a72d812fb808b20)
+#  define CRC32_ZBC_POLY    UINT64_C(0xedb8832000000000)
+#else
+#  define CRC32_ZBC_MU      UINT32_C(0xfb808b20)
+#  define CRC32_ZBC_POLY    UINT32_C(0xedb88320)
+#endif
+
+#define CRC32_ZBC_XLEN      (sizeof(crc32_xlen_t) * 8)
+
+/* clmul and clmulr, as .insn so that the toolchain need not know Zbc */
+
+#define CRC32_ZBC_CLMUL(r, a, b) \
+  __asm__ (".insn r 0x33, 1, 5, %0, %1, %2" : "=r" (r) : "r" (a), "r" (b))
+#define CRC32_ZBC_CLMULR(r, a, b) \
+  __asm__ (".insn r 0x33, 2, 5, %0, %1, %2" : "=r" (r) : "r" (a), "r" (b))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if __riscv_xlen == 64
+typedef uint64_t crc32_xlen_t;
+#else
+typedef uint32_t crc32_xlen_t;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t crc32_zbc_reduce(crc32_xlen_t s)
+{
+  crc32_xlen_t t;
+
+  CRC32_ZBC_CLMUL(t, s, CRC32_ZBC_MU);
+  s ^= t << 1;
+  CRC32_ZBC_CLMULR(t, s, CRC32_ZBC_POLY);
+  return (uint32_t)(t >> (CRC32_ZBC_XLEN - 32));
+}
+
+static inline uint32_t crc32_zbc_byte(uint32_t crc32val, uint8_t data)
+{
+  crc32_xlen_t s = (crc32val ^ data) & 0xff;
+
+  return (crc32val >> 8) ^ crc32_zbc_reduce(s << (CRC32_ZBC_XLEN - 8));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   crc32 polynomial 0x04C11DB7 (bitreflected 0xEDB88320)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  for (; len > 0 && ((uintptr_t)src & (sizeof(crc32_xlen_t) - 1)) != 0;
+       len--)
+    {
+      crc32val = crc32_zbc_byte(crc32val, *src++);
+    }
+
+  for (; len >= sizeof(crc32_xlen_t); len -= sizeof(crc32_xlen_t))
+    {
+      crc32val = crc32_zbc_reduce(crc32val ^
+                                  *(FAR const crc32_xlen_t *)src);
+      src += sizeof(crc32_xlen_t);
+    }
+
+  for (; len > 0; len--)
+    {
+      crc32val = crc32_zbc_byte(crc32val, *src++);
+    }
+
+  return crc32val;
+}
@@ -23,8 +23,9 @@
 /* Note about locking: There is no locking required while only one reader
  * and one writer is using the circular buffer.
  * For multiple writer and one reader there is only a need to lock the
- * writer. And vice versa for only one writer and multiple reader there is
- * only a need to lock the reader.
+ * writer, or the writers use the circbuf_mp_xxx() functions which need no
+ * lock either. And vice versa for only one writer and multiple reader
+ * there is only a need to lock the reader.
  */
 
 /****************************************************************************
@@ -35,13 +36,127 @@
 
 #include <assert.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/lib/lib.h>
 
 /****************************************************************************
- * Private Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* Each side publishes its own index with a release store after it has
+ * written (or read) the data and loads the other side's index with
+ * acquire, so that a reader on another CPU never sees a new head before
+ * the data behind it, and a writer never reuses space still being read.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define CIRCBUF_LOAD(p)        __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define CIRCBUF_STORE(p, v)    __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#  define CIRCBUF_ADD(p, v)      __atomic_add_fetch(p, v, __ATOMIC_ACQ_REL)
+#  define CIRCBUF_CAS(p, e, d) \
+     __atomic_compare_exchange_n(p, e, d, true, __ATOMIC_ACQ_REL, \
+                                 __ATOMIC_ACQUIRE)
+#else
+#  define CIRCBUF_LOAD(p) \
+     (sizeof(size_t) == 8 ? (size_t)nx_atomic_load_8(p, __ATOMIC_ACQUIRE) : \
+                            (size_t)nx_atomic_load_4(p, __ATOMIC_ACQUIRE))
+#  define CIRCBUF_STORE(p, v) \
+     (sizeof(size_t) == 8 ? nx_atomic_store_8(p, v, __ATOMIC_RELEASE) : \
+                            nx_atomic_store_4(p, v, __ATOMIC_RELEASE))
+#  define CIRCBUF_ADD(p, v) \
+     (sizeof(size_t) == 8 ? \
+      (size_t)nx_atomic_fetch_add_8(p, v, __ATOMIC_ACQ_REL) + (v) : \
+      (size_t)nx_atomic_fetch_add_4(p, v, __ATOMIC_ACQ_REL) + (v))
+#  define CIRCBUF_CAS(p, e, d) \
+     (sizeof(size_t) == 8 ? \
+      nx_atomic_compare_exchange_8(p, e, d, true, __ATOMIC_ACQ_REL, \
+                                   __ATOMIC_ACQUIRE) : \
+      nx_atomic_compare_exchange_4(p, e, d, true, __ATOMIC_ACQ_REL, \
+                                   __ATOMIC_ACQUIRE))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: circbuf_off
+ *
+ * Description:
+ *   Return the offset in the buffer of a head or tail position, with a
+ *   mask instead of a division when the size is a power of two.
+ *
+ ****************************************************************************/
+
+static inline size_t circbuf_off(FAR struct circbuf_s *circ, size_t pos)
+{
+  if ((circ->size & (circ->size - 1)) == 0)
+    {
+      return pos & (circ->size - 1);
+    }
+
+  return pos % circ->size;
+}
+
+/****************************************************************************
+ * Name: circbuf_mp_claim
+ *
+ * Description:
+ *   Claim between min and max bytes of space for a producer, contiguous
+ *   ones only if contig is set, by moving the reservation position on
+ *   with compare and swap.
+ *
+ * Returned Value:
+ *   The number of bytes claimed, starting at *pos; zero if less than min
+ *   bytes are free.
+ *
+ ****************************************************************************/
+
+static size_t circbuf_mp_claim(FAR struct circbuf_s *circ, size_t min,
+                               size_t max, bool contig, FAR size_t *pos)
+{
+  size_t start = CIRCBUF_LOAD(&circ->reserve);
+  size_t used;
+  size_t len;
+
+  for (; ; )
+    {
+      used = start - CIRCBUF_LOAD(&circ->tail);
+      if (used > circ->size)
+        {
+          /* start went stale while the consumer moved past it */
+
+          start = CIRCBUF_LOAD(&circ->reserve);
+          continue;
+        }
+
+      len = circ->size - used;
+      if (contig && len > circ->size - circbuf_off(circ, start))
+        {
+          len = circ->size - circbuf_off(circ, start);
+        }
+
+      if (len > max)
+        {
+          len = max;
+        }
+
+      if (len < min || len == 0)
+        {
+          return 0;
+        }
+
+      if (CIRCBUF_CAS(&circ->reserve, &start, start + len))
+        {
+          break;
+        }
+    }
+
+  *pos = start;
+  return len;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,10 +196,12 @@ int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t bytes)
         }
     }
 
-  circ->base = base;
-  circ->size = bytes;
-  circ->head = 0;
-  circ->tail = 0;
+  circ->base    = base;
+  circ->size    = bytes;
+  circ->head    = 0;
+  circ->tail    = 0;
+  circ->reserve = 0;
+  circ->commit  = 0;
 
   return 0;
 }
@@ -136,10 +253,12 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
 
   lib_free(circ->base);
 
-  circ->base = tmp;
-  circ->size = bytes;
-  circ->head = len;
-  circ->tail = 0;
+  circ->base    = tmp;
+  circ->size    = bytes;
+  circ->head    = len;
+  circ->tail    = 0;
+  circ->reserve = len;
+  circ->commit  = len;
 
   return 0;
 }
@@ -158,6 +277,7 @@ void circbuf_reset(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
   circ->head = circ->tail = 0;
+  circ->reserve = circ->commit = 0;
 }
 
 /****************************************************************************
@@ -210,8 +330,14 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
+  size_t tail;
+
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+
+  /* Load tail first: head only moves on, so it is never behind it */
+
+  tail = CIRCBUF_LOAD(&circ->tail);
+  return CIRCBUF_LOAD(&circ->head) - tail;
 }
 
 /****************************************************************************
@@ -298,6 +424,8 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
+  size_t tail;
   size_t len;
   size_t off;
 
@@ -308,13 +436,15 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  tail = CIRCBUF_LOAD(&circ->tail);
+  head = CIRCBUF_LOAD(&circ->head);
+  if (head - pos > head - tail)
     {
-      pos = circ->tail;
+      pos = tail;
     }
 
-  len = circ->head - pos;
-  off = pos % circ->size;
+  len = head - pos;
+  off = circbuf_off(circ, pos);
 
   if (bytes > len)
     {
@@ -386,7 +516,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  CIRCBUF_STORE(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -423,7 +553,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  CIRCBUF_STORE(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -463,7 +593,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
     }
 
   space = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   if (bytes > space)
     {
       bytes = space;
@@ -477,7 +607,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  CIRCBUF_STORE(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -534,7 +664,7 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
     }
 
   circ->head += skip;
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   space = circ->size - off;
   if (bytes < space)
     {
@@ -571,7 +701,7 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -602,7 +732,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_used(circ);
-  off = circ->tail % circ->size;
+  off = circbuf_off(circ, circ->tail);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -628,7 +758,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  CIRCBUF_STORE(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -648,5 +778,134 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  CIRCBUF_STORE(&circ->tail, circ->tail + readsize);
+}
+
+/****************************************************************************
+ * Name: circbuf_mp_reserve
+ *
+ * Description:
+ *   Reserve contiguous space for a producer that may run concurrently with
+ *   other producers (threads, interrupt handlers or other CPUs) and one
+ *   consumer.  The producer writes the data in place and then calls
+ *   circbuf_mp_commit() with the reserved size.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   size  - The number of bytes wanted; returns the number reserved, less
+ *           than wanted if the free space is smaller or wraps around.
+ *
+ * Returned Value:
+ *   The address of the reserved space; NULL if the buffer is full.
+ *
+ ****************************************************************************/
+
+FAR void *circbuf_mp_reserve(FAR struct circbuf_s *circ, FAR size_t *size)
+{
+  size_t pos;
+
+  DEBUGASSERT(circ && size);
+
+  if (!circ->size)
+    {
+      *size = 0;
+      return NULL;
+    }
+
+  *size = circbuf_mp_claim(circ, 1, *size, true, &pos);
+  if (*size == 0)
+    {
+      return NULL;
+    }
+
+  return (FAR char *)circ->base + circbuf_off(circ, pos);
+}
+
+/****************************************************************************
+ * Name: circbuf_mp_commit
+ *
+ * Description:
+ *   Hand data written into space from circbuf_mp_reserve() over to the
+ *   consumer.  Producers never wait for each other: the data becomes
+ *   visible to the consumer once every reservation made before it has
+ *   been committed, published by whichever producer commits last.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - The number of bytes reserved.
+ *
+ ****************************************************************************/
+
+void circbuf_mp_commit(FAR struct circbuf_s *circ, size_t bytes)
+{
+  size_t commit;
+  size_t head;
+
+  DEBUGASSERT(circ);
+
+  /* Once the committed bytes add up to the reserved ones, everything up to
+   * commit is written.  Otherwise a reservation is still in progress and
+   * its commit will publish this data too.
+   */
+
+  commit = CIRCBUF_ADD(&circ->commit, bytes);
+  if (commit != CIRCBUF_LOAD(&circ->reserve))
+    {
+      return;
+    }
+
+  /* Another producer may have published a later position already */
+
+  head = CIRCBUF_LOAD(&circ->head);
+  while ((ssize_t)(commit - head) > 0 &&
+         !CIRCBUF_CAS(&circ->head, &head, commit));
+}
+
+/****************************************************************************
+ * Name: circbuf_mp_write
+ *
+ * Description:
+ *   Write data to the circular buffer from a producer that may run
+ *   concurrently with other producers and one consumer.  The data is
+ *   written as a whole or not at all, so that records from different
+ *   producers never interleave.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   src   - The data to be added.
+ *   bytes - Number of bytes to be added.
+ *
+ * Returned Value:
+ *   bytes if the data was written; zero if it does not fit.
+ *
+ ****************************************************************************/
+
+ssize_t circbuf_mp_write(FAR struct circbuf_s *circ,
+                         FAR const void *src, size_t bytes)
+{
+  size_t pos;
+  size_t off;
+  size_t len;
+
+  DEBUGASSERT(circ);
+  DEBUGASSERT(src || !bytes);
+
+  if (!circ->size || bytes == 0 ||
+      circbuf_mp_claim(circ, bytes, bytes, false, &pos) == 0)
+    {
+      return 0;
+    }
+
+  off = circbuf_off(circ, pos);
+  len = circ->size - off;
+  if (bytes < len)
+    {
+      len = bytes;
+    }
+
+  memcpy((FAR char *)circ->base + off, src, len);
+  memcpy(circ->base, (FAR const char *)src + len, bytes - len);
+  circbuf_mp_commit(circ, bytes);
+
+  return bytes;
 }
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * libs/libc/misc/lib_htable.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/hashtable.h>
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Buckets of the old array moved by each insertion during a resize.  Two
+ * is enough for the move to be done before the table is due to grow
+ * again: that takes as many insertions as the old array has buckets.
+ */
+
+#define HTABLE_MOVE_STEP    2
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: htable_move
+ *
+ * Description:
+ *   Move up to count buckets of the old array into the current one and
+ *   free the old array once it is empty.
+ *
+ ****************************************************************************/
+
+static void htable_move(FAR struct htable_s *table, uint32_t count)
+{
+  uint32_t mask = (UINT32_C(1) << table->bits) - 1;
+  uint32_t size = UINT32_C(1) << table->oldbits;
+  FAR dq_entry_t *entry;
+
+  while (count-- > 0 && table->moved < size)
+    {
+      FAR hash_head_t *bucket = &table->old[table->moved];
+
+      while ((entry = dq_remfirst(bucket)) != NULL)
+        {
+          FAR htable_node_t *node = (FAR htable_node_t *)entry;
+
+          dq_addfirst(entry, &table->buckets[node->hash & mask]);
+        }
+
+      table->moved++;
+    }
+
+  if (table->moved == size)
+    {
+      lib_free(table->old);
+      table->old     = NULL;
+      table->oldbits = 0;
+      table->moved   = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: htable_resize
+ *
+ * Description:
+ *   Start moving the nodes to an array of (1 << bits) buckets.  The table
+ *   keeps its current size if the array cannot be allocated.
+ *
+ ****************************************************************************/
+
+static void htable_resize(FAR struct htable_s *table, unsigned int bits)
+{
+  FAR hash_head_t *buckets;
+
+  buckets = lib_zalloc(sizeof(hash_head_t) << bits);
+  if (buckets == NULL)
+    {
+      return;
+    }
+
+  table->old     = table->buckets;
+  table->oldbits = table->bits;
+  table->moved   = 0;
+  table->buckets = buckets;
+  table->bits    = bits;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: htable_init
+ ****************************************************************************/
+
+void htable_init(FAR struct htable_s *table, unsigned int minbits,
+                 unsigned int maxbits)
+{
+  memset(table, 0, sizeof(*table));
+  table->bits    = minbits;
+  table->minbits = minbits;
+  table->maxbits = maxbits;
+}
+
+/****************************************************************************
+ * Name: htable_deinit
+ ****************************************************************************/
+
+void htable_deinit(FAR struct htable_s *table)
+{
+  lib_free(table->buckets);
+  lib_free(table->old);
+  htable_init(table, table->minbits, table->maxbits);
+}
+
+/****************************************************************************
+ * Name: htable_insert
+ ****************************************************************************/
+
+int htable_insert(FAR struct htable_s *table, FAR htable_node_t *node,
+                  uint32_t hash)
+{
+  size_t size;
+
+  if (table->buckets == NULL)
+    {
+      table->buckets = lib_zalloc(sizeof(hash_head_t) << table->bits);
+      if (table->buckets == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (table->old != NULL)
+    {
+      htable_move(table, HTABLE_MOVE_STEP);
+    }
+
+  node->hash = hash;
+  dq_addfirst(&node->entry, htable_bucket(table, hash));
+  table->nelems++;
+
+  /* Removal never changes the arrays, as it may be done while iterating
+   * over the table, so shrinking is also decided here.
+   */
+
+  if (table->old == NULL)
+    {
+      size = (size_t)1 << table->bits;
+      if (table->nelems > size && table->bits < table->maxbits)
+        {
+          htable_resize(table, table->bits + 1);
+        }
+      else if (table->nelems < size / 8 && table->bits > table->minbits)
+        {
+          htable_resize(table, table->bits - 1);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: htable_remove
+ ****************************************************************************/
+
+void htable_remove(FAR struct htable_s *table, FAR htable_node_t *node)
+{
+  dq_rem(&node->entry, htable_bucket(table, node->hash));
+  table->nelems--;
+}
+
+/****************************************************************************
+ * Name: htable_hashmem
+ ****************************************************************************/
+
+uint32_t htable_hashmem(FAR const void *key, size_t len, uint32_t seed)
+{
+  FAR const uint8_t *data = key;
+  uint32_t hash = seed;
+  uint32_t k;
+  size_t i;
+
+  for (i = 0; i + 4 <= len; i += 4)
+    {
+      memcpy(&k, &data[i], sizeof(k));
+      k    *= 0xcc9e2d51;
+      k     = (k << 15) | (k >> 17);
+      k    *= 0x1b873593;
+      hash ^= k;
+      hash  = (hash << 13) | (hash >> 19);
+      hash  = hash * 5 + 0xe6546b64;
+    }
+
+  k = 0;
+  switch (len & 3)
+    {
+      case 3:
+        k ^= (uint32_t)data[i + 2] << 16;
+
+        /* Fall through */
+
+      case 2:
+        k ^= (uint32_t)data[i + 1] << 8;
+
+        /* Fall through */
+
+      case 1:
+        k    ^= data[i];
+        k    *= 0xcc9e2d51;
+        k     = (k << 15) | (k >> 17);
+        k    *= 0x1b873593;
+        hash ^= k;
+    }
+
+  return htable_hash32(hash ^ (uint32_t)len, 0);
+}
@@ -26,11 +26,44 @@
 
 #include <errno.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmutex_holder_running
+ *
+ * Description:
+ *   Return true if the thread 'holder' is running on a CPU other than the
+ *   calling one.
+ *
+ ****************************************************************************/
+
+#ifdef NXMUTEX_ADAPTIVE_SPIN
+static bool nxmutex_holder_running(pid_t holder)
+{
+  FAR struct tcb_s *tcb;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcb = g_running_tasks[cpu];
+      if (cpu != this_cpu() && tcb != NULL && tcb->pid == holder)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -62,6 +95,105 @@ void nxmutex_add_backtrace(FAR mutex_t *mutex)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxmutex_spin
+ *
+ * Description:
+ *   Try to take the mutex by busy-waiting for as long as its holder is
+ *   running on another CPU, up to CONFIG_LIBC_MUTEX_SPIN_COUNT polls.
+ *   Short critical sections then complete without the two context
+ *   switches of a blocking wait.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   True if the mutex was acquired; false if the caller has to block.
+ *
+ ****************************************************************************/
+
+#ifdef NXMUTEX_ADAPTIVE_SPIN
+bool nxmutex_spin(FAR mutex_t *mutex)
+{
+  int budget = CONFIG_LIBC_MUTEX_SPIN_COUNT;
+  pid_t holder;
+
+  /* Uncontended case */
+
+  if (nxsem_trywait(&mutex->sem) >= 0)
+    {
+      return true;
+    }
+
+  /* Don't spin inside a critical section, the holder may need it to
+   * release the mutex.
+   */
+
+#ifdef CONFIG_IRQCOUNT
+  if (nxsched_self()->irqcount > 0)
+    {
+      goto out;
+    }
+#endif
+
+  while (budget-- > 0)
+    {
+      holder = nxmutex_get_holder(mutex);
+      if (holder < 0)
+        {
+          if (nxsem_trywait(&mutex->sem) >= 0)
+            {
+              atomic_fetch_add_relaxed(&mutex->spins, 1);
+              return true;
+            }
+        }
+      else if (holder == _SCHED_GETTID() ||
+               !nxmutex_holder_running(holder))
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_IRQCOUNT
+out:
+#endif
+  atomic_fetch_add_relaxed(&mutex->blocks, 1);
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmutex_get_stats
+ *
+ * Description:
+ *   This function returns the adaptive spinning counters of the mutex.
+ *
+ * Parameters:
+ *   mutex  - mutex descriptor.
+ *   spins  - Location to return the number of acquisitions that succeeded
+ *            while spinning.
+ *   blocks - Location to return the number of waits that had to block.
+ *
+ * Return Value:
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+void nxmutex_get_stats(FAR mutex_t *mutex, FAR uint32_t *spins,
+                       FAR uint32_t *blocks)
+{
+  if (spins != NULL)
+    {
+      *spins = atomic_read(&mutex->spins);
+    }
+
+  if (blocks != NULL)
+    {
+      *blocks = atomic_read(&mutex->blocks);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxmutex_init
  *
@@ -90,6 +222,11 @@ int nxmutex_init(FAR mutex_t *mutex)
       return ret;
     }
 
+#ifdef CONFIG_LIBC_MUTEX_ADAPTIVE
+  atomic_set(&mutex->spins, 0);
+  atomic_set(&mutex->blocks, 0);
+#endif
+
 #ifdef CONFIG_PRIORITY_INHERITANCE
   nxsem_set_protocol(&mutex->sem, SEM_TYPE_MUTEX | SEM_PRIO_INHERIT);
 #else
@@ -149,7 +286,11 @@ int nxmutex_ticklock(FAR mutex_t *mutex, uint32_t delay)
 
   /* Wait until we get the lock or until the timeout expires */
 
-  if (delay)
+  if (delay && nxmutex_spin(mutex))
+    {
+      ret = OK;
+    }
+  else if (delay)
     {
       ret = nxsem_tickwait(&mutex->sem, delay);
     }
@@ -198,7 +339,11 @@ int nxmutex_clocklock(FAR mutex_t *mutex, clockid_t clockid,
 
   /* Wait until we get the lock or until the timeout expires */
 
-  if (abstime)
+  if (nxmutex_spin(mutex))
+    {
+      ret = OK;
+    }
+  else if (abstime)
     {
       ret = nxsem_clockwait(&mutex->sem, clockid, abstime);
     }
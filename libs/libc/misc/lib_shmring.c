@@ -0,0 +1,431 @@
+/****************************************************************************
+ * libs/libc/misc/lib_shmring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/shmring.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_slot
+ ****************************************************************************/
+
+static FAR struct shmring_slot_s *shmring_slot(FAR struct shmring_s *ring,
+                                               int32_t pos)
+{
+  return (FAR struct shmring_slot_s *)
+    (ring->slots + ((uint32_t)pos & ring->mask) * ring->slotsize);
+}
+
+/****************************************************************************
+ * Name: shmring_trysend
+ *
+ * Description:
+ *   Claim the slot at the head, if it has been received since the ring
+ *   went round, then fill it and hand it to the receivers.
+ *
+ ****************************************************************************/
+
+static ssize_t shmring_trysend(FAR struct shmring_s *ring,
+                               FAR const void *buf, size_t len)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  FAR struct shmring_slot_s *slot;
+  int32_t pos = atomic_read(&hdr->head);
+  int32_t diff;
+
+  for (; ; )
+    {
+      slot = shmring_slot(ring, pos);
+      diff = (int32_t)((uint32_t)atomic_read_acquire(&slot->seq) -
+                       (uint32_t)pos);
+      if (diff == 0)
+        {
+          if (atomic_try_cmpxchg_relaxed(&hdr->head, &pos,
+                                         (int32_t)((uint32_t)pos + 1)))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          return -EAGAIN;
+        }
+      else
+        {
+          pos = atomic_read(&hdr->head);
+        }
+    }
+
+  memcpy(slot->data, buf, len);
+  slot->len = len;
+  atomic_set_release(&slot->seq, (int32_t)((uint32_t)pos + 1));
+  return len;
+}
+
+/****************************************************************************
+ * Name: shmring_tryrecv
+ *
+ * Description:
+ *   Claim the slot at the tail, if it has been sent, then empty it and
+ *   hand it to the senders of the next round.
+ *
+ ****************************************************************************/
+
+static ssize_t shmring_tryrecv(FAR struct shmring_s *ring, FAR void *buf,
+                               size_t len)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  FAR struct shmring_slot_s *slot;
+  int32_t pos = atomic_read(&hdr->tail);
+  int32_t diff;
+  size_t nread;
+
+  for (; ; )
+    {
+      slot = shmring_slot(ring, pos);
+      diff = (int32_t)((uint32_t)atomic_read_acquire(&slot->seq) -
+                       ((uint32_t)pos + 1));
+      if (diff == 0)
+        {
+          if (slot->len > len)
+            {
+              return -EMSGSIZE;
+            }
+
+          if (atomic_try_cmpxchg_relaxed(&hdr->tail, &pos,
+                                         (int32_t)((uint32_t)pos + 1)))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          return -EAGAIN;
+        }
+      else
+        {
+          pos = atomic_read(&hdr->tail);
+        }
+    }
+
+  nread = slot->len;
+  memcpy(buf, slot->data, nread);
+  atomic_set_release(&slot->seq,
+                     (int32_t)((uint32_t)pos + ring->mask + 1));
+  return nread;
+}
+
+/****************************************************************************
+ * Name: shmring_blocked
+ *
+ * Description:
+ *   Return true if the ring is full for a sender, or empty for a receiver.
+ *
+ ****************************************************************************/
+
+static bool shmring_blocked(FAR struct shmring_s *ring, bool send)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  int32_t pos;
+  int32_t seq;
+
+  if (send)
+    {
+      pos = atomic_read(&hdr->head);
+      seq = atomic_read_acquire(&shmring_slot(ring, pos)->seq);
+      return (int32_t)((uint32_t)seq - (uint32_t)pos) < 0;
+    }
+  else
+    {
+      pos = atomic_read(&hdr->tail);
+      seq = atomic_read_acquire(&shmring_slot(ring, pos)->seq);
+      return (int32_t)((uint32_t)seq - ((uint32_t)pos + 1)) < 0;
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_wait
+ *
+ * Description:
+ *   Sleep until the other side wakes the waiters up.  The waiter is counted
+ *   before the ring is checked again, and the other side reads the count
+ *   after it changed the ring, so either the check sees the change or the
+ *   other side sees the waiter.  The futex word, read before both, catches
+ *   a wake up that comes before the sleep.
+ *
+ ****************************************************************************/
+
+static int shmring_wait(FAR struct shmring_s *ring, FAR atomic_t *waiters,
+                        FAR atomic_t *seq, bool send, int timeout)
+{
+  struct shmring_wait_s wait;
+  int ret = OK;
+
+  wait.addr    = seq;
+  wait.val     = atomic_read(seq);
+  wait.timeout = timeout;
+
+  atomic_fetch_add(waiters, 1);
+
+  if (shmring_blocked(ring, send))
+    {
+      ret = ioctl(ring->fd, FIOC_SHMWAIT, (unsigned long)(uintptr_t)&wait);
+      if (ret < 0)
+        {
+          ret = -get_errno();
+        }
+    }
+
+  atomic_fetch_sub(waiters, 1);
+
+  /* The word changed before the sleep: check the ring again */
+
+  return ret == -EAGAIN ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: shmring_wake
+ *
+ * Description:
+ *   Wake the waiters of the other side up, if there are any: the system
+ *   call is only made when the ring was seen empty, or full, by them.  The
+ *   senders and the receivers wait on the same object, so all of them are
+ *   woken up and those that cannot go on sleep again.
+ *
+ ****************************************************************************/
+
+static void shmring_wake(FAR struct shmring_s *ring, FAR atomic_t *waiters,
+                         FAR atomic_t *seq)
+{
+  if (atomic_fetch_add(waiters, 0) > 0)
+    {
+      atomic_fetch_add(seq, 1);
+      ioctl(ring->fd, FIOC_SHMWAKE, INT_MAX);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_open
+ ****************************************************************************/
+
+int shmring_open(FAR struct shmring_s *ring, FAR const char *name,
+                 int oflags, uint32_t msgsize, uint32_t nslots)
+{
+  FAR struct shmring_hdr_s *hdr;
+  bool create = (oflags & O_EXCL) != 0;
+  struct stat st;
+  size_t size;
+  uint32_t i;
+  int ret;
+
+  if (create && (msgsize == 0 || nslots == 0 ||
+                 (nslots & (nslots - 1)) != 0))
+    {
+      return -EINVAL;
+    }
+
+  ring->fd = shm_open(name, oflags | O_RDWR, 0666);
+  if (ring->fd < 0)
+    {
+      return -get_errno();
+    }
+
+  if (create)
+    {
+      size = SHMRING_SIZE(msgsize, nslots);
+      ret  = ftruncate(ring->fd, size);
+    }
+  else
+    {
+      ret  = fstat(ring->fd, &st);
+      size = st.st_size;
+    }
+
+  if (ret < 0)
+    {
+      ret = -get_errno();
+      goto errout_with_fd;
+    }
+  else if (size < sizeof(struct shmring_hdr_s))
+    {
+      ret = -EAGAIN;
+      goto errout_with_fd;
+    }
+
+  hdr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+  if (hdr == MAP_FAILED)
+    {
+      ret = -get_errno();
+      goto errout_with_fd;
+    }
+
+  if (create)
+    {
+      hdr->msgsize = msgsize;
+      hdr->nslots  = nslots;
+    }
+  else if (atomic_read_acquire(&hdr->magic) != SHMRING_MAGIC)
+    {
+      ret = -EAGAIN;
+      goto errout_with_map;
+    }
+  else if (size < SHMRING_SIZE(hdr->msgsize, hdr->nslots))
+    {
+      ret = -EINVAL;
+      goto errout_with_map;
+    }
+
+  ring->hdr      = hdr;
+  ring->slots    = (FAR uint8_t *)(hdr + 1);
+  ring->size     = size;
+  ring->mask     = hdr->nslots - 1;
+  ring->slotsize = SHMRING_SLOTSIZE(hdr->msgsize);
+
+  if (create)
+    {
+      /* The slot of position i is free for the sender of that position */
+
+      for (i = 0; i < nslots; i++)
+        {
+          atomic_set(&shmring_slot(ring, i)->seq, i);
+        }
+
+      atomic_set_release(&hdr->magic, SHMRING_MAGIC);
+    }
+
+  return OK;
+
+errout_with_map:
+  munmap(hdr, size);
+
+errout_with_fd:
+  close(ring->fd);
+  ring->fd = -1;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmring_close
+ ****************************************************************************/
+
+void shmring_close(FAR struct shmring_s *ring)
+{
+  munmap(ring->hdr, ring->size);
+  close(ring->fd);
+  ring->hdr = NULL;
+  ring->fd  = -1;
+}
+
+/****************************************************************************
+ * Name: shmring_send
+ ****************************************************************************/
+
+ssize_t shmring_send(FAR struct shmring_s *ring, FAR const void *buf,
+                     size_t len, int timeout)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  ssize_t ret;
+
+  if (len > hdr->msgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  for (; ; )
+    {
+      ret = shmring_trysend(ring, buf, len);
+      if (ret != -EAGAIN || timeout == 0)
+        {
+          break;
+        }
+
+      ret = shmring_wait(ring, &hdr->spacewaiters, &hdr->spaceseq, true,
+                         timeout);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      shmring_wake(ring, &hdr->datawaiters, &hdr->dataseq);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmring_recv
+ ****************************************************************************/
+
+ssize_t shmring_recv(FAR struct shmring_s *ring, FAR void *buf,
+                     size_t len, int timeout)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  ssize_t ret;
+
+  for (; ; )
+    {
+      ret = shmring_tryrecv(ring, buf, len);
+      if (ret != -EAGAIN || timeout == 0)
+        {
+          break;
+        }
+
+      ret = shmring_wait(ring, &hdr->datawaiters, &hdr->dataseq, false,
+                         timeout);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      shmring_wake(ring, &hdr->spacewaiters, &hdr->spaceseq);
+    }
+
+  return ret;
+}
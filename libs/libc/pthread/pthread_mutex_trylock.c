@@ -0,0 +1,67 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_trylock.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_trylock
+ *
+ * Description:
+ *   The function pthread_mutex_trylock() is identical to
+ *   pthread_mutex_lock() except that if the mutex object referenced by the
+ *   mutex is currently locked (by any thread, including the current
+ *   thread), the call returns immediately with the errno EBUSY.
+ *
+ *   A free mutex is taken in user space with an atomic compare-and-swap.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be locked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.  Note that the errno EINTR
+ *   is never returned by pthread_mutex_trylock().
+ *
+ ****************************************************************************/
+
+int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+{
+#ifdef PTHREAD_MUTEX_FASTPATH
+  if (mutex != NULL && pthread_mutex_fastlock(mutex))
+    {
+      return OK;
+    }
+#endif
+
+  return pthread_mutex_trylock_slow(mutex);
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_unlock.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   The pthread_mutex_unlock() function releases the mutex object referenced
+ *   by mutex.
+ *
+ *   A mutex held by the calling thread with no waiters is released in user
+ *   space with an atomic compare-and-swap.  The kernel is only entered if a
+ *   waiting thread has to be woken up.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+#ifdef PTHREAD_MUTEX_FASTPATH
+  if (mutex != NULL && pthread_mutex_fastunlock(mutex))
+    {
+      return OK;
+    }
+#endif
+
+  return pthread_mutex_unlock_slow(mutex);
+}
@@ -33,6 +33,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <string.h>
 #include <stdlib.h>
 #include <regex.h>
@@ -40,10 +42,39 @@
 #include <stdint.h>
 #include <ctype.h>
 
+#include <nuttx/mutex.h>
+
 #include "tre.h"
 
 #include <assert.h>
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_LIBC_REGEX_CACHE > 0
+/* A compiled pattern kept for regcomp() to share */
+
+struct tre_cache_s
+{
+  char       *regex;
+  int        cflags;
+  size_t     nsub;
+  tre_tnfa_t *tnfa;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_LIBC_REGEX_CACHE > 0
+/* Most recently used first */
+
+static struct tre_cache_s g_tre_cache[CONFIG_LIBC_REGEX_CACHE];
+static mutex_t g_tre_cache_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /* from tre-compile.h
  */
 
@@ -3660,7 +3691,60 @@ static reg_errcode_t tre_ast_to_tnfa(tre_ast_node_t *node,
     }                        \
   while (/* CONSTCOND */ 0)
 
-int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
+/* Bitmap of the characters below TRE_FIRSTPOS_MAX that a match can start
+ * with, for the parallel matcher to skip ahead while no match is in
+ * progress.  None if the empty string matches.
+ */
+
+static void tre_firstpos_chars(tre_tnfa_t *tnfa)
+{
+  tre_tnfa_transition_t *init;
+  tre_tnfa_transition_t *trans;
+  tre_cint_t            c;
+  char                  *chars;
+
+  if (tnfa->have_backrefs)
+    {
+      return;
+    }
+
+  for (init = tnfa->initial; init->state; init++)
+    {
+      if (init->state == tnfa->final)
+        {
+          return;
+        }
+    }
+
+  /* The memory is only an optimization */
+
+  chars = xcalloc(1, TRE_FIRSTPOS_MAX / 8);
+  if (chars == NULL)
+    {
+      return;
+    }
+
+  /* The assertions of the transitions only narrow the set further */
+
+  for (init = tnfa->initial; init->state; init++)
+    {
+      for (trans = init->state; trans->state; trans++)
+        {
+          for (c = trans->code_min;
+               c <= trans->code_max && c < TRE_FIRSTPOS_MAX; c++)
+            {
+              chars[c >> 3] |= 1 << (c & 7);
+            }
+        }
+    }
+
+  tnfa->firstpos_chars = chars;
+}
+
+static void tre_regfree(regex_t *preg);
+
+static int tre_regcomp(regex_t *restrict preg, const char *restrict regex,
+                       int cflags)
 {
   tre_stack_t           *stack;
   tre_ast_node_t        *tree, *tmp_ast_l, *tmp_ast_r;
@@ -3922,6 +4006,9 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->final           = transitions + offs[tree->lastpos[0].position];
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
+  tnfa->refs            = 1;
+
+  tre_firstpos_chars(tnfa);
 
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
@@ -3952,11 +4039,11 @@ error_exit:
     }
 
   preg->TRE_REGEX_T_FIELD = (void *)tnfa;
-  regfree(preg);
+  tre_regfree(preg);
   return errcode;
 }
 
-void regfree(regex_t *preg)
+static void tre_regfree(regex_t *preg)
 {
   tre_tnfa_t            *tnfa;
   unsigned int          i;
@@ -4032,3 +4119,110 @@ void regfree(regex_t *preg)
 
   xfree(tnfa);
 }
+
+#if CONFIG_LIBC_REGEX_CACHE > 0
+/* Drop a reference to a compiled pattern, with the cache lock held. */
+
+static void tre_cache_put(tre_tnfa_t *tnfa)
+{
+  regex_t preg;
+
+  if (--tnfa->refs == 0)
+    {
+      preg.TRE_REGEX_T_FIELD = (void *)tnfa;
+      tre_regfree(&preg);
+    }
+}
+#endif
+
+int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
+{
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  struct tre_cache_s    entry;
+  tre_tnfa_t            *tnfa;
+  size_t                len;
+  int                   ret;
+  int                   i;
+
+  /* Share the compiled pattern if the same one was compiled recently: it
+   * is only read by regexec().
+   */
+
+  nxmutex_lock(&g_tre_cache_lock);
+  for (i = 0; i < CONFIG_LIBC_REGEX_CACHE && g_tre_cache[i].regex; i++)
+    {
+      if (g_tre_cache[i].cflags == cflags &&
+          strcmp(g_tre_cache[i].regex, regex) == 0)
+        {
+          entry = g_tre_cache[i];
+          memmove(&g_tre_cache[1], &g_tre_cache[0], i * sizeof(entry));
+          g_tre_cache[0] = entry;
+          entry.tnfa->refs++;
+          nxmutex_unlock(&g_tre_cache_lock);
+
+          preg->re_nsub           = entry.nsub;
+          preg->TRE_REGEX_T_FIELD = (void *)entry.tnfa;
+          return REG_OK;
+        }
+    }
+
+  nxmutex_unlock(&g_tre_cache_lock);
+
+  ret = tre_regcomp(preg, regex, cflags);
+  if (ret != REG_OK)
+    {
+      return ret;
+    }
+
+  /* Failing to cache the pattern is not an error */
+
+  len         = strlen(regex) + 1;
+  entry.regex = xmalloc(len);
+  if (entry.regex == NULL)
+    {
+      return REG_OK;
+    }
+
+  memcpy(entry.regex, regex, len);
+  tnfa          = (void *)preg->TRE_REGEX_T_FIELD;
+  entry.cflags  = cflags;
+  entry.nsub    = preg->re_nsub;
+  entry.tnfa    = tnfa;
+
+  /* Insert it as the most recently used, evicting the least recently
+   * used one.  Patterns still in use stay until their regfree().
+   */
+
+  nxmutex_lock(&g_tre_cache_lock);
+  i = CONFIG_LIBC_REGEX_CACHE - 1;
+  if (g_tre_cache[i].regex != NULL)
+    {
+      xfree(g_tre_cache[i].regex);
+      tre_cache_put(g_tre_cache[i].tnfa);
+    }
+
+  memmove(&g_tre_cache[1], &g_tre_cache[0], i * sizeof(entry));
+  g_tre_cache[0] = entry;
+  tnfa->refs++;
+  nxmutex_unlock(&g_tre_cache_lock);
+  return REG_OK;
+#else
+  return tre_regcomp(preg, regex, cflags);
+#endif
+}
+
+void regfree(regex_t *preg)
+{
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  tre_tnfa_t *tnfa = (void *)preg->TRE_REGEX_T_FIELD;
+
+  if (tnfa != NULL)
+    {
+      nxmutex_lock(&g_tre_cache_lock);
+      tre_cache_put(tnfa);
+      nxmutex_unlock(&g_tre_cache_lock);
+    }
+#else
+  tre_regfree(preg);
+#endif
+}
@@ -305,6 +305,31 @@ static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
   reach_next_i = reach_next;
   while (1)
     {
+      /* While no match is in progress, skip the characters that no match
+       * starts with rather than try the initial states on each.
+       */
+
+      if (match_eo < 0 && reach_next_i == reach_next &&
+          tnfa->firstpos_chars != NULL)
+        {
+          while (next_c != L'\0' && !tre_firstpos_test(tnfa, next_c))
+            {
+              /* A byte below 0x80 is a character of its own */
+
+              if ((unsigned char)*str_byte - 1u < 0x7fu)
+                {
+                  prev_c        = next_c;
+                  pos           += pos_add_next;
+                  next_c        = (unsigned char)*str_byte++;
+                  pos_add_next  = 1;
+                }
+              else
+                {
+                  GET_NEXT_WCHAR();
+                }
+            }
+        }
+
       /* If no match found yet, add the initial states to `reach_next'. */
 
       if (match_eo < 0)
@@ -211,8 +211,19 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+  int refs;
 };
 
+/* The characters below this are in the firstpos_chars bitmap; any other
+ * one may start a match.
+ */
+
+#define TRE_FIRSTPOS_MAX    256
+
+#define tre_firstpos_test(tnfa, c)                            \
+  ((tre_cint_t)(c) >= TRE_FIRSTPOS_MAX ||                     \
+   ((tnfa)->firstpos_chars[(tre_cint_t)(c) >> 3] & (1 << ((c) & 7))))
+
 /* from tre-mem.h: */
 
 #define TRE_MEM_BLOCK_SIZE  1024
@@ -107,6 +107,19 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
     {
       double y;
 
+#if defined(CONFIG_LIBC_DTOA_FAST) && DBL_MANT_DIG == 53
+      /* Most values are done exactly by the integer engine, the scaling
+       * below is only needed when it cannot decide the last digit.
+       */
+
+      i = __dtoa_fast(x, dtoa, max_digits, max_decimals);
+      if (i > 0)
+        {
+          dtoa->flags = flags;
+          return i;
+        }
+#endif
+
       exp = MIN_MANT_EXP;
 
       /* Bring x within range MIN_MANT <= x < MAX_MANT while computing
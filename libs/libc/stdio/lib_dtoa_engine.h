@@ -162,6 +162,10 @@
 
 #define DTOA_ROUND_NUM        (DBL_DIG + 1)
 
+/* Decimal exponent of the first entry of g_dtoa_powers */
+
+#define DTOA_POWER_MIN_EXP    (-348)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -173,6 +177,15 @@ struct dtoa_s
   char digits[DTOA_MAX_DIG + 1];
 };
 
+#ifdef CONFIG_LIBC_DTOA_FAST
+struct dtoa_power_s
+{
+  uint64_t f;  /* Normalized significand, top bit set */
+  int16_t  e;  /* Binary exponent, the power is f * 2^e */
+  int16_t  k;  /* Decimal exponent */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -181,6 +194,13 @@ extern const double g_dtoa_scale_up[];
 extern const double g_dtoa_scale_down[];
 extern const double g_dtoa_round[];
 
+#ifdef CONFIG_LIBC_DTOA_FAST
+extern const struct dtoa_power_s g_dtoa_powers[];
+#ifdef CONFIG_LIBC_DTOA_FAST_SMALLTABLE
+extern const struct dtoa_power_s g_dtoa_powers_step[];
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -188,4 +208,9 @@ extern const double g_dtoa_round[];
 int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
                   int max_decimals);
 
+#ifdef CONFIG_LIBC_DTOA_FAST
+int __dtoa_fast(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                int max_decimals);
+#endif
+
 #endif /* __LIBS_LIBC_STDIO_LIB_DTOA_ENGINE_H */
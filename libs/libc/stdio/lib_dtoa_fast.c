@@ -0,0 +1,371 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_dtoa_fast.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <sys/param.h>
+
+#include "lib_dtoa_engine.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The scaled value keeps its binary point between these bit positions, so
+ * that the integral part fits in 32 bits and there is room to multiply the
+ * fractional part by 10.
+ */
+
+#define DTOA_ALPHA            (-60)
+#define DTOA_GAMMA            (-32)
+
+/* Upper bound of the error of the scaled value, in units of its last bit.
+ * The reduced table adds one more rounded multiplication.
+ */
+
+#ifdef CONFIG_LIBC_DTOA_FAST_SMALLTABLE
+#  define DTOA_ERROR_UNITS    2
+#else
+#  define DTOA_ERROR_UNITS    1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A floating value f * 2^e with a 64-bit significand */
+
+struct dtoa_fp_s
+{
+  uint64_t f;
+  int e;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_dtoa_pow10[] =
+{
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  1000000000
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dtoa_multiply
+ *
+ * Description:
+ *   Return the upper 64 bits of the 128-bit product, rounded to nearest.
+ *   Done with 32-bit halves so that 32-bit targets need no helper.
+ *
+ ****************************************************************************/
+
+static struct dtoa_fp_s dtoa_multiply(FAR const struct dtoa_fp_s *x,
+                                      FAR const struct dtoa_fp_s *y)
+{
+  struct dtoa_fp_s r;
+  uint64_t a = x->f >> 32;
+  uint64_t b = x->f & UINT32_MAX;
+  uint64_t c = y->f >> 32;
+  uint64_t d = y->f & UINT32_MAX;
+  uint64_t ac = a * c;
+  uint64_t bc = b * c;
+  uint64_t ad = a * d;
+  uint64_t bd = b * d;
+  uint64_t tmp;
+
+  tmp  = (bd >> 32) + (ad & UINT32_MAX) + (bc & UINT32_MAX);
+  tmp += 1u << 31;
+
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e = x->e + y->e + 64;
+  return r;
+}
+
+/****************************************************************************
+ * Name: dtoa_cached_power
+ *
+ * Description:
+ *   Find the power 10^k such that multiplying a normalized value with
+ *   binary exponent e by it brings the exponent into [DTOA_ALPHA,
+ *   DTOA_GAMMA].  Returns k.
+ *
+ ****************************************************************************/
+
+static int dtoa_cached_power(int e, FAR struct dtoa_fp_s *power)
+{
+  FAR const struct dtoa_power_s *entry;
+  int32_t m = DTOA_ALPHA - (e + 64) + 63;
+  int index;
+  int k;
+
+  /* k = ceil(m * log10(2)), 78913 / 2^18 approximates log10(2) */
+
+  k = (m * 78913 + (1 << 18) - 1) >> 18;
+  index = (k - DTOA_POWER_MIN_EXP - 1) / 8 + 1;
+
+#ifdef CONFIG_LIBC_DTOA_FAST_SMALLTABLE
+  entry = &g_dtoa_powers[index / 4];
+  power->f = entry->f;
+  power->e = entry->e;
+  if ((index & 3) != 0)
+    {
+      FAR const struct dtoa_power_s *step = &g_dtoa_powers_step[
+                                                    (index & 3) - 1];
+      struct dtoa_fp_s scale;
+
+      scale.f = step->f;
+      scale.e = step->e;
+      *power = dtoa_multiply(power, &scale);
+      if ((power->f >> 63) == 0)
+        {
+          power->f <<= 1;
+          power->e--;
+        }
+    }
+
+  return entry->k + 8 * (index & 3);
+#else
+  entry = &g_dtoa_powers[index];
+  power->f = entry->f;
+  power->e = entry->e;
+  return entry->k;
+#endif
+}
+
+/****************************************************************************
+ * Name: dtoa_round_weed
+ *
+ * Description:
+ *   The digits in buffer stand for the scaled value minus rest, with rest
+ *   below ten_kappa, the weight of the last digit.  The true value may be
+ *   off by unit.  Round the last digit to nearest if that decision does
+ *   not depend on the error; return false otherwise.
+ *
+ ****************************************************************************/
+
+static bool dtoa_round_weed(FAR char *buffer, int length, uint64_t rest,
+                            uint64_t ten_kappa, uint64_t unit,
+                            FAR int *kappa)
+{
+  int i;
+
+  if (unit >= ten_kappa || ten_kappa - unit <= unit)
+    {
+      return false;
+    }
+
+  /* 2 * (rest + unit) <= 10^kappa: round down */
+
+  if (ten_kappa - rest > rest && ten_kappa - 2 * rest >= 2 * unit)
+    {
+      return true;
+    }
+
+  /* 2 * (rest - unit) >= 10^kappa: round up */
+
+  if (rest > unit && ten_kappa - (rest - unit) <= rest - unit)
+    {
+      buffer[length - 1]++;
+      for (i = length - 1; i > 0 && buffer[i] == '0' + 10; i--)
+        {
+          buffer[i] = '0';
+          buffer[i - 1]++;
+        }
+
+      if (buffer[0] == '0' + 10)
+        {
+          buffer[0] = '1';
+          (*kappa)++;
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __dtoa_fast
+ *
+ * Description:
+ *   Fixed precision conversion of a positive, finite, non-zero double with
+ *   64-bit integer arithmetic: the value is scaled by a cached power of
+ *   ten and the digits are cut from the fixed point result (Grisu).  The
+ *   arguments and result are those of __dtoa_engine().
+ *
+ * Returned Value:
+ *   The number of digits generated, or -1 if the scaling error leaves the
+ *   rounding of the last digit undecided (exact ties included).  The
+ *   caller then falls back to __dtoa_engine().
+ *
+ ****************************************************************************/
+
+int __dtoa_fast(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                int max_decimals)
+{
+  struct dtoa_fp_s w;
+  struct dtoa_fp_s power;
+  uint64_t bits;
+  uint64_t one;
+  uint64_t fractionals;
+  uint64_t error = DTOA_ERROR_UNITS;
+  uint32_t integrals;
+  uint32_t divisor;
+  int length = 0;
+  int kappa;
+  int k;
+  int exp;
+
+  /* Split the IEEE 754 double and normalize it */
+
+  memcpy(&bits, &x, sizeof(bits));
+  w.f = bits & ((UINT64_C(1) << 52) - 1);
+  w.e = (int)((bits >> 52) & 0x7ff);
+  if (w.e != 0)
+    {
+      w.f |= UINT64_C(1) << 52;
+      w.e -= 1075;
+    }
+  else
+    {
+      w.e = -1074;
+    }
+
+  while ((w.f >> 63) == 0)
+    {
+      w.f <<= 1;
+      w.e--;
+    }
+
+  k = dtoa_cached_power(w.e, &power);
+  w = dtoa_multiply(&w, &power);
+
+  one = UINT64_C(1) << -w.e;
+  integrals = (uint32_t)(w.f >> -w.e);
+  fractionals = w.f & (one - 1);
+
+  /* integrals is at least 1 as the product keeps one of its top two bits */
+
+  kappa = 1;
+  while (kappa < 10 && integrals >= g_dtoa_pow10[kappa])
+    {
+      kappa++;
+    }
+
+  exp = kappa - 1 - k;
+
+  if (max_decimals != 0)
+    {
+      max_digits = MIN(max_digits, max_decimals + MAX(exp + 1, 0));
+    }
+
+  if (max_digits <= 0 || max_digits > DTOA_MAX_DIG)
+    {
+      return -1;
+    }
+
+  /* Integral digits */
+
+  divisor = g_dtoa_pow10[kappa - 1];
+  while (kappa > 0)
+    {
+      dtoa->digits[length++] = integrals / divisor + '0';
+      integrals %= divisor;
+      kappa--;
+
+      if (length == max_digits)
+        {
+          if (!dtoa_round_weed(dtoa->digits, length,
+                               ((uint64_t)integrals << -w.e) + fractionals,
+                               (uint64_t)divisor << -w.e, error, &kappa))
+            {
+              return -1;
+            }
+
+          goto done;
+        }
+
+      divisor /= 10;
+    }
+
+  /* Fractional digits, as long as the error leaves them meaningful */
+
+  while (length < max_digits && fractionals > error)
+    {
+      fractionals *= 10;
+      error *= 10;
+      dtoa->digits[length++] = (fractionals >> -w.e) + '0';
+      fractionals &= one - 1;
+      kappa--;
+    }
+
+  if (length == max_digits)
+    {
+      if (!dtoa_round_weed(dtoa->digits, length, fractionals, one, error,
+                           &kappa))
+        {
+          return -1;
+        }
+    }
+  else
+    {
+      /* What is left is within the error, as for exact values like 0.5 or
+       * 100.  The value is the digits so far followed by zeros as long as
+       * the rest stays below half a unit of the last requested digit.
+       */
+
+      fractionals += error;
+      while (length < max_digits && fractionals < one / 10)
+        {
+          fractionals *= 10;
+          dtoa->digits[length++] = '0';
+          kappa--;
+        }
+
+      if (length < max_digits || fractionals >= one / 2)
+        {
+          return -1;
+        }
+    }
+
+done:
+
+  /* A carry into a new leading digit moves the exponent up by one */
+
+  dtoa->digits[length] = '\0';
+  dtoa->exp = kappa - k + length - 1;
+  return length;
+}
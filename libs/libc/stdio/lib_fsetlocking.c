@@ -0,0 +1,67 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_fsetlocking.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdio_ext.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __fsetlocking
+ ****************************************************************************/
+
+int __fsetlocking(FAR FILE *stream, int type)
+{
+  int ret;
+
+  /* Use the mutex directly: funlockfile() would skip the unlock once the
+   * type is FSETLOCKING_BYCALLER.
+   */
+
+  nxrmutex_lock(&stream->fs_lock);
+
+  ret = (stream->fs_flags & __FS_FLAG_NOLOCK) != 0 ?
+        FSETLOCKING_BYCALLER : FSETLOCKING_INTERNAL;
+
+  if (type == FSETLOCKING_BYCALLER)
+    {
+      stream->fs_flags |= __FS_FLAG_NOLOCK;
+    }
+  else if (type == FSETLOCKING_INTERNAL)
+    {
+      stream->fs_flags &= ~__FS_FLAG_NOLOCK;
+    }
+
+  nxrmutex_unlock(&stream->fs_lock);
+  return ret;
+}
@@ -26,6 +26,14 @@
 
 #include <stdio.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* stdio.h may provide an inline version; this is the library function */
+
+#undef getc_unlocked
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
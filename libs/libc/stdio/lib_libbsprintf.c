@@ -27,9 +27,28 @@
 #include <nuttx/streams.h>
 
 #include <string.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Store one argument unless the buffer is full */
+
+#define LIB_BPACK(member, type) \
+  do \
+    { \
+      if (offset + sizeof(var->member) > buflen) \
+        { \
+          return offset; \
+        } \
+      var->member = (type)va_arg(ap, type); \
+      offset += sizeof(var->member); \
+    } \
+  while (0)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -190,7 +209,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
           ret += lib_sprintf(s, fmtstr, var->p);
           infmt = false;
         }
-      else if (c == '.')
+      else if (c == '.' && *fmt != '*')
         {
           prec = fmt;
         }
@@ -198,3 +217,194 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: lib_vbpack
+ *
+ * Description:
+ *   The inverse of lib_bsprintf(): store the arguments consumed by fmt in
+ *   buf, in the one-byte aligned layout lib_bsprintf() reads them back
+ *   from.  Strings are copied, so the buffer can be formatted later.
+ *
+ * Returned Value:
+ *   The number of bytes stored.  Arguments that do not fit are dropped.
+ *
+ ****************************************************************************/
+
+size_t lib_vbpack(FAR void *buf, size_t buflen, FAR const IPTR char *fmt,
+                  va_list ap)
+{
+  begin_packed_struct union
+    {
+      char c;
+      short int si;
+      int i;
+      long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+      long long ll;
+#endif
+      intmax_t im;
+      size_t sz;
+      ptrdiff_t pd;
+      uintptr_t p;
+#ifdef CONFIG_HAVE_DOUBLE
+      float f;
+      double d;
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+      long double ld;
+#  endif
+#endif
+    }
+
+  end_packed_struct *var;
+  FAR const char *prec = NULL;
+  FAR char *data = buf;
+  bool infmt = false;
+  size_t offset = 0;
+  char c;
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (c != '%' && !infmt)
+        {
+          continue;
+        }
+
+      infmt = true;
+      var = (FAR void *)(data + offset);
+
+      if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              LIB_BPACK(im, intmax_t);
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              LIB_BPACK(ll, long long);
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              LIB_BPACK(l, long);
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              LIB_BPACK(sz, size_t);
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              LIB_BPACK(pd, ptrdiff_t);
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              if (offset + sizeof(var->c) > buflen)
+                {
+                  return offset;
+                }
+
+              var->c = (char)va_arg(ap, int);
+              offset += sizeof(var->c);
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              if (offset + sizeof(var->si) > buflen)
+                {
+                  return offset;
+                }
+
+              var->si = (short int)va_arg(ap, int);
+              offset += sizeof(var->si);
+            }
+          else
+            {
+              LIB_BPACK(i, int);
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              if (offset + sizeof(var->f) > buflen)
+                {
+                  return offset;
+                }
+
+              var->f = (float)va_arg(ap, double);
+              offset += sizeof(var->f);
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              LIB_BPACK(ld, long double);
+            }
+#  endif
+          else
+            {
+              LIB_BPACK(d, double);
+            }
+
+          infmt = false;
+#endif
+        }
+      else if (c == '*')
+        {
+          LIB_BPACK(i, int);
+        }
+      else if (c == 's')
+        {
+          FAR const char *value = va_arg(ap, FAR const char *);
+          size_t len;
+
+          if (prec != NULL)
+            {
+              /* lib_bsprintf() skips exactly the precision */
+
+              len = strtol(prec, NULL, 10);
+              if (offset + len > buflen)
+                {
+                  return offset;
+                }
+
+              strncpy(data + offset, value, len);
+              prec = NULL;
+            }
+          else
+            {
+              len = strlen(value) + 1;
+              if (offset + len > buflen)
+                {
+                  return offset;
+                }
+
+              memcpy(data + offset, value, len);
+            }
+
+          offset += len;
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          if (offset + sizeof(var->p) > buflen)
+            {
+              return offset;
+            }
+
+          var->p = (uintptr_t)va_arg(ap, FAR void *);
+          offset += sizeof(var->p);
+          infmt = false;
+        }
+      else if (c == '.' && *fmt != '*')
+        {
+          prec = fmt;
+        }
+    }
+
+  return offset;
+}
@@ -45,7 +45,12 @@
 
 void flockfile(FAR struct file_struct *stream)
 {
-  nxrmutex_lock(&stream->fs_lock);
+  /* Nothing to do for a stream that __fsetlocking() handed to the caller */
+
+  if ((stream->fs_flags & __FS_FLAG_NOLOCK) == 0)
+    {
+      nxrmutex_lock(&stream->fs_lock);
+    }
 }
 
 /****************************************************************************
@@ -54,6 +59,11 @@ void flockfile(FAR struct file_struct *stream)
 
 int ftrylockfile(FAR struct file_struct *stream)
 {
+  if ((stream->fs_flags & __FS_FLAG_NOLOCK) != 0)
+    {
+      return 0;
+    }
+
   return nxrmutex_trylock(&stream->fs_lock);
 }
 
@@ -63,5 +73,8 @@ int ftrylockfile(FAR struct file_struct *stream)
 
 void funlockfile(FAR struct file_struct *stream)
 {
-  nxrmutex_unlock(&stream->fs_lock);
+  if ((stream->fs_flags & __FS_FLAG_NOLOCK) == 0)
+    {
+      nxrmutex_unlock(&stream->fs_lock);
+    }
 }
@@ -53,6 +53,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
   FAR const char *src   = ptr;
   ssize_t ret = ERROR;
   size_t gulp_size;
+  size_t bufsize;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -102,11 +103,14 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
       goto errout;
     }
 
-  /* Determine the number of bytes left in the buffer */
+  /* If the buffer already holds data, top it up first so that the data
+   * goes out in order.
+   */
 
-  gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  bufsize = stream->fs_bufend - stream->fs_bufstart;
+  if (stream->fs_bufpos != stream->fs_bufstart)
     {
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
       if (gulp_size > count)
         {
           /* Yes, clip the gulp to the size of the user data */
@@ -140,7 +144,13 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
+  /* The buffer is empty now unless all the data fit.  Data that would
+   * fill the whole buffer is written directly rather than copied: the
+   * buffer set up with setvbuf() may be of any size, not only
+   * CONFIG_STDIO_BUFFER_SIZE.
+   */
+
+  if (count >= bufsize)
     {
       if (stream->fs_iofunc.write != NULL)
         {
@@ -194,6 +194,25 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Write the literal text up to the next conversion at once */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+          if (fmt != pnt && stream != NULL)
+#  else
+          if (fmt != pnt)
+#  endif
+            {
+              stream_puts(pnt, fmt - pnt, stream);
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -1313,9 +1332,21 @@ str_lpad:
           prec--;
         }
 
-      while (c)
+      /* The digits are in reverse order, turn them around and write them
+       * at once.
+       */
+
+      for (len = 0; len < c / 2; len++)
+        {
+          unsigned char z = buf[len];
+
+          buf[len] = buf[c - 1 - len];
+          buf[c - 1 - len] = z;
+        }
+
+      if (c != 0)
         {
-          stream_putc(buf[--c], stream);
+          stream_puts(buf, c, stream);
         }
 
 tail:
@@ -27,6 +27,14 @@
 #include <stdio.h>
 #include <unistd.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* stdio.h may provide an inline version; this is the library function */
+
+#undef putchar_unlocked
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
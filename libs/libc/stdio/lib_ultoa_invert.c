@@ -39,6 +39,26 @@
 
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Two decimal digits per entry so that base 10 takes one division per pair
+ * of digits.
+ */
+
+static const char g_ultoa_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,12 +71,59 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 {
   int upper = 0;
 
+  if (base == 10)
+    {
+      unsigned int v;
+
+      /* Digits come out least significant first */
+
+      while (val >= 100)
+        {
+          v   = val % 100;
+          val = val / 100;
+
+          *str++ = g_ultoa_pairs[2 * v + 1];
+          *str++ = g_ultoa_pairs[2 * v];
+        }
+
+      v = val;
+      if (v >= 10)
+        {
+          *str++ = g_ultoa_pairs[2 * v + 1];
+          *str++ = g_ultoa_pairs[2 * v];
+        }
+      else
+        {
+          *str++ = v + '0';
+        }
+
+      return str;
+    }
+
   if (base & XTOA_UPPER)
     {
       upper = 1;
       base &= ~XTOA_UPPER;
     }
 
+  if (base == 16 || base == 8)
+    {
+      FAR const char *digits = upper ? "0123456789ABCDEF" :
+                                       "0123456789abcdef";
+      int shift = base == 16 ? 4 : 3;
+
+      /* Shifts instead of (long long) divisions */
+
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+
   do
     {
       int v;
@@ -43,12 +43,23 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Partitions below this size are finished with insertion sort */
+
+#define QSORT_INSERTION_MIN  12
+
+/* An already ordered looking partition is finished with insertion sort as
+ * long as that takes no more than this many element swaps.
+ */
+
+#define QSORT_PARTIAL_MAX    8
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof(TYPE); \
@@ -114,50 +125,113 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: insertion_sort
+ *
+ * Description:
+ *   Insertion sort of nel elements.  If limit is not zero, give up and
+ *   return false once more than limit swaps were needed; the elements stay
+ *   a permutation of the original ones.
+ *
+ ****************************************************************************/
+
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           CODE int (*compar)(FAR const void *,
+                           FAR const void *), int swaptype, size_t limit)
+{
+  FAR char *pm;
+  FAR char *pl;
+  size_t count = 0;
+
+  for (pm = base + width; pm < base + nel * width; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+          if (limit != 0 && ++count > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: sift_down
  ****************************************************************************/
 
+static void sift_down(FAR char *base, size_t root, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int swaptype)
+{
+  FAR char *parent;
+  FAR char *child;
+  size_t i;
+
+  while ((i = 2 * root + 1) < nel)
+    {
+      parent = base + root * width;
+      child  = base + i * width;
+
+      if (i + 1 < nel && compar(child, child + width) < 0)
+        {
+          child += width;
+          i++;
+        }
+
+      if (compar(parent, child) >= 0)
+        {
+          break;
+        }
+
+      swap(parent, child);
+      root = i;
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heap_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ *   Heapsort, used once quicksort has picked too many bad pivots so that
+ *   the whole sort stays O(n log n).
  *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int swaptype)
+{
+  size_t i;
+
+  for (i = nel / 2; i > 0; i--)
+    {
+      sift_down(base, i - 1, nel, width, compar, swaptype);
+    }
+
+  while (nel > 1)
+    {
+      nel--;
+      swap(base, base + nel * width);
+      sift_down(base, 0, nel, width, compar, swaptype);
+    }
+}
+
+/****************************************************************************
+ * Name: intro_sort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Bentley & McIlroy's three-way partitioning quicksort.  Small or already
+ *   ordered partitions are finished with insertion sort, and after 'depth'
+ *   levels of partitioning the rest is heapsorted.  Only the smaller side
+ *   is recursed into, so the stack stays O(log n).
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void intro_sort(FAR char *base, size_t nel, size_t width,
+                       CODE int (*compar)(FAR const void *,
+                       FAR const void *), int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -166,6 +240,8 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t nl;
+  size_t nr;
   int swaptype;
   int swap_cnt;
   int d;
@@ -175,43 +251,35 @@ loop:
   SWAPINIT(base, width);
   swap_cnt = 0;
 
-  if (nel < 7)
+  if (nel < QSORT_INSERTION_MIN)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
-
+      insertion_sort(base, nel, width, compar, swaptype, 0);
       return;
     }
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
+  if (depth-- == 0)
     {
-      pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
-        {
-          d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
-        }
+      heap_sort(base, nel, width, compar, swaptype);
+      return;
+    }
 
-      pm = med3(pl, pm, pn, compar);
+  pl = base;
+  pm = base + (nel / 2) * width;
+  pn = base + (nel - 1) * width;
+  if (nel > 40)
+    {
+      d  = (nel / 8) * width;
+      pl = med3(pl, pl + d, pl + 2 * d, compar);
+      pm = med3(pm - d, pm, pm + d, compar);
+      pn = med3(pn - 2 * d, pn - d, pn, compar);
     }
 
+  pm = med3(pl, pm, pn, compar);
+
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
       while (pb <= pc && (r = compar(pb, base)) <= 0)
@@ -249,43 +317,112 @@ loop:
       pc      -= width;
     }
 
-  if (swap_cnt == 0)
+  pn = base + nel * width;
+  r  = MIN(pa - base, pb - pa);
+  vecswap(base, pb - r, r);
+
+  r  = MIN(pd - pc, pn - pd - width);
+  vecswap(pb, pn - r, r);
+
+  nl = (pb - pa) / width;
+  nr = (pd - pc) / width;
+
+  /* Nothing had to move: the input is likely sorted already, try to
+   * finish both sides cheaply.
+   */
+
+  if (swap_cnt == 0 &&
+      insertion_sort(base, nl, width, compar, swaptype,
+                     QSORT_PARTIAL_MAX) &&
+      insertion_sort(pn - nr * width, nr, width, compar, swaptype,
+                     QSORT_PARTIAL_MAX))
     {
-      /* Switch to insertion sort */
+      return;
+    }
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+  if (nl < nr)
+    {
+      if (nl > 1)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          intro_sort(base, nl, width, compar, depth);
         }
 
-      return;
+      base = pn - nr * width;
+      nel  = nr;
     }
+  else
+    {
+      if (nr > 1)
+        {
+          intro_sort(pn - nr * width, nr, width, compar, depth);
+        }
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+      nel = nl;
+    }
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+  /* Iterate rather than recurse to save stack space */
 
-  if ((r = pb - pa) > width)
+  if (nel > 1)
     {
-      qsort(base, r / width, width, compar);
+      goto loop;
     }
+}
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Bounded with a heapsort fallback (introsort) so that the worst case is
+ *   O(n log n).
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth = 0;
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  intro_sort(base, nel, width, compar, depth);
 }
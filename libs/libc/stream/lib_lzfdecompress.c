@@ -0,0 +1,265 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lzfdecompress.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzfinstream_read
+ *
+ * Description:
+ *   Read exactly len octets from the backend.  Returns len, 0 at the end of
+ *   the backend or a negated errno value, -EINVAL if it ends within.
+ *
+ ****************************************************************************/
+
+static ssize_t lzfinstream_read(FAR struct lib_lzfinstream_s *stream,
+                                FAR void *buf, size_t len)
+{
+  FAR char *ptr = buf;
+  size_t total = 0;
+  ssize_t ret;
+
+  while (total < len)
+    {
+      ret = lib_stream_gets(stream->backend, ptr + total, len - total);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret == 0)
+        {
+          return total == 0 ? 0 : -EINVAL;
+        }
+
+      total += ret;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: lzfinstream_fill
+ *
+ * Description:
+ *   Read the next block written by lib_lzfoutstream() and decompress it
+ *   into stream->out.  Returns 1 when a block was read, 0 at the end of the
+ *   backend or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int lzfinstream_fill(FAR struct lib_lzfinstream_s *stream)
+{
+  uint8_t header[LZF_MAX_HDR_SIZE];
+  unsigned int clen;
+  unsigned int ulen;
+  ssize_t ret;
+
+  ret = lzfinstream_read(stream, header, LZF_MIN_HDR_SIZE);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  if (header[0] != 'Z' || header[1] != 'V')
+    {
+      return -EINVAL;
+    }
+
+  if (header[2] == LZF_TYPE0_HDR)
+    {
+      /* Stored uncompressed */
+
+      ulen = (header[3] << 8) | header[4];
+      if (ulen > LZF_STREAM_BLOCKSIZE)
+        {
+          return -EINVAL;
+        }
+
+      ret = lzfinstream_read(stream, stream->out, ulen);
+    }
+  else if (header[2] == LZF_TYPE1_HDR)
+    {
+      ret = lzfinstream_read(stream, &header[LZF_MIN_HDR_SIZE],
+                             LZF_TYPE1_HDR_SIZE - LZF_MIN_HDR_SIZE);
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -EINVAL;
+        }
+
+      clen = (header[3] << 8) | header[4];
+      ulen = (header[5] << 8) | header[6];
+      if (clen == 0 || clen > LZF_STREAM_BLOCKSIZE ||
+          ulen > LZF_STREAM_BLOCKSIZE)
+        {
+          return -EINVAL;
+        }
+
+      ret = lzfinstream_read(stream, stream->in, clen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret != (ssize_t)clen ||
+               lzf_decompress(stream->in, clen, stream->out, ulen) != ulen)
+        {
+          return -EINVAL;
+        }
+
+      ret = ulen;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (ret != (ssize_t)ulen)
+    {
+      return -EINVAL;
+    }
+
+  stream->offset = 0;
+  stream->length = ulen;
+  return 1;
+}
+
+/****************************************************************************
+ * Name: lzfinstream_getc
+ ****************************************************************************/
+
+static int lzfinstream_getc(FAR struct lib_instream_s *self)
+{
+  FAR struct lib_lzfinstream_s *stream =
+                                 (FAR struct lib_lzfinstream_s *)self;
+  int ret;
+
+  while (stream->offset == stream->length)
+    {
+      ret = lzfinstream_fill(stream);
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : EOF;
+        }
+    }
+
+  self->nget++;
+  return (unsigned char)stream->out[stream->offset++];
+}
+
+/****************************************************************************
+ * Name: lzfinstream_gets
+ ****************************************************************************/
+
+static ssize_t lzfinstream_gets(FAR struct lib_instream_s *self,
+                                FAR void *buf, size_t len)
+{
+  FAR struct lib_lzfinstream_s *stream =
+                                 (FAR struct lib_lzfinstream_s *)self;
+  FAR char *ptr = buf;
+  size_t total = 0;
+  size_t copying;
+  int ret;
+
+  while (total < len)
+    {
+      if (stream->offset == stream->length)
+        {
+          ret = lzfinstream_fill(stream);
+          if (ret < 0 && total == 0)
+            {
+              return ret;
+            }
+          else if (ret <= 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      copying = stream->length - stream->offset;
+      if (copying > len - total)
+        {
+          copying = len - total;
+        }
+
+      memcpy(ptr + total, stream->out + stream->offset, copying);
+      stream->offset += copying;
+      total          += copying;
+    }
+
+  self->nget += total;
+  return total;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lzfinstream
+ *
+ * Description:
+ *  LZF decompressing pipeline stream, reading the blocks written by
+ *  lib_lzfoutstream() from the backend.  Needs two blocks of
+ *  LZF_STREAM_BLOCKSIZE octets whatever the length of the data.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lzfinstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lzfinstream(FAR struct lib_lzfinstream_s *stream,
+                     FAR struct lib_instream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->common.getc = lzfinstream_getc;
+  stream->common.gets = lzfinstream_gets;
+  stream->backend     = backend;
+}
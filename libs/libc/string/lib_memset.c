@@ -32,6 +32,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include <nuttx/mm/kasan.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -53,6 +55,7 @@
 #if !defined(CONFIG_LIBC_ARCH_MEMSET) && defined(LIBC_BUILD_MEMSET)
 #undef memset /* See mm/README.txt */
 no_builtin("memset")
+nosanitize_address
 FAR void *memset(FAR void *s, int c, size_t n)
 {
 #ifdef CONFIG_LIBC_MEMSET_OPTSPEED
@@ -68,6 +71,10 @@ FAR void *memset(FAR void *s, int c, size_t n)
   uint64_t  val64 = ((uint64_t)val32 << 32) | (uint64_t)val32;
 #endif
 
+  /* Check the buffer once instead of every store */
+
+  kasan_check(s, n, true);
+
   /* Make sure that there is something to be cleared */
 
   if (n > 0)
@@ -198,6 +205,8 @@ FAR void *memset(FAR void *s, int c, size_t n)
   /* This version is optimized for size */
 
   FAR unsigned char *p = (FAR unsigned char *)s;
+
+  kasan_check(s, n, true);
   while (n-- > 0) *p++ = c;
 #endif
   return s;
@@ -0,0 +1,302 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each hash sets two bits of the bloom filter: bit (hash % BLOOM_BITS) and
+ * bit ((hash >> BLOOM_SHIFT) % BLOOM_BITS) of one bloom word.
+ */
+
+#define BLOOM_BITS          (sizeof(uintptr_t) * 8)
+#define BLOOM_SHIFT         6
+
+/* Average number of symbols per hash bucket */
+
+#define SYMS_PER_BUCKET     4
+
+#define CHAIN_END           1u
+#define BUCKET_EMPTY        UINT32_MAX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   The GNU symbol hash (h * 33 + c, starting from 5381).
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t h = 5381;
+
+  while (*name != '\0')
+    {
+      h = (h << 5) + h + (uint8_t)*name++;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Name: symtab_bloom
+ *
+ * Description:
+ *   Return the bloom word index of a hash and the two bits it sets there.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_bloom(FAR const struct symtab_hash_s *hash,
+                             uint32_t h, FAR uintptr_t *mask)
+{
+  *mask = ((uintptr_t)1 << (h % BLOOM_BITS)) |
+          ((uintptr_t)1 << ((h >> BLOOM_SHIFT) % BLOOM_BITS));
+  return (h / BLOOM_BITS) & (hash->nbloom - 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash_initialize
+ *
+ * Description:
+ *   Build a hash index over a symbol table.  The symbol table must stay
+ *   valid and unchanged while the index is in use.  If the index cannot be
+ *   allocated, the structure is still usable and symtab_hash_findbyname()
+ *   falls back to symtab_findbyname().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hash_initialize(FAR struct symtab_hash_s *hash,
+                           FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR uint32_t *count;
+  uint32_t nbloom;
+  uint32_t b;
+  uint32_t h;
+  uintptr_t mask;
+  size_t size;
+  int i;
+
+  DEBUGASSERT(hash != NULL && nsyms >= 0);
+
+  memset(hash, 0, sizeof(*hash));
+  hash->symtab = symtab;
+  hash->nsyms  = nsyms;
+
+  if (symtab == NULL || nsyms == 0)
+    {
+      return OK;
+    }
+
+  /* Two bloom bits per symbol, spread over a power-of-two word count */
+
+  for (nbloom = 1; nbloom * BLOOM_BITS < 2 * (uint32_t)nsyms; nbloom <<= 1)
+    {
+    }
+
+  hash->nbuckets = nsyms / SYMS_PER_BUCKET + 1;
+  hash->nbloom   = nbloom;
+
+  size = nbloom * sizeof(uintptr_t) +
+         (hash->nbuckets + 2 * nsyms) * sizeof(uint32_t);
+
+  hash->bloom = lib_zalloc(size);
+  if (hash->bloom == NULL)
+    {
+      hash->nbuckets = 0;
+      hash->nbloom   = 0;
+      return -ENOMEM;
+    }
+
+  hash->buckets = (FAR uint32_t *)&hash->bloom[nbloom];
+  hash->chain   = &hash->buckets[hash->nbuckets];
+  hash->order   = &hash->chain[nsyms];
+
+  /* Count the symbols of each bucket in buckets[], keeping the hashes in
+   * chain[] for now.
+   */
+
+  for (i = 0; i < nsyms; i++)
+    {
+      h = symtab_hashname(symtab[i].sym_name);
+      hash->chain[i] = h;
+      hash->buckets[h % hash->nbuckets]++;
+      hash->bloom[symtab_bloom(hash, h, &mask)] |= mask;
+    }
+
+  /* Turn the counts into the end offset of each bucket in order[] */
+
+  for (b = 1; b < hash->nbuckets; b++)
+    {
+      hash->buckets[b] += hash->buckets[b - 1];
+    }
+
+  /* Place the symbols, last first, so that a bucket keeps the table order
+   * and buckets[] ends up at the start offset of each bucket.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      count = &hash->buckets[hash->chain[i] % hash->nbuckets];
+      hash->order[--(*count)] = i;
+    }
+
+  /* Now fill in the chains and mark the last entry of every bucket */
+
+  for (b = 0; b < hash->nbuckets; b++)
+    {
+      uint32_t start = hash->buckets[b];
+      uint32_t end   = b + 1 < hash->nbuckets ?
+                       hash->buckets[b + 1] : (uint32_t)nsyms;
+      uint32_t k;
+
+      if (start == end)
+        {
+          hash->buckets[b] = BUCKET_EMPTY;
+          continue;
+        }
+
+      for (k = start; k < end; k++)
+        {
+          h = symtab_hashname(symtab[hash->order[k]].sym_name);
+          hash->chain[k] = k + 1 == end ? h | CHAIN_END : h & ~CHAIN_END;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_uninitialize
+ *
+ * Description:
+ *   Free the hash index built by symtab_hash_initialize().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hash_uninitialize(FAR struct symtab_hash_s *hash)
+{
+  DEBUGASSERT(hash != NULL);
+
+  if (hash->bloom != NULL)
+    {
+      lib_free(hash->bloom);
+    }
+
+  memset(hash, 0, sizeof(*hash));
+}
+
+/****************************************************************************
+ * Name: symtab_hash_findbyname
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hash_findbyname(FAR const struct symtab_hash_s *hash,
+                       FAR const char *name)
+{
+  FAR const struct symtab_s *symbol;
+  uintptr_t mask;
+  uint32_t h;
+  uint32_t k;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->bloom == NULL)
+    {
+      return symtab_findbyname(hash->symtab, name, hash->nsyms);
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  h = symtab_hashname(name);
+
+  /* Most names that are not in the table stop at the bloom filter */
+
+  if ((hash->bloom[symtab_bloom(hash, h, &mask)] & mask) != mask)
+    {
+      return NULL;
+    }
+
+  k = hash->buckets[h % hash->nbuckets];
+  if (k == BUCKET_EMPTY)
+    {
+      return NULL;
+    }
+
+  for (; ; k++)
+    {
+      if (((hash->chain[k] ^ h) & ~CHAIN_END) == 0)
+        {
+          symbol = &hash->symtab[hash->order[k]];
+          if (strcmp(name, symbol->sym_name) == 0)
+            {
+              return symbol;
+            }
+        }
+
+      if ((hash->chain[k] & CHAIN_END) != 0)
+        {
+          return NULL;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The user-space copy of the system clock.  The kernel finds it through
+ * struct userspace_s and updates it on each timer tick.
+ */
+
+struct clock_vdso_s g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Read CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME from the copy
+ *   of the system clock published by the kernel.  Other clocks, and all
+ *   clocks before the kernel has published the first time, are read with
+ *   the system call.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR volatile struct clock_vdso_s *vdso = &g_clock_vdso;
+  uint32_t seq;
+
+  if (tp == NULL || (clock_id != CLOCK_MONOTONIC &&
+                     clock_id != CLOCK_BOOTTIME &&
+                     clock_id != CLOCK_REALTIME))
+    {
+      return nx_clock_gettime(clock_id, tp);
+    }
+
+  do
+    {
+      seq = vdso->seq;
+      if (seq == 0)
+        {
+          return nx_clock_gettime(clock_id, tp);
+        }
+
+      UP_DMB();
+
+      if (clock_id == CLOCK_REALTIME)
+        {
+          tp->tv_sec  = vdso->realtime.tv_sec;
+          tp->tv_nsec = vdso->realtime.tv_nsec;
+        }
+      else
+        {
+          tp->tv_sec  = vdso->monotonic.tv_sec;
+          tp->tv_nsec = vdso->monotonic.tv_nsec;
+        }
+
+      UP_DMB();
+    }
+  while ((seq & 1) != 0 || seq != vdso->seq);
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * libs/libdsp/lib_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/* The functions below apply the single axis transformations of
+ * lib_transform.c, lib_svm.c and lib_pid.c to n axes at once.  The loop
+ * bodies have no branches and no dependencies between iterations, so the
+ * compiler can vectorize them with NEON or Helium where available, and on
+ * cores without SIMD one call still saves the per-axis call overhead.
+ */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SVM sector indexed by the signs of the auxiliary i, j, k frame
+ * (bit 0: i > 0, bit 1: j > 0, bit 2: k > 0), as in svm3_sector_get().
+ */
+
+static const uint8_t g_svm3_sector[8] =
+{
+  2, 6, 2, 1, 4, 5, 3, 5
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_batch
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n axes, see
+ *   clarke_transform().
+ *
+ * Input Parameters:
+ *   abc - (in) pointer to the abc frames
+ *   ab  - (out) pointer to the alpha-beta frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch(FAR abc_batch_f32_t *abc,
+                            FAR ab_batch_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = abc->a[i];
+
+      ab->a[i] = a;
+      ab->b[i] = ONE_BY_SQRT3_F * a + TWO_BY_SQRT3_F * abc->b[i];
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n axes, see
+ *   inv_clarke_transform().
+ *
+ * Input Parameters:
+ *   ab  - (in) pointer to the alpha-beta frames
+ *   abc - (out) pointer to the abc frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch(FAR ab_batch_f32_t *ab,
+                                FAR abc_batch_f32_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = ab->a[i];
+      float b = -0.5f * a + SQRT3_BY_TWO_F * ab->b[i];
+
+      abc->a[i] = a;
+      abc->b[i] = b;
+      abc->c[i] = -a - b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n axes, see park_transform().
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   ab    - (in) pointer to the alpha-beta frames
+ *   dq    - (out) pointer to the direct-quadrature frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch(FAR phase_angle_batch_f32_t *angle,
+                          FAR ab_batch_f32_t *ab,
+                          FAR dq_batch_f32_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle->sin[i];
+      float c = angle->cos[i];
+      float a = ab->a[i];
+      float b = ab->b[i];
+
+      dq->d[i] = c * a + s * b;
+      dq->q[i] = c * b - s * a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n axes, see
+ *   inv_park_transform().
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   dq    - (in) pointer to the direct-quadrature frames
+ *   ab    - (out) pointer to the alpha-beta frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch(FAR phase_angle_batch_f32_t *angle,
+                              FAR dq_batch_f32_t *dq,
+                              FAR ab_batch_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle->sin[i];
+      float c = angle->cos[i];
+      float d = dq->d[i];
+      float q = dq->q[i];
+
+      ab->a[i] = c * d - s * q;
+      ab->b[i] = c * q + s * d;
+    }
+}
+
+/****************************************************************************
+ * Name: svm3_batch
+ *
+ * Description:
+ *   Space vector modulation of n axes, see svm3().
+ *
+ *   Instead of selecting the active vector times by sector, the duty
+ *   cycles are computed in the equivalent min-max form: with the phase
+ *   voltages u scaled by 2/sqrt(3),
+ *
+ *     d_x = 0.5 + (u_x - (max(u) + min(u)) / 2) / 2
+ *
+ *   which gives the same result as the alternate-reverse null vector
+ *   sequence of svm3() in every sector, without branches.
+ *
+ * Input Parameters:
+ *   s    - (out) pointer to the SVM data
+ *   v_ab - (in) pointer to the modulation voltage vectors in alpha-beta
+ *          frame, normalized to magnitude (0.0 - 1.0)
+ *   n    - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_batch(FAR struct svm3_batch_f32_s *s, FAR ab_batch_f32_t *v_ab,
+                size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(s != NULL);
+  LIBDSP_DEBUGASSERT(v_ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a  = v_ab->a[i];
+      float b  = v_ab->b[i];
+      float ua = TWO_BY_SQRT3_F * a;
+      float ub = b - ONE_BY_SQRT3_F * a;
+      float uc = -b - ONE_BY_SQRT3_F * a;
+      float max;
+      float min;
+      float mid;
+
+      max = ua > ub ? ua : ub;
+      max = max > uc ? max : uc;
+      min = ua < ub ? ua : ub;
+      min = min < uc ? min : uc;
+      mid = 0.5f - 0.25f * (max + min);
+
+      s->d_u[i] = mid + 0.5f * ua;
+      s->d_v[i] = mid + 0.5f * ub;
+      s->d_w[i] = mid + 0.5f * uc;
+    }
+
+  /* The sector is only needed for the current sampling, so it is left to
+   * a separate loop that the duty cycle loop does not pay for.
+   */
+
+  if (s->sector != NULL)
+    {
+      for (i = 0; i < n; i++)
+        {
+          float ii = SQRT3_BY_TWO_F * v_ab->a[i] - 0.5f * v_ab->b[i];
+          float jj = v_ab->b[i];
+          float kk = -jj - ii;
+
+          s->sector[i] = g_svm3_sector[(ii > 0.0f) | (jj > 0.0f) << 1 |
+                                       (kk > 0.0f) << 2];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pi_controller_batch
+ *
+ * Description:
+ *   n PI controllers with output saturation and windup protection, see
+ *   pi_controller().  The integral reset option is not supported.
+ *
+ * Input Parameters:
+ *   pi  - (in/out) pointer to the PI controller data
+ *   err - (in) current controller errors
+ *   out - (out) controller outputs
+ *   n   - (in) number of controllers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_batch(FAR pi_batch_f32_t *pi, FAR const float *err,
+                         FAR float *out, size_t n)
+{
+  FAR const float *kp;
+  FAR const float *ki;
+  FAR const float *kc;
+  FAR const float *min;
+  FAR const float *max;
+  FAR float *part_i;
+  FAR float *aw;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pi != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  /* Local copies, the stores below could otherwise alias the pointers */
+
+  kp     = pi->KP;
+  ki     = pi->KI;
+  kc     = pi->KC;
+  min    = pi->min;
+  max    = pi->max;
+  part_i = pi->part_i;
+  aw     = pi->aw;
+
+  /* Two passes, each touching few enough arrays for the compiler to check
+   * them for overlap and vectorize: the unsaturated output first, then
+   * saturation and the anti-windup term.
+   */
+
+  for (i = 0; i < n; i++)
+    {
+      float e = err[i];
+
+      part_i[i] += ki[i] * (e - aw[i]);
+      out[i]     = kp[i] * e + part_i[i];
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      float tmp = out[i];
+      float sat;
+
+      sat = tmp > max[i] ? max[i] : tmp;
+      sat = sat < min[i] ? min[i] : sat;
+
+      aw[i]  = kc[i] * (tmp - sat);
+      out[i] = sat;
+    }
+}
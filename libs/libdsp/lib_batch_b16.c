@@ -0,0 +1,332 @@
+/****************************************************************************
+ * libs/libdsp/lib_batch_b16.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+/* Fixed-point versions of the functions in lib_batch.c */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SVM sector indexed by the signs of the auxiliary i, j, k frame
+ * (bit 0: i > 0, bit 1: j > 0, bit 2: k > 0), as in svm3_sector_get_b16().
+ */
+
+static const uint8_t g_svm3_sector_b16[8] =
+{
+  2, 6, 2, 1, 4, 5, 3, 5
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_batch_b16
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n axes, see
+ *   clarke_transform_b16().
+ *
+ * Input Parameters:
+ *   abc - (in) pointer to the abc frames
+ *   ab  - (out) pointer to the alpha-beta frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch_b16(FAR abc_batch_b16_t *abc,
+                                FAR ab_batch_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a = abc->a[i];
+
+      ab->a[i] = a;
+      ab->b[i] = (b16mulb16(ONE_BY_SQRT3_B16, a) +
+                  b16mulb16(TWO_BY_SQRT3_B16, abc->b[i]));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch_b16
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n axes, see
+ *   inv_clarke_transform_b16().
+ *
+ * Input Parameters:
+ *   ab  - (in) pointer to the alpha-beta frames
+ *   abc - (out) pointer to the abc frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch_b16(FAR ab_batch_b16_t *ab,
+                                    FAR abc_batch_b16_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a = ab->a[i];
+      b16_t b = (b16mulb16(-b16HALF, a) +
+                 b16mulb16(SQRT3_BY_TWO_B16, ab->b[i]));
+
+      abc->a[i] = a;
+      abc->b[i] = b;
+      abc->c[i] = -a - b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch_b16
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n axes, see
+ *   park_transform_b16().
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   ab    - (in) pointer to the alpha-beta frames
+ *   dq    - (out) pointer to the direct-quadrature frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch_b16(FAR phase_angle_batch_b16_t *angle,
+                              FAR ab_batch_b16_t *ab,
+                              FAR dq_batch_b16_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t s = angle->sin[i];
+      b16_t c = angle->cos[i];
+      b16_t a = ab->a[i];
+      b16_t b = ab->b[i];
+
+      dq->d[i] = b16mulb16(c, a) + b16mulb16(s, b);
+      dq->q[i] = b16mulb16(c, b) - b16mulb16(s, a);
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch_b16
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n axes, see
+ *   inv_park_transform_b16().
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   dq    - (in) pointer to the direct-quadrature frames
+ *   ab    - (out) pointer to the alpha-beta frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch_b16(FAR phase_angle_batch_b16_t *angle,
+                                  FAR dq_batch_b16_t *dq,
+                                  FAR ab_batch_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t s = angle->sin[i];
+      b16_t c = angle->cos[i];
+      b16_t d = dq->d[i];
+      b16_t q = dq->q[i];
+
+      ab->a[i] = b16mulb16(c, d) - b16mulb16(s, q);
+      ab->b[i] = b16mulb16(c, q) + b16mulb16(s, d);
+    }
+}
+
+/****************************************************************************
+ * Name: svm3_batch_b16
+ *
+ * Description:
+ *   Space vector modulation of n axes, see svm3_b16().  The duty cycles
+ *   are computed in the min-max form described in svm3_batch().
+ *
+ * Input Parameters:
+ *   s    - (out) pointer to the SVM data
+ *   v_ab - (in) pointer to the modulation voltage vectors in alpha-beta
+ *          frame, normalized to magnitude (0.0 - 1.0)
+ *   n    - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_batch_b16(FAR struct svm3_batch_b16_s *s,
+                    FAR ab_batch_b16_t *v_ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(s != NULL);
+  LIBDSP_DEBUGASSERT(v_ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a  = v_ab->a[i];
+      b16_t b  = v_ab->b[i];
+      b16_t ua = b16mulb16(TWO_BY_SQRT3_B16, a);
+      b16_t ub = b - b16mulb16(ONE_BY_SQRT3_B16, a);
+      b16_t uc = -b - b16mulb16(ONE_BY_SQRT3_B16, a);
+      b16_t max;
+      b16_t min;
+      b16_t mid;
+
+      max = ua > ub ? ua : ub;
+      max = max > uc ? max : uc;
+      min = ua < ub ? ua : ub;
+      min = min < uc ? min : uc;
+      mid = b16HALF - ((max + min) >> 2);
+
+      s->d_u[i] = mid + (ua >> 1);
+      s->d_v[i] = mid + (ub >> 1);
+      s->d_w[i] = mid + (uc >> 1);
+    }
+
+  /* The sector is only needed for the current sampling, so it is left to
+   * a separate loop that the duty cycle loop does not pay for.
+   */
+
+  if (s->sector != NULL)
+    {
+      for (i = 0; i < n; i++)
+        {
+          b16_t ii = (b16mulb16(-b16HALF, v_ab->b[i]) +
+                      b16mulb16(SQRT3_BY_TWO_B16, v_ab->a[i]));
+          b16_t jj = v_ab->b[i];
+          b16_t kk = -jj - ii;
+
+          s->sector[i] = g_svm3_sector_b16[(ii > 0) | (jj > 0) << 1 |
+                                           (kk > 0) << 2];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pi_controller_batch_b16
+ *
+ * Description:
+ *   n PI controllers with output saturation and windup protection, see
+ *   pi_controller_b16().  The integral reset option is not supported.
+ *
+ * Input Parameters:
+ *   pi  - (in/out) pointer to the PI controller data
+ *   err - (in) current controller errors
+ *   out - (out) controller outputs
+ *   n   - (in) number of controllers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_batch_b16(FAR pi_batch_b16_t *pi, FAR const b16_t *err,
+                             FAR b16_t *out, size_t n)
+{
+  FAR const b16_t *kp;
+  FAR const b16_t *ki;
+  FAR const b16_t *kc;
+  FAR const b16_t *min;
+  FAR const b16_t *max;
+  FAR b16_t *part_i;
+  FAR b16_t *aw;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pi != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  /* Local copies, the stores below could otherwise alias the pointers */
+
+  kp     = pi->KP;
+  ki     = pi->KI;
+  kc     = pi->KC;
+  min    = pi->min;
+  max    = pi->max;
+  part_i = pi->part_i;
+  aw     = pi->aw;
+
+  /* The unsaturated output first, then saturation and anti-windup */
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t e = err[i];
+
+      part_i[i] += b16mulb16(ki[i], e - aw[i]);
+      out[i]     = b16mulb16(kp[i], e) + part_i[i];
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t tmp = out[i];
+      b16_t sat;
+
+      sat = tmp > max[i] ? max[i] : tmp;
+      sat = sat < min[i] ? min[i] : sat;
+
+      aw[i]  = b16mulb16(kc[i], tmp - sat);
+      out[i] = sat;
+    }
+}
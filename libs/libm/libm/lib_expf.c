@@ -28,11 +28,84 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "libm.h"
 
+#ifdef CONFIG_LIBM_FAST_FLOAT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: expf
+ *
+ * Description:
+ *   exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2, with a
+ *   degree 6 polynomial for exp(r); the kernel of vexpf().  Maximum error
+ *   1 ULP.
+ *
+ ****************************************************************************/
+
+float expf(float x)
+{
+  union
+    {
+      float f;
+      int32_t i;
+    } u;
+
+  float r;
+  float p;
+  float n;
+  int32_t ni;
+
+  if (x != x)
+    {
+      return x;
+    }
+  else if (x > 89.0f)
+    {
+      return INFINITY_F;
+    }
+  else if (x < -104.0f)
+    {
+      return 0.0f;
+    }
+
+  /* Round x / ln2 to an integer with the 1.5 * 2^23 shifter */
+
+  u.f = x * 1.44269504088896341f + 12582912.0f;
+  n   = u.f - 12582912.0f;
+  ni  = u.i - 0x4b400000;
+
+  r = x - n * 0.693359375f;
+  r = r - n * -2.12194440e-4f;
+
+  p = 1.9875691500e-4f * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * (r * r) + r + 1.0f;
+
+  /* Scale in two steps so that subnormal results and overflow come out
+   * right.
+   */
+
+  u.i = ((ni >> 1) + 127) << 23;
+  p  *= u.f;
+  u.i = ((ni - (ni >> 1)) + 127) << 23;
+  return p * u.f;
+}
+
+#else /* CONFIG_LIBM_FAST_FLOAT */
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -109,3 +182,5 @@ float expf(float x)
       return value;
     }
 }
+
+#endif /* CONFIG_LIBM_FAST_FLOAT */
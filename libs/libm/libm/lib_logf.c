@@ -28,9 +28,82 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
 #include <float.h>
 
+#ifdef CONFIG_LIBM_FAST_FLOAT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logf
+ *
+ * Description:
+ *   log(x) = k * ln2 + log(1 + f), 1 + f in [sqrt(2)/2, sqrt(2)), with
+ *   log(1 + f) = f - f^2/2 + s * (f^2/2 + R(s^2)), s = f / (2 + f); the
+ *   kernel of vlogf().  Maximum error 1 ULP.
+ *
+ ****************************************************************************/
+
+float logf(float x)
+{
+  union
+    {
+      float f;
+      int32_t i;
+    } u;
+
+  float hfsq;
+  float f;
+  float s;
+  float z;
+  float w;
+  float r;
+  float k;
+  int32_t ix;
+  int32_t sub = 0;
+
+  if (x != x || x == INFINITY_F)
+    {
+      return x;
+    }
+  else if (x == 0.0f)
+    {
+      return -INFINITY_F;
+    }
+  else if (x < 0.0f)
+    {
+      return NAN;
+    }
+  else if (x < FLT_MIN)
+    {
+      x  *= 33554432.0f;                                /* 2^25 */
+      sub = 25;
+    }
+
+  u.f = x;
+  ix  = u.i + (0x3f800000 - 0x3f3504f3);
+  k   = (float)((ix >> 23) - 0x7f - sub);
+  u.i = (ix & 0x007fffff) + 0x3f3504f3;
+  f   = u.f - 1.0f;
+
+  s    = f / (2.0f + f);
+  z    = s * s;
+  w    = z * z;
+  r    = z * (0.66666662693f + w * 0.28498786688f) +
+         w * (0.40000972152f + w * 0.24279078841f);
+  hfsq = 0.5f * f * f;
+  return s * (hfsq + r) + k * 9.0580006145e-06f - hfsq + f +
+         k * 6.9313812256e-01f;
+}
+
+#else /* CONFIG_LIBM_FAST_FLOAT */
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -106,3 +179,5 @@ float logf(float x)
 
   return y;
 }
+
+#endif /* CONFIG_LIBM_FAST_FLOAT */
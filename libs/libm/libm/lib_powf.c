@@ -28,8 +28,87 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
 
+#ifdef CONFIG_LIBM_FAST_FLOAT
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Return 0 if y is not an integer, 1 if it is odd and 2 if it is even */
+
+static int powf_integer(float y)
+{
+  if (fabsf(y) >= 16777216.0f)                           /* 2^24 */
+    {
+      return 2;
+    }
+  else if (y != (float)(int32_t)y)
+    {
+      return 0;
+    }
+
+  return ((int32_t)y & 1) ? 1 : 2;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: powf
+ *
+ * Description:
+ *   exp(y * log(x)) with the polynomial expf() and logf(), plus the special
+ *   cases of C99 F.10.4.4.  The error grows with |y * log(x)| and reaches
+ *   about 140 ULP for results near the ends of the float range.
+ *
+ ****************************************************************************/
+
+float powf(float x, float y)
+{
+  float r;
+  int yint;
+
+  if (y == 0.0f || x == 1.0f)
+    {
+      return 1.0f;
+    }
+  else if (x != x || y != y)
+    {
+      return x + y;
+    }
+  else if (x == -1.0f && isinff(y))
+    {
+      return 1.0f;
+    }
+
+  yint = powf_integer(y);
+  if (x == 0.0f)
+    {
+      r = y > 0.0f ? 0.0f : INFINITY_F;
+      return yint == 1 ? copysignf(r, x) : r;
+    }
+  else if (x < 0.0f)
+    {
+      if (yint == 0 && !isinff(x))
+        {
+          return NAN;
+        }
+
+      r = expf(y * logf(-x));
+      return yint == 1 ? -r : r;
+    }
+
+  return expf(y * logf(x));
+}
+
+#else /* CONFIG_LIBM_FAST_FLOAT */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -54,3 +133,5 @@ float powf(float b, float e)
 
   return 0.0f;
 }
+
+#endif /* CONFIG_LIBM_FAST_FLOAT */
@@ -0,0 +1,346 @@
+/****************************************************************************
+ * libs/libm/libm/lib_vmathf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kernels are written once against vf_t/vi_t.  With the GCC vector
+ * extension these are 128-bit vectors that the compiler maps onto NEON,
+ * Helium (MVE) or RVV registers when the target has them, and splits into
+ * scalar operations otherwise.  Other compilers get one lane.
+ *
+ * Comparisons yield lane masks (all ones or zero) and data dependent
+ * choices are made with VSELECT, so no lane ever branches.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define VLANES            4
+#  define VMASK(c)          (c)
+#  define VASINT(x)         ((vi_t)(x))
+#  define VASFLT(x)         ((vf_t)(x))
+#  define VTOINT(x)         __builtin_convertvector(x, vi_t)
+#  define VTOFLT(x)         __builtin_convertvector(x, vf_t)
+#  define VSPLAT(c)         ((vf_t){ 0 } + (float)(c))
+#else
+#  define VLANES            1
+#  define VMASK(c)          (-(vi_t)(c))
+#  define VASINT(x)         vmath_asint(x)
+#  define VASFLT(x)         vmath_asflt(x)
+#  define VTOINT(x)         ((vi_t)(x))
+#  define VTOFLT(x)         ((vf_t)(x))
+#  define VSPLAT(c)         (c)
+#endif
+
+#define VSELECT(m, a, b)    VASFLT((VASINT(a) & (m)) | (VASINT(b) & ~(m)))
+
+/* Shifter that rounds a float to an integer in its low mantissa bits */
+
+#define VMATH_SHIFT         12582912.0f        /* 1.5 * 2^23 */
+#define VMATH_SHIFT_BITS    0x4b400000
+
+/* sin/cos subtract j * pi/4 in five parts.  The first four have 12
+ * significant bits, so that their products with j < 2^12 are exact.  Above
+ * this |x| the scalar functions take over.
+ */
+
+#define VMATH_TRIG_MAX      3072.0f
+
+/* Run a kernel over the array VLANES elements at a time, the tail goes
+ * through it in a zero padded vector.  A macro rather than a function
+ * taking the kernel so that the kernel is always inlined.
+ */
+
+#define VMATH_APPLY(in, out, n, kernel) \
+  do \
+    { \
+      vf_t v_; \
+      size_t i_; \
+      for (i_ = 0; i_ + VLANES <= (n); i_ += VLANES) \
+        { \
+          memcpy(&v_, &(in)[i_], sizeof(v_)); \
+          v_ = kernel; \
+          memcpy(&(out)[i_], &v_, sizeof(v_)); \
+        } \
+      if (i_ < (n)) \
+        { \
+          memset(&v_, 0, sizeof(v_)); \
+          memcpy(&v_, &(in)[i_], ((n) - i_) * sizeof(float)); \
+          v_ = kernel; \
+          memcpy(&(out)[i_], &v_, ((n) - i_) * sizeof(float)); \
+        } \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if VLANES > 1
+typedef float   vf_t __attribute__((vector_size(4 * VLANES)));
+typedef int32_t vi_t __attribute__((vector_size(4 * VLANES)));
+#else
+typedef float   vf_t;
+typedef int32_t vi_t;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if VLANES == 1
+static inline vi_t vmath_asint(vf_t x)
+{
+  vi_t i;
+
+  memcpy(&i, &x, sizeof(i));
+  return i;
+}
+
+static inline vf_t vmath_asflt(vi_t i)
+{
+  vf_t x;
+
+  memcpy(&x, &i, sizeof(x));
+  return x;
+}
+#endif
+
+/****************************************************************************
+ * Name: vmath_exp
+ *
+ * Description:
+ *   exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2, with a
+ *   degree 6 polynomial for exp(r).  2^n is applied in two halves so that
+ *   results down in the subnormal range and the overflow to infinity come
+ *   out right without special cases.
+ *
+ ****************************************************************************/
+
+static inline vf_t vmath_exp(vf_t x)
+{
+  vf_t z;
+  vf_t n;
+  vf_t r;
+  vf_t p;
+  vi_t ni;
+  vi_t n1;
+
+  x  = VSELECT(VMASK(x > 89.0f), VSPLAT(89.0f), x);
+  x  = VSELECT(VMASK(x < -104.0f), VSPLAT(-104.0f), x);
+
+  z  = x * 1.44269504088896341f + VMATH_SHIFT;
+  n  = z - VMATH_SHIFT;
+  ni = VASINT(z) - VMATH_SHIFT_BITS;
+
+  r  = x - n * 0.693359375f;
+  r  = r - n * -2.12194440e-4f;
+
+  p  = 1.9875691500e-4f * r + 1.3981999507e-3f;
+  p  = p * r + 8.3334519073e-3f;
+  p  = p * r + 4.1665795894e-2f;
+  p  = p * r + 1.6666665459e-1f;
+  p  = p * r + 5.0000001201e-1f;
+  p  = p * (r * r) + r + 1.0f;
+
+  n1 = ni >> 1;
+  p  = p * VASFLT((n1 + 127) << 23);
+  return p * VASFLT((ni - n1 + 127) << 23);
+}
+
+/****************************************************************************
+ * Name: vmath_log
+ *
+ * Description:
+ *   log(x) = k * ln2 + log(1 + f), 1 + f in [sqrt(2)/2, sqrt(2)), with
+ *   log(1 + f) = f - f^2/2 + s * (f^2/2 + R(s^2)), s = f / (2 + f).
+ *
+ ****************************************************************************/
+
+static inline vf_t vmath_log(vf_t x)
+{
+  vf_t f;
+  vf_t s;
+  vf_t z;
+  vf_t w;
+  vf_t r;
+  vf_t k;
+  vf_t hfsq;
+  vf_t y;
+  vi_t ix;
+  vi_t sub;
+
+  /* Bring subnormals into the normal range */
+
+  sub = VMASK(VASINT(x) < 0x00800000);
+  x   = VSELECT(sub, x * 33554432.0f, x);              /* 2^25 */
+
+  ix  = VASINT(x) + (0x3f800000 - 0x3f3504f3);
+  k   = VTOFLT((ix >> 23) - 0x7f - (sub & 25));
+  ix  = (ix & 0x007fffff) + 0x3f3504f3;
+  f   = VASFLT(ix) - 1.0f;
+
+  s    = f / (2.0f + f);
+  z    = s * s;
+  w    = z * z;
+  r    = z * (0.66666662693f + w * 0.28498786688f) +
+         w * (0.40000972152f + w * 0.24279078841f);
+  hfsq = 0.5f * f * f;
+  y    = s * (hfsq + r) + k * 9.0580006145e-06f - hfsq + f +
+         k * 6.9313812256e-01f;
+
+  /* log(+inf) = +inf, log(0) = -inf, log(x < 0) = NaN, NaN stays NaN */
+
+  y = VSELECT(VMASK(x == INFINITY_F), x, y);
+  y = VSELECT(VMASK(x == 0.0f), VSPLAT(-INFINITY_F), y);
+  y = VSELECT(VMASK(x < 0.0f), VSPLAT(NAN), y);
+  return VSELECT(VMASK(x != x), x, y);
+}
+
+/****************************************************************************
+ * Name: vmath_sincos
+ *
+ * Description:
+ *   Reduce |x| by a multiple j of pi/4 (Cody-Waite) and pick the sine or
+ *   cosine polynomial and sign from the octant.  Valid for |x| <=
+ *   VMATH_TRIG_MAX.
+ *
+ ****************************************************************************/
+
+static inline vf_t vmath_sincos(vf_t x, int cosine)
+{
+  vf_t ax;
+  vf_t y;
+  vf_t z;
+  vf_t ps;
+  vf_t pc;
+  vi_t j;
+  vi_t m2;
+  vi_t m4;
+  vi_t sign;
+
+  ax = VASFLT(VASINT(x) & INT32_MAX);
+  ax = VSELECT(VMASK(ax <= VMATH_TRIG_MAX), ax, VSPLAT(0.0f));
+
+  j  = VTOINT(ax * 1.27323954473516f);                  /* 4 / pi */
+  j  = (j + 1) & ~1;
+  y  = VTOFLT(j);
+
+  ax = ax - y * 0.78515625f;
+  ax = ax - y * 2.4187564849853515625e-4f;
+  ax = ax - y * 3.774766810238361358642578125e-8f;
+  ax = ax - y * 1.2816414596272807e-12f;
+  ax = ax - y * 3.0616171314629196e-17f;
+  z  = ax * ax;
+
+  ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z -
+        1.6666654611e-1f) * z * ax + ax;
+  pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z +
+        4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+
+  /* Octants 2 and 6 (j & 2) swap the polynomials; sin changes sign in
+   * octants 4 and 6 and with x, cos in octants 2 and 4.
+   */
+
+  m2 = VMASK((j & 2) != 0);
+  m4 = VMASK((j & 4) != 0);
+  if (cosine)
+    {
+      sign = (m2 ^ m4) & INT32_MIN;
+      y    = VSELECT(m2, ps, pc);
+    }
+  else
+    {
+      sign = (m4 ^ VASINT(x)) & INT32_MIN;
+      y    = VSELECT(m2, pc, ps);
+    }
+
+  return VASFLT(VASINT(y) ^ sign);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsinf, vcosf, vexpf, vlogf
+ *
+ * Description:
+ *   out[i] = f(in[i]) for i < n.  'in' and 'out' may be the same array.
+ *
+ *   Maximum error, measured over all floats against the exact result:
+ *
+ *     vsinf, vcosf  2.5 ULP for |x| <= 3072, sinf() and cosf() beyond
+ *     vexpf         1 ULP
+ *     vlogf         1 ULP
+ *
+ ****************************************************************************/
+
+void vsinf(FAR const float *in, FAR float *out, size_t n)
+{
+  size_t i;
+
+  VMATH_APPLY(in, out, n, vmath_sincos(v_, 0));
+
+  for (i = 0; i < n; i++)
+    {
+      if (!(fabsf(in[i]) <= VMATH_TRIG_MAX))
+        {
+          out[i] = sinf(in[i]);
+        }
+    }
+}
+
+void vcosf(FAR const float *in, FAR float *out, size_t n)
+{
+  size_t i;
+
+  VMATH_APPLY(in, out, n, vmath_sincos(v_, 1));
+
+  for (i = 0; i < n; i++)
+    {
+      if (!(fabsf(in[i]) <= VMATH_TRIG_MAX))
+        {
+          out[i] = cosf(in[i]);
+        }
+    }
+}
+
+void vexpf(FAR const float *in, FAR float *out, size_t n)
+{
+  VMATH_APPLY(in, out, n, vmath_exp(v_));
+}
+
+void vlogf(FAR const float *in, FAR float *out, size_t n)
+{
+  VMATH_APPLY(in, out, n, vmath_log(v_));
+}
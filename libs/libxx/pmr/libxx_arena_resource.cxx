@@ -0,0 +1,184 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_arena_resource.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstdint>
+
+#include <nuttx/memory_resource.hxx>
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// Chunks are taken from upstream with this alignment, which also keeps the
+// chunk header aligned.
+
+static constexpr std::size_t g_chunk_align = alignof(std::max_align_t);
+
+static char *arena_align(char *p, std::size_t alignment)
+{
+  std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+
+  addr = (addr + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+  return reinterpret_cast<char *>(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+  arena_resource::arena_resource(std::size_t chunksize,
+                                 std::pmr::memory_resource *upstream)
+    noexcept
+    : m_upstream(upstream), m_chunks(nullptr), m_cur(nullptr),
+      m_end(nullptr), m_buffer(nullptr), m_bufsize(0),
+      m_nextsize(chunksize)
+  {
+  }
+
+  arena_resource::arena_resource(void *buffer, std::size_t size,
+                                 std::pmr::memory_resource *upstream)
+    noexcept
+    : m_upstream(upstream), m_chunks(nullptr),
+      m_cur(static_cast<char *>(buffer)),
+      m_end(static_cast<char *>(buffer) + size), m_buffer(buffer),
+      m_bufsize(size), m_nextsize(2 * size)
+  {
+    if (m_nextsize < CONFIG_LIBXX_PMR_ARENA_CHUNKSIZE)
+      {
+        m_nextsize = CONFIG_LIBXX_PMR_ARENA_CHUNKSIZE;
+      }
+  }
+
+  arena_resource::~arena_resource()
+  {
+    shrink();
+  }
+
+  void arena_resource::release() noexcept
+  {
+    chunk_s *keep = m_chunks;
+
+    // The newest chunk is the largest, as the sizes grow
+
+    if (keep != nullptr && keep->size - sizeof(chunk_s) <= m_bufsize)
+      {
+        keep = nullptr;
+      }
+
+    while (m_chunks != nullptr)
+      {
+        chunk_s *chunk = m_chunks;
+
+        m_chunks = chunk->next;
+        if (chunk != keep)
+          {
+            m_upstream->deallocate(chunk, chunk->size, g_chunk_align);
+          }
+      }
+
+    if (keep != nullptr)
+      {
+        keep->next = nullptr;
+        m_chunks   = keep;
+        m_cur      = reinterpret_cast<char *>(keep + 1);
+        m_end      = reinterpret_cast<char *>(keep) + keep->size;
+      }
+    else
+      {
+        m_cur = static_cast<char *>(m_buffer);
+        m_end = m_cur + m_bufsize;
+      }
+  }
+
+  void arena_resource::shrink() noexcept
+  {
+    while (m_chunks != nullptr)
+      {
+        chunk_s *chunk = m_chunks;
+
+        m_chunks = chunk->next;
+        m_upstream->deallocate(chunk, chunk->size, g_chunk_align);
+      }
+
+    m_cur = static_cast<char *>(m_buffer);
+    m_end = m_cur + m_bufsize;
+  }
+
+  void *arena_resource::do_allocate(std::size_t bytes,
+                                    std::size_t alignment)
+  {
+    char *p = m_cur != nullptr ? arena_align(m_cur, alignment) : nullptr;
+    chunk_s *chunk;
+    std::size_t size;
+
+    if (p == nullptr || p > m_end ||
+        bytes > static_cast<std::size_t>(m_end - p))
+      {
+        // Room for the header, the alignment padding and the block, and
+        // at least the next size in the geometric series
+
+        size = sizeof(chunk_s) + alignment + bytes;
+        if (size < m_nextsize)
+          {
+            size = m_nextsize;
+          }
+
+        chunk = static_cast<chunk_s *>(m_upstream->allocate(size,
+                                                            g_chunk_align));
+        if (chunk == nullptr)
+          {
+            return nullptr;
+          }
+
+        chunk->next = m_chunks;
+        chunk->size = size;
+        m_chunks    = chunk;
+        m_end       = reinterpret_cast<char *>(chunk) + size;
+        m_nextsize  = size + size / 2;
+
+        p = arena_align(reinterpret_cast<char *>(chunk + 1), alignment);
+      }
+
+    m_cur = p + bytes;
+    return p;
+  }
+
+  void arena_resource::do_deallocate(void *p, std::size_t bytes,
+                                     std::size_t alignment)
+  {
+    // Memory is only given back by release()
+  }
+
+  bool arena_resource::do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+}
@@ -0,0 +1,129 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_pool_resource.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#include <nuttx/memory_resource.hxx>
+#include <nuttx/mm/mempool.h>
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The pools grow from the heap rather than from upstream: the mempool needs
+// the size of what it frees, which a memory_resource cannot tell.
+
+static FAR void *pool_alloc(FAR void *arg, size_t alignment, size_t size)
+{
+  return memalign(alignment, size);
+}
+
+static size_t pool_alloc_size(FAR void *arg, FAR void *addr)
+{
+  return malloc_size(addr);
+}
+
+static void pool_free(FAR void *arg, FAR void *addr)
+{
+  free(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+  pool_resource::pool_resource(const std::size_t *blocksizes,
+                               std::size_t npools, std::size_t expandsize,
+                               std::pmr::memory_resource *upstream)
+    noexcept
+    : m_upstream(upstream), m_pool(nullptr), m_maxsize(0)
+  {
+    // The block sizes must be ascending, as for the heap's mempool
+
+    m_pool = mempool_multiple_init("pmr", blocksizes, npools, pool_alloc,
+                                   pool_alloc_size, pool_free, this, 0,
+                                   expandsize, expandsize);
+    if (m_pool != nullptr && npools > 0)
+      {
+        m_maxsize = blocksizes[npools - 1];
+      }
+  }
+
+  pool_resource::~pool_resource()
+  {
+    if (m_pool != nullptr)
+      {
+        mempool_multiple_deinit(m_pool);
+      }
+  }
+
+  void *pool_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+  {
+    void *p = nullptr;
+
+    if (m_pool != nullptr && bytes <= m_maxsize)
+      {
+        if (alignment <= alignof(std::max_align_t))
+          {
+            p = mempool_multiple_alloc(m_pool, bytes);
+          }
+        else
+          {
+            p = mempool_multiple_memalign(m_pool, alignment, bytes);
+          }
+      }
+
+    if (p == nullptr)
+      {
+        p = m_upstream->allocate(bytes, alignment);
+      }
+
+    return p;
+  }
+
+  void pool_resource::do_deallocate(void *p, std::size_t bytes,
+                                    std::size_t alignment)
+  {
+    // A small block may still have come from upstream if its pool could
+    // not grow; the pool tells its own blocks apart.
+
+    if (bytes > m_maxsize || mempool_multiple_free(m_pool, p) < 0)
+      {
+        m_upstream->deallocate(p, bytes, alignment);
+      }
+  }
+
+  bool pool_resource::do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+}
@@ -51,6 +51,20 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#if defined(CONFIG_IOB_CPU_CACHE) && CONFIG_IOB_CPU_CACHE > 0
+#  define IOB_CPU_CACHE
+#else
+#  define iob_cache_get()    NULL
+#  define iob_cache_put(iob) false
+#endif
+
+#if defined(CONFIG_IOB_ALLOC) && CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_LARGE
+#else
+#  define iob_large_tryalloc() NULL
+#  define iob_large_free(iob)  false
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -137,6 +151,69 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of count I/O buffers linked through io_flink, from head
+ *   to tail, to the free list with a single acquisition of the lock.  The
+ *   io_flink of tail must be NULL.  Buffers are first committed to any
+ *   tasks waiting for one.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *head, FAR struct iob_s *tail,
+                   int16_t count);
+
+#ifdef IOB_CPU_CACHE
+/****************************************************************************
+ * Name: iob_cache_get / iob_cache_put
+ *
+ * Description:
+ *   Take an I/O buffer from, or give a freed I/O buffer to, the cache of
+ *   the current CPU.  iob_cache_get() returns the buffer in a known state
+ *   or NULL if the cache is empty.  iob_cache_put() returns false if the
+ *   buffer must go back to the free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_get(void);
+bool iob_cache_put(FAR struct iob_s *iob);
+#endif
+
+#ifdef IOB_LARGE
+/****************************************************************************
+ * Name: iob_large_initialize
+ *
+ * Description:
+ *   Set up the large I/O buffers.
+ *
+ ****************************************************************************/
+
+void iob_large_initialize(void);
+
+/****************************************************************************
+ * Name: iob_large_tryalloc
+ *
+ * Description:
+ *   Take a large I/O buffer from its free list without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_large_tryalloc(void);
+
+/****************************************************************************
+ * Name: iob_large_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of the large buffers.  Returns
+ *   false if it is not a large buffer.
+ *
+ ****************************************************************************/
+
+bool iob_large_free(FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
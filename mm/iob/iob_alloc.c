@@ -37,6 +37,7 @@
 #endif
 #include <nuttx/nuttx.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/psi.h>
 
 #include "iob.h"
 
@@ -96,6 +97,9 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+      iob->io_flags  = 0;    /* No flags of the packet */
+#endif
     }
 
   spin_unlock_irqrestore(&g_iob_lock, flags);
@@ -135,6 +139,9 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+          iob->io_flags  = 0;    /* No flags of the packet */
+#endif
           return iob;
         }
     }
@@ -193,6 +200,7 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+      psi_stall_enter(PSI_MEM);
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -204,6 +212,8 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
                                    iob_allocwait_gettimeout(start, timeout));
         }
 
+      psi_stall_leave(PSI_MEM);
+
       if (ret >= 0)
         {
           /* When we wake up from wait successfully, an I/O buffer was
@@ -257,6 +267,16 @@ static void iob_free_dynamic(FAR void *data)
 
 FAR struct iob_s *iob_timedalloc(bool throttled, unsigned int timeout)
 {
+  FAR struct iob_s *iob;
+
+  /* Try the cache of this CPU first */
+
+  iob = iob_cache_get();
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
   /* Were we called from the interrupt level? */
 
   if (up_interrupt_context() || sched_idletask() || timeout == 0)
@@ -300,6 +320,12 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+  iob = iob_cache_get();
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -310,6 +336,100 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer for size bytes of data without waiting.
+ *   The buffer is taken from the best fitting size class:  A small buffer
+ *   from the free list, a large buffer if CONFIG_IOB_LARGE_NBUFFERS is
+ *   enabled or a jumbo buffer from the heap.  If no buffer of that class
+ *   is available, a small buffer is returned and the data has to be
+ *   chained.
+ *
+ * Input Parameters:
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *   size      - The size of the data that the buffer will hold
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size)
+{
+#ifdef CONFIG_IOB_ALLOC
+  FAR struct iob_s *iob = NULL;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      if (size <= CONFIG_IOB_LARGE_BUFSIZE)
+        {
+          iob = iob_large_tryalloc();
+        }
+      else if (size <= UINT16_MAX && !up_interrupt_context())
+        {
+          iob = iob_alloc_dynamic(size);
+        }
+
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_tryalloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate up to count I/O buffers at once without waiting for
+ *   buffers to become free.  The free list is locked only once.
+ *
+ * Input Parameters:
+ *   count     - The number of I/O buffers wanted
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The allocated I/O buffers as a chain of empty buffers linked through
+ *   io_flink, or NULL if none is available.  The chain may be shorter than
+ *   requested.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(unsigned int count, bool throttled)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  while (count-- > 0)
+    {
+      iob = iob_tryalloc_internal(throttled);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      if (tail == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      tail = iob;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return head;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -344,6 +464,9 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
       iob->io_pktlen  = 0;                /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+      iob->io_flags   = 0;                /* No flags of the packet */
+#endif
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                                 CONFIG_IOB_ALIGNMENT);
@@ -390,6 +513,9 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+      iob->io_flags   = 0;       /* No flags of the packet */
+#endif
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
     }
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef IOB_CPU_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free I/O buffers cached by one CPU */
+
+struct iob_cache_s
+{
+  int16_t           count;
+  FAR struct iob_s *head;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_get
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_get(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  /* Interrupts are disabled so that we are not moved to another CPU */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  iob   = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+    }
+
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+      iob->io_flags  = 0;    /* No flags of the packet */
+#endif
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_put
+ *
+ * Description:
+ *   Give a freed I/O buffer to the cache of the current CPU.  A buffer is
+ *   not cached while a task waits for one, it must be committed to that
+ *   task instead.  The check is done without the global lock:  A waiter
+ *   that just started waiting gets the next buffer freed to the list.
+ *
+ ****************************************************************************/
+
+bool iob_cache_put(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+  bool ret = false;
+
+  if (g_iob_count < 0
+#if CONFIG_IOB_THROTTLE > 0
+      || g_throttle_wait > 0
+#endif
+      )
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  if (cache->count < CONFIG_IOB_CPU_CACHE)
+    {
+      iob->io_flink = cache->head;
+      cache->head   = iob;
+      cache->count++;
+      ret = true;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+#endif /* IOB_CPU_CACHE */
@@ -57,6 +57,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
                                bool throttled, bool can_block)
 {
   FAR struct iob_s *head = iob;
+  FAR struct iob_s *spare = NULL;
   FAR struct iob_s *next;
   FAR uint8_t *dest;
   unsigned int ncopy;
@@ -178,18 +179,43 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
+          /* Yes.. allocate a new buffer, a large one if the rest does not
+           * fit into a small one.
            *
            * Copy as many bytes as possible. Block if we're allowed.
            */
 
-          if (can_block)
+          if (len > CONFIG_IOB_BUFSIZE && spare == NULL)
+            {
+              next = iob_large_tryalloc();
+            }
+
+          if (next == NULL && can_block)
             {
               next = iob_alloc(throttled);
             }
-          else
+          else if (next == NULL)
             {
-              next = iob_tryalloc(throttled);
+              /* If more than one buffer is still needed, take them all
+               * from the free list at once.
+               */
+
+              if (spare == NULL && len > CONFIG_IOB_BUFSIZE)
+                {
+                  spare = iob_alloc_batch((len + CONFIG_IOB_BUFSIZE - 1) /
+                                          CONFIG_IOB_BUFSIZE, throttled);
+                }
+
+              if (spare != NULL)
+                {
+                  next           = spare;
+                  spare          = next->io_flink;
+                  next->io_flink = NULL;
+                }
+              else
+                {
+                  next = iob_tryalloc(throttled);
+                }
             }
 
           if (next == NULL)
@@ -208,6 +234,9 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
       offset = 0;
     }
 
+  /* The new buffers are filled completely, so none is left over */
+
+  DEBUGASSERT(spare == NULL);
   return total;
 }
 
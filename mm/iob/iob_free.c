@@ -67,6 +67,110 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of count I/O buffers linked through io_flink, from head
+ *   to tail, to the free list with a single acquisition of the lock.  The
+ *   io_flink of tail must be NULL.
+ *   Buffers are first committed to any tasks waiting for one.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *head, FAR struct iob_s *tail,
+                   int16_t count)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int16_t nposts = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int16_t tposts = 0;
+#endif
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t navail;
+#endif
+
+  /* Free the I/O buffers by adding them to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on the committed list where it is reserved for that
+   * allocation (and not available to iob_tryalloc()). This is true
+   * for both throttled and non-throttled cases.
+   */
+
+  while (head != NULL && g_iob_count < 0)
+    {
+      iob             = head;
+      head            = iob->io_flink;
+      g_iob_count++;
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+      count--;
+      nposts++;
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (head != NULL && g_throttle_wait > 0 &&
+         g_iob_count >= CONFIG_IOB_THROTTLE)
+    {
+      iob             = head;
+      head            = iob->io_flink;
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+      g_throttle_wait--;
+      count--;
+      tposts++;
+    }
+#endif
+
+  if (head != NULL)
+    {
+      g_iob_count    += count;
+      tail->io_flink  = g_iob_freelist;
+      g_iob_freelist  = head;
+    }
+  else
+    {
+      count = 0;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+  while (nposts-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (tposts-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal any threads that have requested a signal notification when an
+   * IOB becomes available, once the count of available IOBs reached a
+   * multiple of the divider.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) < count)
+    {
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -79,10 +183,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -113,6 +213,10 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
           next->io_pktlen = 0;
         }
 
+#ifdef CONFIG_IOB_FLAGS
+      next->io_flags = iob->io_flags;
+#endif
+
       iobinfo("next=%p io_pktlen=%u io_len=%u\n",
               next, next->io_pktlen, next->io_len);
     }
@@ -121,69 +225,20 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
   if (iob->io_free != NULL)
     {
       iob->io_free(iob->io_data);
-      kmm_free(iob);
-      return next;
-    }
-#endif
-
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+      if (!iob_large_free(iob))
+        {
+          kmm_free(iob);
+        }
 
-  if (g_iob_count < 0)
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_iob_sem);
-    }
-#if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_throttle_sem);
+      return next;
     }
 #endif
-  else
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (!iob_cache_put(iob))
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
+      iob->io_flink = NULL;
+      iob_free_list(iob, iob, 1);
     }
-#endif
 
   /* And return the I/O buffer after the one that was freed */
 
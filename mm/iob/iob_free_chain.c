@@ -27,6 +27,9 @@
 #include <nuttx/config.h>
 
 #include <nuttx/arch.h>
+#ifdef CONFIG_IOB_ALLOC
+#  include <nuttx/kmalloc.h>
+#endif
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -40,18 +43,54 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The buffers are returned to the free list in one
+ *   operation.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct iob_s *next;
-
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  int16_t count = 0;
 
   for (; iob; iob = next)
     {
-      next = iob_free(iob);
+      next = iob->io_flink;
+
+#ifdef CONFIG_IOB_ALLOC
+      if (iob->io_free != NULL)
+        {
+          iob->io_free(iob->io_data);
+          if (!iob_large_free(iob))
+            {
+              kmm_free(iob);
+            }
+
+          continue;
+        }
+#endif
+
+      if (iob_cache_put(iob))
+        {
+          continue;
+        }
+
+      /* Collect the rest to free them together */
+
+      iob->io_flink = head;
+      head          = iob;
+      if (tail == NULL)
+        {
+          tail = iob;
+        }
+
+      count++;
+    }
+
+  if (head != NULL)
+    {
+      iob_free_list(head, tail, count);
     }
 }
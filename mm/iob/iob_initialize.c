@@ -174,4 +174,8 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef IOB_LARGE
+  iob_large_initialize();
+#endif
 }
@@ -0,0 +1,176 @@
+/****************************************************************************
+ * mm/iob/iob_large.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef IOB_LARGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IOB_LARGE_ALIGN_SIZE \
+  ALIGN_UP(CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_ALIGNMENT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_s g_iob_large[CONFIG_IOB_LARGE_NBUFFERS];
+
+#ifdef IOB_SECTION
+static uint8_t g_iob_large_buffer[CONFIG_IOB_LARGE_NBUFFERS]
+                                 [IOB_LARGE_ALIGN_SIZE]
+               aligned_data(CONFIG_IOB_ALIGNMENT) locate_data(IOB_SECTION);
+#else
+static uint8_t g_iob_large_buffer[CONFIG_IOB_LARGE_NBUFFERS]
+                                 [IOB_LARGE_ALIGN_SIZE]
+               aligned_data(CONFIG_IOB_ALIGNMENT);
+#endif
+
+/* A list of all free large I/O buffers */
+
+static FAR struct iob_s *g_iob_largelist;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_large_free_cb
+ *
+ * Description:
+ *   The io_free callback of the large I/O buffers.  It only makes
+ *   iob_free() take the path of the dynamic buffers, which gives the
+ *   buffer to iob_large_free().
+ *
+ ****************************************************************************/
+
+static void iob_large_free_cb(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_large_initialize
+ *
+ * Description:
+ *   Set up the large I/O buffers.
+ *
+ ****************************************************************************/
+
+void iob_large_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+    {
+      FAR struct iob_s *iob = &g_iob_large[i];
+
+      iob->io_bufsize = CONFIG_IOB_LARGE_BUFSIZE;
+      iob->io_free    = iob_large_free_cb;
+      iob->io_data    = g_iob_large_buffer[i];
+      iob->io_flink   = g_iob_largelist;
+      g_iob_largelist = iob;
+    }
+}
+
+/****************************************************************************
+ * Name: iob_large_tryalloc
+ *
+ * Description:
+ *   Take a large I/O buffer from its free list without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_large_tryalloc(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  iob   = g_iob_largelist;
+  if (iob != NULL)
+    {
+      g_iob_largelist = iob->io_flink;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_FLAGS
+      iob->io_flags  = 0;    /* No flags of the packet */
+#endif
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_large_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of the large buffers.  Returns
+ *   false if it is not a large buffer.
+ *
+ ****************************************************************************/
+
+bool iob_large_free(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  if (iob < g_iob_large || iob >= &g_iob_large[CONFIG_IOB_LARGE_NBUFFERS])
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  iob->io_flink   = g_iob_largelist;
+  g_iob_largelist = iob;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return true;
+}
+
+#endif /* IOB_LARGE */
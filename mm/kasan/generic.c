@@ -51,6 +51,12 @@
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+#ifdef CONFIG_MM_KASAN_REGION_ALLOWLIST
+#  define KASAN_REGION_ENABLED false
+#else
+#  define KASAN_REGION_ENABLED true
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -59,6 +65,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;  /* Whether the accesses to the region are checked */
   uintptr_t shadow[1];
 };
 
@@ -67,6 +74,7 @@ struct kasan_region_s
  ****************************************************************************/
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
+static FAR struct kasan_region_s *g_region_last;
 static size_t g_region_count;
 static spinlock_t g_lock;
 
@@ -74,45 +82,94 @@ static spinlock_t g_lock;
  * Private Functions
  ****************************************************************************/
 
-static inline_function FAR uintptr_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                    FAR unsigned int *bit)
+/* Return the region that contains an address.  Consecutive accesses
+ * mostly hit the same region, so the last one found is tried first.
+ */
+
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
-  uintptr_t addr = (uintptr_t)ptr;
+  FAR struct kasan_region_s *region = g_region_last;
   size_t i;
 
+  if (region != NULL && addr >= region->begin && addr < region->end)
+    {
+      return region;
+    }
+
   for (i = 0; i < g_region_count; i++)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &g_region[i]->shadow[addr / KASAN_BITS_PER_WORD];
+          g_region_last = region;
+          return region;
         }
     }
 
   return NULL;
 }
 
+static inline_function FAR uintptr_t *
+kasan_region_to_shadow(FAR struct kasan_region_s *region, uintptr_t addr,
+                       size_t size, FAR unsigned int *bit)
+{
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
+}
+
+static inline_function FAR uintptr_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                    FAR unsigned int *bit)
+{
+  FAR struct kasan_region_s *region;
+
+  region = kasan_find_region((uintptr_t)ptr);
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  return kasan_region_to_shadow(region, (uintptr_t)ptr, size, bit);
+}
+
 static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
+  FAR struct kasan_region_s *region;
   FAR uintptr_t *p;
   unsigned int bit;
   unsigned int nbit;
   uintptr_t mask;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  if (p == NULL)
+  region = kasan_find_region((uintptr_t)addr);
+  if (region == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
 
-  if (size <= KASAN_SHADOW_SCALE)
+  if (!region->enabled)
     {
-      return ((*p >> bit) & 1);
+      return false;
+    }
+
+  p = kasan_region_to_shadow(region, (uintptr_t)addr, size, &bit);
+
+  /* The small accesses of the instrumented code cover a few granules of
+   * one shadow word, which takes a single test.
+   */
+
+  if (size <= 2 * KASAN_SHADOW_SCALE)
+    {
+      nbit = ((uintptr_t)addr % KASAN_SHADOW_SCALE + size +
+              KASAN_SHADOW_SCALE - 1) / KASAN_SHADOW_SCALE;
+      if (bit + nbit <= KASAN_BITS_PER_WORD)
+        {
+          return ((*p >> bit) & (((uintptr_t)1 << nbit) - 1)) != 0;
+        }
     }
 
   nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
@@ -228,8 +285,9 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+  region->enabled = KASAN_REGION_ENABLED;
 
   flags = spin_lock_irqsave(&g_lock);
 
@@ -253,6 +311,11 @@ void kasan_unregister(FAR void *addr)
     {
       if (g_region[i]->begin == (uintptr_t)addr)
         {
+          if (g_region_last == g_region[i])
+            {
+              g_region_last = NULL;
+            }
+
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
@@ -262,3 +325,19 @@ void kasan_unregister(FAR void *addr)
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+
+  flags  = spin_lock_irqsave(&g_lock);
+  region = kasan_find_region((uintptr_t)addr);
+  if (region != NULL)
+    {
+      region->enabled = enable;
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return region != NULL ? OK : -EINVAL;
+}
@@ -335,6 +335,25 @@ int kasan_debugpoint(int type, FAR void *addr, size_t size)
 }
 #endif
 
+void kasan_check(FAR const void *addr, size_t size, bool is_write)
+{
+#ifdef CONFIG_MM_KASAN_DISABLE_READS_CHECK
+  if (!is_write)
+    {
+      return;
+    }
+#endif
+
+#ifdef CONFIG_MM_KASAN_DISABLE_WRITES_CHECK
+  if (is_write)
+    {
+      return;
+    }
+#endif
+
+  kasan_check_report(addr, size, is_write, return_address(0));
+}
+
 void __asan_before_dynamic_init(FAR const void *module_name)
 {
   /* Shut up compiler complaints */
@@ -52,6 +52,12 @@
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+#ifdef CONFIG_MM_KASAN_REGION_ALLOWLIST
+#  define KASAN_REGION_ENABLED false
+#else
+#  define KASAN_REGION_ENABLED true
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -60,6 +66,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;  /* Whether the accesses to the region are checked */
   uint8_t   shadow[1];
 };
 
@@ -68,6 +75,7 @@ struct kasan_region_s
  ****************************************************************************/
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
+static FAR struct kasan_region_s *g_region_last;
 static int g_region_count;
 static spinlock_t g_lock;
 
@@ -75,31 +83,57 @@ static spinlock_t g_lock;
  * Private Functions
  ****************************************************************************/
 
-static inline_function FAR uint8_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+/* Return the region that contains an address.  Consecutive accesses
+ * mostly hit the same region, so the last one found is tried first.
+ */
+
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
-  uintptr_t addr;
+  FAR struct kasan_region_s *region = g_region_last;
   int i;
 
-  addr = (uintptr_t)kasan_reset_tag(ptr);
+  if (region != NULL && addr >= region->begin && addr < region->end)
+    {
+      return region;
+    }
 
   for (i = 0; i < g_region_count; i++)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          return &g_region[i]->shadow[addr / KASAN_SHADOW_SCALE];
+          g_region_last = region;
+          return region;
         }
     }
 
   return NULL;
 }
 
+static inline_function FAR uint8_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr;
+
+  addr   = (uintptr_t)kasan_reset_tag(ptr);
+  region = kasan_find_region(addr);
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  return &region->shadow[(addr - region->begin) / KASAN_SHADOW_SCALE];
+}
+
 static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
+  FAR struct kasan_region_s *region;
   FAR uint8_t *p;
+  uintptr_t raw;
   uint8_t tag;
 
   tag = kasan_get_tag(addr);
@@ -111,12 +145,29 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
     }
 #endif
 
-  p = kasan_mem_to_shadow(addr, size);
-  if (p == NULL)
+  raw    = (uintptr_t)kasan_reset_tag(addr);
+  region = kasan_find_region(raw);
+  if (region == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
 
+  if (!region->enabled)
+    {
+      return false;
+    }
+
+  DEBUGASSERT(raw + size <= region->end);
+  p = &region->shadow[(raw - region->begin) / KASAN_SHADOW_SCALE];
+
+  /* An aligned access of up to a granule has a single tag to compare */
+
+  if (size <= KASAN_SHADOW_SCALE &&
+      raw % KASAN_SHADOW_SCALE + size <= KASAN_SHADOW_SCALE)
+    {
+      return *p != tag;
+    }
+
   size = KASAN_SHADOW_SIZE(size);
   while (size--)
     {
@@ -183,8 +234,9 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+  region->enabled = KASAN_REGION_ENABLED;
 
   flags = spin_lock_irqsave(&g_lock);
 
@@ -208,6 +260,11 @@ void kasan_unregister(FAR void *addr)
     {
       if (g_region[i]->begin == (uintptr_t)addr)
         {
+          if (g_region_last == g_region[i])
+            {
+              g_region_last = NULL;
+            }
+
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
@@ -217,3 +274,19 @@ void kasan_unregister(FAR void *addr)
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+
+  flags  = spin_lock_irqsave(&g_lock);
+  region = kasan_find_region((uintptr_t)kasan_reset_tag(addr));
+  if (region != NULL)
+    {
+      region->enabled = enable;
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return region != NULL ? OK : -EINVAL;
+}
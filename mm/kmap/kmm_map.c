@@ -48,6 +48,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The size of the memory mapped by one final level page table, which the
+ * architecture can map with one section entry instead.
+ */
+
+#define KMAP_SECTION_SIZE (MM_PGSIZE * (MM_PGSIZE / sizeof(uintptr_t)))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -127,9 +133,21 @@ static FAR void *map_pages(FAR void **pages, size_t npages, int prot)
 
   size = npages << MM_PGSHIFT;
 
-  /* Find a virtual memory area that fits */
+  /* Find a virtual memory area that fits.  Large areas are aligned to a
+   * section so that contiguous pages can be mapped by sections.
+   */
+
+#ifdef CONFIG_ARCH_ADDRENV_SECTIONS
+  if (size >= KMAP_SECTION_SIZE)
+    {
+      vaddr = gran_alloc_align(g_kmm_map_vpages, size, KMAP_SECTION_SIZE);
+    }
+  else
+#endif
+    {
+      vaddr = gran_alloc(g_kmm_map_vpages, size);
+    }
 
-  vaddr = gran_alloc(g_kmm_map_vpages, size);
   if (!vaddr)
     {
       return NULL;
@@ -53,4 +53,20 @@ FAR void *kmm_malloc(size_t size)
   return mm_malloc(g_kmmheap, size);
 }
 
+#ifdef CONFIG_MM_REGION_ATTR
+/****************************************************************************
+ * Name: kmm_malloc_attr
+ *
+ * Description:
+ *   Allocate memory from the kernel heap, preferably from the regions with
+ *   the given attributes, see mm_malloc_attr().
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_attr(size_t size, uint32_t attr)
+{
+  return mm_malloc_attr(g_kmmheap, size, attr);
+}
+#endif
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
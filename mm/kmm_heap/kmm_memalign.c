@@ -56,4 +56,20 @@ FAR void *kmm_memalign(size_t alignment, size_t size)
   return mm_memalign(g_kmmheap, alignment, size);
 }
 
+#ifdef CONFIG_MM_REGION_ATTR
+/****************************************************************************
+ * Name: kmm_memalign_attr
+ *
+ * Description:
+ *   Allocate aligned memory in the kernel heap, preferably from the regions
+ *   with the given attributes.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_memalign_attr(size_t alignment, size_t size, uint32_t attr)
+{
+  return mm_memalign_attr(g_kmmheap, alignment, size, attr);
+}
+#endif
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
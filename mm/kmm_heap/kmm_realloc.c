@@ -54,4 +54,24 @@ FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
   return mm_realloc(g_kmmheap, oldmem, newsize);
 }
 
+/****************************************************************************
+ * Name: kmm_realloc_inplace
+ *
+ * Description:
+ *   Resize memory in the kernel heap only if it does not have to move.
+ *
+ * Input Parameters:
+ *   mem     - The memory allocated
+ *   newsize - The new size (in bytes) of the memory region.
+ *
+ * Returned Value:
+ *   mem if it was resized, NULL if it is left unchanged.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_realloc_inplace(FAR void *mem, size_t newsize)
+{
+  return mm_realloc_inplace(g_kmmheap, mem, newsize);
+}
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -303,6 +303,43 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
   return found_entry;
 }
 
+/****************************************************************************
+ * Name: mm_map_fault
+ *
+ * Description:
+ *   Resolve a translation fault through the mapping containing vaddr
+ *
+ ****************************************************************************/
+
+int mm_map_fault(FAR struct mm_map_s *mm, FAR void *vaddr, bool write)
+{
+  FAR struct mm_map_entry_s *entry;
+  int ret;
+
+  ret = nxrmutex_lock(&mm->mm_map_mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Hold the list lock so that the mapping cannot go away while its pages
+   * are filled.
+   */
+
+  entry = mm_map_find(mm, vaddr, 1);
+  if (entry != NULL && entry->fault != NULL)
+    {
+      ret = entry->fault(entry, vaddr, write);
+    }
+  else
+    {
+      ret = -EFAULT;
+    }
+
+  nxrmutex_unlock(&mm->mm_map_mutex);
+  return ret;
+}
+
 /****************************************************************************
  * Name: mm_map_remove
  *
@@ -0,0 +1,342 @@
+/****************************************************************************
+ * mm/mempool/kmem_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mm/kmem_cache.h>
+
+#ifdef CONFIG_MM_KMEM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_KMEM_CACHE_PERCPU) && CONFIG_MM_KMEM_CACHE_PERCPU > 0
+#  define KMEM_CACHE_PERCPU
+#else
+#  define kmem_cache_get(cache)      NULL
+#  define kmem_cache_put(cache, blk) false
+#  define kmem_cache_drain(cache)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef KMEM_CACHE_PERCPU
+/* The free objects of a cache kept by one CPU */
+
+struct kmem_percpu_s
+{
+  size_t    count;
+  FAR void *blk[CONFIG_MM_KMEM_CACHE_PERCPU];
+};
+#endif
+
+struct kmem_cache_s
+{
+  struct mempool_s pool; /* The pool holding the objects */
+  kmem_ctor_t      ctor; /* The constructor of the objects */
+
+  /* The offset of the object in its block.  The pool links the free blocks
+   * through their first word, so the objects of a cache with a constructor
+   * start behind it to keep their constructed state.
+   */
+
+  size_t           offset;
+#ifdef KMEM_CACHE_PERCPU
+  struct kmem_percpu_s percpu[CONFIG_SMP_NCPUS];
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_grow
+ *
+ * Description:
+ *   The alloc function of the pool of a cache:  Allocate an expansion from
+ *   the kernel heap and construct all of its objects.  The blocks of an
+ *   expansion are followed by its queue entry.
+ *
+ ****************************************************************************/
+
+static FAR void *kmem_cache_grow(FAR struct mempool_s *pool, size_t size)
+{
+  FAR struct kmem_cache_s *cache = pool->priv;
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR char *base;
+  size_t nblks;
+
+  base = kmm_malloc(size);
+  if (base != NULL && cache->ctor != NULL)
+    {
+      nblks = (size - sizeof(sq_entry_t)) / blocksize;
+      while (nblks-- > 0)
+        {
+          cache->ctor(base + nblks * blocksize + cache->offset);
+        }
+    }
+
+  return base;
+}
+
+static void kmem_cache_shrink(FAR struct mempool_s *pool, FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+static void kmem_cache_check(FAR struct mempool_s *pool, FAR void *blk)
+{
+  DEBUGASSERT(((uintptr_t)blk & (MM_ALIGN - 1)) == 0);
+}
+
+#ifdef KMEM_CACHE_PERCPU
+
+/****************************************************************************
+ * Name: kmem_cache_get / kmem_cache_put
+ *
+ * Description:
+ *   Take a free block from, or give one to the objects kept by the current
+ *   CPU.  kmem_cache_put() returns false if the CPU keeps enough objects.
+ *
+ ****************************************************************************/
+
+static FAR void *kmem_cache_get(FAR struct kmem_cache_s *cache)
+{
+  FAR struct kmem_percpu_s *percpu;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  flags  = up_irq_save();
+  percpu = &cache->percpu[this_cpu()];
+  if (percpu->count > 0)
+    {
+      blk = percpu->blk[--percpu->count];
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+static bool kmem_cache_put(FAR struct kmem_cache_s *cache, FAR void *blk)
+{
+  FAR struct kmem_percpu_s *percpu;
+  irqstate_t flags;
+  bool ret = false;
+
+  flags  = up_irq_save();
+  percpu = &cache->percpu[this_cpu()];
+  if (percpu->count < CONFIG_MM_KMEM_CACHE_PERCPU)
+    {
+      percpu->blk[percpu->count++] = blk;
+      ret = true;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_drain
+ *
+ * Description:
+ *   Give the objects kept by all CPUs back to the pool.
+ *
+ ****************************************************************************/
+
+static void kmem_cache_drain(FAR struct kmem_cache_s *cache)
+{
+  FAR struct kmem_percpu_s *percpu;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      percpu = &cache->percpu[cpu];
+      while (percpu->count > 0)
+        {
+          mempool_release(&cache->pool, percpu->blk[--percpu->count]);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of the same size.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, kmem_ctor_t ctor)
+{
+  FAR struct kmem_cache_s *cache;
+
+  DEBUGASSERT(size > 0);
+
+  cache = kmm_zalloc(sizeof(struct kmem_cache_s));
+  if (cache == NULL)
+    {
+      return NULL;
+    }
+
+  cache->ctor   = ctor;
+  cache->offset = ctor != NULL ? ALIGN_UP(sizeof(sq_entry_t), MM_ALIGN) : 0;
+
+  cache->pool.blocksize  = ALIGN_UP(cache->offset + size, MM_ALIGN);
+  cache->pool.expandsize = CONFIG_MM_KMEM_CACHE_BATCH *
+                           MEMPOOL_REALBLOCKSIZE(&cache->pool) +
+                           sizeof(sq_entry_t);
+  cache->pool.priv       = cache;
+  cache->pool.alloc      = kmem_cache_grow;
+  cache->pool.free       = kmem_cache_shrink;
+  cache->pool.check      = kmem_cache_check;
+
+  if (mempool_init(&cache->pool, name) < 0)
+    {
+      kmm_free(cache);
+      return NULL;
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache.  All objects must have been freed.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache)
+{
+  int ret;
+
+  kmem_cache_drain(cache);
+
+  ret = mempool_deinit(&cache->pool);
+  if (ret >= 0)
+    {
+      kmm_free(cache);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate a constructed object from a cache.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache)
+{
+  FAR char *blk;
+
+  blk = kmem_cache_get(cache);
+  if (blk == NULL)
+    {
+      blk = mempool_allocate(&cache->pool);
+      if (blk == NULL)
+        {
+          return NULL;
+        }
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      /* The pool overwrote the constructed state */
+
+      if (cache->ctor != NULL)
+        {
+          cache->ctor(blk + cache->offset);
+        }
+#endif
+    }
+
+  return blk + cache->offset;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate a zeroed object from a cache that has no constructor.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj;
+
+  DEBUGASSERT(cache->ctor == NULL);
+
+  obj = kmem_cache_alloc(cache);
+  if (obj != NULL)
+    {
+      memset(obj, 0, cache->pool.blocksize);
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object to the cache it was allocated from.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj)
+{
+  FAR char *blk = (FAR char *)obj - cache->offset;
+
+  if (!kmem_cache_put(cache, blk))
+    {
+      mempool_release(&cache->pool, blk);
+    }
+}
+
+#endif /* CONFIG_MM_KMEM_CACHE */
@@ -40,6 +40,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+#  if UINTPTR_MAX > UINT32_MAX
+#    error CONFIG_MM_MEMPOOL_LOCKFREE requires 32-bit pointers
+#  endif
+
+/* The head of a lock-free queue holds the first block in the low word and
+ * a tag that changes with every update in the high word.
+ */
+
+#  define MEMPOOL_LF_BLK(head) ((FAR sq_entry_t *)(uintptr_t)(uint32_t)(head))
+#  define MEMPOOL_LF_HEAD(head, blk) \
+     ((int64_t)((((uint64_t)(head) >> 32) + 1) << 32 | (uintptr_t)(blk)))
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0xAAAAAAAA
 #define MEMPOOL_MAGIC_ALLOC 0x55555555
@@ -98,6 +112,202 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+static inline void mempool_update_water(FAR struct mempool_s *pool)
+{
+  size_t nalloc = pool->nalloc;
+
+  if (pool->hwater < nalloc)
+    {
+      pool->hwater = nalloc;
+    }
+
+  if (pool->lwater > pool->nblocks - nalloc)
+    {
+      pool->lwater = pool->nblocks - nalloc;
+    }
+}
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+
+/****************************************************************************
+ * Name: mempool_lf_push
+ *
+ * Description:
+ *   Push a chain of blocks linked from first to last onto a lock-free
+ *   queue.
+ *
+ ****************************************************************************/
+
+static inline void mempool_lf_push(FAR atomic64_t *queue,
+                                   FAR sq_entry_t *first,
+                                   FAR sq_entry_t *last)
+{
+  int64_t head = atomic64_read(queue);
+
+  do
+    {
+      last->flink = MEMPOOL_LF_BLK(head);
+    }
+  while (!atomic64_try_cmpxchg_release(queue, &head,
+                                       MEMPOOL_LF_HEAD(head, first)));
+}
+
+/****************************************************************************
+ * Name: mempool_lf_pop
+ *
+ * Description:
+ *   Pop a block from a lock-free queue.  The link of the first block may be
+ *   read after another CPU took the block, but the block stays mapped and
+ *   the tag makes the exchange fail then.
+ *
+ ****************************************************************************/
+
+static inline FAR sq_entry_t *mempool_lf_pop(FAR atomic64_t *queue)
+{
+  int64_t head = atomic64_read_acquire(queue);
+  FAR sq_entry_t *blk;
+
+  do
+    {
+      blk = MEMPOOL_LF_BLK(head);
+      if (blk == NULL)
+        {
+          return NULL;
+        }
+    }
+  while (!atomic64_try_cmpxchg_acquire(queue, &head,
+                                       MEMPOOL_LF_HEAD(head, blk->flink)));
+
+  blk->flink = NULL;
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_lf_move
+ *
+ * Description:
+ *   Move the blocks of a queue to an empty lock-free queue.
+ *
+ ****************************************************************************/
+
+static inline void mempool_lf_move(FAR atomic64_t *queue,
+                                   FAR sq_queue_t *from)
+{
+  if (from->head != NULL)
+    {
+      mempool_lf_push(queue, from->head, from->tail);
+      sq_init(from);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_lf_allocate
+ *
+ * Description:
+ *   Take a free block in the lock-free mode:  From the cache of the
+ *   current CPU, from the queue, from the interrupt queue in interrupt
+ *   context or else by expanding the pool.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_lf_allocate(FAR struct mempool_s *pool)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+retry:
+  blk = (FAR sq_entry_t *)(uintptr_t)
+        atomic_xchg(&pool->lfcache[this_cpu()], 0);
+  if (blk == NULL)
+    {
+      blk = mempool_lf_pop(&pool->lfhead);
+    }
+
+  if (blk == NULL)
+    {
+      if (up_interrupt_context())
+        {
+          blk = mempool_lf_pop(&pool->lfihead);
+          if (blk == NULL)
+            {
+              return NULL;
+            }
+        }
+      else if (pool->expandsize >= blocksize + sizeof(sq_entry_t))
+        {
+          size_t nexpand = (pool->expandsize - sizeof(sq_entry_t)) /
+                           blocksize;
+          size_t size = nexpand * blocksize + sizeof(sq_entry_t);
+          FAR char *base = pool->alloc(pool, size);
+          sq_queue_t queue;
+
+          if (base == NULL)
+            {
+              return NULL;
+            }
+
+          kasan_poison(base, size);
+          sq_init(&queue);
+          mempool_add_queue(pool, &queue, base, nexpand, blocksize);
+
+          flags = spin_lock_irqsave(&pool->lock);
+          sq_addlast((FAR sq_entry_t *)(base + nexpand * blocksize),
+                     &pool->equeue);
+          pool->nblocks += nexpand;
+          spin_unlock_irqrestore(&pool->lock, flags);
+
+          blk = sq_remfirst(&queue);
+          mempool_lf_move(&pool->lfhead, &queue);
+        }
+      else if (!pool->wait ||
+               nxsem_wait_uninterruptible(&pool->waitsem) < 0)
+        {
+          return NULL;
+        }
+      else
+        {
+          goto retry;
+        }
+    }
+
+  /* The watermarks are updated without the lock and may be off */
+
+  atomic_fetch_add_relaxed(&pool->nalloc, 1);
+  mempool_update_water(pool);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_lf_release
+ *
+ * Description:
+ *   Give a block back in the lock-free mode:  To the cache of the current
+ *   CPU if it is empty, otherwise to its queue.
+ *
+ ****************************************************************************/
+
+static void mempool_lf_release(FAR struct mempool_s *pool, FAR void *blk)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  int32_t expect = 0;
+
+  atomic_fetch_sub_relaxed(&pool->nalloc, 1);
+
+  if (pool->interruptsize > blocksize &&
+      (FAR char *)blk >= pool->ibase &&
+      (FAR char *)blk < pool->ibase + pool->interruptsize - blocksize)
+    {
+      mempool_lf_push(&pool->lfihead, blk, blk);
+    }
+  else if (!atomic_cmpxchg_release(&pool->lfcache[this_cpu()], &expect,
+                                   (int32_t)(uintptr_t)blk))
+    {
+      mempool_lf_push(&pool->lfhead, blk, blk);
+    }
+}
+#endif /* CONFIG_MM_MEMPOOL_LOCKFREE */
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -255,11 +465,15 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+  pool->nblocks = 0;
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -274,6 +488,7 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       mempool_add_queue(pool, &pool->iqueue,
                         pool->ibase, ninterrupt, blocksize);
       kasan_poison(pool->ibase, size);
+      pool->nblocks = ninterrupt;
     }
   else
     {
@@ -302,14 +517,30 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       sq_addlast((FAR sq_entry_t *)(base + ninitial * blocksize),
                   &pool->equeue);
       kasan_poison(base, size);
+      pool->nblocks += ninitial;
     }
 
+  pool->hwater = 0;
+  pool->lwater = pool->nblocks;
+
   spin_lock_init(&pool->lock);
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
     }
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      atomic_set(&pool->lfcache[i], 0);
+    }
+
+  atomic64_set(&pool->lfhead, 0);
+  atomic64_set(&pool->lfihead, 0);
+  mempool_lf_move(&pool->lfhead, &pool->queue);
+  mempool_lf_move(&pool->lfihead, &pool->iqueue);
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   mempool_procfs_register(&pool->procfs, name);
 #  ifdef CONFIG_MM_BACKTRACE_DEFAULT
@@ -342,6 +573,14 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 FAR void *mempool_allocate(FAR struct mempool_s *pool)
 {
   FAR sq_entry_t *blk;
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+
+  blk = mempool_lf_allocate(pool);
+  if (blk == NULL)
+    {
+      return NULL;
+    }
+#else
   irqstate_t flags;
 
 retry:
@@ -381,6 +620,7 @@ retry:
                                 base, nexpand, blocksize);
               sq_addlast((FAR sq_entry_t *)(base + nexpand * blocksize),
                          &pool->equeue);
+              pool->nblocks += nexpand;
               blk = mempool_remove_queue(pool, &pool->queue);
             }
           else if (!pool->wait ||
@@ -396,7 +636,9 @@ retry:
     }
 
   pool->nalloc++;
+  mempool_update_water(pool);
   spin_unlock_irqrestore(&pool->lock, flags);
+#endif
 
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
@@ -424,8 +666,10 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
+#ifndef CONFIG_MM_MEMPOOL_LOCKFREE
   irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -437,12 +681,18 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  /* The block must be poisoned before another CPU can take it */
+
+  kasan_poison(blk, pool->blocksize);
+  mempool_lf_release(pool, blk);
+#else
+  pool->nalloc--;
+
   if (pool->interruptsize > blocksize)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -462,6 +712,8 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
   kasan_poison(blk, pool->blocksize);
   spin_unlock_irqrestore(&pool->lock, flags);
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -474,6 +726,115 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
     }
 }
 
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Give the memory of an expansion of the pool back if none of its blocks
+ *   is used.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *   base - The address returned by the alloc function of the pool for the
+ *          expansion.
+ *
+ * Returned Value:
+ *   OK on success; A negated errno value on any failure.
+ ****************************************************************************/
+
+int mempool_shrink(FAR struct mempool_s *pool, FAR void *base)
+{
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  /* The blocks cannot be taken out of the middle of a lock-free queue */
+
+  return -ENOSYS;
+#else
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *prev;
+  FAR sq_entry_t *blk;
+  FAR char *end;
+  irqstate_t flags;
+  size_t nexpand;
+  size_t count = 0;
+
+  if (pool->expandsize < blocksize + sizeof(sq_entry_t))
+    {
+      return -EINVAL;
+    }
+
+  nexpand = (pool->expandsize - sizeof(sq_entry_t)) / blocksize;
+  end     = (FAR char *)base + nexpand * blocksize;
+
+  flags = spin_lock_irqsave(&pool->lock);
+
+  /* The entry of the expansion is at its end.  The first one may be the
+   * initial memory, which has another size.
+   */
+
+  sq_for_every(&pool->equeue, entry)
+    {
+      if (entry == (FAR sq_entry_t *)end)
+        {
+          break;
+        }
+    }
+
+  if (entry == NULL || (entry == sq_peek(&pool->equeue) &&
+                        pool->initialsize >= blocksize + sizeof(sq_entry_t)))
+    {
+      spin_unlock_irqrestore(&pool->lock, flags);
+      return -EINVAL;
+    }
+
+  /* All blocks of the expansion must be free */
+
+  sq_for_every(&pool->queue, blk)
+    {
+      if ((FAR char *)blk >= (FAR char *)base && (FAR char *)blk < end)
+        {
+          count++;
+        }
+    }
+
+  if (count < nexpand)
+    {
+      spin_unlock_irqrestore(&pool->lock, flags);
+      return -EBUSY;
+    }
+
+  for (prev = NULL, blk = sq_peek(&pool->queue); blk != NULL; )
+    {
+      if ((FAR char *)blk >= (FAR char *)base && (FAR char *)blk < end)
+        {
+          if (prev != NULL)
+            {
+              sq_remafter(prev, &pool->queue);
+              blk = sq_next(prev);
+            }
+          else
+            {
+              sq_remfirst(&pool->queue);
+              blk = sq_peek(&pool->queue);
+            }
+        }
+      else
+        {
+          prev = blk;
+          blk  = sq_next(blk);
+        }
+    }
+
+  sq_rem(entry, &pool->equeue);
+  pool->nblocks -= nexpand;
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  base = kasan_unpoison(base, nexpand * blocksize + sizeof(sq_entry_t));
+  pool->free(pool, base);
+  return OK;
+#endif
+}
+
 /****************************************************************************
  * Name: mempool_info
  *
@@ -495,12 +856,21 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  info->aordblks = pool->nalloc;
+  info->ordblks = pool->nblocks - info->aordblks;
+  info->iordblks = 0;
+  flags = spin_lock_irqsave(&pool->lock);
+#else
   flags = spin_lock_irqsave(&pool->lock);
   info->ordblks = sq_count(&pool->queue);
   info->iordblks = sq_count(&pool->iqueue);
   info->aordblks = pool->nalloc;
+#endif
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
+  info->hwater = pool->hwater;
+  info->lwater = pool->lwater;
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = blocksize;
   if (pool->wait && pool->expandsize == 0)
@@ -534,11 +904,15 @@ mempool_info_task(FAR struct mempool_s *pool,
 
   if (task->pid == PID_MM_FREE)
     {
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+      size_t count = pool->nblocks - pool->nalloc;
+#else
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
                      sq_count(&pool->iqueue);
 
       spin_unlock_irqrestore(&pool->lock, flags);
+#endif
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
@@ -29,21 +29,63 @@
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/kasan.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_CACHE) && CONFIG_MM_HEAP_MEMPOOL_CACHE > 0
+#  define MEMPOOL_MULTIPLE_CACHE
+
+/* The number of blocks moved between a cache and its pool at a time */
+
+#  define MPOOL_CACHE_BATCH ((CONFIG_MM_HEAP_MEMPOOL_CACHE + 1) / 2)
+#endif
+
+/* Expansions trimmed after they were idle for MPOOL_IDLE_TICKS.  This needs
+ * a work queue, which user space only has with CONFIG_LIBC_USRWORK.
+ */
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_IDLE_TIME) && \
+    CONFIG_MM_HEAP_MEMPOOL_IDLE_TIME > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__) || \
+     defined(CONFIG_LIBC_USRWORK))
+#  define MEMPOOL_MULTIPLE_TRIM
+#  define MPOOL_IDLE_TICKS MSEC2TICK(CONFIG_MM_HEAP_MEMPOOL_IDLE_TIME)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef MEMPOOL_MULTIPLE_CACHE
+/* The free blocks of one pool cached by one CPU */
+
+struct mpool_cache_s
+{
+  size_t    count;
+  FAR void *blk[CONFIG_MM_HEAP_MEMPOOL_CACHE];
+};
+#endif
+
 struct mpool_dict_s
 {
   FAR struct mempool_s *pool; /* Record pool when expanding */
   FAR void             *addr; /* Record expand memary address */
   size_t                size; /* Record expand memary size */
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  atomic_t              used; /* Record used blocks of the expansion */
+  clock_t               idle; /* Record time the last block was freed */
+#endif
 };
 
 struct mpool_chunk_s
@@ -93,6 +135,18 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  /* The block caches, npools entries for each CPU */
+
+  FAR struct mpool_cache_s     *cache;
+#endif
+
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  /* The work that gives idle expansions back */
+
+  struct work_s                 work;
+#endif
 };
 
 /****************************************************************************
@@ -234,6 +288,7 @@ static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
 {
   FAR struct mempool_multiple_s *mpool = pool->priv;
   FAR void *ret;
+  size_t index;
   size_t row;
   size_t col;
 
@@ -246,13 +301,29 @@ static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
       return NULL;
     }
 
-  row = mpool->dict_used >> mpool->dict_col_num_log2;
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  /* Reuse the dictionary entry of a trimmed expansion */
+
+  for (index = 0; index < mpool->dict_used; index++)
+    {
+      row = index >> mpool->dict_col_num_log2;
+      col = index - (row << mpool->dict_col_num_log2);
+      if (mpool->dict[row][col].pool == NULL)
+        {
+          break;
+        }
+    }
+#else
+  index = mpool->dict_used;
+#endif
+
+  row = index >> mpool->dict_col_num_log2;
 
   /* There is no new pointer address to store the dictionaries */
 
   DEBUGASSERT(mpool->dict_row_num > row);
 
-  col = mpool->dict_used - (row << mpool->dict_col_num_log2);
+  col = index - (row << mpool->dict_col_num_log2);
 
   if (mpool->dict[row] == NULL)
     {
@@ -265,7 +336,15 @@ static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
   mpool->dict[row][col].pool = pool;
   mpool->dict[row][col].addr = ret;
   mpool->dict[row][col].size = mpool->minpoolsize + size;
-  *(FAR size_t *)ret = mpool->dict_used++;
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  atomic_set(&mpool->dict[row][col].used, 0);
+#endif
+  *(FAR size_t *)ret = index;
+  if (index == mpool->dict_used)
+    {
+      mpool->dict_used++;
+    }
+
   nxrmutex_unlock(&mpool->lock);
   return (FAR char *)ret + mpool->minpoolsize;
 }
@@ -358,6 +437,282 @@ static void mempool_multiple_check(FAR struct mempool_s *pool,
   assert(mempool_multiple_get_dict(pool->priv, blk));
 }
 
+#ifdef MEMPOOL_MULTIPLE_CACHE
+
+/****************************************************************************
+ * Name: mempool_multiple_cache
+ *
+ * Description:
+ *   Return the cache of a pool for the current CPU.  Interrupts must be
+ *   disabled so that the thread is not moved to another CPU.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mpool_cache_s *
+mempool_multiple_cache(FAR struct mempool_multiple_s *mpool,
+                       FAR struct mempool_s *pool)
+{
+  return &mpool->cache[this_cpu() * mpool->npools + (pool - mpool->pools)];
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_alloc
+ *
+ * Description:
+ *   Take a block from the cache of the current CPU.  If the cache is empty,
+ *   refill it with a batch of blocks from the pool.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *   pool  - The pool of the block.
+ *
+ * Returned Value:
+ *   The pointer to the allocated block on success; NULL if the pool has no
+ *   free block.
+ *
+ ****************************************************************************/
+
+static FAR void *
+mempool_multiple_cache_alloc(FAR struct mempool_multiple_s *mpool,
+                             FAR struct mempool_s *pool)
+{
+  FAR struct mpool_cache_s *cache;
+  FAR void *batch[MPOOL_CACHE_BATCH];
+  irqstate_t flags;
+  FAR void *blk;
+  size_t n;
+
+  flags = up_irq_save();
+  cache = mempool_multiple_cache(mpool, pool);
+  if (cache->count > 0)
+    {
+      blk = cache->blk[--cache->count];
+      up_irq_restore(flags);
+      return blk;
+    }
+
+  up_irq_restore(flags);
+
+  /* Refill from the pool with interrupts enabled, it may have to expand */
+
+  for (n = 0; n < MPOOL_CACHE_BATCH; n++)
+    {
+      batch[n] = mempool_allocate(pool);
+      if (batch[n] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (n == 0)
+    {
+      return NULL;
+    }
+
+  /* Keep one block to return, then cache as many of the others as fit.
+   * The thread may run on another CPU by now, whose cache is not empty.
+   */
+
+  blk = batch[--n];
+
+  flags = up_irq_save();
+  cache = mempool_multiple_cache(mpool, pool);
+  while (n > 0 && cache->count < CONFIG_MM_HEAP_MEMPOOL_CACHE)
+    {
+      cache->blk[cache->count++] = batch[--n];
+    }
+
+  up_irq_restore(flags);
+
+  while (n > 0)
+    {
+      mempool_release(pool, batch[--n]);
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_free
+ *
+ * Description:
+ *   Put a block in the cache of the current CPU.  If the cache is full,
+ *   drain a batch of blocks to the pool first.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *   pool  - The pool of the block.
+ *   blk   - The block to free.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_free(FAR struct mempool_multiple_s *mpool,
+                                        FAR struct mempool_s *pool,
+                                        FAR void *blk)
+{
+  FAR struct mpool_cache_s *cache;
+  FAR void *batch[MPOOL_CACHE_BATCH];
+  irqstate_t flags;
+  size_t n = 0;
+
+  flags = up_irq_save();
+  cache = mempool_multiple_cache(mpool, pool);
+  if (cache->count == CONFIG_MM_HEAP_MEMPOOL_CACHE)
+    {
+      while (n < MPOOL_CACHE_BATCH)
+        {
+          batch[n++] = cache->blk[--cache->count];
+        }
+    }
+
+  cache->blk[cache->count++] = blk;
+  up_irq_restore(flags);
+
+  while (n > 0)
+    {
+      mempool_release(pool, batch[--n]);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_drain
+ *
+ * Description:
+ *   Give the blocks of all caches back to their pools.
+ *
+ ****************************************************************************/
+
+static void
+mempool_multiple_cache_drain(FAR struct mempool_multiple_s *mpool)
+{
+  FAR struct mpool_cache_s *cache;
+  size_t i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS * mpool->npools; i++)
+    {
+      cache = &mpool->cache[i];
+      while (cache->count > 0)
+        {
+          mempool_release(mpool->pools + i % mpool->npools,
+                          cache->blk[--cache->count]);
+        }
+    }
+}
+
+#endif /* MEMPOOL_MULTIPLE_CACHE */
+
+#ifdef MEMPOOL_MULTIPLE_TRIM
+
+/****************************************************************************
+ * Name: mempool_multiple_trim
+ *
+ * Description:
+ *   The work that gives the expansions back to the heap which have not had
+ *   a used block for MPOOL_IDLE_TICKS.  It is queued again for expansions
+ *   that are not idle for long enough yet.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_trim(FAR void *arg)
+{
+  FAR struct mempool_multiple_s *mpool = arg;
+  FAR struct mpool_dict_s *dict;
+  clock_t delay = MPOOL_IDLE_TICKS;
+  bool pending = false;
+  clock_t elapsed;
+  clock_t now;
+  size_t index;
+  size_t row;
+  size_t col;
+
+  nxrmutex_lock(&mpool->lock);
+  now = clock_systime_ticks();
+
+  for (index = 0; index < mpool->dict_used; index++)
+    {
+      row  = index >> mpool->dict_col_num_log2;
+      col  = index - (row << mpool->dict_col_num_log2);
+      dict = &mpool->dict[row][col];
+
+      if (dict->pool == NULL || atomic_read(&dict->used) != 0)
+        {
+          continue;
+        }
+
+      elapsed = now - dict->idle;
+      if (elapsed < MPOOL_IDLE_TICKS)
+        {
+          delay   = MIN(delay, MPOOL_IDLE_TICKS - elapsed);
+          pending = true;
+          continue;
+        }
+
+      /* The pool checks again that all blocks are free:  Blocks held in
+       * the caches of the CPUs keep the expansion.
+       */
+
+      if (mempool_shrink(dict->pool,
+                         (FAR char *)dict->addr + mpool->minpoolsize) == 0)
+        {
+          dict->pool = NULL;
+          dict->addr = NULL;
+          dict->size = 0;
+        }
+    }
+
+  nxrmutex_unlock(&mpool->lock);
+
+  if (pending)
+    {
+      work_queue(LPWORK, &mpool->work, mempool_multiple_trim, mpool,
+                 delay);
+    }
+}
+
+#endif /* MEMPOOL_MULTIPLE_TRIM */
+
+/****************************************************************************
+ * Name: mempool_multiple_get / mempool_multiple_put
+ *
+ * Description:
+ *   Account a block allocated from or freed to its expansion.  The work
+ *   that trims the expansion is started when its last block is freed.
+ *
+ ****************************************************************************/
+
+static inline FAR void *
+mempool_multiple_get(FAR struct mempool_multiple_s *mpool, FAR void *blk)
+{
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  FAR struct mpool_dict_s *dict = mempool_multiple_get_dict(mpool, blk);
+
+  DEBUGASSERT(dict != NULL);
+  atomic_fetch_add_relaxed(&dict->used, 1);
+#endif
+
+  return blk;
+}
+
+static inline void
+mempool_multiple_put(FAR struct mempool_multiple_s *mpool,
+                     FAR struct mpool_dict_s *dict)
+{
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  if (atomic_fetch_sub_release(&dict->used, 1) == 1)
+    {
+      dict->idle = clock_systime_ticks();
+      if (work_available(&mpool->work))
+        {
+          work_queue(LPWORK, &mpool->work, mempool_multiple_trim, mpool,
+                     MPOOL_IDLE_TICKS);
+        }
+    }
+#else
+  UNUSED(mpool);
+  UNUSED(dict);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -405,6 +760,7 @@ mempool_multiple_init(FAR const char *name,
   FAR struct mempool_s *pools;
   size_t maxpoolszie;
   size_t minpoolsize;
+  size_t size;
   int ret;
   int i;
 
@@ -428,9 +784,13 @@ mempool_multiple_init(FAR const char *name,
         }
     }
 
-  mpool = alloc(arg, sizeof(uintptr_t),
-                sizeof(struct mempool_multiple_s) +
-                npools * sizeof(struct mempool_s));
+  size = sizeof(struct mempool_multiple_s) +
+         npools * sizeof(struct mempool_s);
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  size += CONFIG_SMP_NCPUS * npools * sizeof(struct mpool_cache_s);
+#endif
+
+  mpool = alloc(arg, sizeof(uintptr_t), size);
 
   if (mpool == NULL)
     {
@@ -453,6 +813,16 @@ mempool_multiple_init(FAR const char *name,
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
 
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  memset(&mpool->work, 0, sizeof(mpool->work));
+#endif
+
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  mpool->cache = (FAR struct mpool_cache_s *)(pools + npools);
+  memset(mpool->cache, 0,
+         CONFIG_SMP_NCPUS * npools * sizeof(struct mpool_cache_s));
+#endif
+
   for (i = 0; i < npools; i++)
     {
       pools[i].blocksize = poolsize[i];
@@ -537,6 +907,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 {
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
+  FAR void *blk;
 
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
@@ -545,13 +916,30 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
     }
 
   end = mpool->pools + mpool->npools;
-  do
+
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  /* Only the pool of the best size is cached, the larger ones are taken
+   * from directly when it is exhausted.
+   */
+
+  blk = mempool_multiple_cache_alloc(mpool, pool);
+  if (blk)
     {
-      FAR void *blk = mempool_allocate(pool);
+      return mempool_multiple_get(mpool, blk);
+    }
 
+  if (++pool == end)
+    {
+      return NULL;
+    }
+#endif
+
+  do
+    {
+      blk = mempool_allocate(pool);
       if (blk)
         {
-          return blk;
+          return mempool_multiple_get(mpool, blk);
         }
     }
   while (++pool < end);
@@ -634,7 +1022,12 @@ int mempool_multiple_free(FAR struct mempool_multiple_s *mpool,
                             ((FAR char *)kasan_reset_tag(dict->addr) +
                              mpool->minpoolsize)) %
                            MEMPOOL_REALBLOCKSIZE(dict->pool));
+  mempool_multiple_put(mpool, dict);
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  mempool_multiple_cache_free(mpool, dict->pool, blk);
+#else
   mempool_release(dict->pool, blk);
+#endif
   return 0;
 }
 
@@ -716,6 +1109,7 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
       FAR char *blk = mempool_allocate(pool);
       if (blk != NULL)
         {
+          mempool_multiple_get(mpool, blk);
           return (FAR void *)ALIGN_UP((uintptr_t)blk, alignment);
         }
     }
@@ -870,6 +1264,14 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
       return;
     }
 
+#ifdef MEMPOOL_MULTIPLE_TRIM
+  work_cancel_sync(LPWORK, &mpool->work);
+#endif
+
+#ifdef MEMPOOL_MULTIPLE_CACHE
+  mempool_multiple_cache_drain(mpool);
+#endif
+
   for (i = 0; i < mpool->npools; i++)
     {
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
@@ -42,7 +42,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define MEMPOOLINFO_LINELEN 80
+#define MEMPOOLINFO_LINELEN 100
 
 /****************************************************************************
  * Private Types
@@ -142,9 +142,9 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
   offset    = filep->f_pos;
   procfile  = filep->f_priv;
   linesize  = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                              "%13s%11s%9s%9s%9s%9s%9s\n", "", "total",
-                              "bsize", "nused", "nfree", "nifree",
-                              "nwaiter");
+                              "%13s%11s%9s%9s%9s%9s%9s%9s%9s\n", "",
+                              "total", "bsize", "nused", "nfree", "nifree",
+                              "nwaiter", "hwater", "lwater");
 
   copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                             &offset);
@@ -163,11 +163,13 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
 
           mempool_info(pool, &minfo);
           linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu\n",
+                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu"
+                                       "%9lu%9lu\n",
                                        entry->name, minfo.arena,
                                        minfo.sizeblks, minfo.aordblks,
                                        minfo.ordblks, minfo.iordblks,
-                                       minfo.nwaiter);
+                                       minfo.nwaiter, minfo.hwater,
+                                       minfo.lwater);
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
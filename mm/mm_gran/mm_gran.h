@@ -44,8 +44,17 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+
+/* The GAT is followed by two summary bitmaps with one bit for each of its
+ * cells:  The bit is set in the first one if the cell is full and in the
+ * second one if the cell is not empty.
+ */
+
+#define SIZEOF_GATS(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + 2 * SIZEOF_GATS(n) - 1))
 
 /* Debug */
 
@@ -87,7 +87,6 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
   uintptr_t retp;
   size_t nalign;
   size_t ngran;
-  size_t naligned_up;
   int posi;
   int ret;
 
@@ -95,8 +94,7 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
   nalign = NGRANULE(gran, align);
   ngran = NGRANULE(gran, size);
 
-  naligned_up = ngran + (nalign - 1);
-  if (!naligned_up || naligned_up > gran->ngranules)
+  if (!ngran || ngran > gran->ngranules)
     {
       return NULL;
     }
@@ -107,10 +105,9 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
       return NULL;
     }
 
-  posi = gran_search(gran, naligned_up);
+  posi = gran_search_align(gran, ngran, nalign > 0 ? nalign : 1);
   if (posi >= 0)
     {
-      posi = (posi + nalign - 1) & ~(nalign - 1);
       gran_set(gran, posi, ngran);
     }
 
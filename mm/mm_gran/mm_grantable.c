@@ -90,10 +90,91 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
+/* return the index of the lowest set bit of a non-zero value */
+
+static inline unsigned int gat_ctz(uint32_t v)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(v);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(v) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* return the first bit at or after idx that is set (or clear if set is
+ * false) in a bitmap of nbits bits, or nbits if there is none.  The bitmap
+ * is scanned a word at a time.
+ */
+
+static size_t gat_find(const uint32_t *map, size_t idx, size_t nbits,
+                       bool set)
+{
+  uint32_t inv = set ? 0 : GATCFULL;
+  size_t w = idx >> 5;
+  uint32_t v;
+
+  if (idx >= nbits)
+    {
+      return nbits;
+    }
+
+  v = (map[w] ^ inv) & ~(uint32_t)(BIT(idx & 31) - 1);
+  while (v == 0)
+    {
+      if (++w >= (nbits + 31) >> 5)
+        {
+          return nbits;
+        }
+
+      v = map[w] ^ inv;
+    }
+
+  idx = (w << 5) + gat_ctz(v);
+  return idx < nbits ? idx : nbits;
+}
+
+/* return the first free (or used if used is true) granule at or after
+ * posi, or ngranules if there is none.  Cells that are full (or empty) are
+ * skipped with the summary bitmaps 32 at a time.
+ */
+
+static size_t gran_next(const gran_t *gran, size_t posi, bool used)
+{
+  size_t ncells = SIZEOF_GAT(gran->ngranules);
+  size_t c = posi >> 5;
+  uint32_t rest;
+
+  if (posi >= gran->ngranules)
+    {
+      return gran->ngranules;
+    }
+
+  /* The part of the starting cell at and after posi */
+
+  rest = gran->gat[c] & ~(uint32_t)(BIT(posi & 31) - 1);
+  if (used ? rest == 0 : (rest | (uint32_t)(BIT(posi & 31) - 1)) == GATCFULL)
+    {
+      c = gat_find(used ? GATS_USED(gran) : GATS_FULL(gran), c + 1,
+                   ncells, used);
+      if (c >= ncells)
+        {
+          return gran->ngranules;
+        }
+
+      posi = c << 5;
+    }
+
+  return gat_find(gran->gat, posi, gran->ngranules, used);
+}
+
 /* set or clear a GAT cell with given bit mask */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
 {
+  uint32_t *full = GATS_FULL(gran);
+  uint32_t *used = GATS_USED(gran);
+  uint32_t bit = BIT(cell & 31);
+
   if (val)
     {
       gran->gat[cell] |= mask;
@@ -102,6 +183,26 @@ static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
     {
       gran->gat[cell] &= ~mask;
     }
+
+  /* Keep the summary bitmaps up to date */
+
+  if (gran->gat[cell] == GATCFULL)
+    {
+      full[cell >> 5] |= bit;
+    }
+  else
+    {
+      full[cell >> 5] &= ~bit;
+    }
+
+  if (gran->gat[cell] != 0)
+    {
+      used[cell >> 5] |= bit;
+    }
+  else
+    {
+      used[cell >> 5] &= ~bit;
+    }
 }
 
 /* set or clear a range of GAT bits */
@@ -259,24 +360,42 @@ failure:
 
 int gran_search(const gran_t *gran, size_t size)
 {
-  int ret = -EINVAL;
+  return gran_search_align(gran, size, 1);
+}
+
+/* returns granule number of aligned free range or negative error.  Each
+ * run of free granules is found with two word scans:  One for its first
+ * free granule and one for the used granule that ends it.
+ */
+
+int gran_search_align(const gran_t *gran, size_t size, size_t align)
+{
+  size_t posi = 0;
+  size_t end;
 
-  if (gran == NULL || gran->ngranules < size)
+  if (gran == NULL || gran->ngranules < size || align == 0 ||
+      (align & (align - 1)) != 0)
     {
-      return ret;
+      return -EINVAL;
     }
 
-  ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  for (; ; )
     {
-      if (gran_match(gran, i, size, 0, &i))
+      posi = gran_next(gran, posi, false);
+      posi = (posi + align - 1) & ~(align - 1);
+      if (posi + size > gran->ngranules)
         {
-          ret = i;
-          break;
+          return -ENOMEM;
         }
-    }
 
-  return ret;
+      end = gran_next(gran, posi, true);
+      if (end - posi >= size)
+        {
+          return posi;
+        }
+
+      posi = end;
+    }
 }
 
 /* set a range of granules */
@@ -59,6 +59,11 @@
 
 #define GATC_BITS(g)        (sizeof(g->gat[0]) << 3)
 
+/* The summary bitmaps of the full and of the non-empty GAT cells */
+
+#define GATS_FULL(g)        (&(g)->gat[SIZEOF_GAT((g)->ngranules)])
+#define GATS_USED(g)        (GATS_FULL(g) + SIZEOF_GATS((g)->ngranules))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -126,20 +131,23 @@ bool gran_match(const gran_t *gran, size_t posi, size_t size, bool used,
                 size_t *mism);
 
 /****************************************************************************
- * Name: gran_search
+ * Name: gran_search, gran_search_align
  *
  * Description:
- *   search for continuous range of free granules
+ *   search for continuous range of free granules, optionally starting at
+ *   a multiple of align granules.
  *
  * Input Parameters:
- *   gran - Pointer to the gran state
- *   size - Length of range
+ *   gran  - Pointer to the gran state
+ *   size  - Length of range
+ *   align - Alignment of the range in granules, a power of two
  *
  * Return value:
  *   position of negative error number.
  ****************************************************************************/
 
 int gran_search(const gran_t *gran, size_t size);
+int gran_search_align(const gran_t *gran, size_t size, size_t align);
 
 /****************************************************************************
  * Name: gran_set, gran_clear
@@ -29,8 +29,11 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -40,6 +43,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 /****************************************************************************
@@ -103,18 +107,52 @@
              tmp->backtrace[0] = NULL; \
            } \
          tmp->seqno = g_mm_seqno++; \
+         MM_PROFILE_ALLOC(heap, tmp); \
        } \
      while (0)
 #else
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* The sampling heap profiler keeps the backtrace of about one allocation
+ * in every CONFIG_MM_HEAP_PROFILE_RATE bytes allocated.
+ */
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+#  define MM_PROFILE_ALLOC(heap, node) mm_profile_alloc(heap, node)
+#  define MM_PROFILE_FREE(heap, node)  mm_profile_free(heap, node)
+#else
+#  define MM_PROFILE_ALLOC(heap, node)
+#  define MM_PROFILE_FREE(heap, node)
+#endif
+
+/* The deferred frees are given back by the low priority work queue */
+
+#if defined(CONFIG_MM_FREE_DELAY_WORK) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_DELAY_WORK
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* Each power of two size range below MM_MAX_CHUNK is divided into
+ * MM_SL_COUNT free lists, all the larger chunks share the last list.
+ */
+
+#ifdef CONFIG_MM_HEAP_SL_SHIFT
+#  define MM_SL_SHIFT    CONFIG_MM_HEAP_SL_SHIFT
+#else
+#  define MM_SL_SHIFT    0
+#endif
+
+#define MM_SL_COUNT      (1 << MM_SL_SHIFT)
+#define MM_SL_MASK       (MM_SL_COUNT - 1)
+#define MM_NLISTS        (((MM_NNODES - 1) << MM_SL_SHIFT) + 1)
+
 #define MM_GRAN_MASK     (MM_ALIGN - 1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -181,6 +219,9 @@ struct mm_allocnode_s
 #  if CONFIG_MM_BACKTRACE > 0
   FAR void *backtrace[CONFIG_MM_BACKTRACE]; /* The backtrace buffer for caller */
 #  endif
+#  ifdef CONFIG_MM_HEAP_PROFILE
+  uint16_t profsite;                        /* The profile site + 1, or 0 */
+#  endif
 #endif
 };
 
@@ -196,6 +237,9 @@ struct mm_freenode_s
 #  if CONFIG_MM_BACKTRACE > 0
   FAR void *backtrace[CONFIG_MM_BACKTRACE]; /* The backtrace buffer for caller */
 #  endif
+#  ifdef CONFIG_MM_HEAP_PROFILE
+  uint16_t profsite;                        /* The profile site + 1, or 0 */
+#  endif
 #endif
   FAR struct mm_freenode_s *flink;          /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
@@ -204,15 +248,48 @@ struct mm_freenode_s
 static_assert(MM_SIZEOF_ALLOCNODE <= MM_MIN_CHUNK,
               "Error size for struct mm_allocnode_s\n");
 
+static_assert(MM_NNODES <= 32 && MM_SL_SHIFT <= MM_MIN_SHIFT,
+              "Error free list bitmap size\n");
+
 static_assert(MM_ALIGN >= sizeof(uintptr_t) &&
               (MM_ALIGN & MM_GRAN_MASK) == 0,
               "Error memory alignment\n");
 
+#ifdef CONFIG_MM_REGION_ATTR
+static_assert(CONFIG_MM_REGIONS <= 32, "Error region bitmap size\n");
+#endif
+
 struct mm_delaynode_s
 {
   FAR struct mm_delaynode_s *flink;
 };
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* The allocations sampled at one call site.  The counts are estimates of
+ * all the allocations made there:  A sampled allocation of size bytes
+ * stands for MAX(size, CONFIG_MM_HEAP_PROFILE_RATE) bytes.
+ */
+
+struct mm_profsite_s
+{
+  FAR void *backtrace[CONFIG_MM_BACKTRACE];
+  size_t    inuse_objs;  /* The allocations not freed yet */
+  size_t    inuse_bytes;
+  size_t    alloc_objs;  /* All the allocations since boot */
+  size_t    alloc_bytes;
+};
+
+struct mm_profile_s
+{
+  spinlock_t lock;
+  ssize_t    countdown;  /* The bytes left until the next sample */
+
+  /* The call sites, the last one gets the samples that do not fit */
+
+  struct mm_profsite_s site[CONFIG_MM_HEAP_PROFILE_SITES + 1];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -242,19 +319,55 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_REGION_ATTR
+  /* The attributes of each region and the size of its free chunks */
+
+  uint32_t mm_regionattr[CONFIG_MM_REGIONS];
+  size_t   mm_regionfree[CONFIG_MM_REGIONS];
+#endif
+
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
-   * speed up searching of free nodes.
+   * speed up searching of free nodes.  The nodes that follow a hook
+   * up to the next hook form one segregated free list.
+   */
+
+  struct mm_freenode_s mm_nodelist[MM_NLISTS];
+
+  /* Bitmaps of the non-empty free lists:  Bit n of mm_slbitmap[i] is set
+   * if list (i << MM_SL_SHIFT) + n is not empty, and bit i of mm_flbitmap
+   * if mm_slbitmap[i] is not zero.
    */
 
-  struct mm_freenode_s mm_nodelist[MM_NNODES];
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NNODES];
 
-  /* Free delay list, as sometimes we can't do free immdiately. */
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* The number of free chunks and of failed allocations of each power of
+   * two size class, see mm_fraginfo().
+   */
 
-  FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
+  size_t   mm_nfree[MM_NNODES];
+  atomic_t mm_nfail[MM_NNODES];
+#endif
+
+  /* Free delay list, as sometimes we can't do free immdiately.  The
+   * deferred frees are pushed onto it without a lock from any context and
+   * the whole list is taken at once when it is drained.
+   */
+
+#if UINTPTR_MAX <= UINT32_MAX
+  atomic_t mm_delaylist;
+#else
+  atomic64_t mm_delaylist;
+#endif
 
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  size_t mm_delaycount[CONFIG_SMP_NCPUS];
+  atomic_t mm_delaycount;
+#endif
+
+#ifdef MM_DELAY_WORK
+  struct work_s mm_delaywork;
 #endif
 
   /* The is a multiple mempool of the heap */
@@ -267,6 +380,10 @@ struct mm_heap_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+  struct mm_profile_s mm_profile;
+#endif
 };
 
 /* This describes the callback for mm_foreach */
@@ -298,6 +415,19 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
+bool mm_delaylist_drain(FAR struct mm_heap_s *heap, bool force);
+void mm_delaylist_kick(FAR struct mm_heap_s *heap);
+
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+void mm_profile_initialize(FAR struct mm_heap_s *heap);
+void mm_profile_alloc(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node);
+void mm_profile_free(FAR struct mm_heap_s *heap,
+                     FAR struct mm_allocnode_s *node);
+void mm_profile_dump(FAR struct mm_heap_s *heap);
+#endif
 
 /****************************************************************************
  * Inline Functions
@@ -305,14 +435,86 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
 static inline_function int mm_size2ndx(size_t size)
 {
+  int fl;
+
   DEBUGASSERT(size >= MM_MIN_CHUNK);
   if (size >= MM_MAX_CHUNK)
     {
-      return MM_NNODES - 1;
+      return MM_NLISTS - 1;
+    }
+
+  fl = flsl(size >> MM_MIN_SHIFT) - 1;
+  return (fl << MM_SL_SHIFT) |
+         ((size >> (fl + MM_MIN_SHIFT - MM_SL_SHIFT)) & MM_SL_MASK);
+}
+
+#ifdef CONFIG_MM_REGION_ATTR
+/* Return true if a region with the attributes regattr fits the attributes
+ * attr asked for:  It has all of them and, if it is to be CPU local, it is
+ * local to this CPU.
+ */
+
+static inline_function bool mm_region_match(uint32_t regattr, uint32_t attr)
+{
+  uint32_t want = attr & MM_REGION_ATTRMASK;
+
+  if ((regattr & want) != want)
+    {
+      return false;
+    }
+
+  return (want & MM_REGION_CPULOCAL) == 0 ||
+         MM_REGION_CPUOF(regattr) == this_cpu();
+}
+
+/* Return the region that contains a node */
+
+static inline_function int mm_node2region(FAR struct mm_heap_s *heap,
+                                          FAR void *node)
+{
+  int i;
+
+  for (i = 0; i < heap->mm_nregions - 1; i++)
+    {
+      if ((uintptr_t)node >= (uintptr_t)heap->mm_heapstart[i] &&
+          (uintptr_t)node < (uintptr_t)heap->mm_heapend[i])
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+#endif
+
+/* Return the first non-empty free list at or above ndx, or -1 */
+
+static inline_function int mm_nextfreelist(FAR struct mm_heap_s *heap,
+                                           int ndx)
+{
+  uint32_t map;
+  int fl;
+
+  if (ndx >= MM_NLISTS)
+    {
+      return -1;
     }
 
-  size >>= MM_MIN_SHIFT;
-  return flsl(size) - 1;
+  fl  = ndx >> MM_SL_SHIFT;
+  map = heap->mm_slbitmap[fl] & (UINT32_MAX << (ndx & MM_SL_MASK));
+  if (map == 0)
+    {
+      map = heap->mm_flbitmap & ~((UINT32_C(2) << fl) - 1);
+      if (map == 0)
+        {
+          return -1;
+        }
+
+      fl  = ffs(map) - 1;
+      map = heap->mm_slbitmap[fl];
+    }
+
+  return (fl << MM_SL_SHIFT) | (ffs(map) - 1);
 }
 
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
@@ -328,14 +530,20 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
   /* Convert the size to a nodelist index */
 
-  ndx = mm_size2ndx(nodesize);
+  ndx  = mm_size2ndx(nodesize);
+  prev = &heap->mm_nodelist[ndx];
+  next = prev->flink;
 
-  /* Now put the new node into the next */
+  /* Every chunk of a list fits the requests for the next smaller lists,
+   * so the new node simply goes at the head.  Only the last list, whose
+   * sizes are unbounded, is kept ordered by size.
+   */
 
-  for (prev = &heap->mm_nodelist[ndx],
-       next = heap->mm_nodelist[ndx].flink;
-       next && next->size && MM_SIZEOF_NODE(next) < nodesize;
-       prev = next, next = next->flink);
+  if (ndx == MM_NLISTS - 1)
+    {
+      for (; next && MM_SIZEOF_NODE(next) < nodesize;
+           prev = next, next = next->flink);
+    }
 
   /* Does it go in mid next or at the end? */
 
@@ -349,6 +557,93 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
       next->blink = node;
     }
+
+  heap->mm_slbitmap[ndx >> MM_SL_SHIFT] |=
+    UINT32_C(1) << (ndx & MM_SL_MASK);
+  heap->mm_flbitmap |= UINT32_C(1) << (ndx >> MM_SL_SHIFT);
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  heap->mm_nfree[ndx >> MM_SL_SHIFT]++;
+#endif
+#ifdef CONFIG_MM_REGION_ATTR
+  heap->mm_regionfree[mm_node2region(heap, node)] += nodesize;
+#endif
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *next = node->flink;
+  FAR struct mm_freenode_s *prev = node->blink;
+  int ndx;
+
+  /* Remove the node.  There must be a predecessor, but there may not be
+   * a successor node.
+   */
+
+  DEBUGASSERT(prev && prev->flink == node);
+  prev->flink = next;
+  if (next)
+    {
+      next->blink = prev;
+    }
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  heap->mm_nfree[mm_size2ndx(MM_SIZEOF_NODE(node)) >> MM_SL_SHIFT]--;
+#endif
+#ifdef CONFIG_MM_REGION_ATTR
+  heap->mm_regionfree[mm_node2region(heap, node)] -= MM_SIZEOF_NODE(node);
+#endif
+
+  /* The list is empty if the node was between two hooks */
+
+  if (prev->size == 0 && (next == NULL || next->size == 0))
+    {
+      ndx = prev - heap->mm_nodelist;
+      heap->mm_slbitmap[ndx >> MM_SL_SHIFT] &=
+        ~(UINT32_C(1) << (ndx & MM_SL_MASK));
+      if (heap->mm_slbitmap[ndx >> MM_SL_SHIFT] == 0)
+        {
+          heap->mm_flbitmap &= ~(UINT32_C(1) << (ndx >> MM_SL_SHIFT));
+        }
+    }
+}
+
+/* Return a free node of at least size bytes, or NULL */
+
+static inline_function FAR struct mm_freenode_s *
+mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  int ndx = mm_size2ndx(size);
+
+  /* The first node of the list of the size often fits, otherwise any node
+   * of the next non-empty list does.
+   */
+
+  node = heap->mm_nodelist[ndx].flink;
+  if (node && MM_SIZEOF_NODE(node) >= size)
+    {
+      return node;
+    }
+
+  ndx = mm_nextfreelist(heap, ndx + 1);
+  if (ndx >= 0)
+    {
+      return heap->mm_nodelist[ndx].flink;
+    }
+
+  /* Finally try the other nodes of the list of the size */
+
+  for (; node && node->size != 0; node = node->flink)
+    {
+      if (MM_SIZEOF_NODE(node) >= size)
+        {
+          return node;
+        }
+    }
+
+  return NULL;
 }
 
 #endif /* __MM_MM_HEAP_MM_H */
@@ -37,19 +37,43 @@
 
 #include "mm_heap/mm.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The delay list head holds a node pointer in an atomic integer */
+
+#if UINTPTR_MAX <= UINT32_MAX
+typedef int32_t delaylist_t;
+#  define delaylist_read(l)           atomic_read_acquire(l)
+#  define delaylist_xchg(l, v)        atomic_xchg_acquire(l, v)
+#  define delaylist_cmpxchg(l, e, d)  atomic_try_cmpxchg_release(l, e, d)
+#else
+typedef int64_t delaylist_t;
+#  define delaylist_read(l)           atomic64_read_acquire(l)
+#  define delaylist_xchg(l, v)        atomic64_xchg_acquire(l, v)
+#  define delaylist_cmpxchg(l, e, d)  atomic64_try_cmpxchg_release(l, e, d)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: add_delaylist
+ *
+ * Description:
+ *   Push a memory chunk onto the delay list.  The list has many producers
+ *   and its only consumer takes the whole list at once, so a compare and
+ *   swap of the head is all the synchronization needed.
+ *
+ ****************************************************************************/
+
 static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 {
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   FAR struct mm_delaynode_s *tmp = mem;
-  irqstate_t flags;
-
-  /* Delay the deallocation until a more appropriate time. */
-
-  flags = mm_lock_irq(heap);
+  delaylist_t head;
 
 #  ifdef CONFIG_DEBUG_ASSERTIONS
   FAR struct mm_freenode_s *node;
@@ -58,30 +82,32 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
   DEBUGASSERT(MM_NODE_IS_ALLOC(node));
 #  endif
 
-  tmp->flink = heap->mm_delaylist[this_cpu()];
-  heap->mm_delaylist[this_cpu()] = tmp;
+  /* Delay the deallocation until a more appropriate time. */
+
+  head = delaylist_read(&heap->mm_delaylist);
+  do
+    {
+      tmp->flink = (FAR struct mm_delaynode_s *)(uintptr_t)head;
+    }
+  while (!delaylist_cmpxchg(&heap->mm_delaylist, &head,
+                            (delaylist_t)(uintptr_t)tmp));
 
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  heap->mm_delaycount[this_cpu()]++;
+  atomic_fetch_add(&heap->mm_delaycount, 1);
 #endif
-
-  mm_unlock_irq(heap, flags);
 #endif
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mm_delayfree
+ * Name: free_chunk
  *
  * Description:
- *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *   Return a chunk to the free lists, merging it with its free neighbours.
+ *   The caller holds the heap lock.
  *
  ****************************************************************************/
 
-void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+static void free_chunk(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -89,42 +115,17 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   size_t nodesize;
   size_t prevsize;
 
-  if (mm_lock(heap) < 0)
-    {
-      /* Meet -ESRCH return, which means we are in situations
-       * during context switching(See mm_lock() & gettid()).
-       * Then add to the delay list.
-       */
-
-      add_delaylist(heap, mem);
-      return;
-    }
-
   nodesize = mm_malloc_size(heap, mem);
-#ifdef CONFIG_MM_FILL_ALLOCATIONS
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  /* If delay free is enabled, a memory node will be freed twice.
-   * The first time is to add the node to the delay list, and the second
-   * time is to actually free the node. Therefore, we only colorize the
-   * memory node the first time, when `delay` is set to true.
+#if defined(CONFIG_MM_FILL_ALLOCATIONS) && CONFIG_MM_FREE_DELAYCOUNT_MAX == 0
+  /* If delay free is enabled, the node was colorized when it was added to
+   * the delay list.
    */
 
-  if (delay)
-#endif
-    {
-      memset(mem, MM_FREE_MAGIC, nodesize);
-    }
+  memset(mem, MM_FREE_MAGIC, nodesize);
 #endif
 
   kasan_poison(mem, nodesize);
 
-  if (delay)
-    {
-      mm_unlock(heap);
-      add_delaylist(heap, mem);
-      return;
-    }
-
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)
@@ -134,6 +135,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Sanity check against double-frees */
 
   DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+  MM_PROFILE_FREE(heap, (FAR struct mm_allocnode_s *)node);
 
   node->size &= ~MM_ALLOC_BIT;
 
@@ -164,12 +166,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
        * but there may not be a successor node.
        */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -199,12 +196,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
        * not be a successor node.
        */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -217,9 +209,158 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+#ifdef MM_DELAY_WORK
+static void delaylist_worker(FAR void *arg)
+{
+  mm_delaylist_drain(arg, true);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+{
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  if (delay)
+    {
+      size_t nodesize = mm_malloc_size(heap, mem);
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      /* If delay free is enabled, a memory node will be freed twice.
+       * The first time is to add the node to the delay list, and the
+       * second time is to actually free the node. Therefore, we only
+       * colorize the memory node the first time.
+       */
+
+      memset(mem, MM_FREE_MAGIC, nodesize);
+#endif
+
+      kasan_poison(mem, nodesize);
+      mm_unlock(heap);
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  free_chunk(heap, mem);
   mm_unlock(heap);
 }
 
+/****************************************************************************
+ * Name: mm_delaylist_drain
+ *
+ * Description:
+ *   Free all the memory in the delay list in one pass with the heap lock
+ *   held once.  Set force to true to free it immediately; set to false it
+ *   is only freed when CONFIG_MM_FREE_DELAYCOUNT_MAX chunks are delayed,
+ *   if that is enabled.
+ *
+ *   Return true if there is memory freed.
+ *
+ ****************************************************************************/
+
+bool mm_delaylist_drain(FAR struct mm_heap_s *heap, bool force)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp;
+  FAR struct mm_delaynode_s *next;
+  int count = 0;
+
+  if (delaylist_read(&heap->mm_delaylist) == 0)
+    {
+      return false;
+    }
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  if (!force &&
+      atomic_read(&heap->mm_delaycount) < CONFIG_MM_FREE_DELAYCOUNT_MAX)
+    {
+      return false;
+    }
+#endif
+
+  /* The chunks stay on the list if the heap can not be locked now */
+
+  if (mm_lock(heap) < 0)
+    {
+      return false;
+    }
+
+  tmp = (FAR struct mm_delaynode_s *)(uintptr_t)
+        delaylist_xchg(&heap->mm_delaylist, 0);
+
+  for (; tmp != NULL; tmp = next, count++)
+    {
+      next = tmp->flink;
+      free_chunk(heap, tmp);
+    }
+
+  mm_unlock(heap);
+
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  atomic_fetch_sub(&heap->mm_delaycount, count);
+#endif
+
+  return count > 0;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_delaylist_kick
+ *
+ * Description:
+ *   Called on each allocation to give back the delayed memory when it is
+ *   time.  With CONFIG_MM_FREE_DELAY_WORK this only queues the drain on
+ *   the low priority work queue, so the latency of an allocation does not
+ *   depend on the number of delayed frees.
+ *
+ ****************************************************************************/
+
+void mm_delaylist_kick(FAR struct mm_heap_s *heap)
+{
+#ifdef MM_DELAY_WORK
+  if (delaylist_read(&heap->mm_delaylist) == 0 ||
+      !work_available(&heap->mm_delaywork) || up_interrupt_context())
+    {
+      return;
+    }
+
+#  if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  if (atomic_read(&heap->mm_delaycount) < CONFIG_MM_FREE_DELAYCOUNT_MAX)
+    {
+      return;
+    }
+#  endif
+
+  work_queue(LPWORK, &heap->mm_delaywork, delaylist_worker, heap, 0);
+#else
+  mm_delaylist_drain(heap, false);
+#endif
+}
+
 /****************************************************************************
  * Name: mm_free
  *
@@ -259,7 +259,7 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   /* Initialize the node array */
 
-  for (i = 1; i < MM_NNODES; i++)
+  for (i = 1; i < MM_NLISTS; i++)
     {
       heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
@@ -271,6 +271,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   nxmutex_init(&heap->mm_lock);
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+  mm_profile_initialize(heap);
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   heap->mm_procfs.name = name;
@@ -371,6 +375,10 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 {
   int i;
 
+#ifdef MM_DELAY_WORK
+  work_cancel_sync(LPWORK, &heap->mm_delaywork);
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
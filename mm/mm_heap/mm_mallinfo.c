@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -43,6 +44,12 @@ struct mm_mallinfo_handler_s
   FAR struct mallinfo_task *info;
 };
 
+struct mm_heapfree_handler_s
+{
+  mm_heapfree_handler_t handler;
+  FAR void *arg;
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -113,6 +120,24 @@ static void mallinfo_task_handler(FAR struct mm_allocnode_s *node,
     }
 }
 
+static void heapfree_handler(FAR struct mm_allocnode_s *node,
+                             FAR void *arg)
+{
+  FAR struct mm_heapfree_handler_s *handler = arg;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+
+  /* Skip the header and the list links of the free chunk.  The size of
+   * the chunk, that the next chunk holds, lies past its end.
+   */
+
+  if (MM_NODE_IS_FREE(node) && nodesize > sizeof(struct mm_freenode_s))
+    {
+      handler->handler((FAR char *)node + sizeof(struct mm_freenode_s),
+                       nodesize - sizeof(struct mm_freenode_s),
+                       handler->arg);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -204,15 +229,90 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   FAR struct mm_freenode_s *node;
-  for (node = heap->mm_nodelist[MM_NNODES - 1].blink; node;
-       node = node->blink)
+  size_t largest = 0;
+  int ndx;
+  int fl;
+
+  /* The largest chunk is in the last non-empty list */
+
+  fl = fls(heap->mm_flbitmap) - 1;
+  if (fl < 0)
     {
-      size_t nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize != 0)
-        {
-          return nodesize;
-        }
+      return 0;
+    }
+
+  ndx = (fl << MM_SL_SHIFT) | (fls(heap->mm_slbitmap[fl]) - 1);
+  for (node = heap->mm_nodelist[ndx].flink; node && node->size != 0;
+       node = node->flink)
+    {
+      largest = MAX(largest, MM_SIZEOF_NODE(node));
+    }
+
+  return largest;
+}
+
+/****************************************************************************
+ * Name: mm_heapfree_foreach
+ *
+ * Description:
+ *   Visit the free chunks of the heap, for the code that can do without
+ *   their content, e.g. a core dump.  The chunks of the mempools are not
+ *   visited.  Nothing is visited if the heap cannot be locked.
+ *
+ ****************************************************************************/
+
+void mm_heapfree_foreach(FAR struct mm_heap_s *heap,
+                         mm_heapfree_handler_t handler, FAR void *arg)
+{
+  struct mm_heapfree_handler_s priv;
+
+  priv.handler = handler;
+  priv.arg     = arg;
+  mm_foreach(heap, heapfree_handler, &priv);
+}
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the fragmentation of the heap:  The histogram of the sizes of
+ *   the free chunks and of the failed allocations and the external
+ *   fragmentation index, the part of the free memory that is not in the
+ *   largest free chunk, in permille.  The counts are kept up to date as
+ *   the chunks are freed and allocated, so that the heap is not walked.
+ *
+ ****************************************************************************/
+
+int mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+  int ret;
+  int i;
+
+  memset(info, 0, sizeof(*info));
+
+  ret = mm_lock(heap);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < MM_NNODES; i++)
+    {
+      info->nfree[i + MM_MIN_SHIFT] = heap->mm_nfree[i];
+      info->nfail[i + MM_MIN_SHIFT] = atomic_read(&heap->mm_nfail[i]);
+    }
+
+  info->fordblks = mm_heapfree(heap);
+  info->mxordblk = mm_heapfree_largest(heap);
+  mm_unlock(heap);
+
+  if (info->fordblks > 0)
+    {
+      info->fragindex = 1000 - (int)((uint64_t)info->mxordblk * 1000 /
+                                     info->fordblks);
     }
 
-  return 0;
+  return OK;
 }
+#endif
@@ -42,73 +42,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: free_delaylist
- *
- * Description:
- *  Free the memory in delay list either added because of mm_lock failed or
- *  added because of CONFIG_MM_FREE_DELAYCOUNT_MAX.
- *  Set force to true to free all the memory in delay list immediately, set
- *  to false will only free delaylist when time is up if
- *  CONFIG_MM_FREE_DELAYCOUNT_MAX is enabled.
- *
- *  Return true if there is memory freed.
- *
- ****************************************************************************/
-
-static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
-{
-  bool ret = false;
-#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-  FAR struct mm_delaynode_s *tmp;
-  irqstate_t flags;
-
-  /* Move the delay list to local */
-
-  flags = mm_lock_irq(heap);
-
-  tmp = heap->mm_delaylist[this_cpu()];
-
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  if (tmp == NULL ||
-      (!force &&
-        heap->mm_delaycount[this_cpu()] < CONFIG_MM_FREE_DELAYCOUNT_MAX))
-    {
-      mm_unlock_irq(heap, flags);
-      return false;
-    }
-
-  heap->mm_delaycount[this_cpu()] = 0;
-#endif
-
-  heap->mm_delaylist[this_cpu()] = NULL;
-
-  mm_unlock_irq(heap, flags);
-
-  /* Test if the delayed is empty */
-
-  ret = tmp != NULL;
-
-  while (tmp)
-    {
-      FAR void *address;
-
-      /* Get the first delayed deallocation */
-
-      address = tmp;
-      tmp = tmp->flink;
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
-
-      mm_delayfree(heap, address, false);
-    }
-
-#endif
-  return ret;
-}
-
 #if CONFIG_MM_BACKTRACE >= 0
 void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
 {
@@ -136,51 +69,83 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
 }
 #endif
 
+#ifdef CONFIG_MM_REGION_ATTR
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mm_free_delaylist
+ * Name: malloc_findregion
  *
  * Description:
- *   force freeing the delaylist of this heap.
+ *  Return a free node of at least size bytes in one of the regions with
+ *  the attributes, or any free node unless MM_REGION_STRICT is given.  The
+ *  free lists are shared by all regions, so the nodes of the lists that
+ *  fit are walked, but only if a region with the attributes has that much
+ *  free memory at all.
  *
  ****************************************************************************/
 
-void mm_free_delaylist(FAR struct mm_heap_s *heap)
+static FAR struct mm_freenode_s *
+malloc_findregion(FAR struct mm_heap_s *heap, size_t size, uint32_t attr)
 {
-  if (heap)
+  FAR struct mm_freenode_s *node;
+  uint32_t regions = 0;
+  int ndx;
+  int i;
+
+  for (i = 0; i < heap->mm_nregions; i++)
+    {
+      if (mm_region_match(heap->mm_regionattr[i], attr) &&
+          heap->mm_regionfree[i] >= size)
+        {
+          regions |= UINT32_C(1) << i;
+        }
+    }
+
+  for (ndx = mm_size2ndx(size); regions != 0 &&
+       (ndx = mm_nextfreelist(heap, ndx)) >= 0; ndx++)
+    {
+      for (node = heap->mm_nodelist[ndx].flink; node && node->size != 0;
+           node = node->flink)
+        {
+          if (MM_SIZEOF_NODE(node) >= size &&
+              (regions & (UINT32_C(1) << mm_node2region(heap, node))))
+            {
+              return node;
+            }
+        }
+    }
+
+  if (attr & MM_REGION_STRICT)
     {
-       free_delaylist(heap, true);
+      return NULL;
     }
+
+  return mm_findfreechunk(heap, size);
 }
+#endif
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: malloc_attr
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
- *
- *  8-byte alignment of the allocated data is assured.
+ *  Find the smallest chunk that satisfies the request, in a region with
+ *  the attributes if there are any. Take the memory from that chunk, save
+ *  the remaining, smaller chunk (if any).
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+static FAR void *malloc_attr(FAR struct mm_heap_s *heap, size_t size,
+                             uint32_t attr)
 {
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
-  int ndx;
 
-  /* Free the delay list first */
+  /* Give the delay list back first, or have it given back */
 
-  free_delaylist(heap, false);
+  mm_delaylist_kick(heap);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (heap->mm_mpool && attr == 0)
     {
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
@@ -214,30 +179,28 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGVERIFY(mm_lock(heap));
 
-  /* Convert the request size into a nodelist index */
-
-  ndx = mm_size2ndx(alignsize);
-
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
+  /* Search for a large enough chunk in the segregated free lists.  The
+   * bitmaps of the non-empty lists make this a constant time operation
+   * unless only the list of the request size has a chunk that fits.
    */
 
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
+#ifdef CONFIG_MM_REGION_ATTR
+  if (attr != 0)
+    {
+      node = malloc_findregion(heap, alignsize, attr);
+    }
+  else
+#endif
+    {
+      node = mm_findfreechunk(heap, alignsize);
+    }
+
+  if (node)
     {
       DEBUGASSERT(node->blink->flink == node);
       nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize >= alignsize)
-        {
-          break;
-        }
     }
 
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that it must be the best fitting chunk
-   * available.
-   */
-
   if (node)
     {
       FAR struct mm_freenode_s *remainder;
@@ -248,12 +211,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
        * a successor node.
        */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -342,12 +300,12 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #endif
     }
 
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0 || defined(MM_DELAY_WORK)
   /* Try again after free delay list */
 
-  else if (free_delaylist(heap, true))
+  else if (mm_delaylist_drain(heap, true))
     {
-      return mm_malloc(heap, size);
+      return malloc_attr(heap, size, attr);
     }
 #endif
 
@@ -408,6 +366,68 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  if (ret == NULL)
+    {
+      atomic_fetch_add(&heap->mm_nfail[mm_size2ndx(alignsize) >>
+                                       MM_SL_SHIFT], 1);
+    }
+#endif
+
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_free_delaylist
+ *
+ * Description:
+ *   force freeing the delaylist of this heap.
+ *
+ ****************************************************************************/
+
+void mm_free_delaylist(FAR struct mm_heap_s *heap)
+{
+  if (heap)
+    {
+       mm_delaylist_drain(heap, true);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  return malloc_attr(heap, size, 0);
+}
+
+#ifdef CONFIG_MM_REGION_ATTR
+/****************************************************************************
+ * Name: mm_malloc_attr
+ *
+ * Description:
+ *  Allocate from the regions with the given attributes, see
+ *  mm_region_setattr().  The other regions are used if none of them has a
+ *  chunk that fits unless MM_REGION_STRICT is given.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc_attr(FAR struct mm_heap_s *heap, size_t size,
+                         uint32_t attr)
+{
+  return malloc_attr(heap, size, attr & ~MM_REGION_STRICT ? attr : 0);
+}
+#endif
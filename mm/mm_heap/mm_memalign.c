@@ -36,24 +36,29 @@
 #include "mm_heap/mm.h"
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_MM_REGION_ATTR
+#  define mm_malloc_attr(heap, size, attr) mm_malloc(heap, size)
+#endif
+
 /****************************************************************************
- * Name: mm_memalign
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memalign_attr
  *
  * Description:
  *   memalign requests more than enough space from malloc, finds a region
  *   within that chunk that meets the alignment request and then frees any
  *   leading or trailing space.
  *
- *   The alignment argument must be a power of two. 16-byte alignment is
- *   guaranteed by normal malloc calls.
- *
  ****************************************************************************/
 
-FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
-                      size_t size)
+static FAR void *memalign_attr(FAR struct mm_heap_s *heap, size_t alignment,
+                               size_t size, uint32_t attr)
 {
   FAR struct mm_allocnode_s *node;
   uintptr_t rawchunk;
@@ -77,7 +82,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (heap->mm_mpool && attr == 0)
     {
       node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
       if (node != NULL)
@@ -93,7 +98,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_ALIGN)
     {
-      FAR void *ptr = mm_malloc(heap, size);
+      FAR void *ptr = mm_malloc_attr(heap, size, attr);
       DEBUGASSERT(ptr == NULL || ((uintptr_t)ptr) % alignment == 0);
       return ptr;
     }
@@ -133,7 +138,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (uintptr_t)mm_malloc(heap, allocsize);
+  rawchunk = (uintptr_t)mm_malloc_attr(heap, allocsize, attr);
   if (rawchunk == 0)
     {
       return NULL;
@@ -156,6 +161,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - MM_SIZEOF_ALLOCNODE);
   heap->mm_curused -= MM_SIZEOF_NODE(node);
+  MM_PROFILE_FREE(heap, node);
 
   /* Find the aligned subregion */
 
@@ -213,12 +219,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
            * not be a successor node.
            */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += MM_SIZEOF_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
@@ -292,3 +293,41 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
         rawchunk, alignedchunk, size);
   return (FAR void *)alignedchunk;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   Allocate an aligned chunk of memory.
+ *
+ *   The alignment argument must be a power of two. 16-byte alignment is
+ *   guaranteed by normal malloc calls.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  return memalign_attr(heap, alignment, size, 0);
+}
+
+#ifdef CONFIG_MM_REGION_ATTR
+/****************************************************************************
+ * Name: mm_memalign_attr
+ *
+ * Description:
+ *   Allocate an aligned chunk of memory, preferably from the regions with
+ *   the given attributes as mm_malloc_attr() does.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign_attr(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, uint32_t attr)
+{
+  return memalign_attr(heap, alignment, size, attr);
+}
+#endif
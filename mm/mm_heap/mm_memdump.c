@@ -230,6 +230,15 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   struct mm_memdump_priv_s priv;
   pid_t pid = dump->pid;
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+  if (pid == PID_MM_PROFILE)
+    {
+      syslog(LOG_INFO, "Memdump profile\n");
+      mm_profile_dump(heap);
+      return;
+    }
+#endif
+
   memset(&priv, 0, sizeof(struct mm_memdump_priv_s));
   priv.dump = dump;
 
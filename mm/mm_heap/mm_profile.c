@@ -0,0 +1,303 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <execinfo.h>
+#include <string.h>
+#include <syslog.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PROFILE_RATE   CONFIG_MM_HEAP_PROFILE_RATE
+#define PROFILE_NSITES CONFIG_MM_HEAP_PROFILE_SITES
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_site
+ *
+ * Description:
+ *   Return the index of the call site with the given backtrace, adding it
+ *   if it is new.  The sites are kept in an open addressed hash table, the
+ *   overflow site is returned when it is full.
+ *
+ ****************************************************************************/
+
+static int mm_profile_site(FAR struct mm_profile_s *prof,
+                           FAR void * const *backtrace)
+{
+  FAR struct mm_profsite_s *site;
+  uintptr_t hash = 0;
+  int depth;
+  int ndx;
+  int i;
+
+  for (depth = 0; depth < CONFIG_MM_BACKTRACE && backtrace[depth];
+       depth++)
+    {
+      hash = (hash ^ (uintptr_t)backtrace[depth]) * 31;
+    }
+
+  if (depth == 0)
+    {
+      return PROFILE_NSITES;
+    }
+
+  ndx = (hash ^ (hash >> 16)) % PROFILE_NSITES;
+  for (i = 0; i < PROFILE_NSITES; i++)
+    {
+      site = &prof->site[ndx];
+      if (site->backtrace[0] == NULL)
+        {
+          memcpy(site->backtrace, backtrace, depth * sizeof(FAR void *));
+          return ndx;
+        }
+
+      if (memcmp(site->backtrace, backtrace,
+                 depth * sizeof(FAR void *)) == 0 &&
+          (depth == CONFIG_MM_BACKTRACE || site->backtrace[depth] == NULL))
+        {
+          return ndx;
+        }
+
+      if (++ndx == PROFILE_NSITES)
+        {
+          ndx = 0;
+        }
+    }
+
+  return PROFILE_NSITES;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_initialize
+ *
+ * Description:
+ *   Initialize the heap profiler of a new heap.
+ *
+ ****************************************************************************/
+
+void mm_profile_initialize(FAR struct mm_heap_s *heap)
+{
+  spin_lock_init(&heap->mm_profile.lock);
+  heap->mm_profile.countdown = PROFILE_RATE;
+}
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Account for a new allocation.  The countdown of the bytes allocated
+ *   is all that is done for most of them; the allocation that crosses the
+ *   next sample point gets its backtrace recorded and is charged to its
+ *   call site.
+ *
+ ****************************************************************************/
+
+noinline_function void mm_profile_alloc(FAR struct mm_heap_s *heap,
+                                        FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_profile_s *prof = &heap->mm_profile;
+  FAR struct mm_profsite_s *site;
+  size_t size = MM_SIZEOF_NODE(node);
+  irqstate_t flags;
+  size_t weight;
+  int ndx;
+  int n;
+
+  node->profsite = 0;
+
+  flags = spin_lock_irqsave(&prof->lock);
+  prof->countdown -= size;
+  if (prof->countdown > 0)
+    {
+      spin_unlock_irqrestore(&prof->lock, flags);
+      return;
+    }
+
+  prof->countdown += PROFILE_RATE;
+  if (prof->countdown <= 0)
+    {
+      prof->countdown = PROFILE_RATE;
+    }
+
+  spin_unlock_irqrestore(&prof->lock, flags);
+
+  /* The backtrace may already be there if backtraces are enabled for the
+   * heap or the thread.  This function adds one frame to the stack.
+   */
+
+  if (node->backtrace[0] == NULL)
+    {
+      n = sched_backtrace(node->pid, node->backtrace, CONFIG_MM_BACKTRACE,
+                          CONFIG_MM_BACKTRACE_SKIP + 1);
+      if (n < CONFIG_MM_BACKTRACE)
+        {
+          node->backtrace[n < 0 ? 0 : n] = NULL;
+        }
+    }
+
+  if (size >= PROFILE_RATE)
+    {
+      weight = size;
+      n      = 1;
+    }
+  else
+    {
+      weight = PROFILE_RATE;
+      n      = PROFILE_RATE / size;
+    }
+
+  flags = spin_lock_irqsave(&prof->lock);
+  ndx   = mm_profile_site(prof, node->backtrace);
+  site  = &prof->site[ndx];
+
+  site->inuse_objs  += n;
+  site->inuse_bytes += weight;
+  site->alloc_objs  += n;
+  site->alloc_bytes += weight;
+  node->profsite     = ndx + 1;
+
+  spin_unlock_irqrestore(&prof->lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_free
+ *
+ * Description:
+ *   Remove an allocation that is freed or resized from the in use counts
+ *   of its call site if it was sampled.
+ *
+ ****************************************************************************/
+
+void mm_profile_free(FAR struct mm_heap_s *heap,
+                     FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_profile_s *prof = &heap->mm_profile;
+  FAR struct mm_profsite_s *site;
+  size_t size = MM_SIZEOF_NODE(node);
+  irqstate_t flags;
+
+  if (node->profsite == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&prof->lock);
+  site  = &prof->site[node->profsite - 1];
+  if (size >= PROFILE_RATE)
+    {
+      site->inuse_objs  -= 1;
+      site->inuse_bytes -= size;
+    }
+  else
+    {
+      site->inuse_objs  -= PROFILE_RATE / size;
+      site->inuse_bytes -= PROFILE_RATE;
+    }
+
+  node->profsite = 0;
+
+  spin_unlock_irqrestore(&prof->lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_dump
+ *
+ * Description:
+ *   Dump the profile of a heap to the syslog in the text format of the
+ *   legacy pprof heap profiles:  A header with the totals followed by one
+ *   line with the in use and cumulative counts and the backtrace of each
+ *   call site.  The overflow site has no backtrace and is only part of the
+ *   totals.
+ *
+ ****************************************************************************/
+
+void mm_profile_dump(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_profile_s *prof = &heap->mm_profile;
+  char buf[BACKTRACE_BUFFER_SIZE(CONFIG_MM_BACKTRACE)];
+  struct mm_profsite_s total;
+  struct mm_profsite_s site;
+  irqstate_t flags;
+  int i;
+
+  memset(&total, 0, sizeof(total));
+
+  flags = spin_lock_irqsave(&prof->lock);
+  for (i = 0; i <= PROFILE_NSITES; i++)
+    {
+      total.inuse_objs  += prof->site[i].inuse_objs;
+      total.inuse_bytes += prof->site[i].inuse_bytes;
+      total.alloc_objs  += prof->site[i].alloc_objs;
+      total.alloc_bytes += prof->site[i].alloc_bytes;
+    }
+
+  spin_unlock_irqrestore(&prof->lock, flags);
+
+  syslog(LOG_INFO, "heap profile: %zu: %zu [%zu: %zu] @ heapprofile\n",
+         total.inuse_objs, total.inuse_bytes,
+         total.alloc_objs, total.alloc_bytes);
+
+  for (i = 0; i < PROFILE_NSITES; i++)
+    {
+      /* Take a copy so that the syslog is not written with the lock held */
+
+      flags = spin_lock_irqsave(&prof->lock);
+      site  = prof->site[i];
+      spin_unlock_irqrestore(&prof->lock, flags);
+
+      if (site.backtrace[0] == NULL)
+        {
+          continue;
+        }
+
+      backtrace_format(buf, sizeof(buf), site.backtrace,
+                       CONFIG_MM_BACKTRACE);
+      syslog(LOG_INFO, "%zu: %zu [%zu: %zu] @ %s\n",
+             site.inuse_objs, site.inuse_bytes,
+             site.alloc_objs, site.alloc_bytes, buf);
+    }
+}
+
+#endif /* CONFIG_MM_HEAP_PROFILE */
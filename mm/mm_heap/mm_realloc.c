@@ -38,6 +38,115 @@
 
 #include "mm_heap/mm.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: realloc_nodesize
+ *
+ * Description:
+ *   Return the node size needed for an allocation of size bytes, or zero
+ *   on overflow.
+ *
+ ****************************************************************************/
+
+static size_t realloc_nodesize(size_t size)
+{
+  size_t newsize;
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
+   * least MM_MIN_CHUNK.
+   */
+
+  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+    {
+      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
+    }
+
+  newsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
+  if (newsize < size)
+    {
+      /* There must have been an integer overflow */
+
+      DEBUGPANIC();
+      return 0;
+    }
+
+  return newsize;
+}
+
+/****************************************************************************
+ * Name: realloc_takenext
+ *
+ * Description:
+ *   Extend an allocated node by takenext bytes taken from the free chunk
+ *   that follows it.  The whole free chunk is taken if the rest would be
+ *   too small to be a chunk of its own.  The caller holds the heap lock.
+ *
+ ****************************************************************************/
+
+static void realloc_takenext(FAR struct mm_heap_s *heap,
+                             FAR struct mm_allocnode_s *node,
+                             FAR struct mm_freenode_s *next,
+                             size_t takenext)
+{
+  FAR struct mm_freenode_s *newnode;
+  FAR struct mm_allocnode_s *andbeyond;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  size_t nextsize = MM_SIZEOF_NODE(next);
+
+  /* Get the chunk following the next node (which could be the tail
+   * chunk)
+   */
+
+  andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
+
+  /* Remove the next node.  There must be a predecessor, but there
+   * may not be a successor node.
+   */
+
+  mm_delfreechunk(heap, next);
+
+  /* Make sure the new next node has enough space */
+
+  if (nextsize < takenext + MM_MIN_CHUNK)
+    {
+      heap->mm_curused += nextsize - takenext;
+      takenext          = nextsize;
+    }
+
+  /* Extend the node into the next chunk */
+
+  nodesize  += takenext;
+  node->size = nodesize | (node->size & MM_MASK_BIT);
+
+  /* Did we consume the entire next chunk? */
+
+  if (takenext < nextsize)
+    {
+      /* No, take what we need from the next chunk and return it to
+       * the free nodelist.
+       */
+
+      newnode              = (FAR struct mm_freenode_s *)
+                             ((FAR char *)node + nodesize);
+      newnode->size        = nextsize - takenext;
+      andbeyond->preceding = newnode->size;
+
+      /* Add the new free node to the nodelist (with the new size) */
+
+      mm_addfreechunk(heap, newnode);
+    }
+  else
+    {
+      /* Yes, just update some pointers. */
+
+      andbeyond->size &= ~MM_PREVFREE_BIT;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,8 +165,10 @@
  *  extended, it will be extended by:
  *
  *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (2) Taking the whole following free chunk, if any, and the rest of
+ *         the space from the preceding free chunk.
+ *
+ *  Only (2) moves the data, so the following chunk is always used first.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
@@ -110,22 +221,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
     }
 #endif
 
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
-   * least MM_MIN_CHUNK.
-   */
-
-  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+  newsize = realloc_nodesize(size);
+  if (newsize == 0)
     {
-      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
-    }
-
-  newsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
-  if (newsize < size)
-    {
-      /* There must have been an integer overflow */
-
-      DEBUGPANIC();
       return NULL;
     }
 
@@ -139,6 +237,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   DEBUGVERIFY(mm_lock(heap));
   DEBUGASSERT(MM_NODE_IS_ALLOC(oldnode));
 
+  /* The node is sampled again with its new size below */
+
+  MM_PROFILE_FREE(heap, oldnode);
+
   /* Check if this is a request to reduce the size of the allocation. */
 
   oldsize = MM_SIZEOF_NODE(oldnode);
@@ -193,56 +295,20 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev;
       size_t takenext;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Extending into the next chunk keeps the data in place, so take
+       * as much as possible from it and only the rest from the previous
+       * chunk.
        */
 
-      if (nextsize > prevsize)
+      if (needed > nextsize)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
-            }
+          takeprev = needed - nextsize;
+          takenext = nextsize;
         }
-
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
-       */
-
       else
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = 0;
-              takenext = needed;
-            }
+          takeprev = 0;
+          takenext = needed;
         }
 
       /* Extend into the previous free chunk */
@@ -256,12 +322,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * there may not be a successor node.
            */
 
-          DEBUGASSERT(prev && prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Make sure the new previous node has enough space */
 
@@ -316,63 +377,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       if (takenext)
         {
-          FAR struct mm_freenode_s *newnode;
-          FAR struct mm_allocnode_s *andbeyond;
-
-          /* Get the chunk following the next node (which could be the tail
-           * chunk)
-           */
-
-          andbeyond = (FAR struct mm_allocnode_s *)
-                      ((FAR char *)next + nextsize);
-
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
-
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
-
-          /* Make sure the new next node has enough space */
-
-          if (nextsize < takenext + MM_MIN_CHUNK)
-            {
-              heap->mm_curused += nextsize - takenext;
-              takenext          = nextsize;
-            }
-
-          /* Extend the node into the next chunk */
-
-          nodesize += takenext;
-          oldnode->size = nodesize | (oldnode->size & MM_MASK_BIT);
-
-          /* Did we consume the entire preceding chunk? */
-
-          if (takenext < nextsize)
-            {
-              /* No, take what we need from the next chunk and return it to
-               * the free nodelist.
-               */
-
-              newnode              = (FAR struct mm_freenode_s *)
-                                     ((FAR char *)oldnode + nodesize);
-              newnode->size        = nextsize - takenext;
-              andbeyond->preceding = newnode->size;
-
-              /* Add the new free node to the nodelist (with the new size) */
-
-              mm_addfreechunk(heap, newnode);
-            }
-          else
-            {
-              /* Yes, just update some pointers. */
-
-              andbeyond->size &= ~MM_PREVFREE_BIT;
-            }
+          realloc_takenext(heap, oldnode, next, takenext);
         }
 
       /* Update heap statistics */
@@ -394,11 +399,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                               MM_ALLOCNODE_OVERHEAD);
       if (kasan_reset_tag(newmem) != kasan_reset_tag(oldmem))
         {
-          /* Now we have to move the user contents 'down' in memory.  memcpy
-           * should be safe for this.
+          /* Now we have to move the user contents 'down' in memory.  The
+           * old and the new location may overlap.
            */
 
-          memcpy(newmem, oldmem, oldsize - MM_ALLOCNODE_OVERHEAD);
+          memmove(newmem, oldmem, oldsize - MM_ALLOCNODE_OVERHEAD);
         }
 
       return newmem;
@@ -425,3 +430,102 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       return newmem;
     }
 }
+
+/****************************************************************************
+ * Name: mm_realloc_inplace
+ *
+ * Description:
+ *   Resize an allocation only if that can be done without moving it:  It
+ *   is shrunk, or grown into the free chunk that follows it.  Otherwise
+ *   the allocation is left unchanged.
+ *
+ * Input Parameters:
+ *   heap - The heap of the allocation
+ *   mem  - The allocation to resize
+ *   size - The new size
+ *
+ * Returned Value:
+ *   The allocation on success, at the same address; NULL if it can not be
+ *   resized in place.
+ *
+ ****************************************************************************/
+
+FAR void *mm_realloc_inplace(FAR struct mm_heap_s *heap, FAR void *mem,
+                             size_t size)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_freenode_s *next;
+  size_t newsize;
+  size_t oldsize;
+
+  DEBUGASSERT(mem != NULL && mm_heapmember(heap, mem));
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      ssize_t blksize = mempool_multiple_alloc_size(heap->mm_mpool, mem);
+
+      if (blksize >= 0)
+        {
+          return size <= (size_t)blksize ? mem : NULL;
+        }
+    }
+#endif
+
+  newsize = realloc_nodesize(size);
+  if (newsize == 0)
+    {
+      return NULL;
+    }
+
+  node = (FAR struct mm_allocnode_s *)
+    ((FAR char *)kasan_reset_tag(mem) - MM_SIZEOF_ALLOCNODE);
+
+  DEBUGVERIFY(mm_lock(heap));
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  oldsize = MM_SIZEOF_NODE(node);
+  next    = (FAR struct mm_freenode_s *)((FAR char *)node + oldsize);
+  if (newsize > oldsize &&
+      (MM_NODE_IS_ALLOC(next) || oldsize + MM_SIZEOF_NODE(next) < newsize))
+    {
+      mm_unlock(heap);
+      return NULL;
+    }
+
+  MM_PROFILE_FREE(heap, node);
+
+  if (newsize < oldsize)
+    {
+      heap->mm_curused += newsize - oldsize;
+      mm_shrinkchunk(heap, node, newsize);
+      kasan_poison((FAR char *)node + MM_SIZEOF_NODE(node) +
+                   sizeof(mmsize_t), oldsize - MM_SIZEOF_NODE(node));
+    }
+  else if (newsize > oldsize)
+    {
+      realloc_takenext(heap, node, next, newsize - oldsize);
+
+      heap->mm_curused += newsize - oldsize;
+      if (heap->mm_curused > heap->mm_maxused)
+        {
+          heap->mm_maxused = heap->mm_curused;
+        }
+
+      sched_note_heap(NOTE_HEAP_FREE, heap, mem, oldsize,
+                      heap->mm_curused - newsize);
+      sched_note_heap(NOTE_HEAP_ALLOC, heap, mem, newsize,
+                      heap->mm_curused);
+    }
+
+  mm_unlock(heap);
+  MM_ADD_BACKTRACE(heap, node);
+
+  if (newsize > oldsize)
+    {
+      mem = kasan_unpoison(mem, MM_SIZEOF_NODE(node) -
+                           MM_ALLOCNODE_OVERHEAD);
+    }
+
+  return mem;
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * mm/mm_heap/mm_region.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_REGION_ATTR
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_region_setattr
+ *
+ * Description:
+ *   Set the attributes of a region of the heap, e.g. MM_REGION_FAST |
+ *   MM_REGION_DMA for on-chip SRAM or MM_REGION_CPU(1) for the TCM of the
+ *   second CPU.  The regions are numbered in the order they were added,
+ *   the one the heap was initialized with being region 0, and have no
+ *   attributes until they are given some.
+ *
+ * Input Parameters:
+ *   heap   - The heap of the region
+ *   region - The number of the region
+ *   attr   - The attributes of the region
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if there is no such region.
+ *
+ ****************************************************************************/
+
+int mm_region_setattr(FAR struct mm_heap_s *heap, int region,
+                      uint32_t attr)
+{
+  if (region < 0 || region >= heap->mm_nregions)
+    {
+      return -EINVAL;
+    }
+
+  heap->mm_regionattr[region] = attr & ~MM_REGION_STRICT;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_region_info
+ *
+ * Description:
+ *   Return the attributes and the usage of a region of the heap.  The free
+ *   size is kept up to date as the chunks are freed and allocated, so the
+ *   region is not walked.
+ *
+ * Input Parameters:
+ *   heap   - The heap of the region
+ *   region - The number of the region
+ *   info   - The location to return the usage
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if there is no such region.
+ *
+ ****************************************************************************/
+
+int mm_region_info(FAR struct mm_heap_s *heap, int region,
+                   FAR struct mm_regioninfo_s *info)
+{
+  int ret;
+
+  if (region < 0 || region >= heap->mm_nregions)
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_lock(heap);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  info->start    = heap->mm_heapstart[region];
+  info->size     = (uintptr_t)heap->mm_heapend[region] -
+                   (uintptr_t)heap->mm_heapstart[region] +
+                   MM_SIZEOF_ALLOCNODE;
+  info->fordblks = heap->mm_regionfree[region];
+  info->attr     = heap->mm_regionattr[region];
+
+  mm_unlock(heap);
+  return OK;
+}
+
+#endif /* CONFIG_MM_REGION_ATTR */
@@ -131,6 +131,12 @@ struct mm_mallinfo_handler_s
   FAR struct mallinfo_task *info;
 };
 
+struct mm_heapfree_handler_s
+{
+  mm_heapfree_handler_t handler;
+  FAR void *arg;
+};
+
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
 struct mm_tlsf_node_s
 {
@@ -487,6 +493,26 @@ static void mallinfo_task_handler(FAR void *ptr, size_t size, int used,
     }
 }
 
+/****************************************************************************
+ * Name: heapfree_handler
+ ****************************************************************************/
+
+static void heapfree_handler(FAR void *ptr, size_t size, int used,
+                             FAR void *user)
+{
+  FAR struct mm_heapfree_handler_s *handler = user;
+
+  /* Skip the list links at the start of the free block, and the pointer
+   * back to it that the next block keeps in its last word.
+   */
+
+  if (!used && size > 3 * sizeof(FAR void *))
+    {
+      handler->handler((FAR char *)ptr + 2 * sizeof(FAR void *),
+                       size - 3 * sizeof(FAR void *), handler->arg);
+    }
+}
+
 /****************************************************************************
  * Name: mm_lock
  *
@@ -1624,6 +1650,22 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   return newmem;
 }
 
+/****************************************************************************
+ * Name: mm_realloc_inplace
+ *
+ * Description:
+ *   Resize an allocation only if that can be done without moving it.  The
+ *   backtrace of a TLSF block is kept at its end, so only a size that
+ *   fits the current block is accepted.
+ *
+ ****************************************************************************/
+
+FAR void *mm_realloc_inplace(FAR struct mm_heap_s *heap, FAR void *mem,
+                             size_t size)
+{
+  return size <= mm_malloc_size(heap, mem) ? mem : NULL;
+}
+
 /****************************************************************************
  * Name: mm_uninitialize
  *
@@ -1724,3 +1766,41 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   return SIZE_MAX;
 }
+
+/****************************************************************************
+ * Name: mm_heapfree_foreach
+ *
+ * Description:
+ *   Visit the free blocks of the heap, for the code that can do without
+ *   their content, e.g. a core dump.  Nothing is visited if the heap
+ *   cannot be locked.
+ *
+ ****************************************************************************/
+
+void mm_heapfree_foreach(FAR struct mm_heap_s *heap,
+                         mm_heapfree_handler_t handler, FAR void *arg)
+{
+  struct mm_heapfree_handler_s priv;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  priv.handler = handler;
+  priv.arg     = arg;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      if (mm_lock(heap) < 0)
+        {
+          return;
+        }
+
+      tlsf_walk_pool(heap->mm_heapstart[region], heapfree_handler, &priv);
+      mm_unlock(heap);
+    }
+#undef region
+}
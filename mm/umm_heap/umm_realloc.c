@@ -106,3 +106,24 @@ FAR void *realloc(FAR void *oldmem, size_t size)
   return ret;
 #endif
 }
+
+/****************************************************************************
+ * Name: realloc_inplace
+ *
+ * Description:
+ *   Resize memory in the user heap only if it does not have to move, so
+ *   that a growing container can avoid copying its contents.
+ *
+ * Input Parameters:
+ *   mem     - The memory allocated
+ *   newsize - The new size (in bytes) of the memory region.
+ *
+ * Returned Value:
+ *   mem if it was resized, NULL if it is left unchanged.
+ *
+ ****************************************************************************/
+
+FAR void *realloc_inplace(FAR void *mem, size_t size)
+{
+  return mm_realloc_inplace(USR_HEAP, mem, size);
+}
@@ -45,6 +45,7 @@
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -157,14 +158,18 @@ struct arp_notify_s
 };
 #endif
 
-/* One entry in the ARP table (volatile!) */
+/* One entry in the ARP table (volatile!).  The entries in use are hashed
+ * by their IP address and have a device.
+ */
 
 struct arp_entry_s
 {
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
-  clock_t                  at_time;     /* Time of last usage */
+  clock_t                  at_time;     /* Time of last update */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+  hash_node_t              at_node;     /* Hashed by the IP address */
+  dq_entry_t               at_lru;      /* Least recently used first */
 };
 
 /****************************************************************************
@@ -64,6 +64,7 @@
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
 #include "arp/arp.h"
+#include "ipforward/ipforward.h"
 
 #ifdef CONFIG_NET_ARP
 
@@ -91,6 +92,17 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries in use hashed by their IP address */
+
+static DECLARE_HASHTABLE(g_arphash, CONFIG_NET_ARP_HASH_BITS);
+
+/* The entries that were ever used, the free and least recently used ones
+ * first.  g_arpnext is the first entry of the table not used yet.
+ */
+
+static dq_queue_t g_arplru;
+static int g_arpnext;
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -149,32 +161,38 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_entry
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Find the ARP entry corresponding to this IP address in the ARP table,
+ *   expired or not.
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *   dev    - Device structure
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s *arp_entry(in_addr_t ipaddr,
+                                         FAR struct net_driver_s *dev)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
-    {
-      return e2;
-    }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
-    {
-      return e1;
-    }
-  else
+  FAR struct arp_entry_s *tabptr;
+  FAR hash_node_t *node;
+
+  hashtable_for_every_possible(g_arphash, node, (uint32_t)ipaddr)
     {
-      return e2;
+      tabptr = container_of(node, struct arp_entry_s, at_node);
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -197,19 +215,14 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_entry(ipaddr, dev);
+  if (tabptr != NULL &&
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return tabptr;
     }
 
   /* Not found */
@@ -217,6 +230,61 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Return an ARP table entry for a new mapping:  An entry not used yet, or
+ *   the least recently used one, which may be in use.  The entry becomes
+ *   the most recently used one.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  if (g_arpnext < CONFIG_NET_ARPTAB_SIZE)
+    {
+      tabptr = &g_arptable[g_arpnext++];
+    }
+  else
+    {
+      tabptr = container_of(dq_peek(&g_arplru), struct arp_entry_s, at_lru);
+      dq_rem(&tabptr->at_lru, &g_arplru);
+    }
+
+  dq_addlast(&tabptr->at_lru, &g_arplru);
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from the ARP table.  It becomes the first one to be
+ *   reused.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  hashtable_delete(g_arphash, &tabptr->at_node, (uint32_t)tabptr->at_ipaddr);
+  dq_rem(&tabptr->at_lru, &g_arplru);
+  dq_addfirst(&tabptr->at_lru, &g_arplru);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+
+  ipv4_forward_flush(NULL);
+}
+
 /****************************************************************************
  * Name: arp_get_arpreq
  *
@@ -275,72 +343,69 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  if (ethaddr == NULL)
+    {
+      ethaddr = g_zero_ethaddr.ether_addr_octet;
+    }
+
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the least recently used entry.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_entry(ipaddr, dev);
+  if (tabptr != NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      dq_rem(&tabptr->at_lru, &g_arplru);
+      dq_addlast(&tabptr->at_lru, &g_arplru);
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+      /* Need to notify when the entry changes */
 
-          tabptr = &g_arptable[i];
 #ifdef CONFIG_NETLINK_ROUTE
-          found = true;
+      new_entry = memcmp(tabptr->at_ethaddr.ether_addr_octet,
+                         ethaddr, ETHER_ADDR_LEN) != 0;
 #endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
     }
-
-  if (ethaddr == NULL)
+  else
     {
-      ethaddr = g_zero_ethaddr.ether_addr_octet;
-    }
-
-  /* When overwrite old entry, notify old entry RTM_DELNEIGH */
+      tabptr = arp_alloc();
+      if (tabptr->at_dev != NULL)
+        {
+          /* When overwrite old entry, notify old entry RTM_DELNEIGH */
 
 #ifdef CONFIG_NETLINK_ROUTE
-  if (!found && tabptr->at_ipaddr != 0)
-    {
-      arp_get_arpreq(&arp_notify, tabptr);
-      netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
-    }
+          arp_get_arpreq(&arp_notify, tabptr);
+          netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
+#endif
+          hashtable_delete(g_arphash, &tabptr->at_node,
+                           (uint32_t)tabptr->at_ipaddr);
+        }
 
-  /* Need to notify when entry is not found or changes in table */
+      tabptr->at_ipaddr = ipaddr;
+      tabptr->at_dev    = dev;
+      hashtable_add(g_arphash, &tabptr->at_node, (uint32_t)ipaddr);
 
-  new_entry = !found || memcmp(tabptr->at_ethaddr.ether_addr_octet,
-                               ethaddr, ETHER_ADDR_LEN) != 0;
+#ifdef CONFIG_NETLINK_ROUTE
+      new_entry = true;
 #endif
+    }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
+   * information.  The forwarding flows may hold the old MAC address.
    */
 
-  tabptr->at_ipaddr = ipaddr;
+  if (memcmp(tabptr->at_ethaddr.ether_addr_octet,
+             ethaddr, ETHER_ADDR_LEN) != 0)
+    {
+      ipv4_forward_flush(NULL);
+    }
+
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
   /* Notify the new entry */
@@ -418,6 +483,11 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
+      /* It is the most recently used now */
+
+      dq_rem(&tabptr->at_lru, &g_arplru);
+      dq_addlast(&tabptr->at_lru, &g_arplru);
+
       /* Addresses that have failed to be searched will return a special
        * error code so that the upper layer can return faster.
        */
@@ -495,9 +565,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Remove it */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -522,11 +592,11 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 {
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < g_arpnext; ++i)
     {
       if (dev == g_arptable[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(&g_arptable[i]);
         }
     }
 }
@@ -563,11 +633,11 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
   for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
+       nentries > ncopied && i < g_arpnext;
        i++)
     {
       tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
+      if (tabptr->at_dev != NULL &&
           now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
           arp_get_arpreq(&snapshot[ncopied], tabptr);
@@ -84,7 +84,7 @@ can_data_event(FAR struct net_driver_s *dev, FAR struct can_conn_s *conn,
       ninfo("Dropped %d bytes\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.can.drop++;
+      NETSTATS.can.drop++;
 #endif
     }
 
@@ -272,7 +272,7 @@ int can_input(FAR struct net_driver_s *dev)
   int ret;
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.can.recv++;
+  NETSTATS.can.recv++;
 #endif
 
   if (dev->d_iob != NULL)
@@ -293,7 +293,7 @@ int can_input(FAR struct net_driver_s *dev)
   if (ret < 0)
     {
 #ifdef CONFIG_NET_STATISTICS
-    g_netstats.can.drop++;
+    NETSTATS.can.drop++;
 #endif
     }
 
@@ -204,7 +204,7 @@ static inline void can_newdata(FAR struct net_driver_s *dev,
         {
           ninfo("Dropped %d bytes\n", dev->d_len);
 #ifdef CONFIG_NET_STATISTICS
-          g_netstats.can.drop++;
+          NETSTATS.can.drop++;
 #endif
         }
     }
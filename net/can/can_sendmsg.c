@@ -303,7 +303,7 @@ ssize_t can_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.can.sent++;
+  NETSTATS.can.sent++;
 #endif
 
   /* Return the number of bytes actually sent */
@@ -32,11 +32,58 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/****************************************************************************
+ * Name: devif_file_unref
+ *
+ * Description:
+ *   Free callback of an IOB referencing file data.  The memory belongs to
+ *   the file system, so there is nothing to release.
+ *
+ ****************************************************************************/
+
+static void devif_file_unref(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: devif_file_xipbase
+ *
+ * Description:
+ *   Return the memory address of the file data if it may be referenced by
+ *   the TX packets of 'dev'; zero otherwise.
+ *
+ ****************************************************************************/
+
+static uintptr_t devif_file_xipbase(FAR struct net_driver_s *dev,
+                                    FAR struct file *file)
+{
+  uintptr_t base = 0;
+
+  /* The loopback device turns the TX packets into RX packets that may be
+   * trimmed and packed in place, which must not happen to file data.
+   */
+
+  if (dev->d_lltype == NET_LL_LOOPBACK ||
+      file_ioctl(file, FIOC_XIPBASE, (unsigned long)((uintptr_t)&base)) < 0)
+    {
+      return 0;
+    }
+
+  return base;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -63,6 +110,9 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
   FAR struct iob_s *iob;
   unsigned int copying;
   unsigned int remain;
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  uintptr_t base;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -105,10 +155,36 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
   iob = dev->d_iob;
   remain = len;
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  base = devif_file_xipbase(dev, file);
+#endif
+
   while (remain > 0)
     {
       if (iob->io_len + iob->io_offset == CONFIG_IOB_BUFSIZE)
         {
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+          /* The IOB holding the headers is full.  Link the rest of the
+           * file data instead of copying it.  Short tails are copied so
+           * that a driver padding a small frame never touches file data.
+           */
+
+          if (base != 0 && iob->io_flink == NULL &&
+              remain >= CONFIG_IOB_BUFSIZE && remain <= UINT16_MAX)
+            {
+              iob->io_flink =
+                iob_alloc_with_data((FAR void *)
+                                    (base + offset + len - remain),
+                                    remain, devif_file_unref);
+              if (iob->io_flink != NULL)
+                {
+                  iob->io_flink->io_len = remain;
+                  remain = 0;
+                  break;
+                }
+            }
+#endif
+
           if (iob->io_flink == NULL)
             {
               iob->io_flink = iob_tryalloc(false);
@@ -61,13 +61,46 @@
 /* IP/TCP/UDP/ICMP/CAN statistics for all network interfaces */
 
 #ifdef CONFIG_NET_STATISTICS
-struct net_stats_s g_netstats;
+struct net_stats_s g_netstats[CONFIG_SMP_NCPUS];
 #endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_stats_sum
+ *
+ * Description:
+ *   Sum the statistics gathered on all of the CPUs.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+void net_stats_sum(FAR struct net_stats_s *stats)
+{
+  FAR net_stats_t *sum = (FAR net_stats_t *)stats;
+  FAR const net_stats_t *counter;
+  size_t i;
+  int cpu;
+
+  /* All of the counters are of the type net_stats_t */
+
+  *stats = g_netstats[0];
+  for (cpu = 1; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      counter = (FAR const net_stats_t *)&g_netstats[cpu];
+      for (i = 0; i < sizeof(*stats) / sizeof(net_stats_t); i++)
+        {
+          sum[i] += counter[i];
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: devif_initialize
  *
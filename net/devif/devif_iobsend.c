@@ -59,6 +59,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifndef CONFIG_NET_IPFRAG
+  unsigned int maxlen;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -74,7 +77,18 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  maxlen = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev);
+
+#ifdef CONFIG_NETDEV_GSO
+  /* A super-segment is limited by the device instead of the MTU */
+
+  if (dev->d_gsosize > 0)
+    {
+      maxlen = dev->d_gsomax;
+    }
+#endif
+
+  if (len > maxlen - target_offset)
     {
       ret = -EMSGSIZE;
       goto errout;
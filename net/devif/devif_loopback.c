@@ -105,6 +105,23 @@ int devif_loopback(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      /* The packet never left memory, a partial checksum is as good as a
+       * verified one and the input does not check it again.
+       */
+
+      dev->d_iob->io_flags &= ~NETDEV_CSUM_PARTIAL;
+      dev->d_iob->io_flags |= NETDEV_CSUM_VALID;
+#endif
+
+#if defined(CONFIG_NETDEV_GSO) && !defined(CONFIG_NETDEV_GRO)
+      /* A super-segment is delivered whole, as one large segment.  Only
+       * the receive offload tells the input about it.
+       */
+
+      dev->d_gsosize = 0;
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -582,6 +582,72 @@ static inline int devif_poll_mld(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef NET_UDP_HAVE_STACK
+#ifdef CONFIG_NET_DEVPOLL_READY
+static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
+                                      devif_poll_callback_t callback)
+{
+  FAR struct udp_conn_s *conn;
+#ifndef CONFIG_NET_UDP_WRITE_BUFFERS
+  FAR struct devif_callback_s *cb;
+#endif
+  int count = udp_nready();
+  int bstop = 0;
+
+  /* Visit each of the connections queued for the TX poll once */
+
+  while (!bstop && count-- > 0 && (conn = udp_nextready()) != NULL)
+    {
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      /* Skip UDP connections that are bound to other polling devices */
+
+      if (conn->dev == NULL)
+        {
+          udp_txidle(conn);
+        }
+      else if (dev == conn->dev)
+#endif
+        {
+          /* Perform the UDP TX poll */
+
+          udp_poll(dev, conn);
+
+          /* A connection that sent nothing leaves the queue until it has
+           * something to send again.  Without write buffers a send may be
+           * waiting for the poll of another device:  Keep the connection
+           * while its callbacks want the poll.
+           */
+
+          if (dev->d_len == 0)
+            {
+#ifndef CONFIG_NET_UDP_WRITE_BUFFERS
+              for (cb = conn->sconn.list; cb != NULL; cb = cb->nxtconn)
+                {
+                  if ((cb->flags & UDP_POLL) != 0)
+                    {
+                      break;
+                    }
+                }
+
+              if (cb == NULL)
+#endif
+                {
+                  udp_txidle(conn);
+                }
+            }
+
+          /* Perform any necessary conversions on outgoing packets */
+
+          devif_packet_conversion(dev, DEVIF_UDP);
+
+          /* Call back into the driver */
+
+          bstop = devif_poll_local_out(dev, callback);
+        }
+    }
+
+  return bstop;
+}
+#else
 static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
                                       devif_poll_callback_t callback)
 {
@@ -616,6 +682,7 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
   return bstop;
 }
+#endif /* CONFIG_NET_DEVPOLL_READY */
 #endif /* NET_UDP_HAVE_STACK */
 
 /****************************************************************************
@@ -630,7 +697,54 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_DEVPOLL_READY)
+static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
+                                             devif_poll_callback_t callback)
+{
+  FAR struct tcp_conn_s *conn;
+  int count = tcp_nready();
+  int bstop = 0;
+
+  /* Visit each of the connections queued for the TX poll once */
+
+  while (!bstop && count-- > 0 && (conn = tcp_nextready()) != NULL)
+    {
+      /* Skip TCP connections that are bound to other polling devices */
+
+      if (conn->dev == NULL)
+        {
+          tcp_txidle(conn);
+        }
+      else if (dev == conn->dev)
+        {
+          /* Perform the TCP TX poll */
+
+          tcp_poll(dev, conn);
+
+          /* A connection that sent nothing leaves the queue until it has
+           * something to send again.  It is not looked at after a poll that
+           * sent something:  The poll may have freed it after sending a
+           * reset.
+           */
+
+          if (dev->d_iob != NULL && dev->d_len == 0)
+            {
+              tcp_txidle(conn);
+            }
+
+          /* Perform any necessary conversions on outgoing packets */
+
+          devif_packet_conversion(dev, DEVIF_TCP);
+
+          /* Call back into the driver */
+
+          bstop = devif_poll_local_out(dev, callback);
+        }
+    }
+
+  return bstop;
+}
+#elif defined(NET_TCP_HAVE_STACK)
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
                                              devif_poll_callback_t callback)
 {
@@ -741,6 +855,74 @@ static int devif_poll_ipfrag(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: devif_poll_ipfwd
+ *
+ * Description:
+ *   Poll the packets queued by the IPv4 forwarding fast path.  Their link
+ *   layer header was already built when they were queued.
+ *
+ * Input Parameters:
+ *   dev - NIC Device instance.
+ *   callback - the actual sending API provided by each NIC driver.
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+static int devif_poll_ipfwd(FAR struct net_driver_s *dev,
+                            devif_poll_callback_t callback)
+{
+  FAR struct iob_s *iob;
+  bool reused = false;
+  int bstop = false;
+
+  while (!bstop)
+    {
+      iob = iob_remove_queue(&dev->d_fwdout);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      reused = true;
+
+      /* Replace original iob, d_len becomes the size of the IPv4 packet */
+
+      netdev_iob_replace(dev, iob);
+#ifdef CONFIG_NET_IPv6
+      IFF_SET_IPv4(dev->d_flags);
+#endif
+      dev->d_len += NET_LL_HDRLEN(dev);
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+    }
+
+  if (iob_peek_queue(&dev->d_fwdout) != NULL)
+    {
+      netdev_txnotify_dev(dev);
+    }
+
+  /* Reuse iob buffer */
+
+  if (!bstop && reused)
+    {
+      iob_update_pktlen(dev->d_iob, 0, false);
+      netdev_iob_prepare(dev, true, 0);
+    }
+
+  return bstop;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_connections
  *
@@ -785,6 +967,15 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
   bstop = devif_poll_ipfrag(dev, callback);
   if (!bstop)
 #endif
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+    {
+      /* Traverse the packets queued by the IPv4 forwarding fast path */
+
+      bstop = devif_poll_ipfwd(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_ARP_SEND
     {
       /* Check for pending ARP requests */
@@ -1165,6 +1356,9 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   if (dev->d_len == 0)
     {
+#ifdef CONFIG_NETDEV_GSO
+      dev->d_gsosize = 0;
+#endif
       return 0;
     }
 
@@ -1190,7 +1384,14 @@ int devif_poll_out(FAR struct net_driver_s *dev,
         }
 #endif
 
-      return callback(dev);
+      bstop = callback(dev);
+
+#ifdef CONFIG_NETDEV_GSO
+      /* The super-segment has been handed to the device */
+
+      dev->d_gsosize = 0;
+#endif
+      return bstop;
     }
 
   return 0;
@@ -160,7 +160,7 @@ static int ipv4_in(FAR struct net_driver_s *dev)
   /* This is where the input processing starts. */
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.ipv4.recv++;
+  NETSTATS.ipv4.recv++;
 #endif
 
   /* Start of IP input header processing code.
@@ -177,8 +177,8 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       /* IP version and header length. */
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv4.drop++;
-      g_netstats.ipv4.vhlerr++;
+      NETSTATS.ipv4.drop++;
+      NETSTATS.ipv4.vhlerr++;
 #endif
       nwarn("WARNING: Invalid IP version or header length: %02x\n",
             ipv4->vhl);
@@ -230,8 +230,8 @@ static int ipv4_in(FAR struct net_driver_s *dev)
 
 #endif
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv4.drop++;
-      g_netstats.ipv4.fragerr++;
+      NETSTATS.ipv4.drop++;
+      NETSTATS.ipv4.fragerr++;
 #endif
       nwarn("WARNING: IP fragment dropped\n");
       goto drop;
@@ -365,7 +365,7 @@ static int ipv4_in(FAR struct net_driver_s *dev)
                     "Dropping!\n");
 
 #ifdef CONFIG_NET_STATISTICS
-              g_netstats.ipv4.drop++;
+              NETSTATS.ipv4.drop++;
 #endif
               goto drop;
             }
@@ -388,8 +388,8 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       /* Compute and check the IP header checksum. */
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv4.drop++;
-      g_netstats.ipv4.chkerr++;
+      NETSTATS.ipv4.drop++;
+      NETSTATS.ipv4.chkerr++;
 #endif
       nwarn("WARNING: Bad IP checksum\n");
       goto drop;
@@ -438,8 +438,8 @@ static int ipv4_in(FAR struct net_driver_s *dev)
 
       default:              /* Unrecognized/unsupported protocol */
 #ifdef CONFIG_NET_STATISTICS
-        g_netstats.ipv4.drop++;
-        g_netstats.ipv4.protoerr++;
+        NETSTATS.ipv4.drop++;
+        NETSTATS.ipv4.protoerr++;
 #endif
 
         nwarn("WARNING: Unrecognized IP protocol\n");
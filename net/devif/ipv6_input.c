@@ -202,7 +202,7 @@ static int ipv6_in(FAR struct net_driver_s *dev)
   /* This is where the input processing starts. */
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.ipv6.recv++;
+  NETSTATS.ipv6.recv++;
 #endif
 
   /* Start of IP input header processing code.
@@ -217,7 +217,7 @@ static int ipv6_in(FAR struct net_driver_s *dev)
       nwarn("WARNING: Invalid IPv6 version: %d\n", ipv6->vtc >> 4);
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv6.vhlerr++;
+      NETSTATS.ipv6.vhlerr++;
 #endif
       goto drop;
     }
@@ -415,7 +415,7 @@ static int ipv6_in(FAR struct net_driver_s *dev)
       else
         {
 #ifdef CONFIG_NET_STATISTICS
-          g_netstats.ipv6.fragerr++;
+          NETSTATS.ipv6.fragerr++;
 #endif
           goto drop;
         }
@@ -568,7 +568,7 @@ static int ipv6_in(FAR struct net_driver_s *dev)
         nwarn("WARNING: Unrecognized IP protocol: %04x\n", ipv6->proto);
 
 #ifdef CONFIG_NET_STATISTICS
-        g_netstats.ipv6.protoerr++;
+        NETSTATS.ipv6.protoerr++;
 #endif
         goto drop;
     }
@@ -597,7 +597,7 @@ done:
 
 drop:
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.ipv6.drop++;
+  NETSTATS.ipv6.drop++;
 #endif
   dev->d_len = 0;
   return OK;
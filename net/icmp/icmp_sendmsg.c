@@ -146,8 +146,8 @@ static void sendto_request(FAR struct net_driver_s *dev,
   ninfo("Outgoing ICMP packet length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmp.sent++;
-  g_netstats.ipv4.sent++;
+  NETSTATS.icmp.sent++;
+  NETSTATS.ipv4.sent++;
 #endif
 }
 
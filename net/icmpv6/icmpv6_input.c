@@ -278,7 +278,7 @@ void icmpv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.recv++;
+  NETSTATS.icmpv6.recv++;
 #endif
 
   /* REVISIT:
@@ -668,8 +668,8 @@ void icmpv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
       ninfo("Outgoing ICMPv6 packet length: %d (%d)\n",
             dev->d_len, (ipv6->len[0] << 8) | ipv6->len[1]);
 
-      g_netstats.icmpv6.sent++;
-      g_netstats.ipv6.sent++;
+      NETSTATS.icmpv6.sent++;
+      NETSTATS.ipv6.sent++;
     }
 #endif
 
@@ -677,12 +677,12 @@ void icmpv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 icmpv6_type_error:
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.typeerr++;
+  NETSTATS.icmpv6.typeerr++;
 #endif
 
 icmpv6_drop_packet:
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.drop++;
+  NETSTATS.icmpv6.drop++;
 #endif
 
 icmpv6_send_nothing:
@@ -321,8 +321,8 @@ skip_prefix:
   ninfo("Outgoing ICMPv6 Router Advertise length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.sent++;
-  g_netstats.ipv6.sent++;
+  NETSTATS.icmpv6.sent++;
+  NETSTATS.ipv6.sent++;
 #endif
 }
 
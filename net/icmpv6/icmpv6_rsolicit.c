@@ -118,8 +118,8 @@ void icmpv6_rsolicit(FAR struct net_driver_s *dev)
   ninfo("Outgoing ICMPv6 Router Solicitation length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.sent++;
-  g_netstats.ipv6.sent++;
+  NETSTATS.icmpv6.sent++;
+  NETSTATS.ipv6.sent++;
 #endif
 }
 
@@ -143,8 +143,8 @@ static void sendto_request(FAR struct net_driver_s *dev,
   ninfo("Outgoing ICMPv6 packet length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.icmpv6.sent++;
-  g_netstats.ipv6.sent++;
+  NETSTATS.icmpv6.sent++;
+  NETSTATS.ipv6.sent++;
 #endif
 }
 
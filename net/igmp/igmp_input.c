@@ -133,7 +133,7 @@ void igmp_input(struct net_driver_s *dev)
 
   if (dev->d_len < NET_LL_HDRLEN(dev) + (iphdrlen + IGMP_HDRLEN))
     {
-      IGMP_STATINCR(g_netstats.igmp.length_errors);
+      IGMP_STATINCR(NETSTATS.igmp.length_errors);
       nwarn("WARNING: Length error\n");
       goto drop;
     }
@@ -143,7 +143,7 @@ void igmp_input(struct net_driver_s *dev)
 
   if (net_chksum((FAR uint16_t *)igmp, IGMP_HDRLEN) != 0)
     {
-      IGMP_STATINCR(g_netstats.igmp.chksum_errors);
+      IGMP_STATINCR(NETSTATS.igmp.chksum_errors);
       nwarn("WARNING: Checksum error\n");
       goto drop;
     }
@@ -204,13 +204,13 @@ void igmp_input(struct net_driver_s *dev)
                 ninfo("General multicast query\n");
                 if (igmp->maxresp == 0)
                   {
-                    IGMP_STATINCR(g_netstats.igmp.v1_received);
+                    IGMP_STATINCR(NETSTATS.igmp.v1_received);
                     igmp->maxresp = 10;
 
                     nwarn("WARNING: V1 not implemented\n");
                   }
 
-                IGMP_STATINCR(g_netstats.igmp.query_received);
+                IGMP_STATINCR(NETSTATS.igmp.query_received);
 
                 member = (FAR struct igmp_group_s *)dev->d_igmp_grplist.head;
                 for (; member; member = member->next)
@@ -238,7 +238,7 @@ void igmp_input(struct net_driver_s *dev)
                  * last time. Use the incoming IPaddress!
                  */
 
-                IGMP_STATINCR(g_netstats.igmp.ucast_query);
+                IGMP_STATINCR(NETSTATS.igmp.ucast_query);
 
                 grpaddr = net_ip4addr_conv32(igmp->grpaddr);
                 group   = igmp_grpallocfind(dev, &grpaddr);
@@ -262,7 +262,7 @@ void igmp_input(struct net_driver_s *dev)
         else if (net_ipv4addr_cmp(igmp->grpaddr, INADDR_ANY) == 0)
           {
             ninfo("Unicast query\n");
-            IGMP_STATINCR(g_netstats.igmp.ucast_query);
+            IGMP_STATINCR(NETSTATS.igmp.ucast_query);
 
             ninfo("Query to a specific group with the group address as "
                   "destination\n");
@@ -280,7 +280,7 @@ void igmp_input(struct net_driver_s *dev)
         {
           ninfo("Membership report\n");
 
-          IGMP_STATINCR(g_netstats.igmp.report_received);
+          IGMP_STATINCR(NETSTATS.igmp.report_received);
           if (!IS_IDLEMEMBER(group->flags))
             {
               /* This is on a specific group we have already looked up */
@@ -162,14 +162,14 @@ int igmp_leavegroup(struct net_driver_s *dev,
       CLR_SCHEDMSG(group->flags);
       CLR_WAITMSG(group->flags);
 
-      IGMP_STATINCR(g_netstats.igmp.leaves);
+      IGMP_STATINCR(NETSTATS.igmp.leaves);
 
       /* Send a leave if the flag is set according to the state diagram */
 
       if (IFF_IS_UP(dev->d_flags) && IS_LASTREPORT(group->flags))
         {
           ninfo("Schedule Leave Group message\n");
-          IGMP_STATINCR(g_netstats.igmp.leave_sched);
+          IGMP_STATINCR(NETSTATS.igmp.leave_sched);
 
           ret = igmp_waitmsg(group, IGMP_LEAVE_GROUP);
           if (ret < 0)
@@ -114,6 +114,13 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
                                 FAR struct file *infile, FAR off_t *offset,
                                 size_t count);
 #endif
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags,
+                                FAR const struct timespec *timeout);
 
 /****************************************************************************
  * Private Data
@@ -144,6 +151,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -758,6 +767,27 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:
+        {
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_STREAM)
+            {
+              FAR struct tcp_conn_s *tcp = psock->s_conn;
+              *(FAR int *)value = tcp->zerocopy;
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:
         {
@@ -1060,6 +1090,30 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY: /* Enable MSG_ZEROCOPY sends */
+        {
+          if (value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_STREAM)
+            {
+              FAR struct tcp_conn_s *tcp = psock->s_conn;
+
+              net_lock();
+              tcp->zerocopy = (*((FAR const int *)value) != 0);
+              net_unlock();
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP: /* Report receive timestamps as cmsg */
         {
@@ -1212,7 +1266,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1227,7 +1281,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
     }
@@ -1410,6 +1464,7 @@ static int inet_connect(FAR struct socket *psock,
               conn->flags |= _UDP_FLAG_CONNECTMODE;
             }
 
+          udp_rehash(conn);
           return ret;
         }
 #endif /* CONFIG_NET_UDP */
@@ -2362,6 +2417,88 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements sendmmsg() for the AF_INET and AF_INET6 address families.
+ *   The datagrams of a UDP socket are all queued with the network locked
+ *   once; the lock is only given up while waiting for buffers.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  On error, a negated errno value is
+ *   returned (see sendmsg() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags)
+{
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      int ret;
+
+      net_lock();
+      ret = sock_sendmmsg(psock, msgvec, vlen, flags);
+      net_unlock();
+      return ret;
+    }
+#endif
+
+  return sock_sendmmsg(psock, msgvec, vlen, flags);
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements recvmmsg() for the AF_INET and AF_INET6 address families.
+ *   The datagrams of a UDP socket are all taken from the read-ahead buffers
+ *   with the network locked once; the lock is only given up while waiting
+ *   for a datagram.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *   timeout  The time after which no further message is waited for, or
+ *            NULL
+ *
+ * Returned Value:
+ *   The number of messages received.  On error, a negated errno value is
+ *   returned (see recvmsg() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags,
+                         FAR const struct timespec *timeout)
+{
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      int ret;
+
+      net_lock();
+      ret = sock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      net_unlock();
+      return ret;
+    }
+#endif
+
+  return sock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/icmpv6.h>
@@ -65,15 +66,82 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+/* The key of the rules in the port buckets of the index */
+
+#define IPFILTER_PORTKEY(proto, dport) (((uint32_t)(proto) << 16) | (dport))
+
+#define IPFILTER_PORTPROTO(proto) \
+  ((proto) == IP_PROTO_TCP || (proto) == IP_PROTO_UDP)
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+#  ifdef CONFIG_NET_IPv6
+#    define IPFILTER_FLOW_ADDRWORDS 4
+#  else
+#    define IPFILTER_FLOW_ADDRWORDS 1
+#  endif
+#else
+#  define ipfilter_flow_flush()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* The index of a chain.  Every rule is in one of its lists, and all of
+ * them are in chain order.
+ */
+
+struct ipfilter_index_s
+{
+  /* The rules by protocol and destination port, and by destination host */
+
+  DECLARE_HASHTABLE(port, CONFIG_NET_IPFILTER_INDEX_BITS);
+  DECLARE_HASHTABLE(addr, CONFIG_NET_IPFILTER_INDEX_BITS);
+
+  dq_queue_t other;    /* The rules with neither key */
+  uint32_t   count;    /* The number of rules added to the chain */
+};
+#endif
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+/* An accepted flow, holding all that the rules of a chain may look at */
+
+struct ipfilter_flow_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  uint32_t srcip[IPFILTER_FLOW_ADDRWORDS];
+  uint32_t dstip[IPFILTER_FLOW_ADDRWORDS];
+  uint16_t sport;      /* Ports in network byte order */
+  uint16_t dport;
+  uint8_t  family;
+  uint8_t  proto;
+  uint8_t  chain;
+  uint8_t  valid;      /* Zero for the empty slots */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
 static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
+#  ifdef CONFIG_NET_IPFILTER_INDEX
+static struct ipfilter_index_s g_ipv4_index[IPFILTER_CHAIN_MAX];
+#  endif
 #endif
 #ifdef CONFIG_NET_IPv6
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
+#  ifdef CONFIG_NET_IPFILTER_INDEX
+static struct ipfilter_index_s g_ipv6_index[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+static struct ipfilter_flow_s
+g_ipfilter_flows[CONFIG_NET_IPFILTER_FLOWCACHE];
 #endif
 
 /****************************************************************************
@@ -188,6 +256,392 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+
+/****************************************************************************
+ * Name: ipfilter_index_add
+ *
+ * Description:
+ *   Add a rule to the end of the index of its chain.  A rule that matches a
+ *   single TCP/UDP destination port goes to the port bucket of the port,
+ *   one that matches a single destination host to the address bucket of
+ *   hostkey, all others to the list of the rules with neither key.  No
+ *   packet that does not hash to its bucket can be matched by a rule.
+ *
+ * Input Parameters:
+ *   index   - The index of the chain
+ *   entry   - The rule that was added to the chain
+ *   host    - Whether the rule matches a single destination host
+ *   hostkey - The key of the destination host
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_add(FAR struct ipfilter_index_s *index,
+                               FAR struct ipfilter_entry_s *entry,
+                               bool host, uint32_t hostkey)
+{
+  FAR dq_queue_t *list;
+  uint32_t key;
+
+  entry->order = index->count++;
+
+  if (IPFILTER_PORTPROTO(entry->proto) && !entry->inv_proto &&
+      entry->match_tcpudp && !entry->inv_dport &&
+      entry->match.tcpudp.dports[0] == entry->match.tcpudp.dports[1])
+    {
+      key  = IPFILTER_PORTKEY(entry->proto, entry->match.tcpudp.dports[0]);
+      list = &index->port[HASH(key, hashtable_bits(index->port))];
+    }
+  else if (host)
+    {
+      list = &index->addr[HASH(hostkey, hashtable_bits(index->addr))];
+    }
+  else
+    {
+      list = &index->other;
+    }
+
+  dq_addlast(&entry->node, list);
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_clear
+ *
+ * Description:
+ *   Empty the index of a chain whose rules are freed.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_clear(FAR struct ipfilter_index_s *index)
+{
+  hashtable_init(index->port);
+  hashtable_init(index->addr);
+  dq_init(&index->other);
+  index->count = 0;
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_start / ipfilter_index_next
+ *
+ * Description:
+ *   Walk the rules of a chain that may match a packet:  Those in the port
+ *   bucket of a TCP/UDP packet, in the address bucket of its destination,
+ *   and those with neither key.  The three lists are merged, so the rules
+ *   are returned in chain order and the first one matching is the same as
+ *   with the walk of the whole chain.
+ *
+ * Input Parameters:
+ *   index   - The index of the chain
+ *   cursor  - The positions in the three lists
+ *   proto   - The protocol of the packet
+ *   l4hdr   - The L4 header of the packet
+ *   hostkey - The key of the destination address of the packet
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_start(FAR struct ipfilter_index_s *index,
+                                 FAR dq_entry_t **cursor, uint8_t proto,
+                                 FAR const void *l4hdr, uint32_t hostkey)
+{
+  FAR const struct udp_hdr_s *udp = l4hdr;
+  uint32_t key;
+
+  cursor[0] = NULL;
+  if (IPFILTER_PORTPROTO(proto))
+    {
+      /* Ports in TCP & UDP headers have same offset. */
+
+      key       = IPFILTER_PORTKEY(proto, NTOHS(udp->destport));
+      cursor[0] = dq_peek(&index->port[HASH(key,
+                                            hashtable_bits(index->port))]);
+    }
+
+  cursor[1] = dq_peek(&index->addr[HASH(hostkey,
+                                        hashtable_bits(index->addr))]);
+  cursor[2] = dq_peek(&index->other);
+}
+
+static FAR const struct ipfilter_entry_s *
+ipfilter_index_next(FAR dq_entry_t **cursor)
+{
+  FAR const struct ipfilter_entry_s *next = NULL;
+  FAR const struct ipfilter_entry_s *entry;
+  int list = 0;
+  int i;
+
+  for (i = 0; i < 3; i++)
+    {
+      if (cursor[i] != NULL)
+        {
+          entry = container_of(cursor[i], struct ipfilter_entry_s, node);
+          if (next == NULL || entry->order < next->order)
+            {
+              next = entry;
+              list = i;
+            }
+        }
+    }
+
+  if (next != NULL)
+    {
+      cursor[list] = dq_next(cursor[list]);
+    }
+
+  return next;
+}
+#endif /* CONFIG_NET_IPFILTER_INDEX */
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+
+/****************************************************************************
+ * Name: ipfilter_flow_init
+ *
+ * Description:
+ *   Start the flow key of a TCP/UDP packet, the caller adds the addresses.
+ *
+ ****************************************************************************/
+
+static void ipfilter_flow_init(FAR struct ipfilter_flow_s *key,
+                               FAR const struct net_driver_s *indev,
+                               FAR const struct net_driver_s *outdev,
+                               enum ipfilter_chain_e chain,
+                               sa_family_t family, uint8_t proto,
+                               FAR const void *l4hdr)
+{
+  FAR const struct udp_hdr_s *udp = l4hdr;
+
+  memset(key, 0, sizeof(*key));
+  key->indev  = indev;
+  key->outdev = outdev;
+  key->sport  = udp->srcport;
+  key->dport  = udp->destport;
+  key->family = family;
+  key->proto  = proto;
+  key->chain  = chain;
+  key->valid  = 1;
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_slot
+ *
+ * Description:
+ *   Return the slot of the flow cache a flow key hashes to.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_flow_s *
+ipfilter_flow_slot(FAR const struct ipfilter_flow_s *key)
+{
+  FAR const uint32_t *word = (FAR const uint32_t *)key;
+  uint32_t hash = 0;
+  size_t i;
+
+  for (i = 0; i < sizeof(*key) / sizeof(uint32_t); i++)
+    {
+      hash = (hash ^ word[i]) * GOLDEN_RATIO_32;
+    }
+
+  return &g_ipfilter_flows[(hash ^ (hash >> 16)) %
+                           CONFIG_NET_IPFILTER_FLOWCACHE];
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_lookup / ipfilter_flow_insert
+ *
+ * Description:
+ *   Look for an accepted flow in the cache, or remember one.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_flow_lookup(FAR const struct ipfilter_flow_s *key)
+{
+  return memcmp(ipfilter_flow_slot(key), key, sizeof(*key)) == 0;
+}
+
+static void ipfilter_flow_insert(FAR const struct ipfilter_flow_s *key)
+{
+  *ipfilter_flow_slot(key) = *key;
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_flush
+ *
+ * Description:
+ *   Forget all accepted flows when the rules change.
+ *
+ ****************************************************************************/
+
+static void ipfilter_flow_flush(void)
+{
+  memset(g_ipfilter_flows, 0, sizeof(g_ipfilter_flows));
+}
+#endif /* CONFIG_NET_IPFILTER_FLOWCACHE > 0 */
+
+#ifdef CONFIG_NET_IPv4
+
+/****************************************************************************
+ * Name: ipv4_filter_hostkey
+ *
+ * Description:
+ *   Return whether an IPv4 rule matches a single destination host, and
+ *   the key of the host.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static bool ipv4_filter_hostkey(FAR const struct ipfilter_entry_s *entry,
+                                FAR uint32_t *key)
+{
+  FAR const struct ipv4_filter_entry_s *filter =
+    (FAR const struct ipv4_filter_entry_s *)entry;
+
+  *key = filter->dip;
+  return !entry->inv_dstip && filter->dmsk == UINT32_MAX;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv4_filter_match_entry
+ *
+ * Description:
+ *   Match an IPv4 packet with one filter entry.
+ *
+ ****************************************************************************/
+
+static bool
+ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv4_hdr_s *ipv4,
+                        FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+
+/****************************************************************************
+ * Name: ipv6_filter_addrkey / ipv6_filter_hostkey
+ *
+ * Description:
+ *   Fold an IPv6 address into a key of the index.  Return whether an IPv6
+ *   rule matches a single destination host, and the key of the host.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static uint32_t ipv6_filter_addrkey(FAR const uint16_t *addr)
+{
+  uint32_t key = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)addr[i] << 16) | addr[i + 1];
+    }
+
+  return key;
+}
+
+static bool ipv6_filter_hostkey(FAR const struct ipfilter_entry_s *entry,
+                                FAR uint32_t *key)
+{
+  FAR const struct ipv6_filter_entry_s *filter =
+    (FAR const struct ipv6_filter_entry_s *)entry;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      if (filter->dmsk[i] != UINT16_MAX)
+        {
+          return false;
+        }
+    }
+
+  *key = ipv6_filter_addrkey(filter->dip);
+  return !entry->inv_dstip;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match an IPv6 packet with one filter entry.
+ *
+ ****************************************************************************/
+
+static bool
+ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv6_hdr_s *ipv6,
+                        FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif /* CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -213,12 +667,15 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv4_hdr_s *ipv4,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR const struct ipfilter_entry_s *entry;
   FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR dq_entry_t *cursor[3];
+#endif
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  struct ipfilter_flow_s key;
+  bool cached = false;
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -229,45 +686,48 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
-  sq_for_every(queue, entry)
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  if (IPFILTER_PORTPROTO(ipv4->proto))
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+      ipfilter_flow_init(&key, indev, outdev, chain, PF_INET, ipv4->proto,
+                         l4hdr);
+      memcpy(key.srcip, ipv4->srcipaddr, sizeof(in_addr_t));
+      memcpy(key.dstip, ipv4->destipaddr, sizeof(in_addr_t));
+      if (ipfilter_flow_lookup(&key))
         {
-          continue;
+          return IPFILTER_TARGET_ACCEPT;
         }
 
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      cached = true;
+    }
+#endif
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  ipfilter_index_start(&g_ipv4_index[chain], cursor, ipv4->proto, l4hdr,
+                       net_ip4addr_conv32(ipv4->destipaddr));
+  while ((entry = ipfilter_index_next(cursor)) != NULL)
+#else
+  for (entry = (FAR const struct ipfilter_entry_s *)
+               sq_peek(&g_ipv4_filters[chain]);
+       entry != NULL; entry = entry->flink)
+#endif
+    {
+      if (!ipv4_filter_match_entry((FAR const struct ipv4_filter_entry_s *)
+                                   entry, indev, outdev, ipv4, l4hdr))
         {
           continue;
         }
 
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+      if (cached && entry->target == IPFILTER_TARGET_ACCEPT)
         {
-          continue;
+          ipfilter_flow_insert(&key);
         }
+#endif
 
       /* Return the target action if matched. */
 
-      return filter->common.target;
+      return entry->target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -283,12 +743,16 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR const struct ipfilter_entry_s *entry;
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR dq_entry_t *cursor[3];
+#endif
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  struct ipfilter_flow_s key;
+  bool cached = false;
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,45 +763,49 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  if (IPFILTER_PORTPROTO(proto))
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+      ipfilter_flow_init(&key, indev, outdev, chain, PF_INET6, proto,
+                         l4hdr);
+      memcpy(key.srcip, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+      memcpy(key.dstip, ipv6->destipaddr, sizeof(net_ipv6addr_t));
+      if (ipfilter_flow_lookup(&key))
         {
-          continue;
+          return IPFILTER_TARGET_ACCEPT;
         }
 
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      cached = true;
+    }
+#endif
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  ipfilter_index_start(&g_ipv6_index[chain], cursor, proto, l4hdr,
+                       ipv6_filter_addrkey(ipv6->destipaddr));
+  while ((entry = ipfilter_index_next(cursor)) != NULL)
+#else
+  for (entry = (FAR const struct ipfilter_entry_s *)
+               sq_peek(&g_ipv6_filters[chain]);
+       entry != NULL; entry = entry->flink)
+#endif
+    {
+      if (!ipv6_filter_match_entry((FAR const struct ipv6_filter_entry_s *)
+                                   entry, indev, outdev, ipv6, l4hdr,
+                                   proto))
         {
           continue;
         }
 
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+      if (cached && entry->target == IPFILTER_TARGET_ACCEPT)
         {
-          continue;
+          ipfilter_flow_insert(&key);
         }
+#endif
 
       /* Return the target action if matched. */
 
-      return filter->common.target;
+      return entry->target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -407,10 +875,19 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  uint32_t key;
+  bool host;
+#endif
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      host = ipv4_filter_hostkey(entry, &key);
+      ipfilter_index_add(&g_ipv4_index[chain], entry, host, key);
+#endif
     }
 #endif
 
@@ -418,8 +895,14 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      host = ipv6_filter_hostkey(entry, &key);
+      ipfilter_index_add(&g_ipv6_index[chain], entry, host, key);
+#endif
     }
 #endif
+
+  ipfilter_flow_flush();
 }
 
 /****************************************************************************
@@ -448,6 +931,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_clear(&g_ipv4_index[chain]);
+#endif
     }
 #endif
 
@@ -459,8 +946,14 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_clear(&g_ipv6_index[chain]);
+#endif
     }
 #endif
+
+  ipfilter_flow_flush();
 }
 
 /****************************************************************************
@@ -32,6 +32,7 @@
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NET_IPFILTER
@@ -62,6 +63,11 @@ struct ipfilter_entry_s
 {
   FAR struct ipfilter_entry_s *flink;
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  hash_node_t node;       /* The node in the index of the chain */
+  uint32_t    order;      /* The position in the chain */
+#endif
+
   FAR struct net_driver_s *indev;
   FAR struct net_driver_s *outdev;
 
@@ -369,4 +369,28 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipv4_forward_flush
+ *
+ * Description:
+ *   Forget all of the cached forwarding flows.  This must be called when
+ *   the routes, the ARP table or the configuration of a network device
+ *   change.
+ *
+ * Input Parameters:
+ *   dev - If not NULL, the device going down whose queued forwarded
+ *         packets are also dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+void ipv4_forward_flush(FAR struct net_driver_s *dev);
+#else
+#  define ipv4_forward_flush(dev)
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -61,19 +61,19 @@ static int proto_dropstats(int proto)
     {
 #ifdef CONFIG_NET_TCP
     case IP_PROTO_TCP:
-      g_netstats.tcp.drop++;
+      NETSTATS.tcp.drop++;
       break;
 #endif
 
 #ifdef CONFIG_NET_UDP
     case IP_PROTO_UDP:
-      g_netstats.udp.drop++;
+      NETSTATS.udp.drop++;
       break;
 #endif
 
 #ifdef CONFIG_NET_ICMPv6
     case IP_PROTO_ICMP6:
-      g_netstats.icmpv6.drop++;
+      NETSTATS.icmpv6.drop++;
       break;
 #endif
 
@@ -111,10 +111,10 @@ void ipv6_dropstats(FAR struct ipv6_hdr_s *ipv6)
   ret = proto_dropstats(ipv6->proto);
   if (ret < 0)
     {
-      g_netstats.ipv6.protoerr++;
+      NETSTATS.ipv6.protoerr++;
     }
 
-  g_netstats.ipv6.drop++;
+  NETSTATS.ipv6.drop++;
 }
 #endif
 
@@ -141,10 +141,10 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4)
   ret = proto_dropstats(ipv4->proto);
   if (ret < 0)
     {
-      g_netstats.ipv4.protoerr++;
+      NETSTATS.ipv4.protoerr++;
     }
 
-  g_netstats.ipv4.drop++;
+  NETSTATS.ipv4.drop++;
 }
 #endif
 
@@ -31,10 +31,14 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/udp.h>
 
 #include "netdev/netdev.h"
 #include "utils/utils.h"
@@ -44,9 +48,70 @@
 #include "ipforward/ipforward.h"
 #include "nat/nat.h"
 #include "devif/devif.h"
+#include "route/route.h"
+#include "arp/arp.h"
 
 #if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+/* A cached flow is used no longer than the ARP entry of its next hop */
+
+#  ifdef CONFIG_NET_ARP
+#    define IPv4_FLOW_MAXAGE SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#  else
+#    define IPv4_FLOW_MAXAGE SEC2TICK(120)
+#  endif
+
+/* The IPv4 packet is a fragment */
+
+#  define IPv4_ISFRAG(ipv4) \
+  (((ipv4)->ipoffset[0] & 0x3f) != 0 || (ipv4)->ipoffset[1] != 0)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+/* The key of a forwarded TCP/UDP flow */
+
+struct ipv4_flowkey_s
+{
+  FAR struct net_driver_s *indev;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t  srcport;   /* Ports in network byte order */
+  uint16_t  destport;
+  uint8_t   proto;
+};
+
+/* A forwarded flow and where its packets go */
+
+struct ipv4_flow_s
+{
+  struct ipv4_flowkey_s key;
+  FAR struct net_driver_s *fwddev;  /* Forwarding device */
+  clock_t  time;                    /* When the flow was cached */
+  uint32_t gen;                     /* Cache generation, zero if empty */
+#  ifdef CONFIG_NET_ARP
+  uint8_t  ethaddr[ETHER_ADDR_LEN]; /* MAC address of the next hop */
+#  endif
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_FLOWCACHE];
+static uint32_t g_ipv4_flowgen = 1;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -143,8 +208,8 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  FAR uint16_t *ttlproto = (FAR uint16_t *)&ipv4->ttl;
+  uint16_t oldval;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -159,29 +224,14 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   /* Save the updated TTL value */
 
+  oldval    = *ttlproto;
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Only the 16-bit word holding the TTL and the protocol has changed, so
+   * adjust the IPv4 checksum for it instead of summing the whole header.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = HTONS(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  net_chksum_adjust(&ipv4->ipchksum, &oldval, 2, ttlproto, 2);
   return ttl;
 }
 
@@ -420,6 +470,203 @@ static int ipv4_forward_callback(FAR struct net_driver_s *fwddev,
 }
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flow_slot
+ *
+ * Description:
+ *   Build the flow key of a received packet and return the slot of the
+ *   flow cache it hashes to.
+ *
+ * Returned Value:
+ *   The slot of the flow cache, or NULL if the packet is not a TCP or UDP
+ *   packet that can be cached (i.e., it is a fragment or another protocol).
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+static FAR struct ipv4_flow_s *
+ipv4_flow_slot(FAR struct net_driver_s *dev,
+               FAR const struct ipv4_hdr_s *ipv4,
+               FAR struct ipv4_flowkey_s *key)
+{
+  FAR const struct udp_hdr_s *udp;
+  FAR const uint32_t *word = (FAR const uint32_t *)key;
+  uint32_t hash = 0;
+  size_t i;
+
+  if ((ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP) ||
+      IPv4_ISFRAG(ipv4))
+    {
+      return NULL;
+    }
+
+  /* The ports are at the same place in the TCP and UDP headers */
+
+  udp = (FAR const struct udp_hdr_s *)
+        ((FAR const uint8_t *)ipv4 + ((ipv4->vhl & IPv4_HLMASK) << 2));
+
+  memset(key, 0, sizeof(*key));
+  key->indev      = dev;
+  key->srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->srcport    = udp->srcport;
+  key->destport   = udp->destport;
+  key->proto      = ipv4->proto;
+
+  for (i = 0; i < sizeof(*key) / sizeof(uint32_t); i++)
+    {
+      hash = (hash ^ word[i]) * GOLDEN_RATIO_32;
+    }
+
+  return &g_ipv4_flows[(hash ^ (hash >> 16)) %
+                       CONFIG_NET_IPFORWARD_FLOWCACHE];
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_insert
+ *
+ * Description:
+ *   Remember a flow after its packet was forwarded by the slow path.  Only
+ *   flows whose next hop MAC address is already known (or whose forwarding
+ *   device has no link layer header) are cached.
+ *
+ ****************************************************************************/
+
+static void ipv4_flow_insert(FAR struct ipv4_flow_s *flow,
+                             FAR const struct ipv4_flowkey_s *key,
+                             FAR struct net_driver_s *fwddev)
+{
+#ifdef CONFIG_NET_ARP
+  in_addr_t ipaddr = key->destipaddr;
+
+  if (fwddev->d_lltype == NET_LL_ETHERNET ||
+      fwddev->d_lltype == NET_LL_IEEE80211)
+    {
+      /* Find the next hop the same way as arp_out() does.  Broadcast and
+       * multicast destinations are not cached.
+       */
+
+      if (ipaddr == INADDR_BROADCAST || IN_MULTICAST(NTOHL(ipaddr)))
+        {
+          return;
+        }
+
+      if (!net_ipv4addr_maskcmp(ipaddr, fwddev->d_ipaddr,
+                                fwddev->d_netmask))
+        {
+#  ifdef CONFIG_NET_ROUTE
+          netdev_ipv4_router(fwddev, key->destipaddr, &ipaddr);
+#  else
+          net_ipv4addr_copy(ipaddr, fwddev->d_draddr);
+#  endif
+        }
+      else if (net_ipv4addr_broadcast(ipaddr, fwddev->d_netmask))
+        {
+          return;
+        }
+
+      if (arp_find(ipaddr, flow->ethaddr, fwddev) < 0)
+        {
+          return;
+        }
+    }
+  else
+#endif
+  if (NET_LL_HDRLEN(fwddev) != 0)
+    {
+      return;
+    }
+
+  flow->key    = *key;
+  flow->fwddev = fwddev;
+  flow->time   = clock_systime_ticks();
+  flow->gen    = g_ipv4_flowgen;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_forward
+ *
+ * Description:
+ *   Forward a packet of a cached flow: the IPv4 header is updated, the link
+ *   layer header is built in place and the packet is queued directly for
+ *   transmission on the forwarding device.
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was queued, -EAGAIN if the packet must
+ *   go through the slow path (which also handles all of the replies), or
+ *   another negated errno value if the packet must be dropped.
+ *
+ ****************************************************************************/
+
+static int ipv4_flow_forward(FAR struct net_driver_s *dev,
+                             FAR const struct ipv4_flow_s *flow,
+                             FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct net_driver_s *fwddev = flow->fwddev;
+  int ret;
+
+  /* Leave the expiring and the oversized packets to the slow path, and
+   * do not let the queue of the forwarding device grow beyond what the
+   * slow path allows.
+   */
+
+  if (!IFF_IS_UP(fwddev->d_flags) || ipv4->ttl <= 1 ||
+      NET_LL_HDRLEN(fwddev) + dev->d_len > NETDEV_PKTSIZE(fwddev) ||
+      iob_get_queue_entry_count(&fwddev->d_fwdout) >=
+      CONFIG_NET_IPFORWARD_NSTRUCT)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_NET_IPFILTER
+  /* The filter has its own flow cache, so this is cheap for the packets
+   * it already accepted.
+   */
+
+  if (ipv4_filter_fwd(dev, fwddev, ipv4) < 0)
+    {
+      return -EAGAIN;
+    }
+#endif
+
+  ipv4_decr_ttl(ipv4);
+
+#ifdef CONFIG_NET_NAT44
+  ret = ipv4_nat_outbound(fwddev, ipv4, NAT_MANIP_SRC);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Performing NAT44 outbound failed, dropping!\n");
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_NET_ARP
+  if (fwddev->d_lltype == NET_LL_ETHERNET ||
+      fwddev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *peth =
+        (FAR struct eth_hdr_s *)((FAR uint8_t *)ipv4 - ETH_HDRLEN);
+
+      memcpy(peth->dest, flow->ethaddr, ETHER_ADDR_LEN);
+      memcpy(peth->src, fwddev->d_mac.ether.ether_addr_octet,
+             ETHER_ADDR_LEN);
+      peth->type = HTONS(ETHTYPE_IP);
+    }
+#endif
+
+  ret = iob_tryadd_queue(dev->d_iob, &fwddev->d_fwdout);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Failed to queue the forwarded packet: %d\n", ret);
+      return -ENOMEM;
+    }
+
+  netdev_iob_clear(dev);
+  netdev_txnotify_dev(fwddev);
+  return OK;
+}
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE > 0 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -458,12 +705,37 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+#endif
   int ret;
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
   int icmp_reply_type;
   int icmp_reply_code;
 #endif /* CONFIG_NET_ICMP */
 
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+  /* Packets of a known flow bypass the route lookup */
+
+  flow = ipv4_flow_slot(dev, ipv4, &key);
+  if (flow != NULL && flow->gen == g_ipv4_flowgen &&
+      clock_systime_ticks() - flow->time <= IPv4_FLOW_MAXAGE &&
+      memcmp(&flow->key, &key, sizeof(key)) == 0)
+    {
+      ret = ipv4_flow_forward(dev, flow, ipv4);
+      if (ret != -EAGAIN)
+        {
+          if (ret < 0)
+            {
+              goto drop;
+            }
+
+          return OK;
+        }
+    }
+#endif
+
   /* Search for a device that can forward this packet. */
 
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
@@ -491,6 +763,13 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+      if (flow != NULL)
+        {
+          ipv4_flow_insert(flow, &key, fwddev);
+        }
+#endif
     }
   else
     {
@@ -612,4 +891,41 @@ void ipv4_forward_broadcast(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: ipv4_forward_flush
+ *
+ * Description:
+ *   Forget all of the cached forwarding flows.  This must be called when
+ *   the routes, the ARP table or the configuration of a network device
+ *   change.
+ *
+ * Input Parameters:
+ *   dev - If not NULL, the device going down whose queued forwarded
+ *         packets are also dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+void ipv4_forward_flush(FAR struct net_driver_s *dev)
+{
+  /* Bumping the generation invalidates all of the entries at once.  Zero
+   * is never used, so that the empty entries never match.
+   */
+
+  if (++g_ipv4_flowgen == 0)
+    {
+      memset(g_ipv4_flows, 0, sizeof(g_ipv4_flows));
+      g_ipv4_flowgen = 1;
+    }
+
+  if (dev != NULL)
+    {
+      iob_free_queue(&dev->d_fwdout);
+    }
+}
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD && CONFIG_NET_IPv4 */
@@ -117,26 +117,26 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* The reassembly hash table, the nodes of all NICs hashed by their
+ * addresses, IP ID and protocol.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static dq_queue_t    g_assemblyhash[CONFIG_NET_IPFRAG_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
  */
 
-static sq_queue_t    g_assemblyhead_time;
+static dq_queue_t    g_assemblyhead_time;
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access the reassembly hash table and
+ * g_assemblyhead_time at a time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -149,6 +149,11 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node);
+static void ip_fragin_getkey(FAR struct net_driver_s *dev,
+                             FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key);
+static uint16_t ip_fragin_hash(FAR const struct ip_fragkey_s *key);
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
@@ -193,8 +198,8 @@ static void ip_fragin_timerwork(FAR void *arg)
 {
   clock_t curtick = clock_systime_ticks();
   sclock_t interval = 0;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
   ninfo("Start reassembly work queue\n");
@@ -205,13 +210,12 @@ static void ip_fragin_timerwork(FAR void *arg)
    * interval
    */
 
-  entry = sq_peek(&g_assemblyhead_time);
+  entry = dq_peek(&g_assemblyhead_time);
   while (entry != NULL)
     {
-      entrynext = sq_next(entry);
+      entrynext = dq_next(entry);
 
-      node = (FAR struct ip_fragsnode_s *)
-             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      node = container_of(entry, struct ip_fragsnode_s, tnode);
 
       /* Check for timeout, be careful with the calculation formula,
        * the tick counter may overflow
@@ -230,7 +234,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
           if ((node->verifyflag & IP_FRAGVERIFY_RECVDZEROFRAG) != 0)
             {
-              FAR struct net_driver_s *dev = node->dev;
+              FAR struct net_driver_s *dev = node->key.dev;
 
               net_lock();
 
@@ -270,22 +274,9 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
+          /* Remove fragments of this node and the node */
 
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          /* Remove node from single-list and free node memory */
-
-          ip_frag_remnode(node);
-          kmm_free(node);
+          ip_fragin_freenode(node);
         }
       else
         {
@@ -305,7 +296,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 
   /* Be sure to start the timer, if there are nodes in the linked list */
 
-  if (sq_peek(&g_assemblyhead_time) != NULL)
+  if (dq_peek(&g_assemblyhead_time) != NULL)
     {
       clock_t delay = REASSEMBLY_TIMEOUT_MINIMALTICKS;
 
@@ -362,11 +353,119 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
   return next;
 }
 
+/****************************************************************************
+ * Name: ip_fragin_freenode
+ *
+ * Description:
+ *   Free all fragments of a node, remove the node from the reassembly
+ *   cache and free it.
+ *
+ * Input Parameters:
+ *   node - node of the upper-level linked list, it maintains
+ *          information about all fragments belonging to an IP datagram
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
+{
+  FAR struct ip_fraglink_s *fraglink = node->frags;
+
+  while (fraglink != NULL)
+    {
+      fraglink = ip_fragin_freelink(fraglink);
+    }
+
+  ip_frag_remnode(node);
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_getkey
+ *
+ * Description:
+ *   Get the fields identifying the datagram of a fragment from its IP
+ *   header.
+ *
+ * Input Parameters:
+ *   dev      - NIC Device instance
+ *   fraglink - node of the lower-level linked list, it maintains
+ *              information of one fragment
+ *   key      - The location to return the key
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_getkey(FAR struct net_driver_s *dev,
+                             FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key)
+{
+  FAR uint8_t *iphdr = fraglink->frag->io_data + fraglink->frag->io_offset;
+
+  /* The key is compared with memcmp(), so clear the padding as well */
+
+  memset(key, 0, sizeof(*key));
+  key->dev    = dev;
+  key->ipid   = fraglink->ipid;
+  key->isipv4 = fraglink->isipv4;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)iphdr;
+
+      memcpy(key->srcipaddr, ipv4->srcipaddr, sizeof(ipv4->srcipaddr));
+      memcpy(key->destipaddr, ipv4->destipaddr, sizeof(ipv4->destipaddr));
+      key->proto = ipv4->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)iphdr;
+
+      memcpy(key->srcipaddr, ipv6->srcipaddr, sizeof(ipv6->srcipaddr));
+      memcpy(key->destipaddr, ipv6->destipaddr, sizeof(ipv6->destipaddr));
+    }
+#endif
+
+  UNUSED(iphdr);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Return the reassembly hash table bucket of a datagram.
+ *
+ ****************************************************************************/
+
+static uint16_t ip_fragin_hash(FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = key->ipid ^ key->proto;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + key->srcipaddr[i];
+      hash = hash * 31 + key->destipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  return hash % CONFIG_NET_IPFRAG_HASHSIZE;
+}
+
 /****************************************************************************
  * Name: ip_fragin_check
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
+ *   Move the end of the data received without a gap from offset zero over
+ *   the fragments that now follow it, and check whether all fragments have
  *   been received.
  *
  * Input Parameters:
@@ -380,30 +479,22 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
 {
-  uint16_t formerlen = 0;
   FAR struct ip_fraglink_s *entry;
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
-    {
-      entry = fragsnode->frags;
-      while (entry != NULL)
-        {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+  entry = fragsnode->contfrag != NULL ? fragsnode->contfrag->flink :
+                                        fragsnode->frags;
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+  while (entry != NULL && entry->fragoff <= fragsnode->contlen)
+    {
+      fragsnode->contlen  = entry->fragoff + entry->fraglen;
+      fragsnode->contfrag = entry;
+      entry = entry->flink;
+    }
 
-          entry = entry->flink;
-        }
+  if ((fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      fragsnode->contlen >= fragsnode->totallen)
+    {
+      fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
     }
 }
 
@@ -427,8 +518,8 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 {
   uint32_t        cleancnt = 0;
   uint32_t        bufcnt;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
   /* Start cache cleaning if g_bufoccupy exceeds the cache threshold */
@@ -436,35 +527,22 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
   if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
     {
       cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
-      entry = sq_peek(&g_assemblyhead_time);
+      entry = dq_peek(&g_assemblyhead_time);
 
       while (entry != NULL && cleancnt > 0)
         {
-          entrynext = sq_next(entry);
+          entrynext = dq_next(entry);
 
-          node = (FAR struct ip_fragsnode_s *)
-                 container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+          node = container_of(entry, struct ip_fragsnode_s, tnode);
 
           /* Skip specified node */
 
           if (node != curnode)
             {
-              /* Remove fragments of this node */
+              /* Remove fragments of this node and the node */
 
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
-
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
-
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
+              bufcnt = node->bufcnt;
+              ip_fragin_freenode(node);
 
               cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
             }
@@ -530,8 +608,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-  sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  dq_rem(&node->hnode, &g_assemblyhash[node->hash]);
+  dq_rem(&node->tnode, &g_assemblyhead_time);
 
   return node->bufcnt;
 }
@@ -555,179 +633,181 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
-  FAR struct ip_fragsnode_s *node;
-  FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  FAR struct ip_fragsnode_s *node = NULL;
+  FAR struct ip_fraglink_s  *prev;
+  FAR struct ip_fraglink_s  *next;
+  FAR dq_entry_t            *entry;
+  struct ip_fragkey_s        key;
+  uint32_t                   curend;
+  uint32_t                   bufcnt;
+  uint16_t                   hash;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
-   */
+  empty = dq_empty(&g_assemblyhead_time);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  /* Look up the node of this datagram in its hash bucket */
 
-  while (entry != NULL)
+  ip_fragin_getkey(dev, curfraglink, &key);
+  hash = ip_fragin_hash(&key);
+
+  for (entry = dq_peek(&g_assemblyhash[hash]); entry != NULL;
+       entry = dq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *cand =
+        container_of(entry, struct ip_fragsnode_s, hnode);
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (memcmp(&cand->key, &key, sizeof(key)) == 0)
         {
+          node = cand;
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
+  curend = curfraglink->fragoff + curfraglink->fraglen;
+  bufcnt = IOBUF_CNT(curfraglink->frag);
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node == NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
-
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
-
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
+      /* It's a new datagram, malloc a new node and insert it into the
+       * hash table
        */
 
-      while (fraglink != NULL)
+      node = kmm_zalloc(sizeof(struct ip_fragsnode_s));
+      if (node == NULL)
         {
-          /* The fragment list is ordered by fragment offset value */
+          nerr("ERROR: Failed to allocate buffer.\n");
+          return -ENOMEM;
+        }
 
-          if (curfraglink->fragoff <= fraglink->fragoff)
-            {
-              break;
-            }
+      node->key  = key;
+      node->hash = hash;
+      node->tick = clock_systime_ticks();
 
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
-        }
+      dq_addlast(&node->hnode, &g_assemblyhash[hash]);
 
-      if (fraglink == NULL)
-        {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
+      /* Add this new node to the tail of linked list identified by
+       * g_assemblyhead_time
+       */
 
-          lastlink->flink      = curfraglink;
+      dq_addlast(&node->tnode, &g_assemblyhead_time);
 
-          /* Remember I/O buffer count */
+      prev = NULL;
+      next = NULL;
+    }
+  else
+    {
+      /* A datagram may not hold more fragments or I/O buffers than its
+       * share, or a flood of small fragments would take all of them.
+       */
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
+      if (node->nfrags >= CONFIG_NET_IPFRAG_MAXFRAGS ||
+          node->bufcnt + bufcnt > REASSEMBLY_MAXOCCUPYIOB)
         {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
+          nwarn("WARNING: Datagram exceeds the reassembly limits\n");
+          ip_fragin_freenode(node);
+          return -ENOBUFS;
+        }
 
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
-            {
-              node->frags = curfraglink;
-            }
-          else
-            {
-              lastlink->flink = curfraglink;
-            }
+      /* Find the position of the fragment.  Fragments mostly arrive in
+       * order, so look behind the last one first, then behind the data
+       * received without a gap.
+       */
 
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
-        }
-      else
+      prev = node->lastfrag;
+      if (curfraglink->fragoff <= prev->fragoff)
         {
-          /* Insert into the fragment list */
-
-          if (lastlink == NULL)
+          prev = node->contfrag;
+          if (prev == NULL || curfraglink->fragoff <= prev->fragoff)
             {
-              /* Insert before the first node */
-
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
+              prev = NULL;
             }
-          else
-            {
-              /* Insert this node after lastlink */
 
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
+          next = prev != NULL ? prev->flink : node->frags;
+          while (next != NULL && next->fragoff < curfraglink->fragoff)
+            {
+              prev = next;
+              next = next->flink;
             }
+        }
 
-          /* Remember I/O buffer count */
+      next = prev != NULL ? prev->flink : node->frags;
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-    }
-  else
-    {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+      /* Fragments with same offset and length contain the same data, the
+       * copy queued already is used (RFC791, Section3.2).
        */
 
-      node = kmm_malloc(sizeof(struct ip_fragsnode_s));
-      if (node == NULL)
+      if (next != NULL && next->fragoff == curfraglink->fragoff &&
+          next->fraglen == curfraglink->fraglen &&
+          next->morefrags == curfraglink->morefrags)
         {
-          nerr("ERROR: Failed to allocate buffer.\n");
-          return -ENOMEM;
+          return -EEXIST;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
-      node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
-      node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
-      node->verifyflag = 0;
-      node->outgoframe = NULL;
-
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
+      /* Overlapping fragments are not reassembled, the datagram is
+       * dropped (RFC5722).
        */
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
+      if ((prev != NULL &&
+           prev->fragoff + prev->fraglen > curfraglink->fragoff) ||
+          (next != NULL && curend > next->fragoff))
         {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
+          nwarn("WARNING: Overlapping fragment, datagram dropped\n");
+          ip_fragin_freenode(node);
+          return -EINVAL;
         }
+    }
 
-      /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
-       */
+  /* Nothing may follow the tail fragment */
 
-      sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  if (((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+       curend > node->totallen) ||
+      (!curfraglink->morefrags && next != NULL))
+    {
+      nwarn("WARNING: Fragment beyond the datagram, dropped\n");
+      ip_fragin_freenode(node);
+      return -EINVAL;
     }
 
+  /* Insert the fragment behind prev */
+
+  if (prev == NULL)
+    {
+      curfraglink->flink = node->frags;
+      node->frags        = curfraglink;
+    }
+  else
+    {
+      curfraglink->flink = prev->flink;
+      prev->flink        = curfraglink;
+    }
+
+  if (curfraglink->flink == NULL)
+    {
+      node->lastfrag = curfraglink;
+    }
+
+  /* Remember I/O buffer count */
+
+  node->nfrags++;
+  node->bufcnt += bufcnt;
+  g_bufoccupy  += bufcnt;
+
   if (curfraglink->fragoff == 0)
     {
       /* Have received the zero fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
     }
-  else if (!curfraglink->morefrags)
+
+  if (!curfraglink->morefrags)
     {
       /* Have received the tail fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      node->totallen    = curend;
     }
 
   /* For indexing convenience */
@@ -748,7 +828,47 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
   ip_fragin_cachemonitor(node);
 
-  return empty;
+  return empty ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_append
+ *
+ * Description:
+ *   Append the I/O buffer chain of a fragment to the datagram being
+ *   reassembled.  Unlike iob_concat(), the end of the datagram is not
+ *   searched from its head, so a datagram is reassembled in linear time.
+ *
+ * Input Parameters:
+ *   head - The head of the reassembled datagram
+ *   tail - An I/O buffer of the reassembled datagram, the last one found
+ *          by the previous call
+ *   iob  - The I/O buffer chain to append
+ *
+ * Returned Value:
+ *   The new last I/O buffer of the reassembled datagram
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *ip_fragin_append(FAR struct iob_s *head,
+                                   FAR struct iob_s *tail,
+                                   FAR struct iob_s *iob)
+{
+  while (tail->io_flink != NULL)
+    {
+      tail = tail->io_flink;
+    }
+
+  head->io_pktlen += iob->io_pktlen;
+  iob->io_pktlen   = 0;
+  tail->io_flink   = iob;
+
+  while (iob->io_flink != NULL)
+    {
+      iob = iob->io_flink;
+    }
+
+  return iob;
 }
 
 /****************************************************************************
@@ -1110,36 +1230,26 @@ int32_t ip_frag_uninit(void)
 
 void ip_frag_stop(FAR struct net_driver_s *dev)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry = NULL;
+  FAR dq_entry_t *entrynext;
 
   ninfo("Stop frag processing for NIC:%p\n", dev);
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
+      FAR struct ip_fragsnode_s *node =
+        container_of(entry, struct ip_fragsnode_s, tnode);
+      entrynext = dq_next(entry);
 
-      if (dev == node->dev)
+      if (dev == node->key.dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1166,44 +1276,24 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
 void ip_frag_remallfrags(void)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry = NULL;
+  FAR dq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
-
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
-
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
-
+      entrynext = dq_next(entry);
+      ip_fragin_freenode(container_of(entry, struct ip_fragsnode_s, tnode));
       entry = entrynext;
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
+  DEBUGASSERT(g_bufoccupy == 0);
 
   nxmutex_unlock(&g_ipfrag_lock);
 
@@ -1251,6 +1341,15 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  /* A super-segment is cut into TCP segments by the device */
+
+  if (dev->d_gsosize > 0)
+    {
+      return OK;
+    }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
   if (dev->d_lltype == NET_LL_IEEE802154 ||
       dev->d_lltype == NET_LL_PKTRADIO)
@@ -92,29 +92,39 @@ struct ip_fraglink_s
   uint32_t                   ipid;
 };
 
+/* The fields identifying the fragments of one datagram: the device, the
+ * source and destination addresses, the IP ID and, for IPv4, the protocol.
+ * IPv4 addresses are held in the first two words of the address arrays.
+ */
+
+struct ip_fragkey_s
+{
+  FAR struct net_driver_s   *dev;
+  uint32_t                   ipid;
+  uint16_t                   srcipaddr[8];
+  uint16_t                   destipaddr[8];
+  uint8_t                    proto;
+  uint8_t                    isipv4;
+};
+
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain the list of the nodes that share one
+   * bucket of the reassembly hash table.
    */
 
-  FAR struct ip_fragsnode_s *flink;
+  dq_entry_t                 hnode;
 
   /* Another link which connects all ip_fragsnode_s in order of addition
    * time
    */
 
-  FAR sq_entry_t            *flinkat;
+  dq_entry_t                 tnode;
 
-  /* Interface understood by the network */
+  /* The datagram that the fragments belong to, and its hash bucket */
 
-  FAR struct net_driver_s   *dev;
-
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
-   */
-
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
+  uint16_t                   hash;
 
   /* Count ticks, used by ressembly timer */
 
@@ -124,13 +134,32 @@ struct ip_fragsnode_s
 
   uint16_t                   verifyflag;
 
+  /* The number of fragments held by this node */
+
+  uint16_t                   nfrags;
+
   /* Remember the total number of I/O buffers of this node */
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* Linked all fragments with the same IP ID, ordered by fragment offset.
+   * lastfrag is the fragment with the highest offset, so fragments that
+   * arrive in order are appended without walking the list.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  FAR struct ip_fraglink_s  *lastfrag;
+
+  /* The hole tracking: contfrag is the last fragment of the data received
+   * without a gap from offset zero, contlen the length of that data.  It
+   * only moves forward as fragments arrive, so every fragment is looked at
+   * once.  totallen is the length of the payload, known once the tail
+   * fragment has been received.
+   */
+
+  FAR struct ip_fraglink_s  *contfrag;
+  uint32_t                   contlen;
+  uint32_t                   totallen;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -149,8 +178,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access the reassembly hash table and
+ * g_assemblyhead_time at a time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -182,8 +211,9 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. The ip_fragsnode_s nodes are
+ *   found through a hash table keyed on the addresses, the IP ID and the
+ *   protocol.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -191,12 +221,41 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the reassembly cache was empty before, so that the reassembly
+ *   timer must be started, 0 if not.  A negated errno value if the
+ *   fragment was not queued: the I/O buffer is left to the device and
+ *   the caller frees curfraglink.  -EEXIST is returned for a duplicate,
+ *   -EINVAL for a fragment that overlaps others or does not fit the
+ *   datagram and -ENOBUFS when the datagram exceeds its limits.  The
+ *   datagram is dropped in the latter two cases.
+ *
+ ****************************************************************************/
+
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink);
+
+/****************************************************************************
+ * Name: ip_fragin_append
+ *
+ * Description:
+ *   Append the I/O buffer chain of a fragment to the datagram being
+ *   reassembled.  Unlike iob_concat(), the end of the datagram is not
+ *   searched from its head, so a datagram is reassembled in linear time.
+ *
+ * Input Parameters:
+ *   head - The head of the reassembled datagram
+ *   tail - An I/O buffer of the reassembled datagram, the last one found
+ *          by the previous call
+ *   iob  - The I/O buffer chain to append
+ *
+ * Returned Value:
+ *   The new last I/O buffer of the reassembled datagram
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+FAR struct iob_s *ip_fragin_append(FAR struct iob_s *head,
+                                   FAR struct iob_s *tail,
+                                   FAR struct iob_s *iob);
 
 /****************************************************************************
  * Name: ipv4_fragin
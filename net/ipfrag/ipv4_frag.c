@@ -97,7 +97,8 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
   fraglink->morefrags = offset & IP_FLAG_MOREFRAGS;
   fraglink->fragoff   = ((offset & 0x1fff) << 3);
 
-  fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] - IPv4_HDRLEN;
+  fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] -
+                        ((ipv4->vhl & IPv4_HLMASK) << 2);
   fraglink->ipid      = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
   fraglink->frag      = iob;
 
@@ -122,6 +123,7 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
 static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 {
   FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct ipv4_hdr_s *ipv4;
   FAR struct ip_fraglink_s *fraglink;
 
@@ -156,13 +158,14 @@ static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 
           /* Concatenate this iob to the reassembly chain */
 
-          iob_concat(head, iob);
+          tail = ip_fragin_append(head, tail, iob);
         }
       else
         {
           /* Remember the head iob */
 
           head = iob;
+          tail = iob;
         }
 
       linknext = fraglink->flink;
@@ -261,7 +264,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
-  bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -284,7 +287,13 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
 
@@ -320,7 +329,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
+  if (ret > 0)
     {
       /* Restart the work queue for fragment processing */
 
@@ -426,7 +435,7 @@ int32_t ipv4_fragout(FAR struct net_driver_s *dev, uint16_t mtu)
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.ipv4.sent += nfrags - 1;
+  NETSTATS.ipv4.sent += nfrags - 1;
 #endif
 
   netdev_txnotify_dev(dev);
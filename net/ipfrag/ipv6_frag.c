@@ -174,6 +174,7 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
 static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 {
   FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct ipv6_hdr_s *ipv6;
   FAR struct ip_fraglink_s *fraglink;
 
@@ -246,6 +247,7 @@ static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
           /* Remember the head iob */
 
           head = iob;
+          tail = iob;
         }
       else
         {
@@ -262,7 +264,7 @@ static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 
           /* Concatenate this iob to the reassembly chain */
 
-          iob_concat(head, iob);
+          tail = ip_fragin_append(head, tail, iob);
         }
 
       linknext = fraglink->flink;
@@ -468,7 +470,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
-  bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -485,13 +487,23 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Populate fragment information from input packet data */
 
-  ipv6_fragin_getinfo(dev->d_iob, fraginfo);
+  if (ipv6_fragin_getinfo(dev->d_iob, fraginfo) < 0)
+    {
+      kmm_free(fraginfo);
+      return -EINVAL;
+    }
 
   nxmutex_lock(&g_ipfrag_lock);
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -526,7 +538,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
+  if (ret > 0)
     {
       /* Restart the work queue for fragment processing */
 
@@ -653,7 +665,7 @@ int32_t ipv6_fragout(FAR struct net_driver_s *dev, uint16_t mtu)
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.ipv6.sent += nfrags - 1;
+  NETSTATS.ipv6.sent += nfrags - 1;
 #endif
 
   netdev_txnotify_dev(dev);
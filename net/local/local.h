@@ -135,8 +135,9 @@ struct local_conn_s
                         lc_peer; /* Peer connection instance */
 #ifdef CONFIG_NET_LOCAL_SCM
   uint16_t lc_cfpcount;          /* Control file pointer counter */
-  FAR struct file *
-     lc_cfps[LOCAL_NCONTROLFDS]; /* Socket message control filep */
+  bool lc_passcred;              /* SO_PASSCRED: Receive SCM_CREDENTIALS */
+  struct file
+     lc_cfps[LOCAL_NCONTROLFDS]; /* Socket message control files */
   struct ucred lc_cred;          /* The credentials of connection instance */
 #endif /* CONFIG_NET_LOCAL_SCM */
 
@@ -148,6 +149,17 @@ struct local_conn_s
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* A receiver waiting for the peer to copy its data directly into the
+   * receive buffer.  lc_rxbuf is claimed with the network locked.
+   */
+
+  mutex_t lc_rxlock;           /* Held by the peer while it writes the FIFO */
+  sem_t lc_rxsem;              /* Wakes up the waiting receiver */
+  FAR uint8_t *lc_rxbuf;       /* The buffer of the waiting receiver */
+  size_t lc_rxlen;             /* Its size, then the number of bytes copied */
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * socket events.
    */
@@ -442,6 +454,29 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: local_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for the case of the local Unix
+ *   socket
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On  error, a negated
+ *   errno value is returned (see sendmsg() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+int local_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: local_send_preamble
  *
@@ -486,6 +521,69 @@ int local_send_preamble(FAR struct local_conn_s *conn,
 int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
                       size_t len);
 
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Send data on a connected stream socket:  Copy it directly into the
+ *   buffer of the peer if it is waiting for it, and write what remains to
+ *   the write-only FIFO.
+ *
+ * Input Parameters:
+ *   conn     A reference to local connection structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *
+ * Returned Value:
+ *   The number of bytes sent is returned on success; a negated errno value
+ *   is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t len);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Wait for the peer to copy its data directly into the receive buffer if
+ *   the read-only FIFO is empty.
+ *
+ * Input Parameters:
+ *   conn     A reference to local connection structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *
+ * Returned Value:
+ *   The number of bytes copied by the peer, or zero if the data must be
+ *   read from the FIFO.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_wake
+ *
+ * Description:
+ *   Wake up the peer waiting for a direct copy when the connection stops
+ *   sending, so that it reads the end of file from the FIFO.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_wake(FAR struct local_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: local_recvmsg
  *
@@ -162,6 +162,11 @@ FAR struct local_conn_s *local_alloc(void)
       nxsem_init(&conn->lc_waitsem, 0, 0);
 #endif
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      nxmutex_init(&conn->lc_rxlock);
+      nxsem_init(&conn->lc_rxsem, 0, 0);
+#endif
+
       /* This semaphore is used for sending safely in multithread.
        * Make sure data will not be garbled when multi-thread sends.
        */
@@ -302,6 +307,9 @@ void local_free(FAR struct local_conn_s *conn)
 
   if (conn->lc_peer)
     {
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      local_direct_wake(conn);
+#endif
       conn->lc_peer->lc_peer = NULL;
       conn->lc_peer = NULL;
     }
@@ -327,12 +335,7 @@ void local_free(FAR struct local_conn_s *conn)
 
   for (i = 0; i < conn->lc_cfpcount; i++)
     {
-      if (conn->lc_cfps[i])
-        {
-          file_close(conn->lc_cfps[i]);
-          kmm_free(conn->lc_cfps[i]);
-          conn->lc_cfps[i] = NULL;
-        }
+      file_close(&conn->lc_cfps[i]);
     }
 #endif /* CONFIG_NET_LOCAL_SCM */
 
@@ -343,6 +346,11 @@ void local_free(FAR struct local_conn_s *conn)
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  nxmutex_destroy(&conn->lc_rxlock);
+  nxsem_destroy(&conn->lc_rxsem);
+#endif
+
   /* Destroy sem associated with the connection */
 
   nxmutex_destroy(&conn->lc_sendlock);
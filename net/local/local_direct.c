@@ -0,0 +1,253 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Send data on a connected stream socket:  Copy it directly into the
+ *   buffer of the peer if it is waiting for it, and write what remains to
+ *   the write-only FIFO.
+ *
+ *   The lock of the peer is held until the FIFO is written, so that the
+ *   peer cannot find the FIFO empty and wait for a direct copy of data that
+ *   follows the data still being written.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t len)
+{
+  FAR const struct iovec *end = buf + len;
+  FAR struct local_conn_s *peer;
+  FAR uint8_t *rxbuf = NULL;
+  struct iovec part;
+  size_t offset = 0;
+  size_t rxlen = 0;
+  ssize_t sent = 0;
+  ssize_t ret;
+  size_t n;
+
+  net_lock();
+  peer = conn->lc_peer;
+  if (peer == NULL)
+    {
+      net_unlock();
+      return local_send_packet(&conn->lc_outfile, buf, len);
+    }
+
+  local_addref(peer);
+  net_unlock();
+
+  ret = nxmutex_lock(&peer->lc_rxlock);
+  if (ret < 0)
+    {
+      goto errout_with_peer;
+    }
+
+  net_lock();
+  if (peer->lc_rxbuf != NULL)
+    {
+      rxbuf          = peer->lc_rxbuf;
+      rxlen          = peer->lc_rxlen;
+      peer->lc_rxbuf = NULL;
+    }
+
+  net_unlock();
+
+  if (rxbuf != NULL)
+    {
+      /* The peer waits with an empty FIFO:  Fill its buffer */
+
+      for (; buf != end && sent < rxlen; buf++)
+        {
+          n = MIN(buf->iov_len, rxlen - sent);
+          memcpy(rxbuf + sent, buf->iov_base, n);
+          sent += n;
+
+          if (n < buf->iov_len)
+            {
+              offset = n;
+              break;
+            }
+        }
+
+      peer->lc_rxlen = sent;
+      nxsem_post(&peer->lc_rxsem);
+    }
+
+  /* Write what did not fit to the FIFO */
+
+  ret = OK;
+  if (offset > 0)
+    {
+      part.iov_base = (FAR uint8_t *)buf->iov_base + offset;
+      part.iov_len  = buf->iov_len - offset;
+
+      ret = local_send_packet(&conn->lc_outfile, &part, 1);
+      if (ret > 0)
+        {
+          sent += ret;
+        }
+
+      if (ret < 0 || (size_t)ret < part.iov_len)
+        {
+          goto out;
+        }
+
+      buf++;
+    }
+
+  if (buf != end)
+    {
+      ret = local_send_packet(&conn->lc_outfile, buf, end - buf);
+      if (ret > 0)
+        {
+          sent += ret;
+        }
+    }
+
+out:
+  nxmutex_unlock(&peer->lc_rxlock);
+
+errout_with_peer:
+  net_lock();
+  local_subref(peer);
+  net_unlock();
+
+  return sent > 0 ? sent : ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Wait for the peer to copy its data directly into the receive buffer if
+ *   the read-only FIFO is empty.  The FIFO is read as usual if the peer is
+ *   writing it, if it holds data or if the peer stopped sending.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len)
+{
+  FAR struct local_conn_s *peer;
+  int navail = 0;
+  int ret;
+
+  /* The peer holds the lock while it writes the FIFO */
+
+  if (nxmutex_trylock(&conn->lc_rxlock) < 0)
+    {
+      return 0;
+    }
+
+  ret = file_ioctl(&conn->lc_infile, FIONREAD, &navail);
+
+  net_lock();
+  peer = conn->lc_peer;
+  if (ret < 0 || navail > 0 || conn->lc_rxbuf != NULL || peer == NULL ||
+      peer->lc_outfile.f_inode == NULL)
+    {
+      net_unlock();
+      nxmutex_unlock(&conn->lc_rxlock);
+      return 0;
+    }
+
+  conn->lc_rxbuf = buf;
+  conn->lc_rxlen = len;
+  net_unlock();
+  nxmutex_unlock(&conn->lc_rxlock);
+
+  ret = nxsem_wait(&conn->lc_rxsem);
+  if (ret < 0)
+    {
+      net_lock();
+      if (conn->lc_rxbuf == buf)
+        {
+          /* No peer claimed the buffer:  Leave the signal to the read of
+           * the FIFO.
+           */
+
+          conn->lc_rxbuf = NULL;
+          net_unlock();
+          return 0;
+        }
+
+      net_unlock();
+
+      /* The peer is copying the data, wait until it is done */
+
+      nxsem_wait_uninterruptible(&conn->lc_rxsem);
+    }
+
+  return conn->lc_rxlen;
+}
+
+/****************************************************************************
+ * Name: local_direct_wake
+ *
+ * Description:
+ *   Wake up the peer waiting for a direct copy when the connection stops
+ *   sending, so that it reads the end of file from the FIFO.
+ *
+ ****************************************************************************/
+
+void local_direct_wake(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer != NULL && peer->lc_rxbuf != NULL)
+    {
+      peer->lc_rxbuf = NULL;
+      peer->lc_rxlen = 0;
+      nxsem_post(&peer->lc_rxsem);
+    }
+}
+
+#endif /* CONFIG_NET_LOCAL_DIRECT */
@@ -36,7 +36,6 @@
 #include <debug.h>
 #include <fcntl.h>
 
-#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
@@ -160,6 +159,14 @@ static void local_recvctl(FAR struct local_conn_s *conn,
       peer = conn;
     }
 
+  /* The credentials are those of the peer of a connected stream socket */
+
+  if (conn->lc_passcred && conn->lc_peer != NULL)
+    {
+      cmsg_append(msg, SOL_SOCKET, SCM_CREDENTIALS,
+                  &conn->lc_peer->lc_cred, sizeof(struct ucred));
+    }
+
   if (peer->lc_cfpcount == 0)
     {
       goto out;
@@ -175,11 +182,9 @@ static void local_recvctl(FAR struct local_conn_s *conn,
   count = peer->lc_cfpcount;
   for (i = 0; i < count; i++)
     {
-      fds[i] = file_dup(peer->lc_cfps[i], 0,
+      fds[i] = file_dup(&peer->lc_cfps[i], 0,
                         flags & MSG_CMSG_CLOEXEC ? O_CLOEXEC : 0);
-      file_close(peer->lc_cfps[i]);
-      kmm_free(peer->lc_cfps[i]);
-      peer->lc_cfps[i] = NULL;
+      file_close(&peer->lc_cfps[i]);
       peer->lc_cfpcount--;
       if (fds[i] < 0)
         {
@@ -192,8 +197,10 @@ static void local_recvctl(FAR struct local_conn_s *conn,
     {
       if (peer->lc_cfpcount)
         {
-          memmove(peer->lc_cfps[0], peer->lc_cfps[i],
-                  sizeof(FAR void *) * peer->lc_cfpcount);
+          memmove(&peer->lc_cfps[0], &peer->lc_cfps[i],
+                  sizeof(struct file) * peer->lc_cfpcount);
+          memset(&peer->lc_cfps[peer->lc_cfpcount], 0,
+                 sizeof(struct file) * i);
         }
     }
 
@@ -231,7 +238,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = psock->s_conn;
-  size_t readlen = len;
+  size_t readlen;
   int ret;
 
   /* Verify that this is a connected peer socket */
@@ -268,12 +275,29 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
-  /* Read the packet */
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* A blocking receiver lets the peer copy the data directly into its
+   * buffer if the FIFO is empty.
+   */
 
-  ret = psock_fifo_read(psock, buf, 0, &readlen, flags, true);
-  if (ret < 0)
+  readlen = 0;
+  if ((flags & (MSG_PEEK | MSG_DONTWAIT)) == 0 &&
+      !_SS_ISNONBLOCK(conn->lc_conn.s_flags))
     {
-      return ret;
+      readlen = local_direct_recv(conn, buf, len);
+    }
+
+  if (readlen == 0)
+#endif
+    {
+      /* Read the packet */
+
+      readlen = len;
+      ret = psock_fifo_read(psock, buf, 0, &readlen, flags, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
   /* Return the address family */
@@ -413,6 +437,26 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
+  /* If it is non-blocking mode, the data in fifo is 0 and
+   * returns directly
+   */
+
+  if (flags & MSG_DONTWAIT)
+    {
+      int data_len = 0;
+
+      ret = file_ioctl(&conn->lc_infile, FIONREAD, &data_len);
+      if (ret >= 0 && data_len == 0)
+        {
+          ret = -EAGAIN;
+        }
+
+      if (ret < 0)
+        {
+          goto errout_with_infd;
+        }
+    }
+
   readlen = sizeof(addrlen);
   ret = psock_fifo_read(psock, &addrlen, offset, &readlen, flags, false);
   if (ret < 0)
@@ -33,7 +33,6 @@
 #include <assert.h>
 #include <debug.h>
 
-#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -65,9 +64,7 @@ static void local_freectl(FAR struct local_conn_s *conn, int count)
 
   while (count-- > 0)
     {
-      file_close(peer->lc_cfps[--peer->lc_cfpcount]);
-      kmm_free(peer->lc_cfps[peer->lc_cfpcount]);
-      peer->lc_cfps[peer->lc_cfpcount] = NULL;
+      file_close(&peer->lc_cfps[--peer->lc_cfpcount]);
     }
 }
 
@@ -75,7 +72,7 @@ static int local_sendctl(FAR struct local_conn_s *conn,
                          FAR struct msghdr *msg)
 {
   FAR struct local_conn_s *peer;
-  FAR struct file *filep2;
+  FAR struct ucred *cred;
   FAR struct file *filep;
   FAR struct cmsghdr *cmsg;
   int count = 0;
@@ -93,8 +90,32 @@ static int local_sendctl(FAR struct local_conn_s *conn,
   for_each_cmsghdr(cmsg, msg)
     {
       if (!CMSG_OK(msg, cmsg) ||
-          cmsg->cmsg_level != SOL_SOCKET ||
-          cmsg->cmsg_type != SCM_RIGHTS)
+          cmsg->cmsg_level != SOL_SOCKET)
+        {
+          ret = -EOPNOTSUPP;
+          goto fail;
+        }
+
+      /* The receiver gets the credentials of the connection, a sender can
+       * only pass its own.
+       */
+
+      if (cmsg->cmsg_type == SCM_CREDENTIALS)
+        {
+          cred = (FAR struct ucred *)CMSG_DATA(cmsg);
+          if (cmsg->cmsg_len != CMSG_LEN(sizeof(struct ucred)) ||
+              cred->pid != conn->lc_cred.pid ||
+              cred->uid != conn->lc_cred.uid ||
+              cred->gid != conn->lc_cred.gid)
+            {
+              ret = -EPERM;
+              goto fail;
+            }
+
+          continue;
+        }
+
+      if (cmsg->cmsg_type != SCM_RIGHTS)
         {
           ret = -EOPNOTSUPP;
           goto fail;
@@ -117,23 +138,14 @@ static int local_sendctl(FAR struct local_conn_s *conn,
               goto fail;
             }
 
-          filep2 = kmm_zalloc(sizeof(*filep2));
-          if (!filep2)
-            {
-              fs_putfilep(filep);
-              ret = -ENOMEM;
-              goto fail;
-            }
-
-          ret = file_dup2(filep, filep2);
+          ret = file_dup2(filep, &peer->lc_cfps[peer->lc_cfpcount]);
           fs_putfilep(filep);
           if (ret < 0)
             {
-              kmm_free(filep2);
               goto fail;
             }
 
-          peer->lc_cfps[peer->lc_cfpcount++] = filep2;
+          peer->lc_cfpcount++;
         }
     }
 
@@ -214,7 +226,11 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+          ret = local_direct_send(conn, buf, len);
+#else
           ret = local_send_packet(&conn->lc_outfile, buf, len);
+#endif
           nxmutex_unlock(&conn->lc_sendlock);
         }
         break;
@@ -473,3 +489,99 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   return len;
 }
+
+/****************************************************************************
+ * Name: local_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for the case of the local Unix
+ *   socket.  The consecutive messages to the peer of a connected socket
+ *   that carry no address and no control data are written to the FIFO
+ *   with the send lock taken once.  The others are sent one by one with
+ *   psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On  error, a negated
+ *   errno value is returned (see sendmsg() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+int local_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  FAR struct local_conn_s *conn = psock->s_conn;
+  FAR struct msghdr *msg;
+  bool locked = false;
+  ssize_t ret = OK;
+  unsigned int i;
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL || msg->msg_control != NULL ||
+          conn->lc_state != LOCAL_STATE_CONNECTED)
+        {
+          if (locked)
+            {
+              nxmutex_unlock(&conn->lc_sendlock);
+              locked = false;
+            }
+
+          ret = psock_sendmsg(psock, msg, flags);
+        }
+      else if (msg->msg_iov == NULL)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          if (!locked)
+            {
+              ret = nxmutex_lock(&conn->lc_sendlock);
+              if (ret < 0)
+                {
+                  /* May fail because the task was canceled. */
+
+                  break;
+                }
+
+              locked = true;
+            }
+
+          /* Check shutdown state */
+
+          if (conn->lc_outfile.f_inode == NULL)
+            {
+              ret = -EPIPE;
+            }
+          else
+            {
+              ret = local_send_packet(&conn->lc_outfile, msg->msg_iov,
+                                      msg->msg_iovlen);
+            }
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+    }
+
+  if (locked)
+    {
+      nxmutex_unlock(&conn->lc_sendlock);
+    }
+
+  /* The error is only reported if no message was sent */
+
+  return i > 0 ? i : ret;
+}
@@ -113,6 +113,10 @@ const struct sock_intf_s g_local_sockif =
   , local_getsockopt /* si_getsockopt */
   , local_setsockopt /* si_setsockopt */
 #endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL             /* si_sendfile */
+#endif
+  , local_sendmmsg   /* si_sendmmsg */
 };
 
 /****************************************************************************
@@ -567,6 +571,18 @@ static int local_getsockopt(FAR struct socket *psock, int level, int option,
               memcpy(value, &conn->lc_peer->lc_cred, sizeof(struct ucred));
               return OK;
             }
+
+          case SO_PASSCRED:
+            {
+              if (*value_len < sizeof(int))
+                {
+                  return -EINVAL;
+                }
+
+              *(FAR int *)value = conn->lc_passcred;
+              *value_len        = sizeof(int);
+              return OK;
+            }
 #endif
 
           case SO_SNDBUF:
@@ -657,6 +673,19 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
     {
       switch (option)
         {
+#ifdef CONFIG_NET_LOCAL_SCM
+          case SO_PASSCRED:
+            {
+              if (value_len < sizeof(int))
+                {
+                  return -EINVAL;
+                }
+
+              conn->lc_passcred = *(FAR const int *)value != 0;
+              return OK;
+            }
+#endif
+
           case SO_SNDBUF:
             {
               int ret = OK;
@@ -1167,6 +1196,12 @@ static int local_shutdown(FAR struct socket *psock, int how)
                   file_close(&conn->lc_outfile);
                   conn->lc_outfile.f_inode = NULL;
                 }
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              net_lock();
+              local_direct_wake(conn);
+              net_unlock();
+#endif
             }
         }
 
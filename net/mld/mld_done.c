@@ -65,7 +65,7 @@ int mld_done(FAR struct net_driver_s *dev,
              FAR const struct mld_mcast_listen_done_s *done)
 {
   mldinfo("Multicast Listener Done\n");
-  MLD_STATINCR(g_netstats.mld.done_received);
+  MLD_STATINCR(NETSTATS.mld.done_received);
 
   /* The Done message is sent to the link-local, all routers multicast
    * address. We basically ignore the Done message:
@@ -153,7 +153,7 @@ static void mld_gendog_work(FAR void *arg)
     {
       /* Schedule (and forget) the general query. */
 
-      MLD_STATINCR(g_netstats.mld.query_sched);
+      MLD_STATINCR(NETSTATS.mld.query_sched);
       SET_MLD_GENPEND(dev->d_mld.flags);
 
       /* Notify the device that we have a packet to send */
@@ -332,7 +332,7 @@ static void mld_polldog_work(FAR void *arg)
   net_lock();
   if (IS_MLD_STARTUP(group->flags))
     {
-      MLD_STATINCR(g_netstats.mld.report_sched);
+      MLD_STATINCR(NETSTATS.mld.report_sched);
 
       /* Get a reference to the device serving the sub-net */
 
@@ -43,8 +43,10 @@
  * Private Data
  ****************************************************************************/
 
-static DECLARE_HASHTABLE(g_nat44_inbound, CONFIG_NET_NAT_HASH_BITS);
-static DECLARE_HASHTABLE(g_nat44_outbound, CONFIG_NET_NAT_HASH_BITS);
+static struct htable_s g_nat44_inbound =
+  HTABLE_INITIALIZER(CONFIG_NET_NAT_HASH_BITS, CONFIG_NET_NAT_HASH_MAX_BITS);
+static struct htable_s g_nat44_outbound =
+  HTABLE_INITIALIZER(CONFIG_NET_NAT_HASH_BITS, CONFIG_NET_NAT_HASH_MAX_BITS);
 
 /****************************************************************************
  * Private Functions
@@ -62,8 +64,8 @@ static inline uint32_t ipv4_nat_inbound_key(in_addr_t external_ip,
                                             uint16_t external_port,
                                             uint8_t protocol)
 {
-  return NTOHL(external_ip) ^ /* external ip may different in higher bits. */
-         ((uint32_t)protocol << 16) ^ external_port;
+  return htable_hash32(NTOHL(external_ip) ^ ((uint32_t)protocol << 16) ^
+                       external_port, 0);
 }
 
 /****************************************************************************
@@ -78,8 +80,8 @@ static inline uint32_t ipv4_nat_outbound_key(in_addr_t local_ip,
                                              uint16_t local_port,
                                              uint8_t protocol)
 {
-  return NTOHL(local_ip) ^ /* NTOHL makes sure difference is in lower bits. */
-         ((uint32_t)protocol << 8) ^ ((uint32_t)local_port << 16);
+  return htable_hash32(NTOHL(local_ip) ^ ((uint32_t)protocol << 8) ^
+                       ((uint32_t)local_port << 16), 0);
 }
 
 /****************************************************************************
@@ -143,16 +145,31 @@ ipv4_nat_entry_create(uint8_t protocol,
 
   ipv4_nat_entry_refresh(entry);
 
-  hashtable_add(g_nat44_inbound, &entry->hash_inbound,
-                ipv4_nat_inbound_key(external_ip, external_port, protocol));
-  hashtable_add(g_nat44_outbound, &entry->hash_outbound,
-                ipv4_nat_outbound_key(local_ip, local_port, protocol));
+  if (htable_insert(&g_nat44_inbound, &entry->hash_inbound,
+                    ipv4_nat_inbound_key(external_ip, external_port,
+                                         protocol)) < 0)
+    {
+      goto errout;
+    }
+
+  if (htable_insert(&g_nat44_outbound, &entry->hash_outbound,
+                    ipv4_nat_outbound_key(local_ip, local_port,
+                                          protocol)) < 0)
+    {
+      htable_remove(&g_nat44_inbound, &entry->hash_inbound);
+      goto errout;
+    }
 
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_NEW, PF_INET, entry);
 #endif
 
   return entry;
+
+errout:
+  nwarn("WARNING: Failed to allocate IPv4 NAT hashtable\n");
+  kmm_free(entry);
+  return NULL;
 }
 
 /****************************************************************************
@@ -173,14 +190,8 @@ static void ipv4_nat_entry_delete(FAR ipv4_nat_entry_t *entry)
         entry->protocol, entry->local_ip, entry->local_port,
         entry->external_port);
 
-  hashtable_delete(g_nat44_inbound, &entry->hash_inbound,
-                   ipv4_nat_inbound_key(entry->external_ip,
-                                        entry->external_port,
-                                        entry->protocol));
-  hashtable_delete(g_nat44_outbound, &entry->hash_outbound,
-                   ipv4_nat_outbound_key(entry->local_ip,
-                                         entry->local_port,
-                                         entry->protocol));
+  htable_remove(&g_nat44_inbound, &entry->hash_inbound);
+  htable_remove(&g_nat44_outbound, &entry->hash_outbound);
 
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_DELETE, PF_INET, entry);
@@ -291,11 +302,11 @@ void ipv4_nat_entry_clear(FAR struct net_driver_s *dev)
 
 void ipv4_nat_entry_foreach(ipv4_nat_entry_cb_t cb, FAR void *arg)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
-  int i;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
+  uint32_t i;
 
-  hashtable_for_every_safe(g_nat44_inbound, p, tmp, i)
+  htable_for_every_safe(&g_nat44_inbound, p, tmp, i)
     {
       FAR ipv4_nat_entry_t *entry =
         container_of(p, ipv4_nat_entry_t, hash_inbound);
@@ -328,8 +339,8 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
                             uint16_t external_port, in_addr_t peer_ip,
                             uint16_t peer_port, bool refresh)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
   bool skip_ip = net_ipv4addr_cmp(external_ip, INADDR_ANY);
 #ifdef CONFIG_NET_NAT44_SYMMETRIC
   bool skip_peer = net_ipv4addr_cmp(peer_ip, INADDR_ANY);
@@ -338,7 +349,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
 
   ipv4_nat_reclaim_entry(current_time);
 
-  hashtable_for_every_possible_safe(g_nat44_inbound, p, tmp,
+  htable_for_every_possible_safe(&g_nat44_inbound, p, tmp,
                   ipv4_nat_inbound_key(external_ip, external_port, protocol))
     {
       FAR ipv4_nat_entry_t *entry =
@@ -407,14 +418,14 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
                              in_addr_t peer_ip, uint16_t peer_port,
                              bool try_create)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
   uint16_t external_port;
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
   ipv4_nat_reclaim_entry(current_time);
 
-  hashtable_for_every_possible_safe(g_nat44_outbound, p, tmp,
+  htable_for_every_possible_safe(&g_nat44_outbound, p, tmp,
                       ipv4_nat_outbound_key(local_ip, local_port, protocol))
     {
       FAR ipv4_nat_entry_t *entry =
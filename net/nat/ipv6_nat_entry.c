@@ -44,8 +44,10 @@
  * Private Data
  ****************************************************************************/
 
-static DECLARE_HASHTABLE(g_nat66_inbound, CONFIG_NET_NAT_HASH_BITS);
-static DECLARE_HASHTABLE(g_nat66_outbound, CONFIG_NET_NAT_HASH_BITS);
+static struct htable_s g_nat66_inbound =
+  HTABLE_INITIALIZER(CONFIG_NET_NAT_HASH_BITS, CONFIG_NET_NAT_HASH_MAX_BITS);
+static struct htable_s g_nat66_outbound =
+  HTABLE_INITIALIZER(CONFIG_NET_NAT_HASH_BITS, CONFIG_NET_NAT_HASH_MAX_BITS);
 
 /****************************************************************************
  * Private Functions
@@ -67,7 +69,7 @@ static inline uint32_t ipv6_nat_hash_key(const net_ipv6addr_t ip,
                  (((uint32_t)ip[4] << 16) | ip[5]) ^
                  (((uint32_t)ip[6] << 16) | ip[7]);
 
-  return key ^ ((uint32_t)protocol << 16) ^ port;
+  return htable_hash32(key ^ ((uint32_t)protocol << 16) ^ port, 0);
 }
 
 /****************************************************************************
@@ -133,16 +135,30 @@ ipv6_nat_entry_create(uint8_t protocol, const net_ipv6addr_t external_ip,
 
   ipv6_nat_entry_refresh(entry);
 
-  hashtable_add(g_nat66_inbound, &entry->hash_inbound,
-                ipv6_nat_hash_key(external_ip, external_port, protocol));
-  hashtable_add(g_nat66_outbound, &entry->hash_outbound,
-                ipv6_nat_hash_key(local_ip, local_port, protocol));
+  if (htable_insert(&g_nat66_inbound, &entry->hash_inbound,
+                    ipv6_nat_hash_key(external_ip, external_port,
+                                      protocol)) < 0)
+    {
+      goto errout;
+    }
+
+  if (htable_insert(&g_nat66_outbound, &entry->hash_outbound,
+                    ipv6_nat_hash_key(local_ip, local_port, protocol)) < 0)
+    {
+      htable_remove(&g_nat66_inbound, &entry->hash_inbound);
+      goto errout;
+    }
 
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_NEW, PF_INET6, entry);
 #endif
 
   return entry;
+
+errout:
+  nwarn("WARNING: Failed to allocate IPv6 NAT hashtable\n");
+  kmm_free(entry);
+  return NULL;
 }
 
 /****************************************************************************
@@ -166,14 +182,8 @@ static void ipv6_nat_entry_delete(FAR ipv6_nat_entry_t *entry)
         entry->local_ip[5], entry->local_ip[6], entry->local_ip[7],
         entry->local_port, entry->external_port);
 
-  hashtable_delete(g_nat66_inbound, &entry->hash_inbound,
-                   ipv6_nat_hash_key(entry->external_ip,
-                                     entry->external_port,
-                                     entry->protocol));
-  hashtable_delete(g_nat66_outbound, &entry->hash_outbound,
-                   ipv6_nat_hash_key(entry->local_ip,
-                                     entry->local_port,
-                                     entry->protocol));
+  htable_remove(&g_nat66_inbound, &entry->hash_inbound);
+  htable_remove(&g_nat66_outbound, &entry->hash_outbound);
 
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_DELETE, PF_INET6, entry);
@@ -284,11 +294,11 @@ void ipv6_nat_entry_clear(FAR struct net_driver_s *dev)
 
 void ipv6_nat_entry_foreach(ipv6_nat_entry_cb_t cb, FAR void *arg)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
-  int i;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
+  uint32_t i;
 
-  hashtable_for_every_safe(g_nat66_inbound, p, tmp, i)
+  htable_for_every_safe(&g_nat66_inbound, p, tmp, i)
     {
       FAR ipv6_nat_entry_t *entry =
         container_of(p, ipv6_nat_entry_t, hash_inbound);
@@ -323,8 +333,8 @@ ipv6_nat_inbound_entry_find(uint8_t protocol,
                             const net_ipv6addr_t peer_ip,
                             uint16_t peer_port, bool refresh)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
   bool skip_ip = net_ipv6addr_cmp(external_ip, g_ipv6_unspecaddr);
 #ifdef CONFIG_NET_NAT66_SYMMETRIC
   bool skip_peer = net_ipv6addr_cmp(peer_ip, g_ipv6_unspecaddr);
@@ -333,7 +343,7 @@ ipv6_nat_inbound_entry_find(uint8_t protocol,
 
   ipv6_nat_reclaim_entry(current_time);
 
-  hashtable_for_every_possible_safe(g_nat66_inbound, p, tmp,
+  htable_for_every_possible_safe(&g_nat66_inbound, p, tmp,
                     ipv6_nat_hash_key(external_ip, external_port, protocol))
     {
       FAR ipv6_nat_entry_t *entry =
@@ -406,15 +416,15 @@ ipv6_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
                              const net_ipv6addr_t peer_ip,
                              uint16_t peer_port, bool try_create)
 {
-  FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
+  FAR htable_node_t *p;
+  FAR htable_node_t *tmp;
   FAR union ip_addr_u *external_ip;
   uint16_t external_port;
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
   ipv6_nat_reclaim_entry(current_time);
 
-  hashtable_for_every_possible_safe(g_nat66_outbound, p, tmp,
+  htable_for_every_possible_safe(&g_nat66_outbound, p, tmp,
                           ipv6_nat_hash_key(local_ip, local_port, protocol))
     {
       FAR ipv6_nat_entry_t *entry =
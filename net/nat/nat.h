@@ -72,8 +72,8 @@
 
 struct ipv4_nat_entry_s
 {
-  hash_node_t hash_inbound;
-  hash_node_t hash_outbound;
+  htable_node_t hash_inbound;
+  htable_node_t hash_outbound;
 
   /*  Local Network                             External Network
    *                |----------------|
@@ -104,8 +104,8 @@ struct ipv4_nat_entry_s
 
 struct ipv6_nat_entry_s
 {
-  hash_node_t    hash_inbound;
-  hash_node_t    hash_outbound;
+  htable_node_t  hash_inbound;
+  htable_node_t  hash_outbound;
 
   net_ipv6addr_t local_ip;      /* IP address of the local host. */
   net_ipv6addr_t external_ip;   /* External IP address. */
@@ -31,6 +31,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,6 +39,41 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The key of an IPv6 address in the Neighbor table hashtable */
+
+#define NEIGHBOR_HASHKEY(a) \
+  ((((uint32_t)(a)[0] << 16) | (a)[1]) ^ (((uint32_t)(a)[2] << 16) | (a)[3]) ^ \
+   (((uint32_t)(a)[4] << 16) | (a)[5]) ^ (((uint32_t)(a)[6] << 16) | (a)[7]))
+
+/* Make a Neighbor table node the most recently used one */
+
+#define neighbor_touch(n) \
+  do \
+    { \
+      dq_rem(&(n)->nn_lru, &g_neighbor_lru); \
+      dq_addlast(&(n)->nn_lru, &g_neighbor_lru); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One node of the Neighbor table.  The nodes in use are hashed by the IPv6
+ * address of their entry.
+ */
+
+struct neighbor_node_s
+{
+  struct neighbor_entry_s nn_entry;    /* The Neighbor table entry */
+  hash_node_t             nn_node;     /* Hashed by the IPv6 address */
+  dq_entry_t              nn_lru;      /* Least recently used first */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -46,7 +82,18 @@
  * this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The nodes in use hashed by the IPv6 address */
+
+extern DECLARE_HASHTABLE(g_neighbor_hash, CONFIG_NET_IPv6_NCONF_HASH_BITS);
+
+/* The nodes that were ever used, the least recently used ones first, and
+ * the first node of the table not used yet.
+ */
+
+extern dq_queue_t g_neighbor_lru;
+extern int g_neighbor_next;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -65,78 +65,86 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_node_s *node = NULL;
+  FAR hash_node_t *hnode;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  bool    found = false;
   bool    new_entry;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Find the matching entry */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  hashtable_for_every_possible(g_neighbor_hash, hnode,
+                               NEIGHBOR_HASHKEY(ipaddr))
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      node = container_of(hnode, struct neighbor_node_s, nn_node);
+      if (node->nn_entry.ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
-          found = true;
           break;
         }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
+      node = NULL;
     }
 
-  /* When overwrite old entry, need to notify RTM_DELNEIGH */
-
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
+  if (node != NULL)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      neighbor_touch(node);
+      neighbor = &node->nn_entry;
+
+      /* Need to notify when the entry changes */
+
+      new_entry = memcmp(&neighbor->ne_addr.u, addr,
+                         neighbor->ne_addr.na_llsize) != 0;
     }
+  else
+    {
+      /* Use the first free entry, or the least recently used one */
 
-  /* Need to notify when entry is not found or changes in table */
+      if (g_neighbor_next < CONFIG_NET_IPv6_NCONF_ENTRIES)
+        {
+          node = &g_neighbors[g_neighbor_next++];
+          dq_addlast(&node->nn_lru, &g_neighbor_lru);
+        }
+      else
+        {
+          node = container_of(dq_peek(&g_neighbor_lru),
+                              struct neighbor_node_s, nn_lru);
+          neighbor_touch(node);
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+          /* When overwrite old entry, need to notify RTM_DELNEIGH */
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+          netlink_neigh_notify(&node->nn_entry, RTM_DELNEIGH, AF_INET6);
+          hashtable_delete(g_neighbor_hash, &node->nn_node,
+                           NEIGHBOR_HASHKEY(node->nn_entry.ne_ipaddr));
+        }
+
+      neighbor = &node->nn_entry;
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+      hashtable_add(g_neighbor_hash, &node->nn_node,
+                    NEIGHBOR_HASHKEY(ipaddr));
+      new_entry = true;
+    }
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -36,7 +36,18 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The nodes in use hashed by the IPv6 address */
+
+DECLARE_HASHTABLE(g_neighbor_hash, CONFIG_NET_IPv6_NCONF_HASH_BITS);
+
+/* The nodes that were ever used, the least recently used ones first, and
+ * the first node of the table not used yet.
+ */
+
+dq_queue_t g_neighbor_lru;
+int g_neighbor_next;
 
 /****************************************************************************
  * Public Functions
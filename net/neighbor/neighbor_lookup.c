@@ -123,6 +123,11 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      /* It is the most recently used now */
+
+      neighbor_touch(container_of(neighbor, struct neighbor_node_s,
+                                  nn_entry));
+
       /* Yes.. return the link layer address if the caller has provided a
        * non-NULL address in 'laddr'.
        */
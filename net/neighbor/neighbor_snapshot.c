@@ -69,10 +69,10 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
   /* Copy all non-empty entries in the Neighbor table. */
 
   for (i = 0, ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
+       nentries > ncopied && i < g_neighbor_next;
        i++)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i].nn_entry;
 
       /* An unused entry table entry will be nullified.  In particularly,
        * the Neighbor IP address will be all zero (i.e., the unspecified
@@ -56,5 +56,7 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systime_ticks();
+      neighbor_touch(container_of(neighbor, struct neighbor_node_s,
+                                  nn_entry));
     }
 }
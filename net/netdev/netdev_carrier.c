@@ -38,6 +38,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "ipfrag/ipfrag.h"
+#include "ipforward/ipforward.h"
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
 #include "arp/arp.h"
@@ -96,5 +97,6 @@ void netdev_carrier_off(FAR struct net_driver_s *dev)
 
       devif_dev_event(dev, NETDEV_DOWN);
       arp_cleanup(dev);
+      ipv4_forward_flush(dev);
     }
 }
@@ -29,6 +29,7 @@
 #include <debug.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "netdev/netdev.h"
 
@@ -44,7 +45,11 @@
  *   when either (1) all devices have been enumerated or (2) when a callback
  *   returns any non-zero value.
  *
- *   NOTE 1:  The network must be locked throughout the enumeration.
+ *   NOTE 1:  The network must be locked throughout the enumeration unless
+ *            CONFIG_RCU is enabled.  In that case the device list is
+ *            traversed inside an RCU read-side critical section and
+ *            callbacks that are invoked without the network lock must not
+ *            block.
  *   NOTE 2:  No checks are made on devices.  For examples, callbacks will
  *            will be made on network devices that are in the 'down' state.
  *            The callback implementations must take into account all
@@ -60,7 +65,7 @@
  *  1: Enumeration terminated early by callback
  *
  * Assumptions:
- *  The network is locked.
+ *  The network is locked (or CONFIG_RCU is enabled).
  *
  ****************************************************************************/
 
@@ -71,7 +76,13 @@ int netdev_foreach(netdev_callback_t callback, FAR void *arg)
 
   if (callback != NULL)
     {
+#ifdef CONFIG_RCU
+      rcu_read_lock();
+      for (dev = rcu_dereference(g_netdevices); dev;
+           dev = rcu_dereference(dev->flink))
+#else
       for (dev = g_netdevices; dev; dev = dev->flink)
+#endif
         {
           if (callback(dev, arg) != 0)
             {
@@ -79,6 +90,10 @@ int netdev_foreach(netdev_callback_t callback, FAR void *arg)
               break;
             }
         }
+
+#ifdef CONFIG_RCU
+      rcu_read_unlock();
+#endif
     }
 
   return ret;
@@ -108,15 +108,23 @@ void netdev_iob_prepare_dynamic(FAR struct net_driver_s *dev, uint16_t size)
       return;
     }
 
-  /* alloc new iob for jumbo frame */
+  /* Alloc new iob of the size class that fits the frame */
 
-  iob = iob_alloc_dynamic(size);
+  iob = iob_tryalloc_size(false, size);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to allocate an I/O buffer.");
       return;
     }
 
+  /* Keep the current buffer if no larger one was available */
+
+  if (dev->d_iob && IOB_BUFSIZE(iob) <= IOB_BUFSIZE(dev->d_iob))
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
   iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE);
 
   netdev_iob_replace(dev, iob);
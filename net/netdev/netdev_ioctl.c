@@ -85,6 +85,7 @@
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
+#include "ipforward/ipforward.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -884,6 +885,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFDSTADDR:  /* Set P-to-P address */
         ioctl_set_ipv4addr(&dev->d_draddr, &req->ifr_dstaddr);
+        ipv4_forward_flush(NULL);
         break;
 
       case SIOCGIFBRDADDR:  /* Get broadcast IP address */
@@ -901,6 +903,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipv4_forward_flush(NULL);
         break;
 #endif
 
@@ -1093,6 +1096,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               }
 
             ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+            ipv4_forward_flush(NULL);
             netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
 
@@ -1124,6 +1128,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipv4_forward_flush(NULL);
           }
 #endif
 
@@ -2014,6 +2019,10 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
 
               devif_dev_event(dev, NETDEV_DOWN);
 
+              /* Stop forwarding through the device */
+
+              ipv4_forward_flush(dev);
+
 #ifdef CONFIG_NETDOWN_NOTIFIER
               /* Provide signal notifications to threads that want to be
                * notified of the network down state via signal.
@@ -40,6 +40,7 @@
 #include <nuttx/net/ethernet.h>
 #include <nuttx/net/bluetooth.h>
 #include <nuttx/net/can.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
@@ -391,6 +392,7 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_conncb_tail = NULL;
       dev->d_devcb = NULL;
+      netdev_lock_init(dev);
 
       /* We need exclusive access for the following operations */
 
@@ -462,9 +464,12 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
-
       dev->flink = NULL;
+#ifdef CONFIG_RCU
+      rcu_assign_pointer(*last, dev);
+#else
+      *last = dev;
+#endif
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
@@ -58,6 +58,12 @@ void netdev_statistics_log(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
   FAR struct netdev_statistics_s *stats = &dev->d_statistics;
+#if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP) || \
+    defined(CONFIG_NET_ICMP) || defined(CONFIG_NET_ICMPv6)
+  struct net_stats_s netstats;
+
+  net_stats_sum(&netstats);
+#endif
 
   stats_log("%s:T%" PRIu32 "/%" PRIu32 "(%" PRIu64 "B)" ",R"
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -84,18 +90,18 @@ void netdev_statistics_log(FAR void *arg)
 #endif
             , stats->rx_packets, stats->rx_bytes
 #ifdef CONFIG_NET_TCP
-            , g_netstats.tcp.sent, g_netstats.tcp.recv, g_netstats.tcp.drop
+            , netstats.tcp.sent, netstats.tcp.recv, netstats.tcp.drop
 #endif
 #ifdef CONFIG_NET_UDP
-            , g_netstats.udp.sent, g_netstats.udp.recv, g_netstats.udp.drop
+            , netstats.udp.sent, netstats.udp.recv, netstats.udp.drop
 #endif
 #ifdef CONFIG_NET_ICMP
-            , g_netstats.icmp.sent, g_netstats.icmp.recv,
-              g_netstats.icmp.drop
+            , netstats.icmp.sent, netstats.icmp.recv,
+              netstats.icmp.drop
 #endif
 #ifdef CONFIG_NET_ICMPv6
-            , g_netstats.icmpv6.sent, g_netstats.icmpv6.recv,
-              g_netstats.icmpv6.drop
+            , netstats.icmpv6.sent, netstats.icmpv6.recv,
+              netstats.icmpv6.drop
 #endif
             );
 }
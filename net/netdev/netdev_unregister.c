@@ -36,9 +36,11 @@
 #include <net/if.h>
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -144,14 +146,31 @@ int netdev_unregister(FAR struct net_driver_s *dev)
               g_netdevices = curr->flink;
             }
 
+          /* With RCU, lockless readers may still be walking through the
+           * entry, so its link is only cleared after the grace period.
+           */
+
+#ifndef CONFIG_RCU
           curr->flink = NULL;
+#endif
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
+
+      /* No cached forwarding flow may refer to the device any more */
+
+      ipv4_forward_flush(dev);
       net_unlock();
 
+#ifdef CONFIG_RCU
+      /* Wait for the lockless readers before the caller frees the device */
+
+      synchronize_rcu();
+      dev->flink = NULL;
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
       work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
 #endif
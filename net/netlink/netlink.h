@@ -447,6 +447,25 @@ int netlink_add_terminator(NETLINK_HANDLE handle,
 FAR struct netlink_response_s *
 netlink_tryget_response(FAR struct netlink_conn_s *conn);
 
+/****************************************************************************
+ * Name: netlink_tryget_response_fit
+ *
+ * Description:
+ *   Return the next response from the head of the pending response list
+ *   only if its message is no longer than 'maxlen' bytes.
+ *
+ *   Note:  The network will be momentarily locked to support exclusive
+ *   access to the pending response list.
+ *
+ * Returned Value:
+ *   The next response; NULL if the list is empty or the next response does
+ *   not fit.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *
+netlink_tryget_response_fit(FAR struct netlink_conn_s *conn, size_t maxlen);
+
 /****************************************************************************
  * Name: netlink_get_response
  *
@@ -429,6 +429,42 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn)
   return resp;
 }
 
+/****************************************************************************
+ * Name: netlink_tryget_response_fit
+ *
+ * Description:
+ *   Return the next response from the head of the pending response list
+ *   only if its message is no longer than 'maxlen' bytes.
+ *
+ * Returned Value:
+ *   The next response; NULL if the list is empty or the next response does
+ *   not fit.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *
+netlink_tryget_response_fit(FAR struct netlink_conn_s *conn, size_t maxlen)
+{
+  FAR struct netlink_response_s *resp;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+  resp = (FAR struct netlink_response_s *)sq_peek(&conn->resplist);
+  if (resp != NULL && resp->msg.nlmsg_len <= maxlen)
+    {
+      sq_remfirst(&conn->resplist);
+    }
+  else
+    {
+      resp = NULL;
+    }
+
+  net_unlock();
+
+  return resp;
+}
+
 /****************************************************************************
  * Name: netlink_get_response
  *
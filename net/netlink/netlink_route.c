@@ -744,6 +744,8 @@ static int netlink_get_neighborlist(NETLINK_HANDLE handle, int domain,
       return -ENOENT;
     }
 
+  resp->msg.nlmsg_flags |= NLM_F_MULTI;
+
   netlink_add_response(handle, resp);
 
   return netlink_add_terminator(handle, &req->hdr, 0);
@@ -827,6 +829,10 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
       return -ENOENT;
     }
 
+  /* Each route is one part of the dump terminated by NLMSG_DONE */
+
+  resp->msg.nlmsg_flags |= NLM_F_MULTI;
+
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
@@ -946,6 +952,10 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
       return -ENOENT;
     }
 
+  /* Each route is one part of the dump terminated by NLMSG_DONE */
+
+  resp->msg.nlmsg_flags |= NLM_F_MULTI;
+
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
@@ -71,6 +71,11 @@ static ssize_t netlink_sendmsg(FAR struct socket *psock,
 static ssize_t netlink_recvmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
 static int netlink_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_SOCKOPTS
+static int netlink_setsockopt(FAR struct socket *psock, int level,
+                              int option, FAR const void *value,
+                              socklen_t value_len);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -90,7 +95,14 @@ const struct sock_intf_s g_netlink_sockif =
   netlink_poll,         /* si_poll */
   netlink_sendmsg,      /* si_sendmsg */
   netlink_recvmsg,      /* si_recvmsg */
-  netlink_close         /* si_close */
+  netlink_close,        /* si_close */
+  NULL,                 /* si_ioctl */
+  NULL,                 /* si_socketpair */
+  NULL                  /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+  , NULL                /* si_getsockopt */
+  , netlink_setsockopt  /* si_setsockopt */
+#endif
 };
 
 /****************************************************************************
@@ -721,6 +733,46 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   /* Copy the payload to the user buffer */
 
   memcpy(buf, &entry->msg, len);
+
+  /* Fill the rest of the buffer with the following messages up to the end
+   * of a dump, so that a dump takes a few large reads instead of one read
+   * per entry.
+   */
+
+  if (len == entry->msg.nlmsg_len && entry->msg.nlmsg_type != NLMSG_DONE)
+    {
+      size_t buflen = msg->msg_iov->iov_len;
+      size_t offset;
+
+      for (; ; )
+        {
+          kmm_free(entry);
+
+          offset = NLMSG_ALIGN(len);
+          if (offset >= buflen)
+            {
+              entry = NULL;
+              break;
+            }
+
+          entry = netlink_tryget_response_fit(psock->s_conn,
+                                              buflen - offset);
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          memcpy((FAR uint8_t *)buf + offset, &entry->msg,
+                 entry->msg.nlmsg_len);
+          len = offset + entry->msg.nlmsg_len;
+
+          if (entry->msg.nlmsg_type == NLMSG_DONE)
+            {
+              break;
+            }
+        }
+    }
+
   kmm_free(entry);
 
   if (from != NULL)
@@ -731,6 +783,67 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   return len;
 }
 
+/****************************************************************************
+ * Name: netlink_setsockopt
+ *
+ * Description:
+ *   netlink_setsockopt() sets the SOL_NETLINK level options.  Joining or
+ *   leaving a multicast group this way is the same as changing the
+ *   nl_groups given to bind(), one group at a time.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to configure
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static int netlink_setsockopt(FAR struct socket *psock, int level,
+                              int option, FAR const void *value,
+                              socklen_t value_len)
+{
+  FAR struct netlink_conn_s *conn = psock->s_conn;
+  int group;
+
+  if (level != SOL_NETLINK)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  group = *(FAR const int *)value;
+  if (group <= 0 || group > 32)
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+      case NETLINK_ADD_MEMBERSHIP:
+        conn->groups |= 1 << (group - 1);
+        return OK;
+
+      case NETLINK_DROP_MEMBERSHIP:
+        conn->groups &= ~(1 << (group - 1));
+        return OK;
+
+      default:
+        nerr("ERROR: Unrecognized netlink option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netlink_close
  *
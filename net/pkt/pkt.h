@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <poll.h>
 
 #include <nuttx/net/net.h>
 
@@ -54,6 +55,23 @@
 
 struct devif_callback_s; /* Forward reference */
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* A ring of frame slots shared with the user (PACKET_RX_RING and
+ * PACKET_TX_RING).  The frames are laid out as with TPACKET_V1.
+ */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;        /* The first block of the ring */
+  size_t       size;        /* The size of the ring */
+  uint32_t     block_size;  /* The size of a block of frames */
+  uint32_t     frame_size;  /* The size of a frame slot */
+  uint32_t     frame_nr;    /* The number of frames, zero if no ring */
+  uint32_t     frame_pb;    /* The number of frames per block */
+  uint32_t     head;        /* The next frame to be used by the kernel */
+};
+#endif
+
 struct pkt_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -69,11 +87,27 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* The threads polling the socket */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The memory mapped rings.  The transmit ring follows the receive ring
+   * in the one allocation that is mapped.
+   */
+
+  struct pkt_ring_s rx_ring;
+  struct pkt_ring_s tx_ring;
+  FAR uint8_t      *ring_mem;     /* The memory of the rings */
+  bool              ring_mapped;  /* The rings may be used by the user */
+  bool              rx_losing;    /* Frames were dropped for a full ring */
+  uint32_t          rx_packets;   /* PACKET_STATISTICS counts */
+  uint32_t          rx_drops;
+#endif
 };
 
 /****************************************************************************
@@ -292,6 +326,144 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on packet socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup);
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the threads polling a packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset);
+
+#ifdef CONFIG_NET_PKT_MMAP
+
+/****************************************************************************
+ * Name: pkt_ring_setsockopt
+ *
+ * Description:
+ *   Set up (or remove, if tp_block_nr is zero) the receive or transmit
+ *   ring of a packet socket.  The rings cannot be changed once they have
+ *   been mapped.
+ *
+ * Input Parameters:
+ *   conn      - The packet socket connection
+ *   option    - PACKET_RX_RING or PACKET_TX_RING
+ *   value     - A struct tpacket_req
+ *   value_len - The length of value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_statistics
+ *
+ * Description:
+ *   Return and reset the PACKET_STATISTICS counts of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_statistics(FAR struct pkt_conn_s *conn, FAR void *value,
+                        FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet socket that is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy a received frame into the next slot of the receive ring.  The
+ *   frame is dropped if the user still owns the slot.
+ *
+ * Assumptions:
+ *   The network is locked and the socket has a receive ring.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames that the user has put into the transmit ring, in ring
+ *   order until the first slot not marked TP_STATUS_SEND_REQUEST.
+ *
+ * Returned Value:
+ *   The number of bytes sent; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The socket has a transmit ring.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct net_driver_s *dev,
+                      FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_pollstate
+ *
+ * Description:
+ *   Return POLLIN if the receive ring holds a frame for the user and
+ *   POLLOUT if the transmit ring has a free slot.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollstate(FAR struct pkt_conn_s *conn);
+
+#endif /* CONFIG_NET_PKT_MMAP */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -139,6 +139,16 @@ static int pkt_in(FAR struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* A socket with a receive ring gets the frames only there */
+
+      if (conn->rx_ring.frame_nr > 0)
+        {
+          pkt_ring_input(dev, conn);
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -165,6 +175,10 @@ static int pkt_in(FAR struct net_driver_s *dev)
               nwarn("WARNING: Packet not processed\n");
               ret = -EAGAIN;
             }
+          else
+            {
+              pkt_pollnotify(conn, POLLIN);
+            }
         }
     }
   else
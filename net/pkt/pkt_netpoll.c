@@ -0,0 +1,136 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the threads polling a packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset)
+{
+  poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, eventset);
+}
+
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on packet socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+
+  net_lock();
+
+  if (!setup)
+    {
+      slot = fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->fds[i] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_NET_PKT_NPOLLWAITERS)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  conn->fds[i] = fds;
+  fds->priv    = &conn->fds[i];
+
+  /* Frames may always be written without a transmit ring */
+
+  eventset = IOB_QEMPTY(&conn->readahead) ? 0 : POLLIN;
+
+#ifdef CONFIG_NET_PKT_MMAP
+  eventset |= pkt_ring_pollstate(conn);
+  if (conn->tx_ring.frame_nr == 0)
+#endif
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(&fds, 1, eventset);
+
+out:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_PKT */
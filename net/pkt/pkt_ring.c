@@ -0,0 +1,588 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_MMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The offset of the sockaddr_ll and of the data in a frame */
+
+#define PKT_RING_LLOFF  TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+#define PKT_RING_RXOFF  TPACKET_ALIGN(TPACKET_HDRLEN)
+#define PKT_RING_TXOFF  PKT_RING_LLOFF
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a send of the transmit ring */
+
+struct pkt_ring_send_s
+{
+  FAR struct pkt_conn_s       *conn;
+  FAR struct devif_callback_s *cb;
+  sem_t                        sem;
+  ssize_t                      sent;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of a frame slot of a ring.
+ *
+ ****************************************************************************/
+
+static FAR volatile struct tpacket_hdr *
+pkt_ring_frame(FAR const struct pkt_ring_s *ring, uint32_t index)
+{
+  return (FAR volatile struct tpacket_hdr *)
+         (ring->base + (index / ring->frame_pb) * ring->block_size +
+          (index % ring->frame_pb) * ring->frame_size);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_next
+ *
+ * Description:
+ *   Advance the kernel position of a ring, return the previous one.
+ *
+ ****************************************************************************/
+
+static uint32_t pkt_ring_next(FAR struct pkt_ring_s *ring)
+{
+  uint32_t head = ring->head;
+
+  ring->head = head + 1 < ring->frame_nr ? head + 1 : 0;
+  return head;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_prev
+ *
+ * Description:
+ *   Return the frame slot before the kernel position of a ring.
+ *
+ ****************************************************************************/
+
+static uint32_t pkt_ring_prev(FAR const struct pkt_ring_s *ring)
+{
+  return ring->head > 0 ? ring->head - 1 : ring->frame_nr - 1;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_check
+ *
+ * Description:
+ *   Check the layout requested for a ring.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_check(FAR const struct tpacket_req *req, int option)
+{
+  uint32_t minsize;
+
+  if (req->tp_block_nr == 0)
+    {
+      return req->tp_frame_nr == 0 ? OK : -EINVAL;
+    }
+
+  minsize = option == PACKET_RX_RING ? PKT_RING_RXOFF + 1 : TPACKET_HDRLEN;
+  if (req->tp_block_size == 0 || req->tp_frame_size < minsize ||
+      req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size > req->tp_block_size ||
+      req->tp_block_nr > UINT32_MAX / req->tp_block_size ||
+      req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                          req->tp_block_nr)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_txevent
+ *
+ * Description:
+ *   Send the next requested frame of the transmit ring when the device is
+ *   polled, and finish the send when there is none.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_txevent(FAR struct net_driver_s *dev,
+                                 FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_ring_send_s *pstate = pvpriv;
+  FAR volatile struct tpacket_hdr *hdr;
+  FAR struct pkt_ring_s *ring;
+  int ret;
+
+  if (pstate == NULL)
+    {
+      return flags;
+    }
+
+  /* Wait for the next polling cycle if the buffer is busy */
+
+  if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  ring = &pstate->conn->tx_ring;
+  for (; ; )
+    {
+      hdr = pkt_ring_frame(ring, ring->head);
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      UP_DMB();
+
+      /* A frame that does not fit its slot or the device is given back
+       * to the user marked as such.
+       */
+
+      ret = -EMSGSIZE;
+      if (hdr->tp_len <= ring->frame_size - PKT_RING_TXOFF)
+        {
+          ret = devif_send(dev, (FAR uint8_t *)hdr + PKT_RING_TXOFF,
+                           hdr->tp_len, -NET_LL_HDRLEN(dev));
+        }
+
+      pkt_ring_next(ring);
+      if (ret <= 0)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          continue;
+        }
+
+      dev->d_len    = dev->d_sndlen;
+      pstate->sent += hdr->tp_len;
+      IFF_SET_NOARP(dev->d_flags);
+
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+
+      /* The device holds one frame, ask for another poll for the next */
+
+      netdev_txnotify_dev(dev);
+      return flags;
+    }
+
+  /* No more frames were requested, wake up the sender */
+
+  pstate->cb->flags = 0;
+  pstate->cb->priv  = NULL;
+  pstate->cb->event = NULL;
+
+  nxsem_post(&pstate->sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setsockopt
+ *
+ * Description:
+ *   Set up (or remove, if tp_block_nr is zero) the receive or transmit
+ *   ring of a packet socket.  The rings cannot be changed once they have
+ *   been mapped.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR const void *value, socklen_t value_len)
+{
+  FAR const struct tpacket_req *req = value;
+  FAR struct pkt_ring_s *ring;
+  struct pkt_ring_s newring;
+  FAR uint8_t *mem = NULL;
+  size_t rxsize;
+  size_t txsize;
+  int ret;
+
+  if (value == NULL || value_len < sizeof(struct tpacket_req))
+    {
+      return -EINVAL;
+    }
+
+  ret = pkt_ring_check(req, option);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&newring, 0, sizeof(newring));
+  if (req->tp_block_nr > 0)
+    {
+      newring.size       = (size_t)req->tp_block_size * req->tp_block_nr;
+      newring.block_size = req->tp_block_size;
+      newring.frame_size = req->tp_frame_size;
+      newring.frame_nr   = req->tp_frame_nr;
+      newring.frame_pb   = req->tp_block_size / req->tp_frame_size;
+    }
+
+  net_lock();
+
+  if (conn->ring_mapped)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  /* Both rings live in one allocation, so it is replaced and the other
+   * ring starts over empty as well.
+   */
+
+  ring   = option == PACKET_RX_RING ? &conn->rx_ring : &conn->tx_ring;
+  rxsize = option == PACKET_RX_RING ? newring.size : conn->rx_ring.size;
+  txsize = option == PACKET_TX_RING ? newring.size : conn->tx_ring.size;
+
+  if (rxsize + txsize > 0)
+    {
+      mem = kumm_zalloc(rxsize + txsize);
+      if (mem == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+    }
+
+  if (conn->ring_mem != NULL)
+    {
+      kumm_free(conn->ring_mem);
+    }
+
+  *ring                = newring;
+  conn->ring_mem       = mem;
+  conn->rx_ring.base   = mem;
+  conn->rx_ring.head   = 0;
+  conn->tx_ring.base   = mem + rxsize;
+  conn->tx_ring.head   = 0;
+
+out:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_statistics
+ *
+ * Description:
+ *   Return and reset the PACKET_STATISTICS counts of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_statistics(FAR struct pkt_conn_s *conn, FAR void *value,
+                        FAR socklen_t *value_len)
+{
+  struct tpacket_stats stats;
+
+  if (value == NULL || *value_len < sizeof(struct tpacket_stats))
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  stats.tp_packets = conn->rx_packets;
+  stats.tp_drops   = conn->rx_drops;
+  conn->rx_packets = 0;
+  conn->rx_drops   = 0;
+  net_unlock();
+
+  memcpy(value, &stats, sizeof(stats));
+  *value_len = sizeof(stats);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map)
+{
+  size_t size;
+  int ret = -EINVAL;
+
+  net_lock();
+
+  size = conn->rx_ring.size + conn->tx_ring.size;
+  if (conn->ring_mem != NULL && map->offset >= 0 && map->length > 0 &&
+      map->offset < size && map->length <= size - map->offset)
+    {
+      map->vaddr        = conn->ring_mem + map->offset;
+      conn->ring_mapped = true;
+      ret               = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet socket that is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  net_lock();
+
+  if (conn->ring_mem != NULL)
+    {
+      kumm_free(conn->ring_mem);
+    }
+
+  memset(&conn->rx_ring, 0, sizeof(conn->rx_ring));
+  memset(&conn->tx_ring, 0, sizeof(conn->tx_ring));
+  conn->ring_mem    = NULL;
+  conn->ring_mapped = false;
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy a received frame into the next slot of the receive ring.  The
+ *   frame is dropped if the user still owns the slot.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rx_ring;
+  FAR volatile struct tpacket_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  FAR uint8_t *frame;
+  unsigned long status;
+  struct timespec ts;
+  uint32_t snaplen;
+  bool wakeup;
+
+  conn->rx_packets++;
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      conn->rx_drops++;
+      conn->rx_losing = true;
+      return;
+    }
+
+  frame   = (FAR uint8_t *)hdr;
+  snaplen = MIN(dev->d_len, ring->frame_size - PKT_RING_RXOFF);
+  snaplen = iob_copyout(frame + PKT_RING_RXOFF, dev->d_iob, snaplen,
+                        -NET_LL_HDRLEN(dev));
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = PKT_RING_RXOFF;
+  hdr->tp_net     = PKT_RING_RXOFF + NET_LL_HDRLEN(dev);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  sll = (FAR struct sockaddr_ll *)(frame + PKT_RING_LLOFF);
+  memset(sll, 0, sizeof(*sll));
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = dev->d_ifindex;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET && snaplen >= ETH_HDRLEN)
+    {
+      FAR struct eth_hdr_s *eth =
+        (FAR struct eth_hdr_s *)(frame + PKT_RING_RXOFF);
+
+      sll->sll_protocol = eth->type;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+    }
+#endif
+
+  status = TP_STATUS_USER;
+  if (conn->rx_losing)
+    {
+      status |= TP_STATUS_LOSING;
+      conn->rx_losing = false;
+    }
+
+  /* The user may be waiting only if it has taken all frames before this
+   * one, so the threads polling the socket are woken up once per burst.
+   */
+
+  wakeup = ring->frame_nr == 1 ||
+           pkt_ring_frame(ring, pkt_ring_prev(ring))->tp_status ==
+           TP_STATUS_KERNEL;
+
+  /* Hand the frame over only when all of it is written */
+
+  UP_DMB();
+  hdr->tp_status = status;
+  pkt_ring_next(ring);
+
+  if (wakeup)
+    {
+      pkt_pollnotify(conn, POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames that the user has put into the transmit ring, in ring
+ *   order until the first slot not marked TP_STATUS_SEND_REQUEST.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct net_driver_s *dev,
+                      FAR struct pkt_conn_s *conn)
+{
+  struct pkt_ring_send_s state;
+  int ret;
+
+  memset(&state, 0, sizeof(state));
+  nxsem_init(&state.sem, 0, 0); /* Doesn't really fail */
+  state.conn = conn;
+
+  net_lock();
+
+  state.cb = pkt_callback_alloc(dev, conn);
+  if (state.cb == NULL)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  state.cb->flags = PKT_POLL;
+  state.cb->priv  = &state;
+  state.cb->event = pkt_ring_txevent;
+
+  netdev_txnotify_dev(dev);
+
+  ret = net_sem_wait(&state.sem);
+  pkt_callback_free(dev, conn, state.cb);
+
+  /* The user may be waiting for free slots */
+
+  if (state.sent > 0)
+    {
+      pkt_pollnotify(conn, POLLOUT);
+    }
+
+out:
+  net_unlock();
+  nxsem_destroy(&state.sem);
+
+  return state.sent > 0 || ret >= 0 ? state.sent : ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollstate
+ *
+ * Description:
+ *   Return POLLIN if the receive ring holds a frame for the user and
+ *   POLLOUT if the transmit ring has a free slot.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollstate(FAR struct pkt_conn_s *conn)
+{
+  FAR volatile struct tpacket_hdr *hdr;
+  pollevent_t eventset = 0;
+
+  if (conn->rx_ring.frame_nr > 0)
+    {
+      hdr = pkt_ring_frame(&conn->rx_ring, pkt_ring_prev(&conn->rx_ring));
+      if (hdr->tp_status != TP_STATUS_KERNEL)
+        {
+          eventset |= POLLIN;
+        }
+    }
+
+  if (conn->tx_ring.frame_nr > 0)
+    {
+      hdr = pkt_ring_frame(&conn->tx_ring, conn->tx_ring.head);
+      if (hdr->tp_status == TP_STATUS_AVAILABLE)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+
+  return eventset;
+}
+
+#endif /* CONFIG_NET_PKT_MMAP */
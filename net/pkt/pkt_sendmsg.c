@@ -214,6 +214,20 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENODEV;
     }
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A zero length send flushes the transmit ring */
+
+  if (len == 0)
+    {
+      FAR struct pkt_conn_s *conn = psock->s_conn;
+
+      if (conn->tx_ring.frame_nr > 0)
+        {
+          return pkt_ring_send(dev, conn);
+        }
+    }
+#endif
+
   /* Perform the send operation */
 
   /* Initialize the state structure. This is done with the network locked
@@ -55,6 +55,20 @@ static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
 static int        pkt_close(FAR struct socket *psock);
+static int        pkt_sendmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+static int        pkt_recvmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
+#ifdef CONFIG_NET_PKT_MMAP
+static int        pkt_getsockopt(FAR struct socket *psock, int level,
+                    int option, FAR void *value, FAR socklen_t *value_len);
+static int        pkt_setsockopt(FAR struct socket *psock, int level,
+                    int option, FAR const void *value, socklen_t value_len);
+static int        pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -71,10 +85,30 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_netpoll,     /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_getsockopt /* si_getsockopt */
+  , pkt_setsockopt /* si_setsockopt */
+#else
+  , NULL           /* si_getsockopt */
+  , NULL           /* si_setsockopt */
+#endif
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+  , pkt_sendmmsg   /* si_sendmmsg */
+  , pkt_recvmmsg   /* si_recvmmsg */
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_mmap       /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -301,6 +335,12 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_MMAP
+              /* And the memory mapped rings */
+
+              pkt_ring_free(conn);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
@@ -321,6 +361,145 @@ static int pkt_close(FAR struct socket *psock)
     }
 }
 
+/****************************************************************************
+ * Name: pkt_sendmmsg
+ *
+ * Description:
+ *   Send a vector of raw packets with the network locked once.  The lock
+ *   is only given up while waiting for a packet to be sent.
+ *
+ ****************************************************************************/
+
+static int pkt_sendmmsg(FAR struct socket *psock,
+                        FAR struct mmsghdr *msgvec, unsigned int vlen,
+                        int flags)
+{
+  int ret;
+
+  net_lock();
+  ret = sock_sendmmsg(psock, msgvec, vlen, flags);
+  net_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_recvmmsg
+ *
+ * Description:
+ *   Receive a vector of raw packets with the network locked once.  The
+ *   lock is only given up while waiting for a packet.
+ *
+ ****************************************************************************/
+
+static int pkt_recvmmsg(FAR struct socket *psock,
+                        FAR struct mmsghdr *msgvec, unsigned int vlen,
+                        int flags, FAR const struct timespec *timeout)
+{
+  int ret;
+
+  net_lock();
+  ret = sock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  net_unlock();
+
+  return ret;
+}
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   pkt_getsockopt() retrieves the value of the SOL_PACKET level options of
+ *   a raw packet socket.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   level     Protocol level to set the option
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pkt_getsockopt(FAR struct socket *psock, int level,
+                          int option, FAR void *value,
+                          FAR socklen_t *value_len)
+{
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_STATISTICS:
+        return pkt_ring_statistics(psock->s_conn, value, value_len);
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET level options of a raw packet
+ *   socket.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to configure
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pkt_setsockopt(FAR struct socket *psock, int level,
+                          int option, FAR const void *value,
+                          socklen_t value_len)
+{
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        return pkt_ring_setsockopt(psock->s_conn, option, value, value_len);
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the receive and transmit rings of a raw packet socket.
+ *
+ ****************************************************************************/
+
+static int pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  return pkt_ring_mmap(psock->s_conn, map);
+}
+#endif /* CONFIG_NET_PKT_MMAP */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
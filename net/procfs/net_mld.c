@@ -110,12 +110,15 @@ static const linegen_t g_mld_linegen[] =
 
 static int netprocfs_joinleave(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len  = snprintf(netfile->line, NET_LINELEN, "Joins: %04x ",
-                  g_netstats.mld.njoins);
+                  stats.mld.njoins);
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Leaves: %04x\n",
-                  g_netstats.mld.nleaves);
+                  stats.mld.nleaves);
   return len;
 }
 
@@ -125,12 +128,15 @@ static int netprocfs_joinleave(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_queries_sent(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len = snprintf(netfile->line, NET_LINELEN, "Sent       Sched Sent\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "  Queries: %04x  %04x\n",
-                  g_netstats.mld.query_sched, g_netstats.mld.query_sent);
+                  stats.mld.query_sched, stats.mld.query_sent);
   return len;
 }
 
@@ -140,15 +146,18 @@ static int netprocfs_queries_sent(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_reports_sent(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len  = snprintf(netfile->line, NET_LINELEN, "  Reports:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 1: ----  %04x\n",
-                  g_netstats.mld.v1report_sent);
+                  stats.mld.v1report_sent);
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 2: %04x  %04x\n",
-                  g_netstats.mld.report_sched, g_netstats.mld.v2report_sent);
+                  stats.mld.report_sched, stats.mld.v2report_sent);
   return len;
 }
 
@@ -158,8 +167,11 @@ static int netprocfs_reports_sent(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_done_sent(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN, "  Done:    %04x  %04x\n",
-                  g_netstats.mld.done_sched, g_netstats.mld.done_sent);
+                  stats.mld.done_sched, stats.mld.done_sent);
 }
 
 /****************************************************************************
@@ -168,33 +180,39 @@ static int netprocfs_done_sent(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_queries_received_1(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len  = snprintf(netfile->line, NET_LINELEN, "Received:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "  Queries:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Gen:   %04x\n",
-                  g_netstats.mld.gm_query_received);
+                  stats.mld.gm_query_received);
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    MAS:   %04x\n",
-                  g_netstats.mld.mas_query_received);
+                  stats.mld.mas_query_received);
   return len;
 }
 
 static int netprocfs_queries_received_2(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len  = snprintf(netfile->line, NET_LINELEN,
                   "    MASS:  %04x\n",
-                  g_netstats.mld.mass_query_received);
+                  stats.mld.mass_query_received);
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ucast: %04x\n",
-                  g_netstats.mld.ucast_query_received);
+                  stats.mld.ucast_query_received);
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Bad:   %04x\n",
-                  g_netstats.mld.bad_query_received);
+                  stats.mld.bad_query_received);
   return len;
 }
 
@@ -204,15 +222,18 @@ static int netprocfs_queries_received_2(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_reports_received(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len;
 
+  net_stats_sum(&stats);
+
   len  = snprintf(netfile->line, NET_LINELEN, "  Reports:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 1: %04x\n",
-                  g_netstats.mld.v1report_received);
+                  stats.mld.v1report_received);
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 2: %04x\n",
-                  g_netstats.mld.v2report_received);
+                  stats.mld.v2report_received);
   return len;
 }
 
@@ -222,8 +243,11 @@ static int netprocfs_reports_received(FAR struct netprocfs_file_s *netfile)
 
 static int netprocfs_done_received(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN , "  Done:    %04x\n",
-                  g_netstats.mld.done_received);
+                  stats.mld.done_received);
 }
 
 /****************************************************************************
@@ -154,37 +154,40 @@ static int netprocfs_header(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NET_STATISTICS
 static int netprocfs_received(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Received   ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.recv);
+                  stats.ipv4.recv);
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.recv);
+                  stats.ipv6.recv);
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.recv);
+                  stats.tcp.recv);
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.recv);
+                  stats.udp.recv);
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.recv);
+                  stats.icmp.recv);
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.recv);
+                  stats.icmpv6.recv);
 #endif
 
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.recv);
+                  stats.can.recv);
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -199,36 +202,39 @@ static int netprocfs_received(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NET_STATISTICS
 static int netprocfs_dropped(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Dropped    ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.drop);
+                  stats.ipv4.drop);
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.drop);
+                  stats.ipv6.drop);
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.drop);
+                  stats.tcp.drop);
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.drop);
+                  stats.udp.drop);
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.drop);
+                  stats.icmp.drop);
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.drop);
+                  stats.icmpv6.drop);
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.drop);
+                  stats.can.drop);
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -243,9 +249,12 @@ static int netprocfs_dropped(FAR struct netprocfs_file_s *netfile)
 #if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPv4)
 static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN,
                   "  IPv4        VHL: %04x   Frg: %04x\n",
-                  g_netstats.ipv4.vhlerr, g_netstats.ipv4.fragerr);
+                  stats.ipv4.vhlerr, stats.ipv4.fragerr);
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv4 */
 
@@ -256,9 +265,12 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile)
 #if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPv6)
 static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN,
                   "  IPv6        VHL: %04x\n",
-                  g_netstats.ipv6.vhlerr);
+                  stats.ipv6.vhlerr);
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
@@ -269,23 +281,26 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NET_STATISTICS
 static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Checksum ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.chkerr);
+                  stats.ipv4.chkerr);
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.chkerr);
+                  stats.tcp.chkerr);
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.chkerr);
+                  stats.udp.chkerr);
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -309,9 +324,12 @@ static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile)
 #if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP)
 static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN,
                   "  TCP         ACK: %04x   SYN: %04x\n",
-                  g_netstats.tcp.ackerr, g_netstats.tcp.syndrop);
+                  stats.tcp.ackerr, stats.tcp.syndrop);
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
@@ -322,9 +340,12 @@ static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile)
 #if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP)
 static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
+
+  net_stats_sum(&stats);
   return snprintf(netfile->line, NET_LINELEN,
                   "              RST: %04x  %04x\n",
-                  g_netstats.tcp.rst, g_netstats.tcp.synrst);
+                  stats.tcp.rst, stats.tcp.synrst);
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
@@ -335,16 +356,19 @@ static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NET_STATISTICS
 static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Type     ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.protoerr);
+                  stats.ipv4.protoerr);
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.protoerr);
+                  stats.ipv6.protoerr);
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -354,11 +378,11 @@ static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile)
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.typeerr);
+                  stats.icmp.typeerr);
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.typeerr);
+                  stats.icmpv6.typeerr);
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -376,36 +400,39 @@ static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NET_STATISTICS
 static int netprocfs_sent(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Sent       ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.sent);
+                  stats.ipv4.sent);
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.sent);
+                  stats.ipv6.sent);
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.sent);
+                  stats.tcp.sent);
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.sent);
+                  stats.udp.sent);
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.sent);
+                  stats.icmp.sent);
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.sent);
+                  stats.icmpv6.sent);
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.sent);
+                  stats.can.sent);
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -420,8 +447,11 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile)
 #if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP)
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 {
+  struct net_stats_s stats;
   int len = 0;
 
+  net_stats_sum(&stats);
+
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Rexmit   ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -430,7 +460,7 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.rexmit);
+                  stats.tcp.rexmit);
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
@@ -38,6 +38,7 @@
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -88,6 +89,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+  ipv4_forward_flush(NULL);
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
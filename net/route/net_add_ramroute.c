@@ -38,7 +38,9 @@
 
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -63,6 +65,9 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+#ifdef ROUTE_IPv4_TRIE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -84,10 +89,23 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
+#ifdef ROUTE_IPv4_TRIE
+  /* Index the new entry in the prefix trie */
+
+  ret = net_addtrie_ipv4(route);
+  if (ret < 0)
+    {
+      net_unlock();
+      net_freeroute_ipv4(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  ipv4_forward_flush(NULL);
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -100,6 +118,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
                       net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+#ifdef ROUTE_IPv6_TRIE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -121,6 +142,18 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lock();
 
+#ifdef ROUTE_IPv6_TRIE
+  /* Index the new entry in the prefix trie */
+
+  ret = net_addtrie_ipv6(route);
+  if (ret < 0)
+    {
+      net_unlock();
+      net_freeroute_ipv6(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
@@ -42,6 +42,7 @@
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -316,6 +317,7 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   filesize = (nentries - 1) * sizeof(struct net_route_ipv4_s);
   ret = file_truncate(&fshandle, filesize);
 
+  ipv4_forward_flush(NULL);
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
 
 errout_with_fshandle:
@@ -33,10 +33,13 @@
 
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/rcu.h>
 
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -115,6 +118,18 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
 
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
+#ifdef ROUTE_IPv4_TRIE
+      /* Remove the entry from the prefix trie too.  That waits for the
+       * lockless lookups that may still use the entry.
+       */
+
+      net_deltrie_ipv4(route);
+#elif defined(CONFIG_RCU)
+      /* Wait for the lockless lookups that may still use the entry */
+
+      synchronize_rcu();
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -173,6 +188,18 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
 
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
+#ifdef ROUTE_IPv6_TRIE
+      /* Remove the entry from the prefix trie too.  That waits for the
+       * lockless lookups that may still use the entry.
+       */
+
+      net_deltrie_ipv6(route);
+#elif defined(CONFIG_RCU)
+      /* Wait for the lockless lookups that may still use the entry */
+
+      synchronize_rcu();
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
@@ -219,7 +246,13 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv4(net_del_ipv4route, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+  ipv4_forward_flush(NULL);
+  return OK;
 }
 #endif
 
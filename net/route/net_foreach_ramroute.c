@@ -30,6 +30,7 @@
 #include <errno.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/rcu.h>
 
 #include <arch/irq.h>
 
@@ -119,4 +120,61 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: net_lookuproute_ipv4 and net_lookuproute_ipv6
+ *
+ * Description:
+ *   Traverse the routing table without taking the network lock.  The
+ *   handler must not block or modify the routing table.
+ *
+ * Input Parameters:
+ *   handler - Will be called for each route in the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the entire table was search.  Handlers may
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RCU) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+int net_lookuproute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv4_entry_s *route;
+  int ret = 0;
+
+  rcu_read_lock();
+
+  for (route = rcu_dereference(g_ipv4_routes.head);
+       ret == 0 && route != NULL;
+       route = rcu_dereference(route->flink))
+    {
+      ret = handler(&route->entry, arg);
+    }
+
+  rcu_read_unlock();
+  return ret;
+}
+#endif
+
+#if defined(CONFIG_RCU) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+int net_lookuproute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_entry_s *route;
+  int ret = 0;
+
+  rcu_read_lock();
+
+  for (route = rcu_dereference(g_ipv6_routes.head);
+       ret == 0 && route != NULL;
+       route = rcu_dereference(route->flink))
+    {
+      ret = handler(&route->entry, arg);
+    }
+
+  rcu_read_unlock();
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
@@ -26,11 +26,31 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rcu.h>
+
 #include "route/ramroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With RCU, the routing table is traversed without the network lock.  A
+ * new entry must be complete before it is linked, and a removed entry
+ * keeps its link so that a reader standing on it can continue.  The link
+ * is reset when the entry is reused.
+ */
+
+#ifdef CONFIG_RCU
+#  define ramroute_publish(p, e) rcu_assign_pointer(p, e)
+#  define ramroute_unlink(e)
+#else
+#  define ramroute_publish(p, e) ((p) = (e))
+#  define ramroute_unlink(e)     ((e)->flink = NULL)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,13 +77,13 @@ void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      ramroute_publish(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      ramroute_publish(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -75,13 +95,13 @@ void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      ramroute_publish(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      ramroute_publish(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -116,7 +136,7 @@ ramroute_ipv4_remfirst(FAR struct net_route_ipv4_queue_s *list)
           list->tail = NULL;
         }
 
-      ret->flink = NULL;
+      ramroute_unlink(ret);
     }
 
   return ret;
@@ -137,7 +157,7 @@ ramroute_ipv6_remfirst(FAR struct net_route_ipv6_queue_s *list)
           list->tail = NULL;
         }
 
-      ret->flink = NULL;
+      ramroute_unlink(ret);
     }
 
   return ret;
@@ -180,7 +200,7 @@ ramroute_ipv4_remafter(FAR struct net_route_ipv4_entry_s *entry,
           entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      ramroute_unlink(ret);
     }
 
   return ret;
@@ -206,7 +226,7 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
           entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      ramroute_unlink(ret);
     }
 
   return ret;
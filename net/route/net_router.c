@@ -36,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -283,7 +284,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#ifdef ROUTE_IPv4_TRIE
+      ret = net_lookuptrie_ipv4(target, net_ipv4_match, &match);
+#else
+      ret = net_lookuproute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -377,7 +382,11 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#ifdef ROUTE_IPv6_TRIE
+      ret = net_lookuptrie_ipv6(target, net_ipv6_match, &match);
+#else
+      ret = net_lookuproute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -0,0 +1,582 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/rcu.h>
+
+#include "route/ramroute.h"
+#include "route/trieroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The keys are the addresses as arrays of 32-bit words in host order */
+
+#ifdef ROUTE_IPv6_TRIE
+#  define TRIE_NWORDS 4
+#else
+#  define TRIE_NWORDS 1
+#endif
+
+/* Bit n of a key, counting from the most significant bit */
+
+#define TRIE_BIT(key, n) (((key)[(n) >> 5] >> (31 - ((n) & 31))) & 1)
+
+#ifdef CONFIG_RCU
+#  define trie_read_lock()   rcu_read_lock()
+#  define trie_read_unlock() rcu_read_unlock()
+#else
+#  define trie_read_lock()   net_lock()
+#  define trie_read_unlock() net_unlock()
+
+/* The lookups hold the network lock like the updates */
+
+#  define rcu_assign_pointer(p, v) ((p) = (v))
+#  define rcu_dereference(p)       (p)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node of a path compressed binary trie.  A node holds a prefix and the
+ * routes with that prefix.  The nodes without routes are branches that
+ * always have two children, so a trie of n prefixes has less than 2 * n
+ * nodes.  Only the child pointers and the route list of a node change
+ * once it is in the trie, so that the lookups may walk it while it is
+ * modified.
+ */
+
+struct trie_node_s
+{
+  FAR struct trie_node_s *child[2];     /* Longer prefixes, by next bit */
+  FAR struct net_route_tlink_s *routes; /* The routes with this prefix */
+  uint32_t key[TRIE_NWORDS];            /* The prefix */
+  uint8_t plen;                         /* The length of the prefix */
+};
+
+struct route_trie_s
+{
+  FAR struct trie_node_s *root;         /* The shortest prefix */
+  FAR struct trie_node_s *free;         /* Linked through child[0] */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+static struct route_trie_s g_ipv4_trie;
+static struct trie_node_s
+  g_ipv4_trienodes[2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES];
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+static struct route_trie_s g_ipv6_trie;
+static struct trie_node_s
+  g_ipv6_trienodes[2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits two keys have in common, at most
+ *   nbits.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint32_t *a,
+                                FAR const uint32_t *b,
+                                unsigned int nbits)
+{
+  unsigned int n = 0;
+  uint32_t diff;
+  int i;
+
+  for (i = 0; n < nbits; i++)
+    {
+      diff = a[i] ^ b[i];
+      if (diff != 0)
+        {
+          while ((diff & 0x80000000) == 0)
+            {
+              diff <<= 1;
+              n++;
+            }
+
+          break;
+        }
+
+      n += 32;
+    }
+
+  return MIN(n, nbits);
+}
+
+/****************************************************************************
+ * Name: trie_alloc and trie_free
+ *
+ * Description:
+ *   Allocate a node for the first plen bits of key, or free a node.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_alloc(FAR struct route_trie_s *trie,
+                                          FAR const uint32_t *key,
+                                          unsigned int plen)
+{
+  FAR struct trie_node_s *node = trie->free;
+  unsigned int n = plen;
+  int i;
+
+  if (node != NULL)
+    {
+      trie->free = node->child[0];
+      memset(node, 0, sizeof(struct trie_node_s));
+
+      for (i = 0; i < TRIE_NWORDS && n > 0; i++)
+        {
+          node->key[i] = n >= 32 ? key[i] : key[i] & ~(UINT32_MAX >> n);
+          n = n >= 32 ? n - 32 : 0;
+        }
+
+      node->plen = plen;
+    }
+
+  return node;
+}
+
+static void trie_free(FAR struct route_trie_s *trie,
+                      FAR struct trie_node_s *node)
+{
+  node->child[0] = trie->free;
+  trie->free     = node;
+}
+
+/****************************************************************************
+ * Name: trie_init
+ *
+ * Description:
+ *   Initialize a trie with its node pool.
+ *
+ ****************************************************************************/
+
+static void trie_init(FAR struct route_trie_s *trie,
+                      FAR struct trie_node_s *nodes, int nnodes)
+{
+  int i;
+
+  trie->root = NULL;
+  trie->free = NULL;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      trie_free(trie, &nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add a route with the prefix of plen bits of key.  The new nodes are
+ *   initialized before they are linked in with a single pointer update.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct route_trie_s *trie,
+                       FAR const uint32_t *key, unsigned int plen,
+                       FAR struct net_route_tlink_s *route)
+{
+  FAR struct trie_node_s **slot = &trie->root;
+  FAR struct net_route_tlink_s **tail;
+  FAR struct trie_node_s *branch;
+  FAR struct trie_node_s *node;
+  FAR struct trie_node_s *leaf;
+  unsigned int common = 0;
+
+  route->next = NULL;
+
+  /* Find the node with the prefix, or where it goes */
+
+  while ((node = *slot) != NULL)
+    {
+      common = trie_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* The prefix is there, add the route behind the others */
+
+          for (tail = &node->routes; *tail != NULL; tail = &(*tail)->next)
+            {
+            }
+
+          rcu_assign_pointer(*tail, route);
+          return OK;
+        }
+
+      slot = &node->child[TRIE_BIT(key, node->plen)];
+    }
+
+  leaf = trie_alloc(trie, key, plen);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  leaf->routes = route;
+
+  if (node != NULL)
+    {
+      if (common == plen)
+        {
+          /* The new prefix is a prefix of the node, it goes above it */
+
+          leaf->child[TRIE_BIT(node->key, plen)] = node;
+        }
+      else
+        {
+          /* They differ at bit common, a branch node takes both */
+
+          branch = trie_alloc(trie, key, common);
+          if (branch == NULL)
+            {
+              trie_free(trie, leaf);
+              return -ENOMEM;
+            }
+
+          branch->child[TRIE_BIT(key, common)]       = leaf;
+          branch->child[TRIE_BIT(node->key, common)] = node;
+          leaf = branch;
+        }
+    }
+
+  rcu_assign_pointer(*slot, leaf);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Remove a route with the prefix of plen bits of key, and the nodes that
+ *   are no longer needed.
+ *
+ ****************************************************************************/
+
+static void trie_remove(FAR struct route_trie_s *trie,
+                        FAR const uint32_t *key, unsigned int plen,
+                        FAR struct net_route_tlink_s *route)
+{
+  FAR struct trie_node_s **pslot = NULL;
+  FAR struct trie_node_s **slot = &trie->root;
+  FAR struct trie_node_s *parent = NULL;
+  FAR struct trie_node_s *freed[2];
+  FAR struct net_route_tlink_s **link;
+  FAR struct trie_node_s *child;
+  FAR struct trie_node_s *node;
+  int nfreed = 0;
+
+  while ((node = *slot) != NULL && node->plen < plen)
+    {
+      pslot  = slot;
+      parent = node;
+      slot   = &node->child[TRIE_BIT(key, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen)
+    {
+      return;
+    }
+
+  for (link = &node->routes; *link != NULL && *link != route;
+       link = &(*link)->next)
+    {
+    }
+
+  if (*link == NULL)
+    {
+      return;
+    }
+
+  /* A lookup in the route keeps following its link */
+
+  *link = route->next;
+
+  /* A node without routes stays only as the branch of two children */
+
+  if (node->routes == NULL &&
+      (node->child[0] == NULL || node->child[1] == NULL))
+    {
+      child = node->child[0] != NULL ? node->child[0] : node->child[1];
+      *slot = child;
+      freed[nfreed++] = node;
+
+      if (child == NULL && parent != NULL && parent->routes == NULL)
+        {
+          /* The parent is a branch left with a single child */
+
+          *pslot = parent->child[0] != NULL ? parent->child[0] :
+                                              parent->child[1];
+          freed[nfreed++] = parent;
+        }
+    }
+
+#ifdef CONFIG_RCU
+  /* Wait for the lookups that may still use the route or the nodes */
+
+  synchronize_rcu();
+#endif
+
+  while (nfreed > 0)
+    {
+      trie_free(trie, freed[--nfreed]);
+    }
+}
+
+/****************************************************************************
+ * Name: trie_ipv4_key and trie_ipv6_key
+ *
+ * Description:
+ *   Convert an address to a key.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+static void trie_ipv4_key(FAR uint32_t *key, in_addr_t addr)
+{
+  memset(key, 0, TRIE_NWORDS * sizeof(uint32_t));
+  key[0] = NTOHL(addr);
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+static void trie_ipv6_key(FAR uint32_t *key, FAR const uint16_t *addr)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      key[i] = ((uint32_t)NTOHS(addr[2 * i]) << 16) | NTOHS(addr[2 * i + 1]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the prefix tries of the in-memory routing tables
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void)
+{
+#ifdef ROUTE_IPv4_TRIE
+  trie_init(&g_ipv4_trie, g_ipv4_trienodes, nitems(g_ipv4_trienodes));
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+  trie_init(&g_ipv6_trie, g_ipv6_trienodes, nitems(g_ipv6_trienodes));
+#endif
+}
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Add a route of the in-memory routing table to the prefix trie.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  uint32_t key[TRIE_NWORDS];
+
+  trie_ipv4_key(key, route->target);
+  return trie_insert(&g_ipv4_trie, key, net_ipv4_mask2pref(route->netmask),
+                     &((FAR struct net_route_ipv4_entry_s *)route)->tlink);
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  uint32_t key[TRIE_NWORDS];
+
+  trie_ipv6_key(key, route->target);
+  return trie_insert(&g_ipv6_trie, key, net_ipv6_mask2pref(route->netmask),
+                     &((FAR struct net_route_ipv6_entry_s *)route)->tlink);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove a route from the prefix trie.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+void net_deltrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  uint32_t key[TRIE_NWORDS];
+
+  trie_ipv4_key(key, route->target);
+  trie_remove(&g_ipv4_trie, key, net_ipv4_mask2pref(route->netmask),
+              &((FAR struct net_route_ipv4_entry_s *)route)->tlink);
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+void net_deltrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  uint32_t key[TRIE_NWORDS];
+
+  trie_ipv6_key(key, route->target);
+  trie_remove(&g_ipv6_trie, key, net_ipv6_mask2pref(route->netmask),
+              &((FAR struct net_route_ipv6_entry_s *)route)->tlink);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix matches the target address, from the
+ *   shortest prefix to the longest.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_lookuptrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  FAR struct net_route_tlink_s *route;
+  FAR struct trie_node_s *node;
+  uint32_t key[TRIE_NWORDS];
+  int ret = 0;
+
+  trie_ipv4_key(key, target);
+  trie_read_lock();
+
+  for (node = rcu_dereference(g_ipv4_trie.root); node != NULL;
+       node = rcu_dereference(node->child[TRIE_BIT(key, node->plen)]))
+    {
+      if (trie_common(node->key, key, node->plen) < node->plen)
+        {
+          break;
+        }
+
+      for (route = rcu_dereference(node->routes);
+           ret == 0 && route != NULL;
+           route = rcu_dereference(route->next))
+        {
+          entry = container_of(route, struct net_route_ipv4_entry_s, tlink);
+          ret   = handler(&entry->entry, arg);
+        }
+
+      if (ret != 0 || node->plen == 32)
+        {
+          break;
+        }
+    }
+
+  trie_read_unlock();
+  return ret;
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_lookuptrie_ipv6(FAR const uint16_t *target,
+                        route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  FAR struct net_route_tlink_s *route;
+  FAR struct trie_node_s *node;
+  uint32_t key[TRIE_NWORDS];
+  int ret = 0;
+
+  trie_ipv6_key(key, target);
+  trie_read_lock();
+
+  for (node = rcu_dereference(g_ipv6_trie.root); node != NULL;
+       node = rcu_dereference(node->child[TRIE_BIT(key, node->plen)]))
+    {
+      if (trie_common(node->key, key, node->plen) < node->plen)
+        {
+          break;
+        }
+
+      for (route = rcu_dereference(node->routes);
+           ret == 0 && route != NULL;
+           route = rcu_dereference(route->next))
+        {
+          entry = container_of(route, struct net_route_ipv6_entry_s, tlink);
+          ret   = handler(&entry->entry, arg);
+        }
+
+      if (ret != 0 || node->plen == 128)
+        {
+          break;
+        }
+    }
+
+  trie_read_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
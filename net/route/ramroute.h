@@ -61,6 +61,15 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_ROUTE_TRIE
+/* This structure links the routes with the same prefix in the trie */
+
+struct net_route_tlink_s
+{
+  FAR struct net_route_tlink_s *next;
+};
+#endif
+
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
 /* This structure describes one entry in the routing table */
 
@@ -68,6 +77,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_TRIE
+  struct net_route_tlink_s tlink;
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -86,6 +98,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_TRIE
+  struct net_route_tlink_s tlink;
+#endif
 };
 
 /* This structure describes the head of a routing table list */
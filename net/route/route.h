@@ -283,6 +283,36 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lookuproute_ipv4/net_lookuproute_ipv6
+ *
+ * Description:
+ *   Traverse the routing table without modifying it.  With CONFIG_RCU and
+ *   the in-memory routing table, the traversal is done inside of an RCU
+ *   read-side critical section instead of holding the network lock, so
+ *   the handler must not block or modify the routing table.
+ *
+ * Input Parameters:
+ *   handler - Will be called for each route in the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   The same as net_foreachroute_ipv4/net_foreachroute_ipv6.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RCU) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+int net_lookuproute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
+#elif defined(CONFIG_NET_IPv4)
+#  define net_lookuproute_ipv4(h, a) net_foreachroute_ipv4(h, a)
+#endif
+
+#if defined(CONFIG_RCU) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+int net_lookuproute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
+#elif defined(CONFIG_NET_IPv6)
+#  define net_lookuproute_ipv6(h, a) net_foreachroute_ipv6(h, a)
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
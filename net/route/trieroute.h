@@ -0,0 +1,160 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The prefix trie indexes the in-memory routing tables only */
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+#  define ROUTE_IPv4_TRIE 1
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define ROUTE_IPv6_TRIE 1
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the prefix tries of the in-memory routing tables
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void);
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Add a route of the in-memory routing table to the prefix trie.  Routes
+ *   with the same prefix are visited in the order they were added.
+ *
+ * Input Parameters:
+ *   route - The route to add
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove a route from the prefix trie.  With CONFIG_RCU, this waits for
+ *   the lookups that may still use the route, so that it may be freed when
+ *   this function returns.
+ *
+ * Input Parameters:
+ *   route - The route to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+void net_deltrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+void net_deltrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix matches the target address, from the
+ *   shortest prefix to the longest.  This takes O(prefix length) steps
+ *   regardless of the size of the routing table.  With CONFIG_RCU, the
+ *   lookup is done inside of an RCU read-side critical section instead of
+ *   holding the network lock, so the handler must not block or modify the
+ *   routing table.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the lookup early with any non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_lookuptrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_lookuptrie_ipv6(FAR const uint16_t *target,
+                        route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
@@ -408,15 +408,6 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
       destmac = &bcastmac;
     }
 
-  /* Pre-allocate the IOB to hold frame or the first fragment, waiting if
-   * necessary.
-   */
-
-  iob = net_ioballoc(false);
-  DEBUGASSERT(iob != NULL);
-
-  fptr = iob->io_data;
-
   ninfo("Sending packet length %zd\n", buflen);
 
   /* Get the metadata that describes the MAC header on the packet */
@@ -449,6 +440,45 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
       return framer_hdrlen;
     }
 
+  /* Get the maximum packet size supported by this radio. */
+
+  ret = sixlowpan_radio_framelen(radio);
+  if (ret < 0)
+    {
+      nerr("ERROR: sixlowpan_radio_framelen() failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Limit to the maximum size supported by the IOBs */
+
+  if (ret > CONFIG_IOB_BUFSIZE)
+    {
+      ret = CONFIG_IOB_BUFSIZE;
+    }
+
+  /* Reserve space at the end for any FCS that the hardware may include
+   * in the payload.
+   */
+
+  ret -= SIXLOWPAN_MAC_FCSSIZE;
+  if (ret < MAX_MACHDR || ret > UINT16_MAX)
+    {
+      nerr("ERROR: Invalid frame size: %d\n", ret);
+      return ret;
+    }
+
+  framelen = (uint16_t)ret;
+
+  /* Allocate the IOB to hold frame or the first fragment, waiting if
+   * necessary.  This is done only once the frame geometry is known to be
+   * usable, so that no error path has an IOB to give back.
+   */
+
+  iob = net_ioballoc(false);
+  DEBUGASSERT(iob != NULL);
+
+  fptr = iob->io_data;
+
   /* This sill be the initial offset into io_data.  Valid data begins at
    * this offset and must be reflected in io_offset.
    */
@@ -486,35 +516,6 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
 
   ninfo("Header of length=%u protosize=%u\n", g_frame_hdrlen, protosize);
 
-  /* Get the maximum packet size supported by this radio. */
-
-  ret = sixlowpan_radio_framelen(radio);
-  if (ret < 0)
-    {
-      nerr("ERROR: sixlowpan_radio_framelen() failed: %d\n", ret);
-      return ret;
-    }
-
-  /* Limit to the maximum size supported by the IOBs */
-
-  if (ret > CONFIG_IOB_BUFSIZE)
-    {
-      ret = CONFIG_IOB_BUFSIZE;
-    }
-
-  /* Reserve space at the end for any FCS that the hardware may include
-   * in the payload.
-   */
-
-  ret -= SIXLOWPAN_MAC_FCSSIZE;
-  if (ret < MAX_MACHDR || ret > UINT16_MAX)
-    {
-      nerr("ERROR: Invalid frame size: %d\n", ret);
-      return ret;
-    }
-
-  framelen = (uint16_t)ret;
-
   /* Check if we need to fragment the packet into several frames.
    * We may need to reserve space at the end of the frame for a 2-byte FCS
    */
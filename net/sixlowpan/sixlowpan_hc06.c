@@ -101,6 +101,22 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+/* The compression of a unicast destination depends only on its IPv6 and
+ * MAC addresses and on the (fixed) address contexts, so it is remembered
+ * for the next packet to the same destination.
+ */
+
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+struct sixlowpan_destcache_s
+{
+  net_ipv6addr_t ipaddr;
+  struct netdev_varaddr_s macaddr;
+  FAR struct sixlowpan_addrcontext_s *context;
+  uint8_t iphc1;      /* DAC and DAM bits */
+  bool valid;         /* iphc1 is known */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -120,6 +136,13 @@ static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
 #endif
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+/* Direct mapped cache of destination address compressions */
+
+static struct sixlowpan_destcache_s
+  g_hc06_destcache[CONFIG_NET_6LOWPAN_HC06_DESTCACHE];
+#endif
+
 /* Pointer to the byte where to write next inline field. */
 
 static FAR uint8_t *g_hc06ptr;
@@ -177,6 +200,15 @@ static const uint8_t g_llprefix[] =
   0xfe, 0x80
 };
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+/* Inline bytes of a destination address, the tail of it, by DAM */
+
+static const uint8_t g_dam_inline[] =
+{
+  16, 8, 2, 0
+};
+#endif
+
 /* TTL uncompression values */
 
 static const uint8_t g_ttl_values[] =
@@ -258,6 +290,41 @@ static FAR struct sixlowpan_addrcontext_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: find_destcache
+ *
+ * Description:
+ *   Find the cache entry of a destination, taking it over if it belonged
+ *   to another one.  The address context of the entry is always valid;
+ *   the compression (iphc1) only after the first packet.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+static FAR struct sixlowpan_destcache_s *
+  find_destcache(FAR const net_ipv6addr_t ipaddr,
+                 FAR const struct netdev_varaddr_s *macaddr)
+{
+  FAR struct sixlowpan_destcache_s *entry;
+
+  entry = &g_hc06_destcache[(ipaddr[6] ^ ipaddr[7]) %
+                            CONFIG_NET_6LOWPAN_HC06_DESTCACHE];
+
+  if (!net_ipv6addr_cmp(entry->ipaddr, ipaddr) ||
+      entry->macaddr.nv_addrlen != macaddr->nv_addrlen ||
+      memcmp(entry->macaddr.nv_addr, macaddr->nv_addr,
+             macaddr->nv_addrlen) != 0)
+    {
+      net_ipv6addr_copy(entry->ipaddr, ipaddr);
+      memcpy(&entry->macaddr, macaddr, sizeof(struct netdev_varaddr_s));
+      entry->context = find_addrcontext_byprefix(ipaddr);
+      entry->valid   = false;
+    }
+
+  return entry;
+}
+#endif
+
 /****************************************************************************
  * Name: compress_ipaddr, compress_tagaddr, and compress_laddr
  *
@@ -746,6 +813,9 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
   FAR struct sixlowpan_addrcontext_s *saddrcontext;
   FAR struct sixlowpan_addrcontext_s *daddrcontext;
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  FAR struct sixlowpan_destcache_s *dcache;
+#endif
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -773,7 +843,12 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   /* Check if dest address context exists (for allocating third byte) */
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  dcache       = find_destcache(ipv6->destipaddr, destmac);
+  daddrcontext = dcache->context;
+#else
   daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+#endif
   saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
 
   if (daddrcontext != NULL || saddrcontext != NULL)
@@ -997,6 +1072,24 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
           g_hc06ptr += 16;
         }
     }
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  else if (dcache->valid)
+    {
+      /* Compressed like the last packet to this destination */
+
+      tmp = g_dam_inline[dcache->iphc1 & SIXLOWPAN_IPHC_DAM_MASK];
+
+      iphc1 |= dcache->iphc1;
+      if (daddrcontext != NULL)
+        {
+          iphc[2] |= daddrcontext->number;
+        }
+
+      memcpy(g_hc06ptr, (FAR const uint8_t *)ipv6->destipaddr + 16 - tmp,
+             tmp);
+      g_hc06ptr += tmp;
+    }
+#endif
   else
     {
       /* Address is unicast, try to compress */
@@ -1036,6 +1129,12 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
           memcpy(g_hc06ptr, ipv6->destipaddr, 16);
           g_hc06ptr += 16;
         }
+
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+      dcache->iphc1 = iphc1 & (SIXLOWPAN_IPHC_DAC |
+                               SIXLOWPAN_IPHC_DAM_MASK);
+      dcache->valid = true;
+#endif
     }
 
   g_uncomp_hdrlen = IPv6_HDRLEN;
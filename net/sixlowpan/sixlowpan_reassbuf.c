@@ -46,6 +46,10 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Number of hash chains of active reassembly buffers (a power of two) */
+
+#define REASS_NHASH         8
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -57,9 +61,15 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* The active, allocated reassembly buffers, hashed by tag and source so
+ * that each fragment finds its datagram without a walk over all of them.
+ */
+
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_NHASH];
+
+/* Time of the last sweep for expired reassembly buffers */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static clock_t g_reass_sweep;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -67,9 +77,31 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash chain for a reassembly tag and fragment source.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reassbuf_s **
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag ^ (reasstag >> 8);
+
+  if (fragsrc->nv_addrlen > 0)
+    {
+      hash ^= fragsrc->nv_addr[fragsrc->nv_addrlen - 1];
+    }
+
+  return &g_active_reass[hash & (REASS_NHASH - 1)];
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -124,30 +156,37 @@ static void sixlowpan_reass_expire(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
   clock_t elapsed;
+  int i;
+
+  g_reass_sweep = clock_systime_ticks();
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_NHASH; i++)
     {
-      /* Needed if 'reass' is freed */
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
+        {
+          /* Needed if 'reass' is freed */
 
-      next = reass->rb_flink;
+          next = reass->rb_flink;
 
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not certain.
-       */
+          /* Free any inactive reassembly buffers.  This is done because
+           * the life the reassembly buffer is not certain.
+           */
+
+          if (!reass->rb_active)
+            {
+              sixlowpan_reass_free(reass);
+              continue;
+            }
 
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
           /* Get the elpased time of the reassembly */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          elapsed = g_reass_sweep - reass->rb_time;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* If the reassembly has expired, then free the reassembly
+           * buffer
+           */
 
           if (elapsed >= NET_6LOWPAN_TIMEOUT)
             {
@@ -177,12 +216,14 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Find the reassembly buffer in its chain of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -196,7 +237,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -281,6 +322,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -326,10 +368,11 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systime_ticks();
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* Add the reassembly buffer to the active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head            = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink = *head;
+      *head           = reass;
     }
 
   return reass;
@@ -360,26 +403,34 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* Expired buffers are swept at most once per tick, the one that matches
+   * is checked below (we don't want to return old reassembly buffer with
+   * the same tag).
    */
 
-  sixlowpan_reass_expire();
+  if (clock_systime_ticks() != g_reass_sweep)
+    {
+      sixlowpan_reass_expire();
+    }
 
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Now search the chain of the tag and source.  In order to be a match,
+   * it must have the same reassembly tag as well as source address
+   * (different sources might use the same reassembly tag).
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = *sixlowpan_reass_hash(reasstag, fragsrc); reass != NULL;
+       reass = reass->rb_flink)
     {
-      /* In order to be a match, it must have the same reassembly tag as
-       * well as source address (different sources might use the same
-       * reassembly tag).
-       */
-
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          if (!reass->rb_active ||
+              clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
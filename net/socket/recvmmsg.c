@@ -0,0 +1,231 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_recvmmsg
+ *
+ * Description:
+ *   Receive a vector of messages one by one with psock_recvmsg().  This is
+ *   the recvmmsg() of the address families without one of their own; the
+ *   others call it with their lock held.
+ *
+ ****************************************************************************/
+
+int sock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                  unsigned int vlen, int flags,
+                  FAR const struct timespec *timeout)
+{
+  clock_t start = 0;
+  clock_t ticks = 0;
+  ssize_t ret = OK;
+  unsigned int i;
+
+  if (timeout != NULL)
+    {
+      start = clock_systime_ticks();
+      ticks = clock_time2ticks(timeout);
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[i].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      /* Only wait for the first message with MSG_WAITFORONE */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_systime_ticks() - start >= ticks)
+        {
+          i++;
+          break;
+        }
+    }
+
+  /* The error is only reported if no message was received */
+
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  This is
+ *   an internal OS interface.  It is functionally equivalent to
+ *   recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of buffers
+ *   flags     Receive flags
+ *   timeout   The time after which no further message is waited for, or
+ *             NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len of
+ *   each of them is set to the number of characters received.  If no
+ *   message could be received, a negated errno value is returned (see
+ *   comments with recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  /* Verify that non-NULL pointers were passed */
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      return -EINVAL;
+    }
+
+  if (timeout != NULL &&
+      (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+       timeout->tv_nsec >= NSEC_PER_SEC))
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (vlen == 0)
+    {
+      return 0;
+    }
+
+  /* Let logic specific to this address family handle the recvmmsg()
+   * operation if it has any.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_recvmmsg != NULL)
+    {
+      return psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                          timeout);
+    }
+
+  return sock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives multiple messages from a socket with one call.  It
+ *   is equivalent to calling recvmsg() for each of the messages, the
+ *   number of bytes received in each of them is returned in its msg_len.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of buffers
+ *   flags    Receive flags; MSG_WAITFORONE sets MSG_DONTWAIT after the
+ *            first message
+ *   timeout  The time after which no further message is waited for, or
+ *            NULL to wait until all buffers are filled
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set appropriately (see recvmsg()).  An error
+ *   that occurs after some messages were received is not reported.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,193 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_sendmmsg
+ *
+ * Description:
+ *   Send a vector of messages one by one with psock_sendmsg().  This is the
+ *   sendmmsg() of the address families without one of their own; the
+ *   others call it with their lock held.
+ *
+ ****************************************************************************/
+
+int sock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                  unsigned int vlen, int flags)
+{
+  ssize_t ret = OK;
+  unsigned int i;
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+    }
+
+  /* The error is only reported if no message was sent */
+
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent; the msg_len of each
+ *   of them is set to the number of characters sent.  If no message could
+ *   be sent, a negated errno value is returned (see comments with
+ *   sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  /* Verify that non-NULL pointers were passed */
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (vlen == 0)
+    {
+      return 0;
+    }
+
+  /* Let logic specific to this address family handle the sendmmsg()
+   * operation if it has any.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_sendmmsg != NULL)
+    {
+      return psock->s_sockif->si_sendmmsg(psock, msgvec, vlen, flags);
+    }
+
+  return sock_sendmmsg(psock, msgvec, vlen, flags);
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   sendmmsg() sends multiple messages to a socket with one call.  It is
+ *   equivalent to calling sendmsg() for each of the messages, the number
+ *   of bytes sent from each of them is returned in its msg_len.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On error, -1 is
+ *   returned, and errno is set appropriately (see sendmsg()).  An error
+ *   that occurs after some messages were sent is not reported.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -66,10 +66,11 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
@@ -182,6 +183,60 @@ net_sockif(sa_family_t family, int type, int protocol);
 int net_timeo(clock_t start_time, socktimeo_t timeo);
 #endif
 
+/****************************************************************************
+ * Name: sock_sendmmsg
+ *
+ * Description:
+ *   Send a vector of messages one by one with psock_sendmsg().  This is the
+ *   sendmmsg() of the address families without one of their own; the
+ *   others call it with their lock held.
+ *
+ * Input Parameters:
+ *   psock  - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec - The messages to send
+ *   vlen   - The number of messages
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or the negated errno value of the failure
+ *   of the first one.
+ *
+ ****************************************************************************/
+
+int sock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                  unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: sock_recvmmsg
+ *
+ * Description:
+ *   Receive a vector of messages one by one with psock_recvmsg().  This is
+ *   the recvmmsg() of the address families without one of their own; the
+ *   others call it with their lock held.
+ *
+ *   As in Linux, the timeout is checked after each message:  The messages
+ *   are waited for until the buffers are full or the timeout has elapsed,
+ *   but the wait for one message is not limited by the timeout.  With
+ *   MSG_WAITFORONE only the first message is waited for.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - The number of buffers
+ *   flags   - Receive flags
+ *   timeout - The time after which no further message is waited for, or
+ *             NULL
+ *
+ * Returned Value:
+ *   The number of messages received, or the negated errno value of the
+ *   failure of the first one.
+ *
+ ****************************************************************************/
+
+int sock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                  unsigned int vlen, int flags,
+                  FAR const struct timespec *timeout);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -72,6 +73,12 @@
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+#  define TCP_WBSACK(wrb)            ((wrb)->wb_sack)
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+#  define TCP_WBZCEND(wrb)           ((wrb)->wb_zcend)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -105,6 +112,8 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TXREADY           0x80U /* In the queue of the TX poll */
+#define TCP_TFOCOOKIE        0x100U /* Send a Fast Open cookie in SYN-ACK */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -114,10 +123,22 @@
 
 #endif
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+/* The TCP flags for the SACK based loss recovery */
+
+#define TCP_INSR              0x20U /* The flag in SACK based Recovery */
+#define TCP_DSACK             0x40U /* A D-SACK block is to be sent */
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
 
+/* The SACK scoreboard flags of a write buffer (RFC 6675) */
+
+#define TCP_WBSACK_SACKED     0x01  /* The segment was selectively ACKed */
+#define TCP_WBSACK_REXMIT     0x02  /* Retransmitted in the current recovery */
+
 /* After receiving 3 duplicate ACKs, TCP performs a retransmission
  * (RFC 5681 (3.2))
  */
@@ -127,6 +148,15 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+/* The kinds of the timers on the TCP timing wheel */
+
+#define TCP_WTIMER_RTO        0     /* conn->wtimer */
+#define TCP_WTIMER_ACK        1     /* conn->ackwtimer */
+
+/* The retransmission timer of a connection is running */
+
+#define tcp_timer_pending(conn) ((conn)->wtimer.armed)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -176,6 +206,86 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+/* A timer of a connection on the TCP timing wheel (see tcp_timer.c) */
+
+struct tcp_wtimer_s
+{
+  dq_entry_t node;  /* Link in a slot of the wheel */
+  clock_t    slot;  /* The wheel slot in which the timer expires */
+  bool       armed; /* The timer is on the wheel */
+  uint8_t    kind;  /* TCP_WTIMER_RTO or TCP_WTIMER_ACK */
+};
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  tcp_cc.c detects the duplicate ACKs and
+ * runs the fast recovery for all of them, the algorithm decides how the
+ * congestion window grows and how far it is reduced after a loss.
+ */
+
+struct tcp_conn_s;
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* The name used by TCP_CONGESTION */
+
+  /* Reset the state of the algorithm */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow the congestion window, acked bytes of new data up to ackno have
+   * been ACKed outside of the fast recovery.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                          uint32_t acked);
+
+  /* Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of CUBIC (RFC 8312) */
+
+struct tcp_cubic_s
+{
+  clock_t  epoch;         /* Start of the congestion avoidance epoch */
+  uint32_t w_max;         /* The cwnd before the last reduction */
+  uint32_t origin;        /* The cwnd at the plateau of the cubic */
+  uint32_t k;             /* The time to reach the plateau (ms) */
+  uint32_t w_est;         /* The cwnd that Reno would have */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* The number of rounds of the bottleneck bandwidth filter */
+
+#define TCP_BBR_BW_ROUNDS     10
+
+/* The state of BBR */
+
+struct tcp_bbr_s
+{
+  /* The delivery rates of the last rounds (bytes/s) */
+
+  uint32_t bw[TCP_BBR_BW_ROUNDS];
+  uint32_t btlbw;         /* The bottleneck bandwidth, their maximum */
+  uint32_t full_bw;       /* The btlbw at the last growth in STARTUP */
+  uint32_t min_rtt;       /* The minimum round trip time (us) */
+  clock_t  min_rtt_stamp; /* When min_rtt was measured */
+  clock_t  round_stamp;   /* When the current round started */
+  clock_t  probe_rtt_end; /* When PROBE_RTT ends */
+  uint32_t round_end;     /* The sequence number that ends the round */
+  uint32_t round_ackno;   /* The ACK at the start of the round */
+  uint32_t round_count;   /* The number of rounds so far */
+  uint8_t  mode;          /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  full_bw_cnt;   /* The rounds without growth in STARTUP */
+  uint8_t  cycle;         /* The phase of the PROBE_BW gain cycle */
+  bool     full_pipe;     /* The bottleneck bandwidth was reached */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -208,6 +318,11 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+  hash_node_t hnode;      /* Bucket entry of the active connections */
+#ifdef CONFIG_NET_DEVPOLL_READY
+  dq_entry_t rnode;       /* Entry of the queue of the TX poll */
+#endif
+  hash_node_t lnode;      /* Bucket entry of the listeners */
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -226,7 +341,10 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
-  struct   work_s work;   /* TCP timer handle */
+
+  /* The retransmission, keepalive and TIME_WAIT timer */
+
+  struct   tcp_wtimer_s wtimer;
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -234,6 +352,11 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
   uint8_t  rx_unackseg;   /* Number of un-ACKed received segments */
   uint8_t  rx_acktimer;   /* Time since last ACK sent (units: half-seconds) */
+  bool     rx_ackdue;     /* The delayed ACK timer has expired */
+
+  /* The delayed ACK timer */
+
+  struct   tcp_wtimer_s ackwtimer;
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
@@ -252,6 +375,24 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* The congestion control */
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s   bbr;
+#endif
+  } cc;                   /* The state of the congestion control */
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  uint32_t pacing_rate;   /* The pacing rate (bytes/s), 0 if not paced */
+  uint64_t pace_next;     /* When the next segment is due (us) */
+  struct   work_s pace;   /* The pacing timer */
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -309,6 +450,12 @@ struct tcp_conn_s
   struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
 #endif
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* The duplicate segment to report first in the next ACK (RFC 2883) */
+
+  struct tcp_sack_s dsack;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -326,6 +473,20 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  uint32_t   sack_recover; /* The highest sequence number sent when the
+                            * SACK based recovery was entered */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY sends are counted, the completions of the sends before
+   * zc_done are reported on the error queue from zc_reported on.
+   */
+
+  bool       zerocopy;    /* True: SO_ZEROCOPY is set */
+  uint32_t   zc_next;     /* The number of the next MSG_ZEROCOPY send */
+  uint32_t   zc_done;     /* The sends before this number are complete */
+  uint32_t   zc_reported; /* The sends before this number are reported */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -413,6 +574,13 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  uint8_t    wb_sack;      /* The SACK scoreboard flags, TCP_WBSACK_* */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  uint32_t   wb_zcend;     /* The number after the MSG_ZEROCOPY send that
+                            * has data in the buffer, 0 if none */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -455,6 +623,18 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -532,6 +712,59 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txready
+ *
+ * Description:
+ *   Add a connection that may have something to send to the queue of the
+ *   connections visited by the TX poll, if it is not there yet.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void tcp_txready(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_txready(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_txidle
+ *
+ * Description:
+ *   Remove a connection that has nothing to send from the queue of the
+ *   TX poll.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void tcp_txidle(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_nready / tcp_nextready
+ *
+ * Description:
+ *   tcp_nready() returns the number of connections in the queue of the TX
+ *   poll.  tcp_nextready() moves the first of them to the end of the queue
+ *   and returns it, or returns NULL if the queue is empty:  Calling it
+ *   tcp_nready() times visits each queued connection once.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+int tcp_nready(void);
+FAR struct tcp_conn_s *tcp_nextready(void);
+#endif
+
 /****************************************************************************
  * Name: tcp_local_ipv4_device
  *
@@ -639,7 +872,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
  * Description:
  *   If the port number is zero; select an unused port for the connection.
  *   If the port number is non-zero, verify that no other connection has
- *   been created with this port number.
+ *   been created with this port number, unless both have SO_REUSEPORT in
+ *   their options opt.
  *
  * Returned Value:
  *   Selected or verified port number in network order on success, a negated
@@ -652,7 +886,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno);
+                   uint16_t portno, sockopt_t opt);
 
 /****************************************************************************
  * Name: tcp_bind
@@ -919,6 +1153,97 @@ void tcp_initsequence(FAR struct tcp_conn_s *conn);
 
 void tcp_nextsequence(void);
 
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYN-ACK carrying a SYN
+ *   cookie.  This is used instead of dropping the SYN when the backlog of
+ *   the listener is full; no connection state is allocated.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received SYN
+ *   listener - The listening connection matched by the SYN
+ *   iplen    - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *listener,
+                          unsigned int iplen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK in the device buffer returns a valid SYN cookie and,
+ *   if so, create the connection in the TCP_SYN_RCVD state as if the SYN
+ *   had been accepted normally.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received ACK
+ *   listener - The listening connection matched by the ACK
+ *   iplen    - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Returned Value:
+ *   The new connection; NULL if the cookie is not valid or no connection
+ *   could be allocated.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_conn_s *listener,
+                                            unsigned int iplen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_fastopen_input
+ *
+ * Description:
+ *   Process the TCP Fast Open option of a SYN accepted by a listener.  A
+ *   cookie request makes the SYN-ACK carry a cookie; the data of a SYN
+ *   with a valid cookie is queued in the read-ahead buffer of the new
+ *   connection and acknowledged by the SYN-ACK.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure containing the received SYN
+ *   conn  - The connection just allocated for the SYN
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+void tcp_fastopen_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn, unsigned int iplen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_fastopen_option
+ *
+ * Description:
+ *   Write the TCP Fast Open option with the cookie of the peer of 'conn'.
+ *
+ * Returned Value:
+ *   The length of the option (TCP_OPT_FASTOPEN_LEN).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+int tcp_fastopen_option(FAR struct tcp_conn_s *conn, FAR uint8_t *opt);
+#endif
+
 /****************************************************************************
  * Name: tcp_poll
  *
@@ -1046,6 +1371,52 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_update_acktimer
+ *
+ * Description:
+ *   Start the delayed ACK timer of the provided TCP connection, unless it
+ *   is already running.  When it expires, the connection is polled and
+ *   the pending ACK is sent.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" with a delayed ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_update_acktimer(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_update_pacetimer
+ *
+ * Description:
+ *   Poll the connection for TX data again when the pacing of the
+ *   congestion control lets the next segment go.
+ *
+ * Input Parameters:
+ *   conn  - The TCP "connection" to poll for TX data
+ *   ticks - The time to wait for
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+void tcp_update_pacetimer(FAR struct tcp_conn_s *conn, clock_t ticks);
+#endif
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -1092,6 +1463,25 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn);
 
 int tcp_listen(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_reuseport_listener
+ *
+ * Description:
+ *   Return the listener of the SO_REUSEPORT group of listener that accepts
+ *   the connections of the peer at raddr and rport.  listener itself is
+ *   returned if it is not in a group.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *
+tcp_reuseport_listener(FAR struct tcp_conn_s *listener,
+                       FAR const uint16_t *raddr, uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_islistener
  *
@@ -1230,6 +1620,30 @@ uint16_t tcp_rx_mss(FAR struct net_driver_s *dev);
 void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                 uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_synack_cookie
+ *
+ * Description:
+ *   Turn the SYN in the device buffer into a SYN-ACK with the sequence
+ *   number 'isn' and the MSS option 'mss', without a connection.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received SYN
+ *   listener - The listening connection (for the TTL and TOS)
+ *   isn      - The SYN cookie used as initial sequence number
+ *   mss      - The MSS to advertise
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_cookie(FAR struct net_driver_s *dev,
+                       FAR struct tcp_conn_s *listener,
+                       uint32_t isn, uint16_t mss);
+#endif
+
 /****************************************************************************
  * Name: tcp_appsend
  *
@@ -2191,6 +2605,81 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg);
 void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+/****************************************************************************
+ * Name: tcp_zerocopy_attach
+ *
+ * Description:
+ *   Add user data to a write buffer without copying it:  The data is
+ *   referenced by I/O buffers that point to the user memory.
+ *
+ * Input Parameters:
+ *   wrb - The write buffer, it must hold no data yet
+ *   buf - The user data
+ *   len - The length of the data
+ *
+ * Returned Value:
+ *   len on success; -ENOMEM if the I/O buffers could not be allocated.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_attach(FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_done
+ *
+ * Description:
+ *   Complete the MSG_ZEROCOPY sends before zcend, unless a write buffer of
+ *   the connection still holds data of the last of them or the send is
+ *   still in progress.  Called after a write buffer carrying zcend is
+ *   released and at the end of each MSG_ZEROCOPY send.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   zcend - The TCP_WBZCEND() of the released write buffer
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_done(FAR struct tcp_conn_s *conn, uint32_t zcend);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_pending
+ *
+ * Description:
+ *   Return true if a completion notification is waiting on the error
+ *   queue.
+ *
+ ****************************************************************************/
+
+#define tcp_zerocopy_pending(conn) ((conn)->zc_done != (conn)->zc_reported)
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Read the pending completion notification from the error queue into a
+ *   control message.
+ *
+ * Input Parameters:
+ *   psock - The socket of the connection
+ *   msg   - Receive info with the control message buffer
+ *
+ * Returned Value:
+ *   0 on success; -EAGAIN if no notification is pending.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg);
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
+
 /****************************************************************************
  * Name: tcpip_hdrsize
  *
@@ -2308,6 +2797,82 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by its name.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The maximum length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The name of the algorithm.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_pace and tcp_cc_paced
+ *
+ * Description:
+ *   tcp_cc_pace() returns true if the next segment of a paced connection
+ *   may be sent now, otherwise it arms the pacing timer.  tcp_cc_paced()
+ *   accounts for a segment of len bytes that was sent.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+bool tcp_cc_pace(FAR struct tcp_conn_s *conn);
+void tcp_cc_paced(FAR struct tcp_conn_s *conn, uint32_t len);
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -24,7 +24,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <errno.h>
 #include <debug.h>
+#include <string.h>
 
 #include "tcp/tcp.h"
 
@@ -74,10 +76,113 @@
     } \
  } while(0)
 
+/* The algorithm of new connections */
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                               uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",              /* name */
+  NULL,                   /* init */
+  newreno_cong_avoid,     /* cong_avoid */
+  newreno_ssthresh        /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The algorithms that TCP_CONGESTION can select */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algs[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Grow the congestion window of NewReno:  By up to one segment per ACK in
+ *   slow start and by about one segment per round trip in congestion
+ *   avoidance (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                               uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* slow start (RFC 5681):
+       * Grow cwnd exponentially by maxseg(smss) per ACK.
+       */
+
+      increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+      CC_CWND_INC(conn->cwnd, increase);
+      ninfo("update slow start cwnd to %u\n", conn->cwnd);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +208,15 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  /* Keep the algorithm selected by TCP_CONGESTION or taken over from the
+   * listener.
+   */
+
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = TCP_CC_DEFAULT;
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -148,7 +262,7 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -165,6 +279,11 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       CC_INIT_CWND(conn->cwnd, conn->mss);
       conn->max_cwnd = conn->snd_wnd;
       conn->ssthresh = MAX(conn->snd_wnd, conn->ssthresh);
+
+      if (conn->cc_ops->init != NULL)
+        {
+          conn->cc_ops->init(conn);
+        }
     }
 }
 
@@ -269,34 +388,172 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->cong_avoid(conn, ackno, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by its name.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The maximum length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+  size_t namelen = strnlen(name, len);
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_algs); i++)
+    {
+      ops = g_tcp_cc_algs[i];
+      if (strlen(ops->name) == namelen &&
+          strncmp(ops->name, name, namelen) == 0)
+        {
+          if (conn->cc_ops != ops)
+            {
+#ifdef CONFIG_NET_TCP_PACING
+              conn->pacing_rate = 0;
+#endif
+              conn->cc_ops = ops;
+              if (ops->init != NULL)
+                {
+                  ops->init(conn);
+                }
             }
+
+          return OK;
         }
     }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return (conn->cc_ops != NULL ? conn->cc_ops : TCP_CC_DEFAULT)->name;
+}
+
+#ifdef CONFIG_NET_TCP_PACING
+
+/****************************************************************************
+ * Name: tcp_cc_pace
+ *
+ * Description:
+ *   Return true if the next segment of a paced connection may be sent now,
+ *   otherwise arm the pacing timer.  The timer can not wait for less than a
+ *   tick, so everything that is due within the next tick goes at once.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_pace(FAR struct tcp_conn_s *conn)
+{
+  uint64_t now;
+
+  if (conn->pacing_rate == 0)
+    {
+      return true;
+    }
+
+  now = TICK2USEC((uint64_t)clock_systime_ticks());
+  if (conn->pace_next <= now + USEC_PER_TICK)
+    {
+      return true;
+    }
+
+  tcp_update_pacetimer(conn, USEC2TICK(conn->pace_next - now));
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_paced
+ *
+ * Description:
+ *   Account for a segment of len bytes sent on a paced connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_paced(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+  uint64_t now;
+
+  if (conn->pacing_rate == 0)
+    {
+      return;
+    }
+
+  now = TICK2USEC((uint64_t)clock_systime_ticks());
+  if (conn->pace_next < now)
+    {
+      conn->pace_next = now;
+    }
+
+  conn->pace_next += (uint64_t)len * USEC_PER_SEC / conn->pacing_rate;
 }
+#endif /* CONFIG_NET_TCP_PACING */
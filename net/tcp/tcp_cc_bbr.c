@@ -0,0 +1,336 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The modes of BBR */
+
+#define BBR_STARTUP           0 /* Grow exponentially to find the bandwidth */
+#define BBR_DRAIN             1 /* Drain the queue built in STARTUP */
+#define BBR_PROBE_BW          2 /* Cycle the pacing gain around 1 */
+#define BBR_PROBE_RTT         3 /* Shrink the window to measure the RTT */
+
+/* The gains in units of 1/1000 */
+
+#define BBR_UNIT              1000
+#define BBR_HIGH_GAIN         2885 /* 2 / ln(2) */
+#define BBR_DRAIN_GAIN        347  /* 1 / BBR_HIGH_GAIN */
+#define BBR_CWND_GAIN         2000
+
+/* The bandwidth has to grow by 25% in each of three rounds to stay in
+ * STARTUP.
+ */
+
+#define BBR_FULL_BW_GROWTH    1250
+#define BBR_FULL_BW_ROUNDS    3
+
+/* The time the minimum RTT is valid for and the time spent in PROBE_RTT */
+
+#define BBR_MIN_RTT_WIN       SEC2TICK(10)
+#define BBR_PROBE_RTT_TIME    MSEC2TICK(200)
+
+#define BBR_GAIN_CYCLE        8
+#define BBR_MIN_CWND(conn)    (4 * (uint32_t)(conn)->mss)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                           uint32_t acked);
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                  /* name */
+  bbr_init,               /* init */
+  bbr_cong_avoid,         /* cong_avoid */
+  bbr_ssthresh            /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pacing gains of PROBE_BW:  Probe for more bandwidth for a round,
+ * drain the queue this built for a round and cruise for six rounds.
+ */
+
+static const uint16_t g_bbr_cycle[BBR_GAIN_CYCLE] =
+{
+  1250, 750, 1000, 1000, 1000, 1000, 1000, 1000
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_bdp
+ *
+ * Description:
+ *   Return the bandwidth-delay product scaled by gain, or 0 if the model
+ *   has no estimate yet.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bdp(FAR struct tcp_bbr_s *bbr, uint32_t gain)
+{
+  uint64_t bdp;
+
+  if (bbr->btlbw == 0 || bbr->min_rtt == UINT32_MAX)
+    {
+      return 0;
+    }
+
+  bdp = (uint64_t)bbr->btlbw * bbr->min_rtt / USEC_PER_SEC * gain /
+        BBR_UNIT;
+  return MIN(bdp, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: bbr_round
+ *
+ * Description:
+ *   A round trip ends when the data sent at its start is ACKed.  The
+ *   round gives the samples of the model:  Its duration is the RTT and
+ *   what was ACKed during it over the duration is the delivery rate.
+ *   The samples are only as fine as the system tick.
+ *
+ ****************************************************************************/
+
+static void bbr_round(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                      clock_t now)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t elapsed = now - bbr->round_stamp;
+  uint64_t bw;
+  uint32_t rtt;
+  int i;
+
+  rtt = TICK2USEC(elapsed > 0 ? elapsed : 1);
+  bw  = (uint64_t)TCP_SEQ_SUB(ackno, bbr->round_ackno) * USEC_PER_SEC / rtt;
+
+  bbr->bw[bbr->round_count % TCP_BBR_BW_ROUNDS] = MIN(bw, UINT32_MAX);
+  bbr->btlbw = 0;
+  for (i = 0; i < TCP_BBR_BW_ROUNDS; i++)
+    {
+      bbr->btlbw = MAX(bbr->btlbw, bbr->bw[i]);
+    }
+
+  /* A stamp of 0 means that PROBE_RTT wants a fresh sample */
+
+  if (rtt < bbr->min_rtt || bbr->min_rtt_stamp == 0)
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if ((uint64_t)bbr->btlbw * BBR_UNIT >=
+            (uint64_t)bbr->full_bw * BBR_FULL_BW_GROWTH)
+          {
+            bbr->full_bw     = bbr->btlbw;
+            bbr->full_bw_cnt = 0;
+          }
+        else if (++bbr->full_bw_cnt >= BBR_FULL_BW_ROUNDS)
+          {
+            bbr->full_pipe = true;
+            bbr->mode      = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_GAIN_CYCLE;
+        break;
+
+      default:
+        break;
+    }
+
+  /* Start the next round */
+
+  bbr->round_count++;
+  bbr->round_end   = conn->sndseq_max;
+  bbr->round_ackno = ackno;
+  bbr->round_stamp = now;
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ *
+ * Description:
+ *   Reset the model of BBR and start in STARTUP.
+ *
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now = clock_systime_ticks();
+
+  memset(bbr, 0, sizeof(struct tcp_bbr_s));
+  bbr->min_rtt       = UINT32_MAX;
+  bbr->min_rtt_stamp = now;
+  bbr->round_stamp   = now;
+  bbr->round_end     = conn->sndseq_max;
+  bbr->round_ackno   = conn->last_ackno;
+  bbr->mode          = BBR_STARTUP;
+
+  conn->pacing_rate  = 0;
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Update the model with an ACK, run the state machine and derive the
+ *   congestion window and the pacing rate from the model.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                           uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now = clock_systime_ticks();
+  uint32_t pacing_gain;
+  uint32_t target;
+
+  if (TCP_SEQ_GTE(ackno, bbr->round_end))
+    {
+      bbr_round(conn, ackno, now);
+    }
+
+  if (bbr->mode == BBR_DRAIN &&
+      conn->tx_unacked <= bbr_bdp(bbr, BBR_UNIT))
+    {
+      /* Start the gain cycle past its draining phase */
+
+      bbr->mode  = BBR_PROBE_BW;
+      bbr->cycle = 2 + bbr->round_count % (BBR_GAIN_CYCLE - 2);
+    }
+
+  if (bbr->mode != BBR_PROBE_RTT && bbr->min_rtt != UINT32_MAX &&
+      now - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN)
+    {
+      bbr->mode           = BBR_PROBE_RTT;
+      bbr->probe_rtt_end  = now + BBR_PROBE_RTT_TIME;
+      bbr->min_rtt_stamp  = 0;
+    }
+  else if (bbr->mode == BBR_PROBE_RTT &&
+           (sclock_t)(now - bbr->probe_rtt_end) >= 0)
+    {
+      if (bbr->min_rtt_stamp == 0)
+        {
+          bbr->min_rtt_stamp = now;
+        }
+
+      bbr->mode = bbr->full_pipe ? BBR_PROBE_BW : BBR_STARTUP;
+    }
+
+  /* The congestion window */
+
+  if (bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+    }
+  else
+    {
+      target = bbr_bdp(bbr, bbr->full_pipe ? BBR_CWND_GAIN : BBR_HIGH_GAIN);
+      if (bbr->full_pipe)
+        {
+          conn->cwnd = MIN((uint64_t)conn->cwnd + acked, target);
+        }
+      else if (target == 0 || conn->cwnd < target)
+        {
+          conn->cwnd = MIN((uint64_t)conn->cwnd + acked, UINT32_MAX);
+        }
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+
+  /* The pacing rate */
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        pacing_gain = BBR_HIGH_GAIN;
+        break;
+
+      case BBR_DRAIN:
+        pacing_gain = BBR_DRAIN_GAIN;
+        break;
+
+      case BBR_PROBE_BW:
+        pacing_gain = g_bbr_cycle[bbr->cycle];
+        break;
+
+      default:
+        pacing_gain = BBR_UNIT;
+        break;
+    }
+
+  conn->pacing_rate = (uint64_t)bbr->btlbw * pacing_gain / BBR_UNIT;
+
+  ninfo("bbr mode %u btlbw %" PRIu32 " min_rtt %" PRIu32
+        " cwnd %" PRIu32 "\n",
+        bbr->mode, bbr->btlbw, bbr->min_rtt, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not reduce its window on a loss, the model bounds it again
+ *   once the recovery is over.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->cwnd, 2 * conn->mss);
+}
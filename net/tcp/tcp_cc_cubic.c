@@ -0,0 +1,233 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The multiplicative decrease factor beta = 0.7 and the additive increase
+ * factor of the Reno friendly region, 3 * (1 - beta) / (1 + beta) = 9 / 17
+ * (RFC 8312).
+ */
+
+#define CUBIC_BETA(w)         ((w) / 10 * 7)
+#define CUBIC_FAST_CONV(w)    ((w) / 20 * 17)
+#define CUBIC_ALPHA_NUM       9
+#define CUBIC_ALPHA_DEN       17
+
+/* The time since the epoch beyond which the cubic is not followed (ms) */
+
+#define CUBIC_TIME_MAX        500000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                             uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  cubic_init,             /* init */
+  cubic_cong_avoid,       /* cong_avoid */
+  cubic_ssthresh          /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Return the integer cube root of x.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      if ((x >> s) >= 3 * y * (y + 1) + 1)
+        {
+          x -= (3 * y * (y + 1) + 1) << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ *
+ * Description:
+ *   Reset the state of CUBIC.
+ *
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(struct tcp_cubic_s));
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow the congestion window along the cubic function of the time since
+ *   the last reduction:  W(t) = C * (t - K)^3 + W_max, with C = 0.4 and the
+ *   windows in segments, but never slower than Reno would.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                             uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+  clock_t now = clock_systime_ticks();
+  uint64_t target;
+  int64_t offs;
+  int64_t t;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      g_tcp_cc_newreno.cong_avoid(conn, ackno, acked);
+      return;
+    }
+
+  if (cubic->epoch == 0)
+    {
+      /* A new epoch of congestion avoidance starts */
+
+      cubic->epoch = now != 0 ? now : 1;
+      cubic->w_est = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          /* K = cubic_root((W_max - cwnd) / C) seconds */
+
+          cubic->k      = cubic_cbrt((uint64_t)(cubic->w_max - conn->cwnd) *
+                                     (2500000000u / conn->mss));
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  t = TICK2MSEC(now - cubic->epoch);
+  if (t > CUBIC_TIME_MAX)
+    {
+      t = CUBIC_TIME_MAX;
+    }
+
+  /* C * (t - K)^3 in bytes, with t and K in milliseconds */
+
+  t   -= cubic->k;
+  offs = (t * t * t / 1000) * conn->mss / 10000000 * 4;
+
+  if (offs < 0 && (uint64_t)-offs >= cubic->origin)
+    {
+      target = 0;
+    }
+  else
+    {
+      target = cubic->origin + offs;
+    }
+
+  /* The Reno friendly region */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA_NUM /
+                  ((uint64_t)CUBIC_ALPHA_DEN * conn->cwnd);
+  if (target < cubic->w_est)
+    {
+      target = cubic->w_est;
+    }
+
+  /* Approach the target within a round trip, cwnd / acked ACKs */
+
+  if (target > conn->cwnd)
+    {
+      target = conn->cwnd + (target - conn->cwnd) * MAX(acked, 1) /
+               conn->cwnd;
+      conn->cwnd = MIN(target, UINT32_MAX);
+    }
+
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss and reduce it by beta.  With fast
+ *   convergence W_max is set lower if the window did not reach the last
+ *   W_max again, to release bandwidth to new flows.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+
+  cubic->epoch = 0;
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = CUBIC_FAST_CONV(conn->cwnd);
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  return MAX(CUBIC_BETA(conn->cwnd), 2 * conn->mss);
+}
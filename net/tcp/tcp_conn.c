@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -95,10 +97,106 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The same connections hashed by the remote address and the ports.  The
+ * local address is not part of the key, the connections may be bound to
+ * INADDR_ANY.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_active_hash, CONFIG_NET_TCP_HASH_BITS);
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+/* The connections that may have something to send, the ones visited by the
+ * TX poll of the network devices.
+ */
+
+static dq_queue_t g_ready_tcp_connections;
+static int g_nready_tcp_connections;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_key and tcp_ipv6_key
+ *
+ * Description:
+ *   Create the hash key of an active connection from its remote address
+ *   and its local and remote ports (all in network byte order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_key(in_addr_t raddr, uint16_t lport,
+                                    uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_key(FAR const uint16_t *raddr,
+                                    uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_key
+ *
+ * Description:
+ *   Create the hash key of an active connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_key(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_key(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Put a connection whose addresses and ports are set into the active
+ *   list.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_add(g_tcp_active_hash, &conn->hnode, tcp_conn_key(conn));
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -109,11 +207,14 @@ static dq_queue_t g_active_tcp_connections;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   opt is the options of the socket that is bound to the port:  Sockets
+ *   that both have SO_REUSEPORT never conflict.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, sockopt_t opt)
 {
   FAR struct tcp_conn_s *conn = NULL;
 
@@ -131,6 +232,14 @@ static FAR struct tcp_conn_s *
 #endif
          )
         {
+#ifdef CONFIG_NET_SOCKOPTS
+          if (_SO_GETOPT(opt, SO_REUSEPORT) &&
+              _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+            {
+              continue;
+            }
+#endif
+
           /* If there are multiple interface devices, then the local IP
            * address of the connection must also match.  INADDR_ANY is a
            * special case:  There can only be instance of a port number
@@ -192,15 +301,19 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *node;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  hashtable_for_every_possible(g_tcp_active_hash, node,
+                               tcp_ipv4_key(srcipaddr, tcp->destport,
+                                            tcp->srcport))
     {
+      conn = container_of(node, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -225,19 +338,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -259,15 +366,19 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *node;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  hashtable_for_every_possible(g_tcp_active_hash, node,
+                               tcp_ipv6_key(*srcipaddr, tcp->destport,
+                                            tcp->srcport))
     {
+      conn = container_of(node, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -292,19 +403,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -368,7 +473,13 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+                       addr->sin_port,
+#ifdef CONFIG_NET_SOCKOPTS
+                       conn->sconn.s_options
+#else
+                       0
+#endif
+                       );
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -468,7 +579,13 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                addr->sin6_port);
+                addr->sin6_port,
+#ifdef CONFIG_NET_SOCKOPTS
+                conn->sconn.s_options
+#else
+                0
+#endif
+                );
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -518,6 +635,8 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
  * Input Parameters:
  *   portno -- the selected port number in network order. Zero means no port
  *     selected.
+ *   opt -- the options of the socket the port is for.  A port is shared
+ *     with the other sockets with SO_REUSEPORT if it has it too.
  *
  * Returned Value:
  *   Selected or verified port number in network order on success, a negated
@@ -535,7 +654,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno)
+                   uint16_t portno, sockopt_t opt)
 {
   static uint16_t g_last_tcp_port;
 
@@ -568,7 +687,7 @@ int tcp_selectport(uint8_t domain,
               return -EADDRINUSE;
             }
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, 0)
 #ifdef CONFIG_NET_NAT
              || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -580,7 +699,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, opt)
 #ifdef CONFIG_NET_NAT
           || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -608,6 +727,7 @@ int tcp_selectport(uint8_t domain,
 
 void tcp_initialize(void)
 {
+  hashtable_init(g_tcp_active_hash);
 }
 
 /****************************************************************************
@@ -719,6 +839,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   if (conn)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
+      conn_lock_init(&conn->sconn);
       conn->sconn.s_ttl   = IP_TTL_DEFAULT;
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -841,6 +962,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   tcp_stop_monitor(conn, TCP_CLOSE);
 
+#ifdef CONFIG_NET_DEVPOLL_READY
+  /* Remove the connection from the queue of the TX poll */
+
+  tcp_txidle(conn);
+#endif
+
   /* Free remaining callbacks, actually there should be only the send
    * callback for CONFIG_NET_TCP_WRITE_BUFFERS is left.
    */
@@ -860,6 +987,8 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      hashtable_delete(g_tcp_active_hash, &conn->hnode,
+                       tcp_conn_key(conn));
     }
 
   tcp_free_rx_buffers(conn);
@@ -973,6 +1102,83 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_txready
+ *
+ * Description:
+ *   Add a connection that may have something to send to the queue of the
+ *   connections visited by the TX poll, if it is not there yet.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void tcp_txready(FAR struct tcp_conn_s *conn)
+{
+  if ((conn->flags & TCP_TXREADY) == 0)
+    {
+      conn->flags |= TCP_TXREADY;
+      dq_addlast(&conn->rnode, &g_ready_tcp_connections);
+      g_nready_tcp_connections++;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_txidle
+ *
+ * Description:
+ *   Remove a connection that has nothing to send from the queue of the
+ *   TX poll.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_txidle(FAR struct tcp_conn_s *conn)
+{
+  if ((conn->flags & TCP_TXREADY) != 0)
+    {
+      conn->flags &= ~TCP_TXREADY;
+      dq_rem(&conn->rnode, &g_ready_tcp_connections);
+      g_nready_tcp_connections--;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_nready / tcp_nextready
+ *
+ * Description:
+ *   Return the number of the connections in the queue of the TX poll, and
+ *   move the first of them to the end of the queue and return it.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+int tcp_nready(void)
+{
+  return g_nready_tcp_connections;
+}
+
+FAR struct tcp_conn_s *tcp_nextready(void)
+{
+  FAR dq_entry_t *entry;
+
+  entry = dq_remfirst(&g_ready_tcp_connections);
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  dq_addlast(entry, &g_ready_tcp_connections);
+  return container_of(entry, struct tcp_conn_s, rnode);
+}
+#endif /* CONFIG_NET_DEVPOLL_READY */
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -1131,8 +1337,11 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-      /* Initialize the variables of congestion control */
+      /* Initialize the variables of congestion control, with the
+       * algorithm of the listener.
+       */
 
+      conn->cc_ops = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1156,7 +1365,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addactive(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1273,7 +1482,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1288,7 +1497,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1467,7 +1676,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
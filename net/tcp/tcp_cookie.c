@@ -0,0 +1,514 @@
+/****************************************************************************
+ * net/tcp/tcp_cookie.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/net/netconfig.h>
+#if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK) && \
+    (defined(CONFIG_NET_TCP_SYNCOOKIES) || defined(CONFIG_NET_TCP_FASTOPEN))
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <debug.h>
+
+#include <crypto/siphash.h>
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The SYN cookie is laid out as in RFC 4987 / the original BSD cookies:
+ *
+ *   bits 27-31: The time counter modulo 32
+ *   bits 24-26: The index of the MSS in g_tcp_cookiemss[]
+ *   bits  0-23: SipHash of the 4-tuple, peer ISN, counter and MSS index
+ */
+
+#define TCP_COOKIE_PERIOD     SEC2TICK(64) /* Time counter granularity */
+#define TCP_COOKIE_MAXAGE     2            /* Periods a cookie is valid */
+#define TCP_COOKIE_HASHMASK   0x00ffffff
+
+#define TCP_COOKIE_SYN        0            /* Key of the SYN cookies */
+#define TCP_COOKIE_TFO        1            /* Key of the Fast Open cookies */
+#define TCP_COOKIE_NKEYS      2
+
+#define TCP_TFO_COOKIELEN     (TCP_OPT_FASTOPEN_LEN - 2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The SipHash input of a SYN cookie */
+
+struct tcp_syncookie_s
+{
+  uint8_t  laddr[16];
+  uint8_t  raddr[16];
+  uint16_t lport;
+  uint16_t rport;
+  uint32_t seq;      /* The ISN of the peer */
+  uint32_t count;    /* The time counter */
+  uint32_t mssidx;   /* The index of the encoded MSS */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static SIPHASH_KEY g_tcp_cookiekey[TCP_COOKIE_NKEYS];
+static bool g_tcp_cookieinit;
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+/* The MSS values a SYN cookie can encode, in ascending order */
+
+static const uint16_t g_tcp_cookiemss[] =
+{
+  216, 536, 1024, 1220, 1300, 1400, 1440, 1460
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cookie_hash
+ *
+ * Description:
+ *   Return the SipHash-2-4 of 'data' with the secret key 'key', creating
+ *   the keys on first use.
+ *
+ ****************************************************************************/
+
+static uint64_t tcp_cookie_hash(int key, FAR const void *data, size_t len)
+{
+  if (!g_tcp_cookieinit)
+    {
+      arc4random_buf(g_tcp_cookiekey, sizeof(g_tcp_cookiekey));
+      g_tcp_cookieinit = true;
+    }
+
+  return siphash(&g_tcp_cookiekey[key], 2, 4, data, len);
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_option
+ *
+ * Description:
+ *   Find the TCP option 'kind' in the TCP header of the device buffer.
+ *
+ * Returned Value:
+ *   A pointer to the option (its kind byte) and its length in 'optlen';
+ *   NULL if the option is not present.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tcp_cookie_option(FAR struct net_driver_s *dev,
+                                      unsigned int iplen, uint8_t kind,
+                                      FAR uint8_t *optlen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR uint8_t *opt = tcp->optdata;
+  int len = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+  int i = 0;
+
+  while (i < len && opt[i] != TCP_OPT_END)
+    {
+      if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= len || opt[i + 1] < 2 || i + opt[i + 1] > len)
+        {
+          break;
+        }
+
+      if (opt[i] == kind)
+        {
+          *optlen = opt[i + 1];
+          return &opt[i];
+        }
+
+      i += opt[i + 1];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_hash
+ *
+ * Description:
+ *   Hash the 4-tuple of the packet in the device buffer together with the
+ *   peer ISN 'seq', the time counter and the MSS index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+static uint32_t tcp_syncookie_hash(FAR struct net_driver_s *dev,
+                                   FAR struct tcp_hdr_s *tcp, uint32_t seq,
+                                   uint32_t count, uint32_t mssidx)
+{
+  struct tcp_syncookie_s in;
+
+  memset(&in, 0, sizeof(in));
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      memcpy(in.laddr, IPv6BUF->destipaddr, sizeof(net_ipv6addr_t));
+      memcpy(in.raddr, IPv6BUF->srcipaddr, sizeof(net_ipv6addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      memcpy(in.laddr, IPv4BUF->destipaddr, sizeof(in_addr_t));
+      memcpy(in.raddr, IPv4BUF->srcipaddr, sizeof(in_addr_t));
+    }
+#endif
+
+  in.lport  = tcp->destport;
+  in.rport  = tcp->srcport;
+  in.seq    = seq;
+  in.count  = count;
+  in.mssidx = mssidx;
+
+  return (uint32_t)tcp_cookie_hash(TCP_COOKIE_SYN, &in, sizeof(in)) &
+         TCP_COOKIE_HASHMASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_fastopen_cookie
+ *
+ * Description:
+ *   Compute the Fast Open cookie of the peer address of 'conn'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+static void tcp_fastopen_cookie(FAR struct tcp_conn_s *conn,
+                                FAR uint8_t *cookie)
+{
+  const size_t addrlen = net_ip_domain_select(conn->domain,
+                                  sizeof(in_addr_t), sizeof(net_ipv6addr_t));
+  uint64_t hash;
+
+  hash = tcp_cookie_hash(TCP_COOKIE_TFO,
+                         net_ip_binding_raddr(&conn->u, conn->domain),
+                         addrlen);
+  memcpy(cookie, &hash, TCP_TFO_COOKIELEN);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYN-ACK carrying a SYN
+ *   cookie.  This is used instead of dropping the SYN when the backlog of
+ *   the listener is full; no connection state is allocated.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received SYN
+ *   listener - The listening connection matched by the SYN
+ *   iplen    - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *listener,
+                          unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR uint8_t *opt;
+  uint32_t count;
+  uint32_t isn;
+  uint16_t mss;
+  uint8_t optlen;
+  int idx;
+
+  /* Use the smallest of the MSS of the peer (RFC 9293 default without the
+   * option), the MSS of the device and the MSS selected by the user.
+   */
+
+  mss = 536;
+  opt = tcp_cookie_option(dev, iplen, TCP_OPT_MSS, &optlen);
+  if (opt != NULL && optlen == TCP_OPT_MSS_LEN)
+    {
+      mss = ((uint16_t)opt[2] << 8) | opt[3];
+    }
+
+  if (mss > tcp_rx_mss(dev))
+    {
+      mss = tcp_rx_mss(dev);
+    }
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+  if (listener->user_mss > 0 && listener->user_mss < mss)
+    {
+      mss = listener->user_mss;
+    }
+#endif
+
+  for (idx = nitems(g_tcp_cookiemss) - 1; idx > 0; idx--)
+    {
+      if (g_tcp_cookiemss[idx] <= mss)
+        {
+          break;
+        }
+    }
+
+  count = clock_systime_ticks() / TCP_COOKIE_PERIOD;
+  isn   = (count << 27) | ((uint32_t)idx << 24) |
+          tcp_syncookie_hash(dev, tcp, tcp_getsequence(tcp->seqno),
+                             count, idx);
+
+  ninfo("SYN cookie %08" PRIx32 " mss %u\n", isn, g_tcp_cookiemss[idx]);
+  tcp_synack_cookie(dev, listener, isn, g_tcp_cookiemss[idx]);
+}
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK in the device buffer returns a valid SYN cookie and,
+ *   if so, create the connection in the TCP_SYN_RCVD state as if the SYN
+ *   had been accepted normally.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received ACK
+ *   listener - The listening connection matched by the ACK
+ *   iplen    - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Returned Value:
+ *   The new connection; NULL if the cookie is not valid or no connection
+ *   could be allocated.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_conn_s *listener,
+                                            unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR struct tcp_conn_s *conn;
+  uint32_t cookie;
+  uint32_t count;
+  uint32_t seq;
+  uint32_t idx;
+  int age;
+
+  /* The ACK acknowledges the cookie and follows the SYN of the peer */
+
+  cookie = tcp_getsequence(tcp->ackno) - 1;
+  seq    = tcp_getsequence(tcp->seqno) - 1;
+  idx    = (cookie >> 24) & 7;
+  count  = clock_systime_ticks() / TCP_COOKIE_PERIOD;
+
+  for (age = 0; age < TCP_COOKIE_MAXAGE; age++, count--)
+    {
+      if ((count & 0x1f) == (cookie >> 27) &&
+          tcp_syncookie_hash(dev, tcp, seq, count, idx) ==
+          (cookie & TCP_COOKIE_HASHMASK))
+        {
+          break;
+        }
+    }
+
+  if (age >= TCP_COOKIE_MAXAGE)
+    {
+      return NULL;
+    }
+
+  conn = tcp_alloc_accept(dev, tcp, listener);
+  if (conn == NULL)
+    {
+      return NULL;
+    }
+
+  /* tcp_alloc_accept() took the sequence number of the ACK, which is
+   * already the one expected next.  Our ISN was the cookie and only the
+   * SYN is outstanding.
+   */
+
+  conn->crefs = 1;
+  conn->mss   = g_tcp_cookiemss[idx];
+
+  tcp_setsequence(conn->sndseq, cookie);
+#if !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+  conn->rexmit_seq = cookie;
+#endif
+  net_incr32(conn->sndseq, 1);
+
+  ninfo("SYN cookie %08" PRIx32 " accepted\n", cookie);
+  return conn;
+}
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
+
+/****************************************************************************
+ * Name: tcp_fastopen_input
+ *
+ * Description:
+ *   Process the TCP Fast Open option of a SYN accepted by a listener.  A
+ *   cookie request makes the SYN-ACK carry a cookie; the data of a SYN
+ *   with a valid cookie is queued in the read-ahead buffer of the new
+ *   connection and acknowledged by the SYN-ACK.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure containing the received SYN
+ *   conn  - The connection just allocated for the SYN
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN)
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+void tcp_fastopen_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn, unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  uint8_t cookie[TCP_TFO_COOKIELEN];
+  FAR struct iob_s *iob;
+  FAR uint8_t *opt;
+  unsigned int hdrlen;
+  unsigned int len;
+  uint8_t optlen;
+  int ret;
+
+  opt = tcp_cookie_option(dev, iplen, TCP_OPT_FASTOPEN, &optlen);
+  if (opt == NULL)
+    {
+      return;
+    }
+
+  tcp_fastopen_cookie(conn, cookie);
+
+  /* A cookie request or an invalid cookie is answered with a fresh cookie
+   * and the data in the SYN, if any, is ignored (RFC 7413, Section 4.2).
+   */
+
+  if (optlen != TCP_OPT_FASTOPEN_LEN ||
+      memcmp(&opt[2], cookie, TCP_TFO_COOKIELEN) != 0)
+    {
+      conn->flags |= TCP_TFOCOOKIE;
+      return;
+    }
+
+  hdrlen = iplen + ((tcp->tcpoffset >> 4) << 2);
+  if (dev->d_len <= hdrlen)
+    {
+      return;
+    }
+
+  /* Data that does not fit the receive window is left for the peer to
+   * retransmit after the handshake.
+   */
+
+  len = dev->d_len - hdrlen;
+  if (len > tcp_get_recvwindow(dev, conn))
+    {
+      return;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  ret = iob_clone_partial(dev->d_iob, len, hdrlen, iob, 0, false, false);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  net_iob_concat(&conn->readahead, &iob);
+  net_incr32(conn->rcvseq, len);
+
+  ninfo("Fast Open: %u bytes in SYN\n", len);
+}
+#endif /* CONFIG_NET_TCP_FASTOPEN */
+
+/****************************************************************************
+ * Name: tcp_fastopen_option
+ *
+ * Description:
+ *   Write the TCP Fast Open option with the cookie of the peer of 'conn'.
+ *
+ * Returned Value:
+ *   The length of the option (TCP_OPT_FASTOPEN_LEN).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+int tcp_fastopen_option(FAR struct tcp_conn_s *conn, FAR uint8_t *opt)
+{
+  opt[0] = TCP_OPT_FASTOPEN;
+  opt[1] = TCP_OPT_FASTOPEN_LEN;
+  tcp_fastopen_cookie(conn, &opt[2]);
+
+  return TCP_OPT_FASTOPEN_LEN;
+}
+#endif
+
+#endif /* CONFIG_NET_TCP && !CONFIG_NET_TCP_NO_STACK && (SYNCOOKIES || FASTOPEN) */
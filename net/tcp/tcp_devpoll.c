@@ -122,6 +122,21 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
       result = tcp_callback(dev, conn, TCP_POLL);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      /* Send the delayed ACK if its timer expired and nothing carried
+       * it in the meantime.
+       */
+
+      if (conn->rx_ackdue)
+        {
+          conn->rx_ackdue = false;
+          if (conn->rx_unackseg > 0)
+            {
+              result |= TCP_SNDACK;
+            }
+        }
+#endif
+
       /* Handle the callback response */
 
       tcp_appsend(dev, conn, result);
@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <netinet/tcp.h>
 
@@ -239,6 +240,21 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* The congestion control algorithm */
+        if (*value_len == 0)
+          {
+            ret          = -EINVAL;
+          }
+        else
+          {
+            *value_len   = MIN(*value_len, TCP_CA_NAME_MAX);
+            strlcpy(value, tcp_cc_name(conn), *value_len);
+            ret          = OK;
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -67,6 +67,12 @@
 
 #define IPDATA(hl) (*(FAR uint8_t *)IPBUF(hl))
 
+#ifdef CONFIG_NETDEV_GRO
+#  define TCP_GRO_CHECKED(dev) ((dev)->d_gsosize > 0)
+#else
+#  define TCP_GRO_CHECKED(dev) false
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -404,6 +410,41 @@ static bool tcp_rebuild_ofosegs(FAR struct tcp_conn_s *conn,
   return (ofoseg->data == NULL);
 }
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+/****************************************************************************
+ * Name: tcp_input_dsack
+ *
+ * Description:
+ *   Remember a segment that was received twice, it is reported in the first
+ *   SACK block of the next ACK (RFC 2883).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   left   - The first sequence number of the duplicate data
+ *   right  - The sequence number following the duplicate data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_input_dsack(FAR struct tcp_conn_s *conn,
+                            uint32_t left, uint32_t right)
+{
+  if ((conn->flags & TCP_SACK) != 0 && left != right)
+    {
+      ninfo("TCP DSACK [%" PRIu32 " : %" PRIu32 "]\n", left, right);
+
+      conn->dsack.left  = left;
+      conn->dsack.right = right;
+      conn->flags      |= TCP_DSACK;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_input_ofosegs
  *
@@ -431,6 +472,9 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
   bool rebuild;
   int i = 0;
   int len;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  int j;
+#endif
 
   ofoseg.left =
     tcp_getsequence(((FAR struct tcp_hdr_s *)IPBUF(iplen))->seqno);
@@ -454,6 +498,20 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
         "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
         ofoseg.left, ofoseg.right, TCP_SEQ_SUB(ofoseg.right, ofoseg.left));
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* A segment that is already queued is reported as a D-SACK */
+
+  for (j = 0; j < conn->nofosegs; j++)
+    {
+      if (TCP_SEQ_GTE(ofoseg.left, conn->ofosegs[j].left) &&
+          TCP_SEQ_LTE(ofoseg.right, conn->ofosegs[j].right))
+        {
+          tcp_input_dsack(conn, ofoseg.left, ofoseg.right);
+          break;
+        }
+    }
+#endif
+
   /* Trim l3/l4 header to reserve appdata */
 
   dev->d_iob = iob_trimhead(dev->d_iob, len);
@@ -670,6 +728,88 @@ static void tcp_clear_zero_probe(FAR struct tcp_conn_s *conn,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_input_listener
+ *
+ * Description:
+ *   Find the connection listening for the segment in the device buffer,
+ *   selecting the member of a SO_REUSEPORT group for the peer.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet.
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *   tcp    - Header of TCP structure
+ *
+ * Returned Value:
+ *   The listening connection; NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+tcp_input_listener(FAR struct net_driver_s *dev, uint8_t domain,
+                   FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_conn_s *conn;
+  union ip_binding_u uaddr;
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#  endif
+    {
+      net_ipv4addr_copy(uaddr.ipv4.laddr,
+                        net_ip4addr_conv32(IPv4BUF->destipaddr));
+    }
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  conn = tcp_findlistener(&uaddr, tcp->destport, domain);
+#else
+  conn = tcp_findlistener(&uaddr, tcp->destport);
+#endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  /* Select the listener of a SO_REUSEPORT group for the peer */
+
+  if (conn != NULL)
+    {
+#  ifdef CONFIG_NET_IPv6
+#    ifdef CONFIG_NET_IPv4
+      if (domain == PF_INET6)
+#    endif
+        {
+          conn = tcp_reuseport_listener(conn, IPv6BUF->srcipaddr,
+                                        tcp->srcport);
+        }
+#  endif
+
+#  ifdef CONFIG_NET_IPv4
+#    ifdef CONFIG_NET_IPv6
+      if (domain == PF_INET)
+#    endif
+        {
+          conn = tcp_reuseport_listener(conn, IPv4BUF->srcipaddr,
+                                        tcp->srcport);
+        }
+#  endif
+    }
+#endif /* CONFIG_NET_SOCKOPTS */
+
+  return conn;
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -694,9 +834,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 {
   FAR struct tcp_conn_s *conn = NULL;
   FAR struct tcp_hdr_s *tcp;
-  union ip_binding_u uaddr;
   unsigned int tcpiplen;
-  uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
   int      len;
@@ -704,7 +842,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
 
-  g_netstats.tcp.recv++;
+  NETSTATS.tcp.recv++;
 #endif
 
   /* Get a pointer to the TCP header.  The TCP header lies just after the
@@ -724,21 +862,30 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   tcpiplen = iplen + TCP_HDRLEN;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-  /* Start of TCP input header processing code. */
+  /* Start of TCP input header processing code.  The segments verified by
+   * the device or coalesced by the receive offload are already checked.
+   */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!TCP_GRO_CHECKED(dev) && !netdev_csum_valid(dev) &&
+      tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.tcp.drop++;
-      g_netstats.tcp.chkerr++;
+      NETSTATS.tcp.drop++;
+      NETSTATS.tcp.chkerr++;
 #endif
       nwarn("WARNING: Bad TCP checksum\n");
       goto drop;
     }
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+  /* The responses built in the device buffer are ordinary packets */
+
+  dev->d_gsosize = 0;
+#endif
+
   /* Demultiplex this segment. First check any active connections. */
 
   conn = tcp_active(dev, tcp);
@@ -774,36 +921,19 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
        * listening on this port.
        */
 
-      tmp16 = tcp->destport;
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-      if (domain == PF_INET6)
-#  endif
-        {
-          net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
-        }
-#endif
-
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-      if (domain == PF_INET)
-#  endif
-        {
-          net_ipv4addr_copy(uaddr.ipv4.laddr,
-                            net_ip4addr_conv32(IPv4BUF->destipaddr));
-        }
-#endif
-
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
-#else
-      if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
-#endif
+      if ((conn = tcp_input_listener(dev, domain, tcp)) != NULL)
         {
           if (!tcp_backlogavailable(conn))
             {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+              /* Answer statelessly; the ACK will carry the connection */
+
+              tcp_syncookie_synack(dev, conn, iplen);
+              return;
+#else
               nerr("ERROR: no free containers for TCP BACKLOG!\n");
               goto drop;
+#endif
             }
 
           /* We matched the incoming packet with a connection in LISTEN.
@@ -850,7 +980,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                */
 
 #ifdef CONFIG_NET_STATISTICS
-              g_netstats.tcp.syndrop++;
+              NETSTATS.tcp.syndrop++;
 #endif
               nerr("ERROR: No free TCP connections\n");
               goto drop;
@@ -862,12 +992,41 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           tcp_parse_option(dev, conn, iplen);
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+          /* Accept the data of a SYN with a valid Fast Open cookie */
+
+          tcp_fastopen_input(dev, conn, iplen);
+#endif
+
           /* Our response will be a SYNACK. */
 
           tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
           return;
         }
     }
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  else if ((tcp->flags & TCP_CTL & ~TCP_PSH) == TCP_ACK)
+    {
+      /* This may be the ACK of a SYN answered with a SYN cookie.  If the
+       * cookie is valid, continue as in the TCP_SYN_RCVD state.
+       */
+
+      conn = tcp_input_listener(dev, domain, tcp);
+      if (conn != NULL)
+        {
+          if (!tcp_backlogavailable(conn))
+            {
+              goto drop;
+            }
+
+          conn = tcp_syncookie_accept(dev, conn, iplen);
+          if (conn != NULL)
+            {
+              goto found;
+            }
+        }
+    }
+#endif
 
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
 
@@ -885,7 +1044,7 @@ reset:
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.tcp.synrst++;
+  NETSTATS.tcp.synrst++;
 #endif
   tcp_reset(dev, conn);
   return;
@@ -893,6 +1052,12 @@ reset:
 found:
   flags = 0;
 
+  /* The segment may acknowledge data or open the window, so the connection
+   * may have something to send now.
+   */
+
+  tcp_txready(conn);
+
   /* We do a very naive form of TCP reset processing; we just accept
    * any RST and kill our connection. We should in fact check if the
    * sequence number of this reset is within our advertised window
@@ -970,16 +1135,16 @@ found:
 
   if (dev->d_len > 0)
     {
-      if ((g_netstats.tcp.recv %
+      if ((NETSTATS.tcp.recv %
           CONFIG_NET_TCP_DEBUG_DROP_RECV_PROBABILITY) == 0)
         {
           uint32_t seq = tcp_getsequence(tcp->seqno);
 
-          g_netstats.tcp.drop++;
+          NETSTATS.tcp.drop++;
 
           ninfo("TCP DROP RCVPKT: "
                 "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
-                g_netstats.tcp.drop, seq, TCP_SEQ_ADD(seq, dev->d_len),
+                NETSTATS.tcp.drop, seq, TCP_SEQ_ADD(seq, dev->d_len),
                 dev->d_len);
 
           dev->d_len = 0;
@@ -1168,6 +1333,9 @@ found:
           if (TCP_SEQ_LT(seq, rcvseq))
             {
               uint32_t trimlen = TCP_SEQ_SUB(rcvseq, seq);
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+              uint32_t duplen = dev->d_len < trimlen ? dev->d_len : trimlen;
+#endif
 
               if (tcp_trim_head(dev, tcp, trimlen))
                 {
@@ -1176,6 +1344,9 @@ found:
                    * E.g. a keep-alive segment.
                    */
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+                  tcp_input_dsack(conn, seq, TCP_SEQ_ADD(seq, duplen));
+#endif
                   tcp_send(dev, conn, TCP_ACK, tcpiplen);
                   return;
                 }
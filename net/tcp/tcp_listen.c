@@ -50,20 +50,26 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenports table hashes all listeners by their local port. */
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+static DECLARE_HASHTABLE(tcp_listenports, CONFIG_NET_TCP_HASH_BITS);
+
+/* The number of listeners, at most CONFIG_NET_MAX_LISTENPORTS */
+
+static int tcp_nlisteners;
 
 /****************************************************************************
  * Private Functions
@@ -89,21 +95,20 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
-  int ndx;
+  FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *node;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listener that hashes to the same bucket */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(tcp_listenports, node, (uint32_t)portno)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+      conn = container_of(node, struct tcp_conn_s, lnode);
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+      if (conn->lport == portno && conn->domain == domain)
 #else
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
 #endif
         {
 #ifdef CONFIG_NET_IPv6
@@ -143,10 +148,160 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_member
+ *
+ * Description:
+ *   Return true if conn is in the SO_REUSEPORT group of listener:  The
+ *   listeners with SO_REUSEPORT on the same address and port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool tcp_reuseport_member(FAR struct tcp_conn_s *listener,
+                                 FAR struct tcp_conn_s *conn)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn->domain != listener->domain)
+    {
+      return false;
+    }
+#endif
+
+  if (conn->lport != listener->lport ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (listener->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, listener->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, listener->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_conn_raddr
+ *
+ * Description:
+ *   Return the remote address of a connection as an array of half words.
+ *
+ ****************************************************************************/
+
+static FAR const uint16_t *tcp_conn_raddr(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return (FAR const uint16_t *)&conn->u.ipv4.raddr;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return conn->u.ipv6.raddr;
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_reuseport_listener
+ *
+ * Description:
+ *   Return the listener of the SO_REUSEPORT group of listener that accepts
+ *   the connections of a peer.  The peers are spread between the group by
+ *   the hash of their address and port, so that the listener selected for
+ *   the SYN of a connection is selected again when it is accepted.
+ *
+ * Input Parameters:
+ *   listener - The listener found for the connection
+ *   raddr    - The address of the peer
+ *   rport    - The port of the peer
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *
+tcp_reuseport_listener(FAR struct tcp_conn_s *listener,
+                       FAR const uint16_t *raddr, uint16_t rport)
+{
+  FAR struct tcp_conn_s *conn = listener;
+  FAR hash_node_t *node;
+  uint32_t key = rport;
+  uint32_t n = 0;
+  int nwords = 2;
+  int i;
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (listener->domain == PF_INET6)
+#endif
+    {
+      nwords = 8;
+    }
+#endif
+
+  for (i = 0; i < nwords; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  hashtable_for_every_possible(tcp_listenports, node,
+                               (uint32_t)listener->lport)
+    {
+      conn = container_of(node, struct tcp_conn_s, lnode);
+      if (tcp_reuseport_member(listener, conn))
+        {
+          n++;
+        }
+    }
+
+  n = HASH(key, 16) % n;
+  hashtable_for_every_possible(tcp_listenports, node,
+                               (uint32_t)listener->lport)
+    {
+      conn = container_of(node, struct tcp_conn_s, lnode);
+      if (tcp_reuseport_member(listener, conn) && n-- == 0)
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -160,15 +315,17 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR hash_node_t *node;
   int ret = -EINVAL;
 
   net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  hashtable_for_every_possible(tcp_listenports, node,
+                               (uint32_t)conn->lport)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (node == &conn->lnode)
         {
-          tcp_listenports[ndx] = NULL;
+          hashtable_delete(tcp_listenports, node, (uint32_t)conn->lport);
+          tcp_nlisteners--;
           ret = OK;
           break;
         }
@@ -191,7 +348,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s *listener;
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -200,41 +357,44 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * The listeners of a SO_REUSEPORT group share it.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_findlistener(&conn->u, conn->lport, conn->domain);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_findlistener(&conn->u, conn->lport);
 #endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (listener != NULL &&
+      _SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT) &&
+      _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      listener = NULL;
+    }
+#endif
+
+  if (listener != NULL)
     {
       /* Yes, then we must refuse this request */
 
       ret = -EADDRINUSE;
     }
+  else if (tcp_nlisteners >= CONFIG_NET_MAX_LISTENPORTS)
+    {
+      ret = -ENOBUFS;
+    }
   else
     {
       /* Otherwise, save a reference to the connection structure in the
-       * "listener" list.
+       * "listener" table.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-        {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
-        }
+      hashtable_add(tcp_listenports, &conn->lnode, (uint32_t)conn->lport);
+      tcp_nlisteners++;
+      ret = OK;
     }
 
   net_unlock();
@@ -294,6 +454,11 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #endif
   if (listener != NULL)
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      listener = tcp_reuseport_listener(listener, tcp_conn_raddr(conn),
+                                        conn->rport);
+#endif
+
       /* Yes, there is a listener.  Is it accepting connections now? */
 
       if (listener->accept)
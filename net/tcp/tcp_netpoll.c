@@ -265,6 +265,7 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   if ((fds->events & POLLOUT) != 0)
     {
       cb->flags |= TCP_POLL;
+      tcp_txready(conn);
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS)
       cb->flags |= TCP_ACKDATA;
 #endif
@@ -354,6 +355,15 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* A completion notification is waiting on the error queue */
+
+  if (tcp_zerocopy_pending(conn))
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check if any requested events are already in effect */
 
   poll_notify(&fds, 1, eventset);
@@ -44,6 +44,7 @@
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 #include "socket/socket.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Types
@@ -223,11 +224,59 @@ static inline uint16_t tcp_newdata(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: tcp_readahead_detach
+ *
+ * Description:
+ *   Remove the whole I/O buffers at the head of the read-ahead data that
+ *   fit into len bytes from the connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINE_LOCK
+static FAR struct iob_s *tcp_readahead_detach(FAR struct tcp_conn_s *conn,
+                                              size_t len)
+{
+  FAR struct iob_s *head = conn->readahead;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  unsigned int pktlen = 0;
+
+  for (iob = head; iob != NULL && pktlen + iob->io_len <= len;
+       iob = iob->io_flink)
+    {
+      pktlen += iob->io_len;
+      tail    = iob;
+    }
+
+  if (tail == NULL)
+    {
+      return NULL;
+    }
+
+  conn->readahead = tail->io_flink;
+  if (conn->readahead != NULL)
+    {
+      conn->readahead->io_pktlen = head->io_pktlen - pktlen;
+    }
+
+  tail->io_flink  = NULL;
+  head->io_pktlen = pktlen;
+  return head;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_readahead
  *
  * Description:
- *   Copy the read-ahead data from the packet
+ *   Copy the read-ahead data from the packet.  With CONFIG_NET_FINE_LOCK
+ *   the whole I/O buffers are taken from the connection and copied with
+ *   only the connection locked, so that the network is not held for the
+ *   bulk of the copy.
  *
  * Input Parameters:
  *   pstate   recvfrom state structure
@@ -245,6 +294,36 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
   FAR struct tcp_conn_s *conn = pstate->ir_conn;
   FAR struct iob_s *iob;
   int recvlen;
+#ifdef CONFIG_NET_FINE_LOCK
+  unsigned int count;
+
+  if (conn->readahead != NULL && pstate->ir_buflen > 0 &&
+      (pstate->ir_flags & MSG_PEEK) == 0 && net_breaklock(&count) >= 0)
+    {
+      conn_lock(&conn->sconn);
+
+      net_lock();
+      iob = tcp_readahead_detach(conn, pstate->ir_buflen);
+      net_unlock();
+
+      if (iob != NULL)
+        {
+          recvlen = iob_copyout(pstate->ir_buffer, iob, iob->io_pktlen, 0);
+          ninfo("Received %d bytes unlocked\n", recvlen);
+
+          tcp_update_recvlen(pstate, recvlen);
+          iob_free_chain(iob);
+        }
+
+      /* The rest is copied with the network locked.  Other readers of the
+       * connection cannot take their data before it, they need the network
+       * to take it from the connection.
+       */
+
+      net_restorelock(count);
+      conn_unlock(&conn->sconn);
+    }
+#endif
 
   /* Check there is any TCP data already buffered in a read-ahead
    * buffer.
@@ -839,6 +918,7 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
 
   if (tcp_should_send_recvwindow(conn))
     {
+      tcp_txready(conn);
       netdev_txnotify_dev(conn->dev);
     }
 
@@ -883,6 +963,18 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   net_lock();
 
   conn = psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The error queue only holds the MSG_ZEROCOPY completions */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      ret = tcp_zerocopy_recverr(psock, msg);
+      net_unlock();
+      return ret;
+    }
+#endif
+
   for (i = 0; i < msg->msg_iovlen; i++)
     {
       FAR void *buf = msg->msg_iov[i].iov_base;
@@ -149,7 +149,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (!tcp_timer_pending(conn) && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -200,11 +200,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                   IPv6_HDRLEN);
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv6.sent++;
+      NETSTATS.ipv6.sent++;
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -224,18 +225,18 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.ipv4.sent++;
+      NETSTATS.ipv4.sent++;
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
 
   ninfo("Outgoing TCP packet length: %d bytes\n", dev->d_len);
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.tcp.sent++;
+  NETSTATS.tcp.sent++;
 #endif
 
 #if !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
@@ -298,11 +299,33 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   dev->d_len = len;
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
+  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) &&
+      (conn->nofosegs > 0 || (conn->flags & TCP_DSACK) != 0))
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      struct tcp_sack_s sacks[TCP_SACK_RANGES_MAX];
+      int nsacks = 0;
+      int optlen;
       int i;
 
+      /* A D-SACK block goes first (RFC 2883), the out-of-order segments
+       * fill the rest of the option.
+       */
+
+      if ((conn->flags & TCP_DSACK) != 0)
+        {
+          sacks[nsacks++] = conn->dsack;
+          conn->flags &= ~TCP_DSACK;
+        }
+
+      for (i = 0; i < conn->nofosegs && nsacks < TCP_SACK_RANGES_MAX; i++)
+        {
+          sacks[nsacks].left  = conn->ofosegs[i].left;
+          sacks[nsacks].right = conn->ofosegs[i].right;
+          nsacks++;
+        }
+
+      optlen = nsacks * sizeof(struct tcp_sack_s);
+
       tcp->optdata[0] = TCP_OPT_NOOP;
       tcp->optdata[1] = TCP_OPT_NOOP;
       tcp->optdata[2] = TCP_OPT_SACK;
@@ -310,16 +333,16 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       optlen += 4;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-                conn->ofosegs[i].left, conn->ofosegs[i].right,
-                TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
+                sacks[i].left, sacks[i].right,
+                TCP_SEQ_SUB(sacks[i].right, sacks[i].left));
           tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
-                          conn->ofosegs[i].left);
+                          sacks[i].left);
           tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
-                          conn->ofosegs[i].right);
+                          sacks[i].right);
         }
 
       dev->d_len += optlen;
@@ -346,14 +369,14 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   if ((flags & TCP_PSH) != 0)
     {
-      if ((g_netstats.tcp.sent %
+      if ((NETSTATS.tcp.sent %
           CONFIG_NET_TCP_DEBUG_DROP_SEND_PROBABILITY) == 0)
         {
           uint32_t seq = tcp_getsequence(tcp->seqno);
 
           ninfo("TCP DROP SNDPKT: "
                 "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
-                g_netstats.tcp.sent, seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
+                NETSTATS.tcp.sent, seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
                 dev->d_sndlen);
 
           dev->d_len = 0;
@@ -393,7 +416,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.tcp.rst++;
+  NETSTATS.tcp.rst++;
 #endif
 
   /* TCP setup */
@@ -503,7 +526,8 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                   IPv6_HDRLEN);
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +547,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -657,6 +681,15 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  if (tcp->flags == (TCP_ACK | TCP_SYN) && (conn->flags & TCP_TFOCOOKIE))
+    {
+      tcp->optdata[optlen++] = TCP_OPT_NOOP;
+      tcp->optdata[optlen++] = TCP_OPT_NOOP;
+      optlen += tcp_fastopen_option(conn, &tcp->optdata[optlen]);
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -665,6 +698,135 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp_sendcommon(dev, conn, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_synack_cookie
+ *
+ * Description:
+ *   Turn the SYN in the device buffer into a SYN-ACK with the sequence
+ *   number 'isn' and the MSS option 'mss'.  Like tcp_reset(), the response
+ *   is built from the received packet alone; only the MSS option is sent
+ *   because no state is kept to remember the other options.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received SYN
+ *   listener - The listening connection (for the TTL and TOS)
+ *   isn      - The SYN cookie used as initial sequence number
+ *   mss      - The MSS to advertise
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_cookie(FAR struct net_driver_s *dev,
+                       FAR struct tcp_conn_s *listener,
+                       uint32_t isn, uint16_t mss)
+{
+  FAR struct tcp_hdr_s *tcp;
+  uint32_t recvwndo;
+  uint16_t tmp16;
+
+  if (dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  tcp = tcp_header(dev);
+
+  /* Acknowledge the SYN only; any data it carried is dropped and will be
+   * retransmitted by the peer once the connection exists.
+   */
+
+  tcp_setsequence(tcp->ackno, tcp_getsequence(tcp->seqno) + 1);
+  tcp_setsequence(tcp->seqno, isn);
+
+  /* Swap port numbers. */
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  tcp->flags     = TCP_SYN | TCP_ACK;
+  tcp->tcpoffset = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = mss >> 8;
+  tcp->optdata[3] = mss & 0xff;
+
+  /* Window scaling is not negotiated, so the window must fit 16 bits */
+
+  recvwndo = tcp_get_recvwindow(dev, listener);
+  if (recvwndo > UINT16_MAX)
+    {
+      recvwndo = UINT16_MAX;
+    }
+
+  tcp->wnd[0]  = recvwndo >> 8;
+  tcp->wnd[1]  = recvwndo & 0xff;
+  tcp->urgp[0] = 0;
+  tcp->urgp[1] = 0;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      net_ipv6addr_t laddr;
+      net_ipv6addr_t raddr;
+
+      net_ipv6addr_copy(laddr, ipv6->destipaddr);
+      net_ipv6addr_copy(raddr, ipv6->srcipaddr);
+
+      dev->d_len = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN, IP_PROTO_TCP,
+                        laddr, raddr, listener->sconn.s_ttl,
+                        listener->sconn.s_tclass);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                   IPv6_HDRLEN);
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      in_addr_t laddr = net_ip4addr_conv32(ipv4->destipaddr);
+      in_addr_t raddr = net_ip4addr_conv32(ipv4->srcipaddr);
+
+      dev->d_len = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+      ipv4_build_header(ipv4, dev->d_len, IP_PROTO_TCP, &laddr, &raddr,
+                        listener->sconn.s_ttl, listener->sconn.s_tos,
+                        NULL);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_STATISTICS
+  NETSTATS.tcp.sent++;
+#endif
+}
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
+
 /****************************************************************************
  * Name: tcp_send_txnotify
  *
@@ -684,6 +846,8 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_send_txnotify(FAR struct socket *psock,
                        FAR struct tcp_conn_s *conn)
 {
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
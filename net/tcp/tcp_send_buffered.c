@@ -172,6 +172,28 @@ static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 #  define psock_writebuffer_notify(conn)
 #endif
 
+/****************************************************************************
+ * Name: psock_wrbuffer_release
+ *
+ * Description:
+ *   Release a write buffer that was removed from the queues of the
+ *   connection and complete the MSG_ZEROCOPY send it finishes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+static void psock_wrbuffer_release(FAR struct tcp_conn_s *conn,
+                                   FAR struct tcp_wrbuffer_s *wrb)
+{
+  uint32_t zcend = TCP_WBZCEND(wrb);
+
+  tcp_wrbuffer_release(wrb);
+  tcp_zerocopy_done(conn, zcend);
+}
+#else
+#  define psock_wrbuffer_release(conn, wrb) tcp_wrbuffer_release(wrb)
+#endif
+
 static void retransmit_segment(FAR struct tcp_conn_s *conn,
                                FAR struct tcp_wrbuffer_s *wrb)
 {
@@ -184,7 +206,7 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
 
       /* Return the write buffer to the free list */
 
-      tcp_wrbuffer_release(wrb);
+      psock_wrbuffer_release(conn, wrb);
 
       /* Notify any waiters if the write buffers have been
        * drained.
@@ -302,6 +324,12 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
   sq_init(&conn->unacked_q);
   sq_init(&conn->write_q);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The user data of the finished MSG_ZEROCOPY sends is no longer used */
+
+  tcp_zerocopy_done(conn, conn->zc_next);
+#endif
+
   /* Notify any waiters if the write buffers have been drained. */
 
   psock_writebuffer_notify(conn);
@@ -371,6 +399,11 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
           nsack = (*(tcp->optdata + 1 + i) -
                    TCP_OPT_SACK_PERM_LEN) /
                    (sizeof(uint32_t) * 2);
+          if (nsack > TCP_SACK_RANGES_MAX)
+            {
+              nsack = TCP_SACK_RANGES_MAX;
+            }
+
           sacks = (FAR struct tcp_sack_s *)
                   (tcp->optdata + i +
                    TCP_OPT_SACK_PERM_LEN);
@@ -409,6 +442,223 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 
   return nsack;
 }
+
+/****************************************************************************
+ * Name: psock_sack_update
+ *
+ * Description:
+ *   Update the SACK scoreboard (RFC 6675) with the blocks of an incoming
+ *   ACK.  The scoreboard is kept per write buffer:  A write buffer of the
+ *   unacked_q is marked as SACKed once one block covers all of it.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   segs   - The SACK blocks
+ *   nsacks - The number of SACK blocks
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void psock_sack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_ofoseg_s *segs, int nsacks)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t lastseq;
+  int i;
+
+  for (i = 0; i < nsacks; i++)
+    {
+      ninfo("TCP SACK [%d]"
+            "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
+            i, segs[i].left, segs[i].right,
+            TCP_SEQ_SUB(segs[i].right, segs[i].left));
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if ((TCP_WBSACK(wrb) & TCP_WBSACK_SACKED) != 0)
+        {
+          continue;
+        }
+
+      lastseq = TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(lastseq, segs[i].right))
+            {
+              TCP_WBSACK(wrb) |= TCP_WBSACK_SACKED;
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: psock_sack_lost
+ *
+ * Description:
+ *   Return the first write buffer of the unacked_q that is lost by the
+ *   rules of RFC 6675 (IsLost()) and was not retransmitted in the current
+ *   recovery yet.  A write buffer is lost if more than (DupThresh - 1) *
+ *   SMSS bytes or DupThresh write buffers above it have been SACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The write buffer to retransmit, NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_wrbuffer_s *
+psock_sack_lost(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t sacked = 0;
+  int nsacked = 0;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if ((TCP_WBSACK(wrb) & TCP_WBSACK_SACKED) != 0)
+        {
+          sacked += TCP_WBPKTLEN(wrb);
+          nsacked++;
+        }
+    }
+
+  /* What is SACKed above a write buffer only shrinks along the queue, so
+   * the search ends at the first write buffer that is not lost.
+   */
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if ((TCP_WBSACK(wrb) & TCP_WBSACK_SACKED) != 0)
+        {
+          sacked -= TCP_WBPKTLEN(wrb);
+          nsacked--;
+          continue;
+        }
+
+      if (nsacked < TCP_FAST_RETRANSMISSION_THRESH &&
+          sacked <= (TCP_FAST_RETRANSMISSION_THRESH - 1) * conn->mss)
+        {
+          break;
+        }
+
+      if ((TCP_WBSACK(wrb) & TCP_WBSACK_REXMIT) == 0)
+        {
+          return wrb;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: psock_sack_recovery
+ *
+ * Description:
+ *   Run the SACK based loss recovery (RFC 6675) for an incoming ACK:  Enter
+ *   the recovery on DupThresh duplicate ACKs or once the segment at the
+ *   cumulative ACK is lost, leave it when everything that was outstanding
+ *   at the start is ACKed and in between retransmit one lost write buffer
+ *   per ACK.  Retransmitting only as ACKs arrive keeps the number of
+ *   segments in flight about constant, as the pipe estimate of the RFC
+ *   does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackno  - The cumulative ACK
+ *   dupack - DupThresh duplicate ACKs have been received
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void psock_sack_recovery(FAR struct tcp_conn_s *conn,
+                                uint32_t ackno, bool dupack)
+{
+  FAR struct tcp_wrbuffer_s *head;
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+
+  if ((conn->flags & TCP_INSR) != 0 &&
+      TCP_SEQ_GTE(ackno, conn->sack_recover))
+    {
+      ninfo("SACK: recovery done at %" PRIu32 "\n", ackno);
+      conn->flags &= ~TCP_INSR;
+    }
+
+  head = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (head == NULL)
+    {
+      return;
+    }
+
+  wrb = psock_sack_lost(conn);
+  if ((conn->flags & TCP_INSR) == 0)
+    {
+      if (!dupack && wrb != head)
+        {
+          return;
+        }
+
+      ninfo("SACK: recovery from %" PRIu32 " to %" PRIu32 "\n",
+            ackno, conn->sndseq_max);
+
+      conn->flags |= TCP_INSR;
+      conn->sack_recover = conn->sndseq_max;
+
+      for (entry = &head->wb_node; entry; entry = sq_next(entry))
+        {
+          TCP_WBSACK((FAR struct tcp_wrbuffer_s *)entry) &=
+            ~TCP_WBSACK_REXMIT;
+        }
+
+      /* The segment at the cumulative ACK is the first to retransmit even
+       * if the SACK blocks do not yet tell that it is lost.
+       */
+
+      if ((TCP_WBSACK(head) & TCP_WBSACK_SACKED) == 0)
+        {
+          wrb = head;
+        }
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      /* Reduce the congestion window as for the fast retransmission */
+
+      if (conn->flags & TCP_INFT)
+        {
+          tcp_cc_update(conn, NULL);
+        }
+#endif
+    }
+
+  if (wrb != NULL)
+    {
+      ninfo("TCP REXMIT "
+            "[%" PRIu32 " : %" PRIu32 " : %d]\n",
+            TCP_WBSEQNO(wrb),
+            TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
+            TCP_WBPKTLEN(wrb));
+
+      TCP_WBSACK(wrb) |= TCP_WBSACK_REXMIT;
+      sq_rem(&wrb->wb_node, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+    }
+}
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
 /****************************************************************************
@@ -435,10 +685,6 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                                         FAR void *pvpriv, uint16_t flags)
 {
   FAR struct tcp_conn_s *conn = pvpriv;
-#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
-  uint8_t nsacks = 0;
-#endif
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   uint32_t rexmitno = 0;
 #endif
@@ -481,6 +727,11 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR sq_entry_t *entry;
       FAR sq_entry_t *next;
       uint32_t ackno;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      struct tcp_ofoseg_s sacks[TCP_SACK_RANGES_MAX];
+      bool sackopt = false;
+      bool dupack = false;
+#endif
 
       /* Get the offset address of the TCP header */
 
@@ -507,6 +758,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%04x\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Record the SACK blocks of every ACK in the scoreboard */
+
+      if ((conn->flags & TCP_SACK) != 0 && (tcp->tcpoffset & 0xf0) > 0x50)
+        {
+          sackopt = true;
+          psock_sack_update(conn, sacks, parse_sack(conn, tcp, sacks));
+        }
+#endif
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -550,7 +811,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                    * buffers
                    */
 
-                  tcp_wrbuffer_release(wrb);
+                  psock_wrbuffer_release(conn, wrb);
 
                   /* Notify any waiters if the write buffers have been
                    * drained.
@@ -609,19 +870,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                       TCP_WBNACK(wrb) = 0;
                       conn->timeout = true;
+                      tcp_txready(conn);
                       netdev_txnotify_dev(conn->dev);
                       return flags;
                     }
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-                  if ((conn->flags & TCP_SACK) &&
-                      (tcp->tcpoffset & 0xf0) > 0x50)
+                  if (sackopt)
                     {
-                      /* Parse s-ack from tcp options */
-
-                      nsacks = parse_sack(conn, tcp, ofosegs);
+                      /* Recover by the SACK scoreboard below */
 
-                      flags |= TCP_REXMIT;
+                      dupack = true;
                     }
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
                   else
@@ -680,6 +939,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      if (sackopt || (conn->flags & TCP_INSR) != 0)
+        {
+          psock_sack_recovery(conn, ackno, dupack);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -801,70 +1067,6 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     }
 #endif
 
-#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-
-  /* Check if we are being asked to retransmit s-ack data */
-
-  if (nsacks > 0)
-    {
-      FAR struct tcp_wrbuffer_s *wrb;
-      FAR sq_entry_t *entry;
-      FAR sq_entry_t *next;
-      uint32_t right;
-      int i;
-
-      /* Dump s-ack edge */
-
-      for (i = 0, right = 0; i < nsacks; i++)
-        {
-          ninfo("TCP SACK [%d]"
-                "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
-                i, ofosegs[i].left, ofosegs[i].right,
-                TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
-        }
-
-      for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
-        {
-          wrb  = (FAR struct tcp_wrbuffer_s *)entry;
-          next = sq_next(entry);
-
-          for (i = 0, right = 0; i < nsacks; i++)
-            {
-              /* Wrb seqno out of s-ack edge ? do retransmit ! */
-
-              if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
-                  TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
-                {
-                  ninfo("TCP REXMIT "
-                        "[%" PRIu32 " : %" PRIu32 " : %d]\n",
-                        TCP_WBSEQNO(wrb),
-                        TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
-                        TCP_WBPKTLEN(wrb));
-                  sq_rem(entry, &conn->unacked_q);
-                  retransmit_segment(conn, (FAR void *)entry);
-                  break;
-                }
-
-              right = ofosegs[i].right;
-            }
-        }
-
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
-          /* After Fast retransmitted, set ssthresh to the maximum of
-           * the unacked and the 2*SMSS, and enter to Fast Recovery.
-           * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
-           * cwnd=ssthresh + 3*SMSS  referring to rfc5681
-           */
-
-          if (conn->flags & TCP_INFT)
-            {
-              tcp_cc_update(conn, NULL);
-            }
-#endif
-    }
-  else
-#endif
-
   /* Check if we are being asked to retransmit data */
 
   if ((flags & TCP_REXMIT) != 0)
@@ -902,7 +1104,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
               /* And return the write buffer to the free list */
 
-              tcp_wrbuffer_release(wrb);
+              psock_wrbuffer_release(conn, wrb);
 
               /* Notify any waiters if the write buffers have been
                * drained.
@@ -960,8 +1162,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
        * write_q so they can be resent as soon as possible.
        */
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* The scoreboard is not trusted after a timeout (RFC 2018) */
+
+      conn->flags &= ~TCP_INSR;
+#endif
+
       while ((entry = sq_remlast(&conn->unacked_q)) != NULL)
         {
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+          TCP_WBSACK((FAR struct tcp_wrbuffer_s *)entry) = 0;
+#endif
           retransmit_segment(conn, (FAR void *)entry);
         }
     }
@@ -1037,12 +1248,25 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          size_t maxlen = conn->mss;
           int ret;
 
+#ifdef CONFIG_NETDEV_GSO
+          /* A device that segments large sends takes as many full sized
+           * segments as fit in its super-segment at once.
+           */
+
+          if (dev->d_gsomax > tcpip_hdrsize(conn) + 2 * conn->mss)
+            {
+              maxlen = (dev->d_gsomax - tcpip_hdrsize(conn)) /
+                       conn->mss * conn->mss;
+            }
+#endif
+
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1061,12 +1285,34 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            * the maximum size packet that would fit.
            */
 
+#ifdef CONFIG_NETDEV_GSO
+          /* The software segmentation copies the super-segment once more,
+           * fall back to a single segment if the IOBs will not do for
+           * both copies.
+           */
+
+          if (sndlen > conn->mss &&
+              sndlen > iob_navail(false) * CONFIG_IOB_BUFSIZE / 2)
+            {
+              sndlen = conn->mss;
+            }
+#endif
+
           if (sndlen > iob_navail(false) * CONFIG_IOB_BUFSIZE)
             {
               nwarn("Running low on iobs, limiting packet size\n");
               sndlen = CONFIG_IOB_BUFSIZE;
             }
 
+#ifdef CONFIG_NET_TCP_PACING
+          /* Wait for the pacing timer if the segment is not due yet */
+
+          if (!tcp_cc_pace(conn))
+            {
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p seq=%" PRIu32 " pktlen=%u sent=%u sndlen=%zu "
                 "mss=%u snd_wnd=%" PRIu32 " seq=%" PRIu32
                 " remaining_snd_wnd=%" PRIu32 "\n",
@@ -1106,10 +1352,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          if (sndlen > conn->mss)
+            {
+              dev->d_gsosize = conn->mss;
+            }
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gsosize = 0;
+#endif
               return flags;
             }
 
@@ -1121,6 +1377,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
+#ifdef CONFIG_NET_TCP_PACING
+          tcp_cc_paced(conn, sndlen);
+#endif
 
           /* Below prediction will become true,
            * unless retransmission occurrence
@@ -1249,6 +1508,25 @@ static unsigned int tcp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: psock_zerocopy_finish
+ *
+ * Description:
+ *   Count a MSG_ZEROCOPY send that queued some data.  It completes right
+ *   away if all of its write buffers are already released.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+static void psock_zerocopy_finish(FAR struct tcp_conn_s *conn)
+{
+  net_lock();
+  conn->zc_next++;
+  tcp_zerocopy_done(conn, conn->zc_next);
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1318,6 +1596,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  bool       zerocopy;
+#endif
   int        ret = OK;
   clock_t    start;
 
@@ -1373,6 +1654,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                             (flags & MSG_DONTWAIT) != 0;
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  zerocopy = (flags & MSG_ZEROCOPY) != 0 && conn->zerocopy;
+#endif
 
   /* Dump the incoming buffer */
 
@@ -1385,6 +1669,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       unsigned int off;
       size_t chunk_len = len;
       ssize_t chunk_result;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      bool zcchunk;
+#endif
 
       net_lock();
 
@@ -1484,6 +1771,19 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           max_wrb_size = tcp_max_wrb_size(conn);
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          /* Chunks of at least one MSS of a MSG_ZEROCOPY send are
+           * referenced in a write buffer of their own, the rest is copied.
+           */
+
+          zcchunk = zerocopy && chunk_len >= conn->mss;
+          if (zcchunk)
+            {
+              wrb = NULL;
+            }
+#endif
+
           if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
               (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
@@ -1546,7 +1846,44 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          if (zcchunk)
+            {
+              chunk_result = tcp_zerocopy_attach(wrb, cp, chunk_len);
+            }
+          else
+#endif
+#ifdef CONFIG_NET_FINE_LOCK
+          if (off == 0)
+            {
+              unsigned int count;
+              int blresult;
+
+              /* A new write buffer is not known to anyone else yet, fill
+               * it without the network lock.
+               */
+
+              blresult = net_breaklock(&count);
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+              if (blresult >= 0)
+                {
+                  net_restorelock(count);
+                }
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: Lost the connection while copying\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+            }
+          else
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1618,6 +1955,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
       TCP_WBDUMP("I/O buffer chain", wrb, TCP_WBPKTLEN(wrb), 0);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      /* The send is complete once no write buffer holds its data */
+
+      if (zerocopy)
+        {
+          TCP_WBZCEND(wrb) = conn->zc_next + 1;
+        }
+#endif
+
       /* psock_send_eventhandler() will send data in FIFO order from the
        * conn->write_q
        */
@@ -1671,6 +2017,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       goto errout;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zerocopy)
+    {
+      psock_zerocopy_finish(conn);
+    }
+#endif
+
   /* Return the number of bytes actually sent */
 
   return result;
@@ -1681,6 +2034,13 @@ errout_with_lock:
 errout:
   if (result > 0)
     {
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      if (zerocopy)
+        {
+          psock_zerocopy_finish(conn);
+        }
+#endif
+
       return result;
     }
 
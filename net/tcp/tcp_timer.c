@@ -73,11 +73,40 @@
  *
  * NOTE:  We only have 0.5 timing resolution here so the delay will be
  * between 0.5 and 1.0 seconds, and may be delayed further, depending on the
- * polling rate of the the driver (often 1 second).
+ * polling rate of the the driver (often 1 second).  The delayed ACK timer
+ * (CONFIG_NET_TCP_DELAYED_ACK_MS) normally sends the ACK well before that.
  */
 
 #define ACK_DELAY (1)
 
+/* The system clock ticks covered by a slot of the timing wheel */
+
+#define TCP_WHEEL_TICKS \
+  (MSEC2TICK(CONFIG_NET_TCP_WHEEL_MSEC) > 0 ? \
+   MSEC2TICK(CONFIG_NET_TCP_WHEEL_MSEC) : 1)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_wheel_expiry(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The timing wheel.  A timer is in the slot (slot % CONFIG_NET_TCP_WHEEL_
+ * SLOTS), where slot is the first wheel slot starting at or after its
+ * expiry time, so all of the timers found in a slot that was reached are
+ * due, except those that are one or more turns of the wheel further away.
+ */
+
+static dq_queue_t g_tcp_wheel[CONFIG_NET_TCP_WHEEL_SLOTS];
+static struct work_s g_tcp_wheel_work;
+static clock_t g_tcp_wheel_pos;  /* The next slot to be handled */
+static clock_t g_tcp_wheel_due;  /* When the wheel work is queued for */
+static unsigned int g_tcp_wheel_count;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -123,11 +152,235 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
 }
 
 /****************************************************************************
- * Name: tcp_timer_expiry
+ * Name: tcp_wtimer_expiry
  *
  * Description:
- *   Handle a TCP timer expiration for the provided TCP connection
- *   Restart a TCP timer if need to
+ *   Handle the expiry of a timer of a TCP connection: mark the connection
+ *   and poll it for TX.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_wtimer_expiry(FAR struct tcp_wtimer_s *timer)
+{
+  FAR struct tcp_conn_s *conn;
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  if (timer->kind == TCP_WTIMER_ACK)
+    {
+      conn = container_of(timer, struct tcp_conn_s, ackwtimer);
+      conn->rx_ackdue = true;
+    }
+  else
+#endif
+    {
+      conn = container_of(timer, struct tcp_conn_s, wtimer);
+      conn->timeout = true;
+    }
+
+  tcp_txready(conn);
+  netdev_txnotify_dev(conn->dev);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_schedule
+ *
+ * Description:
+ *   Queue the wheel work for the slot 'slot', unless it is already queued
+ *   for an earlier one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_schedule(clock_t slot)
+{
+  clock_t due = slot * TCP_WHEEL_TICKS;
+  sclock_t delay;
+
+  if (!work_available(&g_tcp_wheel_work) &&
+      (sclock_t)(due - g_tcp_wheel_due) >= 0)
+    {
+      return;
+    }
+
+  delay = due - clock_systime_ticks();
+  g_tcp_wheel_due = due;
+  work_queue(LPWORK, &g_tcp_wheel_work, tcp_wheel_expiry, NULL,
+             delay > 0 ? delay : 0);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_expiry
+ *
+ * Description:
+ *   Handle all of the slots of the timing wheel reached since the last
+ *   run, expiring their due timers in one hold of the network lock, and
+ *   queue the next run for the next slot holding a timer.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_expiry(FAR void *arg)
+{
+  FAR struct tcp_wtimer_s *timer;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  FAR dq_queue_t *wheel;
+  clock_t now;
+  clock_t n;
+  clock_t i;
+
+  net_lock();
+
+  now = clock_systime_ticks() / TCP_WHEEL_TICKS;
+  n   = now - g_tcp_wheel_pos + 1;
+  if ((sclock_t)n <= 0)
+    {
+      n = 0;
+    }
+  else if (n > CONFIG_NET_TCP_WHEEL_SLOTS)
+    {
+      n = CONFIG_NET_TCP_WHEEL_SLOTS;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      wheel = &g_tcp_wheel[(g_tcp_wheel_pos + i) %
+                           CONFIG_NET_TCP_WHEEL_SLOTS];
+
+      for (entry = dq_peek(wheel); entry != NULL; entry = next)
+        {
+          next  = dq_next(entry);
+          timer = (FAR struct tcp_wtimer_s *)entry;
+
+          if ((sclock_t)(timer->slot - now) <= 0)
+            {
+              dq_rem(entry, wheel);
+              timer->armed = false;
+              g_tcp_wheel_count--;
+              tcp_wtimer_expiry(timer);
+            }
+        }
+    }
+
+  if ((sclock_t)n > 0)
+    {
+      g_tcp_wheel_pos = now + 1;
+    }
+
+  /* Find the next slot holding a timer */
+
+  if (g_tcp_wheel_count > 0)
+    {
+      for (i = 0; i < CONFIG_NET_TCP_WHEEL_SLOTS; i++)
+        {
+          if (!dq_empty(&g_tcp_wheel[(g_tcp_wheel_pos + i) %
+                                     CONFIG_NET_TCP_WHEEL_SLOTS]))
+            {
+              break;
+            }
+        }
+
+      tcp_wheel_schedule(g_tcp_wheel_pos + i);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_wtimer_cancel
+ *
+ * Description:
+ *   Take a timer off the timing wheel.  Queued work is left as it is, it
+ *   finds nothing to do if no other timer is due.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_wtimer_cancel(FAR struct tcp_wtimer_s *timer)
+{
+  if (timer->armed)
+    {
+      dq_rem(&timer->node,
+             &g_tcp_wheel[timer->slot % CONFIG_NET_TCP_WHEEL_SLOTS]);
+      timer->armed = false;
+      g_tcp_wheel_count--;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_wtimer_start
+ *
+ * Description:
+ *   (Re)start a timer to expire after 'ticks' system clock ticks.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_wtimer_start(FAR struct tcp_wtimer_s *timer, uint8_t kind,
+                             clock_t ticks)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t slot;
+
+  tcp_wtimer_cancel(timer);
+
+  /* An idle wheel restarts from the current slot */
+
+  if (g_tcp_wheel_count == 0 && work_available(&g_tcp_wheel_work))
+    {
+      g_tcp_wheel_pos = now / TCP_WHEEL_TICKS;
+    }
+
+  /* The first slot starting at or after the expiry, and not one that was
+   * already handled.
+   */
+
+  slot = (now + ticks + TCP_WHEEL_TICKS - 1) / TCP_WHEEL_TICKS;
+  if ((sclock_t)(slot - g_tcp_wheel_pos) < 0)
+    {
+      slot = g_tcp_wheel_pos;
+    }
+
+  timer->slot  = slot;
+  timer->kind  = kind;
+  timer->armed = true;
+  dq_addlast(&timer->node, &g_tcp_wheel[slot % CONFIG_NET_TCP_WHEEL_SLOTS]);
+  g_tcp_wheel_count++;
+
+  tcp_wheel_schedule(slot);
+}
+
+/****************************************************************************
+ * Name: tcp_wtimer_left
+ *
+ * Description:
+ *   Return the system clock ticks left before a running timer expires.
+ *
+ ****************************************************************************/
+
+static sclock_t tcp_wtimer_left(FAR struct tcp_wtimer_s *timer)
+{
+  sclock_t left = timer->slot * TCP_WHEEL_TICKS - clock_systime_ticks();
+
+  return left > 0 ? left : 0;
+}
+
+/****************************************************************************
+ * Name: tcp_pace_expiry
+ *
+ * Description:
+ *   Poll a paced TCP connection for TX data when its next segment is due.
  *
  * Input Parameters:
  *   arg - The TCP "connection" to poll for TX data
@@ -135,13 +388,10 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   arg is not NULL.
- *   The connection (arg) is bound to the polling device (dev).
- *
  ****************************************************************************/
 
-static void tcp_timer_expiry(FAR void *arg)
+#ifdef CONFIG_NET_TCP_PACING
+static void tcp_pace_expiry(FAR void *arg)
 {
   FAR struct tcp_conn_s *conn = NULL;
 
@@ -151,7 +401,7 @@ static void tcp_timer_expiry(FAR void *arg)
     {
       if (conn == arg)
         {
-          conn->timeout = true;
+          tcp_txready(conn);
           netdev_txnotify_dev(conn->dev);
           break;
         }
@@ -159,6 +409,7 @@ static void tcp_timer_expiry(FAR void *arg)
 
   net_unlock();
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -251,16 +502,16 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
-      if (work_available(&conn->work) ||
-          TICK2HSEC(work_timeleft(&conn->work)) != timeout)
+      if (!conn->wtimer.armed ||
+          TICK2HSEC(tcp_wtimer_left(&conn->wtimer)) != timeout)
         {
-          work_queue(LPWORK, &conn->work, tcp_timer_expiry,
-                     conn, HSEC2TICK(timeout));
+          tcp_wtimer_start(&conn->wtimer, TCP_WTIMER_RTO,
+                           HSEC2TICK(timeout));
         }
     }
   else
     {
-      work_cancel(LPWORK, &conn->work);
+      tcp_wtimer_cancel(&conn->wtimer);
     }
 }
 
@@ -338,8 +589,74 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
-  work_cancel(LPWORK, &conn->work);
+  tcp_wtimer_cancel(&conn->wtimer);
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  tcp_wtimer_cancel(&conn->ackwtimer);
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  work_cancel(LPWORK, &conn->pace);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_update_acktimer
+ *
+ * Description:
+ *   Start the delayed ACK timer of the provided TCP connection, unless it
+ *   is already running.  When it expires, the connection is polled and
+ *   the pending ACK is sent.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" with a delayed ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_update_acktimer(FAR struct tcp_conn_s *conn)
+{
+  if (!conn->ackwtimer.armed)
+    {
+      conn->rx_ackdue = false;
+      tcp_wtimer_start(&conn->ackwtimer, TCP_WTIMER_ACK,
+                       MSEC2TICK(CONFIG_NET_TCP_DELAYED_ACK_MS));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_update_pacetimer
+ *
+ * Description:
+ *   Poll the connection for TX data again when the pacing of the
+ *   congestion control lets the next segment go.
+ *
+ * Input Parameters:
+ *   conn  - The TCP "connection" to poll for TX data
+ *   ticks - The time to wait for
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+void tcp_update_pacetimer(FAR struct tcp_conn_s *conn, clock_t ticks)
+{
+  if (work_available(&conn->pace))
+    {
+      work_queue(LPWORK, &conn->pace, tcp_pace_expiry, conn, ticks);
+    }
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_set_zero_probe
@@ -592,7 +909,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                */
 
 #ifdef CONFIG_NET_STATISTICS
-              g_netstats.tcp.rexmit++;
+              NETSTATS.tcp.rexmit++;
 #endif
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
@@ -633,22 +950,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
-
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -788,7 +1090,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                * 0.5 seconds..."
                */
 
-              if (conn->rx_acktimer >= ACK_DELAY)
+              if (conn->rx_acktimer >= ACK_DELAY || conn->rx_ackdue)
                 {
                   /* Reset the delayed ACK state and send the ACK
                    * packet.
@@ -796,6 +1098,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
                   conn->rx_unackseg = 0;
                   conn->rx_acktimer = 0;
+                  conn->rx_ackdue   = false;
                   tcp_synack(dev, conn, TCP_ACK);
                   goto done;
                 }
@@ -192,6 +192,12 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
   TCP_WBNACK(wrb) = 0;
 #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The write buffer no longer holds data of a MSG_ZEROCOPY send */
+
+  TCP_WBZCEND(wrb) = 0;
+#endif
+
   /* Then free the write buffer structure */
 
   NET_BUFPOOL_FREE(g_wrbuffer, wrb);
@@ -0,0 +1,265 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest piece of user data referenced by one I/O buffer */
+
+#define TCP_ZEROCOPY_IOBSIZE  UINT16_MAX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_free
+ *
+ * Description:
+ *   The free callback of the I/O buffers referencing user data.  The memory
+ *   belongs to the user, who learns of its release by the completion
+ *   notification.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_free(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_queued
+ *
+ * Description:
+ *   Return true if a queued write buffer of the connection carries zcend.
+ *
+ ****************************************************************************/
+
+static bool tcp_zerocopy_queued(FAR sq_queue_t *queue, uint32_t zcend)
+{
+  FAR sq_entry_t *entry;
+
+  for (entry = sq_peek(queue); entry != NULL; entry = sq_next(entry))
+    {
+      if (TCP_WBZCEND((FAR struct tcp_wrbuffer_s *)entry) == zcend)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_notify
+ *
+ * Description:
+ *   Wake up the threads polling the connection for the error queue.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_notify(FAR struct tcp_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_NPOLLWAITERS; i++)
+    {
+      FAR struct tcp_poll_s *info = &conn->pollinfo[i];
+
+      if (info->conn != NULL && info->fds != NULL)
+        {
+          poll_notify(&info->fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_attach
+ *
+ * Description:
+ *   Add user data to a write buffer without copying it:  The data is
+ *   referenced by I/O buffers that point to the user memory.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_attach(FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const uint8_t *buf, size_t len)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  size_t done;
+  size_t n;
+
+  DEBUGASSERT(TCP_WBPKTLEN(wrb) == 0 && len > 0);
+
+  for (done = 0; done < len; done += n)
+    {
+      n   = MIN(len - done, TCP_ZEROCOPY_IOBSIZE);
+      iob = iob_alloc_with_data((FAR void *)(buf + done), n,
+                                tcp_zerocopy_free);
+      if (iob == NULL)
+        {
+          if (head != NULL)
+            {
+              iob_free_chain(head);
+            }
+
+          return -ENOMEM;
+        }
+
+      iob->io_len = n;
+      if (tail == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      tail = iob;
+    }
+
+  /* Replace the empty I/O buffer the write buffer was allocated with */
+
+  head->io_pktlen = len;
+  iob_free_chain(TCP_WBIOB(wrb));
+  TCP_WBIOB(wrb) = head;
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_done
+ *
+ * Description:
+ *   Complete the MSG_ZEROCOPY sends before zcend, unless a write buffer of
+ *   the connection still holds data of the last of them or the send is
+ *   still in progress.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_done(FAR struct tcp_conn_s *conn, uint32_t zcend)
+{
+  /* The write buffers are released in sequence order, so the sends are
+   * complete in the order they were made and the completions can be
+   * reported as a single range.
+   */
+
+  if (zcend == 0 || (int32_t)(zcend - conn->zc_next) > 0 ||
+      (int32_t)(zcend - conn->zc_done) <= 0)
+    {
+      return;
+    }
+
+  if (tcp_zerocopy_queued(&conn->unacked_q, zcend) ||
+      tcp_zerocopy_queued(&conn->write_q, zcend))
+    {
+      return;
+    }
+
+  conn->zc_done = zcend;
+  tcp_zerocopy_notify(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Read the pending completion notification from the error queue into a
+ *   control message.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  struct sock_extended_err serr;
+  int level = SOL_IP;
+  int type = IP_RECVERR;
+
+  if (!tcp_zerocopy_pending(conn))
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = SOL_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_info   = conn->zc_reported;
+  serr.ee_data   = conn->zc_done - 1;
+
+  /* The notification is consumed even if it does not fit, as in the
+   * other implementations.
+   */
+
+  conn->zc_reported = conn->zc_done;
+
+  msg->msg_flags |= MSG_ERRQUEUE;
+  if (cmsg_append(msg, level, type, &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+
+  return 0;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -70,6 +71,8 @@
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
+#define _UDP_FLAG_HASHED      (1 << 1) /* Bit 1:  In the connected hashtable */
+#define _UDP_FLAG_TXREADY     (1 << 2) /* Bit 2:  In the queue of the TX poll */
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
 
@@ -111,6 +114,13 @@ struct udp_conn_s
   /* UDP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+  hash_node_t pnode;      /* Bucket entry of the local ports */
+  hash_node_t cnode;      /* Bucket entry of the connected sockets */
+#ifdef CONFIG_NET_DEVPOLL_READY
+  dq_entry_t rnode;       /* Entry of the queue of the TX poll */
+#endif
+  uint32_t ckey;          /* The key that cnode is hashed by */
+  uint16_t hport;         /* The local port that pnode is hashed by */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
@@ -250,6 +260,31 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_rehash
+ *
+ * Description:
+ *   Update the hashtables that udp_active() looks up the connections in.
+ *   This must be called whenever the local port, the remote address or
+ *   port or the connection mode of a connection has changed.
+ *
+ ****************************************************************************/
+
+void udp_rehash(FAR struct udp_conn_s *conn);
+
+/****************************************************************************
+ * Name: udp_is_broadcast
+ *
+ * Description:
+ *   Check if the destination address of the received packet is a
+ *   broadcast/multicast address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BROADCAST
+bool udp_is_broadcast(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -263,6 +298,59 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_txready
+ *
+ * Description:
+ *   Add a connection that may have something to send to the queue of the
+ *   connections visited by the TX poll, if it is not there yet.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void udp_txready(FAR struct udp_conn_s *conn);
+#else
+#  define udp_txready(conn)
+#endif
+
+/****************************************************************************
+ * Name: udp_txidle
+ *
+ * Description:
+ *   Remove a connection that has nothing to send from the queue of the
+ *   TX poll.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void udp_txidle(FAR struct udp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: udp_nready / udp_nextready
+ *
+ * Description:
+ *   udp_nready() returns the number of connections in the queue of the TX
+ *   poll.  udp_nextready() moves the first of them to the end of the queue
+ *   and returns it, or returns NULL if the queue is empty:  Calling it
+ *   udp_nready() times visits each queued connection once.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+int udp_nready(void);
+FAR struct udp_conn_s *udp_nextready(void);
+#endif
+
 /****************************************************************************
  * Name: udp_select_port
  *
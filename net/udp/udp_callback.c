@@ -274,7 +274,7 @@ net_dataevent(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
      ninfo("Dropped %d bytes\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.udp.drop++;
+      NETSTATS.udp.drop++;
 #endif
     }
 
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/netconfig.h>
@@ -97,10 +98,124 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+/* The bound connections hashed by their local port, and the connections
+ * in connection mode with a remote address and port hashed by the remote
+ * address and both ports.
+ */
+
+static DECLARE_HASHTABLE(g_udp_port_hash, CONFIG_NET_UDP_HASH_BITS);
+static DECLARE_HASHTABLE(g_udp_conn_hash, CONFIG_NET_UDP_HASH_BITS);
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+/* The connections that may have something to send, the ones visited by the
+ * TX poll of the network devices.
+ */
+
+static dq_queue_t g_ready_udp_connections;
+static int g_nready_udp_connections;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_port_first
+ *
+ * Description:
+ *   Return the first bucket entry of the connections that may be bound to
+ *   a local port.
+ *
+ ****************************************************************************/
+
+static inline FAR hash_node_t *udp_port_first(uint16_t portno)
+{
+  return g_udp_port_hash[HASH((uint32_t)portno,
+                              hashtable_bits(g_udp_port_hash))].head;
+}
+
+/****************************************************************************
+ * Name: udp_ipv4_key and udp_ipv6_key
+ *
+ * Description:
+ *   Create the key of a connected socket from its remote address and its
+ *   local and remote ports (all in network byte order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t udp_ipv4_key(in_addr_t raddr, uint16_t lport,
+                                    uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t udp_ipv6_key(FAR const uint16_t *raddr,
+                                    uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_conn_key
+ *
+ * Description:
+ *   Return true and the key of the connection if it is in connection mode
+ *   with a remote address and port, i.e. it only receives the packets of
+ *   one peer.
+ *
+ ****************************************************************************/
+
+static bool udp_conn_key(FAR struct udp_conn_s *conn, FAR uint32_t *key)
+{
+  if (conn->lport == 0 || conn->rport == 0 ||
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      if (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY))
+        {
+          return false;
+        }
+
+      *key = udp_ipv4_key(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      if (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_unspecaddr))
+        {
+          return false;
+        }
+
+      *key = udp_ipv6_key(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return true;
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -113,6 +228,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: Likewise.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -123,21 +239,28 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
                                             uint16_t portno, sockopt_t opt)
 {
-  FAR struct udp_conn_s *conn = NULL;
+  FAR struct udp_conn_s *conn;
+  FAR hash_node_t *node;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure bound to the same port bucket */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  hashtable_for_every_possible(g_udp_port_hash, node, (uint32_t)portno)
     {
-      /* With SO_REUSEADDR set for both sockets, we do not need to check its
-       * address and port.
+      conn = container_of(node, struct udp_conn_s, pnode);
+
+      /* With SO_REUSEADDR or SO_REUSEPORT set for both sockets, we do not
+       * need to check its address and port.
        */
 
 #ifdef CONFIG_NET_SOCKOPTS
-      if (skip_reusable && _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR))
+      if ((skip_reusable &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR)) ||
+          (skip_reuseport &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT)))
         {
           continue;
         }
@@ -181,6 +304,160 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Return the socket of the SO_REUSEPORT group of an unconnected socket
+ *   that receives the datagrams of a peer.  The group is made of the
+ *   unconnected sockets with SO_REUSEPORT bound to the same address and
+ *   port, and the peers are spread between them by the hash of their
+ *   address and port.  As all sockets bound to a port share a bucket and
+ *   conn is the first of the group in it, the group follows conn.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reuseport_member(FAR struct udp_conn_s *conn,
+                                 FAR struct udp_conn_s *peer)
+{
+  if (peer->domain != conn->domain || peer->lport != conn->lport ||
+      _UDP_ISCONNECTMODE(peer->flags) ||
+      !_SO_GETOPT(peer->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(peer->u.ipv4.laddr, conn->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(peer->u.ipv6.laddr, conn->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+static FAR struct udp_conn_s *
+udp_reuseport_select(FAR struct udp_conn_s *conn, uint32_t key)
+{
+  FAR struct udp_conn_s *peer;
+  FAR hash_node_t *node;
+  uint32_t n = 0;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+  for (node = &conn->pnode; node != NULL; node = node->flink)
+    {
+      peer = container_of(node, struct udp_conn_s, pnode);
+      if (udp_reuseport_member(conn, peer))
+        {
+          n++;
+        }
+    }
+
+  n = HASH(key, 16) % n;
+  for (node = &conn->pnode; node != NULL; node = node->flink)
+    {
+      peer = container_of(node, struct udp_conn_s, pnode);
+      if (udp_reuseport_member(conn, peer) && n-- == 0)
+        {
+          break;
+        }
+    }
+
+  return peer;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
+/****************************************************************************
+ * Name: udp_ipv4_connected
+ *
+ * Description:
+ *   Find the connected socket of the sender of an IPv4 UDP packet.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static FAR struct udp_conn_s *
+udp_ipv4_connected(FAR struct ipv4_hdr_s *ip, FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *conn;
+  FAR hash_node_t *node;
+  in_addr_t srcipaddr = net_ip4addr_conv32(ip->srcipaddr);
+
+  hashtable_for_every_possible(g_udp_conn_hash, node,
+                               udp_ipv4_key(srcipaddr, udp->destport,
+                                            udp->srcport))
+    {
+      conn = container_of(node, struct udp_conn_s, cnode);
+      if (udp->destport == conn->lport && udp->srcport == conn->rport &&
+          net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr) &&
+          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)))
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: udp_ipv6_connected
+ *
+ * Description:
+ *   Find the connected socket of the sender of an IPv6 UDP packet.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static FAR struct udp_conn_s *
+udp_ipv6_connected(FAR struct ipv6_hdr_s *ip, FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *conn;
+  FAR hash_node_t *node;
+
+  hashtable_for_every_possible(g_udp_conn_hash, node,
+                               udp_ipv6_key(ip->srcipaddr, udp->destport,
+                                            udp->srcport))
+    {
+      conn = container_of(node, struct udp_conn_s, cnode);
+      if (udp->destport == conn->lport && udp->srcport == conn->rport &&
+          net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr) &&
+          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+           net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr)))
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -202,11 +479,44 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
+  FAR hash_node_t *node;
+#ifdef CONFIG_NET_SOCKOPTS
+  bool steer = false;
+#endif
+
+  if (conn == NULL)
+    {
+      /* Look for the connected socket of the sender first, unless the
+       * packet is for all sockets bound to the port and they are visited
+       * in turn.
+       */
+
+#ifdef CONFIG_NET_BROADCAST
+      if (!udp_is_broadcast(dev))
+#endif
+        {
+          conn = udp_ipv4_connected(ip, udp);
+          if (conn != NULL)
+            {
+              return conn;
+            }
 
-  conn = udp_nextconn(conn);
+#ifdef CONFIG_NET_SOCKOPTS
+          steer = true;
+#endif
+        }
+
+      node = udp_port_first(udp->destport);
+    }
+  else
+    {
+      node = conn->pnode.flink;
+    }
 
-  while (conn)
+  for (; node != NULL; node = node->flink)
     {
+      conn = container_of(node, struct udp_conn_s, pnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -296,31 +606,37 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure, or the one of its SO_REUSEPORT group that
+               * receives the datagrams of the sender.
                */
 
-              break;
+#ifdef CONFIG_NET_SOCKOPTS
+              if (steer)
+                {
+                  return udp_reuseport_select(conn,
+                    udp_ipv4_key(net_ip4addr_conv32(ip->srcipaddr),
+                                 udp->destport, udp->srcport));
+                }
+#endif
+
+              return conn;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -342,11 +658,44 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
                 FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR hash_node_t *node;
+#ifdef CONFIG_NET_SOCKOPTS
+  bool steer = false;
+#endif
+
+  if (conn == NULL)
+    {
+      /* Look for the connected socket of the sender first, unless the
+       * packet is for all sockets bound to the port and they are visited
+       * in turn.
+       */
+
+#ifdef CONFIG_NET_BROADCAST
+      if (!udp_is_broadcast(dev))
+#endif
+        {
+          conn = udp_ipv6_connected(ip, udp);
+          if (conn != NULL)
+            {
+              return conn;
+            }
+
+#ifdef CONFIG_NET_SOCKOPTS
+          steer = true;
+#endif
+        }
 
-  conn = udp_nextconn(conn);
+      node = udp_port_first(udp->destport);
+    }
+  else
+    {
+      node = conn->pnode.flink;
+    }
 
-  while (conn != NULL)
+  for (; node != NULL; node = node->flink)
     {
+      conn = container_of(node, struct udp_conn_s, pnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -436,31 +785,37 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure, or the one of its SO_REUSEPORT group that
+               * receives the datagrams of the sender.
                */
 
-              break;
+#ifdef CONFIG_NET_SOCKOPTS
+              if (steer)
+                {
+                  return udp_reuseport_select(conn,
+                    udp_ipv6_key(ip->srcipaddr, udp->destport,
+                                 udp->srcport));
+                }
+#endif
+
+              return conn;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -549,6 +904,8 @@ errout:
 
 void udp_initialize(void)
 {
+  hashtable_init(g_udp_port_hash);
+  hashtable_init(g_udp_conn_hash);
 }
 
 /****************************************************************************
@@ -574,12 +931,14 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
     {
       /* Make sure that the connection is marked as uninitialized */
 
+      conn_lock_init(&conn->sconn);
       conn->sconn.s_ttl = IP_TTL_DEFAULT;
       conn->flags       = 0;
 #if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
       conn->domain      = domain;
 #endif
       conn->lport       = 0;
+      conn->hport       = 0;
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcvbufs     = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -622,8 +981,21 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
-  nxmutex_lock(&g_free_lock);
+  /* Remove the connection from the hashtables and the queue of the TX
+   * poll.  This takes the network lock, so it must be done before the free
+   * list is locked.
+   */
+
   conn->lport = 0;
+  udp_rehash(conn);
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+  net_lock();
+  udp_txidle(conn);
+  net_unlock();
+#endif
+
+  nxmutex_lock(&g_free_lock);
 
   /* Remove the connection from the active list */
 
@@ -692,6 +1064,61 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_rehash
+ *
+ * Description:
+ *   Update the hashtables that udp_active() looks up the connections in.
+ *   This must be called whenever the local port, the remote address or
+ *   port or the connection mode of a connection has changed.
+ *
+ ****************************************************************************/
+
+void udp_rehash(FAR struct udp_conn_s *conn)
+{
+  uint32_t key = 0;
+  bool connected;
+
+  net_lock();
+
+  /* Move the connection to the bucket of its local port */
+
+  if (conn->hport != conn->lport)
+    {
+      if (conn->hport != 0)
+        {
+          hashtable_delete(g_udp_port_hash, &conn->pnode,
+                           (uint32_t)conn->hport);
+        }
+
+      conn->hport = conn->lport;
+      if (conn->hport != 0)
+        {
+          hashtable_add(g_udp_port_hash, &conn->pnode,
+                        (uint32_t)conn->hport);
+        }
+    }
+
+  /* And to the bucket of its peer if it is connected to one */
+
+  connected = udp_conn_key(conn, &key);
+  if ((conn->flags & _UDP_FLAG_HASHED) != 0 &&
+      (!connected || key != conn->ckey))
+    {
+      hashtable_delete(g_udp_conn_hash, &conn->cnode, conn->ckey);
+      conn->flags &= ~_UDP_FLAG_HASHED;
+    }
+
+  if (connected && (conn->flags & _UDP_FLAG_HASHED) == 0)
+    {
+      conn->ckey   = key;
+      conn->flags |= _UDP_FLAG_HASHED;
+      hashtable_add(g_udp_conn_hash, &conn->cnode, key);
+    }
+
+  net_unlock();
+}
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -715,6 +1142,83 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_txready
+ *
+ * Description:
+ *   Add a connection that may have something to send to the queue of the
+ *   connections visited by the TX poll, if it is not there yet.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVPOLL_READY
+void udp_txready(FAR struct udp_conn_s *conn)
+{
+  if ((conn->flags & _UDP_FLAG_TXREADY) == 0)
+    {
+      conn->flags |= _UDP_FLAG_TXREADY;
+      dq_addlast(&conn->rnode, &g_ready_udp_connections);
+      g_nready_udp_connections++;
+    }
+}
+
+/****************************************************************************
+ * Name: udp_txidle
+ *
+ * Description:
+ *   Remove a connection that has nothing to send from the queue of the
+ *   TX poll.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_txidle(FAR struct udp_conn_s *conn)
+{
+  if ((conn->flags & _UDP_FLAG_TXREADY) != 0)
+    {
+      conn->flags &= ~_UDP_FLAG_TXREADY;
+      dq_rem(&conn->rnode, &g_ready_udp_connections);
+      g_nready_udp_connections--;
+    }
+}
+
+/****************************************************************************
+ * Name: udp_nready / udp_nextready
+ *
+ * Description:
+ *   Return the number of the connections in the queue of the TX poll, and
+ *   move the first of them to the end of the queue and return it.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+int udp_nready(void)
+{
+  return g_nready_udp_connections;
+}
+
+FAR struct udp_conn_s *udp_nextready(void)
+{
+  FAR dq_entry_t *entry;
+
+  entry = dq_remfirst(&g_ready_udp_connections);
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  dq_addlast(entry, &g_ready_udp_connections);
+  return container_of(entry, struct udp_conn_s, rnode);
+}
+#endif /* CONFIG_NET_DEVPOLL_READY */
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -854,6 +1358,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           conn->lport = portno;
           ret         = OK;
+          udp_rehash(conn);
         }
     }
   else
@@ -879,6 +1384,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
           conn->lport = portno;
           ret         = OK;
+          udp_rehash(conn);
         }
       else
         {
@@ -1013,6 +1519,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 #endif /* CONFIG_NET_IPv6 */
     }
 
+  udp_rehash(conn);
   return OK;
 }
 
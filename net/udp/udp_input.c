@@ -64,53 +64,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: udp_is_broadcast
- *
- * Description:
- *   Check if the destination address is a broadcast/multicast address.
- *
- * Input Parameters:
- *   dev - The device driver structure containing the received UDP packet
- *
- * Returned Value:
- *   True if the destination address is a broadcast/multicast address
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_BROADCAST
-static bool udp_is_broadcast(FAR struct net_driver_s *dev)
-{
-  /* Check if the destination address is a broadcast/multicast address */
-
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-  if (IFF_IS_IPv4(dev->d_flags))
-#  endif
-    {
-      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
-      in_addr_t destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
-
-      return net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST) ||
-             IN_MULTICAST(NTOHL(destipaddr)) ||
-             (net_ipv4addr_maskcmp(destipaddr, dev->d_ipaddr, dev->d_netmask)
-              && net_ipv4addr_broadcast(destipaddr, dev->d_netmask));
-    }
-#endif
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-  else
-#  endif
-    {
-      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
-      return net_is_addr_mcast(ipv6->destipaddr);
-    }
-#endif
-
-  return false;
-}
-#endif
-
 /****************************************************************************
  * Name: udp_input_conn
  *
@@ -223,7 +176,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   /* Update the count of UDP packets received */
 
 #ifdef CONFIG_NET_STATISTICS
-  g_netstats.udp.recv++;
+  NETSTATS.udp.recv++;
 #endif
 
   /* Get a pointer to the UDP header.  The UDP header lies just after the
@@ -245,7 +198,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* A zero checksum field means no checksum, the device may have verified
+   * the checksum already.
+   */
+
+  chksum = netdev_csum_valid(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -270,8 +227,8 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.udp.drop++;
-      g_netstats.udp.chkerr++;
+      NETSTATS.udp.drop++;
+      NETSTATS.udp.chkerr++;
 #endif
       nwarn("WARNING: Bad UDP checksum\n");
       dev->d_len = 0;
@@ -387,6 +344,53 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_is_broadcast
+ *
+ * Description:
+ *   Check if the destination address is a broadcast/multicast address.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received UDP packet
+ *
+ * Returned Value:
+ *   True if the destination address is a broadcast/multicast address
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BROADCAST
+bool udp_is_broadcast(FAR struct net_driver_s *dev)
+{
+  /* Check if the destination address is a broadcast/multicast address */
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv4(dev->d_flags))
+#  endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      in_addr_t destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+
+      return net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST) ||
+             IN_MULTICAST(NTOHL(destipaddr)) ||
+             (net_ipv4addr_maskcmp(destipaddr, dev->d_ipaddr, dev->d_netmask)
+              && net_ipv4addr_broadcast(destipaddr, dev->d_netmask));
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      return net_is_addr_mcast(ipv6->destipaddr);
+    }
+#endif
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_ipv4_input
  *
@@ -195,6 +195,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   if ((fds->events & POLLOUT) != 0)
     {
       cb->flags |= UDP_POLL;
+      udp_txready(conn);
     }
 
   if ((fds->events & POLLIN) != 0)
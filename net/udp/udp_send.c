@@ -190,7 +190,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
                             conn->sconn.s_tos, NULL);
 
 #ifdef CONFIG_NET_STATISTICS
-          g_netstats.ipv4.sent++;
+          NETSTATS.ipv4.sent++;
 #endif
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -231,7 +231,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           dev->d_len       += IPv6_HDRLEN;
 
 #ifdef CONFIG_NET_STATISTICS
-          g_netstats.ipv6.sent++;
+          NETSTATS.ipv6.sent++;
 #endif
         }
 #endif /* CONFIG_NET_IPv6 */
@@ -255,7 +255,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       if (IFF_IS_IPv4(dev->d_flags))
 #endif
         {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
+          udp->udpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_UDP);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -264,7 +264,8 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       else
 #endif
         {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
+          udp->udpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_UDP,
+                                                     IPv6_HDRLEN);
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -277,7 +278,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       ninfo("Outgoing UDP packet length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
-      g_netstats.udp.sent++;
+      NETSTATS.udp.sent++;
 #endif
 
 #ifdef CONFIG_NET_SOCKOPTS
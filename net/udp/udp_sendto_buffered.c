@@ -264,6 +264,8 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_rehash(conn);
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -340,6 +342,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
 
   /* Notify the device driver of the availability of TX data */
 
+  udp_txready(conn);
   netdev_txnotify_dev(dev);
   return OK;
 }
@@ -819,8 +822,24 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       if (nonblock)
         {
+#ifdef CONFIG_NET_FINE_LOCK
+          unsigned int count;
+          int blresult;
+
+          /* The write buffer is not queued yet, fill it without the network
+           * lock.
+           */
+
+          blresult = net_breaklock(&count);
+#endif
           ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
                               len, udpiplen, false);
+#ifdef CONFIG_NET_FINE_LOCK
+          if (blresult >= 0)
+            {
+              net_restorelock(count);
+            }
+#endif
         }
       else
         {
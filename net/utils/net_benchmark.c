@@ -0,0 +1,543 @@
+/****************************************************************************
+ * net/utils/net_benchmark.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/benchmark.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NET_BENCH_BUFSIZE \
+  MAX(CONFIG_NET_BENCHMARK_CHUNK, CONFIG_NET_BENCHMARK_UDP_SIZE)
+
+/* How long the UDP server waits for a datagram that may have been lost */
+
+#define NET_BENCH_UDP_TIMEOUT 1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state shared by the client and the server thread */
+
+struct net_bench_s
+{
+  struct socket listener;     /* The socket the server listens on */
+  sem_t done;                 /* Posted when the server thread ends */
+  int n;                      /* Connections or datagrams to serve */
+  size_t size;                /* Size of the echoed messages */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct net_bench_s g_net_bench;
+static uint8_t g_net_bench_txbuf[NET_BENCH_BUFSIZE];
+static uint8_t g_net_bench_rxbuf[NET_BENCH_BUFSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_bench_addr
+ ****************************************************************************/
+
+static void net_bench_addr(FAR struct sockaddr_in *addr)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(CONFIG_NET_BENCHMARK_PORT);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+
+/****************************************************************************
+ * Name: net_bench_server
+ *
+ * Description:
+ *   Open the server socket and start the server thread.  The thread runs
+ *   at the priority of the caller, whose CPU affinity it inherits.
+ *
+ ****************************************************************************/
+
+static int net_bench_server(int type, FAR const char *name, main_t entry)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct sockaddr_in addr;
+  int value = 1;
+  int ret;
+
+  ret = psock_socket(PF_INET, type, 0, &ctx->listener);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  psock_setsockopt(&ctx->listener, SOL_SOCKET, SO_REUSEADDR, &value,
+                   sizeof(value));
+
+  net_bench_addr(&addr);
+  ret = psock_bind(&ctx->listener, (FAR struct sockaddr *)&addr,
+                   sizeof(addr));
+  if (ret >= 0 && type == SOCK_STREAM)
+    {
+      ret = psock_listen(&ctx->listener, 1);
+    }
+
+  if (ret >= 0)
+    {
+      nxsem_init(&ctx->done, 0, 0);
+      ret = kthread_create(name, nxsched_self()->sched_priority,
+                           CONFIG_SCHED_BENCHMARK_STACKSIZE, entry, NULL);
+      if (ret < 0)
+        {
+          nxsem_destroy(&ctx->done);
+        }
+    }
+
+  if (ret < 0)
+    {
+      psock_close(&ctx->listener);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: net_bench_finish
+ *
+ * Description:
+ *   Wait for the server thread and close the server socket.  If the client
+ *   failed, the server is woken up first.
+ *
+ ****************************************************************************/
+
+static void net_bench_finish(int ret)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+
+  if (ret < 0)
+    {
+      psock_shutdown(&ctx->listener, SHUT_RDWR);
+    }
+
+  nxsem_wait_uninterruptible(&ctx->done);
+  nxsem_destroy(&ctx->done);
+  psock_close(&ctx->listener);
+}
+
+/****************************************************************************
+ * Name: net_bench_connect
+ ****************************************************************************/
+
+static int net_bench_connect(FAR struct socket *psock, int type)
+{
+  struct sockaddr_in addr;
+  int ret;
+
+  ret = psock_socket(PF_INET, type, 0, psock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  net_bench_addr(&addr);
+  ret = psock_connect(psock, (FAR struct sockaddr *)&addr, sizeof(addr));
+  if (ret < 0)
+    {
+      psock_close(psock);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_NET_TCP
+/****************************************************************************
+ * Name: net_bench_send
+ *
+ * Description:
+ *   Send all of a buffer on a stream socket.
+ *
+ ****************************************************************************/
+
+static int net_bench_send(FAR struct socket *psock,
+                          FAR const uint8_t *buf, size_t len)
+{
+  ssize_t nbytes;
+
+  while (len > 0)
+    {
+      nbytes = psock_send(psock, buf, len, 0);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      buf += nbytes;
+      len -= nbytes;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: net_bench_sink
+ *
+ * Description:
+ *   Server thread: accept one connection and discard all it receives, or
+ *   echo it back if ctx->size is not zero.
+ *
+ ****************************************************************************/
+
+static int net_bench_sink(int argc, FAR char *argv[])
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket conn;
+  ssize_t nbytes;
+  int ret;
+
+  memset(&conn, 0, sizeof(conn));
+  ret = psock_accept(&ctx->listener, NULL, NULL, &conn, 0);
+  if (ret >= 0)
+    {
+      do
+        {
+          nbytes = psock_recv(&conn, g_net_bench_rxbuf,
+                              ctx->size > 0 ? ctx->size :
+                              sizeof(g_net_bench_rxbuf), 0);
+          if (nbytes > 0 && ctx->size > 0)
+            {
+              ret = net_bench_send(&conn, g_net_bench_rxbuf, nbytes);
+            }
+        }
+      while (nbytes > 0 && ret >= 0);
+
+      psock_close(&conn);
+    }
+
+  nxsem_post(&ctx->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: net_bench_acceptor
+ *
+ * Description:
+ *   Server thread: accept and close ctx->n connections.
+ *
+ ****************************************************************************/
+
+static int net_bench_acceptor(int argc, FAR char *argv[])
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket conn;
+  int i;
+
+  for (i = 0; i < ctx->n; i++)
+    {
+      memset(&conn, 0, sizeof(conn));
+      if (psock_accept(&ctx->listener, NULL, NULL, &conn, 0) < 0)
+        {
+          break;
+        }
+
+      psock_close(&conn);
+    }
+
+  nxsem_post(&ctx->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: net_bench_stream
+ *
+ * Description:
+ *   Send chunks of a bulk transfer until n samples are taken, either of
+ *   the chunks or, if lock is true, of the network lock hold times.
+ *
+ ****************************************************************************/
+
+static int net_bench_stream(FAR clock_t *samples, int n, bool lock)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket sock;
+  clock_t start;
+  int ret;
+  int i;
+
+  ctx->size = 0;
+  ret = net_bench_server(SOCK_STREAM, "bench_sink", net_bench_sink);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = net_bench_connect(&sock, SOCK_STREAM);
+  if (ret >= 0)
+    {
+      if (lock)
+        {
+          net_lock_sample(samples, n);
+        }
+
+      for (i = 0; lock ? net_lock_nsamples() < n : i < n; i++)
+        {
+          start = perf_gettime();
+          ret = net_bench_send(&sock, g_net_bench_txbuf,
+                               CONFIG_NET_BENCHMARK_CHUNK);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (!lock)
+            {
+              samples[i] = perf_gettime() - start;
+            }
+        }
+
+      if (lock)
+        {
+          net_lock_sample(NULL, 0);
+        }
+
+      psock_close(&sock);
+    }
+
+  net_bench_finish(ret);
+  return ret;
+}
+#endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_UDP
+/****************************************************************************
+ * Name: net_bench_udp_sink
+ *
+ * Description:
+ *   Server thread: receive up to ctx->n datagrams, and stop when none
+ *   comes for a while, as datagrams may be lost.
+ *
+ ****************************************************************************/
+
+static int net_bench_udp_sink(int argc, FAR char *argv[])
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct timeval tv;
+  int i;
+
+  tv.tv_sec  = NET_BENCH_UDP_TIMEOUT;
+  tv.tv_usec = 0;
+  psock_setsockopt(&ctx->listener, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                   sizeof(tv));
+
+  for (i = 0; i < ctx->n; i++)
+    {
+      if (psock_recv(&ctx->listener, g_net_bench_rxbuf,
+                     sizeof(g_net_bench_rxbuf), 0) < 0)
+        {
+          nwarn("WARNING: %d of %d datagrams received\n", i, ctx->n);
+          break;
+        }
+    }
+
+  nxsem_post(&ctx->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+/****************************************************************************
+ * Name: net_bench_tcp_stream
+ ****************************************************************************/
+
+int net_bench_tcp_stream(FAR clock_t *samples, int n)
+{
+  return net_bench_stream(samples, n, false);
+}
+
+/****************************************************************************
+ * Name: net_bench_netlock
+ ****************************************************************************/
+
+int net_bench_netlock(FAR clock_t *samples, int n)
+{
+  return net_bench_stream(samples, n, true);
+}
+
+/****************************************************************************
+ * Name: net_bench_tcp_rr
+ ****************************************************************************/
+
+int net_bench_tcp_rr(FAR clock_t *samples, int n)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket sock;
+  clock_t start;
+  ssize_t nbytes;
+  int ret;
+  int i;
+
+  ctx->size = 1;
+  ret = net_bench_server(SOCK_STREAM, "bench_echo", net_bench_sink);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = net_bench_connect(&sock, SOCK_STREAM);
+  if (ret >= 0)
+    {
+      for (i = 0; i < n; i++)
+        {
+          start = perf_gettime();
+          ret = net_bench_send(&sock, g_net_bench_txbuf, 1);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nbytes = psock_recv(&sock, g_net_bench_txbuf, 1, 0);
+          if (nbytes <= 0)
+            {
+              ret = nbytes < 0 ? nbytes : -ECONNRESET;
+              break;
+            }
+
+          samples[i] = perf_gettime() - start;
+        }
+
+      psock_close(&sock);
+    }
+
+  net_bench_finish(ret);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: net_bench_tcp_connect
+ ****************************************************************************/
+
+int net_bench_tcp_connect(FAR clock_t *samples, int n)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket sock;
+  clock_t start;
+  int ret;
+  int i;
+
+  ctx->n = n;
+  ret = net_bench_server(SOCK_STREAM, "bench_accept", net_bench_acceptor);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      start = perf_gettime();
+      ret = net_bench_connect(&sock, SOCK_STREAM);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      samples[i] = perf_gettime() - start;
+      psock_close(&sock);
+    }
+
+  net_bench_finish(ret);
+  return ret;
+}
+#endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_UDP
+/****************************************************************************
+ * Name: net_bench_udp
+ ****************************************************************************/
+
+int net_bench_udp(FAR clock_t *samples, int n)
+{
+  FAR struct net_bench_s *ctx = &g_net_bench;
+  struct socket sock;
+  clock_t start;
+  ssize_t nbytes;
+  int ret;
+  int i;
+
+  ctx->n = n;
+  ret = net_bench_server(SOCK_DGRAM, "bench_udp", net_bench_udp_sink);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = net_bench_connect(&sock, SOCK_DGRAM);
+  if (ret >= 0)
+    {
+      for (i = 0; i < n; i++)
+        {
+          start  = perf_gettime();
+          nbytes = psock_send(&sock, g_net_bench_txbuf,
+                              CONFIG_NET_BENCHMARK_UDP_SIZE, 0);
+          if (nbytes < 0)
+            {
+              ret = nbytes;
+              break;
+            }
+
+          samples[i] = perf_gettime() - start;
+        }
+
+      psock_close(&sock);
+    }
+
+  net_bench_finish(ret);
+  return ret;
+}
+#endif /* CONFIG_NET_UDP */
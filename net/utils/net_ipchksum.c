@@ -35,6 +35,50 @@
 
 #ifdef CONFIG_NET
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+#  define IS_SUPERSEG(dev) ((dev)->d_gsosize > 0)
+#else
+#  define IS_SUPERSEG(dev) false
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_partial
+ *
+ * Description:
+ *   Check if the device completes the checksum of the outgoing packet in
+ *   d_iob and set the flags of the packet accordingly.  A packet that has
+ *   to be fragmented keeps its full checksum, the device does not see a
+ *   TCP or UDP packet in the fragments.  A TCP super-segment is cut into
+ *   segments that fit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+static bool upperlayer_partial(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+
+  if ((dev->d_csumcaps & NETDEV_CSUM_PARTIAL) != 0 &&
+      (IS_SUPERSEG(dev) ||
+       iob->io_pktlen <= NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev)))
+    {
+      iob->io_flags |= NETDEV_CSUM_PARTIAL;
+      return true;
+    }
+
+  iob->io_flags &= ~NETDEV_CSUM_PARTIAL;
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -153,6 +197,38 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   return (sum == 0) ? 0xffff : HTONS(sum);
 }
+
+/****************************************************************************
+ * Name: ipv4_upperlayer_txchksum
+ *
+ * Description:
+ *   Get the checksum field of an outgoing packet with a zero checksum
+ *   field:  The complement of the checksum over the IPv4 pseudo-header,
+ *   the protocol header and the payload, or only the sum of the
+ *   pseudo-header if the device completes the checksum.
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *
+ * Returned Value:
+ *   The value of the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+uint16_t ipv4_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto)
+{
+  if (upperlayer_partial(dev))
+    {
+      return HTONS(ipv4_upperlayer_header_chksum(dev, proto));
+    }
+
+  return ~ipv4_upperlayer_chksum(dev, proto);
+}
+#endif
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 #if !defined(CONFIG_NET_ARCH_CHKSUM) && \
@@ -274,6 +350,38 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   return (sum == 0) ? 0xffff : HTONS(sum);
 }
+
+/****************************************************************************
+ * Name: ipv6_upperlayer_txchksum
+ *
+ * Description:
+ *   The same as ipv4_upperlayer_txchksum() for IPv6.
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *   iplen - The size of the IPv6 header.  This may be larger than
+ *           IPv6_HDRLEN the IPv6 header if IPv6 extension headers are
+ *           present.
+ *
+ * Returned Value:
+ *   The value of the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+uint16_t ipv6_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto, unsigned int iplen)
+{
+  if (upperlayer_partial(dev))
+    {
+      return HTONS(ipv6_upperlayer_header_chksum(dev, proto, iplen));
+    }
+
+  return ~ipv6_upperlayer_chksum(dev, proto, iplen);
+}
+#endif
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
@@ -54,10 +54,58 @@
 
 static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
 
+#ifdef CONFIG_NET_BENCHMARK
+/* The hold times being recorded, see net_lock_sample() */
+
+static FAR clock_t *g_netlock_samples;
+static int g_netlock_nsamples;
+static int g_netlock_index;
+static clock_t g_netlock_acquired;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_lock_acquired / net_lock_record / net_lock_release
+ *
+ * Description:
+ *   Time the outermost hold of the network lock, while it is recorded.
+ *   Both are called with the lock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCHMARK
+static void net_lock_acquired(void)
+{
+  if (g_netlock_samples != NULL && g_netlock.count == 1)
+    {
+      g_netlock_acquired = perf_gettime();
+    }
+}
+
+static void net_lock_record(void)
+{
+  if (g_netlock_samples != NULL && g_netlock_index < g_netlock_nsamples)
+    {
+      g_netlock_samples[g_netlock_index++] =
+        perf_gettime() - g_netlock_acquired;
+    }
+}
+
+static void net_lock_release(void)
+{
+  if (g_netlock.count == 1)
+    {
+      net_lock_record();
+    }
+}
+#else
+#  define net_lock_acquired()
+#  define net_lock_release()
+#endif
+
 /****************************************************************************
  * Name: _net_timedwait
  ****************************************************************************/
@@ -135,7 +183,14 @@ _net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
 
 int net_lock(void)
 {
-  return nxrmutex_lock(&g_netlock);
+  int ret = nxrmutex_lock(&g_netlock);
+
+  if (ret >= 0)
+    {
+      net_lock_acquired();
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -157,7 +212,14 @@ int net_lock(void)
 
 int net_trylock(void)
 {
-  return nxrmutex_trylock(&g_netlock);
+  int ret = nxrmutex_trylock(&g_netlock);
+
+  if (ret >= 0)
+    {
+      net_lock_acquired();
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -176,6 +238,7 @@ int net_trylock(void)
 
 void net_unlock(void)
 {
+  net_lock_release();
   nxrmutex_unlock(&g_netlock);
 }
 
@@ -191,6 +254,16 @@ void net_unlock(void)
 int net_breaklock(FAR unsigned int *count)
 {
   DEBUGASSERT(count != NULL);
+
+#ifdef CONFIG_NET_BENCHMARK
+  /* The whole hold ends here, whatever the count */
+
+  if (nxrmutex_is_hold(&g_netlock))
+    {
+      net_lock_record();
+    }
+#endif
+
   return nxrmutex_breaklock(&g_netlock, count);
 }
 
@@ -208,9 +281,56 @@ int net_breaklock(FAR unsigned int *count)
 
 int net_restorelock(unsigned int count)
 {
-  return nxrmutex_restorelock(&g_netlock, count);
+  int ret = nxrmutex_restorelock(&g_netlock, count);
+
+#ifdef CONFIG_NET_BENCHMARK
+  if (ret >= 0 && g_netlock_samples != NULL)
+    {
+      g_netlock_acquired = perf_gettime();
+    }
+#endif
+
+  return ret;
 }
 
+/****************************************************************************
+ * Name: net_lock_sample
+ *
+ * Description:
+ *   Record the hold times of the network lock into samples, up to n of
+ *   them, or stop recording if samples is NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCHMARK
+void net_lock_sample(FAR clock_t *samples, int n)
+{
+  nxrmutex_lock(&g_netlock);
+
+  g_netlock_samples  = samples;
+  g_netlock_nsamples = n;
+  g_netlock_index    = 0;
+
+  /* If the caller holds the lock already, its hold counts from here */
+
+  g_netlock_acquired = perf_gettime();
+  nxrmutex_unlock(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_lock_nsamples
+ *
+ * Description:
+ *   Return the number of hold times recorded since net_lock_sample().
+ *
+ ****************************************************************************/
+
+int net_lock_nsamples(void)
+{
+  return g_netlock_index;
+}
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -84,6 +84,12 @@ void clock_timer(void);
 #  define clock_timer()
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_update()
+#endif
+
 /****************************************************************************
  * perf_init
  ****************************************************************************/
@@ -94,4 +100,8 @@ void perf_init(void);
 void cpuload_init(void);
 #endif
 
+#ifdef CONFIG_SCHED_PSI
+void psi_init(void);
+#endif
+
 #endif /* __SCHED_CLOCK_CLOCK_H */
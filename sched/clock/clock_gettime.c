@@ -182,3 +182,19 @@ int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
   nxclock_gettime(clock_id, tp);
   return OK;
 }
+
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   The clock_gettime() system call when the user-space clock_gettime()
+ *   reads the system clock from struct clock_vdso_s.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_VDSO
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  return clock_gettime(clock_id, tp);
+}
+#endif
@@ -237,6 +237,10 @@ void clock_initialize(void)
   cpuload_init();
 #endif
 
+#ifdef CONFIG_SCHED_PSI
+  psi_init();
+#endif
+
   sched_trace_end();
 }
 
@@ -101,6 +101,8 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 #else
   clock_timekeeping_set_wall_time(tp);
 #endif
+
+  clock_vdso_update();
 }
 
 /****************************************************************************
@@ -0,0 +1,89 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Publish the current CLOCK_MONOTONIC and CLOCK_REALTIME times to the
+ *   user-space copy of the system clock, if the user blob provides one.
+ *   This is called on each timer tick and when the time is set.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct clock_vdso_s *vdso = USERSPACE->us_vdso;
+  struct timespec monotonic;
+  struct timespec realtime;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  nxclock_gettime(CLOCK_MONOTONIC, &monotonic);
+  nxclock_gettime(CLOCK_REALTIME, &realtime);
+
+  vdso->seq++;
+  UP_DMB();
+
+  vdso->monotonic = monotonic;
+  vdso->realtime  = realtime;
+
+  UP_DMB();
+  vdso->seq++;
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
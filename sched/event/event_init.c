@@ -49,5 +49,6 @@
 void nxevent_init(FAR nxevent_t *event, nxevent_mask_t events)
 {
   event->events = events;
+  event->expect = 0;
   list_initialize(&event->list);
 }
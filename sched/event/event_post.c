@@ -85,6 +85,7 @@ static inline_function int nxevent_sem_post(FAR sem_t *sem)
 int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
                  nxevent_flags_t eflags)
 {
+  nxevent_mask_t waitmask = 0;
   nxevent_mask_t clear = 0;
   FAR nxevent_wait_t *wait;
   FAR nxevent_wait_t *tmp;
@@ -109,7 +110,9 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
       event->events |= events ? events : ~0;
     }
 
-  if (!list_is_empty(&event->list))
+  /* Only walk the waiters if some of them expect one of the events */
+
+  if ((event->events & event->expect) != 0)
     {
       postall = ((eflags & NXEVENT_POST_ALL) != 0);
 
@@ -122,6 +125,12 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
       list_for_every_entry_safe(&event->list, wait, tmp,
                                 nxevent_wait_t, node)
         {
+          if ((wait->expect & event->events) == 0)
+            {
+              waitmask |= wait->expect;
+              continue;
+            }
+
           waitall = ((wait->eflags & NXEVENT_WAIT_ALL) != 0);
 
           if ((!waitall && ((wait->expect & event->events) != 0)) ||
@@ -147,11 +156,20 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
 
               if (!postall && (event->events & ~clear) == 0)
                 {
+                  /* The waiters not visited keep their events */
+
+                  waitmask = event->expect;
                   break;
                 }
             }
+          else
+            {
+              waitmask |= wait->expect;
+            }
         }
 
+      event->expect = waitmask;
+
       if (clear)
         {
           event->events &= ~clear;
@@ -122,6 +122,7 @@ nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
       wait.eflags = eflags;
 
       list_add_tail(&event->list, &wait.node);
+      event->expect |= events;
 
       /* Wait for the event */
 
@@ -139,6 +140,15 @@ nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
       nxsem_destroy(&wait.sem);
       list_delete(&wait.node);
 
+      /* The expected events may include those of waiters that have left
+       * until the next post recomputes them.
+       */
+
+      if (list_is_empty(&event->list))
+        {
+          event->expect = 0;
+        }
+
       if (ret == 0)
         {
           events = wait.expect;
@@ -39,6 +39,7 @@
 
 #include "sched/sched.h"
 #include "group/group.h"
+#include "signal/signal.h"
 #include "tls/tls.h"
 
 /****************************************************************************
@@ -178,6 +179,17 @@ int group_initialize(FAR struct task_tcb_s *tcb, uint8_t ttype)
       return ret;
     }
 
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Allocate the pool of pending standard signals */
+
+  ret = nxsig_initialize_group(group);
+  if (ret < 0)
+    {
+      task_uninit_info(group);
+      return ret;
+    }
+#endif
+
   nxrmutex_init(&group->tg_mutex);
 
 #ifndef CONFIG_DISABLE_PTHREAD
@@ -29,6 +29,27 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Run one boot phase, recording its duration in the boot profile */
+
+#ifdef CONFIG_INITCALL_PROFILE
+#  define NX_BOOTPROF(name, phase) \
+     do \
+       { \
+         clock_t _start = perf_gettime(); \
+         phase; \
+         nx_bootprof_record(name, _start); \
+       } \
+     while (0)
+#else
+#  define NX_BOOTPROF(name, phase) phase
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -121,4 +142,27 @@ void nx_idle_trampoline(void);
 
 int nx_bringup(void);
 
+/****************************************************************************
+ * Name: nx_bootprof_record
+ *
+ * Description:
+ *   Record the time spent in a boot phase or initcall that was started at
+ *   'start', a perf_gettime() value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_PROFILE
+void nx_bootprof_record(FAR const char *name, clock_t start);
+
+/****************************************************************************
+ * Name: nx_bootprof_dump
+ *
+ * Description:
+ *   Print the boot profile to the syslog.
+ *
+ ****************************************************************************/
+
+void nx_bootprof_dump(void);
+#endif
+
 #endif /* __SCHED_INIT_INIT_H */
@@ -319,7 +319,11 @@ static inline void nx_start_application(void)
    * configured.
    */
 
-  board_late_initialize();
+  NX_BOOTPROF("board_late_initialize", board_late_initialize());
+#endif
+
+#ifdef CONFIG_INITCALL_PROFILE
+  nx_bootprof_dump();
 #endif
 
 #ifdef CONFIG_COREDUMP
@@ -0,0 +1,388 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <syslog.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/trace.h>
+
+#include "sched/sched.h"
+#include "init/init.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_INITCALL_NTHREADS
+#  define CONFIG_INITCALL_NTHREADS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The shared state of one nx_initcall() run */
+
+struct initcall_run_s
+{
+  FAR const struct initcall_s *calls; /* The initcall table */
+  uint32_t all;                       /* Bit mask of all entries */
+  uint32_t started;                   /* Entries taken by a thread */
+  uint32_t done;                      /* Entries that have completed */
+  int result;                         /* First error returned */
+  int nwaiters;                       /* Threads waiting in ready */
+  mutex_t lock;                       /* Protects the fields above */
+  sem_t ready;                        /* Posted when an entry completes */
+  sem_t exited;                       /* Posted by each exiting helper */
+};
+
+#ifdef CONFIG_INITCALL_PROFILE
+/* One boot profile record */
+
+struct bootprof_s
+{
+  FAR const char *name;               /* Phase or initcall name */
+  clock_t start;                      /* perf_gettime() at start */
+  clock_t elapsed;                    /* perf_gettime() ticks spent */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_PROFILE
+static struct bootprof_s g_bootprof[CONFIG_INITCALL_PROFILE_NENTRIES];
+static int g_bootprof_count;
+static spinlock_t g_bootprof_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_one
+ *
+ * Description:
+ *   Run and profile one initcall.
+ *
+ ****************************************************************************/
+
+static int initcall_one(FAR const struct initcall_s *call)
+{
+#ifdef CONFIG_INITCALL_PROFILE
+  clock_t start = perf_gettime();
+#endif
+  int ret;
+
+  trace_beginex(NOTE_TAG_DRIVERS, call->name);
+  ret = call->func();
+  trace_endex(NOTE_TAG_DRIVERS, call->name);
+
+#ifdef CONFIG_INITCALL_PROFILE
+  nx_bootprof_record(call->name, start);
+#endif
+
+  if (ret < 0)
+    {
+      serr("ERROR: initcall %s failed: %d\n", call->name, ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   Run the entries whose dependencies are complete until all of them have
+ *   been started.  Every thread taking part in a run executes this loop.
+ *
+ ****************************************************************************/
+
+static void initcall_worker(FAR struct initcall_run_s *run)
+{
+  uint32_t pending;
+  int ret;
+  int i;
+
+  nxmutex_lock(&run->lock);
+  while (run->started != run->all)
+    {
+      /* Look for an entry that is not started and whose dependencies have
+       * all completed.
+       */
+
+      pending = run->all & ~run->started;
+      for (i = 0; pending != 0; i++, pending >>= 1)
+        {
+          if ((pending & 1) != 0 &&
+              (run->calls[i].deps & ~run->done) == 0)
+            {
+              break;
+            }
+        }
+
+      if (pending == 0)
+        {
+          /* Nothing is ready.  If nothing is running either, the remaining
+           * entries depend on each other or on missing entries.
+           */
+
+          if (run->started == run->done)
+            {
+              serr("ERROR: initcall dependencies cannot be met: %08" PRIx32
+                   "\n", run->all & ~run->started);
+              run->result  = -EDEADLK;
+              run->started = run->all;
+              break;
+            }
+
+          run->nwaiters++;
+          nxmutex_unlock(&run->lock);
+          nxsem_wait_uninterruptible(&run->ready);
+          nxmutex_lock(&run->lock);
+          continue;
+        }
+
+      run->started |= 1 << i;
+      nxmutex_unlock(&run->lock);
+
+      ret = initcall_one(&run->calls[i]);
+
+      nxmutex_lock(&run->lock);
+      run->done |= 1 << i;
+      if (ret < 0 && run->result == OK)
+        {
+          run->result = ret;
+        }
+
+      /* Let the waiting threads look for newly ready entries */
+
+      while (run->nwaiters > 0)
+        {
+          run->nwaiters--;
+          nxsem_post(&run->ready);
+        }
+    }
+
+  /* Release the threads still waiting, there is nothing left to take */
+
+  while (run->nwaiters > 0)
+    {
+      run->nwaiters--;
+      nxsem_post(&run->ready);
+    }
+
+  nxmutex_unlock(&run->lock);
+}
+
+#if CONFIG_INITCALL_NTHREADS > 1
+/****************************************************************************
+ * Name: initcall_thread
+ *
+ * Description:
+ *   The helper threads of a parallel run.
+ *
+ ****************************************************************************/
+
+static int initcall_thread(int argc, FAR char *argv[])
+{
+  FAR struct initcall_run_s *run =
+    (FAR struct initcall_run_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  initcall_worker(run);
+  nxsem_post(&run->exited);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_initcall
+ *
+ * Description:
+ *   Run a table of initialization functions.  An entry is started once all
+ *   the entries named in its deps mask have completed; independent entries
+ *   run in parallel on up to CONFIG_INITCALL_NTHREADS threads, the caller
+ *   being one of them, so the run takes about as long as its slowest chain
+ *   of dependencies.  With one thread the entries run on the caller in a
+ *   dependency-respecting order.  A failed entry still counts as completed
+ *   for its dependents.
+ *
+ *   This must be called from a thread that can wait, for example from
+ *   board_late_initialize().
+ *
+ * Input Parameters:
+ *   calls  - The initcall table
+ *   ncalls - The number of entries, at most 32
+ *
+ * Returned Value:
+ *   Zero (OK) if every entry succeeded; otherwise the first negated errno
+ *   value returned by an entry, or -EDEADLK if the dependencies cannot be
+ *   met.
+ *
+ ****************************************************************************/
+
+int nx_initcall(FAR const struct initcall_s *calls, int ncalls)
+{
+  struct initcall_run_s run;
+#if CONFIG_INITCALL_NTHREADS > 1
+  FAR char *argv[2];
+  char arg1[32];
+  int nhelpers = 0;
+  int ret;
+#endif
+
+  DEBUGASSERT(calls != NULL && ncalls >= 0 && ncalls <= 32);
+
+  if (ncalls == 0)
+    {
+      return OK;
+    }
+
+  run.calls    = calls;
+  run.all      = ncalls == 32 ? UINT32_MAX : (1u << ncalls) - 1;
+  run.started  = 0;
+  run.done     = 0;
+  run.result   = OK;
+  run.nwaiters = 0;
+  nxmutex_init(&run.lock);
+  nxsem_init(&run.ready, 0, 0);
+  nxsem_init(&run.exited, 0, 0);
+
+#if CONFIG_INITCALL_NTHREADS > 1
+  snprintf(arg1, sizeof(arg1), "%p", &run);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  while (nhelpers < CONFIG_INITCALL_NTHREADS - 1 && nhelpers < ncalls - 1)
+    {
+      ret = kthread_create("initcall", this_task()->sched_priority,
+                           CONFIG_INITCALL_STACKSIZE, initcall_thread,
+                           argv);
+      if (ret < 0)
+        {
+          swarn("WARNING: Failed to create initcall thread: %d\n", ret);
+          break;
+        }
+
+      nhelpers++;
+    }
+#endif
+
+  initcall_worker(&run);
+
+#if CONFIG_INITCALL_NTHREADS > 1
+  /* Wait for the entries still running on the helpers */
+
+  while (nhelpers-- > 0)
+    {
+      nxsem_wait_uninterruptible(&run.exited);
+    }
+#endif
+
+  nxsem_destroy(&run.exited);
+  nxsem_destroy(&run.ready);
+  nxmutex_destroy(&run.lock);
+  return run.result;
+}
+
+#ifdef CONFIG_INITCALL_PROFILE
+/****************************************************************************
+ * Name: nx_bootprof_record
+ *
+ * Description:
+ *   Record the time spent in a boot phase or initcall that was started at
+ *   'start', a perf_gettime() value.
+ *
+ ****************************************************************************/
+
+void nx_bootprof_record(FAR const char *name, clock_t start)
+{
+  clock_t now = perf_gettime();
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_bootprof_lock);
+  if (g_bootprof_count < CONFIG_INITCALL_PROFILE_NENTRIES)
+    {
+      FAR struct bootprof_s *prof = &g_bootprof[g_bootprof_count++];
+
+      prof->name    = name;
+      prof->start   = start;
+      prof->elapsed = now - start;
+    }
+
+  spin_unlock_irqrestore(&g_bootprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: nx_bootprof_dump
+ *
+ * Description:
+ *   Print the boot profile: when each phase or initcall started and how
+ *   long it took, in microseconds.
+ *
+ ****************************************************************************/
+
+void nx_bootprof_dump(void)
+{
+  struct timespec start;
+  struct timespec elapsed;
+  int i;
+
+  syslog(LOG_INFO, "Boot profile:   start(us)  elapsed(us) name\n");
+  for (i = 0; i < g_bootprof_count; i++)
+    {
+      perf_convert(g_bootprof[i].start, &start);
+      perf_convert(g_bootprof[i].elapsed, &elapsed);
+
+      syslog(LOG_INFO, "Boot profile: %11" PRIu64 " %11" PRIu64 " %s\n",
+             (uint64_t)start.tv_sec * USEC_PER_SEC +
+             start.tv_nsec / NSEC_PER_USEC,
+             (uint64_t)elapsed.tv_sec * USEC_PER_SEC +
+             elapsed.tv_nsec / NSEC_PER_USEC,
+             g_bootprof[i].name);
+    }
+}
+#endif /* CONFIG_INITCALL_PROFILE */
@@ -40,6 +40,7 @@
 #include "group/group.h"
 #include "sched/sched.h"
 #include "init/init.h"
+#include "rcu/rcu.h"
 
 #ifdef CONFIG_SMP
 
@@ -87,6 +88,10 @@ void nx_idle_trampoline(void)
 
   for (; ; )
     {
+      /* Nothing can be inside of an RCU read-side critical section here */
+
+      nxrcu_quiescent();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -62,6 +62,8 @@
 #include "init/init.h"
 #include "instrument/instrument.h"
 #include "tls/tls.h"
+#include "wdog/wdog.h"
+#include "rcu/rcu.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -626,6 +628,10 @@ void nx_start(void)
 
   g_npidhash = i;
 
+  /* Initialize the allocator of the TCBs */
+
+  nxsched_tcb_initialize();
+
   /* IDLE Group Initialization **********************************************/
 
   idle_group_initialize();
@@ -652,6 +658,12 @@ void nx_start(void)
 
   irq_initialize();
 
+#ifdef CONFIG_WDOG_PERCPU
+  /* Initialize the per-CPU watchdog lists */
+
+  wd_initialize();
+#endif
+
   /* Initialize the POSIX timer facility (if included in the link) */
 
   clock_initialize();
@@ -690,11 +702,11 @@ void nx_start(void)
    * that are different for each  processor and hardware platform.
    */
 
-  up_initialize();
+  NX_BOOTPROF("up_initialize", up_initialize());
 
   /* Initialize common drivers */
 
-  drivers_initialize();
+  NX_BOOTPROF("drivers_initialize", drivers_initialize());
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -702,7 +714,7 @@ void nx_start(void)
    * that cannot wait until board_late_initialize.
    */
 
-  board_early_initialize();
+  NX_BOOTPROF("board_early_initialize", board_early_initialize());
 #endif
 
   /* Hardware resources are now available */
@@ -777,6 +789,10 @@ void nx_start(void)
 #ifndef CONFIG_DISABLE_IDLE_LOOP
   for (; ; )
     {
+      /* Nothing can be inside of an RCU read-side critical section here */
+
+      nxrcu_quiescent();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
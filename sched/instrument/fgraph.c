@@ -0,0 +1,339 @@
+/****************************************************************************
+ * sched/instrument/fgraph.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fgraph.h>
+#include <nuttx/instrument.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The ring of one CPU.  Only that CPU writes it, and the oldest records
+ * are overwritten.
+ */
+
+struct fgraph_ring_s
+{
+  uint32_t head;                 /* Records ever written                    */
+  struct fgraph_record_s record[CONFIG_SCHED_FGRAPH_NRECORDS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void fgraph_enter(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg) noinstrument_function;
+static void fgraph_leave(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg) noinstrument_function;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct instrument_s g_fgraph_instrument =
+{
+  .enter = fgraph_enter,
+  .leave = fgraph_leave
+};
+
+static bool g_fgraph_registered;
+static volatile bool g_fgraph_enabled;
+
+/* The filter set, searched only while it is not empty */
+
+static FAR void *g_fgraph_filter[CONFIG_SCHED_FGRAPH_FILTERS];
+static volatile int g_fgraph_nfilters;
+
+static struct fgraph_ring_s g_fgraph_ring[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fgraph_record
+ *
+ * Description:
+ *   Append a record to the ring of this CPU.  The caller holds
+ *   tcb->fgraph_busy, so an interrupt handler of this CPU that runs
+ *   meanwhile is not traced and cannot interleave its records.
+ *
+ ****************************************************************************/
+
+static void noinstrument_function
+fgraph_record(FAR struct tcb_s *tcb, FAR void *func, clock_t time,
+              clock_t duration, bool leave)
+{
+  FAR struct fgraph_ring_s *ring = &g_fgraph_ring[this_cpu()];
+  FAR struct fgraph_record_s *record;
+
+  record = &ring->record[ring->head % CONFIG_SCHED_FGRAPH_NRECORDS];
+  record->time     = time;
+  record->duration = duration;
+  record->func     = func;
+  record->pid      = tcb->pid;
+  record->depth    = tcb->fgraph_depth;
+  record->leave    = leave;
+  ring->head++;
+}
+
+/****************************************************************************
+ * Name: fgraph_filtered
+ *
+ * Description:
+ *   Return true if the function is in the filter set.
+ *
+ ****************************************************************************/
+
+static bool noinstrument_function fgraph_filtered(FAR void *func)
+{
+  int i;
+
+  for (i = 0; i < g_fgraph_nfilters; i++)
+    {
+      if (g_fgraph_filter[i] == func)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: fgraph_enter / fgraph_leave
+ *
+ * Description:
+ *   The hooks of the instrument framework.  The entry time of each call is
+ *   kept in the TCB, up to CONFIG_SCHED_FGRAPH_DEPTH nested calls, so that
+ *   the exit record holds the duration of the call.
+ *
+ ****************************************************************************/
+
+static void fgraph_enter(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg)
+{
+  FAR struct tcb_s *tcb;
+  clock_t now;
+
+  if (!g_fgraph_enabled)
+    {
+      return;
+    }
+
+  tcb = running_task();
+  if (tcb == NULL || tcb->fgraph_busy)
+    {
+      return;
+    }
+
+  tcb->fgraph_busy = true;
+
+  if (g_fgraph_nfilters > 0 && tcb->fgraph_filter == 0)
+    {
+      if (!fgraph_filtered(this_fn))
+        {
+          tcb->fgraph_busy = false;
+          return;
+        }
+
+      tcb->fgraph_filter = tcb->fgraph_depth + 1;
+    }
+
+  now = perf_gettime();
+  if (tcb->fgraph_depth < CONFIG_SCHED_FGRAPH_DEPTH)
+    {
+      tcb->fgraph_time[tcb->fgraph_depth] = now;
+    }
+
+  fgraph_record(tcb, this_fn, now, 0, false);
+  tcb->fgraph_depth++;
+  tcb->fgraph_busy = false;
+}
+
+static void fgraph_leave(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg)
+{
+  FAR struct tcb_s *tcb;
+  clock_t duration = 0;
+  clock_t now;
+
+  if (!g_fgraph_enabled)
+    {
+      return;
+    }
+
+  tcb = running_task();
+
+  /* The calls entered before the tracer started are not seen leaving */
+
+  if (tcb == NULL || tcb->fgraph_busy || tcb->fgraph_depth == 0)
+    {
+      return;
+    }
+
+  tcb->fgraph_busy = true;
+
+  now = perf_gettime();
+  tcb->fgraph_depth--;
+  if (tcb->fgraph_depth < CONFIG_SCHED_FGRAPH_DEPTH)
+    {
+      duration = now - tcb->fgraph_time[tcb->fgraph_depth];
+    }
+
+  fgraph_record(tcb, this_fn, now, duration, true);
+
+  if (tcb->fgraph_filter == tcb->fgraph_depth + 1)
+    {
+      tcb->fgraph_filter = 0;
+    }
+
+  tcb->fgraph_busy = false;
+}
+
+/****************************************************************************
+ * Name: fgraph_reset
+ *
+ * Description:
+ *   Forget the calls a thread was in when the tracer stopped.
+ *
+ ****************************************************************************/
+
+static void fgraph_reset(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  tcb->fgraph_depth  = 0;
+  tcb->fgraph_filter = 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fgraph_start
+ ****************************************************************************/
+
+void fgraph_start(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+
+  g_fgraph_enabled = false;
+  nxsched_foreach(fgraph_reset, NULL);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      g_fgraph_ring[i].head = 0;
+    }
+
+  if (!g_fgraph_registered)
+    {
+      instrument_register(&g_fgraph_instrument);
+      g_fgraph_registered = true;
+    }
+
+  g_fgraph_enabled = true;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: fgraph_stop
+ ****************************************************************************/
+
+void fgraph_stop(void)
+{
+  g_fgraph_enabled = false;
+}
+
+/****************************************************************************
+ * Name: fgraph_filter
+ ****************************************************************************/
+
+int fgraph_filter(FAR void *func)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (func == NULL)
+    {
+      g_fgraph_nfilters = 0;
+    }
+  else if (!fgraph_filtered(func))
+    {
+      if (g_fgraph_nfilters < CONFIG_SCHED_FGRAPH_FILTERS)
+        {
+          g_fgraph_filter[g_fgraph_nfilters] = func;
+          g_fgraph_nfilters++;
+        }
+      else
+        {
+          ret = -ENOSPC;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fgraph_get
+ ****************************************************************************/
+
+int fgraph_get(int cpu, int index, FAR struct fgraph_record_s *record)
+{
+  FAR struct fgraph_ring_s *ring;
+  uint32_t first;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || index < 0)
+    {
+      return -ENOENT;
+    }
+
+  ring  = &g_fgraph_ring[cpu];
+  first = ring->head > CONFIG_SCHED_FGRAPH_NRECORDS ?
+          ring->head - CONFIG_SCHED_FGRAPH_NRECORDS : 0;
+
+  if (first + index >= ring->head)
+    {
+      return -ENOENT;
+    }
+
+  *record = ring->record[(first + index) % CONFIG_SCHED_FGRAPH_NRECORDS];
+  return OK;
+}
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 
 #include <nuttx/irq.h>
@@ -51,6 +52,18 @@ struct irq_thread_info_s
   xcpt_t handler;     /* Address of the interrupt handler */
   FAR void *arg;      /* The argument provided to the interrupt handler. */
   FAR sem_t *sem;     /* irq sem used to notify irq thread */
+#ifdef CONFIG_IRQ_THREAD_AFFINITY
+  volatile int cpu;   /* The CPU that received the last interrupt */
+#endif
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+  /* The irq thread, the priority it was created with and whether it has
+   * inherited a priority since the thread handler last ran.
+   */
+
+  FAR struct tcb_s *tcb;
+  int priority;
+  bool inherited;
+#endif
 };
 
 /****************************************************************************
@@ -59,6 +72,10 @@ struct irq_thread_info_s
 
 static pid_t g_irq_thread_pid[NR_IRQS];
 
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+static FAR struct irq_thread_info_s *g_irq_thread_info[NR_IRQS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -71,13 +88,30 @@ static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
 {
   FAR struct irq_thread_info_s *info = arg;
   int ret = IRQ_WAKE_THREAD;
+#ifdef CONFIG_IRQ_THREAD_BATCH
+  int semcount;
+#endif
 
   DEBUGASSERT(info->handler != NULL);
   ret = info->handler(irq, regs, info->arg);
 
   if (ret == IRQ_WAKE_THREAD)
     {
-      nxsem_post(info->sem);
+#ifdef CONFIG_IRQ_THREAD_AFFINITY
+      info->cpu = this_cpu();
+#endif
+
+#ifdef CONFIG_IRQ_THREAD_BATCH
+      /* The thread handler has not yet run for a previous interrupt and
+       * will process this one too.
+       */
+
+      if (nxsem_get_value(info->sem, &semcount) < 0 || semcount <= 0)
+#endif
+        {
+          nxsem_post(info->sem);
+        }
+
       ret = OK;
     }
 
@@ -91,12 +125,27 @@ static int isr_thread_main(int argc, FAR char *argv[])
   xcpt_t isrthread = (xcpt_t)((uintptr_t)strtoul(argv[3], NULL, 16));
   FAR void *arg = (FAR void *)((uintptr_t)strtoul(argv[4], NULL, 16));
   struct irq_thread_info_s info;
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+  irqstate_t flags;
+#endif
   sem_t sem;
 
   info.sem = &sem;
   info.arg = arg;
   info.handler = isr;
 
+#ifdef CONFIG_IRQ_THREAD_AFFINITY
+  info.cpu = this_cpu();
+#endif
+
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+  info.tcb       = this_task();
+  info.priority  = info.tcb->sched_priority;
+  info.inherited = false;
+
+  g_irq_thread_info[IRQ_TO_NDX(irq)] = &info;
+#endif
+
   nxsem_init(&sem, 0, 0);
 
   irq_attach(irq, irq_default_handler, &info);
@@ -112,7 +161,38 @@ static int isr_thread_main(int argc, FAR char *argv[])
           continue;
         }
 
+#ifdef CONFIG_IRQ_THREAD_AFFINITY
+      /* Follow the interrupt to the CPU that received it */
+
+      if (info.cpu != this_cpu())
+        {
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(info.cpu, &cpuset);
+          nxsched_set_affinity(0, sizeof(cpuset), &cpuset);
+        }
+#endif
+
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+      info.inherited = false;
+#endif
+
       isrthread(irq, NULL, arg);
+
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+      /* Go back to the original priority, unless another thread started
+       * waiting while the handler was running.
+       */
+
+      flags = enter_critical_section();
+      if (!info.inherited && info.tcb->sched_priority != info.priority)
+        {
+          nxsched_set_priority(info.tcb, info.priority);
+        }
+
+      leave_critical_section(flags);
+#endif
     }
 
   return OK;
@@ -173,6 +253,9 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
   if (isrthread == NULL)
     {
       irq_detach(irq);
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+      g_irq_thread_info[ndx] = NULL;
+#endif
       DEBUGASSERT(g_irq_thread_pid[ndx] != 0);
       kthread_delete(g_irq_thread_pid[ndx]);
       g_irq_thread_pid[ndx] = 0;
@@ -208,3 +291,60 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: irq_thread_inherit
+ *
+ * Description:
+ *   Raise the priority of the thread attached to IRQ number 'irq' with
+ *   irq_attach_thread() to at least 'priority' until the thread handler
+ *   has run.
+ *
+ * Input Parameters:
+ *   irq      - Irq num
+ *   priority - The priority of the waiting thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_THREAD_INHERIT
+int irq_thread_inherit(int irq, int priority)
+{
+  FAR struct irq_thread_info_s *info;
+  irqstate_t flags;
+  int ret = OK;
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  flags = enter_critical_section();
+
+  info = g_irq_thread_info[ndx];
+  if (info == NULL)
+    {
+      ret = -ESRCH;
+    }
+  else
+    {
+      info->inherited = true;
+      if (priority > info->tcb->sched_priority)
+        {
+          ret = nxsched_set_priority(info->tcb, priority);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
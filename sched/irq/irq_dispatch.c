@@ -103,6 +103,9 @@ void irq_dispatch(int irq, FAR void *context)
   xcpt_t vector = irq_unexpected_isr;
   FAR void *arg = NULL;
   unsigned int ndx = irq;
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  clock_t start;
+#endif
 
 #if NR_IRQS > 0
   if ((unsigned)irq < NR_IRQS)
@@ -141,8 +144,18 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  start = perf_gettime();
+#endif
+
+  nxsched_critmon_irq(true);
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
+  nxsched_critmon_irq(false);
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  nxsched_latency_record(LATENCY_IRQ, perf_gettime() - start);
+#endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
   /* Notify that we are leaving from the interrupt handler */
@@ -0,0 +1,721 @@
+/****************************************************************************
+ * sched/misc/benchmark.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/benchmark.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NSAMPLES \
+  (CONFIG_SCHED_BENCHMARK_WARMUP + CONFIG_SCHED_BENCHMARK_ITERATIONS)
+
+#if !defined(CONFIG_DISABLE_MQUEUE) && defined(CONFIG_MQ_MAXMSGSIZE) && \
+    CONFIG_MQ_MAXMSGSIZE > 0
+#  define BENCH_HAVE_MQUEUE 1
+#endif
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define BENCH_WORK HPWORK
+#else
+#  define BENCH_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A benchmark takes n samples, in perf counts, moving bytes in each */
+
+struct bench_s
+{
+  FAR const char *name;
+  bench_run_t run;
+  uint32_t bytes;
+};
+
+/* The state shared with the helper threads and callbacks */
+
+struct bench_ctx_s
+{
+  sem_t sem[2];
+  FAR clock_t *samples;
+  int n;
+  int index;
+  volatile clock_t stamp;
+  volatile bool done;
+#ifdef CONFIG_SCHED_WORKQUEUE
+  struct work_s work;
+#endif
+  struct wdog_s wdog;
+  clock_t abstick;
+  clock_t tick;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_perf(FAR clock_t *samples, int n);
+static int bench_yield(FAR clock_t *samples, int n);
+static int bench_sem(FAR clock_t *samples, int n);
+static int bench_mutex(FAR clock_t *samples, int n);
+#ifdef BENCH_HAVE_MQUEUE
+static int bench_mq(FAR clock_t *samples, int n);
+#endif
+static int bench_signal(FAR clock_t *samples, int n);
+#ifdef CONFIG_SCHED_WORKQUEUE
+static int bench_work(FAR clock_t *samples, int n);
+#endif
+static int bench_wdog(FAR clock_t *samples, int n);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct bench_s g_bench[] =
+{
+  { "perf_gettime",  bench_perf,              0 },
+  { "ctxsw",         bench_yield,             0 },
+  { "sem_pingpong",  bench_sem,               0 },
+  { "mutex",         bench_mutex,             0 },
+#ifdef BENCH_HAVE_MQUEUE
+  { "mq",            bench_mq,                sizeof(clock_t) },
+#endif
+  { "signal",        bench_signal,            0 },
+#ifdef CONFIG_SCHED_WORKQUEUE
+  { "work",          bench_work,              0 },
+#endif
+  { "wdog",          bench_wdog,              0 },
+#ifdef CONFIG_NET_BENCHMARK
+#  ifdef CONFIG_NET_TCP
+  { "tcp_stream",    net_bench_tcp_stream,    CONFIG_NET_BENCHMARK_CHUNK },
+  { "tcp_rr",        net_bench_tcp_rr,        1 },
+  { "tcp_connect",   net_bench_tcp_connect,   0 },
+  { "net_lock",      net_bench_netlock,       0 },
+#  endif
+#  ifdef CONFIG_NET_UDP
+  { "udp",           net_bench_udp,
+                     CONFIG_NET_BENCHMARK_UDP_SIZE },
+#  endif
+#endif
+};
+
+#define BENCH_NTESTS nitems(g_bench)
+
+static struct bench_result_s g_bench_result[BENCH_NTESTS];
+static uint64_t g_bench_base[BENCH_NTESTS];
+static mutex_t g_bench_lock = NXMUTEX_INITIALIZER;
+static struct bench_ctx_s g_bench_ctx;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_helper
+ *
+ * Description:
+ *   Start a helper thread at the priority of the caller.  It inherits the
+ *   CPU affinity of the caller too.
+ *
+ ****************************************************************************/
+
+static int bench_helper(FAR const char *name, main_t entry)
+{
+  return kthread_create(name, this_task()->sched_priority,
+                        CONFIG_SCHED_BENCHMARK_STACKSIZE, entry, NULL);
+}
+
+/****************************************************************************
+ * Name: bench_perf
+ *
+ * Description:
+ *   The cost of reading the perf counter, included in all the samples.
+ *
+ ****************************************************************************/
+
+static int bench_perf(FAR clock_t *samples, int n)
+{
+  clock_t start;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      start      = perf_gettime();
+      samples[i] = perf_gettime() - start;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_yield
+ *
+ * Description:
+ *   Two threads of the same priority yield to each other; a sample is the
+ *   time from the yield of one to the return from the yield of the other.
+ *
+ ****************************************************************************/
+
+static int bench_yield_helper(int argc, FAR char *argv[])
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+
+  while (!ctx->done)
+    {
+      ctx->stamp = perf_gettime();
+      sched_yield();
+    }
+
+  nxsem_post(&ctx->sem[1]);
+  return 0;
+}
+
+static int bench_yield(FAR clock_t *samples, int n)
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  int ret;
+  int i;
+
+  ctx->done = false;
+  ret = bench_helper("bench_yield", bench_yield_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      ctx->stamp = perf_gettime();
+      sched_yield();
+      samples[i] = perf_gettime() - ctx->stamp;
+    }
+
+  ctx->done = true;
+  return nxsem_wait_uninterruptible(&ctx->sem[1]);
+}
+
+/****************************************************************************
+ * Name: bench_sem
+ *
+ * Description:
+ *   A semaphore round trip to a thread of the same priority: two posts,
+ *   two waits and two context switches.
+ *
+ ****************************************************************************/
+
+static int bench_sem_helper(int argc, FAR char *argv[])
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  int i;
+
+  for (i = 0; i < ctx->n; i++)
+    {
+      nxsem_wait_uninterruptible(&ctx->sem[0]);
+      nxsem_post(&ctx->sem[1]);
+    }
+
+  return 0;
+}
+
+static int bench_sem(FAR clock_t *samples, int n)
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  clock_t start;
+  int ret;
+  int i;
+
+  ret = bench_helper("bench_sem", bench_sem_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      start = perf_gettime();
+      nxsem_post(&ctx->sem[0]);
+      nxsem_wait_uninterruptible(&ctx->sem[1]);
+      samples[i] = perf_gettime() - start;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_mutex
+ *
+ * Description:
+ *   An uncontended lock and unlock.
+ *
+ ****************************************************************************/
+
+static int bench_mutex(FAR clock_t *samples, int n)
+{
+  mutex_t mutex;
+  clock_t start;
+  int i;
+
+  nxmutex_init(&mutex);
+
+  for (i = 0; i < n; i++)
+    {
+      start = perf_gettime();
+      nxmutex_lock(&mutex);
+      nxmutex_unlock(&mutex);
+      samples[i] = perf_gettime() - start;
+    }
+
+  nxmutex_destroy(&mutex);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_mq
+ *
+ * Description:
+ *   A send and a receive of a small message on a queue that is never
+ *   full or empty when it matters, so that nobody blocks.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_MQUEUE
+static int bench_mq(FAR clock_t *samples, int n)
+{
+  struct mq_attr attr;
+  struct file mq;
+  clock_t start;
+  clock_t msg;
+  ssize_t nbytes;
+  int ret;
+  int i;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = sizeof(msg);
+
+  ret = file_mq_open(&mq, "/tmp/bench", O_RDWR | O_CREAT, 0644, &attr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  file_mq_unlink("/tmp/bench");
+
+  for (i = 0; i < n; i++)
+    {
+      start = perf_gettime();
+      ret = file_mq_send(&mq, (FAR const char *)&start, sizeof(start), 0);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nbytes = file_mq_receive(&mq, (FAR char *)&msg, sizeof(msg), NULL);
+      if (nbytes < 0)
+        {
+          ret = nbytes;
+          break;
+        }
+
+      samples[i] = perf_gettime() - start;
+    }
+
+  file_mq_close(&mq);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_signal
+ *
+ * Description:
+ *   The time from nxsig_kill() to the return of the thread that waits for
+ *   the signal.
+ *
+ ****************************************************************************/
+
+static int bench_signal_helper(int argc, FAR char *argv[])
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  struct siginfo info;
+  sigset_t set;
+  int i;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR1);
+  nxsig_procmask(SIG_BLOCK, &set, NULL);
+  nxsem_post(&ctx->sem[1]);
+
+  for (i = 0; i < ctx->n; i++)
+    {
+      while (nxsig_waitinfo(&set, &info) < 0)
+        {
+        }
+
+      ctx->samples[i] = perf_gettime() - ctx->stamp;
+      nxsem_post(&ctx->sem[1]);
+    }
+
+  return 0;
+}
+
+static int bench_signal(FAR clock_t *samples, int n)
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  pid_t pid;
+  int ret;
+  int i;
+
+  pid = bench_helper("bench_signal", bench_signal_helper);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  /* Wait until the signal is blocked, or it would kill the helper */
+
+  nxsem_wait_uninterruptible(&ctx->sem[1]);
+
+  for (i = 0; i < n; i++)
+    {
+      ctx->stamp = perf_gettime();
+      ret = nxsig_kill(pid, SIGUSR1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_wait_uninterruptible(&ctx->sem[1]);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_work
+ *
+ * Description:
+ *   The time from work_queue() to the start of the work, on the high
+ *   priority queue if there is one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void bench_work_worker(FAR void *arg)
+{
+  FAR struct bench_ctx_s *ctx = arg;
+
+  ctx->samples[ctx->index] = perf_gettime() - ctx->stamp;
+  nxsem_post(&ctx->sem[1]);
+}
+
+static int bench_work(FAR clock_t *samples, int n)
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  int ret;
+
+  for (ctx->index = 0; ctx->index < n; ctx->index++)
+    {
+      ctx->stamp = perf_gettime();
+      ret = work_queue(BENCH_WORK, &ctx->work, bench_work_worker, ctx, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_wait_uninterruptible(&ctx->sem[1]);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   The error of a watchdog rearmed every tick at an absolute time: a
+ *   sample is the difference between the measured period and one tick.
+ *
+ ****************************************************************************/
+
+static void bench_wdog_callback(wdparm_t arg)
+{
+  FAR struct bench_ctx_s *ctx = (FAR struct bench_ctx_s *)arg;
+  clock_t now = perf_gettime();
+  clock_t period = now - ctx->stamp;
+
+  /* The first expiration only synchronizes to the tick */
+
+  if (ctx->index >= 0)
+    {
+      ctx->samples[ctx->index] = period > ctx->tick ?
+                                 period - ctx->tick : ctx->tick - period;
+    }
+
+  ctx->stamp = now;
+  if (++ctx->index < ctx->n)
+    {
+      wd_start_abstick(&ctx->wdog, ++ctx->abstick, bench_wdog_callback,
+                       arg);
+    }
+  else
+    {
+      nxsem_post(&ctx->sem[1]);
+    }
+}
+
+static int bench_wdog(FAR clock_t *samples, int n)
+{
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  int ret;
+
+  ctx->tick    = perf_getfreq() / TICK_PER_SEC;
+  ctx->index   = -1;
+  ctx->abstick = clock_systime_ticks() + 1;
+
+  ret = wd_start_abstick(&ctx->wdog, ctx->abstick, bench_wdog_callback,
+                         (wdparm_t)ctx);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return nxsem_wait_uninterruptible(&ctx->sem[1]);
+}
+
+/****************************************************************************
+ * Name: bench_compare / bench_ns
+ ****************************************************************************/
+
+static int bench_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+static uint64_t bench_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_one
+ *
+ * Description:
+ *   Run a benchmark and reduce its samples, dropping the warmup ones.
+ *
+ ****************************************************************************/
+
+static int bench_one(int index, FAR clock_t *samples)
+{
+  FAR struct bench_result_s *result = &g_bench_result[index];
+  FAR struct bench_ctx_s *ctx = &g_bench_ctx;
+  FAR clock_t *measured = samples + CONFIG_SCHED_BENCHMARK_WARMUP;
+  int n = CONFIG_SCHED_BENCHMARK_ITERATIONS;
+  uint64_t sum = 0;
+  int ret;
+  int i;
+
+  memset(samples, 0, BENCH_NSAMPLES * sizeof(clock_t));
+  nxsem_init(&ctx->sem[0], 0, 0);
+  nxsem_init(&ctx->sem[1], 0, 0);
+  ctx->samples = samples;
+  ctx->n       = BENCH_NSAMPLES;
+
+  memset(result, 0, sizeof(*result));
+  result->name  = g_bench[index].name;
+  result->bytes = g_bench[index].bytes;
+
+  ret = g_bench[index].run(samples, BENCH_NSAMPLES);
+
+  nxsem_destroy(&ctx->sem[0]);
+  nxsem_destroy(&ctx->sem[1]);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      sum += measured[i];
+    }
+
+  qsort(measured, n, sizeof(clock_t), bench_compare);
+
+  result->iterations = n;
+  result->min        = bench_ns(measured[0]);
+  result->p50        = bench_ns(measured[(n - 1) * 50 / 100]);
+  result->p90        = bench_ns(measured[(n - 1) * 90 / 100]);
+  result->p99        = bench_ns(measured[(n - 1) * 99 / 100]);
+  result->max        = bench_ns(measured[n - 1]);
+  result->mean       = bench_ns(sum / n);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_run
+ ****************************************************************************/
+
+int bench_run(FAR const char *name)
+{
+  FAR clock_t *samples;
+#ifdef CONFIG_SMP
+  FAR struct tcb_s *rtcb = this_task();
+  cpu_set_t affinity;
+  cpu_set_t cpuset;
+#endif
+  int count = 0;
+  int ret;
+  int i;
+
+  samples = kmm_malloc(BENCH_NSAMPLES * sizeof(clock_t));
+  if (samples == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxmutex_lock(&g_bench_lock);
+  if (ret < 0)
+    {
+      kmm_free(samples);
+      return ret;
+    }
+
+#ifdef CONFIG_SMP
+  /* Keep the caller and the helpers, which inherit it, on this CPU */
+
+  affinity = rtcb->affinity;
+  CPU_ZERO(&cpuset);
+  CPU_SET(this_cpu(), &cpuset);
+  nxsched_set_affinity(rtcb->pid, sizeof(cpuset), &cpuset);
+#endif
+
+  for (i = 0; i < BENCH_NTESTS; i++)
+    {
+      if (name != NULL && strcmp(name, g_bench[i].name) != 0)
+        {
+          continue;
+        }
+
+      ret = bench_one(i, samples);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      count++;
+    }
+
+#ifdef CONFIG_SMP
+  nxsched_set_affinity(rtcb->pid, sizeof(affinity), &affinity);
+#endif
+
+  nxmutex_unlock(&g_bench_lock);
+  kmm_free(samples);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return count > 0 ? count : -ENOENT;
+}
+
+/****************************************************************************
+ * Name: bench_get
+ ****************************************************************************/
+
+int bench_get(int index, FAR struct bench_result_s *result)
+{
+  if (index < 0 || index >= BENCH_NTESTS)
+    {
+      return -ENOENT;
+    }
+
+  nxmutex_lock(&g_bench_lock);
+  memcpy(result, &g_bench_result[index], sizeof(*result));
+  result->name = g_bench[index].name;
+  result->base = g_bench_base[index];
+  nxmutex_unlock(&g_bench_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_baseline
+ ****************************************************************************/
+
+void bench_baseline(void)
+{
+  int i;
+
+  nxmutex_lock(&g_bench_lock);
+
+  for (i = 0; i < BENCH_NTESTS; i++)
+    {
+      if (g_bench_result[i].iterations > 0)
+        {
+          g_bench_base[i] = g_bench_result[i].p50;
+        }
+    }
+
+  nxmutex_unlock(&g_bench_lock);
+}
@@ -32,6 +32,7 @@
 
 #include <nuttx/coredump.h>
 #include <nuttx/elf.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 
@@ -76,6 +77,17 @@ struct elf_dumpinfo_s
   pid_t                       pid;
 };
 
+#ifdef CONFIG_BOARD_COREDUMP_SKIPFREE
+/* A free heap chunk inside a memory region, left out of the dump */
+
+struct elf_hole_s
+{
+  uintptr_t start;
+  uintptr_t end;
+  int       region;   /* The index of the memory region */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -110,6 +122,13 @@ static struct memory_region_s g_memory_region[] =
 #endif
 static const struct memory_region_s *g_regions;
 
+#ifdef CONFIG_BOARD_COREDUMP_SKIPFREE
+/* The largest holes, by region and address */
+
+static struct elf_hole_s g_holes[CONFIG_BOARD_COREDUMP_SKIPFREE_NHOLES];
+static int g_nholes;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -382,6 +401,155 @@ static void elf_emit_note(FAR struct elf_dumpinfo_s *cinfo)
     }
 }
 
+/****************************************************************************
+ * Name: elf_add_hole
+ *
+ * Description:
+ *   Record a free heap chunk as a hole of the memory region that holds it,
+ *   keeping the largest ones if there are more than fit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_SKIPFREE
+static void elf_add_hole(FAR void *mem, size_t size, FAR void *arg)
+{
+  FAR struct elf_dumpinfo_s *cinfo = arg;
+  FAR const struct memory_region_s *regions = cinfo->regions;
+  uintptr_t start = ALIGN_UP((uintptr_t)mem, PROGRAM_ALIGNMENT);
+  uintptr_t end = ALIGN_DOWN((uintptr_t)mem + size, PROGRAM_ALIGNMENT);
+  int region;
+  int i;
+
+  if (end <= start || end - start < CONFIG_BOARD_COREDUMP_SKIPFREE_MINSIZE)
+    {
+      return;
+    }
+
+  /* The hole must split a region, so that it never empties one */
+
+  for (region = 0; regions[region].start < regions[region].end; region++)
+    {
+      if ((regions[region].flags & PF_REGISTER) == 0 &&
+          start > regions[region].start && end < regions[region].end)
+        {
+          break;
+        }
+    }
+
+  if (regions[region].start >= regions[region].end)
+    {
+      return;
+    }
+
+  if (g_nholes == CONFIG_BOARD_COREDUMP_SKIPFREE_NHOLES)
+    {
+      int smallest = 0;
+
+      for (i = 1; i < g_nholes; i++)
+        {
+          if (g_holes[i].end - g_holes[i].start <
+              g_holes[smallest].end - g_holes[smallest].start)
+            {
+              smallest = i;
+            }
+        }
+
+      if (g_holes[smallest].end - g_holes[smallest].start >= end - start)
+        {
+          return;
+        }
+
+      for (i = smallest; i < g_nholes - 1; i++)
+        {
+          g_holes[i] = g_holes[i + 1];
+        }
+
+      g_nholes--;
+    }
+
+  for (i = g_nholes; i > 0; i--)
+    {
+      if (g_holes[i - 1].region < region ||
+          (g_holes[i - 1].region == region && g_holes[i - 1].start < start))
+        {
+          break;
+        }
+
+      g_holes[i] = g_holes[i - 1];
+    }
+
+  g_holes[i].start  = start;
+  g_holes[i].end    = end;
+  g_holes[i].region = region;
+  g_nholes++;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_find_holes
+ *
+ * Description:
+ *   Find the free heap chunks to leave out of the memory regions.  They are
+ *   found once, before the program headers are written, so that the
+ *   headers and the data agree even if the heaps change meanwhile.
+ *
+ * Returned Value:
+ *   The number of holes, each of which adds one segment.
+ *
+ ****************************************************************************/
+
+static int elf_find_holes(FAR struct elf_dumpinfo_s *cinfo)
+{
+#ifdef CONFIG_BOARD_COREDUMP_SKIPFREE
+  g_nholes = 0;
+
+  if (cinfo->regions != NULL)
+    {
+#  ifndef CONFIG_BUILD_KERNEL
+      mm_heapfree_foreach(USR_HEAP, elf_add_hole, cinfo);
+#  endif
+#  ifdef CONFIG_MM_KERNEL_HEAP
+      mm_heapfree_foreach(g_kmmheap, elf_add_hole, cinfo);
+#  endif
+    }
+
+  return g_nholes;
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: elf_segment_end
+ *
+ * Description:
+ *   Return the end of the segment of a memory region that starts at start:
+ *   the start of the next hole, or the end of the region.  *next is set to
+ *   the start of the following segment, or 0 if this one is the last.
+ *
+ ****************************************************************************/
+
+static uintptr_t elf_segment_end(FAR struct elf_dumpinfo_s *cinfo,
+                                 int region, uintptr_t start,
+                                 FAR uintptr_t *next)
+{
+#ifdef CONFIG_BOARD_COREDUMP_SKIPFREE
+  int i;
+
+  for (i = 0; i < g_nholes; i++)
+    {
+      if (g_holes[i].region == region && g_holes[i].start >= start)
+        {
+          *next = g_holes[i].end;
+          return g_holes[i].start;
+        }
+    }
+#endif
+
+  *next = 0;
+  return cinfo->regions[region].end;
+}
+
 /****************************************************************************
  * Name: elf_emit_tcb_stack
  *
@@ -474,6 +642,9 @@ static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
 
 static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
 {
+  uintptr_t start;
+  uintptr_t next;
+  uintptr_t end;
   int i;
 
   for (i = 0; i < memsegs; i++)
@@ -500,16 +671,25 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
             {
               elf_emit(cinfo, buf, offset * sizeof(uintptr_t));
             }
+
+          /* Align to page */
+
+          elf_emit_align(cinfo);
+          continue;
         }
-      else
+
+      start = cinfo->regions[i].start;
+      do
         {
-          elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
-                   cinfo->regions[i].end - cinfo->regions[i].start);
-        }
+          end = elf_segment_end(cinfo, i, start, &next);
+          elf_emit(cinfo, (FAR void *)start, end - start);
 
-      /* Align to page */
+          /* Align to page */
 
-      elf_emit_align(cinfo);
+          elf_emit_align(cinfo);
+          start = next;
+        }
+      while (start != 0);
     }
 }
 
@@ -614,10 +794,12 @@ static void elf_emit_tcb_phdr(FAR struct elf_dumpinfo_s *cinfo,
  ****************************************************************************/
 
 static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
-                          int stksegs, int memsegs)
+                          int stksegs, int memsegs, int nholes)
 {
   off_t offset = cinfo->stream->nput +
-                 (stksegs + memsegs + 1 + 1) * sizeof(Elf_Phdr);
+                 (stksegs + memsegs + nholes + 1 + 1) * sizeof(Elf_Phdr);
+  uintptr_t start;
+  uintptr_t next;
   Elf_Phdr phdr;
   int i;
 
@@ -651,15 +833,21 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
 
   for (i = 0; i < memsegs; i++)
     {
-      phdr.p_type   = PT_LOAD;
-      phdr.p_offset = ALIGN_UP(offset, ELF_PAGESIZE);
-      phdr.p_vaddr  = cinfo->regions[i].start;
-      phdr.p_paddr  = phdr.p_vaddr;
-      phdr.p_filesz = cinfo->regions[i].end - cinfo->regions[i].start;
-      phdr.p_memsz  = phdr.p_filesz;
-      phdr.p_flags  = cinfo->regions[i].flags;
-      offset       += ALIGN_UP(phdr.p_memsz, ELF_PAGESIZE);
-      elf_emit(cinfo, &phdr, sizeof(phdr));
+      start = cinfo->regions[i].start;
+      do
+        {
+          phdr.p_type   = PT_LOAD;
+          phdr.p_offset = ALIGN_UP(offset, ELF_PAGESIZE);
+          phdr.p_vaddr  = start;
+          phdr.p_paddr  = phdr.p_vaddr;
+          phdr.p_filesz = elf_segment_end(cinfo, i, start, &next) - start;
+          phdr.p_memsz  = phdr.p_filesz;
+          phdr.p_flags  = cinfo->regions[i].flags;
+          offset       += ALIGN_UP(phdr.p_memsz, ELF_PAGESIZE);
+          elf_emit(cinfo, &phdr, sizeof(phdr));
+          start         = next;
+        }
+      while (start != 0);
     }
 
   memset(&phdr, 0, sizeof(Elf_Phdr));
@@ -955,6 +1143,7 @@ int coredump(FAR const struct memory_region_s *regions,
   irqstate_t flags;
   int memsegs = 0;
   int stksegs;
+  int nholes;
 
   cinfo.regions = regions;
   cinfo.stream  = stream;
@@ -985,17 +1174,21 @@ int coredump(FAR const struct memory_region_s *regions,
              cinfo.regions[memsegs].end; memsegs++);
     }
 
+  /* Each free heap chunk left out splits its region in two segments */
+
+  nholes = elf_find_holes(&cinfo);
+
   /* Fill notes section, with additional one for program header,
    * and one for the core file info defined by NuttX.
    */
 
-  elf_emit_hdr(&cinfo, stksegs + memsegs + 1 + 1);
+  elf_emit_hdr(&cinfo, stksegs + memsegs + nholes + 1 + 1);
 
   /* Fill all the program information about the process for the
    * notes.  This also sets up the file header.
    */
 
-  elf_emit_phdr(&cinfo, stksegs, memsegs);
+  elf_emit_phdr(&cinfo, stksegs, memsegs, nholes);
 
   /* Fill note information */
 
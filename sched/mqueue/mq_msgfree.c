@@ -98,7 +98,10 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
     {
       kmm_free(mqmsg);
     }
-  else
+
+  /* Messages from the pool of a queue are freed with the queue */
+
+  else if (mqmsg->type != MQ_ALLOC_QUEUE)
     {
       DEBUGPANIC();
     }
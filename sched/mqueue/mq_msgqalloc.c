@@ -68,6 +68,14 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+  size_t size = sizeof(struct mqueue_inode_s);
+  int16_t maxmsgsize = MQ_MAX_BYTES;
+  int16_t maxmsgs = MQ_MAX_MSGS;
+#ifdef CONFIG_MQ_ZEROCOPY
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR uint8_t *pool;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -79,26 +87,45 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+  if (attr)
+    {
+      maxmsgs    = (int16_t)attr->mq_maxmsg;
+      maxmsgsize = (int16_t)attr->mq_msgsize;
+    }
+
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* The messages of the queue are allocated right after it */
+
+  if (maxmsgs > 0)
+    {
+      size += maxmsgs * MQ_POOL_MSG_SIZE(maxmsgsize);
+    }
+#endif
+
   /* Allocate memory for the new message queue. */
 
-  msgq = (FAR struct mqueue_inode_s *)
-    kmm_zalloc(sizeof(struct mqueue_inode_s));
+  msgq = (FAR struct mqueue_inode_s *)kmm_zalloc(size);
 
   if (msgq)
     {
       /* Initialize the new named message queue */
 
       list_initialize(&msgq->msglist);
-      if (attr)
-        {
-          msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
-          msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
-        }
-      else
+      msgq->maxmsgs    = maxmsgs;
+      msgq->maxmsgsize = maxmsgsize;
+
+#ifdef CONFIG_MQ_ZEROCOPY
+      list_initialize(&msgq->msgpool);
+
+      pool = (FAR uint8_t *)(msgq + 1);
+      for (i = 0; i < maxmsgs; i++)
         {
-          msgq->maxmsgs    = MQ_MAX_MSGS;
-          msgq->maxmsgsize = MQ_MAX_BYTES;
+          mqmsg       = (FAR struct mqueue_msg_s *)pool;
+          mqmsg->type = MQ_ALLOC_QUEUE;
+          list_add_tail(&msgq->msgpool, &mqmsg->node);
+          pool       += MQ_POOL_MSG_SIZE(maxmsgsize);
         }
+#endif
 
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
       msgq->ntpid = INVALID_PROCESS_ID;
@@ -140,9 +140,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
                                       FAR const struct timespec *abstime,
                                       sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   ssize_t ret = 0;
 
   DEBUGASSERT(up_interrupt_context() == false);
@@ -171,7 +169,62 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
+  ret = nxmq_remove_msg(mq, &mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Return the message to the caller */
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  memcpy(msg, mqmsg->mail, mqmsg->msglen);
+  ret = mqmsg->msglen;
+
+  /* Free the message structure */
+
+#ifdef CONFIG_MQ_ZEROCOPY
+  nxmq_release_msg(mq->f_inode->i_private, mqmsg);
+#else
+  nxmq_free_msg(mqmsg);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_remove_msg
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from a message
+ *   queue, waiting for one to be sent if the queue is empty.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   pmsg    - The location to return the message
+ *   abstime - The absolute time to wait until a timeout is declared
+ *   ticks   - Ticks to wait, used if abstime is NULL and ticks >= 0
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value (see mq_timedreceive()).
+ *
+ ****************************************************************************/
+
+int nxmq_remove_msg(FAR struct file *mq, FAR struct mqueue_msg_s **pmsg,
+                    FAR const struct timespec *abstime, sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
 
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
@@ -204,6 +257,13 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
    * the queue while we are still in the critical section
    */
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* The message stays in use until it is released to the pool, so the
+   * senders are notified then.
+   */
+
+  msgq->nmsgs--;
+#else
   if (msgq->nmsgs-- == msgq->maxmsgs)
     {
       nxmq_pollnotify(msgq, POLLOUT);
@@ -212,29 +272,50 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
   /* Notify all threads waiting for a message in the message queue */
 
   nxmq_notify_receive(msgq);
+#endif
 
   leave_critical_section(flags);
 
-  /* Return the message to the caller */
+  *pmsg = mqmsg;
+  return OK;
+}
 
-  if (prio)
-    {
-      *prio = mqmsg->priority;
-    }
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_release_msg
+ *
+ * Description:
+ *   Return a message to the pool of its message queue and wake up a sender
+ *   waiting for the queue to become non-full.
+ *
+ * Input Parameters:
+ *   msgq  - The message queue
+ *   mqmsg - The message to return
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-  memcpy(msg, mqmsg->mail, mqmsg->msglen);
-  ret = mqmsg->msglen;
+void nxmq_release_msg(FAR struct mqueue_inode_s *msgq,
+                      FAR struct mqueue_msg_s *mqmsg)
+{
+  irqstate_t flags;
 
-  /* Free the message structure */
+  DEBUGASSERT(mqmsg->type == MQ_ALLOC_QUEUE);
 
-  nxmq_free_msg(mqmsg);
+  flags = enter_critical_section();
 
-  return ret;
-}
+  if (MQ_ISFULL(msgq))
+    {
+      nxmq_pollnotify(msgq, POLLOUT);
+    }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+  list_add_tail(&msgq->msgpool, &mqmsg->node);
+  nxmq_notify_receive(msgq);
+  leave_critical_section(flags);
+}
+#endif
 
 /****************************************************************************
  * Name: file_mq_timedreceive
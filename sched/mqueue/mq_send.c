@@ -105,6 +105,7 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
 }
 #endif
 
+#ifndef CONFIG_MQ_ZEROCOPY
 /****************************************************************************
  * Name: nxmq_alloc_msg
  *
@@ -183,6 +184,7 @@ static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
 
   return mqmsg;
 }
+#endif
 
 /****************************************************************************
  * Name: nxmq_add_queue
@@ -279,7 +281,9 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 {
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
+#ifndef CONFIG_MQ_ZEROCOPY
   irqstate_t flags;
+#endif
   int ret = 0;
 
   /* Verify the input parameters */
@@ -306,6 +310,21 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Take a message from the pool of the queue, waiting if it is full, and
+   * fill it outside of the critical section.
+   */
+
+  ret = nxmq_reserve_msg(mq, &mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(mqmsg->mail, msg, msglen);
+  nxmq_commit_msg(msgq, mqmsg, msglen, prio);
+  return OK;
+#else
   /* Pre-allocate a message structure */
 
   mqmsg = nxmq_alloc_msg(msglen);
@@ -367,12 +386,104 @@ out:
     }
 
   return ret;
+#endif
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_reserve_msg
+ *
+ * Description:
+ *   Take a free message from the pool of a message queue, waiting for one
+ *   to be released if the queue is full.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   pmsg    - The location to return the message
+ *   abstime - The absolute time to wait until a timeout is declared
+ *   ticks   - Ticks to wait, used if abstime is NULL and ticks >= 0
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value (see mq_timedsend()).
+ *
+ ****************************************************************************/
+
+int nxmq_reserve_msg(FAR struct file *mq, FAR struct mqueue_msg_s **pmsg,
+                     FAR const struct timespec *abstime, sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (MQ_ISFULL(msgq))
+    {
+      if (up_interrupt_context() || (mq->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+        }
+      else
+        {
+          ret = nxmq_wait_send(msgq, abstime, ticks);
+        }
+    }
+
+  if (ret == OK)
+    {
+      *pmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msgpool);
+      DEBUGASSERT(*pmsg != NULL);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_commit_msg
+ *
+ * Description:
+ *   Add a message taken with nxmq_reserve_msg() to the message queue and
+ *   wake up the receivers.
+ *
+ * Input Parameters:
+ *   msgq   - The message queue
+ *   mqmsg  - The message filled in by the caller
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_commit_msg(FAR struct mqueue_inode_s *msgq,
+                     FAR struct mqueue_msg_s *mqmsg,
+                     size_t msglen, unsigned int prio)
+{
+  irqstate_t flags;
+
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
+
+  flags = enter_critical_section();
+
+  nxmq_add_queue(msgq, mqmsg, prio);
+
+  if (msgq->nmsgs++ == 0)
+    {
+      nxmq_pollnotify(msgq, POLLIN);
+    }
+
+  nxmq_notify_send(msgq);
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: file_mq_timedsend
  *
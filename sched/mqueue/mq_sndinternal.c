@@ -162,7 +162,7 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
    * receiving message queue
    */
 
-  while (msgq->nmsgs >= msgq->maxmsgs)
+  while (MQ_ISFULL(msgq))
     {
       /* Block until the message queue is no longer full.
        * When we are unblocked, we will try again
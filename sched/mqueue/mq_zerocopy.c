@@ -0,0 +1,362 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_buf2msg
+ *
+ * Description:
+ *   Return the message of the queue that contains a buffer handed out by
+ *   file_mq_reserve() or file_mq_borrow(), or NULL if it is not one.
+ *
+ ****************************************************************************/
+
+static FAR struct mqueue_msg_s *nxmq_buf2msg(FAR struct mqueue_inode_s *msgq,
+                                             FAR void *buf)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  uintptr_t offset;
+
+  if (buf == NULL)
+    {
+      return NULL;
+    }
+
+  mqmsg  = container_of((FAR char *)buf, struct mqueue_msg_s, mail);
+  offset = (uintptr_t)mqmsg - (uintptr_t)(msgq + 1);
+
+  if ((uintptr_t)mqmsg < (uintptr_t)(msgq + 1) ||
+      offset % MQ_POOL_MSG_SIZE(msgq->maxmsgsize) != 0 ||
+      offset / MQ_POOL_MSG_SIZE(msgq->maxmsgsize) >= msgq->maxmsgs)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(mqmsg->type == MQ_ALLOC_QUEUE);
+  return mqmsg;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_mq_reserve
+ *
+ * Description:
+ *   Take a free message buffer of mq_msgsize bytes from the pool of the
+ *   message queue.  The caller builds the message directly in the buffer
+ *   and then queues it with file_mq_commit() or gives it back with
+ *   file_mq_release().  The buffer counts against the capacity of the queue
+ *   until then, so file_mq_reserve() blocks while the queue is full unless
+ *   O_NONBLOCK is set.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The location to return the buffer
+ *   abstime - The absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   EAGAIN    The queue was full and O_NONBLOCK was set.
+ *   EINVAL    mq or buf is NULL or abstime is invalid.
+ *   EBADF     The queue was not opened for writing.
+ *   EINTR     The wait was interrupted by a signal.
+ *   ETIMEDOUT The timeout expired.
+ *
+ ****************************************************************************/
+
+int file_mq_reserve(FAR struct file *mq, FAR void **buf,
+                    FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  if (mq == NULL || mq->f_inode == NULL || buf == NULL ||
+      (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)))
+    {
+      return -EINVAL;
+    }
+
+  if ((mq->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxmq_reserve_msg(mq, &mqmsg, abstime, -1);
+  if (ret >= 0)
+    {
+      *buf = mqmsg->mail;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_commit
+ *
+ * Description:
+ *   Queue a message built in a buffer returned by file_mq_reserve().  The
+ *   buffer belongs to the queue afterwards.  On failure it is still owned
+ *   by the caller, who must release it.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buf    - The buffer returned by file_mq_reserve()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   EINVAL   mq is NULL, buf is not a reserved buffer or prio is invalid.
+ *   EMSGSIZE msglen is greater than the mq_msgsize of the queue.
+ *
+ ****************************************************************************/
+
+int file_mq_commit(FAR struct file *mq, FAR void *buf, size_t msglen,
+                   unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mq == NULL || mq->f_inode == NULL || prio >= MQ_PRIO_MAX)
+    {
+      return -EINVAL;
+    }
+
+  msgq  = mq->f_inode->i_private;
+  mqmsg = nxmq_buf2msg(msgq, buf);
+  if (mqmsg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  nxmq_commit_msg(msgq, mqmsg, msglen, prio);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: file_mq_borrow
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue like file_mq_timedreceive(), but return the message buffer itself
+ *   instead of copying it.  The caller must give the buffer back with
+ *   file_mq_release(); until then it counts against the capacity of the
+ *   queue.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The location to return the message buffer
+ *   prio    - If not NULL, the location to return the message priority
+ *   abstime - The absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever
+ *
+ * Returned Value:
+ *   The length of the message on success.  A negated errno value is
+ *   returned on failure (see file_mq_timedreceive()).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_borrow(FAR struct file *mq, FAR void **buf,
+                       FAR unsigned int *prio,
+                       FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  if (mq == NULL || mq->f_inode == NULL || buf == NULL ||
+      (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)))
+    {
+      return -EINVAL;
+    }
+
+  if ((mq->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxmq_remove_msg(mq, &mqmsg, abstime, -1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  *buf = mqmsg->mail;
+  return mqmsg->msglen;
+}
+
+/****************************************************************************
+ * Name: file_mq_release
+ *
+ * Description:
+ *   Give back a buffer returned by file_mq_borrow() or a buffer returned by
+ *   file_mq_reserve() that will not be committed.  All buffers must be
+ *   released before the message queue is closed.
+ *
+ * Input Parameters:
+ *   mq  - Message queue descriptor
+ *   buf - The buffer to release
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success or -EINVAL if buf is not a buffer of
+ *   the queue.
+ *
+ ****************************************************************************/
+
+int file_mq_release(FAR struct file *mq, FAR void *buf)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mq == NULL || mq->f_inode == NULL)
+    {
+      return -EINVAL;
+    }
+
+  msgq  = mq->f_inode->i_private;
+  mqmsg = nxmq_buf2msg(msgq, buf);
+  if (mqmsg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxmq_release_msg(msgq, mqmsg);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_reserve, nxmq_commit, nxmq_borrow and nxmq_release
+ *
+ * Description:
+ *   The same as the file_mq_* functions above, for a message queue
+ *   descriptor.
+ *
+ ****************************************************************************/
+
+int nxmq_reserve(mqd_t mqdes, FAR void **buf,
+                 FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_reserve(filep, buf, abstime);
+  fs_putfilep(filep);
+  return ret;
+}
+
+int nxmq_commit(mqd_t mqdes, FAR void *buf, size_t msglen,
+                unsigned int prio)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_commit(filep, buf, msglen, prio);
+  fs_putfilep(filep);
+  return ret;
+}
+
+ssize_t nxmq_borrow(mqd_t mqdes, FAR void **buf, FAR unsigned int *prio,
+                    FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_borrow(filep, buf, prio, abstime);
+  fs_putfilep(filep);
+  return ret;
+}
+
+int nxmq_release(mqd_t mqdes, FAR void *buf)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_release(filep, buf);
+  fs_putfilep(filep);
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+#include <nuttx/nuttx.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -52,6 +53,12 @@
 
 #define MQ_MSG_SIZE(n) (sizeof(struct mqueue_msg_s) + (n) - 1)
 
+/* The size of one message in the pool of a queue, keeping the following
+ * message header aligned.
+ */
+
+#define MQ_POOL_MSG_SIZE(n) ALIGN_UP(MQ_MSG_SIZE(n), sizeof(uintptr_t))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -60,7 +67,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_QUEUE       /* Part of the message pool of one queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -138,6 +146,25 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
+/* mq_send.c ****************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int nxmq_reserve_msg(FAR struct file *mq, FAR struct mqueue_msg_s **pmsg,
+                     FAR const struct timespec *abstime, sclock_t ticks);
+void nxmq_commit_msg(FAR struct mqueue_inode_s *msgq,
+                     FAR struct mqueue_msg_s *mqmsg,
+                     size_t msglen, unsigned int prio);
+#endif
+
+/* mq_receive.c *************************************************************/
+
+int nxmq_remove_msg(FAR struct file *mq, FAR struct mqueue_msg_s **pmsg,
+                    FAR const struct timespec *abstime, sclock_t ticks);
+#ifdef CONFIG_MQ_ZEROCOPY
+void nxmq_release_msg(FAR struct mqueue_inode_s *msgq,
+                      FAR struct mqueue_msg_s *mqmsg);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
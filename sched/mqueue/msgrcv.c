@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/nuttx.h>
 
 #include "sched/sched.h"
 #include "mqueue/msg.h"
@@ -154,11 +155,60 @@ static int msgrcv_wait(FAR struct msgq_s *msgq, FAR struct msgbuf_s **rcvmsg,
     }
 
 found:
-  msgq->nmsgs--;
   *rcvmsg = newmsg;
   return OK;
 }
 
+/****************************************************************************
+ * Name: msgrcv_notify
+ *
+ * Description:
+ *   Wake up the highest priority task waiting for space on the queue.
+ *
+ ****************************************************************************/
+
+static void msgrcv_notify(FAR struct msgq_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+
+  if (msgq->cmn.nwaitnotfull > 0)
+    {
+      FAR struct tcb_s *rtcb = this_task();
+
+      /* Find the highest priority task that is waiting for
+       * this queue to be not-full in g_waitingformqnotfull list.
+       * This must be performed in a critical section because
+       * messages can be sent from interrupt handlers.
+       */
+
+      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNFLIST(msgq->cmn));
+
+      /* If one was found, unblock it.  NOTE:  There is a race
+       * condition here:  the queue might be full again by the
+       * time the task is unblocked
+       */
+
+      DEBUGASSERT(btcb != NULL);
+
+      wd_cancel(&btcb->waitdog);
+
+      msgq->cmn.nwaitnotfull--;
+
+      /* Indicate that the wait is over. */
+
+      btcb->waitobj = NULL;
+
+      /* Add the task to ready-to-run task list and
+       * perform the context switch if one is needed
+       */
+
+      if (nxsched_add_readytorun(btcb))
+        {
+          up_switch_context(btcb, rtcb);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -193,7 +243,6 @@ ssize_t msgrcv(int msqid, FAR void *msgp, size_t msgsz, long msgtyp,
   FAR struct msgbuf_s *msg = NULL;
   FAR struct mymsg *buf = msgp;
   FAR struct msgq_s *msgq;
-  FAR struct tcb_s *btcb;
   irqstate_t flags;
   int ret;
 
@@ -230,54 +279,132 @@ ssize_t msgrcv(int msqid, FAR void *msgp, size_t msgsz, long msgtyp,
   memcpy(buf->mtext, msg->mtext, ret);
 
   list_add_tail(&g_msgfreelist, &msg->node);
+  msgq->nmsgs--;
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
-  if (msgq->cmn.nwaitnotfull > 0)
-    {
-      FAR struct tcb_s *rtcb = this_task();
+  msgrcv_notify(msgq);
 
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in g_waitingformqnotfull list.
-       * This must be performed in a critical section because
-       * messages can be sent from interrupt handlers.
-       */
+errout_with_critical:
+  leave_critical_section(flags);
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
 
-      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNFLIST(msgq->cmn));
+  return ret;
+}
 
-      /* If one was found, unblock it.  NOTE:  There is a race
-       * condition here:  the queue might be full again by the
-       * time the task is unblocked
-       */
+#ifdef CONFIG_MQ_ZEROCOPY
 
-      DEBUGASSERT(btcb != NULL);
+/****************************************************************************
+ * Name: nxmsg_borrow
+ *
+ * Description:
+ *   Remove a message from the System V message queue msqid like msgrcv(),
+ *   but return the message buffer itself instead of copying it.  The caller
+ *   must give the buffer back with nxmsg_release(); until then it counts
+ *   against the capacity of the queue.
+ *
+ * Input Parameters:
+ *   msqid  - Message queue identifier
+ *   buf    - The location to return the message text
+ *   mtype  - If not NULL, the location to return the message type
+ *   msgtyp - Type of message to be received (see msgrcv())
+ *   msgflg - Operations flags (IPC_NOWAIT, MSG_EXCEPT)
+ *
+ * Returned Value:
+ *   The length of the message text on success.  A negated errno value is
+ *   returned on failure (see msgrcv()).
+ *
+ ****************************************************************************/
 
-      wd_cancel(&btcb->waitdog);
+ssize_t nxmsg_borrow(int msqid, FAR void **buf, FAR long *mtype,
+                     long msgtyp, int msgflg)
+{
+  FAR struct msgbuf_s *msg = NULL;
+  FAR struct msgq_s *msgq;
+  irqstate_t flags;
+  ssize_t ret;
 
-      msgq->cmn.nwaitnotfull--;
+  if (buf == NULL)
+    {
+      return -EFAULT;
+    }
 
-      /* Indicate that the wait is over. */
+  flags = enter_critical_section();
 
-      btcb->waitobj = NULL;
+  msgq = nxmsg_lookup(msqid);
+  if (msgq == NULL)
+    {
+      ret = -EINVAL;
+      goto errout_with_critical;
+    }
 
-      /* Add the task to ready-to-run task list and
-       * perform the context switch if one is needed
-       */
+  ret = msgrcv_wait(msgq, &msg, msgtyp, msgflg);
+  if (ret < 0)
+    {
+      goto errout_with_critical;
+    }
 
-      if (nxsched_add_readytorun(btcb))
-        {
-          up_switch_context(btcb, rtcb);
-        }
+  if (mtype != NULL)
+    {
+      *mtype = msg->mtype;
     }
 
+  *buf = msg->mtext;
+  ret  = msg->msize;
+
 errout_with_critical:
   leave_critical_section(flags);
-errout:
-  if (ret < 0)
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmsg_release
+ *
+ * Description:
+ *   Give back a buffer returned by nxmsg_borrow() or a buffer returned by
+ *   nxmsg_reserve() that will not be committed.
+ *
+ * Input Parameters:
+ *   msqid - Message queue identifier the buffer was taken from
+ *   buf   - The buffer to release
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success or -EINVAL if buf is NULL.  The buffer
+ *   is released even if the queue has been removed in the meantime.
+ *
+ ****************************************************************************/
+
+int nxmsg_release(int msqid, FAR void *buf)
+{
+  FAR struct msgbuf_s *msg;
+  FAR struct msgq_s *msgq;
+  irqstate_t flags;
+
+  if (buf == NULL)
     {
-      set_errno(-ret);
-      return ERROR;
+      return -EINVAL;
     }
 
-  return ret;
+  msg = container_of((FAR char *)buf, struct msgbuf_s, mtext);
+
+  flags = enter_critical_section();
+
+  list_add_tail(&g_msgfreelist, &msg->node);
+
+  msgq = nxmsg_lookup(msqid);
+  if (msgq != NULL && msgq->nmsgs > 0)
+    {
+      msgq->nmsgs--;
+      msgrcv_notify(msgq);
+    }
+
+  leave_critical_section(flags);
+  return OK;
 }
+
+#endif /* CONFIG_MQ_ZEROCOPY */
@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/nuttx.h>
 
 #include "sched/sched.h"
 #include "mqueue/msg.h"
@@ -122,6 +123,54 @@ static int msgsnd_wait(FAR struct msgq_s *msgq, int msgflg)
   return OK;
 }
 
+/****************************************************************************
+ * Name: msgsnd_notify
+ *
+ * Description:
+ *   Wake up the highest priority task waiting for a message on the queue.
+ *
+ ****************************************************************************/
+
+static void msgsnd_notify(FAR struct msgq_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+
+  if (msgq->cmn.nwaitnotempty > 0)
+    {
+      FAR struct tcb_s *rtcb = this_task();
+
+      /* Find the highest priority task that is waiting for
+       * this queue to be non-empty in g_waitingformqnotempty
+       * list. enter_critical_section() should give us sufficient
+       * protection since interrupts should never cause a change
+       * in this list
+       */
+
+      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNELIST(msgq->cmn));
+
+      /* If one was found, unblock it */
+
+      DEBUGASSERT(btcb);
+
+      wd_cancel(&btcb->waitdog);
+
+      msgq->cmn.nwaitnotempty--;
+
+      /* Indicate that the wait is over. */
+
+      btcb->waitobj = NULL;
+
+      /* Add the task to ready-to-run task list and
+       * perform the context switch if one is needed
+       */
+
+      if (nxsched_add_readytorun(btcb))
+        {
+          up_switch_context(btcb, rtcb);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -162,7 +211,6 @@ int msgsnd(int msqid, FAR const void *msgp, size_t msgsz, int msgflg)
   FAR const struct mymsg *buf = msgp;
   FAR struct msgbuf_s *msg;
   FAR struct msgq_s *msgq;
-  FAR struct tcb_s *btcb;
   irqstate_t flags;
   int ret = OK;
 
@@ -228,50 +276,153 @@ int msgsnd(int msqid, FAR const void *msgp, size_t msgsz, int msgflg)
 
       msgq->nmsgs++;
 
-      if (msgq->cmn.nwaitnotempty > 0)
-        {
-          FAR struct tcb_s *rtcb = this_task();
+      msgsnd_notify(msgq);
+    }
 
-          /* Find the highest priority task that is waiting for
-           * this queue to be non-empty in g_waitingformqnotempty
-           * list. enter_critical_section() should give us sufficient
-           * protection since interrupts should never cause a change
-           * in this list
-           */
+errout_with_critical:
+  leave_critical_section(flags);
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
 
-          btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNELIST(msgq->cmn));
+  return OK;
+}
 
-          /* If one was found, unblock it */
+#ifdef CONFIG_MQ_ZEROCOPY
 
-          DEBUGASSERT(btcb);
+/****************************************************************************
+ * Name: nxmsg_reserve
+ *
+ * Description:
+ *   Take a free message buffer of CONFIG_MQ_MAXMSGSIZE bytes for the
+ *   System V message queue msqid.  The caller builds the message text
+ *   directly in the buffer and then queues it with nxmsg_commit() or gives
+ *   it back with nxmsg_release().  The buffer counts against the capacity
+ *   of the queue until then.
+ *
+ * Input Parameters:
+ *   msqid  - Message queue identifier
+ *   buf    - The location to return the buffer
+ *   msgflg - Operations flags (IPC_NOWAIT)
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (see msgsnd()).
+ *
+ ****************************************************************************/
 
-          wd_cancel(&btcb->waitdog);
+int nxmsg_reserve(int msqid, FAR void **buf, int msgflg)
+{
+  FAR struct msgbuf_s *msg;
+  FAR struct msgq_s *msgq;
+  irqstate_t flags;
+  int ret = OK;
 
-          msgq->cmn.nwaitnotempty--;
+  if (buf == NULL)
+    {
+      return -EFAULT;
+    }
 
-          /* Indicate that the wait is over. */
+  flags = enter_critical_section();
 
-          btcb->waitobj = NULL;
+  msgq = nxmsg_lookup(msqid);
+  if (msgq == NULL)
+    {
+      ret = -EINVAL;
+      goto errout_with_critical;
+    }
 
-          /* Add the task to ready-to-run task list and
-           * perform the context switch if one is needed
-           */
+  if (msgq->nmsgs >= msgq->maxmsgs)
+    {
+      if (up_interrupt_context() || (msgflg & IPC_NOWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout_with_critical;
+        }
 
-          if (nxsched_add_readytorun(btcb))
-            {
-              up_switch_context(btcb, rtcb);
-            }
+      ret = msgsnd_wait(msgq, msgflg);
+      if (ret < 0)
+        {
+          goto errout_with_critical;
         }
     }
 
+  msg = (FAR struct msgbuf_s *)list_remove_head(&g_msgfreelist);
+  if (msg == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_critical;
+    }
+
+  msgq->nmsgs++;
+  *buf = msg->mtext;
+
 errout_with_critical:
   leave_critical_section(flags);
-errout:
-  if (ret < 0)
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmsg_commit
+ *
+ * Description:
+ *   Queue a message built in a buffer returned by nxmsg_reserve().  On
+ *   failure the buffer is still owned by the caller, who must release it.
+ *
+ * Input Parameters:
+ *   msqid - Message queue identifier
+ *   buf   - The buffer returned by nxmsg_reserve()
+ *   msgsz - Length of the message text
+ *   mtype - Type of the message, must be > 0
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   EINVAL   msqid or mtype is invalid or buf is NULL.
+ *   EMSGSIZE msgsz is greater than the maximum message size of the queue.
+ *
+ ****************************************************************************/
+
+int nxmsg_commit(int msqid, FAR void *buf, size_t msgsz, long mtype)
+{
+  FAR struct msgbuf_s *msg;
+  FAR struct msgq_s *msgq;
+  irqstate_t flags;
+  int ret = OK;
+
+  if (buf == NULL || mtype <= 0)
     {
-      set_errno(-ret);
-      return ERROR;
+      return -EINVAL;
     }
 
-  return OK;
+  msg = container_of((FAR char *)buf, struct msgbuf_s, mtext);
+
+  flags = enter_critical_section();
+
+  msgq = nxmsg_lookup(msqid);
+  if (msgq == NULL)
+    {
+      ret = -EINVAL;
+    }
+  else if (msgsz > msgq->maxmsgsize)
+    {
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      msg->msize = msgsz;
+      msg->mtype = mtype;
+
+      list_add_tail(&msgq->msglist, &msg->node);
+      msgsnd_notify(msgq);
+    }
+
+  leave_critical_section(flags);
+  return ret;
 }
+
+#endif /* CONFIG_MQ_ZEROCOPY */
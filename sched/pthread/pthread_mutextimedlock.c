@@ -34,6 +34,7 @@
 #include <debug.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/pthread.h>
 
 #include "pthread/pthread.h"
 
@@ -42,7 +43,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: pthread_mutex_timedlock
+ * Name: pthread_mutex_timedlock_slow
  *
  * Description:
  *   The pthread_mutex_timedlock() function will lock the mutex object
@@ -77,8 +78,8 @@
  *
  ****************************************************************************/
 
-int pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
-                            FAR const struct timespec *abs_timeout)
+int pthread_mutex_timedlock_slow(FAR pthread_mutex_t *mutex,
+                                 FAR const struct timespec *abs_timeout)
 {
   int ret = EINVAL;
 
@@ -33,6 +33,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/pthread.h>
+
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -40,7 +42,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: pthread_mutex_trylock
+ * Name: pthread_mutex_trylock_slow
  *
  * Description:
  *   The function pthread_mutex_trylock() is identical to
@@ -68,7 +70,7 @@
  *
  ****************************************************************************/
 
-int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+int pthread_mutex_trylock_slow(FAR pthread_mutex_t *mutex)
 {
   int status;
   int ret = EINVAL;
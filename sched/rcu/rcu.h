@@ -0,0 +1,63 @@
+/****************************************************************************
+ * sched/rcu/rcu.h
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_RCU_RCU_H
+#define __SCHED_RCU_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/rcu.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Report a quiescent state for the current CPU.  Called on every context
+ * switch and from the IDLE loop:  Since RCU readers cannot be preempted or
+ * block, no read-side critical section can span either of them.
+ */
+
+#if defined(CONFIG_RCU) && defined(CONFIG_SMP)
+#  define nxrcu_quiescent() (g_rcu_qs[this_cpu()]++)
+#else
+#  define nxrcu_quiescent()
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_RCU) && defined(CONFIG_SMP)
+/* The number of quiescent states passed through by each CPU */
+
+extern volatile uint32_t g_rcu_qs[CONFIG_SMP_NCPUS];
+#endif
+
+#endif /* __SCHED_RCU_RCU_H */
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * sched/rcu/rcu_call.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "rcu/rcu.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Callbacks are run from the low priority work queue if available */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define RCU_WORK LPWORK
+#else
+#  define RCU_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_rcu_lock = SP_UNLOCKED;
+
+/* The list of callbacks waiting for the next grace period */
+
+static FAR struct rcu_head *g_rcu_head;
+static FAR struct rcu_head **g_rcu_tail = &g_rcu_head;
+
+static struct work_s g_rcu_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Wait for a grace period, then invoke the callbacks that were queued
+ *   before it started.
+ *
+ ****************************************************************************/
+
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_head *head;
+  FAR struct rcu_head *next;
+  irqstate_t flags;
+
+  flags      = spin_lock_irqsave(&g_rcu_lock);
+  head       = g_rcu_head;
+  g_rcu_head = NULL;
+  g_rcu_tail = &g_rcu_head;
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  synchronize_rcu();
+
+  for (; head != NULL; head = next)
+    {
+      next = head->next;
+      head->func(head);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Invoke 'func' on the work queue once all read-side critical sections
+ *   in progress at the time of the call have completed.
+ *
+ * Input Parameters:
+ *   head - The rcu_head embedded in the object to be reclaimed
+ *   func - The function that reclaims the object
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(head != NULL && func != NULL);
+
+  head->next = NULL;
+  head->func = func;
+
+  flags       = spin_lock_irqsave(&g_rcu_lock);
+  *g_rcu_tail = head;
+  g_rcu_tail  = &head->next;
+
+  /* A worker that is already running has detached its list, so the new
+   * callback needs another run.
+   */
+
+  if (work_available(&g_rcu_work))
+    {
+      work_queue(RCU_WORK, &g_rcu_work, rcu_worker, NULL, 0);
+    }
+
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * sched/rcu/rcu_readlock.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+#include "rcu/rcu.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The TCB that is running on this CPU.  Unlike this_task(), this does not
+ * change within an interrupt handler that readies another task.
+ */
+
+#define rcu_running_task() g_running_tasks[this_cpu()]
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter an RCU read-side critical section.  Pre-emption is disabled so
+ *   that a context switch on this CPU implies that the section has ended.
+ *   From an interrupt handler, the nesting count of the interrupted task
+ *   is raised so that the CPU keeps looking busy until the handler leaves
+ *   the section.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void)
+{
+  FAR struct tcb_s *tcb;
+
+  sched_lock();
+
+  tcb = rcu_running_task();
+  if (tcb != NULL)
+    {
+      DEBUGASSERT(tcb->rcu_nesting < INT16_MAX);
+      tcb->rcu_nesting++;
+    }
+
+  /* Order the nesting count before any read of protected data */
+
+  UP_DMB();
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave an RCU read-side critical section.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void)
+{
+  FAR struct tcb_s *tcb;
+
+  /* Complete all reads of protected data before the count drops */
+
+  UP_DMB();
+
+  tcb = rcu_running_task();
+  if (tcb != NULL)
+    {
+      DEBUGASSERT(tcb->rcu_nesting > 0);
+      tcb->rcu_nesting--;
+    }
+
+  sched_unlock();
+}
@@ -0,0 +1,121 @@
+/****************************************************************************
+ * sched/rcu/rcu_synchronize.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/signal.h>
+
+#include "sched/sched.h"
+#include "rcu/rcu.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+volatile uint32_t g_rcu_qs[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until all RCU read-side critical sections that were in progress
+ *   when this function was called have completed.
+ *
+ *   On a single CPU, readers can neither be preempted nor block, so no
+ *   reader can be in progress while the caller runs.  On SMP, each other
+ *   CPU must either be observed outside of a read-side critical section
+ *   or pass through a quiescent state (a context switch or the IDLE loop).
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from task context, outside of any read-side critical section.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+#ifdef CONFIG_SMP
+  uint32_t snap[CONFIG_SMP_NCPUS];
+  FAR struct tcb_s *tcb;
+  int cpu;
+#endif
+
+  DEBUGASSERT(!up_interrupt_context() && this_task()->rcu_nesting == 0);
+
+  /* Order the updates (unlinking the old objects) before looking at the
+   * state of the readers.
+   */
+
+  UP_DMB();
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      snap[cpu] = g_rcu_qs[cpu];
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (; ; )
+        {
+          tcb = g_running_tasks[cpu];
+          if (tcb == NULL || tcb->rcu_nesting == 0 ||
+              g_rcu_qs[cpu] != snap[cpu])
+            {
+              break;
+            }
+
+          /* Readers are short, but sleep rather than spin in case the
+           * reader is waiting for this CPU.
+           */
+
+          nxsig_usleep(USEC_PER_TICK);
+        }
+    }
+
+  /* Order the end of the grace period before the reclamation */
+
+  UP_DMB();
+#endif
+}
@@ -106,6 +106,25 @@
 #  define TLIST_BLOCKED(t)       __TLIST_HEAD(t)
 #endif
 
+/* SMP function call statistics are reported through /proc/smpcall */
+
+#if defined(CONFIG_SMP) && !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMPCALL)
+#  define HAVE_SMP_CALL_STATS 1
+#endif
+
+/* Scheduling latency histograms:  Bucket n counts the samples of up to
+ * 2^n - 1 perf counts, the last bucket also holds everything longer.
+ */
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+#  define LATENCY_READY    0  /* Ready-to-run until running */
+#  define LATENCY_IRQ      1  /* Interrupt handler execution */
+#  define LATENCY_SWITCH   2  /* Context switch */
+#  define LATENCY_NHIST    3
+#  define LATENCY_NBUCKETS 32
+#endif
+
 #ifdef CONFIG_SCHED_CRITMONITOR_MAXTIME_PANIC
 #  define CRITMONITOR_PANIC(fmt, ...) \
           do \
@@ -132,6 +151,18 @@ struct tasklist_s
   uint8_t attr;          /* List attribute flags */
 };
 
+#ifdef HAVE_SMP_CALL_STATS
+/* SMP function call counters of one target CPU */
+
+struct smp_call_stats_s
+{
+  uint32_t sent;         /* IPIs sent to the CPU */
+  uint32_t coalesced;    /* Calls queued behind an IPI already pending */
+  uint32_t handled;      /* IPIs handled by the CPU */
+  uint32_t calls;        /* Functions called by the CPU */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -197,6 +228,19 @@ extern dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
 
 extern FAR struct tcb_s *g_delivertasks[CONFIG_SMP_NCPUS];
 
+#ifdef HAVE_SMP_CALL_STATS
+/* Declared in sched_smp.c:  The SMP function call counters of each CPU */
+
+extern struct smp_call_stats_s g_smp_call_stats[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+/* Declared in sched_latency.c:  The latency histograms of each CPU */
+
+extern uint32_t
+g_latency_hist[CONFIG_SMP_NCPUS][LATENCY_NHIST][LATENCY_NBUCKETS];
+#endif
+
 /* This is the list of all tasks that are ready-to-run, but cannot be placed
  * in the g_readytorun list because:  (1) They are higher priority than the
  * currently active task at the head of the g_readytorun list, and (2) the
@@ -260,6 +304,12 @@ extern struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 extern volatile clock_t g_cpuload_total;
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+/* The number of clock ticks spent in interrupt handlers on each CPU */
+
+extern volatile clock_t g_cpuload_irq[CONFIG_SMP_NCPUS];
+#endif
+
 /* Declared in sched_lock.c *************************************************/
 
 /* Pre-emption is disabled via the interface sched_lock(). sched_lock()
@@ -305,6 +355,8 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
                     FAR void *stack_addr, int stack_size, main_t entry,
                     FAR char * const argv[], FAR char * const envp[]);
 
+void nxsched_tcb_initialize(void);
+
 /* Task list manipulation functions */
 
 bool nxsched_add_readytorun(FAR struct tcb_s *rtrtcb);
@@ -318,6 +370,18 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Constant time g_readytorun list manipulation */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+bool nxsched_add_prioindex(FAR struct tcb_s *tcb);
+void nxsched_remove_prioindex(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_add_prioindex(tcb) \
+     nxsched_add_prioritized(tcb, list_readytorun())
+#  define nxsched_remove_prioindex(tcb) \
+     dq_rem((FAR dq_entry_t *)(tcb), list_readytorun())
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -354,6 +418,15 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                            clock_t deadline, clock_t period);
+void nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -404,6 +477,10 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+void nxsched_process_irqload_ticks(int cpu, clock_t ticks);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -412,6 +489,12 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 void nxsched_update_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+void nxsched_critmon_irq(bool state);
+#else
+#  define nxsched_critmon_irq(s)
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
@@ -424,6 +507,17 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+/* Scheduling latency histograms */
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+void nxsched_latency_record(int hist, clock_t elapsed);
+void nxsched_latency_ready(FAR struct tcb_s *tcb);
+void nxsched_latency_suspend(FAR struct tcb_s *tcb);
+void nxsched_latency_resume(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_latency_ready(tcb)
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -438,24 +532,47 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+/* Return true if tcb has to be queued ahead of next in a prioritized list.
+ * Threads of equal priority are kept in FIFO order, except that deadline
+ * threads of equal priority are kept in Earliest Deadline First order.
+ */
+
+static inline_function bool nxsched_ahead(FAR struct tcb_s *tcb,
+                                          FAR struct tcb_s *next)
+{
+  if (tcb->sched_priority != next->sched_priority)
+    {
+      return tcb->sched_priority > next->sched_priority;
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      (next->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return (sclock_t)(tcb->dl.abstick - next->dl.abstick) < 0;
+    }
+#endif
+
+  return false;
+}
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
-  uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
   /* Lets do a sanity check before we get started. */
 
-  DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && !nxsched_ahead(tcb, next));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
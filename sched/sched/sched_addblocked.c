@@ -69,6 +69,15 @@ void nxsched_add_blocked(FAR struct tcb_s *btcb, tstate_t task_state)
 
   btcb->task_state = task_state;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Apply the CBS wakeup rule when the deadline thread is made ready */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      btcb->dl.blocked = true;
+    }
+
+#endif
   /* Add the TCB to the blocked task list associated with this state. */
 
   tasklist = TLIST_BLOCKED(btcb);
@@ -71,14 +71,26 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+  /* Start measuring the time until the task runs */
+
+  nxsched_latency_ready(btcb);
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread that is waking up may need a fresh deadline */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+
+#endif
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * preempted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (nxsched_islocked_tcb(rtcb) &&
-      rtcb->sched_priority < btcb->sched_priority)
+  if (nxsched_islocked_tcb(rtcb) && nxsched_ahead(btcb, rtcb))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -91,7 +103,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, list_readytorun()))
+  else if (nxsched_add_prioindex(btcb))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -162,6 +174,10 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+  /* Start measuring the time until the task runs */
+
+  nxsched_latency_ready(btcb);
+
   cpu = nxsched_select_cpu(btcb->affinity);
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -216,9 +232,22 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+      /* With per-CPU ready-to-run queues, the task is queued behind the
+       * running task of the selected CPU.  It cannot become the head of
+       * that list since its priority does not exceed the priority of the
+       * running task.
+       */
+
+      nxsched_add_prioritized(btcb, list_assignedtasks(cpu));
+
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+#else
       nxsched_add_prioritized(btcb, list_readytorun());
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
+#endif
       doswitch         = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * sched/sched/sched_alloctcb.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/kmem_cache.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KMEM_CACHE
+/* The cache of the TCBs of all kinds of threads.  Its objects are large
+ * enough for any of them, so a TCB can be freed without knowing what kind
+ * of thread it belonged to.
+ */
+
+static FAR struct kmem_cache_s *g_tcb_cache;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_tcb_initialize
+ *
+ * Description:
+ *   Create the cache of the TCBs.  This is called once the kernel heap is
+ *   available.
+ *
+ ****************************************************************************/
+
+void nxsched_tcb_initialize(void)
+{
+#ifdef CONFIG_MM_KMEM_CACHE
+  g_tcb_cache = kmem_cache_create("tcb", MAX(sizeof(struct task_tcb_s),
+                                             sizeof(struct pthread_tcb_s)),
+                                  NULL);
+  DEBUGASSERT(g_tcb_cache != NULL);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB.
+ *
+ * Input Parameters:
+ *   size - The size of the TCB:  sizeof(struct tcb_s) for a kernel thread,
+ *          sizeof(struct task_tcb_s) or sizeof(struct pthread_tcb_s).
+ *
+ * Returned Value:
+ *   The TCB on success; NULL if the memory is exhausted.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size)
+{
+#ifdef CONFIG_MM_KMEM_CACHE
+  DEBUGASSERT(size <= MAX(sizeof(struct task_tcb_s),
+                          sizeof(struct pthread_tcb_s)));
+  return kmem_cache_zalloc(g_tcb_cache);
+#else
+  return kmm_zalloc(size);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Free a TCB allocated by nxsched_alloc_tcb().
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_MM_KMEM_CACHE
+  kmem_cache_free(g_tcb_cache, tcb);
+#else
+  kmm_free(tcb);
+#endif
+}
@@ -86,6 +86,14 @@
 
 volatile clock_t g_cpuload_total;
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+/* The number of clock ticks spent in interrupt handlers on each CPU.  These
+ * are also included in g_cpuload_total.
+ */
+
+volatile clock_t g_cpuload_irq[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -123,29 +131,22 @@ static void cpuload_callback(wdparm_t arg)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxsched_process_taskload_ticks
+ * Name: cpuload_scale
  *
  * Description:
- *   Collect data that can be used for task load measurements.
+ *   Divide all tick counts by two when g_cpuload_total exceeds the time
+ *   constant.
  *
  * Input Parameters:
- *   tcb   - The task that we are performing the load operations on.
- *   ticks - The ticks that we process in this cpuload.
+ *   None
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, clock_t ticks)
+static void cpuload_scale(void)
 {
-  tcb->ticks += ticks;
-  g_cpuload_total += ticks;
-
   if (g_cpuload_total > CPULOAD_TIMECONSTANT)
     {
       uint32_t total = 0;
@@ -164,12 +165,71 @@ void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, clock_t ticks)
             }
         }
 
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          g_cpuload_irq[i] >>= 1;
+          total += g_cpuload_irq[i];
+        }
+#endif
+
       /* Save the new total. */
 
       g_cpuload_total = total;
     }
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_process_taskload_ticks
+ *
+ * Description:
+ *   Collect data that can be used for task load measurements.
+ *
+ * Input Parameters:
+ *   tcb   - The task that we are performing the load operations on.
+ *   ticks - The ticks that we process in this cpuload.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, clock_t ticks)
+{
+  tcb->ticks += ticks;
+  g_cpuload_total += ticks;
+  cpuload_scale();
+}
+
+/****************************************************************************
+ * Name: nxsched_process_irqload_ticks
+ *
+ * Description:
+ *   Collect data that can be used for the load measurements of interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU that executed the interrupt handlers.
+ *   ticks - The ticks that we process in this cpuload.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+void nxsched_process_irqload_ticks(int cpu, clock_t ticks)
+{
+  g_cpuload_irq[cpu] += ticks;
+  g_cpuload_total    += ticks;
+  cpuload_scale();
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_process_cpuload_ticks
  *
@@ -270,6 +330,42 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   return ret;
 }
 
+/****************************************************************************
+ * Name:  clock_cpuload_irq
+ *
+ * Description:
+ *   Return the load measurement data of the interrupt handlers of a CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU of interest
+ *   cpuload - The location to return the CPU load
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+int clock_cpuload_irq(int cpu, FAR struct cpuload_s *cpuload)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cpuload);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  cpuload->total  = g_cpuload_total;
+  cpuload->active = g_cpuload_irq[cpu];
+  leave_critical_section(flags);
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: cpuload_init
  *
@@ -100,10 +100,148 @@ clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+/* The code locations that take the global critical section */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+struct critmon_caller_s
+g_crit_callers[CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS];
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+/* The start time of the outermost interrupt handler on each CPU, the
+ * interrupt nesting level and the interrupt time not yet charged as ticks.
+ */
+
+static clock_t g_irq_start[CONFIG_SMP_NCPUS];
+static uint8_t g_irq_nest[CONFIG_SMP_NCPUS];
+static clock_t g_irq_rem[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_critmon_caller
+ *
+ * Description:
+ *   Account one use of the critical section to the code location that
+ *   entered it.  The table is an open addressed hash on the caller address
+ *   and callers that do not find a free slot are not accounted.
+ *
+ * Input Parameters:
+ *   caller  - The address of the function that entered the section
+ *   elapsed - The time the critical section was held
+ *
+ * Assumptions:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+static void nxsched_critmon_caller(FAR void *caller, clock_t elapsed)
+{
+  FAR struct critmon_caller_s *entry;
+  unsigned int index;
+  int i;
+
+  index = ((uintptr_t)caller >> 2) %
+          CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS; i++)
+    {
+      entry = &g_crit_callers[index];
+      if (entry->caller == caller || entry->caller == NULL)
+        {
+          entry->caller = caller;
+          entry->count++;
+          entry->total += elapsed;
+          if (elapsed > entry->max)
+            {
+              entry->max = elapsed;
+            }
+
+          return;
+        }
+
+      if (++index >= CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS)
+        {
+          index = 0;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_critmon_ticks
+ *
+ * Description:
+ *   Convert a time in perf counts to clock ticks.  The part of the time that
+ *   is less than one tick is kept in 'rem' and carried into the next
+ *   conversion, so that short runs are not lost.
+ *
+ * Input Parameters:
+ *   rem     - The remainder of the previous conversions
+ *   elapsed - The time in perf counts
+ *
+ * Returned Value:
+ *   The time in clock ticks
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+static clock_t nxsched_critmon_ticks(FAR clock_t *rem, clock_t elapsed)
+{
+  clock_t freq = perf_getfreq();
+  clock_t tick;
+
+  elapsed += *rem;
+  tick     = elapsed * CLOCKS_PER_SEC / freq;
+  *rem     = elapsed - tick * freq / CLOCKS_PER_SEC;
+
+  return tick;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_critmon_elapsed
+ *
+ * Description:
+ *   Return the time a running thread has run since run_start.  The time
+ *   spent in the current interrupt handler is charged to the interrupt.
+ *
+ * Input Parameters:
+ *   tcb     - The running thread
+ *   current - The current time
+ *
+ * Returned Value:
+ *   The time in perf counts
+ *
+ ****************************************************************************/
+
+static clock_t nxsched_critmon_elapsed(FAR struct tcb_s *tcb,
+                                       clock_t current)
+{
+  clock_t elapsed = current - tcb->run_start;
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+  int cpu = this_cpu();
+
+  if (g_irq_nest[cpu] > 0)
+    {
+      clock_t irqtime = current - g_irq_start[cpu];
+
+      elapsed = elapsed > irqtime ? elapsed - irqtime : 0;
+    }
+#endif
+
+  return elapsed;
+}
+
 /****************************************************************************
  * Name: nxsched_critmon_cpuload
  *
@@ -257,6 +395,10 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_CALLERS > 0
+      nxsched_critmon_caller(tcb->crit_caller, elapsed);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
@@ -323,11 +465,11 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
 {
   clock_t current = perf_gettime();
-  clock_t elapsed = current - tcb->run_start;
+  clock_t elapsed = nxsched_critmon_elapsed(tcb, current);
   int cpu = this_cpu();
 
 #ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
-  clock_t tick = elapsed * CLOCKS_PER_SEC / perf_getfreq();
+  clock_t tick = nxsched_critmon_ticks(&tcb->run_rem, elapsed);
   nxsched_critmon_cpuload(tcb, current, tick);
 #endif
 
@@ -396,7 +538,7 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
 void nxsched_update_critmon(FAR struct tcb_s *tcb)
 {
   clock_t current = perf_gettime();
-  clock_t elapsed = current - tcb->run_start;
+  clock_t elapsed = nxsched_critmon_elapsed(tcb, current);
 
   if (tcb->task_state != TSTATE_TASK_RUNNING)
     {
@@ -404,7 +546,7 @@ void nxsched_update_critmon(FAR struct tcb_s *tcb)
     }
 
 #ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
-  clock_t tick = elapsed * CLOCKS_PER_SEC / perf_getfreq();
+  clock_t tick = nxsched_critmon_ticks(&tcb->run_rem, elapsed);
   nxsched_process_taskload_ticks(tcb, tick);
 #endif
 
@@ -416,3 +558,66 @@ void nxsched_update_critmon(FAR struct tcb_s *tcb)
       CHECK_THREAD(tcb->pid, elapsed);
     }
 }
+
+/****************************************************************************
+ * Name: nxsched_critmon_irq
+ *
+ * Description:
+ *   Called when the outermost interrupt handler on a CPU is entered or
+ *   left.  The time spent in the handlers is charged to the interrupts of
+ *   the CPU and removed from the run time of the interrupted thread.
+ *
+ * Input Parameters:
+ *   state - True when entering the handler, false when leaving it
+ *
+ * Assumptions:
+ *   - Called from the interrupt handler with interrupts disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_IRQ
+void nxsched_critmon_irq(bool state)
+{
+  FAR struct tcb_s *tcb;
+  clock_t current;
+  clock_t elapsed;
+  int cpu = this_cpu();
+
+  if (state)
+    {
+      if (g_irq_nest[cpu]++ == 0)
+        {
+          g_irq_start[cpu] = perf_gettime();
+        }
+
+      return;
+    }
+
+  if (--g_irq_nest[cpu] > 0)
+    {
+      return;
+    }
+
+  current = perf_gettime();
+  elapsed = current - g_irq_start[cpu];
+
+  nxsched_process_irqload_ticks(cpu,
+                                nxsched_critmon_ticks(&g_irq_rem[cpu],
+                                                      elapsed));
+
+  /* Skip the interrupt in the run time of the interrupted thread.  If the
+   * thread was already switched out and in again by the handlers, it
+   * starts running now.
+   */
+
+  tcb = running_task();
+  if (current - tcb->run_start >= elapsed)
+    {
+      tcb->run_start += elapsed;
+    }
+  else
+    {
+      tcb->run_start = current;
+    }
+}
+#endif
@@ -0,0 +1,295 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are runtime/period fractions in 12.20 fixed point */
+
+#define DEADLINE_BW_SHIFT 20
+#define DEADLINE_BW_LIMIT \
+  ((uint32_t)(((uint64_t)CONFIG_SCHED_DEADLINE_MAXUTIL << \
+               DEADLINE_BW_SHIFT) / 100))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths reserved by all deadline threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Reserve the bandwidth for a thread that is switching to (or updating
+ *   the parameters of) the SCHED_DEADLINE policy and start its first
+ *   activation.  The thread is admitted only if the total bandwidth of all
+ *   deadline threads does not exceed CONFIG_SCHED_DEADLINE_MAXUTIL percent.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the thread
+ *   runtime  - The execution budget per period in clock ticks
+ *   deadline - The deadline relative to each activation in clock ticks
+ *   period   - The activation period in clock ticks
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL The parameters do not satisfy 0 < runtime <= deadline <= period
+ *   EBUSY  Admitting the thread would exceed the maximum utilization
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                           clock_t deadline, clock_t period)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+  uint64_t total;
+  uint32_t bw;
+
+  DEBUGASSERT(tcb != NULL);
+  dl = &tcb->dl;
+
+  if (runtime < 1 || deadline < runtime || period < deadline ||
+      runtime > INT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  bw = (uint32_t)(((uint64_t)runtime << DEADLINE_BW_SHIFT) / period);
+
+  /* Admission control.  A thread that is already admitted only has to
+   * account for the change in its own bandwidth.
+   */
+
+  flags = enter_critical_section();
+  total = (uint64_t)g_deadline_bw - dl->bandwidth + bw;
+  if (total > DEADLINE_BW_LIMIT)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  g_deadline_bw  = (uint32_t)total;
+
+  dl->runtime    = runtime;
+  dl->deadline   = deadline;
+  dl->period     = period;
+  dl->bandwidth  = bw;
+  dl->blocked    = false;
+
+  /* Start the first activation now */
+
+  dl->abstick    = clock_systime_ticks() + deadline;
+  tcb->timeslice = runtime;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Release the bandwidth reserved by a deadline thread that is changing
+ *   to another policy or exiting.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_deadline_bw >= tcb->dl.bandwidth);
+  g_deadline_bw     -= tcb->dl.bandwidth;
+  tcb->dl.bandwidth  = 0;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Apply the Constant Bandwidth Server wakeup rule to a deadline thread
+ *   that is becoming ready-to-run after having been blocked:  If the
+ *   remaining budget could not be consumed before the current deadline
+ *   without exceeding the reserved bandwidth, a new activation is started
+ *   with a fresh deadline and a full budget.  Otherwise the thread keeps
+ *   its current deadline and budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The thread uses the deadline scheduling policy
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->dl;
+  clock_t now;
+  sclock_t left;
+
+  if (!dl->blocked)
+    {
+      return;
+    }
+
+  dl->blocked = false;
+
+  now  = clock_systime_ticks();
+  left = (sclock_t)(dl->abstick - now);
+
+  /* budget / (abstick - now) > runtime / deadline ? */
+
+  if (left <= 0 ||
+      (uint64_t)MAX(tcb->timeslice, 0) * dl->deadline >
+      (uint64_t)left * dl->runtime)
+    {
+      dl->abstick    = now + dl->deadline;
+      tcb->timeslice = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the execution time of the running deadline thread against its
+ *   budget.  When the budget is exhausted, the deadline is postponed by one
+ *   period and the budget is replenished.  The thread is then requeued
+ *   behind any ready deadline thread with an earlier deadline.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently executing task
+ *   ticks - The number of ticks that have elapsed on the interval timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number if ticks remaining until the budget is exhausted.
+ *
+ *   The value one may returned under certain circumstances that probably
+ *   can't happen.  The value one is the minimal timer setup and it means
+ *   that a context switch is needed now, but cannot be performed because
+ *   noswitches == true.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The task associated with TCB uses the deadline scheduling policy
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches)
+{
+  FAR struct deadline_s *dl;
+  uint32_t ret;
+  int decr;
+
+  DEBUGASSERT(tcb != NULL);
+  dl = &tcb->dl;
+
+  /* Decrement the remaining budget */
+
+  decr = MIN(MAX(tcb->timeslice, 0), ticks);
+  tcb->timeslice -= decr;
+
+  /* Did the thread exhaust its budget? Postponing the deadline may
+   * preempt the thread, so wait until pre-emption is enabled.
+   */
+
+  ret = tcb->timeslice;
+  if (tcb->timeslice <= 0 && !nxsched_islocked_tcb(tcb))
+    {
+      if (noswitches)
+        {
+          ret = 1;
+        }
+      else
+        {
+          FAR struct tcb_s *rtcb = this_task();
+
+          /* Postpone the deadline and replenish the budget */
+
+          dl->abstick    += dl->period;
+          tcb->timeslice  = dl->runtime;
+          ret             = tcb->timeslice;
+
+          /* Give up the CPU if another deadline thread now has an earlier
+           * deadline.
+           */
+
+          if (tcb->flink != NULL && nxsched_ahead(tcb->flink, tcb) &&
+              nxsched_reprioritize_rtr(tcb, tcb->sched_priority))
+            {
+              up_switch_context(this_task(), rtcb);
+            }
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -36,6 +36,41 @@
 #include "clock/clock.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_get_deadline_param
+ *
+ * Description:
+ *   Return the parameters associated with SCHED_DEADLINE.  The parameters
+ *   are zero if the task does not use the deadline scheduling policy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+static void nxsched_get_deadline_param(FAR struct tcb_s *tcb,
+                                       FAR struct sched_param *param)
+{
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      clock_ticks2time(&param->sched_dl_runtime, tcb->dl.runtime);
+      clock_ticks2time(&param->sched_dl_deadline, tcb->dl.deadline);
+      clock_ticks2time(&param->sched_dl_period, tcb->dl.period);
+    }
+  else
+    {
+      param->sched_dl_runtime.tv_sec   = 0;
+      param->sched_dl_runtime.tv_nsec  = 0;
+      param->sched_dl_deadline.tv_sec  = 0;
+      param->sched_dl_deadline.tv_nsec = 0;
+      param->sched_dl_period.tv_sec    = 0;
+      param->sched_dl_period.tv_nsec   = 0;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -88,6 +123,9 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
       /* Return the priority if the calling task. */
 
       param->sched_priority = (int)rtcb->sched_priority;
+#ifdef CONFIG_SCHED_DEADLINE
+      nxsched_get_deadline_param(rtcb, param);
+#endif
     }
 
   /* This PID is not for the calling task, we will have to look it up */
@@ -138,6 +176,10 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
               param->sched_ss_init_budget.tv_nsec = 0;
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          nxsched_get_deadline_param(tcb, param);
+#endif
         }
 
       leave_critical_section(flags);
@@ -0,0 +1,443 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format:  One line for each non-empty bucket.  UPTO is the
+ * exclusive upper limit of the bucket in nanoseconds.
+ *
+ *            1111111111222222222233333333334444444
+ *   1234567890123456789012345678901234567890123456
+ *
+ *   HIST   CPU                 UPTO      COUNT
+ *   SSSSSS DDD DDDDDDDDDDDDDDDDDDDD DDDDDDDDDD
+ */
+
+#define HDR_FMT "HIST   CPU                 UPTO      COUNT\n"
+#define HIST_FMT "%-6s %3d %20" PRIu64 " %10" PRIu32 "\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define LATENCY_LINELEN 48
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct latency_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  char line[LATENCY_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     latency_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     latency_close(FAR struct file *filep);
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     latency_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     latency_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The histogram names as shown in procfs */
+
+static FAR const char *const g_latency_names[LATENCY_NHIST] =
+{
+  "ready",
+  "irq",
+  "switch"
+};
+
+/* The time the last context switch started on each CPU */
+
+static clock_t g_latency_switch[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The latency histograms of each CPU */
+
+uint32_t g_latency_hist[CONFIG_SMP_NCPUS][LATENCY_NHIST][LATENCY_NBUCKETS];
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_latency_operations =
+{
+  latency_open,   /* open */
+  latency_close,  /* close */
+  latency_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  latency_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  latency_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_open
+ ****************************************************************************/
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct latency_file_s *latfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  latfile = kmm_zalloc(sizeof(struct latency_file_s));
+  if (!latfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)latfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_close
+ ****************************************************************************/
+
+static int latency_close(FAR struct file *filep)
+{
+  FAR struct latency_file_s *latfile;
+
+  /* Recover our private data from the struct file instance */
+
+  latfile = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(latfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(latfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct latency_file_s *latfile;
+  struct timespec ts;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t ncopied;
+  uint32_t count;
+  uint64_t upto;
+  off_t offset;
+  int hist;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  latfile = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(latfile);
+
+  offset    = filep->f_pos;
+  remaining = buflen;
+
+  /* The first line to output is the header */
+
+  linesize = snprintf(latfile->line, LATENCY_LINELEN, HDR_FMT);
+  ncopied  = procfs_memcpy(latfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  buffer    += ncopied;
+  remaining -= ncopied;
+
+  /* Then one line for each non-empty bucket */
+
+  for (hist = 0; hist < LATENCY_NHIST && remaining > 0; hist++)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS && remaining > 0; cpu++)
+        {
+          for (i = 0; i < LATENCY_NBUCKETS && remaining > 0; i++)
+            {
+              count = g_latency_hist[cpu][hist][i];
+              if (count == 0)
+                {
+                  continue;
+                }
+
+              if (i < LATENCY_NBUCKETS - 1)
+                {
+                  perf_convert((clock_t)1 << i, &ts);
+                  upto = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+                }
+              else
+                {
+                  upto = UINT64_MAX;
+                }
+
+              linesize = snprintf(latfile->line, LATENCY_LINELEN,
+                                  HIST_FMT, g_latency_names[hist], cpu,
+                                  upto, count);
+              copysize = procfs_memcpy(latfile->line, linesize, buffer,
+                                       remaining, &offset);
+
+              ncopied   += copysize;
+              buffer    += copysize;
+              remaining -= copysize;
+            }
+        }
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += ncopied;
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: latency_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct latency_file_s *oldattr;
+  FAR struct latency_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct latency_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct latency_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct latency_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int latency_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "latency" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_latency_record
+ *
+ * Description:
+ *   Add one sample to a latency histogram of the current CPU.
+ *
+ * Input Parameters:
+ *   hist    - The histogram, one of LATENCY_READY, LATENCY_IRQ or
+ *             LATENCY_SWITCH
+ *   elapsed - The sample in perf counts
+ *
+ * Assumptions:
+ *   Interrupts are disabled on the current CPU.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_record(int hist, clock_t elapsed)
+{
+  int bucket = 0;
+
+  if (elapsed != 0)
+    {
+      bucket = flsll((long long)elapsed);
+      if (bucket >= LATENCY_NBUCKETS)
+        {
+          bucket = LATENCY_NBUCKETS - 1;
+        }
+    }
+
+  g_latency_hist[this_cpu()][hist][bucket]++;
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_ready
+ *
+ * Description:
+ *   Called when a thread is made ready-to-run.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_ready(FAR struct tcb_s *tcb)
+{
+  tcb->ready_time = perf_gettime();
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_suspend
+ *
+ * Description:
+ *   Called when a thread is switched out.  This starts the measurement of
+ *   the context switch and, if the thread was preempted, of the time it
+ *   stays ready-to-run.  If the thread blocks instead, the time is taken
+ *   again when it is made ready-to-run.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_suspend(FAR struct tcb_s *tcb)
+{
+  clock_t now = perf_gettime();
+
+  g_latency_switch[this_cpu()] = now;
+  tcb->ready_time              = now;
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_resume
+ *
+ * Description:
+ *   Called when a thread is switched in.  Records the context switch cost
+ *   and the time the thread was ready-to-run.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_resume(FAR struct tcb_s *tcb)
+{
+  clock_t now = perf_gettime();
+  int cpu = this_cpu();
+
+  if (g_latency_switch[cpu] != 0)
+    {
+      nxsched_latency_record(LATENCY_SWITCH, now - g_latency_switch[cpu]);
+      g_latency_switch[cpu] = 0;
+    }
+
+  if (tcb->ready_time != 0)
+    {
+      nxsched_latency_record(LATENCY_READY, now - tcb->ready_time);
+      tcb->ready_time = 0;
+    }
+}
+
+#endif /* CONFIG_SCHED_LATENCY_HISTOGRAM */
@@ -0,0 +1,283 @@
+/****************************************************************************
+ * sched/sched/sched_lockstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/lockstat.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The contended locks, an open addressed hash on the lock address.  The
+ * table is only taken with the _notrace spinlock calls, which are not
+ * accounted themselves.
+ */
+
+static struct lockstat_s g_lockstat[CONFIG_SCHED_LOCKSTAT];
+static spinlock_t g_lockstat_lock;
+
+/* The spinlock each CPU got after spinning, whose release is timed.  Only
+ * the innermost of nested contended spinlocks is.
+ */
+
+#ifdef CONFIG_SCHED_LOCKSTAT_SPINLOCK
+static FAR volatile spinlock_t *g_lockstat_spin[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_find
+ *
+ * Description:
+ *   Find the entry of a lock, or claim a free one if create is true.
+ *   Returns NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_s *lockstat_find(FAR void *lock, bool create)
+{
+  FAR struct lockstat_s *entry;
+  unsigned int index;
+  int i;
+
+  index = ((uintptr_t)lock >> 2) % CONFIG_SCHED_LOCKSTAT;
+
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT; i++)
+    {
+      entry = &g_lockstat[index];
+      if (entry->lock == lock)
+        {
+          return entry;
+        }
+
+      if (entry->lock == NULL)
+        {
+          if (!create)
+            {
+              return NULL;
+            }
+
+          entry->lock = lock;
+          return entry;
+        }
+
+      if (++index >= CONFIG_SCHED_LOCKSTAT)
+        {
+          index = 0;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lockstat_caller
+ *
+ * Description:
+ *   Count a wait of caller.  When the slots are full, the least frequent
+ *   caller is replaced and its count inherited ("space saving"), so that
+ *   the counts are upper bounds and the frequent callers are kept.
+ *
+ ****************************************************************************/
+
+static void lockstat_caller(FAR struct lockstat_s *entry, FAR void *caller)
+{
+  FAR struct lockstat_caller_s *slot = &entry->callers[0];
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_CALLERS; i++)
+    {
+      if (entry->callers[i].caller == caller)
+        {
+          entry->callers[i].count++;
+          return;
+        }
+
+      if (entry->callers[i].count < slot->count)
+        {
+          slot = &entry->callers[i];
+        }
+    }
+
+  slot->caller = caller;
+  slot->count++;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_wait
+ ****************************************************************************/
+
+void lockstat_wait(FAR void *lock, uint8_t type, FAR void *caller,
+                   clock_t start, bool hold)
+{
+  FAR struct lockstat_s *entry;
+  clock_t now = perf_gettime();
+  clock_t elapsed = now - start;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_notrace(&g_lockstat_lock);
+
+  entry = lockstat_find(lock, true);
+  if (entry != NULL)
+    {
+      entry->type = type;
+      entry->count++;
+      entry->wait += elapsed;
+      if (elapsed > entry->waitmax)
+        {
+          entry->waitmax = elapsed;
+        }
+
+      entry->acquired = hold ? now : 0;
+      lockstat_caller(entry, caller);
+    }
+
+  spin_unlock_irqrestore_notrace(&g_lockstat_lock, flags);
+
+  sched_note_printf_ip(NOTE_TAG_SCHED, (uintptr_t)caller,
+                       "lock %p wait %" PRIu64, 0, lock,
+                       (uint64_t)elapsed);
+}
+
+/****************************************************************************
+ * Name: lockstat_release
+ ****************************************************************************/
+
+void lockstat_release(FAR void *lock)
+{
+  FAR struct lockstat_s *entry;
+  clock_t now = perf_gettime();
+  clock_t elapsed;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_notrace(&g_lockstat_lock);
+
+  entry = lockstat_find(lock, false);
+  if (entry != NULL && entry->acquired != 0)
+    {
+      elapsed = now - entry->acquired;
+      entry->acquired = 0;
+      entry->nhold++;
+      entry->hold += elapsed;
+      if (elapsed > entry->holdmax)
+        {
+          entry->holdmax = elapsed;
+        }
+    }
+
+  spin_unlock_irqrestore_notrace(&g_lockstat_lock, flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_get
+ ****************************************************************************/
+
+bool lockstat_get(int index, FAR struct lockstat_s *stat)
+{
+  irqstate_t flags;
+
+  if (index < 0 || index >= CONFIG_SCHED_LOCKSTAT)
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave_notrace(&g_lockstat_lock);
+  memcpy(stat, &g_lockstat[index], sizeof(*stat));
+  spin_unlock_irqrestore_notrace(&g_lockstat_lock, flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: lockstat_reset
+ ****************************************************************************/
+
+void lockstat_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_notrace(&g_lockstat_lock);
+  memset(g_lockstat, 0, sizeof(g_lockstat));
+  spin_unlock_irqrestore_notrace(&g_lockstat_lock, flags);
+}
+
+#ifdef CONFIG_SCHED_LOCKSTAT_SPINLOCK
+/****************************************************************************
+ * Name: lockstat_spin_lock
+ *
+ * Description:
+ *   spin_lock() with accounting of the spinning.  Being out of line, the
+ *   return address is the code location that took the lock.
+ *
+ ****************************************************************************/
+
+void lockstat_spin_lock(FAR volatile spinlock_t *lock)
+{
+  clock_t start;
+
+  if (spin_trylock_notrace(lock))
+    {
+      return;
+    }
+
+  start = perf_gettime();
+  spin_lock_notrace(lock);
+
+  lockstat_wait((FAR void *)lock, LOCKSTAT_SPIN, return_address(0), start,
+                true);
+  g_lockstat_spin[this_cpu()] = lock;
+}
+
+/****************************************************************************
+ * Name: lockstat_spin_unlock
+ ****************************************************************************/
+
+void lockstat_spin_unlock(FAR volatile spinlock_t *lock)
+{
+  int cpu = this_cpu();
+
+  if (g_lockstat_spin[cpu] == lock)
+    {
+      g_lockstat_spin[cpu] = NULL;
+      lockstat_release((FAR void *)lock);
+    }
+}
+#endif
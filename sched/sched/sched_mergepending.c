@@ -71,7 +71,44 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_PRIORITY_BITMAP)
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *rtcb;
+  bool ret = false;
+
+  /* Do nothing if pre-emption is still disabled */
+
+  if (!nxsched_islocked_tcb(this_task()))
+    {
+      /* With the priority bitmap, each pending TCB is inserted in constant
+       * time so there is no need for a merge walk of the ready-to-run list.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)
+                     dq_remfirst(list_pendingtasks())) != NULL)
+        {
+          rtcb = this_task();
+          if (nxsched_add_prioindex(ptcb))
+            {
+              /* ptcb is now at the head of the ready-to-run list */
+
+              rtcb->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret = true;
+            }
+          else
+            {
+              ptcb->task_state = TSTATE_TASK_READYTORUN;
+            }
+        }
+    }
+
+  return ret;
+}
+#elif !defined(CONFIG_SMP)
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -107,7 +144,7 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && !nxsched_ahead(ptcb, rtcb));
                rtcb = rtcb->flink)
             {
             }
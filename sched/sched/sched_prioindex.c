@@ -0,0 +1,256 @@
+/****************************************************************************
+ * sched/sched/sched_prioindex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRIOINDEX_NLEVELS  (SCHED_PRIORITY_MAX + 1)
+#define PRIOINDEX_NWORDS   ((PRIOINDEX_NLEVELS + 31) >> 5)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The g_readytorun list is still an ordinary doubly linked list so that all
+ * existing list traversals keep working.  It is augmented with an index of
+ * the last TCB at each priority level and a bitmap of the non-empty
+ * levels.  The head of the list, the running task, is deliberately not
+ * indexed:  Its priority may be changed in place (for example by
+ * priority inheritance or by sched_lock()'ed priority changes) without
+ * removing it from the list.
+ */
+
+static FAR struct tcb_s *g_prio_tail[PRIOINDEX_NLEVELS];
+static uint32_t g_prio_bitmap[PRIOINDEX_NWORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_prioindex_lowest
+ *
+ * Description:
+ *   Return the lowest non-empty priority level that is greater than or
+ *   equal to 'priority' or -1 if there is no such level.  The search visits
+ *   at most PRIOINDEX_NWORDS words, independent of the number of tasks.
+ *
+ ****************************************************************************/
+
+static int nxsched_prioindex_lowest(int priority)
+{
+  uint32_t mask;
+  int word = priority >> 5;
+
+  mask = g_prio_bitmap[word] & (UINT32_MAX << (priority & 31));
+  while (mask == 0)
+    {
+      if (++word >= PRIOINDEX_NWORDS)
+        {
+          return -1;
+        }
+
+      mask = g_prio_bitmap[word];
+    }
+
+  return (word << 5) + ffs(mask) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_prioindex_link
+ *
+ * Description:
+ *   Add a TCB that is (or will be) located at the front of its priority
+ *   level (it directly follows the running task) to the index.
+ *
+ ****************************************************************************/
+
+static void nxsched_prioindex_link(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+
+  if (g_prio_tail[priority] == NULL)
+    {
+      g_prio_tail[priority] = tcb;
+      g_prio_bitmap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_prioindex_unlink
+ *
+ * Description:
+ *   Remove an indexed TCB from the index.  The TCB is still linked in the
+ *   g_readytorun list.
+ *
+ ****************************************************************************/
+
+static void nxsched_prioindex_unlink(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev;
+  int priority = tcb->sched_priority;
+
+  if (g_prio_tail[priority] == tcb)
+    {
+      /* The previous TCB belongs to the same level only if it has the same
+       * priority and is itself indexed (i.e., it is not the head).
+       */
+
+      prev = tcb->blink;
+      if (prev != NULL && prev->blink != NULL &&
+          prev->sched_priority == priority)
+        {
+          g_prio_tail[priority] = prev;
+        }
+      else
+        {
+          g_prio_tail[priority] = NULL;
+          g_prio_bitmap[priority >> 5] &= ~((uint32_t)1 << (priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_add_prioindex
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list in constant time.  The TCB is placed
+ *   after all other tasks of the same or higher priority, exactly as
+ *   nxsched_add_prioritized() would place it.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to be added
+ *
+ * Returned Value:
+ *   true if the TCB was added at the head of the g_readytorun list.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+bool nxsched_add_prioindex(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = list_readytorun();
+  FAR struct tcb_s *head = (FAR struct tcb_s *)list->head;
+  FAR struct tcb_s *prev;
+  int priority = tcb->sched_priority;
+  int level;
+
+  DEBUGASSERT(priority < PRIOINDEX_NLEVELS);
+
+  if (head == NULL)
+    {
+      /* Special case:  The list is empty (only during IDLE start-up) */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  if (priority > head->sched_priority)
+    {
+      /* The new TCB becomes the head of the list.  The previous head is now
+       * the first TCB at its priority level.
+       */
+
+      nxsched_prioindex_link(head);
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  /* Insert after the tail of the lowest non-empty level at or above the
+   * new priority or, if there is none, right after the head.
+   */
+
+  level = nxsched_prioindex_lowest(priority);
+  prev  = level < 0 ? head : g_prio_tail[level];
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+
+  g_prio_tail[priority] = tcb;
+  g_prio_bitmap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_prioindex
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list in constant time.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_remove_prioindex(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = list_readytorun();
+  FAR struct tcb_s *next;
+
+  if (tcb->blink == NULL)
+    {
+      /* Removing the head:  Its successor becomes the new, unindexed
+       * head of the list.
+       */
+
+      next = tcb->flink;
+      if (next != NULL)
+        {
+          nxsched_prioindex_unlink(next);
+        }
+    }
+  else
+    {
+      nxsched_prioindex_unlink(tcb);
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
@@ -0,0 +1,239 @@
+/****************************************************************************
+ * sched/sched/sched_profiler.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/profiler.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The samples of one CPU.  Only that CPU writes them, from its interrupt
+ * handlers, and a sample is complete before nsamples counts it.
+ */
+
+struct profiler_cpu_s
+{
+  uint32_t nsamples;
+  struct profiler_sample_s sample[CONFIG_SCHED_PROFILER_NSAMPLES];
+};
+
+struct profiler_s
+{
+  struct wdog_s timer;           /* Samples all the CPUs                    */
+  clock_t period;                /* Of the timer, in ticks                  */
+  volatile bool running;
+  atomic_t dropped;
+  struct profiler_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int profiler_timer_cpu(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct profiler_s g_profiler;
+
+#ifdef CONFIG_SMP
+static struct smp_call_data_s g_profiler_call =
+SMP_CALL_INITIALIZER(profiler_timer_cpu, &g_profiler);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profiler_timer_cpu / profiler_timer
+ *
+ * Description:
+ *   Sample this CPU and, from the timer, ask the others to sample theirs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int profiler_timer_cpu(FAR void *arg)
+{
+  profiler_sample(PROFILER_EVENT_TIMER);
+  return OK;
+}
+#endif
+
+static void profiler_timer(wdparm_t arg)
+{
+  FAR struct profiler_s *prof = (FAR struct profiler_s *)(uintptr_t)arg;
+
+  if (!prof->running)
+    {
+      return;
+    }
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_profiler_call);
+#endif
+
+  profiler_sample(PROFILER_EVENT_TIMER);
+  wd_start(&prof->timer, prof->period, profiler_timer, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profiler_start
+ ****************************************************************************/
+
+void profiler_start(unsigned int rate)
+{
+  FAR struct profiler_s *prof = &g_profiler;
+  int i;
+
+  profiler_stop();
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      prof->cpu[i].nsamples = 0;
+    }
+
+  atomic_set(&prof->dropped, 0);
+  prof->running = true;
+
+  if (rate > 0)
+    {
+      prof->period = NSEC2TICK(NSEC_PER_SEC / rate);
+      if (prof->period == 0)
+        {
+          prof->period = 1;
+        }
+
+      wd_start(&prof->timer, prof->period, profiler_timer,
+               (wdparm_t)(uintptr_t)prof);
+    }
+}
+
+/****************************************************************************
+ * Name: profiler_stop
+ ****************************************************************************/
+
+void profiler_stop(void)
+{
+  g_profiler.running = false;
+  wd_cancel(&g_profiler.timer);
+}
+
+/****************************************************************************
+ * Name: profiler_sample
+ ****************************************************************************/
+
+void profiler_sample(uint8_t event)
+{
+  FAR struct profiler_s *prof = &g_profiler;
+  FAR struct profiler_cpu_s *cpu;
+  FAR struct profiler_sample_s *sample;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int depth;
+
+  if (!prof->running)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+
+  cpu = &prof->cpu[this_cpu()];
+  if (cpu->nsamples >= CONFIG_SCHED_PROFILER_NSAMPLES)
+    {
+      atomic_fetch_add(&prof->dropped, 1);
+      up_irq_restore(flags);
+      return;
+    }
+
+  /* The interrupted PC comes first, then the frames of its call stack */
+
+  tcb    = running_task();
+  sample = &cpu->sample[cpu->nsamples];
+
+  sample->time     = perf_gettime();
+  sample->pid      = tcb->pid;
+  sample->cpu      = this_cpu();
+  sample->event    = event;
+  sample->stack[0] = (FAR void *)up_getusrpc(NULL);
+
+  depth = up_backtrace(tcb, &sample->stack[1],
+                       CONFIG_SCHED_PROFILER_DEPTH - 1,
+                       CONFIG_SCHED_PROFILER_SKIP);
+  sample->depth = 1 + (depth > 0 ? depth : 0);
+
+  cpu->nsamples++;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: profiler_get
+ ****************************************************************************/
+
+int profiler_get(int cpu, int index, FAR struct profiler_sample_s *sample)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || index < 0 ||
+      index >= g_profiler.cpu[cpu].nsamples)
+    {
+      return -ENOENT;
+    }
+
+  *sample = g_profiler.cpu[cpu].sample[index];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profiler_dropped
+ ****************************************************************************/
+
+uint32_t profiler_dropped(void)
+{
+  return atomic_read(&g_profiler.dropped);
+}
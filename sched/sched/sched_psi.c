@@ -0,0 +1,320 @@
+/****************************************************************************
+ * sched/sched/sched_psi.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/psi.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PSI_SAMPLE_TICKS    MAX(MSEC2TICK(CONFIG_SCHED_PSI_SAMPLE_MS), 1)
+
+/* The averages are updated every two seconds, as in Linux */
+
+#define PSI_PERIOD_USEC     (2 * USEC_PER_SEC)
+
+/* The decay factors are in units of 1/2048 */
+
+#define PSI_FSHIFT          11
+#define PSI_FIXED_1         (1 << PSI_FSHIFT)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct psi_res_s
+{
+  uint64_t total[PSI_NKINDS];             /* Stall time in us */
+  uint64_t last[PSI_NKINDS];              /* Total at the period start */
+  uint16_t avg[PSI_NKINDS][PSI_NAVGS];    /* Running averages */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* e^(-2/10), e^(-2/60) and e^(-2/300): the weight of the old average for
+ * a two second period.
+ */
+
+static const uint16_t g_psi_exp[PSI_NAVGS] =
+{
+  1677, 1981, 2034
+};
+
+static struct psi_res_s g_psi[PSI_NRES];
+static atomic_t g_psi_nstall[PSI_NRES];
+static uint32_t g_psi_period;
+static struct wdog_s g_psi_wdog;
+static spinlock_t g_psi_lock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psi_cpu_waiting
+ *
+ * Description:
+ *   Tell whether some task is ready to run but not running.  This is a
+ *   sample taken without locking, as the CPU load one is.
+ *
+ ****************************************************************************/
+
+static bool psi_cpu_waiting(void)
+{
+  FAR struct tcb_s *next;
+  int i;
+
+  if (!dq_empty(list_pendingtasks()))
+    {
+      return true;
+    }
+
+#ifdef CONFIG_SMP
+  if (!dq_empty(list_readytorun()))
+    {
+      return true;
+    }
+#endif
+
+  /* The IDLE task is always last: anything else behind the running task
+   * is waiting for the CPU.
+   */
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      next = current_task(i)->flink;
+      if (next != NULL && !is_idle_task(next))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: psi_cpu_busy
+ *
+ * Description:
+ *   Tell whether some CPU runs a task other than its IDLE task.
+ *
+ ****************************************************************************/
+
+static bool psi_cpu_busy(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (!is_idle_task(current_task(i)))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: psi_calc_avg
+ *
+ * Description:
+ *   Decay an average towards pct, rounding up while it grows so that it
+ *   can reach 100% and down while it shrinks so that it can reach 0.
+ *
+ ****************************************************************************/
+
+static uint16_t psi_calc_avg(uint16_t avg, uint32_t exp, uint32_t pct)
+{
+  uint32_t newavg = avg * exp + pct * (PSI_FIXED_1 - exp);
+
+  if (pct >= avg)
+    {
+      newavg += PSI_FIXED_1 - 1;
+    }
+
+  return newavg >> PSI_FSHIFT;
+}
+
+/****************************************************************************
+ * Name: psi_update_avgs
+ ****************************************************************************/
+
+static void psi_update_avgs(void)
+{
+  FAR struct psi_res_s *psi;
+  uint64_t pct;
+  int res;
+  int kind;
+  int i;
+
+  for (res = 0; res < PSI_NRES; res++)
+    {
+      psi = &g_psi[res];
+      for (kind = 0; kind < PSI_NKINDS; kind++)
+        {
+          pct = (psi->total[kind] - psi->last[kind]) * PSI_AVG_ONE /
+                g_psi_period;
+          pct = MIN(pct, PSI_AVG_ONE);
+          psi->last[kind] = psi->total[kind];
+
+          for (i = 0; i < PSI_NAVGS; i++)
+            {
+              psi->avg[kind][i] = psi_calc_avg(psi->avg[kind][i],
+                                               g_psi_exp[i], pct);
+            }
+        }
+    }
+
+  g_psi_period = 0;
+}
+
+/****************************************************************************
+ * Name: psi_callback
+ *
+ * Description:
+ *   Sample the stall state and charge the whole sampling period to it.
+ *
+ ****************************************************************************/
+
+static void psi_callback(wdparm_t arg)
+{
+  uint64_t total[PSI_NRES][PSI_NKINDS];
+  bool stall[PSI_NRES][PSI_NKINDS];
+  uint32_t usec = TICK2USEC(PSI_SAMPLE_TICKS);
+  irqstate_t flags;
+  bool busy;
+  int res;
+  int kind;
+
+  flags = spin_lock_irqsave(&g_psi_lock);
+
+  /* There is no "full" CPU stall for the whole system: a CPU is never
+   * idle while a task waits for it.
+   */
+
+  busy                     = psi_cpu_busy();
+  stall[PSI_CPU][PSI_SOME] = psi_cpu_waiting();
+  stall[PSI_CPU][PSI_FULL] = false;
+
+  for (res = PSI_MEM; res < PSI_NRES; res++)
+    {
+      stall[res][PSI_SOME] = atomic_read(&g_psi_nstall[res]) > 0;
+      stall[res][PSI_FULL] = stall[res][PSI_SOME] && !busy;
+    }
+
+  for (res = 0; res < PSI_NRES; res++)
+    {
+      for (kind = 0; kind < PSI_NKINDS; kind++)
+        {
+          if (stall[res][kind])
+            {
+              g_psi[res].total[kind] += usec;
+            }
+
+          total[res][kind] = g_psi[res].total[kind];
+        }
+    }
+
+  g_psi_period += usec;
+  if (g_psi_period >= PSI_PERIOD_USEC)
+    {
+      psi_update_avgs();
+    }
+
+  spin_unlock_irqrestore(&g_psi_lock, flags);
+
+  for (res = 0; res < PSI_NRES; res++)
+    {
+      if (stall[res][PSI_SOME])
+        {
+          psi_notify_pressure(res, total[res]);
+        }
+    }
+
+  wd_start(&g_psi_wdog, PSI_SAMPLE_TICKS, psi_callback, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psi_stall_enter / psi_stall_leave
+ ****************************************************************************/
+
+void psi_stall_enter(enum psi_res_e res)
+{
+  atomic_fetch_add_relaxed(&g_psi_nstall[res], 1);
+}
+
+void psi_stall_leave(enum psi_res_e res)
+{
+  atomic_fetch_sub_relaxed(&g_psi_nstall[res], 1);
+}
+
+/****************************************************************************
+ * Name: psi_get
+ ****************************************************************************/
+
+void psi_get(enum psi_res_e res, FAR struct psi_stat_s *stat)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_psi_lock);
+  memcpy(stat->total, g_psi[res].total, sizeof(stat->total));
+  memcpy(stat->avg, g_psi[res].avg, sizeof(stat->avg));
+  spin_unlock_irqrestore(&g_psi_lock, flags);
+}
+
+/****************************************************************************
+ * Name: psi_init
+ *
+ * Description:
+ *   Start sampling the stall state.
+ *
+ ****************************************************************************/
+
+void psi_init(void)
+{
+  wd_start(&g_psi_wdog, PSI_SAMPLE_TICKS, psi_callback, 0);
+}
@@ -35,6 +35,77 @@
 #include "sched/queue.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_steal_task
+ *
+ * Description:
+ *   Find the highest priority, non-running task queued on the assigned task
+ *   list of another CPU that is permitted to run on 'cpu' and move it to
+ *   the g_readytorun list so that it will be selected by the caller.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU that is running out of work
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_PERCPU_READYTORUN)
+static void nxsched_steal_task(int cpu)
+{
+  FAR struct tcb_s *victim = NULL;
+  FAR struct tcb_s *rtrtcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* The lists are prioritized, so the first eligible task is the
+       * best candidate on CPU i.
+       */
+
+      for (rtrtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+           !is_idle_task(rtrtcb); rtrtcb = rtrtcb->flink)
+        {
+          if (rtrtcb->task_state != TSTATE_TASK_RUNNING &&
+              CPU_ISSET(cpu, &rtrtcb->affinity))
+            {
+              if (victim == NULL ||
+                  rtrtcb->sched_priority > victim->sched_priority)
+                {
+                  victim = rtrtcb;
+                }
+
+              break;
+            }
+        }
+    }
+
+  if (victim != NULL)
+    {
+      /* The victim is always between the running task and the IDLE task
+       * of its CPU, so it can be removed with dq_rem_mid().
+       */
+
+      dq_rem_mid(victim);
+      victim->task_state = TSTATE_TASK_READYTORUN;
+      nxsched_add_prioritized(victim, &g_readytorun);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,11 +135,8 @@
 #ifndef CONFIG_SMP
 bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
 {
-  FAR dq_queue_t *tasklist;
   bool doswitch = false;
 
-  tasklist = TLIST_HEAD(rtcb);
-
   /* Check if the TCB to be removed is at the head of the ready to run list.
    * There is only one list, g_readytorun, and it always contains the
    * currently running task.  If we are removing the head of this list,
@@ -93,7 +161,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+  nxsched_remove_prioindex(rtcb);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -184,6 +252,17 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
 
   dq_rem_head((FAR dq_entry_t *)tcb, tasklist);
 
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  /* With per-CPU ready-to-run queues, only the local queue is consulted
+   * unless there is nothing left to run on this CPU but its IDLE task.
+   * In that case, try to steal work from one of the peer CPUs.
+   */
+
+  if (is_idle_task(nxttcb))
+    {
+      nxsched_steal_task(cpu);
+    }
+#else
   /* Find the highest priority non-running tasks in the g_assignedtasks
    * list of other CPUs, and also non-idle tasks, place them in the
    * g_readytorun list. so as to find the task with the highest priority,
@@ -224,6 +303,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
             }
         }
     }
+#endif
 
   /* Which task will go at the head of the list?  It will be either the
    * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -33,6 +33,7 @@
 #include <nuttx/sched_note.h>
 
 #include "irq/irq.h"
+#include "rcu/rcu.h"
 #include "sched/sched.h"
 
 #if defined(CONFIG_SCHED_RESUMESCHEDULER)
@@ -68,6 +69,14 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+  /* A context switch is a quiescent state for RCU */
+
+  nxrcu_quiescent();
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  nxsched_latency_resume(tcb);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
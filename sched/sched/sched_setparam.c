@@ -73,6 +73,7 @@
  *          current scheduling policy.
  *   EPERM  The calling task does not have appropriate privileges.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control rejected the new parameters.
  *
  ****************************************************************************/
 
@@ -205,6 +206,24 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  This also starts a
+   * new activation of the thread.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      ret = nxsched_start_deadline(tcb,
+                      clock_time2ticks(&param->sched_dl_runtime),
+                      clock_time2ticks(&param->sched_dl_deadline),
+                      clock_time2ticks(&param->sched_dl_period));
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
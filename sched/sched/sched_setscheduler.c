@@ -74,6 +74,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control rejected the thread.
  *
  ****************************************************************************/
 
@@ -93,6 +94,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -134,6 +138,17 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release the bandwidth reserved under the deadline policy */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      policy != SCHED_DEADLINE)
+    {
+      nxsched_stop_deadline(tcb);
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -152,7 +167,8 @@ int nxsched_set_scheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags     |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice  = 0;
 #endif
         }
@@ -269,6 +285,31 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Reserve the bandwidth and start the first activation.  A
+           * thread that was already using the deadline policy keeps its
+           * old parameters if the new ones are rejected.
+           */
+
+          ret = nxsched_start_deadline(tcb,
+                          clock_time2ticks(&param->sched_dl_runtime),
+                          clock_time2ticks(&param->sched_dl_deadline),
+                          clock_time2ticks(&param->sched_dl_period));
+          if (ret >= 0 || tcb->dl.bandwidth != 0)
+            {
+              tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
@@ -279,7 +320,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -36,6 +36,16 @@
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef HAVE_SMP_CALL_STATS
+#  define smp_call_stats_inc(cpu, field) (g_smp_call_stats[cpu].field++)
+#else
+#  define smp_call_stats_inc(cpu, field)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -53,6 +63,21 @@ struct smp_call_cookie_s
 static sq_queue_t g_smp_call_queue[CONFIG_SMP_NCPUS];
 static spinlock_t g_smp_call_lock;
 
+/* True if an IPI was sent to the CPU and its handler has not yet started
+ * draining the call queue.  Calls queued in the meantime need no IPI of
+ * their own.
+ */
+
+static bool g_smp_call_pending[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_SMP_CALL_STATS
+struct smp_call_stats_s g_smp_call_stats[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -68,14 +93,16 @@ static spinlock_t g_smp_call_lock;
  *   data  - Call data
  *
  * Returned Value:
- *   None
+ *   True if an IPI has to be sent to the target cpu; false if the call is
+ *   coalesced with an IPI that is already pending.
  *
  ****************************************************************************/
 
-static void nxsched_smp_call_add(int cpu,
+static bool nxsched_smp_call_add(int cpu,
                                  FAR struct smp_call_data_s *data)
 {
   irqstate_t flags;
+  bool sendipi;
 
   flags = spin_lock_irqsave(&g_smp_call_lock);
   if (!sq_inqueue(&data->node[cpu], &g_smp_call_queue[cpu]))
@@ -83,7 +110,19 @@ static void nxsched_smp_call_add(int cpu,
       sq_addlast(&data->node[cpu], &g_smp_call_queue[cpu]);
     }
 
+  sendipi = !g_smp_call_pending[cpu];
+  if (sendipi)
+    {
+      g_smp_call_pending[cpu] = true;
+      smp_call_stats_inc(cpu, sent);
+    }
+  else
+    {
+      smp_call_stats_inc(cpu, coalesced);
+    }
+
   spin_unlock_irqrestore(&g_smp_call_lock, flags);
+  return sendipi;
 }
 
 /****************************************************************************
@@ -116,6 +155,11 @@ int nxsched_smp_call_handler(int irq, FAR void *context,
 
   irqstate_t flags = spin_lock_irqsave(&g_smp_call_lock);
 
+  /* Calls queued from now on are not covered by this IPI */
+
+  g_smp_call_pending[cpu] = false;
+  smp_call_stats_inc(cpu, handled);
+
   call_queue = &g_smp_call_queue[cpu];
 
   sq_for_every_safe(call_queue, curr, next)
@@ -131,6 +175,7 @@ int nxsched_smp_call_handler(int irq, FAR void *context,
       ret = data->func(data->arg);
 
       flags = spin_lock_irqsave(&g_smp_call_lock);
+      smp_call_stats_inc(cpu, calls);
 
       if (data->cookie != NULL)
         {
@@ -303,6 +348,7 @@ int nxsched_smp_call_single_async(int cpuid,
 int nxsched_smp_call_async(cpu_set_t cpuset,
                            FAR struct smp_call_data_s *data)
 {
+  cpu_set_t ipiset;
   int cpucnt;
   int ret = OK;
   int i;
@@ -336,11 +382,18 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
       goto out;
     }
 
+  /* Only interrupt the CPUs that do not already have an IPI pending */
+
+  CPU_ZERO(&ipiset);
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       if (CPU_ISSET(i, &cpuset))
         {
-          nxsched_smp_call_add(i, data);
+          if (nxsched_smp_call_add(i, data))
+            {
+              CPU_SET(i, &ipiset);
+            }
+
           if (--cpucnt == 0)
             {
               break;
@@ -348,7 +401,10 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
         }
     }
 
-  up_send_smp_call(cpuset);
+  if (CPU_COUNT(&ipiset) > 0)
+    {
+      up_send_smp_call(ipiset);
+    }
 
 out:
   if (!up_interrupt_context())
@@ -0,0 +1,302 @@
+/****************************************************************************
+ * sched/sched/sched_smpprocfs.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#ifdef HAVE_SMP_CALL_STATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *            1111111111222222222233333333334444444444
+ *   1234567890123456789012345678901234567890123456789
+ *
+ *   CPU       SENT  COALESCED    HANDLED      CALLS
+ *   DDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ */
+
+#define HDR_FMT "CPU       SENT  COALESCED    HANDLED      CALLS\n"
+#define CPU_FMT "%3d %10lu %10lu %10lu %10lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define SMPCALL_LINELEN 52
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct smpcall_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  char line[SMPCALL_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     smpcall_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     smpcall_close(FAR struct file *filep);
+static ssize_t smpcall_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     smpcall_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     smpcall_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_smpcall_operations =
+{
+  smpcall_open,   /* open */
+  smpcall_close,  /* close */
+  smpcall_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  smpcall_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  smpcall_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smpcall_open
+ ****************************************************************************/
+
+static int smpcall_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct smpcall_file_s *smpfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  smpfile = kmm_zalloc(sizeof(struct smpcall_file_s));
+  if (!smpfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)smpfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smpcall_close
+ ****************************************************************************/
+
+static int smpcall_close(FAR struct file *filep)
+{
+  FAR struct smpcall_file_s *smpfile;
+
+  /* Recover our private data from the struct file instance */
+
+  smpfile = (FAR struct smpcall_file_s *)filep->f_priv;
+  DEBUGASSERT(smpfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(smpfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smpcall_read
+ ****************************************************************************/
+
+static ssize_t smpcall_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct smpcall_file_s *smpfile;
+  struct smp_call_stats_s stats;
+  irqstate_t flags;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t ncopied;
+  off_t offset;
+  int cpu;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  smpfile = (FAR struct smpcall_file_s *)filep->f_priv;
+  DEBUGASSERT(smpfile);
+
+  offset    = filep->f_pos;
+  remaining = buflen;
+
+  /* The first line to output is the header */
+
+  linesize = snprintf(smpfile->line, SMPCALL_LINELEN, HDR_FMT);
+  ncopied  = procfs_memcpy(smpfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  buffer    += ncopied;
+  remaining -= ncopied;
+
+  /* Then one line for each CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && remaining > 0; cpu++)
+    {
+      flags = enter_critical_section();
+      memcpy(&stats, &g_smp_call_stats[cpu], sizeof(stats));
+      leave_critical_section(flags);
+
+      linesize = snprintf(smpfile->line, SMPCALL_LINELEN, CPU_FMT, cpu,
+                          (unsigned long)stats.sent,
+                          (unsigned long)stats.coalesced,
+                          (unsigned long)stats.handled,
+                          (unsigned long)stats.calls);
+      copysize = procfs_memcpy(smpfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      ncopied   += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += ncopied;
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: smpcall_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int smpcall_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct smpcall_file_s *oldattr;
+  FAR struct smpcall_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct smpcall_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct smpcall_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct smpcall_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smpcall_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int smpcall_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "smpcall" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* HAVE_SMP_CALL_STATS */
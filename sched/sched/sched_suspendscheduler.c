@@ -77,6 +77,10 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+  nxsched_latency_suspend(tcb);
+#endif
+
   /* Indicate that the task has been suspended */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
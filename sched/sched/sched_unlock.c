@@ -162,6 +162,31 @@ void sched_unlock(void)
             }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* If (1) the task that was running supported deadline scheduling
+           * and (2) if its runtime budget has already been exhausted, but
+           * (3) its deadline could not be postponed because pre-emption
+           * was disabled, then postpone the deadline now.  This may also
+           * swap the task out in favor of an earlier deadline.
+           */
+
+          if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE
+              && rtcb->timeslice <= 0 && rtcb == this_task())
+            {
+              nxsched_process_deadline(rtcb, 0, false);
+
+#  ifdef CONFIG_SCHED_TICKLESS
+              if (rtcb == this_task() &&
+                  (rtcb->flags & TCB_FLAG_PREEMPT_SCHED) == 0)
+                {
+                  rtcb->flags |= TCB_FLAG_PREEMPT_SCHED;
+                  nxsched_reassess_timer();
+                  rtcb->flags &= ~TCB_FLAG_PREEMPT_SCHED;
+                }
+#  endif
+            }
+#endif
+
           leave_critical_section_wo_note(flags);
         }
     }
@@ -32,6 +32,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/lockstat.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -93,6 +94,10 @@ int nxsem_post_slow(FAR sem_t *sem)
 
       DEBUGASSERT(!up_interrupt_context());
 
+#if CONFIG_SCHED_LOCKSTAT > 0
+      lockstat_release(sem);
+#endif
+
       /* Lock the mutex for us by setting the blocking bit */
 
       mholder = atomic_fetch_or(NXSEM_MHOLDER(sem), NXSEM_MBLOCKING_BIT);
@@ -33,6 +33,8 @@
 #include <nuttx/init.h>
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/lockstat.h>
 #include <nuttx/mm/kmap.h>
 
 #include "sched/sched.h"
@@ -77,6 +79,12 @@ int nxsem_wait_slow(FAR sem_t *sem)
   bool unlocked;
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
+#if CONFIG_SCHED_LOCKSTAT > 0
+  FAR void *lockstat_lock = sem;
+  FAR void *caller = NULL;
+  clock_t start = 0;
+  bool stat = false;
+#endif
 
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
@@ -163,6 +171,28 @@ int nxsem_wait_slow(FAR sem_t *sem)
 
       DEBUGASSERT(rtcb->waitobj == NULL);
 
+#if CONFIG_SCHED_LOCKSTAT > 0
+      /* Counting semaphores are often waited for events rather than as
+       * locks, so they are only accounted on request.
+       */
+
+#  ifndef CONFIG_SCHED_LOCKSTAT_SEMAPHORE
+      if (mutex)
+#  endif
+        {
+#  ifdef CONFIG_SCHED_BACKTRACE
+          if (sched_backtrace(rtcb->pid, &caller, 1,
+                              CONFIG_SCHED_LOCKSTAT_BACKTRACE_SKIP) <= 0)
+#  endif
+            {
+              caller = return_address(0);
+            }
+
+          start = perf_gettime();
+          stat  = true;
+        }
+#endif
+
 #ifdef CONFIG_MM_KMAP
       sem = kmm_map_user(rtcb, sem, sizeof(*sem));
 #endif
@@ -278,7 +308,25 @@ int nxsem_wait_slow(FAR sem_t *sem)
         dq_empty(SEM_WAITLIST(sem)) ? 0 : NXSEM_MBLOCKING_BIT;
 
       atomic_set(NXSEM_MHOLDER(sem), ((uint32_t)rtcb->pid) | blocking_bit);
+
+#if CONFIG_SCHED_LOCKSTAT > 0
+      /* The hold time is only measured when the release is sure to take
+       * the slow path, i.e. while other tasks are still waiting.
+       */
+
+      if (stat)
+        {
+          lockstat_wait(lockstat_lock, LOCKSTAT_MUTEX, caller, start,
+                        blocking_bit != 0);
+        }
+#endif
     }
+#if CONFIG_SCHED_LOCKSTAT > 0
+  else if (stat && ret == OK)
+    {
+      lockstat_wait(lockstat_lock, LOCKSTAT_SEM, caller, start, false);
+    }
+#endif
 
   leave_critical_section(flags);
   return ret;
@@ -51,36 +51,20 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
   FAR sigq_t    *sigq;
   irqstate_t flags;
 
-  /* Check if we were called from an interrupt handler. */
+  /* Try to get the pending signal action structure from the free list */
 
-  if (up_interrupt_context())
-    {
-      /* Try to get the pending signal action structure from the free list */
-
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-
-      /* If so, then try the special list of structures reserved for
-       * interrupt handlers
-       */
+  flags = spin_lock_irqsave(&g_sigfreelock);
+  sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
 
-      if (!sigq)
-        {
-          sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
-        }
-    }
-
-  /* If we were not called from an interrupt handler, then we are
-   * free to allocate pending signal action structures if necessary.
+  /* If there is none and we were called from an interrupt handler, then
+   * try the special list of structures reserved for interrupt handlers.
    */
 
-  else
+  if (!sigq && up_interrupt_context())
     {
-      /* Try to get the pending signal action structure from the free list */
-
-      flags = enter_critical_section();
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-      leave_critical_section(flags);
+      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
     }
 
+  spin_unlock_irqrestore(&g_sigfreelock, flags);
   return sigq;
 }
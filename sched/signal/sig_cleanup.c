@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 
 #include "signal/signal.h"
 
@@ -98,4 +99,12 @@ void nxsig_release(FAR struct task_group_s *group)
     {
       nxsig_release_pendingsignal(sigpend);
     }
+
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Free the pool of pending standard signals */
+
+  sigemptyset(&group->tg_sigpoolset);
+  kmm_free(group->tg_sigpool);
+  group->tg_sigpool = NULL;
+#endif
 }
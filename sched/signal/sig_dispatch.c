@@ -206,16 +206,18 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb,
  *   Allocate a pending signal list entry
  *
  * Assumptions:
- *   Called with g_sigpendingsignal locked
+ *   The free lists are protected by g_sigfreelock
  *
  ****************************************************************************/
 
 static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 {
   FAR sigpendq_t *sigpend;
+  irqstate_t flags;
 
   /* Try to get the pending signal structure from the free list */
 
+  flags = spin_lock_irqsave(&g_sigfreelock);
   sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
   if (!sigpend && up_interrupt_context())
     {
@@ -227,6 +229,7 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
     }
 
+  spin_unlock_irqrestore(&g_sigfreelock, flags);
   return sigpend;
 }
 
@@ -255,6 +258,17 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
       return sigpend;
     }
 
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Standard signals are pending in the pool of the group */
+
+  if (nxsig_ismember(&group->tg_sigpoolset, signo) == 1)
+    {
+      sigpend = NXSIG_POOL(group, signo);
+    }
+
+  return sigpend;
+#endif
+
   /* Search the list for a action pending on this signal */
 
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
@@ -318,6 +332,25 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 
   /* No... There is nothing pending in the group for this signo */
 
+#ifdef CONFIG_SIG_PENDING_POOL
+  else if (NXSIG_POOLED(info->si_signo))
+    {
+      /* Use the entry of the pool of the group.  info may already point
+       * into it if the signal is being dispatched again after it was
+       * removed.
+       */
+
+      sigpend = NXSIG_POOL(group, info->si_signo);
+      if (&sigpend->info != info)
+        {
+          memcpy(&sigpend->info, info, sizeof(siginfo_t));
+        }
+
+      sigpend->tcb = group_dispatch ? NULL : stcb;
+      nxsig_addset(&group->tg_sigpoolset, info->si_signo);
+    }
+#endif
+
   else
     {
       /* Allocate a new pending signal entry */
@@ -358,8 +391,8 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
  *   structures are freed after they get used.
  *
  * Assumptions:
- *   Called with g_sigpendingsignal and g_sigpendingaction locked by
- *   critical section.
+ *   Called within the critical section.  The free lists are protected by
+ *   g_sigfreelock.
  *
  ****************************************************************************/
 
@@ -378,6 +411,7 @@ static irqstate_t nxsig_alloc_dyn_pending(irqstate_t flags)
         {
           FAR sigpendq_t *sigpend = NULL;
           FAR sigq_t *sigq = NULL;
+          irqstate_t lock;
 
           /* Leave critical section for the duration of heap operations */
 
@@ -402,6 +436,7 @@ static irqstate_t nxsig_alloc_dyn_pending(irqstate_t flags)
            */
 
           flags = enter_critical_section();
+          lock  = spin_lock_irqsave(&g_sigfreelock);
 
           if (sigpend)
             {
@@ -414,6 +449,8 @@ static irqstate_t nxsig_alloc_dyn_pending(irqstate_t flags)
               sigq->type = SIG_ALLOC_DYN;
               sq_addfirst((sq_entry_t *)sigq, &g_sigpendingaction);
             }
+
+          spin_unlock_irqrestore(&g_sigfreelock, lock);
         }
     }
 
@@ -491,7 +528,17 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
    * needs to be done here before using the task state or sigprocmask.
    */
 
-  flags = nxsig_alloc_dyn_pending(flags);
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Nothing can be allocated for a standard signal without a signal
+   * handler, which keeps the common case free of any allocation.
+   */
+
+  if (!NXSIG_POOLED(info->si_signo) ||
+      (sigact != NULL && sigact->act.sa_u._sa_sigaction != NULL))
+#endif
+    {
+      flags = nxsig_alloc_dyn_pending(flags);
+    }
 
   masked = nxsig_ismember(&stcb->sigprocmask, info->si_signo);
 
@@ -27,7 +27,9 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <signal.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
@@ -82,6 +84,12 @@ sq_queue_t  g_sigpendingsignal;
 
 sq_queue_t  g_sigpendingirqsignal;
 
+/* The lock protecting the lists of free pending signal and pending signal
+ * action structures.
+ */
+
+spinlock_t  g_sigfreelock = SP_UNLOCKED;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -181,3 +189,39 @@ void nxsig_initialize(void)
                                           SIG_ALLOC_IRQ);
   sched_trace_end();
 }
+
+#ifdef CONFIG_SIG_PENDING_POOL
+/****************************************************************************
+ * Name: nxsig_initialize_group
+ *
+ * Description:
+ *   Allocate the pool of pending standard signals of a new task group.
+ *   The pool is released by nxsig_release().
+ *
+ * Input Parameters:
+ *   group - The new task group
+ *
+ * Returned Value:
+ *   Zero (OK) on success or -ENOMEM if the pool could not be allocated.
+ *
+ ****************************************************************************/
+
+int nxsig_initialize_group(FAR struct task_group_s *group)
+{
+  int i;
+
+  group->tg_sigpool = kmm_malloc(NUM_SIGNALS_POOL * sizeof(sigpendq_t));
+  if (group->tg_sigpool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < NUM_SIGNALS_POOL; i++)
+    {
+      group->tg_sigpool[i].type = SIG_ALLOC_GROUP;
+    }
+
+  sigemptyset(&group->tg_sigpoolset);
+  return OK;
+}
+#endif
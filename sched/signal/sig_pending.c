@@ -107,6 +107,31 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
         }
     }
 
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Add the standard signals pending in the pool of the group */
+
+  if (stcb == NULL)
+    {
+      sigorset(&sigpendset, &sigpendset, &group->tg_sigpoolset);
+    }
+  else if (!sigisemptyset(&group->tg_sigpoolset))
+    {
+      int signo;
+
+      for (signo = SIGSTDMIN; signo <= SIGSTDMAX; signo++)
+        {
+          if (nxsig_ismember(&group->tg_sigpoolset, signo) == 1)
+            {
+              sigpend = NXSIG_POOL(group, signo);
+              if (sigpend->tcb == NULL || sigpend->tcb == stcb)
+                {
+                  nxsig_addset(&sigpendset, signo);
+                }
+            }
+        }
+    }
+#endif
+
   leave_critical_section(flags);
 
   return sigpendset;
@@ -66,9 +66,9 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_sigfreelock);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_sigfreelock, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -81,9 +81,9 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_sigfreelock);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingirqsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_sigfreelock, flags);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -95,4 +95,8 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
     {
       kmm_free(sigpend);
     }
+
+  /* Entries of the pending signal pool of a group (SIG_ALLOC_GROUP) were
+   * already returned to the pool when they were removed.
+   */
 }
@@ -37,6 +37,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
 
 #include "signal/signal.h"
 
@@ -63,6 +64,30 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_SIG_PENDING_POOL
+  /* Standard signals are pending in the pool of the group */
+
+  if (NXSIG_POOLED(signo))
+    {
+      currsig = NULL;
+      if (nxsig_ismember(&group->tg_sigpoolset, signo) == 1)
+        {
+          currsig = NXSIG_POOL(group, signo);
+          if (currsig->tcb == NULL || currsig->tcb == stcb)
+            {
+              nxsig_delset(&group->tg_sigpoolset, signo);
+            }
+          else
+            {
+              currsig = NULL;
+            }
+        }
+
+      leave_critical_section(flags);
+      return currsig;
+    }
+#endif
+
   /* If stcb == NULL, the signal is for whole group. Otherwise only
    * remove the one which is to be delivered to the stcb
    */
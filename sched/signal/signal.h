@@ -36,6 +36,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -48,6 +49,17 @@
 #define NUM_PENDING_ACTIONS      4
 #define NUM_SIGNALS_PENDING      4
 
+/* With CONFIG_SIG_PENDING_POOL, each group has one pending signal structure
+ * for each standard signal.  They are not kept in tg_sigpendingq, a signal
+ * is pending in the pool if it is a member of tg_sigpoolset.
+ */
+
+#ifdef CONFIG_SIG_PENDING_POOL
+#  define NXSIG_POOLED(signo)      ((signo) >= SIGSTDMIN && (signo) <= SIGSTDMAX)
+#  define NXSIG_POOL(group, signo) (&(group)->tg_sigpool[(signo) - SIGSTDMIN])
+#  define NUM_SIGNALS_POOL         (SIGSTDMAX - SIGSTDMIN + 1)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -58,7 +70,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_GROUP       /* Part of the pending signal pool of a group */
 };
 
 /* The following defines the sigaction queue entry */
@@ -138,6 +151,13 @@ extern sq_queue_t  g_sigpendingsignal;
 
 extern sq_queue_t  g_sigpendingirqsignal;
 
+/* g_sigfreelock protects the four lists of free pending signal and pending
+ * signal action structures above, so that allocating and releasing them
+ * does not need the global critical section.
+ */
+
+extern spinlock_t  g_sigfreelock;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -151,6 +171,9 @@ struct task_group_s;
 /* sig_initializee.c */
 
 void               nxsig_initialize(void);
+#ifdef CONFIG_SIG_PENDING_POOL
+int                nxsig_initialize_group(FAR struct task_group_s *group);
+#endif
 
 /* sig_action.c */
 
@@ -26,9 +26,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/prctl.h>
 #include <stdarg.h>
 #include <string.h>
+#include <limits.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -148,6 +150,27 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+#ifdef CONFIG_WDOG_SLACK
+        this_task()->timerslack = va_arg(ap, unsigned long);
+        va_end(ap);
+        return OK;
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_WDOG_SLACK
+        va_end(ap);
+        return (int)MIN(this_task()->timerslack, INT_MAX);
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
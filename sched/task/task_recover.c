@@ -94,4 +94,13 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(nxsched_stop_sporadic(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Release the bandwidth reserved by the deadline thread */
+
+      nxsched_stop_deadline(tcb);
+    }
+#endif
 }
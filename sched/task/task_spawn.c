@@ -92,7 +92,8 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+        nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (tcb == NULL)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -109,7 +110,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
                     entry, argv, envp, actions);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb((FAR struct tcb_s *)tcb);
       return ret;
     }
 
@@ -62,6 +62,9 @@ struct posix_timer_s
   int              pt_overrun;     /* Overrun time */
   sclock_t         pt_delay;       /* If non-zero, used to reset repetitive timers */
   clock_t          pt_expected;    /* Expected absolute time */
+#ifdef CONFIG_WDOG_SLACK
+  clock_t          pt_slack;       /* Allowed expiration delay in ticks */
+#endif
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
   struct sigevent  pt_event;       /* Notification information */
 #ifdef CONFIG_SIG_EVTHREAD
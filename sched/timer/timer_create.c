@@ -188,6 +188,9 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_owner = tcb->pid;
   ret->pt_delay = 0;
   ret->pt_expected = 0;
+#ifdef CONFIG_WDOG_SLACK
+  ret->pt_slack = NSEC2TICK(tcb->timerslack);
+#endif
 
   /* Was a struct sigevent provided? */
 
@@ -131,8 +131,8 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
       timer->pt_overrun = frame - 1;
       timer->pt_expected += frame * timer->pt_delay;
 
-      wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                       timer_timeout, itimer);
+      wd_start_abstick_slack(&timer->pt_wdog, timer->pt_expected,
+                             timer->pt_slack, timer_timeout, itimer);
     }
 }
 
@@ -332,8 +332,9 @@ int timer_settime(timer_t timerid, int flags,
 
   /* Then start the watchdog */
 
-  ret = wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                         timer_timeout, (wdparm_t)timer);
+  ret = wd_start_abstick_slack(&timer->pt_wdog, timer->pt_expected,
+                               timer->pt_slack, timer_timeout,
+                               (wdparm_t)timer);
 
   if (ret < 0)
     {
@@ -62,14 +62,20 @@ int wd_cancel(FAR struct wdog_s *wdog)
 {
   irqstate_t flags;
   bool head;
+  int cpu;
 
-  flags = spin_lock_irqsave(&g_wdspinlock);
+  if (wdog == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = wd_lock_owner(wdog, &cpu);
 
-  /* Make sure that the watchdog is valid and still active. */
+  /* Make sure that the watchdog is still active. */
 
-  if (wdog == NULL || !WDOG_ISACTIVE(wdog))
+  if (!WDOG_ISACTIVE(wdog))
     {
-      spin_unlock_irqrestore(&g_wdspinlock, flags);
+      spin_unlock_irqrestore(wd_spinlock(cpu), flags);
       return -EINVAL;
     }
 
@@ -80,16 +86,20 @@ int wd_cancel(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
-  head = list_is_head(&g_wdactivelist, &wdog->node);
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  head = wd_wheel_remove(wdog);
+#else
+  head = list_is_head(wd_activelist(cpu), &wdog->node);
 
   /* Now, remove the watchdog from the timer queue */
 
   list_delete(&wdog->node);
+#endif
 
   /* Mark the watchdog inactive */
 
   wdog->func = NULL;
-  spin_unlock_irqrestore(&g_wdspinlock, flags);
+  spin_unlock_irqrestore(wd_spinlock(cpu), flags);
 
   if (head)
     {
@@ -34,15 +34,49 @@
  * Public Data
  ****************************************************************************/
 
-spinlock_t g_wdspinlock = SP_UNLOCKED;
-
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_PERCPU
+spinlock_t g_wdspinlock[CONFIG_SMP_NCPUS];
+struct list_node g_wdactivelist[CONFIG_SMP_NCPUS];
+#else
+spinlock_t g_wdspinlock = SP_UNLOCKED;
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU watchdog lists.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called once from nx_start() before any watchdog is started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+void wd_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_lock_init(&g_wdspinlock[i]);
+      list_initialize(&g_wdactivelist[i]);
+    }
+}
+#endif
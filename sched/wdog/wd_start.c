@@ -90,7 +90,19 @@
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_TICKLESS
+#  ifdef CONFIG_WDOG_PERCPU
+static unsigned int g_wdtimernested[CONFIG_SMP_NCPUS];
+#    define wd_timernested(cpu) g_wdtimernested[cpu]
+#  else
 static unsigned int g_wdtimernested;
+#    define wd_timernested(cpu) g_wdtimernested
+#  endif
+#endif
+
+#ifdef CONFIG_WDOG_PERCPU
+/* Used to request a CPU to process its own expired watchdogs */
+
+static struct smp_call_data_s g_wdsmpcall[CONFIG_SMP_NCPUS];
 #endif
 
 /****************************************************************************
@@ -121,9 +133,10 @@ static void wdentry_period(wdparm_t arg)
 
   if (wdperiod->period != 0)
     {
-      wd_start_abstick(&wdperiod->wdog,
-                       wdperiod->wdog.expired + wdperiod->period,
-                       wdentry_period, wdperiod->wdog.arg);
+      wd_start_abstick_slack(&wdperiod->wdog,
+                             wdperiod->wdog.expired + wdperiod->period,
+                             wdperiod->wdog.slack, wdentry_period,
+                             wdperiod->wdog.arg);
     }
 }
 
@@ -135,6 +148,7 @@ static void wdentry_period(wdparm_t arg)
  *   run. If so, remove the watchdog from the list and execute it.
  *
  * Input Parameters:
+ *   cpu   - The CPU whose watchdog list is processed
  *   ticks - current time in ticks
  *
  * Returned Value:
@@ -142,30 +156,46 @@ static void wdentry_period(wdparm_t arg)
  *
  ****************************************************************************/
 
-static inline_function void wd_expiration(clock_t ticks)
+static inline_function void wd_expiration(int cpu, clock_t ticks)
 {
+  FAR struct list_node *list = wd_activelist(cpu);
   FAR struct wdog_s *wdog;
   irqstate_t         flags;
   wdentry_t          func;
   wdparm_t           arg;
 
-  flags = spin_lock_irqsave(&g_wdspinlock);
+  UNUSED(list);
+  flags = spin_lock_irqsave(wd_spinlock(cpu));
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Increment the nested watchdog timer count to handle cases where wd_start
    * is called in the watchdog callback functions.
    */
 
-  g_wdtimernested++;
+  wd_timernested(cpu)++;
 #endif
 
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  for (; ; )
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Advance the timer wheel and take the next expired watchdog */
+
+      wdog = wd_wheel_expire(ticks);
+      if (wdog == NULL)
+        {
+          break;
+        }
+#else
+      if (list_is_empty(list))
+        {
+          break;
+        }
+
+      wdog = list_first_entry(list, struct wdog_s, node);
 
       /* Check if expected time is expired */
 
@@ -177,6 +207,7 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Remove the watchdog from the head of the list */
 
       list_delete(&wdog->node);
+#endif
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -189,21 +220,96 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Execute the watchdog function */
 
       up_setpicbase(wdog->picbase);
-      spin_unlock_irqrestore(&g_wdspinlock, flags);
+      spin_unlock_irqrestore(wd_spinlock(cpu), flags);
 
       CALL_FUNC(func, arg);
 
-      flags = spin_lock_irqsave(&g_wdspinlock);
+      flags = spin_lock_irqsave(wd_spinlock(cpu));
     }
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Decrement the nested watchdog timer count */
 
-  g_wdtimernested--;
+  wd_timernested(cpu)--;
 #endif
 
-  spin_unlock_irqrestore(&g_wdspinlock, flags);
+  spin_unlock_irqrestore(wd_spinlock(cpu), flags);
+}
+
+/****************************************************************************
+ * Name: wd_expiration_handler
+ *
+ * Description:
+ *   SMP call handler that processes the expired watchdogs of the CPU on
+ *   which it runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+static int wd_expiration_handler(FAR void *arg)
+{
+  wd_expiration(this_cpu(), clock_systime_ticks());
+
+  /* Callbacks may have re-armed watchdogs on this CPU */
+
+  nxsched_reassess_timer();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wd_expiration_remote
+ *
+ * Description:
+ *   Request every other CPU with an expired watchdog at the head of its
+ *   list to process its own watchdogs.  This is only needed because the
+ *   timer event is delivered to a single CPU;  CPUs with no expired
+ *   watchdogs are left undisturbed.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ ****************************************************************************/
+
+static void wd_expiration_remote(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  irqstate_t flags;
+  bool expired;
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu == me)
+        {
+          continue;
+        }
+
+      flags   = spin_lock_irqsave(wd_spinlock(cpu));
+      expired = false;
+
+      if (!list_is_empty(wd_activelist(cpu)))
+        {
+          wdog    = list_first_entry(wd_activelist(cpu), struct wdog_s,
+                                     node);
+          expired = clock_compare(wdog->expired, ticks);
+        }
+
+      if (expired && g_wdsmpcall[cpu].func == NULL)
+        {
+          nxsched_smp_call_init(&g_wdsmpcall[cpu],
+                                wd_expiration_handler, NULL);
+        }
+
+      spin_unlock_irqrestore(wd_spinlock(cpu), flags);
+
+      if (expired)
+        {
+          nxsched_smp_call_single_async(cpu, &g_wdsmpcall[cpu]);
+        }
+    }
 }
+#endif
 
 /****************************************************************************
  * Name: wd_insert
@@ -213,6 +319,7 @@ static inline_function void wd_expiration(clock_t ticks)
  *   the list is sorted in increasing order of expiration absolute time.
  *
  * Input Parameters:
+ *   cpu      - The CPU whose watchdog list receives the timer
  *   wdog     - Watchdog ID
  *   expired  - expired absolute time in clock ticks
  *   wdentry  - Function to call on timeout
@@ -227,17 +334,28 @@ static inline_function void wd_expiration(clock_t ticks)
  ****************************************************************************/
 
 static inline_function
-bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+bool wd_insert(int cpu, FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  /* Return whether the next event of the timer wheel has changed. */
+
+  return wd_wheel_insert(wdog);
+#else
+  FAR struct list_node *list = wd_activelist(cpu);
   FAR struct wdog_s *curr;
   FAR struct wdog_s *head;
 
   /* Traverse the watchdog list */
 
-  head = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+  head = list_first_entry(list, struct wdog_s, node);
 
-  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
+  list_for_every_entry(list, curr, struct wdog_s, node)
     {
       /* Until curr->expired has not timed out relative to expired */
 
@@ -260,12 +378,156 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
   wdog->expired = expired;
+#ifdef CONFIG_WDOG_PERCPU
+  wdog->cpu = cpu;
+#endif
 
   /* Return whether the head of the watchdog list has changed. */
 
   return head == curr;
+#endif
 }
 
+/****************************************************************************
+ * Name: wd_start_internal
+ *
+ * Description:
+ *   Start a watchdog at an absolute time with the given slack.  See
+ *   wd_start_abstick().
+ *
+ ****************************************************************************/
+
+static int wd_start_internal(FAR struct wdog_s *wdog, clock_t ticks,
+                             clock_t slack, wdentry_t wdentry,
+                             wdparm_t arg)
+{
+  irqstate_t flags;
+  bool reassess = false;
+  int cpu;
+
+  /* Verify the wdog and setup parameters */
+
+  if (wdog == NULL || wdentry == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* NOTE:  There is a race condition here... the caller may receive
+   * the watchdog between the time that wd_start_abstick is called and
+   * the critical section is established.
+   */
+
+  flags = wd_lock_owner(wdog, &cpu);
+
+  /* Check if the watchdog has been started.  If so, delete it.  We need to
+   * reassess timer if the watchdog list head has changed.
+   */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      reassess |= wd_wheel_remove(wdog);
+#else
+      reassess |= list_is_head(wd_activelist(cpu), &wdog->node);
+      list_delete(&wdog->node);
+#endif
+      wdog->func = NULL;
+    }
+
+#ifdef CONFIG_WDOG_PERCPU
+  /* The watchdog is queued on, and will expire on, the CPU that starts
+   * it.
+   */
+
+  if (cpu != this_cpu())
+    {
+      spin_unlock_irqrestore(wd_spinlock(cpu), flags);
+
+      flags = up_irq_save();
+      cpu   = this_cpu();
+      spin_lock(wd_spinlock(cpu));
+    }
+#endif
+
+#ifdef CONFIG_WDOG_SLACK
+  wdog->slack = slack;
+#else
+  UNUSED(slack);
+#endif
+
+  reassess |= wd_insert(cpu, wdog, ticks, wdentry, arg);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Do not reassess from within the watchdog callbacks, wd_timer() will
+   * pick the new delay.
+   */
+
+  reassess = reassess && wd_timernested(cpu) == 0;
+#endif
+
+  spin_unlock_irqrestore(wd_spinlock(cpu), flags);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (reassess)
+    {
+      /* Resume the interval timer that will generate the next
+       * interval event. If the timer at the head of the list changed,
+       * then this will pick that new delay.
+       */
+
+      nxsched_reassess_timer();
+    }
+#else
+  UNUSED(reassess);
+#endif
+
+  sched_note_wdog(NOTE_WDOG_START, wdentry, (FAR void *)(uintptr_t)ticks);
+  return OK;
+}
+
+#ifdef CONFIG_WDOG_SLACK
+/****************************************************************************
+ * Name: wd_slack_deadline
+ *
+ * Description:
+ *   Return the latest time at which the next timer event for a list of
+ *   watchdogs can occur:  The earliest expiration time plus slack of its
+ *   watchdogs.  The list is sorted by expiration time, so only the
+ *   watchdogs that expire before the deadline found so far may lower it.
+ *
+ * Input Parameters:
+ *   list - A non-empty list of active watchdogs
+ *
+ * Returned Value:
+ *   The deadline in clock ticks
+ *
+ ****************************************************************************/
+
+static clock_t wd_slack_deadline(FAR struct list_node *list)
+{
+  FAR struct wdog_s *wdog;
+  clock_t deadline;
+
+  wdog     = list_first_entry(list, struct wdog_s, node);
+  deadline = wdog->expired + wdog->slack;
+
+  list_for_every_entry(list, wdog, struct wdog_s, node)
+    {
+      if (!clock_compare(wdog->expired, deadline))
+        {
+          break;
+        }
+
+      if (clock_compare(wdog->expired + wdog->slack, deadline))
+        {
+          deadline = wdog->expired + wdog->slack;
+        }
+    }
+
+  return deadline;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -309,66 +571,42 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
                      wdentry_t wdentry, wdparm_t arg)
 {
-  irqstate_t flags;
-  bool reassess = false;
+  return wd_start_internal(wdog, ticks, 0, wdentry, arg);
+}
 
-  /* Verify the wdog and setup parameters */
+#ifdef CONFIG_WDOG_SLACK
+/****************************************************************************
+ * Name: wd_start_abstick_slack
+ *
+ * Description:
+ *   The same as wd_start_abstick(), but the watchdog may expire up to
+ *   'slack' ticks late so that its expiration can be merged with that of
+ *   other watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absolute time in clock ticks
+ *   slack    - Maximum deferral of the expiration in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
 
-  if (wdog == NULL || wdentry == NULL)
+int wd_start_abstick_slack(FAR struct wdog_s *wdog, clock_t ticks,
+                           clock_t slack, wdentry_t wdentry, wdparm_t arg)
+{
+  if (slack > WDOG_MAX_DELAY)
     {
       return -EINVAL;
     }
 
-  /* NOTE:  There is a race condition here... the caller may receive
-   * the watchdog between the time that wd_start_abstick is called and
-   * the critical section is established.
-   */
-
-  flags = spin_lock_irqsave(&g_wdspinlock);
-#ifdef CONFIG_SCHED_TICKLESS
-  /* We need to reassess timer if the watchdog list head has changed. */
-
-  if (WDOG_ISACTIVE(wdog))
-    {
-      reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-      list_delete(&wdog->node);
-      wdog->func = NULL;
-    }
-
-  reassess |= wd_insert(wdog, ticks, wdentry, arg);
-
-  if (!g_wdtimernested && reassess)
-    {
-      /* Resume the interval timer that will generate the next
-       * interval event. If the timer at the head of the list changed,
-       * then this will pick that new delay.
-       */
-
-      spin_unlock_irqrestore(&g_wdspinlock, flags);
-      nxsched_reassess_timer();
-    }
-  else
-    {
-      spin_unlock_irqrestore(&g_wdspinlock, flags);
-    }
-#else
-  UNUSED(reassess);
-
-  /* Check if the watchdog has been started. If so, delete it. */
-
-  if (WDOG_ISACTIVE(wdog))
-    {
-      list_delete(&wdog->node);
-      wdog->func = NULL;
-    }
-
-  wd_insert(wdog, ticks, wdentry, arg);
-  spin_unlock_irqrestore(&g_wdspinlock, flags);
-#endif
-
-  sched_note_wdog(NOTE_WDOG_START, wdentry, (FAR void *)(uintptr_t)ticks);
-  return OK;
+  return wd_start_internal(wdog, ticks, slack, wdentry, arg);
 }
+#endif
 
 /****************************************************************************
  * Name: wd_start
@@ -419,6 +657,41 @@ int wd_start(FAR struct wdog_s *wdog, clock_t delay,
   return wd_start_abstick(wdog, clock_delay2abstick(delay), wdentry, arg);
 }
 
+#ifdef CONFIG_WDOG_SLACK
+/****************************************************************************
+ * Name: wd_start_slack
+ *
+ * Description:
+ *   The same as wd_start(), but the watchdog may expire up to 'slack' ticks
+ *   late so that its expiration can be merged with that of other
+ *   watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   slack    - Maximum deferral of the expiration in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int wd_start_slack(FAR struct wdog_s *wdog, clock_t delay, clock_t slack,
+                   wdentry_t wdentry, wdparm_t arg)
+{
+  if (delay > WDOG_MAX_DELAY)
+    {
+      return -EINVAL;
+    }
+
+  return wd_start_abstick_slack(wdog, clock_delay2abstick(delay), slack,
+                                wdentry, arg);
+}
+#endif
+
 /****************************************************************************
  * Name: wd_start_period
  *
@@ -487,35 +760,87 @@ int wd_start_period(FAR struct wdog_period_s *wdog, clock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#else
+#ifndef CONFIG_WDOG_SLACK
   FAR struct wdog_s *wdog;
+#endif
+  clock_t next;
+  bool found = false;
+  int cpu;
+#endif
   irqstate_t flags;
-  sclock_t ret;
+  sclock_t ret = 0;
 
   /* Check if the watchdog at the head of the list is ready to run */
 
   if (!noswitches)
     {
-      wd_expiration(ticks);
+      wd_expiration(this_cpu(), ticks);
+#ifdef CONFIG_WDOG_PERCPU
+      wd_expiration_remote(ticks);
+#endif
     }
 
-  flags = spin_lock_irqsave(&g_wdspinlock);
-
   /* Return the delay for the next watchdog to expire */
 
-  if (list_is_empty(&g_wdactivelist))
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  flags = spin_lock_irqsave(&g_wdspinlock);
+
+  if (!wd_wheel_next(&next))
     {
       spin_unlock_irqrestore(&g_wdspinlock, flags);
       return 0;
     }
 
-  /* Notice that if noswitches, expired - g_wdtickbase
-   * may get negative value.
+  /* The next wheel event may be a cascade of an upper level that
+   * precedes the actual expiration time.
    */
 
-  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-  ret = wdog->expired - ticks;
+  ret = next - ticks;
 
   spin_unlock_irqrestore(&g_wdspinlock, flags);
+#else
+  /* With per-CPU lists, the next delay is given by the earliest head of
+   * all lists.
+   */
+
+  for (cpu = 0; cpu < WD_NLISTS; cpu++)
+    {
+      flags = spin_lock_irqsave(wd_spinlock(cpu));
+
+      if (!list_is_empty(wd_activelist(cpu)))
+        {
+          /* Notice that if noswitches, expired - g_wdtickbase
+           * may get negative value.
+           */
+
+#ifdef CONFIG_WDOG_SLACK
+          /* Defer the event as long as the slack of all watchdogs allows,
+           * the watchdogs that are due by then will expire together.
+           */
+
+          next = wd_slack_deadline(wd_activelist(cpu));
+#else
+          wdog = list_first_entry(wd_activelist(cpu), struct wdog_s, node);
+          next = wdog->expired;
+#endif
+          if (!found || (sclock_t)(next - ticks) < ret)
+            {
+              ret   = next - ticks;
+              found = true;
+            }
+        }
+
+      spin_unlock_irqrestore(wd_spinlock(cpu), flags);
+    }
+
+  if (!found)
+    {
+      return 0;
+    }
+#endif
 
   /* Return the delay for the next watchdog to expire */
 
@@ -527,6 +852,9 @@ void wd_timer(clock_t ticks)
 {
   /* Check if there are any active watchdogs to process */
 
-  wd_expiration(ticks);
+  wd_expiration(this_cpu(), ticks);
+#ifdef CONFIG_WDOG_PERCPU
+  wd_expiration_remote(ticks);
+#endif
 }
 #endif /* CONFIG_SCHED_TICKLESS */
@@ -0,0 +1,405 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 64 slots.  A slot at level 'n' covers
+ * 64^n ticks, so the wheel covers 64^CONFIG_WDOG_TIMERWHEEL_LEVELS ticks.
+ * Watchdogs that expire further in the future are parked in the last slot
+ * of the top level and cascaded down when that slot is reached.
+ */
+
+#define WHEEL_SLOTBITS      6
+#define WHEEL_NSLOTS        (1 << WHEEL_SLOTBITS)
+#define WHEEL_SLOTMASK      (WHEEL_NSLOTS - 1)
+#define WHEEL_NLEVELS       CONFIG_WDOG_TIMERWHEEL_LEVELS
+#define WHEEL_SHIFT(l)      ((l) * WHEEL_SLOTBITS)
+
+/* Block number of a tick at a given level and the distance in blocks
+ * between two ticks, modulo the size of the block number space.
+ */
+
+#define WHEEL_BLOCK(t, l)   ((clock_t)(t) >> WHEEL_SHIFT(l))
+#define WHEEL_DIST(a, b, l) \
+  ((WHEEL_BLOCK(a, l) - WHEEL_BLOCK(b, l)) & (CLOCK_MAX >> WHEEL_SHIFT(l)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wd_wheel_s
+{
+  clock_t          now;                               /* Wheel time */
+  uint64_t         bitmap[WHEEL_NLEVELS];             /* Non-empty slots */
+  struct list_node slots[WHEEL_NLEVELS][WHEEL_NSLOTS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slot lists are initialized lazily:  A slot list is only valid while
+ * the corresponding bit is set in the bitmap of its level.
+ */
+
+static struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_first
+ *
+ * Description:
+ *   Return the distance (in slots) from the current slot to the first
+ *   non-empty slot of a level or -1 if the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_first(int level)
+{
+  uint64_t bitmap = g_wdwheel.bitmap[level];
+  unsigned int cur;
+
+  if (bitmap == 0)
+    {
+      return -1;
+    }
+
+  cur = WHEEL_BLOCK(g_wdwheel.now, level) & WHEEL_SLOTMASK;
+  if (cur != 0)
+    {
+      bitmap = (bitmap >> cur) | (bitmap << (WHEEL_NSLOTS - cur));
+    }
+
+  return ffsll(bitmap) - 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Link a watchdog into the slot that corresponds to its expiration time,
+ *   relative to the current wheel time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  clock_t expired = wdog->expired;
+  clock_t block;
+  int level;
+  int index;
+
+  /* Watchdogs that have already expired go into the current slot */
+
+  if (clock_compare(expired, g_wdwheel.now))
+    {
+      expired = g_wdwheel.now;
+    }
+
+  for (level = 0; level < WHEEL_NLEVELS - 1; level++)
+    {
+      if (WHEEL_DIST(expired, g_wdwheel.now, level) < WHEEL_NSLOTS)
+        {
+          break;
+        }
+    }
+
+  if (WHEEL_DIST(expired, g_wdwheel.now, level) < WHEEL_NSLOTS)
+    {
+      block = WHEEL_BLOCK(expired, level);
+    }
+  else
+    {
+      /* Beyond the range of the wheel, park in the furthest slot */
+
+      block = WHEEL_BLOCK(g_wdwheel.now, level) + WHEEL_SLOTMASK;
+    }
+
+  index = block & WHEEL_SLOTMASK;
+  slot  = &g_wdwheel.slots[level][index];
+
+  if ((g_wdwheel.bitmap[level] & ((uint64_t)1 << index)) == 0)
+    {
+      list_initialize(slot);
+      g_wdwheel.bitmap[level] |= (uint64_t)1 << index;
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Redistribute the watchdogs of the current slot of every upper level
+ *   whose block has been reached.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  struct list_node list;
+  int level;
+  int index;
+
+  for (level = WHEEL_NLEVELS - 1; level > 0; level--)
+    {
+      index = WHEEL_BLOCK(g_wdwheel.now, level) & WHEEL_SLOTMASK;
+      if ((g_wdwheel.bitmap[level] & ((uint64_t)1 << index)) == 0)
+        {
+          continue;
+        }
+
+      slot = &g_wdwheel.slots[level][index];
+      g_wdwheel.bitmap[level] &= ~((uint64_t)1 << index);
+
+      /* Detach the slot first since re-adding may target the same slot
+       * when the watchdog is still beyond the range of the wheel.
+       */
+
+      list.next       = slot->next;
+      list.prev       = slot->prev;
+      list.next->prev = &list;
+      list.prev->next = &list;
+
+      while (!list_is_empty(&list))
+        {
+          wdog = list_first_entry(&list, struct wdog_s, node);
+          list_delete(&wdog->node);
+          wd_wheel_add(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel in constant time.  wdog->expired must
+ *   already hold the absolute expiration time.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be added
+ *
+ * Returned Value:
+ *   true if the next event time of the wheel has moved earlier.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t before;
+  clock_t after;
+  bool empty;
+
+  empty = !wd_wheel_next(&before);
+  wd_wheel_add(wdog);
+  wd_wheel_next(&after);
+
+  return empty || after != before;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel in constant time.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be removed
+ *
+ * Returned Value:
+ *   true if the next event time of the wheel has changed.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock and the watchdog is active.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *prev = wdog->node.prev;
+  clock_t before;
+  clock_t after;
+  size_t index;
+
+  wd_wheel_next(&before);
+  list_delete(&wdog->node);
+
+  /* If the slot became empty, 'prev' is the slot list head itself.  Its
+   * position in the slot array identifies the bit to clear.
+   */
+
+  if (list_is_empty(prev))
+    {
+      index = prev - &g_wdwheel.slots[0][0];
+      DEBUGASSERT(index < WHEEL_NLEVELS * WHEEL_NSLOTS);
+
+      g_wdwheel.bitmap[index >> WHEEL_SLOTBITS] &=
+        ~((uint64_t)1 << (index & WHEEL_SLOTMASK));
+    }
+
+  return !wd_wheel_next(&after) || after != before;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Get the time of the next wheel event.  That is either the expiration
+ *   time of the earliest watchdog in the first level or the time at which
+ *   an upper level slot has to be cascaded, whichever comes first.  The
+ *   returned time may thus be earlier than the earliest expiration time.
+ *
+ * Input Parameters:
+ *   next - The location to return the next event time
+ *
+ * Returned Value:
+ *   false if the wheel is empty.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  clock_t event;
+  bool found = false;
+  int level;
+  int dist;
+
+  for (level = 0; level < WHEEL_NLEVELS; level++)
+    {
+      dist = wd_wheel_first(level);
+      if (dist < 0)
+        {
+          continue;
+        }
+
+      event = (WHEEL_BLOCK(g_wdwheel.now, level) + dist) <<
+              WHEEL_SHIFT(level);
+      if (clock_compare(event, g_wdwheel.now))
+        {
+          event = g_wdwheel.now;
+        }
+
+      if (!found || (sclock_t)(event - *next) < 0)
+        {
+          *next = event;
+          found = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the wheel up to 'ticks' and remove the next expired watchdog.
+ *
+ * Input Parameters:
+ *   ticks - The current time in ticks
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if there is no (more) expired watchdog.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  clock_t next;
+  int index;
+
+  for (; ; )
+    {
+      index = g_wdwheel.now & WHEEL_SLOTMASK;
+      if ((g_wdwheel.bitmap[0] & ((uint64_t)1 << index)) != 0)
+        {
+          /* The current slot of the first level holds the watchdogs that
+           * expire now.
+           */
+
+          wdog = list_first_entry(&g_wdwheel.slots[0][index],
+                                  struct wdog_s, node);
+          wd_wheel_remove(wdog);
+          return wdog;
+        }
+
+      if (!wd_wheel_next(&next) || !clock_compare(next, ticks))
+        {
+          /* Nothing happens before 'ticks', just move the wheel */
+
+          if (clock_compare(g_wdwheel.now, ticks))
+            {
+              g_wdwheel.now = ticks;
+            }
+
+          return NULL;
+        }
+
+      g_wdwheel.now = next;
+      wd_wheel_cascade();
+    }
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -37,7 +37,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/list.h>
-#include <nuttx/spinlock_type.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -47,6 +47,18 @@
 
 #define list_node wdlist_node
 
+/* Access to the list of active watchdogs of a CPU and to its lock */
+
+#ifdef CONFIG_WDOG_PERCPU
+#  define WD_NLISTS              CONFIG_SMP_NCPUS
+#  define wd_activelist(cpu)     (&g_wdactivelist[cpu])
+#  define wd_spinlock(cpu)       (&g_wdspinlock[cpu])
+#else
+#  define WD_NLISTS              1
+#  define wd_activelist(cpu)     (&g_wdactivelist)
+#  define wd_spinlock(cpu)       (&g_wdspinlock)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -62,10 +74,72 @@ extern "C"
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
+ *
+ * If CONFIG_WDOG_PERCPU is selected, there is one list and one lock per
+ * CPU.  A watchdog is queued in the list of the CPU that started it and
+ * its callback is executed on that CPU.
  */
 
+#ifdef CONFIG_WDOG_PERCPU
+extern struct list_node g_wdactivelist[CONFIG_SMP_NCPUS];
+extern spinlock_t g_wdspinlock[CONFIG_SMP_NCPUS];
+#else
 extern struct list_node g_wdactivelist;
 extern spinlock_t g_wdspinlock;
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_lock_owner
+ *
+ * Description:
+ *   Take the lock of the list that holds an active watchdog.  If the
+ *   watchdog is not active, the lock of an arbitrary list is taken;  The
+ *   caller must check WDOG_ISACTIVE() after the lock has been acquired.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog of interest
+ *   cpu  - The location to return the index of the locked list
+ *
+ * Returned Value:
+ *   The interrupt state to be passed to spin_unlock_irqrestore()
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+static inline_function irqstate_t wd_lock_owner(FAR struct wdog_s *wdog,
+                                                FAR int *cpu)
+{
+  irqstate_t flags;
+  int owner;
+
+  for (; ; )
+    {
+      owner = wdog->cpu;
+      if (owner >= CONFIG_SMP_NCPUS)
+        {
+          owner = 0;
+        }
+
+      flags = spin_lock_irqsave(wd_spinlock(owner));
+      if (!WDOG_ISACTIVE(wdog) || wdog->cpu == owner)
+        {
+          *cpu = owner;
+          return flags;
+        }
+
+      /* The watchdog moved to another list, try again */
+
+      spin_unlock_irqrestore(wd_spinlock(owner), flags);
+    }
+}
+#else
+#  define wd_lock_owner(wdog, cpu) \
+     (*(cpu) = 0, spin_lock_irqsave(&g_wdspinlock))
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -125,6 +199,42 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU watchdog lists.
+ *
+ * Assumptions:
+ *   Called once from nx_start() before any watchdog is started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+void wd_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_remove, wd_wheel_next and wd_wheel_expire
+ *
+ * Description:
+ *   Hierarchical timer wheel backend of the watchdog timers.  Inserting and
+ *   removing a watchdog take constant time.  wd_wheel_next() returns the
+ *   time of the next wheel event and wd_wheel_expire() advances the wheel
+ *   up to the provided time, returning the expired watchdogs one by one.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+bool wd_wheel_insert(FAR struct wdog_s *wdog);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+bool wd_wheel_next(FAR clock_t *next);
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -60,6 +60,17 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* The work may have been queued on, or taken by, another CPU's queue */
+
+  while (work->wq != NULL && work->wq != wqueue)
+    {
+      spin_unlock_irqrestore(&wqueue->lock, flags);
+      wqueue = work->wq;
+      flags = spin_lock_irqsave(&wqueue->lock);
+    }
+#endif
+
   if (!work_available(work))
     {
       /* If the head of the pending queue has changed, we should reset
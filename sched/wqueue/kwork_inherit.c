@@ -39,6 +39,20 @@
 #if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_SCHED_LPWORK) && \
     defined(CONFIG_PRIORITY_INHERITANCE)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With per-CPU work queues the workers of every CPU are adjusted */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define LPWORK_NQUEUES    CONFIG_SMP_NCPUS
+#  define LPWORK_QUEUE(cpu) g_lpwork_percpu[cpu]
+#else
+#  define LPWORK_NQUEUES    1
+#  define LPWORK_QUEUE(cpu) ((FAR struct kwork_wqueue_s *)&g_lpwork)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -208,8 +222,10 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
 
 void lpwork_boostpriority(uint8_t reqprio)
 {
+  FAR struct kwork_wqueue_s *wqueue;
   irqstate_t flags;
   int wndx;
+  int cpu;
 
   /* Clip to the configured maximum priority */
 
@@ -224,9 +240,18 @@ void lpwork_boostpriority(uint8_t reqprio)
 
   /* Adjust the priority of every worker thread */
 
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+  for (cpu = 0; cpu < LPWORK_NQUEUES; cpu++)
     {
-      lpwork_boostworker(g_lpwork.worker[wndx].pid, reqprio);
+      wqueue = LPWORK_QUEUE(cpu);
+      if (wqueue == NULL)
+        {
+          continue;
+        }
+
+      for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+        {
+          lpwork_boostworker(wqueue->worker[wndx].pid, reqprio);
+        }
     }
 
   leave_critical_section(flags);
@@ -252,8 +277,10 @@ void lpwork_boostpriority(uint8_t reqprio)
 
 void lpwork_restorepriority(uint8_t reqprio)
 {
+  FAR struct kwork_wqueue_s *wqueue;
   irqstate_t flags;
   int wndx;
+  int cpu;
 
   /* Clip to the configured maximum priority */
 
@@ -268,9 +295,18 @@ void lpwork_restorepriority(uint8_t reqprio)
 
   /* Adjust the priority of every worker thread */
 
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+  for (cpu = 0; cpu < LPWORK_NQUEUES; cpu++)
     {
-      lpwork_restoreworker(g_lpwork.worker[wndx].pid, reqprio);
+      wqueue = LPWORK_QUEUE(cpu);
+      if (wqueue == NULL)
+        {
+          continue;
+        }
+
+      for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+        {
+          lpwork_restoreworker(wqueue->worker[wndx].pid, reqprio);
+        }
     }
 
   leave_critical_section(flags);
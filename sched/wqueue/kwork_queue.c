@@ -41,47 +41,99 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_queue_period/work_queue_period_wq
+ * Name: work_unqueue_peer
  *
  * Description:
- *   Queue work to be performed periodically.  All queued work will be
- *   performed on the worker thread of execution (not the caller's).
+ *   Remove the work from the per-CPU queue of another CPU on which it was
+ *   queued before, so that it can be queued on a new CPU.
  *
- *   The work structure is allocated and must be initialized to all zero by
- *   the caller.  Otherwise, the work structure is completely managed by the
- *   work queue logic.  The caller should never modify the contents of the
- *   work queue structure directly.  If work_queue() is called before the
- *   previous work has been performed and removed from the queue, then any
- *   pending work will be canceled and lost.
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static void work_unqueue_peer(FAR struct kwork_wqueue_s *wqueue,
+                              FAR struct work_s *work)
+{
+  FAR struct kwork_wqueue_s *oldq = work->wq;
+  irqstate_t flags;
+
+  if (oldq == NULL || oldq == wqueue || work_available(work))
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&oldq->lock);
+
+  if (work->wq == oldq && !work_available(work) &&
+      work_remove(oldq, work))
+    {
+      work_timer_reset(oldq);
+    }
+
+  spin_unlock_irqrestore(&oldq->lock, flags);
+}
+
+/****************************************************************************
+ * Name: work_kick_peer
  *
- * Input Parameters:
- *   qid    - The work queue ID (must be HPWORK or LPWORK)
- *   wqueue - The work queue handle
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will be
- *            invoked on the worker thread of execution.
- *   arg    - The argument that will be passed to the worker callback when
- *            it is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
- *   period - Period (in clock ticks).
+ * Description:
+ *   All workers of the queue are busy:  Wake up an idle worker of another
+ *   CPU so that it can take the new work.
  *
- * Returned Value:
- *   Zero on success, a negated errno on failure
+ ****************************************************************************/
+
+static void work_kick_peer(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_wqueue_s *peer;
+  int cpu;
+  int wndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      peer = wqueue->peers[cpu];
+      if (peer == NULL || peer == wqueue)
+        {
+          continue;
+        }
+
+      /* This is only a hint, an extra wake up does no harm */
+
+      for (wndx = 0; wndx < peer->nthreads; wndx++)
+        {
+          if (peer->worker[wndx].work == NULL)
+            {
+              nxsem_post(&peer->sem);
+              return;
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: work_qperiod
+ *
+ * Description:
+ *   Queue the work on the specified work queue.  'pinned' prevents the work
+ *   from being taken by the workers of other CPUs.
  *
  ****************************************************************************/
 
-int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
-                         FAR struct work_s *work, worker_t worker,
-                         FAR void *arg, clock_t delay, clock_t period)
+static int work_qperiod(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, clock_t period,
+                        bool pinned)
 {
   irqstate_t flags;
   clock_t expected;
   bool retimer;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  bool busy = false;
+  int wndx;
+#endif
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -91,6 +143,12 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
 
   expected = clock_delay2abstick(delay);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* The work may still be queued on the queue of another CPU */
+
+  work_unqueue_peer(wqueue, work);
+#endif
+
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -108,6 +166,15 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
   work->qtime  = expected; /* Expected time */
   work->period = period;   /* Periodical delay */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* Only the per-CPU queues keep track of the work, they never go away */
+
+  work->wq     = wqueue->peers != NULL ? wqueue : NULL;
+  work->pinned = pinned;
+#else
+  UNUSED(pinned);
+#endif
+
   if (delay)
     {
       /* Insert to the pending list of the wqueue. */
@@ -126,6 +193,20 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Insert to the expired list of the wqueue. */
 
       list_add_tail(&wqueue->expired, &work->node);
+      work_stats_ready(work);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Are all workers of this queue busy? */
+
+      if (wqueue->peers != NULL && !pinned && period == 0)
+        {
+          for (busy = true, wndx = 0; busy && wndx < wqueue->nthreads;
+               wndx++)
+            {
+              busy = wqueue->worker[wndx].work != NULL;
+            }
+        }
+#endif
     }
 
   if (retimer)
@@ -140,11 +221,60 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Immediately wake up the worker thread. */
 
       nxsem_post(&wqueue->sem);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      if (busy)
+        {
+          work_kick_peer(wqueue);
+        }
+#endif
     }
 
   return 0;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_period/work_queue_period_wq
+ *
+ * Description:
+ *   Queue work to be performed periodically.  All queued work will be
+ *   performed on the worker thread of execution (not the caller's).
+ *
+ *   The work structure is allocated and must be initialized to all zero by
+ *   the caller.  Otherwise, the work structure is completely managed by the
+ *   work queue logic.  The caller should never modify the contents of the
+ *   work queue structure directly.  If work_queue() is called before the
+ *   previous work has been performed and removed from the queue, then any
+ *   pending work will be canceled and lost.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   period - Period (in clock ticks).
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s *work, worker_t worker,
+                         FAR void *arg, clock_t delay, clock_t period)
+{
+  return work_qperiod(wqueue, work, worker, arg, delay, period, false);
+}
+
 int work_queue_period(int qid, FAR struct work_s *work, worker_t worker,
                       FAR void *arg, clock_t delay, clock_t period)
 {
@@ -195,4 +325,47 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to be performed on the worker of a specific CPU.  This is
+ *   the same as work_queue() except that the work is bound to the queue of
+ *   the selected CPU and will not be taken by the workers of other CPUs.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU that should run the work, or WORK_CPU_ANY
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+  if (cpu == WORK_CPU_ANY)
+    {
+      return work_queue(qid, work, worker, arg, delay);
+    }
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  return work_qperiod(work_qid2wq_cpu(qid, cpu), work, worker, arg,
+                      delay, 0, true);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * sched/wqueue/kwork_stats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_stats_queue
+ *
+ * Description:
+ *   Return the kernel work queue of a class and a CPU, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct kwork_wqueue_s *work_stats_queue(int qid, int cpu)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      return g_hpwork_percpu[cpu];
+    }
+#  endif
+
+#  ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      return g_lpwork_percpu[cpu];
+    }
+#  endif
+
+  return NULL;
+#else
+  return cpu == 0 ? work_qid2wq(qid) : NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: work_stats_bucket
+ *
+ * Description:
+ *   Return the bucket of the latency histogram of a latency.
+ *
+ ****************************************************************************/
+
+static int work_stats_bucket(clock_t latency)
+{
+  struct timespec ts;
+  uint64_t usec;
+  int bucket;
+
+  perf_convert(latency, &ts);
+  usec = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  for (bucket = 0; bucket < WORK_STATS_NBUCKETS - 1 && usec > 0; bucket++)
+    {
+      usec >>= 1;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: work_stats_func
+ *
+ * Description:
+ *   Account a run of a worker function.  When the slots are full, the
+ *   function with the shortest maximum run is replaced if the run is
+ *   longer, so that the slowest functions are kept.
+ *
+ ****************************************************************************/
+
+static void work_stats_func(FAR struct work_stats_s *stats, worker_t worker,
+                            clock_t run)
+{
+  FAR struct work_funcstat_s *slot = &stats->funcs[0];
+  FAR struct work_funcstat_s *func;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_WORKQUEUE_STATS_NWORKERS; i++)
+    {
+      func = &stats->funcs[i];
+      if (func->worker == worker)
+        {
+          slot = func;
+          break;
+        }
+
+      if (func->worker == NULL || func->runmax < slot->runmax)
+        {
+          slot = func;
+        }
+    }
+
+  if (slot->worker != worker)
+    {
+      if (slot->worker != NULL && run <= slot->runmax)
+        {
+          return;
+        }
+
+      memset(slot, 0, sizeof(*slot));
+      slot->worker = worker;
+    }
+
+  slot->count++;
+  slot->run += run;
+  if (run > slot->runmax)
+    {
+      slot->runmax = run;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_stats_dequeue
+ ****************************************************************************/
+
+void work_stats_dequeue(FAR struct kwork_wqueue_s *wqueue)
+{
+  size_t backlog = list_length(&wqueue->expired);
+
+  if (backlog > wqueue->stats.backlogmax)
+    {
+      wqueue->stats.backlogmax = backlog;
+    }
+}
+
+/****************************************************************************
+ * Name: work_stats_update
+ ****************************************************************************/
+
+void work_stats_update(FAR struct kwork_wqueue_s *wqueue, worker_t worker,
+                       clock_t ready, clock_t start, clock_t end)
+{
+  FAR struct work_stats_s *stats = &wqueue->stats;
+  clock_t latency = start - ready;
+  clock_t run = end - start;
+
+  stats->count++;
+  stats->latency += latency;
+  if (latency > stats->latencymax)
+    {
+      stats->latencymax = latency;
+    }
+
+  stats->run += run;
+  if (run > stats->runmax)
+    {
+      stats->runmax = run;
+    }
+
+  stats->histogram[work_stats_bucket(latency)]++;
+  work_stats_func(stats, worker, run);
+}
+
+/****************************************************************************
+ * Name: work_stats_get
+ ****************************************************************************/
+
+int work_stats_get(int qid, int cpu, FAR struct work_stats_s *stats)
+{
+  FAR struct kwork_wqueue_s *wqueue = work_stats_queue(qid, cpu);
+  irqstate_t flags;
+
+  if (wqueue == NULL)
+    {
+      return -ENOENT;
+    }
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+  memcpy(stats, &wqueue->stats, sizeof(*stats));
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_stats_reset
+ ****************************************************************************/
+
+void work_stats_reset(void)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+  int cpu;
+  int qid;
+
+  for (qid = HPWORK; qid <= LPWORK; qid++)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          wqueue = work_stats_queue(qid, cpu);
+          if (wqueue != NULL)
+            {
+              flags = spin_lock_irqsave(&wqueue->lock);
+              memset(&wqueue->stats, 0, sizeof(wqueue->stats));
+              spin_unlock_irqrestore(&wqueue->lock, flags);
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_STATS */
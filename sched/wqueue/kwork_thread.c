@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <inttypes.h>
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>
@@ -40,6 +41,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
 
 #include "sched/sched.h"
 #include "wqueue/wqueue.h"
@@ -90,9 +92,19 @@ struct hp_wqueue_s g_hpwork =
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
     CONFIG_SCHED_HPNTHREADS,
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+    g_hpwork_percpu,
+#endif
   }
 };
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+FAR struct kwork_wqueue_s *g_hpwork_percpu[CONFIG_SMP_NCPUS] =
+{
+  (FAR struct kwork_wqueue_s *)&g_hpwork
+};
+#endif
+
 #endif /* CONFIG_SCHED_HPWORK */
 
 #if defined(CONFIG_SCHED_LPWORK)
@@ -107,11 +119,37 @@ struct lp_wqueue_s g_lpwork =
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
     CONFIG_SCHED_LPNTHREADS,
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+    g_lpwork_percpu,
+#endif
   }
 };
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+FAR struct kwork_wqueue_s *g_lpwork_percpu[CONFIG_SMP_NCPUS] =
+{
+  (FAR struct kwork_wqueue_s *)&g_lpwork
+};
+#endif
+
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The work queues of CPU1 through CPU(n-1) */
+
+#  ifdef CONFIG_SCHED_HPWORK
+static struct hp_wqueue_s g_hpwork_cpu[CONFIG_SMP_NCPUS - 1];
+#  endif
+
+#  ifdef CONFIG_SCHED_LPWORK
+static struct lp_wqueue_s g_lpwork_cpu[CONFIG_SMP_NCPUS - 1];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -148,6 +186,7 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
 
       list_delete(&work->node);
       list_add_tail(&wq->expired, &work->node);
+      work_stats_ready(work);
 
       /* Note that the thread execution this function is also
        * a worker thread, which has already been woken up by the timer.
@@ -161,6 +200,76 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
     }
 }
 
+/****************************************************************************
+ * Name: work_steal
+ *
+ * Description:
+ *   Take the first movable expired work from the queue of another CPU of
+ *   the same class whose workers are all busy.  Pinned and periodic work
+ *   always stays on its own queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue of the idle worker, locked by the caller
+ *
+ * Returned Value:
+ *   The work that now belongs to wqueue, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static FAR struct work_s *work_steal(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_wqueue_s *peer;
+  FAR struct work_s *work;
+  int cpu;
+  int wndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      peer = wqueue->peers[cpu];
+      if (peer == NULL || peer == wqueue)
+        {
+          continue;
+        }
+
+      /* Never wait for a second queue lock here, two idle workers could be
+       * trying to take work from each other.
+       */
+
+      if (!spin_trylock(&peer->lock))
+        {
+          continue;
+        }
+
+      for (wndx = 0; wndx < peer->nthreads; wndx++)
+        {
+          if (peer->worker[wndx].work == NULL)
+            {
+              break;
+            }
+        }
+
+      if (wndx >= peer->nthreads)
+        {
+          list_for_every_entry(&peer->expired, work, struct work_s, node)
+            {
+              if (!work->pinned && work->period == 0)
+                {
+                  list_delete(&work->node);
+                  work->wq = wqueue;
+                  spin_unlock(&peer->lock);
+                  return work;
+                }
+            }
+        }
+
+      spin_unlock(&peer->lock);
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -191,6 +300,12 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t      worker;
   irqstate_t    flags;
   FAR void     *arg;
+  bool          stolen;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t       ready;
+  clock_t       start;
+  clock_t       end;
+#endif
 
   /* Get the handle from argv */
 
@@ -223,12 +338,27 @@ static int work_thread(int argc, FAR char *argv[])
           work_dispatch(wqueue);
         }
 
+      work   = NULL;
+      stolen = false;
+
       if (!list_is_empty(&wqueue->expired))
         {
+          work_stats_dequeue(wqueue);
           work = list_first_entry(&wqueue->expired, struct work_s, node);
-
           list_delete(&work->node);
+        }
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      else if (wqueue->peers != NULL)
+        {
+          /* Nothing to do here, help a CPU that can't keep up */
+
+          work   = work_steal(wqueue);
+          stolen = work != NULL;
+        }
+#endif
 
+      if (work != NULL)
+        {
           /* Extract the work description from the entry (in case the
            * work instance will be reused after it has been de-queued).
            */
@@ -239,6 +369,10 @@ static int work_thread(int argc, FAR char *argv[])
 
           arg = work->arg;
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          ready = work->ready;
+#endif
+
           /* Check whether the work is periodic. */
 
           if (work->period != 0)
@@ -275,10 +409,23 @@ static int work_thread(int argc, FAR char *argv[])
            * performed... we don't have any idea how long this will take!
            */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          start = perf_gettime();
           CALL_WORKER(worker, arg);
+          end = perf_gettime();
+
+          sched_note_printf_ip(NOTE_TAG_SCHED, (uintptr_t)worker,
+                               "work latency %" PRIu64 " run %" PRIu64, 0,
+                               (uint64_t)(start - ready),
+                               (uint64_t)(end - start));
+#else
+          CALL_WORKER(worker, arg);
+#endif
           flags = spin_lock_irqsave(&wqueue->lock);
           sched_lock();
 
+          work_stats_update(wqueue, worker, ready, start, end);
+
           /* Mark the thread un-busy */
 
           kworker->work = NULL;
@@ -295,9 +442,14 @@ static int work_thread(int argc, FAR char *argv[])
       spin_unlock_irqrestore(&wqueue->lock, flags);
       sched_unlock();
 
-      /* Wait for the semaphore to be posted by the wqueue timer. */
+      /* Wait for the semaphore to be posted by the wqueue timer.  After
+       * running work taken from another CPU look for more before sleeping.
+       */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+      if (!stolen)
+        {
+          nxsem_wait_uninterruptible(&wqueue->sem);
+        }
     }
 
   nxsem_post(&wqueue->exsem);
@@ -367,6 +519,91 @@ static int work_thread_create(FAR const char *name, int priority,
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_percpu_create
+ *
+ * Description:
+ *   Start the worker threads of one class of per-CPU work queues and pin
+ *   each thread pool to its CPU.  The queue of CPU0 is statically
+ *   initialized, the queues of the other CPUs are initialized here and
+ *   only become visible to work_queue() once their threads exist.
+ *
+ * Input Parameters:
+ *   name       - Name of the worker threads
+ *   priority   - Priority of the worker threads
+ *   stack_size - size (in bytes) of the stack needed
+ *   percpu     - The per-CPU queue table of this class
+ *   wqueues    - Storage for the queues of CPU1 through CPU(n-1)
+ *   wqsize     - The size of one queue in wqueues
+ *   nthreads   - Number of worker threads per CPU
+ *
+ * Returned Value:
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static int work_percpu_create(FAR const char *name, int priority,
+                              int stack_size,
+                              FAR struct kwork_wqueue_s **percpu,
+                              FAR void *wqueues, size_t wqsize,
+                              int nthreads)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  cpu_set_t cpuset;
+  int wndx;
+  int cpu;
+  int ret;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu == 0)
+        {
+          wqueue = percpu[0];
+        }
+      else
+        {
+          wqueue = (FAR struct kwork_wqueue_s *)
+                   ((FAR uint8_t *)wqueues + (cpu - 1) * wqsize);
+
+          list_initialize(&wqueue->expired);
+          list_initialize(&wqueue->pending);
+          nxsem_init(&wqueue->sem, 0, 0);
+          nxsem_init(&wqueue->exsem, 0, 0);
+          spin_lock_init(&wqueue->lock);
+          wqueue->nthreads = nthreads;
+          wqueue->peers    = percpu;
+        }
+
+      sched_lock();
+
+      ret = work_thread_create(name, priority, NULL, stack_size, wqueue);
+      if (ret < 0)
+        {
+          sched_unlock();
+          return ret;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+
+      for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+        {
+          nxsched_set_affinity(wqueue->worker[wndx].pid,
+                               sizeof(cpu_set_t), &cpuset);
+        }
+
+      /* Publish the queue only after it is fully initialized */
+
+      UP_DMB();
+      percpu[cpu] = wqueue;
+      sched_unlock();
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -570,9 +807,16 @@ int work_start_highpri(void)
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  return work_percpu_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                            CONFIG_SCHED_HPWORKSTACKSIZE, g_hpwork_percpu,
+                            g_hpwork_cpu, sizeof(struct hp_wqueue_s),
+                            CONFIG_SCHED_HPNTHREADS);
+#else
   return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
                             CONFIG_SCHED_HPWORKSTACKSIZE,
                             (FAR struct kwork_wqueue_s *)&g_hpwork);
+#endif
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -598,9 +842,16 @@ int work_start_lowpri(void)
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  return work_percpu_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                            CONFIG_SCHED_LPWORKSTACKSIZE, g_lpwork_percpu,
+                            g_lpwork_cpu, sizeof(struct lp_wqueue_s),
+                            CONFIG_SCHED_LPNTHREADS);
+#else
   return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY, NULL,
                             CONFIG_SCHED_LPWORKSTACKSIZE,
                             (FAR struct kwork_wqueue_s *)&g_lpwork);
+#endif
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/list.h>
 #include <nuttx/wqueue.h>
@@ -72,8 +73,14 @@ struct kwork_wqueue_s
   sem_t            exsem;     /* Sync waiting for thread exit */
   spinlock_t       lock;      /* Spinlock */
   uint8_t          nthreads;  /* Number of worker threads */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct kwork_wqueue_s **peers; /* Per-CPU queues of the same class */
+#endif
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;  /* Protected by lock */
+#endif
   struct kworker_s worker[0]; /* Describes a worker thread */
 };
 
@@ -123,30 +130,82 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The per-CPU kernel work queues.  g_hpwork and g_lpwork serve CPU0, the
+ * queues of the other CPUs are added as they are started.  Until then
+ * work for those CPUs goes to the CPU0 queue.
+ */
+
+#  ifdef CONFIG_SCHED_HPWORK
+extern FAR struct kwork_wqueue_s *g_hpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+
+#  ifdef CONFIG_SCHED_LPWORK
+extern FAR struct kwork_wqueue_s *g_lpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static inline_function
+FAR struct kwork_wqueue_s *work_qid2wq_cpu(int qid, int cpu)
+{
+  FAR struct kwork_wqueue_s **percpu;
+  FAR struct kwork_wqueue_s *wqueue;
+
+#  ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      percpu = g_hpwork_percpu;
+    }
+  else
+#  endif
+#  ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      percpu = g_lpwork_percpu;
+    }
+  else
+#  endif
+    {
+      return NULL;
+    }
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      cpu = this_cpu();
+    }
+
+  wqueue = percpu[cpu];
+  return wqueue != NULL ? wqueue : percpu[0];
+}
+
+#  define work_qid2wq(qid) work_qid2wq_cpu(qid, this_cpu())
+#else
 static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
 {
-#ifdef CONFIG_SCHED_HPWORK
+#  ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
       return (FAR struct kwork_wqueue_s *)&g_hpwork;
     }
   else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
+#  endif
+#  ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
       return (FAR struct kwork_wqueue_s *)&g_lpwork;
     }
   else
-#endif
+#  endif
     {
       return NULL;
     }
 }
+#endif
 
 /****************************************************************************
  * Name: work_insert_pending
@@ -282,6 +341,39 @@ void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
     }
 }
 
+/****************************************************************************
+ * Name: work_stats_ready
+ *
+ * Description:
+ *   Mark the time the work was put in the expired queue of wqueue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+#  define work_stats_ready(work) ((work)->ready = perf_gettime())
+#else
+#  define work_stats_ready(work)
+#endif
+
+/****************************************************************************
+ * Name: work_stats_dequeue / work_stats_update
+ *
+ * Description:
+ *   Account the backlog of wqueue as a worker takes the first expired work,
+ *   then the latency and the run time of that work once it is done.  Both
+ *   are called with the lock of wqueue held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+void work_stats_dequeue(FAR struct kwork_wqueue_s *wqueue);
+void work_stats_update(FAR struct kwork_wqueue_s *wqueue, worker_t worker,
+                       clock_t ready, clock_t start, clock_t end);
+#else
+#  define work_stats_dequeue(wqueue)
+#  define work_stats_update(wqueue, worker, ready, start, end)
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -630,6 +630,14 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzGetGlobalInfo64",
+  "unzGetFilePos64",
+  "unzGoToFilePos64",
+  "unzGetCurrentFileZStreamPos64",
+  "unzCloseCurrentFile",
+  "inflateInit2",
+  "inflateCopy",
+  "inflateReset",
 
   /* Ref:
    * apps/netutils/telnetc/telnetc.c
@@ -1599,6 +1599,71 @@ static void cmd_queue_init(void)
   UNUSED(ret);
 }
 
+/****************************************************************************
+ * Name: bt_receive_buf
+ *
+ * Description:
+ *   Queue a received event or ACL buffer for the Rx work.  Command
+ *   Complete/Status events go to the high priority work queue, all the
+ *   others to the low priority one.
+ *
+ ****************************************************************************/
+
+static void bt_receive_buf(FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_hci_evt_hdr_s *hdr;
+  int ret;
+
+  if (buf->type == BT_EVT)
+    {
+      /* Command Complete/Status events use high priority messages. */
+
+      hdr = (FAR void *)buf->data;
+      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
+          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
+          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
+        {
+          /* Add the buffer to the high priority Rx buffer list */
+
+          bt_enqueue_bufwork(&g_hp_rxlist, buf);
+
+          /* If there is already pending work, then do nothing.  Otherwise,
+           * schedule processing of the Rx buffer list on the high priority
+           * work queue.
+           */
+
+          if (work_available(&g_hp_work))
+            {
+              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
+                               &g_hp_rxlist, 0);
+              if (ret < 0)
+                {
+                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
+                }
+            }
+
+          return;
+        }
+    }
+
+  /* Add the buffer to the low priority Rx buffer list */
+
+  bt_enqueue_bufwork(&g_lp_rxlist, buf);
+
+  /* If there is already pending work, then do nothing.  Otherwise, schedule
+   * processing of the Rx buffer list on the low priority work queue.
+   */
+
+  if (work_available(&g_lp_work))
+    {
+      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
+      if (ret < 0)
+        {
+          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1798,9 +1863,7 @@ void bt_driver_unset(FAR struct bt_driver_s *btdev)
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len)
 {
-  FAR struct bt_hci_evt_hdr_s *hdr;
   struct bt_buf_s *buf;
-  int ret;
 
   if (len + BLUETOOTH_H4_HDRLEN > CONFIG_IOB_BUFSIZE)
     {
@@ -1808,11 +1871,13 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
       return -EINVAL;
     }
 
-  wlinfo("data %p len %zu\n", data, len);
+  if (type != BT_ACL_IN && type != BT_EVT)
+    {
+      wlerr("ERROR: Invalid buf type %u\n", type);
+      return -EINVAL;
+    }
 
-  /* Critical command complete/status events use the high priority work
-   * queue.
-   */
+  wlinfo("data %p len %zu\n", data, len);
 
   buf = bt_buf_alloc(type, NULL, BLUETOOTH_H4_HDRLEN);
   if (buf == NULL)
@@ -1821,65 +1886,55 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
     }
 
   memcpy(bt_buf_extend(buf, len), data, len);
+  bt_receive_buf(buf);
+  return OK;
+}
 
-  if (type != BT_ACL_IN)
-    {
-      if (type != BT_EVT)
-        {
-          wlerr("ERROR: Invalid buf type %u\n", buf->type);
-          bt_buf_release(buf);
-          return -EINVAL;
-        }
-
-      /* Command Complete/Status events use high priority messages. */
-
-      hdr = (FAR void *)buf->data;
-      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
-          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
-          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
-        {
-          /* Add the buffer to the high priority Rx buffer list */
-
-          bt_enqueue_bufwork(&g_hp_rxlist, buf);
-
-          /* If there is already pending work, then do nothing.  Otherwise,
-           * schedule processing of the Rx buffer list on the high priority
-           * work queue.
-           */
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Like bt_receive(), but for a frame that the low-level driver read into
+ *   an IOB, at io_offset, which is handed over instead of copied.
+ *
+ * Input Parameters:
+ *   btdev - An instance of the low-level drivers interface structure.
+ *   type  - The type of the frame, BT_EVT or BT_ACL_IN.
+ *   iob   - The IOB holding the frame.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and the IOB then belongs to the
+ *   stack.  On failure, a negated errno value is returned and the IOB is
+ *   still the caller's.
+ *
+ ****************************************************************************/
 
-          if (work_available(&g_hp_work))
-            {
-              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
-                               &g_hp_rxlist, 0);
-              if (ret < 0)
-                {
-                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
-                }
-            }
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob)
+{
+  struct bt_buf_s *buf;
 
-          return OK;
-        }
+  if (iob->io_len > BLUETOOTH_MAX_FRAMELEN)
+    {
+      wlerr("ERROR: Data too long\n");
+      return -EINVAL;
     }
 
-  /* All others use the low priority work queue */
-
-  /* Add the buffer to the low priority Rx buffer list */
-
-  bt_enqueue_bufwork(&g_lp_rxlist, buf);
+  if (type != BT_ACL_IN && type != BT_EVT)
+    {
+      wlerr("ERROR: Invalid buf type %u\n", type);
+      return -EINVAL;
+    }
 
-  /* If there is already pending work, then do nothing.  Otherwise, schedule
-   * processing of the Rx buffer list on the low priority work queue.
-   */
+  wlinfo("iob %p len %u\n", iob, iob->io_len - iob->io_offset);
 
-  if (work_available(&g_lp_work))
+  buf = bt_buf_alloc(type, iob, 0);
+  if (buf == NULL)
     {
-      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
-      if (ret < 0)
-        {
-          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
-        }
+      return -ENOMEM;
     }
 
+  bt_receive_buf(buf);
   return OK;
 }
 
@@ -489,4 +489,17 @@ void bt_hci_cb_register(FAR struct bt_hci_cb_s *cb);
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len);
 
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Like bt_receive(), but the frame is handed over in the IOB that the
+ *   low-level driver read it into.  The IOB belongs to the stack only if
+ *   OK is returned.
+ *
+ ****************************************************************************/
+
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob);
+
 #endif /* __WIRELESS_BLUETOOTH_BT_HDICORE_H */